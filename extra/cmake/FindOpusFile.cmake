@@ -0,0 +1,35 @@
+# Sets the following variables:
+#
+# OPUSFILE_FOUND
+# OPUSFILE_INCLUDE_DIR
+# OPUS_INCLUDE_DIR
+# OPUSFILE_LIBRARY
+# OPUS_LIBRARY
+
+set(OPUSFILE_SEARCH_PATHS
+	/usr/local
+	/usr
+	)
+
+find_path(OPUSFILE_INCLUDE_DIR opusfile.h
+	PATH_SUFFIXES include/opus
+	PATHS ${OPUSFILE_SEARCH_PATHS})
+
+find_path(OPUS_INCLUDE_DIR opus_multistream.h
+	PATH_SUFFIXES include/opus
+	PATHS ${OPUSFILE_SEARCH_PATHS})
+
+find_library(OPUSFILE_LIBRARY
+	NAMES opusfile
+	PATH_SUFFIXES lib
+	PATHS ${OPUSFILE_SEARCH_PATHS})
+
+find_library(OPUS_LIBRARY
+	NAMES opus
+	PATH_SUFFIXES lib
+	PATHS ${OPUSFILE_SEARCH_PATHS})
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(OpusFile DEFAULT_MSG OPUSFILE_LIBRARY OPUS_LIBRARY OPUSFILE_INCLUDE_DIR OPUS_INCLUDE_DIR)
+
+mark_as_advanced(OPUSFILE_INCLUDE_DIR OPUS_INCLUDE_DIR OPUSFILE_LIBRARY OPUS_LIBRARY)
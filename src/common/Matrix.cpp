@@ -133,6 +133,88 @@ void Matrix4::multiply(const Matrix4 &a, const Matrix4 &b, Matrix4 &t)
 	multiply(a, b, t.e);
 }
 
+void Matrix4::multiplyHierarchy(const Matrix4 *locals, const int *parents, Matrix4 *result, int count)
+{
+	for (int i = 0; i < count; i++)
+	{
+		if (parents[i] < 0)
+		{
+			result[i] = locals[i];
+			continue;
+		}
+
+		// The local matrix may be stored in the result array.
+		float t[16];
+		multiply(result[parents[i]], locals[i], t);
+		memcpy(result[i].e, t, sizeof(float) * 16);
+	}
+}
+
+//                 | x |
+//                 | y |
+//                 | 0 |
+//                 | 1 |
+// | e0 e4 e8  e12 |
+// | e1 e5 e9  e13 |
+// | e2 e6 e10 e14 |
+// | e3 e7 e11 e15 |
+
+void Matrix4::transformXYArray(float *dst, const float *src, int count) const
+{
+	int i = 0;
+
+#if defined(LOVE_SIMD_SSE)
+
+	// Two points per register, as x0 y0 x1 y1.
+	const __m128 cx = _mm_setr_ps(e[0], e[1], e[0], e[1]);
+	const __m128 cy = _mm_setr_ps(e[4], e[5], e[4], e[5]);
+	const __m128 ct = _mm_setr_ps(e[12], e[13], e[12], e[13]);
+
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 p01 = _mm_loadu_ps(&src[i * 2 + 0]);
+		__m128 p23 = _mm_loadu_ps(&src[i * 2 + 4]);
+
+		__m128 x01 = _mm_shuffle_ps(p01, p01, _MM_SHUFFLE(2, 2, 0, 0));
+		__m128 y01 = _mm_shuffle_ps(p01, p01, _MM_SHUFFLE(3, 3, 1, 1));
+		__m128 x23 = _mm_shuffle_ps(p23, p23, _MM_SHUFFLE(2, 2, 0, 0));
+		__m128 y23 = _mm_shuffle_ps(p23, p23, _MM_SHUFFLE(3, 3, 1, 1));
+
+		p01 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x01, cx), _mm_mul_ps(y01, cy)), ct);
+		p23 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x23, cx), _mm_mul_ps(y23, cy)), ct);
+
+		_mm_storeu_ps(&dst[i * 2 + 0], p01);
+		_mm_storeu_ps(&dst[i * 2 + 4], p23);
+	}
+
+#elif defined(LOVE_SIMD_NEON)
+
+	for (; i + 4 <= count; i += 4)
+	{
+		// Deinterleaves into four x and four y values.
+		float32x4x2_t p = vld2q_f32(&src[i * 2]);
+
+		float32x4_t x = vmlaq_n_f32(vmlaq_n_f32(vdupq_n_f32(e[12]), p.val[0], e[0]), p.val[1], e[4]);
+		float32x4_t y = vmlaq_n_f32(vmlaq_n_f32(vdupq_n_f32(e[13]), p.val[0], e[1]), p.val[1], e[5]);
+
+		p.val[0] = x;
+		p.val[1] = y;
+		vst2q_f32(&dst[i * 2], p);
+	}
+
+#endif
+
+	// Remaining points, or all of them without SIMD.
+	for (; i < count; i++)
+	{
+		float x = (e[0]*src[i * 2]) + (e[4]*src[i * 2 + 1]) + (e[12]);
+		float y = (e[1]*src[i * 2]) + (e[5]*src[i * 2 + 1]) + (e[13]);
+
+		dst[i * 2 + 0] = x;
+		dst[i * 2 + 1] = y;
+	}
+}
+
 // | e0 e4 e8  e12 |
 // | e1 e5 e9  e13 |
 // | e2 e6 e10 e14 |
@@ -281,32 +363,46 @@ void Matrix4::setTransformation(float x, float y, float angle, float sx, float s
 	e[13] = y - ox * e[1] - oy * e[5];
 }
 
+// The translate, rotate, scale and shear matrices only have non-identity
+// values in their first two columns or the translation column, so only those
+// columns of this matrix change when multiplying by them.
+
 void Matrix4::translate(float x, float y)
 {
-	Matrix4 t;
-	t.setTranslation(x, y);
-	this->operator *=(t);
+	for (int i = 0; i < 4; i++)
+		e[12 + i] = (e[0 + i] * x) + (e[4 + i] * y) + e[12 + i];
 }
 
 void Matrix4::rotate(float rad)
 {
-	Matrix4 t;
-	t.setRotation(rad);
-	this->operator *=(t);
+	float c = cosf(rad), s = sinf(rad);
+	for (int i = 0; i < 4; i++)
+	{
+		float col0 = e[0 + i];
+		float col1 = e[4 + i];
+		e[0 + i] = (col0 * c) + (col1 * s);
+		e[4 + i] = (col0 * -s) + (col1 * c);
+	}
 }
 
 void Matrix4::scale(float sx, float sy)
 {
-	Matrix4 t;
-	t.setScale(sx, sy);
-	this->operator *=(t);
+	for (int i = 0; i < 4; i++)
+	{
+		e[0 + i] *= sx;
+		e[4 + i] *= sy;
+	}
 }
 
 void Matrix4::shear(float kx, float ky)
 {
-	Matrix4 t;
-	t.setShear(kx,ky);
-	this->operator *=(t);
+	for (int i = 0; i < 4; i++)
+	{
+		float col0 = e[0 + i];
+		float col1 = e[4 + i];
+		e[0 + i] = col0 + (col1 * ky);
+		e[4 + i] = (col0 * kx) + col1;
+	}
 }
 
 bool Matrix4::isAffine2DTransform() const
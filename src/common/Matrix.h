@@ -25,6 +25,9 @@
 #include "math.h"
 #include "Vector.h"
 
+// C++
+#include <type_traits>
+
 namespace love
 {
 
@@ -211,6 +214,21 @@ public:
 	template <typename Vdst, typename Vsrc>
 	void transformXYZ(Vdst *dst, const Vsrc *src, int size) const;
 
+	/**
+	 * Transforms an array of tightly packed x,y float pairs by this Matrix,
+	 * four at a time with SIMD when possible. The source and destination
+	 * arrays may be the same.
+	 **/
+	void transformXYArray(float *dst, const float *src, int count) const;
+
+	/**
+	 * Combines each local matrix with the combined matrix of its parent:
+	 * result[i] = result[parents[i]] * locals[i], or just locals[i] if
+	 * parents[i] is negative. Parents must come before their children. The
+	 * locals and result arrays may be the same.
+	 **/
+	static void multiplyHierarchy(const Matrix4 *locals, const int *parents, Matrix4 *result, int count);
+
 	/**
 	 * Gets whether this matrix is an affine 2D transform (if the only non-
 	 * identity elements are the upper-left 2x2 and 2 translation values in the
@@ -326,6 +344,13 @@ private:
 template <typename Vdst, typename Vsrc>
 void Matrix4::transformXY(Vdst *dst, const Vsrc *src, int size) const
 {
+	// Tightly packed positions can use the SIMD version.
+	if constexpr (std::is_same<Vdst, Vector2>::value && std::is_same<Vsrc, Vector2>::value)
+	{
+		transformXYArray((float *) dst, (const float *) src, size);
+		return;
+	}
+
 	for (int i = 0; i < size; i++)
 	{
 		// Store in temp variables in case src = dst
@@ -23,6 +23,8 @@
 
 #include <string>
 #include <vector>
+#include <atomic>
+#include <cstdint>
 
 // As StringMap instantiates std::vector<std::string> for instances that use
 // getNames(), we end up with multiple copies in the object files. This
@@ -71,17 +73,38 @@ public:
 
 	bool find(const char *key, T &t)
 	{
+		// Lua strings are interned, so a wrapper called in a loop with the
+		// same constant gets the same pointer every time. Check a small cache
+		// keyed by the pointer before hashing the string. A pointer can be
+		// reused for a different string after the original is collected (and
+		// another thread may be updating the entry), so hits are verified.
+		CacheEntry &entry = cache[getCacheIndex(key)];
+
+		if (entry.key.load(std::memory_order_relaxed) == key)
+		{
+			unsigned int str_i = entry.record.load(std::memory_order_relaxed);
+
+			if (str_i < MAX && records[str_i].set && streq(records[str_i].key, key))
+			{
+				t = records[str_i].value;
+				return true;
+			}
+		}
+
 		unsigned int str_hash = djb2(key);
 
 		for (unsigned int i = 0; i < MAX; ++i)
 		{
-			unsigned int str_i = (str_hash + i) % MAX;
+			unsigned int str_i = (str_hash + i) & (MAX - 1);
 
 			if (!records[str_i].set)
 				return false;
 
 			if (streq(records[str_i].key, key))
 			{
+				entry.key.store(key, std::memory_order_relaxed);
+				entry.record.store(str_i, std::memory_order_relaxed);
+
 				t = records[str_i].value;
 				return true;
 			}
@@ -115,7 +138,7 @@ public:
 
 		for (unsigned int i = 0; i < MAX; ++i)
 		{
-			unsigned int str_i = (str_hash + i) % MAX;
+			unsigned int str_i = (str_hash + i) & (MAX - 1);
 
 			if (!records[str_i].set)
 			{
@@ -173,10 +196,36 @@ private:
 		Record() : set(false) {}
 	};
 
-	static const unsigned int MAX = SIZE * 2;
+	struct CacheEntry
+	{
+		std::atomic<const char *> key;
+		std::atomic<unsigned int> record;
+		CacheEntry() : key(nullptr), record(0) {}
+	};
+
+	static constexpr unsigned int getPowerOfTwo(unsigned int n)
+	{
+		unsigned int p = 1;
+		while (p < n)
+			p <<= 1;
+		return p;
+	}
+
+	static unsigned int getCacheIndex(const char *key)
+	{
+		// Allocations are at least 8-byte aligned, so skip the low bits.
+		return (unsigned int) (((uintptr_t) key >> 3) & (CACHE_SIZE - 1));
+	}
+
+	// A power of two at least twice the number of constants, so probing can
+	// mask instead of using a modulo.
+	static const unsigned int MAX = getPowerOfTwo(SIZE * 2);
+
+	static const unsigned int CACHE_SIZE = 8;
 
 	Record records[MAX];
 	const char *reverse[SIZE];
+	CacheEntry cache[CACHE_SIZE];
 
 }; // StringMap
 
@@ -57,7 +57,7 @@ Variant::Variant(const char *str, size_t len)
 	else
 	{
 		type = STRING;
-		data.string = new SharedString(str, len);
+		data.string = SharedString::create(str, len);
 	}
 }
 
@@ -89,6 +89,13 @@ Variant::Variant(SharedTable *table)
 	data.table = table;
 }
 
+// Variant gets ownership of the packed table.
+Variant::Variant(PackedTable *table)
+	: type(PACKEDTABLE)
+{
+	data.packedtable = table;
+}
+
 Variant::Variant(const Variant &v)
 	: type(v.type)
 	, data(v.data)
@@ -99,6 +106,8 @@ Variant::Variant(const Variant &v)
 		data.objectproxy.object->retain();
 	else if (type == TABLE)
 		data.table->retain();
+	else if (type == PACKEDTABLE)
+		data.packedtable->retain();
 }
 
 Variant::Variant(Variant &&v)
@@ -116,6 +125,8 @@ Variant::~Variant()
 		data.objectproxy.object->release();
 	else if (type == TABLE)
 		data.table->release();
+	else if (type == PACKEDTABLE)
+		data.packedtable->release();
 }
 
 Variant &Variant::operator = (const Variant &v)
@@ -126,6 +137,8 @@ Variant &Variant::operator = (const Variant &v)
 		v.data.objectproxy.object->retain();
 	else if (v.type == TABLE)
 		v.data.table->retain();
+	else if (v.type == PACKEDTABLE)
+		v.data.packedtable->retain();
 
 	if (type == STRING)
 		data.string->release();
@@ -133,6 +146,8 @@ Variant &Variant::operator = (const Variant &v)
 		data.objectproxy.object->release();
 	else if (type == TABLE)
 		data.table->release();
+	else if (type == PACKEDTABLE)
+		data.packedtable->release();
 
 	type = v.type;
 	data = v.data;
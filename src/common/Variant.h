@@ -24,8 +24,10 @@
 #include "common/config.h"
 #include "common/Object.h"
 #include "common/int.h"
+#include "common/memory.h"
 
 #include <cstring>
+#include <new>
 #include <string>
 #include <vector>
 
@@ -48,24 +50,46 @@ public:
 		LUSERDATA,
 		LOVEOBJECT,
 		NIL,
-		TABLE
+		TABLE,
+		PACKEDTABLE
 	};
 
+	/**
+	 * Strings too long to be stored inline. The characters are stored right
+	 * after the object in the same allocation, so create() must be used.
+	 **/
 	class SharedString : public love::Object
 	{
 	public:
 
-		SharedString(const char *string, size_t len)
-			: len(len)
+		static SharedString *create(const char *string, size_t len)
 		{
-			str = new char[len+1];
-			str[len] = '\0';
-			memcpy(str, string, len);
+			void *mem = ::operator new(sizeof(SharedString) + len + 1);
+			return new (mem) SharedString(string, len);
 		}
-		virtual ~SharedString() { delete[] str; }
+
+		virtual ~SharedString()
+		{
+			trackMemory(MEMORYTAG_VARIANT, -((int64) len + 1));
+		}
+
+		// The allocation is bigger than the class, so sized deallocation
+		// can't be used.
+		static void operator delete(void *mem) { ::operator delete(mem); }
 
 		char *str;
 		size_t len;
+
+	private:
+
+		SharedString(const char *string, size_t len)
+			: str((char *) (this + 1))
+			, len(len)
+		{
+			memcpy(str, string, len);
+			str[len] = '\0';
+			trackMemory(MEMORYTAG_VARIANT, (int64) len + 1);
+		}
 	};
 
 	class SharedTable : public love::Object
@@ -78,6 +102,44 @@ public:
 		std::vector<std::pair<Variant, Variant>> pairs;
 	};
 
+	/**
+	 * A Lua table serialized into one contiguous buffer, which is much cheaper
+	 * to create and to rebuild than a SharedTable of individual Variants. The
+	 * format is written and read by luax_checkvariant and luax_pushvariant.
+	 **/
+	class PackedTable : public love::Object
+	{
+	public:
+
+		PackedTable() : trackedSize(0) {}
+		virtual ~PackedTable()
+		{
+			for (const Proxy &p : objects)
+			{
+				if (p.object != nullptr)
+					p.object->release();
+			}
+			trackMemory(MEMORYTAG_VARIANT, -(int64) trackedSize);
+		}
+
+		// Called once the data has been written.
+		void updateTrackedMemory()
+		{
+			size_t size = data.capacity() + objects.capacity() * sizeof(Proxy);
+			trackMemory(MEMORYTAG_VARIANT, (int64) size - (int64) trackedSize);
+			trackedSize = size;
+		}
+
+		std::vector<uint8> data;
+
+		// LOVE objects referenced by the table, retained.
+		std::vector<Proxy> objects;
+
+	private:
+
+		size_t trackedSize;
+	};
+
 	union Data
 	{
 		bool boolean;
@@ -86,6 +148,7 @@ public:
 		void *userdata;
 		Proxy objectproxy;
 		SharedTable *table;
+		PackedTable *packedtable;
 		struct
 		{
 			char str[MAX_SMALL_STRING_LENGTH];
@@ -101,6 +164,7 @@ public:
 	Variant(void *lightuserdata);
 	Variant(love::Type *type, love::Object *object);
 	Variant(SharedTable *table);
+	Variant(PackedTable *table);
 	Variant(const Variant &v);
 	Variant(Variant &&v);
 	~Variant();
@@ -23,6 +23,7 @@
 
 #ifdef LOVE_ANDROID
 
+#include <algorithm>
 #include <cerrno>
 #include <set>
 #include <unordered_map>
@@ -139,12 +140,6 @@ void vibrate(double seconds)
 /*
  * Helper functions for the filesystem module
  */
-void freeGameArchiveMemory(void *ptr)
-{
-	char *game_love_data = static_cast<char*>(ptr);
-	delete[] game_love_data;
-}
-
 bool directoryExists(const char *path)
 {
 	struct stat s {};
@@ -391,6 +386,13 @@ struct AssetInfo: public love::filesystem::physfs::PhysfsIo<AssetInfo>
 	char *filename;
 	size_t size;
 
+	// Assets stored uncompressed in the APK (such as a game.love which is
+	// excluded from APK compression) are memory-mapped, and read with plain
+	// copies from the mapping instead of AAsset_read and AAsset_seek.
+	const uint8_t *buffer;
+	int64_t bufferSize;
+	mutable int64_t bufferOffset;
+
 	static AssetInfo *fromAAsset(AAssetManager *assetManager, const char *filename, AAsset *asset)
 	{
 		return new AssetInfo(assetManager, filename, asset);
@@ -398,6 +400,16 @@ struct AssetInfo: public love::filesystem::physfs::PhysfsIo<AssetInfo>
 
 	int64_t read(void* buf, uint64_t len) const
 	{
+		if (buffer != nullptr)
+		{
+			int64_t count = std::min((int64_t) len, bufferSize - bufferOffset);
+			memcpy(buf, buffer + bufferOffset, (size_t) count);
+			bufferOffset += count;
+
+			PHYSFS_setErrorCode(PHYSFS_ERR_OK);
+			return count;
+		}
+
 		int readed = AAsset_read(asset, buf, (size_t) len);
 
 		PHYSFS_setErrorCode(readed < 0 ? PHYSFS_ERR_OS_ERROR : PHYSFS_ERR_OK);
@@ -415,6 +427,19 @@ struct AssetInfo: public love::filesystem::physfs::PhysfsIo<AssetInfo>
 
 	int64_t seek(uint64_t offset) const
 	{
+		if (buffer != nullptr)
+		{
+			if (offset > (uint64_t) bufferSize)
+			{
+				PHYSFS_setErrorCode(PHYSFS_ERR_PAST_EOF);
+				return 0;
+			}
+
+			bufferOffset = (int64_t) offset;
+			PHYSFS_setErrorCode(PHYSFS_ERR_OK);
+			return 1;
+		}
+
 		int64_t success = AAsset_seek64(asset, (off64_t) offset, SEEK_SET) != -1;
 
 		PHYSFS_setErrorCode(success ? PHYSFS_ERR_OK : PHYSFS_ERR_OS_ERROR);
@@ -423,6 +448,9 @@ struct AssetInfo: public love::filesystem::physfs::PhysfsIo<AssetInfo>
 
 	int64_t tell() const
 	{
+		if (buffer != nullptr)
+			return bufferOffset;
+
 		off64_t len = AAsset_getLength64(asset);
 		off64_t remain = AAsset_getRemainingLength64(asset);
 
@@ -455,6 +483,8 @@ struct AssetInfo: public love::filesystem::physfs::PhysfsIo<AssetInfo>
 
 		filename = new (std::nothrow) char[size];
 		memcpy(filename, other.filename, size);
+
+		mapBuffer();
 	}
 
 	~AssetInfo() override
@@ -471,6 +501,29 @@ private:
 	{
 		this->filename = new (std::nothrow) char[size];
 		memcpy(this->filename, filename, size);
+
+		mapBuffer();
+	}
+
+	void mapBuffer()
+	{
+		buffer = nullptr;
+		bufferSize = 0;
+		bufferOffset = 0;
+
+		// Only assets stored uncompressed in the APK have a file descriptor.
+		// AAsset_getBuffer would decompress anything else into memory.
+		off64_t start = 0;
+		off64_t length = 0;
+		int fd = AAsset_openFileDescriptor64(asset, &start, &length);
+		if (fd < 0)
+			return;
+
+		close(fd);
+
+		buffer = (const uint8_t *) AAsset_getBuffer(asset);
+		if (buffer != nullptr)
+			bufferSize = (int64_t) AAsset_getLength64(asset);
 	}
 };
 
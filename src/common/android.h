@@ -57,8 +57,6 @@ void vibrate(double seconds);
 /*
  * Helper functions for the filesystem module
  */
-void freeGameArchiveMemory(void *ptr);
-
 bool directoryExists(const char *path);
 
 bool mkdir(const char *path);
@@ -20,42 +20,310 @@
 
 #include "b64.h"
 #include "Exception.h"
+#include "cpu.h"
+#include "int.h"
 
 #include <limits>
+#include <algorithm>
 #include <stdio.h>
 
+#if defined(LOVE_CPU_X86)
+#	define LOVE_B64_SSSE3
+#	include <tmmintrin.h>
+#elif defined(LOVE_SIMD_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+#	define LOVE_B64_NEON
+#	include <arm_neon.h>
+#endif
+
 namespace love
 {
 
 // Translation table as described in RFC1113
 static const char cb64[]="ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
 
-// Translation table to decode (created by Bob Trower)
-static const char cd64[]="|$$$}rstuvwxyz{$$$$$$$>?@ABCDEFGHIJKLMNOPQRSTUVW$$$$$$XYZ[\\]^_`abcdefghijklmnopq";
+// Sextet values of each character, or -1 for characters which decoding skips.
+static const int8 cd64[256] =
+{
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 62, -1, -1, -1, 63,
+	52, 53, 54, 55, 56, 57, 58, 59, 60, 61, -1, -1, -1, -1, -1, -1,
+	-1, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14,
+	15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, -1,
+	-1, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+	41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+};
+
+#if defined(LOVE_B64_SSSE3)
+
+// The SIMD encoding and decoding is based on the approach described by
+// Wojciech Mula and Daniel Lemire in "Faster Base64 Encoding and Decoding
+// using AVX2 Instructions" (https://arxiv.org/abs/1704.00605).
+
+// Encodes 12 bytes at a time, but reads 16. Returns the number of bytes
+// consumed.
+LOVE_CPU_TARGET("ssse3")
+static size_t b64_encode_simd(const uint8 *src, size_t srclen, char *dst)
+{
+	const __m128i shuffle = _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+	const __m128i offsets = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+	                                      '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+
+	size_t pos = 0;
+
+	for (; srclen - pos >= 16; pos += 12, dst += 16)
+	{
+		__m128i in = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) (src + pos)), shuffle);
+
+		// Spread each group of 3 bytes into 4 sextets, one per byte.
+		__m128i t0 = _mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0FC0FC00)), _mm_set1_epi32(0x04000040));
+		__m128i t1 = _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003F03F0)), _mm_set1_epi32(0x01000010));
+		__m128i sextets = _mm_or_si128(t0, t1);
+
+		// Map each range of sextet values to the offset of its characters.
+		__m128i range = _mm_subs_epu8(sextets, _mm_set1_epi8(51));
+		__m128i upper = _mm_cmpgt_epi8(_mm_set1_epi8(26), sextets);
+		range = _mm_or_si128(range, _mm_and_si128(upper, _mm_set1_epi8(13)));
+
+		__m128i out = _mm_add_epi8(sextets, _mm_shuffle_epi8(offsets, range));
+		_mm_storeu_si128((__m128i *) dst, out);
+	}
+
+	return pos;
+}
+
+// Decodes 16 characters to 12 bytes at a time, storing 16. Stops at the first
+// block with a character outside the base64 alphabet. Returns the number of
+// characters consumed.
+LOVE_CPU_TARGET("ssse3")
+static size_t b64_decode_simd(const char *src, size_t srclen, char *dst, size_t dstsize, size_t &written)
+{
+	const __m128i lut_lo = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+	                                     0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+	const __m128i lut_hi = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+	                                     0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+	const __m128i lut_roll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+	const __m128i mask_2F = _mm_set1_epi8(0x2F);
+	const __m128i pack = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+
+	size_t pos = 0;
+	written = 0;
+
+	for (; srclen - pos >= 16 && dstsize - written >= 16; pos += 16, written += 12)
+	{
+		__m128i in = _mm_loadu_si128((const __m128i *) (src + pos));
+
+		__m128i hi_nibbles = _mm_and_si128(_mm_srli_epi32(in, 4), mask_2F);
+		__m128i lo_nibbles = _mm_and_si128(in, mask_2F);
+		__m128i hi = _mm_shuffle_epi8(lut_hi, hi_nibbles);
+		__m128i lo = _mm_shuffle_epi8(lut_lo, lo_nibbles);
+
+		if (_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_and_si128(lo, hi), _mm_setzero_si128())) != 0)
+			break;
+
+		__m128i eq_2F = _mm_cmpeq_epi8(in, mask_2F);
+		__m128i roll = _mm_shuffle_epi8(lut_roll, _mm_add_epi8(eq_2F, hi_nibbles));
+		__m128i sextets = _mm_add_epi8(in, roll);
+
+		// Merge the sextets back into groups of 3 bytes.
+		__m128i merged = _mm_maddubs_epi16(sextets, _mm_set1_epi32(0x01400140));
+		merged = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+		_mm_storeu_si128((__m128i *) (dst + written), _mm_shuffle_epi8(merged, pack));
+	}
+
+	return pos;
+}
+
+#elif defined(LOVE_B64_NEON)
+
+static uint8x16x4_t b64_load_table(const uint8 *table)
+{
+	uint8x16x4_t t;
+	for (int i = 0; i < 4; i++)
+		t.val[i] = vld1q_u8(table + i * 16);
+	return t;
+}
+
+// Encodes 48 bytes at a time. Returns the number of bytes consumed.
+static size_t b64_encode_simd(const uint8 *src, size_t srclen, char *dst)
+{
+	const uint8x16x4_t table = b64_load_table((const uint8 *) cb64);
+
+	size_t pos = 0;
+
+	for (; srclen - pos >= 48; pos += 48, dst += 64)
+	{
+		uint8x16x3_t in = vld3q_u8(src + pos);
+		uint8x16x4_t out;
+
+		out.val[0] = vshrq_n_u8(in.val[0], 2);
+		out.val[1] = vorrq_u8(vshlq_n_u8(vandq_u8(in.val[0], vdupq_n_u8(0x03)), 4), vshrq_n_u8(in.val[1], 4));
+		out.val[2] = vorrq_u8(vshlq_n_u8(vandq_u8(in.val[1], vdupq_n_u8(0x0F)), 2), vshrq_n_u8(in.val[2], 6));
+		out.val[3] = vandq_u8(in.val[2], vdupq_n_u8(0x3F));
+
+		for (int i = 0; i < 4; i++)
+			out.val[i] = vqtbl4q_u8(table, out.val[i]);
+
+		vst4q_u8((uint8 *) dst, out);
+	}
+
+	return pos;
+}
+
+// Decodes 64 characters to 48 bytes at a time. Stops at the first block with
+// a character outside the base64 alphabet. Returns the number of characters
+// consumed.
+static size_t b64_decode_simd(const char *src, size_t srclen, char *dst, size_t dstsize, size_t &written)
+{
+	// Characters 0-63 and 64-127 of the decoding table. Skipped characters
+	// are 0xFF, as are characters 128+ since table lookups past the end
+	// produce 0 and the second lookup leaves them alone.
+	const uint8x16x4_t table_lo = b64_load_table((const uint8 *) cd64);
+	const uint8x16x4_t table_hi = b64_load_table((const uint8 *) cd64 + 64);
+
+	size_t pos = 0;
+	written = 0;
+
+	for (; srclen - pos >= 64 && dstsize - written >= 48; pos += 64, written += 48)
+	{
+		uint8x16x4_t in = vld4q_u8((const uint8 *) src + pos);
+		uint8x16_t invalid = vdupq_n_u8(0);
+
+		for (int i = 0; i < 4; i++)
+		{
+			uint8x16_t c = in.val[i];
+			uint8x16_t v = vqtbl4q_u8(table_lo, c);
+			v = vqtbx4q_u8(v, table_hi, vsubq_u8(c, vdupq_n_u8(64)));
+			invalid = vorrq_u8(invalid, vorrq_u8(vcgeq_u8(c, vdupq_n_u8(128)), vcgtq_u8(v, vdupq_n_u8(63))));
+			in.val[i] = v;
+		}
+
+		if (vmaxvq_u8(invalid) != 0)
+			break;
+
+		uint8x16x3_t out;
+		out.val[0] = vorrq_u8(vshlq_n_u8(in.val[0], 2), vshrq_n_u8(in.val[1], 4));
+		out.val[1] = vorrq_u8(vshlq_n_u8(in.val[1], 4), vshrq_n_u8(in.val[2], 2));
+		out.val[2] = vorrq_u8(vshlq_n_u8(in.val[2], 6), in.val[3]);
+
+		vst3q_u8((uint8 *) dst + written, out);
+	}
+
+	return pos;
+}
+
+#endif
+
+static bool b64_has_simd()
+{
+#if defined(LOVE_B64_SSSE3)
+	return cpu::hasSSSE3();
+#elif defined(LOVE_B64_NEON)
+	return true;
+#else
+	return false;
+#endif
+}
 
 /**
- * encode 3 8-bit binary bytes as 4 '6-bit' characters
+ * Encodes a run of bytes without line breaks, padding the end if needed.
  **/
-static void b64_encode_block(char in[3], char out[4], int len)
+static size_t b64_encode_run(const uint8 *src, size_t srclen, char *dst, bool simd)
 {
-	out[0] = (char) cb64[(int)((in[0] & 0xfc) >> 2)];
-	out[1] = (char) cb64[(int)(((in[0] & 0x03) << 4) | ((in[1] & 0xf0) >> 4))];
-	out[2] = (char) (len > 1 ? cb64[(int)(((in[1] & 0x0f) << 2) | ((in[2] & 0xc0) >> 6))] : '=');
-	out[3] = (char) (len > 2 ? cb64[(int)(in[2] & 0x3f)] : '=');
+	size_t pos = 0;
+	char *d = dst;
+
+#if defined(LOVE_B64_SSSE3) || defined(LOVE_B64_NEON)
+	if (simd)
+	{
+		pos = b64_encode_simd(src, srclen, d);
+		d += (pos / 3) * 4;
+	}
+#else
+	(void) simd;
+#endif
+
+	for (; srclen - pos >= 3; pos += 3, d += 4)
+	{
+		uint32 v = ((uint32) src[pos] << 16) | ((uint32) src[pos + 1] << 8) | (uint32) src[pos + 2];
+		d[0] = cb64[(v >> 18) & 0x3F];
+		d[1] = cb64[(v >> 12) & 0x3F];
+		d[2] = cb64[(v >> 6) & 0x3F];
+		d[3] = cb64[v & 0x3F];
+	}
+
+	if (pos < srclen)
+	{
+		uint32 v = (uint32) src[pos] << 16;
+		if (pos + 1 < srclen)
+			v |= (uint32) src[pos + 1] << 8;
+
+		d[0] = cb64[(v >> 18) & 0x3F];
+		d[1] = cb64[(v >> 12) & 0x3F];
+		d[2] = pos + 1 < srclen ? cb64[(v >> 6) & 0x3F] : '=';
+		d[3] = '=';
+		d += 4;
+	}
+
+	return (size_t) (d - dst);
 }
 
-char *b64_encode(const char *src, size_t srclen, size_t linelen, size_t &dstlen)
+// Lines hold a whole number of 4 character blocks.
+static size_t b64_line_chars(size_t linelen)
+{
+	return std::max<size_t>(linelen / 4, 1) * 4;
+}
+
+size_t b64_encoded_size(size_t srclen, size_t linelen)
 {
+	size_t paddedlen = ((srclen + 2) / 3) * 4;
+
 	if (linelen == 0)
-		linelen = std::numeric_limits<size_t>::max();
+		return paddedlen;
 
-	size_t blocksout = 0;
-	size_t srcpos = 0;
+	return paddedlen + paddedlen / b64_line_chars(linelen);
+}
+
+size_t b64_encode(const char *src, size_t srclen, size_t linelen, char *dst, size_t dstsize)
+{
+	if (b64_encoded_size(srclen, linelen) > dstsize)
+		throw love::Exception("Not enough space to store the base64-encoded data.");
+
+	const uint8 *s = (const uint8 *) src;
+	bool simd = b64_has_simd();
 
-	size_t adjustment = (srclen % 3) ? (3 - (srclen % 3)) : 0;
-	size_t paddedlen = ((srclen + adjustment) / 3) * 4;
+	if (linelen == 0)
+		return b64_encode_run(s, srclen, dst, simd);
 
-	dstlen = paddedlen + paddedlen / linelen;
+	size_t linechars = b64_line_chars(linelen);
+	size_t linebytes = (linechars / 4) * 3;
+	size_t dstpos = 0;
+
+	for (size_t srcpos = 0; srcpos < srclen; srcpos += linebytes)
+	{
+		size_t len = std::min(linebytes, srclen - srcpos);
+		size_t chars = b64_encode_run(s + srcpos, len, dst + dstpos, simd);
+		dstpos += chars;
+
+		// Only complete lines end with a line break.
+		if (chars == linechars)
+			dst[dstpos++] = '\n';
+	}
+
+	return dstpos;
+}
+
+char *b64_encode(const char *src, size_t srclen, size_t linelen, size_t &dstlen)
+{
+	dstlen = b64_encoded_size(srclen, linelen);
 
 	if (dstlen == 0)
 		return nullptr;
@@ -70,107 +338,94 @@ char *b64_encode(const char *src, size_t srclen, size_t linelen, size_t &dstlen)
 		throw love::Exception("Out of memory.");
 	}
 
+	dstlen = b64_encode(src, srclen, linelen, dst, dstlen);
+	dst[dstlen] = '\0';
+	return dst;
+}
+
+size_t b64_decoded_max_size(size_t srclen)
+{
+	return ((srclen + 3) / 4) * 3;
+}
+
+size_t b64_decode(const char *src, size_t srclen, char *dst, size_t dstsize)
+{
+	bool simd = b64_has_simd();
+
+	size_t srcpos = 0;
 	size_t dstpos = 0;
 
+	uint32 bits = 0;
+	int count = 0;
+
 	while (srcpos < srclen)
 	{
-		char in[3]  = {0};
-		char out[4] = {0};
-
-		int len = 0;
-
-		for (int i = 0; i < 3; i++)
+#if defined(LOVE_B64_SSSE3) || defined(LOVE_B64_NEON)
+		// Runs of valid characters are decoded in bulk, in between any line
+		// breaks or other skipped characters.
+		if (simd && count == 0)
 		{
+			size_t written = 0;
+			srcpos += b64_decode_simd(src + srcpos, srclen - srcpos, dst + dstpos, dstsize - dstpos, written);
+			dstpos += written;
+
 			if (srcpos >= srclen)
 				break;
-
-			in[i] = src[srcpos++];
-			len++;
 		}
+#else
+		(void) simd;
+#endif
 
-		if (len > 0)
-		{
-			b64_encode_block(in, out, len);
-
-			for (int i = 0; i < 4 && dstpos < dstlen; i++, dstpos++)
-				dst[dstpos] = out[i];
+		int v = cd64[(uint8) src[srcpos++]];
+		if (v < 0)
+			continue;
 
-			blocksout++;
-		}
+		bits = (bits << 6) | (uint32) v;
 
-		if (blocksout >= linelen / 4 || srcpos >= srclen)
+		if (++count == 4)
 		{
-			if (blocksout > 0 && dstpos < dstlen)
-				dst[dstpos++] = '\n';
+			if (dstsize - dstpos < 3)
+				throw love::Exception("Not enough space to store the base64-decoded data.");
+
+			dst[dstpos++] = (char) ((bits >> 16) & 0xFF);
+			dst[dstpos++] = (char) ((bits >> 8) & 0xFF);
+			dst[dstpos++] = (char) (bits & 0xFF);
 
-			blocksout = 0;
+			bits = 0;
+			count = 0;
 		}
 	}
 
-	dst[dstpos] = '\0';
-	return dst;
-}
+	// A trailing partial block of 2 or 3 characters still holds 1 or 2 bytes.
+	if (count >= 2)
+	{
+		bits <<= 6 * (4 - count);
 
-static void b64_decode_block(char in[4], char out[3])
-{
-	out[0] = (char)(in[0] << 2 | in[1] >> 4);
-	out[1] = (char)(in[1] << 4 | in[2] >> 2);
-	out[2] = (char)(((in[2] << 6) & 0xc0) | in[3]);
+		if (dstsize - dstpos < (size_t) (count - 1))
+			throw love::Exception("Not enough space to store the base64-decoded data.");
+
+		for (int i = 0; i < count - 1; i++)
+			dst[dstpos++] = (char) ((bits >> (16 - i * 8)) & 0xFF);
+	}
+
+	return dstpos;
 }
 
 char *b64_decode(const char *src, size_t srclen, size_t &size)
 {
-	size_t paddedsize = (srclen / 4) * 3;
+	size_t maxsize = b64_decoded_max_size(srclen);
 
 	char *dst = nullptr;
 	try
 	{
-		dst = new char[paddedsize];
+		dst = new char[std::max<size_t>(maxsize, 1)];
 	}
 	catch (std::exception &)
 	{
 		throw love::Exception("Out of memory.");
 	}
 
-	char *d = dst;
-
-	char in[4]  = {0};
-	char out[3] = {0};
-	size_t i, len, srcpos = 0;
-
-	while (srcpos <= srclen)
-	{
-		for (len = 0, i = 0; i < 4 && srcpos <= srclen; i++)
-		{
-			char v = 0;
-
-			while (srcpos <= srclen && v == 0)
-			{
-				v = src[srcpos++];
-				v = (char)((v < 43 || v > 122) ? 0 : cd64[v - 43]);
-				if (v != 0)
-					v = (char)((v == '$') ? 0 : v - 61);
-			}
-
-			if (srcpos <= srclen)
-			{
-				len++;
-				if (v != 0)
-					in[i] = (char)(v - 1);
-			}
-			else
-				in[i] = 0;
-		}
-
-		if (len)
-		{
-			b64_decode_block(in, out);
-			for (i = 0; i < len - 1; i++)
-				 *(d++) = out[i];
-		}
-	}
-
-	size = (size_t)(ptrdiff_t) (d - dst);
+	size = b64_decode(src, srclen, dst, maxsize);
 	return dst;
 }
 
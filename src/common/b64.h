@@ -40,6 +40,19 @@ namespace love
  */
 char *b64_encode(const char *src, size_t srclen, size_t linelen, size_t &dstlen);
 
+/**
+ * Gets the length of the base64-encoded string for some data.
+ */
+size_t b64_encoded_size(size_t srclen, size_t linelen);
+
+/**
+ * Base64-encode data into an existing buffer, without a null terminator.
+ * Throws if the buffer is smaller than b64_encoded_size.
+ *
+ * @return The length of the encoded string.
+ */
+size_t b64_encode(const char *src, size_t srclen, size_t linelen, char *dst, size_t dstsize);
+
 /**
  * Decode base64 encoded data.
  *
@@ -50,6 +63,20 @@ char *b64_encode(const char *src, size_t srclen, size_t linelen, size_t &dstlen)
  */
 char *b64_decode(const char *src, size_t srclen, size_t &dstlen);
 
+/**
+ * Gets the largest possible size of decoded base64 data, for a string of the
+ * given length.
+ */
+size_t b64_decoded_max_size(size_t srclen);
+
+/**
+ * Decode base64 encoded data into an existing buffer. Throws if the buffer
+ * is too small for the decoded data.
+ *
+ * @return The size of the decoded data.
+ */
+size_t b64_decode(const char *src, size_t srclen, char *dst, size_t dstsize);
+
 } // love
 
 #endif // LOVE_B64_H
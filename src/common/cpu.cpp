@@ -0,0 +1,108 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "cpu.h"
+
+#ifdef LOVE_CPU_X86
+#	if defined(_MSC_VER) && !defined(__clang__)
+#		include <intrin.h>
+#	else
+#		include <cpuid.h>
+#	endif
+#endif
+
+namespace love
+{
+namespace cpu
+{
+
+namespace
+{
+
+struct Features
+{
+	bool ssse3 = false;
+	bool sse41 = false;
+	bool sha = false;
+
+	Features()
+	{
+#ifdef LOVE_CPU_X86
+		unsigned int regs1[4] = {};
+		unsigned int regs7[4] = {};
+		unsigned int maxleaf = 0;
+
+#if defined(_MSC_VER) && !defined(__clang__)
+		int info[4] = {};
+		__cpuid(info, 0);
+		maxleaf = (unsigned int) info[0];
+		if (maxleaf >= 1)
+		{
+			__cpuid(info, 1);
+			for (int i = 0; i < 4; i++)
+				regs1[i] = (unsigned int) info[i];
+		}
+		if (maxleaf >= 7)
+		{
+			__cpuidex(info, 7, 0);
+			for (int i = 0; i < 4; i++)
+				regs7[i] = (unsigned int) info[i];
+		}
+#else
+		maxleaf = __get_cpuid_max(0, nullptr);
+		if (maxleaf >= 1)
+			__cpuid(1, regs1[0], regs1[1], regs1[2], regs1[3]);
+		if (maxleaf >= 7)
+			__cpuid_count(7, 0, regs7[0], regs7[1], regs7[2], regs7[3]);
+#endif
+
+		// Registers are in eax, ebx, ecx, edx order.
+		ssse3 = (regs1[2] & (1u << 9)) != 0;
+		sse41 = (regs1[2] & (1u << 19)) != 0;
+		sha = (regs7[1] & (1u << 29)) != 0;
+#endif
+	}
+};
+
+const Features &getFeatures()
+{
+	static const Features features;
+	return features;
+}
+
+} // anonymous namespace
+
+bool hasSSSE3()
+{
+	return getFeatures().ssse3;
+}
+
+bool hasSSE41()
+{
+	return getFeatures().sse41;
+}
+
+bool hasSHA()
+{
+	return getFeatures().sha;
+}
+
+} // cpu
+} // love
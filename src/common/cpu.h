@@ -0,0 +1,55 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_CPU_H
+#define LOVE_CPU_H
+
+#include "config.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#	define LOVE_CPU_X86
+#endif
+
+// Lets a function use instructions beyond the compiler's target, for code
+// which is only called after checking for them at runtime. MSVC doesn't need
+// it.
+#if defined(_MSC_VER) && !defined(__clang__)
+#	define LOVE_CPU_TARGET(x)
+#else
+#	define LOVE_CPU_TARGET(x) __attribute__((target(x)))
+#endif
+
+namespace love
+{
+namespace cpu
+{
+
+/**
+ * Whether the current CPU supports an x86 instruction set extension. These
+ * are always false on other architectures.
+ **/
+bool hasSSSE3();
+bool hasSSE41();
+bool hasSHA();
+
+} // cpu
+} // love
+
+#endif // LOVE_CPU_H
@@ -19,16 +19,98 @@
  **/
 
 #include "delay.h"
+#include "config.h"
+
+#if defined(LOVE_WINDOWS)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#elif defined(LOVE_LINUX) || defined(LOVE_ANDROID) || defined(LOVE_MACOS) || defined(LOVE_IOS)
+#include <time.h>
+#include <errno.h>
+#define LOVE_DELAY_NANOSLEEP
+#endif
 
 #include <SDL_timer.h>
 #include <SDL_version.h>
 
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
 namespace love
 {
 
-// TODO: use ns.
+#if defined(LOVE_WINDOWS)
+
+// Sleep and SDL_Delay are limited by the system timer resolution, which is
+// often 15.6ms unless timeBeginPeriod is used. High resolution waitable timers
+// (Windows 10 1803+) don't have that limitation.
+struct WaitableTimer
+{
+	HANDLE handle = nullptr;
+
+	WaitableTimer()
+	{
+		handle = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+		if (handle == nullptr)
+			handle = CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+	}
+
+	~WaitableTimer()
+	{
+		if (handle != nullptr)
+			CloseHandle(handle);
+	}
+};
+
+static bool waitableTimerSleep(double ms)
+{
+	static thread_local WaitableTimer timer;
+	if (timer.handle == nullptr)
+		return false;
+
+	// Negative values are relative, in 100 nanosecond intervals.
+	LARGE_INTEGER duetime;
+	duetime.QuadPart = -(LONGLONG)(ms * 10000.0);
+
+	if (!SetWaitableTimerEx(timer.handle, &duetime, 0, nullptr, nullptr, nullptr, 0))
+		return false;
+
+	return WaitForSingleObject(timer.handle, INFINITE) == WAIT_OBJECT_0;
+}
+
+#endif // LOVE_WINDOWS
+
 void sleep(double ms)
 {
+	// A 0ms sleep should still give up the rest of the time slice, which the
+	// SDL path below does.
+	if (ms > 0.0)
+	{
+#if defined(LOVE_WINDOWS)
+		if (waitableTimerSleep(ms))
+			return;
+#elif defined(LOVE_DELAY_NANOSLEEP)
+		// SDL2's SDL_Delay truncates to whole milliseconds.
+		timespec t;
+		t.tv_sec = (time_t)(ms / 1000.0);
+		t.tv_nsec = (long)((ms - (double) t.tv_sec * 1000.0) * 1000000.0);
+
+#if defined(LOVE_LINUX) || defined(LOVE_ANDROID)
+		// The monotonic clock isn't affected by system time changes.
+		while (clock_nanosleep(CLOCK_MONOTONIC, 0, &t, &t) == EINTR)
+			;
+#else
+		while (nanosleep(&t, &t) != 0)
+		{
+			if (errno != EINTR)
+				break;
+		}
+#endif
+		return;
+#endif
+	}
+
 	// We don't need to initialize the SDL timer subsystem for SDL_Delay to
 	// function - and doing so causes SDL to create a worker thread.
 #if SDL_VERSION_ATLEAST(3, 0, 0)
@@ -0,0 +1,126 @@
+R"luastring"--(
+-- DO NOT REMOVE THE ABOVE LINE. It is used to load this file as a C++ string.
+-- There is a matching delimiter at the bottom of the file.
+
+--[[
+Copyright (c) 2006-2024 LOVE Development Team
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+claim that you wrote the original software. If you use this software
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+--]]
+
+
+-- Shared setup for the LuaJIT FFI versions of LOVE's wrapper functions. This
+-- file is executed once per Lua state, and the table it returns is sent as an
+-- argument to the wrapper Lua files (see luax_runwrapper in runtime.cpp).
+
+if type(jit) ~= "table" then return nil end
+
+local status, ffi = pcall(require, "ffi")
+if not status then return nil end
+
+local type, pcall = type, pcall
+local getmetatable, setmetatable = getmetatable, setmetatable
+
+pcall(ffi.cdef, [[
+typedef struct Proxy Proxy;
+]])
+
+local ffiwrapper = {
+	ffi = ffi,
+}
+
+-- LuaJIT's FFI is *much* slower than LOVE's regular methods when the JIT
+-- compiler is disabled, so fast paths should only be installed when it's on.
+function ffiwrapper.isjitenabled()
+	return jit.status()
+end
+
+-- Declares the struct of C function pointers matching the one in the C++
+-- wrapper code, and returns the instance whose address was sent as a string.
+function ffiwrapper.getfuncs(structname, cdecl, pointerstr)
+	pcall(ffi.cdef, cdecl)
+	return ffi.cast(structname.." **", pointerstr)[0]
+end
+
+-- Metatables of LOVE objects as keys, and tables of type name -> bool as values.
+local typecache = setmetatable({}, {__mode = "k"})
+
+-- Returns whether a value is a LOVE object of the given type. Values coming
+-- from user code must pass this before they're given to an FFI function which
+-- expects a Proxy pointer. The result is cached per metatable, since all
+-- objects of the same type share one.
+function ffiwrapper.istype(v, typename)
+	if type(v) ~= "userdata" then return false end
+
+	local mt = getmetatable(v)
+	if type(mt) ~= "table" then return false end
+
+	local types = typecache[mt]
+	if types == nil then
+		types = {}
+		typecache[mt] = types
+	end
+
+	local result = types[typename]
+	if result == nil then
+		result = type(mt.typeOf) == "function" and mt.typeOf(v, typename) == true
+		types[typename] = result
+	end
+
+	return result
+end
+
+local function isoptnumber(v)
+	return v == nil or type(v) == "number"
+end
+
+-- Matches luax_checkstandardtransform in wrap_SpriteBatch.h: writes the x, y,
+-- angle, sx, sy, ox, oy, kx, ky arguments with their defaults into a float[9]
+-- array. Returns false without touching the array if the arguments are
+-- anything else (a Transform, a Quad, strings, ...), so the caller can fall
+-- back to the regular function and its argument handling.
+function ffiwrapper.packstandardtransform(out, x, y, a, sx, sy, ox, oy, kx, ky)
+	if not (isoptnumber(x) and isoptnumber(y) and isoptnumber(a)
+		and isoptnumber(sx) and isoptnumber(sy) and isoptnumber(ox)
+		and isoptnumber(oy) and isoptnumber(kx) and isoptnumber(ky)) then
+		return false
+	end
+
+	-- A nil in place of a Quad followed by more arguments is an error.
+	if x == nil and y ~= nil then
+		return false
+	end
+
+	sx = sx or 1
+
+	out[0] = x or 0
+	out[1] = y or 0
+	out[2] = a or 0
+	out[3] = sx
+	out[4] = sy or sx
+	out[5] = ox or 0
+	out[6] = oy or 0
+	out[7] = kx or 0
+	out[8] = ky or 0
+
+	return true
+end
+
+return ffiwrapper
+
+-- DO NOT REMOVE THE NEXT LINE. It is used to load this file as a C++ string.
+--)luastring"--"
@@ -22,6 +22,9 @@
 #include "memory.h"
 
 #include <stdlib.h>
+#include <new>
+#include <algorithm>
+#include <atomic>
 
 #ifdef LOVE_WINDOWS
 #define WIN32_LEAN_AND_MEAN
@@ -76,4 +79,200 @@ size_t alignUp(size_t size, size_t alignment)
 	return (size + alignment - 1) & (~(alignment - 1));
 }
 
+// The size of the first chunk allocated by a FrameArena.
+static const size_t FRAME_ARENA_MIN_CHUNK_SIZE = 64 * 1024;
+
+FrameArena &FrameArena::getInstance()
+{
+	static thread_local FrameArena arena;
+	return arena;
+}
+
+FrameArena::FrameArena()
+	: chunkIndex(0)
+	, offset(0)
+	, liveAllocations(0)
+{
+}
+
+FrameArena::~FrameArena()
+{
+	for (const Chunk &chunk : chunks)
+		alignedFree(chunk.data);
+}
+
+FrameArena::Chunk FrameArena::createChunk(size_t size)
+{
+	Chunk chunk = {nullptr, size};
+	if (!alignedMalloc((void **) &chunk.data, size, MAX_ALIGNMENT))
+		throw std::bad_alloc();
+	return chunk;
+}
+
+void *FrameArena::allocate(size_t size, size_t alignment)
+{
+	alignment = std::max(alignment, (size_t) 1);
+	if (alignment > MAX_ALIGNMENT)
+		throw std::bad_alloc();
+
+	while (chunkIndex < chunks.size())
+	{
+		const Chunk &chunk = chunks[chunkIndex];
+		size_t start = alignUp(offset, alignment);
+
+		if (start + size <= chunk.size)
+		{
+			offset = start + size;
+			liveAllocations++;
+			return chunk.data + start;
+		}
+
+		chunkIndex++;
+		offset = 0;
+	}
+
+	size_t chunksize = FRAME_ARENA_MIN_CHUNK_SIZE;
+	if (!chunks.empty())
+		chunksize = chunks.back().size * 2;
+	chunksize = std::max(chunksize, alignUp(size, MAX_ALIGNMENT));
+
+	chunks.push_back(createChunk(chunksize));
+
+	chunkIndex = chunks.size() - 1;
+	offset = size;
+	liveAllocations++;
+
+	return chunks.back().data;
+}
+
+void FrameArena::deallocate(void *mem)
+{
+	if (mem == nullptr || liveAllocations == 0)
+		return;
+
+	if (--liveAllocations == 0)
+		rewind();
+}
+
+void FrameArena::rewind()
+{
+	chunkIndex = 0;
+	offset = 0;
+}
+
+void FrameArena::reset()
+{
+	// Memory in use can't be moved, so wait for a frame where it's all free.
+	if (liveAllocations > 0)
+		return;
+
+	rewind();
+
+	if (chunks.size() > 1)
+	{
+		// Replace the chunks with one big enough for everything they held.
+		size_t total = getCapacity();
+
+		for (const Chunk &chunk : chunks)
+			alignedFree(chunk.data);
+		chunks.clear();
+
+		chunks.push_back(createChunk(total));
+	}
+}
+
+size_t FrameArena::getCapacity() const
+{
+	size_t total = 0;
+	for (const Chunk &chunk : chunks)
+		total += chunk.size;
+	return total;
+}
+
+FreeList::FreeList(size_t maxBlocks)
+	: head(nullptr)
+	, count(0)
+	, maxBlocks(maxBlocks)
+{
+}
+
+FreeList::~FreeList()
+{
+	while (head != nullptr)
+	{
+		Block *next = head->next;
+		::operator delete(head);
+		head = next;
+	}
+
+	// Anything freed on this thread after this point goes to the global
+	// allocator.
+	count = 0;
+	maxBlocks = 0;
+}
+
+void *FreeList::pop()
+{
+	if (head == nullptr)
+		return nullptr;
+
+	Block *block = head;
+	head = block->next;
+	count--;
+	return block;
+}
+
+bool FreeList::push(void *mem)
+{
+	if (count >= maxBlocks)
+		return false;
+
+	Block *block = (Block *) mem;
+	block->next = head;
+	head = block;
+	count++;
+	return true;
+}
+
+static std::atomic<int64> trackedMemory[MEMORYTAG_MAX_ENUM];
+static std::atomic<int64> trackedMemoryPeaks[MEMORYTAG_MAX_ENUM];
+
+void trackMemory(MemoryTag tag, int64 size)
+{
+	int64 total = trackedMemory[tag].fetch_add(size, std::memory_order_relaxed) + size;
+
+	int64 peak = trackedMemoryPeaks[tag].load(std::memory_order_relaxed);
+	while (total > peak && !trackedMemoryPeaks[tag].compare_exchange_weak(peak, total, std::memory_order_relaxed))
+	{
+	}
+}
+
+int64 getTrackedMemory(MemoryTag tag)
+{
+	return trackedMemory[tag].load(std::memory_order_relaxed);
+}
+
+int64 getTrackedMemoryPeak(MemoryTag tag)
+{
+	return trackedMemoryPeaks[tag].load(std::memory_order_relaxed);
+}
+
+void resetTrackedMemoryPeaks()
+{
+	for (int i = 0; i < MEMORYTAG_MAX_ENUM; i++)
+		trackedMemoryPeaks[i].store(trackedMemory[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+STRINGMAP_BEGIN(MemoryTag, MEMORYTAG_MAX_ENUM, memoryTag)
+{
+	{ "texture",   MEMORYTAG_TEXTURE   },
+	{ "buffer",    MEMORYTAG_BUFFER    },
+	{ "font",      MEMORYTAG_FONT      },
+	{ "sounddata", MEMORYTAG_SOUNDDATA },
+	{ "imagedata", MEMORYTAG_IMAGEDATA },
+	{ "physics",   MEMORYTAG_PHYSICS   },
+	{ "variant",   MEMORYTAG_VARIANT   },
+}
+STRINGMAP_END(MemoryTag, MEMORYTAG_MAX_ENUM, memoryTag)
+
 } // love
@@ -20,7 +20,12 @@
 
 #pragma once
 
+#include "int.h"
+#include "StringMap.h"
+
 #include <stddef.h>
+#include <cstddef>
+#include <vector>
 
 namespace love
 {
@@ -35,4 +40,202 @@ size_t getPageSize();
  **/
 size_t alignUp(size_t size, size_t alignment);
 
+/**
+ * Subsystems whose memory use is counted, for love.system.getMemoryStats.
+ **/
+enum MemoryTag
+{
+	MEMORYTAG_TEXTURE,
+	MEMORYTAG_BUFFER,
+	MEMORYTAG_FONT,
+	MEMORYTAG_SOUNDDATA,
+	MEMORYTAG_IMAGEDATA,
+	MEMORYTAG_PHYSICS,
+	MEMORYTAG_VARIANT, // Strings and tables in Variants, and Channel storage.
+	MEMORYTAG_MAX_ENUM
+};
+
+/**
+ * Adds (or with a negative size, removes) memory to a tag's total. Thread-safe.
+ **/
+void trackMemory(MemoryTag tag, int64 size);
+
+int64 getTrackedMemory(MemoryTag tag);
+
+/**
+ * The highest total a tag has reached, since startup or the last reset.
+ **/
+int64 getTrackedMemoryPeak(MemoryTag tag);
+void resetTrackedMemoryPeaks();
+
+STRINGMAP_DECLARE(MemoryTag);
+
+/**
+ * A bump allocator for short-lived allocations, such as the temporary arrays
+ * used while building a draw. Each thread has its own arena.
+ *
+ * Freeing an allocation doesn't reclaim its memory. The arena rewinds once
+ * every allocation made from it has been freed, and reset() (called by
+ * love.graphics.present) merges the chunks used during the frame into one, so
+ * a typical frame ends up with a single chunk and no calls to malloc or free.
+ * Allocations which outlive a frame only delay that, so don't store
+ * FrameVectors in long-lived objects.
+ **/
+class FrameArena
+{
+public:
+
+	// The maximum alignment of allocations.
+	static const size_t MAX_ALIGNMENT = 64;
+
+	static FrameArena &getInstance();
+
+	void *allocate(size_t size, size_t alignment);
+	void deallocate(void *mem);
+
+	void reset();
+
+	size_t getCapacity() const;
+	size_t getLiveAllocationCount() const { return liveAllocations; }
+
+	~FrameArena();
+
+private:
+
+	struct Chunk
+	{
+		uint8 *data;
+		size_t size;
+	};
+
+	FrameArena();
+
+	static Chunk createChunk(size_t size);
+	void rewind();
+
+	std::vector<Chunk> chunks;
+	size_t chunkIndex;
+	size_t offset;
+	size_t liveAllocations;
+
+}; // FrameArena
+
+/**
+ * Standard library allocator which allocates from the current thread's
+ * FrameArena.
+ **/
+template <typename T>
+class FrameAllocator
+{
+public:
+
+	typedef T value_type;
+
+	FrameAllocator()
+		: arena(&FrameArena::getInstance())
+	{}
+
+	template <typename U>
+	FrameAllocator(const FrameAllocator<U> &other)
+		: arena(other.arena)
+	{}
+
+	T *allocate(size_t count)
+	{
+		return (T *) arena->allocate(count * sizeof(T), alignof(T));
+	}
+
+	void deallocate(T *mem, size_t /*count*/)
+	{
+		arena->deallocate(mem);
+	}
+
+	template <typename U>
+	bool operator == (const FrameAllocator<U> &other) const { return arena == other.arena; }
+
+	template <typename U>
+	bool operator != (const FrameAllocator<U> &other) const { return arena != other.arena; }
+
+	// Vectors free their memory on the thread which allocated it.
+	FrameArena *arena;
+
+}; // FrameAllocator
+
+template <typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
+
+/**
+ * A per-thread list of freed memory blocks of one size, which are handed out
+ * again instead of going through malloc and free. Blocks freed on a different
+ * thread than the one which allocated them simply move to that thread's list.
+ **/
+class FreeList
+{
+public:
+
+	FreeList(size_t maxBlocks);
+	~FreeList();
+
+	// Returns nullptr if the list is empty.
+	void *pop();
+
+	// Returns false if the list is full, in which case the caller frees it.
+	bool push(void *mem);
+
+private:
+
+	struct Block
+	{
+		Block *next;
+	};
+
+	Block *head;
+	size_t count;
+	size_t maxBlocks;
+
+}; // FreeList
+
+/**
+ * Inheriting from Pooled<T> makes new and delete of T go through a per-thread
+ * FreeList, for types with many short-lived instances (Transforms, Quads,
+ * physics Contacts). Subclasses of T, which have a different size, use the
+ * global allocator.
+ **/
+template <typename T, size_t MAX_FREE_BLOCKS = 1024>
+class Pooled
+{
+public:
+
+	static void *operator new(size_t size)
+	{
+		static_assert(alignof(T) <= alignof(std::max_align_t), "Pooled types can't be over-aligned.");
+
+		if (size == sizeof(T))
+		{
+			void *mem = getFreeList().pop();
+			if (mem != nullptr)
+				return mem;
+		}
+
+		return ::operator new(size);
+	}
+
+	static void operator delete(void *mem, size_t size)
+	{
+		if (mem != nullptr && size == sizeof(T) && getFreeList().push(mem))
+			return;
+
+		::operator delete(mem);
+	}
+
+private:
+
+	static FreeList &getFreeList()
+	{
+		static thread_local FreeList list(MAX_FREE_BLOCKS);
+		return list;
+	}
+
+}; // Pooled
+
 } // love
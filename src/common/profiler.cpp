@@ -0,0 +1,342 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+
+#include "common/config.h"
+#include "profiler.h"
+#include "thread/threads.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <sstream>
+#include <unordered_set>
+#include <vector>
+
+namespace love
+{
+
+namespace
+{
+
+struct ZoneEvent
+{
+	const char *name;
+	int64 begin;
+	int64 end;
+};
+
+struct OpenZone
+{
+	const char *name;
+	int64 begin;
+
+	// Whether the zone is recorded when it ends, rather than only tracked for
+	// the sampler.
+	bool record;
+
+	// The innermost native zone outside this one, if this is a native zone.
+	bool native;
+	const char *outerNativeZone;
+};
+
+} // anonymous namespace
+
+struct ProfileThread
+{
+	static const size_t CAPACITY = 16384;
+
+	ProfileThread(int id)
+		: id(id)
+		, events(CAPACITY)
+		, written(0)
+		, cleared(0)
+		, nativeZone(nullptr)
+	{}
+
+	int id;
+	std::string name;
+
+	// Only the owning thread writes events. Readers use the write count to
+	// know which entries are complete.
+	std::vector<ZoneEvent> events;
+	std::atomic<uint64> written;
+
+	// Events written before this count have been discarded.
+	std::atomic<uint64> cleared;
+
+	// Only touched by the owning thread.
+	std::vector<OpenZone> openZones;
+
+	// The innermost open zone begun from native code, read by the sampler.
+	// Native zone names are string literals, so they're safe to read from
+	// other threads at any time.
+	std::atomic<const char *> nativeZone;
+
+	// Dynamic zone names. Elements never move once inserted, so recorded
+	// events can point at them.
+	std::unordered_set<std::string> names;
+
+	bool retired = false;
+};
+
+namespace
+{
+
+enum ActiveFlags
+{
+	ACTIVE_RECORDING = 1 << 0,
+	ACTIVE_SAMPLING = 1 << 1,
+};
+
+std::atomic<int> active(0);
+
+void setActiveFlag(int flag, bool enable)
+{
+	if (enable)
+		active.fetch_or(flag, std::memory_order_relaxed);
+	else
+		active.fetch_and(~flag, std::memory_order_relaxed);
+}
+
+thread::Mutex *getRegistryMutex()
+{
+	static thread::Mutex *mutex = thread::newMutex();
+	return mutex;
+}
+
+// Buffers are never freed, so a thread's zones can still be exported after
+// it exits. Retired buffers are reused by new threads.
+std::vector<ProfileThread *> &getRegistry()
+{
+	static std::vector<ProfileThread *> buffers;
+	return buffers;
+}
+
+const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+int64 now()
+{
+	auto elapsed = std::chrono::steady_clock::now() - startTime;
+	return (int64) std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+}
+
+struct ThreadBufferOwner
+{
+	ProfileThread *buffer = nullptr;
+
+	// Applied when the buffer is created, so naming a thread doesn't allocate
+	// a buffer for it unless it records zones.
+	std::string name;
+
+	~ThreadBufferOwner()
+	{
+		if (buffer == nullptr)
+			return;
+
+		thread::Lock lock(getRegistryMutex());
+		buffer->retired = true;
+	}
+};
+
+thread_local ThreadBufferOwner threadBuffer;
+
+ProfileThread *getThreadBuffer()
+{
+	if (threadBuffer.buffer != nullptr)
+		return threadBuffer.buffer;
+
+	thread::Lock lock(getRegistryMutex());
+	auto &registry = getRegistry();
+
+	for (ProfileThread *buffer : registry)
+	{
+		if (buffer->retired)
+		{
+			buffer->retired = false;
+			buffer->name = threadBuffer.name;
+			buffer->openZones.clear();
+			buffer->nativeZone.store(nullptr, std::memory_order_relaxed);
+			buffer->names.clear();
+			buffer->cleared.store(buffer->written.load(std::memory_order_acquire), std::memory_order_release);
+			threadBuffer.buffer = buffer;
+			return buffer;
+		}
+	}
+
+	ProfileThread *buffer = new ProfileThread((int) registry.size() + 1);
+	buffer->name = threadBuffer.name;
+	registry.push_back(buffer);
+	threadBuffer.buffer = buffer;
+	return buffer;
+}
+
+void writeEscaped(std::stringstream &ss, const std::string &str)
+{
+	for (char c : str)
+	{
+		if (c == '"' || c == '\\')
+			ss << '\\' << c;
+		else if ((unsigned char) c < 0x20)
+			ss << ' ';
+		else
+			ss << c;
+	}
+}
+
+} // anonymous namespace
+
+void setProfilerEnabled(bool enable)
+{
+	setActiveFlag(ACTIVE_RECORDING, enable);
+}
+
+bool isProfilerEnabled()
+{
+	return (active.load(std::memory_order_relaxed) & ACTIVE_RECORDING) != 0;
+}
+
+void setProfilerSampling(bool sampling)
+{
+	setActiveFlag(ACTIVE_SAMPLING, sampling);
+}
+
+bool isProfilerActive()
+{
+	return active.load(std::memory_order_relaxed) != 0;
+}
+
+void beginProfileZone(const char *name)
+{
+	ProfileThread *buffer = getThreadBuffer();
+	const char *outer = buffer->nativeZone.load(std::memory_order_relaxed);
+	buffer->openZones.push_back({name, now(), isProfilerEnabled(), true, outer});
+	buffer->nativeZone.store(name, std::memory_order_relaxed);
+}
+
+void beginProfileZone(const std::string &name)
+{
+	ProfileThread *buffer = getThreadBuffer();
+	const char *interned = buffer->names.insert(name).first->c_str();
+	buffer->openZones.push_back({interned, now(), true, false, nullptr});
+}
+
+bool endProfileZone()
+{
+	ProfileThread *buffer = threadBuffer.buffer;
+	if (buffer == nullptr || buffer->openZones.empty())
+		return false;
+
+	OpenZone zone = buffer->openZones.back();
+	buffer->openZones.pop_back();
+
+	if (zone.native)
+		buffer->nativeZone.store(zone.outerNativeZone, std::memory_order_relaxed);
+
+	if (zone.record)
+	{
+		uint64 index = buffer->written.load(std::memory_order_relaxed);
+		buffer->events[index % ProfileThread::CAPACITY] = {zone.name, zone.begin, now()};
+		buffer->written.store(index + 1, std::memory_order_release);
+	}
+
+	return true;
+}
+
+ProfileThread *getCurrentProfileThread()
+{
+	return getThreadBuffer();
+}
+
+const char *getProfileThreadZone(const ProfileThread *thread)
+{
+	return thread->nativeZone.load(std::memory_order_relaxed);
+}
+
+void setProfilerThreadName(const std::string &name)
+{
+	threadBuffer.name = name;
+
+	if (threadBuffer.buffer != nullptr)
+	{
+		thread::Lock lock(getRegistryMutex());
+		threadBuffer.buffer->name = name;
+	}
+}
+
+void clearProfile()
+{
+	thread::Lock lock(getRegistryMutex());
+	for (ProfileThread *buffer : getRegistry())
+		buffer->cleared.store(buffer->written.load(std::memory_order_acquire), std::memory_order_release);
+}
+
+std::string getProfileTraceJSON()
+{
+	std::stringstream ss;
+	ss << "{\"traceEvents\":[";
+
+	bool first = true;
+	std::vector<ZoneEvent> events;
+
+	thread::Lock lock(getRegistryMutex());
+
+	for (ProfileThread *buffer : getRegistry())
+	{
+		uint64 written = buffer->written.load(std::memory_order_acquire);
+		uint64 start = written > ProfileThread::CAPACITY ? written - ProfileThread::CAPACITY : 0;
+		start = std::max(start, buffer->cleared.load(std::memory_order_acquire));
+
+		events.clear();
+		for (uint64 i = start; i < written; i++)
+			events.push_back(buffer->events[i % ProfileThread::CAPACITY]);
+
+		// The owning thread may have overwritten the oldest entries while
+		// they were being copied; drop those.
+		uint64 after = buffer->written.load(std::memory_order_acquire);
+		size_t skip = 0;
+		if (after > ProfileThread::CAPACITY && after - ProfileThread::CAPACITY > start)
+			skip = (size_t) std::min<uint64>(after - ProfileThread::CAPACITY - start, events.size());
+
+		if (!buffer->name.empty())
+		{
+			ss << (first ? "" : ",") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->id << ",\"args\":{\"name\":\"";
+			writeEscaped(ss, buffer->name);
+			ss << "\"}}";
+			first = false;
+		}
+
+		for (size_t i = skip; i < events.size(); i++)
+		{
+			const ZoneEvent &e = events[i];
+			ss << (first ? "" : ",") << "{\"name\":\"";
+			writeEscaped(ss, e.name);
+			ss << "\",\"cat\":\"love\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->id;
+			ss << ",\"ts\":" << (e.begin / 1000) << "." << (e.begin % 1000) / 100;
+			ss << ",\"dur\":" << ((e.end - e.begin) / 1000) << "." << ((e.end - e.begin) % 1000) / 100 << "}";
+			first = false;
+		}
+	}
+
+	ss << "]}";
+	return ss.str();
+}
+
+} // love
@@ -0,0 +1,98 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+
+#pragma once
+
+#include "int.h"
+
+#include <string>
+
+namespace love
+{
+
+/**
+ * Lightweight CPU zone profiler. Each thread records completed zones into its
+ * own fixed-size ring buffer without taking any locks, so zones can be placed
+ * in hot paths. Recording is off by default and costs a single atomic load per
+ * zone while disabled.
+ **/
+
+void setProfilerEnabled(bool enable);
+bool isProfilerEnabled();
+
+// While sampling, zones begun from native code are tracked (but not recorded
+// unless the profiler is enabled) so a sampler can see which one a thread is
+// in.
+void setProfilerSampling(bool sampling);
+
+// Whether zones are recorded or tracked for sampling.
+bool isProfilerActive();
+
+// The name must remain valid for as long as recorded zones are kept, e.g. a
+// string literal. Use the std::string variant for dynamic names.
+void beginProfileZone(const char *name);
+void beginProfileZone(const std::string &name);
+
+// Returns false if there was no open zone on this thread.
+bool endProfileZone();
+
+// Identifies a thread's zones, for reading them from another thread.
+struct ProfileThread;
+
+ProfileThread *getCurrentProfileThread();
+
+// Gets the name of the innermost native zone the given thread is in, or null.
+// Can be called from any thread.
+const char *getProfileThreadZone(const ProfileThread *thread);
+
+// Names the calling thread in exported traces.
+void setProfilerThreadName(const std::string &name);
+
+// Discards all recorded zones.
+void clearProfile();
+
+// Returns all recorded zones in the Chrome trace event JSON format, which can
+// be loaded by chrome://tracing, Perfetto, or Tracy's import-chrome tool.
+std::string getProfileTraceJSON();
+
+struct ProfileZone
+{
+	ProfileZone(const char *name)
+		: active(isProfilerActive())
+	{
+		if (active)
+			beginProfileZone(name);
+	}
+
+	~ProfileZone()
+	{
+		if (active)
+			endProfileZone();
+	}
+
+	bool active;
+};
+
+#define LOVE_PROFILE_CONCAT_(a, b) a##b
+#define LOVE_PROFILE_CONCAT(a, b) LOVE_PROFILE_CONCAT_(a, b)
+#define LOVE_PROFILE_ZONE(name) love::ProfileZone LOVE_PROFILE_CONCAT(profileZone_, __LINE__)(name)
+
+} // love
@@ -35,6 +35,12 @@
 #include <cstddef>
 #include <cmath>
 #include <sstream>
+#include <unordered_map>
+
+// Shove the ffiwrapper.lua code directly into a raw string literal.
+static const char ffiwrapper_lua[] =
+#include "ffiwrapper.lua"
+;
 
 namespace love
 {
@@ -630,16 +636,14 @@ void luax_rawnewtype(lua_State *L, love::Type &type, love::Object *object)
 	u->type = &type;
 
 	const char *name = type.getName();
-	luaL_newmetatable(L, name);
-
-	lua_getfield(L, -1, "__gc");
-	bool has_gc = !lua_isnoneornil(L, -1);
-	lua_pop(L, 1);
 
-	// Make sure mt.__gc exists, so Lua states which don't have the object's
-	// module loaded will still clean the object up when it's collected.
-	if (!has_gc)
+	// Metatables which already exist come from luax_register_type, or from an
+	// earlier call here, and have a __gc function either way.
+	if (luaL_newmetatable(L, name) != 0)
 	{
+		// Make sure mt.__gc exists, so Lua states which don't have the
+		// object's module loaded will still clean the object up when it's
+		// collected.
 		lua_pushcfunction(L, w__gc);
 		lua_setfield(L, -2, "__gc");
 	}
@@ -647,7 +651,18 @@ void luax_rawnewtype(lua_State *L, love::Type &type, love::Object *object)
 	lua_setmetatable(L, -2);
 }
 
-void luax_pushtype(lua_State *L, love::Type &type, love::Object *object)
+int luax_getobjectregistry(lua_State *L)
+{
+	luax_getregistry(L, REGISTRY_OBJECTS);
+
+	// The table might not exist - it should be insisted in luax_register_type.
+	if (!lua_istable(L, -1))
+		return 0;
+
+	return lua_gettop(L);
+}
+
+void luax_pushtype(lua_State *L, int objectsidx, love::Type &type, love::Object *object)
 {
 	if (object == nullptr)
 	{
@@ -655,21 +670,15 @@ void luax_pushtype(lua_State *L, love::Type &type, love::Object *object)
 		return;
 	}
 
-	// Fetch the registry table of instantiated objects.
-	luax_getregistry(L, REGISTRY_OBJECTS);
-
-	// The table might not exist - it should be insisted in luax_register_type.
-	if (lua_isnoneornil(L, -1))
-	{
-		lua_pop(L, 1);
+	if (objectsidx == 0)
 		return luax_rawnewtype(L, type, object);
-	}
 
 	ObjectKey objectkey = luax_computeloveobjectkey(L, object);
 
-	// Get the value of loveobjects[object] on the stack.
+	// Get the value of loveobjects[object] on the stack. The table only has a
+	// __mode metafield, so raw access is equivalent.
 	luax_pushloveobjectkey(L, objectkey);
-	lua_gettable(L, -2);
+	lua_rawget(L, objectsidx);
 
 	// If the Proxy userdata isn't in the instantiated types table yet, add it.
 	if (lua_type(L, -1) != LUA_TUSERDATA)
@@ -678,17 +687,35 @@ void luax_pushtype(lua_State *L, love::Type &type, love::Object *object)
 
 		luax_rawnewtype(L, type, object);
 
+		// loveobjects[object] = Proxy.
 		luax_pushloveobjectkey(L, objectkey);
 		lua_pushvalue(L, -2);
+		lua_rawset(L, objectsidx);
+	}
 
-		// loveobjects[object] = Proxy.
-		lua_settable(L, -4);
+	// Keep the Proxy userdata on the stack.
+}
+
+void luax_pushtype(lua_State *L, love::Type &type, love::Object *object)
+{
+	if (object == nullptr)
+	{
+		lua_pushnil(L);
+		return;
+	}
+
+	// Fetch the registry table of instantiated objects.
+	int objectsidx = luax_getobjectregistry(L);
+	if (objectsidx == 0)
+	{
+		lua_pop(L, 1);
+		return luax_rawnewtype(L, type, object);
 	}
 
+	luax_pushtype(L, objectsidx, type, object);
+
 	// Remove the loveobjects table from the stack.
 	lua_remove(L, -2);
-
-	// Keep the Proxy userdata on the stack.
 }
 
 bool luax_istype(lua_State *L, int idx, love::Type &type)
@@ -719,6 +746,286 @@ static Proxy *tryextractproxy(lua_State *L, int idx)
 	return nullptr;
 }
 
+namespace
+{
+
+// Tags for values in a Variant::PackedTable. Tables are stored as their
+// array part's length and value count, then their array values in order, then
+// their remaining key/value pairs. The first time a string is seen its bytes are
+// stored, and later uses refer back to it by index.
+enum PackedTag : uint8
+{
+	PACKED_NIL,
+	PACKED_FALSE,
+	PACKED_TRUE,
+	PACKED_NUMBER,
+	PACKED_STRING,
+	PACKED_STRINGREF,
+	PACKED_LUSERDATA,
+	PACKED_OBJECT,
+	PACKED_TABLE,
+};
+
+struct TablePacker
+{
+	lua_State *L;
+	bool allowuserdata;
+	std::set<const void *> *tableSet;
+
+	StrongRef<Variant::PackedTable> table;
+
+	// Lua strings with the same contents are usually the same object, so
+	// their pointers are enough to find repeats.
+	std::unordered_map<const char *, uint32> strings;
+
+	TablePacker(lua_State *L, bool allowuserdata, std::set<const void *> *tableSet)
+		: L(L)
+		, allowuserdata(allowuserdata)
+		, tableSet(tableSet)
+		, table(new Variant::PackedTable(), Acquire::NORETAIN)
+	{
+	}
+
+	template <typename T>
+	void write(T value)
+	{
+		std::vector<uint8> &data = table->data;
+		size_t offset = data.size();
+		data.resize(offset + sizeof(T));
+		memcpy(data.data() + offset, &value, sizeof(T));
+	}
+
+	bool packValue(int idx)
+	{
+		switch (lua_type(L, idx))
+		{
+		case LUA_TNIL:
+			write<uint8>(PACKED_NIL);
+			return true;
+		case LUA_TBOOLEAN:
+			write<uint8>(lua_toboolean(L, idx) ? PACKED_TRUE : PACKED_FALSE);
+			return true;
+		case LUA_TNUMBER:
+			write<uint8>(PACKED_NUMBER);
+			write<double>(lua_tonumber(L, idx));
+			return true;
+		case LUA_TSTRING:
+		{
+			size_t len = 0;
+			const char *str = lua_tolstring(L, idx, &len);
+
+			auto it = strings.find(str);
+			if (it != strings.end())
+			{
+				write<uint8>(PACKED_STRINGREF);
+				write<uint32>(it->second);
+				return true;
+			}
+
+			strings[str] = (uint32) strings.size();
+
+			write<uint8>(PACKED_STRING);
+			write<uint32>((uint32) len);
+
+			std::vector<uint8> &data = table->data;
+			data.insert(data.end(), (const uint8 *) str, (const uint8 *) str + len);
+			return true;
+		}
+		case LUA_TLIGHTUSERDATA:
+			write<uint8>(PACKED_LUSERDATA);
+			write<void *>(lua_touserdata(L, idx));
+			return true;
+		case LUA_TUSERDATA:
+		{
+			if (!allowuserdata)
+			{
+				luax_typerror(L, idx, "copyable Lua value");
+				return false;
+			}
+
+			Proxy *p = tryextractproxy(L, idx);
+			if (p == nullptr)
+			{
+				luax_typerror(L, idx, "love type");
+				return false;
+			}
+
+			if (p->object != nullptr)
+				p->object->retain();
+
+			table->objects.push_back(*p);
+
+			write<uint8>(PACKED_OBJECT);
+			write<uint32>((uint32) table->objects.size() - 1);
+			return true;
+		}
+		case LUA_TTABLE:
+			return packTable(idx);
+		default:
+			return false;
+		}
+	}
+
+	bool packTable(int idx)
+	{
+		if (idx < 0)
+			idx += lua_gettop(L) + 1;
+
+		// Make sure this table isn't already being serialised.
+		const void *tablePointer = lua_topointer(L, idx);
+		if (!tableSet->insert(tablePointer).second)
+			throw love::Exception("Cycle detected in table");
+
+		luaL_checkstack(L, 4, "table is nested too deeply");
+
+		uint32 arraylen = (uint32) luax_objlen(L, idx);
+
+		if (table->data.empty())
+			table->data.reserve(16 + arraylen * (sizeof(uint8) + sizeof(double)));
+
+		write<uint8>(PACKED_TABLE);
+		write<uint32>(arraylen);
+
+		// The number of hash pairs is filled in once they're counted.
+		size_t pairsoffset = table->data.size();
+		write<uint32>(0);
+
+		bool success = true;
+
+		for (uint32 i = 1; success && i <= arraylen; i++)
+		{
+			lua_rawgeti(L, idx, i);
+			success = packValue(-1);
+			lua_pop(L, 1);
+		}
+
+		uint32 pairs = 0;
+
+		if (success)
+		{
+			lua_pushnil(L);
+
+			while (lua_next(L, idx))
+			{
+				// Skip values which are already in the array part.
+				if (lua_type(L, -2) == LUA_TNUMBER)
+				{
+					double key = lua_tonumber(L, -2);
+					if (key >= 1.0 && key <= (double) arraylen && key == std::floor(key))
+					{
+						lua_pop(L, 1);
+						continue;
+					}
+				}
+
+				if (!packValue(-2) || !packValue(-1))
+				{
+					lua_pop(L, 2);
+					success = false;
+					break;
+				}
+
+				pairs++;
+				lua_pop(L, 1);
+			}
+		}
+
+		memcpy(table->data.data() + pairsoffset, &pairs, sizeof(uint32));
+
+		tableSet->erase(tablePointer);
+		return success;
+	}
+};
+
+struct TableUnpacker
+{
+	lua_State *L;
+	const Variant::PackedTable *table;
+	size_t offset;
+
+	std::vector<std::pair<const char *, size_t>> strings;
+
+	template <typename T>
+	T read()
+	{
+		T value;
+		memcpy(&value, table->data.data() + offset, sizeof(T));
+		offset += sizeof(T);
+		return value;
+	}
+
+	void unpackValue()
+	{
+		switch (read<uint8>())
+		{
+		case PACKED_FALSE:
+			lua_pushboolean(L, 0);
+			break;
+		case PACKED_TRUE:
+			lua_pushboolean(L, 1);
+			break;
+		case PACKED_NUMBER:
+			lua_pushnumber(L, read<double>());
+			break;
+		case PACKED_STRING:
+		{
+			size_t len = read<uint32>();
+			const char *str = (const char *) table->data.data() + offset;
+			offset += len;
+
+			strings.emplace_back(str, len);
+			lua_pushlstring(L, str, len);
+			break;
+		}
+		case PACKED_STRINGREF:
+		{
+			const auto &str = strings[read<uint32>()];
+			lua_pushlstring(L, str.first, str.second);
+			break;
+		}
+		case PACKED_LUSERDATA:
+			lua_pushlightuserdata(L, read<void *>());
+			break;
+		case PACKED_OBJECT:
+		{
+			const Proxy &p = table->objects[read<uint32>()];
+			luax_pushtype(L, *p.type, p.object);
+			break;
+		}
+		case PACKED_TABLE:
+		{
+			luaL_checkstack(L, 4, "table is nested too deeply");
+
+			uint32 arraylen = read<uint32>();
+			uint32 pairs = read<uint32>();
+
+			lua_createtable(L, (int) arraylen, (int) pairs);
+
+			for (uint32 i = 1; i <= arraylen; i++)
+			{
+				unpackValue();
+				lua_rawseti(L, -2, i);
+			}
+
+			for (uint32 i = 0; i < pairs; i++)
+			{
+				unpackValue();
+				unpackValue();
+				lua_rawset(L, -3);
+			}
+
+			break;
+		}
+		case PACKED_NIL:
+		default:
+			lua_pushnil(L);
+			break;
+		}
+	}
+};
+
+} // anonymous namespace
+
 Variant luax_checkvariant(lua_State *L, int n, bool allowuserdata, std::set<const void*> *tableSet)
 {
 	size_t len;
@@ -757,7 +1064,6 @@ Variant luax_checkvariant(lua_State *L, int n, bool allowuserdata, std::set<cons
 		return Variant();
 	case LUA_TTABLE:
 		{
-			bool success = true;
 			std::set<const void *> topTableSet;
 
 			// We can use a pointer to a stack-allocated variable because it's
@@ -765,45 +1071,16 @@ Variant luax_checkvariant(lua_State *L, int n, bool allowuserdata, std::set<cons
 			if (tableSet == nullptr)
 				tableSet = &topTableSet;
 
-			// Now make sure this table wasn't already serialised
-			const void *tablePointer = lua_topointer(L, n);
-			{
-				auto result = tableSet->insert(tablePointer);
-				if (!result.second) // insertion failed
-					throw love::Exception("Cycle detected in table");
-			}
-
-			Variant::SharedTable *table = new Variant::SharedTable();
-
-			size_t len = luax_objlen(L, -1);
-			if (len > 0)
-				table->pairs.reserve(len);
+			TablePacker packer(L, allowuserdata, tableSet);
 
-			lua_pushnil(L);
-
-			while (lua_next(L, n))
+			if (packer.packTable(n))
 			{
-				table->pairs.emplace_back(
-					luax_checkvariant(L, -2, allowuserdata, tableSet),
-					luax_checkvariant(L, -1, allowuserdata, tableSet)
-				);
-				lua_pop(L, 1);
+				packer.table->updateTrackedMemory();
 
-				const auto &p = table->pairs.back();
-				if (p.first.getType() == Variant::UNKNOWN || p.second.getType() == Variant::UNKNOWN)
-				{
-					success = false;
-					break;
-				}
+				// The Variant takes its own reference.
+				packer.table->retain();
+				return Variant(packer.table.get());
 			}
-
-			// And remove the table from the set again
-			tableSet->erase(tablePointer);
-
-			if (success)
-				return Variant(table);
-			else
-				table->release();
 		}
 		break;
 	}
@@ -851,6 +1128,12 @@ void luax_pushvariant(lua_State *L, const Variant &v)
 
 		break;
 	}
+	case Variant::PACKEDTABLE:
+	{
+		TableUnpacker unpacker = {L, data.packedtable, 0, {}};
+		unpacker.unpackValue();
+		break;
+	}
 	case Variant::NIL:
 	default:
 		lua_pushnil(L);
@@ -1151,12 +1434,45 @@ void luax_register(lua_State *L, const char *name, const luaL_Reg *l)
 	}
 }
 
+static const char *FFI_WRAPPER_KEY = "_loveffiwrapper";
+
+void luax_pushffiwrapper(lua_State *L)
+{
+	lua_getfield(L, LUA_REGISTRYINDEX, FFI_WRAPPER_KEY);
+
+	if (lua_isnil(L, -1))
+	{
+		lua_pop(L, 1);
+
+		if (luaL_loadbuffer(L, ffiwrapper_lua, sizeof(ffiwrapper_lua), "=[love \"ffiwrapper.lua\"]") != 0)
+			lua_error(L);
+
+		lua_call(L, 0, 1);
+
+		// Store false when the FFI isn't available, so we don't try again.
+		if (lua_isnil(L, -1))
+		{
+			lua_pop(L, 1);
+			lua_pushboolean(L, 0);
+		}
+
+		lua_pushvalue(L, -1);
+		lua_setfield(L, LUA_REGISTRYINDEX, FFI_WRAPPER_KEY);
+	}
+
+	if (!lua_istable(L, -1))
+	{
+		lua_pop(L, 1);
+		lua_pushnil(L);
+	}
+}
+
 void luax_runwrapper(lua_State *L, const char *filedata, size_t datalen, const char *filename, const love::Type &type, void *ffifuncs)
 {
 	luax_gettypemetatable(L, type);
 
-	// Load and execute the given Lua file, sending the metatable and the ffi
-	// functions struct pointer as arguments.
+	// Load and execute the given Lua file, sending the metatable, the ffi
+	// functions struct pointer and the shared ffi helpers as arguments.
 	if (lua_istable(L, -1))
 	{
 		std::string chunkname = std::string("=[love \"") + std::string(filename) + std::string("\"]");
@@ -1167,7 +1483,8 @@ void luax_runwrapper(lua_State *L, const char *filedata, size_t datalen, const c
 			luax_pushpointerasstring(L, ffifuncs);
 		else
 			lua_pushnil(L);
-		lua_call(L, 2, 0);
+		luax_pushffiwrapper(L);
+		lua_call(L, 3, 0);
 	}
 
 	// Pop the metatable.
@@ -339,6 +339,30 @@ void luax_pushtype(lua_State *L, StrongRef<T> &object)
 	luax_pushtype(L, T::type, object);
 }
 
+/**
+ * Pushes the registry table of instantiated objects (or nil if it doesn't
+ * exist), for wrappers which push many objects at once.
+ * @param L The Lua state.
+ * @return The absolute stack index of the table, or 0 if it doesn't exist.
+ **/
+int luax_getobjectregistry(lua_State *L);
+
+/**
+ * Same as luax_pushtype, but uses the objects registry table at the given
+ * stack index (from luax_getobjectregistry) instead of looking it up again.
+ * @param L The Lua state.
+ * @param objectsidx The absolute stack index of the objects registry, or 0.
+ * @param type The type information of the object.
+ * @param object The pointer to the actual object.
+ **/
+void luax_pushtype(lua_State *L, int objectsidx, love::Type &type, love::Object *object);
+
+template <typename T>
+void luax_pushtype(lua_State *L, int objectsidx, T *object)
+{
+	luax_pushtype(L, objectsidx, T::type, object);
+}
+
 /**
  * Creates a new Lua representation of the given object *without* checking if it
  * exists yet, and *without* storing it in a weak table.
@@ -514,6 +538,17 @@ void luax_checktablefields(lua_State *L, int idx, const char *enumName, bool (*g
 	}
 }
 
+/**
+ * Pushes the table of shared LuaJIT FFI helpers defined in ffiwrapper.lua, or
+ * nil if the FFI isn't available. It's only created once per Lua state.
+ **/
+void luax_pushffiwrapper(lua_State *L);
+
+/**
+ * Runs a wrapper Lua file for the given type. The file gets the type's
+ * metatable, the ffifuncs struct pointer as a string (or nil), and the table
+ * pushed by luax_pushffiwrapper as arguments.
+ **/
 void luax_runwrapper(lua_State *L, const char *filedata, size_t datalen, const char *filename, const love::Type &type, void *ffifuncs);
 
 /**
@@ -108,6 +108,9 @@ public:
 	/// @param newOrigin the new origin with respect to the old origin
 	void ShiftOrigin(const b2Vec2& newOrigin);
 
+	/// Save or load the proxies and moved proxies. See b2World::SaveState.
+	void SerializeState(b2StateBuffer& buffer);
+
 private:
 
 	friend class b2DynamicTree;
@@ -28,6 +28,7 @@
 #include <stddef.h>
 #include <assert.h>
 #include <float.h>
+#include <string.h>
 
 #if !defined(NDEBUG)
 	#define b2DEBUG
@@ -124,6 +125,98 @@ void b2OpenDump(const char* fileName);
 void b2Dump(const char* string, ...);
 void b2CloseDump();
 
+/// Copies simulation state to or from memory, for b2World::SaveState and
+/// b2World::LoadState. The same code measures, saves, checks and loads the
+/// state, so the layout is always consistent.
+struct b2StateBuffer
+{
+	enum Mode
+	{
+		e_measure,	///< only count the bytes needed
+		e_save,
+		e_check,	///< make sure saved state fits the world, without changing it
+		e_load
+	};
+
+	b2StateBuffer(Mode mode, void* data, int32 capacity)
+		: mode(mode), data((uint8*)data), capacity(capacity), size(0), ok(true)
+	{
+	}
+
+	/// Get the memory for the next bytes, or nullptr when measuring or out of room.
+	uint8* Skip(int32 bytes)
+	{
+		uint8* p = nullptr;
+		if (mode != e_measure && (size + bytes > capacity || bytes < 0))
+		{
+			ok = false;
+		}
+		else if (ok && mode != e_measure)
+		{
+			p = data + size;
+		}
+		size += bytes;
+		return p;
+	}
+
+	/// Copy bytes to or from the buffer.
+	void Bytes(void* bytes, int32 count)
+	{
+		uint8* p = Skip(count);
+		if (p != nullptr && mode == e_save)
+		{
+			memcpy(p, bytes, count);
+		}
+		else if (p != nullptr && mode == e_load)
+		{
+			memcpy(bytes, p, count);
+		}
+	}
+
+	/// Copy a value to or from the buffer.
+	template <typename T>
+	void Value(T& value)
+	{
+		Bytes(&value, (int32)sizeof(T));
+	}
+
+	/// Save a value which must be the same when loading.
+	template <typename T>
+	void Check(const T& value)
+	{
+		uint8* p = Skip((int32)sizeof(T));
+		if (p != nullptr && mode == e_save)
+		{
+			memcpy(p, &value, sizeof(T));
+		}
+		else if (p != nullptr && mode == e_check && memcmp(p, &value, sizeof(T)) != 0)
+		{
+			ok = false;
+		}
+	}
+
+	/// Save a count, and get the saved count back when checking or loading.
+	int32 Count(int32 current)
+	{
+		uint8* p = Skip((int32)sizeof(int32));
+		if (p != nullptr && mode == e_save)
+		{
+			memcpy(p, &current, sizeof(int32));
+		}
+		else if (p != nullptr && mode != e_measure)
+		{
+			memcpy(&current, p, sizeof(int32));
+		}
+		return current;
+	}
+
+	Mode mode;
+	uint8* data;
+	int32 capacity;
+	int32 size;
+	bool ok;
+};
+
 /// Version numbering scheme.
 /// See http://en.wikipedia.org/wiki/Software_versioning
 struct b2Version
@@ -162,6 +162,9 @@ public:
 	/// Get the desired tangent speed. In meters per second.
 	float GetTangentSpeed() const;
 
+	/// Get the user data pointer.
+	b2ContactUserData& GetUserData();
+
 	/// Evaluate this contact with your own manifold and transforms.
 	virtual void Evaluate(b2Manifold* manifold, const b2Transform& xfA, const b2Transform& xfB) = 0;
 
@@ -239,6 +242,8 @@ protected:
 	float m_restitutionThreshold;
 
 	float m_tangentSpeed;
+
+	b2ContactUserData m_userData;
 };
 
 inline b2Manifold* b2Contact::GetManifold()
@@ -383,4 +388,9 @@ inline float b2Contact::GetTangentSpeed() const
 	return m_tangentSpeed;
 }
 
+inline b2ContactUserData& b2Contact::GetUserData()
+{
+	return m_userData;
+}
+
 #endif
@@ -46,6 +46,15 @@ public:
 
 	void Collide();
 
+	// Save or load the broad-phase and contacts. See b2World::SaveState.
+	void SerializeState(b2StateBuffer& buffer);
+
+	// Insert a contact into the world and body contact lists.
+	void Link(b2Contact* c);
+
+	// Remove a contact from the world and body contact lists.
+	void Unlink(b2Contact* c);
+
 	b2BroadPhase m_broadPhase;
 	b2Contact* m_contactList;
 	int32 m_contactCount;
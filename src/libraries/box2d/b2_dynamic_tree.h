@@ -133,6 +133,9 @@ public:
 	/// @param newOrigin the new origin with respect to the old origin
 	void ShiftOrigin(const b2Vec2& newOrigin);
 
+	/// Save or load the nodes of the tree. See b2World::SaveState.
+	void SerializeState(b2StateBuffer& buffer);
+
 private:
 
 	int32 AllocateNode();
@@ -96,6 +96,7 @@ protected:
 	void InitVelocityConstraints(const b2SolverData& data) override;
 	void SolveVelocityConstraints(const b2SolverData& data) override;
 	bool SolvePositionConstraints(const b2SolverData& data) override;
+	void SerializeState(b2StateBuffer& buffer) override;
 
 	b2Vec2 m_localAnchorA;
 	b2Vec2 m_localAnchorB;
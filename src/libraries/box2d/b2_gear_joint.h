@@ -88,6 +88,7 @@ protected:
 	void InitVelocityConstraints(const b2SolverData& data) override;
 	void SolveVelocityConstraints(const b2SolverData& data) override;
 	bool SolvePositionConstraints(const b2SolverData& data) override;
+	void SerializeState(b2StateBuffer& buffer) override;
 
 	b2Joint* m_joint1;
 	b2Joint* m_joint2;
@@ -174,6 +174,9 @@ protected:
 	// This returns true if the position errors are within tolerance.
 	virtual bool SolvePositionConstraints(const b2SolverData& data) = 0;
 
+	/// Save or load the accumulated impulses used for warm starting.
+	virtual void SerializeState(b2StateBuffer& buffer) { B2_NOT_USED(buffer); }
+
 	b2JointType m_type;
 	b2Joint* m_prev;
 	b2Joint* m_next;
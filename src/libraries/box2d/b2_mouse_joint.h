@@ -108,6 +108,7 @@ protected:
 	void InitVelocityConstraints(const b2SolverData& data) override;
 	void SolveVelocityConstraints(const b2SolverData& data) override;
 	bool SolvePositionConstraints(const b2SolverData& data) override;
+	void SerializeState(b2StateBuffer& buffer) override;
 
 	b2Vec2 m_localAnchorB;
 	b2Vec2 m_targetA;
@@ -25,6 +25,8 @@
 #include "b2_api.h"
 #include "b2_math.h"
 
+class b2Island;
+
 /// Profiling data. Times are in milliseconds.
 struct B2_API b2Profile
 {
@@ -69,6 +71,7 @@ struct B2_API b2SolverData
 	b2TimeStep step;
 	b2Position* positions;
 	b2Velocity* velocities;
+	const b2Island* island;
 };
 
 #endif
@@ -38,6 +38,7 @@ struct b2JointDef;
 class b2Body;
 class b2Draw;
 class b2Fixture;
+class b2Island;
 class b2Joint;
 
 /// The world class manages all physics entities, dynamic simulation,
@@ -71,6 +72,13 @@ public:
 	/// by you and must remain in scope.
 	void SetDebugDraw(b2Draw* debugDraw);
 
+	/// Register a task executor, used to solve independent islands in parallel.
+	/// Islands are still built, reported and synchronized with the broad-phase
+	/// on the calling thread in a fixed order, so the results don't depend on
+	/// the number of threads. The executor is owned by you and must remain in
+	/// scope. Pass nullptr to solve on the calling thread only.
+	void SetTaskExecutor(b2TaskExecutor* executor);
+
 	/// Create a rigid body given a definition. No reference to the definition
 	/// is retained.
 	/// @warning This function is locked during callbacks.
@@ -210,6 +218,22 @@ public:
 	/// Get the current profile.
 	const b2Profile& GetProfile() const;
 
+	/// Get the number of bytes needed to save the world's state.
+	int32 GetStateSize() const;
+
+	/// Save the simulation state of the bodies, joints, contacts and broad-phase,
+	/// so the world can be rolled back to it later with LoadState.
+	/// @return false if the capacity is too small.
+	/// @warning this should be called outside of a time step.
+	bool SaveState(void* data, int32 capacity) const;
+
+	/// Restore a state saved by SaveState. The world must have the same bodies,
+	/// fixtures and joints as when the state was saved. Contacts are recreated,
+	/// and the destruction listener is told about the old ones.
+	/// @return false, without changing the world, if the state doesn't match.
+	/// @warning this should be called outside of a time step.
+	bool LoadState(const void* data, int32 size);
+
 	/// Dump the world into the log file.
 	/// @warning this should be called outside of a time step.
 	void Dump();
@@ -222,8 +246,13 @@ private:
 	friend class b2Controller;
 
 	void Solve(const b2TimeStep& step);
+	void SolveParallel(const b2TimeStep& step, b2Body** stack, int32 stackSize);
 	void SolveTOI(const b2TimeStep& step);
 
+	void BuildIsland(b2Island* island, b2Body* seed, b2Body** stack, int32 stackSize);
+
+	void SerializeState(b2StateBuffer& buffer);
+
 	void DrawShape(b2Fixture* shape, const b2Transform& xf, const b2Color& color);
 
 	b2BlockAllocator m_blockAllocator;
@@ -242,6 +271,7 @@ private:
 
 	b2DestructionListener* m_destructionListener;
 	b2Draw* m_debugDraw;
+	b2TaskExecutor* m_taskExecutor;
 
 	// This is used to compute the time step ratio to
 	// support a variable time step.
@@ -94,6 +94,10 @@ public:
 	/// Called when two fixtures cease to touch.
 	virtual void EndContact(b2Contact* contact) { B2_NOT_USED(contact); }
 
+	/// Called when a contact is about to be destroyed, touching or not, so
+	/// anything referring to it (such as through its user data) can be cleared.
+	virtual void SayGoodbye(b2Contact* contact) { B2_NOT_USED(contact); }
+
 	/// This is called after a contact is updated. This allows you to inspect a
 	/// contact before it goes to the solver. If you are careful, you can modify the
 	/// contact manifold (e.g. disable contact).
@@ -158,4 +162,18 @@ public:
 									const b2Vec2& normal, float fraction) = 0;
 };
 
+/// A task run by a b2TaskExecutor, for one index in a range.
+typedef void b2TaskFcn(int32 index, void* context);
+
+/// Implement this to let the world solve islands on several threads.
+class B2_API b2TaskExecutor
+{
+public:
+	virtual ~b2TaskExecutor() {}
+
+	/// Call task(i, context) once for each i in [0, count), in any order and on
+	/// any thread, and return when every call has finished.
+	virtual void Run(b2TaskFcn* task, void* context, int32 count) = 0;
+};
+
 #endif
@@ -129,3 +129,24 @@ bool b2BroadPhase::QueryCallback(int32 proxyId)
 
 	return true;
 }
+
+void b2BroadPhase::SerializeState(b2StateBuffer& buffer)
+{
+	m_tree.SerializeState(buffer);
+	buffer.Value(m_proxyCount);
+
+	int32 moveCount = buffer.Count(m_moveCount);
+	if (buffer.mode == b2StateBuffer::e_load && moveCount > m_moveCapacity)
+	{
+		b2Free(m_moveBuffer);
+		m_moveCapacity = moveCount;
+		m_moveBuffer = (int32*)b2Alloc(m_moveCapacity * sizeof(int32));
+	}
+
+	if (buffer.mode == b2StateBuffer::e_load)
+	{
+		m_moveCount = moveCount;
+	}
+
+	buffer.Bytes(m_moveBuffer, moveCount * (int32)sizeof(int32));
+}
@@ -799,3 +799,21 @@ void b2DynamicTree::ShiftOrigin(const b2Vec2& newOrigin)
 		m_nodes[i].aabb.upperBound -= newOrigin;
 	}
 }
+
+void b2DynamicTree::SerializeState(b2StateBuffer& buffer)
+{
+	buffer.Value(m_root);
+	buffer.Value(m_nodeCount);
+	buffer.Value(m_freeList);
+	buffer.Value(m_insertionCount);
+
+	int32 capacity = buffer.Count(m_nodeCapacity);
+	if (buffer.mode == b2StateBuffer::e_load && capacity != m_nodeCapacity)
+	{
+		b2Free(m_nodes);
+		m_nodeCapacity = capacity;
+		m_nodes = (b2TreeNode*)b2Alloc(m_nodeCapacity * sizeof(b2TreeNode));
+	}
+
+	buffer.Bytes(m_nodes, capacity * (int32)sizeof(b2TreeNode));
+}
@@ -28,18 +28,34 @@
 #include <stdlib.h>
 
 #include "common/Exception.h"
+#include "common/memory.h"
+
+#include <cstddef>
 
 b2Version b2_version = {2, 4, 0};
 
 // Memory allocators. Modify these to use your own allocator.
+// LOVE: the size of each allocation is stored in front of it, so Box2D's
+// memory use can be counted in love.system.getMemoryStats.
+static const size_t b2_allocHeaderSize = alignof(std::max_align_t);
+
 void* b2Alloc_Default(int32 size)
 {
-	return malloc(size);
+	char* mem = (char*)malloc(b2_allocHeaderSize + size);
+	if (mem == nullptr)
+		return nullptr;
+	*(int32*)mem = size;
+	love::trackMemory(love::MEMORYTAG_PHYSICS, size);
+	return mem + b2_allocHeaderSize;
 }
 
 void b2Free_Default(void* mem)
 {
-	free(mem);
+	if (mem == nullptr)
+		return;
+	char* block = (char*)mem - b2_allocHeaderSize;
+	love::trackMemory(love::MEMORYTAG_PHYSICS, -(love::int64)*(int32*)block);
+	free(block);
 }
 
 // You can modify this to use your logging facility.
@@ -40,16 +40,27 @@ b2ContactManager::b2ContactManager()
 
 void b2ContactManager::Destroy(b2Contact* c)
 {
-	b2Fixture* fixtureA = c->GetFixtureA();
-	b2Fixture* fixtureB = c->GetFixtureB();
-	b2Body* bodyA = fixtureA->GetBody();
-	b2Body* bodyB = fixtureB->GetBody();
-
 	if (m_contactListener && c->IsTouching())
 	{
 		m_contactListener->EndContact(c);
 	}
 
+	if (m_contactListener)
+	{
+		m_contactListener->SayGoodbye(c);
+	}
+
+	Unlink(c);
+
+	// Call the factory.
+	b2Contact::Destroy(c, m_allocator);
+}
+
+void b2ContactManager::Unlink(b2Contact* c)
+{
+	b2Body* bodyA = c->GetFixtureA()->GetBody();
+	b2Body* bodyB = c->GetFixtureB()->GetBody();
+
 	// Remove from the world.
 	if (c->m_prev)
 	{
@@ -98,8 +109,6 @@ void b2ContactManager::Destroy(b2Contact* c)
 		bodyB->m_contactList = c->m_nodeB.next;
 	}
 
-	// Call the factory.
-	b2Contact::Destroy(c, m_allocator);
 	--m_contactCount;
 }
 
@@ -246,13 +255,14 @@ void b2ContactManager::AddPair(void* proxyUserDataA, void* proxyUserDataB)
 		return;
 	}
 
+	Link(c);
+}
+
+void b2ContactManager::Link(b2Contact* c)
+{
 	// Contact creation may swap fixtures.
-	fixtureA = c->GetFixtureA();
-	fixtureB = c->GetFixtureB();
-	indexA = c->GetChildIndexA();
-	indexB = c->GetChildIndexB();
-	bodyA = fixtureA->GetBody();
-	bodyB = fixtureB->GetBody();
+	b2Body* bodyA = c->GetFixtureA()->GetBody();
+	b2Body* bodyB = c->GetFixtureB()->GetBody();
 
 	// Insert into the world.
 	c->m_prev = nullptr;
@@ -291,3 +301,98 @@ void b2ContactManager::AddPair(void* proxyUserDataA, void* proxyUserDataB)
 
 	++m_contactCount;
 }
+
+// Everything needed to recreate a contact. Fixtures are identified by address,
+// so this can only be loaded into the world it was saved from.
+struct b2ContactState
+{
+	b2Fixture* fixtureA;
+	b2Fixture* fixtureB;
+	int32 indexA;
+	int32 indexB;
+	uint32 flags;
+	b2Manifold manifold;
+	int32 toiCount;
+	float toi;
+	float friction;
+	float restitution;
+	float restitutionThreshold;
+	float tangentSpeed;
+};
+
+void b2ContactManager::SerializeState(b2StateBuffer& buffer)
+{
+	m_broadPhase.SerializeState(buffer);
+
+	int32 count = buffer.Count(m_contactCount);
+	uint8* data = buffer.Skip(count * (int32)sizeof(b2ContactState));
+	if (data == nullptr)
+	{
+		return;
+	}
+
+	if (buffer.mode == b2StateBuffer::e_save)
+	{
+		b2ContactState* state = (b2ContactState*)data;
+		for (b2Contact* c = m_contactList; c; c = c->m_next, ++state)
+		{
+			b2ContactState s;
+			memset((void*)&s, 0, sizeof(s));
+			s.fixtureA = c->m_fixtureA;
+			s.fixtureB = c->m_fixtureB;
+			s.indexA = c->m_indexA;
+			s.indexB = c->m_indexB;
+			s.flags = c->m_flags;
+			s.manifold = c->m_manifold;
+			s.toiCount = c->m_toiCount;
+			s.toi = c->m_toi;
+			s.friction = c->m_friction;
+			s.restitution = c->m_restitution;
+			s.restitutionThreshold = c->m_restitutionThreshold;
+			s.tangentSpeed = c->m_tangentSpeed;
+			memcpy(state, &s, sizeof(s));
+		}
+	}
+	else if (buffer.mode == b2StateBuffer::e_load)
+	{
+		// Contacts are recreated rather than matched up. Begin and end events
+		// aren't reported, since the saved touching state is restored as well.
+		while (m_contactList)
+		{
+			b2Contact* c = m_contactList;
+			if (m_contactListener)
+			{
+				m_contactListener->SayGoodbye(c);
+			}
+			Unlink(c);
+
+			// Don't let the factory wake the bodies up.
+			c->m_manifold.pointCount = 0;
+			b2Contact::Destroy(c, m_allocator);
+		}
+
+		// New contacts go to the front of the lists, so create them in
+		// reverse to get the saved order back.
+		for (int32 i = count - 1; i >= 0; --i)
+		{
+			b2ContactState s;
+			memcpy(&s, data + i * sizeof(b2ContactState), sizeof(s));
+
+			b2Contact* c = b2Contact::Create(s.fixtureA, s.indexA, s.fixtureB, s.indexB, m_allocator);
+			if (c == nullptr)
+			{
+				continue;
+			}
+
+			c->m_flags = s.flags;
+			c->m_manifold = s.manifold;
+			c->m_toiCount = s.toiCount;
+			c->m_toi = s.toi;
+			c->m_friction = s.friction;
+			c->m_restitution = s.restitution;
+			c->m_restitutionThreshold = s.restitutionThreshold;
+			c->m_tangentSpeed = s.tangentSpeed;
+			Link(c);
+		}
+	}
+}
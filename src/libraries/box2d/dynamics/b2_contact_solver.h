@@ -29,6 +29,7 @@
 
 class b2Contact;
 class b2Body;
+class b2Island;
 class b2StackAllocator;
 struct b2ContactPositionConstraint;
 
@@ -69,6 +70,7 @@ struct b2ContactSolverDef
 	b2Position* positions;
 	b2Velocity* velocities;
 	b2StackAllocator* allocator;
+	const b2Island* island;
 };
 
 class b2ContactSolver
@@ -24,6 +24,8 @@
 #include "box2d/b2_body.h"
 #include "box2d/b2_time_step.h"
 
+#include "b2_island.h"
+
 // Point-to-point constraint
 // Cdot = v2 - v1
 //      = v2 + cross(w2, r2) - v1 - cross(w1, r1)
@@ -59,8 +61,8 @@ b2FrictionJoint::b2FrictionJoint(const b2FrictionJointDef* def)
 
 void b2FrictionJoint::InitVelocityConstraints(const b2SolverData& data)
 {
-	m_indexA = m_bodyA->m_islandIndex;
-	m_indexB = m_bodyB->m_islandIndex;
+	m_indexA = data.island->GetIndex(m_bodyA);
+	m_indexB = data.island->GetIndex(m_bodyB);
 	m_localCenterA = m_bodyA->m_sweep.localCenter;
 	m_localCenterB = m_bodyB->m_sweep.localCenter;
 	m_invMassA = m_bodyA->m_invMass;
@@ -196,6 +198,12 @@ bool b2FrictionJoint::SolvePositionConstraints(const b2SolverData& data)
 	return true;
 }
 
+void b2FrictionJoint::SerializeState(b2StateBuffer& buffer)
+{
+	buffer.Value(m_linearImpulse);
+	buffer.Value(m_angularImpulse);
+}
+
 b2Vec2 b2FrictionJoint::GetAnchorA() const
 {
 	return m_bodyA->GetWorldPoint(m_localAnchorA);
@@ -32,6 +32,8 @@
 #include "b2_island.h"
 #include "b2_contact_solver.h"
 
+#include <algorithm>
+
 /*
 Position Correction Notes
 =========================
@@ -163,6 +165,7 @@ b2Island::b2Island(
 	m_bodyCount = 0;
 	m_contactCount = 0;
 	m_jointCount = 0;
+	m_staticCount = 0;
 
 	m_allocator = allocator;
 	m_listener = listener;
@@ -170,6 +173,7 @@ b2Island::b2Island(
 	m_bodies = (b2Body**)m_allocator->Allocate(bodyCapacity * sizeof(b2Body*));
 	m_contacts = (b2Contact**)m_allocator->Allocate(contactCapacity	 * sizeof(b2Contact*));
 	m_joints = (b2Joint**)m_allocator->Allocate(jointCapacity * sizeof(b2Joint*));
+	m_statics = (b2IslandStatic*)m_allocator->Allocate(bodyCapacity * sizeof(b2IslandStatic));
 
 	m_velocities = (b2Velocity*)m_allocator->Allocate(m_bodyCapacity * sizeof(b2Velocity));
 	m_positions = (b2Position*)m_allocator->Allocate(m_bodyCapacity * sizeof(b2Position));
@@ -180,6 +184,7 @@ b2Island::~b2Island()
 	// Warning: the order should reverse the constructor order.
 	m_allocator->Free(m_positions);
 	m_allocator->Free(m_velocities);
+	m_allocator->Free(m_statics);
 	m_allocator->Free(m_joints);
 	m_allocator->Free(m_contacts);
 	m_allocator->Free(m_bodies);
@@ -201,9 +206,13 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 		b2Vec2 v = b->m_linearVelocity;
 		float w = b->m_angularVelocity;
 
-		// Store positions for continuous collision.
-		b->m_sweep.c0 = b->m_sweep.c;
-		b->m_sweep.a0 = b->m_sweep.a;
+		// Store positions for continuous collision. Static bodies never move,
+		// and can be shared with islands solved on other threads.
+		if (b->m_type != b2_staticBody)
+		{
+			b->m_sweep.c0 = b->m_sweep.c;
+			b->m_sweep.a0 = b->m_sweep.a;
+		}
 
 		if (b->m_type == b2_dynamicBody)
 		{
@@ -230,11 +239,14 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 
 	timer.Reset();
 
+	SortStatics();
+
 	// Solver data
 	b2SolverData solverData;
 	solverData.step = step;
 	solverData.positions = m_positions;
 	solverData.velocities = m_velocities;
+	solverData.island = this;
 
 	// Initialize velocity constraints.
 	b2ContactSolverDef contactSolverDef;
@@ -244,6 +256,7 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 	contactSolverDef.positions = m_positions;
 	contactSolverDef.velocities = m_velocities;
 	contactSolverDef.allocator = m_allocator;
+	contactSolverDef.island = this;
 
 	b2ContactSolver contactSolver(&contactSolverDef);
 	contactSolver.InitializeVelocityConstraints();
@@ -335,6 +348,11 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 	for (int32 i = 0; i < m_bodyCount; ++i)
 	{
 		b2Body* body = m_bodies[i];
+		if (body->m_type == b2_staticBody)
+		{
+			continue;
+		}
+
 		body->m_sweep.c = m_positions[i].c;
 		body->m_sweep.a = m_positions[i].a;
 		body->m_linearVelocity = m_velocities[i].v;
@@ -408,6 +426,7 @@ void b2Island::SolveTOI(const b2TimeStep& subStep, int32 toiIndexA, int32 toiInd
 	contactSolverDef.step = subStep;
 	contactSolverDef.positions = m_positions;
 	contactSolverDef.velocities = m_velocities;
+	contactSolverDef.island = this;
 	b2ContactSolver contactSolver(&contactSolverDef);
 
 	// Solve position constraints.
@@ -518,6 +537,47 @@ void b2Island::SolveTOI(const b2TimeStep& subStep, int32 toiIndexA, int32 toiInd
 	Report(contactSolver.m_velocityConstraints);
 }
 
+static bool b2CompareStatics(const b2IslandStatic& a, const b2IslandStatic& b)
+{
+	return a.body < b.body;
+}
+
+void b2Island::SortStatics()
+{
+	std::sort(m_statics, m_statics + m_staticCount, b2CompareStatics);
+}
+
+int32 b2Island::GetIndex(const b2Body* body) const
+{
+	if (body->m_type != b2_staticBody)
+	{
+		return body->m_islandIndex;
+	}
+
+	// Binary search the statics, which are sorted by SortStatics.
+	int32 low = 0;
+	int32 high = m_staticCount - 1;
+	while (low <= high)
+	{
+		int32 mid = (low + high) / 2;
+		if (m_statics[mid].body == body)
+		{
+			return m_statics[mid].index;
+		}
+		else if (m_statics[mid].body < body)
+		{
+			low = mid + 1;
+		}
+		else
+		{
+			high = mid - 1;
+		}
+	}
+
+	b2Assert(false);
+	return -1;
+}
+
 void b2Island::Report(const b2ContactVelocityConstraint* constraints)
 {
 	if (m_listener == nullptr)
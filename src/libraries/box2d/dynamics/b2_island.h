@@ -34,6 +34,13 @@ class b2ContactListener;
 struct b2ContactVelocityConstraint;
 struct b2Profile;
 
+/// A static body and its index in one island.
+struct b2IslandStatic
+{
+	b2Body* body;
+	int32 index;
+};
+
 /// This is an internal class.
 class b2Island
 {
@@ -47,6 +54,7 @@ public:
 		m_bodyCount = 0;
 		m_contactCount = 0;
 		m_jointCount = 0;
+		m_staticCount = 0;
 	}
 
 	void Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& gravity, bool allowSleep);
@@ -56,7 +64,20 @@ public:
 	void Add(b2Body* body)
 	{
 		b2Assert(m_bodyCount < m_bodyCapacity);
-		body->m_islandIndex = m_bodyCount;
+
+		// Static bodies can be in several islands at once, possibly solved on
+		// different threads, so their index is kept by the island instead.
+		if (body->m_type == b2_staticBody)
+		{
+			m_statics[m_staticCount].body = body;
+			m_statics[m_staticCount].index = m_bodyCount;
+			++m_staticCount;
+		}
+		else
+		{
+			body->m_islandIndex = m_bodyCount;
+		}
+
 		m_bodies[m_bodyCount] = body;
 		++m_bodyCount;
 	}
@@ -73,14 +94,21 @@ public:
 		m_joints[m_jointCount++] = joint;
 	}
 
+	/// Get the index of a body in this island's position and velocity arrays.
+	/// SortStatics must be called after the last body is added.
+	int32 GetIndex(const b2Body* body) const;
+
 	void Report(const b2ContactVelocityConstraint* constraints);
 
+	void SortStatics();
+
 	b2StackAllocator* m_allocator;
 	b2ContactListener* m_listener;
 
 	b2Body** m_bodies;
 	b2Contact** m_contacts;
 	b2Joint** m_joints;
+	b2IslandStatic* m_statics;
 
 	b2Position* m_positions;
 	b2Velocity* m_velocities;
@@ -88,6 +116,7 @@ public:
 	int32 m_bodyCount;
 	int32 m_jointCount;
 	int32 m_contactCount;
+	int32 m_staticCount;
 
 	int32 m_bodyCapacity;
 	int32 m_contactCapacity;
@@ -24,6 +24,8 @@
 #include "box2d/b2_mouse_joint.h"
 #include "box2d/b2_time_step.h"
 
+#include "b2_island.h"
+
 // p = attached point, m = mouse point
 // C = p - m
 // Cdot = v
@@ -72,7 +74,7 @@ float b2MouseJoint::GetMaxForce() const
 
 void b2MouseJoint::InitVelocityConstraints(const b2SolverData& data)
 {
-	m_indexB = m_bodyB->m_islandIndex;
+	m_indexB = data.island->GetIndex(m_bodyB);
 	m_localCenterB = m_bodyB->m_sweep.localCenter;
 	m_invMassB = m_bodyB->m_invMass;
 	m_invIB = m_bodyB->m_invI;
@@ -166,6 +168,11 @@ bool b2MouseJoint::SolvePositionConstraints(const b2SolverData& data)
 	return true;
 }
 
+void b2MouseJoint::SerializeState(b2StateBuffer& buffer)
+{
+	buffer.Value(m_impulse);
+}
+
 b2Vec2 b2MouseJoint::GetAnchorA() const
 {
 	return m_targetA;
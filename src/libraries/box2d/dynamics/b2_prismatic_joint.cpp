@@ -25,6 +25,8 @@
 #include "box2d/b2_prismatic_joint.h"
 #include "box2d/b2_time_step.h"
 
+#include "b2_island.h"
+
 // Linear constraint (point-to-line)
 // d = p2 - p1 = x2 + r2 - x1 - r1
 // C = dot(perp, d)
@@ -113,8 +115,8 @@ b2PrismaticJoint::b2PrismaticJoint(const b2PrismaticJointDef* def)
 
 void b2PrismaticJoint::InitVelocityConstraints(const b2SolverData& data)
 {
-	m_indexA = m_bodyA->m_islandIndex;
-	m_indexB = m_bodyB->m_islandIndex;
+	m_indexA = data.island->GetIndex(m_bodyA);
+	m_indexB = data.island->GetIndex(m_bodyB);
 	m_localCenterA = m_bodyA->m_sweep.localCenter;
 	m_localCenterB = m_bodyB->m_sweep.localCenter;
 	m_invMassA = m_bodyA->m_invMass;
@@ -450,6 +452,14 @@ bool b2PrismaticJoint::SolvePositionConstraints(const b2SolverData& data)
 	return linearError <= b2_linearSlop && angularError <= b2_angularSlop;
 }
 
+void b2PrismaticJoint::SerializeState(b2StateBuffer& buffer)
+{
+	buffer.Value(m_impulse);
+	buffer.Value(m_motorImpulse);
+	buffer.Value(m_lowerImpulse);
+	buffer.Value(m_upperImpulse);
+}
+
 b2Vec2 b2PrismaticJoint::GetAnchorA() const
 {
 	return m_bodyA->GetWorldPoint(m_localAnchorA);
@@ -25,6 +25,8 @@
 #include "box2d/b2_revolute_joint.h"
 #include "box2d/b2_time_step.h"
 
+#include "b2_island.h"
+
 // Point-to-point constraint
 // C = p2 - p1
 // Cdot = v2 - v1
@@ -72,8 +74,8 @@ b2RevoluteJoint::b2RevoluteJoint(const b2RevoluteJointDef* def)
 
 void b2RevoluteJoint::InitVelocityConstraints(const b2SolverData& data)
 {
-	m_indexA = m_bodyA->m_islandIndex;
-	m_indexB = m_bodyB->m_islandIndex;
+	m_indexA = data.island->GetIndex(m_bodyA);
+	m_indexB = data.island->GetIndex(m_bodyB);
 	m_localCenterA = m_bodyA->m_sweep.localCenter;
 	m_localCenterB = m_bodyB->m_sweep.localCenter;
 	m_invMassA = m_bodyA->m_invMass;
@@ -320,6 +322,14 @@ bool b2RevoluteJoint::SolvePositionConstraints(const b2SolverData& data)
 	return positionError <= b2_linearSlop && angularError <= b2_angularSlop;
 }
 
+void b2RevoluteJoint::SerializeState(b2StateBuffer& buffer)
+{
+	buffer.Value(m_impulse);
+	buffer.Value(m_motorImpulse);
+	buffer.Value(m_lowerImpulse);
+	buffer.Value(m_upperImpulse);
+}
+
 b2Vec2 b2RevoluteJoint::GetAnchorA() const
 {
 	return m_bodyA->GetWorldPoint(m_localAnchorA);
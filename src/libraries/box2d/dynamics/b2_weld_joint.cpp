@@ -24,6 +24,8 @@
 #include "box2d/b2_time_step.h"
 #include "box2d/b2_weld_joint.h"
 
+#include "b2_island.h"
+
 // Point-to-point constraint
 // C = p2 - p1
 // Cdot = v2 - v1
@@ -61,8 +63,8 @@ b2WeldJoint::b2WeldJoint(const b2WeldJointDef* def)
 
 void b2WeldJoint::InitVelocityConstraints(const b2SolverData& data)
 {
-	m_indexA = m_bodyA->m_islandIndex;
-	m_indexB = m_bodyB->m_islandIndex;
+	m_indexA = data.island->GetIndex(m_bodyA);
+	m_indexB = data.island->GetIndex(m_bodyB);
 	m_localCenterA = m_bodyA->m_sweep.localCenter;
 	m_localCenterB = m_bodyB->m_sweep.localCenter;
 	m_invMassA = m_bodyA->m_invMass;
@@ -305,6 +307,11 @@ bool b2WeldJoint::SolvePositionConstraints(const b2SolverData& data)
 	return positionError <= b2_linearSlop && angularError <= b2_angularSlop;
 }
 
+void b2WeldJoint::SerializeState(b2StateBuffer& buffer)
+{
+	buffer.Value(m_impulse);
+}
+
 b2Vec2 b2WeldJoint::GetAnchorA() const
 {
 	return m_bodyA->GetWorldPoint(m_localAnchorA);
@@ -25,6 +25,8 @@
 #include "box2d/b2_wheel_joint.h"
 #include "box2d/b2_time_step.h"
 
+#include "b2_island.h"
+
 // Linear constraint (point-to-line)
 // d = pB - pA = xB + rB - xA - rA
 // C = dot(ay, d)
@@ -88,8 +90,8 @@ b2WheelJoint::b2WheelJoint(const b2WheelJointDef* def)
 
 void b2WheelJoint::InitVelocityConstraints(const b2SolverData& data)
 {
-	m_indexA = m_bodyA->m_islandIndex;
-	m_indexB = m_bodyB->m_islandIndex;
+	m_indexA = data.island->GetIndex(m_bodyA);
+	m_indexB = data.island->GetIndex(m_bodyB);
 	m_localCenterA = m_bodyA->m_sweep.localCenter;
 	m_localCenterB = m_bodyB->m_sweep.localCenter;
 	m_invMassA = m_bodyA->m_invMass;
@@ -443,6 +445,15 @@ bool b2WheelJoint::SolvePositionConstraints(const b2SolverData& data)
 	return linearError <= b2_linearSlop;
 }
 
+void b2WheelJoint::SerializeState(b2StateBuffer& buffer)
+{
+	buffer.Value(m_impulse);
+	buffer.Value(m_motorImpulse);
+	buffer.Value(m_springImpulse);
+	buffer.Value(m_lowerImpulse);
+	buffer.Value(m_upperImpulse);
+}
+
 b2Vec2 b2WheelJoint::GetAnchorA() const
 {
 	return m_bodyA->GetWorldPoint(m_localAnchorA);
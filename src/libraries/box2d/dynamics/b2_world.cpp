@@ -44,6 +44,7 @@ b2World::b2World(const b2Vec2& gravity)
 {
 	m_destructionListener = nullptr;
 	m_debugDraw = nullptr;
+	m_taskExecutor = nullptr;
 
 	m_bodyList = nullptr;
 	m_jointList = nullptr;
@@ -112,6 +113,11 @@ void b2World::SetDebugDraw(b2Draw* debugDraw)
 	m_debugDraw = debugDraw;
 }
 
+void b2World::SetTaskExecutor(b2TaskExecutor* executor)
+{
+	m_taskExecutor = executor;
+}
+
 b2Body* b2World::CreateBody(const b2BodyDef* def)
 {
 	b2Assert(IsLocked() == false);
@@ -397,13 +403,6 @@ void b2World::Solve(const b2TimeStep& step)
 	m_profile.solveVelocity = 0.0f;
 	m_profile.solvePosition = 0.0f;
 
-	// Size the island for the worst case.
-	b2Island island(m_bodyCount,
-					m_contactManager.m_contactCount,
-					m_jointCount,
-					&m_stackAllocator,
-					m_contactManager.m_contactListener);
-
 	// Clear all the island flags.
 	for (b2Body* b = m_bodyList; b; b = b->m_next)
 	{
@@ -421,164 +420,359 @@ void b2World::Solve(const b2TimeStep& step)
 	// Build and simulate all awake islands.
 	int32 stackSize = m_bodyCount;
 	b2Body** stack = (b2Body**)m_stackAllocator.Allocate(stackSize * sizeof(b2Body*));
-	for (b2Body* seed = m_bodyList; seed; seed = seed->m_next)
+
+	if (m_taskExecutor != nullptr)
+	{
+		SolveParallel(step, stack, stackSize);
+	}
+	else
 	{
-		if (seed->m_flags & b2Body::e_islandFlag)
+		// Size the island for the worst case.
+		b2Island island(m_bodyCount,
+						m_contactManager.m_contactCount,
+						m_jointCount,
+						&m_stackAllocator,
+						m_contactManager.m_contactListener);
+
+		for (b2Body* seed = m_bodyList; seed; seed = seed->m_next)
 		{
-			continue;
+			if (seed->m_flags & b2Body::e_islandFlag)
+			{
+				continue;
+			}
+
+			if (seed->IsAwake() == false || seed->IsEnabled() == false)
+			{
+				continue;
+			}
+
+			// The seed can be dynamic or kinematic.
+			if (seed->GetType() == b2_staticBody)
+			{
+				continue;
+			}
+
+			island.Clear();
+			BuildIsland(&island, seed, stack, stackSize);
+
+			b2Profile profile;
+			island.Solve(&profile, step, m_gravity, m_allowSleep);
+			m_profile.solveInit += profile.solveInit;
+			m_profile.solveVelocity += profile.solveVelocity;
+			m_profile.solvePosition += profile.solvePosition;
+
+			// Post solve cleanup.
+			for (int32 i = 0; i < island.m_bodyCount; ++i)
+			{
+				// Allow static bodies to participate in other islands.
+				b2Body* b = island.m_bodies[i];
+				if (b->GetType() == b2_staticBody)
+				{
+					b->m_flags &= ~b2Body::e_islandFlag;
+				}
+			}
 		}
+	}
 
-		if (seed->IsAwake() == false || seed->IsEnabled() == false)
+	m_stackAllocator.Free(stack);
+
+	{
+		b2Timer timer;
+		// Synchronize fixtures, check for out of range bodies.
+		for (b2Body* b = m_bodyList; b; b = b->GetNext())
 		{
-			continue;
+			// If a body was not in an island then it did not move.
+			if ((b->m_flags & b2Body::e_islandFlag) == 0)
+			{
+				continue;
+			}
+
+			if (b->GetType() == b2_staticBody)
+			{
+				continue;
+			}
+
+			// Update fixtures (for broad-phase).
+			b->SynchronizeFixtures();
 		}
 
-		// The seed can be dynamic or kinematic.
-		if (seed->GetType() == b2_staticBody)
+		// Look for new contacts.
+		m_contactManager.FindNewContacts();
+		m_profile.broadphase = timer.GetMilliseconds();
+	}
+}
+
+// Add the seed and everything connected to it to the island.
+void b2World::BuildIsland(b2Island* island, b2Body* seed, b2Body** stack, int32 stackSize)
+{
+	int32 stackCount = 0;
+	stack[stackCount++] = seed;
+	seed->m_flags |= b2Body::e_islandFlag;
+
+	// Perform a depth first search (DFS) on the constraint graph.
+	while (stackCount > 0)
+	{
+		// Grab the next body off the stack and add it to the island.
+		b2Body* b = stack[--stackCount];
+		b2Assert(b->IsEnabled() == true);
+		island->Add(b);
+
+		// To keep islands as small as possible, we don't
+		// propagate islands across static bodies.
+		if (b->GetType() == b2_staticBody)
 		{
 			continue;
 		}
 
-		// Reset island and stack.
-		island.Clear();
-		int32 stackCount = 0;
-		stack[stackCount++] = seed;
-		seed->m_flags |= b2Body::e_islandFlag;
+		// Make sure the body is awake (without resetting sleep timer).
+		b->m_flags |= b2Body::e_awakeFlag;
 
-		// Perform a depth first search (DFS) on the constraint graph.
-		while (stackCount > 0)
+		// Search all contacts connected to this body.
+		for (b2ContactEdge* ce = b->m_contactList; ce; ce = ce->next)
 		{
-			// Grab the next body off the stack and add it to the island.
-			b2Body* b = stack[--stackCount];
-			b2Assert(b->IsEnabled() == true);
-			island.Add(b);
+			b2Contact* contact = ce->contact;
 
-			// To keep islands as small as possible, we don't
-			// propagate islands across static bodies.
-			if (b->GetType() == b2_staticBody)
+			// Has this contact already been added to an island?
+			if (contact->m_flags & b2Contact::e_islandFlag)
 			{
 				continue;
 			}
 
-			// Make sure the body is awake (without resetting sleep timer).
-			b->m_flags |= b2Body::e_awakeFlag;
+			// Is this contact solid and touching?
+			if (contact->IsEnabled() == false ||
+				contact->IsTouching() == false)
+			{
+				continue;
+			}
 
-			// Search all contacts connected to this body.
-			for (b2ContactEdge* ce = b->m_contactList; ce; ce = ce->next)
+			// Skip sensors.
+			bool sensorA = contact->m_fixtureA->m_isSensor;
+			bool sensorB = contact->m_fixtureB->m_isSensor;
+			if (sensorA || sensorB)
 			{
-				b2Contact* contact = ce->contact;
+				continue;
+			}
 
-				// Has this contact already been added to an island?
-				if (contact->m_flags & b2Contact::e_islandFlag)
-				{
-					continue;
-				}
+			island->Add(contact);
+			contact->m_flags |= b2Contact::e_islandFlag;
 
-				// Is this contact solid and touching?
-				if (contact->IsEnabled() == false ||
-					contact->IsTouching() == false)
-				{
-					continue;
-				}
+			b2Body* other = ce->other;
 
-				// Skip sensors.
-				bool sensorA = contact->m_fixtureA->m_isSensor;
-				bool sensorB = contact->m_fixtureB->m_isSensor;
-				if (sensorA || sensorB)
-				{
-					continue;
-				}
+			// Was the other body already added to this island?
+			if (other->m_flags & b2Body::e_islandFlag)
+			{
+				continue;
+			}
 
-				island.Add(contact);
-				contact->m_flags |= b2Contact::e_islandFlag;
+			b2Assert(stackCount < stackSize);
+			stack[stackCount++] = other;
+			other->m_flags |= b2Body::e_islandFlag;
+		}
 
-				b2Body* other = ce->other;
+		// Search all joints connect to this body.
+		for (b2JointEdge* je = b->m_jointList; je; je = je->next)
+		{
+			if (je->joint->m_islandFlag == true)
+			{
+				continue;
+			}
 
-				// Was the other body already added to this island?
-				if (other->m_flags & b2Body::e_islandFlag)
-				{
-					continue;
-				}
+			b2Body* other = je->other;
 
-				b2Assert(stackCount < stackSize);
-				stack[stackCount++] = other;
-				other->m_flags |= b2Body::e_islandFlag;
+			// Don't simulate joints connected to diabled bodies.
+			if (other->IsEnabled() == false)
+			{
+				continue;
 			}
 
-			// Search all joints connect to this body.
-			for (b2JointEdge* je = b->m_jointList; je; je = je->next)
-			{
-				if (je->joint->m_islandFlag == true)
-				{
-					continue;
-				}
+			island->Add(je->joint);
+			je->joint->m_islandFlag = true;
 
-				b2Body* other = je->other;
+			if (other->m_flags & b2Body::e_islandFlag)
+			{
+				continue;
+			}
 
-				// Don't simulate joints connected to diabled bodies.
-				if (other->IsEnabled() == false)
-				{
-					continue;
-				}
+			b2Assert(stackCount < stackSize);
+			stack[stackCount++] = other;
+			other->m_flags |= b2Body::e_islandFlag;
+		}
+	}
+}
 
-				island.Add(je->joint);
-				je->joint->m_islandFlag = true;
+// The bodies, contacts and joints of one island, in the arrays built by
+// SolveParallel.
+struct b2IslandRange
+{
+	int32 bodyStart;
+	int32 bodyCount;
+	int32 contactStart;
+	int32 contactCount;
+	int32 jointStart;
+	int32 jointCount;
+	b2Profile profile;
+};
 
-				if (other->m_flags & b2Body::e_islandFlag)
-				{
-					continue;
-				}
+struct b2IslandTaskContext
+{
+	b2IslandRange* islands;
+	b2Body** bodies;
+	b2Contact** contacts;
+	b2Joint** joints;
+	b2TimeStep step;
+	b2Vec2 gravity;
+	bool allowSleep;
+};
 
-				b2Assert(stackCount < stackSize);
-				stack[stackCount++] = other;
-				other->m_flags |= b2Body::e_islandFlag;
-			}
-		}
+static void b2SolveIslandTask(int32 index, void* context)
+{
+	b2IslandTaskContext* taskContext = (b2IslandTaskContext*)context;
+	b2IslandRange* range = taskContext->islands + index;
 
-		b2Profile profile;
-		island.Solve(&profile, step, m_gravity, m_allowSleep);
-		m_profile.solveInit += profile.solveInit;
-		m_profile.solveVelocity += profile.solveVelocity;
-		m_profile.solvePosition += profile.solvePosition;
+	// Tasks can run at the same time, so each needs its own allocator. The
+	// listener is called later, from the thread that called Step.
+	b2StackAllocator allocator;
+	b2Island island(range->bodyCount, range->contactCount, range->jointCount, &allocator, nullptr);
 
-		// Post solve cleanup.
-		for (int32 i = 0; i < island.m_bodyCount; ++i)
-		{
-			// Allow static bodies to participate in other islands.
-			b2Body* b = island.m_bodies[i];
-			if (b->GetType() == b2_staticBody)
-			{
-				b->m_flags &= ~b2Body::e_islandFlag;
-			}
-		}
+	for (int32 i = 0; i < range->bodyCount; ++i)
+	{
+		island.Add(taskContext->bodies[range->bodyStart + i]);
+	}
+	for (int32 i = 0; i < range->contactCount; ++i)
+	{
+		island.Add(taskContext->contacts[range->contactStart + i]);
+	}
+	for (int32 i = 0; i < range->jointCount; ++i)
+	{
+		island.Add(taskContext->joints[range->jointStart + i]);
 	}
 
-	m_stackAllocator.Free(stack);
+	island.Solve(&range->profile, taskContext->step, taskContext->gravity, taskContext->allowSleep);
+}
+
+// Build all awake islands, then solve them with the task executor. Islands
+// only share static bodies, which the solver doesn't write to.
+void b2World::SolveParallel(const b2TimeStep& step, b2Body** stack, int32 stackSize)
+{
+	int32 contactCapacity = m_contactManager.m_contactCount;
+
+	// A static body can be in one island per contact or joint touching it.
+	int32 bodyCapacity = m_bodyCount + contactCapacity + m_jointCount;
+
+	b2IslandRange* islands = (b2IslandRange*)m_stackAllocator.Allocate(m_bodyCount * sizeof(b2IslandRange));
+	b2Body** bodies = (b2Body**)m_stackAllocator.Allocate(bodyCapacity * sizeof(b2Body*));
+	b2Contact** contacts = (b2Contact**)m_stackAllocator.Allocate(contactCapacity * sizeof(b2Contact*));
+	b2Joint** joints = (b2Joint**)m_stackAllocator.Allocate(m_jointCount * sizeof(b2Joint*));
+
+	int32 islandCount = 0;
+	int32 bodyCount = 0;
+	int32 contactCount = 0;
+	int32 jointCount = 0;
 
 	{
-		b2Timer timer;
-		// Synchronize fixtures, check for out of range bodies.
-		for (b2Body* b = m_bodyList; b; b = b->GetNext())
+		b2Island island(m_bodyCount, contactCapacity, m_jointCount, &m_stackAllocator, nullptr);
+
+		for (b2Body* seed = m_bodyList; seed; seed = seed->m_next)
 		{
-			// If a body was not in an island then it did not move.
-			if ((b->m_flags & b2Body::e_islandFlag) == 0)
+			if (seed->m_flags & b2Body::e_islandFlag)
 			{
 				continue;
 			}
 
-			if (b->GetType() == b2_staticBody)
+			if (seed->IsAwake() == false || seed->IsEnabled() == false)
 			{
 				continue;
 			}
 
-			// Update fixtures (for broad-phase).
-			b->SynchronizeFixtures();
+			// The seed can be dynamic or kinematic.
+			if (seed->GetType() == b2_staticBody)
+			{
+				continue;
+			}
+
+			island.Clear();
+			BuildIsland(&island, seed, stack, stackSize);
+
+			b2Assert(bodyCount + island.m_bodyCount <= bodyCapacity);
+
+			b2IslandRange* range = islands + islandCount++;
+			range->bodyStart = bodyCount;
+			range->bodyCount = island.m_bodyCount;
+			range->contactStart = contactCount;
+			range->contactCount = island.m_contactCount;
+			range->jointStart = jointCount;
+			range->jointCount = island.m_jointCount;
+
+			memcpy(bodies + bodyCount, island.m_bodies, island.m_bodyCount * sizeof(b2Body*));
+			memcpy(contacts + contactCount, island.m_contacts, island.m_contactCount * sizeof(b2Contact*));
+			memcpy(joints + jointCount, island.m_joints, island.m_jointCount * sizeof(b2Joint*));
+
+			bodyCount += island.m_bodyCount;
+			contactCount += island.m_contactCount;
+			jointCount += island.m_jointCount;
+
+			for (int32 i = 0; i < island.m_bodyCount; ++i)
+			{
+				// Allow static bodies to participate in other islands.
+				b2Body* b = island.m_bodies[i];
+				if (b->GetType() == b2_staticBody)
+				{
+					b->m_flags &= ~b2Body::e_islandFlag;
+				}
+			}
 		}
+	}
 
-		// Look for new contacts.
-		m_contactManager.FindNewContacts();
-		m_profile.broadphase = timer.GetMilliseconds();
+	b2IslandTaskContext context;
+	context.islands = islands;
+	context.bodies = bodies;
+	context.contacts = contacts;
+	context.joints = joints;
+	context.step = step;
+	context.gravity = m_gravity;
+	context.allowSleep = m_allowSleep;
+
+	if (islandCount > 0)
+	{
+		m_taskExecutor->Run(b2SolveIslandTask, &context, islandCount);
 	}
+
+	// Report in island order. The solver stores the final impulses in the
+	// manifolds, so they match what b2Island::Report would have sent.
+	b2ContactListener* listener = m_contactManager.m_contactListener;
+	for (int32 i = 0; i < islandCount; ++i)
+	{
+		const b2IslandRange* range = islands + i;
+		m_profile.solveInit += range->profile.solveInit;
+		m_profile.solveVelocity += range->profile.solveVelocity;
+		m_profile.solvePosition += range->profile.solvePosition;
+
+		if (listener == nullptr)
+		{
+			continue;
+		}
+
+		for (int32 j = 0; j < range->contactCount; ++j)
+		{
+			b2Contact* c = contacts[range->contactStart + j];
+			const b2Manifold* manifold = c->GetManifold();
+
+			b2ContactImpulse impulse;
+			impulse.count = manifold->pointCount;
+			for (int32 k = 0; k < manifold->pointCount; ++k)
+			{
+				impulse.normalImpulses[k] = manifold->points[k].normalImpulse;
+				impulse.tangentImpulses[k] = manifold->points[k].tangentImpulse;
+			}
+
+			listener->PostSolve(c, &impulse);
+		}
+	}
+
+	m_stackAllocator.Free(joints);
+	m_stackAllocator.Free(contacts);
+	m_stackAllocator.Free(bodies);
+	m_stackAllocator.Free(islands);
 }
 
 // Find TOI contacts and solve them.
@@ -868,7 +1062,8 @@ void b2World::SolveTOI(const b2TimeStep& step)
 		subStep.positionIterations = 20;
 		subStep.velocityIterations = step.velocityIterations;
 		subStep.warmStarting = false;
-		island.SolveTOI(subStep, bA->m_islandIndex, bB->m_islandIndex);
+		island.SortStatics();
+		island.SolveTOI(subStep, island.GetIndex(bA), island.GetIndex(bB));
 
 		// Reset island flags and synchronize broad-phase proxies.
 		for (int32 i = 0; i < island.m_bodyCount; ++i)
@@ -1320,3 +1515,119 @@ void b2World::Dump()
 
 	b2CloseDump();
 }
+
+// The part of a body that changes while stepping.
+struct b2BodyState
+{
+	b2Transform xf;
+	b2Sweep sweep;
+	b2Vec2 linearVelocity;
+	float angularVelocity;
+	b2Vec2 force;
+	float torque;
+	float sleepTime;
+	uint16 flags;
+};
+
+void b2World::SerializeState(b2StateBuffer& buffer)
+{
+	const uint16 bodyFlags = b2Body::e_islandFlag | b2Body::e_awakeFlag | b2Body::e_toiFlag;
+
+	buffer.Check(m_bodyCount);
+	buffer.Check(m_jointCount);
+	buffer.Value(m_inv_dt0);
+	buffer.Value(m_newContacts);
+	buffer.Value(m_stepComplete);
+
+	for (b2Body* b = m_bodyList; b; b = b->m_next)
+	{
+		buffer.Check(b);
+		buffer.Check(b->m_type);
+
+		b2BodyState s;
+		memset((void*)&s, 0, sizeof(s));
+		if (buffer.mode == b2StateBuffer::e_save)
+		{
+			s.xf = b->m_xf;
+			s.sweep = b->m_sweep;
+			s.linearVelocity = b->m_linearVelocity;
+			s.angularVelocity = b->m_angularVelocity;
+			s.force = b->m_force;
+			s.torque = b->m_torque;
+			s.sleepTime = b->m_sleepTime;
+			s.flags = b->m_flags & bodyFlags;
+		}
+
+		buffer.Value(s);
+
+		if (buffer.mode == b2StateBuffer::e_load)
+		{
+			b->m_xf = s.xf;
+			b->m_sweep = s.sweep;
+			b->m_linearVelocity = s.linearVelocity;
+			b->m_angularVelocity = s.angularVelocity;
+			b->m_force = s.force;
+			b->m_torque = s.torque;
+			b->m_sleepTime = s.sleepTime;
+			b->m_flags = (b->m_flags & ~bodyFlags) | (s.flags & bodyFlags);
+		}
+
+		for (b2Fixture* f = b->m_fixtureList; f; f = f->m_next)
+		{
+			buffer.Check(f);
+			buffer.Check(f->m_proxyCount);
+
+			for (int32 i = 0; i < f->m_proxyCount; ++i)
+			{
+				buffer.Value(f->m_proxies[i].aabb);
+				buffer.Value(f->m_proxies[i].proxyId);
+			}
+		}
+	}
+
+	for (b2Joint* j = m_jointList; j; j = j->m_next)
+	{
+		buffer.Check(j);
+		buffer.Check(j->m_type);
+		j->SerializeState(buffer);
+	}
+
+	m_contactManager.SerializeState(buffer);
+}
+
+int32 b2World::GetStateSize() const
+{
+	b2StateBuffer buffer(b2StateBuffer::e_measure, nullptr, 0);
+	const_cast<b2World*>(this)->SerializeState(buffer);
+	return buffer.size;
+}
+
+bool b2World::SaveState(void* data, int32 capacity) const
+{
+	b2Assert(IsLocked() == false);
+
+	b2StateBuffer buffer(b2StateBuffer::e_save, data, capacity);
+	const_cast<b2World*>(this)->SerializeState(buffer);
+	return buffer.ok;
+}
+
+bool b2World::LoadState(const void* data, int32 size)
+{
+	b2Assert(IsLocked() == false);
+	if (IsLocked())
+	{
+		return false;
+	}
+
+	// Check everything first, so a bad state never gets half loaded.
+	b2StateBuffer check(b2StateBuffer::e_check, const_cast<void*>(data), size);
+	SerializeState(check);
+	if (check.ok == false || check.size != size)
+	{
+		return false;
+	}
+
+	b2StateBuffer load(b2StateBuffer::e_load, const_cast<void*>(data), size);
+	SerializeState(load);
+	return load.ok;
+}
@@ -33,6 +33,12 @@
 #include <cstdio>
 #include <cstddef>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 
 extern "C" {
 #define LUA_COMPAT_ALL
@@ -42,12 +48,147 @@ extern "C" {
 #include <enet/enet.h>
 }
 
+#include "common/runtime.h"
+#include "common/Data.h"
+#include "data/ByteData.h"
+
 #define check_host(l, idx)\
 	*(ENetHost**)luaL_checkudata(l, idx, "enet_host")
 
 #define check_peer(l, idx)\
 	*(ENetPeer**)luaL_checkudata(l, idx, "enet_peer")
 
+/**
+ * Background servicing (LOVE addition). host:start_service_thread() gives
+ * the host to a thread which calls enet_host_service continuously, so
+ * network I/O doesn't wait for the Lua thread. Received events go into a
+ * lock-free single-producer ring and are returned by host:service and
+ * host:check_events. ENet hosts aren't thread-safe, so the other host and
+ * peer functions lock the host while its thread is running.
+ */
+struct ServiceThread {
+	static const size_t EVENT_QUEUE_SIZE = 1024;
+
+	ENetHost *host;
+	int interval;
+
+	std::mutex hostMutex;
+	std::thread thread;
+	std::atomic<bool> running;
+
+	ENetEvent events[EVENT_QUEUE_SIZE];
+	std::atomic<size_t> head; // Next event to read, only changed by Lua.
+	std::atomic<size_t> tail; // Next slot to write, only changed by the thread.
+
+	// Lets a host:service call with a timeout sleep until an event arrives.
+	std::mutex waitMutex;
+	std::condition_variable waitCond;
+	std::atomic<int> waiters;
+
+	ServiceThread(ENetHost *host)
+		: host(host), interval(1), running(false), head(0), tail(0), waiters(0) {}
+
+	bool isFull() const {
+		return tail.load(std::memory_order_relaxed) - head.load(std::memory_order_acquire) >= EVENT_QUEUE_SIZE;
+	}
+
+	void pushEvent(const ENetEvent &event) {
+		size_t t = tail.load(std::memory_order_relaxed);
+		events[t % EVENT_QUEUE_SIZE] = event;
+		tail.store(t + 1, std::memory_order_release);
+	}
+
+	bool popEvent(ENetEvent &event) {
+		size_t h = head.load(std::memory_order_relaxed);
+		if (h == tail.load(std::memory_order_acquire))
+			return false;
+		event = events[h % EVENT_QUEUE_SIZE];
+		head.store(h + 1, std::memory_order_release);
+		return true;
+	}
+};
+
+static std::mutex service_threads_mutex;
+static std::unordered_map<ENetHost *, ServiceThread *> service_threads;
+static std::atomic<int> service_thread_count(0);
+
+static ServiceThread *get_service_thread(ENetHost *host) {
+	if (service_thread_count.load() == 0)
+		return NULL;
+	std::lock_guard<std::mutex> lock(service_threads_mutex);
+	auto it = service_threads.find(host);
+	return it != service_threads.end() ? it->second : NULL;
+}
+
+/**
+ * Locks a host for the current scope if it has a service thread. Nothing
+ * which can raise a Lua error should happen while one is held.
+ */
+struct HostLock {
+	ServiceThread *st;
+	HostLock(ENetHost *host) : st(get_service_thread(host)) {
+		if (st && st->running.load())
+			st->hostMutex.lock();
+		else
+			st = NULL;
+	}
+	~HostLock() {
+		if (st)
+			st->hostMutex.unlock();
+	}
+};
+
+static void service_thread_main(ServiceThread *st) {
+	while (st->running.load()) {
+		bool queued = false;
+		bool full = false;
+
+		{
+			std::lock_guard<std::mutex> lock(st->hostMutex);
+			ENetEvent event;
+
+			// Events can't be put back into ENet, so stop taking them when
+			// the queue is full and only send until Lua catches up.
+			if (st->isFull()) {
+				enet_host_flush(st->host);
+				full = true;
+			} else {
+				int out = enet_host_service(st->host, &event, 0);
+				while (out > 0) {
+					st->pushEvent(event);
+					queued = true;
+					if (st->isFull()) {
+						full = true;
+						break;
+					}
+					out = enet_host_check_events(st->host, &event);
+				}
+			}
+		}
+
+		if (queued && st->waiters.load() > 0) {
+			{ std::lock_guard<std::mutex> lock(st->waitMutex); }
+			st->waitCond.notify_all();
+		}
+
+		if (full) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(st->interval));
+		} else {
+			// Wait for incoming data without holding the lock. Outgoing
+			// packets are sent on the next pass, at most interval ms later.
+			enet_uint32 condition = ENET_SOCKET_WAIT_RECEIVE | ENET_SOCKET_WAIT_INTERRUPT;
+			enet_socket_wait(st->host->socket, &condition, st->interval);
+		}
+	}
+}
+
+static void stop_service_thread(ServiceThread *st) {
+	if (st->running.load()) {
+		st->running.store(false);
+		st->thread.join();
+	}
+}
+
 /**
  * Parse address string, eg:
  *	*:5959
@@ -203,7 +344,37 @@ static void push_peer(lua_State *l, ENetPeer *peer) {
 	lua_remove(l, -2); // remove enet_peers
 }
 
-static void push_event(lua_State *l, ENetEvent *event) {
+/**
+ * Packet data and love Data (LOVE addition). ENet allocates with new[] and
+ * delete[] (see luaopen_enet), so the buffer of a received packet can be
+ * handed to a ByteData as-is instead of being copied into a string.
+ */
+static void *ENET_CALLBACK packet_malloc(size_t size) {
+	return new (std::nothrow) char[size];
+}
+
+static void ENET_CALLBACK packet_free(void *memory) {
+	delete[] (char *) memory;
+}
+
+static void release_packet_data(ENetPacket *packet) {
+	((love::Data *) packet->userData)->release();
+}
+
+static void push_packet(lua_State *l, ENetPacket *packet, bool as_data) {
+	if (as_data) {
+		love::data::ByteData *data = new love::data::ByteData(packet->data, packet->dataLength, true);
+		packet->data = NULL;
+		enet_packet_destroy(packet);
+		love::luax_pushtype(l, data);
+		data->release();
+	} else {
+		lua_pushlstring(l, (const char *)packet->data, packet->dataLength);
+		enet_packet_destroy(packet);
+	}
+}
+
+static void push_event(lua_State *l, ENetEvent *event, bool as_data) {
 	lua_newtable(l); // event table
 
 	if (event->peer) {
@@ -225,15 +396,13 @@ static void push_event(lua_State *l, ENetEvent *event) {
 			lua_pushstring(l, "disconnect");
 			break;
 		case ENET_EVENT_TYPE_RECEIVE:
-			lua_pushlstring(l, (const char *)event->packet->data, event->packet->dataLength);
+			push_packet(l, event->packet, as_data);
 			lua_setfield(l, -2, "data");
 
 			lua_pushinteger(l, event->channelID);
 			lua_setfield(l, -2, "channel");
 
 			lua_pushstring(l, "receive");
-
-			enet_packet_destroy(event->packet);
 			break;
 		case ENET_EVENT_TYPE_NONE:
 			lua_pushstring(l, "none");
@@ -245,18 +414,25 @@ static void push_event(lua_State *l, ENetEvent *event) {
 
 /**
  * Read a packet off the stack as a string
- * idx is position of string or lightuserdata
+ * idx is position of string, lightuserdata or love Data. A packet made from
+ * Data references its memory until ENet is done with it, instead of copying.
  */
 static ENetPacket *read_packet(lua_State *l, int idx, enet_uint8 *channel_id) {
 	size_t size;
 	int argc = lua_gettop(l);
 	const void* data;
+	love::Data *lovedata = NULL;
 
 	if (lua_islightuserdata(l, idx)) {
 		data = lua_touserdata(l, idx);
 		size = (size_t) luaL_checknumber(l, idx + 1);
 		idx++;
 	}
+	else if (love::luax_istype(l, idx, love::Data::type)) {
+		lovedata = love::luax_totype<love::Data>(l, idx);
+		data = lovedata->getData();
+		size = lovedata->getSize();
+	}
 	else {
 		data = luaL_checklstring(l, idx, &size);
 	}
@@ -282,7 +458,17 @@ static ENetPacket *read_packet(lua_State *l, int idx, enet_uint8 *channel_id) {
 		*channel_id = (int) luaL_checknumber(l, idx+1);
 	}
 
-	packet = enet_packet_create(data, size, flags);
+	if (lovedata != NULL) {
+		packet = enet_packet_create(data, size, flags | ENET_PACKET_FLAG_NO_ALLOCATE);
+		if (packet != NULL) {
+			lovedata->retain();
+			packet->userData = lovedata;
+			packet->freeCallback = release_packet_data;
+		}
+	} else {
+		packet = enet_packet_create(data, size, flags);
+	}
+
 	if (packet == NULL) {
 		luaL_error(l, "Failed to create packet");
 	}
@@ -354,6 +540,7 @@ static int linked_version(lua_State *l) {
  * Serice a host
  * Args:
  *	timeout
+ *	[as_data = false], receive packet data as a ByteData instead of a string
  *
  * Return
  *	nil on no event
@@ -367,19 +554,47 @@ static int host_service(lua_State *l) {
 	ENetEvent event;
 	int timeout = 0, out;
 
-	if (lua_gettop(l) > 1)
+	if (lua_gettop(l) > 1 && !lua_isnil(l, 2))
 		timeout = (int) luaL_checknumber(l, 2);
+	bool as_data = lua_toboolean(l, 3) != 0;
+
+	ServiceThread *st = get_service_thread(host);
+	if (st) {
+		// Queued events are still returned after the thread has stopped.
+		if (st->popEvent(event)) {
+			push_event(l, &event, as_data);
+			return 1;
+		}
+		if (st->running.load()) {
+			if (timeout <= 0)
+				return 0;
+			bool popped = false;
+			{
+				std::unique_lock<std::mutex> lock(st->waitMutex);
+				st->waiters++;
+				st->waitCond.wait_for(lock, std::chrono::milliseconds(timeout), [&]() {
+					return (popped = st->popEvent(event));
+				});
+				st->waiters--;
+			}
+			if (!popped) return 0;
+			push_event(l, &event, as_data);
+			return 1;
+		}
+	}
 
 	out = enet_host_service(host, &event, timeout);
 	if (out == 0) return 0;
 	if (out < 0) return luaL_error(l, "Error during service");
 
-	push_event(l, &event);
+	push_event(l, &event, as_data);
 	return 1;
 }
 
 /**
  * Dispatch a single event if available
+ * Args:
+ *	[as_data = false], receive packet data as a ByteData instead of a string
  */
 static int host_check_events(lua_State *l) {
 	ENetHost *host = check_host(l, 1);
@@ -387,11 +602,22 @@ static int host_check_events(lua_State *l) {
 		return luaL_error(l, "Tried to index a nil host!");
 	}
 	ENetEvent event;
+	bool as_data = lua_toboolean(l, 2) != 0;
+	ServiceThread *st = get_service_thread(host);
+	if (st) {
+		if (st->popEvent(event)) {
+			push_event(l, &event, as_data);
+			return 1;
+		}
+		if (st->running.load())
+			return 0;
+	}
+
 	int out = enet_host_check_events(host, &event);
 	if (out == 0) return 0;
 	if (out < 0) return luaL_error(l, "Error checking event");
 
-	push_event(l, &event);
+	push_event(l, &event, as_data);
 	return 1;
 }
 
@@ -405,7 +631,11 @@ static int host_compress_with_range_coder(lua_State *l) {
 		return luaL_error(l, "Tried to index a nil host!");
 	}
 
-	int result = enet_host_compress_with_range_coder (host);
+	int result;
+	{
+		HostLock lock(host);
+		result = enet_host_compress_with_range_coder (host);
+	}
 	if (result == 0) {
 		lua_pushboolean (l, 1);
 	} else {
@@ -443,7 +673,10 @@ static int host_connect(lua_State *l) {
 	}
 
 	// printf("host connect, channels=%d, data=%d\n", channel_count, data);
-	peer = enet_host_connect(host, &address, channel_count, data);
+	{
+		HostLock lock(host);
+		peer = enet_host_connect(host, &address, channel_count, data);
+	}
 
 	if (peer == NULL) {
 		return luaL_error(l, "Failed to create peer");
@@ -459,6 +692,7 @@ static int host_flush(lua_State *l) {
 	if (!host) {
 		return luaL_error(l, "Tried to index a nil host!");
 	}
+	HostLock lock(host);
 	enet_host_flush(host);
 	return 0;
 }
@@ -471,6 +705,7 @@ static int host_broadcast(lua_State *l) {
 
 	enet_uint8 channel_id;
 	ENetPacket *packet = read_packet(l, 2, &channel_id);
+	HostLock lock(host);
 	enet_host_broadcast(host, channel_id, packet);
 	return 0;
 }
@@ -482,6 +717,7 @@ static int host_channel_limit(lua_State *l) {
 		return luaL_error(l, "Tried to index a nil host!");
 	}
 	int limit = (int) luaL_checknumber(l, 2);
+	HostLock lock(host);
 	enet_host_channel_limit(host, limit);
 	return 0;
 }
@@ -493,6 +729,7 @@ static int host_bandwidth_limit(lua_State *l) {
 	}
 	enet_uint32 in_bandwidth = (int) luaL_checknumber(l, 2);
 	enet_uint32 out_bandwidth = (int) luaL_checknumber(l, 2);
+	HostLock lock(host);
 	enet_host_bandwidth_limit(host, in_bandwidth, out_bandwidth);
 	return 0;
 }
@@ -513,6 +750,14 @@ static int host_get_socket_address(lua_State *l) {
 			address.port);
 	return 1;
 }
+static int host_get_socket_fd(lua_State *l) {
+	ENetHost *host = check_host(l, 1);
+	if (!host) {
+		return luaL_error(l, "Tried to index a nil host!");
+	}
+	lua_pushnumber(l, (lua_Number) host->socket);
+	return 1;
+}
 static int host_total_sent_data(lua_State *l) {
 	ENetHost *host = check_host(l, 1);
 	if (!host) {
@@ -574,11 +819,94 @@ static int host_get_peer(lua_State *l) {
 	return 1;
 }
 
+/**
+ * Start servicing the host on a background thread.
+ * Args:
+ *	[interval = 1], longest time in ms the thread waits for incoming data
+ *	before sending queued packets
+ */
+static int host_start_service_thread(lua_State *l) {
+	ENetHost *host = check_host(l, 1);
+	if (!host) {
+		return luaL_error(l, "Tried to index a nil host!");
+	}
+
+	int interval = 1;
+	if (lua_gettop(l) > 1 && !lua_isnil(l, 2))
+		interval = (int) luaL_checknumber(l, 2);
+	if (interval < 1)
+		return luaL_argerror(l, 2, "interval must be at least 1 ms");
+
+	ServiceThread *st = get_service_thread(host);
+	if (st && st->running.load()) {
+		lua_pushboolean(l, 0);
+		return 1;
+	}
+
+	if (st == NULL) {
+		st = new ServiceThread(host);
+		std::lock_guard<std::mutex> lock(service_threads_mutex);
+		service_threads[host] = st;
+		service_thread_count++;
+	}
+
+	st->interval = interval;
+	st->running.store(true);
+	st->thread = std::thread(service_thread_main, st);
+
+	lua_pushboolean(l, 1);
+	return 1;
+}
+
+/**
+ * Stop the host's service thread. Events it already received are still
+ * returned by service and check_events.
+ */
+static int host_stop_service_thread(lua_State *l) {
+	ENetHost *host = check_host(l, 1);
+	if (!host) {
+		return luaL_error(l, "Tried to index a nil host!");
+	}
+
+	ServiceThread *st = get_service_thread(host);
+	if (st)
+		stop_service_thread(st);
+	return 0;
+}
+
+static int host_has_service_thread(lua_State *l) {
+	ENetHost *host = check_host(l, 1);
+	if (!host) {
+		return luaL_error(l, "Tried to index a nil host!");
+	}
+
+	ServiceThread *st = get_service_thread(host);
+	lua_pushboolean(l, st != NULL && st->running.load());
+	return 1;
+}
+
 static int host_gc(lua_State *l) {
 	// We have to manually grab the userdata so that we can set it to NULL.
 	ENetHost** host = (ENetHost**)luaL_checkudata(l, 1, "enet_host");
 	// We don't want to crash by destroying a non-existant host.
 	if (*host) {
+		ServiceThread *st = get_service_thread(*host);
+		if (st) {
+			stop_service_thread(st);
+
+			ENetEvent event;
+			while (st->popEvent(event)) {
+				if (event.type == ENET_EVENT_TYPE_RECEIVE)
+					enet_packet_destroy(event.packet);
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(service_threads_mutex);
+				service_threads.erase(*host);
+				service_thread_count--;
+			}
+			delete st;
+		}
 		enet_host_destroy(*host);
 	}
 	*host = NULL;
@@ -599,6 +927,7 @@ static int peer_tostring(lua_State *l) {
 
 static int peer_ping(lua_State *l) {
 	ENetPeer *peer = check_peer(l, 1);
+	HostLock lock(peer->host);
 	enet_peer_ping(peer);
 	return 0;
 }
@@ -610,6 +939,7 @@ static int peer_throttle_configure(lua_State *l) {
 	enet_uint32 acceleration = (int) luaL_checknumber(l, 3);
 	enet_uint32 deceleration = (int) luaL_checknumber(l, 4);
 
+	HostLock lock(peer->host);
 	enet_peer_throttle_configure(peer, interval, acceleration, deceleration);
 	return 0;
 }
@@ -644,6 +974,7 @@ static int peer_ping_interval(lua_State *l) {
 
 	if (lua_gettop(l) > 1) {
 		enet_uint32 interval = (int) luaL_checknumber(l, 2);
+		HostLock lock(peer->host);
 		enet_peer_ping_interval (peer, interval);
 	}
 
@@ -668,7 +999,10 @@ static int peer_timeout(lua_State *l) {
 			if (!lua_isnil(l, 2)) timeout_limit = (int) luaL_checknumber(l, 2);
 	}
 
-	enet_peer_timeout (peer, timeout_limit, timeout_minimum, timeout_maximum);
+	{
+		HostLock lock(peer->host);
+		enet_peer_timeout (peer, timeout_limit, timeout_minimum, timeout_maximum);
+	}
 
 	lua_pushinteger (l, peer->timeoutLimit);
 	lua_pushinteger (l, peer->timeoutMinimum);
@@ -681,6 +1015,7 @@ static int peer_disconnect(lua_State *l) {
 	ENetPeer *peer = check_peer(l, 1);
 
 	enet_uint32 data = lua_gettop(l) > 1 ? (int) luaL_checknumber(l, 2) : 0;
+	HostLock lock(peer->host);
 	enet_peer_disconnect(peer, data);
 	return 0;
 }
@@ -689,6 +1024,7 @@ static int peer_disconnect_now(lua_State *l) {
 	ENetPeer *peer = check_peer(l, 1);
 
 	enet_uint32 data = lua_gettop(l) > 1 ? (int) luaL_checknumber(l, 2) : 0;
+	HostLock lock(peer->host);
 	enet_peer_disconnect_now(peer, data);
 	return 0;
 }
@@ -697,6 +1033,7 @@ static int peer_disconnect_later(lua_State *l) {
 	ENetPeer *peer = check_peer(l, 1);
 
 	enet_uint32 data = lua_gettop(l) > 1 ? (int) luaL_checknumber(l, 2) : 0;
+	HostLock lock(peer->host);
 	enet_peer_disconnect_later(peer, data);
 	return 0;
 }
@@ -762,6 +1099,7 @@ static int peer_connect_id(lua_State *l) {
 
 static int peer_reset(lua_State *l) {
 	ENetPeer *peer = check_peer(l, 1);
+	HostLock lock(peer->host);
 	enet_peer_reset(peer);
 	return 0;
 }
@@ -771,17 +1109,19 @@ static int peer_receive(lua_State *l) {
 	ENetPacket *packet;
 	enet_uint8 channel_id = 0;
 
-	if (lua_gettop(l) > 1) {
+	if (lua_gettop(l) > 1 && !lua_isnil(l, 2)) {
 		channel_id = (int) luaL_checknumber(l, 2);
 	}
+	bool as_data = lua_toboolean(l, 3) != 0;
 
-	packet = enet_peer_receive(peer, &channel_id);
+	{
+		HostLock lock(peer->host);
+		packet = enet_peer_receive(peer, &channel_id);
+	}
 	if (packet == NULL) return 0;
 
-	lua_pushlstring(l, (const char *)packet->data, packet->dataLength);
+	push_packet(l, packet, as_data);
 	lua_pushinteger(l, channel_id);
-
-	enet_packet_destroy(packet);
 	return 2;
 }
 
@@ -789,7 +1129,8 @@ static int peer_receive(lua_State *l) {
 /**
  * Send a lua string to a peer
  * Args:
- *	packet data, string
+ *	packet data, string or Data (not copied, so it shouldn't be modified
+ *	until the packet has been sent)
  *	channel id
  *	flags ["reliable", nil]
  *
@@ -801,9 +1142,13 @@ static int peer_send(lua_State *l) {
 	ENetPacket *packet = read_packet(l, 2, &channel_id);
 
 	// printf("sending, channel_id=%d\n", channel_id);
-	int ret = enet_peer_send(peer, channel_id, packet);
-	if (ret < 0) {
-		enet_packet_destroy(packet);
+	int ret;
+	{
+		HostLock lock(peer->host);
+		ret = enet_peer_send(peer, channel_id, packet);
+		if (ret < 0) {
+			enet_packet_destroy(packet);
+		}
 	}
 
 	lua_pushinteger(l, ret);
@@ -829,6 +1174,8 @@ static const struct luaL_Reg enet_host_funcs [] = {
 	// Since ENetSocket isn't part of enet-lua, we should try to keep
 	// naming conventions the same as the rest of the lib.
 	{"get_socket_address", host_get_socket_address},
+	// Lets love.event.wait wake up when the host has incoming packets.
+	{"get_socket_fd", host_get_socket_fd},
 	// We need this function to free up our ports when needed!
 	{"destroy", host_gc},
 
@@ -838,6 +1185,11 @@ static const struct luaL_Reg enet_host_funcs [] = {
 	{"service_time", host_service_time},
 	{"peer_count", host_peer_count},
 	{"get_peer", host_get_peer},
+
+	// LOVE additions for servicing the host on another thread.
+	{"start_service_thread", host_start_service_thread},
+	{"stop_service_thread", host_stop_service_thread},
+	{"has_service_thread", host_has_service_thread},
 	{NULL, NULL}
 };
 
@@ -867,7 +1219,8 @@ extern "C" {
 }
 
 int luaopen_enet(lua_State *l) {
-	enet_initialize();
+	ENetCallbacks callbacks = {packet_malloc, packet_free, NULL};
+	enet_initialize_with_callbacks(ENET_VERSION, &callbacks);
 	atexit(enet_deinitialize);
 
 	// create metatables
@@ -11,10 +11,13 @@ LOCAL_ARM_NEON := true
 
 LOCAL_C_INCLUDES := \
 	${LOCAL_PATH}/src \
-	${LOCAL_PATH}/src/android
+	${LOCAL_PATH}/src/android \
+	${LOCAL_PATH}/../.. \
+	${LOCAL_PATH}/../../modules
 
 LOCAL_SRC_FILES := \
 	src/lua/main.cpp \
+	src/common/AsyncRequest.cpp \
 	src/common/HTTPS.cpp \
 	src/common/HTTPRequest.cpp \
 	src/common/HTTPSClient.cpp \
@@ -0,0 +1,201 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <thread>
+
+#include "AsyncRequest.h"
+#include "HTTPS.h"
+
+static const size_t WORKER_COUNT = 4;
+
+// Never destroyed, since detached workers may still use them at exit.
+static std::mutex *queueMutex = new std::mutex();
+static std::condition_variable *queueCond = new std::condition_variable();
+static std::deque<std::shared_ptr<AsyncRequest>> *queue = new std::deque<std::shared_ptr<AsyncRequest>>();
+static size_t workerCount = 0;
+
+AsyncRequest::AsyncRequest(const HTTPSClient::Request &req, int64_t rangeStart, std::unique_ptr<Sink> sink)
+	: req(req)
+	, done(false)
+	, bodyOffset(0)
+	, rangeStart(std::max<int64_t>(rangeStart, 0))
+	, sink(std::move(sink))
+	, headersWritten(false)
+	, sinkActive(false)
+	, received(0)
+	, total(-1)
+{
+	reply.responseCode = 0;
+	this->req.headersWriter = [this](int code, const HTTPSClient::header_map &headers) { writeHeaders(code, headers); };
+	this->req.bodyWriter = [this](const char *data, size_t size) { return writeBody(data, size); };
+
+	if (this->rangeStart > 0)
+		this->req.headers["Range"] = "bytes=" + std::to_string(this->rangeStart) + "-";
+}
+
+std::shared_ptr<AsyncRequest> AsyncRequest::start(const HTTPSClient::Request &req, int64_t rangeStart, std::unique_ptr<Sink> sink)
+{
+	std::shared_ptr<AsyncRequest> request(new AsyncRequest(req, rangeStart, std::move(sink)));
+
+	std::lock_guard<std::mutex> lock(*queueMutex);
+	queue->push_back(request);
+
+	// Workers are started as needed, and stay around for later requests.
+	if (workerCount < std::min(queue->size(), WORKER_COUNT))
+	{
+		std::thread(workerMain).detach();
+		workerCount++;
+	}
+	else
+		queueCond->notify_one();
+
+	return request;
+}
+
+void AsyncRequest::workerMain()
+{
+	while (true)
+	{
+		std::shared_ptr<AsyncRequest> request;
+		{
+			std::unique_lock<std::mutex> lock(*queueMutex);
+			queueCond->wait(lock, []() { return !queue->empty(); });
+			request = queue->front();
+			queue->pop_front();
+		}
+
+		request->run();
+	}
+}
+
+void AsyncRequest::run()
+{
+	HTTPSClient::Reply result;
+	std::string message;
+
+	try
+	{
+		result = request(req);
+
+		if (!headersWritten)
+			writeHeaders(result.responseCode, result.headers);
+
+		if (!sinkError.empty())
+			message = sinkError;
+		else if (sinkActive)
+		{
+			int64_t size = total.load();
+			if (size >= 0 && received.load() != size)
+				message = "The response body is incomplete";
+			else if (!sink->finish(message) && message.empty())
+				message = "Could not finish writing the response body";
+		}
+	}
+	catch (const std::exception &e)
+	{
+		message = e.what();
+		if (message.empty())
+			message = "Unknown error";
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+	reply = result;
+	error = message;
+	done = true;
+	doneCond.notify_all();
+}
+
+void AsyncRequest::writeHeaders(int code, const HTTPSClient::header_map &headers)
+{
+	headersWritten = true;
+	sinkActive = sink && code >= 200 && code < 300;
+
+	// A server which ignores the range sends the whole body, which mustn't be
+	// added to what the sink already has.
+	if (sinkActive && rangeStart > 0 && code != 206)
+	{
+		sinkError = "The server does not support resuming this download";
+		sinkActive = false;
+	}
+
+	int64_t offset = code == 206 ? rangeStart : 0;
+	received = offset;
+
+	auto length = headers.find("Content-Length");
+	if (length != headers.end())
+		total = offset + std::strtoll(length->second.c_str(), nullptr, 10);
+	else
+		total = -1;
+}
+
+bool AsyncRequest::writeBody(const char *data, size_t size)
+{
+	if (!sinkError.empty())
+		return false;
+
+	received += size;
+
+	if (sinkActive)
+	{
+		if (!sink->write(data, size))
+		{
+			sinkError = "Could not write the response body";
+			return false;
+		}
+		return true;
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	// Drop bytes which were already read rather than letting them pile up.
+	if (bodyOffset > 0 && bodyOffset >= body.size() / 2)
+	{
+		body.erase(0, bodyOffset);
+		bodyOffset = 0;
+	}
+
+	body.append(data, size);
+	return true;
+}
+
+void AsyncRequest::getProgress(int64_t &received, int64_t &total) const
+{
+	received = this->received.load();
+	total = this->total.load();
+}
+
+bool AsyncRequest::isDone() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return done;
+}
+
+bool AsyncRequest::wait(double timeout)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	if (timeout < 0)
+		doneCond.wait(lock, [this]() { return done; });
+	else
+		doneCond.wait_for(lock, std::chrono::duration<double>(timeout), [this]() { return done; });
+	return done;
+}
+
+size_t AsyncRequest::read(char *buffer, size_t size)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	size_t count = std::min(size, body.size() - bodyOffset);
+	std::copy(body.data() + bodyOffset, body.data() + bodyOffset + count, buffer);
+	bodyOffset += count;
+	return count;
+}
+
+std::string AsyncRequest::read(size_t size)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	size_t count = std::min(size, body.size() - bodyOffset);
+	std::string result = body.substr(bodyOffset, count);
+	bodyOffset += count;
+	return result;
+}
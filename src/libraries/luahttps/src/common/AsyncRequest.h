@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "HTTPSClient.h"
+
+// A request performed by a pool of worker threads. The body can be read while
+// it's still being received.
+class AsyncRequest
+{
+public:
+	// Receives the body of a successful (2xx) response on the worker thread,
+	// instead of it being kept for read.
+	class Sink
+	{
+	public:
+		virtual ~Sink() {}
+		virtual bool write(const char *data, size_t size) = 0;
+
+		// Called after the whole body was written. Returning false fails the
+		// request with the given error.
+		virtual bool finish(std::string &error) { (void) error; return true; }
+	};
+
+	// A positive rangeStart requests the body from that byte on, to resume
+	// a download which the sink already has the start of.
+	static std::shared_ptr<AsyncRequest> start(const HTTPSClient::Request &req, int64_t rangeStart = 0, std::unique_ptr<Sink> sink = nullptr);
+
+	bool isDone() const;
+
+	// Waits up to timeout seconds for the request to finish, or forever if
+	// timeout is negative. Returns whether it has finished.
+	bool wait(double timeout);
+
+	// Gets the bytes of the body received so far, including a skipped range,
+	// and the full size of the body or -1 if it isn't known yet.
+	void getProgress(int64_t &received, int64_t &total) const;
+
+	Sink *getSink() const { return sink.get(); }
+
+	// Moves up to size bytes of the body received so far into buffer.
+	size_t read(char *buffer, size_t size);
+	std::string read(size_t size);
+
+	// Only valid once the request is done.
+	const HTTPSClient::Reply &getReply() const { return reply; }
+	bool failed() const { return !error.empty(); }
+	const std::string &getError() const { return error; }
+
+private:
+	AsyncRequest(const HTTPSClient::Request &req, int64_t rangeStart, std::unique_ptr<Sink> sink);
+
+	void run();
+	void writeHeaders(int code, const HTTPSClient::header_map &headers);
+	bool writeBody(const char *data, size_t size);
+
+	static void workerMain();
+
+	HTTPSClient::Request req;
+	HTTPSClient::Reply reply;
+	std::string error;
+
+	mutable std::mutex mutex;
+	std::condition_variable doneCond;
+	bool done;
+
+	// Received body bytes which haven't been read yet start at bodyOffset.
+	std::string body;
+	size_t bodyOffset;
+
+	// Only used by the worker thread.
+	int64_t rangeStart;
+	std::unique_ptr<Sink> sink;
+	bool headersWritten;
+	bool sinkActive;
+	std::string sinkError;
+
+	std::atomic<int64_t> received;
+	std::atomic<int64_t> total;
+};
@@ -1,17 +1,143 @@
+#include <algorithm>
 #include <sstream>
 #include <string>
 #include <memory>
 #include <limits>
 #include <stdexcept>
+#include <mutex>
+#include <vector>
+#include <cstdlib>
+#include <cctype>
 
 #include "HTTPRequest.h"
 #include "PlaintextConnection.h"
 
+static std::mutex idleMutex;
+static std::map<std::string, std::vector<Connection *>> idleConnections;
+
+static std::string trimWhitespace(const std::string &str)
+{
+	size_t start = str.find_first_not_of(" \t");
+	if (start == std::string::npos)
+		return std::string();
+	size_t end = str.find_last_not_of(" \t");
+	return str.substr(start, end - start + 1);
+}
+
+// Header values such as Connection and Transfer-Encoding are case-insensitive
+// lists. The header names are already matched case-insensitively by the
+// header_map.
+static bool hasToken(const HTTPSClient::header_map &headers, const char *name, const std::string &token)
+{
+	auto it = headers.find(name);
+	if (it == headers.end())
+		return false;
+
+	std::string value = it->second;
+	std::transform(value.begin(), value.end(), value.begin(), [](char c) { return (char) std::tolower((unsigned char) c); });
+	return value.find(token) != std::string::npos;
+}
+
+// Buffers reads from a Connection so the response can be parsed line by line
+// and the body read exactly, leaving the connection usable for another request.
+class ResponseReader
+{
+public:
+	ResponseReader(Connection *conn)
+		: conn(conn)
+		, pos(0)
+		, end(0)
+		, received(0)
+	{
+	}
+
+	bool readLine(std::string &line)
+	{
+		line.clear();
+		while (true)
+		{
+			if (pos == end && !fill())
+				return false;
+
+			char c = buffer[pos++];
+			if (c == '\n')
+				break;
+			line.push_back(c);
+		}
+
+		if (!line.empty() && line.back() == '\r')
+			line.pop_back();
+		return true;
+	}
+
+	// Passes up to size bytes to the writer, returns the amount passed on or
+	// 0 if the writer refused them.
+	size_t read(size_t size, const std::function<bool(const char *, size_t)> &writer)
+	{
+		if (pos == end && !fill())
+			return 0;
+
+		size_t count = std::min(size, end - pos);
+		if (!writer(buffer + pos, count))
+			return 0;
+		pos += count;
+		return count;
+	}
+
+	size_t getReceived() const
+	{
+		return received;
+	}
+
+private:
+	bool fill()
+	{
+		pos = 0;
+		end = conn->read(buffer, sizeof(buffer));
+		received += end;
+		return end > 0;
+	}
+
+	Connection *conn;
+	char buffer[8192];
+	size_t pos;
+	size_t end;
+	size_t received;
+};
+
 HTTPRequest::HTTPRequest(ConnectionFactory factory)
 	: factory(factory)
 {
 }
 
+Connection *HTTPRequest::takeIdleConnection(const std::string &key)
+{
+	std::lock_guard<std::mutex> lock(idleMutex);
+	auto &idle = idleConnections[key];
+	if (idle.empty())
+		return nullptr;
+
+	Connection *conn = idle.back();
+	idle.pop_back();
+	return conn;
+}
+
+void HTTPRequest::returnIdleConnection(const std::string &key, Connection *conn)
+{
+	{
+		std::lock_guard<std::mutex> lock(idleMutex);
+		auto &idle = idleConnections[key];
+		if (idle.size() < MAX_IDLE_CONNECTIONS)
+		{
+			idle.push_back(conn);
+			return;
+		}
+	}
+
+	conn->close();
+	delete conn;
+}
+
 HTTPSClient::Reply HTTPRequest::request(const HTTPSClient::Request &req)
 {
 	HTTPSClient::Reply reply;
@@ -21,18 +147,13 @@ HTTPSClient::Reply HTTPRequest::request(const HTTPSClient::Request &req)
 	if (!info.valid)
 		return reply;
 
-	std::unique_ptr<Connection> conn;
-	if (info.schema == "http")
-		conn.reset(new PlaintextConnection());
-	else if (info.schema == "https")
-		conn.reset(factory());
-	else
+	if (info.schema != "http" && info.schema != "https")
 		throw std::runtime_error("Unknown url schema");
 
-	if (!conn->connect(info.hostname, info.port))
-		return reply;
+	std::string key = info.schema + "://" + info.hostname + ":" + std::to_string(info.port);
 
 	// Build the request
+	std::string requestData;
 	{
 		std::stringstream request;
 		std::string method = req.method;
@@ -46,8 +167,6 @@ HTTPSClient::Reply HTTPRequest::request(const HTTPSClient::Request &req)
 		for (auto &header : req.headers)
 			request << header.first << ": " << header.second << "\r\n";
 
-		request << "Connection: Close\r\n";
-
 		request << "Host: " << info.hostname << "\r\n";
 
 		if (hasData)
@@ -58,47 +177,160 @@ HTTPSClient::Reply HTTPRequest::request(const HTTPSClient::Request &req)
 		if (hasData)
 			request << req.postdata;
 
-		// Send it
-		std::string requestData = request.str();
-		conn->write(requestData.c_str(), requestData.size());
+		requestData = request.str();
 	}
 
-	// Now receive the reply
-	std::stringstream response;
+	auto writeBody = [&](const char *data, size_t size) -> bool
+	{
+		if (req.bodyWriter)
+			return req.bodyWriter(data, size);
+		reply.body.append(data, size);
+		return true;
+	};
+
+	// An idle connection may have been closed by the server since it was last
+	// used. If so nothing is received, and the request is sent again on a new
+	// connection.
+	for (int attempt = 0; attempt < 2; ++attempt)
 	{
-		char buffer[8192];
+		std::unique_ptr<Connection> conn(attempt == 0 ? takeIdleConnection(key) : nullptr);
+		bool reused = conn != nullptr;
 
+		if (!conn)
+		{
+			if (info.schema == "http")
+				conn.reset(new PlaintextConnection());
+			else
+				conn.reset(factory());
+
+			if (!conn->connect(info.hostname, info.port))
+				return reply;
+		}
+
+		ResponseReader reader(conn.get());
+		std::string line;
+
+		if (conn->write(requestData.c_str(), requestData.size()) == 0 || !reader.readLine(line))
+		{
+			conn->close();
+			if (reused && reader.getReceived() == 0)
+				continue;
+			return reply;
+		}
+
+		// Parse the status line and headers. Interim 1xx responses, such as
+		// 100 Continue, are followed by the actual response.
+		std::string protocol;
 		while (true)
 		{
-			size_t read = conn->read(buffer, sizeof(buffer));
-			response.write(buffer, read);
-			if (read == 0)
+			reply.responseCode = 500;
+			reply.headers.clear();
+
+			{
+				std::stringstream status(line);
+				status >> protocol >> reply.responseCode;
+			}
+
+			if (protocol != "HTTP/1.1" && protocol != "HTTP/1.0")
+			{
+				conn->close();
+				return reply;
+			}
+
+			while (reader.readLine(line) && !line.empty())
+			{
+				auto sep = line.find(':');
+				if (sep != std::string::npos)
+					reply.headers[line.substr(0, sep)] = trimWhitespace(line.substr(sep+1));
+			}
+
+			int code = reply.responseCode;
+			if (code < 100 || code >= 200 || code == 101)
 				break;
+
+			if (!reader.readLine(line))
+			{
+				conn->close();
+				return reply;
+			}
 		}
 
-		conn->close();
-	}
+		if (req.headersWriter)
+			req.headersWriter(reply.responseCode, reply.headers);
 
-	reply.responseCode = 500;
-	// And parse it
-	{
-		std::string protocol;
-		response >> protocol;
-		if (protocol != "HTTP/1.1")
-			return reply;
+		int code = reply.responseCode;
+
+		// A 101 response switches the connection to another protocol.
+		bool keepAlive = protocol == "HTTP/1.1" && code != 101;
+		if (hasToken(reply.headers, "Connection", "close"))
+			keepAlive = false;
 
-		response >> reply.responseCode;
-		response.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+		// Now receive the body, which is either empty, chunked, a known
+		// length or everything until the server closes the connection.
+		bool complete = true;
 
-		for (std::string line; getline(response, line, '\n') && line != "\r"; )
+		auto length = reply.headers.find("Content-Length");
+
+		if (req.method == "HEAD" || code == 101 || code == 204 || code == 304)
+		{
+		}
+		else if (hasToken(reply.headers, "Transfer-Encoding", "chunked"))
+		{
+			while (true)
+			{
+				if (!reader.readLine(line))
+				{
+					complete = false;
+					break;
+				}
+
+				size_t size = std::strtoul(line.c_str(), nullptr, 16);
+				if (size == 0)
+				{
+					// Skip trailers
+					while (reader.readLine(line) && !line.empty());
+					break;
+				}
+
+				while (size > 0)
+				{
+					size_t read = reader.read(size, writeBody);
+					if (read == 0)
+						break;
+					size -= read;
+				}
+
+				if (size > 0 || !reader.readLine(line))
+				{
+					complete = false;
+					break;
+				}
+			}
+		}
+		else if (length != reply.headers.end())
+		{
+			size_t size = std::strtoul(length->second.c_str(), nullptr, 10);
+			while (size > 0)
+			{
+				size_t read = reader.read(size, writeBody);
+				if (read == 0)
+					break;
+				size -= read;
+			}
+			complete = size == 0;
+		}
+		else
 		{
-			auto sep = line.find(':');
-			reply.headers[line.substr(0, sep)] = line.substr(sep+1, line.size()-sep-1);
+			while (reader.read(std::numeric_limits<size_t>::max(), writeBody) > 0);
+			keepAlive = false;
 		}
 
-		auto begin = std::istreambuf_iterator<char>(response);
-		auto end = std::istreambuf_iterator<char>();
-		reply.body = std::string(begin, end);
+		if (keepAlive && complete)
+			returnIdleConnection(key, conn.release());
+		else
+			conn->close();
+
+		break;
 	}
 
 	return reply;
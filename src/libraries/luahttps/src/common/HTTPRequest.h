@@ -26,5 +26,12 @@ public:
 	static DissectedURL parseUrl(const std::string &url);
 
 private:
+	// Idle keep-alive connections are kept per schema, host and port so
+	// later requests to the same server skip the connect and handshake.
+	static const size_t MAX_IDLE_CONNECTIONS = 4;
+
+	Connection *takeIdleConnection(const std::string &key);
+	void returnIdleConnection(const std::string &key, Connection *conn);
+
 	ConnectionFactory factory;
 };
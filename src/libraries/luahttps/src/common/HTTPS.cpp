@@ -71,8 +71,21 @@ HTTPSClient::Reply request(const HTTPSClient::Request &req)
 	{
 		HTTPSClient &client = *clients[i];
 
-		if (client.valid())
-			return client.request(req);
+		if (!client.valid())
+			continue;
+
+		HTTPSClient::Reply reply = client.request(req);
+
+		// Not every backend streams, pass on the whole body in that case.
+		if (req.bodyWriter && !reply.body.empty())
+		{
+			if (req.headersWriter)
+				req.headersWriter(reply.responseCode, reply.headers);
+			req.bodyWriter(reply.body.data(), reply.body.size());
+			reply.body.clear();
+		}
+
+		return reply;
 	}
 
 	throw std::runtime_error("No applicable HTTPS implementation found");
@@ -3,6 +3,7 @@
 #include <cstdint>
 #include <string>
 #include <map>
+#include <functional>
 
 class HTTPSClient
 {
@@ -21,6 +22,14 @@ public:
 		std::string url;
 		std::string postdata;
 		std::string method;
+
+		// If set, the response body is passed here as it arrives instead of
+		// being stored in Reply::body. Returning false aborts the request.
+		std::function<bool(const char *data, size_t size)> bodyWriter;
+
+		// If set, called with the response code and headers before the body
+		// is passed to bodyWriter.
+		std::function<void(int code, const header_map &headers)> headersWriter;
 	};
 
 	struct Reply
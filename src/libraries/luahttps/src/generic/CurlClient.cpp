@@ -25,6 +25,20 @@ typedef struct StringReader
 	size_t pos;
 } StringReader;
 
+typedef struct BodyWriter
+{
+	const HTTPSClient::Request *req;
+	std::string *body;
+} BodyWriter;
+
+typedef struct HeaderWriter
+{
+	const HTTPSClient::Request *req;
+	HTTPSClient::Reply *reply;
+	CURL *handle;
+	decltype(&curl_easy_getinfo) easy_getinfo;
+} HeaderWriter;
+
 template <class T>
 static inline bool loadSymbol(T &var, void *handle, const char *name)
 {
@@ -42,6 +56,7 @@ CurlClient::Curl::Curl()
 , global_cleanup(nullptr)
 , easy_init(nullptr)
 , easy_cleanup(nullptr)
+, easy_reset(nullptr)
 , easy_setopt(nullptr)
 , easy_perform(nullptr)
 , easy_getinfo(nullptr)
@@ -66,6 +81,8 @@ CurlClient::Curl::Curl()
 		return;
 	if (!loadSymbol(easy_cleanup, handle, "curl_easy_cleanup"))
 		return;
+	if (!loadSymbol(easy_reset, handle, "curl_easy_reset"))
+		return;
 	if (!loadSymbol(easy_setopt, handle, "curl_easy_setopt"))
 		return;
 	if (!loadSymbol(easy_perform, handle, "curl_easy_perform"))
@@ -83,6 +100,9 @@ CurlClient::Curl::Curl()
 
 CurlClient::Curl::~Curl()
 {
+	for (CURL *idle : idleHandles)
+		easy_cleanup(idle);
+
 	if (loaded)
 		global_cleanup();
 
@@ -114,18 +134,33 @@ static size_t stringReader(char *ptr, size_t size, size_t nmemb, StringReader *r
 	return desiredCount;
 }
 
-static size_t stringstreamWriter(char *ptr, size_t size, size_t nmemb, std::stringstream *ss)
+static size_t bodyWriter(char *ptr, size_t size, size_t nmemb, BodyWriter *writer)
 {
 	size_t count = size*nmemb;
-	ss->write(ptr, count);
+	if (writer->req->bodyWriter)
+		return writer->req->bodyWriter(ptr, count) ? count : 0;
+	writer->body->append(ptr, count);
 	return count;
 }
 
-static size_t headerWriter(char *ptr, size_t size, size_t nmemb, std::map<std::string,std::string> *userdata)
+static size_t headerWriter(char *ptr, size_t size, size_t nmemb, HeaderWriter *writer)
 {
-	std::map<std::string, std::string> &headers = *userdata;
+	HTTPSClient::header_map &headers = writer->reply->headers;
 	size_t count = size*nmemb;
 	std::string line(ptr, count);
+
+	// The blank line after the headers.
+	if (line == "\r\n" || line == "\n")
+	{
+		if (writer->req->headersWriter)
+		{
+			long responseCode = 0;
+			writer->easy_getinfo(writer->handle, CURLINFO_RESPONSE_CODE, &responseCode);
+			writer->req->headersWriter((int) responseCode, headers);
+		}
+		return count;
+	}
+
 	size_t split = line.find(':');
 	size_t newline = line.find('\r');
 	if (newline == std::string::npos)
@@ -141,6 +176,38 @@ bool CurlClient::valid() const
 	return curl.loaded;
 }
 
+CURL *CurlClient::takeHandle()
+{
+	{
+		std::lock_guard<std::mutex> lock(curl.idleMutex);
+		if (!curl.idleHandles.empty())
+		{
+			CURL *handle = curl.idleHandles.back();
+			curl.idleHandles.pop_back();
+			return handle;
+		}
+	}
+
+	return curl.easy_init();
+}
+
+void CurlClient::returnHandle(CURL *handle)
+{
+	// Resetting clears the options but keeps the connection cache.
+	curl.easy_reset(handle);
+
+	{
+		std::lock_guard<std::mutex> lock(curl.idleMutex);
+		if (curl.idleHandles.size() < MAX_IDLE_HANDLES)
+		{
+			curl.idleHandles.push_back(handle);
+			return;
+		}
+	}
+
+	curl.easy_cleanup(handle);
+}
+
 HTTPSClient::Reply CurlClient::request(const HTTPSClient::Request &req)
 {
 	Reply reply;
@@ -149,7 +216,7 @@ HTTPSClient::Reply CurlClient::request(const HTTPSClient::Request &req)
 	// Use sensible default header for later
 	HTTPSClient::header_map newHeaders = req.headers;
 
-	CURL *handle = curl.easy_init();
+	CURL *handle = takeHandle();
 	if (!handle)
 		throw std::runtime_error("Could not create curl request");
 
@@ -188,13 +255,15 @@ HTTPSClient::Reply CurlClient::request(const HTTPSClient::Request &req)
 	if (sendHeaders)
 		curl.easy_setopt(handle, CURLOPT_HTTPHEADER, sendHeaders);
 
-	std::stringstream body;
+	BodyWriter writer {&req, &reply.body};
 
-	curl.easy_setopt(handle, CURLOPT_WRITEFUNCTION, stringstreamWriter);
-	curl.easy_setopt(handle, CURLOPT_WRITEDATA, &body);
+	curl.easy_setopt(handle, CURLOPT_WRITEFUNCTION, bodyWriter);
+	curl.easy_setopt(handle, CURLOPT_WRITEDATA, &writer);
+
+	HeaderWriter headerData {&req, &reply, handle, curl.easy_getinfo};
 
 	curl.easy_setopt(handle, CURLOPT_HEADERFUNCTION, headerWriter);
-	curl.easy_setopt(handle, CURLOPT_HEADERDATA, &reply.headers);
+	curl.easy_setopt(handle, CURLOPT_HEADERDATA, &headerData);
 
 	curl.easy_perform(handle);
 
@@ -207,9 +276,7 @@ HTTPSClient::Reply CurlClient::request(const HTTPSClient::Request &req)
 		reply.responseCode = (int) responseCode;
 	}
 
-	reply.body = body.str();
-
-	curl.easy_cleanup(handle);
+	returnHandle(handle);
 	return reply;
 }
 
@@ -6,6 +6,9 @@
 
 #include <curl/curl.h>
 
+#include <mutex>
+#include <vector>
+
 #include "../common/HTTPSClient.h"
 
 class CurlClient : public HTTPSClient
@@ -15,6 +18,13 @@ public:
 	virtual HTTPSClient::Reply request(const HTTPSClient::Request &req) override;
 
 private:
+	// Finished easy handles are kept and reused, which lets curl keep their
+	// connections to a server alive between requests.
+	static const size_t MAX_IDLE_HANDLES = 4;
+
+	CURL *takeHandle();
+	void returnHandle(CURL *handle);
+
 	static struct Curl
 	{
 		Curl();
@@ -26,12 +36,16 @@ private:
 
 		decltype(&curl_easy_init) easy_init;
 		decltype(&curl_easy_cleanup) easy_cleanup;
+		decltype(&curl_easy_reset) easy_reset;
 		decltype(&curl_easy_setopt) easy_setopt;
 		decltype(&curl_easy_perform) easy_perform;
 		decltype(&curl_easy_getinfo) easy_getinfo;
 
 		decltype(&curl_slist_append) slist_append;
 		decltype(&curl_slist_free_all) slist_free_all;
+
+		std::mutex idleMutex;
+		std::vector<CURL *> idleHandles;
 	} curl;
 };
 
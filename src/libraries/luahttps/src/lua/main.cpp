@@ -1,4 +1,6 @@
 #include <algorithm>
+#include <memory>
+#include <new>
 #include <set>
 
 extern "C"
@@ -8,8 +10,14 @@ extern "C"
 }
 
 #include "../common/HTTPS.h"
+#include "../common/AsyncRequest.h"
 #include "../common/config.h"
 
+// LOVE
+#include "common/runtime.h"
+#include "filesystem/Filesystem.h"
+#include "data/HashFunction.h"
+
 static std::string validMethod[] = {"GET", "HEAD", "POST", "PUT", "DELETE", "PATCH"};
 
 static int str_toupper(char c)
@@ -18,6 +26,12 @@ static int str_toupper(char c)
 	return toupper(uc);
 }
 
+static int str_tolower(char c)
+{
+	unsigned char uc = (unsigned char) c;
+	return tolower(uc);
+}
+
 static std::string w_checkstring(lua_State *L, int idx)
 {
 	size_t len;
@@ -61,11 +75,9 @@ static std::string w_optmethod(lua_State *L, int idx, const std::string &default
 	return str;
 }
 
-static int w_request(lua_State *L)
+// Reads the options table at index 2 into req, returns whether it was given.
+static bool w_readrequest(lua_State *L, HTTPSClient::Request &req)
 {
-	auto url = w_checkstring(L, 1);
-	HTTPSClient::Request req(url);
-
 	bool advanced = false;
 
 	if (lua_istable(L, 2))
@@ -93,6 +105,35 @@ static int w_request(lua_State *L)
 		lua_pop(L, 1);
 	}
 
+	return advanced;
+}
+
+static int w_pushreply(lua_State *L, const HTTPSClient::Reply &reply, const std::string &body, bool advanced)
+{
+	lua_pushinteger(L, reply.responseCode);
+	w_pushstring(L, body);
+
+	if (advanced)
+	{
+		lua_newtable(L);
+		for (const auto &header : reply.headers)
+		{
+			w_pushstring(L, header.first);
+			w_pushstring(L, header.second);
+			lua_settable(L, -3);
+		}
+	}
+
+	return advanced ? 3 : 2;
+}
+
+static int w_request(lua_State *L)
+{
+	auto url = w_checkstring(L, 1);
+	HTTPSClient::Request req(url);
+
+	bool advanced = w_readrequest(L, req);
+
 	HTTPSClient::Reply reply;
 
 	try
@@ -107,29 +148,339 @@ static int w_request(lua_State *L)
 		return 2;
 	}
 
-	lua_pushinteger(L, reply.responseCode);
-	w_pushstring(L, reply.body);
+	return w_pushreply(L, reply, reply.body, advanced);
+}
 
-	if (advanced)
+static const char *ASYNC_REQUEST_NAME = "https.AsyncRequest";
+
+// Writes a download straight into a love File, optionally hashing it as it
+// goes so it can be verified without reading it back.
+class FileSink : public AsyncRequest::Sink
+{
+public:
+	FileSink(love::filesystem::File *file, int64_t offset)
+		: file(file)
+		, offset(offset)
 	{
-		lua_newtable(L);
-		for (const auto &header : reply.headers)
+	}
+
+	void setHash(love::data::HashFunction::State *state, const std::string &expected)
+	{
+		this->state.reset(state);
+		this->expected = expected;
+		std::transform(this->expected.begin(), this->expected.end(), this->expected.begin(), str_tolower);
+	}
+
+	bool write(const char *data, size_t size) override
+	{
+		try
 		{
-			w_pushstring(L, header.first);
-			w_pushstring(L, header.second);
-			lua_settable(L, -3);
+			// A resumed download is hashed from the start of the file.
+			if (state && offset > 0)
+			{
+				hashExisting();
+				offset = 0;
+			}
+
+			if (!file->write(data, (love::int64) size))
+				return false;
+
+			if (state)
+				state->update(data, size);
 		}
+		catch (std::exception &)
+		{
+			return false;
+		}
+
+		return true;
 	}
 
-	return advanced ? 3 : 2;
+	bool finish(std::string &error) override
+	{
+		try
+		{
+			file->flush();
+
+			if (state)
+			{
+				if (offset > 0)
+					hashExisting();
+
+				love::data::HashFunction::Value value;
+				state->finalize(value);
+
+				static const char hexchars[] = "0123456789abcdef";
+				for (size_t i = 0; i < value.size; i++)
+				{
+					unsigned char c = (unsigned char) value.data[i];
+					digest.push_back(hexchars[c >> 4]);
+					digest.push_back(hexchars[c & 0xF]);
+				}
+
+				if (!expected.empty() && digest != expected)
+				{
+					error = "Hash mismatch: expected " + expected + ", got " + digest;
+					return false;
+				}
+			}
+		}
+		catch (std::exception &e)
+		{
+			error = e.what();
+			return false;
+		}
+
+		return true;
+	}
+
+	// Only valid once the request is done.
+	const std::string &getDigest() const { return digest; }
+
+private:
+	void hashExisting()
+	{
+		auto fs = love::Module::getInstance<love::filesystem::Filesystem>(love::Module::M_FILESYSTEM);
+		if (fs == nullptr)
+			throw love::Exception("The filesystem module is not loaded.");
+
+		love::StrongRef<love::filesystem::File> existing(fs->openFile(file->getFilename().c_str(), love::filesystem::File::MODE_READ), love::Acquire::NORETAIN);
+
+		char buffer[64 * 1024];
+		int64_t remaining = offset;
+		while (remaining > 0)
+		{
+			love::int64 read = existing->read(buffer, std::min<int64_t>(remaining, sizeof(buffer)));
+			if (read <= 0)
+				throw love::Exception("Could not read the start of the resumed file.");
+			state->update(buffer, read);
+			remaining -= read;
+		}
+	}
+
+	love::StrongRef<love::filesystem::File> file;
+	int64_t offset;
+
+	std::unique_ptr<love::data::HashFunction::State> state;
+	std::string expected;
+	std::string digest;
+};
+
+struct AsyncRequestProxy
+{
+	std::shared_ptr<AsyncRequest> request;
+	FileSink *fileSink;
+	bool advanced;
+};
+
+static AsyncRequestProxy *w_checkasyncrequest(lua_State *L, int idx)
+{
+	return (AsyncRequestProxy *) luaL_checkudata(L, idx, ASYNC_REQUEST_NAME);
+}
+
+// Same arguments as request, but returns an object right away while the
+// request runs on a worker thread. The options table also takes:
+//	file, a File open for writing or appending which gets the body
+//	offset, resume the download from this byte
+//	hash, name of a love.data.hash function to hash the file with
+//	expectedhash, hex digest the file must match
+static int w_requestAsync(lua_State *L)
+{
+	auto url = w_checkstring(L, 1);
+	HTTPSClient::Request req(url);
+
+	bool advanced = w_readrequest(L, req);
+
+	int64_t offset = 0;
+	love::filesystem::File *file = nullptr;
+	love::data::HashFunction *hashfunction = nullptr;
+	love::data::HashFunction::Function function = love::data::HashFunction::FUNCTION_MAX_ENUM;
+	std::string expected;
+
+	if (lua_istable(L, 2))
+	{
+		lua_getfield(L, 2, "offset");
+		offset = (int64_t) luaL_optnumber(L, -1, 0);
+		lua_pop(L, 1);
+
+		lua_getfield(L, 2, "file");
+		if (!lua_isnoneornil(L, -1))
+		{
+			file = love::luax_checktype<love::filesystem::File>(L, -1);
+			auto mode = file->getMode();
+			if (mode != love::filesystem::File::MODE_WRITE && mode != love::filesystem::File::MODE_APPEND)
+				return luaL_error(L, "The download File must be open for writing or appending.");
+		}
+		lua_pop(L, 1);
+
+		lua_getfield(L, 2, "hash");
+		if (!lua_isnoneornil(L, -1))
+		{
+			const char *name = luaL_checkstring(L, -1);
+			if (!love::data::HashFunction::getConstant(name, function))
+				return love::luax_enumerror(L, "hash function", love::data::HashFunction::getConstants(function), name);
+			if (file == nullptr)
+				return luaL_error(L, "Hashing a download requires a file.");
+
+			hashfunction = love::data::HashFunction::getHashFunction(function);
+			if (hashfunction == nullptr || !hashfunction->isSupported(function))
+				return luaL_error(L, "Hash function %s is not supported.", name);
+		}
+		lua_pop(L, 1);
+
+		lua_getfield(L, 2, "expectedhash");
+		expected = luaL_optstring(L, -1, "");
+		lua_pop(L, 1);
+	}
+
+	std::unique_ptr<FileSink> fileSink;
+	if (file != nullptr)
+	{
+		fileSink.reset(new FileSink(file, offset));
+		if (hashfunction != nullptr)
+			fileSink->setHash(hashfunction->newState(function, 0), expected);
+	}
+
+	auto proxy = (AsyncRequestProxy *) lua_newuserdata(L, sizeof(AsyncRequestProxy));
+	new (proxy) AsyncRequestProxy();
+	proxy->advanced = advanced;
+	proxy->fileSink = fileSink.get();
+	luaL_getmetatable(L, ASYNC_REQUEST_NAME);
+	lua_setmetatable(L, -2);
+
+	try
+	{
+		proxy->request = AsyncRequest::start(req, offset, std::move(fileSink));
+	}
+	catch (const std::exception& e)
+	{
+		return luaL_error(L, "%s", e.what());
+	}
+
+	return 1;
+}
+
+static int w_AsyncRequest_gc(lua_State *L)
+{
+	AsyncRequestProxy *proxy = w_checkasyncrequest(L, 1);
+	proxy->~AsyncRequestProxy();
+	return 0;
+}
+
+static int w_AsyncRequest_isDone(lua_State *L)
+{
+	AsyncRequestProxy *proxy = w_checkasyncrequest(L, 1);
+	lua_pushboolean(L, proxy->request->isDone());
+	return 1;
+}
+
+static int w_AsyncRequest_wait(lua_State *L)
+{
+	AsyncRequestProxy *proxy = w_checkasyncrequest(L, 1);
+	double timeout = luaL_optnumber(L, 2, -1);
+	lua_pushboolean(L, proxy->request->wait(timeout));
+	return 1;
+}
+
+// Returns the bytes received so far and the total size, or nil if unknown.
+// Both include the offset of a resumed download.
+static int w_AsyncRequest_getProgress(lua_State *L)
+{
+	AsyncRequestProxy *proxy = w_checkasyncrequest(L, 1);
+	int64_t received = 0;
+	int64_t total = 0;
+	proxy->request->getProgress(received, total);
+
+	lua_pushnumber(L, (lua_Number) received);
+	if (total >= 0)
+		lua_pushnumber(L, (lua_Number) total);
+	else
+		lua_pushnil(L);
+	return 2;
+}
+
+// Returns the hex digest of a hashed download once it has finished.
+static int w_AsyncRequest_getHash(lua_State *L)
+{
+	AsyncRequestProxy *proxy = w_checkasyncrequest(L, 1);
+	if (proxy->fileSink == nullptr || !proxy->request->isDone() || proxy->fileSink->getDigest().empty())
+		return 0;
+
+	w_pushstring(L, proxy->fileSink->getDigest());
+	return 1;
+}
+
+// Returns the body received so far which hasn't been read yet, as a string,
+// or copies it into memory given as a lightuserdata pointer and size (e.g.
+// from Data:getPointer) and returns the number of bytes copied.
+static int w_AsyncRequest_read(lua_State *L)
+{
+	AsyncRequestProxy *proxy = w_checkasyncrequest(L, 1);
+
+	if (lua_islightuserdata(L, 2))
+	{
+		char *buffer = (char *) lua_touserdata(L, 2);
+		size_t size = (size_t) luaL_checknumber(L, 3);
+		lua_pushnumber(L, (lua_Number) proxy->request->read(buffer, size));
+		return 1;
+	}
+
+	size_t size = (size_t) luaL_optnumber(L, 2, (lua_Number) std::string::npos);
+	w_pushstring(L, proxy->request->read(size));
+	return 1;
+}
+
+// Returns nothing while the request is running, and the same values as
+// request once it's done. The body only contains what hasn't been read.
+static int w_AsyncRequest_getResponse(lua_State *L)
+{
+	AsyncRequestProxy *proxy = w_checkasyncrequest(L, 1);
+	AsyncRequest &request = *proxy->request;
+
+	if (!request.isDone())
+		return 0;
+
+	if (request.failed())
+	{
+		lua_pushnil(L);
+		w_pushstring(L, request.getError());
+		return 2;
+	}
+
+	return w_pushreply(L, request.getReply(), request.read(std::string::npos), proxy->advanced);
 }
 
 extern "C" int HTTPS_DLLEXPORT luaopen_https(lua_State *L)
 {
+	static const luaL_Reg asyncRequestFunctions[] = {
+		{"isDone", w_AsyncRequest_isDone},
+		{"wait", w_AsyncRequest_wait},
+		{"read", w_AsyncRequest_read},
+		{"getResponse", w_AsyncRequest_getResponse},
+		{"getProgress", w_AsyncRequest_getProgress},
+		{"getHash", w_AsyncRequest_getHash},
+		{nullptr, nullptr},
+	};
+
+	luaL_newmetatable(L, ASYNC_REQUEST_NAME);
+	lua_pushvalue(L, -1);
+	lua_setfield(L, -2, "__index");
+	lua_pushcfunction(L, w_AsyncRequest_gc);
+	lua_setfield(L, -2, "__gc");
+	for (const luaL_Reg *f = asyncRequestFunctions; f->name; f++)
+	{
+		lua_pushcfunction(L, f->func);
+		lua_setfield(L, -2, f->name);
+	}
+	lua_pop(L, 1);
+
 	lua_newtable(L);
 
 	lua_pushcfunction(L, w_request);
 	lua_setfield(L, -2, "request");
 
+	lua_pushcfunction(L, w_requestAsync);
+	lua_setfield(L, -2, "requestAsync");
+
 	return 1;
 }
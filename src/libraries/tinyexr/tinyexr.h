@@ -10923,10 +10923,20 @@ static int DecodeChunk(EXRImage *exr_image, const EXRHeader *exr_header,
         num_channels, exr_header->channels, exr_header->requested_pixel_types,
         data_width, data_height);
 
+#if defined(TINYEXR_PARALLEL_FOR)
+    // LOVE: lets the caller decode blocks on its own thread pool, via
+    // TINYEXR_PARALLEL_FOR(count, bytes_per_item, func).
+    TINYEXR_PARALLEL_FOR(
+        static_cast<int>(num_blocks),
+        size_t(data_width) * size_t(num_scanline_blocks) *
+            static_cast<size_t>(pixel_data_size),
+        [&](int y) {
+#else
 #ifdef _OPENMP
 #pragma omp parallel for
 #endif
     for (int y = 0; y < static_cast<int>(num_blocks); y++) {
+#endif
       size_t y_idx = static_cast<size_t>(y);
 
       if (offsets[y_idx] + sizeof(int) * 2 > size) {
@@ -10996,7 +11006,11 @@ static int DecodeChunk(EXRImage *exr_image, const EXRHeader *exr_header,
           }
         }
       }
+#if defined(TINYEXR_PARALLEL_FOR)
+    });
+#else
     }  // omp parallel
+#endif
   }
 
   if (invalid_data) {
@@ -21,6 +21,7 @@
 #include "common/version.h"
 #include "common/runtime.h"
 #include "common/Variant.h"
+#include "common/profiler.h"
 #include "modules/love/love.h"
 #include <SDL.h>
 
@@ -316,6 +317,8 @@ int main(int argc, char **argv)
 	DoneAction done = DONE_QUIT;
 	love::Variant restartvalue;
 
+	love::setProfilerThreadName("main");
+
 	do
 	{
 		done = runlove(argc, argv, retval, restartvalue);
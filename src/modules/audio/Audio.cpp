@@ -33,6 +33,8 @@ namespace audio
 {
 
 static bool requestRecPermission = false;
+static bool requestLowLatency = false;
+static int requestedPeriodSize = 0;
 
 void setRequestRecordingPermission(bool rec)
 {
@@ -44,6 +46,22 @@ bool getRequestRecordingPermission()
 	return requestRecPermission;
 }
 
+void setRequestLowLatency(bool lowLatency, int periodSize)
+{
+	requestLowLatency = lowLatency;
+	requestedPeriodSize = periodSize;
+}
+
+bool getRequestLowLatency()
+{
+	return requestLowLatency;
+}
+
+int getRequestedPeriodSize()
+{
+	return requestedPeriodSize;
+}
+
 bool hasRecordingPermission()
 {
 #if defined(LOVE_ANDROID)
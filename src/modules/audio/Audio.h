@@ -73,6 +73,24 @@ void requestRecordingPermission();
  */
 void showRecordingPermissionMissingDialog();
 
+/*
+ * Requests a low-latency output mode, which mixes in shorter periods and
+ * runs the audio thread at a higher priority. This must be set before the
+ * audio module is created.
+ * periodSize is the mixing period in sample frames, or 0 for the default.
+ */
+void setRequestLowLatency(bool lowLatency, int periodSize);
+
+/*
+ * Gets whetever low-latency output will be requested.
+ */
+bool getRequestLowLatency();
+
+/*
+ * Gets the requested mixing period in sample frames, or 0 for the default.
+ */
+int getRequestedPeriodSize();
+
 /**
  * The Audio module is responsible for playing back raw sound samples.
  **/
@@ -95,6 +113,46 @@ public:
 		DISTANCE_MAX_ENUM
 	};
 
+	/**
+	 * Usage of the objects behind effects and filters.
+	 **/
+	struct EffectStats
+	{
+		// Scene effects currently set, which each use an effect slot.
+		int sceneEffects = 0;
+		// Distinct filter configurations in use, and how many Source filters
+		// and effect sends share them.
+		int filters = 0;
+		int filterUsers = 0;
+		// Backend filter and effect objects, including unused ones which are
+		// kept for reuse.
+		int filterObjects = 0;
+		int effectObjects = 0;
+	};
+
+	/**
+	 * Health of the audio update thread. Times are in seconds, and averages
+	 * and maximums cover the updates since the previous getStats call.
+	 **/
+	struct Stats
+	{
+		// Sources playing with a backend voice, and without one.
+		int activeSources = 0;
+		int virtualSources = 0;
+		int maxSources = 0;
+		// Streaming Sources whose data is decoded ahead by worker threads, and
+		// how many decoded chunks are waiting to be queued.
+		int decodingSources = 0;
+		int decodedChunks = 0;
+		// Total number of times a stream ran out of data while playing.
+		int64 underruns = 0;
+		double updateTime = 0.0;
+		double maxUpdateTime = 0.0;
+		// How much later than requested the update thread woke up.
+		double wakeupJitter = 0.0;
+		double maxWakeupJitter = 0.0;
+	};
+
 	static bool getConstant(const char *in, DistanceModel &out);
 	static bool getConstant(DistanceModel in, const char  *&out);
 	static std::vector<std::string> getConstants(DistanceModel);
@@ -105,6 +163,36 @@ public:
 	virtual Source *newSource(love::sound::SoundData *soundData) = 0;
 	virtual Source *newSource(int sampleRate, int bitDepth, int channels, int buffers) = 0;
 
+	/**
+	 * Creates a static Source which shares its sample data with other static
+	 * Sources created with the same cache key.
+	 * @param soundData The decoded sample data, used if nothing is cached yet.
+	 * @param cacheKey Identifies the sample data, e.g. a file path and its
+	 * modification time.
+	 **/
+	virtual Source *newSource(love::sound::SoundData *soundData, const std::string &cacheKey) = 0;
+
+	/**
+	 * Creates a static Source from sample data cached by an earlier newSource
+	 * call with the same cache key.
+	 * @return The new Source, or null if nothing is cached for the key.
+	 **/
+	virtual Source *newCachedSource(const std::string &cacheKey) = 0;
+
+	/**
+	 * Creates a Source which keeps its encoded data in memory and decodes it
+	 * in small blocks while playing, like a stream Source without file I/O.
+	 * @param decoder A Decoder which reads from memory.
+	 **/
+	virtual Source *newCompressedSource(love::sound::Decoder *decoder) = 0;
+
+	/**
+	 * Sets the maximum size in bytes of cached sample data which isn't used by
+	 * any Source. The least recently used data is freed first.
+	 **/
+	virtual void setSourceCacheLimit(int64 bytes) = 0;
+	virtual int64 getSourceCacheLimit() const = 0;
+
 	/**
 	 * Gets the current number of simultaneous playing sources.
 	 * @return The current number of simultaneous playing sources.
@@ -213,6 +301,17 @@ public:
 	 **/
 	virtual void setVelocity(float *v) = 0;
 
+	/**
+	 * Sets the positions and optionally the velocities of many Sources at
+	 * once. All updates are applied together, so none of the Sources is heard
+	 * at its new position before the others.
+	 * @param sources The Sources to update. They must all be mono.
+	 * @param positions [x,y,z] for each Source, in the same order.
+	 * @param velocities [x,y,z] for each Source, or null to keep the current
+	 * velocities.
+	 **/
+	virtual void setPositions(const std::vector<Source*> &sources, const float *positions, const float *velocities) = 0;
+
 	virtual void setDopplerScale(float scale) = 0;
 	virtual float getDopplerScale() const = 0;
 	//virtual void setMeter(float scale) = 0;
@@ -282,6 +381,36 @@ public:
 	 */
 	virtual bool isEFXsupported() const = 0;
 
+	/**
+	 * Gets how many effect slots, filters and effect objects are in use.
+	 */
+	virtual EffectStats getEffectStats() const = 0;
+
+	/**
+	 * Gets counters for the audio update thread, and resets the averages and
+	 * maximums.
+	 */
+	virtual Stats getStats() = 0;
+
+	/**
+	 * Gets the time between audio being mixed and it being heard.
+	 * @return The latency in seconds, or -1 if it can't be determined.
+	 */
+	virtual double getOutputLatency() const = 0;
+
+	/**
+	 * Gets the mixing period of the playback device.
+	 * @return The period in sample frames, or 0 if it can't be determined.
+	 */
+	virtual int getOutputPeriodSize() const = 0;
+
+	/**
+	 * Gets the time of the playback device's clock, which Source::playAt and
+	 * Source::stopAt are scheduled against.
+	 * @return The time in seconds, from an arbitrary starting point.
+	 */
+	virtual double getDeviceTime() const = 0;
+
 	/**
 	 * Sets whether audio from other apps mixes with love.audio or is muted,
 	 * on supported platforms.
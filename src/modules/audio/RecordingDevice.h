@@ -66,6 +66,15 @@ public:
 	 **/
 	virtual love::sound::SoundData *getData() = 0;
 
+	/**
+	 * Retreives recorded data into an existing SoundData, without allocating.
+	 * The SoundData must have the same format as the recording.
+	 * @param dst The SoundData to write to.
+	 * @param dstStart The sample frame in dst to start writing at.
+	 * @return The number of sample frames written, limited by the space in dst.
+	 **/
+	virtual int getData(love::sound::SoundData *dst, int dstStart) = 0;
+
 	/**
 	 * @return C string device name.
 	 **/ 
@@ -29,6 +29,7 @@ love::Type Source::type("Source", &Object::type);
 
 Source::Source(Type sourceType)
 	: sourceType(sourceType)
+	, priority(0)
 {
 }
 
@@ -41,6 +42,26 @@ Source::Type Source::getType() const
 	return sourceType;
 }
 
+void Source::setPriority(int priority)
+{
+	this->priority = priority;
+}
+
+int Source::getPriority() const
+{
+	return priority;
+}
+
+bool Source::isVirtual() const
+{
+	return false;
+}
+
+int Source::getUnderrunCount() const
+{
+	return 0;
+}
+
 bool Source::getConstant(const char *in, Type &out)
 {
 	return types.find(in, out);
@@ -76,6 +97,7 @@ StringMap<Source::Type, Source::TYPE_MAX_ENUM>::Entry Source::typeEntries[] =
 	{"static", Source::TYPE_STATIC},
 	{"stream", Source::TYPE_STREAM},
 	{"queue",  Source::TYPE_QUEUE},
+	{"compressed", Source::TYPE_COMPRESSED},
 };
 
 StringMap<Source::Type, Source::TYPE_MAX_ENUM> Source::types(Source::typeEntries, sizeof(Source::typeEntries));
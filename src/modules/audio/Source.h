@@ -44,6 +44,7 @@ public:
 		TYPE_STATIC,
 		TYPE_STREAM,
 		TYPE_QUEUE,
+		TYPE_COMPRESSED,
 		TYPE_MAX_ENUM
 	};
 
@@ -66,6 +67,14 @@ public:
 	virtual bool isFinished() const = 0;
 	virtual bool update() = 0;
 
+	/**
+	 * Starts or stops the Source when the device clock reaches the given
+	 * time, as returned by Audio::getDeviceTime. Times in the past take effect
+	 * at once. stop() cancels anything scheduled.
+	 **/
+	virtual bool playAt(double time) = 0;
+	virtual void stopAt(double time) = 0;
+
 	virtual void setPitch(float pitch) = 0;
 	virtual float getPitch() const = 0;
 
@@ -124,6 +133,24 @@ public:
 
 	virtual Type getType() const;
 
+	/**
+	 * Sources with a higher priority are given a voice first when more Sources
+	 * are playing than the backend can mix at once.
+	 **/
+	virtual void setPriority(int priority);
+	virtual int getPriority() const;
+
+	/**
+	 * Whether the Source is playing without a backend voice; its play position
+	 * keeps advancing until a voice is available.
+	 **/
+	virtual bool isVirtual() const;
+
+	/**
+	 * Gets how many times a streaming Source ran out of data while playing.
+	 **/
+	virtual int getUnderrunCount() const;
+
 	static bool getConstant(const char *in, Type &out);
 	static bool getConstant(Type in, const char  *&out);
 	static std::vector<std::string> getConstants(Type);
@@ -134,6 +161,7 @@ public:
 protected:
 
 	Type sourceType;
+	int priority;
 
 private:
 
@@ -52,6 +52,30 @@ love::audio::Source *Audio::newSource(int, int, int, int)
 	return new Source();
 }
 
+love::audio::Source *Audio::newSource(love::sound::SoundData *, const std::string &)
+{
+	return new Source();
+}
+
+love::audio::Source *Audio::newCachedSource(const std::string &)
+{
+	return nullptr;
+}
+
+love::audio::Source *Audio::newCompressedSource(love::sound::Decoder *)
+{
+	return new Source();
+}
+
+void Audio::setSourceCacheLimit(int64)
+{
+}
+
+int64 Audio::getSourceCacheLimit() const
+{
+	return 0;
+}
+
 int Audio::getActiveSourceCount() const
 {
 	return 0;
@@ -115,6 +139,10 @@ void Audio::setPosition(float *)
 {
 }
 
+void Audio::setPositions(const std::vector<love::audio::Source*>&, const float *, const float *)
+{
+}
+
 void Audio::getOrientation(float *) const
 {
 }
@@ -199,6 +227,31 @@ bool Audio::isEFXsupported() const
 	return false;
 }
 
+love::audio::Audio::EffectStats Audio::getEffectStats() const
+{
+	return EffectStats();
+}
+
+love::audio::Audio::Stats Audio::getStats()
+{
+	return Stats();
+}
+
+double Audio::getOutputLatency() const
+{
+	return -1.0;
+}
+
+int Audio::getOutputPeriodSize() const
+{
+	return 0;
+}
+
+double Audio::getDeviceTime() const
+{
+	return 0.0;
+}
+
 void Audio::pauseContext()
 {
 }
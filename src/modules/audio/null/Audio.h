@@ -45,6 +45,11 @@ public:
 	love::audio::Source *newSource(love::sound::Decoder *decoder);
 	love::audio::Source *newSource(love::sound::SoundData *soundData);
 	love::audio::Source *newSource(int sampleRate, int bitDepth, int channels, int buffers);
+	love::audio::Source *newSource(love::sound::SoundData *soundData, const std::string &cacheKey);
+	love::audio::Source *newCachedSource(const std::string &cacheKey);
+	love::audio::Source *newCompressedSource(love::sound::Decoder *decoder);
+	void setSourceCacheLimit(int64 bytes);
+	int64 getSourceCacheLimit() const;
 	int getActiveSourceCount() const;
 	int getMaxSources() const;
 	bool play(love::audio::Source *source);
@@ -64,6 +69,7 @@ public:
 	void setOrientation(float *v);
 	void getVelocity(float *v) const;
 	void setVelocity(float *v);
+	void setPositions(const std::vector<love::audio::Source*> &sources, const float *positions, const float *velocities);
 
 	void setDopplerScale(float scale);
 	float getDopplerScale() const;
@@ -82,6 +88,11 @@ public:
 	int getMaxSceneEffects() const;
 	int getMaxSourceEffects() const;
 	bool isEFXsupported() const;
+	EffectStats getEffectStats() const;
+	Stats getStats();
+	double getOutputLatency() const;
+	int getOutputPeriodSize() const;
+	double getDeviceTime() const;
 
 	void pauseContext();
 	void resumeContext();
@@ -52,6 +52,11 @@ love::sound::SoundData *RecordingDevice::getData()
 	return nullptr;
 }
 
+int RecordingDevice::getData(love::sound::SoundData *, int)
+{
+	return 0;
+}
+
 int RecordingDevice::getSampleCount() const
 {
 	return 0;
@@ -60,6 +60,15 @@ bool Source::isPlaying() const
 	return false;
 }
 
+bool Source::playAt(double)
+{
+	return false;
+}
+
+void Source::stopAt(double)
+{
+}
+
 bool Source::isFinished() const
 {
 	return true;
@@ -44,6 +44,8 @@ public:
 	virtual void stop();
 	virtual void pause();
 	virtual bool isPlaying() const;
+	virtual bool playAt(double time);
+	virtual void stopAt(double time);
 	virtual bool isFinished() const;
 	virtual bool update();
 	virtual void setPitch(float pitch);
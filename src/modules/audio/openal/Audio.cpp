@@ -20,11 +20,14 @@
 
 #include "Audio.h"
 #include "common/delay.h"
+#include "common/profiler.h"
 #include "RecordingDevice.h"
 #include "sound/Decoder.h"
+#include "timer/Timer.h"
 
 #include <cstdlib>
 #include <iostream>
+#include <algorithm>
 
 #ifdef LOVE_IOS
 #include "common/ios.h"
@@ -37,11 +40,17 @@ namespace audio
 namespace openal
 {
 
-Audio::PoolThread::PoolThread(Pool *pool)
+Audio::PoolThread::PoolThread(Pool *pool, bool lowLatency)
 	: pool(pool)
 	, finish(false)
+	, lowLatency(lowLatency)
 {
 	threadName = "AudioPool";
+
+	// Missing an update means streams and queues can run dry, which is
+	// audible as soon as the output buffers are short.
+	if (lowLatency)
+		setPriority(thread::THREAD_PRIORITY_HIGH);
 }
 
 Audio::PoolThread::~PoolThread()
@@ -51,6 +60,8 @@ Audio::PoolThread::~PoolThread()
 
 void Audio::PoolThread::threadFunction()
 {
+	setProfilerThreadName("audio");
+
 	while (true)
 	{
 		{
@@ -62,7 +73,11 @@ void Audio::PoolThread::threadFunction()
 		}
 
 		pool->update();
-		sleep(5);
+
+		int interval = lowLatency ? 1 : 5;
+		double before = love::timer::Timer::getTime();
+		sleep(interval);
+		pool->recordWakeup(love::timer::Timer::getTime() - before - interval / 1000.0);
 	}
 }
 
@@ -110,6 +125,8 @@ Audio::Audio()
 	, device(nullptr)
 	, context(nullptr)
 	, pool(nullptr)
+	, sourceCacheLimit(DEFAULT_SOURCE_CACHE_LIMIT)
+	, sourceCacheUseCounter(0)
 	, poolThread(nullptr)
 	, distanceModel(DISTANCE_INVERSE_CLAMPED)
 {
@@ -142,6 +159,18 @@ Audio::Audio()
 		attribs.insert(attribs.begin() + 1, MAX_SOURCE_EFFECTS);
 #endif
 
+		if (getRequestLowLatency())
+		{
+			// OpenAL has no period size attribute, but the refresh rate sets
+			// how many periods are mixed per second.
+			int period = getRequestedPeriodSize();
+			if (period <= 0)
+				period = DEFAULT_LOW_LATENCY_PERIOD;
+
+			attribs.insert(attribs.begin(), ALC_REFRESH);
+			attribs.insert(attribs.begin() + 1, std::max(LOW_LATENCY_FREQUENCY / period, 1));
+		}
+
 		context = alcCreateContext(device, attribs.data());
 
 		if (context == nullptr)
@@ -204,7 +233,7 @@ Audio::Audio()
 		throw;
 	}
 
-	poolThread = new PoolThread(pool);
+	poolThread = new PoolThread(pool, getRequestLowLatency());
 	poolThread->start();
 	
 #ifdef LOVE_IOS
@@ -233,6 +262,9 @@ Audio::~Audio()
 	delete poolThread;
 	delete pool;
 
+	// Cached buffers need the context to still exist.
+	sourceCache.clear();
+
 	for (auto c : capture)
 		delete c;
 
@@ -243,6 +275,9 @@ Audio::~Audio()
 		slotlist.push(e.second.slot);
 	}
 
+	Effect::deleteUnusedEffects();
+	Filter::deleteUnusedFilters();
+
 	if (alDeleteAuxiliaryEffectSlots)
 	{
 		while (!slotlist.empty())
@@ -259,7 +294,7 @@ Audio::~Audio()
 
 love::audio::Source *Audio::newSource(love::sound::Decoder *decoder)
 {
-	return new Source(pool, decoder);
+	return new Source(pool, decoder, Source::TYPE_STREAM);
 }
 
 love::audio::Source *Audio::newSource(love::sound::SoundData *soundData)
@@ -272,6 +307,104 @@ love::audio::Source *Audio::newSource(int sampleRate, int bitDepth, int channels
 	return new Source(pool, sampleRate, bitDepth, channels, buffers);
 }
 
+love::audio::Source *Audio::newSource(love::sound::SoundData *soundData, const std::string &cacheKey)
+{
+	love::audio::Source *source = newCachedSource(cacheKey);
+	if (source != nullptr)
+		return source;
+
+	ALenum fmt = getFormat(soundData->getBitDepth(), soundData->getChannelCount());
+	if (fmt == AL_NONE)
+		return newSource(soundData); // Throws the usual format error.
+
+	StrongRef<StaticDataBuffer> buffer(new StaticDataBuffer(fmt, soundData->getReadOnlyData(), (ALsizei) soundData->getSize(), soundData->getSampleRate()), Acquire::NORETAIN);
+
+	{
+		thread::Lock lock(sourceCacheMutex);
+
+		CachedSourceData data;
+		data.buffer = buffer;
+		data.sampleRate = soundData->getSampleRate();
+		data.bitDepth = soundData->getBitDepth();
+		data.channels = soundData->getChannelCount();
+		data.lastUsed = ++sourceCacheUseCounter;
+
+		sourceCache[cacheKey] = data;
+	}
+
+	source = new Source(pool, buffer.get(), soundData->getSampleRate(), soundData->getBitDepth(), soundData->getChannelCount());
+	trimSourceCache();
+	return source;
+}
+
+love::audio::Source *Audio::newCachedSource(const std::string &cacheKey)
+{
+	thread::Lock lock(sourceCacheMutex);
+
+	auto it = sourceCache.find(cacheKey);
+	if (it == sourceCache.end())
+		return nullptr;
+
+	CachedSourceData &data = it->second;
+	data.lastUsed = ++sourceCacheUseCounter;
+
+	return new Source(pool, data.buffer.get(), data.sampleRate, data.bitDepth, data.channels);
+}
+
+love::audio::Source *Audio::newCompressedSource(love::sound::Decoder *decoder)
+{
+	return new Source(pool, decoder, Source::TYPE_COMPRESSED);
+}
+
+void Audio::setSourceCacheLimit(int64 bytes)
+{
+	{
+		thread::Lock lock(sourceCacheMutex);
+		sourceCacheLimit = std::max(bytes, (int64) 0);
+	}
+
+	trimSourceCache();
+}
+
+int64 Audio::getSourceCacheLimit() const
+{
+	thread::Lock lock(sourceCacheMutex);
+	return sourceCacheLimit;
+}
+
+void Audio::trimSourceCache()
+{
+	thread::Lock lock(sourceCacheMutex);
+
+	// Only data which no Source uses anymore counts against the limit, since
+	// freeing it from the cache wouldn't free any memory otherwise.
+	int64 unusedsize = 0;
+	for (const auto &entry : sourceCache)
+	{
+		if (entry.second.buffer->getReferenceCount() == 1)
+			unusedsize += entry.second.buffer->getSize();
+	}
+
+	while (unusedsize > sourceCacheLimit)
+	{
+		auto oldest = sourceCache.end();
+		for (auto it = sourceCache.begin(); it != sourceCache.end(); ++it)
+		{
+			if (it->second.buffer->getReferenceCount() != 1)
+				continue;
+
+			if (oldest == sourceCache.end() || it->second.lastUsed < oldest->second.lastUsed)
+				oldest = it;
+		}
+
+		if (oldest == sourceCache.end())
+			break;
+
+		unusedsize -= oldest->second.buffer->getSize();
+		sourceCache.erase(oldest);
+	}
+}
+
 int Audio::getActiveSourceCount() const
 {
 	return pool->getActiveSourceCount();
@@ -430,6 +563,11 @@ void Audio::setPosition(float *v)
 	alListenerfv(AL_POSITION, v);
 }
 
+void Audio::setPositions(const std::vector<love::audio::Source*> &sources, const float *positions, const float *velocities)
+{
+	Source::setPositions(sources, positions, velocities);
+}
+
 void Audio::getOrientation(float *v) const
 {
 	alGetListenerfv(AL_ORIENTATION, v);
@@ -707,6 +845,63 @@ bool Audio::isEFXsupported() const
 #endif
 }
 
+love::audio::Audio::EffectStats Audio::getEffectStats() const
+{
+	EffectStats stats;
+	stats.sceneEffects = (int) effectmap.size();
+	Filter::getStats(stats.filters, stats.filterUsers, stats.filterObjects);
+	stats.effectObjects = Effect::getObjectCount();
+	return stats;
+}
+
+love::audio::Audio::Stats Audio::getStats()
+{
+	return pool->getStats();
+}
+
+double Audio::getOutputLatency() const
+{
+#ifndef ALC_SOFT_device_clock
+	typedef int64_t ALCint64SOFT;
+	typedef void (ALC_APIENTRY*LPALCGETINTEGER64VSOFT)(ALCdevice *device,
+		ALCenum pname, ALsizei size, ALCint64SOFT *values);
+	constexpr ALCenum ALC_DEVICE_LATENCY_SOFT = 0x1601;
+#endif
+	static LPALCGETINTEGER64VSOFT alcGetInteger64vSOFT = alcIsExtensionPresent(device, "ALC_SOFT_device_clock") == ALC_TRUE
+		? (LPALCGETINTEGER64VSOFT) alcGetProcAddress(device, "alcGetInteger64vSOFT")
+		: nullptr;
+
+	if (alcGetInteger64vSOFT == nullptr)
+		return -1.0;
+
+	ALCint64SOFT latency = 0;
+	alcGetInteger64vSOFT(device, ALC_DEVICE_LATENCY_SOFT, 1, &latency);
+
+	if (alcGetError(device) != ALC_NO_ERROR)
+		return -1.0;
+
+	// Nanoseconds.
+	return (double) latency / 1000000000.0;
+}
+
+int Audio::getOutputPeriodSize() const
+{
+	ALCint frequency = 0;
+	ALCint refresh = 0;
+	alcGetIntegerv(device, ALC_FREQUENCY, 1, &frequency);
+	alcGetIntegerv(device, ALC_REFRESH, 1, &refresh);
+
+	if (alcGetError(device) != ALC_NO_ERROR || frequency <= 0 || refresh <= 0)
+		return 0;
+
+	return frequency / refresh;
+}
+
+double Audio::getDeviceTime() const
+{
+	return pool->getDeviceTime();
+}
+
 bool Audio::getEffectID(const char *name, ALuint &id)
 {
 	auto iter = effectmap.find(name);
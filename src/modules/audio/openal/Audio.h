@@ -62,6 +62,8 @@ namespace audio
 namespace openal
 {
 
+class StaticDataBuffer;
+
 class Audio : public love::audio::Audio
 {
 public:
@@ -82,6 +84,11 @@ public:
 	love::audio::Source *newSource(love::sound::Decoder *decoder);
 	love::audio::Source *newSource(love::sound::SoundData *soundData);
 	love::audio::Source *newSource(int sampleRate, int bitDepth, int channels, int buffers);
+	love::audio::Source *newSource(love::sound::SoundData *soundData, const std::string &cacheKey);
+	love::audio::Source *newCachedSource(const std::string &cacheKey);
+	love::audio::Source *newCompressedSource(love::sound::Decoder *decoder);
+	void setSourceCacheLimit(int64 bytes);
+	int64 getSourceCacheLimit() const;
 	int getActiveSourceCount() const;
 	int getMaxSources() const;
 	bool play(love::audio::Source *source);
@@ -103,6 +110,7 @@ public:
 	void setOrientation(float *v);
 	void getVelocity(float *v) const;
 	void setVelocity(float *v);
+	void setPositions(const std::vector<love::audio::Source*> &sources, const float *positions, const float *velocities);
 
 	void setDopplerScale(float scale);
 	float getDopplerScale() const;
@@ -121,6 +129,11 @@ public:
 	int getMaxSceneEffects() const;
 	int getMaxSourceEffects() const;
 	bool isEFXsupported() const;
+	EffectStats getEffectStats() const;
+	Stats getStats();
+	double getOutputLatency() const;
+	int getOutputPeriodSize() const;
+	double getDeviceTime() const;
 
 	bool getEffectID(const char *name, ALuint &id);
 
@@ -154,6 +167,30 @@ private:
 	// The Pool.
 	Pool *pool;
 
+	// Sample data shared by static Sources, keyed by cache key.
+	struct CachedSourceData
+	{
+		StrongRef<StaticDataBuffer> buffer;
+		int sampleRate;
+		int bitDepth;
+		int channels;
+		uint64 lastUsed;
+	};
+
+	void trimSourceCache();
+
+	static const int64 DEFAULT_SOURCE_CACHE_LIMIT = 32 * 1024 * 1024;
+
+	// Mixing period used in low-latency mode when none is requested, in
+	// sample frames at LOW_LATENCY_FREQUENCY.
+	static const int DEFAULT_LOW_LATENCY_PERIOD = 256;
+	static const int LOW_LATENCY_FREQUENCY = 48000;
+
+	std::map<std::string, CachedSourceData> sourceCache;
+	int64 sourceCacheLimit;
+	uint64 sourceCacheUseCounter;
+	love::thread::MutexRef sourceCacheMutex;
+
 	class PoolThread: public thread::Threadable
 	{
 	protected:
@@ -167,8 +204,11 @@ private:
 		// finish lock
 		love::thread::MutexRef mutex;
 
+		// Raises the thread priority and updates more often.
+		bool lowLatency;
+
 	public:
-		PoolThread(Pool *pool);
+		PoolThread(Pool *pool, bool lowLatency);
 		virtual ~PoolThread();
 		void setFinish();
 		void threadFunction();
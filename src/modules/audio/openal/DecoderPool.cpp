@@ -0,0 +1,172 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "DecoderPool.h"
+#include "Source.h"
+
+// STD
+#include <algorithm>
+#include <thread>
+
+namespace love
+{
+namespace audio
+{
+namespace openal
+{
+
+DecoderPool::Worker::Worker(DecoderPool *pool)
+	: pool(pool)
+{
+	threadName = "AudioDecoder";
+}
+
+void DecoderPool::Worker::threadFunction()
+{
+	while (true)
+	{
+		Source *source = pool->acquireSource();
+		if (source == nullptr)
+			return;
+
+		source->decodeAheadAtomic();
+		pool->releaseSource(source);
+	}
+}
+
+DecoderPool::DecoderPool()
+	: nextSourceIndex(0)
+	, stopping(false)
+{
+	// Leave a core for the main thread and one for the pool thread.
+	int cores = (int) std::thread::hardware_concurrency();
+	int count = std::max(std::min(cores - 2, MAX_WORKER_THREADS), 1);
+
+	for (int i = 0; i < count; i++)
+	{
+		Worker *worker = new Worker(this);
+		worker->start();
+		workers.push_back(worker);
+	}
+}
+
+DecoderPool::~DecoderPool()
+{
+	{
+		thread::Lock lock(mutex);
+		stopping = true;
+		cond->broadcast();
+	}
+
+	for (Worker *worker : workers)
+	{
+		worker->wait();
+		delete worker;
+	}
+
+	for (Source *source : sources)
+		source->release();
+}
+
+void DecoderPool::addSource(Source *source)
+{
+	thread::Lock lock(mutex);
+
+	if (std::find(sources.begin(), sources.end(), source) != sources.end())
+		return;
+
+	source->retain();
+	sources.push_back(source);
+	cond->broadcast();
+}
+
+void DecoderPool::removeSource(Source *source)
+{
+	thread::Lock lock(mutex);
+
+	auto it = std::find(sources.begin(), sources.end(), source);
+	if (it == sources.end())
+		return;
+
+	sources.erase(it);
+	source->release();
+}
+
+void DecoderPool::wake()
+{
+	thread::Lock lock(mutex);
+	cond->signal();
+}
+
+int DecoderPool::getSourceCount()
+{
+	thread::Lock lock(mutex);
+	return (int) sources.size();
+}
+
+Source *DecoderPool::acquireSource()
+{
+	thread::Lock lock(mutex);
+
+	while (!stopping)
+	{
+		// Round-robin, so one slow decoder doesn't starve the others.
+		for (size_t i = 0; i < sources.size(); i++)
+		{
+			size_t index = (nextSourceIndex + i) % sources.size();
+			Source *source = sources[index];
+
+			if (std::find(busySources.begin(), busySources.end(), source) != busySources.end())
+				continue;
+
+			if (!source->needsDecodeAhead())
+				continue;
+
+			nextSourceIndex = index + 1;
+			busySources.push_back(source);
+			source->retain();
+			return source;
+		}
+
+		// With no streaming Sources there's nothing to poll for, so sleep
+		// until addSource or stopping signals. Otherwise wake up periodically
+		// in case a Source needs more data but nobody signaled.
+		if (sources.empty())
+			cond->wait(mutex);
+		else
+			cond->wait(mutex, 5);
+	}
+
+	return nullptr;
+}
+
+void DecoderPool::releaseSource(Source *source)
+{
+	{
+		thread::Lock lock(mutex);
+		busySources.erase(std::find(busySources.begin(), busySources.end(), source));
+	}
+
+	source->release();
+}
+
+} // openal
+} // audio
+} // love
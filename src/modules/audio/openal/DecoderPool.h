@@ -0,0 +1,100 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_AUDIO_OPENAL_DECODER_POOL_H
+#define LOVE_AUDIO_OPENAL_DECODER_POOL_H
+
+// STD
+#include <vector>
+
+// LOVE
+#include "common/config.h"
+#include "thread/threads.h"
+
+namespace love
+{
+namespace audio
+{
+namespace openal
+{
+
+class Source;
+
+/**
+ * A small set of worker threads which decode streaming Sources ahead of
+ * playback, so the pool thread only has to queue ready PCM data into OpenAL.
+ **/
+class DecoderPool
+{
+public:
+
+	DecoderPool();
+	~DecoderPool();
+
+	void addSource(Source *source);
+	void removeSource(Source *source);
+
+	/**
+	 * Wakes a worker thread after a Source has used some of its decoded data.
+	 **/
+	void wake();
+
+	int getSourceCount();
+
+private:
+
+	class Worker : public love::thread::Threadable
+	{
+	public:
+
+		Worker(DecoderPool *pool);
+		virtual ~Worker() {}
+
+		void threadFunction() override;
+
+	private:
+
+		DecoderPool *pool;
+
+	}; // Worker
+
+	Source *acquireSource();
+	void releaseSource(Source *source);
+
+	static const int MAX_WORKER_THREADS = 2;
+
+	std::vector<Worker *> workers;
+
+	std::vector<Source *> sources;
+	std::vector<Source *> busySources;
+	size_t nextSourceIndex;
+
+	love::thread::MutexRef mutex;
+	love::thread::ConditionalRef cond;
+
+	bool stopping;
+
+}; // DecoderPool
+
+} // openal
+} // audio
+} // love
+
+#endif // LOVE_AUDIO_OPENAL_DECODER_POOL_H
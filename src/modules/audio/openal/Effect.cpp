@@ -20,6 +20,7 @@
 
 #include "Effect.h"
 #include "common/Exception.h"
+#include "thread/threads.h"
 
 #include <cmath>
 #include <iostream>
@@ -31,6 +32,15 @@ namespace audio
 namespace openal
 {
 
+std::vector<ALuint> Effect::unusedEffects;
+int Effect::effectObjectCount = 0;
+
+static love::thread::Mutex *getEffectMutex()
+{
+	static love::thread::MutexRef mutex;
+	return mutex;
+}
+
 //base class
 Effect::Effect()
 {
@@ -62,10 +72,20 @@ bool Effect::generateEffect()
 	if (effect != AL_EFFECT_NULL)
 		return true;
 
+	love::thread::Lock lock(getEffectMutex());
+
+	if (!unusedEffects.empty())
+	{
+		effect = unusedEffects.back();
+		unusedEffects.pop_back();
+		return true;
+	}
+
 	alGenEffects(1, &effect);
 	if (alGetError() != AL_NO_ERROR)
 		throw love::Exception("Failed to create sound Effect.");
 
+	effectObjectCount++;
 	return true;
 #else
 	return false;
@@ -76,11 +96,41 @@ void Effect::deleteEffect()
 {
 #ifdef ALC_EXT_EFX
 	if (effect != AL_EFFECT_NULL)
-		alDeleteEffects(1, &effect);
+	{
+		// Keep the object for reuse, generating and deleting them while audio
+		// is playing can stall the mixer.
+		alEffecti(effect, AL_EFFECT_TYPE, AL_EFFECT_NULL);
+		alGetError();
+
+		love::thread::Lock lock(getEffectMutex());
+		unusedEffects.push_back(effect);
+	}
 #endif
 	effect = AL_EFFECT_NULL;
 }
 
+int Effect::getObjectCount()
+{
+	love::thread::Lock lock(getEffectMutex());
+	return effectObjectCount;
+}
+
+void Effect::deleteUnusedEffects()
+{
+	love::thread::Lock lock(getEffectMutex());
+
+#ifdef ALC_EXT_EFX
+	if (alDeleteEffects)
+	{
+		for (ALuint unused : unusedEffects)
+			alDeleteEffects(1, &unused);
+	}
+#endif
+
+	effectObjectCount -= (int) unusedEffects.size();
+	unusedEffects.clear();
+}
+
 ALuint Effect::getEffect() const
 {
 	return effect;
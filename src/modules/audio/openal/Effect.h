@@ -71,6 +71,12 @@ public:
 	virtual bool setParams(const std::map<Parameter, float> &params);
 	virtual const std::map<Parameter, float> &getParams() const;
 
+	// Number of OpenAL effect objects, including unused ones kept for reuse.
+	static int getObjectCount();
+
+	// Must be called while the OpenAL context is still current.
+	static void deleteUnusedEffects();
+
 private:
 	bool generateEffect();
 	void deleteEffect();
@@ -80,6 +86,9 @@ private:
 	ALuint effect = AL_EFFECT_NULL;
 	std::map<Parameter, float> params;
 	//static std::map<Phoneme, ALint> phonemeMap;
+
+	static std::vector<ALuint> unusedEffects;
+	static int effectObjectCount;
 };
 
 } //openal
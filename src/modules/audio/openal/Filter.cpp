@@ -20,6 +20,7 @@
 
 #include "Filter.h"
 #include "common/Exception.h"
+#include "thread/threads.h"
 
 #include <cmath>
 
@@ -30,10 +31,19 @@ namespace audio
 namespace openal
 {
 
+std::map<std::map<Filter::Parameter, float>, Filter::SharedFilter> Filter::sharedFilters;
+std::vector<ALuint> Filter::unusedFilters;
+int Filter::filterObjectCount = 0;
+
+static love::thread::Mutex *getFilterMutex()
+{
+	static love::thread::MutexRef mutex;
+	return mutex;
+}
+
 //base class
 Filter::Filter()
 {
-	generateFilter();
 }
 
 Filter::Filter(const Filter &s)
@@ -44,7 +54,7 @@ Filter::Filter(const Filter &s)
 
 Filter::~Filter()
 {
-	deleteFilter();
+	releaseFilter();
 }
 
 Filter *Filter::clone()
@@ -52,48 +62,76 @@ Filter *Filter::clone()
 	return new Filter(*this);
 }
 
-bool Filter::generateFilter()
+bool Filter::acquireFilter()
 {
 #ifdef ALC_EXT_EFX
 	if (!alGenFilters)
 		return false;
 
-	if (filter != AL_FILTER_NULL)
+	love::thread::Lock lock(getFilterMutex());
+
+	// Filter settings are copied when they're attached to a source, so every
+	// Filter with the same parameters can use the same OpenAL object.
+	auto it = sharedFilters.find(params);
+	if (it != sharedFilters.end())
+	{
+		it->second.users++;
+		filter = it->second.filter;
 		return true;
+	}
 
-	alGenFilters(1, &filter);
-	if (alGetError() != AL_NO_ERROR)
-		throw love::Exception("Failed to create sound Filter.");
+	ALuint newfilter = AL_FILTER_NULL;
+	if (!unusedFilters.empty())
+	{
+		newfilter = unusedFilters.back();
+		unusedFilters.pop_back();
+	}
+	else
+	{
+		alGenFilters(1, &newfilter);
+		if (alGetError() != AL_NO_ERROR)
+			throw love::Exception("Failed to create sound Filter.");
+		filterObjectCount++;
+	}
+
+	if (!configureFilter(newfilter))
+	{
+		unusedFilters.push_back(newfilter);
+		return false;
+	}
 
+	sharedFilters[params] = {newfilter, 1};
+	filter = newfilter;
 	return true;
 #else
 	return false;
 #endif
 }
 
-void Filter::deleteFilter()
+void Filter::releaseFilter()
 {
-#ifdef ALC_EXT_EFX
-	if (filter != AL_FILTER_NULL)
-		alDeleteFilters(1, &filter);
-#endif
-	filter = AL_FILTER_NULL;
-}
+	if (filter == AL_FILTER_NULL)
+		return;
 
-ALuint Filter::getFilter() const
-{
-	return filter;
-}
+	love::thread::Lock lock(getFilterMutex());
 
-bool Filter::setParams(const std::map<Parameter, float> &params)
-{
-	this->params = params;
-	type = (Type)(int) this->params[FILTER_TYPE];
+	auto it = sharedFilters.find(params);
+	if (it != sharedFilters.end() && --it->second.users == 0)
+	{
+		// Keep the object around, generating and deleting them while audio
+		// is playing can stall the mixer.
+		unusedFilters.push_back(it->second.filter);
+		sharedFilters.erase(it);
+	}
 
-	if (!generateFilter())
-		return false;
+	filter = AL_FILTER_NULL;
+}
 
+bool Filter::configureFilter(ALuint filter) const
+{
 #ifdef ALC_EXT_EFX
+	alGetError();
+
 	switch (type)
 	{
 	case TYPE_LOWPASS:
@@ -106,16 +144,16 @@ bool Filter::setParams(const std::map<Parameter, float> &params)
 		alFilteri(filter, AL_FILTER_TYPE, AL_FILTER_BANDPASS);
 		break;
 	case TYPE_BASIC:
+		// Reused objects may still have another type set.
+		alFilteri(filter, AL_FILTER_TYPE, AL_FILTER_NULL);
+		break;
 	case TYPE_MAX_ENUM:
 		break;
 	}
 
 	//failed to make filter specific type - not supported etc.
 	if (alGetError() != AL_NO_ERROR)
-	{
-		deleteFilter();
 		return false;
-	}
 
 #define clampf(v,l,h) fmax(fmin((v),(h)),(l))
 #define PARAMSTR(i,e,v) filter,AL_##e##_##v,clampf(getValue(i,AL_##e##_DEFAULT_##v),AL_##e##_MIN_##v,AL_##e##_MAX_##v)
@@ -148,6 +186,48 @@ bool Filter::setParams(const std::map<Parameter, float> &params)
 #endif
 }
 
+ALuint Filter::getFilter() const
+{
+	return filter;
+}
+
+bool Filter::setParams(const std::map<Parameter, float> &params)
+{
+	releaseFilter();
+
+	this->params = params;
+	type = (Type)(int) this->params[FILTER_TYPE];
+
+	return acquireFilter();
+}
+
+void Filter::getStats(int &filters, int &users, int &objects)
+{
+	love::thread::Lock lock(getFilterMutex());
+
+	filters = (int) sharedFilters.size();
+	users = 0;
+	for (const auto &shared : sharedFilters)
+		users += shared.second.users;
+	objects = filterObjectCount;
+}
+
+void Filter::deleteUnusedFilters()
+{
+	love::thread::Lock lock(getFilterMutex());
+
+#ifdef ALC_EXT_EFX
+	if (alDeleteFilters)
+	{
+		for (ALuint unused : unusedFilters)
+			alDeleteFilters(1, &unused);
+	}
+#endif
+
+	filterObjectCount -= (int) unusedFilters.size();
+	unusedFilters.clear();
+}
+
 const std::map<Filter::Parameter, float> &Filter::getParams() const
 {
 	return params;
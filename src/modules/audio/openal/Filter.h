@@ -40,6 +40,7 @@
 #endif
 
 #include <vector>
+#include <map>
 
 #include "audio/Filter.h"
 #include "Audio.h"
@@ -66,13 +67,35 @@ public:
 	virtual bool setParams(const std::map<Parameter, float> &params);
 	virtual const std::map<Parameter, float> &getParams() const;
 
+	/**
+	 * Gets the number of distinct filter configurations in use, how many
+	 * Filters use them, and how many OpenAL filter objects exist (including
+	 * unused ones kept for reuse).
+	 **/
+	static void getStats(int &filters, int &users, int &objects);
+
+	// Must be called while the OpenAL context is still current.
+	static void deleteUnusedFilters();
+
 private:
-	bool generateFilter();
-	void deleteFilter();
+	struct SharedFilter
+	{
+		ALuint filter;
+		int users;
+	};
+
+	bool acquireFilter();
+	void releaseFilter();
+	bool configureFilter(ALuint filter) const;
 	float getValue(Parameter in, float def) const;
 	int getValue(Parameter in, int def) const;
 	ALuint filter = AL_FILTER_NULL;
 	std::map<Parameter, float> params;
+
+	// Filters with identical parameters share one OpenAL object.
+	static std::map<std::map<Parameter, float>, SharedFilter> sharedFilters;
+	static std::vector<ALuint> unusedFilters;
+	static int filterObjectCount;
 };
 
 } //openal
@@ -21,7 +21,12 @@
 #include "Pool.h"
 
 #include "event/Event.h"
+#include "timer/Timer.h"
 #include "Source.h"
+#include "common/profiler.h"
+
+// STD
+#include <algorithm>
 
 namespace love
 {
@@ -45,6 +50,9 @@ Pool::Pool(ALCdevice *device)
 	, sources()
 	, disconnectNotified(false)
 	, totalSources(0)
+	, lastUpdateTime(love::timer::Timer::getTime())
+	, decoderPool(nullptr)
+	, underruns(0)
 {
 	// Clear errors.
 	alGetError();
@@ -82,12 +90,20 @@ Pool::Pool(ALCdevice *device)
 
 		available.push(sources[i]);
 	}
+
+	decoderPool = new DecoderPool();
 }
 
 Pool::~Pool()
 {
+	for (Source *s : scheduledSources)
+		s->release();
+	scheduledSources.clear();
+
 	Source::stop(this);
 
+	delete decoderPool;
+
 	// Free all sources.
 	alDeleteSources(totalSources, sources);
 }
@@ -118,13 +134,17 @@ void Pool::update()
 	constexpr ALCenum ALC_CONNECTED = 0x313;
 #endif
 
-	thread::Lock lock(mutex);
+	LOVE_PROFILE_ZONE("Pool::update");
+
+	double updateStart = love::timer::Timer::getTime();
 
 	static bool disconnectExtSupported = alcIsExtensionPresent(device, "ALC_EXT_Disconnect") == ALC_TRUE;
 
 	// Device disconnection event
 	if (disconnectExtSupported)
 	{
+		thread::Lock lock(mutex);
+
 		auto eventModule = Module::getInstance<event::Event>(Module::M_EVENT);
 		if (eventModule)
 		{
@@ -151,21 +171,52 @@ void Pool::update()
 		}
 	}
 
+	// Sources are updated without the pool lock, so decoding a stream doesn't
+	// block playing, stopping or seeking other Sources. Each Source guards
+	// its own state while it's updated.
+	std::vector<Source *> active;
+	{
+		thread::Lock lock(mutex);
+
+		active.reserve(playing.size());
+		for (const auto &i : playing)
+		{
+			i.first->retain();
+			active.push_back(i.first);
+		}
+	}
+
 	std::vector<Source *> torelease;
 
-	for (const auto &i : playing)
+	for (Source *s : active)
 	{
-		if (!i.first->update())
-			torelease.push_back(i.first);
+		if (!s->update())
+			torelease.push_back(s);
 	}
 
-	for (Source *s : torelease)
-		releaseSource(s);
+	{
+		thread::Lock lock(mutex);
+
+		// A Source might have been stopped or restarted since its update.
+		for (Source *s : torelease)
+		{
+			if (s->isFinished())
+				releaseSource(s);
+		}
+
+		updateScheduledSources();
+		updateVirtualSources();
+
+		updateTiming.add(love::timer::Timer::getTime() - updateStart);
+	}
+
+	for (Source *s : active)
+		s->release();
 }
 
 int Pool::getActiveSourceCount() const
 {
-	return (int) playing.size();
+	return (int) (playing.size() + virtualSources.size());
 }
 
 int Pool::getMaxSources() const
@@ -173,6 +224,47 @@ int Pool::getMaxSources() const
 	return totalSources;
 }
 
+love::audio::Audio::Stats Pool::getStats()
+{
+	thread::Lock lock(mutex);
+
+	love::audio::Audio::Stats stats;
+	stats.activeSources = (int) playing.size();
+	stats.virtualSources = (int) virtualSources.size();
+	stats.maxSources = totalSources;
+	stats.underruns = underruns;
+
+	if (decoderPool != nullptr)
+		stats.decodingSources = decoderPool->getSourceCount();
+
+	for (const auto &i : playing)
+		stats.decodedChunks += i.first->getDecodedChunkCount();
+
+	if (updateTiming.count > 0)
+		stats.updateTime = updateTiming.total / updateTiming.count;
+	stats.maxUpdateTime = updateTiming.max;
+
+	if (wakeupTiming.count > 0)
+		stats.wakeupJitter = wakeupTiming.total / wakeupTiming.count;
+	stats.maxWakeupJitter = wakeupTiming.max;
+
+	updateTiming = Timing();
+	wakeupTiming = Timing();
+
+	return stats;
+}
+
+void Pool::recordWakeup(double lateness)
+{
+	thread::Lock lock(mutex);
+	wakeupTiming.add(std::max(lateness, 0.0));
+}
+
+void Pool::recordUnderrun()
+{
+	underruns++;
+}
+
 bool Pool::assignSource(Source *source, ALuint &out, char &wasPlaying)
 {
 	out = 0;
@@ -183,7 +275,14 @@ bool Pool::assignSource(Source *source, ALuint &out, char &wasPlaying)
 	wasPlaying = false;
 
 	if (available.empty())
-		return false;
+	{
+		float listener[3];
+		bool attenuate = false;
+		getListenerState(listener, attenuate);
+
+		if (!stealSource(getImportance(source, listener, attenuate), listener, attenuate))
+			return false;
+	}
 
 	out = available.front();
 	available.pop();
@@ -207,6 +306,15 @@ bool Pool::releaseSource(Source *source, bool stop)
 		return true;
 	}
 
+	auto it = std::find(virtualSources.begin(), virtualSources.end(), source);
+	if (it != virtualSources.end())
+	{
+		source->stopAtomic();
+		virtualSources.erase(it);
+		source->release();
+		return true;
+	}
+
 	return false;
 }
 
@@ -221,6 +329,229 @@ bool Pool::findSource(Source *source, ALuint &out)
 	return true;
 }
 
+Pool::Importance Pool::getImportance(Source *source, const float *listener, bool attenuate) const
+{
+	Importance importance;
+	importance.priority = source->getPriority();
+	importance.audibility = source->getAudibility(listener, attenuate);
+	return importance;
+}
+
+bool Pool::isMoreImportant(const Importance &a, const Importance &b)
+{
+	if (a.priority != b.priority)
+		return a.priority > b.priority;
+
+	return a.audibility > b.audibility * STEAL_AUDIBILITY_RATIO;
+}
+
+void Pool::getListenerState(float *listener, bool &attenuate) const
+{
+	alGetListenerfv(AL_POSITION, listener);
+	attenuate = alGetInteger(AL_DISTANCE_MODEL) != AL_NONE;
+}
+
+bool Pool::stealSource(const Importance &importance, const float *listener, bool attenuate)
+{
+	Source *victim = nullptr;
+	Importance victimimportance = {};
+
+	for (const auto &i : playing)
+	{
+		Source *s = i.first;
+		if (!s->canBeVirtual())
+			continue;
+
+		Importance other = getImportance(s, listener, attenuate);
+		bool lessimportant = other.priority != victimimportance.priority
+			? other.priority < victimimportance.priority
+			: other.audibility < victimimportance.audibility;
+
+		if (victim == nullptr || lessimportant)
+		{
+			victim = s;
+			victimimportance = other;
+		}
+	}
+
+	if (victim == nullptr || !isMoreImportant(importance, victimimportance))
+		return false;
+
+	virtualizeSource(victim);
+	return true;
+}
+
+bool Pool::addVirtualSource(Source *source)
+{
+	if (!source->canBeVirtual())
+		return false;
+
+	source->virtualizeAtomic();
+	virtualSources.push_back(source);
+	source->retain();
+	return true;
+}
+
+void Pool::virtualizeSource(Source *source)
+{
+	ALuint s;
+	if (!findSource(source, s))
+		return;
+
+	// The reference held by the playing list moves to the virtual list.
+	source->virtualizeAtomic();
+	available.push(s);
+	playing.erase(source);
+	virtualSources.push_back(source);
+}
+
+void Pool::devirtualizeSource(Source *source)
+{
+	auto it = std::find(virtualSources.begin(), virtualSources.end(), source);
+	if (it == virtualSources.end() || available.empty())
+		return;
+
+	virtualSources.erase(it);
+
+	ALuint s = available.front();
+	available.pop();
+
+	// If playing fails, the Source releases itself from the playing list.
+	playing.insert(std::make_pair(source, s));
+	source->devirtualizeAtomic(s);
+}
+
+void Pool::updateVirtualSources()
+{
+	double now = love::timer::Timer::getTime();
+	double dt = now - lastUpdateTime;
+	lastUpdateTime = now;
+
+	if (virtualSources.empty())
+		return;
+
+	std::vector<Source *> finished;
+
+	for (Source *s : virtualSources)
+	{
+		if (!s->updateVirtualAtomic(dt))
+			finished.push_back(s);
+	}
+
+	for (Source *s : finished)
+		releaseSource(s);
+
+	float listener[3];
+	bool attenuate = false;
+	getListenerState(listener, attenuate);
+
+	std::vector<std::pair<Importance, Source *>> candidates;
+	candidates.reserve(virtualSources.size());
+
+	for (Source *s : virtualSources)
+	{
+		if (s->isPlaying())
+			candidates.emplace_back(getImportance(s, listener, attenuate), s);
+	}
+
+	std::sort(candidates.begin(), candidates.end(), [](const std::pair<Importance, Source *> &a, const std::pair<Importance, Source *> &b)
+	{
+		if (a.first.priority != b.first.priority)
+			return a.first.priority > b.first.priority;
+		return a.first.audibility > b.first.audibility;
+	});
+
+	// Give the most important virtual Sources a voice, taking one from a less
+	// important Source when none are free. Candidates are sorted, so once one
+	// can't get a voice the rest can't either.
+	for (const auto &c : candidates)
+	{
+		if (available.empty() && !stealSource(c.first, listener, attenuate))
+			break;
+
+		devirtualizeSource(c.second);
+	}
+}
+
+void Pool::scheduleSource(Source *source)
+{
+	if (std::find(scheduledSources.begin(), scheduledSources.end(), source) != scheduledSources.end())
+		return;
+
+	source->retain();
+	scheduledSources.push_back(source);
+}
+
+void Pool::updateScheduledSources()
+{
+	if (scheduledSources.empty())
+		return;
+
+	double now = getDeviceTime();
+
+	// Rebuild the list with the Sources which are still waiting.
+	std::vector<Source *> sources = scheduledSources;
+	scheduledSources.clear();
+
+	for (Source *s : sources)
+	{
+		if (s->updateScheduleAtomic(now))
+			scheduledSources.push_back(s);
+		else
+			s->release();
+	}
+}
+
+#ifndef ALC_SOFT_device_clock
+typedef int64_t ALCint64SOFT;
+typedef void (ALC_APIENTRY*LPALCGETINTEGER64VSOFT)(ALCdevice *device,
+	ALCenum pname, ALsizei size, ALCint64SOFT *values);
+#endif
+
+static LPALCGETINTEGER64VSOFT getDeviceClockFunction(ALCdevice *device)
+{
+	static LPALCGETINTEGER64VSOFT getInteger64v = alcIsExtensionPresent(device, "ALC_SOFT_device_clock") == ALC_TRUE
+		? (LPALCGETINTEGER64VSOFT) alcGetProcAddress(device, "alcGetInteger64vSOFT")
+		: nullptr;
+	return getInteger64v;
+}
+
+double Pool::getDeviceTime() const
+{
+#ifndef ALC_SOFT_device_clock
+	constexpr ALCenum ALC_DEVICE_CLOCK_SOFT = 0x1600;
+#endif
+
+	LPALCGETINTEGER64VSOFT getInteger64v = getDeviceClockFunction(device);
+	if (getInteger64v == nullptr)
+		return love::timer::Timer::getTime();
+
+	// Nanoseconds.
+	ALCint64SOFT clock = 0;
+	getInteger64v(device, ALC_DEVICE_CLOCK_SOFT, 1, &clock);
+	return (double) clock / 1000000000.0;
+}
+
+bool Pool::hasDeviceClock() const
+{
+	return getDeviceClockFunction(device) != nullptr;
+}
+
+void Pool::addDecodingSource(Source *source)
+{
+	decoderPool->addSource(source);
+}
+
+void Pool::removeDecodingSource(Source *source)
+{
+	decoderPool->removeSource(source);
+}
+
+void Pool::wakeDecoders()
+{
+	decoderPool->wake();
+}
+
 thread::Lock Pool::lock()
 {
 	return thread::Lock(mutex);
@@ -229,9 +560,11 @@ thread::Lock Pool::lock()
 std::vector<love::audio::Source*> Pool::getPlayingSources()
 {
 	std::vector<love::audio::Source*> sources;
-	sources.reserve(playing.size());
+	sources.reserve(playing.size() + virtualSources.size());
 	for (auto &i : playing)
 		sources.push_back(i.first);
+	for (Source *s : virtualSources)
+		sources.push_back(s);
 	return sources;
 }
 
@@ -26,12 +26,16 @@
 #include <map>
 #include <vector>
 #include <cmath>
+#include <atomic>
+#include <algorithm>
 
 // LOVE
 #include "common/config.h"
 #include "common/Exception.h"
 #include "thread/threads.h"
 #include "audio/Source.h"
+#include "audio/Audio.h"
+#include "DecoderPool.h"
 
 // OpenAL
 #ifdef LOVE_APPLE_USE_FRAMEWORKS
@@ -78,11 +82,36 @@ public:
 	 **/
 	bool isPlaying(Source *s);
 
+	/**
+	 * Updates playing Sources, and reassigns OpenAL sources to the most
+	 * important of the playing and virtual Sources.
+	 **/
 	void update();
 
 	int getActiveSourceCount() const;
 	int getMaxSources() const;
 
+	/**
+	 * Gets the time in seconds of the device clock if OpenAL has one, or of
+	 * the system timer otherwise.
+	 **/
+	double getDeviceTime() const;
+	bool hasDeviceClock() const;
+
+	/**
+	 * Gets counters for the update thread, and resets the timing averages and
+	 * maximums.
+	 **/
+	love::audio::Audio::Stats getStats();
+
+	/**
+	 * Records how much later than requested the update thread woke up.
+	 **/
+	void recordWakeup(double lateness);
+
+	// Called by streaming Sources when they run out of data while playing.
+	void recordUnderrun();
+
 private:
 
 	friend class Source;
@@ -98,9 +127,41 @@ private:
 	bool assignSource(Source *source, ALuint &out, char &wasPlaying);
 	bool findSource(Source *source, ALuint &out);
 
+	void addDecodingSource(Source *source);
+	void removeDecodingSource(Source *source);
+	void wakeDecoders();
+
+	struct Importance
+	{
+		int priority;
+		float audibility;
+	};
+
+	Importance getImportance(Source *source, const float *listener, bool attenuate) const;
+	static bool isMoreImportant(const Importance &a, const Importance &b);
+	void getListenerState(float *listener, bool &attenuate) const;
+
+	/**
+	 * Moves a less important Source than the given one to the virtual list,
+	 * freeing up its OpenAL source.
+	 **/
+	bool stealSource(const Importance &importance, const float *listener, bool attenuate);
+
+	bool addVirtualSource(Source *source);
+	void virtualizeSource(Source *source);
+	void devirtualizeSource(Source *source);
+	void updateVirtualSources();
+
+	void scheduleSource(Source *source);
+	void updateScheduledSources();
+
 	// Maximum possible number of OpenAL sources the pool attempts to generate.
 	static const int MAX_SOURCES = 64;
 
+	// How much louder a Source of equal priority has to be to take another
+	// one's OpenAL source, so Sources don't keep trading voices.
+	static constexpr float STEAL_AUDIBILITY_RATIO = 1.25f;
+
 	// Current OpenAL device
 	ALCdevice *device;
 
@@ -119,6 +180,36 @@ private:
 	// A map of playing sources.
 	std::map<Source *, ALuint> playing;
 
+	// Sources which are playing without an OpenAL source.
+	std::vector<Source *> virtualSources;
+
+	double lastUpdateTime;
+
+	// Sources waiting for a scheduled start or stop which OpenAL can't do
+	// for them.
+	std::vector<Source *> scheduledSources;
+
+	// Decodes streaming Sources ahead of the pool thread.
+	DecoderPool *decoderPool;
+
+	struct Timing
+	{
+		double total = 0.0;
+		double max = 0.0;
+		int64 count = 0;
+
+		void add(double t)
+		{
+			total += t;
+			max = std::max(max, t);
+			count++;
+		}
+	};
+
+	Timing updateTiming;
+	Timing wakeupTiming;
+	std::atomic<int64> underruns;
+
 	// Only one thread can access this object at the same time. This mutex will
 	// make sure of that.
 	love::thread::MutexRef mutex;
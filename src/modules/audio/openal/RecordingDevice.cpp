@@ -22,6 +22,9 @@
 #include "Audio.h"
 #include "sound/Sound.h"
 
+// C++
+#include <algorithm>
+
 namespace love
 {
 namespace audio
@@ -111,6 +114,29 @@ love::sound::SoundData *RecordingDevice::getData()
 	return soundData;
 }
 
+int RecordingDevice::getData(love::sound::SoundData *dst, int dstStart)
+{
+	if (!isRecording())
+		return 0;
+
+	if (dst->getSampleRate() != sampleRate || dst->getBitDepth() != bitDepth || dst->getChannelCount() != channels)
+		throw love::Exception("SoundData format does not match the recording format.");
+
+	if (dstStart < 0 || dstStart > dst->getSampleCount())
+		throw love::Exception("Destination out-of-range!");
+
+	int samples = std::min(getSampleCount(), dst->getSampleCount() - dstStart);
+	if (samples <= 0)
+		return 0;
+
+	// OpenAL's capture buffer is already a ring buffer, so this is the only
+	// copy the samples go through.
+	uint8 *data = (uint8 *) dst->getData() + (size_t) dstStart * channels * (bitDepth / 8);
+	alcCaptureSamples(device, data, samples);
+
+	return samples;
+}
+
 int RecordingDevice::getSampleCount() const
 {
 	if (!isRecording())
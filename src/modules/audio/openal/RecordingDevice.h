@@ -55,6 +55,7 @@ public:
 	virtual bool start(int samples, int sampleRate, int bitDepth, int channels);
 	virtual void stop();
 	virtual love::sound::SoundData *getData();
+	virtual int getData(love::sound::SoundData *dst, int dstStart);
 	virtual const char *getName() const;
 	virtual int getSampleCount() const;
 	virtual int getMaxSamples() const;
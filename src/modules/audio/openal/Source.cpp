@@ -23,15 +23,26 @@
 #include "Pool.h"
 #include "Audio.h"
 #include "common/math.h"
+#include "sound/SampleConversion.h"
 
 // STD
 #include <iostream>
 #include <algorithm>
+#include <cstring>
 
 #define audiomodule() (Module::getInstance<Audio>(Module::M_AUDIO))
 
 using love::thread::Lock;
 
+#ifndef AL_SOFT_source_start_delay
+typedef void (AL_APIENTRY*LPALSOURCEPLAYATTIMESOFT)(ALuint source, love::int64 start_time);
+#endif
+
+#ifndef AL_SOFT_deferred_updates
+typedef void (AL_APIENTRY*LPALDEFERUPDATESSOFT)(void);
+typedef void (AL_APIENTRY*LPALPROCESSUPDATESSOFT)(void);
+#endif
+
 namespace love
 {
 namespace audio
@@ -129,8 +140,26 @@ Source::Source(Pool *pool, love::sound::SoundData *soundData)
 	if (fmt == AL_NONE)
 		throw InvalidFormatException(soundData->getChannelCount(), soundData->getBitDepth());
 
-	staticBuffer.set(new StaticDataBuffer(fmt, soundData->getData(), (ALsizei) soundData->getSize(), sampleRate), Acquire::NORETAIN);
+	staticBuffer.set(new StaticDataBuffer(fmt, soundData->getReadOnlyData(), (ALsizei) soundData->getSize(), sampleRate), Acquire::NORETAIN);
+
+	float z[3] = {0, 0, 0};
+
+	setFloatv(position, z);
+	setFloatv(velocity, z);
+	setFloatv(direction, z);
+
+	for (int i = 0; i < audiomodule()->getMaxSourceEffects(); i++)
+		slotlist.push(i);
+}
 
+Source::Source(Pool *pool, StaticDataBuffer *buffer, int sampleRate, int bitDepth, int channels)
+	: love::audio::Source(Source::TYPE_STATIC)
+	, pool(pool)
+	, staticBuffer(buffer)
+	, sampleRate(sampleRate)
+	, channels(channels)
+	, bitDepth(bitDepth)
+{
 	float z[3] = {0, 0, 0};
 
 	setFloatv(position, z);
@@ -141,8 +170,8 @@ Source::Source(Pool *pool, love::sound::SoundData *soundData)
 		slotlist.push(i);
 }
 
-Source::Source(Pool *pool, love::sound::Decoder *decoder)
-	: love::audio::Source(Source::TYPE_STREAM)
+Source::Source(Pool *pool, love::sound::Decoder *decoder, Type type)
+	: love::audio::Source(type)
 	, pool(pool)
 	, sampleRate(decoder->getSampleRate())
 	, channels(decoder->getChannelCount())
@@ -239,7 +268,9 @@ Source::Source(const Source &s)
 	, toLoop(0)
 	, buffers(s.buffers)
 {
-	if (sourceType == TYPE_STREAM)
+	priority = s.priority;
+
+	if (isStreamingType())
 	{
 		if (s.decoder.get())
 			decoder.set(s.decoder->clone(), Acquire::NORETAIN);
@@ -326,11 +357,22 @@ love::audio::Source *Source::clone()
 bool Source::play()
 {
 	Lock l = pool->lock();
+
+	if (virtualVoice)
+	{
+		virtualPaused = false;
+		return true;
+	}
+
 	ALuint out;
 
 	char wasPlaying;
 	if (!pool->assignSource(this, out, wasPlaying))
-		return valid = false;
+	{
+		// Keep playing without a voice until one frees up.
+		valid = false;
+		return pool->addVirtualSource(this);
+	}
 
 	if (!wasPlaying)
 		return valid = playAtomic(out);
@@ -341,22 +383,82 @@ bool Source::play()
 
 void Source::stop()
 {
-	if (!valid)
+	Lock l = pool->lock();
+
+	scheduledStart = -1.0;
+	scheduledStop = -1.0;
+
+	if (!valid && !virtualVoice)
 		return;
 
-	Lock l = pool->lock();
 	pool->releaseSource(this);
 }
 
+static LPALSOURCEPLAYATTIMESOFT getSourcePlayAtTime(Pool *pool)
+{
+	// The start time is on the device clock, so that has to be available too.
+	static LPALSOURCEPLAYATTIMESOFT playAtTime = alIsExtensionPresent("AL_SOFT_source_start_delay") && pool->hasDeviceClock()
+		? (LPALSOURCEPLAYATTIMESOFT) alGetProcAddress("alSourcePlayAtTimeSOFT")
+		: nullptr;
+	return playAtTime;
+}
+
+bool Source::playAt(double time)
+{
+	Lock l = pool->lock();
+
+	scheduledStart = -1.0;
+
+	if (time <= pool->getDeviceTime())
+		return play();
+
+	// OpenAL can start the Source on the exact sample, but it needs a voice
+	// ahead of time for that.
+	if (getSourcePlayAtTime(pool) != nullptr && !virtualVoice && !pool->isPlaying(this))
+	{
+		ALuint out;
+		char wasPlaying;
+		if (pool->assignSource(this, out, wasPlaying))
+		{
+			pendingStartTime = time;
+			return valid = playAtomic(out);
+		}
+	}
+
+	// Otherwise the pool thread starts it, on its next update after the time.
+	scheduledStart = time;
+	pool->scheduleSource(this);
+	return true;
+}
+
+void Source::stopAt(double time)
+{
+	Lock l = pool->lock();
+
+	if (time <= pool->getDeviceTime())
+	{
+		stop();
+		return;
+	}
+
+	scheduledStop = time;
+	pool->scheduleSource(this);
+}
+
 void Source::pause()
 {
 	Lock l = pool->lock();
-	if (pool->isPlaying(this))
+	if (virtualVoice)
+		virtualPaused = true;
+	else if (pool->isPlaying(this))
 		pauseAtomic();
 }
 
 bool Source::isPlaying() const
 {
+	if (virtualVoice)
+		return !virtualPaused;
+
 	if (!valid)
 		return false;
 
@@ -370,7 +472,7 @@ bool Source::isFinished() const
 	if (!valid)
 		return false;
 
-	if (sourceType == TYPE_STREAM && (isLooping() || !decoder->isFinished()))
+	if (isStreamingType() && (isLooping() || !isStreamFinished()))
 		return false;
 
 	ALenum state;
@@ -380,6 +482,10 @@ bool Source::isFinished() const
 
 bool Source::update()
 {
+	// Called by the pool thread without the pool lock held, so streaming this
+	// Source doesn't block calls on other Sources.
+	Lock sl(mutex);
+
 	if (!valid)
 		return false;
 
@@ -393,8 +499,15 @@ bool Source::update()
 			return !isFinished();
 		}
 		case TYPE_STREAM:
+		case TYPE_COMPRESSED:
 			if (!isFinished())
 			{
+				// A stream which isn't finished only stops by itself when every
+				// queued buffer played before new data arrived.
+				ALint state;
+				alGetSourcei(source, AL_SOURCE_STATE, &state);
+				bool underrun = state == AL_STOPPED;
+
 				ALint processed;
 				alGetSourcei(source, AL_BUFFERS_PROCESSED, &processed);
 
@@ -419,7 +532,7 @@ bool Source::update()
 
 					offsetSamples += (curOffsetSamples - newOffsetSamples);
 
-					if (streamAtomic(buffer, decoder.get()) > 0)
+					if (streamAtomic(buffer) > 0)
 						alSourceQueueBuffers(source, 1, &buffer);
 					else
 						unusedBuffers.push(buffer);
@@ -428,7 +541,7 @@ bool Source::update()
 				while (!unusedBuffers.empty())
 				{
 					ALuint b = unusedBuffers.top();
-					if (streamAtomic(b, decoder.get()) > 0)
+					if (streamAtomic(b) > 0)
 					{
 						alSourceQueueBuffers(source, 1, &b);
 						unusedBuffers.pop();
@@ -437,6 +550,21 @@ bool Source::update()
 						break;
 				}
 
+				if (underrun)
+				{
+					ALint queued;
+					alGetSourcei(source, AL_BUFFERS_QUEUED, &queued);
+
+					// Resume once there's data again, instead of staying silent.
+					if (queued > 0)
+					{
+						underrunCount++;
+						pool->recordUnderrun();
+						alSourcePlay(source);
+					}
+				}
+
+				pool->wakeDecoders();
 				return true;
 			}
 			return false;
@@ -509,6 +637,7 @@ float Source::getVolume() const
 void Source::seek(double offset, Source::Unit unit)
 {
 	Lock l = pool->lock();
+	Lock sl(mutex);
 
 	int offsetSamples = 0;
 	double offsetSeconds = 0.0f;
@@ -526,6 +655,12 @@ void Source::seek(double offset, Source::Unit unit)
 		break;
 	}
 
+	if (virtualVoice)
+	{
+		virtualOffset = offsetSeconds * sampleRate;
+		return;
+	}
+
 	bool wasPlaying = isPlaying();
 	switch (sourceType)
 	{
@@ -537,6 +672,7 @@ void Source::seek(double offset, Source::Unit unit)
 			}
 			break;
 		case TYPE_STREAM:
+		case TYPE_COMPRESSED:
 		{
 			// To drain all buffers
 			if (valid)
@@ -580,7 +716,7 @@ void Source::seek(double offset, Source::Unit unit)
 			break;
 	}
 
-	if (wasPlaying && (alGetError() == AL_INVALID_VALUE || (sourceType == TYPE_STREAM && !isPlaying())))
+	if (wasPlaying && (alGetError() == AL_INVALID_VALUE || (isStreamingType() && !isPlaying())))
 	{
 		stop();
 		if (isLooping())
@@ -594,6 +730,15 @@ void Source::seek(double offset, Source::Unit unit)
 double Source::tell(Source::Unit unit)
 {
 	Lock l = pool->lock();
+	Lock sl(mutex);
+
+	if (virtualVoice)
+	{
+		if (unit == UNIT_SECONDS)
+			return virtualOffset / (double) sampleRate;
+		else
+			return (int) virtualOffset;
+	}
 
 	int offset = 0;
 
@@ -625,6 +770,7 @@ double Source::getDuration(Unit unit)
 			return (double) samples / (double) sampleRate;
 	}
 	case TYPE_STREAM:
+	case TYPE_COMPRESSED:
 	{
 		double seconds = decoder->getDuration();
 
@@ -786,16 +932,28 @@ bool Source::queue(void *data, size_t length, int dataSampleRate, int dataBitDep
 	if (sourceType != TYPE_QUEUE)
 		throw QueueTypeMismatchException();
 
-	if (dataSampleRate != sampleRate || dataBitDepth != bitDepth || dataChannels != channels )
+	// 8 and 16 bit data can be converted, other format differences can't.
+	if (dataSampleRate != sampleRate || dataChannels != channels || (dataBitDepth != 8 && dataBitDepth != 16))
 		throw QueueFormatMismatchException();
 
-	if (length % (bitDepth / 8 * channels) != 0)
-		throw QueueMalformedLengthException(bitDepth / 8 * channels);
+	if (length % (dataBitDepth / 8 * channels) != 0)
+		throw QueueMalformedLengthException(dataBitDepth / 8 * channels);
 
 	if (length == 0)
 		return true;
 
+	std::vector<uint8> converted;
+	if (dataBitDepth != bitDepth)
+	{
+		size_t count = length / (dataBitDepth / 8);
+		converted.resize(count * (bitDepth / 8));
+		love::sound::convertSamples(data, dataBitDepth, converted.data(), bitDepth, count);
+		data = converted.data();
+		length = converted.size();
+	}
+
 	Lock l = pool->lock();
+	Lock sl(mutex);
 
 	if (unusedBuffers.empty())
 		return false;
@@ -815,11 +973,14 @@ bool Source::queue(void *data, size_t length, int dataSampleRate, int dataBitDep
 
 int Source::getFreeBufferCount() const
 {
+	Lock sl(mutex);
+
 	switch (sourceType) //why not :^)
 	{
 	case TYPE_STATIC:
 		return 0;
 	case TYPE_STREAM:
+	case TYPE_COMPRESSED:
 		return unusedBuffers.size();
 	case TYPE_QUEUE:
 		return unusedBuffers.size();
@@ -831,6 +992,8 @@ int Source::getFreeBufferCount() const
 
 void Source::prepareAtomic()
 {
+	Lock sl(mutex);
+
 	// This Source may now be associated with an OpenAL source that still has
 	// the properties of another love Source. Let's reset it to the settings
 	// of the new one.
@@ -842,19 +1005,35 @@ void Source::prepareAtomic()
 		alSourcei(source, AL_BUFFER, staticBuffer->getBuffer());
 		break;
 	case TYPE_STREAM:
+	case TYPE_COMPRESSED:
+	{
+		// The initial buffers are decoded right away, the rest is decoded
+		// ahead by the decoder pool.
+		Lock dl(decodeMutex);
+
 		while (!unusedBuffers.empty())
 		{
+			decodeChunkAtomic();
+
 			auto b = unusedBuffers.top();
-			if (streamAtomic(b, decoder.get()) == 0)
+			if (streamAtomic(b) == 0)
 				break;
 
 			alSourceQueueBuffers(source, 1, &b);
 			unusedBuffers.pop();
 
-			if (decoder->isFinished())
+			if (decodeFinished)
 				break;
 		}
+
+		{
+			Lock cl(chunkMutex);
+			decodingAhead = true;
+		}
+
+		pool->addDecodingSource(this);
 		break;
+	}
 	case TYPE_QUEUE:
 	{
 		while (!streamBuffers.empty())
@@ -874,17 +1053,37 @@ void Source::prepareAtomic()
 
 void Source::teardownAtomic()
 {
+	Lock sl(mutex);
+
 	switch (sourceType)
 	{
 	case TYPE_STATIC:
 		break;
 	case TYPE_STREAM:
+	case TYPE_COMPRESSED:
 	{
 		ALint queued = 0;
 		ALuint buffers[MAX_BUFFERS];
 
-		// Some decoders (e.g. ModPlug) can rewind() more reliably than seek(0).
-		decoder->rewind();
+		{
+			Lock dl(decodeMutex);
+
+			{
+				Lock cl(chunkMutex);
+				decodingAhead = false;
+				decodeFinished = false;
+				while (!decodedChunks.empty())
+				{
+					freeChunks.push_back(std::move(decodedChunks.front()));
+					decodedChunks.pop_front();
+				}
+			}
+
+			// Some decoders (e.g. ModPlug) can rewind() more reliably than seek(0).
+			decoder->rewind();
+		}
+
+		pool->removeDecodingSource(this);
 
 		// Drain buffers.
 		// NOTE: The Apple implementation of OpenAL on iOS doesn't return
@@ -922,17 +1121,26 @@ void Source::teardownAtomic()
 
 bool Source::playAtomic(ALuint source)
 {
+	// The pool lock is already held, and Source::update may be streaming this
+	// Source on the pool thread.
+	Lock sl(mutex);
+
 	this->source = source;
 	prepareAtomic();
 
 	// Clear errors.
 	alGetError();
 
-	alSourcePlay(source);
+	if (pendingStartTime >= 0.0 && getSourcePlayAtTime(pool) != nullptr)
+		getSourcePlayAtTime(pool)(source, (int64) (pendingStartTime * 1000000000.0));
+	else
+		alSourcePlay(source);
+
+	pendingStartTime = -1.0;
 
 	bool success = alGetError() == AL_NO_ERROR;
 
-	if (sourceType == TYPE_STREAM)
+	if (isStreamingType())
 	{
 		valid = true; //isPlaying() needs source to be valid
 		if (!isPlaying())
@@ -946,7 +1154,7 @@ bool Source::playAtomic(ALuint source)
 	}
 
 	// Static sources: reset the pending offset since it's not valid anymore.
-	if (sourceType != TYPE_STREAM)
+	if (!isStreamingType())
 		offsetSamples = 0;
 
 	return success;
@@ -954,6 +1162,19 @@ bool Source::playAtomic(ALuint source)
 
 void Source::stopAtomic()
 {
+	Lock sl(mutex);
+
+	if (virtualVoice)
+	{
+		virtualVoice = false;
+		virtualPaused = false;
+		virtualOffset = 0.0;
+		offsetSamples = 0;
+		if (isStreamingType())
+			decoder->rewind();
+		return;
+	}
+
 	if (!valid)
 		return;
 	alSourceStop(source);
@@ -962,22 +1183,119 @@ void Source::stopAtomic()
 
 void Source::pauseAtomic()
 {
+	Lock sl(mutex);
+
 	if (valid)
 		alSourcePause(source);
 }
 
 void Source::resumeAtomic()
 {
+	Lock sl(mutex);
+
 	if (valid && !isPlaying())
 	{
 		alSourcePlay(source);
 
 		//failed to play or nothing to play
-		if (alGetError() == AL_INVALID_VALUE || (sourceType == TYPE_STREAM && (int) unusedBuffers.size() == buffers))
+		if (alGetError() == AL_INVALID_VALUE || (isStreamingType() && (int) unusedBuffers.size() == buffers))
 			stop();
 	}
 }
 
+void Source::virtualizeAtomic()
+{
+	// A Source which was never given an OpenAL source may have a pending
+	// offset from seek() instead.
+	double offset = offsetSamples;
+	bool paused = false;
+
+	if (valid)
+	{
+		ALint cur = 0;
+		alGetSourcei(source, AL_SAMPLE_OFFSET, &cur);
+		offset += cur;
+		paused = !isPlaying();
+		stopAtomic();
+	}
+
+	offsetSamples = 0;
+
+	virtualVoice = true;
+	virtualPaused = paused;
+	virtualOffset = offset;
+}
+
+bool Source::devirtualizeAtomic(ALuint source)
+{
+	int offset = (int) virtualOffset;
+	bool paused = virtualPaused;
+
+	virtualVoice = false;
+	virtualPaused = false;
+	virtualOffset = 0.0;
+
+	// Streams start playing from the decoder's position, other types seek
+	// to the pending offset when they're prepared.
+	if (isStreamingType())
+		decoder->seek(offset / (double) sampleRate);
+	else
+		offsetSamples = offset;
+
+	valid = playAtomic(source);
+
+	if (valid)
+	{
+		if (isStreamingType())
+			offsetSamples = offset;
+		if (paused)
+			pauseAtomic();
+	}
+
+	return valid;
+}
+
+bool Source::updateVirtualAtomic(double dt)
+{
+	if (virtualPaused)
+		return true;
+
+	virtualOffset += dt * pitch * sampleRate;
+
+	double length = -1.0;
+	if (sourceType == TYPE_STATIC)
+		length = (double) ((staticBuffer->getSize() / channels) / (bitDepth / 8));
+	else if (isStreamingType() && decoder->getDuration() > 0.0)
+		length = decoder->getDuration() * sampleRate;
+
+	if (length > 0.0 && virtualOffset >= length)
+	{
+		if (!isLooping())
+			return false;
+
+		virtualOffset = fmod(virtualOffset, length);
+	}
+
+	return true;
+}
+
+bool Source::updateScheduleAtomic(double now)
+{
+	if (scheduledStart >= 0.0 && now >= scheduledStart)
+	{
+		scheduledStart = -1.0;
+		play();
+	}
+
+	if (scheduledStop >= 0.0 && now >= scheduledStop)
+	{
+		scheduledStop = -1.0;
+		stop();
+	}
+
+	return scheduledStart >= 0.0 || scheduledStop >= 0.0;
+}
+
 bool Source::play(const std::vector<love::audio::Source*> &sources)
 {
 	if (sources.size() == 0)
@@ -1006,15 +1324,17 @@ bool Source::play(const std::vector<love::audio::Source*> &sources)
 	toPlay.reserve(sources.size());
 	for (size_t i = 0; i < sources.size(); i++)
 	{
+		Source *source = (Source*) sources[i];
+		Lock sl(source->mutex);
+
 		// If the source was paused, wasPlaying[i] will be true but we still
 		// want to resume it. We don't want to call alSourcePlay on sources
 		// that are actually playing though.
-		if (wasPlaying[i] && sources[i]->isPlaying())
+		if (wasPlaying[i] && source->isPlaying())
 			continue;
 
 		if (!wasPlaying[i])
 		{
-			Source *source = (Source*) sources[i];
 			source->source = ids[i];
 			source->prepareAtomic();
 		}
@@ -1029,9 +1349,11 @@ bool Source::play(const std::vector<love::audio::Source*> &sources)
 	for (auto &_source : sources)
 	{
 		Source *source = (Source*) _source;
+		Lock sl(source->mutex);
+
 		source->valid = source->valid || success;
 
-		if (success && source->sourceType != TYPE_STREAM)
+		if (success && !source->isStreamingType())
 			source->offsetSamples = 0;
 	}
 
@@ -1060,6 +1382,8 @@ void Source::stop(const std::vector<love::audio::Source*> &sources)
 	for (auto &_source : sources)
 	{
 		Source *source = (Source*) _source;
+		source->scheduledStart = -1.0;
+		source->scheduledStop = -1.0;
 		if (source->valid)
 			source->teardownAtomic();
 		pool->releaseSource(source, false);
@@ -1080,11 +1404,68 @@ void Source::pause(const std::vector<love::audio::Source*> &sources)
 		Source *source = (Source*) _source;
 		if (source->valid)
 			sourceIds.push_back(source->source);
+		else if (source->virtualVoice)
+			source->virtualPaused = true;
 	}
 
 	alSourcePausev((ALsizei) sourceIds.size(), &sourceIds[0]);
 }
 
+void Source::setPositions(const std::vector<love::audio::Source*> &sources, const float *positions, const float *velocities)
+{
+	if (sources.size() == 0)
+		return;
+
+	// Check everything first so an error doesn't leave half of them moved.
+	for (auto &_source : sources)
+	{
+		if (((Source*) _source)->channels > 1)
+			throw SpatialSupportException();
+	}
+
+	static LPALDEFERUPDATESSOFT deferUpdates = nullptr;
+	static LPALPROCESSUPDATESSOFT processUpdates = nullptr;
+	static bool loaded = false;
+
+	Pool *pool = ((Source*) sources[0])->pool;
+	Lock l = pool->lock();
+
+	if (!loaded)
+	{
+		if (alIsExtensionPresent("AL_SOFT_deferred_updates"))
+		{
+			deferUpdates = (LPALDEFERUPDATESSOFT) alGetProcAddress("alDeferUpdatesSOFT");
+			processUpdates = (LPALPROCESSUPDATESSOFT) alGetProcAddress("alProcessUpdatesSOFT");
+		}
+		loaded = true;
+	}
+
+	// Let the mixer pick up all the changes at once, instead of each one being
+	// applied separately while the loop runs.
+	bool deferred = deferUpdates != nullptr && processUpdates != nullptr;
+	if (deferred)
+		deferUpdates();
+
+	for (size_t i = 0; i < sources.size(); i++)
+	{
+		Source *source = (Source*) sources[i];
+
+		source->setFloatv(source->position, &positions[i * 3]);
+		if (velocities != nullptr)
+			source->setFloatv(source->velocity, &velocities[i * 3]);
+
+		if (source->valid)
+		{
+			alSourcefv(source->source, AL_POSITION, source->position);
+			if (velocities != nullptr)
+				alSourcefv(source->source, AL_VELOCITY, source->velocity);
+		}
+	}
+
+	if (deferred)
+		processUpdates();
+}
+
 std::vector<love::audio::Source*> Source::pause(Pool *pool)
 {
 	Lock l = pool->lock();
@@ -1144,18 +1525,27 @@ void Source::setFloatv(float *dst, const float *src) const
 	dst[2] = src[2];
 }
 
-int Source::streamAtomic(ALuint buffer, love::sound::Decoder *d)
+int Source::streamAtomic(ALuint buffer)
 {
-	// Get more sound data.
-	int decoded = std::max(d->decode(), 0);
+	DecodedChunk chunk;
+	{
+		Lock cl(chunkMutex);
+		if (decodedChunks.empty())
+			return 0;
+
+		chunk = std::move(decodedChunks.front());
+		decodedChunks.pop_front();
+	}
+
+	int decoded = chunk.size;
 
 	// OpenAL implementations are allowed to ignore 0-size alBufferData calls.
 	if (decoded > 0)
 	{
-		int fmt = Audio::getFormat(d->getBitDepth(), d->getChannelCount());
+		int fmt = Audio::getFormat(decoder->getBitDepth(), decoder->getChannelCount());
 
 		if (fmt != AL_NONE)
-			alBufferData(buffer, fmt, d->getBuffer(), decoded, d->getSampleRate());
+			alBufferData(buffer, fmt, chunk.data.data(), decoded, decoder->getSampleRate());
 		else
 			decoded = 0;
 	}
@@ -1173,7 +1563,7 @@ int Source::streamAtomic(ALuint buffer, love::sound::Decoder *d)
 		}
 	}
 
-	if (decoder->isFinished() && isLooping())
+	if (chunk.loops)
 	{
 		int queued, processed;
 		alGetSourcei(source, AL_BUFFERS_QUEUED, &queued);
@@ -1182,12 +1572,95 @@ int Source::streamAtomic(ALuint buffer, love::sound::Decoder *d)
 			toLoop = queued-processed;
 		else
 			toLoop = buffers-processed;
-		d->rewind();
 	}
 
+	Lock cl(chunkMutex);
+	freeChunks.push_back(std::move(chunk));
+
 	return decoded;
 }
 
+bool Source::decodeChunkAtomic()
+{
+	DecodedChunk chunk;
+	{
+		Lock cl(chunkMutex);
+		if (decodeFinished || (int) decodedChunks.size() >= READ_AHEAD_CHUNKS)
+			return false;
+
+		if (!freeChunks.empty())
+		{
+			chunk = std::move(freeChunks.back());
+			freeChunks.pop_back();
+		}
+	}
+
+	// Get more sound data, straight into the chunk.
+	if (chunk.data.size() < (size_t) decoder->getSize())
+		chunk.data.resize(decoder->getSize());
+
+	int decoded = std::max(decoder->decodeInto(chunk.data.data(), (int) chunk.data.size()), 0);
+
+	chunk.size = decoded;
+	chunk.loops = false;
+
+	bool finished = false;
+	if (decoder->isFinished())
+	{
+		if (isLooping())
+		{
+			decoder->rewind();
+			chunk.loops = true;
+		}
+		else
+			finished = true;
+	}
+
+	Lock cl(chunkMutex);
+
+	// Empty chunks are still queued when they loop, so the loop point is
+	// tracked.
+	if (decoded > 0 || chunk.loops)
+		decodedChunks.push_back(std::move(chunk));
+	else
+		freeChunks.push_back(std::move(chunk));
+
+	decodeFinished = finished;
+	return true;
+}
+
+bool Source::isStreamFinished() const
+{
+	Lock cl(chunkMutex);
+	return decodeFinished && decodedChunks.empty();
+}
+
+bool Source::isStreamingType() const
+{
+	// Compressed Sources stream from encoded data in memory.
+	return sourceType == TYPE_STREAM || sourceType == TYPE_COMPRESSED;
+}
+
+bool Source::needsDecodeAhead() const
+{
+	Lock cl(chunkMutex);
+	return decodingAhead && !decodeFinished && (int) decodedChunks.size() < READ_AHEAD_CHUNKS;
+}
+
+void Source::decodeAheadAtomic()
+{
+	Lock dl(decodeMutex);
+
+	bool decoding = false;
+	{
+		Lock cl(chunkMutex);
+		decoding = decodingAhead;
+	}
+
+	if (decoding)
+		decodeChunkAtomic();
+}
+
 void Source::setMinVolume(float volume)
 {
 	if (valid)
@@ -1506,6 +1979,54 @@ bool Source::getEffect(const char *name, std::map<Filter::Parameter, float> &par
 	return true;
 }
 
+bool Source::isVirtual() const
+{
+	return virtualVoice;
+}
+
+int Source::getUnderrunCount() const
+{
+	Lock sl(mutex);
+	return underrunCount;
+}
+
+int Source::getDecodedChunkCount() const
+{
+	Lock cl(chunkMutex);
+	return (int) decodedChunks.size();
+}
+
+float Source::getAudibility(const float *listener, bool attenuate) const
+{
+	if (!isPlaying())
+		return 0.0f;
+
+	float gain = volume;
+
+	// Matches the default inverse distance clamped model. Other models are
+	// close enough for ranking Sources against each other.
+	if (attenuate && channels == 1)
+	{
+		float d[3];
+		for (int i = 0; i < 3; i++)
+			d[i] = relative ? position[i] : position[i] - listener[i];
+
+		float distance = sqrtf(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+		distance = std::min(std::max(distance, referenceDistance), maxDistance);
+
+		float denom = referenceDistance + rolloffFactor * (distance - referenceDistance);
+		if (denom > 0.0f)
+			gain *= referenceDistance / denom;
+	}
+
+	return std::min(std::max(gain, minVolume), maxVolume);
+}
+
+bool Source::canBeVirtual() const
+{
+	return sourceType != TYPE_QUEUE;
+}
+
 bool Source::getActiveEffects(std::vector<std::string> &list) const
 {
 	if (effectmap.empty())
@@ -28,12 +28,14 @@
 #include "audio/Filter.h"
 #include "sound/SoundData.h"
 #include "sound/Decoder.h"
+#include "thread/threads.h"
 #include "Audio.h"
 #include "Filter.h"
 
 // STL
 #include <vector>
 #include <stack>
+#include <deque>
 
 // C
 #include <float.h>
@@ -99,7 +101,8 @@ class Source : public love::audio::Source
 public:
 
 	Source(Pool *pool, love::sound::SoundData *soundData);
-	Source(Pool *pool, love::sound::Decoder *decoder);
+	Source(Pool *pool, StaticDataBuffer *buffer, int sampleRate, int bitDepth, int channels);
+	Source(Pool *pool, love::sound::Decoder *decoder, Type type);
 	Source(Pool *pool, int sampleRate, int bitDepth, int channels, int buffers);
 	Source(const Source &s);
 	virtual ~Source();
@@ -111,6 +114,8 @@ public:
 	virtual bool isPlaying() const;
 	virtual bool isFinished() const;
 	virtual bool update();
+	virtual bool playAt(double time);
+	virtual void stopAt(double time);
 	virtual void setPitch(float pitch);
 	virtual float getPitch() const;
 	virtual void setVolume(float volume);
@@ -157,6 +162,21 @@ public:
 	virtual int getFreeBufferCount() const;
 	virtual bool queue(void *data, size_t length, int dataSampleRate, int dataBitDepth, int dataChannels);
 
+	virtual bool isVirtual() const;
+	virtual int getUnderrunCount() const;
+
+	// Number of decoded chunks waiting to be queued into OpenAL.
+	int getDecodedChunkCount() const;
+
+	/**
+	 * Estimates how loud the Source currently is, from its volume and its
+	 * distance attenuation (if enabled).
+	 **/
+	float getAudibility(const float *listener, bool attenuate) const;
+
+	// Queueable sources can't keep playing without an OpenAL source.
+	bool canBeVirtual() const;
+
 	void prepareAtomic();
 	void teardownAtomic();
 
@@ -165,9 +185,22 @@ public:
 	void pauseAtomic();
 	void resumeAtomic();
 
+	void virtualizeAtomic();
+	bool devirtualizeAtomic(ALuint source);
+	bool updateVirtualAtomic(double dt);
+
+	// Starts or stops the Source if its scheduled time has come. Returns
+	// false once nothing is scheduled anymore.
+	bool updateScheduleAtomic(double now);
+
+	// Called by DecoderPool's worker threads.
+	bool needsDecodeAhead() const;
+	void decodeAheadAtomic();
+
 	static bool play(const std::vector<love::audio::Source*> &sources);
 	static void stop(const std::vector<love::audio::Source*> &sources);
 	static void pause(const std::vector<love::audio::Source*> &sources);
+	static void setPositions(const std::vector<love::audio::Source*> &sources, const float *positions, const float *velocities);
 
 	static std::vector<love::audio::Source*> pause(Pool *pool);
 	static void stop(Pool *pool);
@@ -178,9 +211,18 @@ private:
 
 	void setFloatv(float *dst, const float *src) const;
 
-	int streamAtomic(ALuint buffer, love::sound::Decoder *d);
+	int streamAtomic(ALuint buffer);
+	bool decodeChunkAtomic();
+	bool isStreamFinished() const;
+	bool isStreamingType() const;
 
 	Pool *pool = nullptr;
+
+	// Guards the buffer and decoder state which the pool thread updates. Lock
+	// order is always the pool lock first, then this. Both are recursive, so
+	// the *Atomic functions can lock it again and call back into the pool.
+	love::thread::MutexRef mutex;
+
 	ALuint source = 0;
 	bool valid = false;
 
@@ -215,12 +257,50 @@ private:
 
 	int offsetSamples = 0;
 
+	// State for playing without an OpenAL source.
+	bool virtualVoice = false;
+	bool virtualPaused = false;
+	double virtualOffset = 0.0; // samples
+
+	// Device clock times in seconds, or negative when nothing is scheduled.
+	// pendingStartTime is consumed by playAtomic when OpenAL can delay the
+	// start itself.
+	double scheduledStart = -1.0;
+	double scheduledStop = -1.0;
+	double pendingStartTime = -1.0;
+
 	int sampleRate = 0;
 	int channels = 0;
 	int bitDepth = 0;
 
 	StrongRef<love::sound::Decoder> decoder;
 
+	struct DecodedChunk
+	{
+		std::vector<char> data;
+		int size = 0;
+		// The decoder was rewound after this chunk to loop.
+		bool loops = false;
+	};
+
+	// Streaming Sources are decoded up to this many chunks ahead of what's
+	// queued in OpenAL.
+	const static int READ_AHEAD_CHUNKS = 4;
+
+	std::deque<DecodedChunk> decodedChunks;
+	std::vector<DecodedChunk> freeChunks;
+	bool decodingAhead = false;
+	bool decodeFinished = false;
+
+	// decodeMutex is held while the decoder is in use, chunkMutex guards the
+	// decoded chunks and flags above so the pool thread never waits on a
+	// decode in progress.
+	love::thread::MutexRef decodeMutex;
+	love::thread::MutexRef chunkMutex;
+
+	// Times the OpenAL source ran out of queued data before the stream ended.
+	int underrunCount = 0;
+
 	unsigned int toLoop = 0;
 	ALsizei bufferedBytes = 0;
 	int buffers = 0;
@@ -21,6 +21,9 @@
 // LOVE
 #include "wrap_Audio.h"
 #include "filesystem/wrap_Filesystem.h"
+#include "filesystem/Filesystem.h"
+#include "filesystem/File.h"
+#include "data/wrap_Data.h"
 
 #include "openal/Audio.h"
 #include "null/Audio.h"
@@ -44,9 +47,34 @@ int w_getActiveSourceCount(lua_State *L)
 	return 1;
 }
 
+// Builds a key identifying the contents of a file on disk, so static Sources
+// loaded from the same unchanged file can share their decoded sample data.
+static std::string getSourceCacheKey(lua_State *L, int idx)
+{
+	std::string filename;
+
+	if (lua_type(L, idx) == LUA_TSTRING)
+		filename = lua_tostring(L, idx);
+	else if (luax_istype(L, idx, love::filesystem::File::type))
+		filename = luax_totype<love::filesystem::File>(L, idx)->getFilename();
+	else
+		return std::string();
+
+	auto fs = Module::getInstance<love::filesystem::Filesystem>(Module::M_FILESYSTEM);
+	if (fs == nullptr || filename.empty())
+		return std::string();
+
+	love::filesystem::Filesystem::Info info = {};
+	if (!fs->getInfo(filename.c_str(), info) || info.type != love::filesystem::Filesystem::FILETYPE_FILE)
+		return std::string();
+
+	return filename + ":" + std::to_string(info.modtime) + ":" + std::to_string(info.size);
+}
+
 int w_newSource(lua_State *L)
 {
 	Source::Type stype = Source::TYPE_STREAM;
+	std::string cachekey;
 
 	if (!luax_istype(L, 1, love::sound::SoundData::type))
 	{
@@ -58,12 +86,28 @@ int w_newSource(lua_State *L)
 
 			if (stype == Source::TYPE_QUEUE)
 				return luaL_error(L, "Cannot create queueable sources using newSource. Use newQueueableSource instead.");
+
+			if (stype == Source::TYPE_STATIC)
+				cachekey = getSourceCacheKey(L, 1);
+		}
+
+		if (!cachekey.empty())
+		{
+			Source *cached = nullptr;
+			luax_catchexcept(L, [&]() { cached = instance()->newCachedSource(cachekey); });
+
+			if (cached != nullptr)
+			{
+				luax_pushtype(L, cached);
+				cached->release();
+				return 1;
+			}
 		}
 
 		if (love::filesystem::luax_cangetdata(L, 1))
 		{
 			// stream type
-			if (stype == Source::TYPE_STATIC)
+			if (stype == Source::TYPE_STATIC || stype == Source::TYPE_COMPRESSED)
 				lua_pushstring(L, "memory");
 			else if (!lua_isnone(L, 3))
 				lua_pushvalue(L, 3);
@@ -86,7 +130,9 @@ int w_newSource(lua_State *L)
 
 	luax_catchexcept(L, [&]() {
 		if (luax_istype(L, 1, love::sound::SoundData::type))
-			t = instance()->newSource(luax_totype<love::sound::SoundData>(L, 1));
+			t = instance()->newSource(luax_totype<love::sound::SoundData>(L, 1), cachekey);
+		else if (stype == Source::TYPE_COMPRESSED && luax_istype(L, 1, love::sound::Decoder::type))
+			t = instance()->newCompressedSource(luax_totype<love::sound::Decoder>(L, 1));
 		else if (luax_istype(L, 1, love::sound::Decoder::type))
 			t = instance()->newSource(luax_totype<love::sound::Decoder>(L, 1));
 	});
@@ -287,6 +333,53 @@ int w_getVelocity(lua_State *L)
 	return 3;
 }
 
+// Reads count [x,y,z] triplets from a flat table of numbers or a Data object
+// of floats.
+static const float *readVectorList(lua_State *L, int idx, size_t count, std::vector<float> &storage)
+{
+	size_t components = count * 3;
+
+	if (luax_istype(L, idx, love::Data::type))
+	{
+		love::Data *data = love::data::luax_checkdata(L, idx);
+		if (data->getSize() < components * sizeof(float))
+			luaL_error(L, "Data must contain at least %d floats (3 per Source).", (int) components);
+		return (const float *) data->getData();
+	}
+
+	luaL_checktype(L, idx, LUA_TTABLE);
+
+	if (luax_objlen(L, idx) < components)
+		luaL_error(L, "Table must contain at least %d numbers (3 per Source).", (int) components);
+
+	storage.resize(components);
+	for (size_t i = 0; i < components; i++)
+	{
+		lua_rawgeti(L, idx, (int) i + 1);
+		storage[i] = (float) luaL_checknumber(L, -1);
+		lua_pop(L, 1);
+	}
+
+	return storage.data();
+}
+
+int w_setPositions(lua_State *L)
+{
+	luaL_checktype(L, 1, LUA_TTABLE);
+	std::vector<Source*> sources = readSourceList(L, 1);
+
+	std::vector<float> positionStorage;
+	std::vector<float> velocityStorage;
+
+	const float *positions = readVectorList(L, 2, sources.size(), positionStorage);
+	const float *velocities = nullptr;
+	if (!lua_isnoneornil(L, 3))
+		velocities = readVectorList(L, 3, sources.size(), velocityStorage);
+
+	luax_catchexcept(L, [&]() { instance()->setPositions(sources, positions, velocities); });
+	return 0;
+}
+
 int w_setDopplerScale(lua_State *L)
 {
 	instance()->setDopplerScale(luax_checkfloat(L, 1));
@@ -298,6 +391,21 @@ int w_getDopplerScale(lua_State *L)
 	lua_pushnumber(L, instance()->getDopplerScale());
 	return 1;
 }
+
+int w_setSourceCacheLimit(lua_State *L)
+{
+	int64 limit = (int64) luaL_checknumber(L, 1);
+	if (limit < 0)
+		return luaL_error(L, "Source cache limit must not be negative.");
+	instance()->setSourceCacheLimit(limit);
+	return 0;
+}
+
+int w_getSourceCacheLimit(lua_State *L)
+{
+	lua_pushnumber(L, (lua_Number) instance()->getSourceCacheLimit());
+	return 1;
+}
 /*
 int w_setMeter(lua_State *L)
 {
@@ -540,6 +648,101 @@ int w_isEffectsSupported(lua_State *L)
 	return 1;
 }
 
+int w_getEffectStats(lua_State *L)
+{
+	Audio::EffectStats stats = instance()->getEffectStats();
+
+	if (lua_istable(L, 1))
+		lua_pushvalue(L, 1);
+	else
+		lua_createtable(L, 0, 5);
+
+	lua_pushinteger(L, stats.sceneEffects);
+	lua_setfield(L, -2, "sceneeffects");
+
+	lua_pushinteger(L, stats.filters);
+	lua_setfield(L, -2, "filters");
+
+	lua_pushinteger(L, stats.filterUsers);
+	lua_setfield(L, -2, "filterusers");
+
+	lua_pushinteger(L, stats.filterObjects);
+	lua_setfield(L, -2, "filterobjects");
+
+	lua_pushinteger(L, stats.effectObjects);
+	lua_setfield(L, -2, "effectobjects");
+
+	return 1;
+}
+
+int w_getStats(lua_State *L)
+{
+	Audio::Stats stats = instance()->getStats();
+
+	if (lua_istable(L, 1))
+		lua_pushvalue(L, 1);
+	else
+		lua_createtable(L, 0, 10);
+
+	lua_pushinteger(L, stats.activeSources);
+	lua_setfield(L, -2, "activesources");
+
+	lua_pushinteger(L, stats.virtualSources);
+	lua_setfield(L, -2, "virtualsources");
+
+	lua_pushinteger(L, stats.maxSources);
+	lua_setfield(L, -2, "maxsources");
+
+	lua_pushinteger(L, stats.decodingSources);
+	lua_setfield(L, -2, "decodingsources");
+
+	lua_pushinteger(L, stats.decodedChunks);
+	lua_setfield(L, -2, "decodedchunks");
+
+	lua_pushnumber(L, (lua_Number) stats.underruns);
+	lua_setfield(L, -2, "underruns");
+
+	lua_pushnumber(L, stats.updateTime);
+	lua_setfield(L, -2, "updatetime");
+
+	lua_pushnumber(L, stats.maxUpdateTime);
+	lua_setfield(L, -2, "maxupdatetime");
+
+	lua_pushnumber(L, stats.wakeupJitter);
+	lua_setfield(L, -2, "wakeupjitter");
+
+	lua_pushnumber(L, stats.maxWakeupJitter);
+	lua_setfield(L, -2, "maxwakeupjitter");
+
+	return 1;
+}
+
+int w_getOutputLatency(lua_State *L)
+{
+	double latency = instance()->getOutputLatency();
+	if (latency < 0.0)
+		lua_pushnil(L);
+	else
+		lua_pushnumber(L, latency);
+	return 1;
+}
+
+int w_getDeviceTime(lua_State *L)
+{
+	lua_pushnumber(L, instance()->getDeviceTime());
+	return 1;
+}
+
+int w_getOutputPeriodSize(lua_State *L)
+{
+	int period = instance()->getOutputPeriodSize();
+	if (period <= 0)
+		lua_pushnil(L);
+	else
+		lua_pushinteger(L, period);
+	return 1;
+}
+
 int w_setMixWithSystem(lua_State *L)
 {
 	luax_pushboolean(L, Audio::setMixWithSystem(luax_checkboolean(L, 1)));
@@ -609,8 +812,11 @@ static const luaL_Reg functions[] =
 	{ "getOrientation", w_getOrientation },
 	{ "setVelocity", w_setVelocity },
 	{ "getVelocity", w_getVelocity },
+	{ "setPositions", w_setPositions },
 	{ "setDopplerScale", w_setDopplerScale },
 	{ "getDopplerScale", w_getDopplerScale },
+	{ "setSourceCacheLimit", w_setSourceCacheLimit },
+	{ "getSourceCacheLimit", w_getSourceCacheLimit },
 	//{ "setMeter", w_setMeter },
 	//{ "getMeter", w_setMeter },
 	{ "setDistanceModel", w_setDistanceModel },
@@ -622,6 +828,11 @@ static const luaL_Reg functions[] =
 	{ "getMaxSceneEffects", w_getMaxSceneEffects },
 	{ "getMaxSourceEffects", w_getMaxSourceEffects },
 	{ "isEffectsSupported", w_isEffectsSupported },
+	{ "getEffectStats", w_getEffectStats },
+	{ "getStats", w_getStats },
+	{ "getOutputLatency", w_getOutputLatency },
+	{ "getOutputPeriodSize", w_getOutputPeriodSize },
+	{ "getDeviceTime", w_getDeviceTime },
 	{ "setMixWithSystem", w_setMixWithSystem },
 	{ "getPlaybackDevice", w_getPlaybackDevice },
 	{ "getPlaybackDevices", w_getPlaybackDevices },
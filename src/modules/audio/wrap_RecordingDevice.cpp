@@ -79,6 +79,19 @@ int w_RecordingDevice_stop(lua_State *L)
 int w_RecordingDevice_getData(lua_State *L)
 {
 	RecordingDevice *d = luax_checkrecordingdevice(L, 1);
+
+	if (!lua_isnoneornil(L, 2))
+	{
+		love::sound::SoundData *dst = luax_checktype<love::sound::SoundData>(L, 2);
+		int dstStart = (int) luaL_optinteger(L, 3, 0);
+		int count = 0;
+
+		luax_catchexcept(L, [&](){ count = d->getData(dst, dstStart); });
+
+		lua_pushinteger(L, count);
+		return 1;
+	}
+
 	love::sound::SoundData *s = nullptr;
 
 	luax_catchexcept(L, [&](){ s = d->getData(); });
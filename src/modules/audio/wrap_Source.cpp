@@ -67,6 +67,24 @@ int w_Source_pause(lua_State *L)
 	return 0;
 }
 
+int w_Source_playAt(lua_State *L)
+{
+	Source *t = luax_checksource(L, 1);
+	double time = luaL_checknumber(L, 2);
+	bool success = false;
+	luax_catchexcept(L, [&]() { success = t->playAt(time); });
+	luax_pushboolean(L, success);
+	return 1;
+}
+
+int w_Source_stopAt(lua_State *L)
+{
+	Source *t = luax_checksource(L, 1);
+	double time = luaL_checknumber(L, 2);
+	luax_catchexcept(L, [&]() { t->stopAt(time); });
+	return 0;
+}
+
 int w_Source_setPitch(lua_State *L)
 {
 	Source *t = luax_checksource(L, 1);
@@ -268,6 +286,35 @@ int w_Source_isPlaying(lua_State *L)
 	return 1;
 }
 
+int w_Source_isVirtual(lua_State *L)
+{
+	Source *t = luax_checksource(L, 1);
+	luax_pushboolean(L, t->isVirtual());
+	return 1;
+}
+
+int w_Source_getUnderrunCount(lua_State *L)
+{
+	Source *t = luax_checksource(L, 1);
+	lua_pushinteger(L, t->getUnderrunCount());
+	return 1;
+}
+
+int w_Source_setPriority(lua_State *L)
+{
+	Source *t = luax_checksource(L, 1);
+	int priority = (int) luaL_checkinteger(L, 2);
+	t->setPriority(priority);
+	return 0;
+}
+
+int w_Source_getPriority(lua_State *L)
+{
+	Source *t = luax_checksource(L, 1);
+	lua_pushinteger(L, t->getPriority());
+	return 1;
+}
+
 int w_Source_setVolumeLimits(lua_State *L)
 {
 	Source *t = luax_checksource(L, 1);
@@ -562,7 +609,7 @@ int w_Source_queue(lua_State *L)
 			return luaL_error(L, "Data region out of bounds.");
 
 		luax_catchexcept(L, [&]() {
-			success = t->queue((unsigned char *)s->getData() + offset, length,
+			success = t->queue((unsigned char *)s->getReadOnlyData() + offset, length,
 			            s->getSampleRate(), s->getBitDepth(), s->getChannelCount());
 		});
 	}
@@ -608,6 +655,8 @@ static const luaL_Reg w_Source_functions[] =
 	{ "play", w_Source_play },
 	{ "stop", w_Source_stop },
 	{ "pause", w_Source_pause },
+	{ "playAt", w_Source_playAt },
+	{ "stopAt", w_Source_stopAt },
 
 	{ "setPitch", w_Source_setPitch },
 	{ "getPitch", w_Source_getPitch },
@@ -631,6 +680,10 @@ static const luaL_Reg w_Source_functions[] =
 	{ "setLooping", w_Source_setLooping },
 	{ "isLooping", w_Source_isLooping },
 	{ "isPlaying", w_Source_isPlaying },
+	{ "isVirtual", w_Source_isVirtual },
+	{ "getUnderrunCount", w_Source_getUnderrunCount },
+	{ "setPriority", w_Source_setPriority },
+	{ "getPriority", w_Source_getPriority },
 
 	{ "setVolumeLimits", w_Source_setVolumeLimits },
 	{ "getVolumeLimits", w_Source_getVolumeLimits },
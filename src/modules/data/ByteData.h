@@ -21,8 +21,10 @@
 #pragma once
 
 #include "common/Data.h"
+#include "common/Exception.h"
 
 #include <stddef.h>
+#include <atomic>
 
 namespace love
 {
@@ -46,8 +48,54 @@ public:
 	void *getData() const override;
 	size_t getSize() const override;
 
+	/**
+	 * Atomic operations on an integer at the given byte offset, so threads
+	 * sharing this ByteData can cooperate without extra copies. The offset
+	 * must be aligned to the size of T.
+	 **/
+	template <typename T>
+	T atomicLoad(size_t offset) const
+	{
+		return getAtomic<T>(offset)->load();
+	}
+
+	template <typename T>
+	void atomicStore(size_t offset, T value)
+	{
+		getAtomic<T>(offset)->store(value);
+	}
+
+	// Stores the previous value in 'expected' if the exchange fails.
+	template <typename T>
+	bool atomicCompareExchange(size_t offset, T &expected, T desired)
+	{
+		return getAtomic<T>(offset)->compare_exchange_strong(expected, desired);
+	}
+
+	// Returns the previous value.
+	template <typename T>
+	T atomicAdd(size_t offset, T value)
+	{
+		return getAtomic<T>(offset)->fetch_add(value);
+	}
+
 private:
 
+	template <typename T>
+	std::atomic<T> *getAtomic(size_t offset) const
+	{
+		static_assert(sizeof(std::atomic<T>) == sizeof(T) && std::atomic<T>::is_always_lock_free,
+		              "Atomic type must have the same layout as its value type.");
+
+		if (offset > size || size - offset < sizeof(T))
+			throw love::Exception("The given offset doesn't fit within the Data's size.");
+
+		if (((uintptr_t) data + offset) % alignof(std::atomic<T>) != 0)
+			throw love::Exception("Atomic operations require an offset aligned to %d bytes.", (int) alignof(std::atomic<T>));
+
+		return (std::atomic<T> *) (data + offset);
+	}
+
 	void create();
 
 	char *data;
@@ -0,0 +1,255 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "CompressionStream.h"
+#include "common/Exception.h"
+
+// C
+#include <string.h>
+
+// C++
+#include <algorithm>
+#include <limits>
+
+namespace love
+{
+namespace data
+{
+
+love::Type CompressionStream::type("CompressionStream", &Object::type);
+
+// The output buffer grows by at least this much whenever zlib runs out of
+// room.
+static const size_t OUTPUT_CHUNK_SIZE = 16 * 1024;
+
+CompressionStream::CompressionStream(Mode mode, Compressor::Format format, int level)
+	: mode(mode)
+	, format(format)
+	, stream()
+	, outputStart(0)
+	, outputEnd(0)
+	, totalIn(0)
+	, totalOut(0)
+	, finished(false)
+{
+	if (format != Compressor::FORMAT_ZLIB && format != Compressor::FORMAT_GZIP && format != Compressor::FORMAT_DEFLATE)
+		throw love::Exception("Only the zlib, gzip, and deflate formats can be compressed or decompressed as a stream.");
+
+	int err = Z_OK;
+
+	if (mode == MODE_COMPRESS)
+	{
+		if (level < 0)
+			level = Z_DEFAULT_COMPRESSION;
+		else if (level > 9)
+			level = 9;
+
+		int windowbits = 15;
+		if (format == Compressor::FORMAT_GZIP)
+			windowbits += 16; // This tells zlib to use a gzip header.
+		else if (format == Compressor::FORMAT_DEFLATE)
+			windowbits = -windowbits;
+
+		err = deflateInit2(&stream, level, Z_DEFLATED, windowbits, 8, Z_DEFAULT_STRATEGY);
+	}
+	else
+	{
+		// Adding 32 makes zlib auto-detect the header type, like decompress.
+		int windowbits = format == Compressor::FORMAT_DEFLATE ? -15 : 15 + 32;
+		err = inflateInit2(&stream, windowbits);
+	}
+
+	if (err == Z_MEM_ERROR)
+		throw love::Exception("Out of memory.");
+	else if (err != Z_OK)
+		throw love::Exception("Could not create compression stream.");
+}
+
+CompressionStream::~CompressionStream()
+{
+	if (mode == MODE_COMPRESS)
+		deflateEnd(&stream);
+	else
+		inflateEnd(&stream);
+}
+
+CompressionStream::Mode CompressionStream::getMode() const
+{
+	return mode;
+}
+
+Compressor::Format CompressionStream::getFormat() const
+{
+	return format;
+}
+
+int CompressionStream::process(int flush)
+{
+	int err = Z_OK;
+
+	while (true)
+	{
+		// Move pending output to the front instead of growing forever.
+		if (outputStart > 0 && outputStart >= output.size() / 2)
+		{
+			memmove(output.data(), output.data() + outputStart, outputEnd - outputStart);
+			outputEnd -= outputStart;
+			outputStart = 0;
+		}
+
+		if (output.size() - outputEnd < OUTPUT_CHUNK_SIZE)
+			output.resize(std::max(output.size() * 2, outputEnd + OUTPUT_CHUNK_SIZE));
+
+		size_t available = std::min(output.size() - outputEnd, (size_t) std::numeric_limits<uInt>::max());
+
+		stream.next_out = (Bytef *) output.data() + outputEnd;
+		stream.avail_out = (uInt) available;
+
+		if (mode == MODE_COMPRESS)
+			err = deflate(&stream, flush);
+		else
+			err = inflate(&stream, flush);
+
+		size_t produced = available - stream.avail_out;
+		outputEnd += produced;
+		totalOut += produced;
+
+		if (err == Z_STREAM_END)
+			return err;
+
+		if (err == Z_BUF_ERROR && produced == 0)
+			return Z_OK; // No progress was possible, which isn't an error.
+
+		if (err != Z_OK)
+			return err;
+
+		// zlib only stops short of filling the output buffer when it has
+		// nothing more to give.
+		if (stream.avail_out != 0 && stream.avail_in == 0)
+			return err;
+	}
+}
+
+void CompressionStream::push(const void *data, size_t size)
+{
+	if (finished)
+	{
+		if (mode == MODE_COMPRESS)
+			throw love::Exception("Cannot push data into a finished compression stream.");
+		else if (size > 0)
+			throw love::Exception("Unexpected data after the end of the compressed stream.");
+	}
+
+	const Bytef *bytes = (const Bytef *) data;
+
+	while (size > 0)
+	{
+		size_t chunk = std::min(size, (size_t) std::numeric_limits<uInt>::max());
+
+		stream.next_in = (Bytef *) bytes;
+		stream.avail_in = (uInt) chunk;
+
+		int err = process(Z_NO_FLUSH);
+
+		size_t consumed = chunk - stream.avail_in;
+		totalIn += consumed;
+		bytes += consumed;
+		size -= consumed;
+
+		if (err == Z_STREAM_END)
+		{
+			finished = true;
+			if (size > 0)
+				throw love::Exception("Unexpected data after the end of the compressed stream.");
+		}
+		else if (err == Z_MEM_ERROR)
+			throw love::Exception("Out of memory.");
+		else if (err != Z_OK)
+		{
+			if (mode == MODE_COMPRESS)
+				throw love::Exception("Could not compress data.");
+			else
+				throw love::Exception("Could not decompress data: %s", stream.msg != nullptr ? stream.msg : "invalid compressed data");
+		}
+	}
+
+	stream.next_in = nullptr;
+	stream.avail_in = 0;
+}
+
+void CompressionStream::flush()
+{
+	if (mode != MODE_COMPRESS || finished)
+		return;
+
+	if (process(Z_SYNC_FLUSH) != Z_OK)
+		throw love::Exception("Could not compress data.");
+}
+
+void CompressionStream::finish()
+{
+	if (finished)
+		return;
+
+	if (mode == MODE_DECOMPRESS)
+		throw love::Exception("Could not decompress data: the compressed stream ended unexpectedly.");
+
+	if (process(Z_FINISH) != Z_STREAM_END)
+		throw love::Exception("Could not compress data.");
+
+	finished = true;
+}
+
+bool CompressionStream::isFinished() const
+{
+	return finished;
+}
+
+size_t CompressionStream::getPendingSize() const
+{
+	return outputEnd - outputStart;
+}
+
+size_t CompressionStream::pull(void *dst, size_t size)
+{
+	size = std::min(size, getPendingSize());
+
+	memcpy(dst, output.data() + outputStart, size);
+	outputStart += size;
+
+	if (outputStart == outputEnd)
+		outputStart = outputEnd = 0;
+
+	return size;
+}
+
+size_t CompressionStream::getTotalIn() const
+{
+	return totalIn;
+}
+
+size_t CompressionStream::getTotalOut() const
+{
+	return totalOut;
+}
+
+} // data
+} // love
@@ -0,0 +1,124 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/Object.h"
+#include "Compressor.h"
+
+// zlib
+#include <zlib.h>
+
+// C++
+#include <vector>
+
+namespace love
+{
+namespace data
+{
+
+/**
+ * Compresses or decompresses data incrementally. Input is pushed in as it
+ * becomes available, and the output produced so far can be pulled out at
+ * any time without waiting for the whole stream.
+ **/
+class CompressionStream : public love::Object
+{
+public:
+
+	static love::Type type;
+
+	enum Mode
+	{
+		MODE_COMPRESS,
+		MODE_DECOMPRESS,
+	};
+
+	/**
+	 * @param level The amount of compression to apply (between 0 and 9.) A
+	 *        value of -1 indicates the default. Ignored when decompressing.
+	 **/
+	CompressionStream(Mode mode, Compressor::Format format, int level = -1);
+	virtual ~CompressionStream();
+
+	Mode getMode() const;
+	Compressor::Format getFormat() const;
+
+	/**
+	 * Processes more input. Output becomes available to pull as it's produced.
+	 **/
+	void push(const void *data, size_t size);
+
+	/**
+	 * When compressing, makes all input pushed so far decodable from the
+	 * output, for example at the end of a network packet. Flushing often
+	 * makes the compression worse.
+	 **/
+	void flush();
+
+	/**
+	 * Ends the stream. When decompressing, throws if the compressed stream
+	 * didn't end.
+	 **/
+	void finish();
+
+	/**
+	 * Whether the end of the stream was reached (compressing: finish was
+	 * called, decompressing: the end of the compressed data was seen.)
+	 **/
+	bool isFinished() const;
+
+	// Gets the number of output bytes waiting to be pulled.
+	size_t getPendingSize() const;
+
+	/**
+	 * Copies up to size bytes of the pending output to dst and removes them
+	 * from the stream.
+	 * @return The number of bytes copied.
+	 **/
+	size_t pull(void *dst, size_t size);
+
+	size_t getTotalIn() const;
+	size_t getTotalOut() const;
+
+private:
+
+	// Runs zlib until it stops producing output, returning its last status.
+	int process(int flush);
+
+	Mode mode;
+	Compressor::Format format;
+
+	z_stream stream;
+
+	std::vector<char> output;
+	size_t outputStart;
+	size_t outputEnd;
+
+	size_t totalIn;
+	size_t totalOut;
+
+	bool finished;
+
+}; // CompressionStream
+
+} // data
+} // love
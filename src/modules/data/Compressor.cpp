@@ -23,17 +23,173 @@
 #include "common/config.h"
 #include "common/int.h"
 #include "common/Exception.h"
+#include "thread/threads.h"
 
 #include "libraries/lz4/lz4.h"
 #include "libraries/lz4/lz4hc.h"
 
 #include <zlib.h>
 
+#ifdef LOVE_SUPPORT_ZSTD
+#include <zstd.h>
+#include <zdict.h>
+#endif
+
+// C++
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <thread>
+#include <vector>
+
 namespace love
 {
 namespace data
 {
 
+namespace
+{
+
+// Inputs larger than this are split into independently compressed LZ4 blocks,
+// which are compressed and decompressed in parallel.
+const size_t LZ4_BLOCK_SIZE = 4 * 1024 * 1024;
+
+// Marks the block layout. The original single block layout stores the
+// uncompressed size as its header, which can never be this large.
+const uint32 LZ4_BLOCKS_MAGIC = 0xB10C4C5A;
+
+// magic, block size, uncompressed size (64 bit), block count.
+const size_t LZ4_BLOCKS_HEADER_SIZE = sizeof(uint32) * 3 + sizeof(uint64);
+
+const unsigned int MAX_BLOCK_THREADS = 16;
+
+inline void writeLE32(char *dst, uint32 v)
+{
+#ifdef LOVE_BIG_ENDIAN
+	v = swapuint32(v);
+#endif
+	memcpy(dst, &v, sizeof(uint32));
+}
+
+inline uint32 readLE32(const char *src)
+{
+	uint32 v;
+	memcpy(&v, src, sizeof(uint32));
+#ifdef LOVE_BIG_ENDIAN
+	v = swapuint32(v);
+#endif
+	return v;
+}
+
+inline void writeLE64(char *dst, uint64 v)
+{
+	writeLE32(dst, (uint32) (v & 0xFFFFFFFF));
+	writeLE32(dst + sizeof(uint32), (uint32) (v >> 32));
+}
+
+inline uint64 readLE64(const char *src)
+{
+	return (uint64) readLE32(src) | ((uint64) readLE32(src + sizeof(uint32)) << 32);
+}
+
+struct BlockJob
+{
+	const std::function<void(size_t)> *func = nullptr;
+	size_t count = 0;
+	std::atomic<size_t> next {0};
+
+	love::thread::MutexRef mutex;
+	std::string error;
+	std::atomic<bool> failed {false};
+
+	void process()
+	{
+		while (!failed)
+		{
+			size_t i = next++;
+			if (i >= count)
+				break;
+
+			try
+			{
+				(*func)(i);
+			}
+			catch (std::exception &e)
+			{
+				love::thread::Lock lock(mutex);
+				if (!failed)
+					error = e.what();
+				failed = true;
+			}
+		}
+	}
+};
+
+class BlockWorker : public love::thread::Threadable
+{
+public:
+
+	BlockWorker(BlockJob *job)
+		: job(job)
+	{
+		threadName = "LZ4BlockWorker";
+	}
+
+	void threadFunction() override
+	{
+		job->process();
+	}
+
+private:
+
+	BlockJob *job;
+};
+
+// Calls func for each block index, spread across the cpu's cores. Blocks are
+// multiple megabytes, so starting the threads per call costs little next to
+// the work itself.
+void parallelBlocks(size_t count, const std::function<void(size_t)> &func)
+{
+	unsigned int threads = std::min(std::thread::hardware_concurrency(), MAX_BLOCK_THREADS);
+	if (count < (size_t) threads)
+		threads = (unsigned int) count;
+
+	if (threads < 2)
+	{
+		for (size_t i = 0; i < count; i++)
+			func(i);
+		return;
+	}
+
+	BlockJob job;
+	job.func = &func;
+	job.count = count;
+
+	std::vector<BlockWorker *> workers;
+	for (unsigned int i = 0; i < threads - 1; i++)
+	{
+		BlockWorker *worker = new BlockWorker(&job);
+		if (worker->start())
+			workers.push_back(worker);
+		else
+			worker->release();
+	}
+
+	job.process();
+
+	for (BlockWorker *worker : workers)
+	{
+		worker->wait();
+		worker->release();
+	}
+
+	if (job.failed)
+		throw love::Exception("%s", job.error.c_str());
+}
+
+} // anonymous namespace
+
 class LZ4Compressor : public Compressor
 {
 public:
@@ -43,8 +199,8 @@ public:
 		if (format != FORMAT_LZ4)
 			throw love::Exception("Invalid format (expecting LZ4)");
 
-		if (dataSize > LZ4_MAX_INPUT_SIZE)
-			throw love::Exception("Data is too large for LZ4 compressor.");
+		if (dataSize > LZ4_BLOCK_SIZE)
+			return compressBlocks(data, dataSize, level, compressedSize);
 
 		// We use a custom header to store some info with the compressed data.
 		const size_t headersize = sizeof(uint32);
@@ -63,19 +219,9 @@ public:
 		}
 
 		// Store the size of the uncompressed data as a header.
-#ifdef LOVE_BIG_ENDIAN
-		// Make sure it's little-endian for storage.
-		*(uint32 *) compressedbytes = swapuint32((uint32) dataSize);
-#else
-		*(uint32 *) compressedbytes = (uint32) dataSize;
-#endif
+		writeLE32(compressedbytes, (uint32) dataSize);
 
-		// Use LZ4-HC for compression level 9 and higher.
-		int csize = 0;
-		if (level > 8)
-			csize = LZ4_compress_HC(data, compressedbytes + headersize, (int) dataSize, maxdestsize, LZ4HC_CLEVEL_DEFAULT);
-		else
-			csize = LZ4_compress_default(data, compressedbytes + headersize, (int) dataSize, maxdestsize);
+		int csize = compressBlock(data, compressedbytes + headersize, (int) dataSize, maxdestsize, level);
 
 		if (csize <= 0)
 		{
@@ -83,22 +229,8 @@ public:
 			throw love::Exception("Could not LZ4-compress data.");
 		}
 
-		// We allocated space for the maximum possible amount of data, but the
-		// actual compressed size might be much smaller, so we should shrink the
-		// data buffer if so.
-		if ((double) maxsize / (double) (csize + headersize) >= 1.2)
-		{
-			char *cbytes = new (std::nothrow) char[csize + headersize];
-			if (cbytes)
-			{
-				memcpy(cbytes, compressedbytes, csize + headersize);
-				delete[] compressedbytes;
-				compressedbytes = cbytes;
-			}
-		}
-
 		compressedSize = (size_t) csize + headersize;
-		return compressedbytes;
+		return shrink(compressedbytes, maxsize, compressedSize);
 	}
 
 	char *decompress(Format format, const char *data, size_t dataSize, size_t &decompressedSize) override
@@ -113,12 +245,10 @@ public:
 			throw love::Exception("Invalid LZ4-compressed data size.");
 
 		// Extract the original uncompressed size (stored in our custom header.)
-#ifdef LOVE_BIG_ENDIAN
-		// Convert from stored little-endian to big-endian.
-		uint32 rawsize = swapuint32(*(uint32 *) data);
-#else
-		uint32 rawsize = *(uint32 *) data;
-#endif
+		uint32 rawsize = readLE32(data);
+
+		if (rawsize == LZ4_BLOCKS_MAGIC)
+			return decompressBlocks(data, dataSize, decompressedSize);
 
 		try
 		{
@@ -164,6 +294,169 @@ public:
 		return format == FORMAT_LZ4;
 	}
 
+private:
+
+	// Use LZ4-HC for compression level 9 and higher. Levels above 9 map to
+	// the slower HC levels, up to LZ4HC_CLEVEL_MAX.
+	static int compressBlock(const char *src, char *dst, int srcsize, int dstcapacity, int level)
+	{
+		if (level > 8)
+			return LZ4_compress_HC(src, dst, srcsize, dstcapacity, std::min(level, LZ4HC_CLEVEL_MAX));
+		else
+			return LZ4_compress_default(src, dst, srcsize, dstcapacity);
+	}
+
+	// We allocate space for the maximum possible amount of data, but the
+	// actual compressed size might be much smaller, so we should shrink the
+	// data buffer if so.
+	static char *shrink(char *bytes, size_t allocsize, size_t size)
+	{
+		if ((double) allocsize / (double) size >= 1.2)
+		{
+			char *shrunk = new (std::nothrow) char[size];
+			if (shrunk)
+			{
+				memcpy(shrunk, bytes, size);
+				delete[] bytes;
+				bytes = shrunk;
+			}
+		}
+
+		return bytes;
+	}
+
+	// Layout: the block header, the compressed size of each block, and then
+	// the blocks themselves. Every block is LZ4_BLOCK_SIZE bytes uncompressed
+	// except possibly the last.
+	char *compressBlocks(const char *data, size_t dataSize, int level, size_t &compressedSize)
+	{
+		size_t blockcount = (dataSize + LZ4_BLOCK_SIZE - 1) / LZ4_BLOCK_SIZE;
+
+		if (blockcount > (size_t) std::numeric_limits<uint32>::max())
+			throw love::Exception("Data is too large for LZ4 compressor.");
+
+		size_t headersize = LZ4_BLOCKS_HEADER_SIZE + blockcount * sizeof(uint32);
+		size_t blockbound = (size_t) LZ4_compressBound((int) LZ4_BLOCK_SIZE);
+		size_t maxsize = headersize + blockcount * blockbound;
+		char *compressedbytes = nullptr;
+
+		try
+		{
+			compressedbytes = new char[maxsize];
+		}
+		catch (std::bad_alloc &)
+		{
+			throw love::Exception("Out of memory.");
+		}
+
+		writeLE32(compressedbytes, LZ4_BLOCKS_MAGIC);
+		writeLE32(compressedbytes + 4, (uint32) LZ4_BLOCK_SIZE);
+		writeLE64(compressedbytes + 8, (uint64) dataSize);
+		writeLE32(compressedbytes + 16, (uint32) blockcount);
+
+		std::vector<int> blocksizes(blockcount);
+
+		// Each block gets a worst-case sized slot, they're packed together
+		// afterward.
+		auto compressfunc = [&](size_t i)
+		{
+			size_t offset = i * LZ4_BLOCK_SIZE;
+			int size = (int) std::min(LZ4_BLOCK_SIZE, dataSize - offset);
+			char *dst = compressedbytes + headersize + i * blockbound;
+
+			blocksizes[i] = compressBlock(data + offset, dst, size, (int) blockbound, level);
+			if (blocksizes[i] <= 0)
+				throw love::Exception("Could not LZ4-compress data.");
+		};
+
+		try
+		{
+			parallelBlocks(blockcount, compressfunc);
+		}
+		catch (love::Exception &)
+		{
+			delete[] compressedbytes;
+			throw;
+		}
+
+		size_t size = headersize;
+		for (size_t i = 0; i < blockcount; i++)
+		{
+			writeLE32(compressedbytes + LZ4_BLOCKS_HEADER_SIZE + i * sizeof(uint32), (uint32) blocksizes[i]);
+			memmove(compressedbytes + size, compressedbytes + headersize + i * blockbound, blocksizes[i]);
+			size += (size_t) blocksizes[i];
+		}
+
+		compressedSize = size;
+		return shrink(compressedbytes, maxsize, compressedSize);
+	}
+
+	char *decompressBlocks(const char *data, size_t dataSize, size_t &decompressedSize)
+	{
+		if (dataSize < LZ4_BLOCKS_HEADER_SIZE)
+			throw love::Exception("Invalid LZ4-compressed data size.");
+
+		size_t blocksize = readLE32(data + 4);
+		uint64 rawsize = readLE64(data + 8);
+		size_t blockcount = readLE32(data + 16);
+
+		if (blocksize == 0 || blocksize > LZ4_MAX_INPUT_SIZE || rawsize > (uint64) std::numeric_limits<size_t>::max()
+			|| (uint64) blockcount != (rawsize + blocksize - 1) / blocksize)
+			throw love::Exception("Invalid LZ4-compressed data header.");
+
+		size_t headersize = LZ4_BLOCKS_HEADER_SIZE + blockcount * sizeof(uint32);
+		if (dataSize < headersize)
+			throw love::Exception("Invalid LZ4-compressed data size.");
+
+		std::vector<size_t> offsets(blockcount);
+		size_t offset = headersize;
+
+		for (size_t i = 0; i < blockcount; i++)
+		{
+			size_t size = readLE32(data + LZ4_BLOCKS_HEADER_SIZE + i * sizeof(uint32));
+			if (size > dataSize - offset)
+				throw love::Exception("Invalid LZ4-compressed data size.");
+
+			offsets[i] = offset;
+			offset += size;
+		}
+
+		char *rawbytes = nullptr;
+
+		try
+		{
+			rawbytes = new char[(size_t) rawsize];
+		}
+		catch (std::bad_alloc &)
+		{
+			throw love::Exception("Out of memory.");
+		}
+
+		auto decompressfunc = [&](size_t i)
+		{
+			size_t srcsize = (i + 1 < blockcount ? offsets[i + 1] : offset) - offsets[i];
+			size_t dstoffset = i * blocksize;
+			int expected = (int) std::min(blocksize, (size_t) rawsize - dstoffset);
+
+			int result = LZ4_decompress_safe(data + offsets[i], rawbytes + dstoffset, (int) srcsize, expected);
+			if (result != expected)
+				throw love::Exception("Could not decompress LZ4-compressed data.");
+		};
+
+		try
+		{
+			parallelBlocks(blockcount, decompressfunc);
+		}
+		catch (love::Exception &)
+		{
+			delete[] rawbytes;
+			throw;
+		}
+
+		decompressedSize = (size_t) rawsize;
+		return rawbytes;
+	}
+
 }; // LZ4Compressor
 
 
@@ -171,9 +464,9 @@ class zlibCompressor : public Compressor
 {
 private:
 
-	// The following three functions are mostly copied from the zlib source
-	// (compressBound, compress2, and uncompress), but modified to support both
-	// zlib and gzip.
+	// The following two functions are mostly copied from the zlib source
+	// (compressBound and compress2), but modified to support both zlib and
+	// gzip.
 
 	uLong zlibCompressBound(Format format, uLong sourceLen)
 	{
@@ -220,42 +513,6 @@ private:
 		return deflateEnd(&stream);
 	}
 
-	int zlibDecompress(Format format, Bytef *dest, uLongf *destLen, const Bytef *source, uLong sourceLen)
-	{
-		z_stream stream = {};
-
-		stream.next_in = (Bytef *) source;
-		stream.avail_in = (uInt) sourceLen;
-
-		stream.next_out = dest;
-		stream.avail_out = (uInt) (*destLen);
-
-		// 15 is the default. Adding 32 makes zlib auto-detect the header type.
-		int windowbits = 15 + 32;
-
-		if (format == FORMAT_DEFLATE)
-			windowbits = -15;
-
-		int err = inflateInit2(&stream, windowbits);
-
-		if (err != Z_OK)
-			return err;
-
-		err = inflate(&stream, Z_FINISH);
-
-		if (err != Z_STREAM_END)
-		{
-			inflateEnd(&stream);
-			if (err == Z_NEED_DICT || (err == Z_BUF_ERROR && stream.avail_in == 0))
-				return Z_DATA_ERROR;
-			return err;
-		}
-
-		*destLen = stream.total_out;
-
-		return inflateEnd(&stream);
-	}
-
 public:
 
 	char *compress(Format format, const char *data, size_t dataSize, int level, size_t &compressedSize) override
@@ -312,44 +569,89 @@ public:
 		if (!isSupported(format))
 			throw love::Exception("Invalid format (expecting zlib or gzip)");
 
-		char *rawbytes = nullptr;
-
 		// We might know the output size before decompression. If not, we guess.
-		size_t rawsize = decompressedSize > 0 ? decompressedSize : dataSize * 2;
+		// gzip stores the original size (modulo 2^32) at the end of the data.
+		size_t rawsize = decompressedSize;
+
+		if (rawsize == 0 && format != FORMAT_DEFLATE && dataSize >= 18
+			&& (uint8) data[0] == 0x1F && (uint8) data[1] == 0x8B)
+		{
+			const uint8 *isize = (const uint8 *) data + dataSize - 4;
+			rawsize = (size_t) isize[0] | ((size_t) isize[1] << 8) | ((size_t) isize[2] << 16) | ((size_t) isize[3] << 24);
+
+			// Deflate can't do better than about 1032:1, so a larger size
+			// means the data is corrupt.
+			rawsize = std::min(rawsize, dataSize * 1032);
+		}
+
+		if (rawsize == 0)
+			rawsize = std::max(dataSize * 2, (size_t) 64);
+
+		z_stream stream = {};
+
+		stream.next_in = (Bytef *) data;
+		stream.avail_in = (uInt) dataSize;
+
+		// 15 is the default. Adding 32 makes zlib auto-detect the header type.
+		int windowbits = format == FORMAT_DEFLATE ? -15 : 15 + 32;
+
+		if (inflateInit2(&stream, windowbits) != Z_OK)
+			throw love::Exception("Could not decompress zlib/gzip-compressed data.");
+
+		char *rawbytes = nullptr;
+		size_t offset = 0;
 
-		// Repeatedly try to decompress with an increasingly large output buffer.
+		// Inflate into an output buffer which grows when it runs out of room,
+		// rather than starting over with a bigger one.
 		while (true)
 		{
-			try
+			char *newbytes = new (std::nothrow) char[rawsize];
+			if (newbytes == nullptr)
 			{
-				rawbytes = new char[rawsize];
+				delete[] rawbytes;
+				inflateEnd(&stream);
+				throw love::Exception("Out of memory.");
 			}
-			catch (std::bad_alloc &)
+
+			if (rawbytes != nullptr)
 			{
-				throw love::Exception("Out of memory.");
+				memcpy(newbytes, rawbytes, offset);
+				delete[] rawbytes;
 			}
 
-			uLongf destLen = (uLongf) rawsize;
-			int status = zlibDecompress(format, (Bytef *) rawbytes, &destLen, (const Bytef *) data, (uLong) dataSize);
+			rawbytes = newbytes;
 
-			if (status == Z_OK)
-			{
-				decompressedSize = (size_t) destLen;
+			stream.next_out = (Bytef *) rawbytes + offset;
+			stream.avail_out = (uInt) (rawsize - offset);
+
+			int status = inflate(&stream, Z_FINISH);
+			offset = (size_t) stream.total_out;
+
+			if (status == Z_STREAM_END)
 				break;
+
+			if (status != Z_BUF_ERROR && status != Z_OK)
+			{
+				delete[] rawbytes;
+				inflateEnd(&stream);
+				throw love::Exception("Could not decompress zlib/gzip-compressed data.");
 			}
-			else if (status != Z_BUF_ERROR)
+
+			if (stream.avail_out != 0)
 			{
-				// For any error other than "not enough room", throw an exception.
+				// The input ended before the compressed stream did.
 				delete[] rawbytes;
+				inflateEnd(&stream);
 				throw love::Exception("Could not decompress zlib/gzip-compressed data.");
 			}
 
-			// Not enough room in the output buffer: try again with a larger size.
-			delete[] rawbytes;
 			rawsize *= 2;
 		}
 
-		return rawbytes;
+		inflateEnd(&stream);
+
+		decompressedSize = offset;
+				return rawbytes;
 	}
 
 	bool isSupported(Format format) const override
@@ -359,12 +661,264 @@ public:
 
 }; // zlibCompressor
 
+#ifdef LOVE_SUPPORT_ZSTD
+
+class ZstdCompressor : public Compressor
+{
+private:
+
+	// Maps our 0-9 levels onto Zstandard's 1-19.
+	static int getZstdLevel(int level)
+	{
+		if (level < 0)
+			return ZSTD_CLEVEL_DEFAULT;
+
+		return 1 + std::min(level, 9) * 2;
+	}
+
+public:
+
+	char *compress(Format format, const char *data, size_t dataSize, int level, size_t &compressedSize) override
+	{
+		return compress(format, data, dataSize, level, nullptr, 0, compressedSize);
+	}
+
+	char *compress(Format format, const char *data, size_t dataSize, int level, const char *dictionary, size_t dictionarySize, size_t &compressedSize) override
+	{
+		if (format != FORMAT_ZSTD)
+			throw love::Exception("Invalid format (expecting Zstandard)");
+
+		ZSTD_CCtx *cctx = ZSTD_createCCtx();
+		if (cctx == nullptr)
+			throw love::Exception("Out of memory.");
+
+		ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel, getZstdLevel(level));
+
+		if (dictionarySize > 0 && ZSTD_isError(ZSTD_CCtx_loadDictionary(cctx, dictionary, dictionarySize)))
+		{
+			ZSTD_freeCCtx(cctx);
+			throw love::Exception("Invalid Zstandard dictionary.");
+		}
+
+		size_t maxsize = ZSTD_compressBound(dataSize);
+		char *compressedbytes = new (std::nothrow) char[maxsize];
+
+		if (compressedbytes == nullptr)
+		{
+			ZSTD_freeCCtx(cctx);
+			throw love::Exception("Out of memory.");
+		}
+
+		// The frame header stores the uncompressed size, so decompression
+		// doesn't have to guess.
+		size_t csize = ZSTD_compress2(cctx, compressedbytes, maxsize, data, dataSize);
+		ZSTD_freeCCtx(cctx);
+
+		if (ZSTD_isError(csize))
+		{
+			delete[] compressedbytes;
+			throw love::Exception("Could not Zstandard-compress data: %s", ZSTD_getErrorName(csize));
+		}
+
+		// We allocated space for the maximum possible amount of data, but the
+		// actual compressed size might be much smaller, so we should shrink the
+		// data buffer if so.
+		if ((double) maxsize / (double) csize >= 1.2)
+		{
+			char *cbytes = new (std::nothrow) char[csize];
+			if (cbytes)
+			{
+				memcpy(cbytes, compressedbytes, csize);
+				delete[] compressedbytes;
+				compressedbytes = cbytes;
+			}
+		}
+
+		compressedSize = csize;
+		return compressedbytes;
+	}
+
+	char *decompress(Format format, const char *data, size_t dataSize, size_t &decompressedSize) override
+	{
+		return decompress(format, data, dataSize, nullptr, 0, decompressedSize);
+	}
+
+	char *decompress(Format format, const char *data, size_t dataSize, const char *dictionary, size_t dictionarySize, size_t &decompressedSize) override
+	{
+		if (format != FORMAT_ZSTD)
+			throw love::Exception("Invalid format (expecting Zstandard)");
+
+		unsigned long long framesize = ZSTD_getFrameContentSize(data, dataSize);
+
+		if (framesize == ZSTD_CONTENTSIZE_ERROR)
+			throw love::Exception("Could not decompress Zstandard-compressed data.");
+
+		ZSTD_DCtx *dctx = ZSTD_createDCtx();
+		if (dctx == nullptr)
+			throw love::Exception("Out of memory.");
+
+		if (dictionarySize > 0 && ZSTD_isError(ZSTD_DCtx_loadDictionary(dctx, dictionary, dictionarySize)))
+		{
+			ZSTD_freeDCtx(dctx);
+			throw love::Exception("Invalid Zstandard dictionary.");
+		}
+
+		// Frames written by streaming compressors might not store their size.
+		size_t rawsize = 0;
+		if (framesize != ZSTD_CONTENTSIZE_UNKNOWN)
+			rawsize = (size_t) framesize;
+		else if (decompressedSize > 0)
+			rawsize = decompressedSize;
+		else
+			rawsize = std::max(dataSize * 4, (size_t) 64);
+
+		// Zero-sized frames still need a valid pointer.
+		rawsize = std::max(rawsize, (size_t) 1);
+
+		char *rawbytes = new (std::nothrow) char[rawsize];
+		if (rawbytes == nullptr)
+		{
+			ZSTD_freeDCtx(dctx);
+			throw love::Exception("Out of memory.");
+		}
+
+		ZSTD_inBuffer input = {data, dataSize, 0};
+		size_t offset = 0;
+
+		while (true)
+		{
+			ZSTD_outBuffer output = {rawbytes, rawsize, offset};
+			size_t result = ZSTD_decompressStream(dctx, &output, &input);
+			offset = output.pos;
+
+			if (ZSTD_isError(result))
+			{
+				delete[] rawbytes;
+				ZSTD_freeDCtx(dctx);
+				throw love::Exception("Could not decompress Zstandard-compressed data: %s", ZSTD_getErrorName(result));
+			}
+
+			if (result == 0 && input.pos == input.size)
+				break;
+
+			if (offset < rawsize)
+			{
+				if (input.pos == input.size)
+				{
+					delete[] rawbytes;
+					ZSTD_freeDCtx(dctx);
+					throw love::Exception("Could not decompress Zstandard-compressed data: unexpected end of data.");
+				}
+
+				continue;
+			}
+
+			// Out of room: grow the output and keep going.
+			char *newbytes = new (std::nothrow) char[rawsize * 2];
+			if (newbytes == nullptr)
+			{
+				delete[] rawbytes;
+				ZSTD_freeDCtx(dctx);
+				throw love::Exception("Out of memory.");
+			}
+
+			memcpy(newbytes, rawbytes, offset);
+			delete[] rawbytes;
+			rawbytes = newbytes;
+			rawsize *= 2;
+		}
+
+		ZSTD_freeDCtx(dctx);
+
+		decompressedSize = offset;
+		return rawbytes;
+	}
+
+	bool isSupported(Format format) const override
+	{
+		return format == FORMAT_ZSTD;
+	}
+
+}; // ZstdCompressor
+
+#endif // LOVE_SUPPORT_ZSTD
+
+char *Compressor::compress(Format format, const char *data, size_t dataSize, int level, const char *dictionary, size_t dictionarySize, size_t &compressedSize)
+{
+	if (dictionary != nullptr && dictionarySize > 0)
+		throw love::Exception("Compression dictionaries are only supported by the Zstandard format.");
+
+	return compress(format, data, dataSize, level, compressedSize);
+}
+
+char *Compressor::decompress(Format format, const char *data, size_t dataSize, const char *dictionary, size_t dictionarySize, size_t &decompressedSize)
+{
+	if (dictionary != nullptr && dictionarySize > 0)
+		throw love::Exception("Compression dictionaries are only supported by the Zstandard format.");
+
+	return decompress(format, data, dataSize, decompressedSize);
+}
+
+char *Compressor::trainDictionary(Format format, const std::vector<std::string> &samples, size_t maxSize, size_t &dictionarySize)
+{
+	if (format != FORMAT_ZSTD)
+		throw love::Exception("Compression dictionaries are only supported by the Zstandard format.");
+
+#ifdef LOVE_SUPPORT_ZSTD
+	std::string buffer;
+	std::vector<size_t> sizes;
+
+	for (const std::string &sample : samples)
+	{
+		buffer += sample;
+		sizes.push_back(sample.size());
+	}
+
+	char *dictionary = nullptr;
+
+	try
+	{
+		dictionary = new char[maxSize];
+	}
+	catch (std::bad_alloc &)
+	{
+		throw love::Exception("Out of memory.");
+	}
+
+	size_t result = ZDICT_trainFromBuffer(dictionary, maxSize, buffer.data(), sizes.data(), (unsigned) sizes.size());
+
+	if (ZDICT_isError(result))
+	{
+		delete[] dictionary;
+		throw love::Exception("Could not create compression dictionary: %s", ZDICT_getErrorName(result));
+	}
+
+	dictionarySize = result;
+	return dictionary;
+#else
+	LOVE_UNUSED(samples);
+	LOVE_UNUSED(maxSize);
+	LOVE_UNUSED(dictionarySize);
+	throw love::Exception("Zstandard compression is not supported (LOVE was built without Zstandard support).");
+#endif
+}
+
 Compressor *Compressor::getCompressor(Format format)
 {
 	static LZ4Compressor lz4compressor;
 	static zlibCompressor zlibcompressor;
+#ifdef LOVE_SUPPORT_ZSTD
+	static ZstdCompressor zstdcompressor;
+#endif
 
-	Compressor *compressors[] = {&lz4compressor, &zlibcompressor};
+	Compressor *compressors[] =
+	{
+		&lz4compressor,
+		&zlibcompressor,
+#ifdef LOVE_SUPPORT_ZSTD
+		&zstdcompressor,
+#endif
+	};
 
 	for (Compressor *c : compressors)
 	{
@@ -396,6 +950,7 @@ StringMap<Compressor::Format, Compressor::FORMAT_MAX_ENUM>::Entry Compressor::fo
 	{ "zlib",    FORMAT_ZLIB    },
 	{ "gzip",    FORMAT_GZIP    },
 	{ "deflate", FORMAT_DEFLATE },
+	{ "zstd",    FORMAT_ZSTD    },
 };
 
 StringMap<Compressor::Format, Compressor::FORMAT_MAX_ENUM> Compressor::formatNames(Compressor::formatEntries, sizeof(Compressor::formatEntries));
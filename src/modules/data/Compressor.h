@@ -41,6 +41,7 @@ public:
 		FORMAT_ZLIB,
 		FORMAT_GZIP,
 		FORMAT_DEFLATE,
+		FORMAT_ZSTD,
 		FORMAT_MAX_ENUM
 	};
 
@@ -81,11 +82,32 @@ public:
 	 **/
 	virtual char *decompress(Format format, const char *data, size_t dataSize, size_t &decompressedSize) = 0;
 
+	/**
+	 * Variants of compress and decompress which use a dictionary of data
+	 * shared by both sides, for formats which support it. Small inputs
+	 * similar to the dictionary compress much better with one. The default
+	 * implementations throw if a dictionary is given.
+	 **/
+	virtual char *compress(Format format, const char *data, size_t dataSize, int level, const char *dictionary, size_t dictionarySize, size_t &compressedSize);
+	virtual char *decompress(Format format, const char *data, size_t dataSize, const char *dictionary, size_t dictionarySize, size_t &decompressedSize);
+
 	/**
 	 * Gets whether a specific format is supported by this backend.
 	 **/
 	virtual bool isSupported(Format format) const = 0;
 
+	/**
+	 * Creates a dictionary for the given format from samples of typical data.
+	 *
+	 * @param[in] format The format the dictionary will be used with.
+	 * @param[in] samples The sample inputs.
+	 * @param[in] maxSize The maximum size in bytes of the dictionary.
+	 * @param[out] dictionarySize The size in bytes of the dictionary.
+	 *
+	 * @return The dictionary (allocated with new[]).
+	 **/
+	static char *trainDictionary(Format format, const std::vector<std::string> &samples, size_t maxSize, size_t &dictionarySize);
+
 	static bool getConstant(const char *in, Format &out);
 	static bool getConstant(Format in, const char *&out);
 	static std::vector<std::string> getConstants(Format);
@@ -29,11 +29,63 @@
 #include <list>
 #include <iostream>
 
+#if defined(LOVE_SIMD_SSE) && (defined(__SSE2__) || defined(_M_AMD64) || defined(_M_X64))
+#define LOVE_DATA_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(LOVE_SIMD_NEON)
+#include <arm_neon.h>
+#endif
+
 namespace
 {
 
 static const char hexchars[] = "0123456789abcdef";
 
+size_t bytesToHex(const love::uint8 *src, size_t srclen, char *dst)
+{
+	size_t i = 0;
+
+#if defined(LOVE_DATA_SSE2)
+	const __m128i nibblemask = _mm_set1_epi8(0x0F);
+
+	for (; srclen - i >= 16; i += 16)
+	{
+		__m128i b = _mm_loadu_si128((const __m128i *) (src + i));
+		__m128i hi = _mm_and_si128(_mm_srli_epi16(b, 4), nibblemask);
+		__m128i lo = _mm_and_si128(b, nibblemask);
+
+		// '0' + n, plus the gap from '9' to 'a' for n > 9.
+		hi = _mm_add_epi8(_mm_add_epi8(hi, _mm_set1_epi8('0')), _mm_and_si128(_mm_cmpgt_epi8(hi, _mm_set1_epi8(9)), _mm_set1_epi8('a' - '9' - 1)));
+		lo = _mm_add_epi8(_mm_add_epi8(lo, _mm_set1_epi8('0')), _mm_and_si128(_mm_cmpgt_epi8(lo, _mm_set1_epi8(9)), _mm_set1_epi8('a' - '9' - 1)));
+
+		_mm_storeu_si128((__m128i *) (dst + i * 2), _mm_unpacklo_epi8(hi, lo));
+		_mm_storeu_si128((__m128i *) (dst + i * 2 + 16), _mm_unpackhi_epi8(hi, lo));
+	}
+#elif defined(LOVE_SIMD_NEON)
+	const uint8x16_t table = vld1q_u8((const love::uint8 *) hexchars);
+
+	for (; srclen - i >= 16; i += 16)
+	{
+		uint8x16_t b = vld1q_u8(src + i);
+		uint8x16x2_t chars;
+		chars.val[0] = vqtbl1q_u8(table, vshrq_n_u8(b, 4));
+		chars.val[1] = vqtbl1q_u8(table, vandq_u8(b, vdupq_n_u8(0x0F)));
+		vst2q_u8((love::uint8 *) dst + i * 2, chars);
+	}
+#endif
+
+	for (; i < srclen; i++)
+	{
+		love::uint8 b = src[i];
+		dst[i * 2 + 0] = hexchars[b >> 4];
+		dst[i * 2 + 1] = hexchars[b & 0xF];
+	}
+
+	return srclen * 2;
+}
+
 char *bytesToHex(const love::uint8 *src, size_t srclen, size_t &dstlen)
 {
 	dstlen = srclen * 2;
@@ -51,12 +103,7 @@ char *bytesToHex(const love::uint8 *src, size_t srclen, size_t &dstlen)
 		throw love::Exception("Out of memory.");
 	}
 
-	for (size_t i = 0; i < srclen; i++)
-	{
-		love::uint8 b = src[i];
-		dst[i * 2 + 0] = hexchars[b >> 4];
-		dst[i * 2 + 1] = hexchars[b & 0xF];
-	}
+	bytesToHex(src, srclen, dst);
 
 	dst[dstlen] = '\0';
 	return dst;
@@ -76,7 +123,40 @@ love::uint8 nibble(char c)
 	return 0;
 }
 
-love::uint8 *hexToBytes(const char *src, size_t srclen, size_t &dstlen)
+#if defined(LOVE_DATA_SSE2)
+
+// Same as nibble() for 16 characters at once.
+inline __m128i nibbles(__m128i c)
+{
+	__m128i digit = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(c, _mm_set1_epi8('9' + 1)));
+
+	__m128i lower = _mm_or_si128(c, _mm_set1_epi8(0x20));
+	__m128i letter = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1)));
+
+	__m128i v = _mm_and_si128(digit, _mm_sub_epi8(c, _mm_set1_epi8('0')));
+	return _mm_or_si128(v, _mm_and_si128(letter, _mm_sub_epi8(lower, _mm_set1_epi8('a' - 10))));
+}
+
+// Joins pairs of nibbles into 8 bytes, in the low half of each 16 bit lane.
+inline __m128i joinNibbles(__m128i v)
+{
+	return _mm_or_si128(_mm_and_si128(_mm_slli_epi16(v, 4), _mm_set1_epi16(0xF0)), _mm_srli_epi16(v, 8));
+}
+
+#elif defined(LOVE_SIMD_NEON)
+
+inline uint8x16_t nibbles(uint8x16_t c)
+{
+	uint8x16_t digit = vsubq_u8(c, vdupq_n_u8('0'));
+	uint8x16_t letter = vsubq_u8(vorrq_u8(c, vdupq_n_u8(0x20)), vdupq_n_u8('a'));
+
+	uint8x16_t v = vandq_u8(vcltq_u8(digit, vdupq_n_u8(10)), digit);
+	return vorrq_u8(v, vandq_u8(vcltq_u8(letter, vdupq_n_u8(6)), vaddq_u8(letter, vdupq_n_u8(10))));
+}
+
+#endif
+
+size_t hexToBytes(const char *src, size_t srclen, love::uint8 *dst)
 {
 	if (srclen >= 2 && src[0] == '0' && (src[1] == 'x' || src[1] == 'X'))
 	{
@@ -84,7 +164,46 @@ love::uint8 *hexToBytes(const char *src, size_t srclen, size_t &dstlen)
 		srclen -= 2;
 	}
 
-	dstlen = (srclen + 1) / 2;
+	size_t dstlen = (srclen + 1) / 2;
+	size_t i = 0;
+
+#if defined(LOVE_DATA_SSE2)
+	for (; dstlen - i >= 16 && srclen - i * 2 >= 32; i += 16)
+	{
+		__m128i a = joinNibbles(nibbles(_mm_loadu_si128((const __m128i *) (src + i * 2))));
+		__m128i b = joinNibbles(nibbles(_mm_loadu_si128((const __m128i *) (src + i * 2 + 16))));
+		_mm_storeu_si128((__m128i *) (dst + i), _mm_packus_epi16(a, b));
+	}
+#elif defined(LOVE_SIMD_NEON)
+	for (; dstlen - i >= 16 && srclen - i * 2 >= 32; i += 16)
+	{
+		uint8x16x2_t chars = vld2q_u8((const love::uint8 *) src + i * 2);
+		vst1q_u8(dst + i, vorrq_u8(vshlq_n_u8(nibbles(chars.val[0]), 4), nibbles(chars.val[1])));
+	}
+#endif
+
+	for (; i < dstlen; i++)
+	{
+		dst[i] = nibble(src[i * 2]) << 4;
+
+		if (i * 2 + 1 < srclen)
+			dst[i] |= nibble(src[i * 2 + 1]);
+	}
+
+	return dstlen;
+}
+
+size_t hexDecodedSize(const char *src, size_t srclen)
+{
+	if (srclen >= 2 && src[0] == '0' && (src[1] == 'x' || src[1] == 'X'))
+		srclen -= 2;
+
+	return (srclen + 1) / 2;
+}
+
+love::uint8 *hexToBytes(const char *src, size_t srclen, size_t &dstlen)
+{
+	dstlen = hexDecodedSize(src, srclen);
 
 	if (dstlen == 0)
 		return nullptr;
@@ -99,14 +218,7 @@ love::uint8 *hexToBytes(const char *src, size_t srclen, size_t &dstlen)
 		throw love::Exception("Out of memory.");
 	}
 
-	for (size_t i = 0; i < dstlen; i++)
-	{
-		dst[i] = nibble(src[i * 2]) << 4;
-
-		if (i * 2 + 1 < srclen)
-			dst[i] |= nibble(src[i * 2 + 1]);
-	}
-
+	hexToBytes(src, srclen, dst);
 	return dst;
 }
 
@@ -117,15 +229,26 @@ namespace love
 namespace data
 {
 
-CompressedData *compress(Compressor::Format format, const char *rawbytes, size_t rawsize, int level)
+static Compressor *getCompressor(Compressor::Format format)
 {
 	Compressor *compressor = Compressor::getCompressor(format);
 
 	if (compressor == nullptr)
+	{
+		if (format == Compressor::FORMAT_ZSTD)
+			throw love::Exception("Zstandard compression is not supported (LOVE was built without Zstandard support).");
 		throw love::Exception("Invalid compression format.");
+	}
+
+	return compressor;
+}
+
+CompressedData *compress(Compressor::Format format, const char *rawbytes, size_t rawsize, int level, const char *dictionary, size_t dictionarysize)
+{
+	Compressor *compressor = getCompressor(format);
 
 	size_t compressedsize = 0;
-	char *cbytes = compressor->compress(format, rawbytes, rawsize, level, compressedsize);
+	char *cbytes = compressor->compress(format, rawbytes, rawsize, level, dictionary, dictionarysize, compressedsize);
 
 	CompressedData *data = nullptr;
 
@@ -142,25 +265,21 @@ CompressedData *compress(Compressor::Format format, const char *rawbytes, size_t
 	return data;
 }
 
-char *decompress(CompressedData *data, size_t &decompressedsize)
+char *decompress(CompressedData *data, size_t &decompressedsize, const char *dictionary, size_t dictionarysize)
 {
 	size_t rawsize = data->getDecompressedSize();
 
 	char *rawbytes = decompress(data->getFormat(), (const char *) data->getData(),
-	                            data->getSize(), rawsize);
+	                            data->getSize(), rawsize, dictionary, dictionarysize);
 
 	decompressedsize = rawsize;
 	return rawbytes;
 }
 
-char *decompress(Compressor::Format format, const char *cbytes, size_t compressedsize, size_t &rawsize)
+char *decompress(Compressor::Format format, const char *cbytes, size_t compressedsize, size_t &rawsize, const char *dictionary, size_t dictionarysize)
 {
-	Compressor *compressor = Compressor::getCompressor(format);
-
-	if (compressor == nullptr)
-		throw love::Exception("Invalid compression format.");
-
-	return compressor->decompress(format, cbytes, compressedsize, rawsize);
+	Compressor *compressor = getCompressor(format);
+	return compressor->decompress(format, cbytes, compressedsize, dictionary, dictionarysize, rawsize);
 }
 
 char *encode(EncodeFormat format, const char *src, size_t srclen, size_t &dstlen, size_t linelen)
@@ -187,6 +306,79 @@ char *decode(EncodeFormat format, const char *src, size_t srclen, size_t &dstlen
 	}
 }
 
+size_t getArrayTypeSize(ArrayType type)
+{
+	switch (type)
+	{
+	case ARRAY_FLOAT:
+		return sizeof(float);
+	case ARRAY_DOUBLE:
+		return sizeof(double);
+	case ARRAY_INT8:
+	case ARRAY_UINT8:
+		return 1;
+	case ARRAY_INT16:
+	case ARRAY_UINT16:
+		return 2;
+	case ARRAY_INT32:
+	case ARRAY_UINT32:
+	default:
+		return 4;
+	}
+}
+
+size_t getEncodedSize(EncodeFormat format, size_t srclen, size_t linelen)
+{
+	switch (format)
+	{
+	case ENCODE_BASE64:
+	default:
+		return b64_encoded_size(srclen, linelen);
+	case ENCODE_HEX:
+		return srclen * 2;
+	}
+}
+
+size_t getDecodedMaxSize(EncodeFormat format, const char *src, size_t srclen)
+{
+	switch (format)
+	{
+	case ENCODE_BASE64:
+	default:
+		return b64_decoded_max_size(srclen);
+	case ENCODE_HEX:
+		return hexDecodedSize(src, srclen);
+	}
+}
+
+size_t encode(EncodeFormat format, const char *src, size_t srclen, char *dst, size_t dstsize, size_t linelen)
+{
+	switch (format)
+	{
+	case ENCODE_BASE64:
+	default:
+		return b64_encode(src, srclen, linelen, dst, dstsize);
+	case ENCODE_HEX:
+		if (srclen * 2 > dstsize)
+			throw love::Exception("Not enough space to store the hex-encoded data.");
+		return bytesToHex((const uint8 *) src, srclen, dst);
+	}
+}
+
+size_t decode(EncodeFormat format, const char *src, size_t srclen, char *dst, size_t dstsize)
+{
+	switch (format)
+	{
+	case ENCODE_BASE64:
+	default:
+		return b64_decode(src, srclen, dst, dstsize);
+	case ENCODE_HEX:
+		if (hexDecodedSize(src, srclen) > dstsize)
+			throw love::Exception("Not enough space to store the hex-decoded data.");
+		return hexToBytes(src, srclen, (uint8 *) dst);
+	}
+}
+
 std::string hash(HashFunction::Function function, Data *input)
 {
 	return hash(function, (const char*) input->getData(), input->getSize());
@@ -242,6 +434,16 @@ ByteData *DataModule::newByteData(void *d, size_t size, bool own)
 	return new ByteData(d, size, own);
 }
 
+CompressionStream *DataModule::newCompressionStream(CompressionStream::Mode mode, Compressor::Format format, int level)
+{
+	return new CompressionStream(mode, format, level);
+}
+
+Hasher *DataModule::newHasher(HashFunction::Function function, uint64 seed)
+{
+	return new Hasher(function, seed);
+}
+
 static StringMap<EncodeFormat, ENCODE_MAX_ENUM>::Entry encoderEntries[] =
 {
 	{ "base64", ENCODE_BASE64 },
@@ -258,6 +460,20 @@ static StringMap<ContainerType, CONTAINER_MAX_ENUM>::Entry containerEntries[] =
 
 static StringMap<ContainerType, CONTAINER_MAX_ENUM> containers(containerEntries, sizeof(containerEntries));
 
+static StringMap<ArrayType, ARRAY_MAX_ENUM>::Entry arrayTypeEntries[] =
+{
+	{ "float",  ARRAY_FLOAT  },
+	{ "double", ARRAY_DOUBLE },
+	{ "int8",   ARRAY_INT8   },
+	{ "uint8",  ARRAY_UINT8  },
+	{ "int16",  ARRAY_INT16  },
+	{ "uint16", ARRAY_UINT16 },
+	{ "int32",  ARRAY_INT32  },
+	{ "uint32", ARRAY_UINT32 },
+};
+
+static StringMap<ArrayType, ARRAY_MAX_ENUM> arrayTypes(arrayTypeEntries, sizeof(arrayTypeEntries));
+
 bool getConstant(const char *in, EncodeFormat &out)
 {
 	return encoders.find(in, out);
@@ -288,5 +504,20 @@ std::vector<std::string> getConstants(ContainerType)
 	return containers.getNames();
 }
 
+bool getConstant(const char *in, ArrayType &out)
+{
+	return arrayTypes.find(in, out);
+}
+
+bool getConstant(ArrayType in, const char *&out)
+{
+	return arrayTypes.find(in, out);
+}
+
+std::vector<std::string> getConstants(ArrayType)
+{
+	return arrayTypes.getNames();
+}
+
 } // data
 } // love
@@ -21,6 +21,8 @@
 #pragma once
 
 #include "CompressedData.h"
+#include "CompressionStream.h"
+#include "Hasher.h"
 #include "Compressor.h"
 #include "HashFunction.h"
 #include "DataView.h"
@@ -49,6 +51,25 @@ enum ContainerType
 	CONTAINER_MAX_ENUM
 };
 
+// Element types for reading and writing arrays of numbers in Data.
+enum ArrayType
+{
+	ARRAY_FLOAT,
+	ARRAY_DOUBLE,
+	ARRAY_INT8,
+	ARRAY_UINT8,
+	ARRAY_INT16,
+	ARRAY_UINT16,
+	ARRAY_INT32,
+	ARRAY_UINT32,
+	ARRAY_MAX_ENUM
+};
+
+/**
+ * Gets the size in bytes of a single element of the given array type.
+ **/
+size_t getArrayTypeSize(ArrayType type);
+
 /**
  * Compresses a block of memory using the given compression format.
  *
@@ -58,9 +79,12 @@ enum ContainerType
  * @param level The amount of compression to apply (between 0 and 9.)
  *              A value of -1 indicates the default amount of compression.
  *              Specific formats may not use every level.
+ * @param dictionary Optional data shared with the decompressing side, for
+ *                   formats which support it.
+ * @param dictionarysize The size in bytes of the dictionary.
  * @return The newly compressed data.
  **/
-CompressedData *compress(Compressor::Format format, const char *rawbytes, size_t rawsize, int level = -1);
+CompressedData *compress(Compressor::Format format, const char *rawbytes, size_t rawsize, int level = -1, const char *dictionary = nullptr, size_t dictionarysize = 0);
 
 /**
  * Decompresses existing compressed data into raw bytes.
@@ -69,7 +93,7 @@ CompressedData *compress(Compressor::Format format, const char *rawbytes, size_t
  * @param[out] decompressedsize The size in bytes of the decompressed data.
  * @return The newly decompressed data (allocated with new[]).
  **/
-char *decompress(CompressedData *data, size_t &decompressedsize);
+char *decompress(CompressedData *data, size_t &decompressedsize, const char *dictionary = nullptr, size_t dictionarysize = 0);
 
 /**
  * Decompresses existing compressed data into raw bytes.
@@ -82,11 +106,26 @@ char *decompress(CompressedData *data, size_t &decompressedsize);
  *               bytes of the newly decompressed data.
  * @return The newly decompressed data (allocated with new[]).
  **/
-char *decompress(Compressor::Format format, const char *cbytes, size_t compressedsize, size_t &rawsize);
+char *decompress(Compressor::Format format, const char *cbytes, size_t compressedsize, size_t &rawsize, const char *dictionary = nullptr, size_t dictionarysize = 0);
 
 char *encode(EncodeFormat format, const char *src, size_t srclen, size_t &dstlen, size_t linelen = 0);
 char *decode(EncodeFormat format, const char *src, size_t srclen, size_t &dstlen);
 
+/**
+ * Variants of encode and decode which write into an existing buffer instead
+ * of allocating one, and throw if it's too small. They return the number of
+ * bytes written.
+ **/
+size_t encode(EncodeFormat format, const char *src, size_t srclen, char *dst, size_t dstsize, size_t linelen = 0);
+size_t decode(EncodeFormat format, const char *src, size_t srclen, char *dst, size_t dstsize);
+
+/**
+ * Gets the exact size of the encoded version of some data, and the largest
+ * possible size of the decoded version of an encoded string.
+ **/
+size_t getEncodedSize(EncodeFormat format, size_t srclen, size_t linelen = 0);
+size_t getDecodedMaxSize(EncodeFormat format, const char *src, size_t srclen);
+
 /**
  * Hash the input, producing an set of bytes as output.
  *
@@ -109,6 +148,10 @@ bool getConstant(const char *in, ContainerType &out);
 bool getConstant(ContainerType in, const char *&out);
 std::vector<std::string> getConstants(ContainerType);
 
+bool getConstant(const char *in, ArrayType &out);
+bool getConstant(ArrayType in, const char *&out);
+std::vector<std::string> getConstants(ArrayType);
+
 
 class DataModule : public Module
 {
@@ -121,6 +164,8 @@ public:
 	ByteData *newByteData(size_t size);
 	ByteData *newByteData(const void *d, size_t size);
 	ByteData *newByteData(void *d, size_t size, bool own);
+	CompressionStream *newCompressionStream(CompressionStream::Mode mode, Compressor::Format format, int level = -1);
+	Hasher *newHasher(HashFunction::Function function, uint64 seed = 0);
 
 }; // DataModule
 
@@ -20,10 +20,22 @@
 
 #include "HashFunction.h"
 #include "common/Exception.h"
+#include "common/cpu.h"
 
-// FIXME: Probably trivial by having tole and tobe functions, which can be ifdeffed to being identity functions
-#ifdef LOVE_BIG_ENDIAN
-#	error Hashing not yet implemented for big endian
+#include "libraries/xxHash/xxhash.h"
+
+// C
+#include <string.h>
+
+// C++
+#include <algorithm>
+
+#if defined(LOVE_CPU_X86)
+#	define LOVE_HASH_X86_SHA
+#	include <immintrin.h>
+#elif (defined(__aarch64__) || defined(_M_ARM64)) && (defined(__ARM_FEATURE_SHA2) || defined(__ARM_FEATURE_CRYPTO))
+#	define LOVE_HASH_ARM_SHA
+#	include <arm_neon.h>
 #endif
 
 namespace love
@@ -51,63 +63,172 @@ inline uint64 rightrot(uint64 x, uint8 amount)
 	return (x >> amount) | (x << (64 - amount));
 }
 
-// Extend the value of `a` to make it a multiple of `n`.
-inline uint64 extend_multiple(uint64 a, uint64 n)
+inline uint32 loadLE32(const uint8 *p)
+{
+	return (uint32) p[0] | ((uint32) p[1] << 8) | ((uint32) p[2] << 16) | ((uint32) p[3] << 24);
+}
+
+inline uint32 loadBE32(const uint8 *p)
+{
+	return ((uint32) p[0] << 24) | ((uint32) p[1] << 16) | ((uint32) p[2] << 8) | (uint32) p[3];
+}
+
+inline uint64 loadBE64(const uint8 *p)
+{
+	return ((uint64) loadBE32(p) << 32) | (uint64) loadBE32(p + 4);
+}
+
+inline void storeLE32(char *p, uint32 v)
+{
+	for (int i = 0; i < 4; i++)
+		p[i] = (char) ((v >> (i * 8)) & 0xFF);
+}
+
+inline void storeBE32(char *p, uint32 v)
 {
-	uint64 r = a % n;
-	return r == 0 ? a : a + (n-r);
+	for (int i = 0; i < 4; i++)
+		p[i] = (char) ((v >> (24 - i * 8)) & 0xFF);
+}
+
+inline void storeBE64(char *p, uint64 v)
+{
+	storeBE32(p, (uint32) (v >> 32));
+	storeBE32(p + 4, (uint32) (v & 0xFFFFFFFF));
 }
 
 /**
- * The following implementation is based on the pseudocode provided by multiple
- * authors on wikipedia: https://en.wikipedia.org/wiki/MD5
- * The pseudocode is licensed under the CC-BY-SA license, but no authorship
- * information is present. I believe this note, and the zlib license of this
- * project satisfy the conditions of the license.
+ * Common state for the MD5, SHA-1 and SHA-2 functions. Input is collected
+ * into fixed size blocks for compress(), and finalizing pads the last block
+ * with a 1 bit and the message length in bits.
  **/
-class MD5 : public HashFunction
+template <typename Word, size_t BlockSize, bool BigEndianLength>
+class BlockState : public HashFunction::State
 {
-private:
-	static const uint8 shifts[64];
-	static const uint32 constants[64];
-
 public:
-	bool isSupported(Function function) const override
+
+	void update(const char *input, uint64 length) override
 	{
-		return function == FUNCTION_MD5;
+		const uint8 *in = (const uint8 *) input;
+		totalLength += length;
+
+		if (buffered > 0)
+		{
+			size_t count = (size_t) std::min<uint64>(BlockSize - buffered, length);
+			memcpy(buffer + buffered, in, count);
+			buffered += count;
+			in += count;
+			length -= count;
+
+			if (buffered < BlockSize)
+				return;
+
+			compress(words, buffer, 1);
+			buffered = 0;
+		}
+
+		// Whole blocks are hashed straight from the input.
+		uint64 blocks = length / BlockSize;
+		if (blocks > 0)
+		{
+			compress(words, in, (size_t) blocks);
+			in += blocks * BlockSize;
+			length -= blocks * BlockSize;
+		}
+
+		memcpy(buffer, in, (size_t) length);
+		buffered = (size_t) length;
 	}
 
-	void hash(Function function, const char *input, uint64 length, Value &output) const override
+	void finalize(HashFunction::Value &output) const override
 	{
-		if (function != FUNCTION_MD5)
-			throw love::Exception("Hash function not supported by MD5 implementation");
+		// The length takes up the last 8 bytes of 64 byte blocks, and the last
+		// 16 bytes of 128 byte blocks (we only use the low 8 of those).
+		const size_t lengthsize = BlockSize / 8;
 
-		uint32 a0 = 0x67452301;
-		uint32 b0 = 0xefcdab89;
-		uint32 c0 = 0x98badcfe;
-		uint32 d0 = 0x10325476;
+		uint8 tail[BlockSize * 2];
+		size_t tailsize = buffered + 1 + lengthsize <= BlockSize ? BlockSize : BlockSize * 2;
 
-		// Compute final padded length, accounting for the appended bit (byte) and size
-		uint64 paddedLength = extend_multiple(length + 1 + 8, 64);
+		memcpy(tail, buffer, buffered);
+		memset(tail + buffered, 0, tailsize - buffered);
+		tail[buffered] = 0x80; // append bit
 
-		uint32 *padded = new uint32[paddedLength / 4];
-		memcpy(padded, input, length);
-		memset(((uint8*)padded) + length, 0, paddedLength - length);
-		*(((uint8*)padded) + length) = 0x80; // append bit
+		uint64 bitlength = totalLength * 8;
+		for (int i = 0; i < 8; i++)
+		{
+			uint8 b = (uint8) ((bitlength >> (i * 8)) & 0xFF);
+			if (BigEndianLength)
+				tail[tailsize - 1 - i] = b;
+			else
+				tail[tailsize - 8 + i] = b;
+		}
+
+		Word result[8];
+		memcpy(result, words, sizeof(result));
+		compress(result, tail, tailsize / BlockSize);
+
+		getOutput(result, output);
+	}
+
+	void reset() override
+	{
+		memcpy(words, initial, sizeof(words));
+		buffered = 0;
+		totalLength = 0;
+	}
+
+protected:
+
+	BlockState(const Word *initialwords, size_t count)
+	{
+		memset(initial, 0, sizeof(initial));
+		memcpy(initial, initialwords, sizeof(Word) * count);
+		reset();
+	}
+
+	virtual void compress(Word *state, const uint8 *blocks, size_t count) const = 0;
+	virtual void getOutput(const Word *state, HashFunction::Value &output) const = 0;
+
+private:
+
+	Word initial[8];
+	Word words[8];
+
+	uint8 buffer[BlockSize];
+	size_t buffered;
+	uint64 totalLength;
+
+}; // BlockState
+
+/**
+ * The following implementation is based on the pseudocode provided by multiple
+ * authors on wikipedia: https://en.wikipedia.org/wiki/MD5
+ * The pseudocode is licensed under the CC-BY-SA license, but no authorship
+ * information is present. I believe this note, and the zlib license of this
+ * project satisfy the conditions of the license.
+ **/
+class MD5State : public BlockState<uint32, 64, false>
+{
+public:
+
+	MD5State()
+		: BlockState(initial, 4)
+	{}
 
-		// Append length in bits
-		uint64 bit_length = length * 8;
-		memcpy(((uint8*)padded) + paddedLength - 8, &bit_length, 8);
+protected:
 
-		// Process chunks
-		for (uint64 i = 0; i < paddedLength/4; i += 16)
+	void compress(uint32 *state, const uint8 *blocks, size_t count) const override
+	{
+		uint32 chunk[16];
+
+		for (size_t i = 0; i < count; i++, blocks += 64)
 		{
-			uint32 *chunk = &padded[i];
+			for (int j = 0; j < 16; j++)
+				chunk[j] = loadLE32(blocks + j * 4);
 
-			uint32 A = a0;
-			uint32 B = b0;
-			uint32 C = c0;
-			uint32 D = d0;
+			uint32 A = state[0];
+			uint32 B = state[1];
+			uint32 C = state[2];
+			uint32 D = state[3];
 			uint32 F;
 			uint32 g;
 
@@ -141,30 +262,40 @@ public:
 				A = temp;
 			}
 
-			a0 += A;
-			b0 += B;
-			c0 += C;
-			d0 += D;
+			state[0] += A;
+			state[1] += B;
+			state[2] += C;
+			state[3] += D;
 		}
+	}
 
-		delete[] padded;
-
-		memcpy(&output.data[ 0], &a0, 4);
-		memcpy(&output.data[ 4], &b0, 4);
-		memcpy(&output.data[ 8], &c0, 4);
-		memcpy(&output.data[12], &d0, 4);
+	void getOutput(const uint32 *state, HashFunction::Value &output) const override
+	{
+		for (int i = 0; i < 4; i++)
+			storeLE32(&output.data[i * 4], state[i]);
 		output.size = 16;
 	}
-} md5;
 
-const uint8 MD5::shifts[64] = {
+private:
+
+	static const uint32 initial[4];
+	static const uint8 shifts[64];
+	static const uint32 constants[64];
+
+}; // MD5State
+
+const uint32 MD5State::initial[4] = {
+	0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476,
+};
+
+const uint8 MD5State::shifts[64] = {
 	7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
 	5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20,
 	4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
 	6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21,
 };
 
-const uint32 MD5::constants[64] = {
+const uint32 MD5State::constants[64] = {
 	0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee,
 	0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
 	0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be,
@@ -183,63 +314,65 @@ const uint32 MD5::constants[64] = {
 	0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391,
 };
 
-/**
- * The following implementation was based on the text, not the code listings,
- * in RFC3174. I believe this means no copyright other than that of the L�VE
- * Development Team applies.
- **/
-class SHA1 : public HashFunction
+class MD5 : public HashFunction
 {
 public:
 	bool isSupported(Function function) const override
 	{
-		return function == FUNCTION_SHA1;
+		return function == FUNCTION_MD5;
 	}
 
 	void hash(Function function, const char *input, uint64 length, Value &output) const override
 	{
-		if (function != FUNCTION_SHA1)
-			throw love::Exception("Hash function not supported by SHA1 implementation");
+		if (function != FUNCTION_MD5)
+			throw love::Exception("Hash function not supported by MD5 implementation");
+
+		MD5State state;
+		state.update(input, length);
+		state.finalize(output);
+	}
+
+	State *newState(Function function, uint64 /*seed*/) const override
+	{
+		if (function != FUNCTION_MD5)
+			throw love::Exception("Hash function not supported by MD5 implementation");
 
-		uint32 intermediate[5] = {
-			0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0
-		};
+		return new MD5State();
+	}
+} md5;
 
-		// Compute final padded length, accounting for the appended bit (byte) and size
-		uint64 paddedLength = extend_multiple(length + 1 + 8, 64);
+/**
+ * The following implementation was based on the text, not the code listings,
+ * in RFC3174. I believe this means no copyright other than that of the L�VE
+ * Development Team applies.
+ **/
+class SHA1State : public BlockState<uint32, 64, true>
+{
+public:
 
-		uint32 *padded = new uint32[paddedLength / 4];
-		memcpy(padded, input, length);
-		memset(((uint8*)padded) + length, 0, paddedLength - length);
-		*(((uint8*)padded) + length) = 0x80; // append bit
+	SHA1State()
+		: BlockState(initial, 5)
+	{}
 
-		// Append length in bits (big endian)
-		uint64 bit_length = length * 8;
-		for (int i = 0; i < 8; ++i)
-			*(((uint8*)padded) + (paddedLength - 8 + i)) = (bit_length >> (56 - i * 8)) & 0xFF;
+protected:
 
+	void compress(uint32 *state, const uint8 *blocks, size_t count) const override
+	{
 		// Allocate our extended words
 		uint32 words[80];
 
-		for (uint64 i = 0; i < paddedLength/4; i += 16)
+		for (size_t i = 0; i < count; i++, blocks += 64)
 		{
-			uint32 *chunk = &padded[i];
 			for (int j = 0; j < 16; j++)
-			{
-				char *c = (char*) &words[j];
-				c[0] = (chunk[j] >> 24) & 0xFF;
-				c[1] = (chunk[j] >> 16) & 0xFF;
-				c[2] = (chunk[j] >>  8) & 0xFF;
-				c[3] = (chunk[j] >>  0) & 0xFF;
-			}
+				words[j] = loadBE32(blocks + j * 4);
 			for (int j = 16; j < 80; j++)
 				words[j] = leftrot(words[j-3] ^ words[j-8] ^ words[j-14] ^ words[j-16], 1);
 
-			uint32 A = intermediate[0];
-			uint32 B = intermediate[1];
-			uint32 C = intermediate[2];
-			uint32 D = intermediate[3];
-			uint32 E = intermediate[4];
+			uint32 A = state[0];
+			uint32 B = state[1];
+			uint32 C = state[2];
+			uint32 D = state[3];
+			uint32 E = state[4];
 
 			for (int j = 0; j < 80; j++)
 			{
@@ -261,82 +394,89 @@ public:
 				A = temp;
 			}
 
-			intermediate[0] += A;
-			intermediate[1] += B;
-			intermediate[2] += C;
-			intermediate[3] += D;
-			intermediate[4] += E;
-		}
-
-		delete[] padded;
-
-		for (int i = 0; i < 20; i += 4)
-		{
-			output.data[i+0] = (intermediate[i/4] >> 24) & 0xFF;
-			output.data[i+1] = (intermediate[i/4] >> 16) & 0xFF;
-			output.data[i+2] = (intermediate[i/4] >>  8) & 0xFF;
-			output.data[i+3] = (intermediate[i/4] >>  0) & 0xFF;
+			state[0] += A;
+			state[1] += B;
+			state[2] += C;
+			state[3] += D;
+			state[4] += E;
 		}
+	}
 
+	void getOutput(const uint32 *state, HashFunction::Value &output) const override
+	{
+		for (int i = 0; i < 5; i++)
+			storeBE32(&output.data[i * 4], state[i]);
 		output.size = 20;
 	}
-} sha1;
 
-/**
- * This implementation was based on the description in RFC-6234.
- **/
-// SHA-2: SHA-224 and SHA-256
-class SHA256 : public HashFunction
-{
 private:
-	static const uint32 initial224[8];
-	static const uint32 initial256[8];
-	static const uint32 constants[64];
 
+	static const uint32 initial[5];
+
+}; // SHA1State
+
+const uint32 SHA1State::initial[5] = {
+	0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0
+};
+
+class SHA1 : public HashFunction
+{
 public:
 	bool isSupported(Function function) const override
 	{
-		return function == FUNCTION_SHA224 || function == FUNCTION_SHA256;
+		return function == FUNCTION_SHA1;
 	}
 
 	void hash(Function function, const char *input, uint64 length, Value &output) const override
 	{
-		if (!isSupported(function))
-			throw love::Exception("Hash function not supported by SHA-224/SHA-256 implementation");
+		if (function != FUNCTION_SHA1)
+			throw love::Exception("Hash function not supported by SHA1 implementation");
+
+		SHA1State state;
+		state.update(input, length);
+		state.finalize(output);
+	}
 
-		// Compute final padded length, accounting for the appended bit (byte) and size
-		uint64 paddedLength = extend_multiple(length + 1 + 8, 64);
+	State *newState(Function function, uint64 /*seed*/) const override
+	{
+		if (function != FUNCTION_SHA1)
+			throw love::Exception("Hash function not supported by SHA1 implementation");
 
-		uint32 *padded = new uint32[paddedLength / 4];
-		memcpy(padded, input, length);
-		memset(((uint8*)padded) + length, 0, paddedLength - length);
-		*(((uint8*)padded) + length) = 0x80; // append bit
+		return new SHA1State();
+	}
+} sha1;
 
-		// Append length in bits (big endian)
-		uint64 bit_length = length * 8;
-		for (int i = 0; i < 8; ++i)
-			*(((uint8*)padded) + (paddedLength - 8 + i)) = (bit_length >> (56 - i * 8)) & 0xFF;
+/**
+ * This implementation was based on the description in RFC-6234.
+ **/
+// SHA-2: SHA-224 and SHA-256
+class SHA256State : public BlockState<uint32, 64, true>
+{
+public:
 
-		uint32 intermediate[8];
-		if (function == FUNCTION_SHA224)
-			memcpy(intermediate, initial224, sizeof(intermediate));
-		else
-			memcpy(intermediate, initial256, sizeof(intermediate));
+	SHA256State(bool sha224)
+		: BlockState(sha224 ? initial224 : initial256, 8)
+		, sha224(sha224)
+	{}
+
+protected:
+
+	void compress(uint32 *state, const uint8 *blocks, size_t count) const override
+	{
+#if defined(LOVE_HASH_X86_SHA)
+		if (love::cpu::hasSHA() && love::cpu::hasSSE41())
+			return compressSHAExtensions(state, blocks, count);
+#elif defined(LOVE_HASH_ARM_SHA)
+		return compressSHAExtensions(state, blocks, count);
+#endif
 
 		// Allocate our extended words
 		uint32 words[64];
 
-		for (uint64 i = 0; i < paddedLength/4; i += 16)
+		for (size_t i = 0; i < count; i++, blocks += 64)
 		{
-			uint32 *chunk = &padded[i];
 			for (int j = 0; j < 16; j++)
-			{
-				char *c = (char*) &words[j];
-				c[0] = (chunk[j] >> 24) & 0xFF;
-				c[1] = (chunk[j] >> 16) & 0xFF;
-				c[2] = (chunk[j] >>  8) & 0xFF;
-				c[3] = (chunk[j] >>  0) & 0xFF;
-			}
+				words[j] = loadBE32(blocks + j * 4);
 			for (int j = 16; j < 64; j++)
 			{
 				words[j] = rightrot(words[j-2], 17) ^ rightrot(words[j-2], 19) ^ (words[j-2] >> 10);
@@ -344,14 +484,14 @@ public:
 				words[j] += words[j-7] + words[j-16];
 			}
 
-			uint32 A = intermediate[0];
-			uint32 B = intermediate[1];
-			uint32 C = intermediate[2];
-			uint32 D = intermediate[3];
-			uint32 E = intermediate[4];
-			uint32 F = intermediate[5];
-			uint32 G = intermediate[6];
-			uint32 H = intermediate[7];
+			uint32 A = state[0];
+			uint32 B = state[1];
+			uint32 C = state[2];
+			uint32 D = state[3];
+			uint32 E = state[4];
+			uint32 F = state[5];
+			uint32 G = state[6];
+			uint32 H = state[7];
 
 			for (int j = 0; j < 64; j++)
 			{
@@ -371,45 +511,141 @@ public:
 				A = temp1 + temp2;
 			}
 
-			intermediate[0] += A;
-			intermediate[1] += B;
-			intermediate[2] += C;
-			intermediate[3] += D;
-			intermediate[4] += E;
-			intermediate[5] += F;
-			intermediate[6] += G;
-			intermediate[7] += H;
+			state[0] += A;
+			state[1] += B;
+			state[2] += C;
+			state[3] += D;
+			state[4] += E;
+			state[5] += F;
+			state[6] += G;
+			state[7] += H;
 		}
+	}
 
-		delete[] padded;
+	void getOutput(const uint32 *state, HashFunction::Value &output) const override
+	{
+		int hashlength = sha224 ? 28 : 32;
+		for (int i = 0; i < hashlength / 4; i++)
+			storeBE32(&output.data[i * 4], state[i]);
+		output.size = hashlength;
+	}
+
+private:
+
+#if defined(LOVE_HASH_X86_SHA)
+
+	// Each SHA-NI round instruction does two rounds on state kept as ABEF and
+	// CDGH vectors.
+	LOVE_CPU_TARGET("sha,ssse3,sse4.1")
+	static void compressSHAExtensions(uint32 *state, const uint8 *blocks, size_t count)
+	{
+		const __m128i byteswap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
 
-		int hashlength = 32;
-		if (function == FUNCTION_SHA224)
-			hashlength = 28;
+		__m128i tmp = _mm_loadu_si128((const __m128i *) &state[0]);
+		__m128i state1 = _mm_loadu_si128((const __m128i *) &state[4]);
 
-		for (int i = 0; i < hashlength; i += 4)
+		tmp = _mm_shuffle_epi32(tmp, 0xB1); // CDAB
+		state1 = _mm_shuffle_epi32(state1, 0x1B); // EFGH
+		__m128i state0 = _mm_alignr_epi8(tmp, state1, 8); // ABEF
+		state1 = _mm_blend_epi16(state1, tmp, 0xF0); // CDGH
+
+		for (size_t i = 0; i < count; i++, blocks += 64)
 		{
-			output.data[i+0] = (intermediate[i/4] >> 24) & 0xFF;
-			output.data[i+1] = (intermediate[i/4] >> 16) & 0xFF;
-			output.data[i+2] = (intermediate[i/4] >>  8) & 0xFF;
-			output.data[i+3] = (intermediate[i/4] >>  0) & 0xFF;
+			__m128i abef = state0;
+			__m128i cdgh = state1;
+
+			__m128i msg[4];
+			for (int j = 0; j < 4; j++)
+				msg[j] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) (blocks + j * 16)), byteswap);
+
+			for (int j = 0; j < 16; j++)
+			{
+				// Words 16+ are derived from the previous sixteen.
+				if (j >= 4)
+				{
+					__m128i w = _mm_sha256msg1_epu32(msg[j % 4], msg[(j + 1) % 4]);
+					w = _mm_add_epi32(w, _mm_alignr_epi8(msg[(j + 3) % 4], msg[(j + 2) % 4], 4));
+					msg[j % 4] = _mm_sha256msg2_epu32(w, msg[(j + 3) % 4]);
+				}
+
+				__m128i k = _mm_add_epi32(msg[j % 4], _mm_loadu_si128((const __m128i *) &constants[j * 4]));
+				state1 = _mm_sha256rnds2_epu32(state1, state0, k);
+				state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(k, 0x0E));
+			}
+
+			state0 = _mm_add_epi32(state0, abef);
+			state1 = _mm_add_epi32(state1, cdgh);
 		}
 
-		output.size = hashlength;
+		tmp = _mm_shuffle_epi32(state0, 0x1B); // FEBA
+		state1 = _mm_shuffle_epi32(state1, 0xB1); // DCHG
+		state0 = _mm_blend_epi16(tmp, state1, 0xF0); // DCBA
+		state1 = _mm_alignr_epi8(state1, tmp, 8); // ABEF
+
+		_mm_storeu_si128((__m128i *) &state[0], state0);
+		_mm_storeu_si128((__m128i *) &state[4], state1);
 	}
-} sha256;
 
-const uint32 SHA256::initial224[8] = {
+#elif defined(LOVE_HASH_ARM_SHA)
+
+	static void compressSHAExtensions(uint32 *state, const uint8 *blocks, size_t count)
+	{
+		uint32x4_t state0 = vld1q_u32(&state[0]);
+		uint32x4_t state1 = vld1q_u32(&state[4]);
+
+		for (size_t i = 0; i < count; i++, blocks += 64)
+		{
+			uint32x4_t abcd = state0;
+			uint32x4_t efgh = state1;
+
+			uint32x4_t msg[4];
+			for (int j = 0; j < 4; j++)
+				msg[j] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(blocks + j * 16)));
+
+			for (int j = 0; j < 16; j++)
+			{
+				// Words 16+ are derived from the previous sixteen.
+				if (j >= 4)
+				{
+					uint32x4_t w = vsha256su0q_u32(msg[j % 4], msg[(j + 1) % 4]);
+					msg[j % 4] = vsha256su1q_u32(w, msg[(j + 2) % 4], msg[(j + 3) % 4]);
+				}
+
+				uint32x4_t k = vaddq_u32(msg[j % 4], vld1q_u32(&constants[j * 4]));
+				uint32x4_t prev = state0;
+				state0 = vsha256hq_u32(state0, state1, k);
+				state1 = vsha256h2q_u32(state1, prev, k);
+			}
+
+			state0 = vaddq_u32(state0, abcd);
+			state1 = vaddq_u32(state1, efgh);
+		}
+
+		vst1q_u32(&state[0], state0);
+		vst1q_u32(&state[4], state1);
+	}
+
+#endif
+
+	bool sha224;
+
+	static const uint32 initial224[8];
+	static const uint32 initial256[8];
+	static const uint32 constants[64];
+
+}; // SHA256State
+
+const uint32 SHA256State::initial224[8] = {
 	0xc1059ed8, 0x367cd507, 0x3070dd17, 0xf70e5939,
 	0xffc00b31, 0x68581511, 0x64f98fa7, 0xbefa4fa4,
 };
 
-const uint32 SHA256::initial256[8] = {
+const uint32 SHA256State::initial256[8] = {
 	0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
 	0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
 };
 
-const uint32 SHA256::constants[64] = {
+const uint32 SHA256State::constants[64] = {
 	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
 	0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
 	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
@@ -428,66 +664,57 @@ const uint32 SHA256::constants[64] = {
 	0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
 };
 
-/**
- * This implementation was based on the description in RFC-6234.
- **/
-// SHA-2: SHA-384 and SHA-512
-class SHA512 : public HashFunction
+class SHA256 : public HashFunction
 {
-private:
-	static const uint64 initial384[8];
-	static const uint64 initial512[8];
-	static const uint64 constants[80];
-
 public:
 	bool isSupported(Function function) const override
 	{
-		return function == FUNCTION_SHA384 || function == FUNCTION_SHA512;
+		return function == FUNCTION_SHA224 || function == FUNCTION_SHA256;
 	}
 
 	void hash(Function function, const char *input, uint64 length, Value &output) const override
 	{
 		if (!isSupported(function))
-			throw love::Exception("Hash function not supported by SHA-384/SHA-512 implementation");
+			throw love::Exception("Hash function not supported by SHA-224/SHA-256 implementation");
 
-		uint64 intermediates[8];
-		if (function == FUNCTION_SHA384)
-			memcpy(intermediates, initial384, sizeof(intermediates));
-		else
-			memcpy(intermediates, initial512, sizeof(intermediates));
+		SHA256State state(function == FUNCTION_SHA224);
+		state.update(input, length);
+		state.finalize(output);
+	}
+
+	State *newState(Function function, uint64 /*seed*/) const override
+	{
+		if (!isSupported(function))
+			throw love::Exception("Hash function not supported by SHA-224/SHA-256 implementation");
+
+		return new SHA256State(function == FUNCTION_SHA224);
+	}
+} sha256;
 
-		// Compute final padded length, accounting for the appended bit (byte) and size
-		uint64 paddedLength = extend_multiple(length + 1 + 16, 128);
+/**
+ * This implementation was based on the description in RFC-6234.
+ **/
+// SHA-2: SHA-384 and SHA-512
+class SHA512State : public BlockState<uint64, 128, true>
+{
+public:
 
-		uint64 *padded = new uint64[paddedLength / 8];
-		memcpy(padded, input, length);
-		memset(((uint8*)padded) + length, 0, paddedLength - length);
-		*(((uint8*)padded) + length) = 0x80; // append bit
+	SHA512State(bool sha384)
+		: BlockState(sha384 ? initial384 : initial512, 8)
+		, sha384(sha384)
+	{}
 
-		// Append length in bits (big endian), note we only write a 64-bit int, so
-		// we have filled the first 8 bytes with zeroes
-		uint64 bit_length = length * 8;
-		for (int i = 0; i < 8; ++i)
-			*(((uint8*)padded) + (paddedLength - 8 + i)) = (bit_length >> (56 - i * 8)) & 0xFF;
+protected:
 
+	void compress(uint64 *state, const uint8 *blocks, size_t count) const override
+	{
 		// Allocate our extended words
 		uint64 words[80];
 
-		for (uint64 i = 0; i < paddedLength/8; i += 16)
+		for (size_t i = 0; i < count; i++, blocks += 128)
 		{
-			uint64 *chunk = &padded[i];
 			for (int j = 0; j < 16; ++j)
-			{
-				char *c = (char*) &words[j];
-				c[0] = (chunk[j] >> 56) & 0xFF;
-				c[1] = (chunk[j] >> 48) & 0xFF;
-				c[2] = (chunk[j] >> 40) & 0xFF;
-				c[3] = (chunk[j] >> 32) & 0xFF;
-				c[4] = (chunk[j] >> 24) & 0xFF;
-				c[5] = (chunk[j] >> 16) & 0xFF;
-				c[6] = (chunk[j] >>  8) & 0xFF;
-				c[7] = (chunk[j] >>  0) & 0xFF;
-			}
+				words[j] = loadBE64(blocks + j * 8);
 			for (int j = 16; j < 80; ++j)
 			{
 				words[j] = words[j-7] + words[j-16];
@@ -495,14 +722,14 @@ public:
 				words[j] += rightrot(words[j-15], 1) ^ rightrot(words[j-15], 8) ^ (words[j-15] >> 7);
 			}
 
-			uint64 A = intermediates[0];
-			uint64 B = intermediates[1];
-			uint64 C = intermediates[2];
-			uint64 D = intermediates[3];
-			uint64 E = intermediates[4];
-			uint64 F = intermediates[5];
-			uint64 G = intermediates[6];
-			uint64 H = intermediates[7];
+			uint64 A = state[0];
+			uint64 B = state[1];
+			uint64 C = state[2];
+			uint64 D = state[3];
+			uint64 E = state[4];
+			uint64 F = state[5];
+			uint64 G = state[6];
+			uint64 H = state[7];
 
 			for (int j = 0; j < 80; ++j)
 			{
@@ -521,49 +748,46 @@ public:
 				A = temp1 + temp2;
 			}
 
-			intermediates[0] += A;
-			intermediates[1] += B;
-			intermediates[2] += C;
-			intermediates[3] += D;
-			intermediates[4] += E;
-			intermediates[5] += F;
-			intermediates[6] += G;
-			intermediates[7] += H;
+			state[0] += A;
+			state[1] += B;
+			state[2] += C;
+			state[3] += D;
+			state[4] += E;
+			state[5] += F;
+			state[6] += G;
+			state[7] += H;
 		}
+	}
 
-		delete[] padded;
+	void getOutput(const uint64 *state, HashFunction::Value &output) const override
+	{
+		int hashlength = sha384 ? 48 : 64;
+		for (int i = 0; i < hashlength / 8; i++)
+			storeBE64(&output.data[i * 8], state[i]);
+		output.size = hashlength;
+	}
 
-		int hashlength = 64;
-		if (function == FUNCTION_SHA384)
-			hashlength = 48;
+private:
 
-		for (int i = 0; i < hashlength; i += 8)
-		{
-			output.data[i+0] = (intermediates[i/8] >> 56) & 0xFF;
-			output.data[i+1] = (intermediates[i/8] >> 48) & 0xFF;
-			output.data[i+2] = (intermediates[i/8] >> 40) & 0xFF;
-			output.data[i+3] = (intermediates[i/8] >> 32) & 0xFF;
-			output.data[i+4] = (intermediates[i/8] >> 24) & 0xFF;
-			output.data[i+5] = (intermediates[i/8] >> 16) & 0xFF;
-			output.data[i+6] = (intermediates[i/8] >>  8) & 0xFF;
-			output.data[i+7] = (intermediates[i/8] >>  0) & 0xFF;
-		}
+	bool sha384;
 
-		output.size = hashlength;
-	}
-} sha512;
+	static const uint64 initial384[8];
+	static const uint64 initial512[8];
+	static const uint64 constants[80];
 
-const uint64 SHA512::initial384[8] = {
+}; // SHA512State
+
+const uint64 SHA512State::initial384[8] = {
 	0xcbbb9d5dc1059ed8, 0x629a292a367cd507, 0x9159015a3070dd17, 0x152fecd8f70e5939,
 	0x67332667ffc00b31, 0x8eb44a8768581511, 0xdb0c2e0d64f98fa7, 0x47b5481dbefa4fa4,
 };
 
-const uint64 SHA512::initial512[8] = {
+const uint64 SHA512State::initial512[8] = {
 	0x6a09e667f3bcc908, 0xbb67ae8584caa73b, 0x3c6ef372fe94f82b, 0xa54ff53a5f1d36f1,
 	0x510e527fade682d1, 0x9b05688c2b3e6c1f, 0x1f83d9abfb41bd6b, 0x5be0cd19137e2179,
 };
 
-const uint64 SHA512::constants[80] = {
+const uint64 SHA512State::constants[80] = {
 	0x428a2f98d728ae22, 0x7137449123ef65cd, 0xb5c0fbcfec4d3b2f, 0xe9b5dba58189dbbc,
 	0x3956c25bf348b538, 0x59f111f1b605d019, 0x923f82a4af194f9b, 0xab1c5ed5da6d8118,
 	0xd807aa98a3030242, 0x12835b0145706fbe, 0x243185be4ee4b28c, 0x550c7dc3d5ffb4e2,
@@ -586,6 +810,143 @@ const uint64 SHA512::constants[80] = {
 	0x4cc5d4becb3e42b6, 0x597f299cfc657e2a, 0x5fcb6fab3ad6faec, 0x6c44198c4a475817,
 };
 
+class SHA512 : public HashFunction
+{
+public:
+	bool isSupported(Function function) const override
+	{
+		return function == FUNCTION_SHA384 || function == FUNCTION_SHA512;
+	}
+
+	void hash(Function function, const char *input, uint64 length, Value &output) const override
+	{
+		if (!isSupported(function))
+			throw love::Exception("Hash function not supported by SHA-384/SHA-512 implementation");
+
+		SHA512State state(function == FUNCTION_SHA384);
+		state.update(input, length);
+		state.finalize(output);
+	}
+
+	State *newState(Function function, uint64 /*seed*/) const override
+	{
+		if (!isSupported(function))
+			throw love::Exception("Hash function not supported by SHA-384/SHA-512 implementation");
+
+		return new SHA512State(function == FUNCTION_SHA384);
+	}
+} sha512;
+
+/**
+ * Non-cryptographic, but much faster than the functions above. Useful for
+ * cache keys and checksums. The output is the canonical big-endian form, the
+ * same as the xxhsum tool prints.
+ **/
+class XXHashState : public HashFunction::State
+{
+public:
+
+	XXHashState(bool xxh32, uint64 seed)
+		: seed(seed)
+		, state32(nullptr)
+		, state64(nullptr)
+	{
+		if (xxh32)
+			state32 = XXH32_createState();
+		else
+			state64 = XXH64_createState();
+
+		if (state32 == nullptr && state64 == nullptr)
+			throw love::Exception("Out of memory.");
+
+		reset();
+	}
+
+	virtual ~XXHashState()
+	{
+		if (state32 != nullptr)
+			XXH32_freeState(state32);
+		if (state64 != nullptr)
+			XXH64_freeState(state64);
+	}
+
+	void update(const char *input, uint64 length) override
+	{
+		if (state32 != nullptr)
+			XXH32_update(state32, input, (size_t) length);
+		else
+			XXH64_update(state64, input, (size_t) length);
+	}
+
+	void finalize(HashFunction::Value &output) const override
+	{
+		if (state32 != nullptr)
+			canonical(XXH32_digest(state32), output);
+		else
+			canonical(XXH64_digest(state64), output);
+	}
+
+	void reset() override
+	{
+		if (state32 != nullptr)
+			XXH32_reset(state32, (unsigned int) seed);
+		else
+			XXH64_reset(state64, seed);
+	}
+
+	static void canonical(XXH32_hash_t hash, HashFunction::Value &output)
+	{
+		XXH32_canonical_t c;
+		XXH32_canonicalFromHash(&c, hash);
+		memcpy(output.data, c.digest, sizeof(c.digest));
+		output.size = sizeof(c.digest);
+	}
+
+	static void canonical(XXH64_hash_t hash, HashFunction::Value &output)
+	{
+		XXH64_canonical_t c;
+		XXH64_canonicalFromHash(&c, hash);
+		memcpy(output.data, c.digest, sizeof(c.digest));
+		output.size = sizeof(c.digest);
+	}
+
+private:
+
+	uint64 seed;
+
+	XXH32_state_t *state32;
+	XXH64_state_t *state64;
+
+}; // XXHashState
+
+class XXHash : public HashFunction
+{
+public:
+	bool isSupported(Function function) const override
+	{
+		return function == FUNCTION_XXH32 || function == FUNCTION_XXH64;
+	}
+
+	void hash(Function function, const char *input, uint64 length, Value &output) const override
+	{
+		if (!isSupported(function))
+			throw love::Exception("Hash function not supported by xxHash implementation");
+
+		if (function == FUNCTION_XXH32)
+			XXHashState::canonical(XXH32(input, (size_t) length, 0), output);
+		else
+			XXHashState::canonical(XXH64(input, (size_t) length, 0), output);
+	}
+
+	State *newState(Function function, uint64 seed) const override
+	{
+		if (!isSupported(function))
+			throw love::Exception("Hash function not supported by xxHash implementation");
+
+		return new XXHashState(function == FUNCTION_XXH32, seed);
+	}
+} xxhash;
+
 } // impl
 }
 
@@ -603,6 +964,9 @@ HashFunction *HashFunction::getHashFunction(Function function)
 	case FUNCTION_SHA384:
 	case FUNCTION_SHA512:
 		return &impl::sha512;
+	case FUNCTION_XXH32:
+	case FUNCTION_XXH64:
+		return &impl::xxhash;
 	case FUNCTION_MAX_ENUM:
 		return nullptr;
 	// No default for compiler warnings
@@ -632,6 +996,8 @@ StringMap<HashFunction::Function, HashFunction::FUNCTION_MAX_ENUM>::Entry HashFu
 	{"sha256", FUNCTION_SHA256},
 	{"sha384", FUNCTION_SHA384},
 	{"sha512", FUNCTION_SHA512},
+	{"xxh32", FUNCTION_XXH32},
+	{"xxh64", FUNCTION_XXH64},
 };
 
 StringMap<HashFunction::Function, HashFunction::FUNCTION_MAX_ENUM> HashFunction::functionNames(HashFunction::functionEntries, sizeof(HashFunction::functionEntries));
@@ -42,6 +42,8 @@ public:
 		FUNCTION_SHA256,
 		FUNCTION_SHA384,
 		FUNCTION_SHA512,
+		FUNCTION_XXH32,
+		FUNCTION_XXH64,
 		FUNCTION_MAX_ENUM
 	};
 
@@ -51,6 +53,27 @@ public:
 		size_t size;
 	};
 
+	/**
+	 * Hashes input incrementally, so it never has to be in memory at once.
+	 **/
+	class State
+	{
+	public:
+
+		virtual ~State() {}
+
+		virtual void update(const char *input, uint64 length) = 0;
+
+		/**
+		 * Gets the hash of all input so far. More input can still be added
+		 * afterward.
+		 **/
+		virtual void finalize(Value &output) const = 0;
+
+		// Discards all input so far.
+		virtual void reset() = 0;
+	};
+
 	/**
 	 * Get a HashFunction instance for the given function.
 	 *
@@ -72,6 +95,15 @@ public:
 	 **/
 	virtual void hash(Function function, const char *input, uint64 length, Value &output) const = 0;
 
+	/**
+	 * Creates a new incremental hashing state, which the caller deletes.
+	 *
+	 * @param[in] function The selected hash function.
+	 * @param[in] seed The seed of non-cryptographic functions. Ignored by the
+	 *            others.
+	 **/
+	virtual State *newState(Function function, uint64 seed) const = 0;
+
 	/**
 	 * @param[in] function The requested hash function.
 	 * @return Whether this HashFunction instance implements the given function.
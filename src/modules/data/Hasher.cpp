@@ -0,0 +1,80 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "Hasher.h"
+#include "common/Exception.h"
+
+namespace love
+{
+namespace data
+{
+
+love::Type Hasher::type("Hasher", &Object::type);
+
+Hasher::Hasher(HashFunction::Function function, uint64 seed)
+	: function(function)
+	, state(nullptr)
+	, size(0)
+{
+	HashFunction *hashfunction = HashFunction::getHashFunction(function);
+	if (hashfunction == nullptr)
+		throw love::Exception("Invalid hash function.");
+
+	if (seed != 0 && function != HashFunction::FUNCTION_XXH32 && function != HashFunction::FUNCTION_XXH64)
+		throw love::Exception("Only the xxh32 and xxh64 hash functions can be seeded.");
+
+	state = hashfunction->newState(function, seed);
+}
+
+Hasher::~Hasher()
+{
+	delete state;
+}
+
+HashFunction::Function Hasher::getFunction() const
+{
+	return function;
+}
+
+void Hasher::update(const void *data, size_t size)
+{
+	state->update((const char *) data, size);
+	this->size += size;
+}
+
+void Hasher::finalize(HashFunction::Value &output) const
+{
+	state->finalize(output);
+}
+
+void Hasher::reset()
+{
+	state->reset();
+	size = 0;
+}
+
+uint64 Hasher::getSize() const
+{
+	return size;
+}
+
+} // data
+} // love
@@ -0,0 +1,79 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/Object.h"
+#include "common/int.h"
+#include "HashFunction.h"
+
+namespace love
+{
+namespace data
+{
+
+/**
+ * Hashes data incrementally, so large or streamed inputs never have to be in
+ * memory at once.
+ **/
+class Hasher : public love::Object
+{
+public:
+
+	static love::Type type;
+
+	/**
+	 * @param seed Only supported by the xxHash functions.
+	 **/
+	Hasher(HashFunction::Function function, uint64 seed = 0);
+	virtual ~Hasher();
+
+	HashFunction::Function getFunction() const;
+
+	/**
+	 * Adds more input to the hash.
+	 **/
+	void update(const void *data, size_t size);
+
+	/**
+	 * Gets the hash of all input so far. More input can still be added
+	 * afterward.
+	 **/
+	void finalize(HashFunction::Value &output) const;
+
+	/**
+	 * Discards all input so far.
+	 **/
+	void reset();
+
+	// Total bytes of input since the Hasher was created or reset.
+	uint64 getSize() const;
+
+private:
+
+	HashFunction::Function function;
+	HashFunction::State *state;
+	uint64 size;
+
+}; // Hasher
+
+} // data
+} // love
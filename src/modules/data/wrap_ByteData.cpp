@@ -20,6 +20,7 @@
 
 #include "wrap_ByteData.h"
 #include "wrap_Data.h"
+#include "DataModule.h"
 #include "common/config.h"
 
 #include <algorithm>
@@ -75,21 +76,26 @@ static int w_ByteData_setT(lua_State *L)
 	if (offset < 0 || offset + sizeof(T) * nargs > t->getSize())
 		return luaL_error(L, "The given offset and value parameters don't fit within the Data's size.");
 
-	auto data = (T *)((uint8 *) t->getData() + offset);
+	// The offset doesn't have to be aligned to the type's size.
+	auto data = (uint8 *) t->getData() + offset;
 
 	if (istable)
 	{
 		for (int i = 0; i < nargs; i++)
 		{
 			lua_rawgeti(L, 3, i + 1);
-			data[i] = (T) luaL_checknumber(L, -1);
+			T v = (T) luaL_checknumber(L, -1);
+			memcpy(data + sizeof(T) * i, &v, sizeof(T));
 			lua_pop(L, 1);
 		}
 	}
 	else
 	{
 		for (int i = 0; i < nargs; i++)
-			data[i] = (T) luaL_checknumber(L, 3 + i);
+		{
+			T v = (T) luaL_checknumber(L, 3 + i);
+			memcpy(data + sizeof(T) * i, &v, sizeof(T));
+		}
 	}
 
 	return 0;
@@ -135,6 +141,199 @@ int w_ByteData_setUInt32(lua_State *L)
 	return w_ByteData_setT<uint32>(L);
 }
 
+template <typename T>
+static void luax_setarray(lua_State *L, uint8 *data, int count, int tableidx, int start)
+{
+	for (int i = 0; i < count; i++)
+	{
+		lua_rawgeti(L, tableidx, start + i);
+		T v = (T) luaL_checknumber(L, -1);
+		memcpy(data + sizeof(T) * i, &v, sizeof(T));
+		lua_pop(L, 1);
+	}
+}
+
+int w_ByteData_setArray(lua_State *L)
+{
+	ByteData *t = luax_checkbytedata(L, 1);
+
+	const char *typestr = luaL_checkstring(L, 2);
+	ArrayType type;
+	if (!getConstant(typestr, type))
+		return luax_enumerror(L, "array type", getConstants(type), typestr);
+
+	int64 offset = (int64) luaL_checknumber(L, 3);
+	luaL_checktype(L, 4, LUA_TTABLE);
+
+	int start = (int) luaL_optinteger(L, 5, 1);
+	int64 count = lua_isnoneornil(L, 6)
+		? (int64) luax_objlen(L, 4) - start + 1
+		: (int64) luaL_checknumber(L, 6);
+
+	if (count < 0)
+		return luaL_error(L, "Invalid count parameter (must not be negative)");
+
+	size_t typesize = getArrayTypeSize(type);
+
+	if (offset < 0 || offset + (int64) typesize * count > (int64) t->getSize())
+		return luaL_error(L, "The given offset and values don't fit within the Data's size.");
+
+	auto data = (uint8 *) t->getData() + offset;
+
+	switch (type)
+	{
+	case ARRAY_FLOAT:
+		luax_setarray<float>(L, data, (int) count, 4, start);
+		break;
+	case ARRAY_DOUBLE:
+		luax_setarray<double>(L, data, (int) count, 4, start);
+		break;
+	case ARRAY_INT8:
+		luax_setarray<int8>(L, data, (int) count, 4, start);
+		break;
+	case ARRAY_UINT8:
+		luax_setarray<uint8>(L, data, (int) count, 4, start);
+		break;
+	case ARRAY_INT16:
+		luax_setarray<int16>(L, data, (int) count, 4, start);
+		break;
+	case ARRAY_UINT16:
+		luax_setarray<uint16>(L, data, (int) count, 4, start);
+		break;
+	case ARRAY_INT32:
+		luax_setarray<int32>(L, data, (int) count, 4, start);
+		break;
+	case ARRAY_UINT32:
+	default:
+		luax_setarray<uint32>(L, data, (int) count, 4, start);
+		break;
+	}
+
+	return 0;
+}
+
+int w_ByteData_copyFrom(lua_State *L)
+{
+	ByteData *t = luax_checkbytedata(L, 1);
+	Data *source = luax_checkdata(L, 2);
+
+	int64 dstoffset = (int64) luaL_optnumber(L, 3, 0);
+	int64 srcoffset = (int64) luaL_optnumber(L, 4, 0);
+	int64 size = lua_isnoneornil(L, 5)
+		? (int64) source->getSize() - srcoffset
+		: (int64) luaL_checknumber(L, 5);
+
+	if (size < 0)
+		return luaL_error(L, "Invalid size parameter (must not be negative)");
+
+	if (srcoffset < 0 || srcoffset + size > (int64) source->getSize())
+		return luaL_error(L, "The given source offset and size don't fit within the source Data's size.");
+
+	if (dstoffset < 0 || dstoffset + size > (int64) t->getSize())
+		return luaL_error(L, "The given offset and size don't fit within the Data's size.");
+
+	// The ranges may overlap when copying within the same Data.
+	memmove((uint8 *) t->getData() + dstoffset, (const uint8 *) source->getData() + srcoffset, (size_t) size);
+	return 0;
+}
+
+// Calls func with a value of the integer type named at the given index.
+template <typename Func>
+static int dispatchAtomicType(lua_State *L, int idx, Func func)
+{
+	const char *typestr = luaL_checkstring(L, idx);
+	ArrayType type;
+	if (!getConstant(typestr, type))
+		return luax_enumerror(L, "array type", getConstants(type), typestr);
+
+	switch (type)
+	{
+	case ARRAY_INT8:
+		return func(int8());
+	case ARRAY_UINT8:
+		return func(uint8());
+	case ARRAY_INT16:
+		return func(int16());
+	case ARRAY_UINT16:
+		return func(uint16());
+	case ARRAY_INT32:
+		return func(int32());
+	case ARRAY_UINT32:
+		return func(uint32());
+	default:
+		return luaL_error(L, "Atomic operations require an integer type (got '%s').", typestr);
+	}
+}
+
+static size_t checkAtomicOffset(lua_State *L, int idx)
+{
+	int64 offset = (int64) luaL_checknumber(L, idx);
+	if (offset < 0)
+		luaL_error(L, "The given offset doesn't fit within the Data's size.");
+	return (size_t) offset;
+}
+
+int w_ByteData_atomicLoad(lua_State *L)
+{
+	ByteData *t = luax_checkbytedata(L, 1);
+	size_t offset = checkAtomicOffset(L, 3);
+
+	return dispatchAtomicType(L, 2, [&](auto zero)
+	{
+		decltype(zero) v = 0;
+		luax_catchexcept(L, [&]() { v = t->atomicLoad<decltype(zero)>(offset); });
+		lua_pushnumber(L, (lua_Number) v);
+		return 1;
+	});
+}
+
+int w_ByteData_atomicStore(lua_State *L)
+{
+	ByteData *t = luax_checkbytedata(L, 1);
+	size_t offset = checkAtomicOffset(L, 3);
+
+	return dispatchAtomicType(L, 2, [&](auto zero)
+	{
+		auto v = (decltype(zero)) luaL_checknumber(L, 4);
+		luax_catchexcept(L, [&]() { t->atomicStore(offset, v); });
+		return 0;
+	});
+}
+
+int w_ByteData_atomicCompareExchange(lua_State *L)
+{
+	ByteData *t = luax_checkbytedata(L, 1);
+	size_t offset = checkAtomicOffset(L, 3);
+
+	return dispatchAtomicType(L, 2, [&](auto zero)
+	{
+		auto expected = (decltype(zero)) luaL_checknumber(L, 4);
+		auto desired = (decltype(zero)) luaL_checknumber(L, 5);
+		bool success = false;
+		luax_catchexcept(L, [&]() { success = t->atomicCompareExchange(offset, expected, desired); });
+
+		// On failure, expected holds the value that was actually there.
+		luax_pushboolean(L, success);
+		lua_pushnumber(L, (lua_Number) expected);
+		return 2;
+	});
+}
+
+int w_ByteData_atomicAdd(lua_State *L)
+{
+	ByteData *t = luax_checkbytedata(L, 1);
+	size_t offset = checkAtomicOffset(L, 3);
+
+	return dispatchAtomicType(L, 2, [&](auto zero)
+	{
+		auto v = (decltype(zero)) luaL_checknumber(L, 4);
+		decltype(zero) old = 0;
+		luax_catchexcept(L, [&]() { old = t->atomicAdd(offset, v); });
+		lua_pushnumber(L, (lua_Number) old);
+		return 1;
+	});
+}
+
 static const luaL_Reg w_ByteData_functions[] =
 {
 	{ "clone", w_ByteData_clone },
@@ -147,6 +346,12 @@ static const luaL_Reg w_ByteData_functions[] =
 	{ "setUInt16", w_ByteData_setUInt16 },
 	{ "setInt32", w_ByteData_setInt32 },
 	{ "setUInt32", w_ByteData_setUInt32 },
+	{ "setArray", w_ByteData_setArray },
+	{ "copyFrom", w_ByteData_copyFrom },
+	{ "atomicLoad", w_ByteData_atomicLoad },
+	{ "atomicStore", w_ByteData_atomicStore },
+	{ "atomicCompareExchange", w_ByteData_atomicCompareExchange },
+	{ "atomicAdd", w_ByteData_atomicAdd },
 	{ 0, 0 }
 };
 
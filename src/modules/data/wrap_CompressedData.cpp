@@ -53,10 +53,18 @@ int w_CompressedData_getFormat(lua_State *L)
 	return 1;
 }
 
+int w_CompressedData_getDecompressedSize(lua_State *L)
+{
+	CompressedData *t = luax_checkcompresseddata(L, 1);
+	lua_pushnumber(L, (lua_Number) t->getDecompressedSize());
+	return 1;
+}
+
 static const luaL_Reg w_CompressedData_functions[] =
 {
 	{ "clone", w_CompressedData_clone },
 	{ "getFormat", w_CompressedData_getFormat },
+	{ "getDecompressedSize", w_CompressedData_getDecompressedSize },
 	{ 0, 0 },
 };
 
@@ -0,0 +1,172 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "wrap_CompressionStream.h"
+#include "wrap_DataModule.h"
+#include "DataModule.h"
+
+// C++
+#include <algorithm>
+#include <vector>
+
+namespace love
+{
+namespace data
+{
+
+#define instance() (Module::getInstance<DataModule>(Module::M_DATA))
+
+CompressionStream *luax_checkcompressionstream(lua_State *L, int idx)
+{
+	return luax_checktype<CompressionStream>(L, idx);
+}
+
+int w_CompressionStream_push(lua_State *L)
+{
+	CompressionStream *t = luax_checkcompressionstream(L, 1);
+
+	size_t size = 0;
+	const char *bytes = nullptr;
+
+	if (luax_istype(L, 2, Data::type))
+	{
+		Data *data = luax_checktype<Data>(L, 2);
+		bytes = (const char *) data->getData();
+		size = data->getSize();
+	}
+	else
+		bytes = luaL_checklstring(L, 2, &size);
+
+	bool finish = luax_optboolean(L, 3, false);
+
+	luax_catchexcept(L, [&]()
+	{
+		t->push(bytes, size);
+		if (finish)
+			t->finish();
+	});
+
+	return 0;
+}
+
+int w_CompressionStream_pull(lua_State *L)
+{
+	CompressionStream *t = luax_checkcompressionstream(L, 1);
+	ContainerType ctype = lua_isnoneornil(L, 2) ? CONTAINER_STRING : luax_checkcontainertype(L, 2);
+
+	size_t size = t->getPendingSize();
+	if (!lua_isnoneornil(L, 3))
+		size = std::min(size, (size_t) std::max(luaL_checkinteger(L, 3), (lua_Integer) 0));
+
+	if (ctype == CONTAINER_DATA)
+	{
+		ByteData *data = nullptr;
+		luax_catchexcept(L, [&]() { data = instance()->newByteData(size); });
+		t->pull(data->getData(), size);
+		luax_pushtype(L, Data::type, data);
+		data->release();
+	}
+	else
+	{
+		std::vector<char> bytes(size);
+		t->pull(bytes.data(), size);
+		lua_pushlstring(L, bytes.data(), size);
+	}
+
+	return 1;
+}
+
+int w_CompressionStream_flush(lua_State *L)
+{
+	CompressionStream *t = luax_checkcompressionstream(L, 1);
+	luax_catchexcept(L, [&]() { t->flush(); });
+	return 0;
+}
+
+int w_CompressionStream_finish(lua_State *L)
+{
+	CompressionStream *t = luax_checkcompressionstream(L, 1);
+	luax_catchexcept(L, [&]() { t->finish(); });
+	return 0;
+}
+
+int w_CompressionStream_isFinished(lua_State *L)
+{
+	CompressionStream *t = luax_checkcompressionstream(L, 1);
+	luax_pushboolean(L, t->isFinished());
+	return 1;
+}
+
+int w_CompressionStream_getPendingSize(lua_State *L)
+{
+	CompressionStream *t = luax_checkcompressionstream(L, 1);
+	lua_pushnumber(L, (lua_Number) t->getPendingSize());
+	return 1;
+}
+
+int w_CompressionStream_getTotals(lua_State *L)
+{
+	CompressionStream *t = luax_checkcompressionstream(L, 1);
+	lua_pushnumber(L, (lua_Number) t->getTotalIn());
+	lua_pushnumber(L, (lua_Number) t->getTotalOut());
+	return 2;
+}
+
+int w_CompressionStream_getFormat(lua_State *L)
+{
+	CompressionStream *t = luax_checkcompressionstream(L, 1);
+
+	const char *fname = nullptr;
+	if (!Compressor::getConstant(t->getFormat(), fname))
+		return luax_enumerror(L, "compressed data format", Compressor::getConstants(Compressor::FORMAT_MAX_ENUM), fname);
+
+	lua_pushstring(L, fname);
+	return 1;
+}
+
+int w_CompressionStream_isCompressing(lua_State *L)
+{
+	CompressionStream *t = luax_checkcompressionstream(L, 1);
+	luax_pushboolean(L, t->getMode() == CompressionStream::MODE_COMPRESS);
+	return 1;
+}
+
+static const luaL_Reg w_CompressionStream_functions[] =
+{
+	{ "push", w_CompressionStream_push },
+	{ "pull", w_CompressionStream_pull },
+	{ "flush", w_CompressionStream_flush },
+	{ "finish", w_CompressionStream_finish },
+	{ "isFinished", w_CompressionStream_isFinished },
+	{ "getPendingSize", w_CompressionStream_getPendingSize },
+	{ "getTotals", w_CompressionStream_getTotals },
+	{ "getFormat", w_CompressionStream_getFormat },
+	{ "isCompressing", w_CompressionStream_isCompressing },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_compressionstream(lua_State *L)
+{
+	return luax_register_type(L, &CompressionStream::type, w_CompressionStream_functions, nullptr);
+}
+
+} // data
+} // love
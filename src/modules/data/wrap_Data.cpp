@@ -19,9 +19,13 @@
  **/
 
 #include "wrap_Data.h"
+#include "DataModule.h"
 #include "common/int.h"
 #include "thread/threads.h"
 
+// C
+#include <string.h>
+
 // Put the Lua code directly into a raw string literal.
 static const char data_lua[] =
 #include "wrap_Data.lua"
@@ -112,10 +116,17 @@ static int w_Data_getT(lua_State* L)
 	if (offset < 0 || offset + sizeof(T) * count > t->getSize())
 		return luaL_error(L, "The given offset and count parameters don't fit within the Data's size.");
 
-	auto data = (const T*)((uint8*)t->getData() + offset);
+	luaL_checkstack(L, count, "too many values to return");
+
+	// The offset doesn't have to be aligned to the type's size.
+	auto data = (const uint8 *) t->getData() + offset;
 
 	for (int i = 0; i < count; i++)
-		lua_pushnumber(L, (lua_Number)data[i]);
+	{
+		T v;
+		memcpy(&v, data + sizeof(T) * i, sizeof(T));
+		lua_pushnumber(L, (lua_Number) v);
+	}
 
 	return count;
 }
@@ -160,6 +171,85 @@ int w_Data_getUInt32(lua_State* L)
 	return w_Data_getT<uint32>(L);
 }
 
+template <typename T>
+static void luax_getarray(lua_State *L, const uint8 *data, int count, int tableidx, int start)
+{
+	for (int i = 0; i < count; i++)
+	{
+		T v;
+		memcpy(&v, data + sizeof(T) * i, sizeof(T));
+		lua_pushnumber(L, (lua_Number) v);
+		lua_rawseti(L, tableidx, start + i);
+	}
+}
+
+int w_Data_getArray(lua_State *L)
+{
+	Data *t = luax_checkdata(L, 1);
+
+	const char *typestr = luaL_checkstring(L, 2);
+	ArrayType type;
+	if (!getConstant(typestr, type))
+		return luax_enumerror(L, "array type", getConstants(type), typestr);
+
+	int64 offset = (int64) luaL_checknumber(L, 3);
+	size_t typesize = getArrayTypeSize(type);
+
+	int64 count = lua_isnoneornil(L, 4)
+		? ((int64) t->getSize() - offset) / (int64) typesize
+		: (int64) luaL_checknumber(L, 4);
+
+	if (count < 0)
+		return luaL_error(L, "Invalid count parameter (must not be negative)");
+
+	if (offset < 0 || offset + (int64) typesize * count > (int64) t->getSize())
+		return luaL_error(L, "The given offset and count parameters don't fit within the Data's size.");
+
+	int start = (int) luaL_optinteger(L, 6, 1);
+
+	if (lua_isnoneornil(L, 5))
+		lua_createtable(L, (int) count, 0);
+	else
+	{
+		luaL_checktype(L, 5, LUA_TTABLE);
+		lua_pushvalue(L, 5);
+	}
+
+	int tableidx = lua_gettop(L);
+	auto data = (const uint8 *) t->getData() + offset;
+
+	switch (type)
+	{
+	case ARRAY_FLOAT:
+		luax_getarray<float>(L, data, (int) count, tableidx, start);
+		break;
+	case ARRAY_DOUBLE:
+		luax_getarray<double>(L, data, (int) count, tableidx, start);
+		break;
+	case ARRAY_INT8:
+		luax_getarray<int8>(L, data, (int) count, tableidx, start);
+		break;
+	case ARRAY_UINT8:
+		luax_getarray<uint8>(L, data, (int) count, tableidx, start);
+		break;
+	case ARRAY_INT16:
+		luax_getarray<int16>(L, data, (int) count, tableidx, start);
+		break;
+	case ARRAY_UINT16:
+		luax_getarray<uint16>(L, data, (int) count, tableidx, start);
+		break;
+	case ARRAY_INT32:
+		luax_getarray<int32>(L, data, (int) count, tableidx, start);
+		break;
+	case ARRAY_UINT32:
+	default:
+		luax_getarray<uint32>(L, data, (int) count, tableidx, start);
+		break;
+	}
+
+	return 1;
+}
+
 // C functions in a struct, necessary for the FFI versions of Data methods.
 struct FFI_Data
 {
@@ -190,6 +280,7 @@ const luaL_Reg w_Data_functions[] =
 	{ "getUInt16", w_Data_getUInt16 },
 	{ "getInt32", w_Data_getInt32 },
 	{ "getUInt32", w_Data_getUInt32 },
+	{ "getArray", w_Data_getArray },
 	{ 0, 0 }
 };
 
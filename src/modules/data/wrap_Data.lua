@@ -22,26 +22,20 @@ misrepresented as being the original software.
 3. This notice may not be removed or altered from any source distribution.
 --]]
 
-local Data_mt, ffifuncspointer_str = ...
+local Data_mt, ffifuncspointer_str, ffiwrapper = ...
 local Data = Data_mt.__index
 
 local type, error = type, error
 
-if type(jit) ~= "table" then return end
-
-local status, ffi = pcall(require, "ffi")
-if not status then return end
-
-pcall(ffi.cdef, [[
-typedef struct Proxy Proxy;
+-- getFFIPointer is useful even when the JIT compiler is disabled.
+if ffiwrapper == nil then return end
 
+local ffifuncs = ffiwrapper.getfuncs("FFI_Data", [[
 typedef struct FFI_Data
 {
 	void *(*getFFIPointer)(Proxy *p);
 } FFI_Data;
-]])
-
-local ffifuncs = ffi.cast("const FFI_Data **", ffifuncspointer_str)[0]
+]], ffifuncspointer_str)
 
 -- Overwrite placeholder method with the FFI implementation.
 
@@ -24,6 +24,8 @@
 #include "wrap_ByteData.h"
 #include "wrap_DataView.h"
 #include "wrap_CompressedData.h"
+#include "wrap_CompressionStream.h"
+#include "wrap_Hasher.h"
 #include "DataModule.h"
 #include "common/b64.h"
 
@@ -113,6 +115,25 @@ int w_newByteData(lua_State *L)
 	return 1;
 }
 
+// Dictionaries can be strings or Data.
+static void luax_optdictionary(lua_State *L, int idx, const char *&dictionary, size_t &size)
+{
+	dictionary = nullptr;
+	size = 0;
+
+	if (lua_isnoneornil(L, idx))
+		return;
+
+	if (luax_istype(L, idx, Data::type))
+	{
+		Data *data = luax_checktype<Data>(L, idx);
+		dictionary = (const char *) data->getData();
+		size = data->getSize();
+	}
+	else
+		dictionary = luaL_checklstring(L, idx, &size);
+}
+
 int w_compress(lua_State *L)
 {
 	ContainerType ctype = luax_checkcontainertype(L, 1);
@@ -136,8 +157,12 @@ int w_compress(lua_State *L)
 		rawbytes = (const char *) rawdata->getData();
 	}
 
+	const char *dictionary = nullptr;
+	size_t dictionarysize = 0;
+	luax_optdictionary(L, 5, dictionary, dictionarysize);
+
 	CompressedData *cdata = nullptr;
-	luax_catchexcept(L, [&](){ cdata = compress(format, rawbytes, rawsize, level); });
+	luax_catchexcept(L, [&](){ cdata = compress(format, rawbytes, rawsize, level, dictionary, dictionarysize); });
 
 	if (ctype == CONTAINER_DATA)
 		luax_pushtype(L, cdata);
@@ -155,11 +180,15 @@ int w_decompress(lua_State *L)
 	char *rawbytes = nullptr;
 	size_t rawsize = 0;
 
+	const char *dictionary = nullptr;
+	size_t dictionarysize = 0;
+
 	if (luax_istype(L, 2, CompressedData::type))
 	{
 		CompressedData *data = luax_checkcompresseddata(L, 2);
+		luax_optdictionary(L, 3, dictionary, dictionarysize);
 		rawsize = data->getDecompressedSize();
-		luax_catchexcept(L, [&](){ rawbytes = decompress(data, rawsize); });
+		luax_catchexcept(L, [&](){ rawbytes = decompress(data, rawsize, dictionary, dictionarysize); });
 	}
 	else
 	{
@@ -172,6 +201,13 @@ int w_decompress(lua_State *L)
 		size_t compressedsize = 0;
 		const char *cbytes = nullptr;
 
+		// An optional size hint saves guessing how big the result will be.
+		lua_Integer sizehint = luaL_optinteger(L, 4, 0);
+		if (sizehint > 0)
+			rawsize = (size_t) sizehint;
+
+		luax_optdictionary(L, 5, dictionary, dictionarysize);
+
 		if (luax_istype(L, 3, Data::type))
 		{
 			Data *data = luax_checktype<Data>(L, 3);
@@ -181,7 +217,7 @@ int w_decompress(lua_State *L)
 		else
 			cbytes = luaL_checklstring(L, 3, &compressedsize);
 
-		luax_catchexcept(L, [&](){ rawbytes = decompress(format, cbytes, compressedsize, rawsize); });
+		luax_catchexcept(L, [&](){ rawbytes = decompress(format, cbytes, compressedsize, rawsize, dictionary, dictionarysize); });
 	}
 
 	if (ctype == CONTAINER_DATA)
@@ -200,10 +236,133 @@ int w_decompress(lua_State *L)
 	return 1;
 }
 
-int w_encode(lua_State *L)
+int w_trainDictionary(lua_State *L)
 {
 	ContainerType ctype = luax_checkcontainertype(L, 1);
 
+	const char *fstr = luaL_checkstring(L, 2);
+	Compressor::Format format = Compressor::FORMAT_ZSTD;
+
+	if (!Compressor::getConstant(fstr, format))
+		return luax_enumerror(L, "compressed data format", Compressor::getConstants(format), fstr);
+
+	luaL_checktype(L, 3, LUA_TTABLE);
+
+	// Zstandard's default dictionary size.
+	size_t maxsize = (size_t) luaL_optinteger(L, 4, 110 * 1024);
+	if (maxsize == 0)
+		return luaL_error(L, "Dictionary size must be greater than 0.");
+
+	std::vector<std::string> samples;
+	int count = (int) luax_objlen(L, 3);
+
+	for (int i = 1; i <= count; i++)
+	{
+		lua_rawgeti(L, 3, i);
+
+		size_t size = 0;
+		const char *bytes = nullptr;
+
+		if (luax_istype(L, -1, Data::type))
+		{
+			Data *data = luax_checktype<Data>(L, -1);
+			bytes = (const char *) data->getData();
+			size = data->getSize();
+		}
+		else
+			bytes = luaL_checklstring(L, -1, &size);
+
+		samples.emplace_back(bytes, size);
+		lua_pop(L, 1);
+	}
+
+	size_t dictionarysize = 0;
+	char *dictionary = nullptr;
+	luax_catchexcept(L, [&]() { dictionary = Compressor::trainDictionary(format, samples, maxsize, dictionarysize); });
+
+	if (ctype == CONTAINER_DATA)
+	{
+		ByteData *data = nullptr;
+		luax_catchexcept(L,
+			[&]() { data = instance()->newByteData(dictionary, dictionarysize); },
+			[&](bool) { delete[] dictionary; }
+		);
+		luax_pushtype(L, Data::type, data);
+		data->release();
+	}
+	else
+	{
+		lua_pushlstring(L, dictionary, dictionarysize);
+		delete[] dictionary;
+	}
+
+	return 1;
+}
+
+static int newCompressionStream(lua_State *L, CompressionStream::Mode mode)
+{
+	const char *fstr = luaL_checkstring(L, 1);
+	Compressor::Format format = Compressor::FORMAT_ZLIB;
+
+	if (!Compressor::getConstant(fstr, format))
+		return luax_enumerror(L, "compressed data format", Compressor::getConstants(format), fstr);
+
+	int level = mode == CompressionStream::MODE_COMPRESS ? (int) luaL_optinteger(L, 2, -1) : -1;
+
+	CompressionStream *stream = nullptr;
+	luax_catchexcept(L, [&]() { stream = instance()->newCompressionStream(mode, format, level); });
+
+	luax_pushtype(L, stream);
+	stream->release();
+	return 1;
+}
+
+int w_newCompressionStream(lua_State *L)
+{
+	return newCompressionStream(L, CompressionStream::MODE_COMPRESS);
+}
+
+int w_newDecompressionStream(lua_State *L)
+{
+	return newCompressionStream(L, CompressionStream::MODE_DECOMPRESS);
+}
+
+int w_newHasher(lua_State *L)
+{
+	const char *fstr = luaL_checkstring(L, 1);
+	HashFunction::Function function = HashFunction::FUNCTION_XXH64;
+
+	if (!HashFunction::getConstant(fstr, function))
+		return luax_enumerror(L, "hash function", HashFunction::getConstants(function), fstr);
+
+	uint64 seed = (uint64) luaL_optnumber(L, 2, 0);
+
+	Hasher *hasher = nullptr;
+	luax_catchexcept(L, [&]() { hasher = instance()->newHasher(function, seed); });
+
+	luax_pushtype(L, hasher);
+	hasher->release();
+	return 1;
+}
+
+// Gets the writable region of a destination Data for encode and decode.
+static char *luax_checkdestination(lua_State *L, int idx, int offsetidx, size_t &dstsize)
+{
+	Data *dstdata = luax_checkdata(L, idx);
+	lua_Integer offset = luaL_optinteger(L, offsetidx, 0);
+
+	if (offset < 0 || (size_t) offset > dstdata->getSize())
+		luaL_error(L, "The given offset doesn't fit within the destination Data's size.");
+
+	dstsize = dstdata->getSize() - (size_t) offset;
+	return (char *) dstdata->getData() + offset;
+}
+
+int w_encode(lua_State *L)
+{
+	bool todata = luax_istype(L, 1, Data::type);
+	ContainerType ctype = todata ? CONTAINER_DATA : luax_checkcontainertype(L, 1);
+
 	const char *formatstr = luaL_checkstring(L, 2);
 	EncodeFormat format;
 	if (!getConstant(formatstr, format))
@@ -223,6 +382,16 @@ int w_encode(lua_State *L)
 
 	size_t linelen = (size_t) luaL_optinteger(L, 4, 0);
 
+	if (todata)
+	{
+		size_t dstsize = 0;
+		char *dst = luax_checkdestination(L, 1, 5, dstsize);
+		size_t written = 0;
+		luax_catchexcept(L, [&](){ written = encode(format, src, srclen, dst, dstsize, linelen); });
+		lua_pushinteger(L, (lua_Integer) written);
+		return 1;
+	}
+
 	size_t dstlen = 0;
 	char *dst = nullptr;
 	luax_catchexcept(L, [&](){ dst = encode(format, src, srclen, dstlen, linelen); });
@@ -253,7 +422,8 @@ int w_encode(lua_State *L)
 
 int w_decode(lua_State *L)
 {
-	ContainerType ctype = luax_checkcontainertype(L, 1);
+	bool todata = luax_istype(L, 1, Data::type);
+	ContainerType ctype = todata ? CONTAINER_DATA : luax_checkcontainertype(L, 1);
 
 	const char *formatstr = luaL_checkstring(L, 2);
 	EncodeFormat format;
@@ -272,6 +442,16 @@ int w_decode(lua_State *L)
 	else
 		src = luaL_checklstring(L, 3, &srclen);
 
+	if (todata)
+	{
+		size_t dstsize = 0;
+		char *dst = luax_checkdestination(L, 1, 4, dstsize);
+		size_t written = 0;
+		luax_catchexcept(L, [&](){ written = decode(format, src, srclen, dst, dstsize); });
+		lua_pushinteger(L, (lua_Integer) written);
+		return 1;
+	}
+
 	size_t dstlen = 0;
 	char *dst = nullptr;
 	luax_catchexcept(L, [&](){ dst = decode(format, src, srclen, dstlen); });
@@ -300,6 +480,23 @@ int w_decode(lua_State *L)
 	return 1;
 }
 
+int w_getEncodedSize(lua_State *L)
+{
+	const char *formatstr = luaL_checkstring(L, 1);
+	EncodeFormat format;
+	if (!getConstant(formatstr, format))
+		return luax_enumerror(L, "encode format", getConstants(format), formatstr);
+
+	lua_Integer size = luaL_checkinteger(L, 2);
+	lua_Integer linelen = luaL_optinteger(L, 3, 0);
+
+	if (size < 0 || linelen < 0)
+		return luaL_error(L, "Size and line length must not be negative.");
+
+	lua_pushinteger(L, (lua_Integer) getEncodedSize(format, (size_t) size, (size_t) linelen));
+	return 1;
+}
+
 int w_hash(lua_State *L)
 {
 	int narg = 0; // used to change the arg position when using the deprecated function variant
@@ -422,8 +619,13 @@ static const luaL_Reg functions[] =
 	{ "newByteData", w_newByteData },
 	{ "compress", w_compress },
 	{ "decompress", w_decompress },
+	{ "trainDictionary", w_trainDictionary },
+	{ "newCompressionStream", w_newCompressionStream },
+	{ "newHasher", w_newHasher },
+	{ "newDecompressionStream", w_newDecompressionStream },
 	{ "encode", w_encode },
 	{ "decode", w_decode },
+	{ "getEncodedSize", w_getEncodedSize },
 	{ "hash", w_hash },
 
 	{ "pack", w_pack },
@@ -439,6 +641,8 @@ static const lua_CFunction types[] =
 	luaopen_bytedata,
 	luaopen_dataview,
 	luaopen_compresseddata,
+	luaopen_compressionstream,
+	luaopen_hasher,
 	nullptr
 };
 
@@ -20,6 +20,9 @@
 
 #include "Event.h"
 
+// C++
+#include <new>
+
 using love::thread::Mutex;
 using love::thread::Lock;
 
@@ -28,23 +31,127 @@ namespace love
 namespace event
 {
 
+// Enough for a few frames of high-frequency input without holding on to
+// much memory after a burst.
+static const int MAX_FREE_MESSAGES = 256;
+
+struct FreeMessage
+{
+	FreeMessage *next;
+};
+
+static FreeMessage *freeMessages = nullptr;
+static int freeMessageCount = 0;
+
+static Mutex *getMessagePoolMutex()
+{
+	static love::thread::MutexRef mutex;
+	return mutex;
+}
+
 Message::Message(const std::string &name, const std::vector<Variant> &vargs)
 	: name(name)
-	, args(vargs)
+	, stagedNext(nullptr)
+	, argCount(0)
+{
+	setArgs(vargs.data(), (int) vargs.size());
+}
+
+Message::Message(const std::string &name, const MessageArgs &vargs)
+	: name(name)
+	, stagedNext(nullptr)
+	, argCount(0)
 {
+	setArgs(vargs.data(), vargs.size());
 }
 
 Message::~Message()
 {
+	if (argCount <= MessageArgs::MAX)
+	{
+		Variant *args = (Variant *) inlineArgs;
+		for (int i = 0; i < argCount; i++)
+			args[i].~Variant();
+	}
+}
+
+void Message::setArgs(const Variant *vargs, int count)
+{
+	if (count > MessageArgs::MAX)
+		extraArgs.assign(vargs, vargs + count);
+	else
+	{
+		Variant *args = (Variant *) inlineArgs;
+		for (int i = 0; i < count; i++)
+			new (&args[i]) Variant(vargs[i]);
+	}
+
+	argCount = count;
+}
+
+const Variant *Message::getArgs() const
+{
+	if (argCount > MessageArgs::MAX)
+		return extraArgs.data();
+	return (const Variant *) inlineArgs;
+}
+
+void *Message::operator new(size_t size)
+{
+	if (size == sizeof(Message))
+	{
+		Lock lock(getMessagePoolMutex());
+		if (freeMessages != nullptr)
+		{
+			FreeMessage *mem = freeMessages;
+			freeMessages = mem->next;
+			freeMessageCount--;
+			return mem;
+		}
+	}
+
+	return ::operator new(size);
+}
+
+void Message::operator delete(void *mem, size_t size)
+{
+	if (mem == nullptr)
+		return;
+
+	if (size == sizeof(Message))
+	{
+		Lock lock(getMessagePoolMutex());
+		if (freeMessageCount < MAX_FREE_MESSAGES)
+		{
+			FreeMessage *freemem = (FreeMessage *) mem;
+			freemem->next = freeMessages;
+			freeMessages = freemem;
+			freeMessageCount++;
+			return;
+		}
+	}
+
+	::operator delete(mem);
 }
 
 Event::Event(const char *name)
 	: Module(M_EVENT, name)
+	, stagedMessages(nullptr)
+	, waiters(0)
 {
+	for (int i = 0; i < COALESCED_MAX_ENUM; i++)
+		coalesced[i] = false;
 }
 
 Event::~Event()
 {
+	Message *msg = stagedMessages.exchange(nullptr, std::memory_order_acquire);
+	while (msg != nullptr)
+	{
+		Message *next = msg->stagedNext;
+		msg->release();
+		msg = next;
+	}
 }
 
 void Event::push(Message *msg)
@@ -52,10 +159,62 @@ void Event::push(Message *msg)
 	Lock lock(mutex);
 	msg->retain();
 	queue.push(msg);
+
+	// Messages from other threads (love.event.push, thread errors, file
+	// changes) should end a wait right away. wait checks the queue with the
+	// mutex held after registering itself, so this can't miss it.
+	if (waiters.load() > 0)
+		wake();
+}
+
+void Event::pushStaged(Message *msg)
+{
+	msg->retain();
+
+	Message *head = stagedMessages.load(std::memory_order_relaxed);
+	do
+	{
+		msg->stagedNext = head;
+	} while (!stagedMessages.compare_exchange_weak(head, msg, std::memory_order_release, std::memory_order_relaxed));
+
+	// Same as push: a wait in progress checks the staging list after
+	// registering itself, so this can't miss it.
+	if (waiters.load() > 0)
+		wake();
+}
+
+void Event::drainStaged()
+{
+	if (stagedMessages.load(std::memory_order_relaxed) == nullptr)
+		return;
+
+	Message *msg = stagedMessages.exchange(nullptr, std::memory_order_acquire);
+
+	// The list is newest first, so reverse it.
+	Message *ordered = nullptr;
+	while (msg != nullptr)
+	{
+		Message *next = msg->stagedNext;
+		msg->stagedNext = ordered;
+		ordered = msg;
+		msg = next;
+	}
+
+	Lock lock(mutex);
+	while (ordered != nullptr)
+	{
+		Message *next = ordered->stagedNext;
+		ordered->stagedNext = nullptr;
+		// The reference taken by pushStaged is handed over to the queue.
+		queue.push(ordered);
+		ordered = next;
+	}
 }
 
 bool Event::poll(Message *&msg)
 {
+	drainStaged();
+
 	Lock lock(mutex);
 	if (queue.empty())
 		return false;
@@ -64,8 +223,27 @@ bool Event::poll(Message *&msg)
 	return true;
 }
 
+int Event::pollMany(std::vector<Message *> &msgs, int max)
+{
+	drainStaged();
+
+	Lock lock(mutex);
+
+	int count = 0;
+	while (count < max && !queue.empty())
+	{
+		msgs.push_back(queue.front());
+		queue.pop();
+		count++;
+	}
+
+	return count;
+}
+
 void Event::clear()
 {
+	drainStaged();
+
 	Lock lock(mutex);
 	while (!queue.empty())
 	{
@@ -75,5 +253,71 @@ void Event::clear()
 	}
 }
 
+void Event::setCoalesced(CoalescedEvent type, bool enable)
+{
+	coalesced[type] = enable;
+}
+
+bool Event::isCoalesced(CoalescedEvent type) const
+{
+	return coalesced[type];
+}
+
+Message *Event::coalesce(const Message *prev, const Message *next) const
+{
+	if (!coalesced[COALESCED_MOUSEMOVED] && !coalesced[COALESCED_TOUCHMOVED])
+		return nullptr;
+
+	if (prev->name != next->name || prev->getArgCount() != next->getArgCount())
+		return nullptr;
+
+	const Variant *a = prev->getArgs();
+	const Variant *b = next->getArgs();
+
+	// mousemoved: x, y, dx, dy, istouch.
+	// touchmoved: id, x, y, dx, dy, pressure.
+	int deltaindex = 0;
+	if (coalesced[COALESCED_MOUSEMOVED] && next->name == "mousemoved" && next->getArgCount() == 5)
+	{
+		if (a[4].getType() != Variant::BOOLEAN || b[4].getType() != Variant::BOOLEAN
+			|| a[4].getData().boolean != b[4].getData().boolean)
+			return nullptr;
+		deltaindex = 2;
+	}
+	else if (coalesced[COALESCED_TOUCHMOVED] && next->name == "touchmoved" && next->getArgCount() == 6)
+	{
+		if (a[0].getType() != Variant::LUSERDATA || b[0].getType() != Variant::LUSERDATA
+			|| a[0].getData().userdata != b[0].getData().userdata)
+			return nullptr;
+		deltaindex = 3;
+	}
+	else
+		return nullptr;
+
+	for (int i = deltaindex; i < deltaindex + 2; i++)
+	{
+		if (a[i].getType() != Variant::NUMBER || b[i].getType() != Variant::NUMBER)
+			return nullptr;
+	}
+
+	MessageArgs args;
+	for (int i = 0; i < next->getArgCount(); i++)
+	{
+		if (i == deltaindex || i == deltaindex + 1)
+			args.emplace_back(a[i].getData().number + b[i].getData().number);
+		else
+			args.emplace_back(b[i]);
+	}
+
+	return new Message(next->name, args);
+}
+
+STRINGMAP_CLASS_BEGIN(Event, Event::CoalescedEvent, Event::COALESCED_MAX_ENUM, coalescedEvent)
+{
+	{ "mousemoved", Event::COALESCED_MOUSEMOVED },
+	{ "touchmoved", Event::COALESCED_TOUCHMOVED },
+}
+STRINGMAP_CLASS_END(Event, Event::CoalescedEvent, Event::COALESCED_MAX_ENUM, coalescedEvent)
+
 } // event
 } // love
@@ -22,6 +22,7 @@
 #define LOVE_EVENT_EVENT_H
 
 // LOVE
+#include "common/Exception.h"
 #include "common/Module.h"
 #include "common/StringMap.h"
 #include "common/Variant.h"
@@ -29,9 +30,12 @@
 #include "mouse/Mouse.h"
 #include "joystick/Joystick.h"
 #include "thread/threads.h"
+#include "thread/Channel.h"
 
 // C++
+#include <atomic>
 #include <queue>
+#include <utility>
 #include <vector>
 
 namespace love
@@ -39,15 +43,69 @@ namespace love
 namespace event
 {
 
+/**
+ * A fixed-capacity argument list, so Messages for input events can be built
+ * without allocating.
+ **/
+class MessageArgs
+{
+public:
+
+	static const int MAX = 8;
+
+	MessageArgs() : count(0) {}
+
+	template <typename... Args>
+	void emplace_back(Args&&... args)
+	{
+		if (count >= MAX)
+			throw love::Exception("Too many arguments for an event message.");
+		values[count++] = Variant(std::forward<Args>(args)...);
+	}
+
+	int size() const { return count; }
+	const Variant *data() const { return values; }
+
+private:
+
+	Variant values[MAX];
+	int count;
+
+}; // MessageArgs
+
 class Message : public Object
 {
 public:
 
 	Message(const std::string &name, const std::vector<Variant> &vargs = {});
+	Message(const std::string &name, const MessageArgs &vargs);
 	~Message();
 
+	int getArgCount() const { return argCount; }
+	const Variant *getArgs() const;
+
+	/**
+	 * Messages are recycled through a free list rather than the heap, since
+	 * high-frequency input can create thousands of them per second.
+	 **/
+	static void *operator new(size_t size);
+	static void operator delete(void *mem, size_t size);
+
 	const std::string name;
-	const std::vector<Variant> args;
+
+private:
+
+	friend class Event;
+
+	void setArgs(const Variant *vargs, int count);
+
+	// Next message in Event's staging list, while it's there.
+	Message *stagedNext;
+
+	// Up to MessageArgs::MAX arguments are stored inline.
+	alignas(Variant) uint8 inlineArgs[sizeof(Variant) * MessageArgs::MAX];
+	std::vector<Variant> extraArgs;
+	int argCount;
 
 }; // Message
 
@@ -55,22 +113,84 @@ class Event : public Module
 {
 public:
 
+	// Motion messages which can be merged when many arrive at once.
+	enum CoalescedEvent
+	{
+		COALESCED_MOUSEMOVED,
+		COALESCED_TOUCHMOVED,
+		COALESCED_MAX_ENUM
+	};
+
 	virtual ~Event();
 
 	void push(Message *msg);
+
+	/**
+	 * Like push, but without locking: the message goes on a lock-free staging
+	 * list which is moved into the queue in one go by pump and poll on the
+	 * main thread. Safe to call from any thread.
+	 **/
+	void pushStaged(Message *msg);
+
 	bool poll(Message *&msg);
+
+	// Takes up to max queued messages at once, returning how many were taken.
+	int pollMany(std::vector<Message *> &msgs, int max);
 	virtual void clear();
 
 	virtual void pump() = 0;
-	virtual Message *wait() = 0;
+
+	/**
+	 * Waits until there's an event, a value is pushed to one of the Channels,
+	 * one of the sockets has data to read, or the timeout (in seconds) runs
+	 * out. A negative timeout waits forever.
+	 * @return The event, or null if something else ended the wait.
+	 **/
+	virtual Message *wait(double timeout, const std::vector<love::thread::Channel *> &channels, const std::vector<int64> &sockets) = 0;
+
+	/**
+	 * Makes a wait in progress (or the next one) return early. Can be called
+	 * from any thread.
+	 **/
+	virtual void wake() = 0;
+
+	/**
+	 * When enabled, consecutive messages of the type from a single pump are
+	 * merged into one with the latest position and the sum of the deltas.
+	 * touchmoved messages are only merged with ones for the same touch.
+	 **/
+	void setCoalesced(CoalescedEvent type, bool enable);
+	bool isCoalesced(CoalescedEvent type) const;
+
+	STRINGMAP_CLASS_DECLARE(CoalescedEvent);
 
 protected:
 
 	Event(const char *name);
 
+	/**
+	 * Returns a new message combining prev and next if both are motion
+	 * messages which are coalesced and can be merged, otherwise null.
+	 **/
+	Message *coalesce(const Message *prev, const Message *next) const;
+
+	/**
+	 * Moves messages from the staging list into the queue, in the order they
+	 * were pushed.
+	 **/
+	void drainStaged();
+
 	love::thread::MutexRef mutex;
 	std::queue<Message *> queue;
 
+	// Most recently staged message, linked through Message::stagedNext.
+	std::atomic<Message *> stagedMessages;
+
+	// Threads currently inside wait, so push knows when to wake them.
+	std::atomic<int> waiters;
+
+	bool coalesced[COALESCED_MAX_ENUM];
+
 }; // Event
 
 } // event
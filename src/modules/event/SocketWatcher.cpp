@@ -0,0 +1,237 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "SocketWatcher.h"
+#include "Event.h"
+#include "common/config.h"
+#include "common/Exception.h"
+
+#ifdef LOVE_WINDOWS
+#include <winsock2.h>
+#include <ws2tcpip.h>
+typedef SOCKET socket_t;
+typedef WSAPOLLFD pollfd_t;
+#define LOVE_INVALID_SOCKET INVALID_SOCKET
+#define love_poll WSAPoll
+#define love_closesocket closesocket
+#else
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <poll.h>
+#include <unistd.h>
+#include <errno.h>
+typedef int socket_t;
+typedef pollfd pollfd_t;
+#define LOVE_INVALID_SOCKET (-1)
+#define love_poll poll
+#define love_closesocket close
+#endif
+
+namespace love
+{
+namespace event
+{
+
+static socket_t createWakeSocket()
+{
+	socket_t s = socket(AF_INET, SOCK_DGRAM, 0);
+	if (s == LOVE_INVALID_SOCKET)
+		return LOVE_INVALID_SOCKET;
+
+	sockaddr_in addr = {};
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	addr.sin_port = 0;
+
+	socklen_t addrlen = sizeof(addr);
+
+	if (bind(s, (const sockaddr *) &addr, sizeof(addr)) != 0
+		|| getsockname(s, (sockaddr *) &addr, &addrlen) != 0
+		|| connect(s, (const sockaddr *) &addr, sizeof(addr)) != 0)
+	{
+		love_closesocket(s);
+		return LOVE_INVALID_SOCKET;
+	}
+
+	return s;
+}
+
+SocketWatcher::SocketWatcher(Event *event)
+	: event(event)
+	, wakeSocket((int64) LOVE_INVALID_SOCKET)
+	, started(false)
+	, watching(false)
+	, polling(false)
+	, quit(false)
+{
+	threadName = "SocketWatcher";
+
+#ifdef LOVE_WINDOWS
+	WSADATA data;
+	if (WSAStartup(MAKEWORD(2, 2), &data) != 0)
+		throw love::Exception("Could not initialize Winsock.");
+#endif
+
+	socket_t s = createWakeSocket();
+	if (s == LOVE_INVALID_SOCKET)
+	{
+#ifdef LOVE_WINDOWS
+		WSACleanup();
+#endif
+		throw love::Exception("Could not create the socket watcher's wake socket.");
+	}
+
+	wakeSocket = (int64) s;
+}
+
+SocketWatcher::~SocketWatcher()
+{
+	{
+		love::thread::Lock lock(mutex);
+		quit = true;
+		watching = false;
+		if (polling)
+			interrupt();
+		cond->broadcast();
+	}
+
+	if (started)
+		wait();
+
+	love_closesocket((socket_t) wakeSocket);
+
+#ifdef LOVE_WINDOWS
+	WSACleanup();
+#endif
+}
+
+void SocketWatcher::interrupt()
+{
+	char c = 0;
+	send((socket_t) wakeSocket, &c, 1, 0);
+}
+
+void SocketWatcher::begin(const std::vector<int64> &sockets)
+{
+	love::thread::Lock lock(mutex);
+
+	this->sockets = sockets;
+	watching = true;
+
+	if (!started)
+	{
+		if (!start())
+			throw love::Exception("Could not start the socket watcher thread.");
+		started = true;
+	}
+
+	cond->broadcast();
+}
+
+void SocketWatcher::end()
+{
+	love::thread::Lock lock(mutex);
+
+	watching = false;
+
+	if (polling)
+		interrupt();
+
+	while (polling)
+		cond->wait(mutex);
+
+	sockets.clear();
+}
+
+bool SocketWatcher::isAnyReadable(const std::vector<int64> &sockets)
+{
+	if (sockets.empty())
+		return false;
+
+	std::vector<pollfd_t> fds(sockets.size());
+	for (size_t i = 0; i < sockets.size(); i++)
+	{
+		fds[i].fd = (socket_t) sockets[i];
+		fds[i].events = POLLIN;
+		fds[i].revents = 0;
+	}
+
+	int count = love_poll(fds.data(), (unsigned long) fds.size(), 0);
+	return count > 0;
+}
+
+void SocketWatcher::threadFunction()
+{
+	std::vector<pollfd_t> fds;
+
+	love::thread::Lock lock(mutex);
+
+	while (true)
+	{
+		while (!quit && !watching)
+			cond->wait(mutex);
+
+		if (quit)
+			break;
+
+		fds.resize(sockets.size() + 1);
+
+		fds[0].fd = (socket_t) wakeSocket;
+		fds[0].events = POLLIN;
+		fds[0].revents = 0;
+
+		for (size_t i = 0; i < sockets.size(); i++)
+		{
+			fds[i + 1].fd = (socket_t) sockets[i];
+			fds[i + 1].events = POLLIN;
+			fds[i + 1].revents = 0;
+		}
+
+		polling = true;
+		mutex->unlock();
+
+		int count = love_poll(fds.data(), (unsigned long) fds.size(), -1);
+
+		if (count > 0 && fds[0].revents != 0)
+		{
+			char c = 0;
+			recv((socket_t) wakeSocket, &c, 1, 0);
+			count--;
+		}
+
+		mutex->lock();
+		polling = false;
+
+		// A socket which was closed before end() still counts as ready, but
+		// since watching stops after one wake-up this won't spin.
+		if (count != 0 && watching)
+		{
+			watching = false;
+			event->wake();
+		}
+
+		cond->broadcast();
+	}
+}
+
+} // event
+} // love
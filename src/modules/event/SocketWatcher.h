@@ -0,0 +1,93 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_EVENT_SOCKET_WATCHER_H
+#define LOVE_EVENT_SOCKET_WATCHER_H
+
+// LOVE
+#include "common/int.h"
+#include "thread/threads.h"
+
+// C++
+#include <vector>
+
+namespace love
+{
+namespace event
+{
+
+class Event;
+
+/**
+ * Waits for sockets from luasocket, lua-enet or elsewhere to become readable
+ * in a background thread, and wakes up Event::wait when one does. SDL has no
+ * way to wait on its own events and sockets at the same time.
+ **/
+class SocketWatcher : public love::thread::Threadable
+{
+public:
+
+	SocketWatcher(Event *event);
+	virtual ~SocketWatcher();
+
+	/**
+	 * Starts watching the given native socket handles. The Event is woken up
+	 * (once) when any of them has data to read.
+	 **/
+	void begin(const std::vector<int64> &sockets);
+
+	/**
+	 * Stops watching. Once this returns, the background thread no longer uses
+	 * the sockets, so they can be closed.
+	 **/
+	void end();
+
+	/**
+	 * Checks whether any of the sockets has data to read, without blocking.
+	 **/
+	static bool isAnyReadable(const std::vector<int64> &sockets);
+
+	void threadFunction() override;
+
+private:
+
+	// A loopback UDP socket which sends to itself, so the thread can be
+	// interrupted while it's blocked waiting on the sockets.
+	void interrupt();
+
+	Event *event;
+
+	love::thread::MutexRef mutex;
+	love::thread::ConditionalRef cond;
+
+	std::vector<int64> sockets;
+	int64 wakeSocket;
+
+	bool started;
+	bool watching;
+	bool polling;
+	bool quit;
+
+}; // SocketWatcher
+
+} // event
+} // love
+
+#endif // LOVE_EVENT_SOCKET_WATCHER_H
@@ -28,6 +28,7 @@
 #include "graphics/Graphics.h"
 #include "window/Window.h"
 #include "common/Exception.h"
+#include "common/profiler.h"
 #include "audio/Audio.h"
 #include "common/config.h"
 #include "timer/Timer.h"
@@ -158,15 +159,25 @@ static int SDLCALL watchAppEvents(void * /*udata*/, SDL_Event *event)
 
 Event::Event()
 	: love::event::Event("love.event.sdl")
+	, wakeEventType(0)
+	, wakePending(false)
 {
 	if (SDL_InitSubSystem(SDL_INIT_EVENTS) < 0)
 		throw love::Exception("Could not initialize SDL events subsystem (%s)", SDL_GetError());
 
+	// SDL2 returns -1 on failure, SDL3 returns 0.
+	wakeEventType = SDL_RegisterEvents(1);
+	if (wakeEventType == (Uint32) -1)
+		wakeEventType = 0;
+
 	SDL_AddEventWatch(watchAppEvents, this);
 }
 
 Event::~Event()
 {
+	// The watcher thread can call wake, which needs SDL.
+	socketWatcher.set(nullptr);
+
 	SDL_DelEventWatch(watchAppEvents, this);
 	SDL_QuitSubSystem(SDL_INIT_EVENTS);
 }
@@ -175,29 +186,172 @@ void Event::pump()
 {
 	exceptionIfInRenderPass("love.event.pump");
 
+	LOVE_PROFILE_ZONE("Event::pump");
+
+	// Messages pushed from other threads go before this pump's SDL events.
+	drainStaged();
+
 	SDL_Event e;
 
+	// The last converted message is held back until the next one is known,
+	// so consecutive motion messages can be merged before they're queued.
+	Message *pending = nullptr;
+
 	while (SDL_PollEvent(&e))
 	{
+		if (wakeEventType != 0 && e.type == wakeEventType)
+		{
+			wakePending.store(false);
+			continue;
+		}
+
 		Message *msg = convert(e);
-		if (msg)
+		if (msg == nullptr)
+			continue;
+
+		if (pending != nullptr)
 		{
-			push(msg);
-			msg->release();
+			Message *merged = coalesce(pending, msg);
+			if (merged != nullptr)
+			{
+				pending->release();
+				msg->release();
+				pending = merged;
+				continue;
+			}
+
+			push(pending);
+			pending->release();
 		}
+
+		pending = msg;
+	}
+
+	if (pending != nullptr)
+	{
+		push(pending);
+		pending->release();
 	}
 }
 
-Message *Event::wait()
+Message *Event::wait(double timeout, const std::vector<love::thread::Channel *> &channels, const std::vector<int64> &sockets)
 {
 	exceptionIfInRenderPass("love.event.wait");
 
-	SDL_Event e;
+	LOVE_PROFILE_ZONE("Event::wait");
 
-	if (SDL_WaitEvent(&e) != 1)
-		return nullptr;
+	// Register as a waiter before checking anything, so a push or wake from
+	// another thread after the check always interrupts SDL_WaitEvent.
+	struct WaitScope
+	{
+		Event *event;
+		const std::vector<love::thread::Channel *> &channels;
+
+		WaitScope(Event *event, const std::vector<love::thread::Channel *> &channels)
+			: event(event), channels(channels)
+		{
+			event->waiters.fetch_add(1);
+			for (love::thread::Channel *c : channels)
+				c->addEventWatcher();
+		}
+
+		~WaitScope()
+		{
+			for (love::thread::Channel *c : channels)
+				c->removeEventWatcher();
+			event->waiters.fetch_sub(1);
+		}
+	} scope(this, channels);
+
+	double deadline = timeout >= 0 ? love::timer::Timer::getTime() + timeout : -1.0;
+	bool watchingsockets = false;
+
+	Message *msg = nullptr;
+
+	while (true)
+	{
+		// Messages pushed from Lua or other threads come first.
+		if (poll(msg))
+			break;
+
+		bool ready = false;
+		for (love::thread::Channel *c : channels)
+		{
+			if (c->getCount() > 0)
+			{
+				ready = true;
+				break;
+			}
+		}
+
+		if (ready || SocketWatcher::isAnyReadable(sockets))
+			break;
+
+		int ms = -1;
+		if (deadline >= 0)
+		{
+			double remaining = deadline - love::timer::Timer::getTime();
+			if (remaining <= 0)
+				break;
+			ms = (int) std::ceil(remaining * 1000.0);
+		}
+		else if (wakeEventType == 0)
+		{
+			// Without a wake event nothing can interrupt SDL, so check for
+			// Channel and socket activity regularly instead.
+			if (!channels.empty() || !sockets.empty())
+				ms = 10;
+		}
+
+		if (!sockets.empty() && !watchingsockets && wakeEventType != 0)
+		{
+			if (socketWatcher.get() == nullptr)
+				socketWatcher.set(new SocketWatcher(this), Acquire::NORETAIN);
+			socketWatcher->begin(sockets);
+			watchingsockets = true;
+		}
+
+		SDL_Event e;
+		if (SDL_WaitEventTimeout(&e, ms) != 1)
+			continue;
+
+		if (wakeEventType != 0 && e.type == wakeEventType)
+		{
+			wakePending.store(false);
+
+			// The socket watcher only wakes once per begin.
+			if (watchingsockets)
+			{
+				socketWatcher->end();
+				watchingsockets = false;
+			}
 
-	return convert(e);
+			continue;
+		}
+
+		msg = convert(e);
+		if (msg != nullptr)
+			break;
+	}
+
+	if (watchingsockets)
+		socketWatcher->end();
+
+	return msg;
+}
+
+void Event::wake()
+{
+	if (wakeEventType == 0)
+		return;
+
+	// Only one wake event needs to be in SDL's queue at a time.
+	if (wakePending.exchange(true))
+		return;
+
+	SDL_Event e = {};
+	e.type = wakeEventType;
+	SDL_PushEvent(&e);
 }
 
 void Event::clear()
@@ -211,6 +365,8 @@ void Event::clear()
 		// Do nothing with 'e' ...
 	}
 
+	wakePending.store(false);
+
 	love::event::Event::clear();
 }
 
@@ -229,8 +385,7 @@ Message *Event::convert(const SDL_Event &e)
 {
 	Message *msg = nullptr;
 
-	std::vector<Variant> vargs;
-	vargs.reserve(4);
+	MessageArgs vargs;
 
 	love::filesystem::Filesystem *filesystem = nullptr;
 	love::sensor::Sensor *sensorInstance = nullptr;
@@ -565,7 +720,20 @@ Message *Event::convert(const SDL_Event &e)
 #else
 					auto sdltype = SDL_SensorGetType(sensor);
 #endif
-					if (!sensor::Sensor::getConstant(sensor::sdl::Sensor::convert(sdltype), sensorType))
+					sensor::Sensor::SensorType type = sensor::sdl::Sensor::convert(sdltype);
+
+					if (type != sensor::Sensor::SENSOR_MAX_ENUM && sensorInstance->isBatched(type))
+					{
+#if SDL_VERSION_ATLEAST(3, 0, 0)
+						double timestamp = (double) e.sensor.timestamp / 1000000000.0;
+#else
+						double timestamp = (double) e.sensor.timestamp / 1000.0;
+#endif
+						sensorInstance->addSample(type, e.sensor.data, timestamp);
+						break;
+					}
+
+					if (!sensor::Sensor::getConstant(type, sensorType))
 						sensorType = "unknown";
 
 					vargs.emplace_back(sensorType, strlen(sensorType));
@@ -596,8 +764,7 @@ Message *Event::convertJoystickEvent(const SDL_Event &e) const
 
 	Message *msg = nullptr;
 
-	std::vector<Variant> vargs;
-	vargs.reserve(4);
+	MessageArgs vargs;
 
 	love::Type *joysticktype = &love::joystick::Joystick::type;
 	love::joystick::Joystick *stick = nullptr;
@@ -756,8 +923,7 @@ Message *Event::convertWindowEvent(const SDL_Event &e)
 {
 	Message *msg = nullptr;
 
-	std::vector<Variant> vargs;
-	vargs.reserve(4);
+	MessageArgs vargs;
 
 	window::Window *win = nullptr;
 	graphics::Graphics *gfx = nullptr;
@@ -23,6 +23,7 @@
 
 // LOVE
 #include "event/Event.h"
+#include "event/SocketWatcher.h"
 #include "audio/Source.h"
 
 // SDL
@@ -50,11 +51,13 @@ public:
 	void pump();
 
 	/**
-	 * Waits for the next event (indefinitely). Useful for creating games where
-	 * the screen and game state only needs updating when the user interacts with
-	 * the window.
+	 * Waits for the next event. Useful for creating games where the screen and
+	 * game state only needs updating when the user interacts with the window,
+	 * and for servers which only need to wake up when there's network traffic.
 	 **/
-	Message *wait();
+	Message *wait(double timeout, const std::vector<love::thread::Channel *> &channels, const std::vector<int64> &sockets) override;
+
+	void wake() override;
 
 	/**
 	 * Clears the event queue.
@@ -69,6 +72,12 @@ private:
 	Message *convertJoystickEvent(const SDL_Event &e) const;
 	Message *convertWindowEvent(const SDL_Event &e);
 
+	// Registered with SDL, pushed by wake to interrupt SDL_WaitEvent.
+	Uint32 wakeEventType;
+	std::atomic<bool> wakePending;
+
+	StrongRef<SocketWatcher> socketWatcher;
+
 }; // Event
 
 } // sdl
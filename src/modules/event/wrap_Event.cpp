@@ -25,6 +25,7 @@
 #include "sdl/Event.h"
 
 #include <algorithm>
+#include <climits>
 
 // Shove the wrap_Event.lua code directly into a raw string literal.
 static const char event_lua[] =
@@ -42,10 +43,33 @@ static int luax_pushmessage(lua_State *L, const Message &m)
 {
 	luax_pushstring(L, m.name);
 
-	for (const Variant &v : m.args)
-		luax_pushvariant(L, v);
+	const Variant *args = m.getArgs();
+	for (int i = 0; i < m.getArgCount(); i++)
+		luax_pushvariant(L, args[i]);
 
-	return (int) m.args.size() + 1;
+	return m.getArgCount() + 1;
+}
+
+// Fills the table at the top of the stack with {name, args...}.
+static void luax_setmessagetable(lua_State *L, const Message &m)
+{
+	int oldlen = (int) luax_objlen(L, -1);
+
+	luax_pushstring(L, m.name);
+	lua_rawseti(L, -2, 1);
+
+	const Variant *args = m.getArgs();
+	for (int i = 0; i < m.getArgCount(); i++)
+	{
+		luax_pushvariant(L, args[i]);
+		lua_rawseti(L, -2, i + 2);
+	}
+
+	for (int i = m.getArgCount() + 2; i <= oldlen; i++)
+	{
+		lua_pushnil(L);
+		lua_rawseti(L, -2, i);
+	}
 }
 
 static int w_poll_i(lua_State *L)
@@ -63,16 +87,129 @@ static int w_poll_i(lua_State *L)
 	return 0;
 }
 
+int w_pollMany(lua_State *L)
+{
+	int max = (int) luaL_optinteger(L, 1, INT_MAX);
+	if (max < 0)
+		return luaL_argerror(L, 1, "max must not be negative");
+
+	// An existing table (and the event tables inside it) can be passed in, to
+	// avoid creating new ones every frame.
+	bool reuse = !lua_isnoneornil(L, 2);
+	int oldlen = 0;
+	if (reuse)
+	{
+		luaL_checktype(L, 2, LUA_TTABLE);
+		oldlen = (int) luax_objlen(L, 2);
+	}
+
+	std::vector<Message *> msgs;
+	int count = instance()->pollMany(msgs, max);
+
+	if (reuse)
+		lua_pushvalue(L, 2);
+	else
+		lua_createtable(L, count, 0);
+
+	for (int i = 0; i < count; i++)
+	{
+		lua_rawgeti(L, -1, i + 1);
+		if (!lua_istable(L, -1))
+		{
+			lua_pop(L, 1);
+			lua_createtable(L, msgs[i]->getArgCount() + 1, 0);
+			lua_pushvalue(L, -1);
+			lua_rawseti(L, -3, i + 1);
+		}
+
+		luax_setmessagetable(L, *msgs[i]);
+		lua_pop(L, 1);
+		msgs[i]->release();
+	}
+
+	// Clear events left over from a previous, longer batch.
+	for (int i = count + 1; i <= oldlen; i++)
+	{
+		lua_pushnil(L);
+		lua_rawseti(L, -2, i);
+	}
+
+	lua_pushinteger(L, count);
+	return 2;
+}
+
 int w_pump(lua_State *L)
 {
 	luax_catchexcept(L, [&]() { instance()->pump(); });
 	return 0;
 }
 
+// Gets the native socket handle of a luasocket socket (getfd) or lua-enet host
+// (get_socket_fd), or a number.
+static bool luax_tosockethandle(lua_State *L, int idx, int64 &handle)
+{
+	if (lua_type(L, idx) == LUA_TNUMBER)
+	{
+		handle = (int64) lua_tonumber(L, idx);
+		return true;
+	}
+
+	if (!lua_isuserdata(L, idx) || !lua_getmetatable(L, idx))
+		return false;
+	lua_pop(L, 1);
+
+	const char *methods[] = {"getfd", "get_socket_fd"};
+
+	for (const char *method : methods)
+	{
+		lua_getfield(L, idx, method);
+		if (lua_isfunction(L, -1))
+		{
+			lua_pushvalue(L, idx);
+			lua_call(L, 1, 1);
+			bool isnumber = lua_type(L, -1) == LUA_TNUMBER;
+			if (isnumber)
+				handle = (int64) lua_tonumber(L, -1);
+			lua_pop(L, 1);
+			return isnumber && handle >= 0;
+		}
+		lua_pop(L, 1);
+	}
+
+	return false;
+}
+
 int w_wait(lua_State *L)
 {
+	double timeout = luaL_optnumber(L, 1, -1.0);
+
+	std::vector<love::thread::Channel *> channels;
+	std::vector<int64> sockets;
+
+	if (!lua_isnoneornil(L, 2))
+	{
+		luaL_checktype(L, 2, LUA_TTABLE);
+		int count = (int) luax_objlen(L, 2);
+
+		for (int i = 1; i <= count; i++)
+		{
+			lua_rawgeti(L, 2, i);
+
+			int64 handle = 0;
+			if (luax_istype(L, -1, love::thread::Channel::type))
+				channels.push_back(luax_totype<love::thread::Channel>(L, -1));
+			else if (luax_tosockethandle(L, lua_gettop(L), handle))
+				sockets.push_back(handle);
+			else
+				return luaL_error(L, "Value %d in the table is not a Channel or a socket.", i);
+
+			// The table keeps the Channel alive while waiting.
+			lua_pop(L, 1);
+		}
+	}
+
 	Message *m = nullptr;
-	luax_catchexcept(L, [&]() { m = instance()->wait(); });
+	luax_catchexcept(L, [&]() { m = instance()->wait(timeout, channels, sockets); });
 	if (m != nullptr)
 	{
 		int args = luax_pushmessage(L, *m);
@@ -105,7 +242,7 @@ int w_push(lua_State *L)
 
 	StrongRef<Message> m(new Message(name, vargs), Acquire::NORETAIN);
 
-	instance()->push(m);
+	instance()->pushStaged(m);
 	luax_pushboolean(L, true);
 	return 1;
 }
@@ -116,6 +253,29 @@ int w_clear(lua_State *L)
 	return 0;
 }
 
+static Event::CoalescedEvent luax_checkcoalescedevent(lua_State *L, int idx)
+{
+	const char *str = luaL_checkstring(L, idx);
+	Event::CoalescedEvent type = Event::COALESCED_MAX_ENUM;
+	if (!Event::getConstant(str, type))
+		luax_enumerror(L, "coalesced event", Event::getConstants(type), str);
+	return type;
+}
+
+int w_setCoalesced(lua_State *L)
+{
+	Event::CoalescedEvent type = luax_checkcoalescedevent(L, 1);
+	instance()->setCoalesced(type, luax_checkboolean(L, 2));
+	return 0;
+}
+
+int w_isCoalesced(lua_State *L)
+{
+	Event::CoalescedEvent type = luax_checkcoalescedevent(L, 1);
+	luax_pushboolean(L, instance()->isCoalesced(type));
+	return 1;
+}
+
 int w_quit(lua_State *L)
 {
 	luax_catchexcept(L, [&]() {
@@ -153,9 +313,12 @@ static const luaL_Reg functions[] =
 {
 	{ "pump", w_pump },
 	{ "poll_i", w_poll_i },
+	{ "pollMany", w_pollMany },
 	{ "wait", w_wait },
 	{ "push", w_push },
 	{ "clear", w_clear },
+	{ "setCoalesced", w_setCoalesced },
+	{ "isCoalesced", w_isCoalesced },
 	{ "quit", w_quit },
 	{ "restart", w_restart },
 	{ 0, 0 }
@@ -106,6 +106,7 @@ STRINGMAP_CLASS_BEGIN(File, File::BufferMode, File::BUFFER_MAX_ENUM, bufferMode)
 	{ "none", File::BUFFER_NONE },
 	{ "line", File::BUFFER_LINE },
 	{ "full", File::BUFFER_FULL },
+	{ "readahead", File::BUFFER_READAHEAD },
 }
 STRINGMAP_CLASS_END(File, File::BufferMode, File::BUFFER_MAX_ENUM, bufferMode)
 
@@ -64,6 +64,7 @@ public:
 		BUFFER_NONE,
 		BUFFER_LINE,
 		BUFFER_FULL,
+		BUFFER_READAHEAD,
 		BUFFER_MAX_ENUM
 	};
 
@@ -122,6 +123,9 @@ public:
 	 * buffer's capacity is reached.
 	 * In the BUFFER_LINE mode, the file will also write to disk if a newline is
 	 * written.
+	 * In the BUFFER_READAHEAD mode (read mode only), the next part of the file
+	 * is read in the background while the current buffer is consumed. A size of
+	 * 0 uses a default size.
 	 *
 	 * @param bufmode The buffer mode.
 	 * @param size The size in bytes of the buffer.
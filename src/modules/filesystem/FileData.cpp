@@ -24,6 +24,20 @@
 #include <iostream>
 #include <limits>
 
+#ifdef LOVE_WINDOWS
+#include "common/utf8.h"
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <sys/types.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 namespace love
 {
 namespace filesystem
@@ -33,6 +47,9 @@ love::Type FileData::type("FileData", &Data::type);
 
 FileData::FileData(uint64 size, const std::string &filename)
 	: data(nullptr)
+	, mapped(false)
+	, mapBase(nullptr)
+	, mapLength(0)
 	, size((size_t) size)
 	, filename(filename)
 {
@@ -45,19 +62,25 @@ FileData::FileData(uint64 size, const std::string &filename)
 		throw love::Exception("Out of memory.");
 	}
 
-	size_t dotpos = filename.rfind('.');
+	setNames();
+}
 
-	if (dotpos != std::string::npos)
-	{
-		extension = filename.substr(dotpos + 1);
-		name = filename.substr(0, dotpos);
-	}
-	else
-		name = filename;
+FileData::FileData(const std::string &filename)
+	: data(nullptr)
+	, mapped(false)
+	, mapBase(nullptr)
+	, mapLength(0)
+	, size(0)
+	, filename(filename)
+{
+	setNames();
 }
 
 FileData::FileData(const FileData &c)
 	: data(nullptr)
+	, mapped(false)
+	, mapBase(nullptr)
+	, mapLength(0)
 	, size(c.size)
 	, filename(c.filename)
 	, extension(c.extension)
@@ -76,7 +99,152 @@ FileData::FileData(const FileData &c)
 
 FileData::~FileData()
 {
-	delete [] data;
+	if (!mapped)
+		delete [] data;
+#ifdef LOVE_WINDOWS
+	else
+		UnmapViewOfFile(mapBase);
+#else
+	else
+		munmap(mapBase, mapLength);
+#endif
+}
+
+FileData *FileData::map(const std::string &nativepath, const std::string &filename, uint64 offset, uint64 size)
+{
+	void *view = nullptr;
+	uint64 filesize = 0;
+	uint64 alignedoffset = 0;
+	size_t viewlength = 0;
+
+#ifdef LOVE_WINDOWS
+	std::wstring wpath = to_widestr(nativepath);
+
+	HANDLE file = CreateFileW(wpath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return nullptr;
+
+	LARGE_INTEGER largesize = {};
+	if (!GetFileSizeEx(file, &largesize) || largesize.QuadPart <= 0)
+	{
+		CloseHandle(file);
+		return nullptr;
+	}
+
+	filesize = (uint64) largesize.QuadPart;
+#else
+	int fd = open(nativepath.c_str(), O_RDONLY);
+	if (fd == -1)
+		return nullptr;
+
+	struct stat st = {};
+	if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0)
+	{
+		close(fd);
+		return nullptr;
+	}
+
+	filesize = (uint64) st.st_size;
+#endif
+
+	if (size == 0 && offset < filesize)
+		size = filesize - offset;
+
+	// Mappings have to start at a multiple of the allocation granularity.
+#ifdef LOVE_WINDOWS
+	SYSTEM_INFO sysinfo = {};
+	GetSystemInfo(&sysinfo);
+	uint64 granularity = sysinfo.dwAllocationGranularity;
+#else
+	long pagesize = sysconf(_SC_PAGESIZE);
+	uint64 granularity = pagesize > 0 ? (uint64) pagesize : 4096;
+#endif
+
+	alignedoffset = offset - (offset % granularity);
+	uint64 length = size + (offset - alignedoffset);
+
+	bool valid = size > 0 && offset <= filesize && size <= filesize - offset
+		&& length <= (uint64) std::numeric_limits<size_t>::max();
+
+#ifdef LOVE_WINDOWS
+	if (!valid)
+	{
+		CloseHandle(file);
+		return nullptr;
+	}
+
+	viewlength = (size_t) length;
+
+	// Copy-on-write, so writes through getPointer never reach the file. The
+	// view keeps the mapping alive after both handles are closed.
+	HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+	CloseHandle(file);
+
+	if (mapping == nullptr)
+		return nullptr;
+
+	view = MapViewOfFile(mapping, FILE_MAP_COPY, (DWORD) (alignedoffset >> 32), (DWORD) (alignedoffset & 0xFFFFFFFF), viewlength);
+	CloseHandle(mapping);
+
+	if (view == nullptr)
+		return nullptr;
+#else
+	if (!valid)
+	{
+		close(fd);
+		return nullptr;
+	}
+
+	viewlength = (size_t) length;
+
+	// Copy-on-write, so writes through getPointer never reach the file. The
+	// mapping stays valid after the descriptor is closed.
+	view = mmap(nullptr, viewlength, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, (off_t) alignedoffset);
+	close(fd);
+
+	if (view == MAP_FAILED)
+		return nullptr;
+#endif
+
+	FileData *filedata = nullptr;
+	try
+	{
+		filedata = new FileData(filename);
+	}
+	catch (std::bad_alloc &)
+	{
+#ifdef LOVE_WINDOWS
+		UnmapViewOfFile(view);
+#else
+		munmap(view, viewlength);
+#endif
+		throw love::Exception("Out of memory.");
+	}
+
+	filedata->data = (char *) view + (offset - alignedoffset);
+	filedata->size = size;
+	filedata->mapped = true;
+	filedata->mapBase = view;
+	filedata->mapLength = viewlength;
+	return filedata;
+}
+
+bool FileData::isMapped() const
+{
+	return mapped;
+}
+
+void FileData::setNames()
+{
+	size_t dotpos = filename.rfind('.');
+
+	if (dotpos != std::string::npos)
+	{
+		extension = filename.substr(dotpos + 1);
+		name = filename.substr(0, dotpos);
+	}
+	else
+		name = filename;
 }
 
 FileData *FileData::clone() const
@@ -21,6 +21,7 @@
 #pragma once
 
 // LOVE
+#include "common/config.h"
 #include "common/Data.h"
 #include "common/int.h"
 #include "common/Exception.h"
@@ -43,6 +44,22 @@ public:
 
 	virtual ~FileData();
 
+	/**
+	 * Maps the file at the given native path into memory instead of copying
+	 * its contents. Pages are loaded lazily and shared with the OS file cache
+	 * until written to. The file must not be modified on disk while mapped.
+	 *
+	 * @param nativepath The full path of the file on disk.
+	 * @param filename The name used for the FileData's filename and extension.
+	 * @param offset The byte offset of the data to map within the file.
+	 * @param size The number of bytes to map, or 0 for the rest of the file.
+	 * @return The new FileData, or null if the file can't be mapped.
+	 **/
+	static FileData *map(const std::string &nativepath, const std::string &filename, uint64 offset = 0, uint64 size = 0);
+
+	// Whether the data is memory-mapped rather than allocated.
+	bool isMapped() const;
+
 	// Implements Data.
 	FileData *clone() const;
 	void *getData() const;
@@ -54,9 +71,20 @@ public:
 
 private:
 
+	FileData(const std::string &filename);
+
+	void setNames();
+
 	// The actual data.
 	char *data;
 
+	// True when data is a copy-on-write file mapping.
+	bool mapped;
+
+	// The page-aligned start and length of the mapping, when mapped.
+	void *mapBase;
+	size_t mapLength;
+
 	// Size of the data.
 	uint64 size;
 
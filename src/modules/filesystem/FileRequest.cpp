@@ -0,0 +1,179 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "FileRequest.h"
+
+namespace love
+{
+namespace filesystem
+{
+
+love::Type FileRequest::type("FileRequest", &Object::type);
+
+FileRequest::FileRequest(const std::string &filename, int priority)
+	: sequence(0)
+	, filename(filename)
+	, priority(priority)
+	, write(false)
+	, atomic(false)
+	, status(STATUS_PENDING)
+{
+}
+
+FileRequest::FileRequest(const std::string &filename, Data *writeData, bool atomic, int priority)
+	: sequence(0)
+	, filename(filename)
+	, priority(priority)
+	, write(true)
+	, atomic(atomic)
+	, writeData(writeData)
+	, status(STATUS_PENDING)
+{
+}
+
+FileRequest::~FileRequest()
+{
+}
+
+const std::string &FileRequest::getFilename() const
+{
+	return filename;
+}
+
+bool FileRequest::isWrite() const
+{
+	return write;
+}
+
+bool FileRequest::isAtomic() const
+{
+	return atomic;
+}
+
+Data *FileRequest::getWriteData()
+{
+	thread::Lock lock(mutex);
+	return writeData.get();
+}
+
+FileRequest::Status FileRequest::getStatus()
+{
+	thread::Lock lock(mutex);
+	return status;
+}
+
+bool FileRequest::isDone()
+{
+	thread::Lock lock(mutex);
+	return status == STATUS_COMPLETE || status == STATUS_FAILED || status == STATUS_CANCELED;
+}
+
+FileData *FileRequest::getData()
+{
+	thread::Lock lock(mutex);
+	return status == STATUS_COMPLETE ? data.get() : nullptr;
+}
+
+std::string FileRequest::getError()
+{
+	thread::Lock lock(mutex);
+	return error;
+}
+
+void FileRequest::setPriority(int priority)
+{
+	thread::Lock lock(mutex);
+	this->priority = priority;
+}
+
+int FileRequest::getPriority()
+{
+	thread::Lock lock(mutex);
+	return priority;
+}
+
+void FileRequest::cancel()
+{
+	thread::Lock lock(mutex);
+
+	if (status == STATUS_PENDING || status == STATUS_LOADING)
+	{
+		status = STATUS_CANCELED;
+
+		// A write which has already started keeps its own reference.
+		writeData.set(nullptr);
+		cond->broadcast();
+	}
+}
+
+void FileRequest::wait()
+{
+	thread::Lock lock(mutex);
+
+	while (status == STATUS_PENDING || status == STATUS_LOADING)
+		cond->wait(mutex);
+}
+
+bool FileRequest::startLoading()
+{
+	thread::Lock lock(mutex);
+
+	if (status != STATUS_PENDING)
+		return false;
+
+	status = STATUS_LOADING;
+	return true;
+}
+
+void FileRequest::finish(FileData *data, const std::string &error)
+{
+	thread::Lock lock(mutex);
+
+	if (status != STATUS_LOADING)
+		return;
+
+	writeData.set(nullptr);
+
+	if (error.empty())
+	{
+		this->data.set(data);
+		status = STATUS_COMPLETE;
+	}
+	else
+	{
+		this->error = error;
+		status = STATUS_FAILED;
+	}
+
+	cond->broadcast();
+}
+
+STRINGMAP_CLASS_BEGIN(FileRequest, FileRequest::Status, FileRequest::STATUS_MAX_ENUM, status)
+{
+	{ "pending",  FileRequest::STATUS_PENDING  },
+	{ "loading",  FileRequest::STATUS_LOADING  },
+	{ "complete", FileRequest::STATUS_COMPLETE },
+	{ "failed",   FileRequest::STATUS_FAILED   },
+	{ "canceled", FileRequest::STATUS_CANCELED },
+}
+STRINGMAP_CLASS_END(FileRequest, FileRequest::Status, FileRequest::STATUS_MAX_ENUM, status)
+
+} // filesystem
+} // love
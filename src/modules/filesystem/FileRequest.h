@@ -0,0 +1,127 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_FILESYSTEM_FILE_REQUEST_H
+#define LOVE_FILESYSTEM_FILE_REQUEST_H
+
+// LOVE
+#include "common/Object.h"
+#include "common/StringMap.h"
+#include "thread/threads.h"
+#include "FileData.h"
+
+// STD
+#include <string>
+
+namespace love
+{
+namespace filesystem
+{
+
+/**
+ * An asynchronous read or write of a whole file, which is processed by an
+ * IOQueue. All methods can be called from any thread.
+ **/
+class FileRequest : public love::Object
+{
+public:
+
+	static love::Type type;
+
+	enum Status
+	{
+		STATUS_PENDING,
+		STATUS_LOADING,
+		STATUS_COMPLETE,
+		STATUS_FAILED,
+		STATUS_CANCELED,
+		STATUS_MAX_ENUM
+	};
+
+	FileRequest(const std::string &filename, int priority);
+	FileRequest(const std::string &filename, Data *writeData, bool atomic, int priority);
+	virtual ~FileRequest();
+
+	const std::string &getFilename() const;
+
+	bool isWrite() const;
+	bool isAtomic() const;
+
+	/**
+	 * Gets the data to be written, or null once a write request is done.
+	 **/
+	Data *getWriteData();
+
+	Status getStatus();
+
+	// Whether the request has finished, failed, or been canceled.
+	bool isDone();
+
+	/**
+	 * Gets the loaded data, or null if the request isn't a complete read.
+	 **/
+	FileData *getData();
+	std::string getError();
+
+	void setPriority(int priority);
+	int getPriority();
+
+	/**
+	 * Cancels the request if it isn't done yet. A read which has already
+	 * started still runs to completion, but its result is discarded.
+	 **/
+	void cancel();
+
+	/**
+	 * Blocks until the request is done.
+	 **/
+	void wait();
+
+	// Called by the IOQueue.
+	bool startLoading();
+	void finish(FileData *data, const std::string &error);
+
+	// Used to keep requests with the same priority in FIFO order.
+	uint64 sequence;
+
+	STRINGMAP_CLASS_DECLARE(Status);
+
+private:
+
+	std::string filename;
+	int priority;
+
+	bool write;
+	bool atomic;
+	StrongRef<Data> writeData;
+
+	Status status;
+	StrongRef<FileData> data;
+	std::string error;
+
+	love::thread::MutexRef mutex;
+	love::thread::ConditionalRef cond;
+
+}; // FileRequest
+
+} // filesystem
+} // love
+
+#endif // LOVE_FILESYSTEM_FILE_REQUEST_H
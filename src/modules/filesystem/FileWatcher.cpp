@@ -0,0 +1,750 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "FileWatcher.h"
+#include "event/Event.h"
+#include "common/Variant.h"
+
+// STD
+#include <algorithm>
+#include <map>
+
+#if defined(LOVE_WINDOWS) && !defined(LOVE_WINDOWS_UWP)
+#	define LOVE_FILEWATCHER_WINDOWS
+#	include "common/utf8.h"
+#	ifndef WIN32_LEAN_AND_MEAN
+#		define WIN32_LEAN_AND_MEAN
+#	endif
+#	include <windows.h>
+#elif defined(LOVE_MACOS)
+#	define LOVE_FILEWATCHER_FSEVENTS
+#	include <CoreServices/CoreServices.h>
+#	include <dispatch/dispatch.h>
+#	include <limits.h>
+#	include <stdlib.h>
+#	include <sys/stat.h>
+#elif defined(__linux__)
+#	define LOVE_FILEWATCHER_INOTIFY
+#	include <dirent.h>
+#	include <errno.h>
+#	include <fcntl.h>
+#	include <poll.h>
+#	include <sys/inotify.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif
+
+namespace love
+{
+namespace filesystem
+{
+
+struct FileWatcher::Watch
+{
+	std::string key;
+	std::string nativeDir;
+	std::string virtualDir;
+	std::string fileName;
+	bool recursive = true;
+
+#if defined(LOVE_FILEWATCHER_WINDOWS)
+	HANDLE handle = INVALID_HANDLE_VALUE;
+	OVERLAPPED overlapped = {};
+	DWORD buffer[16384];
+	bool pending = false;
+#elif defined(LOVE_FILEWATCHER_FSEVENTS)
+	// FSEvents reports paths with symlinks resolved.
+	std::string realDir;
+	FSEventStreamRef stream = nullptr;
+#endif
+};
+
+static std::string joinPath(const std::string &dir, const std::string &name)
+{
+	if (dir.empty())
+		return name;
+	return dir + "/" + name;
+}
+
+#if defined(LOVE_FILEWATCHER_INOTIFY)
+
+struct FileWatcher::Backend : public love::thread::Threadable
+{
+	struct Directory
+	{
+		Watch *watch;
+		std::string path;
+	};
+
+	static const uint32_t EVENT_MASK = IN_CREATE | IN_DELETE | IN_MODIFY | IN_CLOSE_WRITE | IN_MOVED_FROM | IN_MOVED_TO;
+
+	FileWatcher *watcher;
+	int fd = -1;
+	int wakefds[2] = {-1, -1};
+
+	// Watch descriptors are per directory inode, so several watches can share
+	// one. Guarded by the FileWatcher's mutex.
+	std::map<int, std::vector<Directory>> directories;
+
+	Backend(FileWatcher *watcher)
+		: watcher(watcher)
+	{
+		threadName = "FileWatcher";
+
+		fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if (fd == -1)
+			throw love::Exception("Could not initialize inotify.");
+
+		if (pipe(wakefds) != 0)
+		{
+			close(fd);
+			throw love::Exception("Could not create the file watcher's wake pipe.");
+		}
+	}
+
+	virtual ~Backend()
+	{
+		close(wakefds[0]);
+		close(wakefds[1]);
+		close(fd);
+	}
+
+	void stop()
+	{
+		if (write(wakefds[1], "x", 1) == 1)
+			wait();
+	}
+
+	// Called with the FileWatcher's mutex held.
+	bool add(Watch *watch)
+	{
+		return addDirectory(watch, watch->nativeDir, "");
+	}
+
+	bool addDirectory(Watch *watch, const std::string &nativepath, const std::string &relative)
+	{
+		int wd = inotify_add_watch(fd, nativepath.c_str(), EVENT_MASK | IN_ONLYDIR);
+		if (wd == -1)
+			return false;
+
+		directories[wd].push_back({watch, relative});
+
+		if (!watch->recursive)
+			return true;
+
+		// inotify isn't recursive, so every subdirectory needs its own watch.
+		DIR *dir = opendir(nativepath.c_str());
+		if (dir == nullptr)
+			return true;
+
+		while (dirent *entry = readdir(dir))
+		{
+			if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+				continue;
+
+			struct stat buf;
+			if (fstatat(dirfd(dir), entry->d_name, &buf, AT_SYMLINK_NOFOLLOW) == 0 && S_ISDIR(buf.st_mode))
+				addDirectory(watch, nativepath + "/" + entry->d_name, joinPath(relative, entry->d_name));
+		}
+
+		closedir(dir);
+		return true;
+	}
+
+	void remove(Watch *watch)
+	{
+		for (auto it = directories.begin(); it != directories.end();)
+		{
+			auto &list = it->second;
+			list.erase(std::remove_if(list.begin(), list.end(), [&](const Directory &d) { return d.watch == watch; }), list.end());
+
+			if (list.empty())
+			{
+				inotify_rm_watch(fd, it->first);
+				it = directories.erase(it);
+			}
+			else
+				++it;
+		}
+
+		delete watch;
+	}
+
+	void threadFunction() override
+	{
+		alignas(struct inotify_event) char buffer[16384];
+
+		pollfd fds[2] = {};
+		fds[0].fd = fd;
+		fds[0].events = POLLIN;
+		fds[1].fd = wakefds[0];
+		fds[1].events = POLLIN;
+
+		std::vector<Change> changes;
+
+		while (true)
+		{
+			if (poll(fds, 2, -1) < 0)
+			{
+				if (errno == EINTR)
+					continue;
+				return;
+			}
+
+			if (fds[1].revents != 0)
+				return;
+
+			ssize_t length = read(fd, buffer, sizeof(buffer));
+			if (length <= 0)
+				continue;
+
+			thread::Lock lock(watcher->mutex);
+			changes.clear();
+
+			for (ssize_t offset = 0; offset < length;)
+			{
+				const inotify_event *event = (const inotify_event *) (buffer + offset);
+				offset += sizeof(inotify_event) + event->len;
+
+				auto it = directories.find(event->wd);
+				if (it == directories.end())
+					continue;
+
+				if (event->mask & IN_IGNORED)
+				{
+					// The directory was removed or unmounted.
+					directories.erase(it);
+					continue;
+				}
+
+				if (event->len == 0)
+					continue;
+
+				Action action = ACTION_MODIFIED;
+				if (event->mask & (IN_CREATE | IN_MOVED_TO))
+					action = ACTION_CREATED;
+				else if (event->mask & (IN_DELETE | IN_MOVED_FROM))
+					action = ACTION_REMOVED;
+
+				// Copied since new subdirectories are added to the map below.
+				std::vector<Directory> list = it->second;
+
+				for (const Directory &d : list)
+				{
+					std::string path = joinPath(d.path, event->name);
+
+					if ((event->mask & IN_ISDIR) && action == ACTION_CREATED && d.watch->recursive)
+						addDirectory(d.watch, d.watch->nativeDir + "/" + path, path);
+
+					changes.push_back({d.watch, path, action});
+				}
+			}
+
+			notify(changes);
+		}
+	}
+};
+
+#elif defined(LOVE_FILEWATCHER_WINDOWS)
+
+struct FileWatcher::Backend : public love::thread::Threadable
+{
+	static const DWORD NOTIFY_FILTER = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE;
+
+	// One wait handle is used to wake the thread up.
+	static const size_t MAX_WATCHES = MAXIMUM_WAIT_OBJECTS - 1;
+
+	FileWatcher *watcher;
+	HANDLE wakeEvent;
+	bool stopping = false;
+
+	// Guarded by the FileWatcher's mutex. Watches are only started and closed
+	// on the backend's thread.
+	std::vector<Watch *> active;
+	std::vector<Watch *> removed;
+
+	Backend(FileWatcher *watcher)
+		: watcher(watcher)
+	{
+		threadName = "FileWatcher";
+
+		wakeEvent = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+		if (wakeEvent == nullptr)
+			throw love::Exception("Could not create the file watcher's wake event.");
+	}
+
+	virtual ~Backend()
+	{
+		CloseHandle(wakeEvent);
+	}
+
+	void stop()
+	{
+		{
+			thread::Lock lock(watcher->mutex);
+			stopping = true;
+		}
+
+		SetEvent(wakeEvent);
+		wait();
+	}
+
+	bool add(Watch *watch)
+	{
+		if (active.size() >= MAX_WATCHES)
+			return false;
+
+		std::wstring wpath = to_widestr(watch->nativeDir);
+
+		watch->handle = CreateFileW(wpath.c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+			nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+
+		if (watch->handle == INVALID_HANDLE_VALUE)
+			return false;
+
+		watch->overlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+		if (watch->overlapped.hEvent == nullptr)
+		{
+			CloseHandle(watch->handle);
+			return false;
+		}
+
+		active.push_back(watch);
+		SetEvent(wakeEvent);
+		return true;
+	}
+
+	void remove(Watch *watch)
+	{
+		active.erase(std::remove(active.begin(), active.end(), watch), active.end());
+
+		// Once the thread has stopped, every handle is already closed.
+		if (stopping)
+		{
+			delete watch;
+			return;
+		}
+
+		removed.push_back(watch);
+		SetEvent(wakeEvent);
+	}
+
+	static void close(Watch *watch)
+	{
+		if (watch->pending)
+		{
+			DWORD bytes = 0;
+			CancelIoEx(watch->handle, &watch->overlapped);
+			GetOverlappedResult(watch->handle, &watch->overlapped, &bytes, TRUE);
+			watch->pending = false;
+		}
+
+		CloseHandle(watch->overlapped.hEvent);
+		CloseHandle(watch->handle);
+	}
+
+	static void issue(Watch *watch)
+	{
+		ResetEvent(watch->overlapped.hEvent);
+		watch->pending = ReadDirectoryChangesW(watch->handle, watch->buffer, sizeof(watch->buffer), watch->recursive ? TRUE : FALSE,
+			NOTIFY_FILTER, nullptr, &watch->overlapped, nullptr) != 0;
+	}
+
+	void read(Watch *watch, std::vector<Change> &changes)
+	{
+		DWORD bytes = 0;
+		BOOL success = GetOverlappedResult(watch->handle, &watch->overlapped, &bytes, FALSE);
+		watch->pending = false;
+
+		// Zero bytes means the buffer overflowed and the changes were lost.
+		if (success && bytes > 0)
+		{
+			const uint8 *data = (const uint8 *) watch->buffer;
+
+			while (true)
+			{
+				const FILE_NOTIFY_INFORMATION *info = (const FILE_NOTIFY_INFORMATION *) data;
+
+				std::wstring wname(info->FileName, info->FileNameLength / sizeof(WCHAR));
+				std::string path = to_utf8(wname.c_str());
+				std::replace(path.begin(), path.end(), '\\', '/');
+
+				Action action = ACTION_MODIFIED;
+				if (info->Action == FILE_ACTION_ADDED || info->Action == FILE_ACTION_RENAMED_NEW_NAME)
+					action = ACTION_CREATED;
+				else if (info->Action == FILE_ACTION_REMOVED || info->Action == FILE_ACTION_RENAMED_OLD_NAME)
+					action = ACTION_REMOVED;
+
+				changes.push_back({watch, path, action});
+
+				if (info->NextEntryOffset == 0)
+					break;
+				data += info->NextEntryOffset;
+			}
+		}
+
+		issue(watch);
+	}
+
+	void threadFunction() override
+	{
+		std::vector<HANDLE> handles;
+		std::vector<Watch *> waiting;
+		std::vector<Change> changes;
+
+		while (true)
+		{
+			handles.clear();
+			waiting.clear();
+			handles.push_back(wakeEvent);
+
+			{
+				thread::Lock lock(watcher->mutex);
+
+				for (Watch *watch : removed)
+				{
+					close(watch);
+					delete watch;
+				}
+				removed.clear();
+
+				if (stopping)
+				{
+					for (Watch *watch : active)
+						close(watch);
+					return;
+				}
+
+				for (Watch *watch : active)
+				{
+					if (!watch->pending)
+						issue(watch);
+
+					if (watch->pending)
+					{
+						handles.push_back(watch->overlapped.hEvent);
+						waiting.push_back(watch);
+					}
+				}
+			}
+
+			DWORD result = WaitForMultipleObjects((DWORD) handles.size(), handles.data(), FALSE, INFINITE);
+			if (result == WAIT_FAILED)
+				return;
+
+			DWORD index = result - WAIT_OBJECT_0;
+			if (index == 0 || index >= handles.size())
+				continue;
+
+			thread::Lock lock(watcher->mutex);
+
+			Watch *watch = waiting[index - 1];
+			if (std::find(active.begin(), active.end(), watch) == active.end())
+				continue;
+
+			changes.clear();
+			read(watch, changes);
+			notify(changes);
+		}
+	}
+};
+
+#elif defined(LOVE_FILEWATCHER_FSEVENTS)
+
+struct FileWatcher::Backend
+{
+	FileWatcher *watcher;
+	dispatch_queue_t queue;
+
+	Backend(FileWatcher *watcher)
+		: watcher(watcher)
+	{
+		queue = dispatch_queue_create("org.love2d.filewatcher", DISPATCH_QUEUE_SERIAL);
+		if (queue == nullptr)
+			throw love::Exception("Could not create the file watcher's dispatch queue.");
+	}
+
+	~Backend()
+	{
+		dispatch_release(queue);
+	}
+
+	bool start()
+	{
+		return true;
+	}
+
+	void stop()
+	{
+	}
+
+	static void callback(ConstFSEventStreamRef, void *info, size_t count, void *eventpaths, const FSEventStreamEventFlags *flags, const FSEventStreamEventId *)
+	{
+		Watch *watch = (Watch *) info;
+		const char **paths = (const char **) eventpaths;
+		std::string prefix = watch->realDir + "/";
+
+		std::vector<Change> changes;
+
+		for (size_t i = 0; i < count; i++)
+		{
+			std::string path = paths[i];
+			if (path.compare(0, prefix.size(), prefix) != 0)
+				continue;
+
+			path = path.substr(prefix.size());
+
+			// Flags are coalesced, so whether the item exists now decides
+			// between creation and removal.
+			struct stat buf;
+			bool exists = lstat(paths[i], &buf) == 0;
+
+			FSEventStreamEventFlags f = flags[i];
+			Action action;
+
+			if (!exists && (f & (kFSEventStreamEventFlagItemRemoved | kFSEventStreamEventFlagItemRenamed)))
+				action = ACTION_REMOVED;
+			else if (exists && (f & (kFSEventStreamEventFlagItemCreated | kFSEventStreamEventFlagItemRenamed)))
+				action = ACTION_CREATED;
+			else if (exists && (f & (kFSEventStreamEventFlagItemModified | kFSEventStreamEventFlagItemInodeMetaMod)))
+				action = ACTION_MODIFIED;
+			else
+				continue;
+
+			changes.push_back({watch, path, action});
+		}
+
+		notify(changes);
+	}
+
+	bool add(Watch *watch)
+	{
+		char resolved[PATH_MAX];
+		if (realpath(watch->nativeDir.c_str(), resolved) == nullptr)
+			return false;
+
+		watch->realDir = resolved;
+		while (watch->realDir.size() > 1 && watch->realDir.back() == '/')
+			watch->realDir.pop_back();
+
+		CFStringRef path = CFStringCreateWithCString(kCFAllocatorDefault, watch->realDir.c_str(), kCFStringEncodingUTF8);
+		if (path == nullptr)
+			return false;
+
+		CFArrayRef paths = CFArrayCreate(kCFAllocatorDefault, (const void **) &path, 1, &kCFTypeArrayCallBacks);
+		CFRelease(path);
+
+		FSEventStreamContext context = {0, watch, nullptr, nullptr, nullptr};
+		FSEventStreamCreateFlags createflags = kFSEventStreamCreateFlagFileEvents | kFSEventStreamCreateFlagNoDefer;
+
+		watch->stream = FSEventStreamCreate(kCFAllocatorDefault, callback, &context, paths, kFSEventStreamEventIdSinceNow, 0.05, createflags);
+		CFRelease(paths);
+
+		if (watch->stream == nullptr)
+			return false;
+
+		FSEventStreamSetDispatchQueue(watch->stream, queue);
+
+		if (!FSEventStreamStart(watch->stream))
+		{
+			FSEventStreamInvalidate(watch->stream);
+			FSEventStreamRelease(watch->stream);
+			return false;
+		}
+
+		return true;
+	}
+
+	void remove(Watch *watch)
+	{
+		FSEventStreamStop(watch->stream);
+		FSEventStreamInvalidate(watch->stream);
+		FSEventStreamRelease(watch->stream);
+
+		// Wait for a callback that's already running. Callbacks don't take the
+		// FileWatcher's mutex, so this can't deadlock.
+		dispatch_sync_f(queue, nullptr, [](void *) {});
+
+		delete watch;
+	}
+};
+
+#else
+
+// No file change notifications on this platform.
+struct FileWatcher::Backend
+{
+	Backend(FileWatcher *)
+	{
+		throw love::Exception("File watching is not supported on this platform.");
+	}
+
+	bool start() { return false; }
+	void stop() {}
+	bool add(Watch *) { return false; }
+	void remove(Watch *watch) { delete watch; }
+};
+
+#endif
+
+void FileWatcher::destroyBackend()
+{
+#if defined(LOVE_FILEWATCHER_INOTIFY) || defined(LOVE_FILEWATCHER_WINDOWS)
+	backend->release();
+#else
+	delete backend;
+#endif
+	backend = nullptr;
+}
+
+FileWatcher::FileWatcher()
+	: backend(nullptr)
+{
+}
+
+FileWatcher::~FileWatcher()
+{
+	if (backend == nullptr)
+		return;
+
+	backend->stop();
+
+	{
+		thread::Lock lock(mutex);
+		for (Watch *watch : watches)
+			backend->remove(watch);
+		watches.clear();
+	}
+
+	destroyBackend();
+}
+
+bool FileWatcher::isSupported()
+{
+#if defined(LOVE_FILEWATCHER_INOTIFY) || defined(LOVE_FILEWATCHER_WINDOWS) || defined(LOVE_FILEWATCHER_FSEVENTS)
+	return true;
+#else
+	return false;
+#endif
+}
+
+bool FileWatcher::addWatch(const std::string &key, const std::string &nativedir, const std::string &virtualdir, const std::string &filename)
+{
+	thread::Lock lock(mutex);
+
+	for (Watch *watch : watches)
+	{
+		if (watch->key == key && watch->nativeDir == nativedir && watch->fileName == filename)
+			return true;
+	}
+
+	if (backend == nullptr)
+	{
+		backend = new Backend(this);
+		if (!backend->start())
+		{
+			destroyBackend();
+			throw love::Exception("Could not start the file watcher.");
+		}
+	}
+
+	Watch *watch = new Watch();
+	watch->key = key;
+	watch->nativeDir = nativedir;
+	watch->virtualDir = virtualdir;
+	watch->fileName = filename;
+	watch->recursive = filename.empty();
+
+	if (!backend->add(watch))
+	{
+		delete watch;
+		return false;
+	}
+
+	watches.push_back(watch);
+	return true;
+}
+
+bool FileWatcher::removeWatches(const std::string &key)
+{
+	thread::Lock lock(mutex);
+
+	bool found = false;
+
+	for (auto it = watches.begin(); it != watches.end();)
+	{
+		if ((*it)->key == key)
+		{
+			backend->remove(*it);
+			it = watches.erase(it);
+			found = true;
+		}
+		else
+			++it;
+	}
+
+	return found;
+}
+
+void FileWatcher::notify(const std::vector<Change> &changes)
+{
+	auto eventmodule = Module::getInstance<event::Event>(Module::M_EVENT);
+	if (eventmodule == nullptr)
+		return;
+
+	const Change *previous = nullptr;
+
+	for (const Change &change : changes)
+	{
+		if (previous != nullptr && previous->watch == change.watch && previous->action == change.action && previous->path == change.path)
+			continue;
+
+		previous = &change;
+
+		const Watch *watch = change.watch;
+		if (!watch->fileName.empty() && change.path != watch->fileName)
+			continue;
+
+		const char *actionstr = nullptr;
+		if (!getConstant(change.action, actionstr))
+			continue;
+
+		std::string path = joinPath(watch->virtualDir, change.path);
+
+		std::vector<Variant> vargs = {
+			Variant(path),
+			Variant(actionstr, strlen(actionstr)),
+		};
+
+		StrongRef<event::Message> msg(new event::Message("filechanged", vargs), Acquire::NORETAIN);
+		eventmodule->push(msg);
+	}
+}
+
+STRINGMAP_CLASS_BEGIN(FileWatcher, FileWatcher::Action, FileWatcher::ACTION_MAX_ENUM, action)
+{
+	{ "created",  FileWatcher::ACTION_CREATED  },
+	{ "modified", FileWatcher::ACTION_MODIFIED },
+	{ "removed",  FileWatcher::ACTION_REMOVED  },
+}
+STRINGMAP_CLASS_END(FileWatcher, FileWatcher::Action, FileWatcher::ACTION_MAX_ENUM, action)
+
+} // filesystem
+} // love
@@ -0,0 +1,115 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_FILESYSTEM_FILE_WATCHER_H
+#define LOVE_FILESYSTEM_FILE_WATCHER_H
+
+// LOVE
+#include "common/config.h"
+#include "common/StringMap.h"
+#include "thread/threads.h"
+
+// STD
+#include <string>
+#include <vector>
+
+namespace love
+{
+namespace filesystem
+{
+
+/**
+ * Watches native directories for changes using the OS's notification API
+ * (inotify, FSEvents or ReadDirectoryChangesW), and pushes a 'filechanged'
+ * event for each change. Nothing is polled, so watching costs nothing while
+ * files stay the same.
+ **/
+class FileWatcher
+{
+public:
+
+	enum Action
+	{
+		ACTION_CREATED,
+		ACTION_MODIFIED,
+		ACTION_REMOVED,
+		ACTION_MAX_ENUM
+	};
+
+	FileWatcher();
+	~FileWatcher();
+
+	/**
+	 * Whether file watching works on this platform.
+	 **/
+	static bool isSupported();
+
+	/**
+	 * Starts watching a native directory.
+	 *
+	 * @param key The name used to remove the watch later.
+	 * @param nativedir The full path of the directory on disk.
+	 * @param virtualdir The directory's path in love.filesystem, which event
+	 *        paths are given relative to.
+	 * @param filename If not empty, only changes to this file in the
+	 *        directory are reported. Otherwise subdirectories are watched too.
+	 * @return False if the directory can't be watched.
+	 **/
+	bool addWatch(const std::string &key, const std::string &nativedir, const std::string &virtualdir, const std::string &filename);
+
+	/**
+	 * Stops all watches added with the given key.
+	 * @return False if there weren't any.
+	 **/
+	bool removeWatches(const std::string &key);
+
+	STRINGMAP_CLASS_DECLARE(Action);
+
+private:
+
+	struct Watch;
+	struct Backend;
+
+	struct Change
+	{
+		Watch *watch;
+		// Relative to the watch's directory, with '/' separators.
+		std::string path;
+		Action action;
+	};
+
+	// Called by the backend with each batch of changes it reads. Repeats of the
+	// same change in a row (a file written in several chunks) are dropped.
+	static void notify(const std::vector<Change> &changes);
+
+	// Backends with a thread are reference counted, others aren't.
+	void destroyBackend();
+
+	std::vector<Watch *> watches;
+	Backend *backend;
+
+	love::thread::MutexRef mutex;
+
+}; // FileWatcher
+
+} // filesystem
+} // love
+
+#endif // LOVE_FILESYSTEM_FILE_WATCHER_H
@@ -38,6 +38,12 @@
 #include <unistd.h>
 #endif
 
+#ifndef LOVE_WINDOWS
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 // C++17 std::filesystem
 #include <filesystem>
 
@@ -50,6 +56,8 @@ love::Type Filesystem::type("filesystem", &Module::type);
 
 Filesystem::Filesystem(const char *name)
 	: Module(M_FILESYSTEM, name)
+	, useExternal(false)
+	, bytecodeCacheEnabled(false)
 {
 }
 
@@ -67,6 +75,16 @@ bool Filesystem::isAndroidSaveExternal() const
 	return useExternal;
 }
 
+void Filesystem::setBytecodeCacheEnabled(bool enable)
+{
+	bytecodeCacheEnabled = enable;
+}
+
+bool Filesystem::isBytecodeCacheEnabled() const
+{
+	return bytecodeCacheEnabled;
+}
+
 FileData *Filesystem::newFileData(const void *data, size_t size, const char *filename) const
 {
 	FileData *fd = new FileData(size, std::string(filename));
@@ -117,6 +135,110 @@ bool Filesystem::getRealPathType(const std::string &path, FileType &ftype) const
 	return true;
 }
 
+bool Filesystem::getRealDirectoryItems(const std::string &path, bool includeSymlinks, std::vector<DirectoryItem> &items) const
+{
+#ifdef LOVE_WINDOWS
+	std::wstring wpattern = to_widestr(path + "\\*");
+
+	// One call per item returns its name, attributes, size and time together.
+	WIN32_FIND_DATAW data = {};
+	HANDLE find = FindFirstFileExW(wpattern.c_str(), FindExInfoBasic, &data, FindExSearchNameMatch, nullptr, FIND_FIRST_EX_LARGE_FETCH);
+	if (find == INVALID_HANDLE_VALUE)
+		return false;
+
+	do
+	{
+		if (wcscmp(data.cFileName, L".") == 0 || wcscmp(data.cFileName, L"..") == 0)
+			continue;
+
+		DirectoryItem item;
+		item.name = to_utf8(data.cFileName);
+
+		DWORD attributes = data.dwFileAttributes;
+		if (attributes & FILE_ATTRIBUTE_REPARSE_POINT)
+			item.info.type = FILETYPE_SYMLINK;
+		else if (attributes & FILE_ATTRIBUTE_DIRECTORY)
+			item.info.type = FILETYPE_DIRECTORY;
+		else
+			item.info.type = FILETYPE_FILE;
+
+		if (item.info.type == FILETYPE_SYMLINK && !includeSymlinks)
+			continue;
+
+		if (item.info.type == FILETYPE_FILE)
+			item.info.size = (int64) (((uint64) data.nFileSizeHigh << 32) | data.nFileSizeLow);
+		else
+			item.info.size = 0;
+
+		// FILETIMEs count 100ns intervals since 1601.
+		uint64 filetime = ((uint64) data.ftLastWriteTime.dwHighDateTime << 32) | data.ftLastWriteTime.dwLowDateTime;
+		item.info.modtime = filetime >= 116444736000000000ULL ? (int64) ((filetime - 116444736000000000ULL) / 10000000ULL) : -1;
+
+		item.info.readonly = (attributes & FILE_ATTRIBUTE_READONLY) != 0;
+
+		items.push_back(item);
+	} while (FindNextFileW(find, &data));
+
+	FindClose(find);
+	return true;
+#else
+	DIR *dir = opendir(path.c_str());
+	if (dir == nullptr)
+		return false;
+
+	int dirfd = ::dirfd(dir);
+	uid_t uid = geteuid();
+	gid_t gid = getegid();
+
+	while (dirent *entry = readdir(dir))
+	{
+		const char *name = entry->d_name;
+		if (strcmp(name, ".") == 0 || strcmp(name, "..") == 0)
+			continue;
+
+		// Relative to the open directory, so the path isn't resolved again.
+		struct stat buf;
+		if (fstatat(dirfd, name, &buf, AT_SYMLINK_NOFOLLOW) != 0)
+			continue;
+
+		DirectoryItem item;
+		item.name = name;
+
+		if (S_ISREG(buf.st_mode))
+			item.info.type = FILETYPE_FILE;
+		else if (S_ISDIR(buf.st_mode))
+			item.info.type = FILETYPE_DIRECTORY;
+		else if (S_ISLNK(buf.st_mode))
+			item.info.type = FILETYPE_SYMLINK;
+		else
+			item.info.type = FILETYPE_OTHER;
+
+		if (item.info.type == FILETYPE_SYMLINK && !includeSymlinks)
+			continue;
+
+		bool sized = item.info.type == FILETYPE_FILE || item.info.type == FILETYPE_OTHER;
+		item.info.size = sized ? (int64) buf.st_size : 0;
+		item.info.modtime = (int64) buf.st_mtime;
+
+		// Worked out from the permission bits instead of an access() call per
+		// item. Read-only mounts aren't detected.
+		if (uid == 0)
+			item.info.readonly = false;
+		else if (buf.st_uid == uid)
+			item.info.readonly = (buf.st_mode & S_IWUSR) == 0;
+		else if (buf.st_gid == gid)
+			item.info.readonly = (buf.st_mode & S_IWGRP) == 0;
+		else
+			item.info.readonly = (buf.st_mode & S_IWOTH) == 0;
+
+		items.push_back(item);
+	}
+
+	closedir(dir);
+	return true;
+#endif
+}
+
 static bool getContainingDirectory(const std::string &path, std::string &newpath)
 {
 	size_t index = path.find_last_of("/\\");
@@ -27,6 +27,7 @@
 #include "common/int.h"
 #include "common/StringMap.h"
 #include "FileData.h"
+#include "FileRequest.h"
 #include "File.h"
 
 // C++
@@ -106,6 +107,13 @@ public:
 		bool readonly;
 	};
 
+	struct DirectoryItem
+	{
+		// Relative to the enumerated directory, with '/' separators.
+		std::string name;
+		Info info;
+	};
+
 	static love::Type type;
 
 	virtual ~Filesystem();
@@ -251,13 +259,34 @@ public:
 	virtual FileData *read(const char *filename, int64 size) const = 0;
 	virtual FileData *read(const char *filename) const = 0;
 
+	/**
+	 * Starts reading a whole file on a background thread.
+	 * @param filename The name of the file to read from.
+	 * @param priority Requests with higher priorities are read first.
+	 **/
+	virtual FileRequest *readAsync(const char *filename, int priority) = 0;
+
 	/**
 	 * Write data to a file.
 	 * @param filename The name of the file to write to.
 	 * @param data The data to write.
 	 * @param size The size in bytes of the data to write.
+	 * @param atomic Whether to write to a temporary file which is flushed to
+	 *        disk and then renamed over the original, so the file never ends
+	 *        up only partially written.
 	 **/
-	virtual void write(const char *filename, const void *data, int64 size) const = 0;
+	virtual void write(const char *filename, const void *data, int64 size, bool atomic = false) const = 0;
+
+	/**
+	 * Starts writing a whole file on a background thread. The data is
+	 * referenced rather than copied, and must not change until the request
+	 * is done.
+	 * @param filename The name of the file to write to.
+	 * @param data The data to write.
+	 * @param atomic Whether to replace the file atomically, as with write.
+	 * @param priority Requests with higher priorities are processed first.
+	 **/
+	virtual FileRequest *writeAsync(const char *filename, Data *data, bool atomic, int priority) = 0;
 
 	/**
 	 * Append data to a file, creating it if it doesn't exist.
@@ -273,6 +302,26 @@ public:
 	 **/
 	virtual bool getDirectoryItems(const char *dir, std::vector<std::string> &items) = 0;
 
+	/**
+	 * Gets the items in a directory along with their info, in one pass rather
+	 * than a getInfo call per item. In recursive mode the contents of all
+	 * subdirectories are included too, named relative to the given directory.
+	 **/
+	virtual bool getDirectoryInfo(const char *dir, bool recursive, std::vector<DirectoryItem> &items) = 0;
+
+	/**
+	 * Starts watching a file, or a directory and everything in it, for
+	 * changes. Every native directory mounted at the path is watched, and each
+	 * change is pushed as a 'filechanged' event.
+	 * @return False if nothing at the path can be watched.
+	 **/
+	virtual bool watch(const char *path) = 0;
+
+	/**
+	 * Stops watching a path given to watch.
+	 **/
+	virtual bool unwatch(const char *path) = 0;
+
 	/**
 	 * Enable or disable symbolic link support in love.filesystem.
 	 **/
@@ -283,6 +332,13 @@ public:
 	 **/
 	virtual bool areSymlinksEnabled() const = 0;
 
+	/**
+	 * Enable or disable caching the compiled bytecode of Lua files loaded with
+	 * require and love.filesystem.load in the save directory.
+	 **/
+	void setBytecodeCacheEnabled(bool enable);
+	bool isBytecodeCacheEnabled() const;
+
 	// Require path accessors
 	// Not const because it's R/W
 	virtual std::vector<std::string> &getRequirePath() = 0;
@@ -298,6 +354,12 @@ public:
 	 **/
 	virtual bool isRealDirectory(const std::string &path) const;
 
+	/**
+	 * Gets the items in the directory at the given full OS-dependent path, and
+	 * their info as PhysFS would report it (symlinks aren't followed).
+	 **/
+	virtual bool getRealDirectoryItems(const std::string &path, bool includeSymlinks, std::vector<DirectoryItem> &items) const;
+
 	/**
 	 * Recursively creates a directory at the given full OS-dependent path.
 	 **/
@@ -330,6 +392,8 @@ private:
 	// Should we save external or internal for Android
 	bool useExternal;
 
+	bool bytecodeCacheEnabled;
+
 }; // Filesystem
 
 } // filesystem
@@ -0,0 +1,179 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "IOQueue.h"
+#include "Filesystem.h"
+
+namespace love
+{
+namespace filesystem
+{
+
+IOQueue::Worker::Worker(IOQueue *queue)
+	: queue(queue)
+{
+	threadName = "FileIO";
+}
+
+void IOQueue::Worker::threadFunction()
+{
+	while (true)
+	{
+		FileRequest *request = queue->takeRequest();
+		if (request == nullptr)
+			return;
+
+		FileData *data = nullptr;
+		std::string error;
+
+		try
+		{
+			if (request->isWrite())
+			{
+				// Held until the write is done, even if the request is canceled.
+				StrongRef<Data> writedata(request->getWriteData());
+				if (writedata.get() != nullptr)
+					queue->filesystem->write(request->getFilename().c_str(), writedata->getData(), (int64) writedata->getSize(), request->isAtomic());
+			}
+			else
+			{
+				data = queue->filesystem->read(request->getFilename().c_str());
+				if (data == nullptr)
+					error = "File could not be read.";
+			}
+		}
+		catch (love::Exception &e)
+		{
+			error = e.what();
+		}
+
+		request->finish(data, error);
+
+		if (data != nullptr)
+			data->release();
+
+		request->release();
+	}
+}
+
+IOQueue::IOQueue(const Filesystem *filesystem)
+	: filesystem(filesystem)
+	, nextSequence(0)
+	, stopping(false)
+{
+	for (int i = 0; i < WORKER_THREADS; i++)
+	{
+		Worker *worker = new Worker(this);
+		worker->start();
+		workers.push_back(worker);
+	}
+}
+
+IOQueue::~IOQueue()
+{
+	{
+		thread::Lock lock(mutex);
+		stopping = true;
+		cond->broadcast();
+	}
+
+	for (Worker *worker : workers)
+	{
+		worker->wait();
+		delete worker;
+	}
+
+	for (FileRequest *request : requests)
+	{
+		request->cancel();
+		request->release();
+	}
+}
+
+void IOQueue::addRequest(FileRequest *request)
+{
+	thread::Lock lock(mutex);
+
+	request->retain();
+	request->sequence = nextSequence++;
+	requests.push_back(request);
+	cond->signal();
+}
+
+int IOQueue::getPendingCount()
+{
+	thread::Lock lock(mutex);
+	return (int) requests.size();
+}
+
+FileRequest *IOQueue::takeRequest()
+{
+	thread::Lock lock(mutex);
+
+	while (!stopping)
+	{
+		// Priorities can change while a request is queued, so the best one is
+		// found when it's needed rather than by keeping the list sorted.
+		FileRequest *bestrequest = nullptr;
+		size_t best = 0;
+		int bestpriority = 0;
+
+		for (size_t i = 0; i < requests.size(); i++)
+		{
+			FileRequest *request = requests[i];
+
+			if (request->getStatus() != FileRequest::STATUS_PENDING)
+			{
+				// Canceled while queued.
+				request->release();
+				requests.erase(requests.begin() + i);
+				i--;
+				continue;
+			}
+
+			int priority = request->getPriority();
+			if (bestrequest == nullptr || priority > bestpriority
+				|| (priority == bestpriority && request->sequence < bestrequest->sequence))
+			{
+				bestrequest = request;
+				best = i;
+				bestpriority = priority;
+			}
+		}
+
+		if (bestrequest != nullptr)
+		{
+			requests.erase(requests.begin() + best);
+
+			if (bestrequest->startLoading())
+				return bestrequest;
+
+			bestrequest->release();
+			continue;
+		}
+
+		cond->wait(mutex);
+	}
+
+	return nullptr;
+}
+
+} // filesystem
+} // love
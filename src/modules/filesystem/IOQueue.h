@@ -0,0 +1,93 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_FILESYSTEM_IO_QUEUE_H
+#define LOVE_FILESYSTEM_IO_QUEUE_H
+
+// LOVE
+#include "common/config.h"
+#include "thread/threads.h"
+#include "FileRequest.h"
+
+// STD
+#include <vector>
+
+namespace love
+{
+namespace filesystem
+{
+
+class Filesystem;
+
+/**
+ * A small set of worker threads which read or write whole files for
+ * FileRequests, highest priority first. Reads and writes go through
+ * Filesystem::read and Filesystem::write, so they see the same mounted paths
+ * and archives as blocking calls.
+ **/
+class IOQueue
+{
+public:
+
+	IOQueue(const Filesystem *filesystem);
+	~IOQueue();
+
+	void addRequest(FileRequest *request);
+
+	int getPendingCount();
+
+private:
+
+	class Worker : public love::thread::Threadable
+	{
+	public:
+
+		Worker(IOQueue *queue);
+		virtual ~Worker() {}
+
+		void threadFunction() override;
+
+	private:
+
+		IOQueue *queue;
+
+	}; // Worker
+
+	FileRequest *takeRequest();
+
+	static const int WORKER_THREADS = 2;
+
+	const Filesystem *filesystem;
+
+	std::vector<Worker *> workers;
+	std::vector<FileRequest *> requests;
+	uint64 nextSequence;
+
+	love::thread::MutexRef mutex;
+	love::thread::ConditionalRef cond;
+
+	bool stopping;
+
+}; // IOQueue
+
+} // filesystem
+} // love
+
+#endif // LOVE_FILESYSTEM_IO_QUEUE_H
@@ -261,6 +261,10 @@ bool NativeFile::setBuffer(BufferMode bufmode, int64 size)
 	if (size < 0)
 		return false;
 
+	// stdio has no background reads.
+	if (bufmode == BUFFER_READAHEAD)
+		return false;
+
 	if (bufmode == BUFFER_NONE)
 		size = 0;
 
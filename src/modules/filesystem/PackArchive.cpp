@@ -0,0 +1,430 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "PackArchive.h"
+#include "common/Exception.h"
+#include "data/Compressor.h"
+
+// STD
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <deque>
+#include <string.h>
+
+namespace love
+{
+namespace filesystem
+{
+namespace pack
+{
+
+using love::data::Compressor;
+
+namespace
+{
+
+inline uint32 readLE32(const uint8 *src)
+{
+	return (uint32) src[0] | ((uint32) src[1] << 8) | ((uint32) src[2] << 16) | ((uint32) src[3] << 24);
+}
+
+inline uint64 readLE64(const uint8 *src)
+{
+	return (uint64) readLE32(src) | ((uint64) readLE32(src + 4) << 32);
+}
+
+inline void writeLE32(uint8 *dst, uint32 v)
+{
+	dst[0] = (uint8) v;
+	dst[1] = (uint8) (v >> 8);
+	dst[2] = (uint8) (v >> 16);
+	dst[3] = (uint8) (v >> 24);
+}
+
+inline void writeLE64(uint8 *dst, uint64 v)
+{
+	writeLE32(dst, (uint32) v);
+	writeLE32(dst + 4, (uint32) (v >> 32));
+}
+
+inline uint64 alignOffset(uint64 offset)
+{
+	return (offset + ENTRY_ALIGNMENT - 1) & ~(ENTRY_ALIGNMENT - 1);
+}
+
+void writeHeader(uint8 *dst, const Header &header)
+{
+	memset(dst, 0, HEADER_SIZE);
+	writeLE32(dst + 0, header.magic);
+	writeLE32(dst + 4, header.version);
+	writeLE32(dst + 8, header.entryCount);
+	writeLE32(dst + 12, header.hashSlotCount);
+	writeLE64(dst + 16, header.indexOffset);
+	writeLE64(dst + 24, header.indexSize);
+	writeLE32(dst + 32, header.rootFirstChild);
+	writeLE32(dst + 36, header.rootChildCount);
+	writeLE64(dst + 40, (uint64) header.modtime);
+}
+
+void writeEntry(uint8 *dst, const Entry &entry)
+{
+	writeLE64(dst + 0, entry.hash);
+	writeLE32(dst + 8, entry.nameOffset);
+	writeLE32(dst + 12, entry.nameLength);
+	writeLE32(dst + 16, entry.parent);
+	dst[20] = entry.flags;
+	dst[21] = entry.compression;
+	dst[22] = 0;
+	dst[23] = 0;
+	writeLE64(dst + 24, entry.offset);
+	writeLE64(dst + 32, entry.storedSize);
+	writeLE64(dst + 40, entry.size);
+}
+
+std::string normalizePath(const std::string &path)
+{
+	std::string result;
+	size_t start = 0;
+
+	while (start <= path.size())
+	{
+		size_t end = path.find('/', start);
+		if (end == std::string::npos)
+			end = path.size();
+
+		std::string component = path.substr(start, end - start);
+
+		if (component == "." || component == "..")
+			throw love::Exception("Invalid path in archive: %s", path.c_str());
+
+		if (!component.empty())
+		{
+			if (!result.empty())
+				result += '/';
+			result += component;
+		}
+
+		start = end + 1;
+	}
+
+	if (result.empty())
+		throw love::Exception("Invalid path in archive: %s", path.c_str());
+
+	return result;
+}
+
+struct Node
+{
+	std::string path;
+	const InputFile *file = nullptr;
+	std::map<std::string, Node *> children;
+};
+
+void writeBytes(File *file, const void *data, uint64 size)
+{
+	if (size > 0 && !file->write(data, (int64) size))
+		throw love::Exception("Could not write to archive file.");
+}
+
+void writePadding(File *file, uint64 size)
+{
+	static const uint8 zeros[ENTRY_ALIGNMENT] = {};
+	writeBytes(file, zeros, size);
+}
+
+} // anonymous namespace
+
+uint64 hashPath(const char *path, size_t length)
+{
+	uint64 hash = 0xCBF29CE484222325ULL;
+
+	for (size_t i = 0; i < length; i++)
+	{
+		hash ^= (uint8) path[i];
+		hash *= 0x100000001B3ULL;
+	}
+
+	return hash;
+}
+
+void readHeader(const uint8 *src, Header &header)
+{
+	header.magic = readLE32(src + 0);
+	header.version = readLE32(src + 4);
+	header.entryCount = readLE32(src + 8);
+	header.hashSlotCount = readLE32(src + 12);
+	header.indexOffset = readLE64(src + 16);
+	header.indexSize = readLE64(src + 24);
+	header.rootFirstChild = readLE32(src + 32);
+	header.rootChildCount = readLE32(src + 36);
+	header.modtime = (int64) readLE64(src + 40);
+}
+
+void readEntry(const uint8 *src, Entry &entry)
+{
+	entry.hash = readLE64(src + 0);
+	entry.nameOffset = readLE32(src + 8);
+	entry.nameLength = readLE32(src + 12);
+	entry.parent = readLE32(src + 16);
+	entry.flags = src[20];
+	entry.compression = src[21];
+	entry.reserved = 0;
+	entry.offset = readLE64(src + 24);
+	entry.storedSize = readLE64(src + 32);
+	entry.size = readLE64(src + 40);
+}
+
+void write(File *file, const std::vector<InputFile> &files, Compression compression, int level, int64 modtime)
+{
+	Compressor *compressor = nullptr;
+	Compressor::Format format = Compressor::FORMAT_LZ4;
+
+	if (compression != COMPRESSION_NONE)
+	{
+		format = compression == COMPRESSION_ZSTD ? Compressor::FORMAT_ZSTD : Compressor::FORMAT_LZ4;
+		compressor = Compressor::getCompressor(format);
+
+		if (compressor == nullptr)
+			throw love::Exception("Zstandard compression is not supported (LOVE was built without Zstandard support).");
+	}
+
+	// Build the directory tree.
+	std::deque<Node> nodes(1);
+	Node *root = &nodes[0];
+
+	for (const InputFile &input : files)
+	{
+		std::string path = normalizePath(input.path);
+		Node *parent = root;
+		size_t start = 0;
+
+		while (true)
+		{
+			size_t end = path.find('/', start);
+			bool last = end == std::string::npos;
+			std::string name = path.substr(start, last ? std::string::npos : end - start);
+
+			auto it = parent->children.find(name);
+			Node *node = nullptr;
+
+			if (it == parent->children.end())
+			{
+				nodes.emplace_back();
+				node = &nodes.back();
+				node->path = path.substr(0, last ? std::string::npos : end);
+				parent->children[name] = node;
+			}
+			else
+				node = it->second;
+
+			if (last)
+			{
+				if (node->file != nullptr)
+					throw love::Exception("Duplicate path in archive: %s", path.c_str());
+				if (!node->children.empty())
+					throw love::Exception("Archive path %s is used as both a file and a directory.", path.c_str());
+				node->file = &input;
+				break;
+			}
+
+			if (node->file != nullptr)
+				throw love::Exception("Archive path %s is used as both a file and a directory.", node->path.c_str());
+
+			parent = node;
+			start = end + 1;
+		}
+	}
+
+	// Assign entries breadth-first, so each directory's children are
+	// contiguous.
+	std::vector<Entry> entries;
+	std::vector<const Node *> entryNodes;
+	std::string names;
+
+	Header header = {};
+	header.magic = MAGIC;
+	header.version = VERSION;
+	header.modtime = modtime;
+	header.rootFirstChild = 0;
+	header.rootChildCount = (uint32) root->children.size();
+
+	std::deque<std::pair<const Node *, uint32>> queue;
+	queue.push_back(std::make_pair(root, NO_ENTRY));
+
+	while (!queue.empty())
+	{
+		const Node *dir = queue.front().first;
+		uint32 dirindex = queue.front().second;
+		queue.pop_front();
+
+		if (dirindex != NO_ENTRY)
+		{
+			entries[dirindex].offset = entries.size();
+			entries[dirindex].size = dir->children.size();
+		}
+
+		for (const auto &child : dir->children)
+		{
+			const Node *node = child.second;
+
+			Entry entry = {};
+			entry.hash = hashPath(node->path.c_str(), node->path.size());
+			entry.nameOffset = (uint32) names.size();
+			entry.nameLength = (uint32) node->path.size();
+			entry.parent = dirindex;
+			entry.flags = node->file == nullptr ? ENTRY_DIRECTORY : 0;
+			entry.compression = COMPRESSION_NONE;
+
+			names += node->path;
+
+			if (node->file == nullptr)
+				queue.push_back(std::make_pair(node, (uint32) entries.size()));
+
+			entries.push_back(entry);
+			entryNodes.push_back(node);
+		}
+	}
+
+	if (entries.size() >= NO_ENTRY || names.size() >= 0xFFFFFFFF)
+		throw love::Exception("Too many files in archive.");
+
+	header.entryCount = (uint32) entries.size();
+
+	header.hashSlotCount = 1;
+	while (header.hashSlotCount < entries.size() * 2)
+		header.hashSlotCount *= 2;
+
+	std::vector<uint32> slots(header.hashSlotCount, NO_ENTRY);
+	for (uint32 i = 0; i < (uint32) entries.size(); i++)
+	{
+		uint32 slot = (uint32) entries[i].hash & (header.hashSlotCount - 1);
+		while (slots[slot] != NO_ENTRY)
+			slot = (slot + 1) & (header.hashSlotCount - 1);
+		slots[slot] = i;
+	}
+
+	// Compress everything up front, since the index needs the final sizes.
+	std::vector<std::unique_ptr<char[]>> compressed(entries.size());
+	uint64 offset = alignOffset(HEADER_SIZE);
+
+	for (size_t i = 0; i < entries.size(); i++)
+	{
+		const InputFile *input = entryNodes[i]->file;
+		if (input == nullptr)
+			continue;
+
+		Entry &entry = entries[i];
+		entry.size = input->size;
+		entry.storedSize = input->size;
+
+		if (compressor != nullptr && input->size > 0)
+		{
+			size_t compressedsize = 0;
+			char *cdata = compressor->compress(format, input->data, input->size, level, compressedsize);
+
+			if (compressedsize < input->size)
+			{
+				compressed[i].reset(cdata);
+				entry.storedSize = compressedsize;
+				entry.compression = (uint8) compression;
+			}
+			else
+				delete[] cdata;
+		}
+
+		entry.offset = offset;
+		offset = alignOffset(offset + entry.storedSize);
+	}
+
+	header.indexOffset = offset;
+	header.indexSize = entries.size() * ENTRY_SIZE + slots.size() * 4 + names.size();
+
+	uint8 headerbytes[HEADER_SIZE];
+	writeHeader(headerbytes, header);
+	writeBytes(file, headerbytes, HEADER_SIZE);
+
+	uint64 position = HEADER_SIZE;
+
+	for (size_t i = 0; i < entries.size(); i++)
+	{
+		const InputFile *input = entryNodes[i]->file;
+		if (input == nullptr)
+			continue;
+
+		const Entry &entry = entries[i];
+		writePadding(file, entry.offset - position);
+
+		const char *data = compressed[i] ? compressed[i].get() : input->data;
+		writeBytes(file, data, entry.storedSize);
+
+		position = entry.offset + entry.storedSize;
+	}
+
+	writePadding(file, header.indexOffset - position);
+
+	std::vector<uint8> index((size_t) header.indexSize);
+	uint8 *dst = index.data();
+
+	for (const Entry &entry : entries)
+	{
+		writeEntry(dst, entry);
+		dst += ENTRY_SIZE;
+	}
+
+	for (uint32 slot : slots)
+	{
+		writeLE32(dst, slot);
+		dst += 4;
+	}
+
+	if (!names.empty())
+		memcpy(dst, names.data(), names.size());
+
+	writeBytes(file, index.data(), index.size());
+}
+
+static StringMap<Compression, COMPRESSION_MAX_ENUM>::Entry compressionEntries[] =
+{
+	{ "none", COMPRESSION_NONE },
+	{ "lz4",  COMPRESSION_LZ4  },
+	{ "zstd", COMPRESSION_ZSTD },
+};
+
+static StringMap<Compression, COMPRESSION_MAX_ENUM> compressionNames(compressionEntries, sizeof(compressionEntries));
+
+bool getConstant(const char *in, Compression &out)
+{
+	return compressionNames.find(in, out);
+}
+
+bool getConstant(Compression in, const char *&out)
+{
+	return compressionNames.find(in, out);
+}
+
+std::vector<std::string> getConstants(Compression)
+{
+	return compressionNames.getNames();
+}
+
+} // pack
+} // filesystem
+} // love
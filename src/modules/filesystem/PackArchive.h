@@ -0,0 +1,137 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_FILESYSTEM_PACK_ARCHIVE_H
+#define LOVE_FILESYSTEM_PACK_ARCHIVE_H
+
+// LOVE
+#include "common/int.h"
+#include "common/StringMap.h"
+#include "File.h"
+
+// STD
+#include <string>
+#include <vector>
+
+namespace love
+{
+namespace filesystem
+{
+
+/**
+ * LOVE's own archive format, made for large read-only asset packs. All
+ * values are little-endian.
+ *
+ * The file starts with a Header. Every file's data starts at a multiple of
+ * ENTRY_ALIGNMENT, so uncompressed entries can be memory-mapped directly. The
+ * index at the end holds the Entry table, then a hash table of entry indices
+ * keyed by full path, then the path strings.
+ *
+ * Entries are stored breadth-first, so the children of each directory are
+ * contiguous and directory listings don't need any searching.
+ **/
+namespace pack
+{
+
+static const uint32 MAGIC = 0x4B41504C; // "LPAK"
+static const uint32 VERSION = 1;
+static const uint64 ENTRY_ALIGNMENT = 4096;
+static const uint32 NO_ENTRY = 0xFFFFFFFF;
+
+static const size_t HEADER_SIZE = 64;
+static const size_t ENTRY_SIZE = 48;
+
+enum Compression
+{
+	COMPRESSION_NONE = 0,
+	COMPRESSION_LZ4 = 1,
+	COMPRESSION_ZSTD = 2,
+	COMPRESSION_MAX_ENUM
+};
+
+enum EntryFlags
+{
+	ENTRY_DIRECTORY = 1 << 0,
+};
+
+struct Header
+{
+	uint32 magic;
+	uint32 version;
+	uint32 entryCount;
+	uint32 hashSlotCount; // Always a power of two.
+	uint64 indexOffset;
+	uint64 indexSize;
+	uint32 rootFirstChild;
+	uint32 rootChildCount;
+	int64 modtime;
+};
+
+struct Entry
+{
+	uint64 hash;
+	uint32 nameOffset; // Full path, relative to the start of the path strings.
+	uint32 nameLength;
+	uint32 parent; // NO_ENTRY for entries in the root.
+	uint8 flags;
+	uint8 compression;
+	uint16 reserved;
+
+	// For directories, offset is the index of the first child and size is
+	// the number of children.
+	uint64 offset;
+	uint64 storedSize;
+	uint64 size;
+};
+
+struct InputFile
+{
+	std::string path;
+	const char *data;
+	size_t size;
+};
+
+// 64 bit FNV-1a.
+uint64 hashPath(const char *path, size_t length);
+
+void readHeader(const uint8 *src, Header &header);
+void readEntry(const uint8 *src, Entry &entry);
+
+/**
+ * Writes a pack archive containing the given files. Files which don't get
+ * smaller when compressed are stored uncompressed.
+ *
+ * @param file The destination, opened for writing.
+ * @param files The files to store. Paths use '/' as a separator.
+ * @param compression How to compress each file.
+ * @param level The compression level, or -1 for the default.
+ * @param modtime The modification time reported for every file.
+ **/
+void write(File *file, const std::vector<InputFile> &files, Compression compression, int level, int64 modtime);
+
+bool getConstant(const char *in, Compression &out);
+bool getConstant(Compression in, const char *&out);
+std::vector<std::string> getConstants(Compression);
+
+} // pack
+} // filesystem
+} // love
+
+#endif // LOVE_FILESYSTEM_PACK_ARCHIVE_H
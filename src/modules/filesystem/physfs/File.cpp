@@ -51,6 +51,7 @@ File::File(const std::string &filename, Mode mode)
 	, mode(MODE_CLOSED)
 	, bufferMode(BUFFER_NONE)
 	, bufferSize(0)
+	, readAhead(nullptr)
 {
 	if (!open(mode))
 		throw love::Exception("Could not open file at path %s", filename.c_str());
@@ -77,6 +78,7 @@ File::File(const File &other)
 	, mode(MODE_CLOSED)
 	, bufferMode(other.bufferMode)
 	, bufferSize(other.bufferSize)
+	, readAhead(nullptr)
 {
 	if (!open(other.mode))
 		throw love::Exception("Could not open file at path %s", filename.c_str());
@@ -157,6 +159,9 @@ bool File::open(Mode mode)
 
 bool File::close()
 {
+	delete readAhead;
+	readAhead = nullptr;
+
 	if (file == nullptr || !PHYSFS_close(file))
 		return false;
 
@@ -183,6 +188,9 @@ int64 File::getSize()
 		return size;
 	}
 
+	if (readAhead != nullptr)
+		return (int64) readAhead->getSize();
+
 	return (int64) PHYSFS_fileLength(file);
 }
 
@@ -194,6 +202,9 @@ int64 File::read(void *dst, int64 size)
 	if (size < 0)
 		throw love::Exception("Invalid read size.");
 
+	if (readAhead != nullptr)
+		return readAhead->read(dst, size);
+
 	return PHYSFS_readBytes(file, dst, (PHYSFS_uint64) size);
 }
 
@@ -232,6 +243,9 @@ bool File::flush()
 
 bool File::isEOF()
 {
+	if (readAhead != nullptr)
+		return readAhead->isEOF();
+
 	return file == nullptr || PHYSFS_eof(file);
 }
 
@@ -240,6 +254,9 @@ int64 File::tell()
 	if (file == nullptr)
 		return -1;
 
+	if (readAhead != nullptr)
+		return (int64) readAhead->tell();
+
 	return (int64) PHYSFS_tell(file);
 }
 
@@ -256,6 +273,9 @@ bool File::seek(int64 pos, SeekOrigin origin)
 	if (pos < 0)
 		return false;
 
+	if (readAhead != nullptr)
+		return readAhead->seek((uint64) pos);
+
 	return file != nullptr && PHYSFS_seek(file, (PHYSFS_uint64) pos) != 0;
 }
 
@@ -273,6 +293,13 @@ bool File::setBuffer(BufferMode bufmode, int64 size)
 		return true;
 	}
 
+	if (bufmode == BUFFER_READAHEAD && mode != MODE_READ)
+		return false;
+
+	// The read-ahead worker may be using the handle.
+	delete readAhead;
+	readAhead = nullptr;
+
 	int ret = 1;
 
 	switch (bufmode)
@@ -286,6 +313,23 @@ bool File::setBuffer(BufferMode bufmode, int64 size)
 	case BUFFER_FULL:
 		ret = PHYSFS_setBuffer(file, size);
 		break;
+	case BUFFER_READAHEAD:
+		// PhysFS's own buffer would only add a copy.
+		ret = PHYSFS_setBuffer(file, 0);
+		if (size == 0)
+			size = DEFAULT_READAHEAD_SIZE;
+		if (ret != 0)
+		{
+			try
+			{
+				readAhead = new ReadAhead(file, size);
+			}
+			catch (love::Exception &)
+			{
+				ret = 0;
+			}
+		}
+		break;
 	}
 
 	if (ret == 0)
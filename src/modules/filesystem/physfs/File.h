@@ -24,6 +24,7 @@
 // LOVE
 #include "common/config.h"
 #include "filesystem/File.h"
+#include "ReadAhead.h"
 
 // PhysFS
 #include "libraries/physfs/physfs.h"
@@ -71,6 +72,9 @@ public:
 	Mode getMode() const override;
 	const std::string &getFilename() const override;
 
+	// Buffer size used by BUFFER_READAHEAD when none is given.
+	static const int64 DEFAULT_READAHEAD_SIZE = 256 * 1024;
+
 private:
 
 	File(const File &other);
@@ -87,6 +91,9 @@ private:
 	BufferMode bufferMode;
 	int64 bufferSize;
 
+	// Owns all reads from the handle in BUFFER_READAHEAD mode.
+	ReadAhead *readAhead;
+
 }; // File
 
 } // physfs
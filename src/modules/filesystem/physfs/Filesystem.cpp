@@ -21,6 +21,8 @@
 #include <iostream>
 #include <sstream>
 #include <algorithm>
+#include <unordered_set>
+#include <atomic>
 
 #include "common/utf8.h"
 #include "common/b64.h"
@@ -28,6 +30,7 @@
 #include "Filesystem.h"
 #include "File.h"
 #include "PhysfsIo.h"
+#include "PackArchiver.h"
 
 // PhysFS
 #include "libraries/physfs/physfs.h"
@@ -44,7 +47,9 @@
 #	include <Knownfolders.h>
 #else
 #	include <sys/param.h>
+#	include <fcntl.h>
 #	include <unistd.h>
+#	include <cstdio>
 #endif
 
 #if defined(LOVE_IOS) || defined(LOVE_MACOS)
@@ -114,6 +119,8 @@ Filesystem::Filesystem()
 	, fullPaths()
 	, commonPathMountInfo()
 	, saveDirectoryNeedsMounting(false)
+	, ioQueue(nullptr)
+	, fileWatcher(nullptr)
 {
 	requirePath = {"?.lua", "?/init.lua"};
 	cRequirePath = {"??"};
@@ -121,6 +128,10 @@ Filesystem::Filesystem()
 
 Filesystem::~Filesystem()
 {
+	// Worker threads may still be using PhysFS.
+	delete ioQueue;
+	delete fileWatcher;
+
 #ifdef LOVE_ANDROID
 	love::android::deinitializeVirtualArchive();
 #endif
@@ -138,6 +149,9 @@ void Filesystem::init(const char *arg0)
 	if (!PHYSFS_init(arg0))
 		throw love::Exception("Failed to initialize filesystem: %s", PHYSFS_getErrorByCode(PHYSFS_getLastErrorCode()));
 
+	if (!registerPackArchiver())
+		throw love::Exception("Failed to initialize filesystem: %s", PHYSFS_getErrorByCode(PHYSFS_getLastErrorCode()));
+
 	// Enable symlinks by default.
 	setSymlinksEnabled(true);
 }
@@ -242,6 +256,8 @@ bool Filesystem::setSource(const char *source)
 	if (!gameSource.empty())
 		return false;
 
+	clearPathCache();
+
 	std::string new_search_path = canonicalizeRealPath(source);
 
 #ifdef LOVE_ANDROID
@@ -336,6 +352,9 @@ bool Filesystem::setupWriteDirectory()
 	if (!PHYSFS_isInit())
 		return false;
 
+	// Everything which creates or changes files goes through here first.
+	clearPathCache();
+
 	if (!saveDirectoryNeedsMounting)
 		return true;
 
@@ -402,6 +421,8 @@ bool Filesystem::mountFullPath(const char *archive, const char *mountpoint, Moun
 
 	std::string canonarchive = canonicalizeRealPath(archive);
 
+	clearPathCache();
+
 	if (permissions == MOUNT_PERMISSIONS_READWRITE)
 		return PHYSFS_mountRW(canonarchive.c_str(), mountpoint, appendToPath) != 0;
 
@@ -440,6 +461,8 @@ bool Filesystem::mount(Data *data, const char *archivename, const char *mountpoi
 	if (!PHYSFS_isInit())
 		return false;
 
+	clearPathCache();
+
 	if (PHYSFS_mountMemory(data->getData(), data->getSize(), nullptr, archivename, mountpoint, appendToPath) != 0)
 	{
 		mountedData[archivename] = data;
@@ -454,6 +477,8 @@ bool Filesystem::unmount(const char *archive)
 	if (!PHYSFS_isInit() || !archive)
 		return false;
 
+	clearPathCache();
+
 	auto datait = mountedData.find(archive);
 
 	if (datait != mountedData.end() && PHYSFS_unmount(archive) != 0)
@@ -496,6 +521,8 @@ bool Filesystem::unmountFullPath(const char *fullpath)
 
 	std::string canonpath = canonicalizeRealPath(fullpath);
 
+	clearPathCache();
+
 	return PHYSFS_unmount(canonpath.c_str()) != 0;
 }
 
@@ -755,17 +782,49 @@ std::string Filesystem::getSourceBaseDirectory() const
 	return gameSource.substr(0, base_end_pos);
 }
 
+void Filesystem::clearPathCache() const
+{
+	thread::Lock lock(pathCacheMutex);
+	pathCache.clear();
+}
+
+bool Filesystem::lookupPath(const char *filepath, std::string *realdir) const
+{
+	thread::Lock lock(pathCacheMutex);
+
+	auto it = pathCache.find(filepath);
+	if (it == pathCache.end())
+	{
+		// A game calling getInfo on endless unique paths shouldn't grow the
+		// cache forever.
+		if (pathCache.size() >= MAX_PATH_CACHE_ENTRIES)
+			pathCache.clear();
+
+		const char *dir = PHYSFS_getRealDir(filepath);
+
+		PathCacheEntry entry;
+		entry.exists = dir != nullptr;
+		entry.realDirectory = dir != nullptr ? dir : "";
+
+		it = pathCache.emplace(filepath, entry).first;
+	}
+
+	if (realdir != nullptr)
+		*realdir = it->second.realDirectory;
+
+	return it->second.exists;
+}
+
 std::string Filesystem::getRealDirectory(const char *filename) const
 {
 	if (!PHYSFS_isInit())
 		throw love::Exception("PhysFS is not initialized.");
 
-	const char *dir = PHYSFS_getRealDir(filename);
-
-	if (dir == nullptr)
+	std::string dir;
+	if (!lookupPath(filename, &dir))
 		throw love::Exception("File does not exist on disk.");
 
-	return std::string(dir);
+	return dir;
 }
 
 bool Filesystem::exists(const char *filepath) const
@@ -773,7 +832,7 @@ bool Filesystem::exists(const char *filepath) const
 	if (!PHYSFS_isInit())
 		return false;
 
-	return PHYSFS_exists(filepath) != 0;
+	return lookupPath(filepath, nullptr);
 }
 
 bool Filesystem::getInfo(const char *filepath, Info &info) const
@@ -781,6 +840,12 @@ bool Filesystem::getInfo(const char *filepath, Info &info) const
 	if (!PHYSFS_isInit())
 		return false;
 
+	// Missing files are the common case for require, and the cache can answer
+	// those without searching every mounted archive. Sizes and modification
+	// times of existing files are always read fresh.
+	if (!lookupPath(filepath, nullptr))
+		return false;
+
 	PHYSFS_Stat stat = {};
 	if (!PHYSFS_stat(filepath, &stat))
 		return false;
@@ -809,7 +874,10 @@ bool Filesystem::createDirectory(const char *dir)
 	if (!setupWriteDirectory())
 		return false;
 
-	if (!PHYSFS_mkdir(dir))
+	bool success = PHYSFS_mkdir(dir) != 0;
+	clearPathCache();
+
+	if (!success)
 		return false;
 
 #ifdef LOVE_ANDROID
@@ -833,10 +901,10 @@ bool Filesystem::remove(const char *file)
 	if (!setupWriteDirectory())
 		return false;
 
-	if (!PHYSFS_delete(file))
-		return false;
+	bool success = PHYSFS_delete(file) != 0;
+	clearPathCache();
 
-	return true;
+	return success;
 }
 
 FileData *Filesystem::read(const char *filename, int64 size) const
@@ -847,16 +915,130 @@ FileData *Filesystem::read(const char *filename, int64 size) const
 	return file.read(size);
 }
 
+bool Filesystem::getMappableRange(const char *filename, std::string &nativepath, uint64 &offset, uint64 &size) const
+{
+	if (!PHYSFS_isInit())
+		return false;
+
+	PHYSFS_Stat stat = {};
+	if (!PHYSFS_stat(filename, &stat) || stat.filetype != PHYSFS_FILETYPE_REGULAR)
+		return false;
+
+	if (stat.filesize < MAP_MIN_FILE_SIZE)
+		return false;
+
+	std::string realdir;
+	if (!lookupPath(filename, &realdir))
+		return false;
+
+	// Files in the save directory can be rewritten while a mapping is alive.
+	const char *writedir = PHYSFS_getWriteDir();
+	if (writedir != nullptr && realdir.compare(0, strlen(writedir), writedir) == 0)
+		return false;
+
+	std::string path = filename;
+	while (!path.empty() && path[0] == '/')
+		path.erase(0, 1);
+
+	const char *mountpoint = PHYSFS_getMountPoint(realdir.c_str());
+	if (mountpoint != nullptr)
+	{
+		std::string prefix = mountpoint;
+		while (!prefix.empty() && prefix[0] == '/')
+			prefix.erase(0, 1);
+
+		if (path.compare(0, prefix.size(), prefix) != 0)
+			return false;
+
+		path = path.substr(prefix.size());
+	}
+
+	// Uncompressed files in pack archives are mapped straight out of the
+	// archive. Files inside other archives have to be decompressed and copied.
+	if (!isRealDirectory(realdir))
+	{
+		if (mountedData.find(realdir) != mountedData.end())
+			return false;
+
+		if (!getPackFileRange(realdir, path, offset, size))
+			return false;
+
+		nativepath = realdir;
+		return true;
+	}
+
+	std::string dir = realdir;
+	if (!dir.empty() && dir.back() != '/' && dir.back() != LOVE_PATH_SEPARATOR[0])
+		dir += LOVE_PATH_SEPARATOR;
+
+	nativepath = dir + path;
+	offset = 0;
+	size = 0;
+	return true;
+}
+
 FileData* Filesystem::read(const char* filename) const
 {
+	// Large files in plain directories and uncompressed files in pack archives
+	// are mapped rather than copied.
+	std::string nativepath;
+	uint64 offset = 0;
+	uint64 size = 0;
+	if (getMappableRange(filename, nativepath, offset, size))
+	{
+		FileData *data = FileData::map(nativepath, filename, offset, size);
+		if (data != nullptr)
+			return data;
+	}
+
 	File file(filename, File::MODE_READ);
 
 	// close() is called in the File destructor.
 	return file.read();
 }
 
-void Filesystem::write(const char *filename, const void *data, int64 size) const
+FileRequest *Filesystem::readAsync(const char *filename, int priority)
+{
+	if (!PHYSFS_isInit())
+		throw love::Exception("PhysFS is not initialized.");
+
+	FileRequest *request = new FileRequest(filename, priority);
+
+	{
+		thread::Lock lock(ioQueueMutex);
+		if (ioQueue == nullptr)
+			ioQueue = new IOQueue(this);
+	}
+
+	ioQueue->addRequest(request);
+	return request;
+}
+
+FileRequest *Filesystem::writeAsync(const char *filename, Data *data, bool atomic, int priority)
 {
+	if (!PHYSFS_isInit())
+		throw love::Exception("PhysFS is not initialized.");
+
+	FileRequest *request = new FileRequest(filename, data, atomic, priority);
+
+	{
+		thread::Lock lock(ioQueueMutex);
+		if (ioQueue == nullptr)
+			ioQueue = new IOQueue(this);
+	}
+
+	ioQueue->addRequest(request);
+	return request;
+}
+
+void Filesystem::write(const char *filename, const void *data, int64 size, bool atomic) const
+{
+	if (atomic)
+	{
+		writeAtomic(filename, data, size);
+		return;
+	}
+
 	File file(filename, File::MODE_WRITE);
 
 	// close() is called in the File destructor.
@@ -873,6 +1055,99 @@ void Filesystem::append(const char *filename, const void *data, int64 size) cons
 		throw love::Exception("Data could not be written.");
 }
 
+static std::string getNativeWritePath(const char *writedir, const std::string &filename)
+{
+	std::string path = filename;
+	while (!path.empty() && path[0] == '/')
+		path.erase(0, 1);
+
+#ifdef LOVE_WINDOWS
+	std::replace(path.begin(), path.end(), '/', '\\');
+#endif
+
+	std::string nativepath = writedir;
+	if (nativepath.empty() || (nativepath.back() != '/' && nativepath.back() != LOVE_PATH_SEPARATOR[0]))
+		nativepath += LOVE_PATH_SEPARATOR;
+
+	return nativepath + path;
+}
+
+static bool replaceNativeFile(const std::string &from, const std::string &to)
+{
+#ifdef LOVE_WINDOWS
+	std::wstring wfrom = to_widestr(from);
+	std::wstring wto = to_widestr(to);
+
+	HANDLE handle = CreateFileW(wfrom.c_str(), GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (handle == INVALID_HANDLE_VALUE)
+		return false;
+
+	BOOL synced = FlushFileBuffers(handle);
+	CloseHandle(handle);
+
+	return synced && MoveFileExW(wfrom.c_str(), wto.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+#else
+	int fd = open(from.c_str(), O_WRONLY | O_CLOEXEC);
+	if (fd == -1)
+		return false;
+
+#if defined(LOVE_MACOS) || defined(LOVE_IOS)
+	// fsync doesn't flush the drive's own cache on Apple platforms.
+	bool synced = fcntl(fd, F_FULLFSYNC) == 0 || fsync(fd) == 0;
+#else
+	bool synced = fsync(fd) == 0;
+#endif
+	close(fd);
+
+	if (!synced || rename(from.c_str(), to.c_str()) != 0)
+		return false;
+
+	// Makes the rename itself durable. Not every filesystem can sync a
+	// directory, so failing here isn't an error.
+	std::string dir = to.substr(0, to.rfind('/'));
+	int dirfd = open(dir.empty() ? "/" : dir.c_str(), O_RDONLY | O_CLOEXEC);
+	if (dirfd != -1)
+	{
+		fsync(dirfd);
+		close(dirfd);
+	}
+
+	return true;
+#endif
+}
+
+void Filesystem::writeAtomic(const char *filename, const void *data, int64 size) const
+{
+	// Atomic writes to the same file from several threads each get their own
+	// temporary file.
+	static std::atomic<uint32> tempCounter(0);
+	std::string tempname = std::string(filename) + "." + std::to_string(tempCounter++) + ".tmp";
+
+	{
+		// Sets up the save directory if needed, and rejects invalid paths.
+		File file(tempname, File::MODE_WRITE);
+
+		if (!file.write(data, size))
+		{
+			file.close();
+			PHYSFS_delete(tempname.c_str());
+			throw love::Exception("Data could not be written.");
+		}
+	}
+
+	const char *writedir = PHYSFS_getWriteDir();
+	bool replaced = writedir != nullptr
+		&& replaceNativeFile(getNativeWritePath(writedir, tempname), getNativeWritePath(writedir, filename));
+
+	if (!replaced)
+		PHYSFS_delete(tempname.c_str());
+
+	clearPathCache();
+
+	if (!replaced)
+		throw love::Exception("Could not replace file %s.", filename);
+}
+
 bool Filesystem::getDirectoryItems(const char *dir, std::vector<std::string> &items)
 {
 	if (!PHYSFS_isInit())
@@ -890,11 +1165,255 @@ bool Filesystem::getDirectoryItems(const char *dir, std::vector<std::string> &it
 	return true;
 }
 
+bool Filesystem::getDirectoryInfo(const char *dir, bool recursive, std::vector<DirectoryItem> &items)
+{
+	if (!PHYSFS_isInit())
+		return false;
+
+	std::vector<SearchPathEntry> searchpath;
+
+	char **rc = PHYSFS_getSearchPath();
+	if (rc == nullptr)
+		return false;
+
+	for (char **i = rc; *i != 0; i++)
+	{
+		SearchPathEntry entry;
+		entry.realPath = *i;
+		entry.native = mountedData.find(entry.realPath) == mountedData.end() && isRealDirectory(entry.realPath);
+
+		const char *mountpoint = PHYSFS_getMountPoint(*i);
+		entry.mountPoint = mountpoint != nullptr ? mountpoint : "";
+		while (!entry.mountPoint.empty() && entry.mountPoint[0] == '/')
+			entry.mountPoint.erase(0, 1);
+
+		searchpath.push_back(entry);
+	}
+
+	PHYSFS_freeList(rc);
+
+	std::string path = dir;
+	while (!path.empty() && path[0] == '/')
+		path.erase(0, 1);
+	while (!path.empty() && path.back() == '/')
+		path.pop_back();
+
+	size_t first = items.size();
+	getDirectoryInfoLevel(path, "", searchpath, items);
+
+	// Symlinks are reported as symlinks rather than followed, so this can't
+	// loop forever.
+	for (size_t i = first; recursive && i < items.size(); i++)
+	{
+		if (items[i].info.type != FILETYPE_DIRECTORY)
+			continue;
+
+		std::string subdir = path.empty() ? items[i].name : path + "/" + items[i].name;
+		getDirectoryInfoLevel(subdir, items[i].name + "/", searchpath, items);
+	}
+
+	return true;
+}
+
+void Filesystem::getDirectoryInfoLevel(const std::string &dir, const std::string &prefix, const std::vector<SearchPathEntry> &searchpath, std::vector<DirectoryItem> &items) const
+{
+	std::vector<DirectoryItem> level;
+	std::unordered_set<std::string> seen;
+
+	bool symlinks = PHYSFS_symbolicLinksPermitted() != 0;
+	bool fallback = false;
+
+	// Native directories are listed directly, in search path order so earlier
+	// mounts win like they do in PhysFS. Anything else (archives, mount points
+	// inside this directory) is left to PhysFS from that point on.
+	for (const SearchPathEntry &entry : searchpath)
+	{
+		const std::string &mp = entry.mountPoint;
+
+		if (mp.empty() || dir.compare(0, mp.size(), mp) == 0 || dir + "/" == mp)
+		{
+			std::string relative = dir.size() > mp.size() ? dir.substr(mp.size()) : std::string();
+
+			// PhysFS also refuses paths which go through symlinks.
+			if (!entry.native || (!symlinks && !relative.empty()))
+			{
+				fallback = true;
+				break;
+			}
+
+			std::string nativepath = entry.realPath;
+			if (!relative.empty())
+			{
+#ifdef LOVE_WINDOWS
+				std::replace(relative.begin(), relative.end(), '/', '\\');
+#endif
+				if (nativepath.back() != '/' && nativepath.back() != LOVE_PATH_SEPARATOR[0])
+					nativepath += LOVE_PATH_SEPARATOR;
+				nativepath += relative;
+			}
+
+			std::vector<DirectoryItem> nativeitems;
+			if (!getRealDirectoryItems(nativepath, symlinks, nativeitems))
+				continue;
+
+			for (DirectoryItem &item : nativeitems)
+			{
+				if (seen.insert(item.name).second)
+					level.push_back(item);
+			}
+		}
+		else if (dir.empty() || mp.compare(0, dir.size() + 1, dir + "/") == 0)
+		{
+			fallback = true;
+			break;
+		}
+	}
+
+	if (fallback)
+	{
+		char **rc = PHYSFS_enumerateFiles(dir.c_str());
+
+		for (char **i = rc; rc != nullptr && *i != 0; i++)
+		{
+			if (seen.find(*i) != seen.end())
+				continue;
+
+			std::string fullpath = dir.empty() ? *i : dir + "/" + *i;
+
+			PHYSFS_Stat stat = {};
+			if (!PHYSFS_stat(fullpath.c_str(), &stat))
+				continue;
+
+			DirectoryItem item;
+			item.name = *i;
+			item.info.size = (int64) stat.filesize;
+			item.info.modtime = (int64) stat.modtime;
+			item.info.readonly = stat.readonly != 0;
+
+			if (stat.filetype == PHYSFS_FILETYPE_REGULAR)
+				item.info.type = FILETYPE_FILE;
+			else if (stat.filetype == PHYSFS_FILETYPE_DIRECTORY)
+				item.info.type = FILETYPE_DIRECTORY;
+			else if (stat.filetype == PHYSFS_FILETYPE_SYMLINK)
+				item.info.type = FILETYPE_SYMLINK;
+			else
+				item.info.type = FILETYPE_OTHER;
+
+			level.push_back(item);
+		}
+
+		if (rc != nullptr)
+			PHYSFS_freeList(rc);
+	}
+
+	// Same order as getDirectoryItems.
+	std::sort(level.begin(), level.end(), [](const DirectoryItem &a, const DirectoryItem &b) { return a.name < b.name; });
+
+	for (DirectoryItem &item : level)
+	{
+		item.name = prefix + item.name;
+		items.push_back(std::move(item));
+	}
+}
+
+bool Filesystem::watch(const char *path)
+{
+	if (!PHYSFS_isInit() || !FileWatcher::isSupported())
+		return false;
+
+	std::string key = path;
+	while (!key.empty() && key[0] == '/')
+		key.erase(0, 1);
+	while (!key.empty() && key.back() == '/')
+		key.pop_back();
+
+	Info info = {};
+	if (!getInfo(key.c_str(), info))
+		return false;
+
+	// Single files are watched through their directory.
+	std::string dir = key;
+	std::string filename;
+	if (info.type != FILETYPE_DIRECTORY)
+	{
+		size_t slash = key.rfind('/');
+		dir = slash != std::string::npos ? key.substr(0, slash) : std::string();
+		filename = slash != std::string::npos ? key.substr(slash + 1) : key;
+	}
+
+	{
+		thread::Lock lock(fileWatcherMutex);
+		if (fileWatcher == nullptr)
+			fileWatcher = new FileWatcher();
+	}
+
+	bool watching = false;
+
+	char **rc = PHYSFS_getSearchPath();
+	if (rc == nullptr)
+		return false;
+
+	for (char **i = rc; *i != 0; i++)
+	{
+		std::string realdir = *i;
+		if (mountedData.find(realdir) != mountedData.end() || !isRealDirectory(realdir))
+			continue;
+
+		const char *mountpoint = PHYSFS_getMountPoint(*i);
+		std::string mp = mountpoint != nullptr ? mountpoint : "";
+		while (!mp.empty() && mp[0] == '/')
+			mp.erase(0, 1);
+
+		std::string nativepath = realdir;
+		std::string virtualdir = dir;
+
+		if (mp.empty() || dir.compare(0, mp.size(), mp) == 0 || dir + "/" == mp)
+		{
+			std::string relative = dir.size() > mp.size() ? dir.substr(mp.size()) : std::string();
+			if (!relative.empty())
+			{
+#ifdef LOVE_WINDOWS
+				std::replace(relative.begin(), relative.end(), '/', '\\');
+#endif
+				if (nativepath.back() != '/' && nativepath.back() != LOVE_PATH_SEPARATOR[0])
+					nativepath += LOVE_PATH_SEPARATOR;
+				nativepath += relative;
+			}
+		}
+		else if (filename.empty() && (dir.empty() || mp.compare(0, dir.size() + 1, dir + "/") == 0))
+		{
+			// Mounted somewhere inside the watched directory.
+			virtualdir = mp.substr(0, mp.size() - 1);
+		}
+		else
+			continue;
+
+		if (isRealDirectory(nativepath) && fileWatcher->addWatch(key, nativepath, virtualdir, filename))
+			watching = true;
+	}
+
+	PHYSFS_freeList(rc);
+	return watching;
+}
+
+bool Filesystem::unwatch(const char *path)
+{
+	std::string key = path;
+	while (!key.empty() && key[0] == '/')
+		key.erase(0, 1);
+	while (!key.empty() && key.back() == '/')
+		key.pop_back();
+
+	thread::Lock lock(fileWatcherMutex);
+	return fileWatcher != nullptr && fileWatcher->removeWatches(key);
+}
+
 void Filesystem::setSymlinksEnabled(bool enable)
 {
 	if (!PHYSFS_isInit())
 		return;
 
+	clearPathCache();
 	PHYSFS_permitSymbolicLinks(enable ? 1 : 0);
 }
 
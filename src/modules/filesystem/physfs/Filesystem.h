@@ -25,9 +25,12 @@
 #include <cstdlib>
 #include <cstring>
 #include <map>
+#include <unordered_map>
 
 // LOVE
 #include "filesystem/Filesystem.h"
+#include "filesystem/IOQueue.h"
+#include "filesystem/FileWatcher.h"
 
 namespace love
 {
@@ -88,10 +91,16 @@ public:
 
 	FileData *read(const char *filename, int64 size) const override;
 	FileData *read(const char *filename) const override;
-	void write(const char *filename, const void *data, int64 size) const override;
+	FileRequest *readAsync(const char *filename, int priority) override;
+	void write(const char *filename, const void *data, int64 size, bool atomic = false) const override;
+	FileRequest *writeAsync(const char *filename, Data *data, bool atomic, int priority) override;
 	void append(const char *filename, const void *data, int64 size) const override;
 
 	bool getDirectoryItems(const char *dir, std::vector<std::string> &items) override;
+	bool getDirectoryInfo(const char *dir, bool recursive, std::vector<DirectoryItem> &items) override;
+
+	bool watch(const char *path) override;
+	bool unwatch(const char *path) override;
 
 	void setSymlinksEnabled(bool enable) override;
 	bool areSymlinksEnabled() const override;
@@ -112,6 +121,33 @@ private:
 
 	bool mountCommonPathInternal(CommonPath path, const char *mountpoint, MountPermissions permissions, bool appendToPath, bool createDir);
 
+	// Files at least this big are memory-mapped by read(), when possible.
+	static const int64 MAP_MIN_FILE_SIZE = 4 * 1024 * 1024;
+
+	// Gets the native path and byte range of a file which can be
+	// memory-mapped: a large file in a read-only native directory, or stored
+	// uncompressed in a pack archive on disk.
+	bool getMappableRange(const char *filename, std::string &nativepath, uint64 &offset, uint64 &size) const;
+
+	struct SearchPathEntry
+	{
+		std::string realPath;
+		// Without a leading slash, and with a trailing one unless it's empty.
+		std::string mountPoint;
+		bool native;
+	};
+
+	// Lists one directory into items, with each item's name prefixed.
+	void getDirectoryInfoLevel(const std::string &dir, const std::string &prefix, const std::vector<SearchPathEntry> &searchpath, std::vector<DirectoryItem> &items) const;
+
+	// Returns whether the path exists in the search path, using the cache.
+	bool lookupPath(const char *filepath, std::string *realdir) const;
+	void clearPathCache() const;
+
+	// Writes to a temporary file in the save directory, then renames it over
+	// the destination once its contents are on disk.
+	void writeAtomic(const char *filename, const void *data, int64 size) const;
+
 	// Contains the current working directory (UTF8).
 	std::string cwd;
 
@@ -140,6 +176,28 @@ private:
 
 	bool saveDirectoryNeedsMounting;
 
+	// Created by the first readAsync or writeAsync call.
+	IOQueue *ioQueue;
+	love::thread::MutexRef ioQueueMutex;
+
+	// Created by the first watch call.
+	FileWatcher *fileWatcher;
+	love::thread::MutexRef fileWatcherMutex;
+
+	struct PathCacheEntry
+	{
+		bool exists;
+		std::string realDirectory;
+	};
+
+	static const size_t MAX_PATH_CACHE_ENTRIES = 8192;
+
+	// Remembers which search path each looked-up path resolved to, if any.
+	// Cleared whenever the search path changes or files may have been
+	// created or removed through love.filesystem.
+	mutable std::unordered_map<std::string, PathCacheEntry> pathCache;
+	mutable love::thread::MutexRef pathCacheMutex;
+
 }; // Filesystem
 
 } // physfs
@@ -0,0 +1,573 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "PackArchiver.h"
+#include "PhysfsIo.h"
+#include "filesystem/PackArchive.h"
+#include "data/Compressor.h"
+#include "thread/threads.h"
+
+// PhysFS
+#include "libraries/physfs/physfs.h"
+
+// STD
+#include <map>
+#include <memory>
+#include <vector>
+#include <string.h>
+#include <sys/stat.h>
+
+namespace love
+{
+namespace filesystem
+{
+namespace physfs
+{
+
+using love::data::Compressor;
+
+namespace
+{
+
+struct Pack
+{
+	PHYSFS_Io *io = nullptr;
+	std::string name;
+	bool native = false;
+
+	pack::Header header;
+	std::vector<pack::Entry> entries;
+	std::vector<uint32> slots;
+	std::string names;
+
+	~Pack()
+	{
+		if (io != nullptr)
+			io->destroy(io);
+	}
+
+	const pack::Entry *find(const char *path) const
+	{
+		while (path[0] == '/')
+			path++;
+
+		size_t length = strlen(path);
+		uint64 hash = pack::hashPath(path, length);
+		uint32 mask = header.hashSlotCount - 1;
+
+		for (uint32 slot = (uint32) hash & mask; slots[slot] != pack::NO_ENTRY; slot = (slot + 1) & mask)
+		{
+			const pack::Entry &entry = entries[slots[slot]];
+			if (entry.hash == hash && entry.nameLength == length && memcmp(names.data() + entry.nameOffset, path, length) == 0)
+				return &entry;
+		}
+
+		return nullptr;
+	}
+};
+
+// Packs opened from files on disk, by name, for getPackFileRange.
+std::map<std::string, Pack *> nativePacks;
+love::thread::Mutex *nativePacksMutex = nullptr;
+
+// Reads a stored entry directly from a duplicate of the archive's Io.
+struct RangeIo : public PhysfsIo<RangeIo>
+{
+	static const uint32 version = 0;
+
+	PHYSFS_Io *source;
+	uint64 start;
+	uint64 size;
+	uint64 position;
+
+	RangeIo(PHYSFS_Io *source, uint64 start, uint64 size)
+		: source(source)
+		, start(start)
+		, size(size)
+		, position(0)
+	{
+	}
+
+	RangeIo(const RangeIo &other)
+		: source(other.source->duplicate(other.source))
+		, start(other.start)
+		, size(other.size)
+		, position(other.position)
+	{
+		if (source == nullptr)
+			throw love::Exception("Could not duplicate archive file handle.");
+	}
+
+	virtual ~RangeIo()
+	{
+		source->destroy(source);
+	}
+
+	int64 read(void *buf, uint64 len)
+	{
+		len = std::min(len, size - position);
+		if (len == 0)
+			return 0;
+
+		if (!source->seek(source, start + position))
+			return -1;
+
+		int64 count = source->read(source, buf, len);
+		if (count > 0)
+			position += (uint64) count;
+
+		return count;
+	}
+
+	int64 write(const void *, uint64)
+	{
+		PHYSFS_setErrorCode(PHYSFS_ERR_READ_ONLY);
+		return -1;
+	}
+
+	int64 seek(uint64 offset)
+	{
+		if (offset > size)
+		{
+			PHYSFS_setErrorCode(PHYSFS_ERR_PAST_EOF);
+			return 0;
+		}
+
+		position = offset;
+		return 1;
+	}
+
+	int64 tell() { return (int64) position; }
+	int64 length() { return (int64) size; }
+	int64 flush() { return 1; }
+};
+
+// Reads a decompressed entry from memory.
+struct MemoryIo : public PhysfsIo<MemoryIo>
+{
+	static const uint32 version = 0;
+
+	std::shared_ptr<char> data;
+	uint64 size;
+	uint64 position;
+
+	MemoryIo(std::shared_ptr<char> data, uint64 size)
+		: data(data)
+		, size(size)
+		, position(0)
+	{
+	}
+
+	MemoryIo(const MemoryIo &other) = default;
+	virtual ~MemoryIo() {}
+
+	int64 read(void *buf, uint64 len)
+	{
+		len = std::min(len, size - position);
+		if (len > 0)
+			memcpy(buf, data.get() + position, (size_t) len);
+		position += len;
+		return (int64) len;
+	}
+
+	int64 write(const void *, uint64)
+	{
+		PHYSFS_setErrorCode(PHYSFS_ERR_READ_ONLY);
+		return -1;
+	}
+
+	int64 seek(uint64 offset)
+	{
+		if (offset > size)
+		{
+			PHYSFS_setErrorCode(PHYSFS_ERR_PAST_EOF);
+			return 0;
+		}
+
+		position = offset;
+		return 1;
+	}
+
+	int64 tell() { return (int64) position; }
+	int64 length() { return (int64) size; }
+	int64 flush() { return 1; }
+};
+
+bool readFully(PHYSFS_Io *io, uint64 offset, void *dst, uint64 size)
+{
+	if (!io->seek(io, offset))
+		return false;
+
+	uint8 *bytes = (uint8 *) dst;
+	while (size > 0)
+	{
+		PHYSFS_sint64 count = io->read(io, bytes, size);
+		if (count <= 0)
+			return false;
+		bytes += count;
+		size -= (uint64) count;
+	}
+
+	return true;
+}
+
+bool isNativeFile(const char *name, PHYSFS_sint64 length)
+{
+	struct stat st = {};
+	return name != nullptr && ::stat(name, &st) == 0 && (st.st_mode & S_IFMT) == S_IFREG && (PHYSFS_sint64) st.st_size == length;
+}
+
+void *openArchive(PHYSFS_Io *io, const char *name, int forWrite, int *claimed)
+{
+	uint8 headerbytes[pack::HEADER_SIZE];
+	pack::Header header;
+
+	PHYSFS_sint64 length = io->length(io);
+	if (length < (PHYSFS_sint64) pack::HEADER_SIZE || !readFully(io, 0, headerbytes, pack::HEADER_SIZE))
+		return nullptr;
+
+	pack::readHeader(headerbytes, header);
+	if (header.magic != pack::MAGIC)
+		return nullptr;
+
+	*claimed = 1;
+
+	if (forWrite)
+	{
+		PHYSFS_setErrorCode(PHYSFS_ERR_READ_ONLY);
+		return nullptr;
+	}
+
+	uint64 slotcount = header.hashSlotCount;
+	uint64 tablesize = (uint64) header.entryCount * pack::ENTRY_SIZE + slotcount * 4;
+
+	if (header.version != pack::VERSION || slotcount == 0 || (slotcount & (slotcount - 1)) != 0
+		|| slotcount < header.entryCount || header.indexSize < tablesize
+		|| header.indexOffset > (uint64) length || header.indexSize > (uint64) length - header.indexOffset)
+	{
+		PHYSFS_setErrorCode(PHYSFS_ERR_CORRUPT);
+		return nullptr;
+	}
+
+	std::unique_ptr<Pack> p(new Pack());
+	std::vector<uint8> index;
+
+	try
+	{
+		index.resize((size_t) header.indexSize);
+		p->entries.resize(header.entryCount);
+		p->slots.resize((size_t) slotcount);
+	}
+	catch (std::bad_alloc &)
+	{
+		PHYSFS_setErrorCode(PHYSFS_ERR_OUT_OF_MEMORY);
+		return nullptr;
+	}
+
+	if (!index.empty() && !readFully(io, header.indexOffset, index.data(), index.size()))
+	{
+		PHYSFS_setErrorCode(PHYSFS_ERR_CORRUPT);
+		return nullptr;
+	}
+
+	const uint8 *src = index.data();
+	for (pack::Entry &entry : p->entries)
+	{
+		pack::readEntry(src, entry);
+		src += pack::ENTRY_SIZE;
+	}
+
+	for (uint32 &slot : p->slots)
+	{
+		slot = (uint32) src[0] | ((uint32) src[1] << 8) | ((uint32) src[2] << 16) | ((uint32) src[3] << 24);
+		src += 4;
+	}
+
+	p->names.assign((const char *) src, (size_t) (header.indexSize - tablesize));
+
+	// Validate everything lookups and reads rely on, once.
+	bool hasempty = false;
+	bool valid = (uint64) header.rootFirstChild + header.rootChildCount <= header.entryCount;
+
+	for (uint32 slot : p->slots)
+	{
+		if (slot == pack::NO_ENTRY)
+			hasempty = true;
+		else if (slot >= header.entryCount)
+			valid = false;
+	}
+
+	// Lookups stop at the first empty slot.
+	valid = valid && hasempty;
+
+	for (size_t i = 0; valid && i < p->entries.size(); i++)
+	{
+		const pack::Entry &entry = p->entries[i];
+
+		if ((uint64) entry.nameOffset + entry.nameLength > p->names.size())
+			valid = false;
+		else if (entry.flags & pack::ENTRY_DIRECTORY)
+			valid = entry.offset + entry.size <= header.entryCount;
+		else
+			valid = entry.compression < pack::COMPRESSION_MAX_ENUM
+				&& entry.offset <= (uint64) length && entry.storedSize <= (uint64) length - entry.offset
+				&& (entry.compression != pack::COMPRESSION_NONE || entry.storedSize == entry.size);
+	}
+
+	if (!valid)
+	{
+		PHYSFS_setErrorCode(PHYSFS_ERR_CORRUPT);
+		return nullptr;
+	}
+
+	p->header = header;
+	p->name = name != nullptr ? name : "";
+	p->native = isNativeFile(name, length);
+
+	if (p->native)
+	{
+		love::thread::Lock lock(nativePacksMutex);
+		nativePacks[p->name] = p.get();
+	}
+
+	// The Pack owns the Io from now on.
+	p->io = io;
+	return p.release();
+}
+
+PHYSFS_EnumerateCallbackResult enumerate(void *opaque, const char *dirname, PHYSFS_EnumerateCallback cb, const char *origdir, void *callbackdata)
+{
+	Pack *p = (Pack *) opaque;
+
+	uint64 first = p->header.rootFirstChild;
+	uint64 count = p->header.rootChildCount;
+
+	if (dirname[0] != '\0' && !(dirname[0] == '/' && dirname[1] == '\0'))
+	{
+		const pack::Entry *dir = p->find(dirname);
+		if (dir == nullptr || !(dir->flags & pack::ENTRY_DIRECTORY))
+		{
+			PHYSFS_setErrorCode(PHYSFS_ERR_NOT_FOUND);
+			return PHYSFS_ENUM_ERROR;
+		}
+
+		first = dir->offset;
+		count = dir->size;
+	}
+
+	std::string name;
+
+	for (uint64 i = first; i < first + count; i++)
+	{
+		const pack::Entry &entry = p->entries[(size_t) i];
+		name.assign(p->names.data() + entry.nameOffset, entry.nameLength);
+
+		size_t slash = name.rfind('/');
+		if (slash != std::string::npos)
+			name.erase(0, slash + 1);
+
+		PHYSFS_EnumerateCallbackResult result = cb(callbackdata, origdir, name.c_str());
+		if (result == PHYSFS_ENUM_ERROR)
+		{
+			PHYSFS_setErrorCode(PHYSFS_ERR_APP_CALLBACK);
+			return PHYSFS_ENUM_ERROR;
+		}
+		else if (result == PHYSFS_ENUM_STOP)
+			return PHYSFS_ENUM_STOP;
+	}
+
+	return PHYSFS_ENUM_OK;
+}
+
+PHYSFS_Io *openRead(void *opaque, const char *filename)
+{
+	Pack *p = (Pack *) opaque;
+
+	const pack::Entry *entry = p->find(filename);
+	if (entry == nullptr)
+	{
+		PHYSFS_setErrorCode(PHYSFS_ERR_NOT_FOUND);
+		return nullptr;
+	}
+
+	if (entry->flags & pack::ENTRY_DIRECTORY)
+	{
+		PHYSFS_setErrorCode(PHYSFS_ERR_NOT_A_FILE);
+		return nullptr;
+	}
+
+	try
+	{
+		if (entry->compression == pack::COMPRESSION_NONE)
+		{
+			PHYSFS_Io *source = p->io->duplicate(p->io);
+			if (source == nullptr)
+				return nullptr;
+
+			return new RangeIo(source, entry->offset, entry->size);
+		}
+
+		// Compressed entries are decompressed completely when opened, so
+		// seeking within them stays cheap.
+		std::vector<char> stored((size_t) entry->storedSize);
+		if (!stored.empty() && !readFully(p->io, entry->offset, stored.data(), stored.size()))
+		{
+			PHYSFS_setErrorCode(PHYSFS_ERR_IO);
+			return nullptr;
+		}
+
+		Compressor::Format format = entry->compression == pack::COMPRESSION_ZSTD ? Compressor::FORMAT_ZSTD : Compressor::FORMAT_LZ4;
+		Compressor *compressor = Compressor::getCompressor(format);
+		if (compressor == nullptr)
+		{
+			PHYSFS_setErrorCode(PHYSFS_ERR_UNSUPPORTED);
+			return nullptr;
+		}
+
+		size_t size = (size_t) entry->size;
+		char *data = compressor->decompress(format, stored.data(), stored.size(), size);
+		std::shared_ptr<char> shared(data, std::default_delete<char[]>());
+
+		if (size != entry->size)
+		{
+			PHYSFS_setErrorCode(PHYSFS_ERR_CORRUPT);
+			return nullptr;
+		}
+
+		return new MemoryIo(shared, size);
+	}
+	catch (std::bad_alloc &)
+	{
+		PHYSFS_setErrorCode(PHYSFS_ERR_OUT_OF_MEMORY);
+	}
+	catch (love::Exception &)
+	{
+		PHYSFS_setErrorCode(PHYSFS_ERR_CORRUPT);
+	}
+
+	return nullptr;
+}
+
+PHYSFS_Io *openWriteOrAppend(void *, const char *)
+{
+	PHYSFS_setErrorCode(PHYSFS_ERR_READ_ONLY);
+	return nullptr;
+}
+
+int removeOrMkdir(void *, const char *)
+{
+	PHYSFS_setErrorCode(PHYSFS_ERR_READ_ONLY);
+	return 0;
+}
+
+int stat(void *opaque, const char *filename, PHYSFS_Stat *stat)
+{
+	Pack *p = (Pack *) opaque;
+	bool isroot = filename[0] == '\0' || (filename[0] == '/' && filename[1] == '\0');
+
+	const pack::Entry *entry = isroot ? nullptr : p->find(filename);
+	if (!isroot && entry == nullptr)
+	{
+		PHYSFS_setErrorCode(PHYSFS_ERR_NOT_FOUND);
+		return 0;
+	}
+
+	bool isdir = isroot || (entry->flags & pack::ENTRY_DIRECTORY) != 0;
+
+	stat->filesize = isdir ? 0 : (PHYSFS_sint64) entry->size;
+	stat->modtime = p->header.modtime;
+	stat->createtime = p->header.modtime;
+	stat->accesstime = -1;
+	stat->filetype = isdir ? PHYSFS_FILETYPE_DIRECTORY : PHYSFS_FILETYPE_REGULAR;
+	stat->readonly = 1;
+	return 1;
+}
+
+void closeArchive(void *opaque)
+{
+	Pack *p = (Pack *) opaque;
+
+	if (p->native)
+	{
+		love::thread::Lock lock(nativePacksMutex);
+		auto it = nativePacks.find(p->name);
+		if (it != nativePacks.end() && it->second == p)
+			nativePacks.erase(it);
+	}
+
+	delete p;
+}
+
+} // anonymous namespace
+
+bool registerPackArchiver()
+{
+	if (nativePacksMutex == nullptr)
+		nativePacksMutex = love::thread::newMutex();
+
+	static const PHYSFS_Archiver archiver =
+	{
+		0,
+		{
+			"LPAK",
+			"LOVE pack archive",
+			"LOVE Development Team",
+			"https://love2d.org",
+			0,
+		},
+		openArchive,
+		enumerate,
+		openRead,
+		openWriteOrAppend,
+		openWriteOrAppend,
+		removeOrMkdir,
+		removeOrMkdir,
+		stat,
+		closeArchive,
+	};
+
+	// PHYSFS_registerArchiver fails if the archiver is already registered,
+	// after a previous init.
+	return PHYSFS_registerArchiver(&archiver) != 0 || PHYSFS_getLastErrorCode() == PHYSFS_ERR_DUPLICATE;
+}
+
+bool getPackFileRange(const std::string &archive, const std::string &path, uint64 &offset, uint64 &size)
+{
+	if (nativePacksMutex == nullptr)
+		return false;
+
+	love::thread::Lock lock(nativePacksMutex);
+
+	auto it = nativePacks.find(archive);
+	if (it == nativePacks.end())
+		return false;
+
+	const pack::Entry *entry = it->second->find(path.c_str());
+	if (entry == nullptr || (entry->flags & pack::ENTRY_DIRECTORY) || entry->compression != pack::COMPRESSION_NONE)
+		return false;
+
+	offset = entry->offset;
+	size = entry->size;
+	return true;
+}
+
+} // physfs
+} // filesystem
+} // love
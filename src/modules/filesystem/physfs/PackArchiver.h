@@ -0,0 +1,60 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_FILESYSTEM_PHYSFS_PACK_ARCHIVER_H
+#define LOVE_FILESYSTEM_PHYSFS_PACK_ARCHIVER_H
+
+// LOVE
+#include "common/int.h"
+
+// STD
+#include <string>
+
+namespace love
+{
+namespace filesystem
+{
+namespace physfs
+{
+
+/**
+ * Registers a PhysFS archiver for LOVE's pack archive format (see
+ * filesystem/PackArchive.h), so packs can be mounted like zip files. Must be
+ * called after PHYSFS_init.
+ **/
+bool registerPackArchiver();
+
+/**
+ * Finds where an uncompressed file is stored inside a mounted pack archive
+ * which was opened from a file on disk, so it can be memory-mapped.
+ *
+ * @param archive The archive's full path, as returned by PHYSFS_getRealDir.
+ * @param path The file's path inside the archive.
+ * @param[out] offset The offset of the file's data in the archive.
+ * @param[out] size The size of the file's data.
+ * @return False if the file isn't stored uncompressed in such an archive.
+ **/
+bool getPackFileRange(const std::string &archive, const std::string &path, uint64 &offset, uint64 &size);
+
+} // physfs
+} // filesystem
+} // love
+
+#endif // LOVE_FILESYSTEM_PHYSFS_PACK_ARCHIVER_H
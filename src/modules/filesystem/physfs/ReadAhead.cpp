@@ -0,0 +1,213 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "ReadAhead.h"
+#include "common/Exception.h"
+
+// STD
+#include <algorithm>
+#include <cstring>
+
+namespace love
+{
+namespace filesystem
+{
+namespace physfs
+{
+
+ReadAhead::Worker::Worker(ReadAhead *readAhead)
+	: readAhead(readAhead)
+{
+	threadName = "FileReadAhead";
+}
+
+void ReadAhead::Worker::threadFunction()
+{
+	ReadAhead *r = readAhead;
+	thread::Lock lock(r->mutex);
+
+	while (true)
+	{
+		while (!r->stopping && (!r->fillPending || r->backValid))
+			r->cond->wait(r->mutex);
+
+		if (r->stopping)
+			return;
+
+		Buffer &buffer = r->back;
+
+		// The front buffer and position are never touched by the worker, and
+		// the back buffer isn't touched by the reader until the fill is done.
+		r->mutex->unlock();
+
+		int64 count = -1;
+		if (PHYSFS_seek(r->file, buffer.offset) != 0)
+			count = PHYSFS_readBytes(r->file, buffer.data.data(), buffer.data.size());
+
+		r->mutex->lock();
+
+		buffer.failed = count < 0;
+		buffer.size = count > 0 ? (size_t) count : 0;
+		r->backValid = true;
+		r->cond->broadcast();
+	}
+}
+
+ReadAhead::ReadAhead(PHYSFS_File *file, int64 bufferSize)
+	: file(file)
+	, length(0)
+	, position(0)
+	, fillPending(false)
+	, backValid(false)
+	, worker(nullptr)
+	, stopping(false)
+{
+	PHYSFS_sint64 filelength = PHYSFS_fileLength(file);
+	PHYSFS_sint64 filepos = PHYSFS_tell(file);
+	if (filelength < 0 || filepos < 0)
+		throw love::Exception("Could not get the size of the file.");
+
+	length = (uint64) filelength;
+	position = (uint64) filepos;
+
+	front.data.resize((size_t) bufferSize);
+	back.data.resize((size_t) bufferSize);
+	front.offset = position;
+
+	worker = new Worker(this);
+	if (!worker->start())
+	{
+		worker->release();
+		throw love::Exception("Could not start the read-ahead thread.");
+	}
+
+	thread::Lock lock(mutex);
+	requestFill(position);
+}
+
+ReadAhead::~ReadAhead()
+{
+	{
+		thread::Lock lock(mutex);
+		stopping = true;
+		cond->broadcast();
+	}
+
+	worker->wait();
+	worker->release();
+
+	// Hand the file back at the position the reader expects.
+	PHYSFS_seek(file, position);
+}
+
+void ReadAhead::requestFill(uint64 offset)
+{
+	back.offset = offset;
+	back.size = 0;
+	back.failed = false;
+	backValid = false;
+	fillPending = offset < length;
+	cond->broadcast();
+}
+
+void ReadAhead::waitForFill()
+{
+	while (fillPending && !backValid)
+		cond->wait(mutex);
+}
+
+int ReadAhead::takeBackBuffer()
+{
+	thread::Lock lock(mutex);
+
+	waitForFill();
+
+	if (!fillPending || back.offset != position)
+	{
+		// Nothing useful was prefetched, so read the current position now.
+		requestFill(position);
+		waitForFill();
+	}
+
+	if (!fillPending)
+		return 0;
+
+	if (back.failed)
+	{
+		fillPending = false;
+		backValid = false;
+		return -1;
+	}
+
+	std::swap(front, back);
+
+	// Start reading the next part while this one is consumed.
+	requestFill(front.offset + front.size);
+	return front.size > 0 ? 1 : 0;
+}
+
+int64 ReadAhead::read(void *dst, int64 size)
+{
+	uint8 *out = (uint8 *) dst;
+	int64 total = 0;
+
+	while (total < size)
+	{
+		uint64 frontend = front.offset + front.size;
+
+		if (position >= front.offset && position < frontend)
+		{
+			size_t available = (size_t) (frontend - position);
+			size_t count = (size_t) std::min<int64>(size - total, (int64) available);
+
+			memcpy(out + total, front.data.data() + (position - front.offset), count);
+			position += count;
+			total += count;
+			continue;
+		}
+
+		if (position >= length)
+			break;
+
+		int result = takeBackBuffer();
+		if (result < 0)
+			return total > 0 ? total : -1;
+		else if (result == 0)
+			break;
+	}
+
+	return total;
+}
+
+bool ReadAhead::seek(uint64 pos)
+{
+	if (pos > length)
+		return false;
+
+	// Nothing is discarded here: seeks within the current buffer or to the
+	// start of the prefetched one keep their data, and read() refills
+	// anything else.
+	position = pos;
+	return true;
+}
+
+} // physfs
+} // filesystem
+} // love
@@ -0,0 +1,122 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_FILESYSTEM_PHYSFS_READ_AHEAD_H
+#define LOVE_FILESYSTEM_PHYSFS_READ_AHEAD_H
+
+// LOVE
+#include "common/config.h"
+#include "common/int.h"
+#include "thread/threads.h"
+
+// PhysFS
+#include "libraries/physfs/physfs.h"
+
+// STD
+#include <vector>
+
+namespace love
+{
+namespace filesystem
+{
+namespace physfs
+{
+
+/**
+ * Double-buffered sequential reads from a PhysFS file. While one buffer is
+ * being consumed, a worker thread fills the other with the next part of the
+ * file, so sequential readers (streaming decoders) see few, large reads.
+ *
+ * The file handle must not be used directly while a ReadAhead exists. Its
+ * position is set to the logical read position when the ReadAhead is
+ * destroyed.
+ **/
+class ReadAhead
+{
+public:
+
+	ReadAhead(PHYSFS_File *file, int64 bufferSize);
+	~ReadAhead();
+
+	int64 read(void *dst, int64 size);
+	bool seek(uint64 pos);
+
+	uint64 tell() const { return position; }
+	uint64 getSize() const { return length; }
+	bool isEOF() const { return position >= length; }
+
+private:
+
+	class Worker : public love::thread::Threadable
+	{
+	public:
+
+		Worker(ReadAhead *readAhead);
+		virtual ~Worker() {}
+
+		void threadFunction() override;
+
+	private:
+
+		ReadAhead *readAhead;
+
+	}; // Worker
+
+	struct Buffer
+	{
+		std::vector<uint8> data;
+		uint64 offset = 0;
+		size_t size = 0;
+		bool failed = false;
+	};
+
+	// Must be called with the mutex held.
+	void requestFill(uint64 offset);
+	void waitForFill();
+
+	// Swaps in the prefetched buffer at the current position. Returns 1 on
+	// success, 0 at the end of the file, or -1 if the read failed.
+	int takeBackBuffer();
+
+	PHYSFS_File *file;
+	uint64 length;
+	uint64 position;
+
+	// Consumed by read(). Only the calling thread touches it.
+	Buffer front;
+
+	// Filled by the worker while fillPending is true.
+	Buffer back;
+	bool fillPending;
+	bool backValid;
+
+	Worker *worker;
+	bool stopping;
+
+	love::thread::MutexRef mutex;
+	love::thread::ConditionalRef cond;
+
+}; // ReadAhead
+
+} // physfs
+} // filesystem
+} // love
+
+#endif // LOVE_FILESYSTEM_PHYSFS_READ_AHEAD_H
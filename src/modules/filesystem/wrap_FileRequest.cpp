@@ -0,0 +1,160 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "wrap_FileRequest.h"
+
+namespace love
+{
+namespace filesystem
+{
+
+FileRequest *luax_checkfilerequest(lua_State *L, int idx)
+{
+	return luax_checktype<FileRequest>(L, idx);
+}
+
+int w_FileRequest_getFilename(lua_State *L)
+{
+	FileRequest *t = luax_checkfilerequest(L, 1);
+	lua_pushstring(L, t->getFilename().c_str());
+	return 1;
+}
+
+int w_FileRequest_getStatus(lua_State *L)
+{
+	FileRequest *t = luax_checkfilerequest(L, 1);
+	const char *str = nullptr;
+	if (!FileRequest::getConstant(t->getStatus(), str))
+		return luaL_error(L, "Unknown file request status.");
+	lua_pushstring(L, str);
+	return 1;
+}
+
+int w_FileRequest_isDone(lua_State *L)
+{
+	FileRequest *t = luax_checkfilerequest(L, 1);
+	luax_pushboolean(L, t->isDone());
+	return 1;
+}
+
+int w_FileRequest_getData(lua_State *L)
+{
+	FileRequest *t = luax_checkfilerequest(L, 1);
+	FileData *data = t->getData();
+
+	if (data != nullptr)
+	{
+		luax_pushtype(L, data);
+		return 1;
+	}
+
+	lua_pushnil(L);
+
+	if (t->getStatus() == FileRequest::STATUS_FAILED)
+	{
+		lua_pushstring(L, t->getError().c_str());
+		return 2;
+	}
+
+	return 1;
+}
+
+int w_FileRequest_getError(lua_State *L)
+{
+	FileRequest *t = luax_checkfilerequest(L, 1);
+
+	if (t->getStatus() != FileRequest::STATUS_FAILED)
+		return 0;
+
+	lua_pushstring(L, t->getError().c_str());
+	return 1;
+}
+
+int w_FileRequest_setPriority(lua_State *L)
+{
+	FileRequest *t = luax_checkfilerequest(L, 1);
+	t->setPriority((int) luaL_checkinteger(L, 2));
+	return 0;
+}
+
+int w_FileRequest_getPriority(lua_State *L)
+{
+	FileRequest *t = luax_checkfilerequest(L, 1);
+	lua_pushinteger(L, t->getPriority());
+	return 1;
+}
+
+int w_FileRequest_cancel(lua_State *L)
+{
+	FileRequest *t = luax_checkfilerequest(L, 1);
+	t->cancel();
+	return 0;
+}
+
+int w_FileRequest_isWrite(lua_State *L)
+{
+	FileRequest *t = luax_checkfilerequest(L, 1);
+	luax_pushboolean(L, t->isWrite());
+	return 1;
+}
+
+int w_FileRequest_wait(lua_State *L)
+{
+	FileRequest *t = luax_checkfilerequest(L, 1);
+	t->wait();
+
+	if (!t->isWrite())
+		return w_FileRequest_getData(L);
+
+	FileRequest::Status status = t->getStatus();
+
+	if (status == FileRequest::STATUS_FAILED)
+	{
+		luax_pushboolean(L, false);
+		lua_pushstring(L, t->getError().c_str());
+		return 2;
+	}
+
+	luax_pushboolean(L, status == FileRequest::STATUS_COMPLETE);
+	return 1;
+}
+
+static const luaL_Reg w_FileRequest_functions[] =
+{
+	{ "getFilename", w_FileRequest_getFilename },
+	{ "getStatus", w_FileRequest_getStatus },
+	{ "isDone", w_FileRequest_isDone },
+	{ "getData", w_FileRequest_getData },
+	{ "getError", w_FileRequest_getError },
+	{ "setPriority", w_FileRequest_setPriority },
+	{ "getPriority", w_FileRequest_getPriority },
+	{ "cancel", w_FileRequest_cancel },
+	{ "isWrite", w_FileRequest_isWrite },
+	{ "wait", w_FileRequest_wait },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_filerequest(lua_State *L)
+{
+	return luax_register_type(L, &FileRequest::type, w_FileRequest_functions, nullptr);
+}
+
+} // filesystem
+} // love
@@ -20,14 +20,18 @@
 
 // LOVE
 #include "common/config.h"
+#include "common/version.h"
 #include "wrap_Filesystem.h"
 #include "wrap_File.h"
 #include "wrap_NativeFile.h"
 #include "wrap_FileData.h"
+#include "wrap_FileRequest.h"
 #include "data/wrap_Data.h"
 #include "data/wrap_DataModule.h"
 
 #include "physfs/Filesystem.h"
+#include "PackArchive.h"
+#include "libraries/xxHash/xxhash.h"
 
 #ifdef LOVE_ANDROID
 #include "common/android.h"
@@ -42,6 +46,8 @@
 #include <string>
 #include <sstream>
 #include <algorithm>
+#include <ctime>
+#include <cstring>
 
 namespace love
 {
@@ -518,6 +524,30 @@ int w_exists(lua_State *L)
 	return 1;
 }
 
+static void setInfoFields(lua_State *L, Filesystem::Info info, const char *typestr)
+{
+	lua_pushstring(L, typestr);
+	lua_setfield(L, -2, "type");
+
+	luax_pushboolean(L, info.readonly);
+	lua_setfield(L, -2, "readonly");
+
+	// Lua numbers (doubles) can't fit the full range of 64 bit ints.
+	info.size = std::min<int64>(info.size, 0x20000000000000LL);
+	if (info.size >= 0)
+	{
+		lua_pushnumber(L, (lua_Number) info.size);
+		lua_setfield(L, -2, "size");
+	}
+
+	info.modtime = std::min<int64>(info.modtime, 0x20000000000000LL);
+	if (info.modtime >= 0)
+	{
+		lua_pushnumber(L, (lua_Number) info.modtime);
+		lua_setfield(L, -2, "modtime");
+	}
+}
+
 int w_getInfo(lua_State *L)
 {
 	const char *filepath = luaL_checkstring(L, 1);
@@ -551,26 +581,7 @@ int w_getInfo(lua_State *L)
 		else
 			lua_createtable(L, 0, 3);
 
-		lua_pushstring(L, typestr);
-		lua_setfield(L, -2, "type");
-
-		luax_pushboolean(L, info.readonly);
-		lua_setfield(L, -2, "readonly");
-
-		// Lua numbers (doubles) can't fit the full range of 64 bit ints.
-		info.size = std::min<int64>(info.size, 0x20000000000000LL);
-		if (info.size >= 0)
-		{
-			lua_pushnumber(L, (lua_Number) info.size);
-			lua_setfield(L, -2, "size");
-		}
-
-		info.modtime = std::min<int64>(info.modtime, 0x20000000000000LL);
-		if (info.modtime >= 0)
-		{
-			lua_pushnumber(L, (lua_Number) info.modtime);
-			lua_setfield(L, -2, "modtime");
-		}
+		setInfoFields(L, info, typestr);
 	}
 	else
 		lua_pushnil(L);
@@ -635,6 +646,19 @@ int w_read(lua_State *L)
 	return 2;
 }
 
+int w_readAsync(lua_State *L)
+{
+	const char *filename = luaL_checkstring(L, 1);
+	int priority = (int) luaL_optinteger(L, 2, 0);
+
+	FileRequest *request = nullptr;
+	luax_catchexcept(L, [&]() { request = instance()->readAsync(filename, priority); });
+
+	luax_pushtype(L, request);
+	request->release();
+	return 1;
+}
+
 static int w_write_or_append(lua_State *L, File::Mode mode)
 {
 	const char *filename = luaL_checkstring(L, 1);
@@ -661,7 +685,7 @@ static int w_write_or_append(lua_State *L, File::Mode mode)
 		if (mode == File::MODE_APPEND)
 			instance()->append(filename, (const void *) input, len);
 		else
-			instance()->write(filename, (const void *) input, len);
+			instance()->write(filename, (const void *) input, len, luax_optboolean(L, 4, false));
 	}
 	catch (love::Exception &e)
 	{
@@ -682,6 +706,89 @@ int w_append(lua_State *L)
 	return w_write_or_append(L, File::MODE_APPEND);
 }
 
+int w_writeAsync(lua_State *L)
+{
+	const char *filename = luaL_checkstring(L, 1);
+
+	StrongRef<love::Data> data;
+
+	if (luax_istype(L, 2, love::Data::type))
+		data.set(luax_totype<love::Data>(L, 2));
+	else if (lua_isstring(L, 2))
+	{
+		// Lua strings can be collected before the write happens.
+		size_t len = 0;
+		const char *str = lua_tolstring(L, 2, &len);
+		luax_catchexcept(L, [&]() { data.set(new FileData(len, filename), Acquire::NORETAIN); });
+		memcpy(data->getData(), str, len);
+	}
+	else
+		return luaL_argerror(L, 2, "string or Data expected");
+
+	bool atomic = luax_optboolean(L, 3, false);
+	int priority = (int) luaL_optinteger(L, 4, 0);
+
+	FileRequest *request = nullptr;
+	luax_catchexcept(L, [&]() { request = instance()->writeAsync(filename, data, atomic, priority); });
+
+	luax_pushtype(L, request);
+	request->release();
+	return 1;
+}
+
+int w_writeArchive(lua_State *L)
+{
+	const char *filename = luaL_checkstring(L, 1);
+	luaL_checktype(L, 2, LUA_TTABLE);
+
+	pack::Compression compression = pack::COMPRESSION_NONE;
+	const char *compressionstr = lua_isnoneornil(L, 3) ? nullptr : luaL_checkstring(L, 3);
+	if (compressionstr && !pack::getConstant(compressionstr, compression))
+		return luax_enumerror(L, "archive compression", pack::getConstants(compression), compressionstr);
+
+	int level = (int) luaL_optinteger(L, 4, -1);
+
+	// The strings and Data stay referenced by the table while writing.
+	std::vector<pack::InputFile> files;
+
+	lua_pushnil(L);
+	while (lua_next(L, 2))
+	{
+		if (lua_type(L, -2) != LUA_TSTRING)
+			return luaL_error(L, "Archive file paths must be strings.");
+
+		pack::InputFile input;
+		input.path = lua_tostring(L, -2);
+
+		if (luax_istype(L, -1, love::Data::type))
+		{
+			love::Data *data = luax_totype<love::Data>(L, -1);
+			input.data = (const char *) data->getData();
+			input.size = data->getSize();
+		}
+		else if (lua_type(L, -1) == LUA_TSTRING)
+			input.data = lua_tolstring(L, -1, &input.size);
+		else
+			return luaL_error(L, "Expected string or Data for archive file %s.", input.path.c_str());
+
+		files.push_back(input);
+		lua_pop(L, 1);
+	}
+
+	try
+	{
+		StrongRef<File> file(instance()->openFile(filename, File::MODE_WRITE), Acquire::NORETAIN);
+		pack::write(file, files, compression, level, (int64) time(nullptr));
+	}
+	catch (love::Exception &e)
+	{
+		return luax_ioError(L, "%s", e.what());
+	}
+
+	luax_pushboolean(L, true);
+	return 1;
+}
+
 int w_getDirectoryItems(lua_State *L)
 {
 	const char *dir = luaL_checkstring(L, 1);
@@ -720,6 +827,91 @@ int w_lines(lua_State *L)
 	return 1;
 }
 
+static const char *BYTECODE_CACHE_DIR = ".bytecodecache";
+
+static std::string getBytecodeCachePath(const std::string &filename, const Data *source)
+{
+	// Bytecode isn't portable between LOVE and Lua versions or architectures.
+	// The chunk name is stored in the bytecode, so it's part of the key too.
+	std::string key = std::string(love::VERSION) + "|" LUA_RELEASE "|" + std::to_string(sizeof(void *)) + "|" + filename;
+
+	XXH64_hash_t seed = XXH64(key.data(), key.size(), 0);
+	XXH64_hash_t hash = XXH64(source->getData(), source->getSize(), seed);
+
+	char name[64];
+	snprintf(name, sizeof(name), "%s/%016llx.luac", BYTECODE_CACHE_DIR, (unsigned long long) hash);
+	return name;
+}
+
+// Pushes the cached chunk and returns true, or returns false with the stack
+// unchanged if there's no usable cached bytecode.
+static bool loadBytecodeCache(lua_State *L, const std::string &cachepath, const std::string &filename)
+{
+	Filesystem::Info info = {};
+	if (!instance()->getInfo(cachepath.c_str(), info) || info.type != Filesystem::FILETYPE_FILE)
+		return false;
+
+	StrongRef<Data> data;
+	try
+	{
+		data.set(instance()->read(cachepath.c_str()), Acquire::NORETAIN);
+	}
+	catch (love::Exception &)
+	{
+		return false;
+	}
+
+#if (LUA_VERSION_NUM > 501) || defined(LUA_JITLIBNAME)
+	int status = luaL_loadbufferx(L, (const char *)data->getData(), data->getSize(), ("@" + filename).c_str(), "b");
+#else
+	int status = luaL_loadbuffer(L, (const char *)data->getData(), data->getSize(), ("@" + filename).c_str());
+#endif
+
+	// Bytecode from a different LuaJIT build is rejected, and is replaced
+	// after compiling from source.
+	if (status != 0)
+	{
+		lua_pop(L, 1);
+		return false;
+	}
+
+	return true;
+}
+
+static int bytecodeWriter(lua_State */*L*/, const void *p, size_t size, void *ud)
+{
+	std::vector<char> *buffer = (std::vector<char> *) ud;
+	buffer->insert(buffer->end(), (const char *) p, (const char *) p + size);
+	return 0;
+}
+
+// Saves the function at the top of the stack. Failures are ignored, since the
+// cache is only an optimization (e.g. there may be no save directory.)
+static void saveBytecodeCache(lua_State *L, const std::string &cachepath)
+{
+	std::vector<char> buffer;
+
+#if LUA_VERSION_NUM >= 503
+	int status = lua_dump(L, bytecodeWriter, &buffer, 0);
+#else
+	int status = lua_dump(L, bytecodeWriter, &buffer);
+#endif
+
+	if (status != 0 || buffer.empty())
+		return;
+
+	try
+	{
+		instance()->createDirectory(BYTECODE_CACHE_DIR);
+
+		// Atomic, since Lua threads can load the same file at the same time.
+		instance()->write(cachepath.c_str(), buffer.data(), (int64) buffer.size(), true);
+	}
+	catch (love::Exception &)
+	{
+	}
+}
+
 int w_load(lua_State *L)
 {
 	std::string filename = std::string(luaL_checkstring(L, 1));
@@ -744,6 +936,21 @@ int w_load(lua_State *L)
 		return luax_ioError(L, "%s", e.what());
 	}
 
+	// Files which are already bytecode (starting with the escape character
+	// of LUA_SIGNATURE) aren't cached. Explicit "t" or "b" modes bypass the
+	// cache, since it would change which kinds of chunks they accept.
+	std::string cachepath;
+	if (instance()->isBytecodeCacheEnabled() && loadMode == Filesystem::LOADMODE_ANY
+		&& data->getSize() > 0 && ((const char *) data->getData())[0] != '\033')
+	{
+		cachepath = getBytecodeCachePath(filename, data);
+		if (loadBytecodeCache(L, cachepath, filename))
+		{
+			data->release();
+			return 1;
+		}
+	}
+
 	int status;
 
 #if (LUA_VERSION_NUM > 501) || defined(LUA_JITLIBNAME)
@@ -773,10 +980,71 @@ int w_load(lua_State *L)
 	case LUA_ERRSYNTAX:
 		return luaL_error(L, "Syntax error: %s\n", lua_tostring(L, -1));
 	default: // success
+		if (!cachepath.empty())
+			saveBytecodeCache(L, cachepath);
 		return 1;
 	}
 }
 
+int w_getDirectoryInfo(lua_State *L)
+{
+	const char *dir = luaL_checkstring(L, 1);
+	bool recursive = luax_optboolean(L, 2, false);
+	std::vector<Filesystem::DirectoryItem> items;
+
+	luax_catchexcept(L, [&]() { instance()->getDirectoryInfo(dir, recursive, items); });
+
+	lua_createtable(L, (int) items.size(), 0);
+
+	for (int i = 0; i < (int) items.size(); i++)
+	{
+		const Filesystem::DirectoryItem &item = items[i];
+
+		const char *typestr = nullptr;
+		if (!Filesystem::getConstant(item.info.type, typestr))
+			return luaL_error(L, "Unknown file type.");
+
+		lua_createtable(L, 0, 5);
+
+		lua_pushstring(L, item.name.c_str());
+		lua_setfield(L, -2, "name");
+
+		setInfoFields(L, item.info, typestr);
+
+		lua_rawseti(L, -2, i + 1);
+	}
+
+	return 1;
+}
+
+int w_watch(lua_State *L)
+{
+	const char *path = luaL_checkstring(L, 1);
+	bool success = false;
+	luax_catchexcept(L, [&]() { success = instance()->watch(path); });
+	luax_pushboolean(L, success);
+	return 1;
+}
+
+int w_unwatch(lua_State *L)
+{
+	const char *path = luaL_checkstring(L, 1);
+	luax_pushboolean(L, instance()->unwatch(path));
+	return 1;
+}
+
+int w_setBytecodeCacheEnabled(lua_State *L)
+{
+	instance()->setBytecodeCacheEnabled(luax_checkboolean(L, 1));
+	return 0;
+}
+
+int w_isBytecodeCacheEnabled(lua_State *L)
+{
+	luax_pushboolean(L, instance()->isBytecodeCacheEnabled());
+	return 1;
+}
+
 int w_setSymlinksEnabled(lua_State *L)
 {
 	instance()->setSymlinksEnabled(luax_checkboolean(L, 1));
@@ -1045,15 +1313,23 @@ static const luaL_Reg functions[] =
 	{ "createDirectory", w_createDirectory },
 	{ "remove", w_remove },
 	{ "read", w_read },
+	{ "readAsync", w_readAsync },
 	{ "write", w_write },
+	{ "writeAsync", w_writeAsync },
 	{ "append", w_append },
+	{ "writeArchive", w_writeArchive },
 	{ "getDirectoryItems", w_getDirectoryItems },
+	{ "getDirectoryInfo", w_getDirectoryInfo },
+	{ "watch", w_watch },
+	{ "unwatch", w_unwatch },
 	{ "lines", w_lines },
 	{ "load", w_load },
 	{ "exists", w_exists },
 	{ "getInfo", w_getInfo },
 	{ "setSymlinksEnabled", w_setSymlinksEnabled },
 	{ "areSymlinksEnabled", w_areSymlinksEnabled },
+	{ "setBytecodeCacheEnabled", w_setBytecodeCacheEnabled },
+	{ "isBytecodeCacheEnabled", w_isBytecodeCacheEnabled },
 	{ "newFileData", w_newFileData },
 	{ "getRequirePath", w_getRequirePath },
 	{ "setRequirePath", w_setRequirePath },
@@ -1071,6 +1347,7 @@ static const lua_CFunction types[] =
 	luaopen_file,
 	luaopen_nativefile,
 	luaopen_filedata,
+	luaopen_filerequest,
 	0
 };
 
@@ -382,6 +382,34 @@ Rasterizer::DataType BMFontRasterizer::getDataType() const
 	return DATA_IMAGE;
 }
 
+int BMFontRasterizer::getAtlasPageCount() const
+{
+	int count = 0;
+	for (const auto &imagepair : images)
+		count = std::max(count, imagepair.first + 1);
+	return count;
+}
+
+image::ImageData *BMFontRasterizer::getAtlasPage(int page) const
+{
+	const auto &imagepair = images.find(page);
+	return imagepair != images.end() ? imagepair->second.get() : nullptr;
+}
+
+bool BMFontRasterizer::getAtlasGlyph(int index, AtlasGlyph &glyph) const
+{
+	if (index < 0 || index >= (int) characters.size())
+		return false;
+
+	const BMFontCharacter &c = characters[index];
+
+	glyph.page = c.page;
+	glyph.x = c.x;
+	glyph.y = c.y;
+	glyph.metrics = c.metrics;
+	return true;
+}
+
 TextShaper *BMFontRasterizer::newTextShaper()
 {
 	return new GenericShaper(this);
@@ -54,6 +54,9 @@ public:
 	bool hasGlyph(uint32 glyph) const override;
 	float getKerning(uint32 leftglyph, uint32 rightglyph) const override;
 	DataType getDataType() const override;
+	int getAtlasPageCount() const override;
+	image::ImageData *getAtlasPage(int page) const override;
+	bool getAtlasGlyph(int index, AtlasGlyph &glyph) const override;
 	TextShaper *newTextShaper() override;
 
 	static bool accepts(love::filesystem::FileData *fontdef);
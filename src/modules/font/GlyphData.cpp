@@ -20,6 +20,7 @@
 
 // LOVE
 #include "GlyphData.h"
+#include "common/memory.h"
 
 // UTF-8
 #include "libraries/utf8/utf8.h"
@@ -41,7 +42,10 @@ GlyphData::GlyphData(uint32 glyph, GlyphMetrics glyphMetrics, PixelFormat f)
 		throw love::Exception("Invalid GlyphData pixel format.");
 
 	if (metrics.width > 0 && metrics.height > 0)
+	{
 		data = new uint8[metrics.width * metrics.height * getPixelSize()];
+		trackMemory(MEMORYTAG_FONT, (int64) getSize());
+	}
 }
 
 GlyphData::GlyphData(const GlyphData &c)
@@ -54,11 +58,14 @@ GlyphData::GlyphData(const GlyphData &c)
 	{
 		data = new uint8[metrics.width * metrics.height * getPixelSize()];
 		memcpy(data, c.data, c.getSize());
+		trackMemory(MEMORYTAG_FONT, (int64) getSize());
 	}
 }
 
 GlyphData::~GlyphData()
 {
+	if (data != nullptr)
+		trackMemory(MEMORYTAG_FONT, -(int64) getSize());
 	delete[] data;
 }
 
@@ -178,6 +178,52 @@ Rasterizer::DataType ImageRasterizer::getDataType() const
 	return DATA_IMAGE;
 }
 
+int ImageRasterizer::getAtlasPageCount() const
+{
+	return 1;
+}
+
+image::ImageData *ImageRasterizer::getAtlasPage(int page) const
+{
+	if (page != 0)
+		return nullptr;
+
+	// Always lock the mutex since the user can't know when to do it.
+	love::thread::Lock lock(imageData->getMutex());
+
+	if (atlasImageData.get() == nullptr)
+	{
+		atlasImageData.set(imageData->clone(), Acquire::NORETAIN);
+
+		Color32 *pixels = (Color32 *) atlasImageData->getData();
+		size_t pixelcount = (size_t) atlasImageData->getWidth() * atlasImageData->getHeight();
+
+		// Use transparency instead of the spacer color
+		for (size_t i = 0; i < pixelcount; i++)
+		{
+			if (pixels[i] == spacer)
+				pixels[i] = Color32(0, 0, 0, 0);
+		}
+	}
+
+	return atlasImageData.get();
+}
+
+bool ImageRasterizer::getAtlasGlyph(int index, AtlasGlyph &glyph) const
+{
+	if (index < 0 || index >= (int) imageGlyphs.size())
+		return false;
+
+	glyph.page = 0;
+	glyph.x = imageGlyphs[index].x;
+	glyph.y = 0;
+	glyph.metrics = {};
+	glyph.metrics.width = imageGlyphs[index].width;
+	glyph.metrics.height = metrics.height;
+	glyph.metrics.advance = imageGlyphs[index].width + extraSpacing;
+	return true;
+}
+
 TextShaper *ImageRasterizer::newTextShaper()
 {
 	return new GenericShaper(this);
@@ -50,6 +50,9 @@ public:
 	int getGlyphCount() const override;
 	bool hasGlyph(uint32 glyph) const override;
 	DataType getDataType() const override;
+	int getAtlasPageCount() const override;
+	image::ImageData *getAtlasPage(int page) const override;
+	bool getAtlasGlyph(int index, AtlasGlyph &glyph) const override;
 	TextShaper *newTextShaper() override;
 
 
@@ -69,6 +72,10 @@ private:
 	// The image data
 	StrongRef<love::image::ImageData> imageData;
 
+	// Copy of the image data with transparency instead of the spacer color,
+	// created when it's first used as an atlas.
+	mutable StrongRef<love::image::ImageData> atlasImageData;
+
 	// Number of glyphs in the font
 	int numglyphs;
 
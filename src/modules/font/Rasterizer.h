@@ -24,6 +24,7 @@
 // LOVE
 #include "common/Object.h"
 #include "common/int.h"
+#include "image/ImageData.h"
 #include "GlyphData.h"
 
 namespace love
@@ -44,6 +45,18 @@ struct FontMetrics
 	int height;
 };
 
+/**
+ * Location of a glyph in an image page which already has all of a
+ * Rasterizer's glyphs laid out in it.
+ **/
+struct AtlasGlyph
+{
+	int page;
+	int x;
+	int y;
+	GlyphMetrics metrics;
+};
+
 /**
  * Holds data for a font object.
  **/
@@ -137,17 +150,41 @@ public:
 
 	virtual DataType getDataType() const = 0;
 
+	/**
+	 * Gets the number of image pages the glyphs are already laid out in, or 0
+	 * if glyphs have to be copied out individually with getGlyphData.
+	 **/
+	virtual int getAtlasPageCount() const { return 0; }
+
+	/**
+	 * Gets an image page for getAtlasPageCount. Pixels outside of glyphs are
+	 * transparent.
+	 **/
+	virtual image::ImageData *getAtlasPage(int /*page*/) const { return nullptr; }
+
+	/**
+	 * Gets where the glyph for the given rasterizer glyph index is in the
+	 * atlas pages. Returns false if it isn't in any.
+	 **/
+	virtual bool getAtlasGlyph(int /*index*/, AtlasGlyph &/*glyph*/) const { return false; }
+
 	virtual ptrdiff_t getHandle() const { return 0; }
 
 	virtual TextShaper *newTextShaper() = 0;
 
 	float getDPIScale() const;
 
+	/**
+	 * Gets whether the glyphs are signed distance fields, with the glyph edge
+	 * at half of the maximum alpha value.
+	 **/
+	bool isSDF() const;
+
 protected:
 
 	FontMetrics metrics;
 	float dpiScale;
-	bool sdf;
+	bool sdf = false;
 
 }; // Rasterizer
 
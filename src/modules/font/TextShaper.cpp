@@ -25,30 +25,102 @@
 
 #include "libraries/utf8/utf8.h"
 
+// C++
+#include <algorithm>
+#include <cmath>
+
+#if defined(LOVE_SIMD_SSE) && (defined(__SSE2__) || defined(_M_AMD64) || defined(_M_X64))
+#define LOVE_TEXTSHAPER_SSE2
+#include <emmintrin.h>
+#elif defined(LOVE_SIMD_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+#define LOVE_TEXTSHAPER_NEON
+#include <arm_neon.h>
+#endif
+
 namespace love
 {
 namespace font
 {
 
+// Widens runs of 16 ASCII bytes at a time, stopping at the first block with
+// a byte that isn't ASCII. Returns the number of bytes (and codepoints) done.
+static size_t decodeASCIIBlocks(const char *src, size_t length, uint32 *dst)
+{
+	size_t i = 0;
+
+#if defined(LOVE_TEXTSHAPER_SSE2)
+	const __m128i zero = _mm_setzero_si128();
+	for (; i + 16 <= length; i += 16)
+	{
+		__m128i bytes = _mm_loadu_si128((const __m128i *) (src + i));
+		if (_mm_movemask_epi8(bytes) != 0)
+			break;
+
+		__m128i lo = _mm_unpacklo_epi8(bytes, zero);
+		__m128i hi = _mm_unpackhi_epi8(bytes, zero);
+		_mm_storeu_si128((__m128i *) (dst + i + 0), _mm_unpacklo_epi16(lo, zero));
+		_mm_storeu_si128((__m128i *) (dst + i + 4), _mm_unpackhi_epi16(lo, zero));
+		_mm_storeu_si128((__m128i *) (dst + i + 8), _mm_unpacklo_epi16(hi, zero));
+		_mm_storeu_si128((__m128i *) (dst + i + 12), _mm_unpackhi_epi16(hi, zero));
+	}
+#elif defined(LOVE_TEXTSHAPER_NEON)
+	for (; i + 16 <= length; i += 16)
+	{
+		uint8x16_t bytes = vld1q_u8((const uint8_t *) (src + i));
+		if (vmaxvq_u8(bytes) >= 0x80)
+			break;
+
+		uint16x8_t lo = vmovl_u8(vget_low_u8(bytes));
+		uint16x8_t hi = vmovl_high_u8(bytes);
+		vst1q_u32(dst + i + 0, vmovl_u16(vget_low_u16(lo)));
+		vst1q_u32(dst + i + 4, vmovl_high_u16(lo));
+		vst1q_u32(dst + i + 8, vmovl_u16(vget_low_u16(hi)));
+		vst1q_u32(dst + i + 12, vmovl_high_u16(hi));
+	}
+#else
+	LOVE_UNUSED(src);
+	LOVE_UNUSED(length);
+	LOVE_UNUSED(dst);
+#endif
+
+	return i;
+}
+
 void getCodepointsFromString(const std::string &text, std::vector<uint32> &codepoints)
 {
-	codepoints.reserve(text.size());
+	// There's never more than one codepoint per byte, so decode straight into
+	// the vector and trim it afterwards.
+	size_t start = codepoints.size();
+	codepoints.resize(start + text.size());
+
+	const char *src = text.data();
+	const char *end = src + text.size();
+	uint32 *dst = codepoints.data() + start;
 
 	try
 	{
-		utf8::iterator<std::string::const_iterator> i(text.begin(), text.begin(), text.end());
-		utf8::iterator<std::string::const_iterator> end(text.end(), text.begin(), text.end());
-
-		while (i != end)
+		while (src < end)
 		{
-			uint32 g = *i++;
-			codepoints.push_back(g);
+			// Mostly-ASCII text is handled in blocks, and the rest one
+			// (validated) codepoint at a time.
+			size_t count = decodeASCIIBlocks(src, (size_t) (end - src), dst);
+			src += count;
+			dst += count;
+
+			while (src < end && (unsigned char) *src < 0x80)
+				*dst++ = (unsigned char) *src++;
+
+			if (src < end)
+				*dst++ = utf8::next(src, end);
 		}
 	}
 	catch (utf8::exception &e)
 	{
+		codepoints.resize(start);
 		throw love::Exception("UTF-8 decoding error: %s", e.what());
 	}
+
+	codepoints.resize(dst - codepoints.data());
 }
 
 void getCodepointsFromString(const std::vector<ColoredString> &strs, ColoredCodepoints &codepoints)
@@ -279,6 +351,63 @@ float TextShaper::getWidth(const std::string& str)
 	return info.width;
 }
 
+void TextShaper::shapeTexts(const std::vector<std::string> &texts, float wraplimit, FrameVector<GlyphPosition> &positions, std::vector<ShapedTextInfo> &infos)
+{
+	std::vector<ColoredCodepoints> allcodepoints(texts.size());
+
+	size_t totalcodepoints = 0;
+	for (size_t i = 0; i < texts.size(); i++)
+	{
+		getCodepointsFromString(texts[i], allcodepoints[i].cps);
+		totalcodepoints += allcodepoints[i].cps.size();
+	}
+
+	// The shapers only reserve space for the text they're given, so reserve
+	// space for everything up front to avoid reallocating for every string.
+	positions.reserve(positions.size() + totalcodepoints);
+	infos.reserve(infos.size() + texts.size());
+
+	std::vector<Range> ranges;
+	std::vector<float> widths;
+
+	for (const ColoredCodepoints &codepoints : allcodepoints)
+	{
+		ShapedTextInfo info = {(int) positions.size(), 0, 0.0f, 0.0f};
+
+		if (wraplimit > 0.0f)
+		{
+			ranges.clear();
+			widths.clear();
+			getWrap(codepoints, wraplimit, ranges, &widths);
+
+			float y = 0.0f;
+
+			for (size_t i = 0; i < ranges.size(); i++)
+			{
+				if (ranges[i].isValid())
+				{
+					computeGlyphPositions(codepoints, ranges[i], Vector2(0.0f, floorf(y)), 0.0f, &positions, nullptr, nullptr);
+					info.width = std::max(info.width, widths[i]);
+				}
+
+				y += getCombinedHeight();
+			}
+
+			info.height = y;
+		}
+		else
+		{
+			TextInfo textinfo = {};
+			computeGlyphPositions(codepoints, Range(), Vector2(0.0f, 0.0f), 0.0f, &positions, nullptr, &textinfo);
+			info.width = textinfo.width;
+			info.height = textinfo.height;
+		}
+
+		info.glyphCount = (int) positions.size() - info.firstGlyph;
+		infos.push_back(info);
+	}
+}
+
 static size_t findNewline(const ColoredCodepoints &codepoints, size_t start)
 {
 	for (size_t i = start; i < codepoints.cps.size(); i++)
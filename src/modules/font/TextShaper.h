@@ -26,6 +26,7 @@
 #include "common/int.h"
 #include "common/Color.h"
 #include "common/Range.h"
+#include "common/memory.h"
 
 #include <vector>
 #include <string>
@@ -81,6 +82,15 @@ public:
 		float height;
 	};
 
+	// Where one string's glyphs are in the output of shapeTexts.
+	struct ShapedTextInfo
+	{
+		int firstGlyph;
+		int glyphCount;
+		float width;
+		float height;
+	};
+
 	// This will be used if the Rasterizer doesn't have a tab character itself.
 	static const int SPACES_PER_TAB = 4;
 
@@ -128,7 +138,14 @@ public:
 
 	virtual void setFallbacks(const std::vector<Rasterizer *> &fallbacks);
 
-	virtual void computeGlyphPositions(const ColoredCodepoints &codepoints, Range range, Vector2 offset, float extraspacing, std::vector<GlyphPosition> *positions, std::vector<IndexedColor> *colors, TextInfo *info) = 0;
+	/**
+	 * Lays out each string (wrapped if wraplimit is positive) and appends the
+	 * glyph positions of all of them to a single array. Separate TextShapers
+	 * with separate Rasterizers can do this on different threads at once.
+	 **/
+	void shapeTexts(const std::vector<std::string> &texts, float wraplimit, FrameVector<GlyphPosition> &positions, std::vector<ShapedTextInfo> &infos);
+
+	virtual void computeGlyphPositions(const ColoredCodepoints &codepoints, Range range, Vector2 offset, float extraspacing, FrameVector<GlyphPosition> *positions, FrameVector<IndexedColor> *colors, TextInfo *info) = 0;
 	virtual int computeWordWrapIndex(const ColoredCodepoints &codepoints, Range range, float wraplimit, float *width) = 0;
 
 protected:
@@ -201,7 +201,7 @@ void HarfbuzzShaper::computeBufferRanges(const ColoredCodepoints &codepoints, Ra
 	});
 }
 
-void HarfbuzzShaper::computeGlyphPositions(const ColoredCodepoints &codepoints, Range range, Vector2 offset, float extraspacing, std::vector<GlyphPosition> *positions, std::vector<IndexedColor> *colors, TextInfo *info)
+void HarfbuzzShaper::computeGlyphPositions(const ColoredCodepoints &codepoints, Range range, Vector2 offset, float extraspacing, FrameVector<GlyphPosition> *positions, FrameVector<IndexedColor> *colors, TextInfo *info)
 {
 	if (!range.isValid() && !codepoints.cps.empty())
 		range = Range(0, codepoints.cps.size());
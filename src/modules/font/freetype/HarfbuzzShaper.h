@@ -46,7 +46,7 @@ public:
 	virtual ~HarfbuzzShaper();
 
 	void setFallbacks(const std::vector<Rasterizer *> &fallbacks) override;
-	void computeGlyphPositions(const ColoredCodepoints &codepoints, Range range, Vector2 offset, float extraspacing, std::vector<GlyphPosition> *positions, std::vector<IndexedColor> *colors, TextInfo *info) override;
+	void computeGlyphPositions(const ColoredCodepoints &codepoints, Range range, Vector2 offset, float extraspacing, FrameVector<GlyphPosition> *positions, FrameVector<IndexedColor> *colors, TextInfo *info) override;
 	int computeWordWrapIndex(const ColoredCodepoints &codepoints, Range range, float wraplimit, float *width) override;
 
 private:
@@ -22,6 +22,7 @@
 #include "TrueTypeRasterizer.h"
 #include "HarfbuzzShaper.h"
 #include "common/Exception.h"
+#include "thread/threads.h"
 
 // C
 #include <math.h>
@@ -33,6 +34,15 @@ namespace font
 namespace freetype
 {
 
+// Faces can be used on different threads at the same time as long as each
+// face is only used by one thread, but creating and destroying faces with the
+// shared FT_Library has to be serialized.
+static love::thread::Mutex *getLibraryMutex()
+{
+	static love::thread::MutexRef mutex;
+	return mutex;
+}
+
 TrueTypeRasterizer::TrueTypeRasterizer(FT_Library library, love::Data *data, int size, const Settings &settings, float defaultdpiscale)
 	: data(data)
 	, hinting(settings.hinting)
@@ -44,6 +54,8 @@ TrueTypeRasterizer::TrueTypeRasterizer(FT_Library library, love::Data *data, int
 	if (size <= 0)
 		throw love::Exception("Invalid TrueType font size: %d", size);
 
+	love::thread::Lock lock(getLibraryMutex());
+
 	FT_Error err = FT_Err_Ok;
 	err = FT_New_Memory_Face(library,
 	                         (const FT_Byte *)data->getData(), /* first byte in memory */
@@ -69,6 +81,7 @@ TrueTypeRasterizer::TrueTypeRasterizer(FT_Library library, love::Data *data, int
 
 TrueTypeRasterizer::~TrueTypeRasterizer()
 {
+	love::thread::Lock lock(getLibraryMutex());
 	FT_Done_Face(face);
 }
 
@@ -236,6 +249,7 @@ bool TrueTypeRasterizer::accepts(FT_Library library, love::Data *data)
 	FT_Long fsize = (FT_Long) data->getSize();
 
 	// Pasing in -1 for the face index lets us test if the data is valid.
+	love::thread::Lock lock(getLibraryMutex());
 	return FT_New_Memory_Face(library, fbase, fsize, -1, nullptr) == 0;
 }
 
@@ -21,6 +21,8 @@
 #include "wrap_Rasterizer.h"
 
 #include "data/wrap_Data.h"
+#include "data/ByteData.h"
+#include "TextShaper.h"
 
 namespace love
 {
@@ -124,6 +126,82 @@ int w_Rasterizer_hasGlyphs(lua_State *L)
 	return 1;
 }
 
+int w_Rasterizer_shapeTexts(lua_State *L)
+{
+	Rasterizer *t = luax_checkrasterizer(L, 1);
+
+	std::vector<std::string> texts;
+	if (lua_istable(L, 2))
+	{
+		int len = (int) luax_objlen(L, 2);
+		for (int i = 1; i <= len; i++)
+		{
+			lua_rawgeti(L, 2, i);
+			texts.push_back(luax_checkstring(L, -1));
+			lua_pop(L, 1);
+		}
+	}
+	else
+		texts.push_back(luax_checkstring(L, 2));
+
+	float wraplimit = (float) luaL_optnumber(L, 3, 0.0);
+
+	std::vector<TextShaper::ShapedTextInfo> infos;
+	love::data::ByteData *data = nullptr;
+
+	luax_catchexcept(L, [&]() {
+		// Kept inside the lambda so it's freed before any Lua error is raised.
+		FrameVector<TextShaper::GlyphPosition> positions;
+
+		StrongRef<TextShaper> shaper(t->newTextShaper(), Acquire::NORETAIN);
+		shaper->shapeTexts(texts, wraplimit, positions, infos);
+
+		// Each glyph is stored as its x and y position (floats) followed by
+		// its glyph index in the Rasterizer (32 bit unsigned integer).
+		struct ShapedGlyph
+		{
+			float x;
+			float y;
+			uint32 index;
+		};
+
+		data = new love::data::ByteData(std::max(positions.size(), (size_t) 1) * sizeof(ShapedGlyph), false);
+		ShapedGlyph *glyphs = (ShapedGlyph *) data->getData();
+
+		for (size_t i = 0; i < positions.size(); i++)
+		{
+			glyphs[i].x = positions[i].position.x;
+			glyphs[i].y = positions[i].position.y;
+			glyphs[i].index = (uint32) positions[i].glyphIndex.index;
+		}
+	});
+
+	luax_pushtype(L, data);
+	data->release();
+
+	lua_createtable(L, (int) infos.size(), 0);
+
+	for (size_t i = 0; i < infos.size(); i++)
+	{
+		const auto &info = infos[i];
+
+		lua_createtable(L, 0, 4);
+
+		lua_pushinteger(L, info.firstGlyph + 1);
+		lua_setfield(L, -2, "first");
+		lua_pushinteger(L, info.glyphCount);
+		lua_setfield(L, -2, "count");
+		lua_pushnumber(L, info.width);
+		lua_setfield(L, -2, "width");
+		lua_pushnumber(L, info.height);
+		lua_setfield(L, -2, "height");
+
+		lua_rawseti(L, -2, (int) i + 1);
+	}
+
+	return 2;
+}
+
 const luaL_Reg w_Rasterizer_functions[] =
 {
 	{ "getHeight", w_Rasterizer_getHeight },
@@ -134,6 +212,7 @@ const luaL_Reg w_Rasterizer_functions[] =
 	{ "getGlyphData", w_Rasterizer_getGlyphData },
 	{ "getGlyphCount", w_Rasterizer_getGlyphCount },
 	{ "hasGlyphs", w_Rasterizer_hasGlyphs },
+	{ "shapeTexts", w_Rasterizer_shapeTexts },
 	{ 0, 0 }
 };
 
@@ -28,6 +28,7 @@ namespace graphics
 {
 
 love::Type Buffer::type("GraphicsBuffer", &Object::type);
+love::Type BufferUpload::type("BufferUpload", &Object::type);
 
 int Buffer::bufferCount = 0;
 int64 Buffer::totalGraphicsMemory = 0;
@@ -239,11 +240,13 @@ Buffer::Buffer(Graphics *gfx, const Settings &settings, const std::vector<DataDe
 
 	++bufferCount;
 	totalGraphicsMemory += size;
+	trackMemory(MEMORYTAG_BUFFER, (int64) size);
 }
 
 Buffer::~Buffer()
 {
 	totalGraphicsMemory -= size;
+	trackMemory(MEMORYTAG_BUFFER, -(int64) size);
 	--bufferCount;
 }
 
@@ -272,6 +275,22 @@ void Buffer::clear(size_t offset, size_t size)
 	clearInternal(offset, size);
 }
 
+bool Buffer::isSubAllocatable(const Settings &settings, size_t size)
+{
+	const uint32 allowedflags = BUFFERUSAGEFLAG_VERTEX | BUFFERUSAGEFLAG_INDEX;
+
+	if (settings.usageFlags == 0 || (settings.usageFlags & ~allowedflags) != 0)
+		return false;
+
+	if (settings.dataUsage != BUFFERDATAUSAGE_STATIC && settings.dataUsage != BUFFERDATAUSAGE_DYNAMIC)
+		return false;
+
+	if (!settings.debugName.empty())
+		return false;
+
+	return size > 0 && size <= SUBALLOCATION_MAX_SIZE;
+}
+
 std::vector<Buffer::DataDeclaration> Buffer::getCommonFormatDeclaration(CommonFormat format)
 {
 	switch (format)
@@ -333,5 +352,14 @@ std::vector<Buffer::DataDeclaration> Buffer::getCommonFormatDeclaration(CommonFo
 	return {};
 }
 
+BufferUpload::BufferUpload(Buffer *buffer)
+	: buffer(buffer)
+{
+}
+
+BufferUpload::~BufferUpload()
+{
+}
+
 } // graphics
 } // love
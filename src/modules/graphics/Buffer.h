@@ -54,6 +54,12 @@ public:
 
 	static const size_t SHADER_STORAGE_BUFFER_MAX_STRIDE = 2048;
 
+	// Small vertex and index buffers are placed in shared pages of this size
+	// instead of getting their own API object.
+	static const size_t SUBALLOCATION_PAGE_SIZE = 1024 * 1024;
+	static const size_t SUBALLOCATION_MAX_SIZE = 64 * 1024;
+	static const size_t SUBALLOCATION_ALIGNMENT = 16;
+
 	enum MapType
 	{
 		MAP_WRITE_INVALIDATE,
@@ -156,6 +162,14 @@ public:
 
 	static std::vector<DataDeclaration> getCommonFormatDeclaration(CommonFormat format);
 
+	/**
+	 * Whether a buffer with these settings can be placed in a shared page.
+	 * Only unnamed vertex or index buffers with static or dynamic data usage
+	 * qualify, since everything else either needs its own object for binding
+	 * or relies on per-object behaviour such as orphaning.
+	 **/
+	static bool isSubAllocatable(const Settings &settings, size_t size);
+
 	class Mapper
 	{
 	public:
@@ -201,5 +215,29 @@ protected:
 	
 }; // Buffer
 
+/**
+ * Tracks the initial data of a Buffer created by Graphics::newBufferAsync.
+ * Backends which can't upload on another thread complete it immediately.
+ **/
+class BufferUpload : public love::Object
+{
+public:
+
+	static love::Type type;
+
+	BufferUpload(Buffer *buffer);
+	virtual ~BufferUpload();
+
+	// Must be called on the main thread.
+	virtual bool isComplete() { return true; }
+
+	Buffer *getBuffer() const { return buffer.get(); }
+
+private:
+
+	StrongRef<Buffer> buffer;
+
+}; // BufferUpload
+
 } // graphics
 } // love
@@ -0,0 +1,189 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "BufferSubAllocator.h"
+#include "common/memory.h"
+
+namespace love
+{
+namespace graphics
+{
+
+BufferSubAllocator::BufferSubAllocator(size_t pagesize, size_t alignment)
+	: pageSize(pagesize)
+	, alignment(alignment)
+	, pageCount(0)
+	, allocatedSize(0)
+{
+}
+
+BufferSubAllocator::~BufferSubAllocator()
+{
+	// Subclasses are responsible for destroying their page objects, since
+	// destroyPage can't be called from here.
+}
+
+bool BufferSubAllocator::allocateFromPage(Page &page, size_t size, size_t &offset)
+{
+	for (size_t i = 0; i < page.freeRanges.size(); i++)
+	{
+		FreeRange &r = page.freeRanges[i];
+		if (r.size < size)
+			continue;
+
+		offset = r.offset;
+
+		if (r.size == size)
+			page.freeRanges.erase(page.freeRanges.begin() + i);
+		else
+		{
+			r.offset += size;
+			r.size -= size;
+		}
+
+		page.used += size;
+		return true;
+	}
+
+	return false;
+}
+
+bool BufferSubAllocator::allocate(size_t size, Allocation &allocation)
+{
+	size = alignUp(size, alignment);
+
+	if (size == 0 || size > pageSize)
+		return false;
+
+	for (size_t i = 0; i < pages.size(); i++)
+	{
+		Page &page = pages[i];
+		if (page.alive && allocateFromPage(page, size, allocation.offset))
+		{
+			allocation.page = (int) i;
+			allocation.size = size;
+			allocatedSize += size;
+			return true;
+		}
+	}
+
+	// Reuse the slot of a previously destroyed page, if there is one.
+	size_t index = pages.size();
+	for (size_t i = 0; i < pages.size(); i++)
+	{
+		if (!pages[i].alive)
+		{
+			index = i;
+			break;
+		}
+	}
+
+	if (!createPage((int) index, pageSize))
+		return false;
+
+	if (index == pages.size())
+		pages.emplace_back();
+
+	Page &page = pages[index];
+	page.alive = true;
+	page.used = 0;
+	page.freeRanges = {{0, pageSize}};
+	pageCount++;
+
+	allocateFromPage(page, size, allocation.offset);
+
+	allocation.page = (int) index;
+	allocation.size = size;
+	allocatedSize += size;
+	return true;
+}
+
+void BufferSubAllocator::deallocate(Allocation &allocation)
+{
+	if (!allocation.isValid() || allocation.page >= (int) pages.size())
+		return;
+
+	Page &page = pages[allocation.page];
+	if (!page.alive)
+		return;
+
+	auto &ranges = page.freeRanges;
+
+	size_t i = 0;
+	while (i < ranges.size() && ranges[i].offset < allocation.offset)
+		i++;
+
+	ranges.insert(ranges.begin() + i, {allocation.offset, allocation.size});
+
+	// Merge with the following range, then with the preceding one.
+	if (i + 1 < ranges.size() && ranges[i].offset + ranges[i].size == ranges[i + 1].offset)
+	{
+		ranges[i].size += ranges[i + 1].size;
+		ranges.erase(ranges.begin() + i + 1);
+	}
+
+	if (i > 0 && ranges[i - 1].offset + ranges[i - 1].size == ranges[i].offset)
+	{
+		ranges[i - 1].size += ranges[i].size;
+		ranges.erase(ranges.begin() + i);
+	}
+
+	page.used -= allocation.size;
+	allocatedSize -= allocation.size;
+
+	if (page.used == 0)
+	{
+		// Keep one empty page around for the next allocation.
+		int emptypages = 0;
+		for (const Page &p : pages)
+		{
+			if (p.alive && p.used == 0)
+				emptypages++;
+		}
+
+		if (emptypages > 1)
+		{
+			destroyPage(allocation.page);
+			page.alive = false;
+			page.freeRanges.clear();
+			pageCount--;
+		}
+	}
+
+	allocation = Allocation();
+}
+
+void BufferSubAllocator::releaseEmptyPages()
+{
+	for (size_t i = 0; i < pages.size(); i++)
+	{
+		Page &page = pages[i];
+		if (page.alive && page.used == 0)
+		{
+			destroyPage((int) i);
+			page.alive = false;
+			page.freeRanges.clear();
+			pageCount--;
+		}
+	}
+}
+
+} // graphics
+} // love
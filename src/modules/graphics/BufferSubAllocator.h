@@ -0,0 +1,105 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// C++
+#include <vector>
+#include <stddef.h>
+
+namespace love
+{
+namespace graphics
+{
+
+/**
+ * Places many small buffers into a few large shared pages. Only the offset
+ * bookkeeping happens here, the backend that subclasses this creates and
+ * destroys the API objects for the pages themselves.
+ **/
+class BufferSubAllocator
+{
+public:
+
+	struct Allocation
+	{
+		int page = -1;
+		size_t offset = 0;
+		size_t size = 0;
+
+		bool isValid() const { return page >= 0; }
+	};
+
+	BufferSubAllocator(size_t pagesize, size_t alignment);
+	virtual ~BufferSubAllocator();
+
+	/**
+	 * Finds space for size bytes in an existing page, or creates a new page.
+	 * Returns false if no page could be created.
+	 **/
+	bool allocate(size_t size, Allocation &allocation);
+	void deallocate(Allocation &allocation);
+
+	/**
+	 * Destroys pages which don't contain any allocations. A single empty page
+	 * is otherwise kept around to avoid churn when small buffers are created
+	 * and released every frame.
+	 **/
+	void releaseEmptyPages();
+
+	size_t getPageSize() const { return pageSize; }
+	int getPageCount() const { return pageCount; }
+	size_t getAllocatedSize() const { return allocatedSize; }
+
+protected:
+
+	virtual bool createPage(int index, size_t size) = 0;
+	virtual void destroyPage(int index) = 0;
+
+private:
+
+	struct FreeRange
+	{
+		size_t offset;
+		size_t size;
+	};
+
+	struct Page
+	{
+		bool alive = false;
+		size_t used = 0;
+
+		// Sorted by offset, adjacent ranges are always merged.
+		std::vector<FreeRange> freeRanges;
+	};
+
+	bool allocateFromPage(Page &page, size_t size, size_t &offset);
+
+	size_t pageSize;
+	size_t alignment;
+
+	std::vector<Page> pages;
+	int pageCount;
+	size_t allocatedSize;
+
+}; // BufferSubAllocator
+
+} // graphics
+} // love
@@ -0,0 +1,320 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+
+#include "DrawList.h"
+
+#include <algorithm>
+#include <string.h>
+
+namespace love
+{
+namespace graphics
+{
+
+love::Type DrawList::type("DrawList", &Drawable::type);
+
+template <typename T>
+static void tintVertices(T *vertices, int count, const Colorf &tint)
+{
+	for (int i = 0; i < count; i++)
+	{
+		Color32 &c = vertices[i].color;
+		c.r = (uint8) (c.r * tint.r + 0.5f);
+		c.g = (uint8) (c.g * tint.g + 0.5f);
+		c.b = (uint8) (c.b * tint.b + 0.5f);
+		c.a = (uint8) (c.a * tint.a + 0.5f);
+	}
+}
+
+static void tintStream(CommonFormat format, void *data, int count, const Colorf &tint)
+{
+	switch (format)
+	{
+	case CommonFormat::RGBAub:
+		for (int i = 0; i < count; i++)
+		{
+			Color32 &c = ((Color32 *) data)[i];
+			c.r = (uint8) (c.r * tint.r + 0.5f);
+			c.g = (uint8) (c.g * tint.g + 0.5f);
+			c.b = (uint8) (c.b * tint.b + 0.5f);
+			c.a = (uint8) (c.a * tint.a + 0.5f);
+		}
+		break;
+	case CommonFormat::STf_RGBAub:
+		tintVertices((STf_RGBAub *) data, count, tint);
+		break;
+	case CommonFormat::STPf_RGBAub:
+		tintVertices((STPf_RGBAub *) data, count, tint);
+		break;
+	case CommonFormat::XYf_STf_RGBAub:
+		tintVertices((XYf_STf_RGBAub *) data, count, tint);
+		break;
+	case CommonFormat::XYf_STus_RGBAub:
+		tintVertices((XYf_STus_RGBAub *) data, count, tint);
+		break;
+	case CommonFormat::XYf_STPf_RGBAub:
+		tintVertices((XYf_STPf_RGBAub *) data, count, tint);
+		break;
+	default:
+		break;
+	}
+}
+
+template <typename T>
+static void transformInterleaved(const Matrix4 &t, void *dst, const void *src, int count)
+{
+	memcpy(dst, src, sizeof(T) * count);
+	t.transformXY((T *) dst, (const T *) src, count);
+}
+
+DrawList::DrawList()
+	: vertexCount(0)
+{
+}
+
+DrawList::~DrawList()
+{
+}
+
+void DrawList::clear()
+{
+	entries.clear();
+	vertexData[0].clear();
+	vertexData[1].clear();
+	vertexCount = 0;
+}
+
+int DrawList::getDrawCount() const
+{
+	return (int) entries.size();
+}
+
+int DrawList::getVertexCount() const
+{
+	return vertexCount;
+}
+
+bool DrawList::canMerge(const Entry &entry, const Graphics::BatchedDrawCommand &cmd, const BlendState &blend) const
+{
+	const Graphics::BatchedDrawCommand &last = entry.command;
+
+	if (entry.drawable.get() != nullptr)
+		return false;
+
+	// Strips and fans can't be joined without changing their triangles.
+	if (cmd.primitiveMode != PRIMITIVE_TRIANGLES && cmd.primitiveMode != PRIMITIVE_POINTS)
+		return false;
+
+	if (cmd.indexMode != TRIANGLEINDEX_NONE && cmd.indexMode != TRIANGLEINDEX_QUADS)
+		return false;
+
+	// The batching system uses 16 bit indices.
+	if (cmd.indexMode != TRIANGLEINDEX_NONE && last.vertexCount + cmd.vertexCount > LOVE_UINT16_MAX)
+		return false;
+
+	return last.primitiveMode == cmd.primitiveMode
+		&& last.formats[0] == cmd.formats[0] && last.formats[1] == cmd.formats[1]
+		&& last.indexMode == cmd.indexMode
+		&& last.texture == cmd.texture
+		&& last.standardShaderType == cmd.standardShaderType
+		&& entry.blend == blend;
+}
+
+Graphics::BatchedVertexData DrawList::recordBatchedDraw(const Graphics::BatchedDrawCommand &cmd, const BlendState &blend)
+{
+	size_t datasizes[2] = {0, 0};
+	for (int i = 0; i < 2; i++)
+	{
+		if (cmd.formats[i] != CommonFormat::NONE)
+			datasizes[i] = getFormatStride(cmd.formats[i]) * cmd.vertexCount;
+	}
+
+	if (!entries.empty() && canMerge(entries.back(), cmd, blend))
+	{
+		entries.back().command.vertexCount += cmd.vertexCount;
+	}
+	else
+	{
+		Entry entry;
+		entry.command = cmd;
+		entry.texture.set(cmd.texture);
+		entry.blend = blend;
+
+		for (int i = 0; i < 2; i++)
+			entry.dataOffsets[i] = vertexData[i].size();
+
+		entries.push_back(entry);
+	}
+
+	vertexCount += cmd.vertexCount;
+
+	Graphics::BatchedVertexData d;
+
+	for (int i = 0; i < 2; i++)
+	{
+		size_t offset = vertexData[i].size();
+		vertexData[i].resize(offset + datasizes[i]);
+		d.stream[i] = datasizes[i] > 0 ? vertexData[i].data() + offset : nullptr;
+	}
+
+	return d;
+}
+
+void DrawList::recordDrawable(Drawable *drawable, const Matrix4 &m, const Colorf &color, const BlendState &blend)
+{
+	if (drawable == this)
+		throw love::Exception("A DrawList cannot be recorded into itself.");
+
+	Entry entry;
+	entry.drawable.set(drawable);
+	entry.transform = m;
+	entry.color = color;
+	entry.blend = blend;
+	entry.dataOffsets[0] = entry.dataOffsets[1] = 0;
+
+	entries.push_back(entry);
+}
+
+void DrawList::replay(Graphics *gfx, const Entry &entry, const Matrix4 &t, bool identity, bool is2D, const Colorf &tint)
+{
+	Graphics::BatchedDrawCommand cmd = entry.command;
+
+	// 2D positions need a third component once a 3D transform is applied.
+	bool expandXY = !is2D && cmd.formats[0] == CommonFormat::XYf;
+	if (expandXY)
+		cmd.formats[0] = CommonFormat::XYZf;
+
+	Graphics::BatchedVertexData data = gfx->requestBatchedDraw(cmd);
+
+	int count = cmd.vertexCount;
+	const uint8 *src = vertexData[0].data() + entry.dataOffsets[0];
+	size_t srcsize = getFormatStride(entry.command.formats[0]) * count;
+
+	if (identity && !expandXY)
+		memcpy(data.stream[0], src, srcsize);
+	else
+	{
+		switch (entry.command.formats[0])
+		{
+		case CommonFormat::XYf:
+			if (expandXY)
+				t.transformXY0((Vector3 *) data.stream[0], (const Vector2 *) src, count);
+			else
+				t.transformXY((Vector2 *) data.stream[0], (const Vector2 *) src, count);
+			break;
+		case CommonFormat::XYZf:
+			t.transformXYZ((Vector3 *) data.stream[0], (const Vector3 *) src, count);
+			break;
+		case CommonFormat::XYf_STf:
+			transformInterleaved<XYf_STf>(t, data.stream[0], src, count);
+			break;
+		case CommonFormat::XYf_STPf:
+			transformInterleaved<XYf_STPf>(t, data.stream[0], src, count);
+			break;
+		case CommonFormat::XYf_STf_RGBAub:
+			transformInterleaved<XYf_STf_RGBAub>(t, data.stream[0], src, count);
+			break;
+		case CommonFormat::XYf_STus_RGBAub:
+			transformInterleaved<XYf_STus_RGBAub>(t, data.stream[0], src, count);
+			break;
+		case CommonFormat::XYf_STPf_RGBAub:
+			transformInterleaved<XYf_STPf_RGBAub>(t, data.stream[0], src, count);
+			break;
+		default:
+			memcpy(data.stream[0], src, srcsize);
+			break;
+		}
+	}
+
+	if (cmd.formats[1] != CommonFormat::NONE)
+	{
+		size_t size = getFormatStride(cmd.formats[1]) * count;
+		memcpy(data.stream[1], vertexData[1].data() + entry.dataOffsets[1], size);
+	}
+
+	// Vertex colors were baked in when recording, so the current color is
+	// applied to them here, the same way it is for regular batched draws.
+	if (tint.r != 1.0f || tint.g != 1.0f || tint.b != 1.0f || tint.a != 1.0f)
+	{
+		for (int i = 0; i < 2; i++)
+		{
+			if (cmd.formats[i] != CommonFormat::NONE)
+				tintStream(cmd.formats[i], data.stream[i], count, tint);
+		}
+	}
+}
+
+void DrawList::draw(Graphics *gfx, const Matrix4 &m)
+{
+	if (entries.empty())
+		return;
+
+	Graphics::TempTransform transform(gfx, m);
+
+	const Matrix4 &t = gfx->getTransform();
+	bool identity = memcmp(t.getElements(), Matrix4().getElements(), sizeof(float) * 16) == 0;
+	bool is2D = t.isAffine2DTransform();
+
+	Colorf tint = gfx->getColor();
+	tint.r = std::min(std::max(tint.r, 0.0f), 1.0f);
+	tint.g = std::min(std::max(tint.g, 0.0f), 1.0f);
+	tint.b = std::min(std::max(tint.b, 0.0f), 1.0f);
+	tint.a = std::min(std::max(tint.a, 0.0f), 1.0f);
+
+	Colorf oldcolor = gfx->getColor();
+	BlendState oldblend = gfx->getBlendState();
+	BlendState blend = oldblend;
+
+	try
+	{
+		for (const Entry &entry : entries)
+		{
+			if (!(entry.blend == blend))
+			{
+				gfx->setBlendState(entry.blend);
+				blend = entry.blend;
+			}
+
+			if (entry.drawable.get() != nullptr)
+			{
+				const Colorf &c = entry.color;
+				gfx->setColor(Colorf(c.r * tint.r, c.g * tint.g, c.b * tint.b, c.a * tint.a));
+				entry.drawable->draw(gfx, entry.transform);
+			}
+			else
+				replay(gfx, entry, t, identity, is2D, tint);
+		}
+	}
+	catch (love::Exception &)
+	{
+		gfx->setColor(oldcolor);
+		if (!(blend == oldblend))
+			gfx->setBlendState(oldblend);
+		throw;
+	}
+
+	gfx->setColor(oldcolor);
+	if (!(blend == oldblend))
+		gfx->setBlendState(oldblend);
+}
+
+} // graphics
+} // love
@@ -0,0 +1,94 @@
+/**
+* Copyright (c) 2006-2024 LOVE Development Team
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+**/
+
+
+#pragma once
+
+// LOVE
+#include "common/config.h"
+#include "common/Color.h"
+#include "Drawable.h"
+#include "Graphics.h"
+
+// C++
+#include <vector>
+
+namespace love
+{
+namespace graphics
+{
+
+/**
+ * A recorded sequence of draws. While a DrawList is being recorded (see
+ * Graphics::beginDrawList), batched draws such as textures, text and shapes
+ * store their generated vertices in the DrawList instead of submitting them.
+ * Other Drawables are stored by reference along with their transform.
+ * Drawing the DrawList replays everything through the batching system, with
+ * no per-draw argument parsing or vertex generation.
+ **/
+class DrawList : public Drawable
+{
+public:
+
+	static love::Type type;
+
+	DrawList();
+	virtual ~DrawList();
+
+	void clear();
+
+	/**
+	 * Gets the number of draws replayed by the DrawList. Consecutive batched
+	 * draws which share the same state are merged when they're recorded.
+	 **/
+	int getDrawCount() const;
+	int getVertexCount() const;
+
+	Graphics::BatchedVertexData recordBatchedDraw(const Graphics::BatchedDrawCommand &cmd, const BlendState &blend);
+	void recordDrawable(Drawable *drawable, const Matrix4 &m, const Colorf &color, const BlendState &blend);
+
+	// Implements Drawable.
+	void draw(Graphics *gfx, const Matrix4 &m) override;
+
+private:
+
+	struct Entry
+	{
+		Graphics::BatchedDrawCommand command;
+		StrongRef<Texture> texture;
+		StrongRef<Drawable> drawable;
+		Matrix4 transform;
+		Colorf color;
+		BlendState blend;
+		size_t dataOffsets[2];
+	};
+
+	bool canMerge(const Entry &entry, const Graphics::BatchedDrawCommand &cmd, const BlendState &blend) const;
+	void replay(Graphics *gfx, const Entry &entry, const Matrix4 &t, bool identity, bool is2D, const Colorf &tint);
+
+	std::vector<Entry> entries;
+	std::vector<uint8> vertexData[2];
+
+	int vertexCount;
+
+}; // DrawList
+
+} // graphics
+} // love
@@ -24,11 +24,13 @@
 #include "common/math.h"
 #include "common/Matrix.h"
 #include "Graphics.h"
+#include "modules/thread/threads.h"
 
 #include <math.h>
 #include <sstream>
 #include <algorithm> // for max
 #include <limits>
+#include <deque>
 
 namespace love
 {
@@ -50,6 +52,157 @@ static inline love::font::TextShaper::GlyphIndex unpackGlyphIndex(uint64 packedi
 	return {(int) (packedindex & 0xFFFFFFFF), (int) (packedindex >> 32)};
 }
 
+// Rasterizers can be shared between Fonts via fallbacks, and they aren't
+// thread-safe, so all rasterizer access by Fonts is serialized.
+static love::thread::Mutex *getRasterizerMutex()
+{
+	static love::thread::MutexRef mutex;
+	return mutex;
+}
+
+// Rasterizes glyphs requested by Font::preload and async glyph loading. The
+// Font's main thread adds the finished glyphs to its texture atlas.
+class Font::GlyphRasterizerThread : public love::thread::Threadable
+{
+public:
+
+	struct Request
+	{
+		love::font::TextShaper::GlyphIndex glyphIndex;
+		uint32 codepoint;
+		bool useCodepoint;
+	};
+
+	struct Result
+	{
+		love::font::TextShaper::GlyphIndex glyphIndex;
+		StrongRef<love::font::GlyphData> glyphData;
+		float dpiScale;
+	};
+
+	GlyphRasterizerThread(love::font::TextShaper *shaper)
+		: shaper(shaper)
+		, generation(0)
+		, stopping(false)
+	{
+		threadName = "FontRasterizer";
+	}
+
+	void addRequests(const std::vector<Request> &newrequests)
+	{
+		love::thread::Lock lock(mutex);
+		requests.insert(requests.end(), newrequests.begin(), newrequests.end());
+		requestAvailable->signal();
+	}
+
+	void takeResults(std::vector<Result> &out)
+	{
+		love::thread::Lock lock(mutex);
+		out.swap(results);
+		results.clear();
+	}
+
+	// Discards all requests and results, including the one currently being
+	// rasterized.
+	void cancel()
+	{
+		love::thread::Lock lock(mutex);
+		requests.clear();
+		results.clear();
+		generation++;
+	}
+
+	void stop()
+	{
+		love::thread::Lock lock(mutex);
+		stopping = true;
+		requestAvailable->signal();
+	}
+
+	void threadFunction() override
+	{
+		while (true)
+		{
+			Request request;
+			uint64 requestgeneration = 0;
+
+			{
+				love::thread::Lock lock(mutex);
+
+				while (!stopping && requests.empty())
+					requestAvailable->wait(mutex);
+
+				if (stopping)
+					return;
+
+				request = requests.front();
+				requests.pop_front();
+				requestgeneration = generation;
+			}
+
+			Result result;
+			result.glyphIndex = request.glyphIndex;
+			result.dpiScale = 1.0f;
+
+			try
+			{
+				love::thread::Lock lock(getRasterizerMutex());
+				rasterize(request, result);
+			}
+			catch (love::Exception &)
+			{
+				// The main thread skips results without glyph data.
+				result.glyphData.set(nullptr);
+			}
+
+			love::thread::Lock lock(mutex);
+			if (requestgeneration == generation)
+				results.push_back(result);
+		}
+	}
+
+private:
+
+	void rasterize(const Request &request, Result &result)
+	{
+		const auto &rasterizers = shaper->getRasterizers();
+
+		if (request.useCodepoint)
+		{
+			// Matches the glyph lookup in TextShaper::getGlyphAdvance.
+			int rasterizeri = 0;
+			for (size_t i = 0; i < rasterizers.size(); i++)
+			{
+				if (rasterizers[i]->hasGlyph(request.codepoint))
+				{
+					rasterizeri = (int) i;
+					break;
+				}
+			}
+
+			result.glyphIndex = {rasterizers[rasterizeri]->getGlyphIndex(request.codepoint), rasterizeri};
+		}
+
+		if (result.glyphIndex.rasterizerIndex < 0 || result.glyphIndex.rasterizerIndex >= (int) rasterizers.size())
+			return;
+
+		const auto &r = rasterizers[result.glyphIndex.rasterizerIndex];
+		result.dpiScale = r->getDPIScale();
+		result.glyphData.set(r->getGlyphDataForIndex(result.glyphIndex.index), Acquire::NORETAIN);
+	}
+
+	StrongRef<love::font::TextShaper> shaper;
+
+	love::thread::MutexRef mutex;
+	love::thread::ConditionalRef requestAvailable;
+
+	std::deque<Request> requests;
+	std::vector<Result> results;
+
+	uint64 generation;
+	bool stopping;
+};
+
 love::Type Font::type("Font", &Object::type);
 int Font::fontCount = 0;
 
@@ -61,12 +214,25 @@ Font::Font(love::font::Rasterizer *r, const SamplerState &s)
 	, textureHeight(128)
 	, samplerState()
 	, dpiScale(r->getDPIScale())
+	, sdf(r->isSDF())
 	, textureCacheID(0)
+	, rasterizerThread(nullptr)
+	, pendingGlyphCount(0)
+	, asyncGlyphLoading(false)
+	, missingGlyphsDrawn(false)
 {
 	samplerState.minFilter = s.minFilter;
 	samplerState.magFilter = s.magFilter;
 	samplerState.maxAnisotropy = s.maxAnisotropy;
 
+	// Distance fields rely on interpolation between texels to reconstruct
+	// the glyph edges when scaled.
+	if (sdf)
+	{
+		samplerState.minFilter = SamplerState::FILTER_LINEAR;
+		samplerState.magFilter = SamplerState::FILTER_LINEAR;
+	}
+
 	// Try to find the best texture size match for the font size. default to the
 	// largest texture size if no rough match is found.
 	while (true)
@@ -98,6 +264,13 @@ Font::Font(love::font::Rasterizer *r, const SamplerState &s)
 
 Font::~Font()
 {
+	if (rasterizerThread != nullptr)
+	{
+		rasterizerThread->stop();
+		rasterizerThread->wait();
+		rasterizerThread->release();
+	}
+
 	--fontCount;
 }
 
@@ -133,10 +306,52 @@ bool Font::loadVolatile()
 	textureCacheID++;
 	glyphs.clear();
 	textures.clear();
+	atlasTextures.clear();
+	createAtlasTextures();
 	createTexture();
 	return true;
 }
 
+void Font::createAtlasTextures()
+{
+	love::thread::Lock lock(getRasterizerMutex());
+	const auto &r = shaper->getRasterizers()[0];
+
+	int pagecount = r->getAtlasPageCount();
+	if (pagecount <= 0)
+		return;
+
+	auto gfx = Module::getInstance<graphics::Graphics>(Module::M_GRAPHICS);
+	int maxsize = (int) gfx->getCapabilities().limits[Graphics::LIMIT_TEXTURE_SIZE];
+
+	std::vector<StrongRef<Texture>> pagetextures(pagecount);
+
+	for (int i = 0; i < pagecount; i++)
+	{
+		love::image::ImageData *page = r->getAtlasPage(i);
+		if (page == nullptr)
+			continue;
+
+		// Glyphs are copied into the regular textures instead, if the pages
+		// can't be used as-is.
+		if (page->getFormat() != pixelFormat || page->getWidth() > maxsize || page->getHeight() > maxsize)
+			return;
+
+		Texture::Slices slices(TEXTURE_2D);
+		slices.set(0, 0, page);
+
+		Texture::Settings settings;
+		settings.format = pixelFormat;
+		settings.width = page->getWidth();
+		settings.height = page->getHeight();
+
+		pagetextures[i].set(gfx->newTexture(settings, &slices), Acquire::NORETAIN);
+		pagetextures[i]->setSamplerState(samplerState);
+	}
+
+	atlasTextures = pagetextures;
+}
+
 void Font::createTexture()
 {
 	auto gfx = Module::getInstance<graphics::Graphics>(Module::M_GRAPHICS);
@@ -165,31 +380,8 @@ void Font::createTexture()
 	texture->setSamplerState(samplerState);
 
 	{
-		size_t datasize = getPixelFormatSliceSize(pixelFormat, size.width, size.height);
-		size_t pixelcount = size.width * size.height;
-
-		// Initialize the texture with transparent white for truetype fonts
-		// (since we keep luminance constant and vary alpha in those glyphs),
-		// and transparent black otherwise.
-		std::vector<uint8> emptydata(datasize, 0);
-
-		if (shaper->getRasterizers()[0]->getDataType() == font::Rasterizer::DATA_TRUETYPE)
-		{
-			if (pixelFormat == PIXELFORMAT_LA8_UNORM)
-			{
-				for (size_t i = 0; i < pixelcount; i++)
-					emptydata[i * 2 + 0] = 255;
-			}
-			else if (pixelFormat == PIXELFORMAT_RGBA8_UNORM)
-			{
-				for (size_t i = 0; i < pixelcount; i++)
-				{
-					emptydata[i * 4 + 0] = 255;
-					emptydata[i * 4 + 1] = 255;
-					emptydata[i * 4 + 2] = 255;
-				}
-			}
-		}
+		std::vector<uint8> emptydata;
+		getEmptyPixels(size.width, size.height, emptydata);
 
 		Rect rect = {0, 0, size.width, size.height};
 		texture->replacePixels(emptydata.data(), emptydata.size(), 0, 0, rect, false);
@@ -219,24 +411,162 @@ void Font::createTexture()
 	}
 }
 
+void Font::getEmptyPixels(int width, int height, std::vector<uint8> &pixels) const
+{
+	size_t datasize = getPixelFormatSliceSize(pixelFormat, width, height);
+	size_t pixelcount = width * height;
+
+	// Initialize the texture with transparent white for truetype fonts
+	// (since we keep luminance constant and vary alpha in those glyphs),
+	// and transparent black otherwise.
+	pixels.assign(datasize, 0);
+
+	if (shaper->getRasterizers()[0]->getDataType() == font::Rasterizer::DATA_TRUETYPE)
+	{
+		if (pixelFormat == PIXELFORMAT_LA8_UNORM)
+		{
+			for (size_t i = 0; i < pixelcount; i++)
+				pixels[i * 2 + 0] = 255;
+		}
+		else if (pixelFormat == PIXELFORMAT_RGBA8_UNORM)
+		{
+			for (size_t i = 0; i < pixelcount; i++)
+			{
+				pixels[i * 4 + 0] = 255;
+				pixels[i * 4 + 1] = 255;
+				pixels[i * 4 + 2] = 255;
+			}
+		}
+	}
+}
+
 void Font::unloadVolatile()
 {
 	glyphs.clear();
 	textures.clear();
+	atlasTextures.clear();
+	layoutCache.clear();
+	layoutCacheMap.clear();
 }
 
 love::font::GlyphData *Font::getRasterizerGlyphData(love::font::TextShaper::GlyphIndex glyphindex, float &dpiscale)
 {
+	love::thread::Lock lock(getRasterizerMutex());
 	const auto &r = shaper->getRasterizers()[glyphindex.rasterizerIndex];
 	dpiscale = r->getDPIScale();
 	return r->getGlyphDataForIndex(glyphindex.index);
 }
 
+void Font::copyGlyphPixels(love::font::GlyphData *gd, uint8 *dst, size_t dststride) const
+{
+	int w = gd->getWidth();
+	int h = gd->getHeight();
+
+	const uint8 *src = (const uint8 *) gd->getData();
+
+	if (pixelFormat != gd->getFormat())
+	{
+		if (!(pixelFormat == PIXELFORMAT_RGBA8_UNORM && gd->getFormat() == PIXELFORMAT_LA8_UNORM))
+			throw love::Exception("Cannot upload font glyphs to texture atlas: unexpected format conversion.");
+
+		for (int y = 0; y < h; y++)
+		{
+			uint8 *row = dst + y * dststride;
+
+			for (int x = 0; x < w; x++)
+			{
+				int pixel = y * w + x;
+				row[x * 4 + 0] = src[pixel * 2 + 0];
+				row[x * 4 + 1] = src[pixel * 2 + 0];
+				row[x * 4 + 2] = src[pixel * 2 + 0];
+				row[x * 4 + 3] = src[pixel * 2 + 1];
+			}
+		}
+	}
+	else
+	{
+		size_t srcstride = getPixelFormatSliceSize(pixelFormat, w, 1);
+		for (int y = 0; y < h; y++)
+			memcpy(dst + y * dststride, src + y * srcstride, srcstride);
+	}
+}
+
+void Font::uploadGlyphBatch(GlyphUploadBatch &batch)
+{
+	if (batch.rects.empty())
+	{
+		batch.texture = nullptr;
+		return;
+	}
+
+	// Glyphs are placed left to right in rows, so everything to the right of
+	// the batch's starting position in its first row, and every row after
+	// that, is still empty. Each of those two areas is uploaded in one call.
+	Rect areas[2] = {};
+	bool hasarea[2] = {false, false};
+
+	for (const Rect &rect : batch.rects)
+	{
+		int a = rect.y == batch.startY ? 0 : 1;
+
+		if (!hasarea[a])
+		{
+			areas[a] = rect;
+			hasarea[a] = true;
+			continue;
+		}
+
+		int right = std::max(areas[a].x + areas[a].w, rect.x + rect.w);
+		int bottom = std::max(areas[a].y + areas[a].h, rect.y + rect.h);
+		areas[a].x = std::min(areas[a].x, rect.x);
+		areas[a].y = std::min(areas[a].y, rect.y);
+		areas[a].w = right - areas[a].x;
+		areas[a].h = bottom - areas[a].y;
+	}
+
+	std::vector<uint8> pixels;
+
+	for (int a = 0; a < 2; a++)
+	{
+		if (!hasarea[a])
+			continue;
+
+		const Rect &area = areas[a];
+		getEmptyPixels(area.w, area.h, pixels);
+
+		size_t pixelsize = getPixelFormatBlockSize(pixelFormat);
+		size_t stride = getPixelFormatSliceSize(pixelFormat, area.w, 1);
+
+		for (size_t i = 0; i < batch.rects.size(); i++)
+		{
+			const Rect &rect = batch.rects[i];
+			if ((rect.y == batch.startY) != (a == 0))
+				continue;
+
+			uint8 *dst = pixels.data() + (rect.y - area.y) * stride + (rect.x - area.x) * pixelsize;
+			copyGlyphPixels(batch.glyphData[i], dst, stride);
+		}
+
+		batch.texture->replacePixels(pixels.data(), pixels.size(), 0, 0, area, false);
+	}
+
+	batch.texture = nullptr;
+	batch.glyphData.clear();
+	batch.rects.clear();
+}
+
 const Font::Glyph &Font::addGlyph(love::font::TextShaper::GlyphIndex glyphindex)
 {
+	if (glyphindex.rasterizerIndex == 0 && !atlasTextures.empty())
+		return addAtlasGlyph(glyphindex);
+
 	float glyphdpiscale = getDPIScale();
 	StrongRef<love::font::GlyphData> gd(getRasterizerGlyphData(glyphindex, glyphdpiscale), Acquire::NORETAIN);
+	return addGlyph(glyphindex, gd, glyphdpiscale, nullptr);
+}
 
+const Font::Glyph &Font::addGlyph(love::font::TextShaper::GlyphIndex glyphindex, love::font::GlyphData *gd, float glyphdpiscale, GlyphUploadBatch *batch)
+{
 	int w = gd->getWidth();
 	int h = gd->getHeight();
 
@@ -252,12 +582,17 @@ const Font::Glyph &Font::addGlyph(love::font::TextShaper::GlyphIndex glyphindex)
 
 		if (textureY + h + TEXTURE_PADDING > textureHeight)
 		{
+			// The batched glyphs have to be in the texture before it's
+			// replaced by a larger one.
+			if (batch != nullptr)
+				uploadGlyphBatch(*batch);
+
 			// Totally out of space - new texture!
 			createTexture();
 
 			// Makes sure the above code for checking if the glyph can fit at
 			// the current position in the texture is run again for this glyph.
-			return addGlyph(glyphindex);
+			return addGlyph(glyphindex, gd, glyphdpiscale, batch);
 		}
 	}
 
@@ -274,26 +609,26 @@ const Font::Glyph &Font::addGlyph(love::font::TextShaper::GlyphIndex glyphindex)
 
 		Rect rect = {textureX, textureY, gd->getWidth(), gd->getHeight()};
 
-		if (pixelFormat != gd->getFormat())
+		if (batch != nullptr)
 		{
-			if (!(pixelFormat == PIXELFORMAT_RGBA8_UNORM && gd->getFormat() == PIXELFORMAT_LA8_UNORM))
-				throw love::Exception("Cannot upload font glyphs to texture atlas: unexpected format conversion.");
-
-			const uint8 *src = (const uint8 *) gd->getData();
+			if (batch->texture != texture)
+			{
+				uploadGlyphBatch(*batch);
+				batch->texture = texture;
+				batch->startX = textureX;
+				batch->startY = textureY;
+			}
 
+			batch->glyphData.emplace_back(gd);
+			batch->rects.push_back(rect);
+		}
+		else if (pixelFormat != gd->getFormat())
+		{
 			size_t dstsize = getPixelFormatSliceSize(pixelFormat, w, h);
 			std::vector<uint8> dst(dstsize, 0);
-			uint8 *dstdata = dst.data();
 
-			for (int pixel = 0; pixel < w * h; pixel++)
-			{
-				dstdata[pixel * 4 + 0] = src[pixel * 2 + 0];
-				dstdata[pixel * 4 + 1] = src[pixel * 2 + 0];
-				dstdata[pixel * 4 + 2] = src[pixel * 2 + 0];
-				dstdata[pixel * 4 + 3] = src[pixel * 2 + 1];
-			}
-
-			texture->replacePixels(dstdata, dstsize, 0, 0, rect, false);
+			copyGlyphPixels(gd, dst.data(), getPixelFormatSliceSize(pixelFormat, w, 1));
+			texture->replacePixels(dst.data(), dstsize, 0, 0, rect, false);
 		}
 		else
 		{
@@ -340,6 +675,65 @@ const Font::Glyph &Font::addGlyph(love::font::TextShaper::GlyphIndex glyphindex)
 	return glyphs[packedindex];
 }
 
+const Font::Glyph &Font::addAtlasGlyph(love::font::TextShaper::GlyphIndex glyphindex)
+{
+	love::font::AtlasGlyph ag = {};
+	float glyphdpiscale = getDPIScale();
+	bool found = false;
+
+	{
+		love::thread::Lock lock(getRasterizerMutex());
+		const auto &r = shaper->getRasterizers()[glyphindex.rasterizerIndex];
+		glyphdpiscale = r->getDPIScale();
+		found = r->getAtlasGlyph(glyphindex.index, ag);
+	}
+
+	Glyph g;
+
+	g.texture = nullptr;
+	memset(g.vertices, 0, sizeof(GlyphVertex) * 4);
+
+	int w = ag.metrics.width;
+	int h = ag.metrics.height;
+
+	if (found && w > 0 && h > 0 && ag.page >= 0 && ag.page < (int) atlasTextures.size() && atlasTextures[ag.page].get() != nullptr)
+	{
+		Texture *texture = atlasTextures[ag.page];
+		g.texture = texture;
+
+		double tX     = (double) ag.x,                    tY      = (double) ag.y;
+		double tWidth = (double) texture->getPixelWidth(), tHeight = (double) texture->getPixelHeight();
+
+		Color32 c(255, 255, 255, 255);
+
+		// Unlike our own atlas, there's no guaranteed transparent padding
+		// around the glyph, so the quad borders aren't extruded.
+		float fw = (float) w;
+		float fh = (float) h;
+
+		const GlyphVertex verts[4] =
+		{
+			{  0,   0, normToUint16(tX/tWidth),     normToUint16(tY/tHeight),     c},
+			{  0,  fh, normToUint16(tX/tWidth),     normToUint16((tY+h)/tHeight), c},
+			{ fw,   0, normToUint16((tX+w)/tWidth), normToUint16(tY/tHeight),     c},
+			{ fw,  fh, normToUint16((tX+w)/tWidth), normToUint16((tY+h)/tHeight), c}
+		};
+
+		for (int i = 0; i < 4; i++)
+		{
+			g.vertices[i] = verts[i];
+			g.vertices[i].x += ag.metrics.bearingX;
+			g.vertices[i].y -= ag.metrics.bearingY;
+			g.vertices[i].x /= glyphdpiscale;
+			g.vertices[i].y /= glyphdpiscale;
+		}
+	}
+
+	uint64 packedindex = packGlyphIndex(glyphindex);
+	glyphs[packedindex] = g;
+	return glyphs[packedindex];
+}
+
 const Font::Glyph &Font::findGlyph(love::font::TextShaper::GlyphIndex glyphindex)
 {
 	uint64 packedindex = packGlyphIndex(glyphindex);
@@ -348,16 +742,132 @@ const Font::Glyph &Font::findGlyph(love::font::TextShaper::GlyphIndex glyphindex
 	if (it != glyphs.end())
 		return it->second;
 
+	// Glyphs in the atlas don't need to be rasterized.
+	if (glyphindex.rasterizerIndex == 0 && !atlasTextures.empty())
+		return addAtlasGlyph(glyphindex);
+
+	if (asyncGlyphLoading)
+	{
+		// Draw without the glyph until the rasterizer thread has finished it.
+		static const Glyph missingglyph = {};
+
+		if (pendingGlyphs.insert(packedindex).second)
+		{
+			startRasterizerThread();
+			rasterizerThread->addRequests({{glyphindex, 0, false}});
+			pendingGlyphCount++;
+		}
+
+		missingGlyphsDrawn = true;
+		return missingglyph;
+	}
+
 	return addGlyph(glyphindex);
 }
 
+void Font::startRasterizerThread()
+{
+	if (rasterizerThread != nullptr)
+		return;
+
+	rasterizerThread = new GlyphRasterizerThread(shaper);
+
+	if (!rasterizerThread->start())
+	{
+		rasterizerThread->release();
+		rasterizerThread = nullptr;
+		throw love::Exception("Could not start the font rasterizer thread.");
+	}
+}
+
+void Font::uploadPreloadedGlyphs()
+{
+	if (rasterizerThread == nullptr || pendingGlyphCount == 0)
+		return;
+
+	std::vector<GlyphRasterizerThread::Result> results;
+	rasterizerThread->takeResults(results);
+
+	if (results.empty())
+		return;
+
+	pendingGlyphCount -= (int) results.size();
+
+	bool added = false;
+	GlyphUploadBatch batch;
+
+	for (const auto &result : results)
+	{
+		uint64 packedindex = packGlyphIndex(result.glyphIndex);
+		pendingGlyphs.erase(packedindex);
+
+		// The glyph may have been added synchronously in the meantime.
+		if (result.glyphData.get() == nullptr || glyphs.find(packedindex) != glyphs.end())
+			continue;
+
+		addGlyph(result.glyphIndex, result.glyphData, result.dpiScale, &batch);
+		added = true;
+	}
+
+	uploadGlyphBatch(batch);
+
+	// Make sure text drawn without these glyphs (including cached Text
+	// vertices) is regenerated with them.
+	if (added && missingGlyphsDrawn)
+	{
+		textureCacheID++;
+		missingGlyphsDrawn = !pendingGlyphs.empty();
+	}
+}
+
+void Font::preload(const Codepoints &codepoints)
+{
+	std::vector<GlyphRasterizerThread::Request> requests;
+	requests.reserve(codepoints.size());
+
+	// Glyphs in the primary Rasterizer's atlas are added without being
+	// rasterized, so they don't need to be preloaded.
+	const auto &r = shaper->getRasterizers()[0];
+
+	for (uint32 codepoint : codepoints)
+	{
+		if (!atlasTextures.empty() && r->hasGlyph(codepoint))
+			continue;
+		requests.push_back({{0, 0}, codepoint, true});
+	}
+
+	if (requests.empty())
+		return;
+
+	startRasterizerThread();
+	rasterizerThread->addRequests(requests);
+	pendingGlyphCount += (int) requests.size();
+}
+
+bool Font::isPreloading() const
+{
+	return pendingGlyphCount > 0;
+}
+
+void Font::setAsyncGlyphLoading(bool enable)
+{
+	asyncGlyphLoading = enable;
+}
+
+bool Font::isAsyncGlyphLoading() const
+{
+	return asyncGlyphLoading;
+}
+
 float Font::getKerning(uint32 leftglyph, uint32 rightglyph)
 {
+	love::thread::Lock lock(getRasterizerMutex());
 	return shaper->getKerning(leftglyph, rightglyph);
 }
 
 float Font::getKerning(const std::string &leftchar, const std::string &rightchar)
 {
+	love::thread::Lock lock(getRasterizerMutex());
 	return shaper->getKerning(leftchar, rightchar);
 }
 
@@ -368,9 +878,15 @@ float Font::getHeight() const
 
 std::vector<Font::DrawCommand> Font::generateVertices(const love::font::ColoredCodepoints &codepoints, Range range, const Colorf &constantcolor, std::vector<GlyphVertex> &vertices, float extra_spacing, Vector2 offset, love::font::TextShaper::TextInfo *info)
 {
-	std::vector<love::font::TextShaper::GlyphPosition> glyphpositions;
-	std::vector<love::font::IndexedColor> colors;
-	shaper->computeGlyphPositions(codepoints, range, offset, extra_spacing, &glyphpositions, &colors, info);
+	uploadPreloadedGlyphs();
+
+	FrameVector<love::font::TextShaper::GlyphPosition> glyphpositions;
+	FrameVector<love::font::IndexedColor> colors;
+
+	{
+		love::thread::Lock lock(getRasterizerMutex());
+		shaper->computeGlyphPositions(codepoints, range, offset, extra_spacing, &glyphpositions, &colors, info);
+	}
 
 	size_t vertstartsize = vertices.size();
 	vertices.reserve(vertstartsize + glyphpositions.size() * 4);
@@ -464,6 +980,8 @@ std::vector<Font::DrawCommand> Font::generateVerticesFormatted(const love::font:
 {
 	wrap = std::max(wrap, 0.0f);
 
+	uploadPreloadedGlyphs();
+
 	uint32 cacheid = textureCacheID;
 
 	std::vector<DrawCommand> drawcommands;
@@ -471,7 +989,7 @@ std::vector<Font::DrawCommand> Font::generateVerticesFormatted(const love::font:
 
 	std::vector<Range> ranges;
 	std::vector<float> widths;
-	shaper->getWrap(text, wrap, ranges, &widths);
+	getWrap(text, wrap, ranges, &widths);
 
 	float y = 0.0f;
 	float maxwidth = 0.0f;
@@ -571,6 +1089,7 @@ void Font::printv(graphics::Graphics *gfx, const Matrix4 &t, const std::vector<D
 		streamcmd.indexMode = TRIANGLEINDEX_QUADS;
 		streamcmd.vertexCount = cmd.vertexcount;
 		streamcmd.texture = cmd.texture;
+		streamcmd.standardShaderType = sdf ? Shader::STANDARD_SDF_TEXT : Shader::STANDARD_DEFAULT;
 
 		Graphics::BatchedVertexData data = gfx->requestBatchedDraw(streamcmd);
 		GlyphVertex *vertexdata = (GlyphVertex *) data.stream[0];
@@ -580,15 +1099,69 @@ void Font::printv(graphics::Graphics *gfx, const Matrix4 &t, const std::vector<D
 	}
 }
 
+const Font::TextLayout &Font::getTextLayout(const love::font::ColoredCodepoints &codepoints, const Colorf &constantcolor, bool formatted, float wrap, AlignMode align)
+{
+	// This can invalidate the texture cache, so it has to happen before any
+	// cached layouts are checked.
+	uploadPreloadedGlyphs();
+
+	// The key contains everything that affects the generated vertices.
+	std::string key;
+	key.reserve(sizeof(float) * 6 + sizeof(uint32) * codepoints.cps.size() + sizeof(love::font::IndexedColor) * codepoints.colors.size());
+
+	float settings[6] = {formatted ? wrap : -1.0f, (float) align, constantcolor.r, constantcolor.g, constantcolor.b, constantcolor.a};
+	key.append((const char *) settings, sizeof(settings));
+	key.append((const char *) codepoints.cps.data(), sizeof(uint32) * codepoints.cps.size());
+
+	for (const auto &c : codepoints.colors)
+	{
+		key.append((const char *) &c.index, sizeof(c.index));
+		key.append((const char *) &c.color, sizeof(c.color));
+	}
+
+	auto it = layoutCacheMap.find(key);
+	if (it != layoutCacheMap.end())
+	{
+		if (it->second->textureCacheID == textureCacheID)
+		{
+			layoutCache.splice(layoutCache.begin(), layoutCache, it->second);
+			return layoutCache.front();
+		}
+
+		layoutCache.erase(it->second);
+		layoutCacheMap.erase(it);
+	}
+
+	TextLayout layout;
+	layout.key = std::move(key);
+
+	if (formatted)
+		layout.drawCommands = generateVerticesFormatted(codepoints, constantcolor, wrap, align, layout.vertices);
+	else
+		layout.drawCommands = generateVertices(codepoints, Range(), constantcolor, layout.vertices);
+
+	// Generating vertices can itself invalidate the texture cache.
+	layout.textureCacheID = textureCacheID;
+
+	layoutCache.push_front(std::move(layout));
+	layoutCacheMap[layoutCache.front().key] = layoutCache.begin();
+
+	if (layoutCache.size() > MAX_TEXT_LAYOUTS)
+	{
+		layoutCacheMap.erase(layoutCache.back().key);
+		layoutCache.pop_back();
+	}
+
+	return layoutCache.front();
+}
+
 void Font::print(graphics::Graphics *gfx, const std::vector<love::font::ColoredString> &text, const Matrix4 &m, const Colorf &constantcolor)
 {
 	love::font::ColoredCodepoints codepoints;
 	love::font::getCodepointsFromString(text, codepoints);
 
-	std::vector<GlyphVertex> vertices;
-	std::vector<DrawCommand> drawcommands = generateVertices(codepoints, Range(), constantcolor, vertices);
-
-	printv(gfx, m, drawcommands, vertices);
+	const TextLayout &layout = getTextLayout(codepoints, constantcolor, false, 0.0f, ALIGN_LEFT);
+	printv(gfx, m, layout.drawCommands, layout.vertices);
 }
 
 void Font::printf(graphics::Graphics *gfx, const std::vector<love::font::ColoredString> &text, float wrap, AlignMode align, const Matrix4 &m, const Colorf &constantcolor)
@@ -596,35 +1169,41 @@ void Font::printf(graphics::Graphics *gfx, const std::vector<love::font::Colored
 	love::font::ColoredCodepoints codepoints;
 	love::font::getCodepointsFromString(text, codepoints);
 
-	std::vector<GlyphVertex> vertices;
-	std::vector<DrawCommand> drawcommands = generateVerticesFormatted(codepoints, constantcolor, wrap, align, vertices);
-
-	printv(gfx, m, drawcommands, vertices);
+	const TextLayout &layout = getTextLayout(codepoints, constantcolor, true, wrap, align);
+	printv(gfx, m, layout.drawCommands, layout.vertices);
 }
 
 int Font::getWidth(const std::string &str)
 {
+	love::thread::Lock lock(getRasterizerMutex());
 	return shaper->getWidth(str);
 }
 
 int Font::getWidth(uint32 glyph)
 {
+	love::thread::Lock lock(getRasterizerMutex());
 	return shaper->getGlyphAdvance(glyph);
 }
 
 void Font::getWrap(const love::font::ColoredCodepoints &codepoints, float wraplimit, std::vector<Range> &ranges, std::vector<float> *linewidths)
 {
+	love::thread::Lock lock(getRasterizerMutex());
 	shaper->getWrap(codepoints, wraplimit, ranges, linewidths);
 }
 
 void Font::getWrap(const std::vector<love::font::ColoredString> &text, float wraplimit, std::vector<std::string> &lines, std::vector<float> *linewidths)
 {
+	love::thread::Lock lock(getRasterizerMutex());
 	shaper->getWrap(text, wraplimit, lines, linewidths);
 }
 
 void Font::setLineHeight(float height)
 {
 	shaper->setLineHeight(height);
+
+	// Cached layouts were made with the old line height.
+	layoutCache.clear();
+	layoutCacheMap.clear();
 }
 
 float Font::getLineHeight() const
@@ -664,11 +1243,13 @@ float Font::getBaseline() const
 
 bool Font::hasGlyph(uint32 glyph) const
 {
+	love::thread::Lock lock(getRasterizerMutex());
 	return shaper->hasGlyph(glyph);
 }
 
 bool Font::hasGlyphs(const std::string &text) const
 {
+	love::thread::Lock lock(getRasterizerMutex());
 	return shaper->hasGlyphs(text);
 }
 
@@ -678,7 +1259,18 @@ void Font::setFallbacks(const std::vector<Font *> &fallbacks)
 	for (const Font* f : fallbacks)
 		rasterizerfallbacks.push_back(f->shaper->getRasterizers()[0]);
 
-	shaper->setFallbacks(rasterizerfallbacks);
+	// Glyph indices from before the fallbacks changed may refer to different
+	// rasterizers afterward.
+	if (rasterizerThread != nullptr)
+		rasterizerThread->cancel();
+
+	pendingGlyphCount = 0;
+	pendingGlyphs.clear();
+
+	{
+		love::thread::Lock lock(getRasterizerMutex());
+		shaper->setFallbacks(rasterizerfallbacks);
+	}
 
 	// Invalidate existing textures.
 	textureCacheID++;
@@ -694,6 +1286,11 @@ float Font::getDPIScale() const
 	return dpiScale;
 }
 
+bool Font::isSDF() const
+{
+	return sdf;
+}
+
 uint32 Font::getTextureCacheID() const
 {
 	return textureCacheID;
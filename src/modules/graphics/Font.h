@@ -21,7 +21,9 @@
 #pragma once
 
 // STD
+#include <list>
 #include <unordered_map>
+#include <unordered_set>
 #include <string>
 #include <vector>
 #include <stddef.h>
@@ -146,8 +148,37 @@ public:
 
 	void setFallbacks(const std::vector<Font *> &fallbacks);
 
+	/**
+	 * Rasterizes the glyphs for the given codepoints on a background thread.
+	 * Finished glyphs are added to the texture atlas the next time text is
+	 * laid out with this Font, so they don't have to be rasterized when
+	 * they're first drawn.
+	 **/
+	void preload(const Codepoints &codepoints);
+
+	/**
+	 * Gets whether any glyphs requested by preload (or by async glyph loading)
+	 * haven't been added to the texture atlas yet.
+	 **/
+	bool isPreloading() const;
+
+	/**
+	 * Sets whether text with glyphs that aren't in the texture atlas yet is
+	 * drawn without them while they're rasterized on a background thread,
+	 * instead of stalling until they've been rasterized. The missing glyphs
+	 * show up the next time the text is drawn after they're ready.
+	 **/
+	void setAsyncGlyphLoading(bool enable);
+	bool isAsyncGlyphLoading() const;
+
 	float getDPIScale() const;
 
+	/**
+	 * Gets whether the glyphs are signed distance fields, which are drawn
+	 * with a built-in shader that keeps their edges sharp at any scale.
+	 **/
+	bool isSDF() const;
+
 	uint32 getTextureCacheID() const;
 
 	// Implements Volatile.
@@ -174,12 +205,44 @@ private:
 		int height;
 	};
 
+	// Glyphs whose pixels are copied into a single staging area, so they can
+	// be uploaded to the atlas with as few replacePixels calls as possible.
+	struct GlyphUploadBatch
+	{
+		Texture *texture = nullptr;
+		int startX = 0;
+		int startY = 0;
+		std::vector<StrongRef<love::font::GlyphData>> glyphData;
+		std::vector<Rect> rects;
+	};
+
+	// Vertices generated by print or printf, reused while the same text is
+	// drawn with the same settings.
+	struct TextLayout
+	{
+		std::string key;
+		uint32 textureCacheID;
+		std::vector<DrawCommand> drawCommands;
+		std::vector<GlyphVertex> vertices;
+	};
+
+	class GlyphRasterizerThread;
+
 	void createTexture();
+	void createAtlasTextures();
+	void getEmptyPixels(int width, int height, std::vector<uint8> &pixels) const;
+	void copyGlyphPixels(love::font::GlyphData *gd, uint8 *dst, size_t dststride) const;
+	void uploadGlyphBatch(GlyphUploadBatch &batch);
+	void uploadPreloadedGlyphs();
+	void startRasterizerThread();
 
 	TextureSize getNextTextureSize() const;
 	love::font::GlyphData *getRasterizerGlyphData(love::font::TextShaper::GlyphIndex glyphindex, float &dpiscale);
 	const Glyph &addGlyph(love::font::TextShaper::GlyphIndex glyphindex);
+	const Glyph &addGlyph(love::font::TextShaper::GlyphIndex glyphindex, love::font::GlyphData *gd, float glyphdpiscale, GlyphUploadBatch *batch);
+	const Glyph &addAtlasGlyph(love::font::TextShaper::GlyphIndex glyphindex);
 	const Glyph &findGlyph(love::font::TextShaper::GlyphIndex glyphindex);
+	const TextLayout &getTextLayout(const love::font::ColoredCodepoints &codepoints, const Colorf &constantcolor, bool formatted, float wrap, AlignMode align);
 	void printv(Graphics *gfx, const Matrix4 &t, const std::vector<DrawCommand> &drawcommands, const std::vector<GlyphVertex> &vertices);
 
 	StrongRef<love::font::TextShaper> shaper;
@@ -189,6 +252,11 @@ private:
 
 	std::vector<StrongRef<Texture>> textures;
 
+	// Textures of the image pages the primary Rasterizer's glyphs are already
+	// laid out in, if it has any. Its glyphs are drawn straight from these
+	// instead of being copied into the textures above.
+	std::vector<StrongRef<Texture>> atlasTextures;
+
 	// maps packed glyph index values to glyph texture information
 	std::unordered_map<uint64, Glyph> glyphs;
 
@@ -198,12 +266,32 @@ private:
 
 	float dpiScale;
 
+	bool sdf;
+
 	int textureX, textureY;
 	int rowHeight;
 
 	// ID which is incremented when the texture cache is invalidated.
 	uint32 textureCacheID;
 
+	GlyphRasterizerThread *rasterizerThread;
+
+	// Number of requests given to the rasterizer thread which haven't been
+	// added to the atlas yet, and the glyphs requested by async loading.
+	int pendingGlyphCount;
+	std::unordered_set<uint64> pendingGlyphs;
+
+	bool asyncGlyphLoading;
+
+	// Whether text has been laid out without some async-loaded glyphs.
+	bool missingGlyphsDrawn;
+
+	// Recently drawn text layouts, most recently used first.
+	std::list<TextLayout> layoutCache;
+	std::unordered_map<std::string, std::list<TextLayout>::iterator> layoutCacheMap;
+
+	static const size_t MAX_TEXT_LAYOUTS = 64;
+
 	// 1 pixel of transparent padding between glyphs (so quads won't pick up
 	// other glyphs), plus one pixel of transparent padding that the quads will
 	// use, for edge antialiasing.
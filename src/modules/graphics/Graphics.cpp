@@ -31,8 +31,13 @@
 #include "Font.h"
 #include "Video.h"
 #include "TextBatch.h"
+#include "ShapeBatch.h"
+#include "DrawList.h"
+#include "RectPacker.h"
 #include "common/deprecation.h"
+#include "common/profiler.h"
 #include "common/config.h"
+#include "common/memory.h"
 
 // C++
 #include <algorithm>
@@ -143,6 +148,18 @@ void setRenderers(const std::vector<Renderer> &renderers)
 	_renderers = renderers;
 }
 
+static int _framesInFlight = 2;
+
+int getFramesInFlight()
+{
+	return _framesInFlight;
+}
+
+void setFramesInFlight(int frames)
+{
+	_framesInFlight = frames;
+}
+
 Graphics *Graphics::createInstance()
 {
 	Graphics *instance = Module::getInstance<Graphics>(M_GRAPHICS);
@@ -192,15 +209,26 @@ Graphics::Graphics(const char *name)
 	, active(true)
 	, batchedDrawState()
 	, deviceProjectionMatrix()
+	, stencilClipDepth(0)
+	, textureArrayBatching(false)
+	, asyncCompute(false)
+	, gpuFrameTime(-1.0)
+	, presentTime(0.0)
+	, defaultShaderCompileTime(0.0)
+	, textureStreamingBudget(0)
+	, shaderCacheEnabled(false)
 	, renderTargetSwitchCount(0)
 	, drawCalls(0)
 	, drawCallsBatched(0)
 	, quadIndexBuffer(nullptr)
 	, fanIndexBuffer(nullptr)
+	, lineQuadBuffer(nullptr)
 	, capabilities()
 	, defaultTextures()
 	, defaultTexelBuffers()
 	, defaultStorageBuffer(nullptr)
+	, shapeCapture(nullptr)
+	, recordingDrawList(nullptr)
 	, cachedShaderStages()
 {
 	transformStack.reserve(16);
@@ -218,10 +246,16 @@ Graphics::Graphics(const char *name)
 
 Graphics::~Graphics()
 {
+	ParticleSystem::stopUpdateThreads();
+
 	if (quadIndexBuffer != nullptr)
 		quadIndexBuffer->release();
 	if (fanIndexBuffer != nullptr)
 		fanIndexBuffer->release();
+	if (lineQuadBuffer != nullptr)
+		lineQuadBuffer->release();
+	if (recordingDrawList != nullptr)
+		recordingDrawList->release();
 
 	releaseDefaultResources();
 
@@ -253,6 +287,15 @@ Graphics::~Graphics()
 		cachedShaderStages[i].clear();
 
 	pendingReadbacks.clear();
+	pendingBackbufferCaptures.clear();
+
+	// The staging buffers are owned by the temporary resource pool, which is
+	// cleared below.
+	for (const auto &upload : pendingUploads)
+		upload->stagingBuffer = nullptr;
+	pendingUploads.clear();
+
+	streamingTextures.clear();
 	clearTemporaryResources();
 
 	Shader::deinitialize();
@@ -297,6 +340,144 @@ Quad *Graphics::newQuad(Quad::Viewport v, double sw, double sh)
 	return new Quad(v, sw, sh);
 }
 
+static bool packAtlas(const std::vector<Rect> &sizes, const std::vector<size_t> &order, int width, int height, int padding, std::vector<Rect> &rects)
+{
+	// Padding goes around every rectangle, including at the atlas edges.
+	RectPacker packer(width - padding, height - padding);
+
+	for (size_t i : order)
+	{
+		int x = 0;
+		int y = 0;
+		if (!packer.pack(sizes[i].w + padding, sizes[i].h + padding, x, y))
+			return false;
+
+		rects[i] = {x + padding, y + padding, sizes[i].w, sizes[i].h};
+	}
+
+	return true;
+}
+
+Texture *Graphics::newAtlas(const std::vector<AtlasSource> &sources, const AtlasSettings &settings, std::vector<Rect> &rects)
+{
+	if (sources.empty())
+		throw love::Exception("An atlas needs at least one image.");
+
+	int padding = std::max(settings.padding, 0);
+	int maxsize = getCapabilities().limits[LIMIT_TEXTURE_SIZE];
+	if (settings.maxSize > 0)
+		maxsize = std::min(maxsize, settings.maxSize);
+
+	std::vector<Rect> sizes(sources.size());
+	int64 area = 0;
+	int largest = 1;
+
+	for (size_t i = 0; i < sources.size(); i++)
+	{
+		const AtlasSource &source = sources[i];
+
+		if (source.imageData != nullptr)
+		{
+			sizes[i].w = source.imageData->getWidth();
+			sizes[i].h = source.imageData->getHeight();
+		}
+		else if (source.texture != nullptr)
+		{
+			if (source.texture->getTextureType() != TEXTURE_2D)
+				throw love::Exception("Only 2D textures can be added to an atlas.");
+			sizes[i].w = source.texture->getPixelWidth();
+			sizes[i].h = source.texture->getPixelHeight();
+		}
+		else
+			throw love::Exception("Invalid atlas image.");
+
+		area += (int64) (sizes[i].w + padding) * (sizes[i].h + padding);
+		largest = std::max(largest, std::max(sizes[i].w, sizes[i].h) + padding * 2);
+	}
+
+	// Taller images first packs much more tightly.
+	std::vector<size_t> order(sources.size());
+	for (size_t i = 0; i < order.size(); i++)
+		order[i] = i;
+
+	std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+		if (sizes[a].h != sizes[b].h)
+			return sizes[a].h > sizes[b].h;
+		return sizes[a].w > sizes[b].w;
+	});
+
+	// Start from the smallest power of two square that could hold everything,
+	// and alternately double the width and height until it fits.
+	int width = std::min(nextP2(std::max(largest, (int) std::ceil(std::sqrt((double) area)))), maxsize);
+	int height = width;
+	rects.resize(sources.size());
+
+	while (!packAtlas(sizes, order, width, height, padding, rects))
+	{
+		if (width >= maxsize && height >= maxsize)
+			throw love::Exception("The images don't fit in a %dx%d atlas.", maxsize, maxsize);
+
+		if (width <= height && width < maxsize)
+			width = std::min(width * 2, maxsize);
+		else
+			height = std::min(height * 2, maxsize);
+	}
+
+	Texture::Settings s;
+	s.width = width;
+	s.height = height;
+	s.format = PIXELFORMAT_NORMAL;
+	s.linear = settings.linear;
+	s.renderTarget = true;
+	s.mipmaps = settings.mipmaps ? Texture::MIPMAPS_MANUAL : Texture::MIPMAPS_NONE;
+	s.debugName = settings.debugName;
+
+	StrongRef<Texture> atlas(newTexture(s), Acquire::NORETAIN);
+
+	// Clear, then draw the Textures into place.
+	flushBatchedDraws();
+	push(STACK_ALL);
+
+	try
+	{
+		reset();
+		setRenderTarget(RenderTarget(atlas.get()), 0);
+		clear(OptionalColorD(ColorD(0, 0, 0, 0)), OptionalInt(), OptionalDouble());
+		setBlendMode(BLEND_REPLACE, BLENDALPHA_PREMULTIPLIED);
+
+		for (size_t i = 0; i < sources.size(); i++)
+		{
+			Texture *texture = sources[i].texture;
+			if (texture == nullptr)
+				continue;
+
+			float sx = (float) texture->getPixelWidth() / (float) texture->getWidth();
+			float sy = (float) texture->getPixelHeight() / (float) texture->getHeight();
+			Matrix4 m(rects[i].x, rects[i].y, 0, sx, sy, 0, 0, 0, 0);
+			draw(texture, m);
+		}
+	}
+	catch (love::Exception &)
+	{
+		pop();
+		throw;
+	}
+
+	pop();
+
+	for (size_t i = 0; i < sources.size(); i++)
+	{
+		if (sources[i].imageData != nullptr)
+			atlas->replacePixels(sources[i].imageData, 0, 0, rects[i].x, rects[i].y, false);
+	}
+
+	if (settings.mipmaps)
+		atlas->generateMipmaps();
+
+	atlas->retain();
+	return atlas.get();
+}
+
 Font *Graphics::newFont(love::font::Rasterizer *data)
 {
 	return new Font(data, states.back().defaultSamplerState);
@@ -317,9 +498,9 @@ Video *Graphics::newVideo(love::video::VideoStream *stream, float dpiscale)
 	return new Video(this, stream, dpiscale);
 }
 
-love::graphics::SpriteBatch *Graphics::newSpriteBatch(Texture *texture, int size, BufferDataUsage usage)
+love::graphics::SpriteBatch *Graphics::newSpriteBatch(Texture *texture, int size, BufferDataUsage usage, bool instanced)
 {
-	return new SpriteBatch(this, texture, size, usage);
+	return new SpriteBatch(this, texture, size, usage, instanced);
 }
 
 love::graphics::ParticleSystem *Graphics::newParticleSystem(Texture *texture, int size)
@@ -327,6 +508,11 @@ love::graphics::ParticleSystem *Graphics::newParticleSystem(Texture *texture, in
 	return new ParticleSystem(texture, size);
 }
 
+void Graphics::updateParticleSystems(const std::vector<ParticleSystem *> &systems, float dt)
+{
+	ParticleSystem::updateAll(systems, dt);
+}
+
 ShaderStage *Graphics::newShaderStage(ShaderStageType stage, const std::string &source, const Shader::CompileOptions &options, const Shader::SourceInfo &info, bool cache)
 {
 	ShaderStage *s = nullptr;
@@ -426,6 +612,49 @@ Shader *Graphics::newComputeShader(const std::string &source, const Shader::Comp
 	return newShaderInternal(stages, options);
 }
 
+ShaderVariants *Graphics::newShaderVariants(const std::vector<std::string> &stagessource, const Shader::CompileOptions &options, const std::vector<std::string> &features, const std::vector<uint32> &masks)
+{
+	if (masks.empty())
+		throw love::Exception("At least one shader variant must be specified.");
+
+	StrongRef<ShaderVariants> variants(new ShaderVariants(features), Acquire::NORETAIN);
+
+	for (uint32 mask : masks)
+	{
+		if (!variants->isValidMask(mask))
+			throw love::Exception("Shader variant mask %u uses features which weren't declared.", mask);
+	}
+
+	// Start compiling every variant before waiting on any of them, so drivers
+	// with parallel shader compilation can work on all of them at once.
+	for (uint32 mask : masks)
+	{
+		if (variants->hasVariant(mask))
+			continue;
+
+		Shader::CompileOptions variantoptions = options;
+		variantoptions.async = true;
+
+		for (size_t i = 0; i < features.size(); i++)
+		{
+			if (mask & (1u << i))
+				variantoptions.defines[features[i]] = "1";
+		}
+
+		if (!options.debugName.empty())
+			variantoptions.debugName = options.debugName + " (variant " + std::to_string(mask) + ")";
+
+		StrongRef<Shader> shader(newShader(stagessource, variantoptions), Acquire::NORETAIN);
+		variants->addVariant(mask, shader);
+	}
+
+	if (!options.async)
+		variants->waitUntilReady();
+
+	variants->retain();
+	return variants.get();
+}
+
 Buffer *Graphics::newBuffer(const Buffer::Settings &settings, DataFormat format, const void *data, size_t size, size_t arraylength)
 {
 	std::vector<Buffer::DataDeclaration> dataformat = {{"", format, 0}};
@@ -452,6 +681,16 @@ love::graphics::TextBatch *Graphics::newTextBatch(graphics::Font *font, const st
 	return new TextBatch(font, text);
 }
 
+ShapeBatch *Graphics::newShapeBatch()
+{
+	return new ShapeBatch();
+}
+
+DrawList *Graphics::newDrawList()
+{
+	return new DrawList();
+}
+
 love::data::ByteData *Graphics::readbackBuffer(Buffer *buffer, size_t offset, size_t size, data::ByteData *dest, size_t destoffset)
 {
 	StrongRef<GraphicsReadback> readback;
@@ -492,6 +731,14 @@ GraphicsReadback *Graphics::readbackTextureAsync(Texture *texture, int slice, in
 	return readback;
 }
 
+ReadbackRing *Graphics::newReadbackRing(int size)
+{
+	if (size <= 0)
+		throw love::Exception("Readback ring size must be greater than 0.");
+
+	return new ReadbackRing(size);
+}
+
 void Graphics::cleanupCachedShaderStage(ShaderStageType type, const std::string &hashkey)
 {
 	cachedShaderStages[type].erase(hashkey);
@@ -810,6 +1057,8 @@ void Graphics::restoreState(const DisplayState &s)
 	setLineStyle(s.lineStyle);
 	setLineJoin(s.lineJoin);
 
+	setBatchSortMode(s.batchSortMode);
+
 	setPointSize(s.pointSize);
 
 	if (s.scissor)
@@ -855,6 +1104,8 @@ void Graphics::restoreStateChecked(const DisplayState &s)
 	setLineStyle(s.lineStyle);
 	setLineJoin(s.lineJoin);
 
+	setBatchSortMode(s.batchSortMode);
+
 	if (s.pointSize != cur.pointSize)
 		setPointSize(s.pointSize);
 
@@ -1002,9 +1253,9 @@ void Graphics::setRenderTargets(const RenderTargetsStrongRef &rts)
 	targets.colors.reserve(rts.colors.size());
 
 	for (const auto &rt : rts.colors)
-		targets.colors.emplace_back(rt.texture.get(), rt.slice, rt.mipmap);
+		targets.colors.emplace_back(rt.texture.get(), rt.slice, rt.mipmap, rt.storeAction);
 
-	targets.depthStencil = RenderTarget(rts.depthStencil.texture, rts.depthStencil.slice, rts.depthStencil.mipmap);
+	targets.depthStencil = RenderTarget(rts.depthStencil.texture, rts.depthStencil.slice, rts.depthStencil.mipmap, rts.depthStencil.storeAction);
 	targets.temporaryRTFlags = rts.temporaryRTFlags;
 
 	return setRenderTargets(targets);
@@ -1029,14 +1280,14 @@ void Graphics::setRenderTargets(const RenderTargets &rts)
 
 		for (int i = 0; i < rtcount; i++)
 		{
-			if (rts.colors[i] != prevRTsRef.colors[i])
+			if (rts.colors[i] != prevRTsRef.colors[i] || !isSameRenderPass(rts.colors[i], prevRTsRef.colors[i]))
 			{
 				modified = true;
 				break;
 			}
 		}
 
-		if (!modified && rts.depthStencil != prevRTsRef.depthStencil)
+		if (!modified && (rts.depthStencil != prevRTsRef.depthStencil || !isSameRenderPass(rts.depthStencil, prevRTsRef.depthStencil)))
 			modified = true;
 
 		if (rts.temporaryRTFlags != prevRTsRef.temporaryRTFlags)
@@ -1147,9 +1398,9 @@ void Graphics::setRenderTargets(const RenderTargets &rts)
 	refs.colors.reserve(rts.colors.size());
 
 	for (auto c : rts.colors)
-		refs.colors.emplace_back(c.texture, c.slice, c.mipmap);
+		refs.colors.emplace_back(c.texture, c.slice, c.mipmap, c.storeAction);
 
-	refs.depthStencil = RenderTargetStrongRef(rts.depthStencil.texture, rts.depthStencil.slice);
+	refs.depthStencil = RenderTargetStrongRef(rts.depthStencil.texture, rts.depthStencil.slice, rts.depthStencil.mipmap, rts.depthStencil.storeAction);
 	refs.temporaryRTFlags = rts.temporaryRTFlags;
 
 	std::swap(state.renderTargets, refs);
@@ -1175,6 +1426,63 @@ void Graphics::setRenderTargets(const RenderTargets &rts)
 		OptionalDouble cleardepth(1.0);
 		clear(clearcolor, clearstencil, cleardepth);
 	}
+
+	applyLoadActions(rts);
+}
+
+bool Graphics::isSameRenderPass(const RenderTarget &rt, const RenderTargetStrongRef &prev)
+{
+	// An explicit load action always starts a new pass.
+	return rt.loadAction == LOAD_ACTION_LOAD && rt.storeAction == prev.storeAction;
+}
+
+void Graphics::applyLoadActions(const RenderTargets &rts)
+{
+	// Backends defer the start of a pass until something is drawn, so a clear
+	// or discard here becomes the load action of the pass rather than an
+	// extra operation on the render target.
+	std::vector<OptionalColorD> clearcolors(rts.colors.size());
+	std::vector<bool> discardcolors(rts.colors.size(), false);
+	bool clearcolor = false;
+	bool discardcolor = false;
+
+	for (size_t i = 0; i < rts.colors.size(); i++)
+	{
+		if (rts.colors[i].loadAction == LOAD_ACTION_CLEAR)
+		{
+			clearcolors[i] = OptionalColorD(ColorD(0.0, 0.0, 0.0, 0.0));
+			clearcolor = true;
+		}
+		else if (rts.colors[i].loadAction == LOAD_ACTION_DONTCARE)
+		{
+			discardcolors[i] = true;
+			discardcolor = true;
+		}
+	}
+
+	const RenderTarget &ds = rts.depthStencil;
+	bool cleards = ds.texture != nullptr && ds.loadAction == LOAD_ACTION_CLEAR;
+	bool discardds = ds.texture != nullptr && ds.loadAction == LOAD_ACTION_DONTCARE;
+
+	if (clearcolor || cleards)
+	{
+		OptionalInt clearstencil;
+		OptionalDouble cleardepth;
+
+		if (cleards)
+		{
+			PixelFormat format = ds.texture->getPixelFormat();
+			if (isPixelFormatStencil(format))
+				clearstencil = OptionalInt(0);
+			if (isPixelFormatDepth(format))
+				cleardepth = OptionalDouble(1.0);
+		}
+
+		clear(clearcolors, clearstencil, cleardepth);
+	}
+
+	if (discardcolor || discardds)
+		discard(discardcolors, discardds);
 }
 
 void Graphics::setRenderTarget()
@@ -1210,9 +1518,9 @@ Graphics::RenderTargets Graphics::getRenderTargets() const
 	rts.colors.reserve(curRTs.colors.size());
 
 	for (const auto &rt : curRTs.colors)
-		rts.colors.emplace_back(rt.texture.get(), rt.slice, rt.mipmap);
+		rts.colors.emplace_back(rt.texture.get(), rt.slice, rt.mipmap, rt.storeAction);
 
-	rts.depthStencil = RenderTarget(curRTs.depthStencil.texture, curRTs.depthStencil.slice, curRTs.depthStencil.mipmap);
+	rts.depthStencil = RenderTarget(curRTs.depthStencil.texture, curRTs.depthStencil.slice, curRTs.depthStencil.mipmap, curRTs.depthStencil.storeAction);
 	rts.temporaryRTFlags = curRTs.temporaryRTFlags;
 
 	return rts;
@@ -1268,10 +1576,15 @@ bool Graphics::isRenderTargetActive(Texture *texture, int slice) const
 	return false;
 }
 
-Texture *Graphics::getTemporaryTexture(PixelFormat format, int w, int h, int samples)
+Texture *Graphics::getTemporaryTexture(PixelFormat format, int w, int h, int samples, bool memoryless, bool framescoped)
 {
 	Texture *texture = nullptr;
 
+	// Match the format the texture will actually be created with.
+	format = getSizedFormat(format);
+	if (!isGammaCorrect())
+		format = getLinearPixelFormat(format);
+
 	for (TemporaryTexture &temp : temporaryTextures)
 	{
 		if (temp.framesSinceUse < 0)
@@ -1279,10 +1592,12 @@ Texture *Graphics::getTemporaryTexture(PixelFormat format, int w, int h, int sam
 
 		Texture *c = temp.texture;
 		if (c->getPixelFormat() == format && c->getPixelWidth() == w
-			&& c->getPixelHeight() == h && c->getRequestedMSAA() == samples)
+			&& c->getPixelHeight() == h && c->getRequestedMSAA() == samples
+			&& c->isMemoryless() == memoryless)
 		{
 			texture = c;
 			temp.framesSinceUse = -1;
+			temp.frameScoped = framescoped;
 			break;
 		}
 	}
@@ -1295,10 +1610,11 @@ Texture *Graphics::getTemporaryTexture(PixelFormat format, int w, int h, int sam
 		settings.width = w;
 		settings.height = h;
 		settings.msaa = samples;
+		settings.memoryless = memoryless;
 
 		texture = newTexture(settings);
 
-		temporaryTextures.emplace_back(texture);
+		temporaryTextures.emplace_back(texture, framescoped);
 	}
 
 	return texture;
@@ -1372,6 +1688,8 @@ void Graphics::updateTemporaryResources()
 		}
 		else if (t.framesSinceUse >= 0)
 			t.framesSinceUse++;
+		else if (t.frameScoped)
+			t.framesSinceUse = 0;
 	}
 
 	for (int i = (int) temporaryBuffers.size() - 1; i >= 0; i--)
@@ -1388,8 +1706,35 @@ void Graphics::updateTemporaryResources()
 	}
 }
 
+void Graphics::purgeUnusedTemporaryResources()
+{
+	for (int i = (int) temporaryTextures.size() - 1; i >= 0; i--)
+	{
+		auto &t = temporaryTextures[i];
+		if (t.framesSinceUse >= 0)
+		{
+			t.texture->release();
+			t = temporaryTextures.back();
+			temporaryTextures.pop_back();
+		}
+	}
+
+	for (int i = (int) temporaryBuffers.size() - 1; i >= 0; i--)
+	{
+		auto &t = temporaryBuffers[i];
+		if (t.framesSinceUse >= 0)
+		{
+			t.buffer->release();
+			t = temporaryBuffers.back();
+			temporaryBuffers.pop_back();
+		}
+	}
+}
+
 void Graphics::clearTemporaryResources()
 {
+	releaseTextureArrayBatches();
+
 	for (auto temp :temporaryBuffers)
 		temp.buffer->release();
 
@@ -1400,6 +1745,368 @@ void Graphics::clearTemporaryResources()
 	temporaryTextures.clear();
 }
 
+void Graphics::setTextureArrayBatching(bool enable)
+{
+	if (!enable && textureArrayBatching)
+		releaseTextureArrayBatches();
+
+	textureArrayBatching = enable;
+}
+
+bool Graphics::isTextureArrayBatching() const
+{
+	return textureArrayBatching;
+}
+
+void Graphics::setAsyncCompute(bool enable)
+{
+	asyncCompute = enable;
+}
+
+bool Graphics::isAsyncCompute() const
+{
+	return asyncCompute;
+}
+
+StreamingTexture *Graphics::newStreamingTexture(love::image::CompressedImageData *data, const Texture::Settings &settings)
+{
+	return new StreamingTexture(this, data, settings);
+}
+
+void Graphics::setTextureStreamingBudget(int64 bytes)
+{
+	textureStreamingBudget = std::max(bytes, (int64) 0);
+}
+
+int64 Graphics::getTextureStreamingBudget() const
+{
+	return textureStreamingBudget;
+}
+
+int64 Graphics::getStreamingTextureMemory() const
+{
+	int64 total = 0;
+	for (const StreamingTexture *t : streamingTextures)
+		total += t->getResidentMemorySize(t->getResidentMipmap());
+	return total;
+}
+
+void Graphics::addStreamingTexture(StreamingTexture *texture)
+{
+	streamingTextures.push_back(texture);
+}
+
+void Graphics::removeStreamingTexture(StreamingTexture *texture)
+{
+	auto it = std::find(streamingTextures.begin(), streamingTextures.end(), texture);
+	if (it != streamingTextures.end())
+	{
+		*it = streamingTextures.back();
+		streamingTextures.pop_back();
+	}
+}
+
+VirtualTexture *Graphics::newVirtualTexture(int width, int height, const VirtualTexture::Settings &settings)
+{
+	return new VirtualTexture(this, width, height, settings);
+}
+
+void Graphics::addVirtualTexture(VirtualTexture *texture)
+{
+	virtualTextures.push_back(texture);
+}
+
+void Graphics::removeVirtualTexture(VirtualTexture *texture)
+{
+	auto it = std::find(virtualTextures.begin(), virtualTextures.end(), texture);
+	if (it != virtualTextures.end())
+	{
+		*it = virtualTextures.back();
+		virtualTextures.pop_back();
+	}
+}
+
+void Graphics::updateVirtualTextures()
+{
+	for (VirtualTexture *t : virtualTextures)
+		t->update();
+}
+
+void Graphics::updateStreamingTextures()
+{
+	if (streamingTextures.empty())
+		return;
+
+	int64 budget = textureStreamingBudget;
+	int64 total = getStreamingTextureMemory();
+
+	// Least recently drawn first, then the most detailed.
+	FrameVector<StreamingTexture *> candidates(streamingTextures.begin(), streamingTextures.end());
+	std::sort(candidates.begin(), candidates.end(), [](const StreamingTexture *a, const StreamingTexture *b)
+	{
+		if (a->getFramesSinceDraw() != b->getFramesSinceDraw())
+			return a->getFramesSinceDraw() > b->getFramesSinceDraw();
+		return a->getResidentMipmap() < b->getResidentMipmap();
+	});
+
+	// Drops the most detailed mipmaps of textures until the total fits within
+	// the given size.
+	auto evict = [&](int64 target, bool undrawnonly)
+	{
+		for (StreamingTexture *t : candidates)
+		{
+			if (total <= target || (undrawnonly && t->getFramesSinceDraw() == 0))
+				break;
+
+			int mip = t->getResidentMipmap();
+			while (total > target && mip < t->getMipmapCount() - 1)
+			{
+				total -= t->getResidentMemorySize(mip) - t->getResidentMemorySize(mip + 1);
+				mip++;
+			}
+
+			t->setResidentMipmap(mip);
+		}
+	};
+
+	try
+	{
+		if (budget > 0 && total > budget)
+			evict(budget, false);
+		else
+		{
+			// Only stream in one more level per frame, for the drawn texture
+			// which is furthest from the detail it's displayed at.
+			StreamingTexture *best = nullptr;
+			for (StreamingTexture *t : streamingTextures)
+			{
+				if (t->getFramesSinceDraw() > 0 || t->getDesiredMipmap() >= t->getResidentMipmap())
+					continue;
+
+				int need = t->getResidentMipmap() - t->getDesiredMipmap();
+				if (best == nullptr || need > best->getResidentMipmap() - best->getDesiredMipmap())
+					best = t;
+			}
+
+			if (best != nullptr)
+			{
+				int mip = best->getResidentMipmap() - 1;
+				int64 growth = best->getResidentMemorySize(mip) - best->getResidentMemorySize(mip + 1);
+
+				if (budget > 0 && total + growth > budget)
+					evict(budget - growth, true);
+
+				if (budget <= 0 || total + growth <= budget)
+					best->setResidentMipmap(mip);
+			}
+		}
+	}
+	catch (love::Exception &)
+	{
+		// Keep the current residency if a new texture couldn't be created.
+	}
+
+	for (StreamingTexture *t : streamingTextures)
+		t->nextFrame();
+}
+
+void Graphics::setShaderCacheEnabled(bool enable)
+{
+	shaderCacheEnabled = enable;
+}
+
+bool Graphics::isShaderCacheEnabled() const
+{
+	return shaderCacheEnabled;
+}
+
+bool Graphics::getTextureArrayBatchLayer(Texture *texture, Texture *&arraytexture, int &layer)
+{
+	// Custom shaders sample the main texture as a 2D texture.
+	if (!textureArrayBatching || !Shader::isDefaultActive())
+		return false;
+
+	auto &info = texture->getArrayBatchInfo();
+
+	if (info.arrayTexture != nullptr)
+	{
+		if (info.samplerKey == texture->getSamplerState().toKey())
+		{
+			arraytexture = info.arrayTexture;
+			layer = info.layer;
+			return true;
+		}
+
+		// The sampler state changed since it was copied, find a new page.
+		removeFromTextureArrayBatch(texture);
+	}
+
+	if (info.drawCount < 0 || ++info.drawCount < TEXTURE_ARRAY_BATCH_MIN_DRAWS)
+		return false;
+
+	if (!isTextureArrayBatchable(texture) || !addToTextureArrayBatch(texture))
+	{
+		info.drawCount = -1;
+		return false;
+	}
+
+	arraytexture = info.arrayTexture;
+	layer = info.layer;
+	return true;
+}
+
+bool Graphics::isTextureArrayBatchable(Texture *texture) const
+{
+	if (!capabilities.textureTypes[TEXTURE_2D_ARRAY] || !capabilities.features[FEATURE_COPY_TEXTURE_TO_BUFFER])
+		return false;
+
+	// Contents of render targets, compute-writable textures and texture views
+	// can change without going through replacePixels.
+	if (texture->getTextureType() != TEXTURE_2D || texture->isRenderTarget()
+		|| texture->isComputeWritable() || !texture->isReadable()
+		|| texture->getRootViewInfo().texture != texture
+		|| texture->getMipmapCount() > 1)
+	{
+		return false;
+	}
+
+	PixelFormat format = texture->getPixelFormat();
+	int w = texture->getPixelWidth();
+	int h = texture->getPixelHeight();
+
+	if (isPixelFormatDepthStencil(format) || w > TEXTURE_ARRAY_BATCH_MAX_SIZE || h > TEXTURE_ARRAY_BATCH_MAX_SIZE)
+		return false;
+
+	// Buffer copies work in multiples of 4 bytes.
+	if (getPixelFormatSliceSize(format, w, h) % 4 != 0)
+		return false;
+
+	return true;
+}
+
+bool Graphics::addToTextureArrayBatch(Texture *texture)
+{
+	PixelFormat format = texture->getPixelFormat();
+	int w = texture->getPixelWidth();
+	int h = texture->getPixelHeight();
+	uint64 samplerkey = texture->getSamplerState().toKey();
+
+	TextureArrayBatchPage *page = nullptr;
+	int layer = -1;
+
+	for (TextureArrayBatchPage &p : textureArrayBatchPages)
+	{
+		Texture *t = p.texture.get();
+		if (t->getPixelWidth() != w || t->getPixelHeight() != h || t->getPixelFormat() != format || p.samplerKey != samplerkey)
+			continue;
+
+		auto it = std::find(p.layers.begin(), p.layers.end(), nullptr);
+		if (it != p.layers.end())
+		{
+			page = &p;
+			layer = (int) (it - p.layers.begin());
+			break;
+		}
+	}
+
+	try
+	{
+		if (page == nullptr)
+		{
+			int layercount = std::min(TEXTURE_ARRAY_BATCH_LAYERS, (int) capabilities.limits[LIMIT_TEXTURE_LAYERS]);
+
+			Texture::Settings settings;
+			settings.type = TEXTURE_2D_ARRAY;
+			settings.width = w;
+			settings.height = h;
+			settings.layers = layercount;
+			settings.format = format;
+			settings.debugName = "texture_array_batch";
+
+			TextureArrayBatchPage newpage;
+			newpage.texture.set(newTexture(settings, nullptr), Acquire::NORETAIN);
+			newpage.texture->setSamplerState(texture->getSamplerState());
+			newpage.samplerKey = samplerkey;
+			newpage.layers.resize(layercount, nullptr);
+
+			textureArrayBatchPages.push_back(newpage);
+			page = &textureArrayBatchPages.back();
+			layer = 0;
+		}
+
+		flushBatchedDraws();
+
+		Rect rect = {0, 0, w, h};
+		size_t size = getPixelFormatSliceSize(format, w, h);
+
+		Buffer *buffer = getTemporaryBuffer(size, DATAFORMAT_UINT32, 0, BUFFERDATAUSAGE_DYNAMIC);
+
+		try
+		{
+			copyTextureToBuffer(texture, buffer, 0, 0, rect, 0, w);
+			copyBufferToTexture(buffer, page->texture, 0, w, layer, 0, rect);
+		}
+		catch (love::Exception &)
+		{
+			releaseTemporaryBuffer(buffer);
+			throw;
+		}
+
+		releaseTemporaryBuffer(buffer);
+	}
+	catch (love::Exception &)
+	{
+		return false;
+	}
+
+	page->layers[layer] = texture;
+
+	auto &info = texture->getArrayBatchInfo();
+	info.arrayTexture = page->texture;
+	info.layer = layer;
+	info.samplerKey = samplerkey;
+
+	return true;
+}
+
+void Graphics::removeFromTextureArrayBatch(Texture *texture)
+{
+	auto &info = texture->getArrayBatchInfo();
+	if (info.arrayTexture == nullptr)
+		return;
+
+	for (size_t i = 0; i < textureArrayBatchPages.size(); i++)
+	{
+		TextureArrayBatchPage &page = textureArrayBatchPages[i];
+		if (page.texture.get() != info.arrayTexture)
+			continue;
+
+		page.layers[info.layer] = nullptr;
+
+		// Pending batches hold their own reference to the array texture.
+		if (std::find_if(page.layers.begin(), page.layers.end(), [](Texture *t) { return t != nullptr; }) == page.layers.end())
+			textureArrayBatchPages.erase(textureArrayBatchPages.begin() + i);
+
+		break;
+	}
+
+	info = Texture::ArrayBatchInfo();
+}
+
+void Graphics::releaseTextureArrayBatches()
+{
+	for (TextureArrayBatchPage &page : textureArrayBatchPages)
+	{
+		for (Texture *texture : page.layers)
+		{
+			if (texture != nullptr)
+				texture->getArrayBatchInfo() = Texture::ArrayBatchInfo();
+		}
+	}
+
+	textureArrayBatchPages.clear();
+}
+
 void Graphics::updatePendingReadbacks()
 {
 	for (int i = (int)pendingReadbacks.size() - 1; i >= 0; i--)
@@ -1413,6 +2120,81 @@ void Graphics::updatePendingReadbacks()
 	}
 }
 
+void Graphics::updatePendingUploads()
+{
+	for (int i = (int)pendingUploads.size() - 1; i >= 0; i--)
+	{
+		TextureUpload *upload = pendingUploads[i];
+		if (--upload->framesRemaining <= 0)
+		{
+			releaseTemporaryBuffer(upload->stagingBuffer);
+			upload->stagingBuffer = nullptr;
+
+			pendingUploads[i] = pendingUploads.back();
+			pendingUploads.pop_back();
+		}
+	}
+}
+
+TextureUpload *Graphics::replacePixelsAsync(Texture *texture, love::image::ImageDataBase *data, int slice, int mipmap, int x, int y, bool reloadmipmaps)
+{
+	// ImageData format might be linear but intended to be used as sRGB, so we
+	// don't error if only the sRGBness is different.
+	if (getLinearPixelFormat(data->getFormat()) != getLinearPixelFormat(texture->getPixelFormat()))
+		throw love::Exception("Pixel formats must match.");
+
+	if (texture->getMSAA() > 1)
+		throw love::Exception("replacePixelsAsync cannot be called on a MSAA Texture.");
+
+	size_t size = data->getSize();
+
+	// Buffer-to-texture copies need 4 byte aligned sizes. Fall back to a
+	// regular upload for the rare data which doesn't fit that.
+	if (size % 4 != 0)
+	{
+		texture->replacePixels(data, slice, mipmap, x, y, reloadmipmaps);
+		return new TextureUpload(texture, nullptr);
+	}
+
+	Rect rect = {x, y, data->getWidth(), data->getHeight()};
+
+	flushBatchedDraws();
+
+	Buffer *buffer = getTemporaryBuffer(size, DATAFORMAT_UINT32, 0, BUFFERDATAUSAGE_DYNAMIC);
+
+	try
+	{
+		buffer->fill(0, size, data->getData());
+		copyBufferToTexture(buffer, texture, 0, rect.w, slice, mipmap, rect);
+
+		if (reloadmipmaps && mipmap == 0 && texture->getMipmapCount() > 1)
+			texture->generateMipmaps();
+	}
+	catch (love::Exception &)
+	{
+		releaseTemporaryBuffer(buffer);
+		throw;
+	}
+
+	TextureUpload *upload = new TextureUpload(texture, buffer);
+	pendingUploads.push_back(upload);
+	return upload;
+}
+
+TextureUpload *Graphics::newTextureAsync(const Texture::Settings &settings, love::image::ImageData *data)
+{
+	// The Texture is created without data and filled by a staged copy.
+	StrongRef<Texture> texture(newTexture(settings, nullptr), Acquire::NORETAIN);
+	bool reloadmipmaps = texture->getMipmapsMode() == Texture::MIPMAPS_AUTO;
+	return replacePixelsAsync(texture, data, 0, 0, 0, 0, reloadmipmaps);
+}
+
+BufferUpload *Graphics::newBufferAsync(const Buffer::Settings &settings, const std::vector<Buffer::DataDeclaration> &format, Data *data, size_t arraylength)
+{
+	StrongRef<Buffer> buffer(newBuffer(settings, format, data->getData(), data->getSize(), arraylength), Acquire::NORETAIN);
+	return new BufferUpload(buffer);
+}
+
 void Graphics::intersectScissor(const Rect &rect)
 {
 	Rect currect = states.back().scissorRect;
@@ -1442,6 +2224,141 @@ bool Graphics::getScissor(Rect &rect) const
 	return state.scissor;
 }
 
+static bool isNearZero(float v)
+{
+	return fabs(v) < 1.0e-5f;
+}
+
+static bool getAxisAlignedClipRect(const Matrix4 &m, float x, float y, float w, float h, Rect &rect)
+{
+	const float *e = m.getElements();
+
+	// Projective transforms can't be represented by a scissor box.
+	if (!isNearZero(e[3]) || !isNearZero(e[7]) || e[15] != 1.0f)
+		return false;
+
+	// Translation and scale, optionally combined with a 90 degree rotation.
+	bool aligned = (isNearZero(e[1]) && isNearZero(e[4])) || (isNearZero(e[0]) && isNearZero(e[5]));
+	if (!aligned)
+		return false;
+
+	Vector2 corners[2] = {Vector2(x, y), Vector2(x + w, y + h)};
+	m.transformXY(corners, corners, 2);
+
+	int x1 = (int) floorf(std::min(corners[0].x, corners[1].x) + 0.5f);
+	int y1 = (int) floorf(std::min(corners[0].y, corners[1].y) + 0.5f);
+	int x2 = (int) floorf(std::max(corners[0].x, corners[1].x) + 0.5f);
+	int y2 = (int) floorf(std::max(corners[0].y, corners[1].y) + 0.5f);
+
+	rect = {x1, y1, x2 - x1, y2 - y1};
+	return true;
+}
+
+void Graphics::drawClipStencil(const ClipState &clip, StencilAction action, int value)
+{
+	// Only pixels inside every enclosing stencil clip have the current depth
+	// as their stencil value, so nested clips never need a stencil clear.
+	StencilState stencil;
+	stencil.action = action;
+	stencil.compare = COMPARE_EQUAL;
+	stencil.value = value;
+
+	push(STACK_ALL);
+
+	try
+	{
+		replaceTransform(clip.transform);
+		setShader();
+		setDepthMode();
+		setWireframe(false);
+		setColorMask({ false, false, false, false });
+		setStencilState(stencil);
+
+		rectangle(DRAW_FILL, clip.x, clip.y, clip.w, clip.h);
+	}
+	catch (love::Exception &)
+	{
+		pop();
+		throw;
+	}
+
+	pop();
+}
+
+bool Graphics::pushClip(float x, float y, float w, float h)
+{
+	if (w < 0.0f)
+	{
+		x += w;
+		w = -w;
+	}
+
+	if (h < 0.0f)
+	{
+		y += h;
+		h = -h;
+	}
+
+	ClipState clip;
+	clip.hadScissor = getScissor(clip.scissorRect);
+	clip.stencilState = getStencilState();
+
+	Rect rect;
+	if (!states.back().useCustomProjection && getAxisAlignedClipRect(getTransform(), x, y, w, h, rect))
+	{
+		intersectScissor(rect);
+	}
+	else
+	{
+		if (stencilClipDepth >= MAX_STENCIL_CLIP_DEPTH)
+			throw love::Exception("Maximum stencil clip depth reached (more pushClips than popClips?)");
+
+		clip.stencil = true;
+		clip.x = x;
+		clip.y = y;
+		clip.w = w;
+		clip.h = h;
+		clip.transform = getTransform();
+
+		drawClipStencil(clip, STENCIL_INCREMENT, stencilClipDepth);
+		stencilClipDepth++;
+
+		StencilState test;
+		test.compare = COMPARE_EQUAL;
+		test.value = stencilClipDepth;
+		setStencilState(test);
+	}
+
+	clipStack.push_back(clip);
+	return clip.stencil;
+}
+
+void Graphics::popClip()
+{
+	if (clipStack.empty())
+		throw love::Exception("Minimum clip stack depth reached (more popClips than pushClips?)");
+
+	ClipState clip = clipStack.back();
+
+	if (clip.stencil)
+	{
+		drawClipStencil(clip, STENCIL_DECREMENT, stencilClipDepth);
+		stencilClipDepth--;
+		setStencilState(clip.stencilState);
+	}
+	else if (clip.hadScissor)
+		setScissor(clip.scissorRect);
+	else
+		setScissor();
+
+	clipStack.pop_back();
+}
+
+int Graphics::getClipDepth() const
+{
+	return (int) clipStack.size();
+}
+
 void Graphics::setStencilMode(StencilMode mode, int value)
 {
 	setStencilState(computeStencilState(mode, value));
@@ -1572,6 +2489,19 @@ Graphics::LineJoin Graphics::getLineJoin() const
 	return states.back().lineJoin;
 }
 
+void Graphics::setBatchSortMode(BatchSortMode mode)
+{
+	if (mode != states.back().batchSortMode)
+		flushBatchedDraws();
+
+	states.back().batchSortMode = mode;
+}
+
+Graphics::BatchSortMode Graphics::getBatchSortMode() const
+{
+	return states.back().batchSortMode;
+}
+
 float Graphics::getPointSize() const
 {
 	return states.back().pointSize;
@@ -1587,6 +2517,24 @@ void Graphics::captureScreenshot(const ScreenshotInfo &info)
 	pendingScreenshotCallbacks.push_back(info);
 }
 
+void Graphics::captureBackbuffer(Texture *dest)
+{
+	if (!capabilities.features[FEATURE_BACKBUFFER_CAPTURE])
+		throw love::Exception("Capturing the backbuffer to a Texture is not supported by the current renderer.");
+
+	if (dest->getTextureType() != TEXTURE_2D || !dest->isRenderTarget() || dest->getMSAA() > 1)
+		throw love::Exception("The backbuffer can only be captured to a 2D render target Texture without MSAA.");
+
+	PixelFormat format = getLinearPixelFormat(dest->getPixelFormat());
+	if (format != PIXELFORMAT_RGBA8_UNORM)
+		throw love::Exception("The backbuffer can only be captured to a Texture with the rgba8 or srgba8 pixel format.");
+
+	if (dest->getPixelWidth() != getPixelWidth() || dest->getPixelHeight() != getPixelHeight())
+		throw love::Exception("The Texture's pixel dimensions must match the backbuffer's to capture it.");
+
+	pendingBackbufferCaptures.push_back(dest);
+}
+
 void Graphics::copyBuffer(Buffer *source, Buffer *dest, size_t sourceoffset, size_t destoffset, size_t size)
 {
 	Range sourcerange(sourceoffset, size);
@@ -1782,6 +2730,8 @@ void Graphics::copyBufferToTexture(Buffer *source, Texture *dest, size_t sourceo
 	if (sourcerange.getMax() >= source->getSize())
 		throw love::Exception("Buffer copy source offset and width/height doesn't fit within the source Buffer.");
 
+	removeFromTextureArrayBatch(dest);
+
 	dest->copyFromBuffer(source, sourceoffset, sourcewidth, size, slice, mipmap, rect);
 }
 
@@ -1797,7 +2747,7 @@ static const char *getIndirectArgsTypeName(Graphics::IndirectArgsType argstype)
 	return "(Unknown argument data)";
 }
 
-void Graphics::validateIndirectArgsBuffer(IndirectArgsType argstype, Buffer *indirectargs, int argsindex)
+void Graphics::validateIndirectArgsBuffer(IndirectArgsType argstype, Buffer *indirectargs, int argsindex, int drawcount)
 {
 	if (!capabilities.features[FEATURE_INDIRECT_DRAW])
 		throw love::Exception("Indirect draws and compute dispatches are not supported on this system.");
@@ -1808,6 +2758,9 @@ void Graphics::validateIndirectArgsBuffer(IndirectArgsType argstype, Buffer *ind
 	if (argsindex < 0)
 		throw love::Exception("The given indirect argument index cannot be negative.");
 
+	if (drawcount <= 0)
+		throw love::Exception("The number of indirect draws must be positive.");
+
 	size_t argelements = 0;
 	if (argstype == INDIRECT_ARGS_DISPATCH)
 		argelements = 3;
@@ -1823,8 +2776,12 @@ void Graphics::validateIndirectArgsBuffer(IndirectArgsType argstype, Buffer *ind
 
 	size_t argsoffset = argsindex * indirectargs->getArrayStride();
 
-	if (indirectargs->getSize() < argsoffset + sizeof(uint32) * argelements)
+	if (indirectargs->getSize() < argsoffset + sizeof(uint32) * argelements * drawcount)
+	{
+		if (drawcount > 1)
+			throw love::Exception("The given index and draw count (%d) into the indirect argument Buffer do not fit within the Buffer's size.", drawcount);
 		throw love::Exception("The given index into the indirect argument Buffer does not fit within the Buffer's size.");
+	}
 }
 
 void Graphics::dispatchThreadgroups(Shader *shader, int x, int y, int z)
@@ -1877,10 +2834,256 @@ void Graphics::dispatchIndirect(Shader *shader, Buffer *indirectargs, int argsin
 		throw love::Exception("Compute shader must have resources bound to all writable texture and buffer variables.");
 }
 
+static bool isSourceOnlyBlendFactor(BlendFactor factor)
+{
+	switch (factor)
+	{
+	case BLENDFACTOR_ZERO:
+	case BLENDFACTOR_ONE:
+	case BLENDFACTOR_SRC_COLOR:
+	case BLENDFACTOR_ONE_MINUS_SRC_COLOR:
+	case BLENDFACTOR_SRC_ALPHA:
+	case BLENDFACTOR_ONE_MINUS_SRC_ALPHA:
+		return true;
+	default:
+		return false;
+	}
+}
+
+static bool isOrderIndependentBlend(BlendOperation op, BlendFactor src, BlendFactor dst)
+{
+	// Min and max ignore the blend factors.
+	if (op == BLENDOP_MIN || op == BLENDOP_MAX)
+		return true;
+
+	if (op == BLENDOP_SUBTRACT)
+		return false;
+
+	// dst + f(src), or dst - f(src) with reverse subtract.
+	if (dst == BLENDFACTOR_ONE && isSourceOnlyBlendFactor(src))
+		return true;
+
+	if (op != BLENDOP_ADD)
+		return false;
+
+	// dst * f(src).
+	if (src == BLENDFACTOR_ZERO && isSourceOnlyBlendFactor(dst))
+		return true;
+
+	// src * dst.
+	return src == BLENDFACTOR_DST_COLOR && dst == BLENDFACTOR_ZERO;
+}
+
+bool Graphics::isBatchReorderSafe() const
+{
+	const DisplayState &state = states.back();
+
+	// Depth and stencil writes can resolve differently when draws overlap.
+	if (state.depthWrite || state.stencil.action != STENCIL_KEEP)
+		return false;
+
+	const BlendState &b = state.blend;
+	if (!b.enable)
+		return false;
+
+	return isOrderIndependentBlend(b.operationRGB, b.srcFactorRGB, b.dstFactorRGB)
+		&& isOrderIndependentBlend(b.operationA, b.srcFactorA, b.dstFactorA);
+}
+
+Graphics::BatchedVertexData Graphics::requestDeferredBatchedDraw(const BatchedDrawCommand &cmd)
+{
+	BatchedDrawState &state = batchedDrawState;
+
+	// Keep anything which was batched before sorting started in front.
+	if (state.vertexCount > 0)
+		flushBatchedDraws();
+
+	// Changing the user shader ends the deferred batch, so it's safe to
+	// validate against it now. The default shaders are validated when the
+	// draws are submitted.
+	if (!Shader::isDefaultActive() && Shader::current != nullptr)
+		Shader::current->validateDrawState(cmd.primitiveMode, cmd.texture);
+
+	// Blend, depth and stencil state, render targets, and the user shader all
+	// flush when they change, so only per-draw state needs to be in the key.
+	uint32 textureindex = 0;
+	if (cmd.texture != nullptr)
+	{
+		auto &textures = state.deferredTextures;
+		auto it = std::find_if(textures.begin(), textures.end(), [&](const StrongRef<Texture> &t) { return t.get() == cmd.texture; });
+
+		textureindex = (uint32) (it - textures.begin()) + 1;
+		if (it == textures.end())
+			textures.emplace_back(cmd.texture);
+	}
+
+	uint64 key = ((uint64) cmd.standardShaderType << 56)
+		| ((uint64) cmd.primitiveMode << 48)
+		| ((uint64) cmd.formats[0] << 40)
+		| ((uint64) cmd.formats[1] << 36)
+		| ((uint64) (cmd.indexMode != TRIANGLEINDEX_NONE) << 32)
+		| (uint64) textureindex;
+
+	DeferredBatchedDraw draw;
+	draw.sortKey = key;
+	draw.command = cmd;
+
+	size_t totalsize = state.deferredVertexData.size();
+	size_t datasizes[2] = {0, 0};
+
+	for (int i = 0; i < 2; i++)
+	{
+		draw.dataOffsets[i] = totalsize;
+		if (cmd.formats[i] != CommonFormat::NONE)
+			datasizes[i] = getFormatStride(cmd.formats[i]) * cmd.vertexCount;
+		totalsize += datasizes[i];
+	}
+
+	state.deferredVertexData.resize(totalsize);
+	state.deferredDraws.push_back(draw);
+
+	BatchedVertexData d;
+
+	for (int i = 0; i < 2; i++)
+		d.stream[i] = datasizes[i] > 0 ? state.deferredVertexData.data() + draw.dataOffsets[i] : nullptr;
+
+	return d;
+}
+
+void Graphics::submitDeferredBatchedDraws()
+{
+	BatchedDrawState &state = batchedDrawState;
+
+	if (state.deferredDraws.empty() || state.submittingDeferred)
+		return;
+
+	state.submittingDeferred = true;
+
+	auto &draws = state.deferredDraws;
+	std::stable_sort(draws.begin(), draws.end(), [](const DeferredBatchedDraw &a, const DeferredBatchedDraw &b)
+	{
+		return a.sortKey < b.sortKey;
+	});
+
+	for (const DeferredBatchedDraw &draw : draws)
+	{
+		BatchedVertexData d = requestBatchedDraw(draw.command);
+
+		for (int i = 0; i < 2; i++)
+		{
+			if (draw.command.formats[i] == CommonFormat::NONE || draw.command.vertexCount == 0)
+				continue;
+
+			size_t size = getFormatStride(draw.command.formats[i]) * draw.command.vertexCount;
+			memcpy(d.stream[i], state.deferredVertexData.data() + draw.dataOffsets[i], size);
+		}
+	}
+
+	draws.clear();
+	state.deferredVertexData.clear();
+	state.deferredTextures.clear();
+	state.submittingDeferred = false;
+}
+
+void Graphics::beginShapeCapture(ShapeCapture *capture)
+{
+	if (shapeCapture != nullptr)
+		throw love::Exception("A shape capture is already active.");
+
+	capture->positions.clear();
+	capture->attributes.clear();
+	capture->indices.clear();
+
+	shapeCapture = capture;
+}
+
+void Graphics::endShapeCapture()
+{
+	shapeCapture = nullptr;
+}
+
+void Graphics::beginDrawList(DrawList *list)
+{
+	if (recordingDrawList != nullptr)
+		throw love::Exception("A DrawList is already being recorded.");
+
+	if (shapeCapture != nullptr)
+		throw love::Exception("Cannot record a DrawList while a shape capture is active.");
+
+	list->clear();
+	list->retain();
+	recordingDrawList = list;
+
+	pushIdentityTransform();
+}
+
+void Graphics::endDrawList()
+{
+	if (recordingDrawList == nullptr)
+		throw love::Exception("No DrawList is being recorded.");
+
+	popTransform();
+
+	recordingDrawList->release();
+	recordingDrawList = nullptr;
+}
+
+DrawList *Graphics::getRecordingDrawList() const
+{
+	return recordingDrawList;
+}
+
+static Graphics::BatchedVertexData captureBatchedDraw(Graphics::ShapeCapture &capture, const Graphics::BatchedDrawCommand &cmd)
+{
+	if (cmd.primitiveMode != PRIMITIVE_TRIANGLES || cmd.texture != nullptr
+		|| cmd.formats[0] != CommonFormat::XYf || cmd.formats[1] != CommonFormat::STf_RGBAub)
+	{
+		throw love::Exception("Only untextured 2D shapes can be recorded.");
+	}
+
+	uint32 start = (uint32) capture.positions.size();
+	uint32 count = (uint32) cmd.vertexCount;
+
+	capture.positions.resize(start + count);
+	capture.attributes.resize(start + count);
+
+	size_t indexstart = capture.indices.size();
+
+	if (cmd.indexMode == TRIANGLEINDEX_NONE)
+	{
+		capture.indices.resize(indexstart + count);
+		for (uint32 i = 0; i < count; i++)
+			capture.indices[indexstart + i] = start + i;
+	}
+	else
+	{
+		capture.indices.resize(indexstart + getIndexCount(cmd.indexMode, count));
+		fillIndices(cmd.indexMode, start, count, capture.indices.data() + indexstart);
+	}
+
+	Graphics::BatchedVertexData d;
+	d.stream[0] = capture.positions.data() + start;
+	d.stream[1] = capture.attributes.data() + start;
+	return d;
+}
+
 Graphics::BatchedVertexData Graphics::requestBatchedDraw(const BatchedDrawCommand &cmd)
 {
+	if (shapeCapture != nullptr)
+		return captureBatchedDraw(*shapeCapture, cmd);
+
+	if (recordingDrawList != nullptr)
+		return recordingDrawList->recordBatchedDraw(cmd, states.back().blend);
+
 	BatchedDrawState &state = batchedDrawState;
 
+	BatchSortMode sortmode = states.back().batchSortMode;
+	if (sortmode != BATCH_SORT_NONE && !state.submittingDeferred && !state.flushing
+		&& (sortmode == BATCH_SORT_ALWAYS || isBatchReorderSafe()))
+	{
+		return requestDeferredBatchedDraw(cmd);
+	}
+
 	bool shouldflush = false;
 	bool shouldresize = false;
 
@@ -2016,9 +3219,14 @@ void Graphics::flushBatchedDraws()
 {
 	auto &sbstate = batchedDrawState;
 
+	if (!sbstate.deferredDraws.empty() && !sbstate.submittingDeferred)
+		submitDeferredBatchedDraws();
+
 	if ((sbstate.vertexCount == 0 && sbstate.indexCount == 0) || sbstate.flushing)
 		return;
 
+	LOVE_PROFILE_ZONE("Graphics::flushBatchedDraws");
+
 	VertexAttributes attributes;
 	BufferBindings buffers;
 
@@ -2105,6 +3313,14 @@ void Graphics::flushBatchedDrawsGlobal()
 
 void Graphics::draw(Drawable *drawable, const Matrix4 &m)
 {
+	// Textures go through the batching system and are recorded there, other
+	// Drawables are replayed by reference.
+	if (recordingDrawList != nullptr && dynamic_cast<Texture *>(drawable) == nullptr)
+	{
+		recordingDrawList->recordDrawable(drawable, transformStack.back() * m, getColor(), states.back().blend);
+		return;
+	}
+
 	drawable->draw(this, m);
 }
 
@@ -2125,12 +3341,18 @@ void Graphics::drawLayer(Texture *texture, int layer, Quad *quad, const Matrix4
 
 void Graphics::drawInstanced(Mesh *mesh, const Matrix4 &m, int instancecount)
 {
+	if (recordingDrawList != nullptr)
+		throw love::Exception("Instanced draws cannot be recorded in a DrawList.");
+
 	mesh->drawInstanced(this, m, instancecount);
 }
 
-void Graphics::drawIndirect(Mesh *mesh, const Matrix4 &m, Buffer *indirectargs, int argsindex)
+void Graphics::drawIndirect(Mesh *mesh, const Matrix4 &m, Buffer *indirectargs, int argsindex, int drawcount)
 {
-	mesh->drawIndirect(this, m, indirectargs, argsindex);
+	if (recordingDrawList != nullptr)
+		throw love::Exception("Indirect draws cannot be recorded in a DrawList.");
+
+	mesh->drawIndirect(this, m, indirectargs, argsindex, drawcount);
 }
 
 void Graphics::drawFromShader(PrimitiveType primtype, int vertexcount, int instancecount, Texture *maintexture)
@@ -2207,7 +3429,7 @@ void Graphics::drawFromShader(Buffer *indexbuffer, int indexcount, int instancec
 	draw(cmd);
 }
 
-void Graphics::drawFromShaderIndirect(PrimitiveType primtype, Buffer *indirectargs, int argsindex, Texture *maintexture)
+void Graphics::drawFromShaderIndirect(PrimitiveType primtype, Buffer *indirectargs, int argsindex, Texture *maintexture, int drawcount)
 {
 	flushBatchedDraws();
 
@@ -2217,7 +3439,7 @@ void Graphics::drawFromShaderIndirect(PrimitiveType primtype, Buffer *indirectar
 	if (Shader::isDefaultActive() || !Shader::current)
 		throw love::Exception("drawFromShaderIndirect can only be used with a custom shader.");
 
-	validateIndirectArgsBuffer(INDIRECT_ARGS_DRAW_VERTICES, indirectargs, argsindex);
+	validateIndirectArgsBuffer(INDIRECT_ARGS_DRAW_VERTICES, indirectargs, argsindex, drawcount);
 
 	Shader::current->validateDrawState(primtype, maintexture);
 
@@ -2229,12 +3451,13 @@ void Graphics::drawFromShaderIndirect(PrimitiveType primtype, Buffer *indirectar
 	cmd.primitiveType = primtype;
 	cmd.indirectBuffer = indirectargs;
 	cmd.indirectBufferOffset = argsindex * indirectargs->getArrayStride();
+	cmd.indirectDrawCount = drawcount;
 	cmd.texture = getTextureOrDefaultForActiveShader(maintexture);
 
 	draw(cmd);
 }
 
-void Graphics::drawFromShaderIndirect(Buffer *indexbuffer, Buffer *indirectargs, int argsindex, Texture *maintexture)
+void Graphics::drawFromShaderIndirect(Buffer *indexbuffer, Buffer *indirectargs, int argsindex, Texture *maintexture, int drawcount)
 {
 	flushBatchedDraws();
 
@@ -2244,7 +3467,7 @@ void Graphics::drawFromShaderIndirect(Buffer *indexbuffer, Buffer *indirectargs,
 	if (Shader::isDefaultActive() || !Shader::current)
 		throw love::Exception("drawFromShaderIndirect can only be used with a custom shader.");
 
-	validateIndirectArgsBuffer(INDIRECT_ARGS_DRAW_INDICES, indirectargs, argsindex);
+	validateIndirectArgsBuffer(INDIRECT_ARGS_DRAW_INDICES, indirectargs, argsindex, drawcount);
 
 	Shader::current->validateDrawState(PRIMITIVE_TRIANGLES, maintexture);
 
@@ -2256,7 +3479,8 @@ void Graphics::drawFromShaderIndirect(Buffer *indexbuffer, Buffer *indirectargs,
 	cmd.primitiveType = PRIMITIVE_TRIANGLES;
 	cmd.indexType = getIndexDataType(indexbuffer->getDataMember(0).decl.format);
 	cmd.indirectBuffer = indirectargs;
-	cmd.indexBufferOffset = argsindex * indirectargs->getArrayStride();
+	cmd.indirectBufferOffset = argsindex * indirectargs->getArrayStride();
+	cmd.indirectDrawCount = drawcount;
 	cmd.texture = getTextureOrDefaultForActiveShader(maintexture);
 
 	draw(cmd);
@@ -2378,6 +3602,105 @@ void Graphics::polyline(const Vector2 *vertices, size_t count)
 	}
 }
 
+void Graphics::drawLines(Buffer *points, int start, int count, const Matrix4 &m)
+{
+	if (!(points->getUsageFlags() & BUFFERUSAGEFLAG_VERTEX))
+		throw love::Exception("drawLines requires a Buffer created with the vertex usage flag.");
+
+	const Buffer::DataMember &member = points->getDataMember(0);
+	if (member.decl.format != DATAFORMAT_FLOAT_VEC2)
+		throw love::Exception("The first member of the Buffer given to drawLines must use the floatvec2 format.");
+
+	if (start < 0 || count < 2 || (size_t) start + (size_t) count > points->getArrayLength())
+		throw love::Exception("Invalid point range given to drawLines.");
+
+	flushBatchedDraws();
+
+	if (Shader::isDefaultActive())
+		Shader::attachDefault(Shader::STANDARD_LINES);
+
+	if (Shader::current == nullptr)
+		return;
+
+	const char *pointnames[] = {"LinePrevious", "LineStart", "LineEnd", "LineNext"};
+	int pointattribs[4];
+
+	for (int i = 0; i < 4; i++)
+	{
+		pointattribs[i] = Shader::current->getVertexAttributeIndex(pointnames[i]);
+		if (pointattribs[i] < 0)
+			throw love::Exception("The active shader must declare the '%s' vertex attribute to be used with drawLines.", pointnames[i]);
+	}
+
+	Shader::current->validateDrawState(PRIMITIVE_TRIANGLE_STRIP, nullptr);
+
+	if (lineQuadBuffer == nullptr)
+	{
+		// x selects the segment's start or end point, y the side of the line.
+		Vector2 unitquad[4] = {
+			Vector2(0.0f, -1.0f),
+			Vector2(0.0f, 1.0f),
+			Vector2(1.0f, -1.0f),
+			Vector2(1.0f, 1.0f),
+		};
+
+		Buffer::Settings settings(BUFFERUSAGEFLAG_VERTEX, BUFFERDATAUSAGE_STATIC);
+		auto decl = Buffer::getCommonFormatDeclaration(CommonFormat::XYf);
+		lineQuadBuffer = newBuffer(settings, decl, unitquad, sizeof(unitquad), 0);
+	}
+
+	size_t stride = points->getArrayStride();
+	size_t memberoffset = points->getMemberOffset(0);
+
+	VertexAttributes attributes;
+	attributes.setCommonFormat(CommonFormat::XYf, 0);
+
+	for (int i = 0; i < 4; i++)
+	{
+		attributes.set(pointattribs[i], member.decl.format, (uint16) memberoffset, (uint8) (i + 1));
+		attributes.setBufferLayout(i + 1, (uint16) stride, STEP_PER_INSTANCE);
+	}
+
+	TempTransform transform(this, m);
+
+	Texture *texture = getTextureOrDefaultForActiveShader(nullptr);
+
+	// Each instance is one segment, which reads the point before and after it
+	// for its joins. The first and last segments are drawn separately with
+	// their outer neighbour clamped to the segment's own end point, which the
+	// shader treats as an unjoined end.
+	auto drawsegments = [&](int prev, int a, int b, int next, int instancecount)
+	{
+		BufferBindings buffers;
+		buffers.set(0, lineQuadBuffer, 0);
+		buffers.set(1, points, (start + prev) * stride);
+		buffers.set(2, points, (start + a) * stride);
+		buffers.set(3, points, (start + b) * stride);
+		buffers.set(4, points, (start + next) * stride);
+
+		DrawCommand cmd(&attributes, &buffers);
+		cmd.primitiveType = PRIMITIVE_TRIANGLE_STRIP;
+		cmd.vertexCount = 4;
+		cmd.instanceCount = instancecount;
+		cmd.texture = texture;
+
+		draw(cmd);
+	};
+
+	if (count == 2)
+	{
+		drawsegments(0, 0, 1, 1, 1);
+		return;
+	}
+
+	drawsegments(0, 0, 1, 2, 1);
+
+	if (count > 3)
+		drawsegments(0, 1, 2, 3, count - 3);
+
+	drawsegments(count - 3, count - 2, count - 1, count - 1, 1);
+}
+
 void Graphics::rectangle(DrawMode mode, float x, float y, float w, float h)
 {
 	Vector2 coords[] = {Vector2(x,y), Vector2(x,y+h), Vector2(x+w,y+h), Vector2(x+w,y), Vector2(x,y)};
@@ -2661,10 +3984,15 @@ Graphics::Stats Graphics::getStats() const
 {
 	Stats stats;
 
-	getAPIStats(stats.shaderSwitches);
+	stats.shaderSwitches = 0;
+	stats.framebufferCacheSize = 0;
+	stats.framebufferCacheHits = 0;
+	stats.framebufferCacheMisses = 0;
+
+	getAPIStats(stats);
 
 	stats.drawCalls = drawCalls;
-	if (batchedDrawState.vertexCount > 0)
+	if (batchedDrawState.vertexCount > 0 || !batchedDrawState.deferredDraws.empty())
 		stats.drawCalls++;
 
 	stats.renderTargetSwitches = renderTargetSwitchCount;
@@ -2675,9 +4003,156 @@ Graphics::Stats Graphics::getStats() const
 	stats.textureMemory = Texture::totalGraphicsMemory;
 	stats.bufferMemory = Buffer::totalGraphicsMemory;
 
+	stats.streamBufferMemory = 0;
+	stats.streamBufferUsed = 0;
+	stats.streamBufferStalls = 0;
+
+	const StreamBuffer *streambuffers[] = {batchedDrawState.vb[0], batchedDrawState.vb[1], batchedDrawState.indexBuffer};
+	for (const StreamBuffer *buffer : streambuffers)
+	{
+		if (buffer == nullptr)
+			continue;
+
+		stats.streamBufferMemory += buffer->getMemorySize();
+		stats.streamBufferUsed += buffer->getFrameUsedSize();
+		stats.streamBufferStalls += buffer->getFrameStallCount();
+	}
+
+	stats.gpuFrameTime = gpuFrameTime;
+	stats.gpuScopes = gpuScopeTimes;
+	stats.presentTime = presentTime;
+
 	return stats;
 }
 
+bool Graphics::defragmentMemory(int64 /*maxbytes*/, int64 &bytesmoved)
+{
+	bytesmoved = 0;
+	return true;
+}
+
+void Graphics::beginGPUScope(const std::string &name)
+{
+	GPUTimerFrame *frame = getGPUTimerFrame();
+	if (frame == nullptr)
+		return;
+
+	flushBatchedDraws();
+
+	int timestamp = writeGPUTimestamp();
+	if (timestamp < 0)
+		return;
+
+	frame->openScopes.push_back((int) frame->scopes.size());
+	frame->scopes.push_back({name, (int) frame->openScopes.size() - 1, timestamp, -1});
+}
+
+void Graphics::endGPUScope()
+{
+	GPUTimerFrame *frame = getGPUTimerFrame();
+	if (frame == nullptr)
+		return;
+
+	if (frame->openScopes.empty())
+		throw love::Exception("endGPUScope must be called after beginGPUScope, within the same frame.");
+
+	flushBatchedDraws();
+
+	GPUTimerScope &scope = frame->scopes[frame->openScopes.back()];
+	frame->openScopes.pop_back();
+
+	scope.endTimestamp = writeGPUTimestamp();
+}
+
+OcclusionQuery *Graphics::newOcclusionQuery()
+{
+	if (!capabilities.features[FEATURE_OCCLUSION_QUERY])
+		throw love::Exception("Occlusion queries are not supported on this system.");
+
+	return new OcclusionQuery();
+}
+
+void Graphics::beginOcclusionQuery(OcclusionQuery *query)
+{
+	if (activeOcclusionQuery.get() != nullptr)
+		throw love::Exception("Only one occlusion query can be active at a time (missing endOcclusionQuery?)");
+
+	flushBatchedDraws();
+
+	query->begin();
+	activeOcclusionQuery.set(query);
+	beginOcclusionQueryInternal(query);
+}
+
+void Graphics::endOcclusionQuery()
+{
+	OcclusionQuery *query = activeOcclusionQuery.get();
+	if (query == nullptr)
+		throw love::Exception("endOcclusionQuery must be called after beginOcclusionQuery.");
+
+	flushBatchedDraws();
+
+	endOcclusionQueryInternal(query);
+	query->end();
+	activeOcclusionQuery.set(nullptr);
+}
+
+OcclusionQuery *Graphics::getActiveOcclusionQuery() const
+{
+	return activeOcclusionQuery.get();
+}
+
+void Graphics::beginGPUTimerFrame()
+{
+	GPUTimerFrame *frame = getGPUTimerFrame();
+	if (frame == nullptr)
+		return;
+
+	*frame = GPUTimerFrame();
+
+	// The first timestamp marks the start of the frame.
+	writeGPUTimestamp();
+}
+
+void Graphics::endGPUTimerFrame()
+{
+	GPUTimerFrame *frame = getGPUTimerFrame();
+	if (frame == nullptr || frame->timestampCount == 0)
+		return;
+
+	flushBatchedDraws();
+
+	// Scopes left open end with the frame.
+	int timestamp = writeGPUTimestamp();
+	for (int index : frame->openScopes)
+		frame->scopes[index].endTimestamp = timestamp;
+	frame->openScopes.clear();
+
+	frame->frameEndTimestamp = timestamp;
+}
+
+void Graphics::resolveGPUTimerFrame(const GPUTimerFrame &frame, const std::vector<double> &timestamps)
+{
+	auto gettime = [&](int index) { return index >= 0 && index < (int) timestamps.size() ? timestamps[index] : -1.0; };
+
+	double framestart = gettime(0);
+	double frameend = gettime(frame.frameEndTimestamp);
+
+	if (framestart < 0.0 || frameend < framestart)
+		return;
+
+	gpuFrameTime = frameend - framestart;
+
+	gpuScopeTimes.clear();
+	for (const GPUTimerScope &scope : frame.scopes)
+	{
+		double begin = gettime(scope.beginTimestamp);
+		double end = gettime(scope.endTimestamp);
+		if (begin >= 0.0 && end >= begin)
+			gpuScopeTimes.push_back({scope.name, scope.depth, end - begin});
+	}
+}
+
 size_t Graphics::getStackDepth() const
 {
 	return stackTypeStack.size();
@@ -2894,6 +4369,9 @@ STRINGMAP_CLASS_BEGIN(Graphics, Graphics::Feature, Graphics::FEATURE_MAX_ENUM, f
 	{ "texelbuffer",              Graphics::FEATURE_TEXEL_BUFFER         },
 	{ "copytexturetobuffer",      Graphics::FEATURE_COPY_TEXTURE_TO_BUFFER },
 	{ "indirectdraw",             Graphics::FEATURE_INDIRECT_DRAW        },
+	{ "asynccompute",             Graphics::FEATURE_ASYNC_COMPUTE        },
+	{ "occlusionquery",           Graphics::FEATURE_OCCLUSION_QUERY      },
+	{ "backbuffercapture",        Graphics::FEATURE_BACKBUFFER_CAPTURE   },
 }
 STRINGMAP_CLASS_END(Graphics, Graphics::Feature, Graphics::FEATURE_MAX_ENUM, feature)
 
@@ -2922,6 +4400,30 @@ STRINGMAP_CLASS_BEGIN(Graphics, Graphics::StackType, Graphics::STACK_MAX_ENUM, s
 }
 STRINGMAP_CLASS_END(Graphics, Graphics::StackType, Graphics::STACK_MAX_ENUM, stackType)
 
+STRINGMAP_CLASS_BEGIN(Graphics, Graphics::LoadAction, Graphics::LOAD_ACTION_MAX_ENUM, loadAction)
+{
+	{ "load",     Graphics::LOAD_ACTION_LOAD     },
+	{ "clear",    Graphics::LOAD_ACTION_CLEAR    },
+	{ "dontcare", Graphics::LOAD_ACTION_DONTCARE },
+}
+STRINGMAP_CLASS_END(Graphics, Graphics::LoadAction, Graphics::LOAD_ACTION_MAX_ENUM, loadAction)
+
+STRINGMAP_CLASS_BEGIN(Graphics, Graphics::StoreAction, Graphics::STORE_ACTION_MAX_ENUM, storeAction)
+{
+	{ "store",   Graphics::STORE_ACTION_STORE   },
+	{ "discard", Graphics::STORE_ACTION_DISCARD },
+	{ "resolve", Graphics::STORE_ACTION_RESOLVE },
+}
+STRINGMAP_CLASS_END(Graphics, Graphics::StoreAction, Graphics::STORE_ACTION_MAX_ENUM, storeAction)
+
+STRINGMAP_CLASS_BEGIN(Graphics, Graphics::BatchSortMode, Graphics::BATCH_SORT_MAX_ENUM, batchSortMode)
+{
+	{ "none",   Graphics::BATCH_SORT_NONE   },
+	{ "safe",   Graphics::BATCH_SORT_SAFE   },
+	{ "always", Graphics::BATCH_SORT_ALWAYS }
+}
+STRINGMAP_CLASS_END(Graphics, Graphics::BatchSortMode, Graphics::BATCH_SORT_MAX_ENUM, batchSortMode)
+
 STRINGMAP_BEGIN(Renderer, RENDERER_MAX_ENUM, renderer)
 {
 	{ "opengl", RENDERER_OPENGL },
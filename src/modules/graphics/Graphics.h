@@ -38,6 +38,8 @@
 #include "Quad.h"
 #include "Mesh.h"
 #include "GraphicsReadback.h"
+#include "OcclusionQuery.h"
+#include "VirtualTexture.h"
 #include "Deprecations.h"
 #include "renderstate.h"
 #include "math/Transform.h"
@@ -59,6 +61,8 @@ namespace graphics
 class SpriteBatch;
 class ParticleSystem;
 class TextBatch;
+class ShapeBatch;
+class DrawList;
 class Video;
 class Buffer;
 
@@ -109,6 +113,14 @@ const std::vector<Renderer> &getDefaultRenderers();
 const std::vector<Renderer> &getRenderers();
 void setRenderers(const std::vector<Renderer> &renderers);
 
+/**
+ * The number of frames the CPU may record ahead of the GPU, for backends which
+ * manage this themselves (currently Vulkan). 2 gives lower latency, 3 more
+ * throughput. Must be set before the graphics module is created.
+ **/
+int getFramesInFlight();
+void setFramesInFlight(int frames);
+
 class Graphics : public Module
 {
 public:
@@ -160,6 +172,9 @@ public:
 		FEATURE_TEXEL_BUFFER,
 		FEATURE_COPY_TEXTURE_TO_BUFFER,
 		FEATURE_INDIRECT_DRAW,
+		FEATURE_ASYNC_COMPUTE,
+		FEATURE_OCCLUSION_QUERY,
+		FEATURE_BACKBUFFER_CAPTURE,
 		FEATURE_MAX_ENUM
 	};
 
@@ -194,6 +209,35 @@ public:
 		TEMPORARY_RT_STENCIL = (1 << 1),
 	};
 
+	// What happens to a render target's existing contents when a pass using
+	// it begins.
+	enum LoadAction
+	{
+		LOAD_ACTION_LOAD,
+		LOAD_ACTION_CLEAR,
+		LOAD_ACTION_DONTCARE,
+		LOAD_ACTION_MAX_ENUM
+	};
+
+	// What happens to a render target's contents when a pass using it ends.
+	// Resolve stores only the resolved contents of a MSAA render target, and
+	// is the same as store for other render targets.
+	enum StoreAction
+	{
+		STORE_ACTION_STORE,
+		STORE_ACTION_DISCARD,
+		STORE_ACTION_RESOLVE,
+		STORE_ACTION_MAX_ENUM
+	};
+
+	enum BatchSortMode
+	{
+		BATCH_SORT_NONE,
+		BATCH_SORT_SAFE,
+		BATCH_SORT_ALWAYS,
+		BATCH_SORT_MAX_ENUM
+	};
+
 	enum IndirectArgsType
 	{
 		INDIRECT_ARGS_DISPATCH,
@@ -216,6 +260,22 @@ public:
 		std::string device;
 	};
 
+	struct GPUScopeTime
+	{
+		std::string name;
+		int depth;
+		double seconds;
+	};
+
+	struct MemoryHeapStats
+	{
+		// Estimated bytes used by the program, and bytes it can use before
+		// the system starts evicting or failing allocations.
+		int64 usage;
+		int64 budget;
+		bool deviceLocal;
+	};
+
 	struct Stats
 	{
 		int drawCalls;
@@ -227,6 +287,22 @@ public:
 		int buffers;
 		int64 textureMemory;
 		int64 bufferMemory;
+		int64 streamBufferMemory;
+		int64 streamBufferUsed;
+		int streamBufferStalls;
+		// Backend framebuffer object cache. Hits and misses are per-frame.
+		int framebufferCacheSize;
+		int framebufferCacheHits;
+		int framebufferCacheMisses;
+		// GPU timings of the most recent frame whose results are available,
+		// usually 1-2 frames behind. Negative when unsupported.
+		double gpuFrameTime;
+		std::vector<GPUScopeTime> gpuScopes;
+		// CPU time the most recent present spent blocked in the OS or driver,
+		// e.g. waiting for vsync or a free swap chain image.
+		double presentTime;
+		// Per memory heap usage. Empty when the backend can't query it.
+		std::vector<MemoryHeapStats> memoryHeaps;
 	};
 
 	struct DrawCommand
@@ -243,6 +319,10 @@ public:
 		Buffer *indirectBuffer = nullptr;
 		size_t indirectBufferOffset = 0;
 
+		// Number of tightly packed argument entries read from the indirect
+		// buffer, each of which is a separate draw.
+		int indirectDrawCount = 1;
+
 		Texture *texture = nullptr;
 
 		// TODO: This should be moved out to a state transition API?
@@ -271,6 +351,10 @@ public:
 		Buffer *indirectBuffer = nullptr;
 		size_t indirectBufferOffset = 0;
 
+		// Number of tightly packed argument entries read from the indirect
+		// buffer, each of which is a separate draw.
+		int indirectDrawCount = 1;
+
 		Texture *texture = nullptr;
 
 		// TODO: This should be moved out to a state transition API?
@@ -304,6 +388,15 @@ public:
 		void *stream[2];
 	};
 
+	// Untextured 2D triangles collected from shape draws while a capture is
+	// active, instead of being sent to the batched draw buffers.
+	struct ShapeCapture
+	{
+		std::vector<Vector2> positions;
+		std::vector<STf_RGBAub> attributes;
+		std::vector<uint32> indices;
+	};
+
 	class TempTransform
 	{
 	public:
@@ -347,16 +440,25 @@ public:
 		int slice;
 		int mipmap;
 
-		RenderTarget(Texture *texture, int slice = 0, int mipmap = 0)
+		// Not part of the render target's identity. The load action is only
+		// applied when the render target is set, and isn't kept afterward.
+		LoadAction loadAction;
+		StoreAction storeAction;
+
+		RenderTarget(Texture *texture, int slice = 0, int mipmap = 0, StoreAction storeAction = STORE_ACTION_STORE)
 			: texture(texture)
 			, slice(slice)
 			, mipmap(mipmap)
+			, loadAction(LOAD_ACTION_LOAD)
+			, storeAction(storeAction)
 		{}
 
 		RenderTarget()
 			: texture(nullptr)
 			, slice(0)
 			, mipmap(0)
+			, loadAction(LOAD_ACTION_LOAD)
+			, storeAction(STORE_ACTION_STORE)
 		{}
 
 		bool operator != (const RenderTarget &other) const
@@ -375,11 +477,13 @@ public:
 		StrongRef<Texture> texture;
 		int slice = 0;
 		int mipmap = 0;
+		StoreAction storeAction = STORE_ACTION_STORE;
 
-		RenderTargetStrongRef(Texture *texture, int slice = 0, int mipmap = 0)
+		RenderTargetStrongRef(Texture *texture, int slice = 0, int mipmap = 0, StoreAction storeAction = STORE_ACTION_STORE)
 			: texture(texture)
 			, slice(slice)
 			, mipmap(mipmap)
+			, storeAction(storeAction)
 		{}
 
 		bool operator != (const RenderTargetStrongRef &other) const
@@ -445,6 +549,22 @@ public:
 		}
 	};
 
+	// One image packed by newAtlas. Exactly one of the two is set.
+	struct AtlasSource
+	{
+		love::image::ImageDataBase *imageData = nullptr;
+		Texture *texture = nullptr;
+	};
+
+	struct AtlasSettings
+	{
+		int padding = 1;
+		int maxSize = 0; // The texture size limit when 0.
+		bool linear = false;
+		bool mipmaps = false;
+		std::string debugName;
+	};
+
 	Graphics(const char *name);
 	virtual ~Graphics();
 
@@ -452,16 +572,37 @@ public:
 	virtual Texture *newTextureView(Texture *base, const Texture::ViewSettings &viewsettings) = 0;
 
 	Quad *newQuad(Quad::Viewport v, double sw, double sh);
+
+	/**
+	 * Packs the sources into a new render target texture. ImageData is
+	 * uploaded directly into its place and Textures are drawn into theirs,
+	 * so nothing is read back to the CPU. rects gets the pixel rectangle of
+	 * each source, in the same order.
+	 **/
+	Texture *newAtlas(const std::vector<AtlasSource> &sources, const AtlasSettings &settings, std::vector<Rect> &rects);
 	Font *newFont(love::font::Rasterizer *data);
 	Font *newDefaultFont(int size, const font::TrueTypeRasterizer::Settings &settings);
 	Video *newVideo(love::video::VideoStream *stream, float dpiscale);
 
-	SpriteBatch *newSpriteBatch(Texture *texture, int size, BufferDataUsage usage);
+	SpriteBatch *newSpriteBatch(Texture *texture, int size, BufferDataUsage usage, bool instanced = false);
 	ParticleSystem *newParticleSystem(Texture *texture, int size);
 
+	/**
+	 * Updates several ParticleSystems at once, spreading the work across
+	 * worker threads.
+	 **/
+	void updateParticleSystems(const std::vector<ParticleSystem *> &systems, float dt);
+
 	Shader *newShader(const std::vector<std::string> &stagessource, const Shader::CompileOptions &options);
 	Shader *newComputeShader(const std::string &source, const Shader::CompileOptions &options);
 
+	/**
+	 * Compiles one Shader for each feature mask, with the defines for the
+	 * features in the mask set. Every variant is compiled asynchronously where
+	 * supported, and goes through the shader cache when it's enabled.
+	 **/
+	ShaderVariants *newShaderVariants(const std::vector<std::string> &stagessource, const Shader::CompileOptions &options, const std::vector<std::string> &features, const std::vector<uint32> &masks);
+
 	virtual Buffer *newBuffer(const Buffer::Settings &settings, const std::vector<Buffer::DataDeclaration> &format, const void *data, size_t size, size_t arraylength) = 0;
 	virtual Buffer *newBuffer(const Buffer::Settings &settings, DataFormat format, const void *data, size_t size, size_t arraylength);
 
@@ -471,12 +612,38 @@ public:
 
 	TextBatch *newTextBatch(Font *font, const std::vector<love::font::ColoredString> &text = {});
 
+	ShapeBatch *newShapeBatch();
+	DrawList *newDrawList();
+
 	data::ByteData *readbackBuffer(Buffer *buffer, size_t offset, size_t size, data::ByteData *dest, size_t destoffset);
 	GraphicsReadback *readbackBufferAsync(Buffer *buffer, size_t offset, size_t size, data::ByteData *dest, size_t destoffset);
 
 	image::ImageData *readbackTexture(Texture *texture, int slice, int mipmap, const Rect &rect, image::ImageData *dest, int destx, int desty);
 	GraphicsReadback *readbackTextureAsync(Texture *texture, int slice, int mipmap, const Rect &rect, image::ImageData *dest, int destx, int desty);
 
+	ReadbackRing *newReadbackRing(int size);
+
+	/**
+	 * Stages the pixels in a temporary Buffer and queues a GPU copy into the
+	 * Texture, instead of uploading synchronously. The returned object tracks
+	 * when the staging memory is released. Backends which can upload from
+	 * another thread do that instead.
+	 **/
+	virtual TextureUpload *replacePixelsAsync(Texture *texture, love::image::ImageDataBase *data, int slice, int mipmap, int x, int y, bool reloadmipmaps);
+
+	/**
+	 * Creates a 2D Texture and uploads the ImageData to it asynchronously.
+	 * The returned object holds the new Texture.
+	 **/
+	virtual TextureUpload *newTextureAsync(const Texture::Settings &settings, love::image::ImageData *data);
+
+	/**
+	 * Creates a Buffer whose initial data is uploaded asynchronously where the
+	 * backend supports it. The Data must not be modified until the upload is
+	 * complete. The returned object holds the new Buffer.
+	 **/
+	virtual BufferUpload *newBufferAsync(const Buffer::Settings &settings, const std::vector<Buffer::DataDeclaration> &format, Data *data, size_t arraylength);
+
 	bool validateShader(bool gles, const std::vector<std::string> &stages, const Shader::CompileOptions &options, std::string &err);
 
 	Texture *getDefaultTexture(TextureType type, DataBaseType dataType, bool depthSample);
@@ -606,6 +773,17 @@ public:
 	 */
 	bool getScissor(Rect &rect) const;
 
+	/**
+	 * Intersects the clip region with a rectangle in the current coordinate
+	 * system, until the matching popClip. The scissor box is used when the
+	 * current transform keeps the rectangle axis-aligned, and the stencil
+	 * buffer is only used for rotated or skewed rectangles.
+	 * @return Whether the stencil buffer was used for this clip rectangle.
+	 **/
+	bool pushClip(float x, float y, float w, float h);
+	void popClip();
+	int getClipDepth() const;
+
 	void setStencilMode(StencilMode mode, int value);
 	void setStencilMode();
 	StencilMode getStencilMode(int &value) const;
@@ -679,6 +857,87 @@ public:
 	void setLineJoin(LineJoin style);
 	LineJoin getLineJoin() const;
 
+	/**
+	 * Sets whether batched draws are recorded and reordered by their sort key
+	 * before being submitted, so draws which share a texture and shader can be
+	 * merged even when they aren't consecutive. BATCH_SORT_SAFE only reorders
+	 * when the active blend, depth and stencil states make the result
+	 * independent of draw order, BATCH_SORT_ALWAYS reorders unconditionally.
+	 **/
+	void setBatchSortMode(BatchSortMode mode);
+	BatchSortMode getBatchSortMode() const;
+
+	/**
+	 * Sets whether frequently drawn 2D textures are automatically copied into
+	 * layers of shared array textures, so that draws using different textures
+	 * with the same size, format and sampler state can be batched together.
+	 **/
+	void setTextureArrayBatching(bool enable);
+	bool isTextureArrayBatching() const;
+
+	/**
+	 * Sets whether compute dispatches run on a separate compute queue, where
+	 * they can overlap with rendering. Their results are only guaranteed to
+	 * be visible to rendering two frames later, and resources they write
+	 * must not be used by rendering in the meantime (i.e. double buffer
+	 * them). Has no effect unless the asynccompute feature is supported.
+	 **/
+	void setAsyncCompute(bool enable);
+	bool isAsyncCompute() const;
+
+	/**
+	 * Named GPU timestamp scopes, which can be nested. Their durations are
+	 * returned by getStats once the GPU has finished the frame.
+	 **/
+	void beginGPUScope(const std::string &name);
+	void endGPUScope();
+
+	/**
+	 * Occlusion queries count the samples drawn between begin and end, which
+	 * pass the depth and stencil tests. Results arrive asynchronously, and
+	 * only one query can be active at a time.
+	 **/
+	OcclusionQuery *newOcclusionQuery();
+	void beginOcclusionQuery(OcclusionQuery *query);
+	void endOcclusionQuery();
+	OcclusionQuery *getActiveOcclusionQuery() const;
+
+	// Collects the results of occlusion queries the GPU has finished.
+	virtual void updateOcclusionQueries() {}
+
+	StreamingTexture *newStreamingTexture(love::image::CompressedImageData *data, const Texture::Settings &settings);
+
+	/**
+	 * Sets the maximum number of bytes all StreamingTextures may use together.
+	 * The most detailed mipmaps of the least recently drawn textures are
+	 * dropped when it's exceeded. A budget of 0 means no limit.
+	 **/
+	void setTextureStreamingBudget(int64 bytes);
+	int64 getTextureStreamingBudget() const;
+	int64 getStreamingTextureMemory() const;
+
+	void addStreamingTexture(StreamingTexture *texture);
+	void removeStreamingTexture(StreamingTexture *texture);
+
+	VirtualTexture *newVirtualTexture(int width, int height, const VirtualTexture::Settings &settings);
+
+	void addVirtualTexture(VirtualTexture *texture);
+	void removeVirtualTexture(VirtualTexture *texture);
+
+	/**
+	 * Gets the array texture and layer to draw in place of the given texture.
+	 * Returns false if the texture should be drawn directly.
+	 **/
+	bool getTextureArrayBatchLayer(Texture *texture, Texture *&arraytexture, int &layer);
+	void removeFromTextureArrayBatch(Texture *texture);
+
+	/**
+	 * Sets whether compiled shader programs are stored in the save directory
+	 * and reused by later runs, when the active backend supports it.
+	 **/
+	void setShaderCacheEnabled(bool enable);
+	bool isShaderCacheEnabled() const;
+
 	/**
 	 * Sets the size of points.
 	 **/
@@ -704,6 +963,14 @@ public:
 
 	void captureScreenshot(const ScreenshotInfo &info);
 
+	/**
+	 * Copies the backbuffer into a render target Texture of the same size on
+	 * the GPU, when it's next presented. Unlike captureScreenshot this doesn't
+	 * wait for the GPU, so the Texture can be read back with
+	 * readbackTextureAsync after present to capture frames without stalling.
+	 **/
+	void captureBackbuffer(Texture *dest);
+
 	void copyBuffer(Buffer *source, Buffer *dest, size_t sourceoffset, size_t destoffset, size_t size);
 	void copyTextureToBuffer(Texture *source, Buffer *dest, int slice, int mipmap, const Rect &rect, size_t destoffset, int destwidth);
 	void copyBufferToTexture(Buffer *source, Texture *dest, size_t sourceoffset, int sourcewidth, int slice, int mipmap, const Rect &rect);
@@ -716,12 +983,12 @@ public:
 	void drawLayer(Texture *texture, int layer, const Matrix4 &m);
 	void drawLayer(Texture *texture, int layer, Quad *quad, const Matrix4 &m);
 	void drawInstanced(Mesh *mesh, const Matrix4 &m, int instancecount);
-	void drawIndirect(Mesh *mesh, const Matrix4 &m, Buffer *indirectargs, int argsindex);
+	void drawIndirect(Mesh *mesh, const Matrix4 &m, Buffer *indirectargs, int argsindex, int drawcount = 1);
 
 	void drawFromShader(PrimitiveType primtype, int vertexcount, int instancecount, Texture *maintexture);
 	void drawFromShader(Buffer *indexbuffer, int indexcount, int instancecount, int startindex, Texture *maintexture);
-	void drawFromShaderIndirect(PrimitiveType primtype, Buffer *indirectargs, int argsindex, Texture *maintexture);
-	void drawFromShaderIndirect(Buffer *indexbuffer, Buffer *indirectargs, int argsindex, Texture *maintexture);
+	void drawFromShaderIndirect(PrimitiveType primtype, Buffer *indirectargs, int argsindex, Texture *maintexture, int drawcount = 1);
+	void drawFromShaderIndirect(Buffer *indexbuffer, Buffer *indirectargs, int argsindex, Texture *maintexture, int drawcount = 1);
 
 	/**
 	 * Draws text at the specified coordinates
@@ -747,6 +1014,17 @@ public:
 	 **/
 	void polyline(const Vector2 *vertices, size_t count);
 
+	/**
+	 * Draws a series of lines connecting points stored in the first member of
+	 * a vertex Buffer, which must be a floatvec2. The line is expanded into
+	 * triangles by the vertex shader instead of on the CPU, using miter joins
+	 * and the current line width and style.
+	 * @param points Buffer containing the vertex positions.
+	 * @param start Index of the first point in the Buffer.
+	 * @param count Number of points to draw, at least 2.
+	 **/
+	void drawLines(Buffer *points, int start, int count, const Matrix4 &m);
+
 	/**
 	 * Draws a rectangle.
 	 * @param x Position along x-axis for top-left corner.
@@ -853,6 +1131,21 @@ public:
 	 **/
 	Stats getStats() const;
 
+	/**
+	 * Returns the total time in seconds spent compiling the standard shaders,
+	 * which happens when the window is first created.
+	 **/
+	double getDefaultShaderCompileTime() const { return defaultShaderCompileTime; }
+
+	/**
+	 * Moves allocations around in GPU memory to reclaim fragmented space.
+	 * Each call does one pass which moves at most maxbytes (0 means no
+	 * limit), and stalls until the GPU has finished all submitted work, so
+	 * it's meant to be called during loading screens. Returns true when
+	 * there's nothing left to move.
+	 **/
+	virtual bool defragmentMemory(int64 maxbytes, int64 &bytesmoved);
+
 	size_t getStackDepth() const;
 	void push(StackType type = STACK_TRANSFORM);
 	void pop();
@@ -882,17 +1175,45 @@ public:
 	void flushBatchedDraws();
 	BatchedVertexData requestBatchedDraw(const BatchedDrawCommand &command);
 
+	/**
+	 * Redirects subsequent shape draws into the given capture rather than the
+	 * batched draw buffers, until endShapeCapture is called.
+	 **/
+	void beginShapeCapture(ShapeCapture *capture);
+	void endShapeCapture();
+
+	/**
+	 * Records subsequent draws into the given DrawList instead of drawing
+	 * them, until endDrawList is called. Draws are recorded relative to the
+	 * transform that was active when recording began.
+	 **/
+	void beginDrawList(DrawList *list);
+	void endDrawList();
+	DrawList *getRecordingDrawList() const;
+
 	static void flushBatchedDrawsGlobal();
 
-	Texture *getTemporaryTexture(PixelFormat format, int w, int h, int samples);
+	/**
+	 * Gets a render target texture from the temporary texture pool. Released
+	 * textures are handed out again by later calls, so textures whose uses
+	 * don't overlap share memory. Frame-scoped textures are also returned to
+	 * the pool automatically when the frame is presented.
+	 **/
+	Texture *getTemporaryTexture(PixelFormat format, int w, int h, int samples, bool memoryless = false, bool framescoped = false);
 	void releaseTemporaryTexture(Texture *texture);
 
 	Buffer *getTemporaryBuffer(size_t size, DataFormat format, uint32 usageflags, BufferDataUsage datausage);
 	void releaseTemporaryBuffer(Buffer *buffer);
 
+	/**
+	 * Releases pooled temporary textures and buffers which aren't currently
+	 * in use, e.g. when GPU memory is running low.
+	 **/
+	void purgeUnusedTemporaryResources();
+
 	void cleanupCachedShaderStage(ShaderStageType type, const std::string &cachekey);
 
-	void validateIndirectArgsBuffer(IndirectArgsType argstype, Buffer *indirectargs, int argsindex);
+	void validateIndirectArgsBuffer(IndirectArgsType argstype, Buffer *indirectargs, int argsindex, int drawcount = 1);
 
 	template <typename T>
 	T *getScratchBuffer(size_t count)
@@ -914,6 +1235,9 @@ public:
 	STRINGMAP_CLASS_DECLARE(Feature);
 	STRINGMAP_CLASS_DECLARE(SystemLimit);
 	STRINGMAP_CLASS_DECLARE(StackType);
+	STRINGMAP_CLASS_DECLARE(LoadAction);
+	STRINGMAP_CLASS_DECLARE(StoreAction);
+	STRINGMAP_CLASS_DECLARE(BatchSortMode);
 
 protected:
 
@@ -930,6 +1254,8 @@ protected:
 		LineStyle lineStyle = LINE_SMOOTH;
 		LineJoin lineJoin = LINE_JOIN_MITER;
 
+		BatchSortMode batchSortMode = BATCH_SORT_NONE;
+
 		float pointSize = 1.0f;
 
 		bool scissor = false;
@@ -959,6 +1285,26 @@ protected:
 		SamplerState defaultSamplerState = SamplerState();
 	};
 
+	struct ClipState
+	{
+		bool stencil = false;
+
+		// Rectangle and transform used to undo a stencil clip.
+		float x = 0.0f, y = 0.0f, w = 0.0f, h = 0.0f;
+		Matrix4 transform;
+
+		bool hadScissor = false;
+		Rect scissorRect = Rect();
+		StencilState stencilState;
+	};
+
+	struct DeferredBatchedDraw
+	{
+		uint64 sortKey;
+		BatchedDrawCommand command;
+		size_t dataOffsets[2];
+	};
+
 	struct BatchedDrawState
 	{
 		StreamBuffer *vb[2];
@@ -976,6 +1322,13 @@ protected:
 
 		bool flushing = false;
 
+		// Draws recorded while a batch sort mode is active. Their vertex data
+		// lives in deferredVertexData until they're sorted and submitted.
+		std::vector<DeferredBatchedDraw> deferredDraws;
+		std::vector<StrongRef<Texture>> deferredTextures;
+		std::vector<uint8> deferredVertexData;
+		bool submittingDeferred = false;
+
 		BatchedDrawState()
 		{
 			vb[0] = vb[1] = nullptr;
@@ -997,14 +1350,23 @@ protected:
 		{}
 	};
 
+	struct TextureArrayBatchPage
+	{
+		StrongRef<Texture> texture;
+		uint64 samplerKey;
+		std::vector<Texture *> layers;
+	};
+
 	struct TemporaryTexture
 	{
 		Texture *texture;
 		int framesSinceUse;
+		bool frameScoped;
 
-		TemporaryTexture(Texture *tex)
+		TemporaryTexture(Texture *tex, bool framescoped)
 			: texture(tex)
 			, framesSinceUse(-1)
+			, frameScoped(framescoped)
 		{}
 	};
 
@@ -1022,7 +1384,41 @@ protected:
 	virtual void setRenderTargetsInternal(const RenderTargets &rts, int pixelw, int pixelh, bool hasSRGBtexture) = 0;
 
 	virtual void initCapabilities() = 0;
-	virtual void getAPIStats(int &shaderswitches) const = 0;
+	virtual void getAPIStats(Stats &stats) const = 0;
+
+	struct GPUTimerScope
+	{
+		std::string name;
+		int depth;
+		int beginTimestamp;
+		int endTimestamp;
+	};
+
+	// The timestamps written during a single frame. Backends keep one for
+	// each frame which can be in flight.
+	struct GPUTimerFrame
+	{
+		std::vector<GPUTimerScope> scopes;
+		std::vector<int> openScopes;
+		int timestampCount = 0;
+		int frameEndTimestamp = -1;
+	};
+
+	// Returns null when GPU timestamps aren't supported.
+	virtual GPUTimerFrame *getGPUTimerFrame() { return nullptr; }
+
+	// Records a GPU timestamp in the current frame. Returns its index in the
+	// frame, or -1 if it couldn't be written.
+	virtual int writeGPUTimestamp() { return -1; }
+
+	void beginGPUTimerFrame();
+	void endGPUTimerFrame();
+
+	// Called after the active occlusion query changes, with batched draws
+	// already flushed.
+	virtual void beginOcclusionQueryInternal(OcclusionQuery */*query*/) {}
+	virtual void endOcclusionQueryInternal(OcclusionQuery */*query*/) {}
+	void resolveGPUTimerFrame(const GPUTimerFrame &frame, const std::vector<double> &timestamps);
 
 	void createQuadIndexBuffer();
 	void createFanIndexBuffer();
@@ -1031,10 +1427,22 @@ protected:
 	void clearTemporaryResources();
 
 	void updatePendingReadbacks();
+	void updatePendingUploads();
+	void updateStreamingTextures();
+	void updateVirtualTextures();
+
+	bool isTextureArrayBatchable(Texture *texture) const;
+	bool addToTextureArrayBatch(Texture *texture);
+	void releaseTextureArrayBatches();
 
 	void releaseDefaultResources();
 
+	bool isBatchReorderSafe() const;
+	BatchedVertexData requestDeferredBatchedDraw(const BatchedDrawCommand &command);
+	void submitDeferredBatchedDraws();
+
 	void validateStencilState(const StencilState &s) const;
+	void drawClipStencil(const ClipState &clip, StencilAction action, int value);
 	void validateDepthState(bool depthwrite) const;
 
 	void restoreState(const DisplayState &s);
@@ -1060,7 +1468,9 @@ protected:
 	StrongRef<love::graphics::Font> defaultFont;
 
 	std::vector<ScreenshotInfo> pendingScreenshotCallbacks;
+	std::vector<StrongRef<Texture>> pendingBackbufferCaptures;
 	std::vector<StrongRef<GraphicsReadback>> pendingReadbacks;
+	std::vector<StrongRef<TextureUpload>> pendingUploads;
 
 	BatchedDrawState batchedDrawState;
 
@@ -1072,34 +1482,66 @@ protected:
 	std::vector<DisplayState> states;
 	std::vector<StackType> stackTypeStack;
 
+	std::vector<ClipState> clipStack;
+
+	StrongRef<OcclusionQuery> activeOcclusionQuery;
+	int stencilClipDepth;
+
 	std::vector<TemporaryBuffer> temporaryBuffers;
 	std::vector<TemporaryTexture> temporaryTextures;
 
+	bool textureArrayBatching;
+	bool asyncCompute;
+	std::vector<TextureArrayBatchPage> textureArrayBatchPages;
+
+	std::vector<StreamingTexture *> streamingTextures;
+	std::vector<VirtualTexture *> virtualTextures;
+
+	double gpuFrameTime;
+	std::vector<GPUScopeTime> gpuScopeTimes;
+	double presentTime;
+	double defaultShaderCompileTime;
+	int64 textureStreamingBudget;
+
+	bool shaderCacheEnabled;
+
 	int renderTargetSwitchCount;
 	int drawCalls;
 	int drawCallsBatched;
 
 	Buffer *quadIndexBuffer;
 	Buffer *fanIndexBuffer;
+	Buffer *lineQuadBuffer;
 
 	Capabilities capabilities;
 
 	Deprecations deprecations;
 
 	static const size_t MAX_USER_STACK_DEPTH = 128;
+	static const int MAX_STENCIL_CLIP_DEPTH = 255;
 	static const int MAX_TEMPORARY_RESOURCE_UNUSED_FRAMES = 16;
 
+	static const int TEXTURE_ARRAY_BATCH_MIN_DRAWS = 8;
+	static const int TEXTURE_ARRAY_BATCH_LAYERS = 16;
+	static const int TEXTURE_ARRAY_BATCH_MAX_SIZE = 1024;
+
 private:
 
 	void checkSetDefaultFont();
 	int calculateEllipsePoints(float rx, float ry) const;
 
+	static bool isSameRenderPass(const RenderTarget &rt, const RenderTargetStrongRef &prev);
+	void applyLoadActions(const RenderTargets &rts);
+
 	Texture *defaultTextures[TEXTURE_MAX_ENUM][DATA_BASETYPE_MAX_ENUM][2];
 	Buffer *defaultTexelBuffers[DATA_BASETYPE_MAX_ENUM];
 	Buffer *defaultStorageBuffer;
 
 	std::vector<uint8> scratchBuffer;
 
+	ShapeCapture *shapeCapture;
+	DrawList *recordingDrawList;
+
 	std::unordered_map<std::string, ShaderStage *> cachedShaderStages[SHADERSTAGE_MAX_ENUM];
 
 }; // Graphics
@@ -26,12 +26,16 @@
 #include "image/ImageData.h"
 #include "image/Image.h"
 
+// C++
+#include <algorithm>
+
 namespace love
 {
 namespace graphics
 {
 
 love::Type GraphicsReadback::type("GraphicsReadback", &Object::type);
+love::Type ReadbackRing::type("ReadbackRing", &Object::type);
 
 GraphicsReadback::GraphicsReadback(Graphics */*gfx*/, ReadbackMethod method, Buffer *buffer, size_t offset, size_t size, love::data::ByteData *dest, size_t destoffset)
 	: dataType(DATA_BUFFER)
@@ -221,5 +225,103 @@ GraphicsReadback::Status GraphicsReadback::readbackBuffer(Buffer *buffer, size_t
 	return success ? STATUS_COMPLETE : STATUS_ERROR;
 }
 
+ReadbackRing::ReadbackRing(int size)
+	: slots(std::max(size, 1))
+	, next(0)
+{
+}
+
+ReadbackRing::~ReadbackRing()
+{
+}
+
+ReadbackRing::Slot *ReadbackRing::getFreeSlot()
+{
+	// Readbacks complete in submission order, so the next slot in the ring
+	// always holds the oldest one.
+	Slot &slot = slots[next];
+	if (slot.readback.get() && (!slot.readback->isComplete() || !slot.polled))
+		return nullptr;
+
+	next = (next + 1) % slots.size();
+	return &slot;
+}
+
+GraphicsReadback *ReadbackRing::readbackBuffer(Graphics *gfx, Buffer *buffer, size_t offset, size_t size)
+{
+	Slot *slot = getFreeSlot();
+	if (slot == nullptr)
+		return nullptr;
+
+	if (slot->bufferData.get() == nullptr || slot->bufferData->getSize() != size)
+		slot->bufferData.set(new love::data::ByteData(size, false), Acquire::NORETAIN);
+
+	slot->readback.set(gfx->readbackBufferAsync(buffer, offset, size, slot->bufferData, 0), Acquire::NORETAIN);
+	slot->polled = false;
+
+	return slot->readback;
+}
+
+GraphicsReadback *ReadbackRing::readbackTexture(Graphics *gfx, Texture *texture, int slice, int mipmap, const Rect &rect)
+{
+	Slot *slot = getFreeSlot();
+	if (slot == nullptr)
+		return nullptr;
+
+	PixelFormat format = getLinearPixelFormat(texture->getPixelFormat());
+
+	StrongRef<love::image::ImageData> &dest = slot->imageData;
+	if (dest.get() == nullptr || dest->getWidth() != rect.w || dest->getHeight() != rect.h || dest->getFormat() != format)
+	{
+		auto module = Module::getInstance<image::Image>(Module::M_IMAGE);
+		if (module == nullptr)
+			throw love::Exception("The love.image module must be loaded for readbackTexture.");
+
+		if (!image::ImageData::validPixelFormat(format))
+		{
+			const char *formatname = "unknown";
+			love::getConstant(format, formatname);
+			throw love::Exception("ImageData with the '%s' pixel format is not supported.", formatname);
+		}
+
+		dest.set(module->newImageData(rect.w, rect.h, format, nullptr), Acquire::NORETAIN);
+	}
+
+	dest->setLinear(isGammaCorrect() && !isPixelFormatSRGB(texture->getPixelFormat()));
+
+	slot->readback.set(gfx->readbackTextureAsync(texture, slice, mipmap, rect, dest, 0, 0), Acquire::NORETAIN);
+	slot->polled = false;
+
+	return slot->readback;
+}
+
+void ReadbackRing::poll(std::vector<GraphicsReadback *> &completed)
+{
+	for (size_t i = 0; i < slots.size(); i++)
+	{
+		Slot &slot = slots[(next + i) % slots.size()];
+		if (slot.readback.get() == nullptr || slot.polled)
+			continue;
+
+		slot.readback->update();
+		if (!slot.readback->isComplete())
+			break;
+
+		slot.polled = true;
+		completed.push_back(slot.readback);
+	}
+}
+
+int ReadbackRing::getPendingCount() const
+{
+	int count = 0;
+	for (const Slot &slot : slots)
+	{
+		if (slot.readback.get() && !slot.readback->isComplete())
+			count++;
+	}
+	return count;
+}
+
 } // graphics
 } // love
@@ -28,6 +28,9 @@
 #include "common/StringMap.h"
 #include "common/pixelformat.h"
 
+// C++
+#include <vector>
+
 namespace love::image
 {
 class ImageData;
@@ -109,5 +112,47 @@ protected:
 
 }; // GraphicsReadback
 
+/**
+ * A fixed number of reusable async readback slots, for continuous readbacks
+ * such as GPU picking or video capture. Destination Data objects are recycled
+ * between requests so no new memory is allocated once the ring is warm.
+ * The Data of a completed readback is overwritten when its slot is reused.
+ **/
+class ReadbackRing : public love::Object
+{
+public:
+
+	static love::Type type;
+
+	ReadbackRing(int size);
+	virtual ~ReadbackRing();
+
+	// These return null without blocking when every slot is still in use.
+	GraphicsReadback *readbackBuffer(Graphics *gfx, Buffer *buffer, size_t offset, size_t size);
+	GraphicsReadback *readbackTexture(Graphics *gfx, Texture *texture, int slice, int mipmap, const Rect &rect);
+
+	// Gets the readbacks which completed since the last poll, oldest first.
+	void poll(std::vector<GraphicsReadback *> &completed);
+
+	int getSize() const { return (int) slots.size(); }
+	int getPendingCount() const;
+
+private:
+
+	struct Slot
+	{
+		StrongRef<GraphicsReadback> readback;
+		StrongRef<love::data::ByteData> bufferData;
+		StrongRef<love::image::ImageData> imageData;
+		bool polled = true;
+	};
+
+	Slot *getFreeSlot();
+
+	std::vector<Slot> slots;
+	size_t next;
+
+}; // ReadbackRing
+
 } // graphics
 } // love
@@ -27,7 +27,10 @@
 
 // C++
 #include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <limits>
+#include <unordered_map>
 
 namespace love
 {
@@ -282,7 +285,10 @@ void *Mesh::getVertexData() const
 void Mesh::setVertexDataModified(size_t offset, size_t size)
 {
 	if (vertexData != nullptr)
+	{
 		modifiedVertexData.encapsulate(offset, size);
+		positionBoundsValid = false;
+	}
 }
 
 void Mesh::flush()
@@ -487,6 +493,532 @@ size_t Mesh::getIndexCount() const
 	return indexCount;
 }
 
+// Size of the simulated post-transform vertex cache used by optimize().
+static const int OPTIMIZE_CACHE_SIZE = 32;
+
+// Most GPUs reuse vertices from roughly this many recent ones. Used to find
+// the points where reordering triangle clusters won't cost extra cache misses.
+static const int OVERDRAW_CACHE_SIZE = 16;
+
+static uint64 hashVertex(const uint8 *vertex, const std::vector<Buffer::DataMember> &members)
+{
+	// FNV-1a over the bytes of each member, skipping any padding.
+	uint64 hash = 14695981039346656037ULL;
+	for (const auto &member : members)
+	{
+		for (size_t i = 0; i < member.size; i++)
+			hash = (hash ^ vertex[member.offset + i]) * 1099511628211ULL;
+	}
+	return hash;
+}
+
+static bool isVertexEqual(const uint8 *a, const uint8 *b, const std::vector<Buffer::DataMember> &members)
+{
+	for (const auto &member : members)
+	{
+		if (memcmp(a + member.offset, b + member.offset, member.size) != 0)
+			return false;
+	}
+	return true;
+}
+
+/**
+ * Vertex score from Tom Forsyth's "Linear-Speed Vertex Cache Optimisation".
+ **/
+static float getVertexCacheScore(int cachepos, uint32 remainingtris)
+{
+	if (remainingtris == 0)
+		return -1.0f;
+
+	float score = 0.0f;
+
+	if (cachepos >= 3)
+		score = powf(1.0f - (float) (cachepos - 3) / (float) (OPTIMIZE_CACHE_SIZE - 3), 1.5f);
+	else if (cachepos >= 0)
+		score = 0.75f; // The last triangle's vertices.
+
+	// Favor vertices with few triangles left, to avoid leaving lone triangles.
+	return score + 2.0f * powf((float) remainingtris, -0.5f);
+}
+
+static void optimizeVertexCache(std::vector<uint32> &indices, size_t vertexcount)
+{
+	size_t tricount = indices.size() / 3;
+	if (tricount == 0)
+		return;
+
+	std::vector<uint32> remaining(vertexcount, 0);
+	for (uint32 index : indices)
+		remaining[index]++;
+
+	// Triangles using each vertex. The first remaining[v] entries of each
+	// vertex's list are the triangles which haven't been emitted yet.
+	std::vector<uint32> adjacencyoffsets(vertexcount + 1, 0);
+	for (size_t v = 0; v < vertexcount; v++)
+		adjacencyoffsets[v + 1] = adjacencyoffsets[v] + remaining[v];
+
+	std::vector<uint32> adjacency(indices.size());
+	std::vector<uint32> fillpos(adjacencyoffsets.begin(), adjacencyoffsets.end() - 1);
+	for (size_t i = 0; i < indices.size(); i++)
+		adjacency[fillpos[indices[i]]++] = (uint32) (i / 3);
+
+	std::vector<int> cachepos(vertexcount, -1);
+	std::vector<float> vertexscores(vertexcount);
+	for (size_t v = 0; v < vertexcount; v++)
+		vertexscores[v] = getVertexCacheScore(-1, remaining[v]);
+
+	std::vector<float> triscores(tricount);
+	std::vector<bool> emitted(tricount, false);
+
+	size_t besttri = 0;
+	for (size_t t = 0; t < tricount; t++)
+	{
+		const uint32 *tri = &indices[t * 3];
+		triscores[t] = vertexscores[tri[0]] + vertexscores[tri[1]] + vertexscores[tri[2]];
+		if (triscores[t] > triscores[besttri])
+			besttri = t;
+	}
+
+	std::vector<uint32> result;
+	result.reserve(indices.size());
+
+	std::vector<uint32> cache;
+	std::vector<uint32> newcache;
+	cache.reserve(OPTIMIZE_CACHE_SIZE + 3);
+	newcache.reserve(OPTIMIZE_CACHE_SIZE + 3);
+
+	size_t nextunemitted = 0;
+
+	for (size_t n = 0; n < tricount; n++)
+	{
+		if (besttri == std::numeric_limits<size_t>::max())
+		{
+			// Nothing in the cache has triangles left, so start over from the
+			// next triangle in the original order.
+			while (emitted[nextunemitted])
+				nextunemitted++;
+			besttri = nextunemitted;
+		}
+
+		const uint32 *tri = &indices[besttri * 3];
+		result.insert(result.end(), tri, tri + 3);
+		emitted[besttri] = true;
+
+		newcache.assign(tri, tri + 3);
+		for (uint32 v : cache)
+		{
+			if (v != tri[0] && v != tri[1] && v != tri[2])
+				newcache.push_back(v);
+		}
+
+		for (int i = 0; i < 3; i++)
+		{
+			uint32 v = tri[i];
+			uint32 *list = &adjacency[adjacencyoffsets[v]];
+			for (uint32 j = 0; j < remaining[v]; j++)
+			{
+				if (list[j] == (uint32) besttri)
+				{
+					std::swap(list[j], list[remaining[v] - 1]);
+					break;
+				}
+			}
+			remaining[v]--;
+		}
+
+		// Update the scores of every vertex whose cache position changed, and
+		// the triangles which use them.
+		for (size_t i = 0; i < newcache.size(); i++)
+		{
+			uint32 v = newcache[i];
+			int pos = (int) i < OPTIMIZE_CACHE_SIZE ? (int) i : -1;
+			cachepos[v] = pos;
+
+			float score = getVertexCacheScore(pos, remaining[v]);
+			float delta = score - vertexscores[v];
+			vertexscores[v] = score;
+
+			const uint32 *list = &adjacency[adjacencyoffsets[v]];
+			for (uint32 j = 0; j < remaining[v]; j++)
+				triscores[list[j]] += delta;
+		}
+
+		if ((int) newcache.size() > OPTIMIZE_CACHE_SIZE)
+			newcache.resize(OPTIMIZE_CACHE_SIZE);
+
+		std::swap(cache, newcache);
+
+		besttri = std::numeric_limits<size_t>::max();
+		float bestscore = -std::numeric_limits<float>::max();
+
+		for (uint32 v : cache)
+		{
+			const uint32 *list = &adjacency[adjacencyoffsets[v]];
+			for (uint32 j = 0; j < remaining[v]; j++)
+			{
+				if (triscores[list[j]] > bestscore)
+				{
+					bestscore = triscores[list[j]];
+					besttri = list[j];
+				}
+			}
+		}
+	}
+
+	indices = std::move(result);
+}
+
+/**
+ * Based on the overdraw optimizer in meshoptimizer: the triangles are split
+ * into clusters at the points where the vertex cache starts over, and the
+ * clusters which face away from the center of the mesh are drawn first, since
+ * they're more likely to occlude the rest.
+ **/
+static void optimizeOverdraw(std::vector<uint32> &indices, const std::vector<float> &positions)
+{
+	size_t tricount = indices.size() / 3;
+	if (tricount == 0)
+		return;
+
+	size_t vertexcount = positions.size() / 3;
+
+	std::vector<size_t> clusters;
+	std::vector<int64> timestamps(vertexcount, std::numeric_limits<int64>::min() / 2);
+	int64 time = OVERDRAW_CACHE_SIZE;
+
+	for (size_t t = 0; t < tricount; t++)
+	{
+		int misses = 0;
+		for (int i = 0; i < 3; i++)
+		{
+			uint32 v = indices[t * 3 + i];
+			if (time - timestamps[v] > OVERDRAW_CACHE_SIZE)
+			{
+				timestamps[v] = time++;
+				misses++;
+			}
+		}
+
+		if (t == 0 || misses == 3)
+			clusters.push_back(t);
+	}
+
+	float meshcenter[3] = {0.0f, 0.0f, 0.0f};
+	float meshweight = 0.0f;
+
+	std::vector<float> clustercenters(clusters.size() * 3, 0.0f);
+	std::vector<float> clusternormals(clusters.size() * 3, 0.0f);
+
+	for (size_t c = 0; c < clusters.size(); c++)
+	{
+		size_t end = c + 1 < clusters.size() ? clusters[c + 1] : tricount;
+		float weight = 0.0f;
+
+		for (size_t t = clusters[c]; t < end; t++)
+		{
+			const float *p0 = &positions[indices[t * 3 + 0] * 3];
+			const float *p1 = &positions[indices[t * 3 + 1] * 3];
+			const float *p2 = &positions[indices[t * 3 + 2] * 3];
+
+			float e1[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+			float e2[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+			float n[3] = {e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0]};
+			float area = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+
+			for (int i = 0; i < 3; i++)
+			{
+				float center = (p0[i] + p1[i] + p2[i]) / 3.0f;
+				clustercenters[c * 3 + i] += center * area;
+				clusternormals[c * 3 + i] += n[i];
+				meshcenter[i] += center * area;
+			}
+
+			weight += area;
+		}
+
+		if (weight > 0.0f)
+		{
+			for (int i = 0; i < 3; i++)
+				clustercenters[c * 3 + i] /= weight;
+		}
+
+		meshweight += weight;
+	}
+
+	if (meshweight > 0.0f)
+	{
+		for (int i = 0; i < 3; i++)
+			meshcenter[i] /= meshweight;
+	}
+
+	std::vector<float> sortkeys(clusters.size());
+	for (size_t c = 0; c < clusters.size(); c++)
+	{
+		const float *center = &clustercenters[c * 3];
+		const float *n = &clusternormals[c * 3];
+		float len = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+
+		float dot = 0.0f;
+		for (int i = 0; i < 3; i++)
+			dot += (center[i] - meshcenter[i]) * n[i];
+
+		sortkeys[c] = len > 0.0f ? dot / len : 0.0f;
+	}
+
+	std::vector<size_t> order(clusters.size());
+	for (size_t c = 0; c < order.size(); c++)
+		order[c] = c;
+
+	std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return sortkeys[a] > sortkeys[b]; });
+
+	std::vector<uint32> result;
+	result.reserve(indices.size());
+
+	for (size_t c : order)
+	{
+		size_t end = c + 1 < clusters.size() ? clusters[c + 1] : tricount;
+		result.insert(result.end(), indices.begin() + clusters[c] * 3, indices.begin() + end * 3);
+	}
+
+	indices = std::move(result);
+}
+
+static bool getQuantizedFormat(const Buffer::DataMember &member, DataFormat &format)
+{
+	const DataFormatInfo &info = member.info;
+	if (info.baseType != DATA_BASETYPE_FLOAT || info.componentSize != sizeof(float) || info.isMatrix || member.decl.arrayLength > 0)
+		return false;
+
+	if (member.decl.name == getConstant(ATTRIB_POS))
+		return false;
+
+	if (info.components == 4 && member.decl.name == getConstant(ATTRIB_COLOR))
+		format = DATAFORMAT_UNORM8_VEC4;
+	else if (info.components == 2)
+		format = DATAFORMAT_UNORM16_VEC2;
+	else if (info.components == 4)
+		format = DATAFORMAT_UNORM16_VEC4;
+	else
+		return false;
+
+	return true;
+}
+
+void Mesh::optimize(const OptimizeSettings &settings)
+{
+	if (vertexData == nullptr || vertexBuffer.get() == nullptr)
+		throw love::Exception("Mesh:optimize requires a Mesh with its own vertex data.");
+
+	if (primitiveType != PRIMITIVE_TRIANGLES)
+		throw love::Exception("Mesh:optimize requires the 'triangles' draw mode.");
+
+	if (useIndexBuffer && indexData == nullptr)
+		throw love::Exception("Mesh:optimize can't be used with a Mesh that has a custom index Buffer.");
+
+	for (const auto &attrib : attachedAttributes)
+	{
+		if (attrib.enabled && attrib.step == STEP_PER_VERTEX && attrib.buffer.get() != vertexBuffer.get())
+			throw love::Exception("Mesh:optimize can't be used while per-vertex attributes from other Buffers are attached (attribute '%s').", attrib.name.c_str());
+	}
+
+	std::vector<uint32> indices;
+	if (!getVertexMap(indices))
+	{
+		indices.resize(vertexCount);
+		for (size_t i = 0; i < vertexCount; i++)
+			indices[i] = (uint32) i;
+	}
+
+	if (indices.size() % 3 != 0)
+		throw love::Exception("Mesh:optimize requires the vertex map to have a multiple of 3 vertices.");
+
+	if (settings.deduplicate)
+	{
+		std::vector<uint32> unique(vertexCount);
+		std::unordered_multimap<uint64, uint32> hashes;
+		hashes.reserve(vertexCount);
+
+		for (size_t v = 0; v < vertexCount; v++)
+		{
+			const uint8 *vertex = vertexData + v * vertexStride;
+			uint64 hash = hashVertex(vertex, vertexFormat);
+
+			unique[v] = (uint32) v;
+
+			auto range = hashes.equal_range(hash);
+			for (auto it = range.first; it != range.second; ++it)
+			{
+				if (isVertexEqual(vertex, vertexData + it->second * vertexStride, vertexFormat))
+				{
+					unique[v] = it->second;
+					break;
+				}
+			}
+
+			if (unique[v] == v)
+				hashes.emplace(hash, (uint32) v);
+		}
+
+		for (uint32 &index : indices)
+			index = unique[index];
+	}
+
+	// Triangles which reuse a vertex index don't draw anything.
+	size_t tricount = 0;
+	for (size_t t = 0; t < indices.size() / 3; t++)
+	{
+		uint32 a = indices[t * 3 + 0], b = indices[t * 3 + 1], c = indices[t * 3 + 2];
+		if (a == b || b == c || a == c)
+			continue;
+
+		indices[tricount * 3 + 0] = a;
+		indices[tricount * 3 + 1] = b;
+		indices[tricount * 3 + 2] = c;
+		tricount++;
+	}
+	indices.resize(tricount * 3);
+
+	if (indices.empty())
+		throw love::Exception("Mesh:optimize requires the Mesh to have at least one non-degenerate triangle.");
+
+	if (settings.vertexCache)
+		optimizeVertexCache(indices, vertexCount);
+
+	int posindex = vertexBuffer->getDataMemberIndex(getConstant(ATTRIB_POS));
+	if (settings.overdraw && posindex >= 0)
+	{
+		const Buffer::DataMember &member = vertexFormat[posindex];
+		const DataFormatInfo &info = member.info;
+		if (info.baseType == DATA_BASETYPE_FLOAT && info.componentSize == sizeof(float) && info.components == 3 && !info.isMatrix && member.decl.arrayLength == 0)
+		{
+			std::vector<float> positions(vertexCount * 3);
+			for (size_t v = 0; v < vertexCount; v++)
+				memcpy(&positions[v * 3], vertexData + v * vertexStride + member.offset, sizeof(float) * 3);
+
+			optimizeOverdraw(indices, positions);
+		}
+	}
+
+	// Order vertices by first use, which also drops unused ones.
+	std::vector<uint32> remap(vertexCount, LOVE_UINT32_MAX);
+	std::vector<uint32> sources;
+	sources.reserve(vertexCount);
+
+	for (uint32 &index : indices)
+	{
+		if (remap[index] == LOVE_UINT32_MAX)
+		{
+			remap[index] = (uint32) sources.size();
+			sources.push_back(index);
+		}
+		index = remap[index];
+	}
+
+	std::vector<Buffer::DataDeclaration> decls;
+	std::vector<bool> quantized(vertexFormat.size(), false);
+
+	for (size_t i = 0; i < vertexFormat.size(); i++)
+	{
+		const Buffer::DataMember &member = vertexFormat[i];
+		decls.push_back(member.decl);
+
+		DataFormat format = DATAFORMAT_MAX_ENUM;
+		if (!settings.quantize || !getQuantizedFormat(member, format))
+			continue;
+
+		bool inrange = true;
+		for (size_t v = 0; v < sources.size() && inrange; v++)
+		{
+			const float *values = (const float *) (vertexData + sources[v] * vertexStride + member.offset);
+			for (int c = 0; c < member.info.components; c++)
+			{
+				if (!(values[c] >= 0.0f && values[c] <= 1.0f))
+				{
+					inrange = false;
+					break;
+				}
+			}
+		}
+
+		if (inrange)
+		{
+			decls.back().format = format;
+			quantized[i] = true;
+		}
+	}
+
+	auto gfx = Module::getInstance<graphics::Graphics>(Module::M_GRAPHICS);
+	Buffer::Settings buffersettings(BUFFERUSAGEFLAG_VERTEX, vertexBuffer->getDataUsage());
+	StrongRef<Buffer> newbuffer(gfx->newBuffer(buffersettings, decls, nullptr, 0, sources.size()), Acquire::NORETAIN);
+
+	size_t newstride = newbuffer->getArrayStride();
+	const auto &newformat = newbuffer->getDataMembers();
+
+	uint8 *newdata = nullptr;
+	try
+	{
+		newdata = new uint8[newbuffer->getSize()];
+	}
+	catch (std::exception &)
+	{
+		throw love::Exception("Out of memory");
+	}
+
+	memset(newdata, 0, newbuffer->getSize());
+
+	for (size_t v = 0; v < sources.size(); v++)
+	{
+		const uint8 *src = vertexData + sources[v] * vertexStride;
+		uint8 *dst = newdata + v * newstride;
+
+		for (size_t i = 0; i < vertexFormat.size(); i++)
+		{
+			const Buffer::DataMember &srcmember = vertexFormat[i];
+			const Buffer::DataMember &dstmember = newformat[i];
+
+			if (!quantized[i])
+			{
+				memcpy(dst + dstmember.offset, src + srcmember.offset, srcmember.size);
+				continue;
+			}
+
+			const float *values = (const float *) (src + srcmember.offset);
+			if (dstmember.info.componentSize == 1)
+			{
+				uint8 *out = dst + dstmember.offset;
+				for (int c = 0; c < srcmember.info.components; c++)
+					out[c] = (uint8) (values[c] * 255.0f + 0.5f);
+			}
+			else
+			{
+				uint16 *out = (uint16 *) (dst + dstmember.offset);
+				for (int c = 0; c < srcmember.info.components; c++)
+					out[c] = (uint16) (values[c] * 65535.0f + 0.5f);
+			}
+		}
+	}
+
+	newbuffer->fill(0, newbuffer->getSize(), newdata);
+
+	for (auto &attrib : attachedAttributes)
+	{
+		if (attrib.buffer.get() == vertexBuffer.get())
+			attrib.buffer = newbuffer;
+	}
+
+	delete[] vertexData;
+	vertexData = newdata;
+	vertexBuffer = newbuffer;
+	vertexCount = sources.size();
+	vertexStride = newstride;
+	vertexFormat = newformat;
+	modifiedVertexData = Range();
+	positionBoundsValid = false;
+	drawRange = Range();
+
+	setVertexMap(indices);
+}
+
 void Mesh::setTexture(Texture *tex)
 {
 	texture.set(tex);
@@ -502,6 +1034,30 @@ Texture *Mesh::getTexture() const
 	return texture.get();
 }
 
+void Mesh::setBoneBuffer(Buffer *buffer)
+{
+	if (Shader::standardShaders[Shader::STANDARD_SKINNED] == nullptr)
+		throw love::Exception("GPU skinning is not supported on this system.");
+
+	if (!(buffer->getUsageFlags() & BUFFERUSAGEFLAG_TEXEL))
+		throw love::Exception("Mesh bone Buffers must be created with the texel usage flag.");
+
+	if (buffer->getDataMembers().size() != 1 || buffer->getDataMember(0).decl.format != DATAFORMAT_FLOAT_VEC4)
+		throw love::Exception("Mesh bone Buffers must have a single floatvec4 member.");
+
+	boneBuffer.set(buffer);
+}
+
+void Mesh::setBoneBuffer()
+{
+	boneBuffer.set(nullptr);
+}
+
+Buffer *Mesh::getBoneBuffer() const
+{
+	return boneBuffer.get();
+}
+
 void Mesh::setDrawMode(PrimitiveType mode)
 {
 	primitiveType = mode;
@@ -535,35 +1091,114 @@ bool Mesh::getDrawRange(int &start, int &count) const
 	return true;
 }
 
+void Mesh::setCullRect(float x, float y, float w, float h)
+{
+	if (w < 0.0f || h < 0.0f)
+		throw love::Exception("Invalid cull rectangle.");
+
+	culling = true;
+	cullRect[0] = x;
+	cullRect[1] = y;
+	cullRect[2] = x + w;
+	cullRect[3] = y + h;
+}
+
+void Mesh::setCullRect()
+{
+	culling = false;
+}
+
+bool Mesh::getCullRect(float &x, float &y, float &w, float &h) const
+{
+	if (!culling)
+		return false;
+
+	x = cullRect[0];
+	y = cullRect[1];
+	w = cullRect[2] - cullRect[0];
+	h = cullRect[3] - cullRect[1];
+	return true;
+}
+
+bool Mesh::isCulled()
+{
+	// Skinned vertices can end up anywhere.
+	if (!culling || vertexData == nullptr || boneBuffer.get() != nullptr)
+		return false;
+
+	// The positions have to come from this Mesh's vertex data.
+	int positionindex = -1;
+	for (const auto &attrib : attachedAttributes)
+	{
+		if (attrib.enabled && attrib.name == getConstant(ATTRIB_POS))
+		{
+			if (attrib.buffer.get() == vertexBuffer.get() && attrib.startArrayIndex == 0 && attrib.step == STEP_PER_VERTEX)
+				positionindex = attrib.indexInBuffer;
+			break;
+		}
+	}
+
+	if (positionindex < 0)
+		return false;
+
+	const Buffer::DataMember &member = vertexFormat[positionindex];
+	if (member.info.baseType != DATA_BASETYPE_FLOAT || member.info.componentSize != sizeof(float) || member.info.isMatrix || member.info.components < 2 || member.decl.arrayLength > 0)
+		return false;
+
+	if (!positionBoundsValid)
+	{
+		positionBounds[0] = positionBounds[1] = std::numeric_limits<float>::max();
+		positionBounds[2] = positionBounds[3] = std::numeric_limits<float>::lowest();
+
+		for (size_t i = 0; i < vertexCount; i++)
+		{
+			const float *pos = (const float *) (vertexData + i * vertexStride + member.offset);
+			positionBounds[0] = std::min(positionBounds[0], pos[0]);
+			positionBounds[1] = std::min(positionBounds[1], pos[1]);
+			positionBounds[2] = std::max(positionBounds[2], pos[0]);
+			positionBounds[3] = std::max(positionBounds[3], pos[1]);
+		}
+
+		positionBoundsValid = true;
+	}
+
+	return positionBounds[2] < cullRect[0] || positionBounds[0] > cullRect[2]
+		|| positionBounds[3] < cullRect[1] || positionBounds[1] > cullRect[3];
+}
+
 void Mesh::draw(Graphics *gfx, const love::Matrix4 &m)
 {
-	drawInternal(gfx, m, 1, nullptr, 0);
+	drawInternal(gfx, m, 1, nullptr, 0, 1);
 }
 
 void Mesh::drawInstanced(Graphics *gfx, const Matrix4 &m, int instancecount)
 {
-	drawInternal(gfx, m, instancecount, nullptr, 0);
+	drawInternal(gfx, m, instancecount, nullptr, 0, 1);
 }
 
-void Mesh::drawIndirect(Graphics *gfx, const Matrix4 &m, Buffer *indirectargs, int argsindex)
+void Mesh::drawIndirect(Graphics *gfx, const Matrix4 &m, Buffer *indirectargs, int argsindex, int drawcount)
 {
-	drawInternal(gfx, m, 0, indirectargs, argsindex);
+	drawInternal(gfx, m, 0, indirectargs, argsindex, drawcount);
 }
 
-void Mesh::drawInternal(Graphics *gfx, const Matrix4 &m, int instancecount, Buffer *indirectargs, int argsindex)
+void Mesh::drawInternal(Graphics *gfx, const Matrix4 &m, int instancecount, Buffer *indirectargs, int argsindex, int drawcount)
 {
 	if (vertexCount <= 0 || (instancecount <= 0 && indirectargs == nullptr))
 		return;
 
+	// Instances and indirect draws can end up anywhere.
+	if (instancecount == 1 && indirectargs == nullptr && isCulled())
+		return;
+
 	if (indirectargs != nullptr)
 	{
 		if (primitiveType == PRIMITIVE_TRIANGLE_FAN)
 			throw love::Exception("The fan draw mode is not supported in indirect draws.");
 
 		if (useIndexBuffer && indexBuffer != nullptr)
-			gfx->validateIndirectArgsBuffer(Graphics::INDIRECT_ARGS_DRAW_INDICES, indirectargs, argsindex);
+			gfx->validateIndirectArgsBuffer(Graphics::INDIRECT_ARGS_DRAW_INDICES, indirectargs, argsindex, drawcount);
 		else
-			gfx->validateIndirectArgsBuffer(Graphics::INDIRECT_ARGS_DRAW_VERTICES, indirectargs, argsindex);
+			gfx->validateIndirectArgsBuffer(Graphics::INDIRECT_ARGS_DRAW_VERTICES, indirectargs, argsindex, drawcount);
 	}
 
 	// Some graphics backends don't natively support triangle fans. So we'd
@@ -577,11 +1212,30 @@ void Mesh::drawInternal(Graphics *gfx, const Matrix4 &m, int instancecount, Buff
 	flush();
 
 	if (Shader::isDefaultActive())
-		Shader::attachDefault(primitiveType == PRIMITIVE_POINTS ? Shader::STANDARD_POINTS : Shader::STANDARD_DEFAULT);
+	{
+		Shader::StandardShader defaultshader = Shader::STANDARD_DEFAULT;
+		if (primitiveType == PRIMITIVE_POINTS)
+			defaultshader = Shader::STANDARD_POINTS;
+		else if (boneBuffer.get() != nullptr)
+			defaultshader = Shader::STANDARD_SKINNED;
+
+		Shader::attachDefault(defaultshader);
+	}
 
 	if (Shader::current)
 		Shader::current->validateDrawState(primitiveType, texture);
 
+	// Custom shaders get the bones too, if they declare love_BoneTransforms.
+	if (Shader::current && boneBuffer.get() != nullptr)
+	{
+		const Shader::UniformInfo *info = Shader::current->getUniformInfo("love_BoneTransforms");
+		if (info != nullptr && info->baseType == Shader::UNIFORM_TEXELBUFFER)
+		{
+			Buffer *bones = boneBuffer.get();
+			Shader::current->sendBuffers(info, &bones, 1);
+		}
+	}
+
 	VertexAttributes attributes;
 	BufferBindings buffers;
 
@@ -665,6 +1319,7 @@ void Mesh::drawInternal(Graphics *gfx, const Matrix4 &m, int instancecount, Buff
 
 		cmd.indirectBuffer = indirectargs;
 		cmd.indirectBufferOffset = argsindex * (indirectargs != nullptr ? indirectargs->getArrayStride() : 0);
+		cmd.indirectDrawCount = drawcount;
 
 		if (cmd.indexCount > 0)
 			gfx->draw(cmd);
@@ -686,6 +1341,7 @@ void Mesh::drawInternal(Graphics *gfx, const Matrix4 &m, int instancecount, Buff
 
 		cmd.indirectBuffer = indirectargs;
 		cmd.indirectBufferOffset = argsindex * (indirectargs != nullptr ? indirectargs->getArrayStride() : 0);
+		cmd.indirectDrawCount = drawcount;
 
 		if (cmd.vertexCount > 0)
 			gfx->draw(cmd);
@@ -63,6 +63,20 @@ public:
 		bool enabled;
 	};
 
+	struct OptimizeSettings
+	{
+		// Merge vertices whose data is identical.
+		bool deduplicate = true;
+		// Reorder triangles for the post-transform vertex cache.
+		bool vertexCache = true;
+		// Reorder clusters of triangles so front-most ones tend to be drawn
+		// first. Only used when positions have 3 components.
+		bool overdraw = true;
+		// Store float attributes whose values are all in [0, 1] as unorm16,
+		// or unorm8 for VertexColor.
+		bool quantize = false;
+	};
+
 	static love::Type type;
 
 	Mesh(Graphics *gfx, const std::vector<Buffer::DataDeclaration> &vertexformat, const void *data, size_t datasize, PrimitiveType drawmode, BufferDataUsage usage);
@@ -147,6 +161,16 @@ public:
 	 **/
 	size_t getIndexCount() const;
 
+	/**
+	 * Rebuilds the vertex data and vertex map of a triangle Mesh to make it
+	 * faster to draw: duplicate and unused vertices are removed, triangles are
+	 * reordered for the GPU's vertex cache and to reduce overdraw, and the
+	 * vertices are sorted in the order they're first used. Triangles which
+	 * overlap in 2D may blend in a different order afterwards.
+	 * A new vertex Buffer is created, and the draw range is reset.
+	 **/
+	void optimize(const OptimizeSettings &settings);
+
 	/**
 	 * Sets the texture used when drawing the Mesh.
 	 **/
@@ -163,6 +187,16 @@ public:
 	 **/
 	Texture *getTexture() const;
 
+	/**
+	 * Sets the Buffer of bone transforms used to skin the Mesh on the GPU.
+	 * Each bone is two floatvec4 elements holding the rows of its 2D affine
+	 * transform. With the default shader, each vertex is blended between up
+	 * to 4 bones using its VertexBoneIndices and VertexBoneWeights attributes.
+	 **/
+	void setBoneBuffer(Buffer *buffer);
+	void setBoneBuffer();
+	Buffer *getBoneBuffer() const;
+
 	/**
 	 * Sets the draw mode used when drawing the Mesh.
 	 **/
@@ -173,11 +207,21 @@ public:
 	void setDrawRange();
 	bool getDrawRange(int &start, int &count) const;
 
+	/**
+	 * Sets a rectangle, in the Mesh's own coordinate space, outside of which
+	 * the Mesh isn't drawn. Only the positions in the Mesh's own vertex data
+	 * are looked at, so non-instanced draws are skipped when none of them are
+	 * inside (shaders which move vertices around shouldn't use this).
+	 **/
+	void setCullRect(float x, float y, float w, float h);
+	void setCullRect();
+	bool getCullRect(float &x, float &y, float &w, float &h) const;
+
 	// Implements Drawable.
 	void draw(Graphics *gfx, const Matrix4 &m) override;
 
 	void drawInstanced(Graphics *gfx, const Matrix4 &m, int instancecount);
-	void drawIndirect(Graphics *gfx, const Matrix4 &m, Buffer *indirectargs, int argsindex);
+	void drawIndirect(Graphics *gfx, const Matrix4 &m, Buffer *indirectargs, int argsindex, int drawcount = 1);
 
 	static std::vector<Buffer::DataDeclaration> getDefaultVertexFormat();
 
@@ -189,7 +233,9 @@ private:
 	int getAttachedAttributeIndex(const std::string &name) const;
 	void finalizeAttribute(BufferAttribute &attrib) const;
 
-	void drawInternal(Graphics *gfx, const Matrix4 &m, int instancecount, Buffer *indirectargs, int argsindex);
+	void drawInternal(Graphics *gfx, const Matrix4 &m, int instancecount, Buffer *indirectargs, int argsindex, int drawcount);
+
+	bool isCulled();
 
 	std::vector<Buffer::DataMember> vertexFormat;
 
@@ -217,6 +263,15 @@ private:
 
 	StrongRef<Texture> texture;
 
+	StrongRef<Buffer> boneBuffer;
+
+	bool culling = false;
+	float cullRect[4] = {}; // min x, min y, max x, max y
+
+	// Bounds of the vertex positions, updated when the vertex data changes.
+	bool positionBoundsValid = false;
+	float positionBounds[4] = {};
+
 }; // Mesh
 
 } // graphics
@@ -0,0 +1,89 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "OcclusionQuery.h"
+
+namespace love
+{
+namespace graphics
+{
+
+love::Type OcclusionQuery::type("OcclusionQuery", &Object::type);
+
+OcclusionQuery::OcclusionQuery()
+	: generation(0)
+	, pendingSegments(0)
+	, samples(0)
+	, active(false)
+	, conservative(false)
+{
+}
+
+OcclusionQuery::~OcclusionQuery()
+{
+}
+
+bool OcclusionQuery::isResultAvailable() const
+{
+	return !active && pendingSegments == 0;
+}
+
+void OcclusionQuery::begin()
+{
+	// Segments of a previous begin/end pair which are still in flight are
+	// ignored once they resolve.
+	generation++;
+	pendingSegments = 0;
+	samples = 0;
+	active = true;
+	conservative = false;
+}
+
+void OcclusionQuery::end()
+{
+	active = false;
+	if (conservative && samples == 0)
+		samples = 1;
+}
+
+uint32 OcclusionQuery::addSegment()
+{
+	pendingSegments++;
+	return generation;
+}
+
+void OcclusionQuery::resolveSegment(uint32 segmentgeneration, uint64 segmentsamples)
+{
+	if (segmentgeneration != generation)
+		return;
+
+	pendingSegments--;
+	samples += segmentsamples;
+}
+
+void OcclusionQuery::markConservative()
+{
+	conservative = true;
+	if (!active && samples == 0)
+		samples = 1;
+}
+
+} // graphics
+} // love
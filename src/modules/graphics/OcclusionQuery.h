@@ -0,0 +1,81 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/config.h"
+#include "common/int.h"
+#include "common/Object.h"
+
+namespace love
+{
+namespace graphics
+{
+
+/**
+ * Counts the samples which pass the depth and stencil tests between
+ * Graphics::beginOcclusionQuery and endOcclusionQuery. Backends may split the
+ * query into several GPU queries (one per render pass, for example), whose
+ * results are added together when they become available a few frames later.
+ **/
+class OcclusionQuery : public love::Object
+{
+public:
+
+	static love::Type type;
+
+	OcclusionQuery();
+	virtual ~OcclusionQuery();
+
+	bool isActive() const { return active; }
+
+	// Whether the result of the most recent begin/end pair is known.
+	bool isResultAvailable() const;
+
+	// Only exact on systems with precise occlusion queries. Elsewhere it's
+	// only guaranteed to be nonzero when any samples passed.
+	uint64 getSamples() const { return samples; }
+
+	// Used by Graphics and the backends.
+	void begin();
+	void end();
+
+	// Adds a GPU query to the current begin/end pair. Returns the generation
+	// to pass to resolveSegment.
+	uint32 addSegment();
+	void resolveSegment(uint32 generation, uint64 segmentsamples);
+
+	// Used when the backend runs out of GPU queries, so the result has to
+	// assume something was drawn.
+	void markConservative();
+
+private:
+
+	uint32 generation;
+	int pendingSegments;
+	uint64 samples;
+	bool active;
+	bool conservative;
+
+}; // OcclusionQuery
+
+} // graphics
+} // love
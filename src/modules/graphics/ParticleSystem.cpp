@@ -25,11 +25,23 @@
 
 #include "common/math.h"
 #include "modules/math/RandomGenerator.h"
+#include "modules/thread/threads.h"
 
 // STD
 #include <algorithm>
 #include <cmath>
 #include <cstdlib>
+#include <cstring>
+#include <atomic>
+#include <thread>
+
+#if defined(LOVE_SIMD_SSE)
+#include <xmmintrin.h>
+#endif
+
+#if defined(LOVE_SIMD_NEON)
+#include <arm_neon.h>
+#endif
 
 namespace love
 {
@@ -39,9 +51,17 @@ namespace graphics
 namespace
 {
 
-love::math::RandomGenerator rng;
+// Seeds each ParticleSystem's own random generator.
+love::math::RandomGenerator seedGenerator;
+
+love::math::RandomGenerator::Seed nextSeed()
+{
+	love::math::RandomGenerator::Seed seed;
+	seed.b64 = seedGenerator.rand();
+	return seed;
+}
 
-float calculate_variation(float inner, float outer, float var)
+float calculate_variation(love::math::RandomGenerator &rng, float inner, float outer, float var)
 {
 	float low = inner - (outer/2.0f)*var;
 	float high = inner + (outer/2.0f)*var;
@@ -49,16 +69,161 @@ float calculate_variation(float inner, float outer, float var)
 	return low*(1-r)+high*r;
 }
 
+// Simulates particles and writes their vertices, for GPU simulation mode.
+// See ParticleSystem::update and ParticleSystem::draw for the CPU version.
+const char *gpuSimulationCode = R"(
+layout (local_size_x = 64, local_size_y = 1, local_size_z = 1) in;
+
+struct Particle
+{
+	vec4 positionVelocity;
+	vec4 originAcceleration;
+	vec4 accelerationDamping;
+	vec4 lifeSize;
+	vec4 spin;
+};
+
+buffer ParticleBuffer
+{
+	Particle particles[];
+};
+
+writeonly buffer VertexBuffer
+{
+	uint vertices[];
+};
+
+readonly buffer QuadBuffer
+{
+	vec4 quadVertices[];
+};
+
+uniform float sizes[8];
+uniform int sizeCount;
+uniform vec4 colors[8];
+uniform int colorCount;
+uniform int quadCount;
+uniform int particleCount;
+uniform float deltaTime;
+uniform vec2 particleOffset;
+uniform int relativeRotation;
+
+void writeVertex(uint index, vec2 pos, vec2 texcoord, vec4 color)
+{
+	uint base = index * 5u;
+	vertices[base + 0u] = floatBitsToUint(pos.x);
+	vertices[base + 1u] = floatBitsToUint(pos.y);
+	vertices[base + 2u] = floatBitsToUint(texcoord.x);
+	vertices[base + 3u] = floatBitsToUint(texcoord.y);
+	vertices[base + 4u] = packUnorm4x8(clamp(color, 0.0, 1.0));
+}
+
+void computemain()
+{
+	uint index = love_GlobalThreadID.x;
+	if (index >= uint(particleCount))
+		return;
+
+	Particle p = particles[index];
+
+	bool isnew = p.spin.z != 0.0;
+	vec2 position = p.positionVelocity.xy;
+	vec2 velocity = p.positionVelocity.zw;
+	float life = p.lifeSize.x;
+	float rotation = p.lifeSize.w;
+
+	// Particles uploaded since the last dispatch only need their vertices.
+	if (!isnew)
+		life -= deltaTime;
+
+	if (life <= 0.0)
+	{
+		p.lifeSize.x = life;
+		particles[index] = p;
+		for (uint v = 0u; v < 4u; v++)
+			writeVertex(index * 4u + v, vec2(0.0), vec2(0.0), vec4(0.0));
+		return;
+	}
+
+	float t = 1.0 - life / p.lifeSize.y;
+
+	if (!isnew)
+	{
+		vec2 radial = position - p.originAcceleration.xy;
+		float len = length(radial);
+		radial = len > 0.0 ? radial / len : vec2(0.0);
+		vec2 tangential = vec2(-radial.y, radial.x) * p.accelerationDamping.y;
+		radial *= p.accelerationDamping.x;
+
+		velocity += (radial + tangential + p.originAcceleration.zw) * deltaTime;
+		velocity *= 1.0 / (1.0 + p.accelerationDamping.z * deltaTime);
+		position += velocity * deltaTime;
+
+		rotation += mix(p.spin.x, p.spin.y, t) * deltaTime;
+	}
+
+	float angle = rotation;
+	if (relativeRotation != 0 && (velocity.x != 0.0 || velocity.y != 0.0))
+		angle += atan(velocity.y, velocity.x);
+
+	float s = max((p.accelerationDamping.w + t * p.lifeSize.z) * float(sizeCount - 1), 0.0);
+	int i = min(int(s), sizeCount - 1);
+	int k = min(i + 1, sizeCount - 1);
+	float size = mix(sizes[i], sizes[k], s - float(i));
+
+	s = max(t * float(colorCount - 1), 0.0);
+	i = min(int(s), colorCount - 1);
+	k = min(i + 1, colorCount - 1);
+	vec4 color = mix(colors[i], colors[k], s - float(i));
+
+	int quadindex = clamp(int(t * float(quadCount)), 0, quadCount - 1);
+
+	float c = cos(angle);
+	float sn = sin(angle);
+
+	for (uint v = 0u; v < 4u; v++)
+	{
+		vec4 q = quadVertices[uint(quadindex) * 4u + v];
+		vec2 local = (q.xy - particleOffset) * size;
+		vec2 pos = vec2(c * local.x - sn * local.y, sn * local.x + c * local.y) + position;
+		writeVertex(index * 4u + v, pos, q.zw, color);
+	}
+
+	p.positionVelocity = vec4(position, velocity);
+	p.lifeSize.x = life;
+	p.lifeSize.w = rotation;
+	p.spin.z = 0.0;
+	particles[index] = p;
+}
+)";
+
+void sendGPUUniform(Shader *shader, const char *name, const void *data, size_t size)
+{
+	const Shader::UniformInfo *info = shader->getUniformInfo(name);
+	if (info == nullptr || !info->active)
+		return;
+
+	memcpy(info->data, data, std::min(size, info->dataSize));
+	shader->updateUniform(info, info->count);
+}
+
+void sendGPUBuffer(Shader *shader, const char *name, Buffer *buffer)
+{
+	const Shader::UniformInfo *info = shader->getUniformInfo(name);
+	if (info != nullptr && info->active)
+		shader->sendBuffers(info, &buffer, 1);
+}
+
 } // anonymous namespace
 
 love::Type ParticleSystem::type("ParticleSystem", &Drawable::type);
 
 ParticleSystem::ParticleSystem(Texture *texture, uint32 size)
 	: pMem(nullptr)
-	, pFree(nullptr)
-	, pHead(nullptr)
-	, pTail(nullptr)
+	, pArrays()
+	, pReversed(false)
 	, texture(texture)
+	, rng()
 	, active(true)
 	, insertMode(INSERT_MODE_TOP)
 	, maxParticles(0)
@@ -95,6 +260,10 @@ ParticleSystem::ParticleSystem(Texture *texture, uint32 size)
 	, relativeRotation(false)
 	, vertexAttributes(CommonFormat::XYf_STf_RGBAub, 0)
 	, buffer(nullptr)
+	, gpuSimulation(false)
+	, gpuNextSlot(0)
+	, gpuUsedSlots(0)
+	, gpuTime(0.0)
 {
 	if (size == 0 || size > MAX_PARTICLES)
 		throw love::Exception("Invalid ParticleSystem size.");
@@ -105,15 +274,16 @@ ParticleSystem::ParticleSystem(Texture *texture, uint32 size)
 	sizes.push_back(1.0f);
 	colors.push_back(Colorf(1.0f, 1.0f, 1.0f, 1.0f));
 
+	rng.setSeed(nextSeed());
 	setBufferSize(size);
 }
 
 ParticleSystem::ParticleSystem(const ParticleSystem &p)
 	: pMem(nullptr)
-	, pFree(nullptr)
-	, pHead(nullptr)
-	, pTail(nullptr)
+	, pArrays()
+	, pReversed(p.pReversed)
 	, texture(p.texture)
+	, rng()
 	, active(p.active)
 	, insertMode(p.insertMode)
 	, maxParticles(p.maxParticles)
@@ -156,7 +326,13 @@ ParticleSystem::ParticleSystem(const ParticleSystem &p)
 	, relativeRotation(p.relativeRotation)
 	, vertexAttributes(p.vertexAttributes)
 	, buffer(nullptr)
+	, gpuSimulation(p.gpuSimulation)
+	, gpuShader(p.gpuShader)
+	, gpuNextSlot(0)
+	, gpuUsedSlots(0)
+	, gpuTime(0.0)
 {
+	rng.setSeed(nextSeed());
 	setBufferSize(maxParticles);
 }
 
@@ -183,9 +359,18 @@ void ParticleSystem::resetOffset()
 
 void ParticleSystem::createBuffers(size_t size)
 {
+	if (gpuSimulation)
+	{
+		createGPUBuffers(size);
+		return;
+	}
+
 	try
 	{
-		pFree = pMem = new Particle[size];
+		pMem = new float[size * PARTICLE_ARRAY_MAX_ENUM];
+		for (int i = 0; i < PARTICLE_ARRAY_MAX_ENUM; i++)
+			pArrays[i] = pMem + size * i;
+
 		maxParticles = (uint32) size;
 
 		auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
@@ -209,9 +394,92 @@ void ParticleSystem::deleteBuffers()
 		buffer->release();
 
 	pMem = nullptr;
+	for (int i = 0; i < PARTICLE_ARRAY_MAX_ENUM; i++)
+		pArrays[i] = nullptr;
+
 	buffer = nullptr;
 	maxParticles = 0;
 	activeParticles = 0;
+
+	gpuParticleBuffer.set(nullptr);
+	gpuVertexBuffer.set(nullptr);
+	gpuDeathTimes.clear();
+	gpuPendingParticles.clear();
+}
+
+void ParticleSystem::createGPUBuffers(size_t size)
+{
+	auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+
+	if (gpuShader.get() == nullptr)
+	{
+		Shader::CompileOptions options;
+		options.debugName = "ParticleSystem simulation";
+		gpuShader.set(gfx->newComputeShader(gpuSimulationCode, options), Acquire::NORETAIN);
+	}
+
+	try
+	{
+		std::vector<Buffer::DataDeclaration> particleformat = {
+			{ "positionVelocity", DATAFORMAT_FLOAT_VEC4 },
+			{ "originAcceleration", DATAFORMAT_FLOAT_VEC4 },
+			{ "accelerationDamping", DATAFORMAT_FLOAT_VEC4 },
+			{ "lifeSize", DATAFORMAT_FLOAT_VEC4 },
+			{ "spin", DATAFORMAT_FLOAT_VEC4 },
+		};
+
+		Buffer::Settings particlesettings(BUFFERUSAGEFLAG_SHADER_STORAGE, BUFFERDATAUSAGE_DYNAMIC);
+		particlesettings.debugName = "ParticleSystem particles";
+		gpuParticleBuffer.set(gfx->newBuffer(particlesettings, particleformat, nullptr, 0, size), Acquire::NORETAIN);
+
+		// Same layout as the CPU path's vertices, but the compute shader writes
+		// them as raw uints.
+		std::vector<Buffer::DataDeclaration> vertexformat = {{ "data", DATAFORMAT_UINT32 }};
+		size_t vertexcount = size * 4 * sizeof(Vertex) / sizeof(uint32);
+
+		Buffer::Settings vertexsettings(BUFFERUSAGEFLAG_VERTEX | BUFFERUSAGEFLAG_SHADER_STORAGE, BUFFERDATAUSAGE_STATIC);
+		vertexsettings.debugName = "ParticleSystem vertices";
+		gpuVertexBuffer.set(gfx->newBuffer(vertexsettings, vertexformat, nullptr, 0, vertexcount), Acquire::NORETAIN);
+
+		gpuDeathTimes.resize(size, 0.0);
+		maxParticles = (uint32) size;
+	}
+	catch (std::bad_alloc &)
+	{
+		deleteBuffers();
+		throw love::Exception("Out of memory");
+	}
+}
+
+void ParticleSystem::setGPUSimulation(bool enable)
+{
+	if (enable == gpuSimulation)
+		return;
+
+	uint32 size = maxParticles;
+
+	deleteBuffers();
+	gpuSimulation = enable;
+
+	try
+	{
+		createBuffers(size);
+	}
+	catch (love::Exception &)
+	{
+		// Compute shaders or storage buffers might not be supported.
+		gpuSimulation = false;
+		createBuffers(size);
+		reset();
+		throw;
+	}
+
+	reset();
+}
+
+bool ParticleSystem::isGPUSimulation() const
+{
+	return gpuSimulation;
 }
 
 void ParticleSystem::setBufferSize(uint32 size)
@@ -233,24 +501,16 @@ void ParticleSystem::addParticle(float t)
 	if (isFull())
 		return;
 
-	// Gets a free particle and updates the allocation pointer.
-	Particle *p = pFree++;
-	initParticle(p, t);
-
-	switch (insertMode)
+	if (gpuSimulation)
 	{
-	default:
-	case INSERT_MODE_TOP:
-		insertTop(p);
-		break;
-	case INSERT_MODE_BOTTOM:
-		insertBottom(p);
-		break;
-	case INSERT_MODE_RANDOM:
-		insertRandom(p);
-		break;
+		addGPUParticle(t);
+		return;
 	}
 
+	Particle p;
+	initParticle(&p, t);
+	insertParticle(p);
+
 	activeParticles++;
 }
 
@@ -379,8 +639,8 @@ void ParticleSystem::initParticle(Particle *p, float t)
 
 	min = rotationMin;
 	max = rotationMax;
-	p->spinStart = calculate_variation(spinStart, spinEnd, spinVariation);
-	p->spinEnd = calculate_variation(spinEnd, spinStart, spinVariation);
+	p->spinStart = calculate_variation(rng, spinStart, spinEnd, spinVariation);
+	p->spinEnd = calculate_variation(rng, spinEnd, spinStart, spinVariation);
 	p->rotation = (float) rng.random(min, max);
 
 	p->angle = p->rotation;
@@ -392,110 +652,94 @@ void ParticleSystem::initParticle(Particle *p, float t)
 	p->quadIndex = 0;
 }
 
-void ParticleSystem::insertTop(Particle *p)
+void ParticleSystem::addGPUParticle(float t)
 {
-	if (pHead == nullptr)
-	{
-		pHead = p;
-		p->prev = nullptr;
-	}
-	else
-	{
-		pTail->next = p;
-		p->prev = pTail;
-	}
-	p->next = nullptr;
-	pTail = p;
-}
+	// Slots are reused in order, so the system is full when the oldest slot
+	// still has a live particle.
+	uint32 slot = gpuNextSlot;
+	if (slot < gpuUsedSlots && gpuDeathTimes[slot] > gpuTime)
+		return;
 
-void ParticleSystem::insertBottom(Particle *p)
-{
-	if (pTail == nullptr)
-	{
-		pTail = p;
-		p->next = nullptr;
-	}
-	else
-	{
-		pHead->prev = p;
-		p->next = pHead;
-	}
-	p->prev = nullptr;
-	pHead = p;
-}
+	Particle p;
+	initParticle(&p, t);
 
-void ParticleSystem::insertRandom(Particle *p)
-{
-	// Nonuniform, but 64-bit is so large nobody will notice. Hopefully.
-	uint64 pos = rng.rand() % ((int64) activeParticles + 1);
+	GPUParticle g = {
+		{ p.position.x, p.position.y, p.velocity.x, p.velocity.y },
+		{ p.origin.x, p.origin.y, p.linearAcceleration.x, p.linearAcceleration.y },
+		{ p.radialAcceleration, p.tangentialAcceleration, p.linearDamping, p.sizeOffset },
+		{ p.life, p.lifetime, p.sizeIntervalSize, p.rotation },
+		{ p.spinStart, p.spinEnd, 1.0f, 0.0f },
+	};
 
-	// Special case where the particle gets inserted before the head.
-	if (pos == activeParticles)
-	{
-		Particle *pA = pHead;
-		if (pA)
-			pA->prev = p;
-		p->prev = nullptr;
-		p->next = pA;
-		pHead = p;
-		return;
-	}
+	gpuPendingParticles.emplace_back(slot, g);
+	gpuDeathTimes[slot] = gpuTime + p.life;
 
-	// Inserts the particle after the randomly selected particle.
-	Particle *pA = pMem + pos;
-	Particle *pB = pA->next;
-	pA->next = p;
-	if (pB)
-		pB->prev = p;
-	else
-		pTail = p;
-	p->prev = pA;
-	p->next = pB;
+	gpuNextSlot = (slot + 1) % maxParticles;
+	gpuUsedSlots = std::max(gpuUsedSlots, slot + 1);
+
+	activeParticles++;
 }
 
-ParticleSystem::Particle *ParticleSystem::removeParticle(Particle *p)
+void ParticleSystem::insertParticle(const Particle &p)
 {
-	// The linked list is updated in this function and old pointers may be
-	// invalidated. The returned pointer will inform the caller of the new
-	// pointer to the next particle.
-	Particle *pNext = nullptr;
-
-	// Removes the particle from the linked list.
-	if (p->prev)
-		p->prev->next = p->next;
-	else
-		pHead = p->next;
+	// Top and bottom insertion both append, since particles are stored in
+	// reverse draw order in bottom insert mode.
+	uint32 index = activeParticles;
 
-	if (p->next)
+	if (insertMode == INSERT_MODE_RANDOM)
 	{
-		p->next->prev = p->prev;
-		pNext = p->next;
+		// Nonuniform, but 64-bit is so large nobody will notice. Hopefully.
+		index = (uint32) (rng.rand() % ((int64) activeParticles + 1));
+		moveParticles(index + 1, index, activeParticles - index);
 	}
-	else
-		pTail = p->prev;
-
-	// The (in memory) last particle can now be moved into the free slot.
-	// It will skip the moving if it happens to be the removed particle.
-	pFree--;
-	if (p != pFree)
-	{
-		*p = *pFree;
-		if (pNext == pFree)
-			pNext = p;
 
-		if (p->prev)
-			p->prev->next = p;
-		else
-			pHead = p;
+	setParticle(index, p);
+}
+
+void ParticleSystem::setParticle(uint32 index, const Particle &p)
+{
+	float **a = pArrays;
+
+	a[PARTICLE_LIFE][index] = p.life;
+	a[PARTICLE_LIFETIME][index] = p.lifetime;
+	a[PARTICLE_POSITION_X][index] = p.position.x;
+	a[PARTICLE_POSITION_Y][index] = p.position.y;
+	a[PARTICLE_ORIGIN_X][index] = p.origin.x;
+	a[PARTICLE_ORIGIN_Y][index] = p.origin.y;
+	a[PARTICLE_VELOCITY_X][index] = p.velocity.x;
+	a[PARTICLE_VELOCITY_Y][index] = p.velocity.y;
+	a[PARTICLE_LINEAR_ACCELERATION_X][index] = p.linearAcceleration.x;
+	a[PARTICLE_LINEAR_ACCELERATION_Y][index] = p.linearAcceleration.y;
+	a[PARTICLE_RADIAL_ACCELERATION][index] = p.radialAcceleration;
+	a[PARTICLE_TANGENTIAL_ACCELERATION][index] = p.tangentialAcceleration;
+	a[PARTICLE_LINEAR_DAMPING][index] = p.linearDamping;
+	a[PARTICLE_SIZE][index] = p.size;
+	a[PARTICLE_SIZE_OFFSET][index] = p.sizeOffset;
+	a[PARTICLE_SIZE_INTERVAL_SIZE][index] = p.sizeIntervalSize;
+	a[PARTICLE_ROTATION][index] = p.rotation;
+	a[PARTICLE_ANGLE][index] = p.angle;
+	a[PARTICLE_SPIN_START][index] = p.spinStart;
+	a[PARTICLE_SPIN_END][index] = p.spinEnd;
+	a[PARTICLE_COLOR_R][index] = p.color.r;
+	a[PARTICLE_COLOR_G][index] = p.color.g;
+	a[PARTICLE_COLOR_B][index] = p.color.b;
+	a[PARTICLE_COLOR_A][index] = p.color.a;
+	a[PARTICLE_QUAD_INDEX][index] = (float) p.quadIndex;
+}
+
+void ParticleSystem::moveParticles(uint32 dst, uint32 src, uint32 count)
+{
+	if (count == 0 || dst == src)
+		return;
 
-		if (p->next)
-			p->next->prev = p;
-		else
-			pTail = p;
-	}
+	for (int i = 0; i < PARTICLE_ARRAY_MAX_ENUM; i++)
+		memmove(pArrays[i] + dst, pArrays[i] + src, sizeof(float) * count);
+}
 
-	activeParticles--;
-	return pNext;
+void ParticleSystem::reverseParticles()
+{
+	for (int i = 0; i < PARTICLE_ARRAY_MAX_ENUM; i++)
+		std::reverse(pArrays[i], pArrays[i] + activeParticles);
 }
 
 void ParticleSystem::setTexture(Texture *tex)
@@ -517,6 +761,14 @@ Texture *ParticleSystem::getTexture() const
 void ParticleSystem::setInsertMode(InsertMode mode)
 {
 	insertMode = mode;
+
+	bool reversed = mode == INSERT_MODE_BOTTOM;
+	if (reversed != pReversed)
+	{
+		if (pMem != nullptr)
+			reverseParticles();
+		pReversed = reversed;
+	}
 }
 
 ParticleSystem::InsertMode ParticleSystem::getInsertMode() const
@@ -862,12 +1114,20 @@ void ParticleSystem::pause()
 
 void ParticleSystem::reset()
 {
+	if (gpuSimulation)
+	{
+		gpuPendingParticles.clear();
+		gpuNextSlot = 0;
+		gpuUsedSlots = 0;
+		activeParticles = 0;
+		life = lifetime;
+		emitCounter = 0;
+		return;
+	}
+
 	if (pMem == nullptr)
 		return;
 
-	pFree = pMem;
-	pHead = nullptr;
-	pTail = nullptr;
 	activeParticles = 0;
 	life = lifetime;
 	emitCounter = 0;
@@ -911,101 +1171,283 @@ bool ParticleSystem::isFull() const
 
 void ParticleSystem::update(float dt)
 {
+	if (gpuSimulation)
+	{
+		if (maxParticles == 0 || dt == 0.0f)
+			return;
+
+		gpuTime += dt;
+
+		// Particle state lives on the GPU, but death times are tracked here so
+		// the count and spawning don't need to read anything back.
+		activeParticles = 0;
+		for (uint32 i = 0; i < gpuUsedSlots; i++)
+		{
+			if (gpuDeathTimes[i] > gpuTime)
+				activeParticles++;
+		}
+
+		updateGPU(dt);
+		emitParticles(dt);
+
+		prevPosition = position;
+		return;
+	}
+
 	if (pMem == nullptr || dt == 0.0f)
 		return;
 
-	// Traverse all particles and update.
-	Particle *p = pHead;
+	float *life = pArrays[PARTICLE_LIFE];
 
-	while (p)
-	{
-		// Decrease lifespan.
-		p->life -= dt;
+	// Decrease lifespan.
+	for (uint32 i = 0; i < activeParticles; i++)
+		life[i] -= dt;
 
-		if (p->life <= 0)
-			p = removeParticle(p);
-		else
+	// Remove dead particles by moving each run of live ones down over them,
+	// which keeps the remaining particles in order.
+	uint32 count = 0;
+	for (uint32 i = 0; i < activeParticles;)
+	{
+		if (life[i] <= 0)
 		{
-			// Temp variables.
-			love::Vector2 radial, tangential;
-			love::Vector2 ppos = p->position;
+			i++;
+			continue;
+		}
 
-			// Get vector from particle center to particle.
-			radial = ppos - p->origin;
-			radial.normalize();
-			tangential = radial;
+		uint32 start = i;
+		while (i < activeParticles && life[i] > 0)
+			i++;
 
-			// Resize radial acceleration.
-			radial *= p->radialAcceleration;
+		moveParticles(count, start, i - start);
+		count += i - start;
+	}
 
-			// Calculate tangential acceleration.
-			{
-				float a = tangential.x;
-				tangential.x = -tangential.y;
-				tangential.y = a;
-			}
+	activeParticles = count;
 
-			// Resize tangential.
-			tangential *= p->tangentialAcceleration;
+	integrateParticles(dt);
+	interpolateParticles();
 
-			// Update velocity.
-			p->velocity += (radial + tangential + p->linearAcceleration) * dt;
+	// Make some more particles.
+	emitParticles(dt);
 
-			// Apply damping.
-			p->velocity *= 1.0f / (1.0f + p->linearDamping * dt);
+	prevPosition = position;
+}
 
-			// Modify position.
-			ppos += p->velocity * dt;
+void ParticleSystem::integrateParticles(float dt)
+{
+	const float *life = pArrays[PARTICLE_LIFE];
+	const float *lifetime = pArrays[PARTICLE_LIFETIME];
+	const float *originX = pArrays[PARTICLE_ORIGIN_X];
+	const float *originY = pArrays[PARTICLE_ORIGIN_Y];
+	const float *accelX = pArrays[PARTICLE_LINEAR_ACCELERATION_X];
+	const float *accelY = pArrays[PARTICLE_LINEAR_ACCELERATION_Y];
+	const float *radialAccel = pArrays[PARTICLE_RADIAL_ACCELERATION];
+	const float *tangentialAccel = pArrays[PARTICLE_TANGENTIAL_ACCELERATION];
+	const float *damping = pArrays[PARTICLE_LINEAR_DAMPING];
+	const float *spinStarts = pArrays[PARTICLE_SPIN_START];
+	const float *spinEnds = pArrays[PARTICLE_SPIN_END];
 
-			p->position = ppos;
+	float *posX = pArrays[PARTICLE_POSITION_X];
+	float *posY = pArrays[PARTICLE_POSITION_Y];
+	float *velX = pArrays[PARTICLE_VELOCITY_X];
+	float *velY = pArrays[PARTICLE_VELOCITY_Y];
+	float *rotation = pArrays[PARTICLE_ROTATION];
 
-			const float t = 1.0f - p->life / p->lifetime;
+	uint32 count = activeParticles;
+	uint32 i = 0;
 
-			// Rotate.
-			p->rotation += (p->spinStart * (1.0f - t) + p->spinEnd * t) * dt;
+#if defined(LOVE_SIMD_SSE)
 
-			p->angle = p->rotation;
+	const __m128 vdt = _mm_set1_ps(dt);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
 
-			if (relativeRotation)
-				p->angle += atan2f(p->velocity.y, p->velocity.x);
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 px = _mm_loadu_ps(&posX[i]);
+		__m128 py = _mm_loadu_ps(&posY[i]);
+
+		// Normalized vector from particle center to particle.
+		__m128 rx = _mm_sub_ps(px, _mm_loadu_ps(&originX[i]));
+		__m128 ry = _mm_sub_ps(py, _mm_loadu_ps(&originY[i]));
+		__m128 len = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(rx, rx), _mm_mul_ps(ry, ry)));
+		__m128 m = _mm_and_ps(_mm_cmpgt_ps(len, zero), _mm_div_ps(one, len));
+		rx = _mm_mul_ps(rx, m);
+		ry = _mm_mul_ps(ry, m);
+
+		// Radial, tangential and linear acceleration.
+		__m128 ra = _mm_loadu_ps(&radialAccel[i]);
+		__m128 ta = _mm_loadu_ps(&tangentialAccel[i]);
+		__m128 ax = _mm_add_ps(_mm_add_ps(_mm_mul_ps(rx, ra), _mm_mul_ps(_mm_sub_ps(zero, ry), ta)), _mm_loadu_ps(&accelX[i]));
+		__m128 ay = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ry, ra), _mm_mul_ps(rx, ta)), _mm_loadu_ps(&accelY[i]));
+
+		__m128 vx = _mm_add_ps(_mm_loadu_ps(&velX[i]), _mm_mul_ps(ax, vdt));
+		__m128 vy = _mm_add_ps(_mm_loadu_ps(&velY[i]), _mm_mul_ps(ay, vdt));
+
+		// Apply damping.
+		__m128 d = _mm_div_ps(one, _mm_add_ps(one, _mm_mul_ps(_mm_loadu_ps(&damping[i]), vdt)));
+		vx = _mm_mul_ps(vx, d);
+		vy = _mm_mul_ps(vy, d);
+
+		_mm_storeu_ps(&velX[i], vx);
+		_mm_storeu_ps(&velY[i], vy);
+		_mm_storeu_ps(&posX[i], _mm_add_ps(px, _mm_mul_ps(vx, vdt)));
+		_mm_storeu_ps(&posY[i], _mm_add_ps(py, _mm_mul_ps(vy, vdt)));
+
+		// Rotate.
+		__m128 t = _mm_sub_ps(one, _mm_div_ps(_mm_loadu_ps(&life[i]), _mm_loadu_ps(&lifetime[i])));
+		__m128 spin = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&spinStarts[i]), _mm_sub_ps(one, t)), _mm_mul_ps(_mm_loadu_ps(&spinEnds[i]), t));
+		_mm_storeu_ps(&rotation[i], _mm_add_ps(_mm_loadu_ps(&rotation[i]), _mm_mul_ps(spin, vdt)));
+	}
 
-			// Change size according to given intervals:
-			// i = 0       1       2      3          n-1
-			//     |-------|-------|------|--- ... ---|
-			// t = 0    1/(n-1)        3/(n-1)        1
-			//
-			// `s' is the interpolation variable scaled to the current
-			// interval width, e.g. if n = 5 and t = 0.3, then the current
-			// indices are 1,2 and s = 0.3 - 0.25 = 0.05
-			float s = p->sizeOffset + t * p->sizeIntervalSize; // size variation
-			s *= (float)(sizes.size() - 1); // 0 <= s < sizes.size()
-			size_t i = (size_t)s;
-			size_t k = (i == sizes.size() - 1) ? i : i + 1; // boundary check (prevents failing on t = 1.0f)
-			s -= (float)i; // transpose s to be in interval [0:1]: i <= s < i + 1 ~> 0 <= s < 1
-			p->size = sizes[i] * (1.0f - s) + sizes[k] * s;
+#elif defined(LOVE_SIMD_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
 
-			// Update color according to given intervals (as above)
-			s = t * (float)(colors.size() - 1);
-			i = (size_t)s;
-			k = (i == colors.size() - 1) ? i : i + 1;
-			s -= (float)i;                            // 0 <= s <= 1
-			p->color = colors[i] * (1.0f - s) + colors[k] * s;
+	const float32x4_t vdt = vdupq_n_f32(dt);
+	const float32x4_t zero = vdupq_n_f32(0.0f);
+	const float32x4_t one = vdupq_n_f32(1.0f);
 
-			// Update the quad index.
-			k = quads.size();
-			if (k > 0)
-			{
-				s = t * (float) k; // [0:numquads-1] (clamped below)
-				i = (s > 0.0f) ? (size_t) s : 0;
-				p->quadIndex = (int) ((i < k) ? i : k - 1);
-			}
+	for (; i + 4 <= count; i += 4)
+	{
+		float32x4_t px = vld1q_f32(&posX[i]);
+		float32x4_t py = vld1q_f32(&posY[i]);
+
+		// Normalized vector from particle center to particle.
+		float32x4_t rx = vsubq_f32(px, vld1q_f32(&originX[i]));
+		float32x4_t ry = vsubq_f32(py, vld1q_f32(&originY[i]));
+		float32x4_t len = vsqrtq_f32(vaddq_f32(vmulq_f32(rx, rx), vmulq_f32(ry, ry)));
+		uint32x4_t nonzero = vcgtq_f32(len, zero);
+		float32x4_t m = vreinterpretq_f32_u32(vandq_u32(nonzero, vreinterpretq_u32_f32(vdivq_f32(one, len))));
+		rx = vmulq_f32(rx, m);
+		ry = vmulq_f32(ry, m);
+
+		// Radial, tangential and linear acceleration.
+		float32x4_t ra = vld1q_f32(&radialAccel[i]);
+		float32x4_t ta = vld1q_f32(&tangentialAccel[i]);
+		float32x4_t ax = vaddq_f32(vaddq_f32(vmulq_f32(rx, ra), vmulq_f32(vnegq_f32(ry), ta)), vld1q_f32(&accelX[i]));
+		float32x4_t ay = vaddq_f32(vaddq_f32(vmulq_f32(ry, ra), vmulq_f32(rx, ta)), vld1q_f32(&accelY[i]));
+
+		float32x4_t vx = vaddq_f32(vld1q_f32(&velX[i]), vmulq_f32(ax, vdt));
+		float32x4_t vy = vaddq_f32(vld1q_f32(&velY[i]), vmulq_f32(ay, vdt));
+
+		// Apply damping.
+		float32x4_t d = vdivq_f32(one, vaddq_f32(one, vmulq_f32(vld1q_f32(&damping[i]), vdt)));
+		vx = vmulq_f32(vx, d);
+		vy = vmulq_f32(vy, d);
+
+		vst1q_f32(&velX[i], vx);
+		vst1q_f32(&velY[i], vy);
+		vst1q_f32(&posX[i], vaddq_f32(px, vmulq_f32(vx, vdt)));
+		vst1q_f32(&posY[i], vaddq_f32(py, vmulq_f32(vy, vdt)));
+
+		// Rotate.
+		float32x4_t t = vsubq_f32(one, vdivq_f32(vld1q_f32(&life[i]), vld1q_f32(&lifetime[i])));
+		float32x4_t spin = vaddq_f32(vmulq_f32(vld1q_f32(&spinStarts[i]), vsubq_f32(one, t)), vmulq_f32(vld1q_f32(&spinEnds[i]), t));
+		vst1q_f32(&rotation[i], vaddq_f32(vld1q_f32(&rotation[i]), vmulq_f32(spin, vdt)));
+	}
+
+#endif
+
+	// Remaining particles, or all of them without SIMD.
+	for (; i < count; i++)
+	{
+		// Get vector from particle center to particle.
+		love::Vector2 radial(posX[i] - originX[i], posY[i] - originY[i]);
+		radial.normalize();
+
+		// Calculate tangential acceleration.
+		love::Vector2 tangential(-radial.y, radial.x);
+		tangential *= tangentialAccel[i];
+
+		// Resize radial acceleration.
+		radial *= radialAccel[i];
+
+		// Update velocity.
+		love::Vector2 velocity(velX[i], velY[i]);
+		velocity += (radial + tangential + love::Vector2(accelX[i], accelY[i])) * dt;
+
+		// Apply damping.
+		velocity *= 1.0f / (1.0f + damping[i] * dt);
+
+		velX[i] = velocity.x;
+		velY[i] = velocity.y;
+
+		// Modify position.
+		posX[i] += velocity.x * dt;
+		posY[i] += velocity.y * dt;
+
+		const float t = 1.0f - life[i] / lifetime[i];
+
+		// Rotate.
+		rotation[i] += (spinStarts[i] * (1.0f - t) + spinEnds[i] * t) * dt;
+	}
+}
 
-			// Next particle.
-			p = p->next;
+void ParticleSystem::interpolateParticles()
+{
+	const float *life = pArrays[PARTICLE_LIFE];
+	const float *lifetime = pArrays[PARTICLE_LIFETIME];
+	const float *velX = pArrays[PARTICLE_VELOCITY_X];
+	const float *velY = pArrays[PARTICLE_VELOCITY_Y];
+	const float *rotation = pArrays[PARTICLE_ROTATION];
+	const float *sizeOffset = pArrays[PARTICLE_SIZE_OFFSET];
+	const float *sizeIntervalSize = pArrays[PARTICLE_SIZE_INTERVAL_SIZE];
+
+	float *angle = pArrays[PARTICLE_ANGLE];
+	float *size = pArrays[PARTICLE_SIZE];
+	float *colorR = pArrays[PARTICLE_COLOR_R];
+	float *colorG = pArrays[PARTICLE_COLOR_G];
+	float *colorB = pArrays[PARTICLE_COLOR_B];
+	float *colorA = pArrays[PARTICLE_COLOR_A];
+	float *quadIndex = pArrays[PARTICLE_QUAD_INDEX];
+
+	for (uint32 n = 0; n < activeParticles; n++)
+	{
+		const float t = 1.0f - life[n] / lifetime[n];
+
+		angle[n] = rotation[n];
+
+		if (relativeRotation)
+			angle[n] += atan2f(velY[n], velX[n]);
+
+		// Change size according to given intervals:
+		// i = 0       1       2      3          n-1
+		//     |-------|-------|------|--- ... ---|
+		// t = 0    1/(n-1)        3/(n-1)        1
+		//
+		// `s' is the interpolation variable scaled to the current
+		// interval width, e.g. if n = 5 and t = 0.3, then the current
+		// indices are 1,2 and s = 0.3 - 0.25 = 0.05
+		float s = sizeOffset[n] + t * sizeIntervalSize[n]; // size variation
+		s *= (float)(sizes.size() - 1); // 0 <= s < sizes.size()
+		size_t i = (size_t)s;
+		size_t k = (i == sizes.size() - 1) ? i : i + 1; // boundary check (prevents failing on t = 1.0f)
+		s -= (float)i; // transpose s to be in interval [0:1]: i <= s < i + 1 ~> 0 <= s < 1
+		size[n] = sizes[i] * (1.0f - s) + sizes[k] * s;
+
+		// Update color according to given intervals (as above)
+		s = t * (float)(colors.size() - 1);
+		i = (size_t)s;
+		k = (i == colors.size() - 1) ? i : i + 1;
+		s -= (float)i;                            // 0 <= s <= 1
+		Colorf color = colors[i] * (1.0f - s) + colors[k] * s;
+		colorR[n] = color.r;
+		colorG[n] = color.g;
+		colorB[n] = color.b;
+		colorA[n] = color.a;
+
+		// Update the quad index.
+		k = quads.size();
+		if (k > 0)
+		{
+			s = t * (float) k; // [0:numquads-1] (clamped below)
+			i = (s > 0.0f) ? (size_t) s : 0;
+			quadIndex[n] = (float) ((i < k) ? i : k - 1);
 		}
 	}
+}
 
-	// Make some more particles.
+void ParticleSystem::emitParticles(float dt)
+{
 	if (active)
 	{
 		float rate = 1.0f / emissionRate; // the amount of time between each particle emit
@@ -1021,12 +1463,306 @@ void ParticleSystem::update(float dt)
 		if (lifetime != -1 && life < 0)
 			stop();
 	}
+}
 
-	prevPosition = position;
+void ParticleSystem::updateGPU(float dt)
+{
+	auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+	Shader *shader = gpuShader.get();
+
+	// Upload newly spawned particles, in contiguous runs of slots.
+	size_t stride = sizeof(GPUParticle);
+	for (size_t i = 0; i < gpuPendingParticles.size();)
+	{
+		size_t count = 1;
+		while (i + count < gpuPendingParticles.size() && gpuPendingParticles[i + count].first == gpuPendingParticles[i].first + count)
+			count++;
+
+		std::vector<GPUParticle> run;
+		run.reserve(count);
+		for (size_t j = i; j < i + count; j++)
+			run.push_back(gpuPendingParticles[j].second);
+
+		gpuParticleBuffer->fill(gpuPendingParticles[i].first * stride, count * stride, run.data());
+		i += count;
+	}
+
+	gpuPendingParticles.clear();
+
+	if (gpuUsedSlots == 0)
+		return;
+
+	// Each quad is 4 vec4s of (position.xy, texcoord.xy).
+	size_t quadcount = std::max<size_t>(quads.size(), 1);
+	std::vector<float> quaddata(quadcount * 4 * 4);
+	for (size_t i = 0; i < quadcount; i++)
+	{
+		Quad *quad = quads.empty() ? texture->getQuad() : quads[i].get();
+		const Vector2 *positions = quad->getVertexPositions();
+		const Vector2 *texcoords = quad->getVertexTexCoords();
+
+		for (int v = 0; v < 4; v++)
+		{
+			float *q = &quaddata[(i * 4 + v) * 4];
+			q[0] = positions[v].x;
+			q[1] = positions[v].y;
+			q[2] = texcoords[v].x;
+			q[3] = texcoords[v].y;
+		}
+	}
+
+	if (gpuQuadBuffer.get() == nullptr || gpuQuadBuffer->getArrayLength() < quadcount * 4)
+	{
+		std::vector<Buffer::DataDeclaration> format = {{ "quad", DATAFORMAT_FLOAT_VEC4 }};
+		Buffer::Settings settings(BUFFERUSAGEFLAG_SHADER_STORAGE, BUFFERDATAUSAGE_DYNAMIC);
+		settings.debugName = "ParticleSystem quads";
+		gpuQuadBuffer.set(gfx->newBuffer(settings, format, nullptr, 0, quadcount * 4), Acquire::NORETAIN);
+	}
+
+	gpuQuadBuffer->fill(0, quaddata.size() * sizeof(float), quaddata.data());
+
+	float sizedata[MAX_SIZES] = {};
+	for (size_t i = 0; i < sizes.size() && i < MAX_SIZES; i++)
+		sizedata[i] = sizes[i];
+
+	float colordata[MAX_COLORS * 4] = {};
+	for (size_t i = 0; i < colors.size() && i < MAX_COLORS; i++)
+	{
+		colordata[i * 4 + 0] = colors[i].r;
+		colordata[i * 4 + 1] = colors[i].g;
+		colordata[i * 4 + 2] = colors[i].b;
+		colordata[i * 4 + 3] = colors[i].a;
+	}
+
+	int sizecount = (int) (sizes.size() < MAX_SIZES ? sizes.size() : MAX_SIZES);
+	int colorcount = (int) (colors.size() < MAX_COLORS ? colors.size() : MAX_COLORS);
+	int quadcountuniform = (int) quadcount;
+	int particlecount = (int) gpuUsedSlots;
+	float offsetdata[2] = { offset.x, offset.y };
+	int relative = relativeRotation ? 1 : 0;
+
+	sendGPUUniform(shader, "sizes", sizedata, sizeof(sizedata));
+	sendGPUUniform(shader, "sizeCount", &sizecount, sizeof(int));
+	sendGPUUniform(shader, "colors", colordata, sizeof(colordata));
+	sendGPUUniform(shader, "colorCount", &colorcount, sizeof(int));
+	sendGPUUniform(shader, "quadCount", &quadcountuniform, sizeof(int));
+	sendGPUUniform(shader, "particleCount", &particlecount, sizeof(int));
+	sendGPUUniform(shader, "deltaTime", &dt, sizeof(float));
+	sendGPUUniform(shader, "particleOffset", offsetdata, sizeof(offsetdata));
+	sendGPUUniform(shader, "relativeRotation", &relative, sizeof(int));
+
+	sendGPUBuffer(shader, "ParticleBuffer", gpuParticleBuffer);
+	sendGPUBuffer(shader, "VertexBuffer", gpuVertexBuffer);
+	sendGPUBuffer(shader, "QuadBuffer", gpuQuadBuffer);
+
+	gfx->dispatchThreadgroups(shader, (gpuUsedSlots + 63) / 64, 1, 1);
+}
+
+void ParticleSystem::drawGPU(Graphics *gfx, const Matrix4 &m)
+{
+	if (gpuUsedSlots == 0 && gpuPendingParticles.empty())
+		return;
+
+	// Particles emitted since the last update still need their vertices.
+	if (!gpuPendingParticles.empty())
+		updateGPU(0.0f);
+
+	gfx->flushBatchedDraws();
+
+	if (Shader::isDefaultActive())
+		Shader::attachDefault(Shader::STANDARD_DEFAULT);
+
+	if (Shader::current)
+		Shader::current->validateDrawState(PRIMITIVE_TRIANGLES, texture);
+
+	Graphics::TempTransform transform(gfx, m);
+
+	BufferBindings vertexbuffers;
+	vertexbuffers.set(0, gpuVertexBuffer, 0);
+
+	Texture *tex = gfx->getTextureOrDefaultForActiveShader(texture);
+	gfx->drawQuads(0, gpuUsedSlots, vertexAttributes, vertexbuffers, tex);
+}
+
+namespace
+{
+
+// Maximum number of worker threads used by ParticleSystem::updateAll.
+const unsigned int MAX_UPDATE_THREADS = 16;
+
+class UpdateWorker;
+
+// State shared between ParticleSystem::updateAll and its worker threads. The
+// calling thread also updates systems, and then waits for the workers.
+struct UpdatePool
+{
+	love::thread::MutexRef mutex;
+	love::thread::ConditionalRef workAvailable;
+	love::thread::ConditionalRef workFinished;
+
+	std::vector<UpdateWorker *> workers;
+
+	const std::vector<ParticleSystem *> *systems = nullptr;
+	float dt = 0.0f;
+	std::atomic<size_t> nextSystem {0};
+
+	uint64 generation = 0;
+	size_t busyWorkers = 0;
+	bool stopping = false;
+
+	void updateSystems()
+	{
+		size_t count = systems->size();
+		for (size_t i = nextSystem++; i < count; i = nextSystem++)
+			(*systems)[i]->update(dt);
+	}
+};
+
+class UpdateWorker : public love::thread::Threadable
+{
+public:
+
+	UpdateWorker(UpdatePool *pool)
+		: pool(pool)
+	{
+		threadName = "ParticleSystemWorker";
+	}
+
+	void threadFunction() override
+	{
+		uint64 generation = 0;
+
+		while (true)
+		{
+			{
+				love::thread::Lock lock(pool->mutex);
+
+				while (!pool->stopping && pool->generation == generation)
+					pool->workAvailable->wait(pool->mutex);
+
+				if (pool->stopping)
+					return;
+
+				generation = pool->generation;
+			}
+
+			pool->updateSystems();
+
+			love::thread::Lock lock(pool->mutex);
+			if (--pool->busyWorkers == 0)
+				pool->workFinished->signal();
+		}
+	}
+
+private:
+
+	UpdatePool *pool;
+};
+
+UpdatePool *updatePool = nullptr;
+
+} // anonymous namespace
+
+void ParticleSystem::updateAll(const std::vector<ParticleSystem *> &systems, float dt)
+{
+	std::vector<ParticleSystem *> cpusystems;
+	cpusystems.reserve(systems.size());
+
+	for (ParticleSystem *system : systems)
+	{
+		if (!system->isGPUSimulation())
+			cpusystems.push_back(system);
+	}
+
+	// A system can't be updated by two threads at once.
+	std::vector<ParticleSystem *> sorted = cpusystems;
+	std::sort(sorted.begin(), sorted.end());
+	if (std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end())
+		throw love::Exception("A ParticleSystem cannot be in the list more than once.");
+
+	// GPU-simulated systems dispatch compute shaders, so they have to be
+	// updated on this thread.
+	for (ParticleSystem *system : systems)
+	{
+		if (system->isGPUSimulation())
+			system->update(dt);
+	}
+
+	unsigned int threads = std::thread::hardware_concurrency();
+
+	if (cpusystems.size() < 2 || threads < 2)
+	{
+		for (ParticleSystem *system : cpusystems)
+			system->update(dt);
+		return;
+	}
+
+	if (updatePool == nullptr)
+	{
+		updatePool = new UpdatePool();
+
+		unsigned int count = std::min(threads - 1, MAX_UPDATE_THREADS);
+		for (unsigned int i = 0; i < count; i++)
+		{
+			UpdateWorker *worker = new UpdateWorker(updatePool);
+			if (worker->start())
+				updatePool->workers.push_back(worker);
+			else
+				worker->release();
+		}
+	}
+
+	UpdatePool *pool = updatePool;
+
+	{
+		love::thread::Lock lock(pool->mutex);
+		pool->systems = &cpusystems;
+		pool->dt = dt;
+		pool->nextSystem = 0;
+		pool->busyWorkers = pool->workers.size();
+		pool->generation++;
+		pool->workAvailable->broadcast();
+	}
+
+	pool->updateSystems();
+
+	love::thread::Lock lock(pool->mutex);
+	while (pool->busyWorkers > 0)
+		pool->workFinished->wait(pool->mutex);
+
+	pool->systems = nullptr;
+}
+
+void ParticleSystem::stopUpdateThreads()
+{
+	if (updatePool == nullptr)
+		return;
+
+	{
+		love::thread::Lock lock(updatePool->mutex);
+		updatePool->stopping = true;
+		updatePool->workAvailable->broadcast();
+	}
+
+	for (UpdateWorker *worker : updatePool->workers)
+	{
+		worker->wait();
+		worker->release();
+	}
+
+	delete updatePool;
+	updatePool = nullptr;
 }
 
 void ParticleSystem::draw(Graphics *gfx, const Matrix4 &m)
 {
+	if (gpuSimulation)
+	{
+		if (getCount() > 0 && texture.get() != nullptr)
+			drawGPU(gfx, m);
+		return;
+	}
+
 	uint32 pCount = getCount();
 
 	if (pCount == 0 || texture.get() == nullptr || pMem == nullptr || buffer == nullptr)
@@ -1044,28 +1780,40 @@ void ParticleSystem::draw(Graphics *gfx, const Matrix4 &m)
 	const Vector2 *texcoords = texture->getQuad()->getVertexTexCoords();
 
 	Vertex *pVerts = (Vertex *) buffer->map(Buffer::MAP_WRITE_INVALIDATE, 0, buffer->getSize());
-	Particle *p = pHead;
+
+	const float *posX = pArrays[PARTICLE_POSITION_X];
+	const float *posY = pArrays[PARTICLE_POSITION_Y];
+	const float *angle = pArrays[PARTICLE_ANGLE];
+	const float *size = pArrays[PARTICLE_SIZE];
+	const float *colorR = pArrays[PARTICLE_COLOR_R];
+	const float *colorG = pArrays[PARTICLE_COLOR_G];
+	const float *colorB = pArrays[PARTICLE_COLOR_B];
+	const float *colorA = pArrays[PARTICLE_COLOR_A];
+	const float *quadIndex = pArrays[PARTICLE_QUAD_INDEX];
 
 	bool useQuads = !quads.empty();
 
 	Matrix3 t;
 
 	// set the vertex data for each particle (transformation, texcoords, color)
-	while (p)
+	for (uint32 n = 0; n < pCount; n++)
 	{
+		uint32 i = pReversed ? pCount - 1 - n : n;
+
 		if (useQuads)
 		{
-			positions = quads[p->quadIndex]->getVertexPositions();
-			texcoords = quads[p->quadIndex]->getVertexTexCoords();
+			int q = (int) quadIndex[i];
+			positions = quads[q]->getVertexPositions();
+			texcoords = quads[q]->getVertexTexCoords();
 		}
 
 		// particle vertices are image vertices transformed by particle info
-		t.setTransformation(p->position.x, p->position.y, p->angle, p->size, p->size, offset.x, offset.y, 0.0f, 0.0f);
+		t.setTransformation(posX[i], posY[i], angle[i], size[i], size[i], offset.x, offset.y, 0.0f, 0.0f);
 		t.transformXY(pVerts, positions, 4);
 
 		// Particle colors are stored as floats (0-1) but vertex colors are
 		// unsigned bytes (0-255).
-		Color32 c = toColor32(p->color);
+		Color32 c = toColor32(Colorf(colorR[i], colorG[i], colorB[i], colorA[i]));
 
 		// set the texture coordinate and color data for particle vertices
 		for (int v = 0; v < 4; v++)
@@ -1076,7 +1824,6 @@ void ParticleSystem::draw(Graphics *gfx, const Matrix4 &m)
 		}
 
 		pVerts += 4;
-		p = p->next;
 	}
 
 	buffer->unmap(0, pCount * sizeof(Vertex) * 4);
@@ -30,6 +30,8 @@
 #include "Quad.h"
 #include "Texture.h"
 #include "Buffer.h"
+#include "Shader.h"
+#include "modules/math/RandomGenerator.h"
 
 // STL
 #include <vector>
@@ -83,6 +85,10 @@ public:
 	 **/
 	static const uint32 MAX_PARTICLES = LOVE_INT32_MAX / 4;
 
+	// Used by the GPU simulation path, which uses fixed-size uniform arrays.
+	static const size_t MAX_SIZES = 8;
+	static const size_t MAX_COLORS = 8;
+
 	/**
 	 * Creates a particle system with the specified buffer size and texture.
 	 **/
@@ -510,6 +516,27 @@ public:
 	 **/
 	void update(float dt);
 
+	/**
+	 * Sets whether particles are simulated and turned into vertices on the GPU
+	 * with a compute shader. New particles are still initialized on the CPU.
+	 * The insert mode is ignored in this mode, and changing it removes all
+	 * existing particles.
+	 **/
+	void setGPUSimulation(bool enable);
+	bool isGPUSimulation() const;
+
+	/**
+	 * Updates several particle systems at once. CPU-simulated systems are
+	 * spread across worker threads, with the same results as calling update
+	 * on each of them in order.
+	 **/
+	static void updateAll(const std::vector<ParticleSystem *> &systems, float dt);
+
+	/**
+	 * Stops the worker threads used by updateAll, if they were started.
+	 **/
+	static void stopUpdateThreads();
+
 	// Implements Drawable.
 	void draw(Graphics *gfx, const Matrix4 &m) override;
 
@@ -523,12 +550,10 @@ public:
 
 private:
 
-	// Represents a single particle.
+	// Represents a single particle. Only used while spawning, live particles
+	// are stored in separate per-attribute arrays (see ParticleArray.)
 	struct Particle
 	{
-		Particle *prev;
-		Particle *next;
-
 		float lifetime;
 		float life;
 
@@ -558,35 +583,94 @@ private:
 		int quadIndex;
 	};
 
+	// Particle data in the compute shader's storage buffer. Must match the
+	// struct in the shader code.
+	struct GPUParticle
+	{
+		float positionVelocity[4];
+		float originAcceleration[4];
+		float accelerationDamping[4]; // radial, tangential, damping, size offset.
+		float lifeSize[4]; // life, lifetime, size interval, rotation.
+		float spin[4]; // start, end, whether it's new, unused.
+	};
+
 	void resetOffset();
 
 	void createBuffers(size_t size);
 	void deleteBuffers();
 
+	void createGPUBuffers(size_t size);
+	void addGPUParticle(float t);
+	void updateGPU(float dt);
+	void drawGPU(Graphics *gfx, const Matrix4 &m);
+
+	void emitParticles(float dt);
+
 	void addParticle(float t);
-	Particle *removeParticle(Particle *p);
 
 	// Called by addParticle.
 	void initParticle(Particle *p, float t);
-	void insertTop(Particle *p);
-	void insertBottom(Particle *p);
-	void insertRandom(Particle *p);
+	void insertParticle(const Particle &p);
 
-	// Pointer to the beginning of the allocated memory.
-	Particle *pMem;
+	void setParticle(uint32 index, const Particle &p);
+	void moveParticles(uint32 dst, uint32 src, uint32 count);
+	void reverseParticles();
 
-	// Pointer to a free particle.
-	Particle *pFree;
+	// Called by update.
+	void integrateParticles(float dt);
+	void interpolateParticles();
 
-	// Pointer to the start of the linked list.
-	Particle *pHead;
+	// Per-particle attributes. Each one is a separate array so the update loops
+	// can process several particles at once with SIMD instructions.
+	enum ParticleArray
+	{
+		PARTICLE_LIFE,
+		PARTICLE_LIFETIME,
+		PARTICLE_POSITION_X,
+		PARTICLE_POSITION_Y,
+		PARTICLE_ORIGIN_X,
+		PARTICLE_ORIGIN_Y,
+		PARTICLE_VELOCITY_X,
+		PARTICLE_VELOCITY_Y,
+		PARTICLE_LINEAR_ACCELERATION_X,
+		PARTICLE_LINEAR_ACCELERATION_Y,
+		PARTICLE_RADIAL_ACCELERATION,
+		PARTICLE_TANGENTIAL_ACCELERATION,
+		PARTICLE_LINEAR_DAMPING,
+		PARTICLE_SIZE,
+		PARTICLE_SIZE_OFFSET,
+		PARTICLE_SIZE_INTERVAL_SIZE,
+		PARTICLE_ROTATION,
+		PARTICLE_ANGLE,
+		PARTICLE_SPIN_START,
+		PARTICLE_SPIN_END,
+		PARTICLE_COLOR_R,
+		PARTICLE_COLOR_G,
+		PARTICLE_COLOR_B,
+		PARTICLE_COLOR_A,
+		PARTICLE_QUAD_INDEX, // Stored as a float, like everything else.
+		PARTICLE_ARRAY_MAX_ENUM
+	};
+
+	// Pointer to the beginning of the allocated memory, which holds every
+	// particle array.
+	float *pMem;
+
+	// The start of each particle array. Live particles are always the first
+	// activeParticles elements, with no gaps.
+	float *pArrays[PARTICLE_ARRAY_MAX_ENUM];
 
-	// Pointer to the end of the linked list.
-	Particle *pTail;
+	// Whether particles are stored in the reverse of the order they're drawn.
+	// Used in bottom insert mode, so new particles can always be appended.
+	bool pReversed;
 
 	// The texture to be drawn.
 	StrongRef<Texture> texture;
 
+	// Each system has its own random generator, so systems can be updated on
+	// different threads with deterministic results.
+	love::math::RandomGenerator rng;
+
 	// Whether the particle emitter is active.
 	bool active;
 
@@ -676,6 +760,20 @@ private:
 	const VertexAttributes vertexAttributes;
 	Buffer *buffer;
 
+	bool gpuSimulation;
+	StrongRef<Shader> gpuShader;
+	StrongRef<Buffer> gpuParticleBuffer;
+	StrongRef<Buffer> gpuVertexBuffer;
+	StrongRef<Buffer> gpuQuadBuffer;
+
+	// The time each GPU particle slot's particle dies, used to track the
+	// particle count without reading data back from the GPU.
+	std::vector<double> gpuDeathTimes;
+	std::vector<std::pair<uint32, GPUParticle>> gpuPendingParticles;
+	uint32 gpuNextSlot;
+	uint32 gpuUsedSlots;
+	double gpuTime;
+
 	static StringMap<AreaSpreadDistribution, DISTRIBUTION_MAX_ENUM>::Entry distributionsEntries[];
 	static StringMap<AreaSpreadDistribution, DISTRIBUTION_MAX_ENUM> distributions;
 
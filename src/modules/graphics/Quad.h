@@ -23,6 +23,7 @@
 
 // LOVE
 #include "common/Object.h"
+#include "common/memory.h"
 #include "common/math.h"
 #include "common/Vector.h"
 
@@ -31,7 +32,7 @@ namespace love
 namespace graphics
 {
 
-class Quad : public Object
+class Quad : public Object, public Pooled<Quad>
 {
 public:
 
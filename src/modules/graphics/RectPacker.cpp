@@ -0,0 +1,133 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "RectPacker.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace love
+{
+namespace graphics
+{
+
+RectPacker::RectPacker(int width, int height)
+	: width(width)
+	, height(height)
+{
+	skyline.push_back({0, 0, width});
+}
+
+bool RectPacker::fits(size_t index, int w, int h, int &y) const
+{
+	int x = skyline[index].x;
+	if (x + w > width)
+		return false;
+
+	int remaining = w;
+	y = skyline[index].y;
+
+	// The rectangle rests on the highest segment it spans.
+	for (size_t i = index; remaining > 0; i++)
+	{
+		if (i >= skyline.size())
+			return false;
+
+		y = std::max(y, skyline[i].y);
+		if (y + h > height)
+			return false;
+
+		remaining -= skyline[i].width;
+	}
+
+	return true;
+}
+
+bool RectPacker::pack(int w, int h, int &x, int &y)
+{
+	if (w <= 0 || h <= 0)
+		return false;
+
+	int besttop = std::numeric_limits<int>::max();
+	int bestwidth = std::numeric_limits<int>::max();
+	size_t bestindex = skyline.size();
+
+	for (size_t i = 0; i < skyline.size(); i++)
+	{
+		int top = 0;
+		if (!fits(i, w, h, top))
+			continue;
+
+		// Prefer the lowest top edge, then the narrowest segment.
+		if (top + h < besttop || (top + h == besttop && skyline[i].width < bestwidth))
+		{
+			besttop = top + h;
+			bestwidth = skyline[i].width;
+			bestindex = i;
+			x = skyline[i].x;
+			y = top;
+		}
+	}
+
+	if (bestindex == skyline.size())
+		return false;
+
+	addSegment(bestindex, x, y, w, h);
+	return true;
+}
+
+void RectPacker::addSegment(size_t index, int x, int y, int w, int h)
+{
+	skyline.insert(skyline.begin() + index, {x, y + h, w});
+
+	// Trim or remove the segments the new one covers.
+	for (size_t i = index + 1; i < skyline.size(); i++)
+	{
+		const Segment &prev = skyline[i - 1];
+		int prevend = prev.x + prev.width;
+
+		if (skyline[i].x >= prevend)
+			break;
+
+		int shrink = prevend - skyline[i].x;
+		skyline[i].x += shrink;
+		skyline[i].width -= shrink;
+
+		if (skyline[i].width > 0)
+			break;
+
+		skyline.erase(skyline.begin() + i);
+		i--;
+	}
+
+	// Merge neighbours at the same height.
+	for (size_t i = 0; i + 1 < skyline.size(); i++)
+	{
+		if (skyline[i].y == skyline[i + 1].y)
+		{
+			skyline[i].width += skyline[i + 1].width;
+			skyline.erase(skyline.begin() + i + 1);
+			i--;
+		}
+	}
+}
+
+} // graphics
+} // love
@@ -0,0 +1,69 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// C++
+#include <cstddef>
+#include <vector>
+
+namespace love
+{
+namespace graphics
+{
+
+/**
+ * Packs rectangles into a fixed-size area with the skyline bottom-left
+ * heuristic: the top edge of everything placed so far is kept as a list of
+ * horizontal segments, and each rectangle goes wherever its top ends up
+ * lowest. Rectangles are never moved once placed.
+ **/
+class RectPacker
+{
+public:
+
+	RectPacker(int width, int height);
+
+	/**
+	 * Finds room for a w by h rectangle and reserves it.
+	 * @return false if it doesn't fit, in which case nothing changes.
+	 **/
+	bool pack(int w, int h, int &x, int &y);
+
+private:
+
+	struct Segment
+	{
+		int x;
+		int y;
+		int width;
+	};
+
+	bool fits(size_t index, int w, int h, int &y) const;
+	void addSegment(size_t index, int x, int y, int w, int h);
+
+	int width;
+	int height;
+	std::vector<Segment> skyline;
+
+}; // RectPacker
+
+} // graphics
+} // love
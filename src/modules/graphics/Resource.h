@@ -34,6 +34,12 @@ public:
 	virtual ~Resource() {}
 	virtual ptrdiff_t getHandle() const = 0;
 
+	/**
+	 * Byte offset of this resource's data within the API object returned by
+	 * getHandle. Non-zero for buffers placed in a shared page.
+	 **/
+	virtual size_t getHandleOffset() const { return 0; }
+
 }; // Resource
 
 } // graphics
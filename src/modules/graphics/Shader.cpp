@@ -57,6 +57,12 @@ static const char global_syntax[] = R"(
 #define DepthCubeImage samplerCubeShadow
 #define extern uniform
 
+#ifdef LOVE_SPECIALIZATION_CONSTANTS
+	#define SpecializationConstant(id) layout (constant_id = id) const
+#else
+	#define SpecializationConstant(id) const
+#endif
+
 #if __VERSION__ >= 430 || (defined(GL_ES) && __VERSION__ >= 310)
 	layout (std430) buffer;
 #endif
@@ -72,6 +78,8 @@ uniform highp vec4 love_UniformsPerDraw[12];
 
 #define CurrentDPIScale (love_UniformsPerDraw[8].x)
 #define ConstantPointSize (love_UniformsPerDraw[8].y)
+#define ConstantLineWidth (love_UniformsPerDraw[8].z)
+#define love_LineSmooth (love_UniformsPerDraw[8].w)
 #define love_ClipSpaceParams (love_UniformsPerDraw[9])
 #define ConstantColor (love_UniformsPerDraw[10])
 #define love_ScreenSize (love_UniformsPerDraw[11])
@@ -770,6 +778,76 @@ const Shader::UniformInfo *Shader::getUniformInfo(const std::string &name) const
 	return it != reflection.allUniforms.end() ? it->second : nullptr;
 }
 
+void Shader::updateUniforms(const UniformUpdate *updates, int count)
+{
+	for (int i = 0; i < count; i++)
+		updateUniform(updates[i].first, updates[i].second);
+}
+
+void Shader::setSpecializationConstant(const std::string &name, double value)
+{
+	auto it = specializationConstants.find(name);
+	if (it == specializationConstants.end())
+		throw love::Exception("Shader specialization constant '%s' does not exist.", name.c_str());
+
+	SpecializationConstant &constant = it->second;
+	LocalUniformValue newvalue = {};
+
+	switch (constant.baseType)
+	{
+	case DATA_BASETYPE_FLOAT:
+		newvalue.f = (float) value;
+		break;
+	case DATA_BASETYPE_INT:
+		newvalue.i = (int32) value;
+		break;
+	case DATA_BASETYPE_UINT:
+		newvalue.u = (uint32) value;
+		break;
+	case DATA_BASETYPE_BOOL:
+		newvalue.u = value != 0.0 ? 1 : 0;
+		break;
+	default:
+		throw love::Exception("Unsupported type for shader specialization constant '%s'.", name.c_str());
+	}
+
+	if (newvalue.u == constant.value.u)
+		return;
+
+	// Batched draws which haven't been submitted yet use the old value.
+	if (current == this)
+		Graphics::flushBatchedDrawsGlobal();
+
+	constant.value = newvalue;
+	specializationConstantsChanged();
+}
+
+bool Shader::getSpecializationConstant(const std::string &name, double &value) const
+{
+	auto it = specializationConstants.find(name);
+	if (it == specializationConstants.end())
+		return false;
+
+	const SpecializationConstant &constant = it->second;
+
+	if (constant.baseType == DATA_BASETYPE_FLOAT)
+		value = constant.value.f;
+	else if (constant.baseType == DATA_BASETYPE_INT)
+		value = constant.value.i;
+	else
+		value = constant.value.u;
+
+	return true;
+}
+
+void Shader::getSpecializationData(std::vector<uint32> &data) const
+{
+	data.clear();
+	data.reserve(specializationConstants.size());
+	for (const auto &kvp : specializationConstants)
+		data.push_back(kvp.second.value.u);
+}
+
 bool Shader::hasUniform(const std::string &name) const
 {
 	const auto it = reflection.allUniforms.find(name);
@@ -1622,6 +1700,115 @@ vec4 position(mat4 clipSpaceFromLocal, vec4 localPosition)
 }
 )";
 
+// Used by instanced SpriteBatches. Each instance is a unit quad, transformed
+// by the per-instance attributes. See SpriteBatch::SpriteInstance.
+static const std::string defaultInstancedSpritesVertex = R"(
+attribute vec4 InstanceTransformX;
+attribute vec3 InstanceTransformY;
+attribute vec4 InstanceTexCoord;
+attribute vec4 InstanceColor;
+
+vec4 position(mat4 clipSpaceFromLocal, vec4 localPosition)
+{
+	vec3 unit = vec3(localPosition.xy, 1.0);
+	VaryingTexCoord = vec4(InstanceTexCoord.xy + localPosition.xy * InstanceTexCoord.zw, InstanceTransformX.w, 1.0);
+	VaryingColor = gammaCorrectColor(InstanceColor) * ConstantColor;
+	return clipSpaceFromLocal * vec4(dot(InstanceTransformX.xyz, unit), dot(InstanceTransformY, unit), 0.0, 1.0);
+}
+)";
+
+// Used by Graphics::drawLines. Each instance is one segment of the line, with
+// the points before and after it used to compute miter joins. The unit quad's
+// x is 0 at the segment start and 1 at its end, and y is -1 or 1 for the two
+// sides of the line.
+static const std::string defaultLinesVertex = R"(
+attribute vec2 LinePrevious;
+attribute vec2 LineStart;
+attribute vec2 LineEnd;
+attribute vec2 LineNext;
+
+vec2 lineOffset(vec2 dirin, vec2 dirout, vec2 normal, float width, bool join)
+{
+	vec2 tangent = dirin + dirout;
+	if (!join || dot(tangent, tangent) < 0.0001)
+		return normal * width;
+
+	tangent = normalize(tangent);
+	vec2 miter = vec2(-tangent.y, tangent.x);
+	float d = dot(miter, normal);
+
+	// Very sharp joins fall back to no join rather than a long spike.
+	if (d < 0.25)
+		return normal * width;
+
+	return miter * (width / d);
+}
+
+vec4 position(mat4 clipSpaceFromLocal, vec4 localPosition)
+{
+	vec2 dir = LineEnd - LineStart;
+	float len = length(dir);
+	dir = len > 0.0 ? dir / len : vec2(1.0, 0.0);
+	vec2 normal = vec2(-dir.y, dir.x);
+
+	float scale = 0.5 * (length(TransformMatrix[0].xy) + length(TransformMatrix[1].xy)) * CurrentDPIScale;
+	float pixelsize = love_LineSmooth > 0.0 ? 1.0 / max(scale, 0.000001) : 0.0;
+	float halfwidth = ConstantLineWidth * 0.5;
+	float edge = halfwidth + pixelsize * 0.5;
+
+	bool atend = localPosition.x > 0.5;
+	vec2 point = atend ? LineEnd : LineStart;
+	vec2 otherdir = atend ? LineNext - LineEnd : LineStart - LinePrevious;
+	float otherlen = length(otherdir);
+	otherdir = otherlen > 0.0 ? otherdir / otherlen : dir;
+
+	vec2 offset = atend
+		? lineOffset(dir, otherdir, normal, edge, otherlen > 0.0)
+		: lineOffset(otherdir, dir, normal, edge, otherlen > 0.0);
+
+	VaryingTexCoord = vec4(localPosition.y * edge, halfwidth, pixelsize, 0.0);
+	VaryingColor = ConstantColor;
+	return clipSpaceFromLocal * vec4(point + offset * localPosition.y, 0.0, 1.0);
+}
+)";
+
+// Used by Meshes with a bone Buffer. Each bone is two texels, the rows of its
+// 2D affine transform. See Mesh::setBoneBuffer.
+static const std::string defaultSkinnedVertex = R"(
+attribute vec4 VertexBoneIndices;
+attribute vec4 VertexBoneWeights;
+
+uniform highp samplerBuffer love_BoneTransforms;
+
+vec2 love_skinPosition(vec3 position, float bone)
+{
+	int i = int(bone) * 2;
+	return vec2(dot(texelFetch(love_BoneTransforms, i).xyz, position), dot(texelFetch(love_BoneTransforms, i + 1).xyz, position));
+}
+
+vec4 position(mat4 clipSpaceFromLocal, vec4 localPosition)
+{
+	vec3 p = vec3(localPosition.xy, 1.0);
+	vec2 skinned = love_skinPosition(p, VertexBoneIndices.x) * VertexBoneWeights.x
+		+ love_skinPosition(p, VertexBoneIndices.y) * VertexBoneWeights.y
+		+ love_skinPosition(p, VertexBoneIndices.z) * VertexBoneWeights.z
+		+ love_skinPosition(p, VertexBoneIndices.w) * VertexBoneWeights.w;
+	return clipSpaceFromLocal * vec4(skinned, localPosition.zw);
+}
+)";
+
+// VaryingTexCoord.x is the signed distance from the line's center, y is half
+// the line width, and z is the size of a pixel when antialiasing.
+static const std::string defaultLinesPixel = R"(
+void effect()
+{
+	float alpha = 1.0;
+	if (VaryingTexCoord.z > 0.0)
+		alpha = clamp((VaryingTexCoord.y - abs(VaryingTexCoord.x)) / VaryingTexCoord.z + 0.5, 0.0, 1.0);
+	love_PixelColor = vec4(VaryingColor.rgb, VaryingColor.a * alpha);
+}
+)";
+
 static const std::string defaultStandardPixel = R"(
 vec4 effect(vec4 vcolor, Image tex, vec2 texcoord, vec2 pixcoord)
 {
@@ -1629,6 +1816,18 @@ vec4 effect(vec4 vcolor, Image tex, vec2 texcoord, vec2 pixcoord)
 }
 )";
 
+// Used by Fonts with signed distance field glyphs. The distance is stored in
+// the alpha channel, with the glyph edge at 0.5.
+static const std::string defaultSDFTextPixel = R"(
+vec4 effect(vec4 vcolor, Image tex, vec2 texcoord, vec2 pixcoord)
+{
+	vec4 texel = Texel(tex, texcoord);
+	float width = max(fwidth(texel.a) * 0.5, 0.0001);
+	float alpha = smoothstep(0.5 - width, 0.5 + width, texel.a);
+	return vec4(texel.rgb, alpha) * vcolor;
+}
+)";
+
 static const std::string defaultVideoPixel = R"(
 void effect()
 {
@@ -1650,6 +1849,12 @@ const std::string &Shader::getDefaultCode(StandardShader shader, ShaderStageType
 	{
 		if (shader == STANDARD_POINTS)
 			return defaultPointsVertex;
+		else if (shader == STANDARD_INSTANCED_SPRITES || shader == STANDARD_INSTANCED_SPRITES_ARRAY)
+			return defaultInstancedSpritesVertex;
+		else if (shader == STANDARD_LINES)
+			return defaultLinesVertex;
+		else if (shader == STANDARD_SKINNED)
+			return defaultSkinnedVertex;
 		else
 			return defaultVertex;
 	}
@@ -1662,6 +1867,11 @@ const std::string &Shader::getDefaultCode(StandardShader shader, ShaderStageType
 		case STANDARD_VIDEO: return defaultVideoPixel;
 		case STANDARD_ARRAY: return defaultArrayPixel;
 		case STANDARD_POINTS: return defaultStandardPixel;
+		case STANDARD_INSTANCED_SPRITES: return defaultStandardPixel;
+		case STANDARD_INSTANCED_SPRITES_ARRAY: return defaultArrayPixel;
+		case STANDARD_SDF_TEXT: return defaultSDFTextPixel;
+		case STANDARD_LINES: return defaultLinesPixel;
+		case STANDARD_SKINNED: return defaultStandardPixel;
 		case STANDARD_MAX_ENUM: return nocode;
 	}
 
@@ -1687,6 +1897,92 @@ static StringMap<Shader::BuiltinUniform, Shader::BUILTIN_MAX_ENUM>::Entry builti
 
 static StringMap<Shader::BuiltinUniform, Shader::BUILTIN_MAX_ENUM> builtinNames(builtinNameEntries, sizeof(builtinNameEntries));
 
+love::Type ShaderVariants::type("ShaderVariants", &Object::type);
+
+ShaderVariants::ShaderVariants(const std::vector<std::string> &features)
+	: features(features)
+{
+	if (features.size() > (size_t) MAX_FEATURES)
+		throw love::Exception("Shader variants can have at most %d features.", MAX_FEATURES);
+
+	for (size_t i = 0; i < features.size(); i++)
+	{
+		if (features[i].empty())
+			throw love::Exception("Shader variant feature names must not be empty.");
+
+		for (size_t j = 0; j < i; j++)
+		{
+			if (features[i] == features[j])
+				throw love::Exception("Shader variant feature '%s' is declared more than once.", features[i].c_str());
+		}
+	}
+}
+
+ShaderVariants::~ShaderVariants()
+{
+}
+
+uint32 ShaderVariants::getFeatureBit(const std::string &feature) const
+{
+	for (size_t i = 0; i < features.size(); i++)
+	{
+		if (features[i] == feature)
+			return 1u << i;
+	}
+
+	throw love::Exception("Unknown shader variant feature '%s'.", feature.c_str());
+}
+
+bool ShaderVariants::isValidMask(uint32 mask) const
+{
+	return features.size() >= (size_t) MAX_FEATURES || (mask >> features.size()) == 0;
+}
+
+void ShaderVariants::addVariant(uint32 mask, Shader *shader)
+{
+	if (!isValidMask(mask))
+		throw love::Exception("Shader variant mask %u uses features which weren't declared.", mask);
+
+	variants[mask].set(shader);
+}
+
+bool ShaderVariants::hasVariant(uint32 mask) const
+{
+	return variants.find(mask) != variants.end();
+}
+
+Shader *ShaderVariants::getShader(uint32 mask) const
+{
+	auto it = variants.find(mask);
+	if (it == variants.end())
+		throw love::Exception("Shader variant with feature mask %u was not compiled.", mask);
+
+	return it->second.get();
+}
+
+void ShaderVariants::getVariantMasks(std::vector<uint32> &masks) const
+{
+	masks.clear();
+	masks.reserve(variants.size());
+	for (const auto &kvp : variants)
+		masks.push_back(kvp.first);
+}
+
+bool ShaderVariants::isReady()
+{
+	// Query every variant, so each one which is done gets finalized.
+	bool ready = true;
+	for (auto &kvp : variants)
+		ready = kvp.second->isReady() && ready;
+	return ready;
+}
+
+void ShaderVariants::waitUntilReady()
+{
+	for (auto &kvp : variants)
+		kvp.second->waitUntilReady();
+}
+
 bool Shader::getConstant(const char *in, Language &out)
 {
 	return languages.find(in, out);
@@ -89,6 +89,11 @@ public:
 		STANDARD_VIDEO,
 		STANDARD_ARRAY,
 		STANDARD_POINTS,
+		STANDARD_INSTANCED_SPRITES,
+		STANDARD_INSTANCED_SPRITES_ARRAY,
+		STANDARD_SDF_TEXT,
+		STANDARD_LINES,
+		STANDARD_SKINNED,
 		STANDARD_MAX_ENUM
 	};
 
@@ -119,6 +124,7 @@ public:
 	{
 		std::map<std::string, std::string> defines;
 		std::string debugName;
+		bool async = false;
 	};
 
 	struct SourceInfo
@@ -172,6 +178,9 @@ public:
 		size_t dataSize;
 	};
 
+	// A uniform whose values have changed, and how many array elements to update.
+	typedef std::pair<const UniformInfo *, int> UniformUpdate;
+
 	union LocalUniformValue
 	{
 		float f;
@@ -179,6 +188,14 @@ public:
 		uint32 u;
 	};
 
+	// A constant declared with SpecializationConstant(id) in shader code.
+	struct SpecializationConstant
+	{
+		uint32 id;
+		DataBaseType baseType;
+		LocalUniformValue value;
+	};
+
 	// The members in here must respect uniform buffer alignment/padding rules.
  	struct BuiltinUniformData
  	{
@@ -231,6 +248,18 @@ public:
 	 */
 	static Vector4 computeClipSpaceParams(uint32 clipSpaceTransformFlags);
 
+	/**
+	 * Gets whether the Shader has finished compiling. Shaders created with the
+	 * async option may still be compiling in the background, in which case
+	 * using them waits for compilation to finish. Throws if compiling failed.
+	 **/
+	virtual bool isReady() { return true; }
+
+	/**
+	 * Waits for any in-progress background compilation to finish.
+	 **/
+	virtual void waitUntilReady() {}
+
 	/**
 	 * Returns any warnings this Shader may have generated.
 	 **/
@@ -245,6 +274,22 @@ public:
 
 	virtual void updateUniform(const UniformInfo *info, int count) = 0;
 
+	/**
+	 * Updates several uniforms at once, after their values have been changed.
+	 * Backends can avoid repeating work which is needed for any update.
+	 **/
+	virtual void updateUniforms(const UniformUpdate *updates, int count);
+
+	/**
+	 * Sets the value of a specialization constant. Backends which support them
+	 * (Vulkan and Metal) use the new value in subsequent draws without
+	 * recompiling the shader's code. Other backends don't expose any, and
+	 * constants keep the value they're declared with.
+	 **/
+	void setSpecializationConstant(const std::string &name, double value);
+	bool getSpecializationConstant(const std::string &name, double &value) const;
+	const std::map<std::string, SpecializationConstant> &getSpecializationConstants() const { return specializationConstants; }
+
 	virtual void sendTextures(const UniformInfo *info, Texture **textures, int count) = 0;
 	virtual void sendBuffers(const UniformInfo *info, Buffer **buffers, int count) = 0;
 
@@ -310,6 +355,12 @@ protected:
 
 	std::string getShaderStageDebugName(ShaderStageType stage) const;
 
+	// Called after a specialization constant's value changes.
+	virtual void specializationConstantsChanged() {}
+
+	// Gets the values of all specialization constants, ordered by name.
+	void getSpecializationData(std::vector<uint32> &data) const;
+
 	void handleUnknownUniformName(const char *name);
 
 	// std140 uniform buffer alignment-aware copy.
@@ -332,7 +383,58 @@ protected:
 
 	std::string debugName;
 
+	std::map<std::string, SpecializationConstant> specializationConstants;
+
 }; // Shader
 
+/**
+ * A set of Shaders compiled from the same code, where each variant enables a
+ * different combination of feature defines. Variants are compiled up front and
+ * selected with a bitmask of their features when drawing.
+ **/
+class ShaderVariants : public Object
+{
+public:
+
+	static love::Type type;
+
+	static const int MAX_FEATURES = 32;
+
+	ShaderVariants(const std::vector<std::string> &features);
+	virtual ~ShaderVariants();
+
+	const std::vector<std::string> &getFeatures() const { return features; }
+
+	/**
+	 * Gets the bit used for the given feature name. Throws if the feature
+	 * wasn't declared.
+	 **/
+	uint32 getFeatureBit(const std::string &feature) const;
+
+	// Whether the mask only uses declared features.
+	bool isValidMask(uint32 mask) const;
+
+	void addVariant(uint32 mask, Shader *shader);
+	bool hasVariant(uint32 mask) const;
+
+	/**
+	 * Gets the variant compiled for exactly the given features. Throws if it
+	 * wasn't in the declared set of variants.
+	 **/
+	Shader *getShader(uint32 mask) const;
+
+	int getVariantCount() const { return (int) variants.size(); }
+	void getVariantMasks(std::vector<uint32> &masks) const;
+
+	bool isReady();
+	void waitUntilReady();
+
+private:
+
+	std::vector<std::string> features;
+	std::map<uint32, StrongRef<Shader>> variants;
+
+}; // ShaderVariants
+
 } // graphics
 } // love
@@ -0,0 +1,364 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "ShapeBatch.h"
+
+#include <algorithm>
+
+namespace love
+{
+namespace graphics
+{
+
+love::Type ShapeBatch::type("ShapeBatch", &Drawable::type);
+
+ShapeBatch::ShapeBatch()
+	: color(1.0f, 1.0f, 1.0f, 1.0f)
+	, lineWidth(1.0f)
+	, lineJoin(Graphics::LINE_JOIN_MITER)
+	, lineStyle(Graphics::LINE_SMOOTH)
+	, dirty(false)
+	, indexDataType(INDEX_UINT16)
+	, vertexCount(0)
+	, indexCount(0)
+{
+}
+
+ShapeBatch::~ShapeBatch()
+{
+}
+
+void ShapeBatch::addCommand(const Command &cmd)
+{
+	commands.push_back(cmd);
+	commands.back().color = color;
+	dirty = true;
+}
+
+void ShapeBatch::rectangle(Graphics::DrawMode mode, float x, float y, float w, float h, float rx, float ry, int points)
+{
+	Command cmd = {};
+	cmd.type = COMMAND_RECTANGLE;
+	cmd.drawMode = mode;
+	cmd.points = points;
+	cmd.params[0] = x;
+	cmd.params[1] = y;
+	cmd.params[2] = w;
+	cmd.params[3] = h;
+	cmd.params[4] = rx;
+	cmd.params[5] = ry;
+	addCommand(cmd);
+}
+
+void ShapeBatch::circle(Graphics::DrawMode mode, float x, float y, float radius, int points)
+{
+	Command cmd = {};
+	cmd.type = COMMAND_CIRCLE;
+	cmd.drawMode = mode;
+	cmd.points = points;
+	cmd.params[0] = x;
+	cmd.params[1] = y;
+	cmd.params[2] = radius;
+	addCommand(cmd);
+}
+
+void ShapeBatch::ellipse(Graphics::DrawMode mode, float x, float y, float a, float b, int points)
+{
+	Command cmd = {};
+	cmd.type = COMMAND_ELLIPSE;
+	cmd.drawMode = mode;
+	cmd.points = points;
+	cmd.params[0] = x;
+	cmd.params[1] = y;
+	cmd.params[2] = a;
+	cmd.params[3] = b;
+	addCommand(cmd);
+}
+
+void ShapeBatch::arc(Graphics::DrawMode drawmode, Graphics::ArcMode arcmode, float x, float y, float radius, float angle1, float angle2, int points)
+{
+	Command cmd = {};
+	cmd.type = COMMAND_ARC;
+	cmd.drawMode = drawmode;
+	cmd.arcMode = arcmode;
+	cmd.points = points;
+	cmd.params[0] = x;
+	cmd.params[1] = y;
+	cmd.params[2] = radius;
+	cmd.params[3] = angle1;
+	cmd.params[4] = angle2;
+	addCommand(cmd);
+}
+
+void ShapeBatch::polygon(Graphics::DrawMode mode, const Vector2 *coords, size_t count)
+{
+	Command cmd = {};
+	cmd.type = COMMAND_POLYGON;
+	cmd.drawMode = mode;
+	cmd.coords.assign(coords, coords + count);
+	addCommand(cmd);
+}
+
+void ShapeBatch::line(const Vector2 *coords, size_t count)
+{
+	Command cmd = {};
+	cmd.type = COMMAND_LINE;
+	cmd.drawMode = Graphics::DRAW_LINE;
+	cmd.coords.assign(coords, coords + count);
+	addCommand(cmd);
+}
+
+void ShapeBatch::clear()
+{
+	commands.clear();
+	dirty = true;
+}
+
+void ShapeBatch::setColor(const Colorf &c)
+{
+	color = c;
+}
+
+const Colorf &ShapeBatch::getColor() const
+{
+	return color;
+}
+
+void ShapeBatch::setLineWidth(float width)
+{
+	if (width != lineWidth)
+		dirty = true;
+	lineWidth = width;
+}
+
+float ShapeBatch::getLineWidth() const
+{
+	return lineWidth;
+}
+
+void ShapeBatch::setLineJoin(Graphics::LineJoin join)
+{
+	if (join != lineJoin)
+		dirty = true;
+	lineJoin = join;
+}
+
+Graphics::LineJoin ShapeBatch::getLineJoin() const
+{
+	return lineJoin;
+}
+
+void ShapeBatch::setLineStyle(Graphics::LineStyle style)
+{
+	if (style != lineStyle)
+		dirty = true;
+	lineStyle = style;
+}
+
+Graphics::LineStyle ShapeBatch::getLineStyle() const
+{
+	return lineStyle;
+}
+
+int ShapeBatch::getVertexCount()
+{
+	if (dirty)
+	{
+		auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+		tessellate(gfx);
+	}
+
+	return vertexCount;
+}
+
+void ShapeBatch::replay(Graphics *gfx, const Command &cmd)
+{
+	const float *p = cmd.params;
+
+	switch (cmd.type)
+	{
+	case COMMAND_RECTANGLE:
+		if (cmd.points > 0)
+			gfx->rectangle(cmd.drawMode, p[0], p[1], p[2], p[3], p[4], p[5], cmd.points);
+		else
+			gfx->rectangle(cmd.drawMode, p[0], p[1], p[2], p[3], p[4], p[5]);
+		break;
+	case COMMAND_CIRCLE:
+		if (cmd.points > 0)
+			gfx->circle(cmd.drawMode, p[0], p[1], p[2], cmd.points);
+		else
+			gfx->circle(cmd.drawMode, p[0], p[1], p[2]);
+		break;
+	case COMMAND_ELLIPSE:
+		if (cmd.points > 0)
+			gfx->ellipse(cmd.drawMode, p[0], p[1], p[2], p[3], cmd.points);
+		else
+			gfx->ellipse(cmd.drawMode, p[0], p[1], p[2], p[3]);
+		break;
+	case COMMAND_ARC:
+		if (cmd.points > 0)
+			gfx->arc(cmd.drawMode, cmd.arcMode, p[0], p[1], p[2], p[3], p[4], cmd.points);
+		else
+			gfx->arc(cmd.drawMode, cmd.arcMode, p[0], p[1], p[2], p[3], p[4]);
+		break;
+	case COMMAND_POLYGON:
+		gfx->polygon(cmd.drawMode, cmd.coords.data(), cmd.coords.size());
+		break;
+	case COMMAND_LINE:
+		gfx->polyline(cmd.coords.data(), cmd.coords.size());
+		break;
+	}
+}
+
+void ShapeBatch::tessellate(Graphics *gfx)
+{
+	gfx->flushBatchedDraws();
+
+	// Shapes are generated in the ShapeBatch's local space, with the transform
+	// applied when it's drawn. Automatic point counts therefore use a pixel
+	// scale of 1.
+	Colorf oldcolor = gfx->getColor();
+	float oldwidth = gfx->getLineWidth();
+	Graphics::LineJoin oldjoin = gfx->getLineJoin();
+	Graphics::LineStyle oldstyle = gfx->getLineStyle();
+
+	gfx->push(Graphics::STACK_TRANSFORM);
+	gfx->origin();
+
+	gfx->setLineWidth(lineWidth);
+	gfx->setLineJoin(lineJoin);
+	gfx->setLineStyle(lineStyle);
+
+	gfx->beginShapeCapture(&capture);
+
+	try
+	{
+		for (const Command &cmd : commands)
+		{
+			gfx->setColor(cmd.color);
+			replay(gfx, cmd);
+		}
+	}
+	catch (love::Exception &)
+	{
+		gfx->endShapeCapture();
+		gfx->pop();
+		gfx->setColor(oldcolor);
+		gfx->setLineWidth(oldwidth);
+		gfx->setLineJoin(oldjoin);
+		gfx->setLineStyle(oldstyle);
+		throw;
+	}
+
+	gfx->endShapeCapture();
+	gfx->pop();
+	gfx->setColor(oldcolor);
+	gfx->setLineWidth(oldwidth);
+	gfx->setLineJoin(oldjoin);
+	gfx->setLineStyle(oldstyle);
+
+	uploadGeometry(gfx);
+	dirty = false;
+}
+
+void ShapeBatch::uploadGeometry(Graphics *gfx)
+{
+	vertexCount = (int) capture.positions.size();
+	indexCount = (int) capture.indices.size();
+
+	if (vertexCount == 0 || indexCount == 0)
+		return;
+
+	size_t possize = sizeof(Vector2) * vertexCount;
+	size_t attribsize = sizeof(STf_RGBAub) * vertexCount;
+
+	if (positionBuffer.get() == nullptr || possize > positionBuffer->getSize())
+	{
+		Buffer::Settings settings(BUFFERUSAGEFLAG_VERTEX, BUFFERDATAUSAGE_DYNAMIC);
+		auto decl = Buffer::getCommonFormatDeclaration(CommonFormat::XYf);
+		positionBuffer.set(gfx->newBuffer(settings, decl, nullptr, possize, 0), Acquire::NORETAIN);
+	}
+
+	if (attributeBuffer.get() == nullptr || attribsize > attributeBuffer->getSize())
+	{
+		Buffer::Settings settings(BUFFERUSAGEFLAG_VERTEX, BUFFERDATAUSAGE_DYNAMIC);
+		auto decl = Buffer::getCommonFormatDeclaration(CommonFormat::STf_RGBAub);
+		attributeBuffer.set(gfx->newBuffer(settings, decl, nullptr, attribsize, 0), Acquire::NORETAIN);
+	}
+
+	positionBuffer->fill(0, possize, capture.positions.data());
+	attributeBuffer->fill(0, attribsize, capture.attributes.data());
+
+	IndexDataType indextype = getIndexDataTypeFromMax(vertexCount);
+	size_t indexsize = getIndexDataSize(indextype) * indexCount;
+
+	if (indexBuffer.get() == nullptr || indexsize > indexBuffer->getSize() || indextype != indexDataType)
+	{
+		Buffer::Settings settings(BUFFERUSAGEFLAG_INDEX, BUFFERDATAUSAGE_DYNAMIC);
+		indexBuffer.set(gfx->newBuffer(settings, getIndexDataFormat(indextype), nullptr, indexsize, 0), Acquire::NORETAIN);
+		indexDataType = indextype;
+	}
+
+	if (indextype == INDEX_UINT16)
+	{
+		std::vector<uint16> indices(capture.indices.begin(), capture.indices.end());
+		indexBuffer->fill(0, indexsize, indices.data());
+	}
+	else
+		indexBuffer->fill(0, indexsize, capture.indices.data());
+}
+
+void ShapeBatch::draw(Graphics *gfx, const Matrix4 &m)
+{
+	if (dirty)
+		tessellate(gfx);
+
+	if (vertexCount == 0 || indexCount == 0)
+		return;
+
+	gfx->flushBatchedDraws();
+
+	if (Shader::isDefaultActive())
+		Shader::attachDefault(Shader::STANDARD_DEFAULT);
+
+	if (Shader::current)
+		Shader::current->validateDrawState(PRIMITIVE_TRIANGLES, nullptr);
+
+	VertexAttributes attributes;
+	attributes.setCommonFormat(CommonFormat::XYf, 0);
+	attributes.setCommonFormat(CommonFormat::STf_RGBAub, 1);
+
+	BufferBindings buffers;
+	buffers.set(0, positionBuffer, 0);
+	buffers.set(1, attributeBuffer, 0);
+
+	Graphics::TempTransform transform(gfx, m);
+
+	Graphics::DrawIndexedCommand cmd(&attributes, &buffers, indexBuffer);
+	cmd.primitiveType = PRIMITIVE_TRIANGLES;
+	cmd.indexType = indexDataType;
+	cmd.indexCount = indexCount;
+	cmd.texture = gfx->getTextureOrDefaultForActiveShader(nullptr);
+
+	gfx->draw(cmd);
+}
+
+} // graphics
+} // love
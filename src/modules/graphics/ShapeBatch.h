@@ -0,0 +1,137 @@
+/**
+* Copyright (c) 2006-2024 LOVE Development Team
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+**/
+
+#pragma once
+
+// LOVE
+#include "common/config.h"
+#include "common/Color.h"
+#include "common/Vector.h"
+#include "Drawable.h"
+#include "Graphics.h"
+#include "Buffer.h"
+
+// C++
+#include <vector>
+
+namespace love
+{
+namespace graphics
+{
+
+/**
+ * A retained set of primitive shapes. The shapes are tessellated once, the
+ * first time the ShapeBatch is drawn after it has been modified, rather than every
+ * frame like the equivalent love.graphics calls.
+ **/
+class ShapeBatch : public Drawable
+{
+public:
+
+	static love::Type type;
+
+	ShapeBatch();
+	virtual ~ShapeBatch();
+
+	void rectangle(Graphics::DrawMode mode, float x, float y, float w, float h, float rx, float ry, int points);
+	void circle(Graphics::DrawMode mode, float x, float y, float radius, int points);
+	void ellipse(Graphics::DrawMode mode, float x, float y, float a, float b, int points);
+	void arc(Graphics::DrawMode drawmode, Graphics::ArcMode arcmode, float x, float y, float radius, float angle1, float angle2, int points);
+	void polygon(Graphics::DrawMode mode, const Vector2 *coords, size_t count);
+	void line(const Vector2 *coords, size_t count);
+
+	void clear();
+
+	/**
+	 * Sets the color used by shapes added after this call. The color set with
+	 * love.graphics.setColor when the ShapeBatch is drawn is multiplied with it.
+	 **/
+	void setColor(const Colorf &c);
+	const Colorf &getColor() const;
+
+	void setLineWidth(float width);
+	float getLineWidth() const;
+
+	void setLineJoin(Graphics::LineJoin join);
+	Graphics::LineJoin getLineJoin() const;
+
+	void setLineStyle(Graphics::LineStyle style);
+	Graphics::LineStyle getLineStyle() const;
+
+	/**
+	 * Gets the number of vertices generated by the last tessellation,
+	 * tessellating first if the shapes have changed since then.
+	 **/
+	int getVertexCount();
+
+	// Implements Drawable.
+	void draw(Graphics *gfx, const Matrix4 &m) override;
+
+private:
+
+	enum CommandType
+	{
+		COMMAND_RECTANGLE,
+		COMMAND_CIRCLE,
+		COMMAND_ELLIPSE,
+		COMMAND_ARC,
+		COMMAND_POLYGON,
+		COMMAND_LINE,
+	};
+
+	struct Command
+	{
+		CommandType type;
+		Graphics::DrawMode drawMode;
+		Graphics::ArcMode arcMode;
+		Colorf color;
+		int points;
+		float params[7];
+		std::vector<Vector2> coords;
+	};
+
+	void addCommand(const Command &cmd);
+	void tessellate(Graphics *gfx);
+	void replay(Graphics *gfx, const Command &cmd);
+	void uploadGeometry(Graphics *gfx);
+
+	std::vector<Command> commands;
+
+	Colorf color;
+	float lineWidth;
+	Graphics::LineJoin lineJoin;
+	Graphics::LineStyle lineStyle;
+
+	bool dirty;
+
+	Graphics::ShapeCapture capture;
+
+	StrongRef<Buffer> positionBuffer;
+	StrongRef<Buffer> attributeBuffer;
+	StrongRef<Buffer> indexBuffer;
+	IndexDataType indexDataType;
+
+	int vertexCount;
+	int indexCount;
+
+}; // ShapeBatch
+
+} // graphics
+} // love
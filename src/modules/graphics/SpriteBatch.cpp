@@ -26,6 +26,7 @@
 #include "Quad.h"
 #include "Graphics.h"
 #include "Buffer.h"
+#include "data/ByteData.h"
 
 // C++
 #include <algorithm>
@@ -40,7 +41,7 @@ namespace graphics
 
 love::Type SpriteBatch::type("SpriteBatch", &Drawable::type);
 
-SpriteBatch::SpriteBatch(Graphics *gfx, Texture *texture, int size, BufferDataUsage usage)
+SpriteBatch::SpriteBatch(Graphics *gfx, Texture *texture, int size, BufferDataUsage usage, bool instanced)
 	: texture(texture)
 	, size(size)
 	, next(0)
@@ -49,8 +50,14 @@ SpriteBatch::SpriteBatch(Graphics *gfx, Texture *texture, int size, BufferDataUs
 	, array_buf(nullptr)
 	, vertex_data(nullptr)
 	, modified_sprites()
+	, is_static(false)
+	, instanced(instanced)
 	, range_start(-1)
 	, range_count(-1)
+	, culling(false)
+	, cull_rect()
+	, cull_grid_valid(false)
+	, cull_cell_size(1.0f)
 {
 	if (size <= 0)
 		throw love::Exception("Invalid SpriteBatch size.");
@@ -64,8 +71,9 @@ SpriteBatch::SpriteBatch(Graphics *gfx, Texture *texture, int size, BufferDataUs
 		vertex_format = CommonFormat::XYf_STf_RGBAub;
 
 	vertex_stride = getFormatStride(vertex_format);
+	sprite_stride = instanced ? sizeof(SpriteInstance) : vertex_stride * 4;
 
-	size_t vertex_size = vertex_stride * 4 * size;
+	size_t vertex_size = sprite_stride * size;
 
 	vertex_data = (uint8 *) malloc(vertex_size);
 	if (vertex_data == nullptr)
@@ -73,10 +81,25 @@ SpriteBatch::SpriteBatch(Graphics *gfx, Texture *texture, int size, BufferDataUs
 
 	memset(vertex_data, 0, vertex_size);
 
+	sprite_bounds.resize(size);
+
 	Buffer::Settings settings(BUFFERUSAGEFLAG_VERTEX, usage);
-	auto decl = Buffer::getCommonFormatDeclaration(vertex_format);
+	array_buf.set(gfx->newBuffer(settings, getBufferFormat(), nullptr, vertex_size, 0), Acquire::NORETAIN);
 
-	array_buf.set(gfx->newBuffer(settings, decl, nullptr, vertex_size, 0), Acquire::NORETAIN);
+	if (instanced)
+	{
+		// Every instance is drawn using the same unit quad.
+		XYf_STf unitquad[4] = {
+			{0.0f, 0.0f, 0.0f, 0.0f},
+			{0.0f, 1.0f, 0.0f, 1.0f},
+			{1.0f, 0.0f, 1.0f, 0.0f},
+			{1.0f, 1.0f, 1.0f, 1.0f},
+		};
+
+		Buffer::Settings quadsettings(BUFFERUSAGEFLAG_VERTEX, BUFFERDATAUSAGE_STATIC);
+		auto quaddecl = Buffer::getCommonFormatDeclaration(CommonFormat::XYf_STf);
+		unit_quad_buf.set(gfx->newBuffer(quadsettings, quaddecl, unitquad, sizeof(unitquad), 0), Acquire::NORETAIN);
+	}
 }
 
 SpriteBatch::~SpriteBatch()
@@ -94,6 +117,8 @@ int SpriteBatch::add(Quad *quad, const Matrix4 &m, int index /*= -1*/)
 	if (vertex_format == CommonFormat::XYf_STPf_RGBAub)
 		return addLayer(quad->getLayer(), quad, m, index);
 
+	checkNotStatic();
+
 	if (index < -1 || index >= size)
 		throw love::Exception("Invalid sprite index: %d", index + 1);
 
@@ -105,19 +130,27 @@ int SpriteBatch::add(Quad *quad, const Matrix4 &m, int index /*= -1*/)
 
 	int spriteindex = (index == -1 ? next : index);
 
-	size_t offset = spriteindex * vertex_stride * 4;
-	auto verts = (XYf_STf_RGBAub *) (vertex_data + offset);
+	// The grid holds the sprites in [0, next).
+	bool ingrid = cull_grid_valid && spriteindex < next;
+	if (ingrid)
+		removeFromCullGrid(spriteindex);
 
-	m.transformXY(verts, quadpositions, 4);
-
-	for (int i = 0; i < 4; i++)
+	if (instanced)
+		setInstance(spriteindex, quad, m, 0);
+	else
 	{
-		verts[i].s = quadtexcoords[i].x;
-		verts[i].t = quadtexcoords[i].y;
-		verts[i].color = color;
+		size_t offset = spriteindex * sprite_stride;
+		auto verts = (XYf_STf_RGBAub *) (vertex_data + offset);
+
+		fillQuadVertices(m, quadpositions, quadtexcoords, color, verts);
+
+		setSpriteBounds(spriteindex, verts);
 	}
 
-	modified_sprites.encapsulate(spriteindex);
+	if (ingrid || (cull_grid_valid && index == -1))
+		addToCullGrid(spriteindex);
+
+	setModified(spriteindex);
 
 	// Increment counter.
 	if (index == -1)
@@ -136,6 +169,8 @@ int SpriteBatch::addLayer(int layer, Quad *quad, const Matrix4 &m, int index)
 	if (vertex_format != CommonFormat::XYf_STPf_RGBAub)
 		throw love::Exception("addLayer can only be called on a SpriteBatch that uses an Array Texture!");
 
+	checkNotStatic();
+
 	if (index < -1 || index >= size)
 		throw love::Exception("Invalid sprite index: %d", index + 1);
 
@@ -150,20 +185,27 @@ int SpriteBatch::addLayer(int layer, Quad *quad, const Matrix4 &m, int index)
 
 	int spriteindex = (index == -1 ? next : index);
 
-	size_t offset = spriteindex * vertex_stride * 4;
-	auto verts = (XYf_STPf_RGBAub *) (vertex_data + offset);
+	// The grid holds the sprites in [0, next).
+	bool ingrid = cull_grid_valid && spriteindex < next;
+	if (ingrid)
+		removeFromCullGrid(spriteindex);
 
-	m.transformXY(verts, quadpositions, 4);
-
-	for (int i = 0; i < 4; i++)
+	if (instanced)
+		setInstance(spriteindex, quad, m, layer);
+	else
 	{
-		verts[i].s = quadtexcoords[i].x;
-		verts[i].t = quadtexcoords[i].y;
-		verts[i].p = (float) layer;
-		verts[i].color = color;
+		size_t offset = spriteindex * sprite_stride;
+		auto verts = (XYf_STPf_RGBAub *) (vertex_data + offset);
+
+		fillQuadVertices(m, quadpositions, quadtexcoords, (float) layer, color, verts);
+
+		setSpriteBounds(spriteindex, verts);
 	}
 
-	modified_sprites.encapsulate(spriteindex);
+	if (ingrid || (cull_grid_valid && index == -1))
+		addToCullGrid(spriteindex);
+
+	setModified(spriteindex);
 
 	// Increment counter.
 	if (index == -1)
@@ -172,26 +214,195 @@ int SpriteBatch::addLayer(int layer, Quad *quad, const Matrix4 &m, int index)
 	return index;
 }
 
+void SpriteBatch::setInstance(int spriteindex, Quad *quad, const Matrix4 &m, int layer)
+{
+	const Vector2 *quadpositions = quad->getVertexPositions();
+	const Vector2 *quadtexcoords = quad->getVertexTexCoords();
+	const float *e = m.getElements();
+
+	// The last quad vertex is the bottom-right corner, so it's also the size.
+	float w = quadpositions[3].x;
+	float h = quadpositions[3].y;
+
+	auto instance = (SpriteInstance *) (vertex_data + spriteindex * sprite_stride);
+
+	// The 2D affine transform from the unit quad to the sprite's position.
+	instance->transformX[0] = e[0] * w;
+	instance->transformX[1] = e[4] * h;
+	instance->transformX[2] = e[12];
+	instance->transformX[3] = (float) layer;
+
+	instance->transformY[0] = e[1] * w;
+	instance->transformY[1] = e[5] * h;
+	instance->transformY[2] = e[13];
+
+	instance->texcoords[0] = quadtexcoords[0].x;
+	instance->texcoords[1] = quadtexcoords[0].y;
+	instance->texcoords[2] = quadtexcoords[3].x - quadtexcoords[0].x;
+	instance->texcoords[3] = quadtexcoords[3].y - quadtexcoords[0].y;
+
+	instance->color = color;
+
+	Vector2 corners[4];
+	m.transformXY(corners, quadpositions, 4);
+	setSpriteBounds(spriteindex, corners);
+}
+
+template <typename T>
+void SpriteBatch::setSpriteBounds(int spriteindex, const T *positions)
+{
+	SpriteBounds &b = sprite_bounds[spriteindex];
+	b.minx = b.maxx = positions[0].x;
+	b.miny = b.maxy = positions[0].y;
+
+	for (int i = 1; i < 4; i++)
+	{
+		b.minx = std::min(b.minx, positions[i].x);
+		b.miny = std::min(b.miny, positions[i].y);
+		b.maxx = std::max(b.maxx, positions[i].x);
+		b.maxy = std::max(b.maxy, positions[i].y);
+	}
+}
+
+std::vector<Buffer::DataDeclaration> SpriteBatch::getBufferFormat() const
+{
+	if (!instanced)
+		return Buffer::getCommonFormatDeclaration(vertex_format);
+
+	// Must match SpriteInstance and the instanced sprite standard shader.
+	return {
+		{ "InstanceTransformX", DATAFORMAT_FLOAT_VEC4 },
+		{ "InstanceTransformY", DATAFORMAT_FLOAT_VEC3 },
+		{ "InstanceTexCoord", DATAFORMAT_FLOAT_VEC4 },
+		{ "InstanceColor", DATAFORMAT_UNORM8_VEC4 },
+	};
+}
+
+bool SpriteBatch::isInstanced() const
+{
+	return instanced;
+}
+
 void SpriteBatch::clear()
 {
 	// Reset the position of the next index.
 	next = 0;
+
+	cull_grid.clear();
+	cull_large_sprites.clear();
 }
 
 void SpriteBatch::flush()
 {
-	if (modified_sprites.isValid())
-	{
-		size_t offset = modified_sprites.getOffset() * vertex_stride * 4;
-		size_t size = modified_sprites.getSize() * vertex_stride * 4;
+	if (modified_sprites.empty())
+		return;
 
-		if (array_buf->getDataUsage() == BUFFERDATAUSAGE_STREAM)
-			array_buf->fill(0, array_buf->getSize(), vertex_data);
-		else
+	if (array_buf->getDataUsage() == BUFFERDATAUSAGE_STREAM)
+		array_buf->fill(0, array_buf->getSize(), vertex_data);
+	else
+	{
+		for (const Range &range : modified_sprites)
+		{
+			size_t offset = range.getOffset() * sprite_stride;
+			size_t size = range.getSize() * sprite_stride;
 			array_buf->fill(offset, size, vertex_data + offset);
+		}
+	}
+
+	modified_sprites.clear();
+}
+
+void SpriteBatch::setModified(int spriteindex)
+{
+	size_t index = (size_t) spriteindex;
+	const size_t distance = MODIFIED_RANGE_MERGE_DISTANCE;
 
-		modified_sprites.invalidate();
+	// The first range which is close enough to (or after) the sprite.
+	auto it = std::lower_bound(modified_sprites.begin(), modified_sprites.end(), index, [](const Range &r, size_t i)
+	{
+		return r.last + distance + 1 < i;
+	});
+
+	if (it != modified_sprites.end() && it->first <= index + distance + 1)
+	{
+		it->encapsulate(index);
+
+		// The range might have grown close enough to the ones after it.
+		auto nextit = it + 1;
+		while (nextit != modified_sprites.end() && nextit->first <= it->last + distance + 1)
+		{
+			it->encapsulate(*nextit);
+			nextit = modified_sprites.erase(nextit);
+			it = nextit - 1;
+		}
 	}
+	else
+		modified_sprites.insert(it, Range(index, 1));
+
+	if (modified_sprites.size() <= MAX_MODIFIED_RANGES)
+		return;
+
+	// Too many separate uploads, merge the two closest ranges.
+	size_t closest = 0;
+	for (size_t i = 1; i + 1 < modified_sprites.size(); i++)
+	{
+		size_t gap = modified_sprites[i + 1].first - modified_sprites[i].last;
+		if (gap < modified_sprites[closest + 1].first - modified_sprites[closest].last)
+			closest = i;
+	}
+
+	modified_sprites[closest].encapsulate(modified_sprites[closest + 1]);
+	modified_sprites.erase(modified_sprites.begin() + closest + 1);
+}
+
+void SpriteBatch::checkNotStatic() const
+{
+	if (is_static)
+		throw love::Exception("Sprites cannot be added or changed while the SpriteBatch is static.");
+}
+
+void SpriteBatch::setStatic(bool enable)
+{
+	if (enable == is_static)
+		return;
+
+	size_t vertex_size = sprite_stride * size;
+
+	if (enable)
+	{
+		flush();
+
+		free(vertex_data);
+		vertex_data = nullptr;
+	}
+	else
+	{
+		uint8 *data = (uint8 *) malloc(vertex_size);
+		if (data == nullptr)
+			throw love::Exception("Out of memory.");
+
+		// The contents only exist on the GPU now, so get them from there.
+		try
+		{
+			auto gfx = Module::getInstance<graphics::Graphics>(Module::M_GRAPHICS);
+			StrongRef<data::ByteData> bytes(gfx->readbackBuffer(array_buf, 0, vertex_size, nullptr, 0), Acquire::NORETAIN);
+			memcpy(data, bytes->getData(), vertex_size);
+		}
+		catch (love::Exception &)
+		{
+			free(data);
+			throw;
+		}
+
+		vertex_data = data;
+	}
+
+	is_static = enable;
+}
+
+bool SpriteBatch::isStatic() const
+{
+	return is_static;
 }
 
 void SpriteBatch::setTexture(Texture *newtexture)
@@ -235,7 +446,9 @@ void SpriteBatch::setBufferSize(int newsize)
 	if (newsize == size)
 		return;
 
-	size_t vertex_size = vertex_stride * 4 * newsize;
+	checkNotStatic();
+
+	size_t vertex_size = sprite_stride * newsize;
 
 	int new_next = std::min(next, newsize);
 
@@ -245,14 +458,30 @@ void SpriteBatch::setBufferSize(int newsize)
 
 	auto gfx = Module::getInstance<graphics::Graphics>(Module::M_GRAPHICS);
 	Buffer::Settings settings(array_buf->getUsageFlags(), array_buf->getDataUsage());
-	auto decl = Buffer::getCommonFormatDeclaration(vertex_format);
 
-	array_buf.set(gfx->newBuffer(settings, decl, nullptr, vertex_size, 0), Acquire::NORETAIN);
+	array_buf.set(gfx->newBuffer(settings, getBufferFormat(), nullptr, vertex_size, 0), Acquire::NORETAIN);
 
-	array_buf->fill(0, vertex_stride * 4 * new_next, new_vertex_data);
+	array_buf->fill(0, sprite_stride * new_next, new_vertex_data);
 
 	vertex_data = (uint8 *) new_vertex_data;
 
+	sprite_bounds.resize(newsize);
+
+	// Sprites past new_next may still be in the grid.
+	if (new_next < next)
+		cull_grid_valid = false;
+
+	// Everything before new_next was just uploaded, and nothing past newsize
+	// exists anymore.
+	std::vector<Range> remaining;
+	for (Range range : modified_sprites)
+	{
+		range.intersect(Range(new_next, newsize - new_next));
+		if (new_next < newsize && range.isValid())
+			remaining.push_back(range);
+	}
+	modified_sprites = remaining;
+
 	size = newsize;
 	next = new_next;
 }
@@ -270,8 +499,11 @@ void SpriteBatch::attachAttribute(const std::string &name, Buffer *buffer, Mesh
 	AttachedAttribute oldattrib = {};
 	AttachedAttribute newattrib = {};
 
-	if (buffer->getArrayLength() < (size_t) next * 4)
-		throw love::Exception("Buffer has too few vertices to be attached to this SpriteBatch (at least %d vertices are required)", next*4);
+	// Attached attributes are per-instance in instanced SpriteBatches.
+	int verticespersprite = instanced ? 1 : 4;
+
+	if (buffer->getArrayLength() < (size_t) next * verticespersprite)
+		throw love::Exception("Buffer has too few vertices to be attached to this SpriteBatch (at least %d vertices are required)", next*verticespersprite);
 
 	auto it = attached_attributes.find(name);
 	if (it != attached_attributes.end())
@@ -312,6 +544,209 @@ bool SpriteBatch::getDrawRange(int &start, int &count) const
 	return true;
 }
 
+void SpriteBatch::setCullRect(float x, float y, float w, float h)
+{
+	if (w < 0.0f || h < 0.0f)
+		throw love::Exception("Invalid cull rectangle.");
+
+	culling = true;
+	cull_rect.minx = x;
+	cull_rect.miny = y;
+	cull_rect.maxx = x + w;
+	cull_rect.maxy = y + h;
+}
+
+void SpriteBatch::setCullRect()
+{
+	culling = false;
+}
+
+bool SpriteBatch::getCullRect(float &x, float &y, float &w, float &h) const
+{
+	if (!culling)
+		return false;
+
+	x = cull_rect.minx;
+	y = cull_rect.miny;
+	w = cull_rect.maxx - cull_rect.minx;
+	h = cull_rect.maxy - cull_rect.miny;
+	return true;
+}
+
+bool SpriteBatch::isSpriteVisible(int spriteindex) const
+{
+	const SpriteBounds &b = sprite_bounds[spriteindex];
+	return b.maxx >= cull_rect.minx && b.minx <= cull_rect.maxx
+		&& b.maxy >= cull_rect.miny && b.miny <= cull_rect.maxy;
+}
+
+uint64 SpriteBatch::getCullCellKey(int x, int y) const
+{
+	return ((uint64) (uint32) x << 32) | (uint64) (uint32) y;
+}
+
+void SpriteBatch::getCullCells(const SpriteBounds &b, int &x0, int &y0, int &x1, int &y1) const
+{
+	const float limit = (float) (LOVE_INT32_MAX / 2);
+
+	x0 = (int) std::floor(std::min(std::max(b.minx / cull_cell_size, -limit), limit));
+	y0 = (int) std::floor(std::min(std::max(b.miny / cull_cell_size, -limit), limit));
+	x1 = (int) std::floor(std::min(std::max(b.maxx / cull_cell_size, -limit), limit));
+	y1 = (int) std::floor(std::min(std::max(b.maxy / cull_cell_size, -limit), limit));
+}
+
+void SpriteBatch::addToCullGrid(int spriteindex)
+{
+	int x0, y0, x1, y1;
+	getCullCells(sprite_bounds[spriteindex], x0, y0, x1, y1);
+
+	if ((int64) (x1 - x0 + 1) * (y1 - y0 + 1) > MAX_CULL_CELLS_PER_SPRITE)
+	{
+		cull_large_sprites.push_back(spriteindex);
+		return;
+	}
+
+	for (int y = y0; y <= y1; y++)
+	{
+		for (int x = x0; x <= x1; x++)
+			cull_grid[getCullCellKey(x, y)].push_back(spriteindex);
+	}
+}
+
+void SpriteBatch::removeFromCullGrid(int spriteindex)
+{
+	auto removefrom = [spriteindex](std::vector<int> &sprites)
+	{
+		auto it = std::find(sprites.begin(), sprites.end(), spriteindex);
+		if (it != sprites.end())
+		{
+			*it = sprites.back();
+			sprites.pop_back();
+		}
+	};
+
+	int x0, y0, x1, y1;
+	getCullCells(sprite_bounds[spriteindex], x0, y0, x1, y1);
+
+	if ((int64) (x1 - x0 + 1) * (y1 - y0 + 1) > MAX_CULL_CELLS_PER_SPRITE)
+	{
+		removefrom(cull_large_sprites);
+		return;
+	}
+
+	for (int y = y0; y <= y1; y++)
+	{
+		for (int x = x0; x <= x1; x++)
+		{
+			auto it = cull_grid.find(getCullCellKey(x, y));
+			if (it == cull_grid.end())
+				continue;
+
+			removefrom(it->second);
+			if (it->second.empty())
+				cull_grid.erase(it);
+		}
+	}
+}
+
+void SpriteBatch::buildCullGrid()
+{
+	cull_grid.clear();
+	cull_large_sprites.clear();
+
+	// Cells a few sprites wide keep both the per-sprite cell count and the
+	// number of cells touched by a query low.
+	double extent = 0.0;
+	for (int i = 0; i < next; i++)
+	{
+		const SpriteBounds &b = sprite_bounds[i];
+		extent += std::max(b.maxx - b.minx, b.maxy - b.miny);
+	}
+
+	if (next > 0)
+		extent /= next;
+
+	cull_cell_size = std::max((float) extent * 4.0f, 1.0f);
+
+	for (int i = 0; i < next; i++)
+		addToCullGrid(i);
+
+	cull_grid_valid = true;
+}
+
+void SpriteBatch::getVisibleRanges(int start, int count, std::vector<Range> &ranges)
+{
+	if (!cull_grid_valid)
+		buildCullGrid();
+
+	visible_sprites.clear();
+
+	int x0, y0, x1, y1;
+	getCullCells(cull_rect, x0, y0, x1, y1);
+
+	int end = start + count;
+	int64 querycells = (int64) (x1 - x0 + 1) * (y1 - y0 + 1);
+
+	if (querycells > (int64) cull_grid.size())
+	{
+		// Looking at every occupied cell is cheaper than the query.
+		for (int i = start; i < end; i++)
+		{
+			if (isSpriteVisible(i))
+				visible_sprites.push_back(i);
+		}
+	}
+	else
+	{
+		for (int y = y0; y <= y1; y++)
+		{
+			for (int x = x0; x <= x1; x++)
+			{
+				auto it = cull_grid.find(getCullCellKey(x, y));
+				if (it == cull_grid.end())
+					continue;
+
+				for (int i : it->second)
+				{
+					if (i >= start && i < end && isSpriteVisible(i))
+						visible_sprites.push_back(i);
+				}
+			}
+		}
+
+		for (int i : cull_large_sprites)
+		{
+			if (i >= start && i < end && isSpriteVisible(i))
+				visible_sprites.push_back(i);
+		}
+
+		// Sprites in more than one cell show up more than once.
+		std::sort(visible_sprites.begin(), visible_sprites.end());
+		visible_sprites.erase(std::unique(visible_sprites.begin(), visible_sprites.end()), visible_sprites.end());
+	}
+
+	// Drawing a few hidden sprites is cheaper than more draws, so join nearby
+	// ranges, more aggressively until there are few enough of them.
+	size_t distance = CULL_RANGE_MERGE_DISTANCE;
+	while (true)
+	{
+		ranges.clear();
+
+		for (int i : visible_sprites)
+		{
+			if (!ranges.empty() && (size_t) i <= ranges.back().last + distance + 1)
+				ranges.back().encapsulate(i);
+			else
+				ranges.push_back(Range(i, 1));
+		}
+
+		if (ranges.size() <= MAX_CULL_RANGES)
+			break;
+
+		distance *= 2;
+	}
+}
+
 void SpriteBatch::draw(Graphics *gfx, const Matrix4 &m)
 {
 	if (next == 0)
@@ -324,7 +759,11 @@ void SpriteBatch::draw(Graphics *gfx, const Matrix4 &m)
 		if (Shader::isDefaultActive())
 		{
 			Shader::StandardShader defaultshader = Shader::STANDARD_DEFAULT;
-			if (texture->getTextureType() == TEXTURE_2D_ARRAY)
+			if (instanced && texture->getTextureType() == TEXTURE_2D_ARRAY)
+				defaultshader = Shader::STANDARD_INSTANCED_SPRITES_ARRAY;
+			else if (instanced)
+				defaultshader = Shader::STANDARD_INSTANCED_SPRITES;
+			else if (texture->getTextureType() == TEXTURE_2D_ARRAY)
 				defaultshader = Shader::STANDARD_ARRAY;
 
 			Shader::attachDefault(defaultshader);
@@ -339,20 +778,41 @@ void SpriteBatch::draw(Graphics *gfx, const Matrix4 &m)
 	VertexAttributes attributes;
 	BufferBindings buffers;
 
+	int activebuffers = 1;
+
+	if (instanced)
+	{
+		// Buffer 0 is the unit quad, and buffer 1 has the per-instance data,
+		// bound to whichever of its attributes the active shader uses.
+		buffers.set(0, unit_quad_buf, 0);
+		attributes.setCommonFormat(CommonFormat::XYf_STf, 0);
+
+		for (int i = 0; i < (int) array_buf->getDataMembers().size(); i++)
+		{
+			const auto &member = array_buf->getDataMember(i);
+			int attributeindex = Shader::current ? Shader::current->getVertexAttributeIndex(member.decl.name) : -1;
+
+			if (attributeindex >= 0)
+				attributes.set(attributeindex, member.decl.format, (uint16) array_buf->getMemberOffset(i), 1);
+		}
+
+		attributes.setBufferLayout(1, (uint16) sprite_stride, STEP_PER_INSTANCE);
+		buffers.set(1, array_buf, 0);
+		activebuffers++;
+	}
+	else
 	{
 		buffers.set(0, array_buf, 0);
 		attributes.setCommonFormat(vertex_format, 0);
 	}
 
-	int activebuffers = 1;
-
 	for (const auto &it : attached_attributes)
 	{
 		Buffer *buffer = it.second.buffer.get();
 
 		// We have to do this check here as wll because setBufferSize can be
 		// called after attachAttribute.
-		if (buffer->getArrayLength() < (size_t) next * 4)
+		if (buffer->getArrayLength() < (size_t) next * (instanced ? 1 : 4))
 			throw love::Exception("Buffer with attribute '%s' attached to this SpriteBatch has too few vertices", it.first.c_str());
 
 		int attributeindex = -1;
@@ -376,7 +836,7 @@ void SpriteBatch::draw(Graphics *gfx, const Matrix4 &m)
 			uint16 stride = (uint16) buffer->getArrayStride();
 
 			attributes.set(attributeindex, member.decl.format, offset, activebuffers);
-			attributes.setBufferLayout(activebuffers, stride);
+			attributes.setBufferLayout(activebuffers, stride, instanced ? STEP_PER_INSTANCE : STEP_PER_VERTEX);
 
 			// TODO: We should reuse buffer bindings with the same buffer+stride+step.
 			buffers.set(activebuffers, buffer, 0);
@@ -394,10 +854,38 @@ void SpriteBatch::draw(Graphics *gfx, const Matrix4 &m)
 
 	count = std::min(count, next - start);
 
-	if (count > 0)
+	if (count <= 0)
+		return;
+
+	Texture *tex = gfx->getTextureOrDefaultForActiveShader(texture);
+
+	std::vector<Range> ranges;
+	if (culling)
+		getVisibleRanges(start, count, ranges);
+	else
+		ranges.push_back(Range(start, count));
+
+	for (const Range &range : ranges)
 	{
-		Texture *tex = gfx->getTextureOrDefaultForActiveShader(texture);
-		gfx->drawQuads(start, count, attributes, buffers, tex);
+		int rangestart = (int) range.getOffset();
+		int rangecount = (int) range.getSize();
+
+		if (instanced)
+		{
+			// Per-instance buffers start at the first sprite in the range.
+			BufferBindings rangebuffers = buffers;
+			for (int i = 1; i < activebuffers; i++)
+				rangebuffers.info[i].offset += rangestart * attributes.bufferLayouts[i].stride;
+
+			Graphics::DrawIndexedCommand cmd(&attributes, &rangebuffers, gfx->getQuadIndexBuffer());
+			cmd.indexType = INDEX_UINT16;
+			cmd.indexCount = 6;
+			cmd.instanceCount = rangecount;
+			cmd.texture = tex;
+			gfx->draw(cmd);
+		}
+		else
+			gfx->drawQuads(rangestart, rangecount, attributes, buffers, tex);
 	}
 }
 
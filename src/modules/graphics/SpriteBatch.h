@@ -25,6 +25,7 @@
 
 // C++
 #include <unordered_map>
+#include <vector>
 
 // LOVE
 #include "common/math.h"
@@ -33,6 +34,7 @@
 #include "common/Range.h"
 #include "Drawable.h"
 #include "Mesh.h"
+#include "Buffer.h"
 #include "vertex.h"
 
 namespace love
@@ -52,7 +54,7 @@ public:
 
 	static love::Type type;
 
-	SpriteBatch(Graphics *gfx, Texture *texture, int size, BufferDataUsage usage);
+	SpriteBatch(Graphics *gfx, Texture *texture, int size, BufferDataUsage usage, bool instanced = false);
 	virtual ~SpriteBatch();
 
 	int add(const Matrix4 &m, int index = -1);
@@ -103,6 +105,31 @@ public:
 	void setDrawRange();
 	bool getDrawRange(int &start, int &count) const;
 
+	/**
+	 * Sets whether the SpriteBatch is static. A static SpriteBatch uploads any
+	 * pending changes and then frees its CPU-side copy of the sprite data, so
+	 * sprites can't be added or changed until it's made non-static again.
+	 **/
+	void setStatic(bool enable);
+	bool isStatic() const;
+
+	/**
+	 * Gets whether the SpriteBatch stores one instance per sprite and draws
+	 * them all with a single instanced draw of a unit quad, instead of storing
+	 * four vertices per sprite.
+	 **/
+	bool isInstanced() const;
+
+	/**
+	 * Sets a rectangle, in the SpriteBatch's own coordinate space, outside of
+	 * which sprites are skipped when drawing. Sprites are indexed in a grid
+	 * so only the visible ones are looked at, and they're drawn as a few
+	 * contiguous ranges.
+	 **/
+	void setCullRect(float x, float y, float w, float h);
+	void setCullRect();
+	bool getCullRect(float &x, float &y, float &w, float &h) const;
+
 	// Implements Drawable.
 	void draw(Graphics *gfx, const Matrix4 &m) override;
 
@@ -115,12 +142,65 @@ private:
 		int index;
 	};
 
+	struct SpriteBounds
+	{
+		float minx, miny;
+		float maxx, maxy;
+	};
+
+	// Per-sprite data used by instanced SpriteBatches. The transform rows and
+	// the texture rectangle are applied to a unit quad in the vertex shader.
+	struct SpriteInstance
+	{
+		float transformX[4]; // a, c, e, layer
+		float transformY[3]; // b, d, f
+		float texcoords[4]; // s, t, width, height
+		Color32 color;
+	};
+
 	/**
 	 * Sets the total number of sprites this SpriteBatch can hold.
 	 * Leaves existing sprite data intact when possible.
 	 **/
 	void setBufferSize(int newsize);
 
+	/**
+	 * Marks a sprite as needing to be uploaded in the next flush.
+	 **/
+	void setModified(int spriteindex);
+
+	void checkNotStatic() const;
+
+	void setInstance(int spriteindex, Quad *quad, const Matrix4 &m, int layer);
+
+	std::vector<Buffer::DataDeclaration> getBufferFormat() const;
+
+	template <typename T>
+	void setSpriteBounds(int spriteindex, const T *positions);
+
+	bool isSpriteVisible(int spriteindex) const;
+	uint64 getCullCellKey(int x, int y) const;
+	void getCullCells(const SpriteBounds &b, int &x0, int &y0, int &x1, int &y1) const;
+	void addToCullGrid(int spriteindex);
+	void removeFromCullGrid(int spriteindex);
+	void buildCullGrid();
+	void getVisibleRanges(int start, int count, std::vector<Range> &ranges);
+
+	// Modified sprites whose gap is at most this many sprites are uploaded in
+	// a single range.
+	static const size_t MODIFIED_RANGE_MERGE_DISTANCE = 16;
+
+	// The most separate ranges uploaded by a flush.
+	static const size_t MAX_MODIFIED_RANGES = 64;
+
+	// Visible sprites whose gap is at most this many sprites are drawn in a
+	// single range, and a culled draw uses at most this many ranges.
+	static const size_t CULL_RANGE_MERGE_DISTANCE = 8;
+	static const size_t MAX_CULL_RANGES = 32;
+
+	// Sprites covering more grid cells than this are always tested instead.
+	static const int MAX_CULL_CELLS_PER_SPRITE = 64;
+
 	StrongRef<Texture> texture;
 
 	// Max number of sprites in the batch.
@@ -136,15 +216,40 @@ private:
 	CommonFormat vertex_format;
 	size_t vertex_stride;
 
+	// Size in bytes of a single sprite's data in the buffer.
+	size_t sprite_stride;
+
 	StrongRef<love::graphics::Buffer> array_buf;
 	uint8 *vertex_data;
 
-	Range modified_sprites;
+	// Sorted, non-overlapping ranges of modified sprites.
+	std::vector<Range> modified_sprites;
+
+	bool is_static;
+	bool instanced;
+
+	// Unit quad vertices shared by every instance, in instanced mode.
+	StrongRef<Buffer> unit_quad_buf;
 
 	std::unordered_map<std::string, AttachedAttribute> attached_attributes;
 	
 	int range_start;
 	int range_count;
+
+	// Bounds of every sprite, in the SpriteBatch's coordinate space.
+	std::vector<SpriteBounds> sprite_bounds;
+
+	bool culling;
+	SpriteBounds cull_rect;
+
+	// Sprites in [0, next) by grid cell, built the first time a culled draw
+	// happens and kept up to date by add and clear after that.
+	bool cull_grid_valid;
+	float cull_cell_size;
+	std::unordered_map<uint64, std::vector<int>> cull_grid;
+	std::vector<int> cull_large_sprites;
+
+	std::vector<int> visible_sprites;
 	
 }; // SpriteBatch
 
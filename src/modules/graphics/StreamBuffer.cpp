@@ -20,6 +20,7 @@
 
 #include "StreamBuffer.h"
 #include "common/Exception.h"
+#include "common/memory.h"
 
 namespace love
 {
@@ -29,8 +30,15 @@ namespace graphics
 StreamBuffer::StreamBuffer(BufferUsage mode, size_t size)
 	: bufferSize(size)
 	, frameGPUReadOffset(0)
+	, frameStallCount(0)
 	, mode(mode)
 {
+	trackMemory(MEMORYTAG_BUFFER, (int64) size);
+}
+
+StreamBuffer::~StreamBuffer()
+{
+	trackMemory(MEMORYTAG_BUFFER, -(int64) bufferSize);
 }
 
 } // graphics
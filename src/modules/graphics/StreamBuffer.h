@@ -51,12 +51,28 @@ public:
 		{}
 	};
 
-	virtual ~StreamBuffer() {}
+	virtual ~StreamBuffer();
 
 	size_t getSize() const { return bufferSize; }
 	BufferUsage getMode() const { return mode; }
 	size_t getUsableSize() const { return bufferSize - frameGPUReadOffset; }
 
+	/**
+	 * Gets the number of bytes used so far in the current frame's region.
+	 **/
+	size_t getFrameUsedSize() const { return frameGPUReadOffset; }
+
+	/**
+	 * Gets the number of times map() had to wait for the GPU to finish using
+	 * the current frame's region.
+	 **/
+	int getFrameStallCount() const { return frameStallCount; }
+
+	/**
+	 * Gets the total size of the buffer's memory, including all frame regions.
+	 **/
+	virtual size_t getMemorySize() const { return bufferSize; }
+
 	virtual size_t getGPUReadOffset() const = 0;
 
 	virtual MapInfo map(size_t minsize) = 0;
@@ -71,6 +87,7 @@ protected:
 
 	size_t bufferSize;
 	size_t frameGPUReadOffset;
+	int frameStallCount;
 	BufferUsage mode;
 
 }; // StreamBuffer
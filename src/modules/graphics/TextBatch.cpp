@@ -47,16 +47,15 @@ TextBatch::~TextBatch()
 		free(vertexData);
 }
 
-void TextBatch::uploadVertices(const std::vector<Font::GlyphVertex> &vertices, size_t vertoffset)
+void TextBatch::reserveVertices(size_t vertexcount)
 {
-	size_t offset = vertoffset * sizeof(Font::GlyphVertex);
-	size_t datasize = vertices.size() * sizeof(Font::GlyphVertex);
+	size_t datasize = vertexcount * sizeof(Font::GlyphVertex);
 
 	// If we haven't created a VBO or the vertices are too big, make a new one.
-	if (datasize > 0 && (!vertexBuffer || (offset + datasize) > vertexBuffer->getSize()))
+	if (datasize > 0 && (!vertexBuffer || datasize > vertexBuffer->getSize()))
 	{
 		// Make it bigger than necessary to reduce potential future allocations.
-		size_t newsize = size_t((offset + datasize) * 1.5);
+		size_t newsize = size_t(datasize * 1.5);
 
 		if (vertexBuffer != nullptr)
 			newsize = std::max(size_t(vertexBuffer->getSize() * 1.5), newsize);
@@ -78,10 +77,22 @@ void TextBatch::uploadVertices(const std::vector<Font::GlyphVertex> &vertices, s
 		else
 			vertexData = (uint8 *) newdata;
 
-		vertexBuffer = newbuffer;
+		vertexBuffer.set(newbuffer, Acquire::NORETAIN);
 
 		vertexBuffers.set(0, vertexBuffer, 0);
+
+		// The new buffer doesn't have any of the existing vertices yet.
+		if (vertOffset > 0)
+			modifiedVertices.encapsulate(0, vertOffset * sizeof(Font::GlyphVertex));
 	}
+}
+
+void TextBatch::uploadVertices(const std::vector<Font::GlyphVertex> &vertices, size_t vertoffset)
+{
+	size_t offset = vertoffset * sizeof(Font::GlyphVertex);
+	size_t datasize = vertices.size() * sizeof(Font::GlyphVertex);
+
+	reserveVertices(vertoffset + vertices.size());
 
 	if (vertexData != nullptr && datasize > 0)
 	{
@@ -107,71 +118,155 @@ void TextBatch::regenerateVertices()
 	}
 }
 
-void TextBatch::addTextData(const TextData &t)
+void TextBatch::generateTextData(TextData &t, std::vector<Font::GlyphVertex> &vertices)
 {
-	std::vector<Font::GlyphVertex> vertices;
-	std::vector<Font::DrawCommand> newcommands;
-
-	love::font::TextShaper::TextInfo textinfo;
-
 	Colorf constantcolor = Colorf(1.0f, 1.0f, 1.0f, 1.0f);
 
 	// We only have formatted text if the align mode is valid.
 	if (t.align == Font::ALIGN_MAX_ENUM)
-		newcommands = font->generateVertices(t.codepoints, Range(), constantcolor, vertices, 0.0f, Vector2(0.0f, 0.0f), &textinfo);
+		t.drawCommands = font->generateVertices(t.codepoints, Range(), constantcolor, vertices, 0.0f, Vector2(0.0f, 0.0f), &t.textInfo);
 	else
-		newcommands = font->generateVerticesFormatted(t.codepoints, constantcolor, t.wrap, t.align, vertices, &textinfo);
-
-	size_t voffset = vertOffset;
-
-	if (!t.appendVertices)
-	{
-		voffset = 0;
-		vertOffset = 0;
-		drawCommands.clear();
-		textData.clear();
-	}
+		t.drawCommands = font->generateVerticesFormatted(t.codepoints, constantcolor, t.wrap, t.align, vertices, &t.textInfo);
 
 	if (t.useMatrix && !vertices.empty())
 		t.matrix.transformXY(vertices.data(), vertices.data(), (int) vertices.size());
 
-	uploadVertices(vertices, voffset);
+	t.vertexCount = (int) vertices.size();
+}
 
-	if (!newcommands.empty())
+void TextBatch::appendDrawCommands(const std::vector<Font::DrawCommand> &commands, int vertexstart)
+{
+	for (size_t i = 0; i < commands.size(); i++)
 	{
-		// The start vertex should be adjusted to account for the vertex offset.
-		for (Font::DrawCommand &cmd : newcommands)
-			cmd.startvertex += (int) voffset;
+		Font::DrawCommand cmd = commands[i];
 
-		auto firstcmd = newcommands.begin();
+		// The start vertex should be adjusted to account for the vertex offset.
+		cmd.startvertex += vertexstart;
 
 		// If the first draw command in the new list has the same texture as the
 		// last one in the existing list we're building and its vertices are
 		// in-order, we can combine them (saving a draw call.)
-		if (!drawCommands.empty())
+		if (i == 0 && !drawCommands.empty())
 		{
-			auto prevcmd = drawCommands.back();
-			if (prevcmd.texture == firstcmd->texture && (prevcmd.startvertex + prevcmd.vertexcount) == firstcmd->startvertex)
+			Font::DrawCommand &prevcmd = drawCommands.back();
+			if (prevcmd.texture == cmd.texture && (prevcmd.startvertex + prevcmd.vertexcount) == cmd.startvertex)
 			{
-				drawCommands.back().vertexcount += firstcmd->vertexcount;
-				++firstcmd;
+				prevcmd.vertexcount += cmd.vertexcount;
+				continue;
 			}
 		}
 
-		// Append the new draw commands to the list we're building.
-		drawCommands.insert(drawCommands.end(), firstcmd, newcommands.end());
+		drawCommands.push_back(cmd);
 	}
+}
+
+void TextBatch::addTextData(const TextData &data)
+{
+	TextData t = data;
 
-	vertOffset = voffset + vertices.size();
+	std::vector<Font::GlyphVertex> vertices;
+	generateTextData(t, vertices);
+
+	if (!t.appendVertices)
+	{
+		vertOffset = 0;
+		drawCommands.clear();
+		textData.clear();
+	}
+
+	t.vertexStart = (int) vertOffset;
+
+	uploadVertices(vertices, vertOffset);
+	appendDrawCommands(t.drawCommands, t.vertexStart);
+
+	vertOffset += vertices.size();
 
 	textData.push_back(t);
-	textData.back().textInfo = textinfo;
 
 	// Font::generateVertices can invalidate the font's texture cache.
 	if (font->getTextureCacheID() != textureCacheID)
 		regenerateVertices();
 }
 
+void TextBatch::replaceTextData(int index, const TextData *data)
+{
+	if (index < 0 || index >= (int) textData.size())
+		throw love::Exception("Invalid text index: %d", index + 1);
+
+	TextData &old = textData[index];
+
+	TextData t;
+	std::vector<Font::GlyphVertex> vertices;
+
+	if (data != nullptr)
+	{
+		t = *data;
+
+		// Entries after the first are always appended when regenerating.
+		t.appendVertices = old.appendVertices;
+
+		generateTextData(t, vertices);
+	}
+
+	// Font::generateVertices can invalidate the font's texture cache, in which
+	// case everything has to be regenerated anyway.
+	if (font->getTextureCacheID() != textureCacheID)
+	{
+		if (data != nullptr)
+			textData[index] = t;
+		else
+			textData.erase(textData.begin() + index);
+
+		textureCacheID = (uint32) -1;
+		regenerateVertices();
+		return;
+	}
+
+	size_t start = old.vertexStart;
+	size_t oldcount = old.vertexCount;
+	size_t newcount = vertices.size();
+	size_t tailstart = start + oldcount;
+	size_t tailcount = vertOffset - tailstart;
+	size_t newtotal = vertOffset - oldcount + newcount;
+
+	reserveVertices(newtotal);
+
+	// Only the replaced entry is regenerated. The vertices of the entries
+	// after it are moved instead.
+	if (vertexData != nullptr)
+	{
+		const size_t vsize = sizeof(Font::GlyphVertex);
+
+		if (newcount != oldcount && tailcount > 0)
+			memmove(vertexData + (start + newcount) * vsize, vertexData + tailstart * vsize, tailcount * vsize);
+
+		if (newcount > 0)
+			memcpy(vertexData + start * vsize, vertices.data(), newcount * vsize);
+
+		size_t modifiedend = newcount != oldcount ? newtotal : start + newcount;
+		if (modifiedend > start)
+			modifiedVertices.encapsulate(start * vsize, (modifiedend - start) * vsize);
+	}
+
+	int delta = (int) newcount - (int) oldcount;
+	for (size_t i = index + 1; i < textData.size(); i++)
+		textData[i].vertexStart += delta;
+
+	if (data != nullptr)
+	{
+		t.vertexStart = (int) start;
+		textData[index] = t;
+	}
+	else
+		textData.erase(textData.begin() + index);
+
+	vertOffset = newtotal;
+
+	drawCommands.clear();
+	for (const TextData &td : textData)
+		appendDrawCommands(td.drawCommands, td.vertexStart);
+}
+
 void TextBatch::set(const std::vector<love::font::ColoredString> &text)
 {
 	return set(text, -1.0f, Font::ALIGN_MAX_ENUM);
@@ -203,6 +298,30 @@ int TextBatch::addf(const std::vector<love::font::ColoredString> &text, float wr
 	return (int) textData.size() - 1;
 }
 
+void TextBatch::replace(int index, const std::vector<love::font::ColoredString> &text, const Matrix4 &m)
+{
+	replacef(index, text, -1.0f, Font::ALIGN_MAX_ENUM, m);
+}
+
+void TextBatch::replacef(int index, const std::vector<love::font::ColoredString> &text, float wrap, Font::AlignMode align, const Matrix4 &m)
+{
+	love::font::ColoredCodepoints codepoints;
+	love::font::getCodepointsFromString(text, codepoints);
+
+	TextData t = {codepoints, wrap, align, {}, true, true, m};
+	replaceTextData(index, &t);
+}
+
+void TextBatch::remove(int index)
+{
+	replaceTextData(index, nullptr);
+}
+
+int TextBatch::getCount() const
+{
+	return (int) textData.size();
+}
+
 void TextBatch::clear()
 {
 	textData.clear();
@@ -260,7 +379,7 @@ void TextBatch::draw(Graphics *gfx, const Matrix4 &m)
 		regenerateVertices();
 
 	if (Shader::isDefaultActive())
-		Shader::attachDefault(Shader::STANDARD_DEFAULT);
+		Shader::attachDefault(font->isSDF() ? Shader::STANDARD_SDF_TEXT : Shader::STANDARD_DEFAULT);
 
 	Texture *firsttex = nullptr;
 	if (!drawCommands.empty())
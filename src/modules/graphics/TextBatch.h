@@ -49,6 +49,25 @@ public:
 	int add(const std::vector<love::font::ColoredString> &text, const Matrix4 &m);
 	int addf(const std::vector<love::font::ColoredString> &text, float wrap, Font::AlignMode align, const Matrix4 &m);
 
+	/**
+	 * Replaces the text at the given index (as returned by add or addf). Only
+	 * the vertices of that text are regenerated - the vertices of the text
+	 * after it are moved if its size changes.
+	 **/
+	void replace(int index, const std::vector<love::font::ColoredString> &text, const Matrix4 &m);
+	void replacef(int index, const std::vector<love::font::ColoredString> &text, float wrap, Font::AlignMode align, const Matrix4 &m);
+
+	/**
+	 * Removes the text at the given index. The indices of the text after it
+	 * are shifted down by one.
+	 **/
+	void remove(int index);
+
+	/**
+	 * Gets the number of separately added pieces of text.
+	 **/
+	int getCount() const;
+
 	void clear();
 
 	void setFont(Font *f);
@@ -78,11 +97,21 @@ private:
 		bool useMatrix;
 		bool appendVertices;
 		Matrix4 matrix;
+
+		// Location of this text's vertices, and its draw commands relative to
+		// the first vertex.
+		int vertexStart = 0;
+		int vertexCount = 0;
+		std::vector<Font::DrawCommand> drawCommands;
 	};
 
+	void reserveVertices(size_t vertexcount);
 	void uploadVertices(const std::vector<Font::GlyphVertex> &vertices, size_t vertoffset);
 	void regenerateVertices();
+	void generateTextData(TextData &t, std::vector<Font::GlyphVertex> &vertices);
+	void appendDrawCommands(const std::vector<Font::DrawCommand> &commands, int vertexstart);
 	void addTextData(const TextData &s);
+	void replaceTextData(int index, const TextData *data);
 
 	StrongRef<Font> font;
 
@@ -22,6 +22,7 @@
 #include "common/config.h"
 #include "Texture.h"
 #include "Graphics.h"
+#include "common/memory.h"
 
 // C
 #include <cmath>
@@ -158,6 +159,8 @@ std::vector<std::string> SamplerState::getConstants(WrapMode)
 }
 
 love::Type Texture::type("Texture", &Drawable::type);
+love::Type TextureUpload::type("TextureUpload", &Object::type);
+love::Type StreamingTexture::type("StreamingTexture", &Drawable::type);
 int Texture::textureCount = 0;
 int64 Texture::totalGraphicsMemory = 0;
 
@@ -167,6 +170,7 @@ Texture::Texture(Graphics *gfx, const Settings &settings, const Slices *slices)
 	, renderTarget(settings.renderTarget)
 	, computeWrite(settings.computeWrite)
 	, readable(true)
+	, memoryless(settings.memoryless)
 	, viewFormats(settings.viewFormats)
 	, mipmapsMode(settings.mipmaps)
 	, width(settings.width)
@@ -235,6 +239,8 @@ Texture::Texture(Graphics *gfx, const Settings &settings, const Slices *slices)
 
 	if (settings.readable.hasValue)
 		readable = settings.readable.value;
+	else if (memoryless && settings.msaa <= 1)
+		readable = false;
 	else
 		readable = !renderTarget || !isPixelFormatDepthStencil(format);
 
@@ -284,6 +290,12 @@ Texture::Texture(Graphics *gfx, const Settings &settings, const Slices *slices)
 	if (isCompressed() && renderTarget)
 		throw love::Exception("Compressed textures cannot be render targets.");
 
+	if (memoryless && (!renderTarget || texType != TEXTURE_2D || computeWrite))
+		throw love::Exception("Memoryless textures must be 2D render targets without compute write support.");
+
+	if (memoryless && readable && settings.msaa <= 1)
+		throw love::Exception("Memoryless textures cannot be readable unless they use MSAA.");
+
 	if (isPixelFormatDepthStencil(format) && !renderTarget)
 		throw love::Exception("Depth or stencil pixel formats are only supported with render target textures.");
 
@@ -340,6 +352,7 @@ Texture::Texture(Graphics *gfx, Texture *base, const ViewSettings &viewsettings)
 	, renderTarget(base->renderTarget)
 	, computeWrite(base->computeWrite)
 	, readable(base->readable)
+	, memoryless(base->memoryless)
 	, viewFormats(base->viewFormats)
 	, mipmapsMode(base->mipmapsMode)
 	, width(1)
@@ -452,6 +465,13 @@ Texture::~Texture()
 {
 	updateGraphicsMemorySize(false);
 
+	if (arrayBatch.arrayTexture != nullptr)
+	{
+		auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+		if (gfx != nullptr)
+			gfx->removeFromTextureArrayBatch(this);
+	}
+
 	if (this == rootView.texture)
 		--textureCount;
 
@@ -487,6 +507,7 @@ void Texture::updateGraphicsMemorySize(bool loaded)
 	totalGraphicsMemory = std::max(totalGraphicsMemory - graphicsMemorySize, (int64) 0);
 
 	memsize = std::max(memsize, (int64) 0);
+	trackMemory(MEMORYTAG_TEXTURE, memsize - graphicsMemorySize);
 	graphicsMemorySize = memsize;
 	totalGraphicsMemory += memsize;
 }
@@ -510,6 +531,14 @@ void Texture::draw(Graphics *gfx, Quad *q, const Matrix4 &localTransform)
 	if (renderTarget && gfx->isRenderTargetActive(this))
 		throw love::Exception("Cannot render a Texture to itself.");
 
+	Texture *arraytexture = nullptr;
+	int arraylayer = 0;
+	if (gfx->getTextureArrayBatchLayer(this, arraytexture, arraylayer))
+	{
+		arraytexture->drawLayer(gfx, arraylayer, q, localTransform);
+		return;
+	}
+
 	const Matrix4 &tm = gfx->getTransform();
 	bool is2D = tm.isAffine2DTransform();
 
@@ -598,10 +627,10 @@ void Texture::drawLayer(Graphics *gfx, int layer, Quad *q, const Matrix4 &m)
 void Texture::uploadImageData(love::image::ImageDataBase *d, int level, int slice, int x, int y)
 {
 	Rect rect = {x, y, d->getWidth(), d->getHeight()};
-	uploadByteData(d->getData(), d->getSize(), level, slice, rect);
+	uploadByteData(d->getReadOnlyData(), d->getSize(), level, slice, rect);
 }
 
-void Texture::replacePixels(love::image::ImageDataBase *d, int slice, int mipmap, int x, int y, bool reloadmipmaps)
+void Texture::validateReplacePixels(love::image::ImageDataBase *d, int slice, int mipmap, const Rect &rect) const
 {
 	if (!isReadable())
 		throw love::Exception("replacePixels can only be called on readable Textures.");
@@ -613,13 +642,9 @@ void Texture::replacePixels(love::image::ImageDataBase *d, int slice, int mipmap
 		throw love::Exception("replacePixels cannot be called on depth or stencil Textures.");
 
 	auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
-	if (gfx != nullptr && gfx->isRenderTargetActive(this))
+	if (gfx != nullptr && gfx->isRenderTargetActive(const_cast<Texture *>(this)))
 		throw love::Exception("replacePixels cannot be called on this Texture while it's an active render target.");
 
-	// No effect if the texture hasn't been created yet.
-	if (getHandle() == 0)
-		return;
-
 	// ImageData format might be linear but intended to be used as sRGB, so we
 	// don't error if only the sRGBness is different.
 	if (getLinearPixelFormat(d->getFormat()) != getLinearPixelFormat(getPixelFormat()))
@@ -635,8 +660,6 @@ void Texture::replacePixels(love::image::ImageDataBase *d, int slice, int mipmap
 		throw love::Exception("Invalid texture slice index %d.", slice + 1);
 	}
 
-	Rect rect = {x, y, d->getWidth(), d->getHeight()};
-
 	int mipw = getPixelWidth(mipmap);
 	int miph = getPixelHeight(mipmap);
 
@@ -658,9 +681,24 @@ void Texture::replacePixels(love::image::ImageDataBase *d, int slice, int mipmap
 			throw love::Exception("Compressed texture format %s only supports replacing a sub-rectangle with offset and dimensions that are a multiple of %d x %d.", name, bw, bh);
 		}
 	}
+}
+
+void Texture::replacePixels(love::image::ImageDataBase *d, int slice, int mipmap, int x, int y, bool reloadmipmaps)
+{
+	Rect rect = {x, y, d->getWidth(), d->getHeight()};
+	validateReplacePixels(d, slice, mipmap, rect);
+
+	// No effect if the texture hasn't been created yet.
+	if (getHandle() == 0)
+		return;
+
+	auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
 
 	Graphics::flushBatchedDrawsGlobal();
 
+	if (gfx != nullptr)
+		gfx->removeFromTextureArrayBatch(rootView.texture);
+
 	uploadImageData(d, mipmap, slice, x, y);
 
 	if (reloadmipmaps && mipmap == 0 && getMipmapCount() > 1)
@@ -678,6 +716,9 @@ void Texture::replacePixels(const void *data, size_t size, int slice, int mipmap
 
 	Graphics::flushBatchedDrawsGlobal();
 
+	if (gfx != nullptr)
+		gfx->removeFromTextureArrayBatch(rootView.texture);
+
 	uploadByteData(data, size, mipmap, slice, rect);
 
 	if (reloadmipmaps && mipmap == 0 && getMipmapCount() > 1)
@@ -1136,7 +1177,9 @@ static StringMap<Texture::SettingType, Texture::SETTING_MAX_ENUM>::Entry setting
 	{ "computewrite", Texture::SETTING_COMPUTE_WRITE },
 	{ "viewformats",  Texture::SETTING_VIEW_FORMATS  },
 	{ "readable",     Texture::SETTING_READABLE      },
+	{ "memoryless",   Texture::SETTING_MEMORYLESS    },
 	{ "debugname",    Texture::SETTING_DEBUGNAME     },
+	{ "compress",     Texture::SETTING_COMPRESS      },
 };
 
 static StringMap<Texture::SettingType, Texture::SETTING_MAX_ENUM> settingTypes(settingTypeEntries, sizeof(settingTypeEntries));
@@ -1176,6 +1219,119 @@ bool Texture::getConstant(const char *in, SettingType &out)
 	return settingTypes.find(in, out);
 }
 
+TextureUpload::TextureUpload(Texture *texture, Buffer *stagingbuffer)
+	: texture(texture)
+	, stagingBuffer(stagingbuffer)
+	, framesRemaining(stagingbuffer != nullptr ? UPLOAD_FRAMES_IN_FLIGHT : 0)
+{
+}
+
+TextureUpload::~TextureUpload()
+{
+}
+
+StreamingTexture::StreamingTexture(Graphics *gfx, love::image::CompressedImageData *data, const Texture::Settings &settings)
+	: gfx(gfx)
+	, data(data)
+	, settings(settings)
+	, residentMipmap(-1)
+	, desiredMipmap(0)
+	, framesSinceDraw(1)
+{
+	if (data->getSliceCount(0) != 1)
+		throw love::Exception("Streaming textures must use 2D image data.");
+
+	this->settings.type = TEXTURE_2D;
+	this->settings.renderTarget = false;
+	this->settings.computeWrite = false;
+	this->settings.msaa = 1;
+
+	// Start with the first level which is small enough to be cheap to load,
+	// and let Graphics stream in more detail once it's needed.
+	int mipcount = getMipmapCount();
+	int mip = 0;
+	while (mip < mipcount - 1 && std::max(data->getWidth(mip), data->getHeight(mip)) > INITIAL_MAX_SIZE)
+		mip++;
+
+	setResidentMipmap(mip);
+	desiredMipmap = mipcount - 1;
+
+	gfx->addStreamingTexture(this);
+}
+
+StreamingTexture::~StreamingTexture()
+{
+	auto graphics = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+	if (graphics == gfx)
+		gfx->removeStreamingTexture(this);
+}
+
+int StreamingTexture::getMipmapCount() const
+{
+	return data->getMipmapCount();
+}
+
+int64 StreamingTexture::getResidentMemorySize(int firstmipmap) const
+{
+	int64 size = 0;
+	for (int mip = std::max(firstmipmap, 0); mip < getMipmapCount(); mip++)
+		size += (int64) data->getSize(mip);
+	return size;
+}
+
+void StreamingTexture::setResidentMipmap(int mipmap)
+{
+	mipmap = std::min(std::max(mipmap, 0), getMipmapCount() - 1);
+	if (mipmap == residentMipmap)
+		return;
+
+	Texture::Slices slices(TEXTURE_2D);
+	for (int mip = mipmap; mip < getMipmapCount(); mip++)
+		slices.set(0, mip - mipmap, data->getSlice(0, mip));
+
+	// Scaling the DPI with the mipmap keeps the Texture's logical size, so
+	// draws and Quads don't change when detail is streamed in or out.
+	Texture::Settings s = settings;
+	s.dpiScale = settings.dpiScale / (float) (1 << mipmap);
+	s.mipmaps = getMipmapCount() - mipmap > 1 ? Texture::MIPMAPS_MANUAL : Texture::MIPMAPS_NONE;
+	s.mipmapCount = 0;
+
+	StrongRef<Texture> newtexture(gfx->newTexture(s, &slices), Acquire::NORETAIN);
+
+	if (texture.get())
+		newtexture->setSamplerState(texture->getSamplerState());
+
+	texture = newtexture;
+	residentMipmap = mipmap;
+}
+
+void StreamingTexture::draw(Graphics *gfx, const Matrix4 &m)
+{
+	Matrix4 t(gfx->getTransform(), m);
+	const float *e = t.getElements();
+
+	// Number of screen pixels covered by one texel of the most detailed level.
+	float dpiscale = (float) gfx->getCurrentDPIScale();
+	float sx = sqrtf(e[0] * e[0] + e[1] * e[1]) * dpiscale;
+	float sy = sqrtf(e[4] * e[4] + e[5] * e[5]) * dpiscale;
+	float screenscale = std::max(sx, sy) / settings.dpiScale;
+
+	int mip = 0;
+	if (screenscale > 0.0f && screenscale < 1.0f)
+		mip = (int) floorf(log2f(1.0f / screenscale));
+
+	desiredMipmap = std::min(desiredMipmap, std::min(mip, getMipmapCount() - 1));
+	framesSinceDraw = 0;
+
+	texture->draw(gfx, m);
+}
+
+void StreamingTexture::nextFrame()
+{
+	desiredMipmap = getMipmapCount() - 1;
+	framesSinceDraw = std::min(framesSinceDraw, LOVE_INT32_MAX - 1) + 1;
+}
+
 bool Texture::getConstant(SettingType in, const char *&out)
 {
 	return settingTypes.find(in, out);
@@ -177,7 +177,9 @@ public:
 		SETTING_COMPUTE_WRITE,
 		SETTING_VIEW_FORMATS,
 		SETTING_READABLE,
+		SETTING_MEMORYLESS,
 		SETTING_DEBUGNAME,
+		SETTING_COMPRESS,
 		SETTING_MAX_ENUM
 	};
 
@@ -198,7 +200,13 @@ public:
 		bool computeWrite = false;
 		std::vector<PixelFormat> viewFormats;
 		OptionalBool readable;
+		// Render target contents only need to exist while they're being
+		// rendered to. For MSAA textures this only applies to the multisample
+		// buffer, not the resolved texture.
+		bool memoryless = false;
 		std::string debugName;
+		// Only used by love.graphics.newTexture, to compress ImageData.
+		PixelFormat compressFormat = PIXELFORMAT_UNKNOWN;
 	};
 
 	struct ViewSettings
@@ -249,6 +257,16 @@ public:
 		int startLayer;
 	};
 
+	// Where Graphics has copied this texture to, when texture array batching
+	// is enabled. A negative draw count means the texture can't be batched.
+	struct ArrayBatchInfo
+	{
+		Texture *arrayTexture = nullptr;
+		int layer = -1;
+		int drawCount = 0;
+		uint64 samplerKey = 0;
+	};
+
 	static int64 totalGraphicsMemory;
 
 	// Drawable.
@@ -263,9 +281,15 @@ public:
 	void drawLayer(Graphics *gfx, int layer, Quad *quad, const Matrix4 &m);
 
 	void replacePixels(love::image::ImageDataBase *d, int slice, int mipmap, int x, int y, bool reloadmipmaps);
+
+	/**
+	 * Throws if replacePixels can't be used with the given data and region.
+	 **/
+	void validateReplacePixels(love::image::ImageDataBase *d, int slice, int mipmap, const Rect &rect) const;
 	void replacePixels(const void *data, size_t size, int slice, int mipmap, const Rect &rect, bool reloadmipmaps);
 
 	void generateMipmaps();
+	bool supportsGenerateMipmaps(const char *&outReason) const;
 
 	virtual void copyFromBuffer(Buffer *source, size_t sourceoffset, int sourcewidth, size_t size, int slice, int mipmap, const Rect &rect) = 0;
 	virtual void copyToBuffer(Buffer *dest, int slice, int mipmap, const Rect &rect, size_t destoffset, int destwidth, size_t size) = 0;
@@ -280,6 +304,7 @@ public:
 	bool isRenderTarget() const { return renderTarget; }
 	bool isComputeWritable() const { return computeWrite; }
 	bool isReadable() const { return readable; }
+	bool isMemoryless() const { return memoryless; }
 
 	const std::vector<PixelFormat> &getViewFormats() const { return viewFormats; }
 
@@ -315,6 +340,8 @@ public:
 
 	const std::string &getDebugName() const { return debugName; }
 
+	ArrayBatchInfo &getArrayBatchInfo() { return arrayBatch; }
+
 	static int getTotalMipmapCount(int w, int h);
 	static int getTotalMipmapCount(int w, int h, int d);
 
@@ -342,7 +369,6 @@ protected:
 	void uploadImageData(love::image::ImageDataBase *d, int level, int slice, int x, int y);
 	virtual void uploadByteData(const void *data, size_t size, int level, int slice, const Rect &r) = 0;
 
-	bool supportsGenerateMipmaps(const char *&outReason) const;
 	virtual void generateMipmapsInternal() = 0;
 
 	SamplerState validateSamplerState(SamplerState s) const;
@@ -356,6 +382,7 @@ protected:
 	bool renderTarget;
 	bool computeWrite;
 	bool readable;
+	bool memoryless;
 
 	std::vector<PixelFormat> viewFormats;
 
@@ -384,8 +411,92 @@ protected:
 	ViewInfo rootView;
 	ViewInfo parentView;
 
+	ArrayBatchInfo arrayBatch;
+
 }; // Texture
 
+/**
+ * Tracks a pixel upload which was staged through a temporary Buffer and
+ * queued as a GPU-side copy. The staging Buffer is returned to Graphics'
+ * temporary pool once the copy is known to have been consumed.
+ **/
+class TextureUpload : public love::Object
+{
+public:
+
+	static love::Type type;
+
+	TextureUpload(Texture *texture, Buffer *stagingbuffer);
+	virtual ~TextureUpload();
+
+	// Must be called on the main thread.
+	virtual bool isComplete() { return stagingBuffer == nullptr; }
+	Texture *getTexture() const { return texture.get(); }
+
+private:
+
+	friend class Graphics;
+
+	// Number of presented frames after which the copy is assumed to have
+	// been consumed by the GPU.
+	static const int UPLOAD_FRAMES_IN_FLIGHT = 3;
+
+	StrongRef<Texture> texture;
+	Buffer *stagingBuffer;
+	int framesRemaining;
+
+}; // TextureUpload
+
+/**
+ * Wraps a Texture whose GPU allocation only covers the mipmap levels of its
+ * compressed source data which are currently needed. The smallest levels are
+ * loaded first, and Graphics streams in more detail once the texture is drawn
+ * large enough on screen, or drops the most detailed levels again when the
+ * texture streaming budget is exceeded.
+ **/
+class StreamingTexture : public Drawable
+{
+public:
+
+	static love::Type type;
+
+	StreamingTexture(Graphics *gfx, love::image::CompressedImageData *data, const Texture::Settings &settings);
+	virtual ~StreamingTexture();
+
+	void draw(Graphics *gfx, const Matrix4 &m) override;
+
+	// The returned Texture is replaced whenever the resident mipmaps change.
+	Texture *getTexture() const { return texture.get(); }
+	love::image::CompressedImageData *getData() const { return data.get(); }
+
+	int getMipmapCount() const;
+	int getResidentMipmap() const { return residentMipmap; }
+	int getDesiredMipmap() const { return desiredMipmap; }
+	int getFramesSinceDraw() const { return framesSinceDraw; }
+
+	// GPU memory used when the given mipmap and all smaller ones are resident.
+	int64 getResidentMemorySize(int firstmipmap) const;
+
+	void setResidentMipmap(int mipmap);
+
+	// Called by Graphics once per frame, after residency has been updated.
+	void nextFrame();
+
+private:
+
+	static const int INITIAL_MAX_SIZE = 64;
+
+	Graphics *gfx;
+	StrongRef<love::image::CompressedImageData> data;
+	Texture::Settings settings;
+	StrongRef<Texture> texture;
+
+	int residentMipmap;
+	int desiredMipmap;
+	int framesSinceDraw;
+
+}; // StreamingTexture
+
 } // graphics
 } // love
 
@@ -24,6 +24,9 @@
 #include "Shader.h"
 #include "Graphics.h"
 
+// C++
+#include <cstring>
+
 namespace love
 {
 namespace graphics
@@ -36,6 +39,7 @@ Video::Video(Graphics *gfx, love::video::VideoStream *stream, float dpiscale)
 	, width(stream->getWidth() / dpiscale)
 	, height(stream->getHeight() / dpiscale)
 	, samplerState()
+	, currentSet(0)
 {
 	const SamplerState &defaultSampler = gfx->getDefaultSamplerState();
 	samplerState.minFilter = defaultSampler.minFilter;
@@ -71,33 +75,30 @@ Video::Video(Graphics *gfx, love::video::VideoStream *stream, float dpiscale)
 	vertices[3].s = 1.0f;
 	vertices[3].t = 1.0f;
 
-	// Create the textures using the initial frame data.
+	// Create the textures and upload the initial frame data.
 	auto frame = (const love::video::VideoStream::Frame*) stream->getFrontBuffer();
 
 	int widths[3]  = {frame->yw, frame->cw, frame->cw};
 	int heights[3] = {frame->yh, frame->ch, frame->ch};
 
-	const unsigned char *data[3] = {frame->yplane, frame->cbplane, frame->crplane};
-
 	Texture::Settings settings;
 
-	for (int i = 0; i < 3; i++)
+	for (int set = 0; set < FRAME_SET_COUNT; set++)
 	{
-		settings.width = widths[i];
-		settings.height = heights[i];
-		settings.format = PIXELFORMAT_R8_UNORM;
-		Texture *tex = gfx->newTexture(settings, nullptr);
-
-		tex->setSamplerState(samplerState);
-
-		size_t bpp = getPixelFormatBlockSize(PIXELFORMAT_R8_UNORM);
-		size_t size = bpp * widths[i] * heights[i];
+		for (int i = 0; i < 3; i++)
+		{
+			settings.width = widths[i];
+			settings.height = heights[i];
+			settings.format = PIXELFORMAT_R8_UNORM;
+			Texture *tex = gfx->newTexture(settings, nullptr);
 
-		Rect rect = {0, 0, widths[i], heights[i]};
-		tex->replacePixels(data[i], size, 0, 0, rect, false);
+			tex->setSamplerState(samplerState);
 
-		textures[i].set(tex, Acquire::NORETAIN);
+			textures[set][i].set(tex, Acquire::NORETAIN);
+		}
 	}
+
+	uploadFrame(gfx, frame, currentSet);
 }
 
 Video::~Video()
@@ -113,7 +114,7 @@ love::video::VideoStream *Video::getStream()
 
 void Video::draw(Graphics *gfx, const Matrix4 &m)
 {
-	update();
+	update(gfx);
 
 	// setVideoTextures may call flushBatchedDraws before setting the textures, so
 	// we can't call it after requestBatchedDraw.
@@ -122,7 +123,10 @@ void Video::draw(Graphics *gfx, const Matrix4 &m)
 		shader = Shader::standardShaders[Shader::STANDARD_VIDEO];
 
 	if (shader != nullptr)
-		shader->setVideoTextures(textures[0], textures[1], textures[2]);
+	{
+		const auto &yuv = textures[currentSet];
+		shader->setVideoTextures(yuv[0], yuv[1], yuv[2]);
+	}
 
 	const Matrix4 &tm = gfx->getTransform();
 	bool is2D = tm.isAffine2DTransform();
@@ -157,7 +161,7 @@ void Video::draw(Graphics *gfx, const Matrix4 &m)
 	gfx->flushBatchedDraws();
 }
 
-void Video::update()
+void Video::update(Graphics *gfx)
 {
 	bool bufferschanged = stream->swapBuffers();
 	stream->fillBackBuffer();
@@ -166,19 +170,70 @@ void Video::update()
 	{
 		auto frame = (const love::video::VideoStream::Frame*) stream->getFrontBuffer();
 
-		int widths[3]  = {frame->yw, frame->cw, frame->cw};
-		int heights[3] = {frame->yh, frame->ch, frame->ch};
+		int set = (currentSet + 1) % FRAME_SET_COUNT;
+		uploadFrame(gfx, frame, set);
+		currentSet = set;
+	}
+}
+
+void Video::uploadFrame(Graphics *gfx, const love::video::VideoStream::Frame *frame, int set)
+{
+	int widths[3]  = {frame->yw, frame->cw, frame->cw};
+	int heights[3] = {frame->yh, frame->ch, frame->ch};
+
+	const unsigned char *data[3] = {frame->yplane, frame->cbplane, frame->crplane};
+
+	size_t bpp = getPixelFormatBlockSize(PIXELFORMAT_R8_UNORM);
+
+	size_t sizes[3];
+	size_t offsets[3];
+	size_t totalsize = 0;
 
-		const unsigned char *data[3] = {frame->yplane, frame->cbplane, frame->crplane};
+	// Buffer-to-texture copies need 4 byte aligned offsets and sizes.
+	bool usestaging = true;
 
+	for (int i = 0; i < 3; i++)
+	{
+		sizes[i] = bpp * widths[i] * heights[i];
+		offsets[i] = totalsize;
+		totalsize += sizes[i];
+
+		if (sizes[i] % 4 != 0)
+			usestaging = false;
+	}
+
+	if (!usestaging)
+	{
 		for (int i = 0; i < 3; i++)
 		{
-			size_t bpp = getPixelFormatBlockSize(PIXELFORMAT_R8_UNORM);
-			size_t size = bpp * widths[i] * heights[i];
-
 			Rect rect = {0, 0, widths[i], heights[i]};
-			textures[i]->replacePixels(data[i], size, 0, 0, rect, false);
+			textures[set][i]->replacePixels(data[i], sizes[i], 0, 0, rect, false);
 		}
+		return;
+	}
+
+	// The planes are copied into a staging buffer and then uploaded to the
+	// textures from there, which lets the upload happen asynchronously
+	// instead of stalling until the driver has consumed the CPU-side data.
+	Buffer *buffer = stagingBuffers[set].get();
+
+	if (buffer == nullptr || buffer->getSize() < totalsize)
+	{
+		Buffer::Settings settings(0, BUFFERDATAUSAGE_STREAM);
+		buffer = gfx->newBuffer(settings, DATAFORMAT_UINT32, nullptr, totalsize, 0);
+		stagingBuffers[set].set(buffer, Acquire::NORETAIN);
+	}
+
+	{
+		Buffer::Mapper mapper(*buffer);
+		for (int i = 0; i < 3; i++)
+			memcpy((uint8 *) mapper.data + offsets[i], data[i], sizes[i]);
+	}
+
+	for (int i = 0; i < 3; i++)
+	{
+		Rect rect = {0, 0, widths[i], heights[i]};
+		gfx->copyBufferToTexture(buffer, textures[set][i], offsets[i], widths[i], 0, 0, rect);
 	}
 }
 
@@ -220,8 +275,11 @@ void Video::setSamplerState(const SamplerState &s)
 	samplerState.wrapV = s.wrapV;
 	samplerState.maxAnisotropy = s.maxAnisotropy;
 
-	for (const auto &texture : textures)
-		texture->setSamplerState(samplerState);
+	for (const auto &set : textures)
+	{
+		for (const auto &texture : set)
+			texture->setSamplerState(samplerState);
+	}
 }
 
 const SamplerState &Video::getSamplerState() const
@@ -24,6 +24,7 @@
 #include "common/math.h"
 #include "Drawable.h"
 #include "Texture.h"
+#include "Buffer.h"
 #include "vertex.h"
 #include "video/VideoStream.h"
 #include "audio/Source.h"
@@ -63,7 +64,13 @@ public:
 
 private:
 
-	void update();
+	// Frames alternate between sets of YUV textures and staging buffers, so
+	// uploading a new frame doesn't have to wait for the GPU to finish with
+	// the previous one.
+	static const int FRAME_SET_COUNT = 2;
+
+	void update(Graphics *gfx);
+	void uploadFrame(Graphics *gfx, const love::video::VideoStream::Frame *frame, int set);
 
 	StrongRef<love::video::VideoStream> stream;
 
@@ -74,9 +81,12 @@ private:
 
 	Vertex vertices[4];
 
-	StrongRef<Texture> textures[3];
+	StrongRef<Texture> textures[FRAME_SET_COUNT][3];
+	StrongRef<Buffer> stagingBuffers[FRAME_SET_COUNT];
+	int currentSet;
+
 	StrongRef<love::audio::Source> source;
-	
+
 }; // Video
 
 } // graphics
@@ -0,0 +1,607 @@
+/**
+* Copyright (c) 2006-2024 LOVE Development Team
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+**/
+
+// LOVE
+#include "VirtualTexture.h"
+#include "Graphics.h"
+#include "filesystem/Filesystem.h"
+#include "image/Image.h"
+
+// C++
+#include <algorithm>
+#include <string.h>
+
+namespace love
+{
+namespace graphics
+{
+
+love::Type VirtualTexture::type("VirtualTexture", &Drawable::type);
+
+VirtualTexture::VirtualTexture(Graphics *gfx, int width, int height, const Settings &settings)
+	: gfx(gfx)
+	, settings(settings)
+	, width(width)
+	, height(height)
+	, tilesX(0)
+	, tilesY(0)
+	, slotSize(0)
+	, residentCount(0)
+	, indirectionDirty()
+	, frame(1)
+{
+	if (width <= 0 || height <= 0)
+		throw love::Exception("VirtualTexture dimensions must be greater than 0.");
+
+	if (settings.tileSize <= 0)
+		throw love::Exception("VirtualTexture tile size must be greater than 0.");
+
+	// Cache slot coordinates are stored in 8 bit indirection texels.
+	if (settings.cacheSize <= 0 || settings.cacheSize > 256)
+		throw love::Exception("VirtualTexture cache size must be between 1 and 256 tiles.");
+
+	if (settings.uploadsPerFrame <= 0)
+		throw love::Exception("VirtualTexture uploads per frame must be greater than 0.");
+
+	if (isPixelFormatCompressed(settings.format) || isPixelFormatDepthStencil(settings.format))
+		throw love::Exception("VirtualTextures must use an uncompressed color pixel format.");
+
+	if (!settings.tilePath.empty())
+	{
+		if (Module::getInstance<love::filesystem::Filesystem>(Module::M_FILESYSTEM) == nullptr)
+			throw love::Exception("Streaming VirtualTexture tiles requires the love.filesystem module.");
+		if (Module::getInstance<love::image::Image>(Module::M_IMAGE) == nullptr)
+			throw love::Exception("Streaming VirtualTexture tiles requires the love.image module.");
+	}
+
+	tilesX = (width + settings.tileSize - 1) / settings.tileSize;
+	tilesY = (height + settings.tileSize - 1) / settings.tileSize;
+	slotSize = settings.tileSize + 2;
+
+	int maxsize = (int) gfx->getCapabilities().limits[Graphics::LIMIT_TEXTURE_SIZE];
+
+	if (tilesX > maxsize || tilesY > maxsize)
+		throw love::Exception("VirtualTexture has too many tiles for its indirection texture (%dx%d, the maximum is %dx%d). Use a larger tile size.", tilesX, tilesY, maxsize, maxsize);
+
+	if (slotSize * settings.cacheSize > maxsize)
+		throw love::Exception("VirtualTexture cache texture would be %d pixels wide, the maximum is %d. Use a smaller tile size or cache size.", slotSize * settings.cacheSize, maxsize);
+
+	Texture::Settings s;
+	s.width = slotSize * settings.cacheSize;
+	s.height = slotSize * settings.cacheSize;
+	s.format = settings.format;
+	s.linear = settings.linear;
+	s.debugName = settings.debugName;
+
+	cacheTexture.set(gfx->newTexture(s, nullptr), Acquire::NORETAIN);
+
+	{
+		std::vector<uint8> emptydata(getPixelFormatSliceSize(s.format, s.width, s.height), 0);
+		Rect rect = {0, 0, s.width, s.height};
+		cacheTexture->replacePixels(emptydata.data(), emptydata.size(), 0, 0, rect, false);
+	}
+
+	s.width = tilesX;
+	s.height = tilesY;
+	s.format = PIXELFORMAT_RGBA8_UNORM;
+	s.linear = true;
+	s.debugName = settings.debugName.empty() ? std::string() : settings.debugName + " indirection";
+
+	indirectionTexture.set(gfx->newTexture(s, nullptr), Acquire::NORETAIN);
+
+	SamplerState sampler = indirectionTexture->getSamplerState();
+	sampler.minFilter = SamplerState::FILTER_NEAREST;
+	sampler.magFilter = SamplerState::FILTER_NEAREST;
+	sampler.wrapU = SamplerState::WRAP_CLAMP;
+	sampler.wrapV = SamplerState::WRAP_CLAMP;
+	indirectionTexture->setSamplerState(sampler);
+
+	indirection.assign((size_t) tilesX * tilesY * 4, 0);
+	indirectionDirty = {0, 0, tilesX, tilesY};
+	flushIndirection();
+
+	slots.assign((size_t) settings.cacheSize * settings.cacheSize, -1);
+
+	gfx->addVirtualTexture(this);
+}
+
+VirtualTexture::~VirtualTexture()
+{
+	for (auto &pair : tiles)
+	{
+		if (pair.second.request.get())
+			pair.second.request->cancel();
+	}
+
+	auto graphics = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+	if (graphics == gfx)
+		gfx->removeVirtualTexture(this);
+}
+
+void VirtualTexture::requestRegion(int x, int y, int w, int h)
+{
+	int tx0 = std::max(x, 0) / settings.tileSize;
+	int ty0 = std::max(y, 0) / settings.tileSize;
+	int tx1 = std::min((int64) x + w, (int64) width) > 0 ? (int) ((std::min((int64) x + w, (int64) width) - 1) / settings.tileSize) : -1;
+	int ty1 = std::min((int64) y + h, (int64) height) > 0 ? (int) ((std::min((int64) y + h, (int64) height) - 1) / settings.tileSize) : -1;
+
+	// Touching more tiles than fit in the cache would only make them evict
+	// each other.
+	int budget = (int) slots.size();
+
+	for (int ty = ty0; ty <= ty1 && budget > 0; ty++)
+	{
+		for (int tx = tx0; tx <= tx1 && budget > 0; tx++, budget--)
+			touchTile(tx, ty);
+	}
+}
+
+void VirtualTexture::touchTile(int tx, int ty)
+{
+	Tile &tile = tiles[getTileKey(tx, ty)];
+	tile.lastUsedFrame = frame;
+}
+
+void VirtualTexture::setTile(int tx, int ty, love::image::ImageData *data)
+{
+	if (tx < 0 || ty < 0 || tx >= tilesX || ty >= tilesY)
+		throw love::Exception("Invalid tile (%d, %d). The VirtualTexture has %dx%d tiles.", tx, ty, tilesX, tilesY);
+
+	if (data->getFormat() != settings.format)
+		throw love::Exception("The ImageData's pixel format must match the VirtualTexture's.");
+
+	int tilew = std::min(settings.tileSize, width - tx * settings.tileSize);
+	int tileh = std::min(settings.tileSize, height - ty * settings.tileSize);
+
+	if (data->getWidth() != tilew || data->getHeight() != tileh)
+		throw love::Exception("Tile (%d, %d) must be %dx%d pixels, the ImageData is %dx%d.", tx, ty, tilew, tileh, data->getWidth(), data->getHeight());
+
+	uint64 key = getTileKey(tx, ty);
+	Tile &tile = tiles[key];
+
+	if (tile.request.get())
+		tile.request->cancel();
+	tile.request.set(nullptr);
+	tile.decode.set(nullptr);
+
+	tile.lastUsedFrame = std::max(tile.lastUsedFrame, frame);
+
+	int slot = tile.slot >= 0 ? tile.slot : acquireSlot();
+	if (slot < 0)
+		throw love::Exception("All VirtualTexture cache slots are in use by tiles drawn this frame.");
+
+	uploadTile(key, tile, slot, data);
+	flushIndirection();
+}
+
+bool VirtualTexture::isTileResident(int tx, int ty) const
+{
+	if (tx < 0 || ty < 0 || tx >= tilesX || ty >= tilesY)
+		return false;
+
+	auto it = tiles.find(getTileKey(tx, ty));
+	return it != tiles.end() && it->second.status == TILE_RESIDENT;
+}
+
+void VirtualTexture::getPendingTiles(std::vector<int> &pending) const
+{
+	for (const auto &pair : tiles)
+	{
+		if (pair.second.status == TILE_RESIDENT || pair.second.status == TILE_FAILED)
+			continue;
+
+		pending.push_back((int) (pair.first % (uint64) tilesX));
+		pending.push_back((int) (pair.first / (uint64) tilesX));
+	}
+}
+
+int VirtualTexture::acquireSlot()
+{
+	int lru = -1;
+	uint64 lruframe = frame;
+
+	for (int i = 0; i < (int) slots.size(); i++)
+	{
+		if (slots[i] < 0)
+			return i;
+
+		const Tile &tile = tiles.find((uint64) slots[i])->second;
+		if (tile.lastUsedFrame < lruframe)
+		{
+			lru = i;
+			lruframe = tile.lastUsedFrame;
+		}
+	}
+
+	// Tiles used this frame are never evicted.
+	if (lru < 0)
+		return -1;
+
+	uint64 key = (uint64) slots[lru];
+	setIndirection(key, -1);
+	tiles.erase(key);
+	slots[lru] = -1;
+	residentCount--;
+
+	return lru;
+}
+
+void VirtualTexture::uploadTile(uint64 key, Tile &tile, int slot, love::image::ImageData *data)
+{
+	int w = data->getWidth();
+	int h = data->getHeight();
+	size_t pixelsize = getPixelFormatBlockSize(settings.format);
+
+	// Repeat the tile's edge pixels into a 1 pixel border, so filtering at
+	// its edges doesn't blend in the neighbouring cache slots.
+	int pw = w + 2;
+	int ph = h + 2;
+	uploadScratch.resize((size_t) pw * ph * pixelsize);
+
+	const uint8 *src = (const uint8 *) data->getReadOnlyData();
+	for (int y = 0; y < ph; y++)
+	{
+		int sy = std::min(std::max(y - 1, 0), h - 1);
+		const uint8 *srcrow = src + (size_t) sy * w * pixelsize;
+		uint8 *dstrow = uploadScratch.data() + (size_t) y * pw * pixelsize;
+
+		memcpy(dstrow, srcrow, pixelsize);
+		memcpy(dstrow + pixelsize, srcrow, w * pixelsize);
+		memcpy(dstrow + (w + 1) * pixelsize, srcrow + (w - 1) * pixelsize, pixelsize);
+	}
+
+	int cs = settings.cacheSize;
+	Rect rect = {(slot % cs) * slotSize, (slot / cs) * slotSize, pw, ph};
+	cacheTexture->replacePixels(uploadScratch.data(), uploadScratch.size(), 0, 0, rect, false);
+
+	if (tile.status != TILE_RESIDENT)
+		residentCount++;
+
+	slots[slot] = (int64) key;
+	tile.slot = slot;
+	tile.status = TILE_RESIDENT;
+	setIndirection(key, slot);
+}
+
+void VirtualTexture::setIndirection(uint64 key, int slot)
+{
+	int tx = (int) (key % (uint64) tilesX);
+	int ty = (int) (key / (uint64) tilesX);
+
+	uint8 *texel = indirection.data() + ((size_t) ty * tilesX + tx) * 4;
+	texel[0] = slot >= 0 ? (uint8) (slot % settings.cacheSize) : 0;
+	texel[1] = slot >= 0 ? (uint8) (slot / settings.cacheSize) : 0;
+	texel[2] = 0;
+	texel[3] = slot >= 0 ? 255 : 0;
+
+	if (indirectionDirty.w <= 0 || indirectionDirty.h <= 0)
+	{
+		indirectionDirty = {tx, ty, 1, 1};
+		return;
+	}
+
+	int x0 = std::min(indirectionDirty.x, tx);
+	int y0 = std::min(indirectionDirty.y, ty);
+	int x1 = std::max(indirectionDirty.x + indirectionDirty.w, tx + 1);
+	int y1 = std::max(indirectionDirty.y + indirectionDirty.h, ty + 1);
+	indirectionDirty = {x0, y0, x1 - x0, y1 - y0};
+}
+
+void VirtualTexture::flushIndirection()
+{
+	const Rect &r = indirectionDirty;
+	if (r.w <= 0 || r.h <= 0)
+		return;
+
+	uploadScratch.resize((size_t) r.w * r.h * 4);
+	for (int y = 0; y < r.h; y++)
+	{
+		const uint8 *src = indirection.data() + ((size_t) (r.y + y) * tilesX + r.x) * 4;
+		memcpy(uploadScratch.data() + (size_t) y * r.w * 4, src, (size_t) r.w * 4);
+	}
+
+	indirectionTexture->replacePixels(uploadScratch.data(), uploadScratch.size(), 0, 0, r, false);
+	indirectionDirty = {0, 0, 0, 0};
+}
+
+std::string VirtualTexture::getTilePath(uint64 key) const
+{
+	std::string path = settings.tilePath;
+	std::string x = std::to_string(key % (uint64) tilesX);
+	std::string y = std::to_string(key / (uint64) tilesX);
+
+	size_t pos = 0;
+	while ((pos = path.find("{x}", pos)) != std::string::npos)
+	{
+		path.replace(pos, 3, x);
+		pos += x.size();
+	}
+
+	pos = 0;
+	while ((pos = path.find("{y}", pos)) != std::string::npos)
+	{
+		path.replace(pos, 3, y);
+		pos += y.size();
+	}
+
+	return path;
+}
+
+void VirtualTexture::draw(Graphics *gfx, const Matrix4 &m)
+{
+	if (gfx->isRenderTargetActive(cacheTexture.get()))
+		throw love::Exception("Cannot render a VirtualTexture to itself.");
+
+	const Matrix4 &tm = gfx->getTransform();
+	bool is2D = tm.isAffine2DTransform();
+
+	Matrix4 t(tm, m);
+
+	int tx0 = 0;
+	int ty0 = 0;
+	int tx1 = tilesX - 1;
+	int ty1 = tilesY - 1;
+
+	// Only the tiles covering the render target are drawn and requested.
+	// Non-2D transforms request everything, up to the cache size.
+	if (is2D)
+	{
+		int w = gfx->getWidth();
+		int h = gfx->getHeight();
+
+		Graphics::RenderTarget rt = gfx->getRenderTargets().getFirstTarget();
+		if (rt.texture != nullptr)
+		{
+			w = rt.texture->getWidth(rt.mipmap);
+			h = rt.texture->getHeight(rt.mipmap);
+		}
+
+		Rect scissor;
+		if (gfx->getScissor(scissor))
+		{
+			w = std::min(w, scissor.x + scissor.w);
+			h = std::min(h, scissor.y + scissor.h);
+		}
+
+		Matrix4 inverse = t.inverse();
+
+		Vector2 screen[4] = {
+			Vector2(0.0f, 0.0f),
+			Vector2((float) w, 0.0f),
+			Vector2(0.0f, (float) h),
+			Vector2((float) w, (float) h),
+		};
+
+		Vector2 local[4];
+		inverse.transformXY(local, screen, 4);
+
+		float minx = local[0].x, maxx = local[0].x;
+		float miny = local[0].y, maxy = local[0].y;
+		for (int i = 1; i < 4; i++)
+		{
+			minx = std::min(minx, local[i].x);
+			maxx = std::max(maxx, local[i].x);
+			miny = std::min(miny, local[i].y);
+			maxy = std::max(maxy, local[i].y);
+		}
+
+		if (maxx < 0.0f || maxy < 0.0f || minx >= (float) width || miny >= (float) height)
+			return;
+
+		float ts = (float) settings.tileSize;
+		tx0 = std::max((int) (minx / ts), 0);
+		ty0 = std::max((int) (miny / ts), 0);
+		tx1 = std::min((int) (maxx / ts), tilesX - 1);
+		ty1 = std::min((int) (maxy / ts), tilesY - 1);
+	}
+
+	requestRegion(tx0 * settings.tileSize, ty0 * settings.tileSize, (tx1 - tx0 + 1) * settings.tileSize, (ty1 - ty0 + 1) * settings.tileSize);
+
+	Graphics::BatchedDrawCommand cmd;
+	cmd.formats[0] = getSinglePositionFormat(is2D);
+	cmd.formats[1] = CommonFormat::STf_RGBAub;
+	cmd.indexMode = TRIANGLEINDEX_QUADS;
+	cmd.texture = cacheTexture.get();
+
+	int ts = settings.tileSize;
+	float cachesize = (float) cacheTexture->getWidth();
+	Color32 c = toColor32(gfx->getColor());
+
+	auto drawTile = [&](int tx, int ty, int slot)
+	{
+		cmd.vertexCount = 4;
+		Graphics::BatchedVertexData data = gfx->requestBatchedDraw(cmd);
+
+		float x = (float) (tx * ts);
+		float y = (float) (ty * ts);
+		float w = (float) std::min(ts, width - tx * ts);
+		float h = (float) std::min(ts, height - ty * ts);
+
+		Vector2 positions[4] = {
+			Vector2(x, y),
+			Vector2(x, y + h),
+			Vector2(x + w, y),
+			Vector2(x + w, y + h),
+		};
+
+		if (is2D)
+			t.transformXY((Vector2 *) data.stream[0], positions, 4);
+		else
+			t.transformXY0((Vector3 *) data.stream[0], positions, 4);
+
+		float s0 = (float) ((slot % settings.cacheSize) * slotSize + 1) / cachesize;
+		float t0 = (float) ((slot / settings.cacheSize) * slotSize + 1) / cachesize;
+		float s1 = s0 + w / cachesize;
+		float t1 = t0 + h / cachesize;
+
+		STf_RGBAub *vertexdata = (STf_RGBAub *) data.stream[1];
+		vertexdata[0] = {s0, t0, c};
+		vertexdata[1] = {s0, t1, c};
+		vertexdata[2] = {s1, t0, c};
+		vertexdata[3] = {s1, t1, c};
+	};
+
+	// When more tiles are visible than the cache holds, it's cheaper to go
+	// through the resident tiles than through the visible ones.
+	if ((int64) (tx1 - tx0 + 1) * (ty1 - ty0 + 1) > (int64) slots.size())
+	{
+		for (int slot = 0; slot < (int) slots.size(); slot++)
+		{
+			int64 key = slots[slot];
+			if (key < 0)
+				continue;
+			int tx = (int) (key % tilesX);
+			int ty = (int) (key / tilesX);
+			if (tx >= tx0 && tx <= tx1 && ty >= ty0 && ty <= ty1)
+				drawTile(tx, ty, slot);
+		}
+		return;
+	}
+
+	for (int ty = ty0; ty <= ty1; ty++)
+	{
+		for (int tx = tx0; tx <= tx1; tx++)
+		{
+			auto it = tiles.find(getTileKey(tx, ty));
+			if (it != tiles.end() && it->second.status == TILE_RESIDENT)
+				drawTile(tx, ty, it->second.slot);
+		}
+	}
+}
+
+void VirtualTexture::update()
+{
+	auto imagemodule = Module::getInstance<love::image::Image>(Module::M_IMAGE);
+
+	int uploads = 0;
+	int inflight = 0;
+
+	for (auto it = tiles.begin(); it != tiles.end();)
+	{
+		uint64 key = it->first;
+		Tile &tile = it->second;
+
+		if (tile.status == TILE_READING && tile.request->isDone())
+		{
+			love::filesystem::FileData *filedata = tile.request->getData();
+
+			tile.status = TILE_FAILED;
+			if (filedata != nullptr && imagemodule != nullptr)
+			{
+				try
+				{
+					tile.decode.set(imagemodule->newImageDataAsync(filedata), Acquire::NORETAIN);
+					tile.status = TILE_DECODING;
+				}
+				catch (love::Exception &)
+				{
+				}
+			}
+
+			tile.request.set(nullptr);
+		}
+
+		if (tile.status == TILE_DECODING && tile.decode->isComplete())
+		{
+			tile.status = TILE_FAILED;
+
+			try
+			{
+				love::image::ImageData *data = tile.decode->getImageData();
+				int tx = (int) (key % (uint64) tilesX);
+				int ty = (int) (key / (uint64) tilesX);
+				int tilew = std::min(settings.tileSize, width - tx * settings.tileSize);
+				int tileh = std::min(settings.tileSize, height - ty * settings.tileSize);
+
+				if (data->getFormat() == settings.format && data->getWidth() == tilew && data->getHeight() == tileh)
+					tile.status = TILE_DECODED;
+			}
+			catch (love::Exception &)
+			{
+			}
+
+			if (tile.status == TILE_FAILED)
+				tile.decode.set(nullptr);
+		}
+
+		if (tile.status == TILE_DECODED && uploads < settings.uploadsPerFrame)
+		{
+			// Evicting other tiles doesn't invalidate this iterator.
+			int slot = acquireSlot();
+			if (slot >= 0)
+			{
+				uploadTile(key, tile, slot, tile.decode->getImageData());
+				tile.decode.set(nullptr);
+				uploads++;
+			}
+		}
+
+		// Missing and failed tiles are forgotten once they're no longer
+		// used, and aren't retried until they're requested again.
+		if (tile.status != TILE_RESIDENT && frame - tile.lastUsedFrame > STALE_FRAMES)
+		{
+			if (tile.request.get())
+				tile.request->cancel();
+			it = tiles.erase(it);
+			continue;
+		}
+
+		if (tile.status == TILE_READING || tile.status == TILE_DECODING || tile.status == TILE_DECODED)
+			inflight++;
+
+		++it;
+	}
+
+	auto fs = Module::getInstance<love::filesystem::Filesystem>(Module::M_FILESYSTEM);
+
+	if (!settings.tilePath.empty() && fs != nullptr && inflight < MAX_LOADS_IN_FLIGHT)
+	{
+		std::vector<std::pair<uint64, uint64>> wanted;
+		for (const auto &pair : tiles)
+		{
+			if (pair.second.status == TILE_WANTED)
+				wanted.emplace_back(pair.second.lastUsedFrame, pair.first);
+		}
+
+		// Most recently used first.
+		std::sort(wanted.begin(), wanted.end(), std::greater<std::pair<uint64, uint64>>());
+
+		for (size_t i = 0; i < wanted.size() && inflight < MAX_LOADS_IN_FLIGHT; i++, inflight++)
+		{
+			Tile &tile = tiles[wanted[i].second];
+
+			try
+			{
+				tile.request.set(fs->readAsync(getTilePath(wanted[i].second).c_str(), 0), Acquire::NORETAIN);
+				tile.status = TILE_READING;
+			}
+			catch (love::Exception &)
+			{
+				tile.status = TILE_FAILED;
+			}
+		}
+	}
+
+	flushIndirection();
+	frame++;
+}
+
+} // graphics
+} // love
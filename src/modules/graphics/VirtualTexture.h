@@ -0,0 +1,184 @@
+/**
+* Copyright (c) 2006-2024 LOVE Development Team
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+**/
+
+
+#pragma once
+
+// LOVE
+#include "common/config.h"
+#include "common/pixelformat.h"
+#include "Drawable.h"
+#include "Texture.h"
+#include "filesystem/FileRequest.h"
+#include "image/ImageData.h"
+#include "image/ImageDataLoad.h"
+
+// C++
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+namespace love
+{
+namespace graphics
+{
+
+class Graphics;
+
+/**
+ * A logical texture which can be much larger than the maximum texture size.
+ * It's split into square tiles, and only the tiles which have been drawn (or
+ * requested) recently are kept in a fixed-size physical cache texture, so
+ * memory use doesn't depend on the size of the virtual texture.
+ *
+ * Tiles are read from files named by the tile path pattern, where "{x}" and
+ * "{y}" are replaced with the tile's column and row. Reading and decoding
+ * happen on worker threads. Tiles can also be provided directly with setTile.
+ *
+ * Drawing a VirtualTexture draws the resident tiles in the visible part of
+ * it. Custom shaders can sample it through the indirection texture, which has
+ * one texel per tile: the cache slot's column and row (in units of 1/255) in
+ * red and green, and alpha set to 1 once the tile is resident. Each cache
+ * slot is (tilesize + 2) pixels wide, with a 1 pixel border around the tile.
+ **/
+class VirtualTexture : public Drawable
+{
+public:
+
+	static love::Type type;
+
+	struct Settings
+	{
+		int tileSize = 256;
+		// Width and height of the cache texture, in tiles.
+		int cacheSize = 8;
+		PixelFormat format = PIXELFORMAT_RGBA8_UNORM;
+		bool linear = false;
+		std::string tilePath;
+		// Maximum number of tiles copied into the cache texture per frame.
+		int uploadsPerFrame = 4;
+		std::string debugName;
+	};
+
+	VirtualTexture(Graphics *gfx, int width, int height, const Settings &settings);
+	virtual ~VirtualTexture();
+
+	int getWidth() const { return width; }
+	int getHeight() const { return height; }
+	int getTileSize() const { return settings.tileSize; }
+	int getTileCountX() const { return tilesX; }
+	int getTileCountY() const { return tilesY; }
+	int getCacheSize() const { return settings.cacheSize; }
+	int getResidentTileCount() const { return residentCount; }
+
+	Texture *getCacheTexture() const { return cacheTexture.get(); }
+	Texture *getIndirectionTexture() const { return indirectionTexture.get(); }
+
+	/**
+	 * Marks the tiles overlapping the given rectangle (in pixels of the
+	 * virtual texture) as needed, so they're streamed in if they aren't
+	 * resident and aren't evicted while they're still being used.
+	 **/
+	void requestRegion(int x, int y, int w, int h);
+
+	/**
+	 * Copies the ImageData into the cache as the given tile, replacing any
+	 * pending load of it. The ImageData must have the same size as the tile,
+	 * which is smaller than the tile size at the right and bottom edges.
+	 **/
+	void setTile(int tx, int ty, love::image::ImageData *data);
+
+	bool isTileResident(int tx, int ty) const;
+
+	/**
+	 * Gets the tiles which have been requested recently but aren't resident
+	 * yet, as pairs of column and row.
+	 **/
+	void getPendingTiles(std::vector<int> &tiles) const;
+
+	// Implements Drawable.
+	void draw(Graphics *gfx, const Matrix4 &m) override;
+
+	// Called by Graphics once per frame.
+	void update();
+
+private:
+
+	enum TileStatus
+	{
+		TILE_WANTED,
+		TILE_READING,
+		TILE_DECODING,
+		TILE_DECODED,
+		TILE_RESIDENT,
+		TILE_FAILED,
+	};
+
+	struct Tile
+	{
+		TileStatus status = TILE_WANTED;
+		int slot = -1;
+		uint64 lastUsedFrame = 0;
+		StrongRef<love::filesystem::FileRequest> request;
+		StrongRef<love::image::ImageDataLoad> decode;
+	};
+
+	// Tiles which haven't been used for this many frames lose their place in
+	// the load queue.
+	static const int STALE_FRAMES = 2;
+	static const int MAX_LOADS_IN_FLIGHT = 8;
+
+	uint64 getTileKey(int tx, int ty) const { return (uint64) ty * (uint64) tilesX + (uint64) tx; }
+	void touchTile(int tx, int ty);
+	int acquireSlot();
+	void uploadTile(uint64 key, Tile &tile, int slot, love::image::ImageData *data);
+	void setIndirection(uint64 key, int slot);
+	void flushIndirection();
+	std::string getTilePath(uint64 key) const;
+
+	Graphics *gfx;
+	Settings settings;
+
+	int width;
+	int height;
+	int tilesX;
+	int tilesY;
+	int slotSize;
+
+	StrongRef<Texture> cacheTexture;
+	StrongRef<Texture> indirectionTexture;
+
+	std::unordered_map<uint64, Tile> tiles;
+
+	// The tile key stored in each cache slot, or -1 if it's free.
+	std::vector<int64> slots;
+	int residentCount;
+
+	std::vector<uint8> indirection;
+	Rect indirectionDirty;
+
+	std::vector<uint8> uploadScratch;
+
+	uint64 frame;
+
+}; // VirtualTexture
+
+} // graphics
+} // love
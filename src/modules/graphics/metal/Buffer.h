@@ -21,9 +21,13 @@
 #pragma once
 
 #include "graphics/Buffer.h"
+#include "graphics/BufferSubAllocator.h"
 #include "Metal.h"
 #include "common/Range.h"
 
+// C++
+#include <vector>
+
 namespace love
 {
 namespace graphics
@@ -31,6 +35,30 @@ namespace graphics
 namespace metal
 {
 
+/**
+ * Shared MTLBuffers which small Buffers are placed in.
+ **/
+class BufferPageAllocator final : public BufferSubAllocator
+{
+public:
+
+	BufferPageAllocator(id<MTLDevice> device);
+	virtual ~BufferPageAllocator();
+
+	id<MTLBuffer> getPageBuffer(int page) const { return pageBuffers[page]; }
+
+protected:
+
+	bool createPage(int index, size_t size) override;
+	void destroyPage(int index) override;
+
+private:
+
+	id<MTLDevice> device;
+	std::vector<id<MTLBuffer>> pageBuffers;
+
+}; // BufferPageAllocator
+
 class Buffer final : public love::graphics::Buffer
 {
 public:
@@ -44,6 +72,7 @@ public:
 	void copyTo(love::graphics::Buffer *dest, size_t sourceoffset, size_t destoffset, size_t size) override;
 
 	ptrdiff_t getHandle() const override { return (ptrdiff_t) buffer; }
+	size_t getHandleOffset() const override { return subAllocation.offset; }
 	ptrdiff_t getTexelBufferHandle() const override { return (ptrdiff_t) texture; }
 
 private:
@@ -57,6 +86,10 @@ private:
 
 	Range mappedRange;
 
+	// Set when the buffer object is a page shared with other small buffers.
+	BufferPageAllocator *pageAllocator;
+	BufferSubAllocator::Allocation subAllocation;
+
 }; // Buffer
 
 } // metal
@@ -58,11 +58,47 @@ static MTLPixelFormat getMTLPixelFormat(DataFormat format)
 	}
 }
 
+BufferPageAllocator::BufferPageAllocator(id<MTLDevice> device)
+	: BufferSubAllocator(love::graphics::Buffer::SUBALLOCATION_PAGE_SIZE, love::graphics::Buffer::SUBALLOCATION_ALIGNMENT)
+	, device(device)
+{
+}
+
+BufferPageAllocator::~BufferPageAllocator()
+{ @autoreleasepool {
+	pageBuffers.clear();
+	device = nil;
+}}
+
+bool BufferPageAllocator::createPage(int index, size_t size)
+{ @autoreleasepool {
+	id<MTLBuffer> buffer = [device newBufferWithLength:size options:MTLResourceStorageModePrivate];
+	if (buffer == nil)
+		return false;
+
+	buffer.label = @"Shared buffer page";
+
+	if ((size_t) index >= pageBuffers.size())
+		pageBuffers.resize(index + 1, nil);
+
+	pageBuffers[index] = buffer;
+	return true;
+}}
+
+void BufferPageAllocator::destroyPage(int index)
+{ @autoreleasepool {
+	// Buffers placed in the page hold their own reference to it, and Metal
+	// keeps it alive while command buffers use it.
+	pageBuffers[index] = nil;
+}}
+
 Buffer::Buffer(love::graphics::Graphics *gfx, id<MTLDevice> device, const Settings &settings, const std::vector<DataDeclaration> &format, const void *data, size_t size, size_t arraylength)
 	: love::graphics::Buffer(gfx, settings, format, size, arraylength)
 	, texture(nil)
 	, mapBuffer(nil)
 	, mappedRange()
+	, pageAllocator(nullptr)
+	, subAllocation()
 { @autoreleasepool {
 	size = getSize();
 	arraylength = getArrayLength();
@@ -86,12 +122,24 @@ Buffer::Buffer(love::graphics::Graphics *gfx, id<MTLDevice> device, const Settin
 	else
 		opts |= MTLResourceStorageModePrivate;
 
-	buffer = [device newBufferWithLength:size options:opts];
+	if (isSubAllocatable(settings, size))
+	{
+		auto *mgfx = (Graphics *) gfx;
+		BufferPageAllocator *pages = mgfx->getBufferPageAllocator();
+		if (pages->allocate(size, subAllocation))
+		{
+			pageAllocator = pages;
+			buffer = pages->getPageBuffer(subAllocation.page);
+		}
+	}
+
+	if (buffer == nil)
+		buffer = [device newBufferWithLength:size options:opts];
 
 	if (buffer == nil)
 		throw love::Exception("Could not create buffer with %d bytes (out of VRAM?)", size);
 
-	if (!debugName.empty())
+	if (!debugName.empty() && pageAllocator == nullptr)
 		buffer.label = @(debugName.c_str());
 
 	if (usageFlags & BUFFERUSAGEFLAG_TEXEL)
@@ -129,12 +177,14 @@ Buffer::Buffer(love::graphics::Graphics *gfx, id<MTLDevice> device, const Settin
 #endif
 
 		if (clearsize > 0)
-			[encoder fillBuffer:buffer range:NSMakeRange(0, clearsize) value:0];
+			[encoder fillBuffer:buffer range:NSMakeRange(subAllocation.offset, clearsize) value:0];
 	}
 }}
 
 Buffer::~Buffer()
 { @autoreleasepool {
+	if (pageAllocator != nullptr)
+		pageAllocator->deallocate(subAllocation);
 	buffer = nil;
 	texture = nil;
 }}
@@ -160,7 +210,7 @@ void *Buffer::map(MapType map, size_t offset, size_t size)
 		mappedRange = r;
 		mapped = true;
 		mappedType = map;
-		return (char *) buffer.contents + offset;
+		return (char *) buffer.contents + subAllocation.offset + offset;
 	}
 
 	auto gfx = Graphics::getInstance();
@@ -202,7 +252,7 @@ void Buffer::unmap(size_t usedoffset, size_t usedsize)
 	[encoder copyFromBuffer:mapBuffer
 			   sourceOffset:(usedoffset - mappedRange.getOffset())
 				   toBuffer:buffer
-		  destinationOffset:usedoffset
+		  destinationOffset:subAllocation.offset + usedoffset
 					   size:usedsize];
 
 	mapBuffer = nil;
@@ -227,7 +277,7 @@ void Buffer::clearInternal(size_t offset, size_t size)
 	auto gfx = Graphics::getInstance();
 	auto encoder = gfx->useBlitEncoder();
 
-	[encoder fillBuffer:buffer range:NSMakeRange(offset, size) value:0];
+	[encoder fillBuffer:buffer range:NSMakeRange(subAllocation.offset + offset, size) value:0];
 }}
 
 void Buffer::copyTo(love::graphics::Buffer *dest, size_t sourceoffset, size_t destoffset, size_t size)
@@ -236,9 +286,9 @@ void Buffer::copyTo(love::graphics::Buffer *dest, size_t sourceoffset, size_t de
 	auto encoder = gfx->useBlitEncoder();
 
 	[encoder copyFromBuffer:buffer
-			   sourceOffset:sourceoffset
+			   sourceOffset:subAllocation.offset + sourceoffset
 				   toBuffer:((Buffer *) dest)->buffer
-		  destinationOffset:destoffset
+		  destinationOffset:dest->getHandleOffset() + destoffset
 					   size:size];
 }}
 
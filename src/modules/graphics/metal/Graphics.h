@@ -36,6 +36,8 @@ namespace graphics
 namespace metal
 {
 
+class BufferPageAllocator;
+
 class Graphics final : public love::graphics::Graphics
 {
 public:
@@ -111,6 +113,8 @@ public:
 	bool usesGLSLES() const override;
 	RendererInfo getRendererInfo() const override;
 
+	void updateOcclusionQueries() override;
+
 	void setShaderChanged();
 
 	id<MTLCommandBuffer> useCommandBuffer();
@@ -138,6 +142,8 @@ public:
 	StreamBuffer *getUniformBuffer() const { return uniformBuffer; }
 	Buffer *getDefaultAttributesBuffer() const { return defaultAttributesBuffer; }
 
+	BufferPageAllocator *getBufferPageAllocator();
+
 	int getClosestMSAASamples(int requestedsamples);
 
 	static Graphics *getInstance() { return graphicsInstance; }
@@ -202,10 +208,18 @@ private:
 
 	void setRenderTargetsInternal(const RenderTargets &rts, int pixelw, int pixelh, bool hasSRGBcanvas) override;
 	void initCapabilities() override;
-	void getAPIStats(int &shaderswitches) const override;
+	void getAPIStats(Stats &stats) const override;
+
+	void beginOcclusionQueryInternal(OcclusionQuery *query) override;
+	void endOcclusionQueryInternal(OcclusionQuery *query) override;
 
 	void processCompletedCommandBuffers();
 
+	id<MTLBuffer> getVisibilityResultBuffer();
+	void retireVisibilityResultBuffer();
+	void beginOcclusionQuerySegment();
+	void endOcclusionQuerySegment();
+
 	void endPass(bool presenting);
 
 	id<MTLDepthStencilState> getCachedDepthStencilState(const DepthState &depth, const StencilState &stencil);
@@ -237,18 +251,60 @@ private:
 
 	RenderEncoderBindings renderBindings;
 
+	// Shader resources last applied to the current render encoder.
+	struct AppliedShaderResources
+	{
+		uint32 shaderVersion;
+		uint32 texturesVersion;
+		love::graphics::Texture *mainTexture;
+	};
+
+	AppliedShaderResources appliedRenderResources;
+
 	StreamBuffer *uniformBuffer;
 	StreamBuffer::MapInfo uniformBufferData;
 	size_t uniformBufferOffset;
 	size_t uniformBufferGPUStart;
 
+	// Location of the most recent uniform data upload, so identical data can
+	// be reused.
+	size_t lastUniformDataOffset;
+	size_t lastUniformDataSize;
+
 	Buffer *defaultAttributesBuffer;
 
+	BufferPageAllocator *bufferPageAllocator;
+
 	std::map<uint64, void *> cachedSamplers;
 	std::unordered_map<uint64, void *> cachedDepthStencilStates;
 
 	std::vector<id<MTLCommandBuffer>> activeCommandBuffers;
 
+	struct OcclusionQuerySegment
+	{
+		StrongRef<OcclusionQuery> query;
+		uint32 generation;
+		id<MTLCommandBuffer> commandBuffer;
+	};
+
+	// Each render encoder writes occlusion results into one slot of the
+	// visibility result buffer it was created with. Buffers are retired at the
+	// end of each frame and read back once their command buffers complete.
+	struct VisibilityResultBuffer
+	{
+		id<MTLBuffer> buffer;
+		std::vector<OcclusionQuerySegment> segments;
+	};
+
+	static const size_t MAX_OCCLUSION_QUERY_SEGMENTS = 512;
+
+	VisibilityResultBuffer visibilityResults;
+	std::vector<VisibilityResultBuffer> pendingVisibilityResults;
+	std::vector<id<MTLBuffer>> freeVisibilityResultBuffers;
+	bool renderEncoderHasVisibilityResults;
+	bool occlusionQuerySegmentOpen;
+	MTLVisibilityResultMode visibilityResultMode;
+
 	DeviceFamilies families;
 
 	bool isVMDevice;
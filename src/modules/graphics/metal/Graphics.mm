@@ -26,8 +26,10 @@
 #include "Shader.h"
 #include "ShaderStage.h"
 #include "window/Window.h"
+#include "timer/Timer.h"
 #include "image/Image.h"
 #include "common/memory.h"
+#include "common/profiler.h"
 
 #import <QuartzCore/CAMetalLayer.h>
 
@@ -280,11 +282,19 @@ Graphics::Graphics()
 	, requestedBackbufferMSAA(0)
 	, attachmentStoreActions()
 	, renderBindings()
+	, appliedRenderResources()
 	, uniformBufferOffset(0)
 	, uniformBufferGPUStart(0)
+	, lastUniformDataOffset(0)
+	, lastUniformDataSize(0)
 	, defaultAttributesBuffer(nullptr)
+	, bufferPageAllocator(nullptr)
 	, families()
 	, isVMDevice(false)
+	, visibilityResults()
+	, renderEncoderHasVisibilityResults(false)
+	, occlusionQuerySegmentOpen(false)
+	, visibilityResultMode(MTLVisibilityResultModeBoolean)
 { @autoreleasepool {
 	if (@available(macOS 10.15, iOS 13.0, *))
 	{
@@ -364,6 +374,7 @@ Graphics::Graphics()
 	createFanIndexBuffer();
 
 	// We always need a default shader.
+	double shaderstart = timer::Timer::getTime();
 	for (int i = 0; i < Shader::STANDARD_MAX_ENUM; i++)
 	{
 		auto stype = (Shader::StandardShader) i;
@@ -376,6 +387,7 @@ Graphics::Graphics()
 			Shader::standardShaders[i] = newShader(stages, opts);
 		}
 	}
+	defaultShaderCompileTime += timer::Timer::getTime() - shaderstart;
 
 	// A shader should always be active, but the default shader shouldn't be
 	// returned by getShader(), so we don't do setShader(defaultShader).
@@ -414,8 +426,13 @@ Graphics::~Graphics()
 		[cmd waitUntilCompleted];
 	}
 
+	updateOcclusionQueries();
+	visibilityResults = {};
+	freeVisibilityResultBuffers.clear();
+
 	uniformBuffer->release();
 	defaultAttributesBuffer->release();
+	delete bufferPageAllocator;
 	passDesc = nil;
 	commandQueue = nil;
 	device = nil;
@@ -459,6 +476,13 @@ love::graphics::Buffer *Graphics::newBuffer(const Buffer::Settings &settings, co
 	return new Buffer(this, device, settings, format, data, size, arraylength);
 }
 
+BufferPageAllocator *Graphics::getBufferPageAllocator()
+{
+	if (bufferPageAllocator == nullptr)
+		bufferPageAllocator = new BufferPageAllocator(device);
+	return bufferPageAllocator;
+}
+
 love::graphics::GraphicsReadback *Graphics::newReadbackInternal(ReadbackMethod method, love::graphics::Buffer *buffer, size_t offset, size_t size, data::ByteData *dest, size_t destoffset)
 {
 	return new GraphicsReadback(this, method, buffer, offset, size, dest, destoffset);
@@ -471,8 +495,8 @@ love::graphics::GraphicsReadback *Graphics::newReadbackInternal(ReadbackMethod m
 
 void Graphics::backbufferChanged(int width, int height, int pixelwidth, int pixelheight, bool backbufferstencil, bool backbufferdepth, int msaa)
 {
-	bool sizechanged = width != this->width || height != this->height
-		|| pixelwidth != this->pixelWidth || pixelheight != this->pixelHeight;
+	// The backbuffer textures only depend on the size in pixels.
+	bool sizechanged = pixelwidth != this->pixelWidth || pixelheight != this->pixelHeight;
 
 	bool dschanged = backbufferstencil != this->backbufferHasStencil || backbufferdepth != this->backbufferHasDepth;
 	bool msaachanged = msaa != this->requestedBackbufferMSAA;
@@ -640,13 +664,33 @@ static inline void setAttachment(const Graphics::RenderTarget &rt, MTLRenderPass
 
 	desc.resolveTexture = nil;
 
-	if (rt.texture->getMSAA() > 1 && rt.texture->isReadable())
+	if (rt.storeAction == Graphics::STORE_ACTION_DISCARD)
+		storeaction = MTLStoreActionDontCare;
+	else if (rt.texture->getMSAA() > 1 && rt.texture->isReadable())
 	{
-		storeaction = MTLStoreActionStoreAndMultisampleResolve;
+		if (rt.storeAction == Graphics::STORE_ACTION_RESOLVE)
+			storeaction = MTLStoreActionMultisampleResolve;
+		else
+			storeaction = MTLStoreActionStoreAndMultisampleResolve;
 		desc.resolveTexture = getMTLTexture(rt.texture);
 	}
 }
 
+// Memoryless attachments have no contents outside of a render pass, so they
+// can't be loaded at the start of one or stored at the end.
+static inline MTLStoreAction getAttachmentStoreAction(MTLRenderPassAttachmentDescriptor *desc, MTLStoreAction action)
+{
+	if (Metal::isMemoryless(desc.texture))
+		return desc.resolveTexture != nil ? MTLStoreActionMultisampleResolve : MTLStoreActionDontCare;
+	return action;
+}
+
+static inline void fixMemorylessLoadAction(MTLRenderPassAttachmentDescriptor *desc)
+{
+	if (desc.loadAction == MTLLoadActionLoad && Metal::isMemoryless(desc.texture))
+		desc.loadAction = MTLLoadActionDontCare;
+}
+
 id<MTLRenderCommandEncoder> Graphics::useRenderEncoder()
 {
 	if (renderEncoder == nil)
@@ -700,15 +744,29 @@ id<MTLRenderCommandEncoder> Graphics::useRenderEncoder()
 			key.msaa = backbufferMSAA ? (uint8) backbufferMSAA->getMSAA() : 1;
 		}
 
+		for (int i = 0; i < MAX_COLOR_RENDER_TARGETS; i++)
+			fixMemorylessLoadAction(passDesc.colorAttachments[i]);
+		fixMemorylessLoadAction(passDesc.depthAttachment);
+		fixMemorylessLoadAction(passDesc.stencilAttachment);
+
+		// Only attach a visibility result buffer once occlusion queries are
+		// in use, so other programs don't pay for it.
+		passDesc.visibilityResultBuffer = activeOcclusionQuery.get() != nullptr ? getVisibilityResultBuffer() : visibilityResults.buffer;
+		renderEncoderHasVisibilityResults = passDesc.visibilityResultBuffer != nil;
+
 		renderEncoder = [useCommandBuffer() renderCommandEncoderWithDescriptor:passDesc];
 
 		renderBindings = {};
+		appliedRenderResources = {};
 
 		id<MTLBuffer> defaultbuffer = getMTLBuffer(defaultAttributesBuffer);
 		setBuffer(renderEncoder, renderBindings, SHADERSTAGE_VERTEX, DEFAULT_VERTEX_BUFFER_BINDING, defaultbuffer, 0);
 
 		dirtyRenderState = STATEBIT_ALL;
 		lastCullMode = CULL_MAX_ENUM;
+
+		if (activeOcclusionQuery.get() != nullptr)
+			beginOcclusionQuerySegment();
 	}
 
 	return renderEncoder;
@@ -727,20 +785,26 @@ void Graphics::submitRenderEncoder(SubmitType type)
 			[renderEncoder setColorStoreAction:(store ? MTLStoreActionStore : actions.color[0]) atIndex:0];
 
 		for (size_t i = 0; i < rts.colors.size(); i++)
-			[renderEncoder setColorStoreAction:(store ? MTLStoreActionStore : actions.color[i]) atIndex:i];
+		{
+			MTLStoreAction action = getAttachmentStoreAction(passDesc.colorAttachments[i], store ? MTLStoreActionStore : actions.color[i]);
+			[renderEncoder setColorStoreAction:action atIndex:i];
+		}
 
 		love::graphics::Texture *ds = rts.depthStencil.texture.get();
 		if (isbackbuffer)
 			ds = backbufferDepthStencil;
 
 		if ((rts.temporaryRTFlags & TEMPORARY_RT_DEPTH) != 0 || (ds != nullptr && isPixelFormatDepth(ds->getPixelFormat())))
-			[renderEncoder setDepthStoreAction:store ? MTLStoreActionStore : actions.depth];
+			[renderEncoder setDepthStoreAction:getAttachmentStoreAction(passDesc.depthAttachment, store ? MTLStoreActionStore : actions.depth)];
 
 		if ((rts.temporaryRTFlags & TEMPORARY_RT_STENCIL) != 0 || (ds != nullptr && isPixelFormatStencil(ds->getPixelFormat())))
-			[renderEncoder setStencilStoreAction:store ? MTLStoreActionStore : actions.stencil];
+			[renderEncoder setStencilStoreAction:getAttachmentStoreAction(passDesc.stencilAttachment, store ? MTLStoreActionStore : actions.stencil)];
+
+		endOcclusionQuerySegment();
 
 		[renderEncoder endEncoding];
 		renderEncoder = nil;
+		renderEncoderHasVisibilityResults = false;
 
 		// Reset actions to load. The next clear/discard/etc will set more
 		// appropriate actions if necessary.
@@ -1045,6 +1109,7 @@ bool Graphics::applyShaderUniforms(id<MTLComputeCommandEncoder> encoder, love::g
 		uniformBuffer->release();
 		uniformBuffer = CreateStreamBuffer(device, BUFFERUSAGE_UNIFORM, newsize);
 		uniformBufferData = {};
+		lastUniformDataSize = 0;
 		uniformBufferOffset = 0;
 	}
 
@@ -1119,6 +1184,8 @@ void Graphics::applyShaderUniforms(id<MTLRenderCommandEncoder> renderEncoder, lo
 
 	builtins->scaleParams.x = (float) getCurrentDPIScale();
 	builtins->scaleParams.y = getPointSize();
+	builtins->scaleParams.z = getLineWidth();
+	builtins->scaleParams.w = getLineStyle() == LINE_SMOOTH ? 1.0f : 0.0f;
 
 	uint32 flags = Shader::CLIP_TRANSFORM_Z_NEG1_1_TO_0_1;
 	builtins->clipSpaceParams = Shader::computeClipSpaceParams(flags);
@@ -1142,6 +1209,7 @@ void Graphics::applyShaderUniforms(id<MTLRenderCommandEncoder> renderEncoder, lo
 		uniformBuffer->release();
 		uniformBuffer = CreateStreamBuffer(device, BUFFERUSAGE_UNIFORM, newsize);
 		uniformBufferData = {};
+		lastUniformDataSize = 0;
 		uniformBufferOffset = 0;
 	}
 
@@ -1151,16 +1219,39 @@ void Graphics::applyShaderUniforms(id<MTLRenderCommandEncoder> renderEncoder, lo
 		uniformBufferGPUStart = uniformBuffer->getGPUReadOffset();
 	}
 
-	memcpy(uniformBufferData.data + uniformBufferOffset, bufferdata, size);
+	// Consecutive draws often have identical uniform data (for example the
+	// same transform and color), in which case the previous upload is reused
+	// and the encoder's buffer offsets don't need to change.
+	bool reuseuniforms = lastUniformDataSize == size
+		&& memcmp(uniformBufferData.data + lastUniformDataOffset, bufferdata, size) == 0;
+
+	if (!reuseuniforms)
+	{
+		memcpy(uniformBufferData.data + uniformBufferOffset, bufferdata, size);
+		lastUniformDataOffset = uniformBufferOffset;
+		lastUniformDataSize = size;
+		uniformBufferOffset += alignUp(size, alignment);
+	}
 
 	id<MTLBuffer> buffer = getMTLBuffer(uniformBuffer);
 	int uniformindex = Shader::getUniformBufferBinding();
 
 	auto &bindings = renderBindings;
-	setBuffer(renderEncoder, bindings, SHADERSTAGE_VERTEX, uniformindex, buffer, uniformBufferGPUStart + uniformBufferOffset);
-	setBuffer(renderEncoder, bindings, SHADERSTAGE_PIXEL, uniformindex, buffer, uniformBufferGPUStart + uniformBufferOffset);
+	setBuffer(renderEncoder, bindings, SHADERSTAGE_VERTEX, uniformindex, buffer, uniformBufferGPUStart + lastUniformDataOffset);
+	setBuffer(renderEncoder, bindings, SHADERSTAGE_PIXEL, uniformindex, buffer, uniformBufferGPUStart + lastUniformDataOffset);
 
-	uniformBufferOffset += alignUp(size, alignment);
+	// The encoder keeps its bindings until it ends, so there's nothing else to
+	// do if the same resources were applied to it last time.
+	auto &applied = appliedRenderResources;
+	if (applied.shaderVersion == s->getResourcesVersion() && applied.mainTexture == maintex
+		&& applied.texturesVersion == Texture::bindingsVersion)
+	{
+		return;
+	}
+
+	applied.shaderVersion = s->getResourcesVersion();
+	applied.mainTexture = maintex;
+	applied.texturesVersion = Texture::bindingsVersion;
 
 	for (const Shader::TextureBinding &b : s->getTextureBindings())
 	{
@@ -1215,7 +1306,7 @@ static void setVertexBuffers(id<MTLRenderCommandEncoder> encoder, love::graphics
 		{
 			auto b = buffers->info[i];
 			id<MTLBuffer> buffer = getMTLBuffer(b.buffer);
-			setBuffer(encoder, bindings, SHADERSTAGE_VERTEX, firstBinding + i, buffer, b.offset);
+			setBuffer(encoder, bindings, SHADERSTAGE_VERTEX, firstBinding + i, buffer, b.buffer->getHandleOffset() + b.offset);
 		}
 
 		i++;
@@ -1240,9 +1331,15 @@ void Graphics::draw(const DrawCommand &cmd)
 
 	if (cmd.indirectBuffer != nullptr)
 	{
-		[encoder drawPrimitives:getMTLPrimitiveType(cmd.primitiveType)
-				 indirectBuffer:getMTLBuffer(cmd.indirectBuffer)
-		   indirectBufferOffset:cmd.indirectBufferOffset];
+		// Metal has no multi-draw indirect call outside of indirect command
+		// buffers, so each draw is encoded separately.
+		const size_t stride = sizeof(uint32) * 4;
+		for (int i = 0; i < cmd.indirectDrawCount; i++)
+		{
+			[encoder drawPrimitives:getMTLPrimitiveType(cmd.primitiveType)
+					 indirectBuffer:getMTLBuffer(cmd.indirectBuffer)
+			   indirectBufferOffset:cmd.indirectBufferOffset + stride * i];
+		}
 	}
 	else
 	{
@@ -1274,12 +1371,16 @@ void Graphics::draw(const DrawIndexedCommand &cmd)
 
 	if (cmd.indirectBuffer != nullptr)
 	{
-		[encoder drawIndexedPrimitives:getMTLPrimitiveType(cmd.primitiveType)
-							 indexType:indexType
-						   indexBuffer:getMTLBuffer(cmd.indexBuffer)
-					 indexBufferOffset:cmd.indexBufferOffset
-						indirectBuffer:getMTLBuffer(cmd.indirectBuffer)
-				  indirectBufferOffset:cmd.indexBufferOffset];
+		const size_t stride = sizeof(uint32) * 5;
+		for (int i = 0; i < cmd.indirectDrawCount; i++)
+		{
+			[encoder drawIndexedPrimitives:getMTLPrimitiveType(cmd.primitiveType)
+								 indexType:indexType
+							   indexBuffer:getMTLBuffer(cmd.indexBuffer)
+						 indexBufferOffset:cmd.indexBuffer->getHandleOffset() + cmd.indexBufferOffset
+							indirectBuffer:getMTLBuffer(cmd.indirectBuffer)
+					  indirectBufferOffset:cmd.indirectBufferOffset + stride * i];
+		}
 	}
 	else
 	{
@@ -1287,7 +1388,7 @@ void Graphics::draw(const DrawIndexedCommand &cmd)
 							indexCount:cmd.indexCount
 							 indexType:indexType
 						   indexBuffer:getMTLBuffer(cmd.indexBuffer)
-					 indexBufferOffset:cmd.indexBufferOffset
+					 indexBufferOffset:cmd.indexBuffer->getHandleOffset() + cmd.indexBufferOffset
 						 instanceCount:cmd.instanceCount];
 	}
 
@@ -1634,6 +1735,8 @@ void Graphics::present(void *screenshotCallbackData)
 	if (!isActive())
 		return;
 
+	LOVE_PROFILE_ZONE("Graphics::present");
+
 	if (isRenderTargetActive())
 		throw love::Exception("present cannot be called while a render target is active.");
 
@@ -1677,6 +1780,7 @@ void Graphics::present(void *screenshotCallbackData)
 
 	uniformBuffer->nextFrame();
 	uniformBufferData = {};
+	lastUniformDataSize = 0;
 	uniformBufferOffset = 0;
 
 	id<MTLCommandBuffer> cmd = getCommandBuffer();
@@ -1686,6 +1790,8 @@ void Graphics::present(void *screenshotCallbackData)
 
 	submitCommandBuffer(SUBMIT_DONE);
 
+	retireVisibilityResultBuffer();
+
 	activeDrawable = nil;
 
 	if (!pendingScreenshotCallbacks.empty())
@@ -1737,7 +1843,11 @@ void Graphics::present(void *screenshotCallbackData)
 
 	auto window = Module::getInstance<love::window::Window>(M_WINDOW);
 	if (window != nullptr)
+	{
+		double presentstart = timer::Timer::getTime();
 		window->swapBuffers();
+		presentTime = timer::Timer::getTime() - presentstart;
+	}
 
 	// This is set to NO when there are pending screen captures.
 	metalLayer.framebufferOnly = YES;
@@ -1749,10 +1859,133 @@ void Graphics::present(void *screenshotCallbackData)
 	drawCallsBatched = 0;
 
 	updatePendingReadbacks();
+	updatePendingUploads();
+	updateStreamingTextures();
+	updateVirtualTextures();
 	updateTemporaryResources();
+	FrameArena::getInstance().reset();
+	updateOcclusionQueries();
 	processCompletedCommandBuffers();
 }}
 
+id<MTLBuffer> Graphics::getVisibilityResultBuffer()
+{
+	if (visibilityResults.buffer == nil)
+	{
+		if (!freeVisibilityResultBuffers.empty())
+		{
+			visibilityResults.buffer = freeVisibilityResultBuffers.back();
+			freeVisibilityResultBuffers.pop_back();
+		}
+		else
+		{
+			size_t size = MAX_OCCLUSION_QUERY_SEGMENTS * sizeof(uint64);
+			visibilityResults.buffer = [device newBufferWithLength:size options:MTLResourceStorageModeShared];
+		}
+
+		// Counting mode doesn't clear the slots it writes to.
+		if (visibilityResults.buffer != nil)
+			memset(visibilityResults.buffer.contents, 0, visibilityResults.buffer.length);
+	}
+
+	return visibilityResults.buffer;
+}
+
+void Graphics::retireVisibilityResultBuffer()
+{
+	if (visibilityResults.buffer == nil || visibilityResults.segments.empty())
+		return;
+
+	pendingVisibilityResults.push_back(visibilityResults);
+	visibilityResults = {};
+}
+
+void Graphics::beginOcclusionQuerySegment()
+{
+	OcclusionQuery *query = activeOcclusionQuery.get();
+	if (query == nullptr || renderEncoder == nil || occlusionQuerySegmentOpen)
+		return;
+
+	size_t slot = visibilityResults.segments.size();
+
+	if (!renderEncoderHasVisibilityResults || slot >= MAX_OCCLUSION_QUERY_SEGMENTS)
+	{
+		query->markConservative();
+		return;
+	}
+
+	OcclusionQuerySegment segment;
+	segment.query.set(query);
+	segment.generation = query->addSegment();
+	segment.commandBuffer = commandBuffer;
+	visibilityResults.segments.push_back(segment);
+
+	[renderEncoder setVisibilityResultMode:visibilityResultMode offset:slot * sizeof(uint64)];
+	occlusionQuerySegmentOpen = true;
+}
+
+void Graphics::endOcclusionQuerySegment()
+{
+	if (!occlusionQuerySegmentOpen || renderEncoder == nil)
+		return;
+
+	[renderEncoder setVisibilityResultMode:MTLVisibilityResultModeDisabled offset:0];
+	occlusionQuerySegmentOpen = false;
+}
+
+void Graphics::beginOcclusionQueryInternal(OcclusionQuery */*query*/)
+{ @autoreleasepool {
+	// The current encoder was created without a visibility result buffer, so
+	// end it. The next draw starts a new encoder which will have one.
+	if (renderEncoder != nil && !renderEncoderHasVisibilityResults)
+		submitRenderEncoder(SUBMIT_STORE);
+
+	beginOcclusionQuerySegment();
+}}
+
+void Graphics::endOcclusionQueryInternal(OcclusionQuery */*query*/)
+{ @autoreleasepool {
+	endOcclusionQuerySegment();
+}}
+
+void Graphics::updateOcclusionQueries()
+{ @autoreleasepool {
+	for (size_t i = 0; i < pendingVisibilityResults.size(); )
+	{
+		auto &results = pendingVisibilityResults[i];
+
+		bool completed = true;
+		for (const auto &segment : results.segments)
+		{
+			auto status = segment.commandBuffer.status;
+			if (status != MTLCommandBufferStatusCompleted && status != MTLCommandBufferStatusError)
+			{
+				completed = false;
+				break;
+			}
+		}
+
+		if (!completed)
+		{
+			i++;
+			continue;
+		}
+
+		const uint64 *data = (const uint64 *) results.buffer.contents;
+		for (size_t slot = 0; slot < results.segments.size(); slot++)
+		{
+			const auto &segment = results.segments[slot];
+			if (segment.commandBuffer.status == MTLCommandBufferStatusError)
+				segment.query->resolveSegment(segment.generation, 1);
+			else
+				segment.query->resolveSegment(segment.generation, data[slot]);
+		}
+
+		freeVisibilityResultBuffers.push_back(results.buffer);
+		pendingVisibilityResults.erase(pendingVisibilityResults.begin() + i);
+	}
+}}
+
 int Graphics::getRequestedBackbufferMSAA() const
 {
 	return requestedBackbufferMSAA;
@@ -2242,8 +2475,14 @@ void Graphics::initCapabilities()
 		capabilities.features[FEATURE_INDIRECT_DRAW] = true;
 	else
 		capabilities.features[FEATURE_INDIRECT_DRAW] = false;
+
+	capabilities.features[FEATURE_ASYNC_COMPUTE] = false;
 	
-	static_assert(FEATURE_MAX_ENUM == 13, "Graphics::initCapabilities must be updated when adding a new graphics feature!");
+	capabilities.features[FEATURE_OCCLUSION_QUERY] = true;
+	if (families.mac[1] || families.macCatalyst[1] || families.apple[3])
+		visibilityResultMode = MTLVisibilityResultModeCounting;
+	capabilities.features[FEATURE_BACKBUFFER_CAPTURE] = false;
+	static_assert(FEATURE_MAX_ENUM == 16, "Graphics::initCapabilities must be updated when adding a new graphics feature!");
 
 	// https://developer.apple.com/metal/Metal-Feature-Set-Tables.pdf
 	capabilities.limits[LIMIT_POINT_SIZE] = 511;
@@ -2289,9 +2528,9 @@ void Graphics::initCapabilities()
 		capabilities.textureTypes[i] = true;
 }
 
-void Graphics::getAPIStats(int &shaderswitches) const
+void Graphics::getAPIStats(Stats &stats) const
 {
-	shaderswitches = shaderSwitches;
+	stats.shaderSwitches = shaderSwitches;
 }
 
 } // metal
@@ -45,6 +45,10 @@ public:
 
 	static PixelFormatDesc convertPixelFormat(id<MTLDevice> device, PixelFormat format);
 
+	// Memoryless render targets are only supported by Apple GPUs.
+	static bool supportsMemoryless(id<MTLDevice> device);
+	static bool isMemoryless(id<MTLTexture> texture);
+
 }; // Metal
 
 } // metal
@@ -470,6 +470,20 @@ Metal::PixelFormatDesc Metal::convertPixelFormat(id<MTLDevice> device, PixelForm
 	return desc;
 }
 
+bool Metal::supportsMemoryless(id<MTLDevice> device)
+{
+	if (@available(macOS 11.0, iOS 13.0, *))
+		return [device supportsFamily:MTLGPUFamilyApple1];
+	return false;
+}
+
+bool Metal::isMemoryless(id<MTLTexture> texture)
+{
+	if (@available(macOS 11.0, iOS 10.0, *))
+		return texture != nil && texture.storageMode == MTLStorageModeMemoryless;
+	return false;
+}
+
 } // metal
 } // graphics
 } // love
@@ -33,6 +33,7 @@
 #include <unordered_map>
 #include <map>
 #include <string>
+#include <vector>
 
 namespace glslang
 {
@@ -109,6 +110,7 @@ public:
 	int getVertexAttributeIndex(const std::string &name) override;
 	const UniformInfo *getUniformInfo(BuiltinUniform builtin) const override;
 	void updateUniform(const UniformInfo *info, int count) override;
+	void updateUniforms(const UniformUpdate *updates, int count) override;
 	void sendTextures(const UniformInfo *info, love::graphics::Texture **textures, int count) override;
 	void sendBuffers(const UniformInfo *info, love::graphics::Buffer **buffers, int count) override;
 	ptrdiff_t getHandle() const override { return 0; }
@@ -123,6 +125,10 @@ public:
 	const std::vector<TextureBinding> &getTextureBindings() const { return textureBindings; }
 	const std::vector<BufferBinding> &getBufferBindings() const { return bufferBindings; }
 
+	// Unique across all shaders, and changes whenever this shader's textures
+	// or buffers change.
+	uint32 getResourcesVersion() const { return resourcesVersion; }
+
 	uint8 *getLocalUniformBufferData() { return localUniformBufferData; }
 	size_t getLocalUniformBufferSize() const { return localUniformBufferSize; }
 	size_t getBuiltinUniformDataOffset() const { return builtinUniformDataOffset; }
@@ -137,9 +143,26 @@ private:
 		}
 	};
 
+	typedef std::unordered_map<RenderPipelineKey, const void *, RenderPipelineHasher> RenderPipelineMap;
+
+	// Functions and pipelines created for one set of specialization constant
+	// values.
+	struct Specialization
+	{
+		id<MTLFunction> functions[SHADERSTAGE_MAX_ENUM];
+		RenderPipelineMap renderPipelines;
+		id<MTLComputePipelineState> computePipeline;
+	};
+
 	void buildLocalUniforms(const spirv_cross::CompilerMSL &msl, const spirv_cross::SPIRType &type, size_t baseoffset, const std::string &basename);
+	void copyUniformData(const UniformInfo *info, int count);
 	void compileFromGLSLang(id<MTLDevice> device, const glslang::TProgram &program);
+	void reflectSpecializationConstants(const spirv_cross::CompilerMSL &msl);
+	void createFunctions();
+	void createComputePipeline(id<MTLDevice> device);
+	void specializationConstantsChanged() override;
 
+	id<MTLLibrary> libraries[SHADERSTAGE_MAX_ENUM];
 	id<MTLFunction> functions[SHADERSTAGE_MAX_ENUM];
 
 	UniformInfo *builtinUniformInfo[BUILTIN_MAX_ENUM];
@@ -156,9 +179,17 @@ private:
 	std::vector<TextureBinding> textureBindings;
 	std::vector<BufferBinding> bufferBindings;
 
-	std::unordered_map<RenderPipelineKey, const void *, RenderPipelineHasher> cachedRenderPipelines;
+	uint32 resourcesVersion;
+	static uint32 resourcesVersionCounter;
+
+	RenderPipelineMap cachedRenderPipelines;
 	id<MTLComputePipelineState> computePipeline;
 
+	// The functions and pipelines above use the current specialization
+	// constant values, other sets which have been used are kept here.
+	std::vector<uint32> specializationData;
+	std::map<std::vector<uint32>, Specialization> inactiveSpecializations;
+
 }; // Metal
 
 } // metal
@@ -131,6 +131,8 @@ static inline id<MTLBuffer> getMTLBuffer(love::graphics::Buffer *buffer)
 	return buffer ? (__bridge id<MTLBuffer>)(void *) buffer->getHandle() : nil;
 }
 
+uint32 Shader::resourcesVersionCounter = 0;
+
 static EShLanguage getGLSLangStage(ShaderStageType stage)
 {
 	switch (stage)
@@ -145,6 +147,7 @@ static EShLanguage getGLSLangStage(ShaderStageType stage)
 
 Shader::Shader(id<MTLDevice> device, StrongRef<love::graphics::ShaderStage> stages[SHADERSTAGE_MAX_ENUM], const CompileOptions &options)
 	: love::graphics::Shader(stages, options)
+	, libraries()
 	, functions()
 	, builtinUniformInfo()
 	, localUniformStagingData(nullptr)
@@ -152,6 +155,7 @@ Shader::Shader(id<MTLDevice> device, StrongRef<love::graphics::ShaderStage> stag
 	, localUniformBufferSize(0)
 	, builtinUniformDataOffset(0)
 	, firstVertexBufferBinding(DEFAULT_VERTEX_BUFFER_BINDING + 1)
+	, resourcesVersion(++resourcesVersionCounter)
 { @autoreleasepool {
 	using namespace glslang;
 
@@ -191,6 +195,7 @@ Shader::Shader(id<MTLDevice> device, StrongRef<love::graphics::ShaderStage> stag
 		tshader->setEnvInputVulkanRulesRelaxed();
 		tshader->setGlobalUniformBinding(0);
 		tshader->setGlobalUniformSet(0);
+		tshader->setPreamble("#define LOVE_SPECIALIZATION_CONSTANTS 1\n");
 
 		const std::string &source = stages[i]->getSource();
 		const char *csrc = source.c_str();
@@ -249,6 +254,15 @@ Shader::Shader(id<MTLDevice> device, StrongRef<love::graphics::ShaderStage> stag
 
 	cleanup();
 
+	getSpecializationData(specializationData);
+	createFunctions();
+	createComputePipeline(device);
+}}
+
+void Shader::createComputePipeline(id<MTLDevice> device)
+{
+	computePipeline = nil;
+
 	if (functions[SHADERSTAGE_COMPUTE] != nil)
 	{
 		MTLComputePipelineDescriptor *desc = [MTLComputePipelineDescriptor new];
@@ -269,6 +283,151 @@ Shader::Shader(id<MTLDevice> device, StrongRef<love::graphics::ShaderStage> stag
 				throw love::Exception("Error creating compute shader pipeline.");
 		}
 	}
+}
+
+void Shader::reflectSpecializationConstants(const spirv_cross::CompilerMSL &msl)
+{
+	for (const auto &sc : msl.get_specialization_constants())
+	{
+		const std::string &name = msl.get_name(sc.id);
+		if (name.empty())
+			continue;
+
+		const auto &constant = msl.get_constant(sc.id);
+		const auto &type = msl.get_type(constant.constant_type);
+
+		SpecializationConstant c = {};
+		c.id = sc.constant_id;
+
+		switch (type.basetype)
+		{
+		case spirv_cross::SPIRType::Float:
+			c.baseType = DATA_BASETYPE_FLOAT;
+			c.value.f = constant.scalar_f32();
+			break;
+		case spirv_cross::SPIRType::Int:
+			c.baseType = DATA_BASETYPE_INT;
+			c.value.i = constant.scalar_i32();
+			break;
+		case spirv_cross::SPIRType::UInt:
+			c.baseType = DATA_BASETYPE_UINT;
+			c.value.u = constant.scalar();
+			break;
+		case spirv_cross::SPIRType::Boolean:
+			c.baseType = DATA_BASETYPE_BOOL;
+			c.value.u = constant.scalar() != 0 ? 1 : 0;
+			break;
+		default:
+			throw love::Exception("Shader specialization constant '%s' must be a float, int, uint, or bool.", name.c_str());
+		}
+
+		for (const auto &kvp : specializationConstants)
+		{
+			if (kvp.second.id == c.id && kvp.first != name)
+				throw love::Exception("Shader specialization constants '%s' and '%s' use the same id.", kvp.first.c_str(), name.c_str());
+		}
+
+		specializationConstants[name] = c;
+	}
+}
+
+void Shader::createFunctions()
+{
+	MTLFunctionConstantValues *values = nil;
+
+	// Constants which aren't set here use the value from the shader code.
+	if (!specializationConstants.empty())
+	{
+		values = [MTLFunctionConstantValues new];
+
+		for (const auto &kvp : specializationConstants)
+		{
+			const SpecializationConstant &c = kvp.second;
+			bool b = c.value.u != 0;
+
+			switch (c.baseType)
+			{
+			case DATA_BASETYPE_FLOAT:
+				[values setConstantValue:&c.value.f type:MTLDataTypeFloat atIndex:c.id];
+				break;
+			case DATA_BASETYPE_INT:
+				[values setConstantValue:&c.value.i type:MTLDataTypeInt atIndex:c.id];
+				break;
+			case DATA_BASETYPE_UINT:
+				[values setConstantValue:&c.value.u type:MTLDataTypeUInt atIndex:c.id];
+				break;
+			case DATA_BASETYPE_BOOL:
+				[values setConstantValue:&b type:MTLDataTypeBool atIndex:c.id];
+				break;
+			default:
+				break;
+			}
+		}
+	}
+
+	for (int i = 0; i < SHADERSTAGE_MAX_ENUM; i++)
+	{
+		id<MTLLibrary> library = libraries[i];
+		functions[i] = nil;
+
+		if (library == nil)
+			continue;
+
+		NSString *name = library.functionNames[0];
+
+		if (values != nil)
+		{
+			NSError *err = nil;
+			functions[i] = [library newFunctionWithName:name constantValues:values error:&err];
+			if (functions[i] == nil)
+			{
+				NSString *errorstr = err != nil ? err.localizedDescription : @"unknown error";
+				throw love::Exception("Error specializing Metal shader function: %s", errorstr.UTF8String);
+			}
+		}
+		else
+			functions[i] = [library newFunctionWithName:name];
+
+		std::string debugname = getShaderStageDebugName((ShaderStageType) i);
+		if (!debugname.empty())
+			functions[i].label = @(debugname.c_str());
+	}
+}
+
+void Shader::specializationConstantsChanged()
+{ @autoreleasepool {
+	std::vector<uint32> newdata;
+	getSpecializationData(newdata);
+
+	Specialization &old = inactiveSpecializations[specializationData];
+	for (int i = 0; i < SHADERSTAGE_MAX_ENUM; i++)
+		old.functions[i] = functions[i];
+	old.renderPipelines = std::move(cachedRenderPipelines);
+	old.computePipeline = computePipeline;
+
+	cachedRenderPipelines.clear();
+	specializationData = newdata;
+
+	auto it = inactiveSpecializations.find(specializationData);
+	if (it != inactiveSpecializations.end())
+	{
+		for (int i = 0; i < SHADERSTAGE_MAX_ENUM; i++)
+			functions[i] = it->second.functions[i];
+		cachedRenderPipelines = std::move(it->second.renderPipelines);
+		computePipeline = it->second.computePipeline;
+		inactiveSpecializations.erase(it);
+	}
+	else
+	{
+		// The converted Metal code doesn't change, only the functions and
+		// pipelines created from it.
+		createFunctions();
+		createComputePipeline(Graphics::getInstance()->device);
+	}
+
+	// The render pipeline state is only re-fetched when the shader changes.
+	if (current == this)
+		Graphics::getInstance()->setShaderChanged();
 }}
 
 void Shader::buildLocalUniforms(const spirv_cross::CompilerMSL &msl, const spirv_cross::SPIRType &type, size_t baseoffset, const std::string &basename)
@@ -509,6 +668,8 @@ void Shader::compileFromGLSLang(id<MTLDevice> device, const glslang::TProgram &p
 
 		msl.set_msl_options(options);
 
+		reflectSpecializationConstants(msl);
+
 		std::string source = msl.compile();
 //		printf("// MSL SOURCE for stage %d:\n\n%s\n\n", stageindex, source.c_str());
 
@@ -531,11 +692,7 @@ void Shader::compileFromGLSLang(id<MTLDevice> device, const glslang::TProgram &p
 			throw love::Exception("Error compiling converted Metal shader code:\n\n%s", errorstr.UTF8String);
 		}
 
-		functions[stageindex] = [library newFunctionWithName:library.functionNames[0]];
-
-		std::string debugname = getShaderStageDebugName((ShaderStageType)stageindex);
-		if (!debugname.empty())
-			functions[stageindex].label = @(debugname.c_str());
+		libraries[stageindex] = library;
 
 		auto setTextureBinding = [this](CompilerMSL &msl, int stageindex, const spirv_cross::Resource &resource) -> void
 		{
@@ -672,13 +829,24 @@ void Shader::compileFromGLSLang(id<MTLDevice> device, const glslang::TProgram &p
 Shader::~Shader()
 { @autoreleasepool {
 	for (int i = 0; i < SHADERSTAGE_MAX_ENUM; i++)
+	{
 		functions[i] = nil;
+		libraries[i] = nil;
+	}
 
 	for (const auto &kvp : cachedRenderPipelines)
 		CFBridgingRelease(kvp.second);
 
 	cachedRenderPipelines.clear();
 
+	for (const auto &specialization : inactiveSpecializations)
+	{
+		for (const auto &kvp : specialization.second.renderPipelines)
+			CFBridgingRelease(kvp.second);
+	}
+
+	inactiveSpecializations.clear();
+
 	delete[] localUniformStagingData;
 	delete[] localUniformBufferData;
 }}
@@ -713,6 +881,23 @@ void Shader::updateUniform(const UniformInfo *info, int count)
 	if (current == this)
 		Graphics::flushBatchedDrawsGlobal();
 
+	copyUniformData(info, count);
+}
+
+void Shader::updateUniforms(const UniformUpdate *updates, int count)
+{
+	if (current == this)
+		Graphics::flushBatchedDrawsGlobal();
+
+	for (int i = 0; i < count; i++)
+		copyUniformData(updates[i].first, updates[i].second);
+}
+
+void Shader::copyUniformData(const UniformInfo *info, int count)
+{
+	if (info->dataSize == 0)
+		return;
+
 	count = std::min(count, info->count);
 
 	size_t offset = (const uint8 *)info->data - localUniformStagingData;
@@ -775,6 +960,8 @@ void Shader::sendTextures(const UniformInfo *info, love::graphics::Texture **tex
 			binding.samplerTexture = tex;
 		}
 	}
+
+	resourcesVersion = ++resourcesVersionCounter;
 }}
 
 void Shader::sendBuffers(const UniformInfo *info, love::graphics::Buffer **buffers, int count)
@@ -835,6 +1022,8 @@ void Shader::sendBuffers(const UniformInfo *info, love::graphics::Buffer **buffe
 				binding.buffer = getMTLBuffer(buffer);
 		}
 	}
+
+	resourcesVersion = ++resourcesVersionCounter;
 }
 
 void Shader::setVideoTextures(love::graphics::Texture *ytexture, love::graphics::Texture *cbtexture, love::graphics::Texture *crtexture)
@@ -77,7 +77,11 @@ public:
 		// Make sure this frame's section of the buffer is done being used.
 		if (!mappedFrames[frameIndex])
 		{
-			dispatch_semaphore_wait(frameSemaphores[frameIndex], DISPATCH_TIME_FOREVER);
+			if (dispatch_semaphore_wait(frameSemaphores[frameIndex], DISPATCH_TIME_NOW) != 0)
+			{
+				frameStallCount++;
+				dispatch_semaphore_wait(frameSemaphores[frameIndex], DISPATCH_TIME_FOREVER);
+			}
 			mappedFrames[frameIndex] = true;
 		}
 
@@ -114,6 +118,12 @@ public:
 		mappedFrames[frameIndex] = false;
 		frameIndex = (frameIndex + 1) % BUFFER_FRAMES;
 		frameGPUReadOffset = 0;
+		frameStallCount = 0;
+	}
+
+	size_t getMemorySize() const override
+	{
+		return bufferSize * BUFFER_FRAMES;
 	}
 
 	void markUsed(size_t usedsize) override
@@ -54,6 +54,9 @@ public:
 
 	id<MTLSamplerState> getMTLSampler() const { return sampler; }
 
+	// Changes whenever any texture's sampler changes or a texture is destroyed.
+	static uint32 bindingsVersion;
+
 private:
 
 	void uploadByteData(const void *data, size_t size, int level, int slice, const Rect &r) override;
@@ -28,6 +28,8 @@ namespace graphics
 namespace metal
 {
 
+uint32 Texture::bindingsVersion = 0;
+
 static MTLTextureType getMTLTextureType(TextureType type, int msaa)
 {
 	switch (type)
@@ -70,6 +72,13 @@ Texture::Texture(love::graphics::Graphics *gfxbase, id<MTLDevice> device, const
 
 	desc.storageMode = MTLStorageModePrivate;
 
+	bool usememoryless = memoryless && Metal::supportsMemoryless(device);
+	if (usememoryless && getRequestedMSAA() <= 1)
+	{
+		if (@available(macOS 11.0, iOS 10.0, *))
+			desc.storageMode = MTLStorageModeMemoryless;
+	}
+
 	if (readable)
 		desc.usage |= MTLTextureUsageShaderRead;
 	if (renderTarget)
@@ -102,6 +111,12 @@ Texture::Texture(love::graphics::Graphics *gfxbase, id<MTLDevice> device, const
 		desc.textureType = getMTLTextureType(texType, actualMSAASamples);
 		desc.usage &= ~MTLTextureUsageShaderRead;
 
+		if (usememoryless)
+		{
+			if (@available(macOS 11.0, iOS 10.0, *))
+				desc.storageMode = MTLStorageModeMemoryless;
+		}
+
 		msaaTexture = [device newTextureWithDescriptor:desc];
 		if (msaaTexture == nil)
 		{
@@ -131,8 +146,11 @@ Texture::Texture(love::graphics::Graphics *gfxbase, id<MTLDevice> device, const
 	std::vector<uint8> emptydata;
 	MTLRenderPassDescriptor *passdesc = nil;
 
+	// Memoryless textures have no contents to initialize outside of a pass.
+	bool initialize = !Metal::isMemoryless(texture);
+
 	// Initialize texture.
-	for (int mip = 0; mip < mipcount; mip++)
+	for (int mip = 0; initialize && mip < mipcount; mip++)
 	{
 		for (int slice = 0; slice < getSliceCount(mip); slice++)
 		{
@@ -178,7 +196,9 @@ Texture::Texture(love::graphics::Graphics *gfxbase, id<MTLDevice> device, const
 					{
 						attachment.texture = msaaTexture;
 						attachment.resolveTexture = texture;
-						attachment.storeAction = MTLStoreActionStoreAndMultisampleResolve;
+						attachment.storeAction = Metal::isMemoryless(msaaTexture)
+							? MTLStoreActionMultisampleResolve
+							: MTLStoreActionStoreAndMultisampleResolve;
 					}
 				};
 
@@ -256,6 +276,7 @@ Texture::Texture(love::graphics::Graphics *gfx, id<MTLDevice> device, love::grap
 
 Texture::~Texture()
 { @autoreleasepool {
+	bindingsVersion++;
 	texture = nil;
 	msaaTexture = nil;
 	sampler = nil;
@@ -337,7 +358,7 @@ void Texture::copyFromBuffer(love::graphics::Buffer *source, size_t sourceoffset
 		options = MTLBlitOptionDepthFromDepthStencil;
 
 	[encoder copyFromBuffer:buffer
-			   sourceOffset:sourceoffset
+			   sourceOffset:source->getHandleOffset() + sourceoffset
 		  sourceBytesPerRow:rowSize
 		sourceBytesPerImage:size
 				 sourceSize:MTLSizeMake(rect.w, rect.h, 1)
@@ -371,7 +392,7 @@ void Texture::copyToBuffer(love::graphics::Buffer *dest, int slice, int mipmap,
 				sourceOrigin:MTLOriginMake(rect.x, rect.y, z)
 				  sourceSize:MTLSizeMake(rect.w, rect.h, 1)
 					toBuffer:buffer
-		   destinationOffset:destoffset
+		   destinationOffset:dest->getHandleOffset() + destoffset
 	  destinationBytesPerRow:rowSize
 	destinationBytesPerImage:size
 					 options:options];
@@ -384,6 +405,7 @@ void Texture::setSamplerState(const SamplerState &s)
 
 	samplerState = validateSamplerState(s);
 	sampler = Graphics::getInstance()->getCachedSampler(samplerState);
+	bindingsVersion++;
 }}
 
 } // metal
@@ -66,6 +66,51 @@ static GLenum getGLFormat(DataFormat format)
 	}
 }
 
+BufferPageAllocator::BufferPageAllocator(BufferUsage usage, BufferDataUsage datausage)
+	: BufferSubAllocator(love::graphics::Buffer::SUBALLOCATION_PAGE_SIZE, love::graphics::Buffer::SUBALLOCATION_ALIGNMENT)
+	, usage(usage)
+	, dataUsage(datausage)
+{
+}
+
+BufferPageAllocator::~BufferPageAllocator()
+{
+	for (GLuint buffer : pageBuffers)
+	{
+		if (buffer != 0)
+			gl.deleteBuffer(buffer);
+	}
+}
+
+bool BufferPageAllocator::createPage(int index, size_t size)
+{
+	while (glGetError() != GL_NO_ERROR)
+		/* Clear the error buffer. */;
+
+	GLuint buffer = 0;
+	glGenBuffers(1, &buffer);
+	gl.bindBuffer(usage, buffer);
+	glBufferData(OpenGL::getGLBufferType(usage), (GLsizeiptr) size, nullptr, OpenGL::getGLBufferDataUsage(dataUsage));
+
+	if (glGetError() != GL_NO_ERROR)
+	{
+		gl.deleteBuffer(buffer);
+		return false;
+	}
+
+	if ((size_t) index >= pageBuffers.size())
+		pageBuffers.resize(index + 1, 0);
+
+	pageBuffers[index] = buffer;
+	return true;
+}
+
+void BufferPageAllocator::destroyPage(int index)
+{
+	gl.deleteBuffer(pageBuffers[index]);
+	pageBuffers[index] = 0;
+}
+
 Buffer::Buffer(love::graphics::Graphics *gfx, const Settings &settings, const std::vector<DataDeclaration> &format, const void *data, size_t size, size_t arraylength)
 	: love::graphics::Buffer(gfx, settings, format, size, arraylength)
 {
@@ -88,6 +133,9 @@ Buffer::Buffer(love::graphics::Graphics *gfx, const Settings &settings, const st
 	if (dataUsage == BUFFERDATAUSAGE_STREAM)
 		ownsMemoryMap = true;
 
+	if (isSubAllocatable(settings, size))
+		pageAllocator = ((Graphics *) gfx)->getBufferPageAllocator(mapUsage, dataUsage);
+
 	std::vector<uint8> emptydata;
 	if (settings.zeroInitialize && data == nullptr && !GLAD_VERSION_4_3)
 	{
@@ -111,7 +159,10 @@ Buffer::Buffer(love::graphics::Graphics *gfx, const Settings &settings, const st
 	if (settings.zeroInitialize && data == nullptr && GLAD_VERSION_4_3)
 	{
 		gl.bindBuffer(mapUsage, buffer);
-		glClearBufferData(target, GL_R8UI, GL_RED, GL_UNSIGNED_BYTE, nullptr);
+		if (subAllocation.isValid())
+			glClearBufferSubData(target, GL_R8UI, subAllocation.offset, getSize(), GL_RED, GL_UNSIGNED_BYTE, nullptr);
+		else
+			glClearBufferData(target, GL_R8UI, GL_RED, GL_UNSIGNED_BYTE, nullptr);
 	}
 }
 
@@ -132,8 +183,13 @@ bool Buffer::loadVolatile()
 
 void Buffer::unloadVolatile()
 {
+	// The upload thread could still be using the buffer object.
+	waitForPendingUpload();
+
 	mapped = false;
-	if (buffer != 0)
+	if (subAllocation.isValid())
+		pageAllocator->deallocate(subAllocation);
+	else if (buffer != 0)
 		gl.deleteBuffer(buffer);
 	buffer = 0;
 	if (texture != 0)
@@ -146,6 +202,17 @@ bool Buffer::load(const void *initialdata)
 	while (glGetError() != GL_NO_ERROR)
 		/* Clear the error buffer. */;
 
+	if (pageAllocator != nullptr && pageAllocator->allocate(getSize(), subAllocation))
+	{
+		buffer = pageAllocator->getPageBuffer(subAllocation.page);
+		gl.bindBuffer(mapUsage, buffer);
+
+		if (initialdata != nullptr)
+			glBufferSubData(target, (GLintptr) subAllocation.offset, (GLsizeiptr) getSize(), initialdata);
+
+		return (glGetError() == GL_NO_ERROR);
+	}
+
 	glGenBuffers(1, &buffer);
 	gl.bindBuffer(mapUsage, buffer);
 
@@ -172,6 +239,10 @@ bool Buffer::load(const void *initialdata)
 
 bool Buffer::supportsOrphan() const
 {
+	// Orphaning a shared page would discard the other buffers in it.
+	if (subAllocation.isValid())
+		return false;
+
 	return dataUsage == BUFFERDATAUSAGE_STREAM || dataUsage == BUFFERDATAUSAGE_DYNAMIC;
 }
 
@@ -180,6 +251,8 @@ void *Buffer::map(MapType map, size_t offset, size_t size)
 	if (size == 0)
 		return nullptr;
 
+	waitForPendingUpload();
+
 	if (map == MAP_WRITE_INVALIDATE && (isImmutable() || dataUsage == BUFFERDATAUSAGE_READBACK))
 		return nullptr;
 
@@ -264,6 +337,8 @@ bool Buffer::fill(size_t offset, size_t size, const void *data)
 	if (size == 0 || isImmutable() || dataUsage == BUFFERDATAUSAGE_READBACK)
 		return false;
 
+	waitForPendingUpload();
+
 	size_t buffersize = getSize();
 
 	if (!Range(0, buffersize).contains(Range(offset, size)))
@@ -289,7 +364,7 @@ bool Buffer::fill(size_t offset, size_t size, const void *data)
 	}
 	else
 	{
-		glBufferSubData(target, (GLintptr) offset, (GLsizeiptr) size, data);
+		glBufferSubData(target, (GLintptr) (subAllocation.offset + offset), (GLsizeiptr) size, data);
 	}
 
 	return true;
@@ -297,10 +372,12 @@ bool Buffer::fill(size_t offset, size_t size, const void *data)
 
 void Buffer::clearInternal(size_t offset, size_t size)
 {
+	waitForPendingUpload();
+
 	if (GLAD_VERSION_4_3)
 	{
 		gl.bindBuffer(mapUsage, buffer);
-		glClearBufferSubData(target, GL_R8UI, offset, size, GL_RED, GL_UNSIGNED_BYTE, nullptr);
+		glClearBufferSubData(target, GL_R8UI, subAllocation.offset + offset, size, GL_RED, GL_UNSIGNED_BYTE, nullptr);
 	}
 	else
 	{
@@ -318,10 +395,16 @@ void Buffer::clearInternal(size_t offset, size_t size)
 
 void Buffer::copyTo(love::graphics::Buffer *dest, size_t sourceoffset, size_t destoffset, size_t size)
 {
+	waitForPendingUpload();
+	((Buffer *) dest)->waitForPendingUpload();
+
 	// TODO: tracked state for these bind types?
 	glBindBuffer(GL_COPY_READ_BUFFER, buffer);
 	glBindBuffer(GL_COPY_WRITE_BUFFER, ((Buffer *) dest)->buffer);
 
+	sourceoffset += getHandleOffset();
+	destoffset += dest->getHandleOffset();
+
 	glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, sourceoffset, destoffset, size);
 }
 
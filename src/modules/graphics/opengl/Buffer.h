@@ -24,10 +24,12 @@
 #include "common/config.h"
 #include "common/Range.h"
 #include "graphics/Buffer.h"
+#include "graphics/BufferSubAllocator.h"
 #include "graphics/Volatile.h"
 
 // OpenGL
 #include "OpenGL.h"
+#include "UploadThread.h"
 
 namespace love
 {
@@ -39,6 +41,32 @@ class Graphics;
 namespace opengl
 {
 
+/**
+ * Shared GL buffer objects which small Buffers are placed in.
+ **/
+class BufferPageAllocator final : public BufferSubAllocator
+{
+public:
+
+	BufferPageAllocator(BufferUsage usage, BufferDataUsage datausage);
+	virtual ~BufferPageAllocator();
+
+	GLuint getPageBuffer(int page) const { return pageBuffers[page]; }
+
+protected:
+
+	bool createPage(int index, size_t size) override;
+	void destroyPage(int index) override;
+
+private:
+
+	BufferUsage usage;
+	BufferDataUsage dataUsage;
+
+	std::vector<GLuint> pageBuffers;
+
+}; // BufferPageAllocator
+
 class Buffer final : public love::graphics::Buffer, public Volatile
 {
 public:
@@ -55,11 +83,22 @@ public:
 	bool fill(size_t offset, size_t size, const void *data) override;
 	void copyTo(love::graphics::Buffer *dest, size_t sourceoffset, size_t destoffset, size_t size) override;
 
-	ptrdiff_t getHandle() const override { return buffer; };
-	ptrdiff_t getTexelBufferHandle() const override { return texture; };
+	ptrdiff_t getHandle() const override { waitForPendingUpload(); return buffer; };
+	size_t getHandleOffset() const override { return subAllocation.offset; }
+	ptrdiff_t getTexelBufferHandle() const override { waitForPendingUpload(); return texture; };
 
 	BufferUsage getMapUsage() const { return mapUsage; }
 
+	// Don't wait for a pending upload, unlike the handle getters above.
+	GLuint getGLBuffer() const { return buffer; }
+	GLuint getGLTexelBuffer() const { return texture; }
+
+	/**
+	 * Makes uses of the buffer on the main thread wait for the upload to be
+	 * complete first.
+	 **/
+	void setPendingUpload(UploadJob *job) { pendingUpload.set(job); }
+
 private:
 
 	bool load(const void *initialdata);
@@ -67,6 +106,15 @@ private:
 
 	void clearInternal(size_t offset, size_t size) override;
 
+	void waitForPendingUpload() const
+	{
+		if (pendingUpload.get() != nullptr)
+		{
+			pendingUpload->wait();
+			pendingUpload.set(nullptr);
+		}
+	}
+
 	BufferUsage mapUsage = BUFFERUSAGE_VERTEX;
 	GLenum target = 0;
 
@@ -76,12 +124,18 @@ private:
 	// Used for Texel Buffer types.
 	GLuint texture = 0;
 
+	// Set when the buffer object is a page shared with other small buffers.
+	BufferPageAllocator *pageAllocator = nullptr;
+	BufferSubAllocator::Allocation subAllocation;
+
 	// A pointer to mapped memory.
 	char *memoryMap = nullptr;
 	bool ownsMemoryMap = false;
 
 	Range mappedRange;
 
+	mutable StrongRef<UploadJob> pendingUpload;
+
 }; // Buffer
 
 } // opengl
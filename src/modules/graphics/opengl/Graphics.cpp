@@ -22,6 +22,8 @@
 #include "common/config.h"
 #include "common/math.h"
 #include "common/Vector.h"
+#include "common/profiler.h"
+#include "common/memory.h"
 
 #include "Graphics.h"
 #include "font/Font.h"
@@ -29,6 +31,7 @@
 #include "GraphicsReadback.h"
 #include "math/MathModule.h"
 #include "window/Window.h"
+#include "timer/Timer.h"
 #include "Buffer.h"
 #include "ShaderStage.h"
 
@@ -107,13 +110,20 @@ love::graphics::Graphics *createInstance()
 
 Graphics::Graphics()
 	: love::graphics::Graphics("love.graphics.opengl")
+	, framebufferUseCounter(0)
+	, framebufferCacheHits(0)
+	, framebufferCacheMisses(0)
 	, windowHasStencil(false)
 	, mainVAO(0)
+	, uploadThread(nullptr)
+	, uploadThreadFailed(false)
 	, internalBackbufferFBO(0)
 	, requestedBackbufferMSAA(0)
 	, bufferMapMemory(nullptr)
 	, bufferMapMemorySize(2 * 1024 * 1024)
+	, bufferPageAllocators()
 	, pixelFormatUsage()
+	, gpuTimerFrameIndex(0)
 {
 	gl = OpenGL();
 
@@ -145,7 +155,15 @@ Graphics::Graphics()
 
 Graphics::~Graphics()
 {
+	stopUploadThread();
+
 	delete[] bufferMapMemory;
+
+	for (auto &allocators : bufferPageAllocators)
+	{
+		for (BufferPageAllocator *allocator : allocators)
+			delete allocator;
+	}
 }
 
 love::graphics::StreamBuffer *Graphics::newStreamBuffer(BufferUsage type, size_t size)
@@ -178,6 +196,132 @@ love::graphics::Buffer *Graphics::newBuffer(const Buffer::Settings &settings, co
 	return new Buffer(this, settings, format, data, size, arraylength);
 }
 
+UploadThread *Graphics::getUploadThread()
+{
+	if (uploadThread != nullptr || uploadThreadFailed)
+		return uploadThread;
+
+	// Only try once per context.
+	uploadThreadFailed = true;
+
+	// Needs fences and GL_COPY_WRITE_BUFFER.
+	if (!(GLAD_VERSION_3_2 || GLAD_ES_VERSION_3_0))
+		return nullptr;
+
+	auto window = getInstance<love::window::Window>(M_WINDOW);
+	if (window == nullptr)
+		return nullptr;
+
+	void *context = window->createSharedGLContext();
+	if (context == nullptr)
+		return nullptr;
+
+	UploadThread *thread = new UploadThread(window, context);
+	if (!thread->start())
+	{
+		thread->release();
+		window->destroySharedGLContext(context);
+		return nullptr;
+	}
+
+	// Uploads go through the staged path instead if the context can't be
+	// used on another thread.
+	if (!thread->waitForContext())
+	{
+		thread->stop();
+		thread->release();
+		return nullptr;
+	}
+
+	uploadThread = thread;
+	uploadThreadFailed = false;
+	return uploadThread;
+}
+
+void Graphics::stopUploadThread()
+{
+	if (uploadThread != nullptr)
+	{
+		uploadThread->stop();
+		uploadThread->release();
+		uploadThread = nullptr;
+	}
+
+	uploadThreadFailed = false;
+}
+
+love::graphics::TextureUpload *Graphics::queueTextureUpload(UploadThread *thread, Texture *texture, love::image::ImageDataBase *data, int slice, int mipmap, const Rect &rect, bool generatemipmaps)
+{
+	// The upload context only sees the texture object once the commands which
+	// created it have been submitted.
+	glFlush();
+
+	StrongRef<UploadJob> job(new TextureUploadJob(texture->getGLTexture(), texture->getTextureType(), texture->getPixelFormat(), data, slice, mipmap, rect, generatemipmaps), Acquire::NORETAIN);
+
+	texture->setPendingUpload(job);
+	thread->queue(job);
+
+	return new TextureUpload(texture, job);
+}
+
+love::graphics::TextureUpload *Graphics::replacePixelsAsync(love::graphics::Texture *texture, love::image::ImageDataBase *data, int slice, int mipmap, int x, int y, bool reloadmipmaps)
+{
+	UploadThread *thread = getUploadThread();
+	if (thread == nullptr)
+		return love::graphics::Graphics::replacePixelsAsync(texture, data, slice, mipmap, x, y, reloadmipmaps);
+
+	Rect rect = {x, y, data->getWidth(), data->getHeight()};
+	texture->validateReplacePixels(data, slice, mipmap, rect);
+
+	bool generatemipmaps = reloadmipmaps && mipmap == 0 && texture->getMipmapCount() > 1;
+
+	const char *miperr = nullptr;
+	if (generatemipmaps && !texture->supportsGenerateMipmaps(miperr))
+		throw love::Exception("%s", miperr);
+
+	flushBatchedDraws();
+	removeFromTextureArrayBatch(texture->getRootViewInfo().texture);
+
+	return queueTextureUpload(thread, (Texture *) texture, data, slice, mipmap, rect, generatemipmaps);
+}
+
+love::graphics::TextureUpload *Graphics::newTextureAsync(const Texture::Settings &settings, love::image::ImageData *data)
+{
+	UploadThread *thread = getUploadThread();
+	if (thread == nullptr || settings.renderTarget || settings.msaa > 1)
+		return love::graphics::Graphics::newTextureAsync(settings, data);
+
+	Texture::Slices slices(settings.type);
+	slices.set(0, 0, data);
+
+	// The storage is allocated here, but not filled or cleared.
+	StrongRef<Texture> texture(new Texture(this, settings, &slices, true), Acquire::NORETAIN);
+
+	bool generatemipmaps = texture->getMipmapCount() > 1 && texture->getMipmapsMode() != Texture::MIPMAPS_NONE;
+	Rect rect = {0, 0, data->getWidth(), data->getHeight()};
+
+	return queueTextureUpload(thread, texture, data, 0, 0, rect, generatemipmaps);
+}
+
+love::graphics::BufferUpload *Graphics::newBufferAsync(const Buffer::Settings &settings, const std::vector<Buffer::DataDeclaration> &format, Data *data, size_t arraylength)
+{
+	UploadThread *thread = getUploadThread();
+	if (thread == nullptr)
+		return love::graphics::Graphics::newBufferAsync(settings, format, data, arraylength);
+
+	StrongRef<Buffer> buffer(new Buffer(this, settings, format, nullptr, data->getSize(), arraylength), Acquire::NORETAIN);
+
+	glFlush();
+
+	size_t size = std::min(data->getSize(), buffer->getSize());
+	StrongRef<UploadJob> job(new BufferUploadJob(buffer->getGLBuffer(), buffer->getGLTexelBuffer(), buffer->getHandleOffset(), data, size), Acquire::NORETAIN);
+
+	buffer->setPendingUpload(job);
+	thread->queue(job);
+
+	return new BufferUpload(buffer, job);
+}
+
 love::graphics::GraphicsReadback *Graphics::newReadbackInternal(ReadbackMethod method, love::graphics::Buffer *buffer, size_t offset, size_t size, data::ByteData *dest, size_t destoffset)
 {
 	return new GraphicsReadback(this, method, buffer, offset, size, dest, destoffset);
@@ -190,8 +334,9 @@ love::graphics::GraphicsReadback *Graphics::newReadbackInternal(ReadbackMethod m
 
 void Graphics::backbufferChanged(int width, int height, int pixelwidth, int pixelheight, bool backbufferstencil, bool backbufferdepth, int msaa)
 {
-	bool changed = width != this->width || height != this->height
-		|| pixelwidth != this->pixelWidth || pixelheight != this->pixelHeight;
+	// The internal backbuffer only depends on the size in pixels, so it's kept
+	// when just the DPI-scaled size changes.
+	bool changed = pixelwidth != this->pixelWidth || pixelheight != this->pixelHeight;
 
 	changed |= backbufferstencil != this->backbufferHasStencil || backbufferdepth != this->backbufferHasDepth;
 	changed |= msaa != this->requestedBackbufferMSAA;
@@ -372,11 +517,19 @@ bool Graphics::setMode(void */*context*/, int width, int height, int pixelwidth,
 	// Restore the graphics state.
 	restoreState(states.back());
 
+	beginGPUTimerFrame();
+
 	// We always need a default shader.
+	double shaderstart = timer::Timer::getTime();
 	for (int i = 0; i < Shader::STANDARD_MAX_ENUM; i++)
 	{
 		auto stype = (Shader::StandardShader) i;
 
+		// The skinning shader's samplerBuffer needs desktop GL 3.1. Meshes
+		// can't be given bone Buffers without it.
+		if (stype == Shader::STANDARD_SKINNED && !GLAD_VERSION_3_1)
+			continue;
+
 		if (!Shader::standardShaders[i])
 		{
 			std::vector<std::string> stages;
@@ -386,6 +539,7 @@ bool Graphics::setMode(void */*context*/, int width, int height, int pixelwidth,
 			Shader::standardShaders[i] = newShader(stages, opts);
 		}
 	}
+	defaultShaderCompileTime += timer::Timer::getTime() - shaderstart;
 
 	// A shader should always be active, but the default shader shouldn't be
 	// returned by getShader(), so we don't do setShader(defaultShader).
@@ -402,6 +556,10 @@ void Graphics::unSetMode()
 
 	flushBatchedDraws();
 
+	// The upload thread's context shares objects with the one that's about
+	// to be destroyed.
+	stopUploadThread();
+
 	internalBackbuffer.set(nullptr);
 	internalBackbufferDepthStencil.set(nullptr);
 
@@ -409,10 +567,24 @@ void Graphics::unSetMode()
 	// mode change.
 	Volatile::unloadAll();
 
+	// Every sub-allocated buffer was released above, so this destroys all
+	// pages.
+	for (auto &allocators : bufferPageAllocators)
+	{
+		for (BufferPageAllocator *allocator : allocators)
+		{
+			if (allocator != nullptr)
+				allocator->releaseEmptyPages();
+		}
+	}
+
 	clearTemporaryResources();
 
+	deleteGPUTimerQueries();
+	deleteOcclusionQueries();
+
 	for (const auto &pair : framebufferObjects)
-		gl.deleteFramebuffer(pair.second);
+		gl.deleteFramebuffer(pair.second.fbo);
 
 	framebufferObjects.clear();
 
@@ -561,7 +733,15 @@ void Graphics::draw(const DrawCommand &cmd)
 	if (cmd.indirectBuffer != nullptr)
 	{
 		gl.bindBuffer(BUFFERUSAGE_INDIRECT_ARGUMENTS, (GLuint) cmd.indirectBuffer->getHandle());
-		glDrawArraysIndirect(glprimitivetype, BUFFER_OFFSET(cmd.indirectBufferOffset));
+
+		if (cmd.indirectDrawCount > 1 && gl.isMultiDrawIndirectSupported())
+			glMultiDrawArraysIndirect(glprimitivetype, BUFFER_OFFSET(cmd.indirectBufferOffset), cmd.indirectDrawCount, 0);
+		else
+		{
+			const size_t stride = sizeof(uint32) * 4;
+			for (int i = 0; i < cmd.indirectDrawCount; i++)
+				glDrawArraysIndirect(glprimitivetype, BUFFER_OFFSET(cmd.indirectBufferOffset + stride * i));
+		}
 	}
 	else if (cmd.instanceCount > 1)
 		glDrawArraysInstanced(glprimitivetype, cmd.vertexStart, cmd.vertexCount, cmd.instanceCount);
@@ -578,7 +758,7 @@ void Graphics::draw(const DrawIndexedCommand &cmd)
 	gl.bindTextureToUnit(cmd.texture, 0, false);
 	gl.setCullMode(cmd.cullMode);
 
-	const void *gloffset = BUFFER_OFFSET(cmd.indexBufferOffset);
+	const void *gloffset = BUFFER_OFFSET(cmd.indexBuffer->getHandleOffset() + cmd.indexBufferOffset);
 	GLenum glprimitivetype = OpenGL::getGLPrimitiveType(cmd.primitiveType);
 	GLenum gldatatype = OpenGL::getGLIndexDataType(cmd.indexType);
 
@@ -589,7 +769,15 @@ void Graphics::draw(const DrawIndexedCommand &cmd)
 		// Note: OpenGL doesn't support indirect indexed draws with a non-zero
 		// index buffer offset.
 		gl.bindBuffer(BUFFERUSAGE_INDIRECT_ARGUMENTS, (GLuint) cmd.indirectBuffer->getHandle());
-		glDrawElementsIndirect(glprimitivetype, gldatatype, BUFFER_OFFSET(cmd.indirectBufferOffset));
+
+		if (cmd.indirectDrawCount > 1 && gl.isMultiDrawIndirectSupported())
+			glMultiDrawElementsIndirect(glprimitivetype, gldatatype, BUFFER_OFFSET(cmd.indirectBufferOffset), cmd.indirectDrawCount, 0);
+		else
+		{
+			const size_t stride = sizeof(uint32) * 5;
+			for (int i = 0; i < cmd.indirectDrawCount; i++)
+				glDrawElementsIndirect(glprimitivetype, gldatatype, BUFFER_OFFSET(cmd.indirectBufferOffset + stride * i));
+		}
 	}
 	else if (cmd.instanceCount > 1)
 		glDrawElementsInstanced(glprimitivetype, cmd.indexCount, gldatatype, gloffset, cmd.instanceCount);
@@ -757,7 +945,7 @@ void Graphics::setRenderTargetsInternal(const RenderTargets &rts, int pixelw, in
 		vertexwinding = vertexwinding == WINDING_CW ? WINDING_CCW : WINDING_CW;
 	}
 
-	glFrontFace(vertexwinding == WINDING_CW ? GL_CW : GL_CCW);
+	gl.setFrontFace(vertexwinding == WINDING_CW ? GL_CW : GL_CCW);
 
 	gl.setViewport({0, 0, pixelw, pixelh});
 
@@ -787,6 +975,26 @@ void Graphics::endPass(bool presenting)
 		discard({}, true);
 	}
 
+	// Render targets whose contents aren't needed after this pass. The MSAA
+	// buffers of resolve-only render targets are discarded after resolving.
+	std::vector<bool> discardcolors(rts.colors.size(), false);
+	bool discarddepthstencil = false;
+	bool hasdiscard = false;
+
+	for (size_t i = 0; i < rts.colors.size(); i++)
+	{
+		const auto &rt = rts.colors[i];
+		if (rt.storeAction == STORE_ACTION_DISCARD || (rt.storeAction == STORE_ACTION_RESOLVE && rt.texture->getMSAA() > 1 && rt.texture->isReadable()))
+			discardcolors[i] = hasdiscard = true;
+	}
+
+	if (depthstencil != nullptr)
+	{
+		StoreAction action = rts.depthStencil.storeAction;
+		if (action == STORE_ACTION_DISCARD || (action == STORE_ACTION_RESOLVE && depthstencil->getMSAA() > 1 && depthstencil->isReadable()))
+			discarddepthstencil = hasdiscard = true;
+	}
+
 	// Resolve MSAA buffers. MSAA is only supported for 2D render targets so we
 	// don't have to worry about resolving to slices.
 	if (rts.colors.size() > 0 && rts.colors[0].texture->getMSAA() > 1)
@@ -799,7 +1007,7 @@ void Graphics::endPass(bool presenting)
 		{
 			Texture *c = (Texture *) rts.colors[i].texture.get();
 
-			if (!c->isReadable())
+			if (!c->isReadable() || rts.colors[i].storeAction == STORE_ACTION_DISCARD)
 				continue;
 
 			glReadBuffer(GL_COLOR_ATTACHMENT0 + i);
@@ -813,7 +1021,8 @@ void Graphics::endPass(bool presenting)
 		}
 	}
 
-	if (depthstencil != nullptr && depthstencil->getMSAA() > 1 && depthstencil->isReadable())
+	if (depthstencil != nullptr && depthstencil->getMSAA() > 1 && depthstencil->isReadable()
+		&& rts.depthStencil.storeAction != STORE_ACTION_DISCARD)
 	{
 		gl.bindFramebuffer(OpenGL::FRAMEBUFFER_DRAW, ((Texture *) depthstencil)->getFBO());
 
@@ -837,6 +1046,10 @@ void Graphics::endPass(bool presenting)
 				glBlitFramebuffer(0, 0, w, h, 0, 0, w, h, mask, GL_NEAREST);
 		}
 	}
+
+	// The read framebuffer is still the one that was rendered to.
+	if (hasdiscard)
+		discard(OpenGL::FRAMEBUFFER_READ, discardcolors, discarddepthstencil);
 }
 
 void Graphics::clear(OptionalColorD c, OptionalInt stencil, OptionalDouble depth)
@@ -1064,7 +1277,7 @@ void Graphics::cleanupRenderTexture(love::graphics::Texture *texture)
 		if (hastexture)
 		{
 			if (isCreated())
-				gl.deleteFramebuffer(it->second);
+				gl.deleteFramebuffer(it->second.fbo);
 			it = framebufferObjects.erase(it);
 		}
 		else
@@ -1074,14 +1287,33 @@ void Graphics::cleanupRenderTexture(love::graphics::Texture *texture)
 
 GLuint Graphics::bindCachedFBO(const RenderTargets &targets)
 {
-	GLuint fbo = framebufferObjects[targets];
+	GLuint fbo = 0;
+	auto it = framebufferObjects.find(targets);
 
-	if (fbo != 0)
+	if (it != framebufferObjects.end())
 	{
+		it->second.lastUse = ++framebufferUseCounter;
+		fbo = it->second.fbo;
+		framebufferCacheHits++;
 		gl.bindFramebuffer(OpenGL::FRAMEBUFFER_ALL, fbo);
 	}
 	else
 	{
+		framebufferCacheMisses++;
+
+		if (framebufferObjects.size() >= MAX_CACHED_FBOS)
+		{
+			auto oldest = framebufferObjects.begin();
+			for (auto i = framebufferObjects.begin(); i != framebufferObjects.end(); ++i)
+			{
+				if (i->second.lastUse < oldest->second.lastUse)
+					oldest = i;
+			}
+
+			gl.deleteFramebuffer(oldest->second.fbo);
+			framebufferObjects.erase(oldest);
+		}
+
 		int msaa = targets.getFirstTarget().texture->getMSAA();
 		bool hasDS = targets.depthStencil.texture != nullptr;
 
@@ -1148,7 +1380,7 @@ GLuint Graphics::bindCachedFBO(const RenderTargets &targets)
 			throw love::Exception("Could not create Framebuffer Object! %s", sstr);
 		}
 
-		framebufferObjects[targets] = fbo;
+		framebufferObjects[targets] = {fbo, ++framebufferUseCounter};
 	}
 
 	return fbo;
@@ -1159,6 +1391,8 @@ void Graphics::present(void *screenshotCallbackData)
 	if (!isActive())
 		return;
 
+	LOVE_PROFILE_ZONE("Graphics::present");
+
 	if (isRenderTargetActive())
 		throw love::Exception("present cannot be called while a render target is active.");
 
@@ -1194,6 +1428,28 @@ void Graphics::present(void *screenshotCallbackData)
 		discard(OpenGL::FRAMEBUFFER_READ, {true}, false);
 	}
 
+	if (!pendingBackbufferCaptures.empty())
+	{
+		bool scissor = gl.isStateEnabled(OpenGL::ENABLE_SCISSOR_TEST);
+		if (scissor)
+			gl.setEnableState(OpenGL::ENABLE_SCISSOR_TEST, false);
+
+		gl.bindFramebuffer(OpenGL::FRAMEBUFFER_READ, getSystemBackbufferFBO());
+
+		// Flip vertically, since render target Textures are stored top row
+		// first.
+		for (const auto &dest : pendingBackbufferCaptures)
+		{
+			gl.bindFramebuffer(OpenGL::FRAMEBUFFER_DRAW, ((Texture *) dest.get())->getFBO());
+			glBlitFramebuffer(0, 0, w, h, 0, h, w, 0, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+		}
+
+		if (scissor)
+			gl.setEnableState(OpenGL::ENABLE_SCISSOR_TEST, true);
+
+		pendingBackbufferCaptures.clear();
+	}
+
 	if (!pendingScreenshotCallbacks.empty())
 	{
 		size_t row = 4 * w;
@@ -1274,9 +1530,18 @@ void Graphics::present(void *screenshotCallbackData)
 		buffer->nextFrame();
 	batchedDrawState.indexBuffer->nextFrame();
 
+	endGPUTimerFrame();
+
 	auto window = getInstance<love::window::Window>(M_WINDOW);
 	if (window != nullptr)
+	{
+		double presentstart = timer::Timer::getTime();
 		window->swapBuffers();
+		presentTime = timer::Timer::getTime() - presentstart;
+	}
+
+	resolveGPUTimerQueries();
+	updateOcclusionQueries();
 
 	gl.bindFramebuffer(OpenGL::FRAMEBUFFER_ALL, getInternalBackbufferFBO());
 
@@ -1284,10 +1549,18 @@ void Graphics::present(void *screenshotCallbackData)
 	drawCalls = 0;
 	gl.stats.shaderSwitches = 0;
 	renderTargetSwitchCount = 0;
+	framebufferCacheHits = 0;
+	framebufferCacheMisses = 0;
 	drawCallsBatched = 0;
 
 	updatePendingReadbacks();
+	updatePendingUploads();
+	updateStreamingTextures();
+	updateVirtualTextures();
 	updateTemporaryResources();
+	FrameArena::getInstance().reset();
+
+	beginGPUTimerFrame();
 }
 
 int Graphics::getRequestedBackbufferMSAA() const
@@ -1302,10 +1575,11 @@ int Graphics::getBackbufferMSAA() const
 
 void Graphics::setScissor(const Rect &rect)
 {
-	flushBatchedDraws();
-
 	DisplayState &state = states.back();
 
+	if (!state.scissor || !(rect == state.scissorRect))
+		flushBatchedDraws();
+
 	if (!gl.isStateEnabled(OpenGL::ENABLE_SCISSOR_TEST))
 		gl.setEnableState(OpenGL::ENABLE_SCISSOR_TEST, true);
 
@@ -1339,7 +1613,8 @@ void Graphics::setStencilState(const StencilState &s)
 {
 	validateStencilState(s);
 
-	flushBatchedDraws();
+	if (!(s == states.back().stencil))
+		flushBatchedDraws();
 
 	bool enablestencil = s.action != STENCIL_KEEP || s.compare != COMPARE_ALWAYS;
 	if (enablestencil != gl.isStateEnabled(OpenGL::ENABLE_STENCIL_TEST))
@@ -1390,8 +1665,8 @@ void Graphics::setStencilState(const StencilState &s)
 
 	if (enablestencil)
 	{
-		glStencilFunc(glcompare, s.value, s.readMask);
-		glStencilOp(GL_KEEP, GL_KEEP, glaction);
+		gl.setStencilFunc(glcompare, s.value, s.readMask);
+		gl.setStencilOp(GL_KEEP, GL_KEEP, glaction);
 	}
 
 	if (s.writeMask != gl.getStencilWriteMask())
@@ -1419,7 +1694,7 @@ void Graphics::setDepthMode(CompareMode compare, bool write)
 
 	if (depthenable)
 	{
-		glDepthFunc(OpenGL::getGLCompareMode(compare));
+		gl.setDepthFunc(OpenGL::getGLCompareMode(compare));
 		gl.setDepthWrites(write);
 	}
 }
@@ -1436,7 +1711,7 @@ void Graphics::setFrontFaceWinding(Winding winding)
 	if (isRenderTargetActive())
 		winding = winding == WINDING_CW ? WINDING_CCW : WINDING_CW;
 
-	glFrontFace(winding == WINDING_CW ? GL_CW : GL_CCW);
+	gl.setFrontFace(winding == WINDING_CW ? GL_CW : GL_CCW);
 }
 
 void Graphics::setColor(Colorf c)
@@ -1451,7 +1726,8 @@ void Graphics::setColor(Colorf c)
 
 void Graphics::setColorMask(ColorChannelMask mask)
 {
-	flushBatchedDraws();
+	if (mask != states.back().colorMask)
+		flushBatchedDraws();
 
 	uint32 maskbits =
 		((mask.r ? 1 : 0) << 0) | ((mask.g ? 1 : 0) << 1) |
@@ -1478,8 +1754,8 @@ void Graphics::setBlendState(const BlendState &blend)
 		GLenum dstRGB = getGLBlendFactor(blend.dstFactorRGB);
 		GLenum dstA   = getGLBlendFactor(blend.dstFactorA);
 
-		glBlendEquationSeparate(opRGB, opA);
-		glBlendFuncSeparate(srcRGB, dstRGB, srcA, dstA);
+		gl.setBlendEquation(opRGB, opA);
+		gl.setBlendFunc(srcRGB, dstRGB, srcA, dstA);
 	}
 
 	states.back().blend = blend;
@@ -1499,9 +1775,10 @@ void Graphics::setWireframe(bool enable)
 	if (GLAD_ES_VERSION_2_0)
 		return;
 
-	flushBatchedDraws();
+	if (enable != states.back().wireframe)
+		flushBatchedDraws();
 
-	glPolygonMode(GL_FRONT_AND_BACK, enable ? GL_LINE : GL_FILL);
+	gl.setPolygonMode(enable ? GL_LINE : GL_FILL);
 	states.back().wireframe = enable;
 }
 
@@ -1520,6 +1797,18 @@ void Graphics::releaseBufferMapMemory(void *mem)
 		free(mem);
 }
 
+BufferPageAllocator *Graphics::getBufferPageAllocator(BufferUsage usage, BufferDataUsage datausage)
+{
+	int usageindex = usage == BUFFERUSAGE_INDEX ? 1 : 0;
+	int datausageindex = datausage == BUFFERDATAUSAGE_DYNAMIC ? 1 : 0;
+
+	BufferPageAllocator *&allocator = bufferPageAllocators[usageindex][datausageindex];
+	if (allocator == nullptr)
+		allocator = new BufferPageAllocator(usage == BUFFERUSAGE_INDEX ? BUFFERUSAGE_INDEX : BUFFERUSAGE_VERTEX, datausage);
+
+	return allocator;
+}
+
 Renderer Graphics::getRenderer() const
 {
 	return RENDERER_OPENGL;
@@ -1560,9 +1849,175 @@ Graphics::RendererInfo Graphics::getRendererInfo() const
 	return info;
 }
 
-void Graphics::getAPIStats(int &shaderswitches) const
+void Graphics::getAPIStats(Stats &stats) const
+{
+	stats.shaderSwitches = gl.stats.shaderSwitches;
+	stats.framebufferCacheSize = (int) framebufferObjects.size();
+	stats.framebufferCacheHits = framebufferCacheHits;
+	stats.framebufferCacheMisses = framebufferCacheMisses;
+}
+
+Graphics::GPUTimerFrame *Graphics::getGPUTimerFrame()
+{
+	if (!isCreated() || !gl.isTimestampQuerySupported())
+		return nullptr;
+
+	return &gpuTimerFrames[gpuTimerFrameIndex].timer;
+}
+
+int Graphics::writeGPUTimestamp()
+{
+	GPUTimerQueryFrame &frame = gpuTimerFrames[gpuTimerFrameIndex];
+	int index = frame.timer.timestampCount;
+
+	if (index >= MAX_GPU_TIMESTAMPS)
+		return -1;
+
+	if (index >= (int) frame.queries.size())
+	{
+		GLuint query = 0;
+		glGenQueries(1, &query);
+		frame.queries.push_back(query);
+	}
+
+	glQueryCounter(frame.queries[index], GL_TIMESTAMP);
+
+	frame.timer.timestampCount++;
+	return index;
+}
+
+void Graphics::resolveGPUTimerQueries()
 {
-	shaderswitches = gl.stats.shaderSwitches;
+	if (!gl.isTimestampQuerySupported())
+		return;
+
+	gpuTimerFrames[gpuTimerFrameIndex].pending = gpuTimerFrames[gpuTimerFrameIndex].timer.timestampCount > 0;
+
+	// Results from a frame where the GPU was disjoint (e.g. its clock changed)
+	// are meaningless. This also resets the disjoint flag.
+	GLint disjoint = 0;
+	if (GLAD_EXT_disjoint_timer_query)
+		glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+
+	std::vector<double> timestamps;
+
+	// Check older frames first, so the most recent completed frame wins.
+	for (int i = 1; i <= GPU_TIMER_FRAMES; i++)
+	{
+		GPUTimerQueryFrame &frame = gpuTimerFrames[(gpuTimerFrameIndex + i) % GPU_TIMER_FRAMES];
+		if (!frame.pending)
+			continue;
+
+		GLuint available = 0;
+		glGetQueryObjectuiv(frame.queries[frame.timer.timestampCount - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available)
+			continue;
+
+		frame.pending = false;
+
+		if (disjoint)
+			continue;
+
+		timestamps.resize(frame.timer.timestampCount);
+		for (int j = 0; j < frame.timer.timestampCount; j++)
+		{
+			GLuint64 ns = 0;
+			glGetQueryObjectui64v(frame.queries[j], GL_QUERY_RESULT, &ns);
+			timestamps[j] = (double) ns * 1e-9;
+		}
+
+		resolveGPUTimerFrame(frame.timer, timestamps);
+	}
+
+	gpuTimerFrameIndex = (gpuTimerFrameIndex + 1) % GPU_TIMER_FRAMES;
+
+	// If the GPU is more than a few frames behind, the oldest frame's results
+	// are dropped so its queries can be reused.
+	gpuTimerFrames[gpuTimerFrameIndex].pending = false;
+}
+
+void Graphics::deleteGPUTimerQueries()
+{
+	for (GPUTimerQueryFrame &frame : gpuTimerFrames)
+	{
+		if (!frame.queries.empty())
+			glDeleteQueries((GLsizei) frame.queries.size(), frame.queries.data());
+		frame.queries.clear();
+		frame.timer = GPUTimerFrame();
+		frame.pending = false;
+	}
+
+	gpuTimerFrameIndex = 0;
+}
+
+void Graphics::beginOcclusionQueryInternal(love::graphics::OcclusionQuery *query)
+{
+	GLuint glquery = 0;
+	if (!freeOcclusionQueries.empty())
+	{
+		glquery = freeOcclusionQueries.back();
+		freeOcclusionQueries.pop_back();
+	}
+	else
+		glGenQueries(1, &glquery);
+
+	glBeginQuery(gl.getOcclusionQueryTarget(), glquery);
+
+	uint32 generation = query->addSegment();
+	occlusionQuerySegments.push_back({query, generation, glquery});
+}
+
+void Graphics::endOcclusionQueryInternal(love::graphics::OcclusionQuery */*query*/)
+{
+	glEndQuery(gl.getOcclusionQueryTarget());
+}
+
+void Graphics::updateOcclusionQueries()
+{
+	if (!isCreated())
+		return;
+
+	size_t resolved = 0;
+
+	for (const OcclusionQuerySegment &segment : occlusionQuerySegments)
+	{
+		if (segment.query->isActive())
+			break;
+
+		GLuint available = 0;
+		glGetQueryObjectuiv(segment.glQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available)
+			break;
+
+		GLuint samples = 0;
+		glGetQueryObjectuiv(segment.glQuery, GL_QUERY_RESULT, &samples);
+
+		segment.query->resolveSegment(segment.generation, samples);
+		freeOcclusionQueries.push_back(segment.glQuery);
+		resolved++;
+	}
+
+	occlusionQuerySegments.erase(occlusionQuerySegments.begin(), occlusionQuerySegments.begin() + resolved);
+}
+
+void Graphics::deleteOcclusionQueries()
+{
+	// Results which weren't read yet are lost with the context, so assume
+	// something was drawn.
+	for (const OcclusionQuerySegment &segment : occlusionQuerySegments)
+	{
+		segment.query->resolveSegment(segment.generation, 1);
+		freeOcclusionQueries.push_back(segment.glQuery);
+	}
+
+	occlusionQuerySegments.clear();
+
+	if (activeOcclusionQuery.get() != nullptr)
+		activeOcclusionQuery->markConservative();
+
+	if (!freeOcclusionQueries.empty())
+		glDeleteQueries((GLsizei) freeOcclusionQueries.size(), freeOcclusionQueries.data());
+	freeOcclusionQueries.clear();
 }
 
 void Graphics::initCapabilities()
@@ -1580,7 +2035,10 @@ void Graphics::initCapabilities()
 	capabilities.features[FEATURE_TEXEL_BUFFER] = gl.isBufferUsageSupported(BUFFERUSAGE_TEXEL);
 	capabilities.features[FEATURE_COPY_TEXTURE_TO_BUFFER] = gl.isCopyTextureToBufferSupported();
 	capabilities.features[FEATURE_INDIRECT_DRAW] = capabilities.features[FEATURE_GLSL4];
-	static_assert(FEATURE_MAX_ENUM == 13, "Graphics::initCapabilities must be updated when adding a new graphics feature!");
+	capabilities.features[FEATURE_ASYNC_COMPUTE] = false;
+	capabilities.features[FEATURE_OCCLUSION_QUERY] = gl.isOcclusionQuerySupported();
+	capabilities.features[FEATURE_BACKBUFFER_CAPTURE] = true;
+	static_assert(FEATURE_MAX_ENUM == 16, "Graphics::initCapabilities must be updated when adding a new graphics feature!");
 
 	capabilities.limits[LIMIT_POINT_SIZE] = gl.getMaxPointSize();
 	capabilities.limits[LIMIT_TEXTURE_SIZE] = gl.getMax2DTextureSize();
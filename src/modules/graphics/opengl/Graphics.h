@@ -36,6 +36,7 @@
 #include "image/Image.h"
 #include "image/ImageData.h"
 
+#include "Buffer.h"
 #include "Texture.h"
 #include "Shader.h"
 
@@ -60,6 +61,10 @@ public:
 	love::graphics::Texture *newTextureView(love::graphics::Texture *base, const Texture::ViewSettings &viewsettings) override;
 	love::graphics::Buffer *newBuffer(const Buffer::Settings &settings, const std::vector<Buffer::DataDeclaration> &format, const void *data, size_t size, size_t arraylength) override;
 
+	love::graphics::TextureUpload *replacePixelsAsync(love::graphics::Texture *texture, love::image::ImageDataBase *data, int slice, int mipmap, int x, int y, bool reloadmipmaps) override;
+	love::graphics::TextureUpload *newTextureAsync(const Texture::Settings &settings, love::image::ImageData *data) override;
+	love::graphics::BufferUpload *newBufferAsync(const Buffer::Settings &settings, const std::vector<Buffer::DataDeclaration> &format, Data *data, size_t arraylength) override;
+
 	void backbufferChanged(int width, int height, int pixelwidth, int pixelheight, bool backbufferstencil, bool backbufferdepth, int msaa) override;
 	bool setMode(void *context, int width, int height, int pixelwidth, int pixelheight, bool backbufferstencil, bool backbufferdepth, int msaa) override;
 	void unSetMode() override;
@@ -113,6 +118,8 @@ public:
 	void *getBufferMapMemory(size_t size);
 	void releaseBufferMapMemory(void *mem);
 
+	BufferPageAllocator *getBufferPageAllocator(BufferUsage usage, BufferDataUsage datausage);
+
 private:
 
 	struct CachedFBOHasher
@@ -122,11 +129,18 @@ private:
 			RenderTarget hashtargets[MAX_COLOR_RENDER_TARGETS + 1];
 			int hashcount = 0;
 
+			// Load and store actions don't affect which FBO is used.
 			for (size_t i = 0; i < rts.colors.size(); i++)
-				hashtargets[hashcount++] = rts.colors[i];
+			{
+				const RenderTarget &rt = rts.colors[i];
+				hashtargets[hashcount++] = RenderTarget(rt.texture, rt.slice, rt.mipmap);
+			}
 
 			if (rts.depthStencil.texture != nullptr)
-				hashtargets[hashcount++] = rts.depthStencil;
+			{
+				const RenderTarget &rt = rts.depthStencil;
+				hashtargets[hashcount++] = RenderTarget(rt.texture, rt.slice, rt.mipmap);
+			}
 			else if (rts.temporaryRTFlags != 0)
 				hashtargets[hashcount++] = RenderTarget(nullptr, -1, rts.temporaryRTFlags);
 
@@ -143,7 +157,18 @@ private:
 
 	void setRenderTargetsInternal(const RenderTargets &rts, int pixelw, int pixelh, bool hasSRGBtexture) override;
 	void initCapabilities() override;
-	void getAPIStats(int &shaderswitches) const override;
+	void getAPIStats(Stats &stats) const override;
+
+	GPUTimerFrame *getGPUTimerFrame() override;
+	int writeGPUTimestamp() override;
+
+	void resolveGPUTimerQueries();
+	void deleteGPUTimerQueries();
+
+	void updateOcclusionQueries() override;
+	void beginOcclusionQueryInternal(love::graphics::OcclusionQuery *query) override;
+	void endOcclusionQueryInternal(love::graphics::OcclusionQuery *query) override;
+	void deleteOcclusionQueries();
 
 	void endPass(bool presenting);
 	GLuint bindCachedFBO(const RenderTargets &targets);
@@ -157,10 +182,31 @@ private:
 
 	uint32 computePixelFormatUsage(PixelFormat format, bool readable);
 
-	std::unordered_map<RenderTargets, GLuint, CachedFBOHasher> framebufferObjects;
+	// Starts the upload thread the first time it's needed. Returns null if
+	// shared contexts or fences aren't supported.
+	UploadThread *getUploadThread();
+	void stopUploadThread();
+	love::graphics::TextureUpload *queueTextureUpload(UploadThread *thread, Texture *texture, love::image::ImageDataBase *data, int slice, int mipmap, const Rect &rect, bool generatemipmaps);
+
+	struct CachedFBO
+	{
+		GLuint fbo;
+		uint64 lastUse;
+	};
+
+	// The least recently used FBO is deleted when the cache is full.
+	static const size_t MAX_CACHED_FBOS = 64;
+
+	std::unordered_map<RenderTargets, CachedFBO, CachedFBOHasher> framebufferObjects;
+	uint64 framebufferUseCounter;
+	int framebufferCacheHits;
+	int framebufferCacheMisses;
 	bool windowHasStencil;
 	GLuint mainVAO;
 
+	UploadThread *uploadThread;
+	bool uploadThreadFailed;
+
 	StrongRef<love::graphics::Texture> internalBackbuffer;
 	StrongRef<love::graphics::Texture> internalBackbufferDepthStencil;
 	GLuint internalBackbufferFBO;
@@ -169,9 +215,38 @@ private:
 	char *bufferMapMemory;
 	size_t bufferMapMemorySize;
 
+	// [vertex, index][static, dynamic]
+	BufferPageAllocator *bufferPageAllocators[2][2];
+
 	// [non-readable, readable]
 	uint32 pixelFormatUsage[PIXELFORMAT_MAX_ENUM][2];
 
+	struct GPUTimerQueryFrame
+	{
+		GPUTimerFrame timer;
+		std::vector<GLuint> queries;
+		bool pending = false;
+	};
+
+	// Query results are read a couple of frames later, to avoid stalling.
+	static const int GPU_TIMER_FRAMES = 3;
+	static const int MAX_GPU_TIMESTAMPS = 256;
+
+	GPUTimerQueryFrame gpuTimerFrames[GPU_TIMER_FRAMES];
+	int gpuTimerFrameIndex;
+
+	struct OcclusionQuerySegment
+	{
+		StrongRef<love::graphics::OcclusionQuery> query;
+		uint32 generation;
+		GLuint glQuery;
+	};
+
+	// GL queries can span render target changes, so each begin/end pair only
+	// needs one. Results become available in submission order.
+	std::vector<OcclusionQuerySegment> occlusionQuerySegments;
+	std::vector<GLuint> freeOcclusionQueries;
+
 }; // Graphics
 
 } // opengl
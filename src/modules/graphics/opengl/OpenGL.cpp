@@ -240,12 +240,17 @@ void OpenGL::setupContext()
 
 	setVertexAttributes(VertexAttributes(), BufferBindings());
 
+	// Let the driver pick how many threads to use for async shader compiles.
+	if (GLAD_ARB_parallel_shader_compile)
+		glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+
 	// Get the current viewport.
 	glGetIntegerv(GL_VIEWPORT, (GLint *) &state.viewport.x);
 
 	// And the current scissor - but we need to compensate for GL scissors
 	// starting at the bottom left instead of top left.
 	glGetIntegerv(GL_SCISSOR_BOX, (GLint *) &state.scissor.x);
+	state.scissorBox = state.scissor;
 	state.scissor.y = state.viewport.h - (state.scissor.y + state.scissor.h);
 
 	for (int i = 0; i < 2; i++)
@@ -298,9 +303,37 @@ void OpenGL::setupContext()
 	glActiveTexture(GL_TEXTURE0);
 	state.curTextureUnit = 0;
 
-	setDepthWrites(state.depthWritesEnabled);
-	setStencilWriteMask(state.stencilWriteMask);
-	setColorWriteMask(state.colorWriteMask);
+	// The context may not be fresh, so the shadowed state is applied directly
+	// rather than through the (redundancy-checking) setters.
+	glDepthMask(state.depthWritesEnabled ? GL_TRUE : GL_FALSE);
+	glStencilMask(state.stencilWriteMask);
+	uint32 colormask = state.colorWriteMask;
+	glColorMask(colormask & (1 << 0), colormask & (1 << 1), colormask & (1 << 2), colormask & (1 << 3));
+
+	state.blendEquation[0] = state.blendEquation[1] = GL_FUNC_ADD;
+	glBlendEquationSeparate(GL_FUNC_ADD, GL_FUNC_ADD);
+
+	state.blendFunc[0] = state.blendFunc[2] = GL_ONE;
+	state.blendFunc[1] = state.blendFunc[3] = GL_ZERO;
+	glBlendFuncSeparate(GL_ONE, GL_ZERO, GL_ONE, GL_ZERO);
+
+	state.stencilFunc = GL_ALWAYS;
+	state.stencilRef = 0;
+	state.stencilReadMask = LOVE_UINT32_MAX;
+	glStencilFunc(GL_ALWAYS, 0, LOVE_UINT32_MAX);
+
+	state.stencilOp[0] = state.stencilOp[1] = state.stencilOp[2] = GL_KEEP;
+	glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+
+	state.depthFunc = GL_LESS;
+	glDepthFunc(GL_LESS);
+
+	state.frontFace = GL_CCW;
+	glFrontFace(GL_CCW);
+
+	state.polygonMode = GL_FILL;
+	if (!GLAD_ES_VERSION_2_0)
+		glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
 
 	contextInitialized = true;
 }
@@ -353,6 +386,25 @@ void OpenGL::initVendor()
 
 void OpenGL::initOpenGLFunctions()
 {
+	if (!GLAD_VERSION_4_3 && !GLAD_ARB_multi_draw_indirect && GLAD_EXT_multi_draw_indirect)
+	{
+		fp_glMultiDrawArraysIndirect = fp_glMultiDrawArraysIndirectEXT;
+		fp_glMultiDrawElementsIndirect = fp_glMultiDrawElementsIndirectEXT;
+	}
+
+	if (!GLAD_VERSION_3_3 && !GLAD_ARB_timer_query && GLAD_EXT_disjoint_timer_query)
+	{
+		fp_glQueryCounter = fp_glQueryCounterEXT;
+		fp_glGetQueryObjectui64v = fp_glGetQueryObjectui64vEXT;
+
+		if (!GLAD_ES_VERSION_3_0)
+		{
+			fp_glGenQueries = fp_glGenQueriesEXT;
+			fp_glDeleteQueries = fp_glDeleteQueriesEXT;
+			fp_glGetQueryObjectuiv = fp_glGetQueryObjectuivEXT;
+		}
+	}
+
 	if (!GLAD_VERSION_3_2 && !GLAD_ES_VERSION_3_2 && !GLAD_ARB_draw_elements_base_vertex)
 	{
 		if (GLAD_OES_draw_elements_base_vertex)
@@ -692,6 +744,21 @@ void OpenGL::deleteBuffer(GLuint buffer)
 	}
 }
 
+void OpenGL::resetBufferBinding(GLuint buffer)
+{
+	for (int i = 0; i < (int) BUFFERUSAGE_MAX_ENUM; i++)
+	{
+		if (state.boundBuffers[i] == buffer)
+			state.boundBuffers[i] = 0;
+
+		for (GLuint &bufferid : state.boundIndexedBuffers[i])
+		{
+			if (bufferid == buffer)
+				bufferid = 0;
+		}
+	}
+}
+
 void OpenGL::setVertexAttributes(const VertexAttributes &attributes, const BufferBindings &buffers)
 {
 	uint32 enablediff = attributes.enableBits ^ state.enabledAttribArrays;
@@ -730,7 +797,8 @@ void OpenGL::setVertexAttributes(const VertexAttributes &attributes, const Buffe
 			bool intformat = false;
 			GLenum gltype = getGLVertexDataType(attrib.getFormat(), components, normalized, intformat);
 
-			const void *offsetpointer = reinterpret_cast<void*>(bufferinfo.offset + attrib.offsetFromVertex);
+			size_t offset = bufferinfo.buffer->getHandleOffset() + bufferinfo.offset + attrib.offsetFromVertex;
+			const void *offsetpointer = reinterpret_cast<void*>(offset);
 
 			bindBuffer(BUFFERUSAGE_VERTEX, (GLuint) bufferinfo.buffer->getHandle());
 
@@ -794,18 +862,95 @@ Rect OpenGL::getViewport() const
 
 void OpenGL::setScissor(const Rect &v, bool rtActive)
 {
-	if (rtActive)
-		glScissor(v.x, v.y, v.w, v.h);
-	else
+	Rect box = v;
+
+	// With no RT active, we need to compensate for glScissor starting
+	// from the lower left of the viewport instead of the top left.
+	if (!rtActive)
+		box.y = state.viewport.h - (v.y + v.h);
+
+	if (!(box == state.scissorBox))
 	{
-		// With no RT active, we need to compensate for glScissor starting
-		// from the lower left of the viewport instead of the top left.
-		glScissor(v.x, state.viewport.h - (v.y + v.h), v.w, v.h);
+		glScissor(box.x, box.y, box.w, box.h);
+		state.scissorBox = box;
 	}
 
 	state.scissor = v;
 }
 
+void OpenGL::setBlendEquation(GLenum modeRGB, GLenum modeA)
+{
+	if (modeRGB != state.blendEquation[0] || modeA != state.blendEquation[1])
+	{
+		glBlendEquationSeparate(modeRGB, modeA);
+		state.blendEquation[0] = modeRGB;
+		state.blendEquation[1] = modeA;
+	}
+}
+
+void OpenGL::setBlendFunc(GLenum srcRGB, GLenum dstRGB, GLenum srcA, GLenum dstA)
+{
+	GLenum *cur = state.blendFunc;
+	if (srcRGB != cur[0] || dstRGB != cur[1] || srcA != cur[2] || dstA != cur[3])
+	{
+		glBlendFuncSeparate(srcRGB, dstRGB, srcA, dstA);
+		cur[0] = srcRGB;
+		cur[1] = dstRGB;
+		cur[2] = srcA;
+		cur[3] = dstA;
+	}
+}
+
+void OpenGL::setStencilFunc(GLenum func, GLint ref, GLuint mask)
+{
+	if (func != state.stencilFunc || ref != state.stencilRef || mask != state.stencilReadMask)
+	{
+		glStencilFunc(func, ref, mask);
+		state.stencilFunc = func;
+		state.stencilRef = ref;
+		state.stencilReadMask = mask;
+	}
+}
+
+void OpenGL::setStencilOp(GLenum sfail, GLenum dpfail, GLenum dppass)
+{
+	GLenum *cur = state.stencilOp;
+	if (sfail != cur[0] || dpfail != cur[1] || dppass != cur[2])
+	{
+		glStencilOp(sfail, dpfail, dppass);
+		cur[0] = sfail;
+		cur[1] = dpfail;
+		cur[2] = dppass;
+	}
+}
+
+void OpenGL::setDepthFunc(GLenum func)
+{
+	if (func != state.depthFunc)
+	{
+		glDepthFunc(func);
+		state.depthFunc = func;
+	}
+}
+
+void OpenGL::setFrontFace(GLenum mode)
+{
+	if (mode != state.frontFace)
+	{
+		glFrontFace(mode);
+		state.frontFace = mode;
+	}
+}
+
+void OpenGL::setPolygonMode(GLenum mode)
+{
+	if (mode != state.polygonMode)
+	{
+		glPolygonMode(GL_FRONT_AND_BACK, mode);
+		state.polygonMode = mode;
+	}
+}
+
 void OpenGL::setEnableState(EnableState enablestate, bool enable)
 {
 	GLenum glstate = GL_NONE;
@@ -921,6 +1066,9 @@ void OpenGL::framebufferTexture(GLenum attachment, TextureType texType, GLuint t
 
 void OpenGL::setDepthWrites(bool enable)
 {
+	if (enable == state.depthWritesEnabled)
+		return;
+
 	glDepthMask(enable ? GL_TRUE : GL_FALSE);
 	state.depthWritesEnabled = enable;
 }
@@ -932,6 +1080,9 @@ bool OpenGL::hasDepthWrites() const
 
 void OpenGL::setStencilWriteMask(uint32 mask)
 {
+	if (mask == state.stencilWriteMask)
+		return;
+
 	glStencilMask(mask);
 	state.stencilWriteMask = mask;
 }
@@ -943,6 +1094,9 @@ uint32 OpenGL::getStencilWriteMask() const
 
 void OpenGL::setColorWriteMask(uint32 mask)
 {
+	if (mask == state.colorWriteMask)
+		return;
+
 	glColorMask(mask & (1 << 0), mask & (1 << 1), mask & (1 << 2), mask & (1 << 3));
 	state.colorWriteMask = mask;
 }
@@ -1043,6 +1197,18 @@ void OpenGL::deleteTexture(GLuint texture)
 	glDeleteTextures(1, &texture);
 }
 
+void OpenGL::resetTextureBinding(GLuint texture)
+{
+	for (int i = 0; i < TEXTURE_MAX_ENUM + 1; i++)
+	{
+		for (GLuint &texid : state.boundTextures[i])
+		{
+			if (texid == texture)
+				texid = 0;
+		}
+	}
+}
+
 GLint OpenGL::getGLWrapMode(SamplerState::WrapMode wmode)
 {
 	switch (wmode)
@@ -1291,6 +1457,43 @@ bool OpenGL::isCopyTextureToBufferSupported() const
 	return GLAD_VERSION_4_5 || GLAD_ARB_get_texture_sub_image;
 }
 
+bool OpenGL::isProgramBinarySupported() const
+{
+	if (!(GLAD_VERSION_4_1 || GLAD_ES_VERSION_3_0 || GLAD_ARB_get_program_binary))
+		return false;
+
+	// Drivers are allowed to support the API without any binary formats.
+	GLint formats = 0;
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+	return formats > 0;
+}
+
+bool OpenGL::isParallelShaderCompileSupported() const
+{
+	return GLAD_ARB_parallel_shader_compile;
+}
+
+bool OpenGL::isMultiDrawIndirectSupported() const
+{
+	return GLAD_VERSION_4_3 || GLAD_ARB_multi_draw_indirect || GLAD_EXT_multi_draw_indirect;
+}
+
+bool OpenGL::isTimestampQuerySupported() const
+{
+	return GLAD_VERSION_3_3 || GLAD_ARB_timer_query || GLAD_EXT_disjoint_timer_query;
+}
+
+bool OpenGL::isOcclusionQuerySupported() const
+{
+	return GLAD_VERSION_1_5 || GLAD_ES_VERSION_3_0;
+}
+
+GLenum OpenGL::getOcclusionQueryTarget() const
+{
+	// OpenGL ES only has boolean occlusion queries.
+	return GLAD_VERSION_1_5 ? GL_SAMPLES_PASSED : GL_ANY_SAMPLES_PASSED;
+}
+
 int OpenGL::getMax2DTextureSize() const
 {
 	return std::max(max2DTextureSize, 1);
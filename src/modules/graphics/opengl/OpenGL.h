@@ -257,6 +257,13 @@ public:
 	 **/
 	void deleteBuffer(GLuint buffer);
 
+	/**
+	 * Makes the next bindBuffer of the buffer call glBindBuffer even if it's
+	 * already bound. Changes made by another context are only guaranteed to
+	 * be visible after the object is bound again.
+	 **/
+	void resetBufferBinding(GLuint buffer);
+
 	/**
 	 * Set all vertex attribute state.
 	 **/
@@ -285,6 +292,28 @@ public:
 	 **/
 	void setScissor(const Rect &v, bool rtActive);
 
+	/**
+	 * Wrappers for glBlendEquationSeparate and glBlendFuncSeparate which
+	 * eliminate redundant state setting.
+	 **/
+	void setBlendEquation(GLenum modeRGB, GLenum modeA);
+	void setBlendFunc(GLenum srcRGB, GLenum dstRGB, GLenum srcA, GLenum dstA);
+
+	/**
+	 * Wrappers for glStencilFunc and glStencilOp which eliminate redundant
+	 * state setting.
+	 **/
+	void setStencilFunc(GLenum func, GLint ref, GLuint mask);
+	void setStencilOp(GLenum sfail, GLenum dpfail, GLenum dppass);
+
+	/**
+	 * Wrappers for glDepthFunc, glFrontFace and glPolygonMode which eliminate
+	 * redundant state setting.
+	 **/
+	void setDepthFunc(GLenum func);
+	void setFrontFace(GLenum mode);
+	void setPolygonMode(GLenum mode);
+
 	/**
 	 * State-tracked version of glEnable.
 	 **/
@@ -350,6 +379,11 @@ public:
 	 **/
 	void deleteTexture(GLuint texture);
 
+	/**
+	 * Like resetBufferBinding, for textures.
+	 **/
+	void resetTextureBinding(GLuint texture);
+
 	/**
 	 * Sets sampler state parameters for the currently bound texture.
 	 **/
@@ -367,6 +401,17 @@ public:
 	bool isSamplerLODBiasSupported() const;
 	bool isBaseVertexSupported() const;
 	bool isCopyTextureToBufferSupported() const;
+	bool isProgramBinarySupported() const;
+	bool isParallelShaderCompileSupported() const;
+	bool isMultiDrawIndirectSupported() const;
+	bool isTimestampQuerySupported() const;
+	bool isOcclusionQuerySupported() const;
+
+	/**
+	 * GL_SAMPLES_PASSED where sample counts are supported, otherwise
+	 * GL_ANY_SAMPLES_PASSED.
+	 **/
+	GLenum getOcclusionQueryTarget() const;
 
 	/**
 	 * Returns the maximum supported width or height of a texture.
@@ -511,6 +556,21 @@ private:
 		Rect viewport;
 		Rect scissor;
 
+		// The scissor box as passed to glScissor (origin at the bottom-left.)
+		Rect scissorBox;
+
+		GLenum blendEquation[2];
+		GLenum blendFunc[4];
+
+		GLenum stencilFunc;
+		GLint stencilRef;
+		GLuint stencilReadMask;
+		GLenum stencilOp[3];
+
+		GLenum depthFunc;
+		GLenum frontFace;
+		GLenum polygonMode;
+
 		bool depthWritesEnabled = true;
 		uint32 stencilWriteMask = LOVE_UINT32_MAX;
 		uint32 colorWriteMask = LOVE_UINT32_MAX;
@@ -25,6 +25,11 @@
 #include "ShaderStage.h"
 #include "Graphics.h"
 #include "graphics/vertex.h"
+#include "filesystem/Filesystem.h"
+#include "common/version.h"
+
+// Libraries
+#include "libraries/xxHash/xxhash.h"
 
 // C++
 #include <algorithm>
@@ -41,6 +46,9 @@ namespace opengl
 Shader::Shader(StrongRef<love::graphics::ShaderStage> stages[SHADERSTAGE_MAX_ENUM], const CompileOptions &options)
 	: love::graphics::Shader(stages, options)
 	, program(0)
+	, asyncCompile(options.async)
+	, compilePending(false)
+	, useProgramCache(false)
 	, builtinUniforms()
 	, builtinUniformInfo()
 {
@@ -292,11 +300,7 @@ bool Shader::loadVolatile()
 	activeStorageBufferBindings.clear();
 	activeWritableStorageBuffers.clear();
 
-	for (const auto &stage : stages)
-	{
-		if (stage.get() != nullptr)
-			((ShaderStage*)stage.get())->loadVolatile();
-	}
+	linkError.clear();
 
 	program = glCreateProgram();
 
@@ -306,10 +310,39 @@ bool Shader::loadVolatile()
 	if (!debugName.empty() && (GLAD_VERSION_4_3 || GLAD_ES_VERSION_3_2))
 		glObjectLabel(GL_PROGRAM, program, -1, debugName.c_str());
 
+	auto gfx = Module::getInstance<love::graphics::Graphics>(Module::M_GRAPHICS);
+	useProgramCache = gfx != nullptr && gfx->isShaderCacheEnabled() && gl.isProgramBinarySupported();
+
+	if (useProgramCache)
+		programCacheFilename = getProgramCacheFilename();
+
+	if (useProgramCache && loadProgramBinary(programCacheFilename))
+	{
+		finishLoad();
+		return true;
+	}
+
+	// With parallel shader compilation the driver compiles and links on its
+	// own threads, and the results are only checked once they're complete.
+	bool background = asyncCompile && gl.isParallelShaderCompileSupported();
+
 	for (const auto &stage : stages)
 	{
 		if (stage.get() != nullptr)
+		{
+			try
+			{
+				((ShaderStage*)stage.get())->compile(!background);
+			}
+			catch (love::Exception &)
+			{
+				glDeleteProgram(program);
+				program = 0;
+				throw;
+			}
+
 			glAttachShader(program, (GLuint) stage->getHandle());
+		}
 	}
 
 	// Bind generic vertex attribute indices to names in the shader.
@@ -320,19 +353,68 @@ bool Shader::loadVolatile()
 			glBindAttribLocation(program, i, (const GLchar *) name);
 	}
 
+	if (useProgramCache)
+		glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
 	glLinkProgram(program);
 
+	if (background)
+	{
+		compilePending = true;
+		return true;
+	}
+
+	finishLink();
+	return true;
+}
+
+void Shader::finishLink()
+{
+	compilePending = false;
+
 	GLint status;
 	glGetProgramiv(program, GL_LINK_STATUS, &status);
 
 	if (status == GL_FALSE)
 	{
 		std::string warnings = getProgramWarnings();
+
 		glDeleteProgram(program);
 		program = 0;
-		throw love::Exception("Cannot link shader program object:\n%s", warnings.c_str());
+
+		// Stage compile errors are more useful than the resulting link error.
+		try
+		{
+			for (const auto &stage : stages)
+			{
+				if (stage.get() != nullptr)
+					((ShaderStage*)stage.get())->checkCompileStatus();
+			}
+
+			linkError = "Cannot link shader program object:\n" + warnings;
+		}
+		catch (love::Exception &e)
+		{
+			linkError = e.what();
+		}
+
+		throw love::Exception("%s", linkError.c_str());
 	}
 
+	for (const auto &stage : stages)
+	{
+		if (stage.get() != nullptr)
+			((ShaderStage*)stage.get())->checkCompileStatus();
+	}
+
+	if (useProgramCache)
+		saveProgramBinary(programCacheFilename);
+
+	finishLoad();
+}
+
+void Shader::finishLoad()
+{
 	// Get all active uniform variables in this shader from OpenGL.
 	mapActiveUniforms();
 
@@ -342,12 +424,46 @@ bool Shader::loadVolatile()
 		current = nullptr;
 		attach();
 	}
+}
 
+bool Shader::isReady()
+{
+	if (!compilePending)
+	{
+		checkLinkError();
+		return true;
+	}
+
+	GLint complete = GL_FALSE;
+	glGetProgramiv(program, GL_COMPLETION_STATUS_ARB, &complete);
+
+	if (complete == GL_FALSE)
+		return false;
+
+	finishLink();
 	return true;
 }
 
+void Shader::waitUntilReady()
+{
+	if (compilePending)
+		finishLink();
+	else
+		checkLinkError();
+}
+
+void Shader::checkLinkError() const
+{
+	// A failed background compile leaves no program, so keep failing rather
+	// than silently using program 0.
+	if (!linkError.empty())
+		throw love::Exception("%s", linkError.c_str());
+}
+
 void Shader::unloadVolatile()
 {
+	compilePending = false;
+
 	if (program != 0)
 	{
 		if (current == this)
@@ -368,6 +484,146 @@ void Shader::unloadVolatile()
 		builtinUniforms[i] = -1;
 }
 
+// Header of the program binary files written to the shader cache.
+struct ProgramBinaryHeader
+{
+	uint32 magic;
+	uint32 format;
+};
+
+static const uint32 PROGRAM_BINARY_MAGIC = 0x4C4F5647; // 'LOVG'
+
+std::string Shader::getProgramCacheFilename() const
+{
+	XXH64_state_t *state = XXH64_createState();
+	XXH64_reset(state, 0);
+
+	// Binaries are only valid for the exact driver that created them. Drivers
+	// also reject mismatched binaries themselves, but this avoids repeatedly
+	// loading and discarding stale files after a driver update.
+	const char *strings[] = {
+		LOVE_VERSION_STRING,
+		(const char *) glGetString(GL_VENDOR),
+		(const char *) glGetString(GL_RENDERER),
+		(const char *) glGetString(GL_VERSION),
+	};
+
+	for (const char *str : strings)
+	{
+		if (str != nullptr)
+			XXH64_update(state, str, strlen(str) + 1);
+	}
+
+	for (const auto &stage : stages)
+	{
+		if (stage.get() == nullptr)
+			continue;
+
+		ShaderStageType type = stage->getStageType();
+		const std::string &source = stage->getSource();
+
+		XXH64_update(state, &type, sizeof(ShaderStageType));
+		XXH64_update(state, source.c_str(), source.length() + 1);
+	}
+
+	uint64 hash = XXH64_digest(state);
+	XXH64_freeState(state);
+
+	char filename[64];
+	snprintf(filename, sizeof(filename), "shadercache/gl_%016llx.bin", (unsigned long long) hash);
+	return std::string(filename);
+}
+
+bool Shader::loadProgramBinary(const std::string &filename)
+{
+	auto fs = Module::getInstance<filesystem::Filesystem>(Module::M_FILESYSTEM);
+	if (fs == nullptr || !fs->exists(filename.c_str()))
+		return false;
+
+	StrongRef<filesystem::FileData> filedata;
+
+	try
+	{
+		filedata.set(fs->read(filename.c_str()), Acquire::NORETAIN);
+	}
+	catch (love::Exception &)
+	{
+		return false;
+	}
+
+	if (filedata->getSize() <= sizeof(ProgramBinaryHeader))
+		return false;
+
+	ProgramBinaryHeader header;
+	memcpy(&header, filedata->getData(), sizeof(ProgramBinaryHeader));
+
+	if (header.magic != PROGRAM_BINARY_MAGIC)
+		return false;
+
+	const char *data = (const char *) filedata->getData() + sizeof(ProgramBinaryHeader);
+	GLsizei size = (GLsizei) (filedata->getSize() - sizeof(ProgramBinaryHeader));
+
+	glProgramBinary(program, (GLenum) header.format, data, size);
+
+	GLint status = GL_FALSE;
+	glGetProgramiv(program, GL_LINK_STATUS, &status);
+
+	if (status == GL_FALSE)
+	{
+		// The binary was rejected, so the program needs to be linked from
+		// source. A fresh program object avoids any leftover state.
+		glDeleteProgram(program);
+		program = glCreateProgram();
+
+		if (program == 0)
+			throw love::Exception("Cannot create shader program object.");
+
+		if (!debugName.empty() && (GLAD_VERSION_4_3 || GLAD_ES_VERSION_3_2))
+			glObjectLabel(GL_PROGRAM, program, -1, debugName.c_str());
+
+		return false;
+	}
+
+	return true;
+}
+
+void Shader::saveProgramBinary(const std::string &filename) const
+{
+	auto fs = Module::getInstance<filesystem::Filesystem>(Module::M_FILESYSTEM);
+	if (fs == nullptr)
+		return;
+
+	GLint length = 0;
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+
+	if (length <= 0)
+		return;
+
+	std::vector<char> filedata(sizeof(ProgramBinaryHeader) + length);
+
+	GLenum format = 0;
+	GLsizei written = 0;
+	glGetProgramBinary(program, length, &written, &format, filedata.data() + sizeof(ProgramBinaryHeader));
+
+	if (written <= 0)
+		return;
+
+	ProgramBinaryHeader header;
+	header.magic = PROGRAM_BINARY_MAGIC;
+	header.format = (uint32) format;
+	memcpy(filedata.data(), &header, sizeof(ProgramBinaryHeader));
+
+	try
+	{
+		fs->createDirectory("shadercache");
+		fs->write(filename.c_str(), filedata.data(), sizeof(ProgramBinaryHeader) + written);
+	}
+	catch (love::Exception &)
+	{
+		// The save directory might not be writable, the cache is optional.
+	}
+}
+
 std::string Shader::getProgramWarnings() const
 {
 	GLint strsize, nullpos;
@@ -415,6 +671,8 @@ void Shader::attach()
 	{
 		Graphics::flushBatchedDrawsGlobal();
 
+		waitUntilReady();
+
 		gl.useProgram(program);
 		current = this;
 		// retain/release happens in Graphics::setShader.
@@ -459,11 +717,42 @@ void Shader::updateUniform(const UniformInfo *info, int count)
 	updateUniform(info, count, false);
 }
 
+void Shader::updateUniforms(const UniformUpdate *updates, int count)
+{
+	if (current != this)
+	{
+		for (int i = 0; i < count; i++)
+			addPendingUniformUpdate(updates[i].first, updates[i].second);
+		return;
+	}
+
+	flushBatchedDraws();
+
+	for (int i = 0; i < count; i++)
+		updateUniform(updates[i].first, updates[i].second, true);
+}
+
+void Shader::addPendingUniformUpdate(const UniformInfo *info, int count)
+{
+	// A uniform sent several times before the Shader is used only needs to be
+	// updated once, with its latest values.
+	for (UniformUpdate &update : pendingUniformUpdates)
+	{
+		if (update.first == info)
+		{
+			update.second = std::max(update.second, count);
+			return;
+		}
+	}
+
+	pendingUniformUpdates.push_back(std::make_pair(info, count));
+}
+
 void Shader::updateUniform(const UniformInfo *info, int count, bool internalupdate)
 {
 	if (current != this && !internalupdate)
 	{
-		pendingUniformUpdates.push_back(std::make_pair(info, count));
+		addPendingUniformUpdate(info, count);
 		return;
 	}
 
@@ -726,6 +1015,8 @@ ptrdiff_t Shader::getHandle() const
 
 int Shader::getVertexAttributeIndex(const std::string &name)
 {
+	waitUntilReady();
+
 	auto it = attributes.find(name);
 	if (it != attributes.end())
 		return it->second;
@@ -769,6 +1060,8 @@ void Shader::updateBuiltinUniforms(love::graphics::Graphics *gfx, int viewportW,
 
 	data.scaleParams.x = (float) gfx->getCurrentDPIScale();
 	data.scaleParams.y = gfx->getPointSize();
+	data.scaleParams.z = gfx->getLineWidth();
+	data.scaleParams.w = gfx->getLineStyle() == Graphics::LINE_SMOOTH ? 1.0f : 0.0f;
 
 	// Users expect to work with y-up NDC, y-down pixel coordinates and textures
 	// (see graphics/Shader.h).
@@ -61,10 +61,13 @@ public:
 
 	// Implements Shader.
 	void attach() override;
+	bool isReady() override;
+	void waitUntilReady() override;
 	std::string getWarnings() const override;
 	int getVertexAttributeIndex(const std::string &name) override;
 	const UniformInfo *getUniformInfo(BuiltinUniform builtin) const override;
 	void updateUniform(const UniformInfo *info, int count) override;
+	void updateUniforms(const UniformUpdate *updates, int count) override;
 	void sendTextures(const UniformInfo *info, love::graphics::Texture **textures, int count) override;
 	void sendBuffers(const UniformInfo *info, love::graphics::Buffer **buffers, int count) override;
 	ptrdiff_t getHandle() const override;
@@ -94,7 +97,13 @@ private:
 	// Map active uniform names to their locations.
 	void mapActiveUniforms();
 
+	// Checks the results of linking, then maps uniforms.
+	void finishLink();
+	void finishLoad();
+	void checkLinkError() const;
+
 	void updateUniform(const UniformInfo *info, int count, bool internalupdate);
+	void addPendingUniformUpdate(const UniformInfo *info, int count);
 	void sendTextures(const UniformInfo *info, love::graphics::Texture **textures, int count, bool internalupdate);
 	void sendBuffers(const UniformInfo *info, love::graphics::Buffer **buffers, int count, bool internalupdate);
 
@@ -103,9 +112,21 @@ private:
 	// Get any warnings or errors generated only by the shader program object.
 	std::string getProgramWarnings() const;
 
+	// Persistent program binary cache, see Graphics::setShaderCacheEnabled.
+	std::string getProgramCacheFilename() const;
+	bool loadProgramBinary(const std::string &filename);
+	void saveProgramBinary(const std::string &filename) const;
+
 	// volatile
 	GLuint program;
 
+	bool asyncCompile;
+	bool compilePending;
+	std::string linkError;
+
+	bool useProgramCache;
+	std::string programCacheFilename;
+
 	// Location values for any built-in uniform variables.
 	GLint builtinUniforms[BUILTIN_MAX_ENUM];
 	UniformInfo *builtinUniformInfo[BUILTIN_MAX_ENUM];
@@ -122,7 +143,7 @@ private:
 
 	std::vector<Buffer *> activeWritableStorageBuffers;
 
-	std::vector<std::pair<const UniformInfo *, int>> pendingUniformUpdates;
+	std::vector<UniformUpdate> pendingUniformUpdates;
 
 }; // Shader
 
@@ -30,8 +30,8 @@ namespace opengl
 ShaderStage::ShaderStage(love::graphics::Graphics *gfx, ShaderStageType stage, const std::string &source, bool gles, const std::string &cachekey)
 	: love::graphics::ShaderStage(gfx, stage, source, gles, cachekey)
 	, glShader(0)
+	, compileStatusChecked(false)
 {
-	loadVolatile();
 }
 
 ShaderStage::~ShaderStage()
@@ -40,9 +40,19 @@ ShaderStage::~ShaderStage()
 }
 
 bool ShaderStage::loadVolatile()
+{
+	// The shader object is created on demand by compile().
+	return true;
+}
+
+void ShaderStage::compile(bool checkstatus)
 {
 	if (glShader != 0)
-		return true;
+	{
+		if (checkstatus)
+			checkCompileStatus();
+		return;
+	}
 
 	ShaderStageType stage = getStageType();
 	const char *typestr = "unknown";
@@ -70,6 +80,20 @@ bool ShaderStage::loadVolatile()
 	glShaderSource(glShader, 1, (const GLchar **)&src, &srclen);
 	glCompileShader(glShader);
 
+	compileStatusChecked = false;
+
+	if (checkstatus)
+		checkCompileStatus();
+}
+
+void ShaderStage::checkCompileStatus()
+{
+	if (glShader == 0 || compileStatusChecked)
+		return;
+
+	const char *typestr = "unknown";
+	getConstant(getStageType(), typestr);
+
 	GLint infologlen;
 	glGetShaderiv(glShader, GL_INFO_LOG_LENGTH, &infologlen);
 
@@ -88,10 +112,11 @@ bool ShaderStage::loadVolatile()
 	if (status == GL_FALSE)
 	{
 		glDeleteShader(glShader);
+		glShader = 0;
 		throw love::Exception("Cannot compile %s shader code:\n%s", typestr, warnings.c_str());
 	}
 
-	return true;
+	compileStatusChecked = true;
 }
 
 void ShaderStage::unloadVolatile()
@@ -40,6 +40,15 @@ public:
 
 	ptrdiff_t getHandle() const override { return glShader; }
 
+	/**
+	 * Compiles the GL shader object, if it hasn't been already. This is done
+	 * lazily so it can be skipped when a Shader loads a cached program binary.
+	 * If checkstatus is false, the driver may finish compiling in the
+	 * background and checkCompileStatus must be called later.
+	 **/
+	void compile(bool checkstatus = true);
+	void checkCompileStatus();
+
 	// Implements Volatile.
 	bool loadVolatile() override;
 	void unloadVolatile() override;
@@ -47,6 +56,7 @@ public:
 private:
 
 	GLuint glShader;
+	bool compileStatusChecked;
 
 }; // ShaderStage
 
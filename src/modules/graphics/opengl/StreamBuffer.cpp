@@ -150,6 +150,7 @@ public:
 	{
 		// Orphan the buffer before its first use in the next frame.
 		frameGPUReadOffset = 0;
+		frameStallCount = 0;
 		orphan = true;
 	}
 
@@ -215,6 +216,7 @@ public:
 
 		frameIndex = (frameIndex + 1) % BUFFER_FRAMES;
 		frameGPUReadOffset = 0;
+		frameStallCount = 0;
 	}
 
 	void markUsed(size_t usedsize) override
@@ -224,8 +226,24 @@ public:
 		frameGPUReadOffset += usedsize;
 	}
 
+	size_t getMemorySize() const override
+	{
+		return bufferSize * BUFFER_FRAMES;
+	}
+
 protected:
 
+	// Makes sure this frame's section of the buffer is done being used.
+	void waitForFrame()
+	{
+		FenceSync &sync = syncs[frameIndex];
+
+		if (!sync.isComplete())
+			frameStallCount++;
+
+		sync.cpuWait();
+	}
+
 	int frameIndex;
 	FenceSync syncs[BUFFER_FRAMES];
 
@@ -252,8 +270,7 @@ public:
 	{
 		gl.bindBuffer(mode, vbo);
 
-		// Make sure this frame's section of the buffer is done being used.
-		syncs[frameIndex].cpuWait();
+		waitForFrame();
 
 		MapInfo info;
 		info.size = bufferSize - frameGPUReadOffset;
@@ -334,8 +351,7 @@ public:
 
 	MapInfo map(size_t /*minsize*/) override
 	{
-		// Make sure this frame's section of the buffer is done being used.
-		syncs[frameIndex].cpuWait();
+		waitForFrame();
 
 		MapInfo info;
 		info.size = bufferSize - frameGPUReadOffset;
@@ -437,8 +453,7 @@ public:
 
 	MapInfo map(size_t /*minsize*/) override
 	{
-		// Make sure this frame's section of the buffer is done being used.
-		syncs[frameIndex].cpuWait();
+		waitForFrame();
 
 		MapInfo info;
 		info.size = bufferSize - frameGPUReadOffset;
@@ -452,6 +467,11 @@ public:
 		return offset;
 	}
 
+	size_t getMemorySize() const override
+	{
+		return alignedSize;
+	}
+
 	ptrdiff_t getHandle() const override { return vbo; }
 
 	bool loadVolatile() override
@@ -210,9 +210,10 @@ static GLenum newRenderbuffer(int width, int height, int &samples, PixelFormat p
 	return status;
 }
 
-Texture::Texture(love::graphics::Graphics *gfx, const Settings &settings, const Slices *data)
+Texture::Texture(love::graphics::Graphics *gfx, const Settings &settings, const Slices *data, bool deferupload)
 	: love::graphics::Texture(gfx, settings, data)
 	, slices(settings.type)
+	, deferUpload(deferupload)
 	, fbo(0)
 	, texture(0)
 	, renderbuffer(0)
@@ -234,11 +235,13 @@ Texture::Texture(love::graphics::Graphics *gfx, const Settings &settings, const
 	// ImageData is referenced by the first loadVolatile call, but we don't
 	// hang on to it after that so we can save memory.
 	slices.clear();
+	deferUpload = false;
 }
 
 Texture::Texture(love::graphics::Graphics *gfx, love::graphics::Texture *base, const Texture::ViewSettings &viewsettings)
 	: love::graphics::Texture(gfx, base, viewsettings)
 	, slices(viewsettings.type.get(base->getTextureType()))
+	, deferUpload(false)
 	, fbo(0)
 	, texture(0)
 	, renderbuffer(0)
@@ -336,7 +339,7 @@ void Texture::createTexture()
 				glCompressedTexImage3D(gltype, mip, fmt.internalformat, w, h, slicecount, 0, mipsize, nullptr);
 		}
 
-		for (int slice = 0; slice < slicecount; slice++)
+		for (int slice = 0; slice < slicecount && !deferUpload; slice++)
 		{
 			love::image::ImageDataBase *id = slices.get(slice, mip);
 			if (id != nullptr)
@@ -388,7 +391,7 @@ void Texture::createTexture()
 
 	// Non-readable textures can't have mipmaps (enforced in the base class),
 	// so generateMipmaps here is fine - when they aren't already initialized.
-	if (clearmips < mipmapCount && slices.getMipmapCount() <= 1 && getMipmapsMode() != MIPMAPS_NONE)
+	if (clearmips < mipmapCount && slices.getMipmapCount() <= 1 && getMipmapsMode() != MIPMAPS_NONE && !deferUpload)
 		generateMipmaps();
 }
 
@@ -447,6 +450,10 @@ bool Texture::loadVolatile()
 
 void Texture::unloadVolatile()
 {
+	// The upload thread could still be using the texture object.
+	if (pendingUpload.get() != nullptr)
+		waitForPendingUpload();
+
 	if (isRenderTarget() && (fbo != 0 || renderbuffer != 0 || texture != 0))
 	{
 		// This is a bit ugly, but we need some way to destroy the cached FBO
@@ -571,7 +578,7 @@ void Texture::copyFromBuffer(love::graphics::Buffer *source, size_t sourceoffset
 
 	// glTexSubImage and friends copy from the active pixel_unpack_buffer by
 	// treating the pointer as a byte offset.
-	const uint8 *byteoffset = (const uint8 *)(ptrdiff_t)sourceoffset;
+	const uint8 *byteoffset = (const uint8 *)(ptrdiff_t)(source->getHandleOffset() + sourceoffset);
 	uploadByteData(byteoffset, size, mipmap, slice, rect);
 
 	glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
@@ -587,7 +594,7 @@ void Texture::copyToBuffer(love::graphics::Buffer *dest, int slice, int mipmap,
 
 	// glTexSubImage and friends copy to the active PIXEL_PACK_BUFFER by
 	// treating the pointer as a byte offset.
-	uint8 *byteoffset = (uint8 *)(ptrdiff_t)destoffset;
+	uint8 *byteoffset = (uint8 *)(ptrdiff_t)(dest->getHandleOffset() + destoffset);
 
 	readbackInternal(slice, mipmap, rect, destwidth, size, byteoffset);
 
@@ -602,13 +609,23 @@ void Texture::setSamplerState(const SamplerState &s)
 	gl.setSamplerState(texType, samplerState);
 }
 
+void Texture::waitForPendingUpload() const
+{
+	pendingUpload->wait();
+	pendingUpload.set(nullptr);
+}
+
 ptrdiff_t Texture::getHandle() const
 {
+	if (pendingUpload.get() != nullptr)
+		waitForPendingUpload();
 	return texture;
 }
 
 ptrdiff_t Texture::getRenderTargetHandle() const
 {
+	if (pendingUpload.get() != nullptr)
+		waitForPendingUpload();
 	return renderTarget ? (renderbuffer != 0 ? renderbuffer : texture) : 0;
 }
 
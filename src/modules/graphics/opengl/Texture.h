@@ -26,6 +26,7 @@
 
 // OpenGL
 #include "OpenGL.h"
+#include "UploadThread.h"
 
 namespace love
 {
@@ -38,7 +39,11 @@ class Texture final : public love::graphics::Texture, public Volatile
 {
 public:
 
-	Texture(love::graphics::Graphics *gfx, const Settings &settings, const Slices *data);
+	/**
+	 * When deferupload is true, the texture's storage is allocated but the
+	 * data isn't uploaded, so it can be copied from the UploadThread instead.
+	 **/
+	Texture(love::graphics::Graphics *gfx, const Settings &settings, const Slices *data, bool deferupload = false);
 	Texture(love::graphics::Graphics *gfx, love::graphics::Texture *base, const Texture::ViewSettings &viewsettings);
 
 	virtual ~Texture();
@@ -59,6 +64,15 @@ public:
 
 	inline GLuint getFBO() const { return fbo; }
 
+	// Doesn't wait for a pending upload, unlike getHandle.
+	inline GLuint getGLTexture() const { return texture; }
+
+	/**
+	 * Makes uses of the texture on the main thread wait for the upload to be
+	 * complete first.
+	 **/
+	void setPendingUpload(UploadJob *job) { pendingUpload.set(job); }
+
 	void readbackInternal(int slice, int mipmap, const Rect &rect, int destwidth, size_t size, void *dest);
 
 private:
@@ -69,7 +83,12 @@ private:
 
 	void generateMipmapsInternal() override;
 
+	void waitForPendingUpload() const;
+
 	Slices slices;
+	bool deferUpload;
+
+	mutable StrongRef<UploadJob> pendingUpload;
 
 	GLuint fbo;
 
@@ -0,0 +1,348 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "UploadThread.h"
+#include "OpenGL.h"
+#include "common/Exception.h"
+#include "window/Window.h"
+
+namespace love
+{
+namespace graphics
+{
+namespace opengl
+{
+
+UploadJob::UploadJob()
+	: finished(false)
+	, complete(false)
+{
+}
+
+UploadJob::~UploadJob()
+{
+}
+
+bool UploadJob::isComplete()
+{
+	if (complete)
+		return true;
+
+	{
+		love::thread::Lock lock(mutex);
+		if (!finished)
+			return false;
+	}
+
+	if (hasError())
+	{
+		complete = true;
+		return true;
+	}
+
+	if (!fence.isComplete())
+		return false;
+
+	fence.cleanup();
+	complete = true;
+	completed();
+
+	return true;
+}
+
+void UploadJob::wait()
+{
+	if (complete)
+		return;
+
+	{
+		love::thread::Lock lock(mutex);
+		while (!finished)
+			finishedCond->wait(mutex);
+	}
+
+	if (hasError())
+	{
+		complete = true;
+		return;
+	}
+
+	fence.cpuWait();
+	complete = true;
+	completed();
+}
+
+void UploadJob::finish(const char *error)
+{
+	if (error == nullptr)
+	{
+		fence.fence();
+
+		// The main context can't see the fence until it's been submitted.
+		glFlush();
+	}
+
+	love::thread::Lock lock(mutex);
+	if (error != nullptr)
+		this->error = error;
+	finished = true;
+	finishedCond->broadcast();
+}
+
+TextureUploadJob::TextureUploadJob(GLuint texture, TextureType textype, PixelFormat format, love::image::ImageDataBase *data, int slice, int mipmap, const Rect &rect, bool generatemipmaps)
+	: texture(texture)
+	, texType(textype)
+	, format(format)
+	, data(data)
+	, slice(slice)
+	, mipmap(mipmap)
+	, rect(rect)
+	, generateMipmaps(generatemipmaps)
+{
+}
+
+TextureUploadJob::~TextureUploadJob()
+{
+}
+
+void TextureUploadJob::run()
+{
+	GLenum gltype = OpenGL::getGLTextureType(texType);
+	GLenum gltarget = gltype;
+
+	if (texType == TEXTURE_CUBE)
+		gltarget = GL_TEXTURE_CUBE_MAP_POSITIVE_X + slice;
+
+	OpenGL::TextureFormat fmt = OpenGL::convertPixelFormat(format);
+	const void *pixels = data->getReadOnlyData();
+	GLsizei size = (GLsizei) data->getSize();
+
+	// This context's bindings aren't tracked by the OpenGL class.
+	glBindTexture(gltype, texture);
+
+	if (isPixelFormatCompressed(format))
+	{
+		if (texType == TEXTURE_2D || texType == TEXTURE_CUBE)
+			glCompressedTexSubImage2D(gltarget, mipmap, rect.x, rect.y, rect.w, rect.h, fmt.internalformat, size, pixels);
+		else
+			glCompressedTexSubImage3D(gltarget, mipmap, rect.x, rect.y, slice, rect.w, rect.h, 1, fmt.internalformat, size, pixels);
+	}
+	else
+	{
+		if (texType == TEXTURE_2D || texType == TEXTURE_CUBE)
+			glTexSubImage2D(gltarget, mipmap, rect.x, rect.y, rect.w, rect.h, fmt.externalformat, fmt.type, pixels);
+		else
+			glTexSubImage3D(gltarget, mipmap, rect.x, rect.y, slice, rect.w, rect.h, 1, fmt.externalformat, fmt.type, pixels);
+	}
+
+	if (generateMipmaps)
+		glGenerateMipmap(gltype);
+
+	glBindTexture(gltype, 0);
+
+	// The pixels aren't needed once they've been submitted.
+	data.set(nullptr);
+}
+
+void TextureUploadJob::completed()
+{
+	gl.resetTextureBinding(texture);
+}
+
+BufferUploadJob::BufferUploadJob(GLuint buffer, GLuint texelbuffer, size_t offset, Data *data, size_t size)
+	: buffer(buffer)
+	, texelBuffer(texelbuffer)
+	, offset(offset)
+	, data(data)
+	, size(size)
+{
+}
+
+BufferUploadJob::~BufferUploadJob()
+{
+}
+
+void BufferUploadJob::run()
+{
+	glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+	glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr) offset, (GLsizeiptr) size, data->getData());
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+	data.set(nullptr);
+}
+
+void BufferUploadJob::completed()
+{
+	gl.resetBufferBinding(buffer);
+	if (texelBuffer != 0)
+		gl.resetTextureBinding(texelBuffer);
+}
+
+UploadThread::UploadThread(love::window::Window *window, void *context)
+	: window(window)
+	, context(context)
+	, stopping(false)
+	, contextState(CONTEXT_PENDING)
+{
+	threadName = "GraphicsUpload";
+}
+
+UploadThread::~UploadThread()
+{
+}
+
+void UploadThread::threadFunction()
+{
+	// This can fail, for example with EGL when the window surface can't be
+	// current on two threads at once.
+	bool current = window->setSharedGLContextCurrent(context);
+
+	if (current)
+	{
+		// Matches the main context. See Graphics::setMode.
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	}
+
+	{
+		love::thread::Lock lock(mutex);
+		contextState = current ? CONTEXT_CURRENT : CONTEXT_FAILED;
+		contextReady->broadcast();
+	}
+
+	while (true)
+	{
+		UploadJob *job = nullptr;
+
+		{
+			love::thread::Lock lock(mutex);
+
+			while (!stopping && jobs.empty())
+				workAvailable->wait(mutex);
+
+			if (stopping)
+				break;
+
+			job = jobs.front();
+			jobs.pop_front();
+		}
+
+		if (current)
+		{
+			job->run();
+			job->finish(nullptr);
+		}
+		else
+			job->finish("The upload thread's OpenGL context could not be made current.");
+
+		job->release();
+	}
+
+	if (current)
+		window->setSharedGLContextCurrent(nullptr);
+}
+
+bool UploadThread::waitForContext()
+{
+	love::thread::Lock lock(mutex);
+
+	while (contextState == CONTEXT_PENDING)
+		contextReady->wait(mutex);
+
+	return contextState == CONTEXT_CURRENT;
+}
+
+void UploadThread::queue(UploadJob *job)
+{
+	love::thread::Lock lock(mutex);
+
+	job->retain();
+	jobs.push_back(job);
+	workAvailable->signal();
+}
+
+void UploadThread::stop()
+{
+	std::deque<UploadJob *> cancelled;
+
+	{
+		love::thread::Lock lock(mutex);
+		stopping = true;
+		workAvailable->broadcast();
+		std::swap(cancelled, jobs);
+	}
+
+	wait();
+
+	for (UploadJob *job : cancelled)
+	{
+		job->finish("The upload was cancelled because the OpenGL context was destroyed.");
+		job->release();
+	}
+
+	window->destroySharedGLContext(context);
+	context = nullptr;
+}
+
+TextureUpload::TextureUpload(love::graphics::Texture *texture, UploadJob *job)
+	: love::graphics::TextureUpload(texture, nullptr)
+	, job(job)
+{
+}
+
+TextureUpload::~TextureUpload()
+{
+}
+
+bool TextureUpload::isComplete()
+{
+	if (!job->isComplete())
+		return false;
+
+	if (job->hasError())
+		throw love::Exception("Could not upload texture data: %s", job->getError().c_str());
+
+	return true;
+}
+
+BufferUpload::BufferUpload(love::graphics::Buffer *buffer, UploadJob *job)
+	: love::graphics::BufferUpload(buffer)
+	, job(job)
+{
+}
+
+BufferUpload::~BufferUpload()
+{
+}
+
+bool BufferUpload::isComplete()
+{
+	if (!job->isComplete())
+		return false;
+
+	if (job->hasError())
+		throw love::Exception("Could not upload buffer data: %s", job->getError().c_str());
+
+	return true;
+}
+
+} // opengl
+} // graphics
+} // love
@@ -0,0 +1,239 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/Object.h"
+#include "common/Data.h"
+#include "common/pixelformat.h"
+#include "thread/threads.h"
+#include "image/ImageDataBase.h"
+#include "graphics/Texture.h"
+#include "graphics/Buffer.h"
+#include "FenceSync.h"
+
+// C++
+#include <deque>
+#include <string>
+
+namespace love
+{
+
+namespace window
+{
+class Window;
+}
+
+namespace graphics
+{
+namespace opengl
+{
+
+/**
+ * Data which is copied into a GL texture or buffer object on the
+ * UploadThread. Everything except run() and finish() is called on the main
+ * thread.
+ **/
+class UploadJob : public love::Object
+{
+public:
+
+	UploadJob();
+	virtual ~UploadJob();
+
+	/**
+	 * Whether the upload thread is done with the job and the GPU has executed
+	 * its commands. Doesn't block.
+	 **/
+	bool isComplete();
+
+	/**
+	 * Blocks until the job is complete.
+	 **/
+	void wait();
+
+	/**
+	 * Whether the job completed without uploading its data. Only valid once
+	 * the job is complete.
+	 **/
+	bool hasError() const { return !error.empty(); }
+	const std::string &getError() const { return error; }
+
+	// Called on the upload thread, with its context current.
+	virtual void run() = 0;
+
+	/**
+	 * Marks the job as finished. A non-null error means nothing was uploaded.
+	 **/
+	void finish(const char *error);
+
+protected:
+
+	// Called on the main thread once the job is complete. Objects changed by
+	// another context must be bound again for the changes to be visible.
+	virtual void completed() = 0;
+
+private:
+
+	FenceSync fence;
+	bool finished;
+	bool complete;
+	std::string error;
+
+	love::thread::MutexRef mutex;
+	love::thread::ConditionalRef finishedCond;
+
+}; // UploadJob
+
+class TextureUploadJob final : public UploadJob
+{
+public:
+
+	TextureUploadJob(GLuint texture, TextureType textype, PixelFormat format, love::image::ImageDataBase *data, int slice, int mipmap, const Rect &rect, bool generatemipmaps);
+	virtual ~TextureUploadJob();
+
+	void run() override;
+
+protected:
+
+	void completed() override;
+
+private:
+
+	GLuint texture;
+	TextureType texType;
+	PixelFormat format;
+	StrongRef<love::image::ImageDataBase> data;
+	int slice;
+	int mipmap;
+	Rect rect;
+	bool generateMipmaps;
+
+}; // TextureUploadJob
+
+class BufferUploadJob final : public UploadJob
+{
+public:
+
+	BufferUploadJob(GLuint buffer, GLuint texelbuffer, size_t offset, Data *data, size_t size);
+	virtual ~BufferUploadJob();
+
+	void run() override;
+
+protected:
+
+	void completed() override;
+
+private:
+
+	GLuint buffer;
+	GLuint texelBuffer;
+	size_t offset;
+	StrongRef<Data> data;
+	size_t size;
+
+}; // BufferUploadJob
+
+/**
+ * A thread with its own OpenGL context, which shares objects with the main
+ * context. Texture and buffer data is copied there so the main thread doesn't
+ * have to wait for it, and each job is followed by a fence which the main
+ * thread checks before the object is used.
+ **/
+class UploadThread final : public love::thread::Threadable
+{
+public:
+
+	UploadThread(love::window::Window *window, void *context);
+	virtual ~UploadThread();
+
+	void threadFunction() override;
+
+	/**
+	 * Waits until the thread has tried to make its context current, and
+	 * returns whether it succeeded. If not, the thread must be stopped.
+	 **/
+	bool waitForContext();
+
+	void queue(UploadJob *job);
+
+	/**
+	 * Stops the thread and destroys its context. Jobs which haven't run yet
+	 * finish with an error.
+	 **/
+	void stop();
+
+private:
+
+	love::window::Window *window;
+	void *context;
+
+	std::deque<UploadJob *> jobs;
+	bool stopping;
+
+	enum ContextState
+	{
+		CONTEXT_PENDING,
+		CONTEXT_CURRENT,
+		CONTEXT_FAILED,
+	};
+
+	ContextState contextState;
+	love::thread::ConditionalRef contextReady;
+
+	love::thread::MutexRef mutex;
+	love::thread::ConditionalRef workAvailable;
+
+}; // UploadThread
+
+class TextureUpload final : public love::graphics::TextureUpload
+{
+public:
+
+	TextureUpload(love::graphics::Texture *texture, UploadJob *job);
+	virtual ~TextureUpload();
+
+	bool isComplete() override;
+
+private:
+
+	StrongRef<UploadJob> job;
+
+}; // TextureUpload
+
+class BufferUpload final : public love::graphics::BufferUpload
+{
+public:
+
+	BufferUpload(love::graphics::Buffer *buffer, UploadJob *job);
+	virtual ~BufferUpload();
+
+	bool isComplete() override;
+
+private:
+
+	StrongRef<UploadJob> job;
+
+}; // BufferUpload
+
+} // opengl
+} // graphics
+} // love
@@ -20,6 +20,15 @@
 
 #include "vertex.h"
 #include "common/StringMap.h"
+#include "common/config.h"
+
+#if defined(LOVE_SIMD_SSE)
+#include <xmmintrin.h>
+#endif
+
+#if defined(LOVE_SIMD_NEON)
+#include <arm_neon.h>
+#endif
 
 namespace love
 {
@@ -273,6 +282,91 @@ void fillIndices(TriangleIndexMode mode, uint32 vertexStart, uint32 vertexCount,
 	fillIndicesT(mode, vertexStart, vertexCount, indices);
 }
 
+// Writes the x, y, s, t and color members, which the vertex types used here
+// all start with.
+template <typename T>
+static void fillQuadVerticesT(const Matrix4 &m, const Vector2 *positions, const Vector2 *texcoords, Color32 color, T *vertices)
+{
+	const float *e = m.getElements();
+	const float *p = (const float *) positions;
+	const float *st = (const float *) texcoords;
+
+#if defined(LOVE_SIMD_SSE)
+
+	// Two corners per register, as x0 y0 x1 y1.
+	const __m128 cx = _mm_setr_ps(e[0], e[1], e[0], e[1]);
+	const __m128 cy = _mm_setr_ps(e[4], e[5], e[4], e[5]);
+	const __m128 ct = _mm_setr_ps(e[12], e[13], e[12], e[13]);
+
+	__m128 p01 = _mm_loadu_ps(&p[0]);
+	__m128 p23 = _mm_loadu_ps(&p[4]);
+
+	__m128 x01 = _mm_shuffle_ps(p01, p01, _MM_SHUFFLE(2, 2, 0, 0));
+	__m128 y01 = _mm_shuffle_ps(p01, p01, _MM_SHUFFLE(3, 3, 1, 1));
+	__m128 x23 = _mm_shuffle_ps(p23, p23, _MM_SHUFFLE(2, 2, 0, 0));
+	__m128 y23 = _mm_shuffle_ps(p23, p23, _MM_SHUFFLE(3, 3, 1, 1));
+
+	p01 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x01, cx), _mm_mul_ps(y01, cy)), ct);
+	p23 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x23, cx), _mm_mul_ps(y23, cy)), ct);
+
+	__m128 st01 = _mm_loadu_ps(&st[0]);
+	__m128 st23 = _mm_loadu_ps(&st[4]);
+
+	// x y s t for each corner.
+	_mm_storeu_ps(&vertices[0].x, _mm_movelh_ps(p01, st01));
+	_mm_storeu_ps(&vertices[1].x, _mm_movehl_ps(st01, p01));
+	_mm_storeu_ps(&vertices[2].x, _mm_movelh_ps(p23, st23));
+	_mm_storeu_ps(&vertices[3].x, _mm_movehl_ps(st23, p23));
+
+#elif defined(LOVE_SIMD_NEON)
+
+	// Deinterleaves into four x and four y values.
+	float32x4x2_t pos = vld2q_f32(p);
+	float32x4x2_t tc = vld2q_f32(st);
+
+	float32x4x4_t v;
+	v.val[0] = vmlaq_n_f32(vmlaq_n_f32(vdupq_n_f32(e[12]), pos.val[0], e[0]), pos.val[1], e[4]);
+	v.val[1] = vmlaq_n_f32(vmlaq_n_f32(vdupq_n_f32(e[13]), pos.val[0], e[1]), pos.val[1], e[5]);
+	v.val[2] = tc.val[0];
+	v.val[3] = tc.val[1];
+
+	// x y s t for each corner.
+	vst4q_lane_f32(&vertices[0].x, v, 0);
+	vst4q_lane_f32(&vertices[1].x, v, 1);
+	vst4q_lane_f32(&vertices[2].x, v, 2);
+	vst4q_lane_f32(&vertices[3].x, v, 3);
+
+#else
+
+	for (int i = 0; i < 4; i++)
+	{
+		vertices[i].x = (e[0]*p[i * 2]) + (e[4]*p[i * 2 + 1]) + (e[12]);
+		vertices[i].y = (e[1]*p[i * 2]) + (e[5]*p[i * 2 + 1]) + (e[13]);
+		vertices[i].s = st[i * 2 + 0];
+		vertices[i].t = st[i * 2 + 1];
+	}
+
+#endif
+
+	for (int i = 0; i < 4; i++)
+		vertices[i].color = color;
+}
+
+void fillQuadVertices(const Matrix4 &m, const Vector2 *positions, const Vector2 *texcoords, Color32 color, XYf_STf_RGBAub *vertices)
+{
+	static_assert(offsetof(XYf_STf_RGBAub, t) == sizeof(float) * 3, "x, y, s and t must be contiguous");
+	fillQuadVerticesT(m, positions, texcoords, color, vertices);
+}
+
+void fillQuadVertices(const Matrix4 &m, const Vector2 *positions, const Vector2 *texcoords, float layer, Color32 color, XYf_STPf_RGBAub *vertices)
+{
+	static_assert(offsetof(XYf_STPf_RGBAub, t) == sizeof(float) * 3, "x, y, s and t must be contiguous");
+	fillQuadVerticesT(m, positions, texcoords, color, vertices);
+
+	for (int i = 0; i < 4; i++)
+		vertices[i].p = layer;
+}
+
 void VertexAttributes::setCommonFormat(CommonFormat format, uint8 bufferindex)
 {
 	setBufferLayout(bufferindex, (uint16) getFormatStride(format));
@@ -23,6 +23,8 @@
 // LOVE
 #include "common/int.h"
 #include "common/Color.h"
+#include "common/Matrix.h"
+#include "common/Vector.h"
 #include "common/StringMap.h"
 
 // C
@@ -402,6 +404,13 @@ int getIndexCount(TriangleIndexMode mode, int vertexCount);
 void fillIndices(TriangleIndexMode mode, uint16 vertexStart, uint16 vertexCount, uint16 *indices);
 void fillIndices(TriangleIndexMode mode, uint32 vertexStart, uint32 vertexCount, uint32 *indices);
 
+/**
+ * Transforms the 4 corners of a quad and writes them along with their texture
+ * coordinates and color as interleaved vertices, using SIMD when possible.
+ **/
+void fillQuadVertices(const Matrix4 &m, const Vector2 *positions, const Vector2 *texcoords, Color32 color, XYf_STf_RGBAub *vertices);
+void fillQuadVertices(const Matrix4 &m, const Vector2 *positions, const Vector2 *texcoords, float layer, Color32 color, XYf_STPf_RGBAub *vertices);
+
 STRINGMAP_DECLARE(BuiltinVertexAttribute);
 STRINGMAP_DECLARE(BufferUsage);
 STRINGMAP_DECLARE(IndexDataType);
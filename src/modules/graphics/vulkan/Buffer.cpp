@@ -55,12 +55,60 @@ static VkBufferUsageFlags getVulkanUsageFlags(BufferUsageFlags flags)
 	return vkFlags;
 }
 
+BufferPageAllocator::BufferPageAllocator(Graphics *vgfx)
+	: BufferSubAllocator(love::graphics::Buffer::SUBALLOCATION_PAGE_SIZE, love::graphics::Buffer::SUBALLOCATION_ALIGNMENT)
+	, vgfx(vgfx)
+{
+}
+
+BufferPageAllocator::~BufferPageAllocator()
+{
+	for (int i = 0; i < (int) pages.size(); i++)
+	{
+		if (pages[i].buffer != VK_NULL_HANDLE)
+			destroyPage(i);
+	}
+}
+
+bool BufferPageAllocator::createPage(int index, size_t size)
+{
+	VkBufferCreateInfo bufferInfo{};
+	bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	bufferInfo.size = size;
+	bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
+	vgfx->setQueueFamilySharing(bufferInfo.sharingMode, bufferInfo.queueFamilyIndexCount, bufferInfo.pQueueFamilyIndices);
+
+	// No user data, so defragmentation leaves pages alone.
+	VmaAllocationCreateInfo allocCreateInfo{};
+	allocCreateInfo.usage = VMA_MEMORY_USAGE_AUTO;
+	allocCreateInfo.flags = vgfx->getBudgetAllocationFlags();
+
+	Page page;
+	if (vmaCreateBuffer(vgfx->getVmaAllocator(), &bufferInfo, &allocCreateInfo, &page.buffer, &page.allocation, nullptr) != VK_SUCCESS)
+		return false;
+
+	if ((size_t) index >= pages.size())
+		pages.resize(index + 1);
+
+	pages[index] = page;
+	return true;
+}
+
+void BufferPageAllocator::destroyPage(int index)
+{
+	// Allocations are only released once the GPU is done with them (see
+	// Buffer::unloadVolatile), so an empty page can be destroyed right away.
+	vmaDestroyBuffer(vgfx->getVmaAllocator(), pages[index].buffer, pages[index].allocation);
+	pages[index] = Page();
+}
+
 Buffer::Buffer(love::graphics::Graphics *gfx, const Settings &settings, const std::vector<DataDeclaration> &format, const void *data, size_t size, size_t arraylength)
 	: love::graphics::Buffer(gfx, settings, format, size, arraylength)
 	, zeroInitialize(settings.zeroInitialize)
 	, initialData(data)
 	, vgfx(dynamic_cast<Graphics*>(gfx))
 	, usageFlags(settings.usageFlags)
+	, subAllocatable(isSubAllocatable(settings, getSize()))
 {
 	loadVolatile();
 }
@@ -69,17 +117,45 @@ bool Buffer::loadVolatile()
 {
 	allocator = vgfx->getVmaAllocator();
 
+	BufferPageAllocator *pages = subAllocatable ? vgfx->getBufferPageAllocator() : nullptr;
+	if (pages != nullptr && pages->allocate(getSize(), subAllocation))
+	{
+		buffer = pages->getPageBuffer(subAllocation.page);
+		allocation = VK_NULL_HANDLE;
+		coherent = false;
+
+		// The allocation size is a multiple of 4, as vkCmdFillBuffer needs.
+		if (zeroInitialize)
+			vkCmdFillBuffer(vgfx->getCommandBufferForDataTransfer(), buffer, subAllocation.offset, subAllocation.size, 0);
+
+		if (initialData)
+			fill(0, size, initialData);
+
+		return true;
+	}
+
 	VkBufferCreateInfo bufferInfo{};
 	bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
 	bufferInfo.size = getSize();
 	bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | getVulkanUsageFlags(usageFlags);
+	vgfx->setQueueFamilySharing(bufferInfo.sharingMode, bufferInfo.queueFamilyIndexCount, bufferInfo.pQueueFamilyIndices);
 
 	VmaAllocationCreateInfo allocCreateInfo{};
 	allocCreateInfo.usage = VMA_MEMORY_USAGE_AUTO;
 	if (dataUsage == BUFFERDATAUSAGE_READBACK)
 		allocCreateInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+	allocCreateInfo.flags |= vgfx->getBudgetAllocationFlags();
+	allocCreateInfo.pUserData = this;
 
 	auto result = vmaCreateBuffer(allocator, &bufferInfo, &allocCreateInfo, &buffer, &allocation, &allocInfo);
+	if (result == VK_ERROR_OUT_OF_DEVICE_MEMORY && (allocCreateInfo.flags & VMA_ALLOCATION_CREATE_WITHIN_BUDGET_BIT))
+	{
+		// Over budget: free what we can and let the driver decide.
+		vgfx->purgeUnusedTemporaryResources();
+		allocCreateInfo.flags &= ~VMA_ALLOCATION_CREATE_WITHIN_BUDGET_BIT;
+		result = vmaCreateBuffer(allocator, &bufferInfo, &allocCreateInfo, &buffer, &allocation, &allocInfo);
+	}
+
 	if (result != VK_SUCCESS)
 		throw love::Exception("failed to create buffer");
 
@@ -128,8 +204,25 @@ void Buffer::unloadVolatile()
 	if (buffer == VK_NULL_HANDLE)
 		return;
 
+	if (subAllocation.isValid())
+	{
+		// Other buffers may be placed in the same range once it's released,
+		// so wait until the GPU is done with it.
+		vgfx->queueCleanUp([pages=vgfx->getBufferPageAllocator(), suballocation=subAllocation]() mutable {
+			pages->deallocate(suballocation);
+		});
+
+		subAllocation = BufferSubAllocator::Allocation();
+		buffer = VK_NULL_HANDLE;
+		return;
+	}
+
 	auto device = vgfx->getDevice();
 
+	// The allocation outlives this object until the cleanup runs, so make
+	// sure defragmentation doesn't try to move it.
+	vmaSetAllocationUserData(allocator, allocation, nullptr);
+
 	vgfx->queueCleanUp(
 		[device=device, allocator=allocator, buffer=buffer, allocation=allocation, bufferView=bufferView](){
 		vkDeviceWaitIdle(device);
@@ -157,6 +250,50 @@ ptrdiff_t Buffer::getTexelBufferHandle() const
 	return (ptrdiff_t) bufferView;
 }
 
+bool Buffer::isMovable() const
+{
+	const uint32 descriptorflags = BUFFERUSAGEFLAG_TEXEL | BUFFERUSAGEFLAG_SHADER_STORAGE | (1u << BUFFERUSAGE_UNIFORM);
+	return buffer != VK_NULL_HANDLE && !subAllocation.isValid() && (usageFlags & descriptorflags) == 0 && !isMapped();
+}
+
+bool Buffer::beginMove(VkCommandBuffer commandBuffer, VmaAllocation dstallocation)
+{
+	VkBufferCreateInfo bufferInfo{};
+	bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	bufferInfo.size = getSize();
+	bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | getVulkanUsageFlags(usageFlags);
+	vgfx->setQueueFamilySharing(bufferInfo.sharingMode, bufferInfo.queueFamilyIndexCount, bufferInfo.pQueueFamilyIndices);
+
+	VkBuffer newbuffer = VK_NULL_HANDLE;
+	if (vkCreateBuffer(vgfx->getDevice(), &bufferInfo, nullptr, &newbuffer) != VK_SUCCESS)
+		return false;
+
+	if (vmaBindBufferMemory(allocator, dstallocation, newbuffer) != VK_SUCCESS)
+	{
+		vkDestroyBuffer(vgfx->getDevice(), newbuffer, nullptr);
+		return false;
+	}
+
+	VkBufferCopy region{};
+	region.size = getSize();
+	vkCmdCopyBuffer(commandBuffer, buffer, newbuffer, 1, &region);
+
+	movedFromBuffer = buffer;
+	buffer = newbuffer;
+	return true;
+}
+
+void Buffer::finishMove()
+{
+	vkDestroyBuffer(vgfx->getDevice(), movedFromBuffer, nullptr);
+	movedFromBuffer = VK_NULL_HANDLE;
+}
+
+void Buffer::updateAllocationInfo()
+{
+	vmaGetAllocationInfo(allocator, allocation, &allocInfo);
+}
+
 void *Buffer::map(MapType map, size_t offset, size_t size)
 {
 	if (size == 0)
@@ -183,19 +320,8 @@ void *Buffer::map(MapType map, size_t offset, size_t size)
 	}
 	else
 	{
-		VkBufferCreateInfo bufferInfo{};
-		bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-		bufferInfo.size = size;
-		bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-
-		VmaAllocationCreateInfo allocInfo{};
-		allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
-		allocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
-
-		if (vmaCreateBuffer(allocator, &bufferInfo, &allocInfo, &stagingBuffer, &stagingAllocation, &stagingAllocInfo) != VK_SUCCESS)
-			throw love::Exception("failed to create staging buffer");
-
-		return stagingAllocInfo.pMappedData;
+		staging = vgfx->allocateStagingMemory(size, 4);
+		return staging.data;
 	}
 }
 
@@ -207,39 +333,17 @@ bool Buffer::fill(size_t offset, size_t size, const void *data)
 	if (!Range(0, getSize()).contains(Range(offset, size)))
 		return false;
 
-	VkBufferCreateInfo bufferInfo{};
-	bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-	bufferInfo.size = size;
-	bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-
-	VmaAllocationCreateInfo allocInfo{};
-	allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
-	allocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
-
-	VkBuffer fillBuffer;
-	VmaAllocation fillAllocation;
-	VmaAllocationInfo fillAllocInfo;
-
-	if (vmaCreateBuffer(allocator, &bufferInfo, &allocInfo, &fillBuffer, &fillAllocation, &fillAllocInfo) != VK_SUCCESS)
-		throw love::Exception("failed to create fill buffer");
+	StagingAllocation fillStaging = vgfx->allocateStagingMemory(size, 4);
 
-	memcpy(fillAllocInfo.pMappedData, data, size);
-
-	VkMemoryPropertyFlags memoryProperties;
-	vmaGetAllocationMemoryProperties(allocator, fillAllocation, &memoryProperties);
-	if (~memoryProperties & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)
-		vmaFlushAllocation(allocator, fillAllocation, 0, size);
+	memcpy(fillStaging.data, data, size);
+	vgfx->flushStagingMemory(fillStaging, 0, size);
 
 	VkBufferCopy bufferCopy{};
-	bufferCopy.srcOffset = 0;
-	bufferCopy.dstOffset = offset;
+	bufferCopy.srcOffset = fillStaging.offset;
+	bufferCopy.dstOffset = subAllocation.offset + offset;
 	bufferCopy.size = size;
 
-	vkCmdCopyBuffer(vgfx->getCommandBufferForDataTransfer(), fillBuffer, buffer, 1, &bufferCopy);
-
-	vgfx->queueCleanUp([allocator = allocator, fillBuffer = fillBuffer, fillAllocation = fillAllocation]() {
-		vmaDestroyBuffer(allocator, fillBuffer, fillAllocation);
-	});
+	vkCmdCopyBuffer(vgfx->getCommandBufferForDataTransfer(), fillStaging.buffer, buffer, 1, &bufferCopy);
 
 	return true;
 }
@@ -248,27 +352,22 @@ void Buffer::unmap(size_t usedoffset, size_t usedsize)
 {
 	if (dataUsage != BUFFERDATAUSAGE_READBACK)
 	{
+		VkDeviceSize mappedOffset = usedoffset - mappedRange.getOffset();
+
 		VkBufferCopy bufferCopy{};
-		bufferCopy.srcOffset = usedoffset - mappedRange.getOffset();
-		bufferCopy.dstOffset = usedoffset;
+		bufferCopy.srcOffset = staging.offset + mappedOffset;
+		bufferCopy.dstOffset = subAllocation.offset + usedoffset;
 		bufferCopy.size = usedsize;
 
-		VkMemoryPropertyFlags memoryProperties;
-		vmaGetAllocationMemoryProperties(allocator, stagingAllocation, &memoryProperties);
-		if (~memoryProperties & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)
-			vmaFlushAllocation(allocator, stagingAllocation, bufferCopy.srcOffset, usedsize);
+		vgfx->flushStagingMemory(staging, mappedOffset, usedsize);
 
-		vkCmdCopyBuffer(vgfx->getCommandBufferForDataTransfer(), stagingBuffer, buffer, 1, &bufferCopy);
-
-		vgfx->queueCleanUp([allocator = allocator, stagingBuffer = stagingBuffer, stagingAllocation = stagingAllocation]() {
-			vmaDestroyBuffer(allocator, stagingBuffer, stagingAllocation);
-		});
+		vkCmdCopyBuffer(vgfx->getCommandBufferForDataTransfer(), staging.buffer, buffer, 1, &bufferCopy);
 	}
 }
 
 void Buffer::clearInternal(size_t offset, size_t size)
 {
-	vkCmdFillBuffer(vgfx->getCommandBufferForDataTransfer(), buffer, offset, size, 0);
+	vkCmdFillBuffer(vgfx->getCommandBufferForDataTransfer(), buffer, subAllocation.offset + offset, size, 0);
 }
 
 void Buffer::copyTo(love::graphics::Buffer *dest, size_t sourceoffset, size_t destoffset, size_t size)
@@ -276,8 +375,8 @@ void Buffer::copyTo(love::graphics::Buffer *dest, size_t sourceoffset, size_t de
 	auto commandBuffer = vgfx->getCommandBufferForDataTransfer();
 
 	VkBufferCopy bufferCopy{};
-	bufferCopy.srcOffset = sourceoffset;
-	bufferCopy.dstOffset = destoffset;
+	bufferCopy.srcOffset = subAllocation.offset + sourceoffset;
+	bufferCopy.dstOffset = dest->getHandleOffset() + destoffset;
 	bufferCopy.size = size;
 
 	vkCmdCopyBuffer(commandBuffer, buffer, (VkBuffer) dest->getHandle(), 1, &bufferCopy);
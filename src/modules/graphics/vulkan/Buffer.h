@@ -23,8 +23,10 @@
 #include "common/Range.h"
 
 #include "graphics/Buffer.h"
+#include "graphics/BufferSubAllocator.h"
 #include "graphics/Volatile.h"
 
+#include "Vulkan.h"
 #include "VulkanWrapper.h"
 
 
@@ -37,6 +39,36 @@ namespace vulkan
 
 class Graphics;
 
+/**
+ * Shared VkBuffers which small Buffers are placed in.
+ **/
+class BufferPageAllocator final : public BufferSubAllocator
+{
+public:
+
+	BufferPageAllocator(Graphics *vgfx);
+	virtual ~BufferPageAllocator();
+
+	VkBuffer getPageBuffer(int page) const { return pages[page].buffer; }
+
+protected:
+
+	bool createPage(int index, size_t size) override;
+	void destroyPage(int index) override;
+
+private:
+
+	struct Page
+	{
+		VkBuffer buffer = VK_NULL_HANDLE;
+		VmaAllocation allocation = VK_NULL_HANDLE;
+	};
+
+	Graphics *vgfx;
+	std::vector<Page> pages;
+
+}; // BufferPageAllocator
+
 class Buffer final
 	: public love::graphics::Buffer
 	, public Volatile
@@ -53,8 +85,16 @@ public:
 	bool fill(size_t offset, size_t size, const void *data) override;
 	void copyTo(love::graphics::Buffer *dest, size_t sourceoffset, size_t destoffset, size_t size) override;
 	ptrdiff_t getHandle() const override;
+	size_t getHandleOffset() const override { return subAllocation.offset; }
 	ptrdiff_t getTexelBufferHandle() const override;
 
+	// Used by Graphics::defragmentMemory. Buffers which are referenced by
+	// descriptor sets can't be moved, since those hold on to the VkBuffer.
+	bool isMovable() const;
+	bool beginMove(VkCommandBuffer commandBuffer, VmaAllocation dstallocation);
+	void finishMove();
+	void updateAllocationInfo();
+
 private:
 
 	void clearInternal(size_t offset, size_t size) override;
@@ -62,17 +102,18 @@ private:
 	bool zeroInitialize;
 	const void *initialData;
 	VkBuffer buffer = VK_NULL_HANDLE;
-	VkBuffer stagingBuffer = VK_NULL_HANDLE;
+	VkBuffer movedFromBuffer = VK_NULL_HANDLE;
 	VkBufferView bufferView = VK_NULL_HANDLE;
 	Graphics *vgfx = nullptr;
 	VmaAllocator allocator;
 	VmaAllocation allocation;
-	VmaAllocation stagingAllocation;
 	VmaAllocationInfo allocInfo;
-	VmaAllocationInfo stagingAllocInfo;
+	StagingAllocation staging;
 	BufferUsageFlags usageFlags;
 	Range mappedRange;
 	bool coherent;
+	bool subAllocatable;
+	BufferSubAllocator::Allocation subAllocation;
 };
 
 } // vulkan
@@ -22,7 +22,10 @@
 #include "common/pixelformat.h"
 #include "common/version.h"
 #include "common/memory.h"
+#include "common/profiler.h"
 #include "window/Window.h"
+#include "timer/Timer.h"
+#include "filesystem/Filesystem.h"
 #include "Buffer.h"
 #include "Graphics.h"
 #include "GraphicsReadback.h"
@@ -75,6 +78,36 @@ VmaAllocator Graphics::getVmaAllocator() const
 	return vmaAllocator;
 }
 
+BufferPageAllocator *Graphics::getBufferPageAllocator()
+{
+	if (bufferPageAllocator.get() == nullptr)
+		bufferPageAllocator.reset(new BufferPageAllocator(this));
+	return bufferPageAllocator.get();
+}
+
+void Graphics::setQueueFamilySharing(VkSharingMode &mode, uint32_t &count, const uint32_t *&indices) const
+{
+	if (computeQueue != VK_NULL_HANDLE)
+	{
+		mode = VK_SHARING_MODE_CONCURRENT;
+		count = 2;
+		indices = sharedQueueFamilies;
+	}
+	else
+	{
+		mode = VK_SHARING_MODE_EXCLUSIVE;
+		count = 0;
+		indices = nullptr;
+	}
+}
+
+VmaAllocationCreateFlags Graphics::getBudgetAllocationFlags() const
+{
+	if (optionalDeviceExtensions.memoryBudget)
+		return VMA_ALLOCATION_CREATE_WITHIN_BUDGET_BIT;
+	return 0;
+}
+
 static void checkOptionalInstanceExtensions(OptionalInstanceExtensions& ext)
 {
 	uint32_t count;
@@ -96,6 +129,7 @@ static void checkOptionalInstanceExtensions(OptionalInstanceExtensions& ext)
 
 Graphics::Graphics()
 	: love::graphics::Graphics("love.graphics.vulkan")
+	, framesInFlight((uint32_t) std::min(std::max(love::graphics::getFramesInFlight(), 1), (int) MAX_FRAMES_IN_FLIGHT))
 {
 	if (SDL_Vulkan_LoadLibrary(nullptr))
 		throw love::Exception("could not find vulkan");
@@ -425,38 +459,56 @@ void Graphics::submitGpuCommands(SubmitMode submitMode, void *screenshotCallback
 	VkSubmitInfo submitInfo{};
 	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 
-	VkSemaphore waitSemaphores[] = { imageAvailableSemaphores.at(currentFrame) };
-	VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT };
+	VkSemaphore waitSemaphores[2] = {};
+	VkPipelineStageFlags waitStages[2] = {};
 
 	if (imageRequested)
 	{
-		submitInfo.waitSemaphoreCount = 1;
-		submitInfo.pWaitSemaphores = waitSemaphores;
-		submitInfo.pWaitDstStageMask = waitStages;
+		waitSemaphores[submitInfo.waitSemaphoreCount] = imageAvailableSemaphores.at(currentFrame);
+		waitStages[submitInfo.waitSemaphoreCount] = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+		submitInfo.waitSemaphoreCount++;
 		imageRequested = false;
 	}
 
+	if (!computeFinishedPending.empty() && computeFinishedPending[currentFrame])
+	{
+		waitSemaphores[submitInfo.waitSemaphoreCount] = computeFinishedSemaphores.at(currentFrame);
+		waitStages[submitInfo.waitSemaphoreCount] = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+		submitInfo.waitSemaphoreCount++;
+		computeFinishedPending[currentFrame] = false;
+	}
+
+	submitInfo.pWaitSemaphores = waitSemaphores;
+	submitInfo.pWaitDstStageMask = waitStages;
+
 	submitInfo.commandBufferCount = static_cast<uint32_t>(submitCommandbuffers.size());
 	submitInfo.pCommandBuffers = submitCommandbuffers.data();
 
-	VkSemaphore signalSemaphores[] = { renderFinishedSemaphores.at(currentFrame) };
+	VkSemaphore signalSemaphores[2] = {};
 
 	VkFence fence = VK_NULL_HANDLE;
 
 	if (submitMode == SUBMIT_PRESENT)
 	{
 		if (!swapChainImages.empty())
-		{
-			submitInfo.signalSemaphoreCount = 1;
-			submitInfo.pSignalSemaphores = signalSemaphores;
-		}
+			signalSemaphores[submitInfo.signalSemaphoreCount++] = renderFinishedSemaphores.at(currentFrame);
 
 		vkResetFences(device, 1, &inFlightFences[currentFrame]);
 		fence = inFlightFences[currentFrame];
 	}
 
+	if (computeCommandsRecording)
+		signalSemaphores[submitInfo.signalSemaphoreCount++] = graphicsToComputeSemaphores.at(currentFrame);
+
+	submitInfo.pSignalSemaphores = signalSemaphores;
+
 	if (vkQueueSubmit(graphicsQueue, 1, &submitInfo, fence) != VK_SUCCESS)
 		throw love::Exception("failed to submit draw command buffer");
+
+	// Async compute work goes after everything recorded this frame. When the
+	// CPU is about to wait for the GPU anyway, it's finished right away.
+	if (computeCommandsRecording)
+		submitComputeCommands(submitMode == SUBMIT_PRESENT && screenshotBuffer == VK_NULL_HANDLE);
 	
 	if (submitMode == SUBMIT_NOPRESENT || submitMode == SUBMIT_RESTART || screenshotBuffer != VK_NULL_HANDLE)
 	{
@@ -537,6 +589,8 @@ void Graphics::present(void *screenshotCallbackdata)
 	if (!isActive())
 		return;
 
+	LOVE_PROFILE_ZONE("Graphics::present");
+
 	if (isRenderTargetActive())
 		throw love::Exception("present cannot be called while a render target is active.");
 
@@ -545,6 +599,10 @@ void Graphics::present(void *screenshotCallbackdata)
 
 	deprecations.draw(this);
 
+	endGPUTimerFrame();
+	if (!gpuTimerFrames.empty())
+		gpuTimerFrames.at(currentFrame).pending = gpuTimerFrames.at(currentFrame).timer.timestampCount > 0;
+
 	submitGpuCommands(SUBMIT_PRESENT, screenshotCallbackdata);
 
 	VkResult result = VK_SUCCESS;
@@ -559,7 +617,9 @@ void Graphics::present(void *screenshotCallbackdata)
 		presentInfo.pSwapchains = &swapChain;
 		presentInfo.pImageIndices = &imageIndex;
 
+		double presentstart = timer::Timer::getTime();
 		result = vkQueuePresentKHR(presentQueue, &presentInfo);
+		presentTime = timer::Timer::getTime() - presentstart;
 	}
 	else
 	{
@@ -591,17 +651,22 @@ void Graphics::present(void *screenshotCallbackdata)
 	drawCallsBatched = 0;
 
 	updatePendingReadbacks();
+	updatePendingUploads();
+	updateStreamingTextures();
+	updateVirtualTextures();
 	updateTemporaryResources();
+	FrameArena::getInstance().reset();
 
 	frameCounter++;
-	currentFrame = (currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
+	currentFrame = (currentFrame + 1) % framesInFlight;
 
 	beginFrame();
 }
 
 void Graphics::backbufferChanged(int width, int height, int pixelwidth, int pixelheight, bool backbufferstencil, bool backbufferdepth, int msaa)
 {
-	if (swapChain != VK_NULL_HANDLE && (pixelwidth != this->pixelWidth || pixelheight != this->pixelHeight || width != this->width || height != this->height
+	// The swapchain only depends on the size in pixels, not the DPI-scaled size.
+	if (swapChain != VK_NULL_HANDLE && (pixelwidth != this->pixelWidth || pixelheight != this->pixelHeight
 		|| backbufferstencil != this->backbufferHasStencil || backbufferdepth != this->backbufferHasDepth || msaa != requestedMsaa))
 		requestSwapchainRecreation();
 
@@ -627,10 +692,12 @@ bool Graphics::setMode(void *context, int width, int height, int pixelwidth, int
 	backbufferChanged(width, height, pixelwidth, pixelheight, backbufferstencil, backbufferdepth, msaa);
 
 	cleanUpFunctions.clear();
-	cleanUpFunctions.resize(MAX_FRAMES_IN_FLIGHT);
+	cleanUpFunctions.resize(framesInFlight);
 
 	readbackCallbacks.clear();
-	readbackCallbacks.resize(MAX_FRAMES_IN_FLIGHT);
+	readbackCallbacks.resize(framesInFlight);
+
+	stagingFrames.resize(framesInFlight);
 
 	bool createBaseObjects = physicalDevice == VK_NULL_HANDLE;
 
@@ -658,6 +725,8 @@ bool Graphics::setMode(void *context, int width, int height, int pixelwidth, int
 		createCommandPool();
 		createCommandBuffers();
 		createSyncObjects();
+		createGPUTimerQueryPools();
+		createOcclusionQueryPools();
 	}
 
 	if (localUniformBuffer == nullptr)
@@ -710,7 +779,7 @@ bool Graphics::setMode(void *context, int width, int height, int pixelwidth, int
 			defaultVertexBuffer.set(newBuffer(settings, format, &data, sizeof(DefaultData), 1), Acquire::NORETAIN);
 
 			VkBuffer buffer = (VkBuffer)defaultVertexBuffer->getHandle();
-			VkDeviceSize offset = 0;
+			VkDeviceSize offset = defaultVertexBuffer->getHandleOffset();
 			vkCmdBindVertexBuffers(commandBuffers.at(currentFrame), DEFAULT_VERTEX_BUFFER_BINDING, 1, &buffer, &offset);
 		}
 
@@ -749,7 +818,10 @@ void Graphics::initCapabilities()
 	capabilities.features[FEATURE_TEXEL_BUFFER] = true;
 	capabilities.features[FEATURE_COPY_TEXTURE_TO_BUFFER] = true;
 	capabilities.features[FEATURE_INDIRECT_DRAW] = true;
-	static_assert(FEATURE_MAX_ENUM == 13, "Graphics::initCapabilities must be updated when adding a new graphics feature!");
+	capabilities.features[FEATURE_ASYNC_COMPUTE] = computeQueue != VK_NULL_HANDLE;
+	capabilities.features[FEATURE_OCCLUSION_QUERY] = true;
+	capabilities.features[FEATURE_BACKBUFFER_CAPTURE] = false;
+	static_assert(FEATURE_MAX_ENUM == 16, "Graphics::initCapabilities must be updated when adding a new graphics feature!");
 
 	VkPhysicalDeviceProperties properties;
 	vkGetPhysicalDeviceProperties(physicalDevice, &properties);
@@ -775,9 +847,103 @@ void Graphics::initCapabilities()
 	capabilities.textureTypes[TEXTURE_CUBE] = true;
 }
 
-void Graphics::getAPIStats(int &shaderswitches) const
+void Graphics::getAPIStats(Stats &stats) const
 {
-	shaderswitches = static_cast<int>(Vulkan::getNumShaderSwitches());
+	stats.shaderSwitches = static_cast<int>(Vulkan::getNumShaderSwitches());
+	stats.framebufferCacheSize = static_cast<int>(framebuffers.size());
+
+	if (vmaAllocator == VK_NULL_HANDLE)
+		return;
+
+	const VkPhysicalDeviceMemoryProperties *memoryProperties = nullptr;
+	vmaGetMemoryProperties(vmaAllocator, &memoryProperties);
+
+	// Without VK_EXT_memory_budget these are VMA's own estimates.
+	VmaBudget budgets[VK_MAX_MEMORY_HEAPS];
+	vmaGetHeapBudgets(vmaAllocator, budgets);
+
+	for (uint32 i = 0; i < memoryProperties->memoryHeapCount; i++)
+	{
+		MemoryHeapStats heap;
+		heap.usage = (int64) budgets[i].usage;
+		heap.budget = (int64) budgets[i].budget;
+		heap.deviceLocal = (memoryProperties->memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0;
+		stats.memoryHeaps.push_back(heap);
+	}
+}
+
+bool Graphics::defragmentMemory(int64 maxbytes, int64 &bytesmoved)
+{
+	bytesmoved = 0;
+
+	if (vmaAllocator == VK_NULL_HANDLE)
+		return true;
+
+	// Moved memory can't be in use by any pending GPU work.
+	submitGpuCommands(SUBMIT_RESTART);
+
+	VmaDefragmentationInfo defragInfo{};
+	defragInfo.flags = VMA_DEFRAGMENTATION_FLAG_ALGORITHM_FAST_BIT;
+	defragInfo.maxBytesPerPass = (VkDeviceSize) maxbytes;
+
+	VmaDefragmentationContext context = VK_NULL_HANDLE;
+	if (vmaBeginDefragmentation(vmaAllocator, &defragInfo, &context) != VK_SUCCESS)
+		return true;
+
+	VmaDefragmentationPassMoveInfo pass{};
+	VkResult result = vmaBeginDefragmentationPass(vmaAllocator, context, &pass);
+
+	std::vector<Buffer*> movedBuffers;
+
+	if (result == VK_INCOMPLETE)
+	{
+		VkCommandBuffer commandBuffer = getCommandBufferForDataTransfer();
+
+		VkMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		barrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+		for (uint32 i = 0; i < pass.moveCount; i++)
+		{
+			VmaDefragmentationMove &move = pass.pMoves[i];
+
+			VmaAllocationInfo allocInfo{};
+			vmaGetAllocationInfo(vmaAllocator, move.srcAllocation, &allocInfo);
+
+			// Only Buffers tag their allocations. Images are left alone since
+			// their views and framebuffers are cached in many places.
+			Buffer *buffer = (Buffer *) allocInfo.pUserData;
+			if (buffer != nullptr && buffer->isMovable() && buffer->beginMove(commandBuffer, move.dstTmpAllocation))
+				movedBuffers.push_back(buffer);
+			else
+				move.operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+		}
+
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+		submitGpuCommands(SUBMIT_RESTART);
+
+		for (Buffer *buffer : movedBuffers)
+			buffer->finishMove();
+
+		result = vmaEndDefragmentationPass(vmaAllocator, context, &pass);
+
+		for (Buffer *buffer : movedBuffers)
+			buffer->updateAllocationInfo();
+	}
+
+	VmaDefragmentationStats defragStats{};
+	vmaEndDefragmentation(vmaAllocator, context, &defragStats);
+
+	bytesmoved = (int64) defragStats.bytesMoved;
+
+	// With everything else ignored there may be moves left which will never
+	// happen, so stop once a pass can't make progress.
+	return result == VK_SUCCESS || movedBuffers.empty();
 }
 
 void Graphics::unSetMode()
@@ -788,6 +954,8 @@ void Graphics::unSetMode()
 
 	cleanupSwapChain();
 	vkDestroySurfaceKHR(instance, surface, nullptr);
+
+	savePipelineCache();
 }
 
 void Graphics::setActive(bool enable)
@@ -871,12 +1039,22 @@ void Graphics::draw(const DrawCommand &cmd)
 
 	if (cmd.indirectBuffer != nullptr)
 	{
-		vkCmdDrawIndirect(
-			commandBuffers.at(currentFrame),
-			(VkBuffer) cmd.indirectBuffer->getHandle(),
-			cmd.indirectBufferOffset,
-			1,
-			0);
+		const uint32 stride = sizeof(uint32) * 4;
+		uint32 drawcount = (uint32) cmd.indirectDrawCount;
+
+		// Without the multiDrawIndirect feature only one draw can be read per
+		// call.
+		uint32 drawspercall = multiDrawIndirectSupported ? drawcount : 1;
+
+		for (uint32 i = 0; i < drawcount; i += drawspercall)
+		{
+			vkCmdDrawIndirect(
+				commandBuffers.at(currentFrame),
+				(VkBuffer) cmd.indirectBuffer->getHandle(),
+				cmd.indirectBufferOffset + stride * i,
+				drawspercall,
+				stride);
+		}
 	}
 	else
 	{
@@ -895,20 +1073,26 @@ void Graphics::draw(const DrawIndexedCommand &cmd)
 {
 	prepareDraw(*cmd.attributes, *cmd.buffers, cmd.texture, cmd.primitiveType, cmd.cullMode);
 
-	vkCmdBindIndexBuffer(
-		commandBuffers.at(currentFrame),
+	bindIndexBuffer(
 		(VkBuffer) cmd.indexBuffer->getHandle(),
-		(VkDeviceSize) cmd.indexBufferOffset,
+		(VkDeviceSize) (cmd.indexBuffer->getHandleOffset() + cmd.indexBufferOffset),
 		Vulkan::getVulkanIndexBufferType(cmd.indexType));
 
 	if (cmd.indirectBuffer != nullptr)
 	{
-		vkCmdDrawIndexedIndirect(
-			commandBuffers.at(currentFrame),
-			(VkBuffer) cmd.indirectBuffer->getHandle(),
-			cmd.indirectBufferOffset,
-			1,
-			0);
+		const uint32 stride = sizeof(uint32) * 5;
+		uint32 drawcount = (uint32) cmd.indirectDrawCount;
+		uint32 drawspercall = multiDrawIndirectSupported ? drawcount : 1;
+
+		for (uint32 i = 0; i < drawcount; i += drawspercall)
+		{
+			vkCmdDrawIndexedIndirect(
+				commandBuffers.at(currentFrame),
+				(VkBuffer) cmd.indirectBuffer->getHandle(),
+				cmd.indirectBufferOffset + stride * i,
+				drawspercall,
+				stride);
+		}
 	}
 	else
 	{
@@ -931,10 +1115,9 @@ void Graphics::drawQuads(int start, int count, const VertexAttributes &attribute
 
 	prepareDraw(attributes, buffers, texture, PRIMITIVE_TRIANGLES, CULL_NONE);
 
-	vkCmdBindIndexBuffer(
-		commandBuffers.at(currentFrame),
+	bindIndexBuffer(
 		(VkBuffer)quadIndexBuffer->getHandle(),
-		0,
+		quadIndexBuffer->getHandleOffset(),
 		Vulkan::getVulkanIndexBufferType(INDEX_UINT16));
 
 	int baseVertex = start * 4;
@@ -1198,15 +1381,14 @@ bool Graphics::dispatch(love::graphics::Shader *shader, int x, int y, int z)
 {
 	usedShadersInFrame.insert(computeShader);
 
-	if (renderPassState.active)
-		endRenderPass();
+	VkCommandBuffer commandBuffer = getCommandBufferForCompute();
 
-	vkCmdBindPipeline(commandBuffers.at(currentFrame), VK_PIPELINE_BIND_POINT_COMPUTE, computeShader->getComputePipeline());
+	vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, computeShader->getComputePipeline());
 
-	computeShader->cmdPushDescriptorSets(commandBuffers.at(currentFrame), VK_PIPELINE_BIND_POINT_COMPUTE);
+	computeShader->cmdPushDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE);
 
 	// TODO: does this need any layout transitions?
-	vkCmdDispatch(commandBuffers.at(currentFrame), (uint32) x, (uint32) y, (uint32) z);
+	vkCmdDispatch(commandBuffer, (uint32) x, (uint32) y, (uint32) z);
 
 	return true;
 }
@@ -1215,15 +1397,14 @@ bool Graphics::dispatch(love::graphics::Shader *shader, love::graphics::Buffer *
 {
 	usedShadersInFrame.insert(computeShader);
 
-	if (renderPassState.active)
-		endRenderPass();
+	VkCommandBuffer commandBuffer = getCommandBufferForCompute();
 
-	vkCmdBindPipeline(commandBuffers.at(currentFrame), VK_PIPELINE_BIND_POINT_COMPUTE, computeShader->getComputePipeline());
+	vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, computeShader->getComputePipeline());
 
-	computeShader->cmdPushDescriptorSets(commandBuffers.at(currentFrame), VK_PIPELINE_BIND_POINT_COMPUTE);
+	computeShader->cmdPushDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE);
 
 	// TODO: does this need any layout transitions?
-	vkCmdDispatchIndirect(commandBuffers.at(currentFrame), (VkBuffer) indirectargs->getHandle(), argsoffset);
+	vkCmdDispatchIndirect(commandBuffer, (VkBuffer) indirectargs->getHandle(), argsoffset);
 
 	return true;
 }
@@ -1271,6 +1452,14 @@ void Graphics::beginFrame()
 {
 	vkWaitForFences(device, 1, &inFlightFences[currentFrame], VK_TRUE, UINT64_MAX);
 
+	// Resources queued for cleanup this frame may also be used by its async
+	// compute work.
+	if (!computeFences.empty())
+		vkWaitForFences(device, 1, &computeFences[currentFrame], VK_TRUE, UINT64_MAX);
+
+	resolveGPUTimerQueries();
+	resolveOcclusionQueries(currentFrame);
+
 	if (frameCounter >= USAGES_POLL_INTERVAL)
 	{
 		cleanupUnusedObjects();
@@ -1308,8 +1497,19 @@ void Graphics::beginFrame()
 		cleanUpFn();
 	cleanUpFunctions.at(currentFrame).clear();
 
+	resetStagingMemory(currentFrame);
+
 	startRecordingGraphicsCommands();
 
+	if (!gpuTimerFrames.empty())
+	{
+		vkCmdResetQueryPool(commandBuffers.at(currentFrame), gpuTimerFrames.at(currentFrame).queryPool, 0, MAX_GPU_TIMESTAMPS);
+		beginGPUTimerFrame();
+	}
+
+	if (!occlusionQueryFrames.empty())
+		vkCmdResetQueryPool(commandBuffers.at(currentFrame), occlusionQueryFrames.at(currentFrame).queryPool, 0, MAX_OCCLUSION_QUERY_SEGMENTS);
+
 	if (!swapChainImages.empty())
 	{
 		Vulkan::cmdTransitionImageLayout(
@@ -1381,7 +1581,7 @@ void Graphics::startRecordingGraphicsCommands()
 	if (defaultVertexBuffer)
 	{
 		VkBuffer buffer = (VkBuffer)defaultVertexBuffer->getHandle();
-		VkDeviceSize offset = 0;
+		VkDeviceSize offset = defaultVertexBuffer->getHandleOffset();
 		vkCmdBindVertexBuffers(commandBuffers.at(currentFrame), DEFAULT_VERTEX_BUFFER_BINDING, 1, &buffer, &offset);
 	}
 }
@@ -1395,6 +1595,67 @@ void Graphics::endRecordingGraphicsCommands()
 		throw love::Exception("failed to record command buffer");
 }
 
+VkCommandBuffer Graphics::getCommandBufferForCompute()
+{
+	if (!isAsyncCompute() || computeQueue == VK_NULL_HANDLE)
+	{
+		if (renderPassState.active)
+			endRenderPass();
+
+		return commandBuffers.at(currentFrame);
+	}
+
+	if (!computeCommandsRecording)
+	{
+		VkCommandBufferBeginInfo beginInfo{};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+		if (vkBeginCommandBuffer(computeCommandBuffers.at(currentFrame), &beginInfo) != VK_SUCCESS)
+			throw love::Exception("failed to begin recording compute command buffer");
+
+		computeCommandsRecording = true;
+	}
+
+	return computeCommandBuffers.at(currentFrame);
+}
+
+void Graphics::submitComputeCommands(bool signalGraphics)
+{
+	computeCommandsRecording = false;
+
+	VkCommandBuffer commandBuffer = computeCommandBuffers.at(currentFrame);
+
+	if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+		throw love::Exception("failed to record compute command buffer");
+
+	VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
+	VkSubmitInfo submitInfo{};
+	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submitInfo.waitSemaphoreCount = 1;
+	submitInfo.pWaitSemaphores = &graphicsToComputeSemaphores.at(currentFrame);
+	submitInfo.pWaitDstStageMask = &waitStage;
+	submitInfo.commandBufferCount = 1;
+	submitInfo.pCommandBuffers = &commandBuffer;
+
+	if (signalGraphics)
+	{
+		submitInfo.signalSemaphoreCount = 1;
+		submitInfo.pSignalSemaphores = &computeFinishedSemaphores.at(currentFrame);
+	}
+
+	vkResetFences(device, 1, &computeFences[currentFrame]);
+
+	if (vkQueueSubmit(computeQueue, 1, &submitInfo, computeFences[currentFrame]) != VK_SUCCESS)
+		throw love::Exception("failed to submit compute command buffer");
+
+	if (signalGraphics)
+		computeFinishedPending[currentFrame] = true;
+	else
+		vkQueueWaitIdle(computeQueue);
+}
+
 VkCommandBuffer Graphics::getCommandBufferForDataTransfer()
 {
 	if (renderPassState.active)
@@ -1408,6 +1669,103 @@ void Graphics::queueCleanUp(std::function<void()> cleanUp)
 	cleanUpFunctions.at(currentFrame).push_back(cleanUp);
 }
 
+StagingAllocation Graphics::allocateStagingMemory(VkDeviceSize size, VkDeviceSize alignment)
+{
+	StagingFrame &frame = stagingFrames.at(currentFrame);
+
+	alignment = std::max(alignment, (VkDeviceSize) 1);
+
+	// Pages are filled in order, and earlier pages are never revisited within
+	// a frame.
+	for (; frame.currentPage < frame.pages.size(); frame.currentPage++)
+	{
+		StagingPage &page = frame.pages[frame.currentPage];
+		VkDeviceSize offset = ((page.used + alignment - 1) / alignment) * alignment;
+
+		if (offset + size <= page.size)
+		{
+			page.used = offset + size;
+
+			StagingAllocation staging;
+			staging.buffer = page.buffer;
+			staging.allocation = page.allocation;
+			staging.offset = offset;
+			staging.data = (uint8 *) page.data + offset;
+			return staging;
+		}
+	}
+
+	StagingPage page;
+	page.size = std::max(size, STAGING_PAGE_SIZE);
+
+	VkBufferCreateInfo bufferInfo{};
+	bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	bufferInfo.size = page.size;
+	bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+
+	VmaAllocationCreateInfo allocCreateInfo{};
+	allocCreateInfo.usage = VMA_MEMORY_USAGE_AUTO;
+	allocCreateInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+	VmaAllocationInfo allocInfo{};
+	if (vmaCreateBuffer(vmaAllocator, &bufferInfo, &allocCreateInfo, &page.buffer, &page.allocation, &allocInfo) != VK_SUCCESS)
+		throw love::Exception("failed to create staging buffer");
+
+	page.data = allocInfo.pMappedData;
+	page.used = size;
+
+	frame.pages.push_back(page);
+	frame.currentPage = frame.pages.size() - 1;
+
+	StagingAllocation staging;
+	staging.buffer = page.buffer;
+	staging.allocation = page.allocation;
+	staging.offset = 0;
+	staging.data = page.data;
+	return staging;
+}
+
+void Graphics::flushStagingMemory(const StagingAllocation &staging, VkDeviceSize offset, VkDeviceSize size)
+{
+	VkMemoryPropertyFlags memoryProperties;
+	vmaGetAllocationMemoryProperties(vmaAllocator, staging.allocation, &memoryProperties);
+	if (~memoryProperties & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)
+		vmaFlushAllocation(vmaAllocator, staging.allocation, staging.offset + offset, size);
+}
+
+void Graphics::resetStagingMemory(size_t frameIndex)
+{
+	StagingFrame &frame = stagingFrames.at(frameIndex);
+	auto &pages = frame.pages;
+
+	// Keep the pages the frame used, so a steady amount of uploads doesn't
+	// create any new buffers. Oversized and unused pages are released.
+	for (size_t i = pages.size(); i > 0; i--)
+	{
+		const StagingPage &page = pages[i - 1];
+		if (page.size > STAGING_PAGE_SIZE || (page.used == 0 && i > 1))
+		{
+			vmaDestroyBuffer(vmaAllocator, page.buffer, page.allocation);
+			pages.erase(pages.begin() + (i - 1));
+		}
+	}
+
+	for (StagingPage &page : pages)
+		page.used = 0;
+
+	frame.currentPage = 0;
+}
+
+void Graphics::destroyStagingMemory()
+{
+	for (const StagingFrame &frame : stagingFrames)
+	{
+		for (const StagingPage &page : frame.pages)
+			vmaDestroyBuffer(vmaAllocator, page.buffer, page.allocation);
+	}
+	stagingFrames.clear();
+}
+
 void Graphics::addReadbackCallback(std::function<void()> callback)
 {
 	readbackCallbacks.at(currentFrame).push_back(callback);
@@ -1422,6 +1780,8 @@ graphics::Shader::BuiltinUniformData Graphics::getCurrentBuiltinUniformData()
 
 	data.scaleParams.x = (float) getCurrentDPIScale();
 	data.scaleParams.y = getPointSize();
+	data.scaleParams.z = getLineWidth();
+	data.scaleParams.w = getLineStyle() == LINE_SMOOTH ? 1.0f : 0.0f;
 
 	// Flip y to convert input y-up [-1, 1] to vulkan's y-down [-1, 1].
 	// Convert input z [-1, 1] to vulkan [0, 1].
@@ -1623,6 +1983,18 @@ QueueFamilyIndices Graphics::findQueueFamilies(VkPhysicalDevice device)
 		i++;
 	}
 
+	// Compute-only families are usually separate hardware queues, which is
+	// what lets async compute overlap with rendering.
+	for (uint32_t j = 0; j < queueFamilyCount; j++)
+	{
+		VkQueueFlags flags = queueFamilies[j].queueFlags;
+		if ((flags & VK_QUEUE_COMPUTE_BIT) && !(flags & VK_QUEUE_GRAPHICS_BIT))
+		{
+			indices.computeFamily = j;
+			break;
+		}
+	}
+
 	return indices;
 }
 
@@ -1661,6 +2033,9 @@ void Graphics::createLogicalDevice()
 		indices.presentFamily.value
 	};
 
+	if (indices.computeFamily.hasValue)
+		uniqueQueueFamilies.insert(indices.computeFamily.value);
+
 	float queuePriority = 1.0f;
 	for (uint32_t queueFamily : uniqueQueueFamilies)
 	{
@@ -1687,9 +2062,16 @@ void Graphics::createLogicalDevice()
 	if (optionalDeviceExtensions.spirv14 && deviceApiVersion < VK_API_VERSION_1_1)
 		optionalDeviceExtensions.spirv14 = false;
 
+	VkPhysicalDeviceFeatures supportedFeatures{};
+	vkGetPhysicalDeviceFeatures(physicalDevice, &supportedFeatures);
+	multiDrawIndirectSupported = supportedFeatures.multiDrawIndirect == VK_TRUE;
+	occlusionQueryPrecise = supportedFeatures.occlusionQueryPrecise == VK_TRUE;
+
 	VkPhysicalDeviceFeatures deviceFeatures{};
 	deviceFeatures.samplerAnisotropy = VK_TRUE;
 	deviceFeatures.fillModeNonSolid = VK_TRUE;
+	deviceFeatures.multiDrawIndirect = multiDrawIndirectSupported ? VK_TRUE : VK_FALSE;
+	deviceFeatures.occlusionQueryPrecise = occlusionQueryPrecise ? VK_TRUE : VK_FALSE;
 
 	VkDeviceCreateInfo createInfo{};
 	createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
@@ -1737,17 +2119,141 @@ void Graphics::createLogicalDevice()
 
 	vkGetDeviceQueue(device, indices.graphicsFamily.value, 0, &graphicsQueue);
 	vkGetDeviceQueue(device, indices.presentFamily.value, 0, &presentQueue);
+
+	if (indices.computeFamily.hasValue)
+	{
+		vkGetDeviceQueue(device, indices.computeFamily.value, 0, &computeQueue);
+		sharedQueueFamilies[0] = indices.graphicsFamily.value;
+		sharedQueueFamilies[1] = indices.computeFamily.value;
+	}
+}
+
+// Prepended to the driver's pipeline cache data when it's saved to disk.
+struct PipelineCacheFileHeader
+{
+	uint32 magic;
+	uint32 dataSize;
+	uint32 vendorID;
+	uint32 deviceID;
+	uint32 driverVersion;
+	uint8 pipelineCacheUUID[VK_UUID_SIZE];
+};
+
+static const uint32 PIPELINE_CACHE_FILE_MAGIC = 0x4C4F5643; // 'LOVC'
+static const char *PIPELINE_CACHE_FILENAME = "vulkan_pipeline_cache.bin";
+
+static PipelineCacheFileHeader getPipelineCacheFileHeader(VkPhysicalDevice physicalDevice)
+{
+	VkPhysicalDeviceProperties properties;
+	vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+	PipelineCacheFileHeader header{};
+	header.magic = PIPELINE_CACHE_FILE_MAGIC;
+	header.vendorID = properties.vendorID;
+	header.deviceID = properties.deviceID;
+	header.driverVersion = properties.driverVersion;
+	memcpy(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE);
+
+	return header;
+}
+
+static std::vector<uint8> loadPipelineCacheData(VkPhysicalDevice physicalDevice)
+{
+	std::vector<uint8> cachedata;
+
+	auto fs = Module::getInstance<filesystem::Filesystem>(Module::M_FILESYSTEM);
+	if (fs == nullptr || !fs->exists(PIPELINE_CACHE_FILENAME))
+		return cachedata;
+
+	StrongRef<filesystem::FileData> filedata;
+
+	try
+	{
+		filedata.set(fs->read(PIPELINE_CACHE_FILENAME), Acquire::NORETAIN);
+	}
+	catch (love::Exception &)
+	{
+		return cachedata;
+	}
+
+	PipelineCacheFileHeader expected = getPipelineCacheFileHeader(physicalDevice);
+	PipelineCacheFileHeader header{};
+
+	if (filedata->getSize() < sizeof(PipelineCacheFileHeader))
+		return cachedata;
+
+	memcpy(&header, filedata->getData(), sizeof(PipelineCacheFileHeader));
+
+	// Data from a different device or driver version would be rejected (or
+	// worse, mishandled) by the driver, so it's discarded here instead.
+	if (header.magic != expected.magic
+		|| header.vendorID != expected.vendorID
+		|| header.deviceID != expected.deviceID
+		|| header.driverVersion != expected.driverVersion
+		|| memcmp(header.pipelineCacheUUID, expected.pipelineCacheUUID, VK_UUID_SIZE) != 0
+		|| header.dataSize != filedata->getSize() - sizeof(PipelineCacheFileHeader))
+	{
+		return cachedata;
+	}
+
+	const uint8 *data = (const uint8 *) filedata->getData() + sizeof(PipelineCacheFileHeader);
+	cachedata.assign(data, data + header.dataSize);
+
+	return cachedata;
 }
 
 void Graphics::createPipelineCache()
 {
+	std::vector<uint8> cachedata = loadPipelineCacheData(physicalDevice);
+
 	VkPipelineCacheCreateInfo cacheInfo{};
 	cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+	cacheInfo.initialDataSize = cachedata.size();
+	cacheInfo.pInitialData = cachedata.empty() ? nullptr : cachedata.data();
+
+	if (vkCreatePipelineCache(device, &cacheInfo, nullptr, &pipelineCache) == VK_SUCCESS)
+		return;
+
+	// Fall back to an empty cache if the driver didn't accept the saved data.
+	cacheInfo.initialDataSize = 0;
+	cacheInfo.pInitialData = nullptr;
 
 	if (vkCreatePipelineCache(device, &cacheInfo, nullptr, &pipelineCache) != VK_SUCCESS)
 		throw love::Exception("could not create pipeline cache");
 }
 
+void Graphics::savePipelineCache()
+{
+	if (pipelineCache == VK_NULL_HANDLE)
+		return;
+
+	auto fs = Module::getInstance<filesystem::Filesystem>(Module::M_FILESYSTEM);
+	if (fs == nullptr)
+		return;
+
+	size_t size = 0;
+	if (vkGetPipelineCacheData(device, pipelineCache, &size, nullptr) != VK_SUCCESS || size == 0)
+		return;
+
+	std::vector<uint8> filedata(sizeof(PipelineCacheFileHeader) + size);
+
+	if (vkGetPipelineCacheData(device, pipelineCache, &size, filedata.data() + sizeof(PipelineCacheFileHeader)) != VK_SUCCESS)
+		return;
+
+	PipelineCacheFileHeader header = getPipelineCacheFileHeader(physicalDevice);
+	header.dataSize = (uint32) size;
+	memcpy(filedata.data(), &header, sizeof(PipelineCacheFileHeader));
+
+	try
+	{
+		fs->write(PIPELINE_CACHE_FILENAME, filedata.data(), sizeof(PipelineCacheFileHeader) + size);
+	}
+	catch (love::Exception &)
+	{
+		// The save directory might not be writable, the cache is optional.
+	}
+}
+
 void Graphics::initVMA()
 {
 	VmaAllocatorCreateInfo allocatorCreateInfo = {};
@@ -1847,12 +2353,15 @@ void Graphics::createSwapChain()
 	SwapChainSupportDetails swapChainSupport = querySwapChainSupport(physicalDevice);
 
 	VkSurfaceFormatKHR surfaceFormat = chooseSwapSurfaceFormat(swapChainSupport.formats);
-	VkPresentModeKHR presentMode = chooseSwapPresentMode(swapChainSupport.presentModes);
+	presentMode = chooseSwapPresentMode(swapChainSupport.presentModes);
 	VkExtent2D extent = chooseSwapExtent(swapChainSupport.capabilities);
 
 	if (extent.width > 0 && extent.height > 0)
 	{
 		uint32_t imageCount = swapChainSupport.capabilities.minImageCount + 1;
+		// Mailbox needs an image being displayed, one queued, and one to draw to.
+		if (presentMode == VK_PRESENT_MODE_MAILBOX_KHR)
+			imageCount = std::max(imageCount, 3u);
 		if (swapChainSupport.capabilities.maxImageCount > 0 && imageCount > swapChainSupport.capabilities.maxImageCount)
 			imageCount = swapChainSupport.capabilities.maxImageCount;
 
@@ -1972,6 +2481,9 @@ VkPresentModeKHR Graphics::chooseSwapPresentMode(const std::vector<VkPresentMode
 	const auto begin = availablePresentModes.begin();
 	const auto end = availablePresentModes.end();
 
+	if (requestedPresentMode != VK_PRESENT_MODE_MAX_ENUM_KHR && std::find(begin, end, requestedPresentMode) != end)
+		return requestedPresentMode;
+
 	switch (vsync)
 	{
 	case -1:
@@ -2115,6 +2627,7 @@ VkFramebuffer Graphics::getFramebuffer(FramebufferConfiguration &configuration)
 
 void Graphics::createDefaultShaders()
 {
+	double shaderstart = timer::Timer::getTime();
 	for (int i = 0; i < Shader::STANDARD_MAX_ENUM; i++)
 	{
 		auto stype = (Shader::StandardShader)i;
@@ -2127,6 +2640,7 @@ void Graphics::createDefaultShaders()
 			Shader::standardShaders[i] = newShader(stages, {});
 		}
 	}
+	defaultShaderCompileTime += timer::Timer::getTime() - shaderstart;
 }
 
 VkRenderPass Graphics::createRenderPass(RenderPassConfiguration &configuration)
@@ -2149,7 +2663,7 @@ VkRenderPass Graphics::createRenderPass(RenderPassConfiguration &configuration)
 		colorDescription.format = colorAttachment.format;
 		colorDescription.samples = colorAttachment.msaaSamples;
 		colorDescription.loadOp = colorAttachment.loadOp;
-		colorDescription.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+		colorDescription.storeOp = colorAttachment.storeOp;
 		colorDescription.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
 		colorDescription.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
 		colorDescription.initialLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
@@ -2171,9 +2685,9 @@ VkRenderPass Graphics::createRenderPass(RenderPassConfiguration &configuration)
 		depthStencilAttachment.format = configuration.staticData.depthStencilAttachment.format;
 		depthStencilAttachment.samples = configuration.staticData.depthStencilAttachment.msaaSamples;
 		depthStencilAttachment.loadOp = configuration.staticData.depthStencilAttachment.depthLoadOp;
-		depthStencilAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+		depthStencilAttachment.storeOp = configuration.staticData.depthStencilAttachment.storeOp;
 		depthStencilAttachment.stencilLoadOp = configuration.staticData.depthStencilAttachment.stencilLoadOp;
-		depthStencilAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_STORE;
+		depthStencilAttachment.stencilStoreOp = configuration.staticData.depthStencilAttachment.storeOp;
 		depthStencilAttachment.initialLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
 		depthStencilAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
 		attachments.push_back(depthStencilAttachment);
@@ -2384,7 +2898,7 @@ void Graphics::prepareDraw(const VertexAttributes &attributes, const BufferBindi
 		if (buffers.useBits & bit)
 		{
 			vkbuffers[buffercount] = (VkBuffer)buffers.info[i].buffer->getHandle();
-			vkoffsets[buffercount] = (VkDeviceSize)buffers.info[i].offset;
+			vkoffsets[buffercount] = (VkDeviceSize)(buffers.info[i].buffer->getHandleOffset() + buffers.info[i].offset);
 			buffercount++;
 		}
 
@@ -2392,8 +2906,32 @@ void Graphics::prepareDraw(const VertexAttributes &attributes, const BufferBindi
 		allbits >>= 1;
 	}
 
-	if (buffercount > 0)
+	// Large numbers of draws sharing the same buffers (e.g. batched or
+	// SpriteBatch draws) don't need to re-bind them every time.
+	bool bindingschanged = buffercount != renderPassState.vertexBufferCount
+		|| memcmp(vkbuffers, renderPassState.vertexBuffers, sizeof(VkBuffer) * buffercount) != 0
+		|| memcmp(vkoffsets, renderPassState.vertexBufferOffsets, sizeof(VkDeviceSize) * buffercount) != 0;
+
+	if (buffercount > 0 && bindingschanged)
+	{
 		vkCmdBindVertexBuffers(commandBuffers.at(currentFrame), VERTEX_BUFFER_BINDING_START, buffercount, vkbuffers, vkoffsets);
+
+		renderPassState.vertexBufferCount = buffercount;
+		memcpy(renderPassState.vertexBuffers, vkbuffers, sizeof(VkBuffer) * buffercount);
+		memcpy(renderPassState.vertexBufferOffsets, vkoffsets, sizeof(VkDeviceSize) * buffercount);
+	}
+}
+
+void Graphics::bindIndexBuffer(VkBuffer buffer, VkDeviceSize offset, VkIndexType type)
+{
+	if (buffer == renderPassState.indexBuffer && offset == renderPassState.indexBufferOffset && type == renderPassState.indexType)
+		return;
+
+	vkCmdBindIndexBuffer(commandBuffers.at(currentFrame), buffer, offset, type);
+
+	renderPassState.indexBuffer = buffer;
+	renderPassState.indexBufferOffset = offset;
+	renderPassState.indexType = type;
 }
 
 void Graphics::setDefaultRenderPass()
@@ -2474,6 +3012,13 @@ void Graphics::setDefaultRenderPass()
 	}
 }
 
+// Render target textures don't have separate resolve images here, so resolve
+// is the same as store.
+static VkAttachmentStoreOp getStoreOp(Graphics::StoreAction action)
+{
+	return action == Graphics::STORE_ACTION_DISCARD ? VK_ATTACHMENT_STORE_OP_DONT_CARE : VK_ATTACHMENT_STORE_OP_STORE;
+}
+
 void Graphics::setRenderPass(const RenderTargets &rts, int pixelw, int pixelh, bool hasSRGBtexture)
 {
 	// fixme: hasSRGBtexture
@@ -2482,13 +3027,15 @@ void Graphics::setRenderPass(const RenderTargets &rts, int pixelw, int pixelh, b
 		renderPassConfiguration.colorAttachments.push_back({ 
 			Vulkan::getTextureFormat(color.texture->getPixelFormat()).internalFormat,
 			VK_ATTACHMENT_LOAD_OP_LOAD,
-			dynamic_cast<Texture*>(color.texture)->getMsaaSamples() });
+			dynamic_cast<Texture*>(color.texture)->getMsaaSamples(),
+			getStoreOp(color.storeAction) });
 	if (rts.depthStencil.texture != nullptr)
 		renderPassConfiguration.staticData.depthStencilAttachment = {
 			Vulkan::getTextureFormat(rts.depthStencil.texture->getPixelFormat()).internalFormat,
 			VK_ATTACHMENT_LOAD_OP_LOAD,
 			VK_ATTACHMENT_LOAD_OP_LOAD,
-			dynamic_cast<Texture*>(rts.depthStencil.texture)->getMsaaSamples() };
+			dynamic_cast<Texture*>(rts.depthStencil.texture)->getMsaaSamples(),
+			getStoreOp(rts.depthStencil.storeAction) };
 
 	FramebufferConfiguration configuration{};
 
@@ -2572,13 +3119,22 @@ void Graphics::startRenderPass()
 
 	vkCmdBeginRenderPass(commandBuffers.at(currentFrame), &renderPassState.beginInfo, VK_SUBPASS_CONTENTS_INLINE);
 
+	renderPassState.vertexBufferCount = 0;
+	renderPassState.indexBuffer = VK_NULL_HANDLE;
+
 	applyScissor();
+
+	if (activeOcclusionQuery.get() != nullptr)
+		beginOcclusionQuerySegment();
 }
 
 void Graphics::endRenderPass()
 {
 	renderPassState.active = false;
 
+	if (occlusionQuerySegmentOpen)
+		endOcclusionQuerySegment();
+
 	vkCmdEndRenderPass(commandBuffers.at(currentFrame));
 
 	for (const auto &[image, format, imageLayout, renderLayout, rootmip, rootlayer] : renderPassState.transitionImages)
@@ -2870,9 +3426,10 @@ VkSampleCountFlagBits Graphics::getMsaaCount(int requestedMsaa) const
 
 void Graphics::setVsync(int vsync)
 {
-	if (vsync != this->vsync)
+	if (vsync != this->vsync || requestedPresentMode != VK_PRESENT_MODE_MAX_ENUM_KHR)
 	{
 		this->vsync = vsync;
+		requestedPresentMode = VK_PRESENT_MODE_MAX_ENUM_KHR;
 
 		// With the extension VK_EXT_swapchain_maintenance1 a swapchain recreation might not be needed
 		// https://github.com/KhronosGroup/Vulkan-Docs/blob/main/proposals/VK_EXT_swapchain_maintenance1.adoc
@@ -2888,6 +3445,45 @@ int Graphics::getVsync() const
 	return vsync;
 }
 
+bool Graphics::setPresentMode(VkPresentModeKHR mode)
+{
+	auto modes = getSupportedPresentModes();
+	if (std::find(modes.begin(), modes.end(), mode) == modes.end())
+		return false;
+
+	if (mode != requestedPresentMode)
+	{
+		requestedPresentMode = mode;
+
+		if (mode == VK_PRESENT_MODE_FIFO_KHR)
+			vsync = 1;
+		else if (mode == VK_PRESENT_MODE_FIFO_RELAXED_KHR)
+			vsync = -1;
+		else
+			vsync = 0;
+
+		requestSwapchainRecreation();
+	}
+
+	return true;
+}
+
+VkPresentModeKHR Graphics::getPresentMode() const
+{
+	// A pending recreation will use the requested mode, which is known to be
+	// supported.
+	if (requestedPresentMode != VK_PRESENT_MODE_MAX_ENUM_KHR)
+		return requestedPresentMode;
+	return presentMode;
+}
+
+std::vector<VkPresentModeKHR> Graphics::getSupportedPresentModes()
+{
+	if (physicalDevice == VK_NULL_HANDLE || surface == VK_NULL_HANDLE)
+		return {};
+	return querySwapChainSupport(physicalDevice).presentModes;
+}
+
 void Graphics::mapLocalUniformData(void *data, size_t size, VkDescriptorBufferInfo &bufferInfo)
 {
 	size_t alignedSize = alignUp(size, minUniformBufferOffsetAlignment);
@@ -3046,27 +3642,43 @@ void Graphics::createCommandPool()
 
 	if (vkCreateCommandPool(device, &poolInfo, nullptr, &commandPool) != VK_SUCCESS)
 		throw love::Exception("failed to create command pool");
+
+	if (computeQueue != VK_NULL_HANDLE)
+	{
+		poolInfo.queueFamilyIndex = queueFamilyIndices.computeFamily.value;
+		if (vkCreateCommandPool(device, &poolInfo, nullptr, &computeCommandPool) != VK_SUCCESS)
+			throw love::Exception("failed to create compute command pool");
+	}
 }
 
 void Graphics::createCommandBuffers()
 {
-	commandBuffers.resize(MAX_FRAMES_IN_FLIGHT);
+	commandBuffers.resize(framesInFlight);
 
 	VkCommandBufferAllocateInfo allocInfo{};
 	allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
 	allocInfo.commandPool = commandPool;
 	allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-	allocInfo.commandBufferCount = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT);
+	allocInfo.commandBufferCount = framesInFlight;
 
 	if (vkAllocateCommandBuffers(device, &allocInfo, commandBuffers.data()) != VK_SUCCESS)
 		throw love::Exception("failed to allocate command buffers");
+
+	if (computeCommandPool != VK_NULL_HANDLE)
+	{
+		computeCommandBuffers.resize(framesInFlight);
+		allocInfo.commandPool = computeCommandPool;
+
+		if (vkAllocateCommandBuffers(device, &allocInfo, computeCommandBuffers.data()) != VK_SUCCESS)
+			throw love::Exception("failed to allocate compute command buffers");
+	}
 }
 
 void Graphics::createSyncObjects()
 {
-	imageAvailableSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-	renderFinishedSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-	inFlightFences.resize(MAX_FRAMES_IN_FLIGHT);
+	imageAvailableSemaphores.resize(framesInFlight);
+	renderFinishedSemaphores.resize(framesInFlight);
+	inFlightFences.resize(framesInFlight);
 	imagesInFlight.resize(swapChainImages.size(), VK_NULL_HANDLE);
 
 	VkSemaphoreCreateInfo semaphoreInfo{};
@@ -3076,11 +3688,190 @@ void Graphics::createSyncObjects()
 	fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
 	fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
 
-	for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+	for (size_t i = 0; i < framesInFlight; i++)
 		if (vkCreateSemaphore(device, &semaphoreInfo, nullptr, &imageAvailableSemaphores.at(i)) != VK_SUCCESS ||
 			vkCreateSemaphore(device, &semaphoreInfo, nullptr, &renderFinishedSemaphores.at(i)) != VK_SUCCESS ||
 			vkCreateFence(device, &fenceInfo, nullptr, &inFlightFences.at(i)) != VK_SUCCESS)
 			throw love::Exception("failed to create synchronization objects for a frame!");
+
+	if (computeQueue == VK_NULL_HANDLE)
+		return;
+
+	graphicsToComputeSemaphores.resize(framesInFlight);
+	computeFinishedSemaphores.resize(framesInFlight);
+	computeFences.resize(framesInFlight);
+	computeFinishedPending.resize(framesInFlight, false);
+
+	for (size_t i = 0; i < framesInFlight; i++)
+		if (vkCreateSemaphore(device, &semaphoreInfo, nullptr, &graphicsToComputeSemaphores.at(i)) != VK_SUCCESS ||
+			vkCreateSemaphore(device, &semaphoreInfo, nullptr, &computeFinishedSemaphores.at(i)) != VK_SUCCESS ||
+			vkCreateFence(device, &fenceInfo, nullptr, &computeFences.at(i)) != VK_SUCCESS)
+			throw love::Exception("failed to create async compute synchronization objects for a frame!");
+}
+
+void Graphics::createGPUTimerQueryPools()
+{
+	VkPhysicalDeviceProperties properties;
+	vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+	if (!properties.limits.timestampComputeAndGraphics)
+		return;
+
+	timestampPeriod = properties.limits.timestampPeriod;
+
+	VkQueryPoolCreateInfo poolInfo{};
+	poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+	poolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+	poolInfo.queryCount = MAX_GPU_TIMESTAMPS;
+
+	gpuTimerFrames.resize(framesInFlight);
+
+	for (auto &frame : gpuTimerFrames)
+	{
+		if (vkCreateQueryPool(device, &poolInfo, nullptr, &frame.queryPool) != VK_SUCCESS)
+			throw love::Exception("failed to create timestamp query pool");
+	}
+}
+
+void Graphics::resolveGPUTimerQueries()
+{
+	if (gpuTimerFrames.empty())
+		return;
+
+	GPUTimerQueryFrame &frame = gpuTimerFrames.at(currentFrame);
+	if (!frame.pending)
+		return;
+
+	frame.pending = false;
+
+	// The frame's fence has been waited on, so its results are available.
+	std::vector<uint64_t> results(frame.timer.timestampCount);
+	VkResult result = vkGetQueryPoolResults(
+		device, frame.queryPool, 0, (uint32_t)results.size(),
+		results.size() * sizeof(uint64_t), results.data(), sizeof(uint64_t),
+		VK_QUERY_RESULT_64_BIT);
+
+	if (result != VK_SUCCESS)
+		return;
+
+	std::vector<double> timestamps(results.size());
+	for (size_t i = 0; i < results.size(); i++)
+		timestamps[i] = (double) results[i] * timestampPeriod * 1e-9;
+
+	resolveGPUTimerFrame(frame.timer, timestamps);
+}
+
+graphics::Graphics::GPUTimerFrame *Graphics::getGPUTimerFrame()
+{
+	if (gpuTimerFrames.empty())
+		return nullptr;
+	return &gpuTimerFrames.at(currentFrame).timer;
+}
+
+int Graphics::writeGPUTimestamp()
+{
+	GPUTimerQueryFrame &frame = gpuTimerFrames.at(currentFrame);
+	int index = frame.timer.timestampCount;
+
+	if (index >= MAX_GPU_TIMESTAMPS)
+		return -1;
+
+	vkCmdWriteTimestamp(commandBuffers.at(currentFrame), VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, frame.queryPool, (uint32_t)index);
+
+	frame.timer.timestampCount++;
+	return index;
+}
+
+void Graphics::createOcclusionQueryPools()
+{
+	VkQueryPoolCreateInfo poolInfo{};
+	poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+	poolInfo.queryType = VK_QUERY_TYPE_OCCLUSION;
+	poolInfo.queryCount = MAX_OCCLUSION_QUERY_SEGMENTS;
+
+	occlusionQueryFrames.resize(framesInFlight);
+
+	for (auto &frame : occlusionQueryFrames)
+	{
+		if (vkCreateQueryPool(device, &poolInfo, nullptr, &frame.queryPool) != VK_SUCCESS)
+			throw love::Exception("failed to create occlusion query pool");
+	}
+}
+
+void Graphics::resolveOcclusionQueries(size_t frameIndex)
+{
+	if (occlusionQueryFrames.empty())
+		return;
+
+	OcclusionQueryFrame &frame = occlusionQueryFrames.at(frameIndex);
+	if (frame.segments.empty())
+		return;
+
+	// Only called once the frame's fence has been signaled.
+	std::vector<uint64_t> results(frame.segments.size());
+	VkResult result = vkGetQueryPoolResults(
+		device, frame.queryPool, 0, (uint32_t)results.size(),
+		results.size() * sizeof(uint64_t), results.data(), sizeof(uint64_t),
+		VK_QUERY_RESULT_64_BIT);
+
+	for (size_t i = 0; i < frame.segments.size(); i++)
+	{
+		const OcclusionQuerySegment &segment = frame.segments[i];
+		uint64 samples = result == VK_SUCCESS ? results[i] : 1;
+		segment.query->resolveSegment(segment.generation, samples);
+	}
+
+	frame.segments.clear();
+}
+
+void Graphics::updateOcclusionQueries()
+{
+	for (size_t i = 0; i < occlusionQueryFrames.size(); i++)
+	{
+		// The current frame's commands haven't been submitted yet.
+		if (i == currentFrame || occlusionQueryFrames[i].segments.empty())
+			continue;
+
+		if (vkGetFenceStatus(device, inFlightFences.at(i)) == VK_SUCCESS)
+			resolveOcclusionQueries(i);
+	}
+}
+
+void Graphics::beginOcclusionQueryInternal(love::graphics::OcclusionQuery */*query*/)
+{
+	if (renderPassState.active)
+		beginOcclusionQuerySegment();
+}
+
+void Graphics::endOcclusionQueryInternal(love::graphics::OcclusionQuery */*query*/)
+{
+	if (occlusionQuerySegmentOpen)
+		endOcclusionQuerySegment();
+}
+
+void Graphics::beginOcclusionQuerySegment()
+{
+	love::graphics::OcclusionQuery *query = activeOcclusionQuery.get();
+	OcclusionQueryFrame &frame = occlusionQueryFrames.at(currentFrame);
+
+	if (frame.segments.size() >= MAX_OCCLUSION_QUERY_SEGMENTS)
+	{
+		query->markConservative();
+		return;
+	}
+
+	VkQueryControlFlags flags = occlusionQueryPrecise ? VK_QUERY_CONTROL_PRECISE_BIT : 0;
+	vkCmdBeginQuery(commandBuffers.at(currentFrame), frame.queryPool, (uint32_t)frame.segments.size(), flags);
+
+	frame.segments.push_back({query, query->addSegment()});
+	occlusionQuerySegmentOpen = true;
+}
+
+void Graphics::endOcclusionQuerySegment()
+{
+	OcclusionQueryFrame &frame = occlusionQueryFrames.at(currentFrame);
+	vkCmdEndQuery(commandBuffers.at(currentFrame), frame.queryPool, (uint32_t)frame.segments.size() - 1);
+	occlusionQuerySegmentOpen = false;
 }
 
 void Graphics::cleanup()
@@ -3090,15 +3881,45 @@ void Graphics::cleanup()
 			cleanUpFn();
 	cleanUpFunctions.clear();
 
+	bufferPageAllocator.reset();
+	destroyStagingMemory();
+
+	for (auto &frame : gpuTimerFrames)
+		vkDestroyQueryPool(device, frame.queryPool, nullptr);
+	gpuTimerFrames.clear();
+
+	for (auto &frame : occlusionQueryFrames)
+		vkDestroyQueryPool(device, frame.queryPool, nullptr);
+	occlusionQueryFrames.clear();
+
 	vmaDestroyAllocator(vmaAllocator);
-	for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+	for (size_t i = 0; i < framesInFlight; i++)
 	{
 		vkDestroySemaphore(device, renderFinishedSemaphores[i], nullptr);
 		vkDestroySemaphore(device, imageAvailableSemaphores[i], nullptr);
 		vkDestroyFence(device, inFlightFences[i], nullptr);
 	}
 
-	vkFreeCommandBuffers(device, commandPool, MAX_FRAMES_IN_FLIGHT, commandBuffers.data());
+	vkFreeCommandBuffers(device, commandPool, framesInFlight, commandBuffers.data());
+
+	for (size_t i = 0; i < computeFences.size(); i++)
+	{
+		vkDestroySemaphore(device, graphicsToComputeSemaphores[i], nullptr);
+		vkDestroySemaphore(device, computeFinishedSemaphores[i], nullptr);
+		vkDestroyFence(device, computeFences[i], nullptr);
+	}
+	graphicsToComputeSemaphores.clear();
+	computeFinishedSemaphores.clear();
+	computeFences.clear();
+	computeFinishedPending.clear();
+
+	if (computeCommandPool != VK_NULL_HANDLE)
+	{
+		vkFreeCommandBuffers(device, computeCommandPool, framesInFlight, computeCommandBuffers.data());
+		vkDestroyCommandPool(device, computeCommandPool, nullptr);
+		computeCommandPool = VK_NULL_HANDLE;
+		computeCommandBuffers.clear();
+	}
 
 	for (auto const &p : samplers)
 		vkDestroySampler(device, p.second, nullptr);
@@ -3113,8 +3934,10 @@ void Graphics::cleanup()
 	framebuffers.clear();
 
 	vkDestroyCommandPool(device, commandPool, nullptr);
+	savePipelineCache();
 	vkDestroyPipelineCache(device, pipelineCache, nullptr);
 	vkDestroyDevice(device, nullptr);
+	computeQueue = VK_NULL_HANDLE;
 }
 
 void Graphics::cleanupSwapChain()
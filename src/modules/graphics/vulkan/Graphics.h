@@ -23,6 +23,7 @@
 // löve
 #include "common/config.h"
 #include "graphics/Graphics.h"
+#include "Buffer.h"
 #include "StreamBuffer.h"
 #include "ShaderStage.h"
 #include "Shader.h"
@@ -51,12 +52,14 @@ struct ColorAttachment
 	VkFormat format = VK_FORMAT_UNDEFINED;
 	VkAttachmentLoadOp loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
 	VkSampleCountFlagBits msaaSamples = VK_SAMPLE_COUNT_1_BIT;
+	VkAttachmentStoreOp storeOp = VK_ATTACHMENT_STORE_OP_STORE;
 
 	bool operator==(const ColorAttachment &attachment) const
 	{
 		return format == attachment.format && 
 			loadOp == attachment.loadOp &&
-			msaaSamples == attachment.msaaSamples;
+			msaaSamples == attachment.msaaSamples &&
+			storeOp == attachment.storeOp;
 	}
 };
 
@@ -66,13 +69,15 @@ struct DepthStencilAttachment
 	VkAttachmentLoadOp depthLoadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
 	VkAttachmentLoadOp stencilLoadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
 	VkSampleCountFlagBits msaaSamples = VK_SAMPLE_COUNT_1_BIT;
+	VkAttachmentStoreOp storeOp = VK_ATTACHMENT_STORE_OP_STORE;
 
 	bool operator==(const DepthStencilAttachment &attachment) const
 	{
 		return format == attachment.format &&
 			depthLoadOp == attachment.depthLoadOp &&
 			stencilLoadOp == attachment.stencilLoadOp &&
-			msaaSamples == attachment.msaaSamples;
+			msaaSamples == attachment.msaaSamples &&
+			storeOp == attachment.storeOp;
 	}
 };
 
@@ -174,6 +179,8 @@ struct QueueFamilyIndices
 {
 	Optional<uint32_t> graphicsFamily;
 	Optional<uint32_t> presentFamily;
+	// Only set for a family with compute but not graphics support.
+	Optional<uint32_t> computeFamily;
 
 	bool isComplete() const
 	{
@@ -196,6 +203,12 @@ struct RenderpassState
 	RenderPassConfiguration renderPassConfiguration{};
 	FramebufferConfiguration framebufferConfiguration{};
 	VkPipeline pipeline = VK_NULL_HANDLE;
+	uint32 vertexBufferCount = 0;
+	VkBuffer vertexBuffers[BufferBindings::MAX] = {};
+	VkDeviceSize vertexBufferOffsets[BufferBindings::MAX] = {};
+	VkBuffer indexBuffer = VK_NULL_HANDLE;
+	VkDeviceSize indexBufferOffset = 0;
+	VkIndexType indexType = VK_INDEX_TYPE_MAX_ENUM;
 	std::vector<std::tuple<VkImage, PixelFormat, VkImageLayout, VkImageLayout, int, int>> transitionImages;
 	uint32_t numColorAttachments = 0;
 	float width = 0.0f;
@@ -256,13 +269,27 @@ public:
 	void draw(const DrawCommand &cmd) override;
 	void draw(const DrawIndexedCommand &cmd) override;
 	void drawQuads(int start, int count, const VertexAttributes &attributes, const BufferBindings &buffers, graphics::Texture *texture) override;
+	bool defragmentMemory(int64 maxbytes, int64 &bytesmoved) override;
 
 	// internal functions.
 
 	VkDevice getDevice() const;
 	VmaAllocator getVmaAllocator() const;
+	// Allocations made with these flags fail instead of exceeding the memory
+	// budget, so the caller can free up memory and retry without them.
+	VmaAllocationCreateFlags getBudgetAllocationFlags() const;
+	// Lets resources be used by both the graphics and async compute queues
+	// without ownership transfers.
+	void setQueueFamilySharing(VkSharingMode &mode, uint32_t &count, const uint32_t *&indices) const;
+	BufferPageAllocator *getBufferPageAllocator();
+	VkPipelineCache getPipelineCache() const { return pipelineCache; }
 	VkCommandBuffer getCommandBufferForDataTransfer();
 	void queueCleanUp(std::function<void()> cleanUp);
+	uint32_t getFramesInFlight() const { return framesInFlight; }
+	// Sub-allocates host visible memory for uploads recorded in the current
+	// frame. It's reused once the GPU has finished that frame.
+	StagingAllocation allocateStagingMemory(VkDeviceSize size, VkDeviceSize alignment);
+	void flushStagingMemory(const StagingAllocation &staging, VkDeviceSize offset, VkDeviceSize size);
 	void addReadbackCallback(std::function<void()> callback);
 	void submitGpuCommands(SubmitMode, void *screenshotCallbackData = nullptr);
 	VkSampler getCachedSampler(const SamplerState &sampler);
@@ -273,6 +300,9 @@ public:
 	VkSampleCountFlagBits getMsaaCount(int requestedMsaa) const;
 	void setVsync(int vsync);
 	int getVsync() const;
+	bool setPresentMode(VkPresentModeKHR mode);
+	VkPresentModeKHR getPresentMode() const;
+	std::vector<VkPresentModeKHR> getSupportedPresentModes();
 	void mapLocalUniformData(void *data, size_t size, VkDescriptorBufferInfo &bufferInfo);
 
 	VkPipeline createGraphicsPipeline(Shader *shader, const GraphicsPipelineConfiguration &configuration);
@@ -286,7 +316,12 @@ protected:
 	bool dispatch(love::graphics::Shader *shader, int x, int y, int z) override;
 	bool dispatch(love::graphics::Shader *shader, love::graphics::Buffer *indirectargs, size_t argsoffset) override;
 	void initCapabilities() override;
-	void getAPIStats(int &shaderswitches) const override;
+	void getAPIStats(Stats &stats) const override;
+	GPUTimerFrame *getGPUTimerFrame() override;
+	int writeGPUTimestamp() override;
+	void updateOcclusionQueries() override;
+	void beginOcclusionQueryInternal(love::graphics::OcclusionQuery *query) override;
+	void endOcclusionQueryInternal(love::graphics::OcclusionQuery *query) override;
 	void setRenderTargetsInternal(const RenderTargets &rts, int pixelw, int pixelh, bool hasSRGBtexture) override;
 
 private:
@@ -296,6 +331,7 @@ private:
 	QueueFamilyIndices findQueueFamilies(VkPhysicalDevice device);
 	void createLogicalDevice();
 	void createPipelineCache();
+	void savePipelineCache();
 	void initVMA();
 	void createSurface();
 	bool checkDeviceExtensionSupport(VkPhysicalDevice device);
@@ -318,6 +354,12 @@ private:
 	void createCommandPool();
 	void createCommandBuffers();
 	void createSyncObjects();
+	void createGPUTimerQueryPools();
+	void resolveGPUTimerQueries();
+	void createOcclusionQueryPools();
+	void resolveOcclusionQueries(size_t frameIndex);
+	void beginOcclusionQuerySegment();
+	void endOcclusionQuerySegment();
 	void cleanup();
 	void cleanupSwapChain();
 	void recreateSwapChain();
@@ -325,6 +367,8 @@ private:
 	void beginFrame();
 	void startRecordingGraphicsCommands();
 	void endRecordingGraphicsCommands();
+	VkCommandBuffer getCommandBufferForCompute();
+	void submitComputeCommands(bool signalGraphics);
 	void createVulkanVertexFormat(
 		Shader *shader,
 		const VertexAttributes &attributes, 
@@ -339,6 +383,7 @@ private:
 	void startRenderPass();
 	void endRenderPass();
 	void applyScissor();
+	void bindIndexBuffer(VkBuffer buffer, VkDeviceSize offset, VkIndexType type);
 	VkSampler createSampler(const SamplerState &sampler);
 	void cleanupUnusedObjects();
 	void requestSwapchainRecreation();
@@ -352,6 +397,8 @@ private:
 	OptionalDeviceExtensions optionalDeviceExtensions;
 	VkQueue graphicsQueue = VK_NULL_HANDLE;
 	VkQueue presentQueue = VK_NULL_HANDLE;
+	VkQueue computeQueue = VK_NULL_HANDLE;
+	uint32_t sharedQueueFamilies[2] = {};
 	VkSurfaceKHR surface = VK_NULL_HANDLE;
 	VkSwapchainKHR swapChain = VK_NULL_HANDLE;
 	std::vector<VkImage> swapChainImages;
@@ -381,21 +428,93 @@ private:
 	std::vector<VkSemaphore> renderFinishedSemaphores;
 	std::vector<VkFence> inFlightFences;
 	std::vector<VkFence> imagesInFlight;
+	// Async compute work is recorded alongside each frame's graphics commands
+	// and submitted after them. Rendering in the next use of the same frame
+	// slot waits for it.
+	VkCommandPool computeCommandPool = VK_NULL_HANDLE;
+	std::vector<VkCommandBuffer> computeCommandBuffers;
+	std::vector<VkSemaphore> graphicsToComputeSemaphores;
+	std::vector<VkSemaphore> computeFinishedSemaphores;
+	std::vector<VkFence> computeFences;
+	std::vector<bool> computeFinishedPending;
+	bool computeCommandsRecording = false;
+
+	struct GPUTimerQueryFrame
+	{
+		GPUTimerFrame timer;
+		VkQueryPool queryPool = VK_NULL_HANDLE;
+		bool pending = false;
+	};
+
+	static const int MAX_GPU_TIMESTAMPS = 256;
+
+	std::vector<GPUTimerQueryFrame> gpuTimerFrames;
+	float timestampPeriod = 1.0f;
+
+	// Vulkan queries can't span render passes, so an occlusion query gets a
+	// segment for each render pass it's active in.
+	struct OcclusionQuerySegment
+	{
+		StrongRef<love::graphics::OcclusionQuery> query;
+		uint32 generation;
+	};
+
+	struct OcclusionQueryFrame
+	{
+		VkQueryPool queryPool = VK_NULL_HANDLE;
+		std::vector<OcclusionQuerySegment> segments;
+	};
+
+	static const int MAX_OCCLUSION_QUERY_SEGMENTS = 1024;
+
+	std::vector<OcclusionQueryFrame> occlusionQueryFrames;
+	bool occlusionQuerySegmentOpen = false;
+	bool occlusionQueryPrecise = false;
 	int vsync = 1;
+	// VK_PRESENT_MODE_MAX_ENUM_KHR when the present mode is picked from vsync.
+	VkPresentModeKHR requestedPresentMode = VK_PRESENT_MODE_MAX_ENUM_KHR;
+	VkPresentModeKHR presentMode = VK_PRESENT_MODE_FIFO_KHR;
 	VkDeviceSize minUniformBufferOffsetAlignment = 0;
 	bool imageRequested = false;
+	bool multiDrawIndirectSupported = false;
 	uint32_t frameCounter = 0;
 	size_t currentFrame = 0;
+	uint32_t framesInFlight = 2;
 	uint32_t imageIndex = 0;
 	bool swapChainRecreationRequested = false;
 	bool transitionColorDepthLayouts = false;
 	VmaAllocator vmaAllocator = VK_NULL_HANDLE;
+	std::unique_ptr<BufferPageAllocator> bufferPageAllocator;
 	StrongRef<love::graphics::Buffer> defaultVertexBuffer;
 	StrongRef<StreamBuffer> localUniformBuffer;
 	// functions that need to be called to cleanup objects that were needed for rendering a frame.
 	// We need a vector for each frame in flight.
 	std::vector<std::vector<std::function<void()>>> cleanUpFunctions;
 	std::vector<std::vector<std::function<void()>>> readbackCallbacks;
+
+	struct StagingPage
+	{
+		VkBuffer buffer = VK_NULL_HANDLE;
+		VmaAllocation allocation = VK_NULL_HANDLE;
+		void *data = nullptr;
+		VkDeviceSize size = 0;
+		VkDeviceSize used = 0;
+	};
+
+	struct StagingFrame
+	{
+		std::vector<StagingPage> pages;
+		size_t currentPage = 0;
+	};
+
+	// Uploads bigger than this get a page of their own, which is released
+	// once its frame is done.
+	static constexpr VkDeviceSize STAGING_PAGE_SIZE = 4 * 1024 * 1024;
+
+	void resetStagingMemory(size_t frameIndex);
+	void destroyStagingMemory();
+
+	std::vector<StagingFrame> stagingFrames;
 	std::set<StrongRef<Shader>> usedShadersInFrame;
 	RenderpassState renderPassState;
 };
@@ -188,7 +188,7 @@ bool Shader::loadVolatile()
 	createDescriptorSetLayout();
 	createPipelineLayout();
 	createDescriptorPoolSizes();
-	descriptorPools.resize(MAX_FRAMES_IN_FLIGHT);
+	descriptorPools.resize(vgfx->getFramesInFlight());
 	currentFrame = 0;
 	newFrame();
 
@@ -201,7 +201,7 @@ void Shader::unloadVolatile()
 		return;
 
 	vgfx->queueCleanUp([shaderModules = std::move(shaderModules), device = device, descriptorSetLayout = descriptorSetLayout, pipelineLayout = pipelineLayout,
-		descriptorPools = descriptorPools, computePipeline = computePipeline, graphicsPipelines = std::move(graphicsPipelines)](){
+		descriptorPools = descriptorPools, computePipelines = std::move(computePipelines), graphicsPipelineSets = std::move(graphicsPipelineSets)](){
 		for (const auto &pools : descriptorPools)
 		{
 			for (const auto pool : pools)
@@ -211,15 +211,24 @@ void Shader::unloadVolatile()
 			vkDestroyShaderModule(device, shaderModule, nullptr);
 		vkDestroyDescriptorSetLayout(device, descriptorSetLayout, nullptr);
 		vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
-		if (computePipeline != VK_NULL_HANDLE)
-			vkDestroyPipeline(device, computePipeline, nullptr);
-		for (const auto& kvp : graphicsPipelines)
+		for (const auto &kvp : computePipelines)
 			vkDestroyPipeline(device, kvp.second, nullptr);
+		for (const auto &pipelines : graphicsPipelineSets)
+		{
+			for (const auto &kvp : pipelines.second)
+				vkDestroyPipeline(device, kvp.second, nullptr);
+		}
 	});
 
 	shaderModules.clear();
+	computePipelines.clear();
+	graphicsPipelineSets.clear();
+	graphicsPipelines = nullptr;
+	computePipeline = VK_NULL_HANDLE;
 	shaderStages.clear();
 	descriptorPools.clear();
+	descriptorSetCache.clear();
+	currentDescriptorSet = VK_NULL_HANDLE;
 }
 
 const std::vector<VkPipelineShaderStageCreateInfo> &Shader::getShaderStages() const
@@ -232,18 +241,38 @@ const VkPipelineLayout Shader::getGraphicsPipelineLayout() const
 	return pipelineLayout;
 }
 
-VkPipeline Shader::getComputePipeline() const
+VkPipeline Shader::getComputePipeline()
 {
+	if (computePipeline != VK_NULL_HANDLE)
+		return computePipeline;
+
+	auto it = computePipelines.find(specializationData);
+	if (it != computePipelines.end())
+	{
+		computePipeline = it->second;
+		return computePipeline;
+	}
+
+	VkComputePipelineCreateInfo computeInfo{};
+	computeInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+	computeInfo.stage = shaderStages.at(0);
+	computeInfo.layout = pipelineLayout;
+
+	if (vkCreateComputePipelines(device, vgfx->getPipelineCache(), 1, &computeInfo, nullptr, &computePipeline) != VK_SUCCESS)
+		throw love::Exception("failed to create compute pipeline");
+
+	computePipelines[specializationData] = computePipeline;
 	return computePipeline;
 }
 
 void Shader::newFrame()
 {
-	currentFrame = (currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
+	currentFrame = (currentFrame + 1) % vgfx->getFramesInFlight();
 
 	currentDescriptorPool = 0;
 	currentDescriptorSet = VK_NULL_HANDLE;
 	resourceDescriptorsDirty = true;
+	descriptorSetCache.clear();
 
 	for (VkDescriptorPool pool : descriptorPools[currentFrame])
 		vkResetDescriptorPool(device, pool, 0);
@@ -306,12 +335,24 @@ void Shader::cmdPushDescriptorSets(VkCommandBuffer commandBuffer, VkPipelineBind
 
 	if (resourceDescriptorsDirty || currentDescriptorSet == VK_NULL_HANDLE)
 	{
-		currentDescriptorSet = allocateDescriptorSet();
+		getDescriptorSetContents(descriptorSetContents);
+		uint64 hash = XXH64(descriptorSetContents.data(), descriptorSetContents.size(), 0);
 
-		for (auto &write : descriptorWrites)
-			write.dstSet = currentDescriptorSet;
+		auto it = descriptorSetCache.find(hash);
+		if (it != descriptorSetCache.end() && it->second.contents == descriptorSetContents)
+			currentDescriptorSet = it->second.set;
+		else
+		{
+			currentDescriptorSet = allocateDescriptorSet();
+
+			for (auto &write : descriptorWrites)
+				write.dstSet = currentDescriptorSet;
+
+			vkUpdateDescriptorSets(device, descriptorWrites.size(), descriptorWrites.data(), 0, nullptr);
+
+			descriptorSetCache[hash] = { descriptorSetContents, currentDescriptorSet };
+		}
 
-		vkUpdateDescriptorSets(device, descriptorWrites.size(), descriptorWrites.data(), 0, nullptr);
 		resourceDescriptorsDirty = false;
 	}
 
@@ -354,6 +395,20 @@ void Shader::updateUniform(const UniformInfo *info, int count)
 	if (current == this)
 		Graphics::flushBatchedDrawsGlobal();
 
+	copyUniformData(info, count);
+}
+
+void Shader::updateUniforms(const UniformUpdate *updates, int count)
+{
+	if (current == this)
+		Graphics::flushBatchedDrawsGlobal();
+
+	for (int i = 0; i < count; i++)
+		copyUniformData(updates[i].first, updates[i].second);
+}
+
+void Shader::copyUniformData(const UniformInfo *info, int count)
+{
 	count = std::min(count, info->count);
 
 	if (info->data != nullptr)
@@ -559,6 +614,7 @@ void Shader::compileShaders()
 		tshader->setEnvInputVulkanRulesRelaxed();
 		tshader->setGlobalUniformBinding(0);
 		tshader->setGlobalUniformSet(0);
+		tshader->setPreamble("#define LOVE_SPECIALIZATION_CONSTANTS 1\n");
 
 		auto &glsl = stages[i]->getSource();
 		const char *csrc = glsl.c_str();
@@ -624,6 +680,8 @@ void Shader::compileShaders()
 		auto active = compiler->get_active_interface_variables();
 		auto shaderResources = comp.get_shader_resources();
 
+		reflectSpecializationConstants(comp);
+
 		for (const auto &resource : shaderResources.uniform_buffers)
 		{
 			// TODO: Do something smarter here.
@@ -806,6 +864,8 @@ void Shader::compileShaders()
 		shaderStages.push_back(shaderStageInfo);
 	}
 
+	updateSpecializationInfo();
+
 	int numBuffers = 0;
 	int numTextures = 0;
 	int numBufferViews = 0;
@@ -981,6 +1041,87 @@ void Shader::compileShaders()
 	resourceDescriptorsDirty = true;
 }
 
+void Shader::reflectSpecializationConstants(const spirv_cross::Compiler &comp)
+{
+	for (const auto &sc : comp.get_specialization_constants())
+	{
+		const std::string &name = comp.get_name(sc.id);
+		if (name.empty())
+			continue;
+
+		const auto &constant = comp.get_constant(sc.id);
+		const auto &type = comp.get_type(constant.constant_type);
+
+		SpecializationConstant c = {};
+		c.id = sc.constant_id;
+
+		switch (type.basetype)
+		{
+		case spirv_cross::SPIRType::Float:
+			c.baseType = DATA_BASETYPE_FLOAT;
+			c.value.f = constant.scalar_f32();
+			break;
+		case spirv_cross::SPIRType::Int:
+			c.baseType = DATA_BASETYPE_INT;
+			c.value.i = constant.scalar_i32();
+			break;
+		case spirv_cross::SPIRType::UInt:
+			c.baseType = DATA_BASETYPE_UINT;
+			c.value.u = constant.scalar();
+			break;
+		case spirv_cross::SPIRType::Boolean:
+			c.baseType = DATA_BASETYPE_BOOL;
+			c.value.u = constant.scalar() != 0 ? 1 : 0;
+			break;
+		default:
+			throw love::Exception("Shader specialization constant '%s' must be a float, int, uint, or bool.", name.c_str());
+		}
+
+		for (const auto &kvp : specializationConstants)
+		{
+			if (kvp.second.id == c.id && kvp.first != name)
+				throw love::Exception("Shader specialization constants '%s' and '%s' use the same id.", kvp.first.c_str(), name.c_str());
+		}
+
+		// Keep values which were set before the shader was reloaded.
+		if (specializationConstants.find(name) == specializationConstants.end())
+			specializationConstants[name] = c;
+	}
+}
+
+void Shader::updateSpecializationInfo()
+{
+	getSpecializationData(specializationData);
+
+	specializationEntries.clear();
+	for (const auto &kvp : specializationConstants)
+	{
+		VkSpecializationMapEntry entry{};
+		entry.constantID = kvp.second.id;
+		entry.offset = (uint32) (specializationEntries.size() * sizeof(uint32));
+		entry.size = sizeof(uint32);
+		specializationEntries.push_back(entry);
+	}
+
+	specializationInfo.mapEntryCount = (uint32) specializationEntries.size();
+	specializationInfo.pMapEntries = specializationEntries.data();
+	specializationInfo.dataSize = specializationData.size() * sizeof(uint32);
+	specializationInfo.pData = specializationData.data();
+
+	for (auto &stage : shaderStages)
+		stage.pSpecializationInfo = specializationEntries.empty() ? nullptr : &specializationInfo;
+
+	graphicsPipelines = &graphicsPipelineSets[specializationData];
+	computePipeline = VK_NULL_HANDLE;
+}
+
+void Shader::specializationConstantsChanged()
+{
+	// Pipelines for the new values are created (or found) when they're next
+	// used; the shader modules themselves don't change.
+	updateSpecializationInfo();
+}
+
 void Shader::createDescriptorSetLayout()
 {
 	std::vector<VkDescriptorSetLayoutBinding> bindings;
@@ -1040,14 +1181,7 @@ void Shader::createPipelineLayout()
 	if (isCompute)
 	{
 		assert(shaderStages.size() == 1);
-
-		VkComputePipelineCreateInfo computeInfo{};
-		computeInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
-		computeInfo.stage = shaderStages.at(0);
-		computeInfo.layout = pipelineLayout;
-
-		if (vkCreateComputePipelines(device, VK_NULL_HANDLE, 1, &computeInfo, nullptr, &computePipeline) != VK_SUCCESS)
-			throw love::Exception("failed to create compute pipeline");
+		getComputePipeline();
 	}
 }
 
@@ -1172,6 +1306,35 @@ void Shader::createDescriptorPool()
 	descriptorPools[currentFrame].push_back(pool);
 }
 
+void Shader::getDescriptorSetContents(std::vector<uint8> &contents) const
+{
+	// Fields are copied individually since the structs can have padding.
+	contents.clear();
+
+	auto append = [&](const void *data, size_t size)
+	{
+		const uint8 *bytes = (const uint8 *) data;
+		contents.insert(contents.end(), bytes, bytes + size);
+	};
+
+	for (const auto &info : descriptorBuffers)
+	{
+		append(&info.buffer, sizeof(info.buffer));
+		append(&info.offset, sizeof(info.offset));
+		append(&info.range, sizeof(info.range));
+	}
+
+	for (const auto &info : descriptorImages)
+	{
+		append(&info.sampler, sizeof(info.sampler));
+		append(&info.imageView, sizeof(info.imageView));
+		append(&info.imageLayout, sizeof(info.imageLayout));
+	}
+
+	for (const auto &view : descriptorBufferViews)
+		append(&view, sizeof(view));
+}
+
 VkDescriptorSet Shader::allocateDescriptorSet()
 {
 	if (descriptorPools[currentFrame].empty())
@@ -1205,12 +1368,12 @@ VkDescriptorSet Shader::allocateDescriptorSet()
 
 VkPipeline Shader::getCachedGraphicsPipeline(Graphics *vgfx, const GraphicsPipelineConfiguration &configuration)
 {
-	auto it = graphicsPipelines.find(configuration);
-	if (it != graphicsPipelines.end())
+	auto it = graphicsPipelines->find(configuration);
+	if (it != graphicsPipelines->end())
 		return it->second;
 
 	VkPipeline pipeline = vgfx->createGraphicsPipeline(this, configuration);
-	graphicsPipelines.insert({ configuration, pipeline });
+	graphicsPipelines->insert({ configuration, pipeline });
 	
 	return pipeline;
 }
@@ -105,7 +105,7 @@ public:
 	bool loadVolatile() override;
 	void unloadVolatile() override;
 
-	VkPipeline getComputePipeline() const;
+	VkPipeline getComputePipeline();
 
 	const std::vector<VkPipelineShaderStageCreateInfo> &getShaderStages() const;
 
@@ -127,6 +127,7 @@ public:
 	const UniformInfo *getUniformInfo(BuiltinUniform builtin) const override;
 
 	void updateUniform(const UniformInfo *info, int count) override;
+	void updateUniforms(const UniformUpdate *updates, int count) override;
 
 	void sendTextures(const UniformInfo *info, graphics::Texture **textures, int count) override;
 	void sendBuffers(const UniformInfo *info, love::graphics::Buffer **buffers, int count) override;
@@ -145,6 +146,13 @@ private:
 	void buildLocalUniforms(spirv_cross::Compiler &comp, const spirv_cross::SPIRType &type, size_t baseoff, const std::string &basename);
 	void createDescriptorPool();
 	VkDescriptorSet allocateDescriptorSet();
+	void getDescriptorSetContents(std::vector<uint8> &contents) const;
+
+	void copyUniformData(const UniformInfo *info, int count);
+
+	void reflectSpecializationConstants(const spirv_cross::Compiler &comp);
+	void updateSpecializationInfo();
+	void specializationConstantsChanged() override;
 
 	void setTextureDescriptor(const UniformInfo *info, love::graphics::Texture *texture, int index);
 	void setBufferDescriptor(const UniformInfo *info, love::graphics::Buffer *buffer, int index);
@@ -162,6 +170,18 @@ private:
 	std::vector<VkBufferView> descriptorBufferViews;
 	std::vector<VkWriteDescriptorSet> descriptorWrites;
 
+	struct CachedDescriptorSet
+	{
+		std::vector<uint8> contents;
+		VkDescriptorSet set;
+	};
+
+	// Descriptor sets written during the current frame, keyed by a hash of
+	// their contents. Switching back to a combination of resources that was
+	// already used this frame re-binds its set instead of writing a new one.
+	std::unordered_map<uint64, CachedDescriptorSet> descriptorSetCache;
+	std::vector<uint8> descriptorSetContents;
+
 	std::vector<VkPipelineShaderStageCreateInfo> shaderStages;
 	std::vector<VkShaderModule> shaderModules;
 
@@ -182,7 +202,17 @@ private:
 
 	std::unordered_map<std::string, AttributeInfo> attributes;
 
-	std::unordered_map<GraphicsPipelineConfiguration, VkPipeline, GraphicsPipelineConfigurationHasher> graphicsPipelines;
+	typedef std::unordered_map<GraphicsPipelineConfiguration, VkPipeline, GraphicsPipelineConfigurationHasher> GraphicsPipelineMap;
+
+	// Pipelines are created separately for each set of specialization
+	// constant values, keyed by those values.
+	std::map<std::vector<uint32>, GraphicsPipelineMap> graphicsPipelineSets;
+	std::map<std::vector<uint32>, VkPipeline> computePipelines;
+	GraphicsPipelineMap *graphicsPipelines = nullptr;
+
+	std::vector<VkSpecializationMapEntry> specializationEntries;
+	std::vector<uint32> specializationData;
+	VkSpecializationInfo specializationInfo{};
 
 	uint32_t currentFrame = 0;
 	uint32_t currentDescriptorPool = 0;
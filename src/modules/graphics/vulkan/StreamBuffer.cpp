@@ -51,13 +51,18 @@ StreamBuffer::StreamBuffer(graphics::Graphics *gfx, BufferUsage mode, size_t siz
 bool StreamBuffer::loadVolatile()
 {
 	allocator = vgfx->getVmaAllocator();
+	framesInFlight = (int) vgfx->getFramesInFlight();
 
 	VkBufferCreateInfo bufferInfo{};
 	bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-	bufferInfo.size = getSize() * MAX_FRAMES_IN_FLIGHT; // TODO: Is this sufficient or should it be +1?
+	bufferInfo.size = getSize() * framesInFlight; // TODO: Is this sufficient or should it be +1?
 	bufferInfo.usage = getUsageFlags(mode);
 	bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
+	// Compute shaders read their uniforms from here.
+	if (mode == BUFFERUSAGE_UNIFORM)
+		vgfx->setQueueFamilySharing(bufferInfo.sharingMode, bufferInfo.queueFamilyIndexCount, bufferInfo.pQueueFamilyIndices);
+
 	VmaAllocationCreateInfo allocCreateInfo = {};
 	allocCreateInfo.usage = VMA_MEMORY_USAGE_AUTO;
 	allocCreateInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
@@ -128,8 +133,14 @@ void StreamBuffer::markUsed(size_t usedSize)
 
 void StreamBuffer::nextFrame()
 {
-	frameIndex = (frameIndex + 1) % MAX_FRAMES_IN_FLIGHT;
+	frameIndex = (frameIndex + 1) % framesInFlight;
 	frameGPUReadOffset = 0;
+	frameStallCount = 0;
+}
+
+size_t StreamBuffer::getMemorySize() const
+{
+	return bufferSize * framesInFlight;
 }
 
 } // vulkan
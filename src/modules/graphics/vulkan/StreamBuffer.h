@@ -54,6 +54,8 @@ public:
 
 	void nextFrame() override;
 
+	size_t getMemorySize() const override;
+
 	ptrdiff_t getHandle() const override;
 
 private:
@@ -63,6 +65,7 @@ private:
 	VmaAllocationInfo allocInfo;
 	VkBuffer buffer = VK_NULL_HANDLE;
 	int frameIndex = 0;
+	int framesInFlight = 1;
 	bool coherent;
 
 };
@@ -23,6 +23,7 @@
 #include "Vulkan.h"
 
 #include <limits>
+#include <numeric>
 
 namespace love
 {
@@ -90,6 +91,16 @@ bool Texture::loadVolatile()
 			usageFlags |= VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
 	}
 
+	// Transient attachments can only be used as attachments, which lets them
+	// use lazily allocated memory on tile-based GPUs. Readable MSAA textures
+	// are sampled directly in this backend, so they can't be transient.
+	bool transient = memoryless && !readable;
+	if (transient)
+	{
+		usageFlags &= ~(VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT);
+		usageFlags |= VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+	}
+
 	layerCount = 1;
 
 	if (texType == TEXTURE_2D_ARRAY)
@@ -133,6 +144,10 @@ bool Texture::loadVolatile()
 		imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 		imageInfo.samples = msaaSamples;
 
+		// Only textures a compute shader can access need to be shared.
+		if (readable || computeWrite)
+			vgfx->setQueueFamilySharing(imageInfo.sharingMode, imageInfo.queueFamilyIndexCount, imageInfo.pQueueFamilyIndices);
+
 		VkImageFormatListCreateInfo viewFormatsInfo{};
 		viewFormatsInfo.sType = VK_STRUCTURE_TYPE_IMAGE_FORMAT_LIST_CREATE_INFO;
 
@@ -145,8 +160,30 @@ bool Texture::loadVolatile()
 		}
 
 		VmaAllocationCreateInfo imageAllocationCreateInfo{};
+		imageAllocationCreateInfo.flags = vgfx->getBudgetAllocationFlags();
+
+		VkResult result = VK_ERROR_OUT_OF_DEVICE_MEMORY;
+
+		if (transient)
+		{
+			VmaAllocationCreateInfo lazyAllocationCreateInfo{};
+			lazyAllocationCreateInfo.usage = VMA_MEMORY_USAGE_GPU_LAZILY_ALLOCATED;
+			result = vmaCreateImage(allocator, &imageInfo, &lazyAllocationCreateInfo, &textureImage, &textureImageAllocation, nullptr);
+		}
+
+		// Not all devices have lazily allocated memory.
+		if (result != VK_SUCCESS)
+			result = vmaCreateImage(allocator, &imageInfo, &imageAllocationCreateInfo, &textureImage, &textureImageAllocation, nullptr);
 
-		if (vmaCreateImage(allocator, &imageInfo, &imageAllocationCreateInfo, &textureImage, &textureImageAllocation, nullptr) != VK_SUCCESS)
+		if (result == VK_ERROR_OUT_OF_DEVICE_MEMORY && (imageAllocationCreateInfo.flags & VMA_ALLOCATION_CREATE_WITHIN_BUDGET_BIT))
+		{
+			// Over budget: free what we can and let the driver decide.
+			vgfx->purgeUnusedTemporaryResources();
+			imageAllocationCreateInfo.flags &= ~VMA_ALLOCATION_CREATE_WITHIN_BUDGET_BIT;
+			result = vmaCreateImage(allocator, &imageInfo, &imageAllocationCreateInfo, &textureImage, &textureImageAllocation, nullptr);
+		}
+
+		if (result != VK_SUCCESS)
 			throw love::Exception("failed to create image");
 
 		auto commandBuffer = vgfx->getCommandBufferForDataTransfer();
@@ -187,7 +224,7 @@ bool Texture::loadVolatile()
 				}
 			}
 		}
-		else
+		else if (!transient)
 			clear();
 	}
 	else
@@ -525,25 +562,15 @@ void Texture::generateMipmapsInternal()
 
 void Texture::uploadByteData(const void *data, size_t size, int level, int slice, const Rect &r)
 {
-	VkBuffer stagingBuffer;
-	VmaAllocation vmaAllocation;
-
-	VkBufferCreateInfo bufferCreateInfo{};
-	bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-	bufferCreateInfo.size = size;
-	bufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+	// Copy offsets must be a multiple of both 4 and the texel block size.
+	VkDeviceSize alignment = std::lcm((VkDeviceSize) getPixelFormatBlockSize(getPixelFormat()), (VkDeviceSize) 4);
+	StagingAllocation staging = vgfx->allocateStagingMemory(size, alignment);
 
-	VmaAllocationCreateInfo allocCreateInfo = {};
-	allocCreateInfo.usage = VMA_MEMORY_USAGE_AUTO;
-	allocCreateInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
-
-	VmaAllocationInfo allocInfo;
-	vmaCreateBuffer(allocator, &bufferCreateInfo, &allocCreateInfo, &stagingBuffer, &vmaAllocation, &allocInfo);
-
-	memcpy(allocInfo.pMappedData, data, size);
+	memcpy(staging.data, data, size);
+	vgfx->flushStagingMemory(staging, 0, size);
 
 	VkBufferImageCopy region{};
-	region.bufferOffset = 0;
+	region.bufferOffset = staging.offset;
 	region.bufferRowLength = 0;
 	region.bufferImageHeight = 0;
 
@@ -577,7 +604,7 @@ void Texture::uploadByteData(const void *data, size_t size, int level, int slice
 
 		vkCmdCopyBufferToImage(
 			commandBuffer,
-			stagingBuffer,
+			staging.buffer,
 			textureImage,
 			VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
 			1,
@@ -591,16 +618,12 @@ void Texture::uploadByteData(const void *data, size_t size, int level, int slice
 	else
 		vkCmdCopyBufferToImage(
 			commandBuffer,
-			stagingBuffer,
+			staging.buffer,
 			textureImage,
 			imageLayout,
 			1,
 			&region
 		);
-
-	vgfx->queueCleanUp([allocator = allocator, stagingBuffer, vmaAllocation]() {
-		vmaDestroyBuffer(allocator, stagingBuffer, vmaAllocation);
-	});
 }
 
 void Texture::copyFromBuffer(graphics::Buffer *source, size_t sourceoffset, int sourcewidth, size_t size, int slice, int mipmap, const Rect &rect)
@@ -614,7 +637,7 @@ void Texture::copyFromBuffer(graphics::Buffer *source, size_t sourceoffset, int
 	layers.layerCount = 1;
 
 	VkBufferImageCopy region{};
-	region.bufferOffset = sourceoffset;
+	region.bufferOffset = source->getHandleOffset() + sourceoffset;
 	region.bufferRowLength = sourcewidth;
 	region.bufferImageHeight = 1;
 	region.imageSubresource = layers;
@@ -644,7 +667,7 @@ void Texture::copyToBuffer(graphics::Buffer *dest, int slice, int mipmap, const
 	layers.layerCount = 1;
 
 	VkBufferImageCopy region{};
-	region.bufferOffset = destoffset;
+	region.bufferOffset = dest->getHandleOffset() + destoffset;
 	region.bufferRowLength = destwidth;
 	region.bufferImageHeight = 0;
 	region.imageSubresource = layers;
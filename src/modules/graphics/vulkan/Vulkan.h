@@ -49,7 +49,17 @@ struct TextureFormat
 	VkComponentSwizzle swizzleA = VK_COMPONENT_SWIZZLE_IDENTITY;
 };
 
-constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 2;
+// A range of host visible memory handed out by Graphics::allocateStagingMemory.
+struct StagingAllocation
+{
+	VkBuffer buffer = VK_NULL_HANDLE;
+	VmaAllocation allocation = VK_NULL_HANDLE;
+	VkDeviceSize offset = 0;
+	void *data = nullptr;
+};
+
+// Upper limit for love::graphics::getFramesInFlight.
+constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 3;
 
 class Vulkan
 {
@@ -453,5 +453,38 @@ extern "C" int luaopen_graphicsbuffer(lua_State *L)
 	return luax_register_type(L, &Buffer::type, w_Buffer_functions, nullptr);
 }
 
+static BufferUpload *luax_checkbufferupload(lua_State *L, int idx)
+{
+	return luax_checktype<BufferUpload>(L, idx);
+}
+
+static int w_BufferUpload_isComplete(lua_State *L)
+{
+	BufferUpload *upload = luax_checkbufferupload(L, 1);
+	bool complete = false;
+	luax_catchexcept(L, [&]() { complete = upload->isComplete(); });
+	luax_pushboolean(L, complete);
+	return 1;
+}
+
+static int w_BufferUpload_getBuffer(lua_State *L)
+{
+	BufferUpload *upload = luax_checkbufferupload(L, 1);
+	luax_pushtype(L, upload->getBuffer());
+	return 1;
+}
+
+static const luaL_Reg w_BufferUpload_functions[] =
+{
+	{ "isComplete", w_BufferUpload_isComplete },
+	{ "getBuffer", w_BufferUpload_getBuffer },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_bufferupload(lua_State *L)
+{
+	return luax_register_type(L, &BufferUpload::type, w_BufferUpload_functions, nullptr);
+}
+
 } // graphics
 } // love
@@ -34,6 +34,7 @@ void luax_readbufferdata(lua_State *L, DataFormat format, const char *data);
 
 Buffer *luax_checkbuffer(lua_State *L, int idx);
 extern "C" int luaopen_graphicsbuffer(lua_State *L);
+extern "C" int luaopen_bufferupload(lua_State *L);
 
 } // graphics
 } // love
@@ -257,6 +257,68 @@ int w_Font_setFallbacks(lua_State *L)
 	return 0;
 }
 
+int w_Font_preload(lua_State *L)
+{
+	Font *t = luax_checkfont(L, 1);
+	Font::Codepoints codepoints;
+
+	int count = std::max(lua_gettop(L) - 1, 1);
+
+	luax_catchexcept(L, [&]() {
+		for (int i = 2; i < count + 2; i++)
+		{
+			if (lua_type(L, i) == LUA_TSTRING)
+				love::font::getCodepointsFromString(luax_checkstring(L, i), codepoints);
+			else if (lua_istable(L, i))
+			{
+				// A {first, last} range of codepoints.
+				lua_rawgeti(L, i, 1);
+				lua_rawgeti(L, i, 2);
+				uint32 first = (uint32) luaL_checknumber(L, -2);
+				uint32 last = (uint32) luaL_checknumber(L, -1);
+				lua_pop(L, 2);
+
+				for (uint32 c = first; c <= last && c >= first; c++)
+					codepoints.push_back(c);
+			}
+			else
+				codepoints.push_back((uint32) luaL_checknumber(L, i));
+		}
+
+		t->preload(codepoints);
+	});
+
+	return 0;
+}
+
+int w_Font_isPreloading(lua_State *L)
+{
+	Font *t = luax_checkfont(L, 1);
+	luax_pushboolean(L, t->isPreloading());
+	return 1;
+}
+
+int w_Font_setAsyncGlyphLoading(lua_State *L)
+{
+	Font *t = luax_checkfont(L, 1);
+	t->setAsyncGlyphLoading(luax_checkboolean(L, 2));
+	return 0;
+}
+
+int w_Font_isAsyncGlyphLoading(lua_State *L)
+{
+	Font *t = luax_checkfont(L, 1);
+	luax_pushboolean(L, t->isAsyncGlyphLoading());
+	return 1;
+}
+
+int w_Font_isSDF(lua_State *L)
+{
+	Font *t = luax_checkfont(L, 1);
+	luax_pushboolean(L, t->isSDF());
+	return 1;
+}
+
 int w_Font_getDPIScale(lua_State *L)
 {
 	Font *t = luax_checkfont(L, 1);
@@ -279,7 +341,12 @@ static const luaL_Reg w_Font_functions[] =
 	{ "hasGlyphs", w_Font_hasGlyphs },
 	{ "getKerning", w_Font_getKerning },
 	{ "setFallbacks", w_Font_setFallbacks },
+	{ "preload", w_Font_preload },
+	{ "isPreloading", w_Font_isPreloading },
+	{ "setAsyncGlyphLoading", w_Font_setAsyncGlyphLoading },
+	{ "isAsyncGlyphLoading", w_Font_isAsyncGlyphLoading },
 	{ "getDPIScale", w_Font_getDPIScale },
+	{ "isSDF", w_Font_isSDF },
 	{ 0, 0 }
 };
 
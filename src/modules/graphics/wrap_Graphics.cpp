@@ -23,6 +23,7 @@
 #include "Texture.h"
 #include "image/ImageData.h"
 #include "image/Image.h"
+#include "image/ImageDataEncode.h"
 #include "font/Rasterizer.h"
 #include "filesystem/Filesystem.h"
 #include "filesystem/wrap_Filesystem.h"
@@ -31,6 +32,7 @@
 #include "common/Reference.h"
 #include "math/wrap_Transform.h"
 #include "thread/wrap_Channel.h"
+#include "libraries/xxHash/xxhash.h"
 
 #include "opengl/Graphics.h"
 
@@ -46,6 +48,22 @@ static const char graphics_lua[] =
 #include "wrap_Graphics.lua"
 ;
 
+static const char graphics_capture_lua[] =
+#include "wrap_GraphicsCapture.lua"
+;
+
+static const char graphics_dynamicresolution_lua[] =
+#include "wrap_GraphicsDynamicResolution.lua"
+;
+
+static const char graphics_imageprocessing_lua[] =
+#include "wrap_GraphicsImageProcessing.lua"
+;
+
+static const char graphics_recording_lua[] =
+#include "wrap_GraphicsRecording.lua"
+;
+
 namespace love
 {
 namespace graphics
@@ -262,6 +280,24 @@ static Graphics::RenderTarget checkRenderTarget(lua_State *L, int idx)
 
 	target.mipmap = luax_intflag(L, idx, "mipmap", 1) - 1;
 
+	lua_getfield(L, idx, "load");
+	if (!lua_isnoneornil(L, -1))
+	{
+		const char *str = luaL_checkstring(L, -1);
+		if (!Graphics::getConstant(str, target.loadAction))
+			luax_enumerror(L, "load action", Graphics::getConstants(target.loadAction), str);
+	}
+	lua_pop(L, 1);
+
+	lua_getfield(L, idx, "store");
+	if (!lua_isnoneornil(L, -1))
+	{
+		const char *str = luaL_checkstring(L, -1);
+		if (!Graphics::getConstant(str, target.storeAction))
+			luax_enumerror(L, "store action", Graphics::getConstants(target.storeAction), str);
+	}
+	lua_pop(L, 1);
+
 	return target;
 }
 
@@ -378,6 +414,13 @@ static void pushRenderTarget(lua_State *L, const Graphics::RenderTarget &rt)
 
 	lua_pushnumber(L, rt.mipmap + 1);
 	lua_setfield(L, -2, "mipmap");
+
+	const char *store = nullptr;
+	if (rt.storeAction != Graphics::STORE_ACTION_STORE && Graphics::getConstant(rt.storeAction, store))
+	{
+		lua_pushstring(L, store);
+		lua_setfield(L, -2, "store");
+	}
 }
 
 int w_getCanvas(lua_State *L)
@@ -397,7 +440,7 @@ int w_getCanvas(lua_State *L)
 	{
 		for (const auto &rt : targets.colors)
 		{
-			if (rt.mipmap != 0 || rt.texture->getTextureType() != TEXTURE_2D)
+			if (rt.mipmap != 0 || rt.texture->getTextureType() != TEXTURE_2D || rt.storeAction != Graphics::STORE_ACTION_STORE)
 			{
 				shouldUseTablesVariant = true;
 				break;
@@ -469,9 +512,12 @@ static void screenshotFileCallback(const Graphics::ScreenshotInfo *info, love::i
 
 	if (i != nullptr && fileinfo != nullptr)
 	{
+		// Encoding happens on love.image's worker threads, which also report
+		// any errors, so the frame doesn't wait for it.
 		try
 		{
-			i->encode(fileinfo->format, fileinfo->filename.c_str(), true);
+			image::ImageDataEncode *encode = new image::ImageDataEncode(i, fileinfo->format, fileinfo->filename, true, 1);
+			encode->release();
 		}
 		catch (love::Exception &e)
 		{
@@ -551,6 +597,13 @@ int w_captureScreenshot(lua_State *L)
 	return 0;
 }
 
+int w_captureBackbuffer(lua_State *L)
+{
+	Texture *t = luax_checktexture(L, 1);
+	luax_catchexcept(L, [&]() { instance()->captureBackbuffer(t); });
+	return 0;
+}
+
 int w_setScissor(lua_State *L)
 {
 	int nargs = lua_gettop(L);
@@ -604,6 +657,31 @@ int w_getScissor(lua_State *L)
 	return 4;
 }
 
+int w_pushClip(lua_State *L)
+{
+	float x = (float) luaL_checknumber(L, 1);
+	float y = (float) luaL_checknumber(L, 2);
+	float w = (float) luaL_checknumber(L, 3);
+	float h = (float) luaL_checknumber(L, 4);
+
+	bool stencil = false;
+	luax_catchexcept(L, [&]() { stencil = instance()->pushClip(x, y, w, h); });
+	luax_pushboolean(L, stencil);
+	return 1;
+}
+
+int w_popClip(lua_State *L)
+{
+	luax_catchexcept(L, [&]() { instance()->popClip(); });
+	return 0;
+}
+
+int w_getClipDepth(lua_State *L)
+{
+	lua_pushinteger(L, instance()->getClipDepth());
+	return 1;
+}
+
 int w_setStencilMode(lua_State *L)
 {
 	if (lua_gettop(L) <= 1 && lua_isnoneornil(L, 1))
@@ -738,6 +816,61 @@ getImageData(lua_State *L, int idx, bool allowcompressed, float *dpiscale)
 	return std::make_pair(idata, cdata);
 }
 
+// Compresses ImageData for a Texture. The result is cached in the save
+// directory, so the same pixels only need to be compressed once.
+static StrongRef<image::CompressedImageData> compressTextureData(image::ImageData *data, PixelFormat format, bool mipmaps)
+{
+	auto imagemodule = Module::getInstance<image::Image>(Module::M_IMAGE);
+	auto fs = Module::getInstance<filesystem::Filesystem>(Module::M_FILESYSTEM);
+
+	if (imagemodule == nullptr)
+		throw love::Exception("Cannot compress images without the love.image module.");
+
+	int64 key[] = {data->getWidth(), data->getHeight(), data->getFormat(), format, mipmaps};
+	uint64 seed = XXH64(key, sizeof(key), 0);
+	uint64 hash = XXH64(data->getReadOnlyData(), data->getSize(), seed);
+
+	char filename[64];
+	snprintf(filename, sizeof(filename), "texturecache/%016llx.dds", (unsigned long long) hash);
+
+	StrongRef<image::CompressedImageData> cdata;
+
+	if (fs != nullptr && fs->exists(filename))
+	{
+		try
+		{
+			StrongRef<filesystem::FileData> filedata(fs->read(filename), Acquire::NORETAIN);
+			cdata.set(imagemodule->newCompressedData(filedata), Acquire::NORETAIN);
+		}
+		catch (love::Exception &)
+		{
+			// Fall back to compressing again if the cached file is unusable.
+		}
+	}
+
+	if (cdata.get() == nullptr)
+	{
+		StrongRef<filesystem::FileData> filedata(data->encodeCompressed(format, mipmaps, filename), Acquire::NORETAIN);
+		cdata.set(imagemodule->newCompressedData(filedata), Acquire::NORETAIN);
+
+		if (fs != nullptr)
+		{
+			try
+			{
+				fs->createDirectory("texturecache");
+				fs->write(filename, filedata->getData(), filedata->getSize());
+			}
+			catch (love::Exception &)
+			{
+				// The cache is optional, e.g. when no save directory is set.
+			}
+		}
+	}
+
+	cdata->setLinear(data->isLinear());
+	return cdata;
+}
+
 static int w__pushNewTexture(lua_State *L, Texture::Slices *slices, const Texture::Settings &settings)
 {
 	StrongRef<Texture> i;
@@ -780,6 +913,15 @@ static void luax_checktexturesettings(lua_State *L, int idx, bool opt, bool chec
 	}
 	lua_pop(L, 1);
 
+	lua_getfield(L, idx, Texture::getConstant(Texture::SETTING_COMPRESS));
+	if (!lua_isnoneornil(L, -1))
+	{
+		const char *str = luaL_checkstring(L, -1);
+		if (!getConstant(str, s.compressFormat))
+			luax_enumerror(L, "pixel format", str);
+	}
+	lua_pop(L, 1);
+
 	if (checkType)
 	{
 		lua_getfield(L, idx, Texture::getConstant(Texture::SETTING_TYPE));
@@ -830,6 +972,7 @@ static void luax_checktexturesettings(lua_State *L, int idx, bool opt, bool chec
 	s.msaa = luax_intflag(L, idx, Texture::getConstant(Texture::SETTING_MSAA), s.msaa);
 
 	s.computeWrite = luax_boolflag(L, idx, Texture::getConstant(Texture::SETTING_COMPUTE_WRITE), s.computeWrite);
+	s.memoryless = luax_boolflag(L, idx, Texture::getConstant(Texture::SETTING_MEMORYLESS), s.memoryless);
 
 	lua_getfield(L, idx, Texture::getConstant(Texture::SETTING_VIEW_FORMATS));
 	if (!lua_isnoneornil(L, -1))
@@ -907,6 +1050,49 @@ int w_newCanvas(lua_State *L)
 	return 1;
 }
 
+int w_getTemporaryCanvas(lua_State *L)
+{
+	luax_checkgraphicscreated(L);
+
+	int w = (int) luaL_optinteger(L, 1, instance()->getPixelWidth());
+	int h = (int) luaL_optinteger(L, 2, instance()->getPixelHeight());
+
+	PixelFormat format = PIXELFORMAT_NORMAL;
+	int msaa = 1;
+	bool memoryless = false;
+
+	if (!lua_isnoneornil(L, 3))
+	{
+		luaL_checktype(L, 3, LUA_TTABLE);
+
+		lua_getfield(L, 3, Texture::getConstant(Texture::SETTING_FORMAT));
+		if (!lua_isnoneornil(L, -1))
+		{
+			const char *str = luaL_checkstring(L, -1);
+			if (!getConstant(str, format))
+				luax_enumerror(L, "pixel format", str);
+		}
+		lua_pop(L, 1);
+
+		msaa = luax_intflag(L, 3, Texture::getConstant(Texture::SETTING_MSAA), msaa);
+		memoryless = luax_boolflag(L, 3, Texture::getConstant(Texture::SETTING_MEMORYLESS), memoryless);
+	}
+
+	Texture *texture = nullptr;
+	luax_catchexcept(L, [&](){ texture = instance()->getTemporaryTexture(format, w, h, msaa > 1 ? msaa : 0, memoryless, true); });
+
+	// The temporary texture pool keeps its own reference.
+	luax_pushtype(L, texture);
+	return 1;
+}
+
+int w_releaseTemporaryCanvas(lua_State *L)
+{
+	Texture *texture = luax_checktexture(L, 1);
+	instance()->releaseTemporaryTexture(texture);
+	return 0;
+}
+
 int w_newTexture(lua_State *L)
 {
 	luax_checkgraphicscreated(L);
@@ -958,6 +1144,18 @@ int w_newTexture(lua_State *L)
 		else
 		{
 			auto data = getImageData(L, 1, true, autodpiscale);
+
+			if (data.first.get() && settings.compressFormat != PIXELFORMAT_UNKNOWN)
+			{
+				bool mipmaps = settings.mipmaps != Texture::MIPMAPS_NONE;
+				luax_catchexcept(L, [&]() { data.second = compressTextureData(data.first, settings.compressFormat, mipmaps); });
+				data.first.set(nullptr);
+
+				// Compressed textures can't generate their own mipmaps.
+				if (mipmaps)
+					settings.mipmaps = Texture::MIPMAPS_MANUAL;
+			}
+
 			if (data.first.get())
 				slices.set(0, 0, data.first);
 			else
@@ -968,6 +1166,105 @@ int w_newTexture(lua_State *L)
 	return w__pushNewTexture(L, slicesref, settings);
 }
 
+int w_newTextureAsync(lua_State *L)
+{
+	luax_checkgraphicscreated(L);
+
+	Texture::Settings settings;
+	settings.type = TEXTURE_2D;
+	bool dpiscaleset = false;
+
+	luax_checktexturesettings(L, 2, true, false, false, OptionalBool(), settings, dpiscaleset);
+	float *autodpiscale = dpiscaleset ? nullptr : &settings.dpiScale;
+
+	StrongRef<image::ImageData> data = getImageData(L, 1, false, autodpiscale).first;
+
+	// The Texture is created without data and filled asynchronously, so its
+	// size and format need to be spelled out here.
+	settings.format = data->getFormat();
+	if (isGammaCorrect() && !data->isLinear())
+		settings.format = getSRGBPixelFormat(settings.format);
+
+	settings.width = (int) (data->getWidth() / settings.dpiScale + 0.5);
+	settings.height = (int) (data->getHeight() / settings.dpiScale + 0.5);
+
+	StrongRef<TextureUpload> upload;
+	luax_catchexcept(L, [&]() { upload.set(instance()->newTextureAsync(settings, data), Acquire::NORETAIN); });
+
+	luax_pushtype(L, upload->getTexture());
+	luax_pushtype(L, upload);
+	return 2;
+}
+
+int w_newStreamingTexture(lua_State *L)
+{
+	luax_checkgraphicscreated(L);
+
+	Texture::Settings settings;
+	settings.type = TEXTURE_2D;
+	bool dpiscaleset = false;
+
+	luax_checktexturesettings(L, 2, true, false, false, OptionalBool(false), settings, dpiscaleset);
+	float *autodpiscale = dpiscaleset ? nullptr : &settings.dpiScale;
+
+	auto data = getImageData(L, 1, true, autodpiscale);
+	if (data.second.get() == nullptr)
+		return luaL_argerror(L, 1, "streaming textures require compressed image data with mipmaps (e.g. KTX or DDS)");
+
+	StreamingTexture *t = nullptr;
+	luax_catchexcept(L, [&]() { t = instance()->newStreamingTexture(data.second, settings); });
+
+	luax_pushtype(L, t);
+	t->release();
+	return 1;
+}
+
+int w_newVirtualTexture(lua_State *L)
+{
+	luax_checkgraphicscreated(L);
+
+	int width = (int) luaL_checkinteger(L, 1);
+	int height = (int) luaL_checkinteger(L, 2);
+
+	VirtualTexture::Settings settings;
+
+	if (!lua_isnoneornil(L, 3))
+	{
+		luaL_checktype(L, 3, LUA_TTABLE);
+
+		settings.tileSize = luax_intflag(L, 3, "tilesize", settings.tileSize);
+		settings.cacheSize = luax_intflag(L, 3, "cachesize", settings.cacheSize);
+		settings.uploadsPerFrame = luax_intflag(L, 3, "uploadsperframe", settings.uploadsPerFrame);
+		settings.linear = luax_boolflag(L, 3, "linear", settings.linear);
+
+		lua_getfield(L, 3, "format");
+		if (!lua_isnoneornil(L, -1))
+		{
+			const char *str = luaL_checkstring(L, -1);
+			if (!getConstant(str, settings.format))
+				luax_enumerror(L, "pixel format", str);
+		}
+		lua_pop(L, 1);
+
+		lua_getfield(L, 3, "path");
+		if (!lua_isnoneornil(L, -1))
+			settings.tilePath = luaL_checkstring(L, -1);
+		lua_pop(L, 1);
+
+		lua_getfield(L, 3, "debugname");
+		if (!lua_isnoneornil(L, -1))
+			settings.debugName = luaL_checkstring(L, -1);
+		lua_pop(L, 1);
+	}
+
+	VirtualTexture *t = nullptr;
+	luax_catchexcept(L, [&]() { t = instance()->newVirtualTexture(width, height, settings); });
+
+	luax_pushtype(L, t);
+	t->release();
+	return 1;
+}
+
 int w_newCubeTexture(lua_State *L)
 {
 	luax_checkgraphicscreated(L);
@@ -1373,6 +1670,67 @@ int w_newQuad(lua_State *L)
 	return 1;
 }
 
+int w_newAtlas(lua_State *L)
+{
+	luax_checkgraphicscreated(L);
+	luaL_checktype(L, 1, LUA_TTABLE);
+
+	std::vector<Graphics::AtlasSource> sources;
+	int count = (int) luax_objlen(L, 1);
+
+	for (int i = 1; i <= count; i++)
+	{
+		lua_rawgeti(L, 1, i);
+
+		Graphics::AtlasSource source;
+		if (luax_istype(L, -1, image::ImageData::type))
+			source.imageData = luax_totype<image::ImageData>(L, -1);
+		else if (luax_istype(L, -1, Texture::type))
+			source.texture = luax_totype<Texture>(L, -1);
+		else
+			return luaL_error(L, "Atlas image %d must be an ImageData or Texture.", i);
+
+		sources.push_back(source);
+		lua_pop(L, 1);
+	}
+
+	Graphics::AtlasSettings settings;
+
+	if (!lua_isnoneornil(L, 2))
+	{
+		luaL_checktype(L, 2, LUA_TTABLE);
+
+		settings.padding = luax_intflag(L, 2, "padding", settings.padding);
+		settings.maxSize = luax_intflag(L, 2, "maxsize", settings.maxSize);
+		settings.linear = luax_boolflag(L, 2, "linear", settings.linear);
+		settings.mipmaps = luax_boolflag(L, 2, "mipmaps", settings.mipmaps);
+
+		lua_getfield(L, 2, "debugname");
+		if (!lua_isnoneornil(L, -1))
+			settings.debugName = luaL_checkstring(L, -1);
+		lua_pop(L, 1);
+	}
+
+	std::vector<Rect> rects;
+	Texture *atlas = nullptr;
+	luax_catchexcept(L, [&]() { atlas = instance()->newAtlas(sources, settings, rects); });
+
+	luax_pushtype(L, atlas);
+	atlas->release();
+
+	lua_createtable(L, (int) rects.size(), 0);
+	for (size_t i = 0; i < rects.size(); i++)
+	{
+		Quad::Viewport v = {(double) rects[i].x, (double) rects[i].y, (double) rects[i].w, (double) rects[i].h};
+		Quad *quad = instance()->newQuad(v, atlas->getWidth(), atlas->getHeight());
+		luax_pushtype(L, quad);
+		quad->release();
+		lua_rawseti(L, -2, (int) i + 1);
+	}
+
+	return 2;
+}
+
 int w_newFont(lua_State *L)
 {
 	luax_checkgraphicscreated(L);
@@ -1435,16 +1793,18 @@ int w_newSpriteBatch(lua_State *L)
 	Texture *texture = luax_checktexture(L, 1);
 	int size = (int) luaL_optinteger(L, 2, 1000);
 	BufferDataUsage usage = BUFFERDATAUSAGE_DYNAMIC;
-	if (lua_gettop(L) > 2)
+	if (!lua_isnoneornil(L, 3))
 	{
 		const char *usagestr = luaL_checkstring(L, 3);
 		if (!getConstant(usagestr, usage))
 			return luax_enumerror(L, "usage hint", getConstants(usage), usagestr);
 	}
 
+	bool instanced = luax_optboolean(L, 4, false);
+
 	SpriteBatch *t = nullptr;
 	luax_catchexcept(L,
-		[&](){ t = instance()->newSpriteBatch(texture, size, usage); }
+		[&](){ t = instance()->newSpriteBatch(texture, size, usage, instanced); }
 	);
 
 	luax_pushtype(L, t);
@@ -1471,6 +1831,7 @@ int w_newParticleSystem(lua_State *L)
 	return 1;
 }
 
+// Returns the index of the options table argument.
 static int w_getShaderSource(lua_State *L, int startidx, std::vector<std::string> &stages, Shader::CompileOptions &options)
 {
 	using namespace love::filesystem;
@@ -1580,9 +1941,14 @@ static int w_getShaderSource(lua_State *L, int startidx, std::vector<std::string
 		if (!lua_isnoneornil(L, -1))
 			options.debugName = luax_checkstring(L, -1);
 		lua_pop(L, 1);
+
+		lua_getfield(L, optionsidx, "async");
+		if (!lua_isnoneornil(L, -1))
+			options.async = luax_checkboolean(L, -1);
+		lua_pop(L, 1);
 	}
 
-	return 0;
+	return optionsidx;
 }
 
 int w_newShader(lua_State *L)
@@ -1651,6 +2017,82 @@ int w_newComputeShader(lua_State* L)
 	return 1;
 }
 
+int w_newShaderVariants(lua_State *L)
+{
+	std::vector<std::string> stages;
+	Shader::CompileOptions options;
+	int optionsidx = w_getShaderSource(L, 1, stages, options);
+
+	luaL_checktype(L, optionsidx, LUA_TTABLE);
+
+	std::vector<std::string> features;
+	lua_getfield(L, optionsidx, "features");
+	if (!lua_istable(L, -1))
+		return luaL_argerror(L, optionsidx, "expected 'features' field to be a table of feature names");
+	for (int i = 1; i <= (int) luax_objlen(L, -1); i++)
+	{
+		lua_rawgeti(L, -1, i);
+		features.push_back(luax_checkstring(L, -1));
+		lua_pop(L, 1);
+	}
+	lua_pop(L, 1);
+
+	// Variants can be given as masks or as tables of feature names.
+	std::vector<uint32> masks;
+	lua_getfield(L, optionsidx, "variants");
+	if (!lua_istable(L, -1))
+		return luaL_argerror(L, optionsidx, "expected 'variants' field to be a table");
+	for (int i = 1; i <= (int) luax_objlen(L, -1); i++)
+	{
+		lua_rawgeti(L, -1, i);
+		if (lua_type(L, -1) == LUA_TNUMBER)
+			masks.push_back((uint32) lua_tonumber(L, -1));
+		else if (lua_istable(L, -1))
+		{
+			uint32 mask = 0;
+			for (int j = 1; j <= (int) luax_objlen(L, -1); j++)
+			{
+				lua_rawgeti(L, -1, j);
+				std::string name = luax_checkstring(L, -1);
+				lua_pop(L, 1);
+
+				auto it = std::find(features.begin(), features.end(), name);
+				if (it == features.end())
+					return luaL_error(L, "Unknown shader variant feature '%s'.", name.c_str());
+
+				mask |= 1u << (uint32) (it - features.begin());
+			}
+			masks.push_back(mask);
+		}
+		else
+			return luaL_argerror(L, optionsidx, "'variants' table values must be feature masks or tables of feature names");
+		lua_pop(L, 1);
+	}
+	lua_pop(L, 1);
+
+	bool should_error = false;
+	try
+	{
+		ShaderVariants *variants = instance()->newShaderVariants(stages, options, features, masks);
+		luax_pushtype(L, variants);
+		variants->release();
+	}
+	catch (love::Exception &e)
+	{
+		luax_getfunction(L, "graphics", "_transformGLSLErrorMessages");
+		lua_pushstring(L, e.what());
+
+		// Function pushes the new error string onto the stack.
+		lua_pcall(L, 1, 1, 0);
+		should_error = true;
+	}
+
+	if (should_error)
+		return lua_error(L);
+
+	return 1;
+}
+
 int w_validateShader(lua_State *L)
 {
 	bool gles = luax_checkboolean(L, 1);
@@ -1877,11 +2319,9 @@ static Buffer *luax_newbuffer(lua_State *L, int idx, Buffer::Settings settings,
 	return b;
 }
 
-int w_newBuffer(lua_State *L)
+static void luax_checkbufferusageflags(lua_State *L, int idx, Buffer::Settings &settings)
 {
-	Buffer::Settings settings(0, BUFFERDATAUSAGE_DYNAMIC);
-
-	luaL_checktype(L, 3, LUA_TTABLE);
+	luaL_checktype(L, idx, LUA_TTABLE);
 
 	for (int i = 0; i < BUFFERUSAGE_MAX_ENUM; i++)
 	{
@@ -1889,10 +2329,16 @@ int w_newBuffer(lua_State *L)
 		const char *tname = nullptr;
 		if (!getConstant(bufferusage, tname))
 			continue;
-		if (luax_boolflag(L, 3, tname, false))
+		if (luax_boolflag(L, idx, tname, false))
 			settings.usageFlags = (BufferUsageFlags)(settings.usageFlags | (1u << i));
 	}
+}
+
+int w_newBuffer(lua_State *L)
+{
+	Buffer::Settings settings(0, BUFFERDATAUSAGE_DYNAMIC);
 
+	luax_checkbufferusageflags(L, 3, settings);
 	luax_optbuffersettings(L, 3, settings);
 
 	std::vector<Buffer::DataDeclaration> format;
@@ -1905,6 +2351,28 @@ int w_newBuffer(lua_State *L)
 	return 1;
 }
 
+int w_newBufferAsync(lua_State *L)
+{
+	luax_checkgraphicscreated(L);
+
+	Buffer::Settings settings(0, BUFFERDATAUSAGE_DYNAMIC);
+
+	luax_checkbufferusageflags(L, 3, settings);
+	luax_optbuffersettings(L, 3, settings);
+
+	std::vector<Buffer::DataDeclaration> format;
+	luax_checkbufferformat(L, 1, format);
+
+	Data *data = luax_checktype<Data>(L, 2);
+
+	StrongRef<BufferUpload> upload;
+	luax_catchexcept(L, [&]() { upload.set(instance()->newBufferAsync(settings, format, data, 0), Acquire::NORETAIN); });
+
+	luax_pushtype(L, upload->getBuffer());
+	luax_pushtype(L, upload);
+	return 2;
+}
+
 static PrimitiveType luax_checkmeshdrawmode(lua_State *L, int idx)
 {
 	const char *modestr = luaL_checkstring(L, idx);
@@ -2246,6 +2714,53 @@ int w_newTextBatch(lua_State *L)
 	return 1;
 }
 
+int w_newShapeBatch(lua_State *L)
+{
+	luax_checkgraphicscreated(L);
+
+	ShapeBatch *s = nullptr;
+	luax_catchexcept(L, [&](){ s = instance()->newShapeBatch(); });
+
+	luax_pushtype(L, s);
+	s->release();
+	return 1;
+}
+
+int w_newDrawList(lua_State *L)
+{
+	luax_checkgraphicscreated(L);
+
+	DrawList *d = nullptr;
+	luax_catchexcept(L, [&](){ d = instance()->newDrawList(); });
+
+	luax_pushtype(L, d);
+	d->release();
+	return 1;
+}
+
+int w_beginDrawList(lua_State *L)
+{
+	DrawList *d = luax_checkdrawlist(L, 1);
+	luax_catchexcept(L, [&](){ instance()->beginDrawList(d); });
+	return 0;
+}
+
+int w_endDrawList(lua_State *L)
+{
+	luax_catchexcept(L, [&](){ instance()->endDrawList(); });
+	return 0;
+}
+
+int w_getRecordingDrawList(lua_State *L)
+{
+	DrawList *d = instance()->getRecordingDrawList();
+	if (d != nullptr)
+		luax_pushtype(L, d);
+	else
+		lua_pushnil(L);
+	return 1;
+}
+
 int w_newText(lua_State *L)
 {
 	luax_markdeprecated(L, 1, "love.graphics.newText", API_FUNCTION, DEPRECATED_RENAMED, "love.graphics.newTextBatch");
@@ -2314,6 +2829,18 @@ int w_readbackBufferAsync(lua_State *L)
 	return 1;
 }
 
+int w_newReadbackRing(lua_State *L)
+{
+	int size = (int) luaL_checkinteger(L, 1);
+
+	ReadbackRing *ring = nullptr;
+	luax_catchexcept(L, [&]() { ring = instance()->newReadbackRing(size); });
+
+	luax_pushtype(L, ring);
+	ring->release();
+	return 1;
+}
+
 int w_readbackTexture(lua_State *L)
 {
 	Texture *t = luax_checktexture(L, 1);
@@ -2768,6 +3295,27 @@ int w_getLineJoin(lua_State *L)
 	return 1;
 }
 
+int w_setBatchSortMode(lua_State *L)
+{
+	Graphics::BatchSortMode mode;
+	const char *str = luaL_checkstring(L, 1);
+	if (!Graphics::getConstant(str, mode))
+		return luax_enumerror(L, "batch sort mode", Graphics::getConstants(mode), str);
+
+	instance()->setBatchSortMode(mode);
+	return 0;
+}
+
+int w_getBatchSortMode(lua_State *L)
+{
+	Graphics::BatchSortMode mode = instance()->getBatchSortMode();
+	const char *str;
+	if (!Graphics::getConstant(mode, str))
+		return luaL_error(L, "Unknown batch sort mode");
+	lua_pushstring(L, str);
+	return 1;
+}
+
 int w_setPointSize(lua_State *L)
 {
 	float size = (float)luaL_checknumber(L, 1);
@@ -2871,6 +3419,60 @@ int w_isWireframe(lua_State *L)
 	return 1;
 }
 
+int w_setTextureArrayBatching(lua_State *L)
+{
+	instance()->setTextureArrayBatching(luax_checkboolean(L, 1));
+	return 0;
+}
+
+int w_isTextureArrayBatching(lua_State *L)
+{
+	luax_pushboolean(L, instance()->isTextureArrayBatching());
+	return 1;
+}
+
+int w_setAsyncCompute(lua_State *L)
+{
+	instance()->setAsyncCompute(luax_checkboolean(L, 1));
+	return 0;
+}
+
+int w_isAsyncCompute(lua_State *L)
+{
+	luax_pushboolean(L, instance()->isAsyncCompute());
+	return 1;
+}
+
+int w_setTextureStreamingBudget(lua_State *L)
+{
+	instance()->setTextureStreamingBudget((int64) luaL_checknumber(L, 1));
+	return 0;
+}
+
+int w_getTextureStreamingBudget(lua_State *L)
+{
+	lua_pushnumber(L, (lua_Number) instance()->getTextureStreamingBudget());
+	return 1;
+}
+
+int w_getStreamingTextureMemory(lua_State *L)
+{
+	lua_pushnumber(L, (lua_Number) instance()->getStreamingTextureMemory());
+	return 1;
+}
+
+int w_setShaderCacheEnabled(lua_State *L)
+{
+	instance()->setShaderCacheEnabled(luax_checkboolean(L, 1));
+	return 0;
+}
+
+int w_isShaderCacheEnabled(lua_State *L)
+{
+	luax_pushboolean(L, instance()->isShaderCacheEnabled());
+	return 1;
+}
+
 int w_setShader(lua_State *L)
 {
 	if (lua_isnoneornil(L,1))
@@ -2879,8 +3481,17 @@ int w_setShader(lua_State *L)
 		return 0;
 	}
 
+	// A variant can be selected directly, by passing its feature mask.
+	if (luax_istype(L, 1, ShaderVariants::type))
+	{
+		ShaderVariants *variants = luax_checkshadervariants(L, 1);
+		uint32 mask = luax_checkshadervariantmask(L, 2, variants);
+		luax_catchexcept(L, [&]() { instance()->setShader(variants->getShader(mask)); });
+		return 0;
+	}
+
 	Shader *shader = luax_checkshader(L, 1);
-	instance()->setShader(shader);
+	luax_catchexcept(L, [&]() { instance()->setShader(shader); });
 	return 0;
 }
 
@@ -3100,6 +3711,12 @@ int w_getSystemLimits(lua_State *L)
 	return 1;
 }
 
+int w__getDefaultShaderCompileTime(lua_State *L)
+{
+	lua_pushnumber(L, instance()->getDefaultShaderCompileTime());
+	return 1;
+}
+
 int w_getStats(lua_State *L)
 {
 	Graphics::Stats stats = instance()->getStats();
@@ -3107,7 +3724,7 @@ int w_getStats(lua_State *L)
 	if (lua_istable(L, 1))
 		lua_pushvalue(L, 1);
 	else
-		lua_createtable(L, 0, 7);
+		lua_createtable(L, 0, 19);
 
 	lua_pushinteger(L, stats.drawCalls);
 	lua_setfield(L, -2, "drawcalls");
@@ -3136,9 +3753,136 @@ int w_getStats(lua_State *L)
 	lua_pushnumber(L, (lua_Number) stats.bufferMemory);
 	lua_setfield(L, -2, "buffermemory");
 
+	lua_pushnumber(L, (lua_Number) stats.streamBufferMemory);
+	lua_setfield(L, -2, "streambuffermemory");
+
+	lua_pushnumber(L, (lua_Number) stats.streamBufferUsed);
+	lua_setfield(L, -2, "streambufferused");
+
+	lua_pushinteger(L, stats.streamBufferStalls);
+	lua_setfield(L, -2, "streambufferstalls");
+
+	lua_pushinteger(L, stats.framebufferCacheSize);
+	lua_setfield(L, -2, "framebuffers");
+
+	lua_pushinteger(L, stats.framebufferCacheHits);
+	lua_setfield(L, -2, "framebuffercachehits");
+
+	lua_pushinteger(L, stats.framebufferCacheMisses);
+	lua_setfield(L, -2, "framebuffercachemisses");
+
+	lua_pushnumber(L, stats.gpuFrameTime);
+	lua_setfield(L, -2, "gputime");
+
+	lua_pushnumber(L, stats.presentTime);
+	lua_setfield(L, -2, "presenttime");
+
+	lua_createtable(L, (int) stats.gpuScopes.size(), 0);
+	for (size_t i = 0; i < stats.gpuScopes.size(); i++)
+	{
+		const Graphics::GPUScopeTime &scope = stats.gpuScopes[i];
+
+		lua_createtable(L, 0, 3);
+
+		luax_pushstring(L, scope.name);
+		lua_setfield(L, -2, "name");
+
+		lua_pushnumber(L, scope.seconds);
+		lua_setfield(L, -2, "time");
+
+		lua_pushinteger(L, scope.depth);
+		lua_setfield(L, -2, "depth");
+
+		lua_rawseti(L, -2, (int) i + 1);
+	}
+	lua_setfield(L, -2, "gpuscopes");
+
+	lua_createtable(L, (int) stats.memoryHeaps.size(), 0);
+	for (size_t i = 0; i < stats.memoryHeaps.size(); i++)
+	{
+		const Graphics::MemoryHeapStats &heap = stats.memoryHeaps[i];
+
+		lua_createtable(L, 0, 3);
+
+		lua_pushnumber(L, (lua_Number) heap.usage);
+		lua_setfield(L, -2, "usage");
+
+		lua_pushnumber(L, (lua_Number) heap.budget);
+		lua_setfield(L, -2, "budget");
+
+		luax_pushboolean(L, heap.deviceLocal);
+		lua_setfield(L, -2, "devicelocal");
+
+		lua_rawseti(L, -2, (int) i + 1);
+	}
+	lua_setfield(L, -2, "memoryheaps");
+
 	return 1;
 }
 
+int w_defragmentMemory(lua_State *L)
+{
+	int64 maxbytes = (int64) luaL_optnumber(L, 1, 0);
+	if (maxbytes < 0)
+		return luaL_error(L, "Maximum byte count cannot be negative.");
+
+	int64 bytesmoved = 0;
+	bool complete = true;
+	luax_catchexcept(L, [&]() { complete = instance()->defragmentMemory(maxbytes, bytesmoved); });
+
+	luax_pushboolean(L, complete);
+	lua_pushnumber(L, (lua_Number) bytesmoved);
+	return 2;
+}
+
+int w_newOcclusionQuery(lua_State *L)
+{
+	luax_checkgraphicscreated(L);
+
+	OcclusionQuery *query = nullptr;
+	luax_catchexcept(L, [&]() { query = instance()->newOcclusionQuery(); });
+
+	luax_pushtype(L, query);
+	query->release();
+	return 1;
+}
+
+int w_beginOcclusionQuery(lua_State *L)
+{
+	OcclusionQuery *query = luax_checkocclusionquery(L, 1);
+	luax_catchexcept(L, [&]() { instance()->beginOcclusionQuery(query); });
+	return 0;
+}
+
+int w_endOcclusionQuery(lua_State *L)
+{
+	luax_catchexcept(L, [&]() { instance()->endOcclusionQuery(); });
+	return 0;
+}
+
+int w_getActiveOcclusionQuery(lua_State *L)
+{
+	OcclusionQuery *query = instance()->getActiveOcclusionQuery();
+	if (query != nullptr)
+		luax_pushtype(L, query);
+	else
+		lua_pushnil(L);
+	return 1;
+}
+
+int w_beginGPUScope(lua_State *L)
+{
+	std::string name = luax_checkstring(L, 1);
+	luax_catchexcept(L, [&]() { instance()->beginGPUScope(name); });
+	return 0;
+}
+
+int w_endGPUScope(lua_State *L)
+{
+	luax_catchexcept(L, [&]() { instance()->endGPUScope(); });
+	return 0;
+}
+
 int w_draw(lua_State *L)
 {
 	Drawable *drawable = nullptr;
@@ -3234,6 +3978,21 @@ int w_drawIndirect(lua_State *L)
 	return 0;
 }
 
+int w_multiDrawIndirect(lua_State *L)
+{
+	Mesh *t = luax_checkmesh(L, 1);
+	Buffer *argsbuffer = luax_checkbuffer(L, 2);
+	int argsindex = (int) luaL_checkinteger(L, 3) - 1;
+	int drawcount = (int) luaL_checkinteger(L, 4);
+
+	luax_checkstandardtransform(L, 5, [&](const Matrix4 &m)
+	{
+		luax_catchexcept(L, [&]() { instance()->drawIndirect(t, m, argsbuffer, argsindex, drawcount); });
+	});
+
+	return 0;
+}
+
 int w_drawFromShader(lua_State *L)
 {
 	if (luax_istype(L, 1, Buffer::type))
@@ -3283,7 +4042,9 @@ int w_drawFromShaderIndirect(lua_State *L)
 		if (!lua_isnoneornil(L, 4))
 			tex = luax_checktexture(L, 4);
 
-		luax_catchexcept(L, [&]() { instance()->drawFromShaderIndirect(t, argsbuffer, argsindex, tex); });
+		int drawcount = (int) luaL_optinteger(L, 5, 1);
+
+		luax_catchexcept(L, [&]() { instance()->drawFromShaderIndirect(t, argsbuffer, argsindex, tex, drawcount); });
 	}
 	else
 	{
@@ -3299,11 +4060,32 @@ int w_drawFromShaderIndirect(lua_State *L)
 		if (!lua_isnoneornil(L, 4))
 			tex = luax_checktexture(L, 4);
 
-		luax_catchexcept(L, [&]() { instance()->drawFromShaderIndirect(primtype, argsbuffer, argsindex, tex); });
+		int drawcount = (int) luaL_optinteger(L, 5, 1);
+
+		luax_catchexcept(L, [&]() { instance()->drawFromShaderIndirect(primtype, argsbuffer, argsindex, tex, drawcount); });
 	}
 	return 0;
 }
 
+int w_drawLines(lua_State *L)
+{
+	Buffer *points = luax_checkbuffer(L, 1);
+	int start = (int) luaL_optinteger(L, 2, 1) - 1;
+
+	int count = 0;
+	if (lua_isnoneornil(L, 3))
+		count = (int) points->getArrayLength() - start;
+	else
+		count = (int) luaL_checkinteger(L, 3);
+
+	luax_checkstandardtransform(L, 4, [&](const Matrix4 &m)
+	{
+		luax_catchexcept(L, [&]() { instance()->drawLines(points, start, count, m); });
+	});
+
+	return 0;
+}
+
 int w_print(lua_State *L)
 {
 	std::vector<love::font::ColoredString> str;
@@ -3792,6 +4574,26 @@ int w_copyTextureToBuffer(lua_State *L)
 	return 0;
 }
 
+int w_updateParticleSystems(lua_State *L)
+{
+	luaL_checktype(L, 1, LUA_TTABLE);
+	float dt = (float) luaL_checknumber(L, 2);
+
+	std::vector<ParticleSystem *> systems;
+	size_t count = luax_objlen(L, 1);
+	systems.reserve(count);
+
+	for (size_t i = 1; i <= count; i++)
+	{
+		lua_rawgeti(L, 1, i);
+		systems.push_back(luax_checkparticlesystem(L, -1));
+		lua_pop(L, 1);
+	}
+
+	luax_catchexcept(L, [&](){ instance()->updateParticleSystems(systems, dt); });
+	return 0;
+}
+
 int w_flushBatch(lua_State *)
 {
 	instance()->flushBatchedDraws();
@@ -3941,6 +4743,34 @@ int w_resetProjection(lua_State */*L*/)
 
 
 // List of functions to wrap.
+// C functions in a struct, necessary for the FFI versions of Graphics functions.
+struct FFI_Graphics
+{
+	bool (*draw)(Proxy *drawable, const float *transform);
+};
+
+static FFI_Graphics ffifuncs =
+{
+	[](Proxy *p, const float *t) -> bool // draw
+	{
+		auto drawable = luax_ffi_checktype<Drawable>(p);
+		if (drawable == nullptr || instance() == nullptr)
+			return false;
+
+		// Exceptions can't cross the FFI boundary. The Lua code calls the
+		// regular function when this fails, which raises the error instead.
+		try
+		{
+			instance()->draw(drawable, Matrix4(t[0], t[1], t[2], t[3], t[4], t[5], t[6], t[7], t[8]));
+			return true;
+		}
+		catch (std::exception &)
+		{
+			return false;
+		}
+	},
+};
+
 static const luaL_Reg functions[] =
 {
 	{ "reset", w_reset },
@@ -3949,27 +4779,41 @@ static const luaL_Reg functions[] =
 	{ "present", w_present },
 
 	{ "newCanvas", w_newCanvas },
+	{ "getTemporaryCanvas", w_getTemporaryCanvas },
+	{ "releaseTemporaryCanvas", w_releaseTemporaryCanvas },
 	{ "newTexture", w_newTexture },
+	{ "newTextureAsync", w_newTextureAsync },
+	{ "newStreamingTexture", w_newStreamingTexture },
+	{ "newVirtualTexture", w_newVirtualTexture },
 	{ "newCubeTexture", w_newCubeTexture },
 	{ "newArrayTexture", w_newArrayTexture },
 	{ "newVolumeTexture", w_newVolumeTexture },
 	{ "newTextureView", w_newTextureView },
 	{ "newQuad", w_newQuad },
+	{ "newAtlas", w_newAtlas },
 	{ "newFont", w_newFont },
 	{ "newImageFont", w_newImageFont },
 	{ "newSpriteBatch", w_newSpriteBatch },
 	{ "newParticleSystem", w_newParticleSystem },
 	{ "newShader", w_newShader },
 	{ "newComputeShader", w_newComputeShader },
+	{ "newShaderVariants", w_newShaderVariants },
 	{ "newBuffer", w_newBuffer },
+	{ "newBufferAsync", w_newBufferAsync },
 	{ "newMesh", w_newMesh },
 	{ "newTextBatch", w_newTextBatch },
+	{ "newShapeBatch", w_newShapeBatch },
+	{ "newDrawList", w_newDrawList },
+	{ "beginDrawList", w_beginDrawList },
+	{ "endDrawList", w_endDrawList },
+	{ "getRecordingDrawList", w_getRecordingDrawList },
 	{ "_newVideo", w_newVideo },
 
 	{ "readbackBuffer", w_readbackBuffer },
 	{ "readbackBufferAsync", w_readbackBufferAsync },
 	{ "readbackTexture", w_readbackTexture },
 	{ "readbackTextureAsync", w_readbackTextureAsync },
+	{ "newReadbackRing", w_newReadbackRing },
 
 	{ "validateShader", w_validateShader },
 
@@ -4001,6 +4845,8 @@ static const luaL_Reg functions[] =
 	{ "getLineWidth", w_getLineWidth },
 	{ "getLineStyle", w_getLineStyle },
 	{ "getLineJoin", w_getLineJoin },
+	{ "setBatchSortMode", w_setBatchSortMode },
+	{ "getBatchSortMode", w_getBatchSortMode },
 	{ "setPointSize", w_setPointSize },
 	{ "getPointSize", w_getPointSize },
 	{ "setDepthMode", w_setDepthMode },
@@ -4011,6 +4857,15 @@ static const luaL_Reg functions[] =
 	{ "getFrontFaceWinding", w_getFrontFaceWinding },
 	{ "setWireframe", w_setWireframe },
 	{ "isWireframe", w_isWireframe },
+	{ "setTextureArrayBatching", w_setTextureArrayBatching },
+	{ "isTextureArrayBatching", w_isTextureArrayBatching },
+	{ "setAsyncCompute", w_setAsyncCompute },
+	{ "isAsyncCompute", w_isAsyncCompute },
+	{ "setTextureStreamingBudget", w_setTextureStreamingBudget },
+	{ "getTextureStreamingBudget", w_getTextureStreamingBudget },
+	{ "getStreamingTextureMemory", w_getStreamingTextureMemory },
+	{ "setShaderCacheEnabled", w_setShaderCacheEnabled },
+	{ "isShaderCacheEnabled", w_isShaderCacheEnabled },
 
 	{ "setShader", w_setShader },
 	{ "getShader", w_getShader },
@@ -4021,15 +4876,26 @@ static const luaL_Reg functions[] =
 	{ "getSystemLimits", w_getSystemLimits },
 	{ "getTextureTypes", w_getTextureTypes },
 	{ "getStats", w_getStats },
+	{ "_getDefaultShaderCompileTime", w__getDefaultShaderCompileTime },
+	{ "defragmentMemory", w_defragmentMemory },
+	{ "beginGPUScope", w_beginGPUScope },
+	{ "newOcclusionQuery", w_newOcclusionQuery },
+	{ "beginOcclusionQuery", w_beginOcclusionQuery },
+	{ "endOcclusionQuery", w_endOcclusionQuery },
+	{ "getActiveOcclusionQuery", w_getActiveOcclusionQuery },
+	{ "endGPUScope", w_endGPUScope },
 
 	{ "captureScreenshot", w_captureScreenshot },
+	{ "captureBackbuffer", w_captureBackbuffer },
 
 	{ "draw", w_draw },
 	{ "drawLayer", w_drawLayer },
 	{ "drawInstanced", w_drawInstanced },
 	{ "drawIndirect", w_drawIndirect },
+	{ "multiDrawIndirect", w_multiDrawIndirect },
 	{ "drawFromShader", w_drawFromShader },
 	{ "drawFromShaderIndirect", w_drawFromShaderIndirect },
+	{ "drawLines", w_drawLines },
 
 	{ "print", w_print },
 	{ "printf", w_printf },
@@ -4041,6 +4907,8 @@ static const luaL_Reg functions[] =
 	{ "copyBufferToTexture", w_copyBufferToTexture },
 	{ "copyTextureToBuffer", w_copyTextureToBuffer },
 
+	{ "updateParticleSystems", w_updateParticleSystems },
+
 	{ "isCreated", w_isCreated },
 	{ "isActive", w_isActive },
 	{ "isGammaCorrect", w_isGammaCorrect },
@@ -4056,6 +4924,9 @@ static const luaL_Reg functions[] =
 	{ "setScissor", w_setScissor },
 	{ "intersectScissor", w_intersectScissor },
 	{ "getScissor", w_getScissor },
+	{ "pushClip", w_pushClip },
+	{ "popClip", w_popClip },
+	{ "getClipDepth", w_getClipDepth },
 
 	{ "setStencilMode", w_setStencilMode },
 	{ "getStencilMode", w_getStencilMode },
@@ -4110,15 +4981,24 @@ static const lua_CFunction types[] =
 {
 	luaopen_drawable,
 	luaopen_texture,
+	luaopen_textureupload,
+	luaopen_streamingtexture,
 	luaopen_font,
 	luaopen_quad,
 	luaopen_graphicsbuffer,
+	luaopen_bufferupload,
 	luaopen_graphicsreadback,
+	luaopen_readbackring,
+	luaopen_occlusionquery,
 	luaopen_spritebatch,
 	luaopen_particlesystem,
 	luaopen_shader,
+	luaopen_shadervariants,
 	luaopen_mesh,
 	luaopen_textbatch,
+	luaopen_shapebatch,
+	luaopen_drawlist,
+	luaopen_virtualtexture,
 	luaopen_video,
 	0
 };
@@ -4142,7 +5022,37 @@ extern "C" int luaopen_love_graphics(lua_State *L)
 
 	int n = luax_register_module(L, w);
 
+	// Execute wrap_Graphics.lua, sending the ffifuncs pointer and the shared
+	// ffi helpers as args.
 	if (luaL_loadbuffer(L, (const char *)graphics_lua, sizeof(graphics_lua), "=[love \"wrap_Graphics.lua\"]") == 0)
+	{
+		luax_pushpointerasstring(L, &ffifuncs);
+		luax_pushffiwrapper(L);
+		lua_call(L, 2, 0);
+	}
+	else
+		lua_error(L);
+
+	// Frame capture wraps the final versions of the functions above, so it
+	// has to run after wrap_Graphics.lua.
+	if (luaL_loadbuffer(L, (const char *)graphics_capture_lua, sizeof(graphics_capture_lua), "=[love \"wrap_GraphicsCapture.lua\"]") == 0)
+		lua_call(L, 0, 0);
+	else
+		lua_error(L);
+
+	if (luaL_loadbuffer(L, (const char *)graphics_dynamicresolution_lua, sizeof(graphics_dynamicresolution_lua), "=[love \"wrap_GraphicsDynamicResolution.lua\"]") == 0)
+		lua_call(L, 0, 0);
+	else
+		lua_error(L);
+
+	if (luaL_loadbuffer(L, (const char *)graphics_imageprocessing_lua, sizeof(graphics_imageprocessing_lua), "=[love \"wrap_GraphicsImageProcessing.lua\"]") == 0)
+		lua_call(L, 0, 0);
+	else
+		lua_error(L);
+
+	// Recording wraps present after dynamic resolution does, so it sees the
+	// upscaled frame.
+	if (luaL_loadbuffer(L, (const char *)graphics_recording_lua, sizeof(graphics_recording_lua), "=[love \"wrap_GraphicsRecording.lua\"]") == 0)
 		lua_call(L, 0, 0);
 	else
 		lua_error(L);
@@ -30,9 +30,13 @@
 #include "wrap_Shader.h"
 #include "wrap_Mesh.h"
 #include "wrap_TextBatch.h"
+#include "wrap_ShapeBatch.h"
+#include "wrap_DrawList.h"
+#include "wrap_VirtualTexture.h"
 #include "wrap_Video.h"
 #include "wrap_Buffer.h"
 #include "wrap_GraphicsReadback.h"
+#include "wrap_OcclusionQuery.h"
 #include "Graphics.h"
 
 namespace love
@@ -22,6 +22,8 @@ misrepresented as being the original software.
 3. This notice may not be removed or altered from any source distribution.
 --]]
 
+local ffifuncspointer_str, ffiwrapper = ...
+
 local table_concat = table.concat
 local ipairs = ipairs
 local pcall = pcall
@@ -129,5 +131,36 @@ function graphics._transformGLSLErrorMessages(message)
 	return table_concat(lines, "\n")
 end
 
+-- Everything below this point is efficient FFI replacements for existing
+-- love.graphics functionality.
+
+if ffiwrapper == nil or not ffiwrapper.isjitenabled() then return end
+
+local istype = ffiwrapper.istype
+local packstandardtransform = ffiwrapper.packstandardtransform
+
+-- Matches the struct declaration in wrap_Graphics.cpp.
+local ffifuncs = ffiwrapper.getfuncs("FFI_Graphics", [[
+typedef struct FFI_Graphics
+{
+	bool (*draw)(Proxy *drawable, const float *transform);
+} FFI_Graphics;
+]], ffifuncspointer_str)
+
+local transform = ffiwrapper.ffi.new("float[9]")
+
+local _draw = graphics.draw
+
+-- Only the common draw(drawable, x, y, ...) form is handled here. Quads,
+-- Transforms and anything which errors go through the regular function.
+function graphics.draw(drawable, x, y, a, sx, sy, ox, oy, kx, ky)
+	if istype(drawable, "Drawable")
+		and packstandardtransform(transform, x, y, a, sx, sy, ox, oy, kx, ky)
+		and ffifuncs.draw(drawable, transform) then
+		return
+	end
+	return _draw(drawable, x, y, a, sx, sy, ox, oy, kx, ky)
+end
+
 -- DO NOT REMOVE THE NEXT LINE. It is used to load this file as a C++ string.
 --)luastring"--"
@@ -0,0 +1,635 @@
+R"luastring"--(
+-- DO NOT REMOVE THE ABOVE LINE. It is used to load this file as a C++ string.
+-- There is a matching delimiter at the bottom of the file.
+
+--[[
+Copyright (c) 2006-2024 LOVE Development Team
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+claim that you wrote the original software. If you use this software
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+--]]
+
+-- Frame capture and replay. love.graphics.captureFrames records the
+-- love.graphics calls made during the next few frames, along with the
+-- textures, fonts, shaders etc. they use, to a file in the save directory.
+-- love.graphics.replayCapture runs the recorded calls again with timing, so
+-- rendering can be benchmarked on any backend independently of game logic.
+--
+-- Calls are recorded at the love.graphics API level, while capturing the
+-- module functions and some object methods are temporarily replaced with
+-- recording versions. Things which can't be recorded (calls through local
+-- copies of love.graphics functions, Meshes, SpriteBatches, Text objects,
+-- ParticleSystems, Buffers, and the contents of shader uniforms sent before
+-- the capture started) are counted in the capture file and skipped.
+
+local graphics = love.graphics
+
+local type, select, pairs, ipairs, pcall, error = type, select, pairs, ipairs, pcall, error
+local tostring, tonumber, getmetatable = tostring, tonumber, getmetatable
+local string_format, table_concat, table_sort = string.format, table.concat, table.sort
+local unpack = unpack or table.unpack
+
+local CAPTURE_VERSION = 1
+
+-- Arguments used to create Fonts and Shaders, so they can be created again in
+-- a replay. Weak keys, so the objects can still be collected.
+local creationargs = setmetatable({}, {__mode = "k"})
+
+for _, name in ipairs({"newFont", "setNewFont", "newShader"}) do
+	local f = graphics[name]
+	graphics[name] = function(...)
+		local obj = f(...)
+		if obj ~= nil then
+			creationargs[obj] = {n = select("#", ...), ...}
+		end
+		return obj
+	end
+end
+
+local function gettime()
+	return love.timer and love.timer.getTime() or love._getTime()
+end
+
+local function islovetype(v, typename)
+	if type(v) ~= "userdata" then return false end
+	local mt = getmetatable(v)
+	return type(mt) == "table" and type(mt.typeOf) == "function" and mt.typeOf(v, typename) == true
+end
+
+local function encodebase64(str)
+	return love.data.encode("string", "base64", str)
+end
+
+local function decodebase64(str)
+	return love.data.decode("string", "base64", str)
+end
+
+-----------------------------------------------------------
+-- Recording.
+-----------------------------------------------------------
+
+local capture = nil
+
+local encodeargs, getresource
+
+-- Returns the serializable form of a value, or nil if it can't be recorded.
+-- Tables are wrapped as {t=...} and objects as {r=resourceid}, so plain
+-- strings, numbers and booleans can be stored as-is.
+local function encodevalue(c, v)
+	local t = type(v)
+	if t == "number" or t == "string" or t == "boolean" then
+		return v
+	elseif t == "table" then
+		local out = {}
+		for k, x in pairs(v) do
+			local encoded = encodevalue(c, x)
+			if encoded == nil or (type(k) ~= "number" and type(k) ~= "string") then
+				return nil
+			end
+			out[k] = encoded
+		end
+		return {t = out}
+	elseif t == "userdata" then
+		local id = getresource(c, v)
+		if id ~= nil then
+			return {r = id}
+		end
+	end
+	return nil
+end
+
+function encodeargs(c, ...)
+	local n = select("#", ...)
+	local args = {n = n}
+	for i = 1, n do
+		local v = select(i, ...)
+		if v ~= nil then
+			args[i] = encodevalue(c, v)
+			if args[i] == nil then
+				return nil
+			end
+		end
+	end
+	return args
+end
+
+local function encodefiledata(data)
+	return {type = "filedata", name = data:getFilename(), data = encodebase64(data:getString())}
+end
+
+local function encodeimagedata(imagedata)
+	local ok, filedata = pcall(imagedata.encode, imagedata, "png")
+	if ok then
+		return encodebase64(filedata:getString())
+	end
+	return nil
+end
+
+local function newresource(c, obj)
+	if islovetype(obj, "Texture") then
+		if obj:getTextureType() ~= "2d" then return nil end
+		local w, h = obj:getDimensions()
+		local res = {
+			type = "texture",
+			width = w,
+			height = h,
+			dpiscale = obj:getDPIScale(),
+			format = obj:getFormat(),
+			canvas = obj:isCanvas(),
+			msaa = obj:getMSAA(),
+			mipmaps = obj:getMipmapCount() > 1,
+			filter = {obj:getFilter()},
+			wrap = {obj:getWrap()},
+		}
+		local ok, imagedata = pcall(graphics.readbackTexture, obj)
+		if ok and imagedata then
+			res.pixels = encodeimagedata(imagedata)
+		end
+		return res
+	elseif islovetype(obj, "Quad") then
+		local x, y, w, h = obj:getViewport()
+		local sw, sh = obj:getTextureDimensions()
+		return {type = "quad", viewport = {x, y, w, h}, sw = sw, sh = sh}
+	elseif islovetype(obj, "Font") then
+		local res = {type = "font", height = obj:getHeight(), filter = {obj:getFilter()}, lineheight = obj:getLineHeight()}
+		local args = creationargs[obj]
+		if args then
+			res.args = encodeargs(c, unpack(args, 1, args.n))
+		end
+		return res
+	elseif islovetype(obj, "Shader") then
+		local args = creationargs[obj]
+		if args == nil then return nil end
+		local res = {type = "shader", args = encodeargs(c, unpack(args, 1, args.n))}
+		if res.args == nil then return nil end
+		return res
+	elseif islovetype(obj, "Transform") then
+		return {type = "transform", matrix = {obj:getMatrix()}}
+	elseif islovetype(obj, "ImageData") then
+		local pixels = encodeimagedata(obj)
+		if pixels == nil then return nil end
+		return {type = "imagedata", pixels = pixels}
+	elseif islovetype(obj, "FileData") then
+		return encodefiledata(obj)
+	end
+	return nil
+end
+
+function getresource(c, obj)
+	local id = c.ids[obj]
+	if id == nil then
+		c.depth = c.depth + 1
+		local ok, res = pcall(newresource, c, obj)
+		c.depth = c.depth - 1
+		if not ok or res == nil then return nil end
+		-- Resources can be referenced by other resources, so the id is only
+		-- assigned once everything it depends on has been added.
+		table.insert(c.resources, res)
+		id = #c.resources
+		c.ids[obj] = id
+	end
+	return id
+end
+
+local function countunrecorded(c, name)
+	c.unrecorded[name] = (c.unrecorded[name] or 0) + 1
+end
+
+local function endcall(c, ok, ...)
+	c.depth = c.depth - 1
+	if not ok then
+		error((...), 0)
+	end
+	return ...
+end
+
+-- Calls made from inside a recorded call (e.g. love.graphics.draw's Lua code
+-- calling C functions) aren't recorded again. If a call can't be recorded,
+-- the calls it makes are recorded instead, which handles things like
+-- love.graphics.stencil(func).
+local function wrapfunction(name, f)
+	return function(...)
+		local c = capture
+		if c == nil or c.depth > 0 then
+			return f(...)
+		end
+		local args = encodeargs(c, ...)
+		if args == nil then
+			countunrecorded(c, name)
+			return f(...)
+		end
+		table.insert(c.commands, {f = name, a = args})
+		c.depth = c.depth + 1
+		return endcall(c, pcall(f, ...))
+	end
+end
+
+local function wrapmethod(name, f)
+	return function(self, ...)
+		local c = capture
+		if c == nil or c.depth > 0 then
+			return f(self, ...)
+		end
+		local id = getresource(c, self)
+		local args = encodeargs(c, ...)
+		if id == nil or args == nil then
+			countunrecorded(c, name)
+			return f(self, ...)
+		end
+		table.insert(c.commands, {m = name, o = id, a = args})
+		c.depth = c.depth + 1
+		return endcall(c, pcall(f, self, ...))
+	end
+end
+
+-- Methods which change state that affects rendering.
+local recordedmethods = {
+	Texture = {"setFilter", "setMipmapFilter", "setWrap", "replacePixels", "generateMipmaps"},
+	Quad = {"setViewport"},
+	Font = {"setFilter", "setLineHeight"},
+	Shader = {"send", "sendColor"},
+}
+
+-- Getters, constructors and functions which don't affect rendering.
+local function isrecordedfunction(name)
+	return not (name:match("^get") or name:match("^is") or name:match("^has")
+		or name:match("^new") or name:match("^_") or name:match("^readback")
+		or name:match("^validate") or name:match("^capture") or name:match("^replay")
+		or name == "present")
+end
+
+-- Graphics state which isn't reset by love.graphics.origin, as
+-- {setter, getter} pairs. It's recorded as the first commands of a capture.
+local initialstate = {
+	{"setColor", "getColor"},
+	{"setBackgroundColor", "getBackgroundColor"},
+	{"setBlendMode", "getBlendMode"},
+	{"setColorMask", "getColorMask"},
+	{"setLineWidth", "getLineWidth"},
+	{"setLineStyle", "getLineStyle"},
+	{"setLineJoin", "getLineJoin"},
+	{"setPointSize", "getPointSize"},
+	{"setScissor", "getScissor"},
+	{"setMeshCullMode", "getMeshCullMode"},
+	{"setFrontFaceWinding", "getFrontFaceWinding"},
+	{"setWireframe", "isWireframe"},
+	{"setDefaultFilter", "getDefaultFilter"},
+	{"setFont", "getFont"},
+	{"setShader", "getShader"},
+}
+
+local function pack(...)
+	return {n = select("#", ...), ...}
+end
+
+local function recordinitialstate(c)
+	for _, v in ipairs(initialstate) do
+		local getter = graphics[v[2]]
+		if getter then
+			local packed = pack(pcall(getter))
+			if packed[1] then
+				local args = encodeargs(c, unpack(packed, 2, packed.n))
+				if args then
+					table.insert(c.commands, {f = v[1], a = args})
+				end
+			end
+		end
+	end
+end
+
+local function serialize(v, out)
+	local t = type(v)
+	if t == "number" then
+		if v ~= v then
+			out[#out + 1] = "0/0"
+		elseif v == math.huge then
+			out[#out + 1] = "1/0"
+		elseif v == -math.huge then
+			out[#out + 1] = "-1/0"
+		else
+			out[#out + 1] = string_format("%.17g", v)
+		end
+	elseif t == "string" then
+		out[#out + 1] = string_format("%q", v)
+	elseif t == "boolean" then
+		out[#out + 1] = tostring(v)
+	elseif t == "table" then
+		out[#out + 1] = "{"
+		for k, x in pairs(v) do
+			out[#out + 1] = "["
+			serialize(k, out)
+			out[#out + 1] = "]="
+			serialize(x, out)
+			out[#out + 1] = ","
+		end
+		out[#out + 1] = "}\n"
+	else
+		out[#out + 1] = "nil"
+	end
+end
+
+local function stopcapture()
+	local c = capture
+	capture = nil
+
+	for name, f in pairs(c.originals) do
+		graphics[name] = f
+	end
+	for mt, methods in pairs(c.originalmethods) do
+		for name, f in pairs(methods) do
+			mt[name] = f
+		end
+	end
+
+	return c
+end
+
+local function finishcapture()
+	local c = stopcapture()
+
+	local name, version, vendor, device = graphics.getRendererInfo()
+	local data = {
+		version = CAPTURE_VERSION,
+		renderer = {name = name, version = version, vendor = vendor, device = device},
+		resources = c.resources,
+		frames = c.frames,
+		unrecorded = c.unrecorded,
+	}
+
+	local out = {"return "}
+	serialize(data, out)
+
+	local ok, err = love.filesystem.write(c.filename, table_concat(out))
+	if not ok then
+		error("Could not write graphics capture: " .. tostring(err), 2)
+	end
+end
+
+local function wrappresent(present)
+	return function(...)
+		local c = capture
+		if c == nil then
+			return present(...)
+		end
+		table.insert(c.frames, c.commands)
+		c.commands = {}
+		present(...)
+		if #c.frames >= c.framecount then
+			finishcapture()
+		end
+	end
+end
+
+function graphics.captureFrames(frames, filename)
+	if type(frames) ~= "number" or frames < 1 then
+		error("bad argument #1 to captureFrames (expected positive number)", 2)
+	end
+	if type(filename) ~= "string" then
+		error("bad argument #2 to captureFrames (expected string)", 2)
+	end
+	if capture ~= nil then
+		error("A graphics capture is already in progress.", 2)
+	end
+
+	local c = {
+		framecount = math.floor(frames),
+		filename = filename,
+		frames = {},
+		commands = {},
+		resources = {},
+		ids = {},
+		unrecorded = {},
+		depth = 0,
+		originals = {},
+		originalmethods = {},
+	}
+
+	recordinitialstate(c)
+
+	for name, f in pairs(graphics) do
+		if type(f) == "function" and isrecordedfunction(name) then
+			c.originals[name] = f
+		end
+	end
+	c.originals.present = graphics.present
+
+	for name, f in pairs(c.originals) do
+		graphics[name] = name == "present" and wrappresent(f) or wrapfunction(name, f)
+	end
+
+	local registry = debug and debug.getregistry and debug.getregistry()
+	for typename, methods in pairs(recordedmethods) do
+		local mt = registry and registry[typename]
+		if type(mt) == "table" then
+			c.originalmethods[mt] = {}
+			for _, name in ipairs(methods) do
+				if type(mt[name]) == "function" then
+					c.originalmethods[mt][name] = mt[name]
+					mt[name] = wrapmethod(name, mt[name])
+				end
+			end
+		end
+	end
+
+	capture = c
+end
+
+function graphics.isCapturing()
+	return capture ~= nil
+end
+
+-----------------------------------------------------------
+-- Replay.
+-----------------------------------------------------------
+
+local decodeargs
+
+local function decodevalue(v, objects)
+	if type(v) ~= "table" then
+		return v
+	elseif v.r ~= nil then
+		return objects[v.r]
+	else
+		local out = {}
+		for k, x in pairs(v.t) do
+			out[k] = decodevalue(x, objects)
+		end
+		return out
+	end
+end
+
+function decodeargs(args, objects)
+	local out = {}
+	for i = 1, args.n do
+		if args[i] ~= nil then
+			out[i] = decodevalue(args[i], objects)
+		end
+	end
+	return out, args.n
+end
+
+local function newimagedata(pixels)
+	local filedata = love.filesystem.newFileData(decodebase64(pixels), "capture.png")
+	return love.image.newImageData(filedata)
+end
+
+local function createresource(res, objects)
+	if res.type == "texture" then
+		local imagedata = res.pixels and newimagedata(res.pixels)
+		local tex
+		if res.canvas then
+			tex = graphics.newCanvas(res.width, res.height, {
+				format = res.format,
+				msaa = res.msaa,
+				dpiscale = res.dpiscale,
+				mipmaps = res.mipmaps and "manual" or "none",
+			})
+			if imagedata and res.msaa <= 1 then
+				pcall(tex.replacePixels, tex, imagedata)
+			end
+		elseif imagedata then
+			tex = graphics.newImage(imagedata, {dpiscale = res.dpiscale, mipmaps = res.mipmaps})
+		else
+			tex = graphics.newTexture(res.width, res.height, {format = res.format, dpiscale = res.dpiscale})
+		end
+		tex:setFilter(unpack(res.filter))
+		tex:setWrap(unpack(res.wrap))
+		return tex
+	elseif res.type == "quad" then
+		local v = res.viewport
+		return graphics.newQuad(v[1], v[2], v[3], v[4], res.sw, res.sh)
+	elseif res.type == "font" then
+		local font
+		if res.args then
+			local args, n = decodeargs(res.args, objects)
+			local ok, f = pcall(graphics.newFont, unpack(args, 1, n))
+			font = ok and f or nil
+		end
+		-- Fonts created without a known source are approximated with the
+		-- default font at the same height.
+		font = font or graphics.newFont(res.height)
+		font:setFilter(unpack(res.filter))
+		font:setLineHeight(res.lineheight)
+		return font
+	elseif res.type == "shader" then
+		local args, n = decodeargs(res.args, objects)
+		return graphics.newShader(unpack(args, 1, n))
+	elseif res.type == "transform" then
+		local transform = love.math.newTransform()
+		transform:setMatrix("row", unpack(res.matrix))
+		return transform
+	elseif res.type == "imagedata" then
+		return newimagedata(res.pixels)
+	elseif res.type == "filedata" then
+		return love.filesystem.newFileData(decodebase64(res.data), res.name)
+	end
+end
+
+local function runcommand(cmd, objects)
+	local args, n = decodeargs(cmd.a, objects)
+	if cmd.f then
+		return pcall(graphics[cmd.f], unpack(args, 1, n))
+	else
+		local obj = objects[cmd.o]
+		return pcall(obj[cmd.m], obj, unpack(args, 1, n))
+	end
+end
+
+local function percentile(sorted, p)
+	local index = math.max(1, math.ceil(p * #sorted))
+	return sorted[math.min(index, #sorted)]
+end
+
+function graphics.replayCapture(filename, loops)
+	if capture ~= nil then
+		error("Cannot replay a graphics capture while capturing.", 2)
+	end
+	loops = math.max(1, math.floor(tonumber(loops) or 1))
+
+	local chunk, err = love.filesystem.load(filename)
+	if not chunk then
+		error(err, 2)
+	end
+	local data = chunk()
+	if type(data) ~= "table" or data.version ~= CAPTURE_VERSION then
+		error("Unsupported graphics capture file: " .. tostring(filename), 2)
+	end
+
+	local objects = {}
+	local failedresources = 0
+	for i, res in ipairs(data.resources) do
+		local ok, obj = pcall(createresource, res, objects)
+		if ok then
+			objects[i] = obj
+		else
+			failedresources = failedresources + 1
+		end
+	end
+
+	local times = {}
+	local failed = 0
+
+	for loop = 1, loops do
+		graphics.reset()
+		graphics.origin()
+
+		for _, frame in ipairs(data.frames) do
+			if love.event then
+				love.event.pump()
+			end
+
+			local start = gettime()
+			for _, cmd in ipairs(frame) do
+				if not runcommand(cmd, objects) and loop == 1 then
+					failed = failed + 1
+				end
+			end
+			graphics.present()
+			table.insert(times, gettime() - start)
+		end
+	end
+
+	graphics.reset()
+
+	local sorted = {}
+	local total = 0
+	for i, t in ipairs(times) do
+		sorted[i] = t
+		total = total + t
+	end
+	table_sort(sorted)
+
+	local unrecorded = 0
+	for _, count in pairs(data.unrecorded) do
+		unrecorded = unrecorded + count
+	end
+
+	return {
+		frames = #times,
+		mean = #times > 0 and total / #times or 0,
+		min = sorted[1] or 0,
+		max = sorted[#sorted] or 0,
+		p50 = percentile(sorted, 0.5) or 0,
+		p90 = percentile(sorted, 0.9) or 0,
+		p99 = percentile(sorted, 0.99) or 0,
+		failed = failed,
+		failedresources = failedresources,
+		unrecorded = unrecorded,
+	}
+end
+
+-- DO NOT REMOVE THE NEXT LINE. It is used to load this file as a C++ string.
+--)luastring"--"
@@ -0,0 +1,301 @@
+R"luastring"--(
+-- DO NOT REMOVE THE ABOVE LINE. It is used to load this file as a C++ string.
+-- There is a matching delimiter at the bottom of the file.
+
+--[[
+Copyright (c) 2006-2024 LOVE Development Team
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+claim that you wrote the original software. If you use this software
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+--]]
+
+-- Dynamic resolution. While it's enabled, drawing to the screen goes to an
+-- internal canvas whose resolution is a fraction of the window's, and
+-- love.graphics.present upscales that canvas to the window before presenting.
+-- The scale is adjusted every so often from the GPU frame time reported by
+-- love.graphics.getStats, to keep it below the target frame time.
+--
+-- The internal canvas has the same size in DPI-scaled units as the window, so
+-- coordinates, love.graphics.getDimensions etc. don't change. setCanvas()
+-- selects it and getCanvas() returns nil while it's active, as with the
+-- regular backbuffer. If GPU timings aren't supported the scale stays fixed.
+
+local graphics = love.graphics
+
+local type, select, error, pcall, tostring = type, select, error, pcall, tostring
+local math_floor, math_sqrt, math_min, math_max = math.floor, math.sqrt, math.min, math.max
+
+local setCanvas = graphics.setCanvas
+local getCanvas = graphics.getCanvas
+local reset = graphics.reset
+local present = graphics.present
+
+-- Catmull-Rom filtering with 9 bilinear samples instead of 16 point samples.
+local UPSCALE_SHADER = [[
+uniform vec2 textureSize;
+
+vec4 effect(vec4 color, Image tex, vec2 texcoord, vec2 pixcoord)
+{
+	vec2 samplepos = texcoord * textureSize;
+	vec2 texpos1 = floor(samplepos - 0.5) + 0.5;
+	vec2 f = samplepos - texpos1;
+
+	vec2 w0 = f * (-0.5 + f * (1.0 - 0.5 * f));
+	vec2 w1 = 1.0 + f * f * (-2.5 + 1.5 * f);
+	vec2 w2 = f * (0.5 + f * (2.0 - 1.5 * f));
+	vec2 w3 = f * f * (-0.5 + 0.5 * f);
+
+	vec2 w12 = w1 + w2;
+	vec2 texpos0 = (texpos1 - 1.0) / textureSize;
+	vec2 texpos3 = (texpos1 + 2.0) / textureSize;
+	vec2 texpos12 = (texpos1 + w2 / w12) / textureSize;
+
+	vec4 result = vec4(0.0);
+	result += Texel(tex, vec2(texpos0.x, texpos0.y)) * w0.x * w0.y;
+	result += Texel(tex, vec2(texpos12.x, texpos0.y)) * w12.x * w0.y;
+	result += Texel(tex, vec2(texpos3.x, texpos0.y)) * w3.x * w0.y;
+	result += Texel(tex, vec2(texpos0.x, texpos12.y)) * w0.x * w12.y;
+	result += Texel(tex, vec2(texpos12.x, texpos12.y)) * w12.x * w12.y;
+	result += Texel(tex, vec2(texpos3.x, texpos12.y)) * w3.x * w12.y;
+	result += Texel(tex, vec2(texpos0.x, texpos3.y)) * w0.x * w3.y;
+	result += Texel(tex, vec2(texpos12.x, texpos3.y)) * w12.x * w3.y;
+	result += Texel(tex, vec2(texpos3.x, texpos3.y)) * w3.x * w3.y;
+
+	return clamp(result, 0.0, 1.0) * color;
+}
+]]
+
+-- Scale changes are rounded to this, so the canvas isn't recreated for tiny
+-- differences.
+local SCALE_STEP = 0.05
+
+-- GPU timings lag a few frames behind, and a new canvas size takes a while to
+-- show up in them.
+local ADJUST_INTERVAL = 30
+
+local drs = nil
+local upscaleshader = nil
+local stats = {}
+
+local function bindcanvas(d)
+	setCanvas(d.targets)
+end
+
+local function createcanvas(d)
+	local width, height = graphics.getDimensions()
+	local dpiscale = graphics.getDPIScale()
+
+	local flags = {}
+	if love.window then
+		flags = select(3, love.window.getMode())
+	end
+
+	if d.canvas then
+		d.canvas:release()
+	end
+
+	d.canvas = graphics.newCanvas(width, height, {
+		dpiscale = dpiscale * d.scale,
+		msaa = flags.msaa or 0,
+	})
+	d.canvas:setFilter("linear", "linear")
+
+	d.targets = {d.canvas, depth = flags.depth == true, stencil = flags.stencil ~= false}
+	d.width, d.height, d.dpiscale = width, height, dpiscale
+end
+
+local function quantizescale(d, scale)
+	scale = math_floor(scale / SCALE_STEP + 0.5) * SCALE_STEP
+	return math_min(math_max(scale, d.minscale), d.maxscale)
+end
+
+local function adjustscale(d)
+	local gputime = graphics.getStats(stats).gputime
+	if gputime and gputime > 0 then
+		if d.gputime == nil then
+			d.gputime = gputime
+		else
+			d.gputime = d.gputime + (gputime - d.gputime) * 0.1
+		end
+	end
+
+	d.frames = d.frames + 1
+
+	local scale = d.scale
+	if d.gputime ~= nil and d.frames >= ADJUST_INTERVAL then
+		d.frames = 0
+
+		-- GPU time is roughly proportional to the pixel count, which is
+		-- proportional to the square of the scale. Aim a bit below the target
+		-- when going down, and only go up if there's plenty of headroom.
+		if d.gputime > d.target * 0.95 then
+			scale = quantizescale(d, d.scale * math_sqrt(d.target * 0.85 / d.gputime))
+			if scale >= d.scale then
+				scale = quantizescale(d, d.scale - SCALE_STEP)
+			end
+		elseif d.gputime < d.target * 0.7 then
+			scale = quantizescale(d, d.scale * math_sqrt(d.target * 0.8 / d.gputime))
+		end
+	end
+
+	local width, height = graphics.getDimensions()
+	if scale ~= d.scale or width ~= d.width or height ~= d.height or graphics.getDPIScale() ~= d.dpiscale then
+		d.scale = scale
+		createcanvas(d)
+	end
+end
+
+local function drawcanvas(d)
+	graphics.push("all")
+	reset()
+	graphics.setBlendMode("replace", "premultiplied")
+
+	if d.upscale == "cubic" and d.scale < 1 and upscaleshader then
+		upscaleshader:send("textureSize", {d.canvas:getPixelDimensions()})
+		graphics.setShader(upscaleshader)
+	end
+
+	graphics.draw(d.canvas, 0, 0)
+	graphics.pop()
+end
+
+graphics.setCanvas = function(...)
+	local d = drs
+	if d ~= nil and (...) == nil then
+		return bindcanvas(d)
+	end
+	return setCanvas(...)
+end
+
+local function filtercanvas(d, canvas, ...)
+	if canvas == d.canvas and select("#", ...) == 0 then
+		return nil
+	end
+	return canvas, ...
+end
+
+graphics.getCanvas = function()
+	local d = drs
+	if d == nil then
+		return getCanvas()
+	end
+	return filtercanvas(d, getCanvas())
+end
+
+graphics.reset = function()
+	reset()
+	if drs ~= nil then
+		bindcanvas(drs)
+	end
+end
+
+graphics.present = function(...)
+	local d = drs
+	if d == nil or getCanvas() ~= d.canvas then
+		return present(...)
+	end
+
+	drawcanvas(d)
+	setCanvas()
+	present(...)
+
+	adjustscale(d)
+	bindcanvas(d)
+end
+
+local function checksetting(settings, name, default)
+	local v = settings[name]
+	if v == nil then
+		return default
+	elseif type(v) ~= "number" or v ~= v or v <= 0 then
+		error("Invalid dynamic resolution setting '" .. name .. "' (expected positive number)", 3)
+	end
+	return v
+end
+
+function graphics.setDynamicResolution(enable, settings)
+	if not enable then
+		local d = drs
+		if d ~= nil then
+			drs = nil
+			if getCanvas() == d.canvas then
+				setCanvas()
+			end
+			d.canvas:release()
+		end
+		return
+	end
+
+	if settings ~= nil and type(settings) ~= "table" then
+		error("bad argument #2 to setDynamicResolution (expected table)", 2)
+	end
+	settings = settings or {}
+
+	local target = checksetting(settings, "target", 1 / 60)
+	local minscale = checksetting(settings, "minscale", 0.5)
+	local maxscale = checksetting(settings, "maxscale", 1)
+	if minscale > maxscale then
+		error("Dynamic resolution minscale must not be greater than maxscale", 2)
+	end
+
+	local upscale = settings.upscale or "cubic"
+	if upscale ~= "cubic" and upscale ~= "linear" then
+		error("Invalid dynamic resolution upscale filter '" .. tostring(upscale) .. "' (expected 'cubic' or 'linear')", 2)
+	end
+
+	if upscale == "cubic" and upscaleshader == nil then
+		local ok, shader = pcall(graphics.newShader, UPSCALE_SHADER)
+		upscaleshader = ok and shader or false
+	end
+
+	local d = drs
+	if d == nil then
+		d = {frames = 0}
+	end
+
+	d.target = target
+	d.minscale = minscale
+	d.maxscale = maxscale
+	d.upscale = upscale
+
+	d.scale = quantizescale(d, checksetting(settings, "scale", d.scale or maxscale))
+
+	if d.canvas == nil or d.canvas:getDPIScale() ~= graphics.getDPIScale() * d.scale then
+		local active = d.canvas ~= nil and getCanvas() == d.canvas
+		createcanvas(d)
+		if active then
+			bindcanvas(d)
+		end
+	end
+
+	if drs == nil then
+		drs = d
+		if getCanvas() == nil then
+			bindcanvas(d)
+		end
+	end
+end
+
+function graphics.isDynamicResolutionEnabled()
+	return drs ~= nil
+end
+
+function graphics.getDynamicResolutionScale()
+	return drs and drs.scale or 1
+end
+
+-- DO NOT REMOVE THE NEXT LINE. It is used to load this file as a C++ string.
+--)luastring"--"
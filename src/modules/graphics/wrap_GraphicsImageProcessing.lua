@@ -0,0 +1,445 @@
+R"luastring"--(
+-- DO NOT REMOVE THE ABOVE LINE. It is used to load this file as a C++ string.
+-- There is a matching delimiter at the bottom of the file.
+
+--[[
+Copyright (c) 2006-2024 LOVE Development Team
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+claim that you wrote the original software. If you use this software
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+--]]
+
+-- Built-in compute kernels for common image processing passes: separable
+-- gaussian and box blurs, downsample chains, and luminance histograms with
+-- an average luminance reduction. They read from any readable texture and
+-- write to textures created with computewrite = true, so they need GLSL 4
+-- support.
+--
+-- The blur loads each row or column segment plus its apron into shared
+-- memory once, instead of sampling the source (2 * radius + 1) times per
+-- pixel. The downsample writes two levels per dispatch, the second one from
+-- the first level's results in shared memory. The histogram is accumulated
+-- in shared memory per thread group and merged into the buffer with one
+-- atomic add per bin and group.
+
+local graphics = love.graphics
+
+local type, error, ipairs, tostring = type, error, ipairs, tostring
+local math_ceil, math_exp, math_max, math_min, math_floor = math.ceil, math.exp, math.max, math.min, math.floor
+local string_format = string.format
+local unpack = unpack or table.unpack
+
+local BLUR_GROUP_SIZE = 128
+local MAX_BLUR_RADIUS = 32
+local HISTOGRAM_BINS = 256
+
+-- Pixel formats which can be used as the destination, and their GLSL image
+-- format qualifiers.
+local STORAGE_FORMATS = {
+	rgba8 = "rgba8",
+	rgba16f = "rgba16f",
+	rgba32f = "rgba32f",
+	rg8 = "rg8",
+	rg16f = "rg16f",
+	rg32f = "rg32f",
+	r8 = "r8",
+	r16f = "r16f",
+	r32f = "r32f",
+}
+
+local BLUR_SHADER = [[
+#pragma language glsl4
+
+layout (local_size_x = GROUP_SIZE, local_size_y = 1, local_size_z = 1) in;
+
+uniform Image source;
+layout (FORMAT) uniform writeonly image2D dest;
+
+// (1, 0) for the horizontal pass, (0, 1) for the vertical one.
+uniform ivec2 direction;
+uniform int radius;
+uniform float weights[MAX_RADIUS + 1];
+
+shared vec4 tile[GROUP_SIZE + 2 * MAX_RADIUS];
+
+void computemain()
+{
+	ivec2 size = textureSize(source, 0);
+	ivec2 across = ivec2(1) - direction;
+	int len = size.x * direction.x + size.y * direction.y;
+
+	int start = int(love_ThreadGroupID.x) * GROUP_SIZE;
+	int row = int(love_ThreadGroupID.y);
+	int lid = int(love_LocalThreadIndex);
+
+	for (int i = lid; i < GROUP_SIZE + 2 * radius; i += GROUP_SIZE)
+	{
+		int p = clamp(start + i - radius, 0, len - 1);
+		tile[i] = texelFetch(source, direction * p + across * row, 0);
+	}
+
+	barrier();
+
+	int p = start + lid;
+	if (p >= len)
+		return;
+
+	vec4 sum = tile[lid + radius] * weights[0];
+	for (int i = 1; i <= radius; i++)
+		sum += (tile[lid + radius - i] + tile[lid + radius + i]) * weights[i];
+
+	imageStore(dest, direction * p + across * row, sum);
+}
+]]
+
+local DOWNSAMPLE_SHADER = [[
+#pragma language glsl4
+
+layout (local_size_x = 16, local_size_y = 16, local_size_z = 1) in;
+
+uniform Image source;
+layout (FORMAT) uniform writeonly image2D dest1;
+layout (FORMAT) uniform writeonly image2D dest2;
+uniform int levels;
+
+shared vec4 tile[16][16];
+
+void computemain()
+{
+	ivec2 sourcemax = textureSize(source, 0) - 1;
+	ivec2 size1 = imageSize(dest1);
+	ivec2 gid = ivec2(love_GlobalThreadID.xy);
+	ivec2 lid = ivec2(love_LocalThreadID.xy);
+
+	// Threads past the edge still compute the clamped edge pixel, so the
+	// second level can read complete 2x2 blocks from the tile.
+	ivec2 pos = min(gid, size1 - 1);
+	ivec2 s = pos * 2;
+	vec4 c = texelFetch(source, min(s, sourcemax), 0);
+	c += texelFetch(source, min(s + ivec2(1, 0), sourcemax), 0);
+	c += texelFetch(source, min(s + ivec2(0, 1), sourcemax), 0);
+	c += texelFetch(source, min(s + ivec2(1, 1), sourcemax), 0);
+	c *= 0.25;
+
+	if (gid.x < size1.x && gid.y < size1.y)
+		imageStore(dest1, pos, c);
+
+	if (levels < 2)
+		return;
+
+	tile[lid.y][lid.x] = c;
+	barrier();
+
+	if (lid.x < 8 && lid.y < 8)
+	{
+		ivec2 pos2 = ivec2(love_ThreadGroupID.xy) * 8 + lid;
+		ivec2 size2 = imageSize(dest2);
+		if (pos2.x < size2.x && pos2.y < size2.y)
+		{
+			ivec2 t = lid * 2;
+			vec4 c2 = tile[t.y][t.x] + tile[t.y][t.x + 1] + tile[t.y + 1][t.x] + tile[t.y + 1][t.x + 1];
+			imageStore(dest2, pos2, c2 * 0.25);
+		}
+	}
+}
+]]
+
+local HISTOGRAM_SHADER = [[
+#pragma language glsl4
+
+layout (local_size_x = 16, local_size_y = 16, local_size_z = 1) in;
+
+uniform Image source;
+
+// Minimum and maximum log2 luminance. Bin 0 holds black pixels.
+uniform vec2 range;
+
+layout (std430) buffer Histogram
+{
+	uint bins[];
+};
+
+shared uint localbins[256];
+
+void computemain()
+{
+	uint lid = love_LocalThreadIndex;
+	localbins[lid] = 0u;
+	barrier();
+
+	ivec2 size = textureSize(source, 0);
+	ivec2 pos = ivec2(love_GlobalThreadID.xy);
+	if (pos.x < size.x && pos.y < size.y)
+	{
+		vec3 c = texelFetch(source, pos, 0).rgb;
+		float lum = dot(c, vec3(0.2126, 0.7152, 0.0722));
+		uint bin = 0u;
+		if (lum > 0.00001)
+		{
+			float t = clamp((log2(lum) - range.x) / (range.y - range.x), 0.0, 1.0);
+			bin = uint(t * 254.0 + 1.0);
+		}
+		atomicAdd(localbins[bin], 1u);
+	}
+
+	barrier();
+
+	if (localbins[lid] != 0u)
+		atomicAdd(bins[lid], localbins[lid]);
+}
+]]
+
+local LUMINANCE_SHADER = [[
+#pragma language glsl4
+
+layout (local_size_x = 256, local_size_y = 1, local_size_z = 1) in;
+
+layout (FORMAT) uniform writeonly image2D dest;
+uniform vec2 range;
+uniform float pixelcount;
+
+layout (std430) buffer Histogram
+{
+	uint bins[];
+};
+
+shared float weighted[256];
+
+void computemain()
+{
+	uint lid = love_LocalThreadIndex;
+	weighted[lid] = float(bins[lid]) * float(lid);
+	barrier();
+
+	for (uint s = 128u; s > 0u; s >>= 1u)
+	{
+		if (lid < s)
+			weighted[lid] += weighted[lid + s];
+		barrier();
+	}
+
+	if (lid == 0u)
+	{
+		float count = max(pixelcount - float(bins[0]), 1.0);
+		float bin = weighted[0] / count;
+		float lum = 0.0;
+		if (bin >= 1.0)
+			lum = exp2((bin - 1.0) / 254.0 * (range.y - range.x) + range.x);
+		imageStore(dest, ivec2(0, 0), vec4(lum, lum, lum, 1.0));
+	}
+}
+]]
+
+local shaders = {}
+local temporarytextures = {}
+local histogrambuffer = nil
+
+local function checksupported()
+	if not graphics.getSupported().glsl4 then
+		error("Compute shaders are not supported on this system.", 3)
+	end
+end
+
+local function getshader(name, code, format)
+	local key = name .. ":" .. (format or "")
+	local shader = shaders[key]
+	if shader == nil then
+		local defines = {
+			GROUP_SIZE = BLUR_GROUP_SIZE,
+			MAX_RADIUS = MAX_BLUR_RADIUS,
+			FORMAT = format and STORAGE_FORMATS[format] or nil,
+		}
+		shader = graphics.newComputeShader(code, {defines = defines, debugname = "love." .. name})
+		shaders[key] = shader
+	end
+	return shader
+end
+
+local function checkdest(dest, arg, fname)
+	local format = dest:getFormat()
+	if STORAGE_FORMATS[format] == nil then
+		error(string_format("bad argument #%d to '%s' (unsupported storage texture format '%s')", arg, fname, format), 3)
+	end
+	if not dest:isComputeWritable() then
+		error(string_format("bad argument #%d to '%s' (texture must be created with computewrite = true)", arg, fname), 3)
+	end
+	return format
+end
+
+local function gettemporarytexture(width, height, format)
+	local key = string_format("%dx%d:%s", width, height, format)
+	local texture = temporarytextures[key]
+	if texture == nil then
+		texture = graphics.newTexture(width, height, {
+			format = format,
+			computewrite = true,
+			debugname = "love.computeBlur temporary",
+		})
+		temporarytextures[key] = texture
+	end
+	return texture
+end
+
+local blurweights = {}
+
+local function computeblurweights(radius, mode, sigma)
+	if mode == "box" then
+		for i = 0, radius do
+			blurweights[i + 1] = 1 / (2 * radius + 1)
+		end
+	elseif mode == "gaussian" then
+		sigma = sigma or math_max(radius / 2, 0.5)
+		local total = 0
+		for i = 0, radius do
+			local w = math_exp(-(i * i) / (2 * sigma * sigma))
+			blurweights[i + 1] = w
+			total = total + (i == 0 and w or 2 * w)
+		end
+		for i = 0, radius do
+			blurweights[i + 1] = blurweights[i + 1] / total
+		end
+	else
+		error("Invalid blur mode '" .. tostring(mode) .. "', expected one of: 'gaussian', 'box'", 3)
+	end
+
+	for i = radius + 2, MAX_BLUR_RADIUS + 1 do
+		blurweights[i] = 0
+	end
+
+	return blurweights
+end
+
+-- love.graphics.computeBlur(source, dest, radius [, mode, sigma])
+function graphics.computeBlur(source, dest, radius, mode, sigma)
+	checksupported()
+	local format = checkdest(dest, 2, "computeBlur")
+
+	radius = math_floor(radius or 0)
+	if radius < 0 or radius > MAX_BLUR_RADIUS then
+		error(string_format("Blur radius must be between 0 and %d.", MAX_BLUR_RADIUS), 2)
+	end
+
+	local width, height = source:getPixelDimensions()
+	local dwidth, dheight = dest:getPixelDimensions()
+	if width ~= dwidth or height ~= dheight then
+		error("The source and destination textures of a blur must have the same dimensions.", 2)
+	end
+
+	local shader = getshader("computeBlur", BLUR_SHADER, format)
+	shader:send("weights", unpack(computeblurweights(radius, mode or "gaussian", sigma), 1, MAX_BLUR_RADIUS + 1))
+	shader:send("radius", radius)
+
+	local temp = gettemporarytexture(width, height, format)
+
+	shader:send("source", source)
+	shader:send("dest", temp)
+	shader:send("direction", {1, 0})
+	graphics.dispatchThreadgroups(shader, math_ceil(width / BLUR_GROUP_SIZE), height)
+
+	shader:send("source", temp)
+	shader:send("dest", dest)
+	shader:send("direction", {0, 1})
+	graphics.dispatchThreadgroups(shader, math_ceil(height / BLUR_GROUP_SIZE), width)
+end
+
+-- love.graphics.computeDownsample(source, dests)
+-- Each texture in dests gets half the resolution of the one before it.
+function graphics.computeDownsample(source, dests)
+	checksupported()
+	if type(dests) ~= "table" then
+		error("bad argument #2 to 'computeDownsample' (table expected, got " .. type(dests) .. ")", 2)
+	end
+
+	local format = nil
+	for _, dest in ipairs(dests) do
+		local destformat = checkdest(dest, 2, "computeDownsample")
+		if format ~= nil and destformat ~= format then
+			error("All downsample destination textures must have the same format.", 2)
+		end
+		format = destformat
+	end
+
+	if format == nil then
+		return
+	end
+
+	local shader = getshader("computeDownsample", DOWNSAMPLE_SHADER, format)
+
+	local i = 1
+	while i <= #dests do
+		local dest1 = dests[i]
+		local dest2 = dests[i + 1]
+		local width, height = dest1:getPixelDimensions()
+
+		shader:send("source", i == 1 and source or dests[i - 1])
+		shader:send("dest1", dest1)
+		shader:send("dest2", dest2 or dest1)
+		shader:send("levels", dest2 and 2 or 1)
+		graphics.dispatchThreadgroups(shader, math_ceil(width / 16), math_ceil(height / 16))
+
+		i = i + 2
+	end
+end
+
+-- love.graphics.computeHistogram(source, buffer [, minlog, maxlog])
+-- The buffer needs shaderstorage = true and at least 256 uint32 elements.
+function graphics.computeHistogram(source, buffer, minlog, maxlog)
+	checksupported()
+	minlog = minlog or -8
+	maxlog = maxlog or 4
+	if maxlog <= minlog then
+		error("The maximum log luminance must be greater than the minimum.", 2)
+	end
+
+	buffer:clear()
+
+	local shader = getshader("computeHistogram", HISTOGRAM_SHADER)
+	shader:send("source", source)
+	shader:send("range", {minlog, maxlog})
+	shader:send("Histogram", buffer)
+
+	local width, height = source:getPixelDimensions()
+	graphics.dispatchThreadgroups(shader, math_ceil(width / 16), math_ceil(height / 16))
+end
+
+-- love.graphics.computeLuminance(source, dest [, minlog, maxlog])
+-- Writes the average luminance of the source to the first pixel of dest.
+function graphics.computeLuminance(source, dest, minlog, maxlog)
+	checksupported()
+	local format = checkdest(dest, 2, "computeLuminance")
+	minlog = minlog or -8
+	maxlog = maxlog or 4
+
+	if histogrambuffer == nil then
+		histogrambuffer = graphics.newBuffer("uint32", HISTOGRAM_BINS, {
+			shaderstorage = true,
+			debugname = "love.computeLuminance histogram",
+		})
+	end
+
+	graphics.computeHistogram(source, histogrambuffer, minlog, maxlog)
+
+	local width, height = source:getPixelDimensions()
+	local shader = getshader("computeLuminance", LUMINANCE_SHADER, format)
+	shader:send("dest", dest)
+	shader:send("range", {minlog, maxlog})
+	shader:send("pixelcount", width * height)
+	shader:send("Histogram", histogrambuffer)
+	graphics.dispatchThreadgroups(shader, 1)
+end
+
+-- DO NOT REMOVE THE NEXT LINE. It is used to load this file as a C++ string.
+--)luastring"--"
@@ -22,6 +22,9 @@
 #include "wrap_GraphicsReadback.h"
 #include "data/ByteData.h"
 #include "image/ImageData.h"
+#include "wrap_Buffer.h"
+#include "wrap_Texture.h"
+#include "Buffer.h"
 
 namespace love
 {
@@ -91,5 +94,101 @@ extern "C" int luaopen_graphicsreadback(lua_State *L)
 	return luax_register_type(L, &GraphicsReadback::type, w_GraphicsReadback_functions, nullptr);
 }
 
+static ReadbackRing *luax_checkreadbackring(lua_State *L, int idx)
+{
+	return luax_checktype<ReadbackRing>(L, idx);
+}
+
+int w_ReadbackRing_readbackBuffer(lua_State *L)
+{
+	ReadbackRing *ring = luax_checkreadbackring(L, 1);
+	Buffer *b = luax_checkbuffer(L, 2);
+	lua_Integer offset = luaL_optinteger(L, 3, 0);
+	lua_Integer size = luaL_optinteger(L, 4, b->getSize() - offset);
+
+	auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+
+	GraphicsReadback *r = nullptr;
+	luax_catchexcept(L, [&]() { r = ring->readbackBuffer(gfx, b, offset, size); });
+
+	luax_pushtype(L, r);
+	return 1;
+}
+
+int w_ReadbackRing_readbackTexture(lua_State *L)
+{
+	ReadbackRing *ring = luax_checkreadbackring(L, 1);
+	Texture *t = luax_checktexture(L, 2);
+
+	int slice = 0;
+	if (t->getTextureType() != TEXTURE_2D)
+		slice = (int) luaL_checkinteger(L, 3) - 1;
+
+	int mipmap = (int) luaL_optinteger(L, 4, 1) - 1;
+
+	Rect rect = {0, 0, t->getPixelWidth(mipmap), t->getPixelHeight(mipmap)};
+	if (!lua_isnoneornil(L, 5))
+	{
+		rect.x = (int) luaL_checkinteger(L, 5);
+		rect.y = (int) luaL_checkinteger(L, 6);
+		rect.w = (int) luaL_checkinteger(L, 7);
+		rect.h = (int) luaL_checkinteger(L, 8);
+	}
+
+	auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+
+	GraphicsReadback *r = nullptr;
+	luax_catchexcept(L, [&]() { r = ring->readbackTexture(gfx, t, slice, mipmap, rect); });
+
+	luax_pushtype(L, r);
+	return 1;
+}
+
+int w_ReadbackRing_poll(lua_State *L)
+{
+	ReadbackRing *ring = luax_checkreadbackring(L, 1);
+
+	std::vector<GraphicsReadback *> completed;
+	luax_catchexcept(L, [&]() { ring->poll(completed); });
+
+	lua_createtable(L, (int) completed.size(), 0);
+	for (size_t i = 0; i < completed.size(); i++)
+	{
+		luax_pushtype(L, completed[i]);
+		lua_rawseti(L, -2, (int) i + 1);
+	}
+
+	return 1;
+}
+
+int w_ReadbackRing_getSize(lua_State *L)
+{
+	ReadbackRing *ring = luax_checkreadbackring(L, 1);
+	lua_pushinteger(L, ring->getSize());
+	return 1;
+}
+
+int w_ReadbackRing_getPendingCount(lua_State *L)
+{
+	ReadbackRing *ring = luax_checkreadbackring(L, 1);
+	lua_pushinteger(L, ring->getPendingCount());
+	return 1;
+}
+
+static const luaL_Reg w_ReadbackRing_functions[] =
+{
+	{ "readbackBuffer", w_ReadbackRing_readbackBuffer },
+	{ "readbackTexture", w_ReadbackRing_readbackTexture },
+	{ "poll", w_ReadbackRing_poll },
+	{ "getSize", w_ReadbackRing_getSize },
+	{ "getPendingCount", w_ReadbackRing_getPendingCount },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_readbackring(lua_State *L)
+{
+	return luax_register_type(L, &ReadbackRing::type, w_ReadbackRing_functions, nullptr);
+}
+
 } // graphics
 } // love
@@ -31,6 +31,7 @@ namespace graphics
 
 GraphicsReadback *luax_checkgraphicsreadback(lua_State *L, int idx);
 extern "C" int luaopen_graphicsreadback(lua_State *L);
+extern "C" int luaopen_readbackring(lua_State *L);
 
 } // graphics
 } // love
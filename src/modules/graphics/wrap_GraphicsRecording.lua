@@ -0,0 +1,214 @@
+R"luastring"--(
+-- DO NOT REMOVE THE ABOVE LINE. It is used to load this file as a C++ string.
+-- There is a matching delimiter at the bottom of the file.
+
+--[[
+Copyright (c) 2006-2024 LOVE Development Team
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+claim that you wrote the original software. If you use this software
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+--]]
+
+-- Gameplay recording. While recording, every presented frame is copied on the
+-- GPU into one of a few recycled canvases with captureBackbuffer, read back with
+-- readbackTextureAsync into a recycled ImageData, and encoded to a numbered
+-- image file on the ImageData:encodeAsync worker threads. Nothing waits for the
+-- GPU or the encoder: if every slot is still busy the frame is dropped.
+--
+-- The image sequence can be turned into a video afterwards, for example with
+--   ffmpeg -framerate 60 -i %06d.qoi -c:v libx264 -pix_fmt yuv420p out.mp4
+
+local graphics = love.graphics
+
+local type, ipairs, error, pcall, tostring = type, ipairs, error, pcall, tostring
+local string_format = string.format
+
+local present = graphics.present
+
+local FORMATS = {qoi = true, png = true, tga = true}
+
+local recording = nil
+
+local function createslots(r)
+	local width, height = graphics.getPixelDimensions()
+	local format = graphics.isGammaCorrect() and "srgba8" or "rgba8"
+
+	r.width, r.height = width, height
+	r.slots = {}
+
+	for i = 1, r.buffers do
+		r.slots[i] = {
+			state = "free",
+			canvas = graphics.newCanvas(width, height, {format = format, dpiscale = 1}),
+			imagedata = love.image.newImageData(width, height, "rgba8"),
+		}
+	end
+end
+
+local function releaseslots(r)
+	for _, slot in ipairs(r.slots) do
+		slot.canvas:release()
+		slot.imagedata:release()
+	end
+	r.slots = {}
+end
+
+local function startencode(r, slot)
+	if slot.readback:hasError() then
+		r.dropped = r.dropped + 1
+		slot.state = "free"
+	else
+		slot.encode = slot.imagedata:encodeAsync(r.format, slot.filename, r.level)
+		slot.state = "encode"
+		r.recorded = r.recorded + 1
+	end
+	slot.readback = nil
+end
+
+local function updateslots(r)
+	for _, slot in ipairs(r.slots) do
+		if slot.state == "readback" and slot.readback:isComplete() then
+			startencode(r, slot)
+		end
+		if slot.state == "encode" and slot.encode:isComplete() then
+			slot.encode = nil
+			slot.state = "free"
+		end
+	end
+end
+
+-- Waits for every pending readback and encode.
+local function flushslots(r)
+	for _, slot in ipairs(r.slots) do
+		if slot.state == "readback" then
+			slot.readback:wait()
+			startencode(r, slot)
+		end
+		if slot.state == "encode" then
+			-- Failed encodes have already been reported by the encode thread.
+			pcall(slot.encode.getFileData, slot.encode)
+			slot.encode = nil
+			slot.state = "free"
+		end
+	end
+end
+
+graphics.present = function(...)
+	local r = recording
+	if r == nil or not graphics.isActive() then
+		return present(...)
+	end
+
+	updateslots(r)
+
+	local width, height = graphics.getPixelDimensions()
+	if width ~= r.width or height ~= r.height then
+		flushslots(r)
+		releaseslots(r)
+		createslots(r)
+	end
+
+	local capture = nil
+	for _, slot in ipairs(r.slots) do
+		if slot.state == "free" then
+			capture = slot
+			break
+		end
+	end
+
+	if capture ~= nil then
+		graphics.captureBackbuffer(capture.canvas)
+		capture.state = "capture"
+	else
+		r.dropped = r.dropped + 1
+	end
+
+	present(...)
+
+	if capture ~= nil then
+		r.frame = r.frame + 1
+		capture.filename = string_format("%s/%06d.%s", r.directory, r.frame, r.format)
+		capture.readback = graphics.readbackTextureAsync(capture.canvas, 1, 1, 0, 0, r.width, r.height, capture.imagedata)
+		capture.state = "readback"
+	end
+end
+
+function graphics.startRecording(directory, settings)
+	if type(directory) ~= "string" then
+		error("bad argument #1 to startRecording (expected string)", 2)
+	end
+	if settings ~= nil and type(settings) ~= "table" then
+		error("bad argument #2 to startRecording (expected table)", 2)
+	end
+	settings = settings or {}
+
+	if recording ~= nil then
+		error("A recording is already in progress.", 2)
+	end
+	if not love.image or not love.filesystem then
+		error("Recording requires the love.image and love.filesystem modules.", 2)
+	end
+	if not graphics.getSupported().backbuffercapture then
+		error("Recording is not supported by the current renderer.", 2)
+	end
+
+	local format = settings.format or "qoi"
+	if not FORMATS[format] then
+		error("Invalid recording format '" .. tostring(format) .. "' (expected 'qoi', 'png', or 'tga')", 2)
+	end
+
+	local buffers = settings.buffers or 4
+	if type(buffers) ~= "number" or buffers < 1 or buffers % 1 ~= 0 then
+		error("Invalid recording setting 'buffers' (expected positive integer)", 2)
+	end
+
+	if not love.filesystem.createDirectory(directory) then
+		error("Could not create recording directory '" .. directory .. "'", 2)
+	end
+
+	local r = {
+		directory = directory,
+		format = format,
+		level = settings.level,
+		buffers = buffers,
+		frame = 0,
+		recorded = 0,
+		dropped = 0,
+	}
+
+	createslots(r)
+	recording = r
+end
+
+function graphics.stopRecording()
+	local r = recording
+	if r == nil then
+		return 0, 0
+	end
+
+	recording = nil
+	flushslots(r)
+	releaseslots(r)
+
+	return r.recorded, r.dropped
+end
+
+function graphics.isRecording()
+	return recording ~= nil
+end
+
+-- DO NOT REMOVE THE NEXT LINE. It is used to load this file as a C++ string.
+--)luastring"--"
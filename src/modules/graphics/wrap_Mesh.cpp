@@ -27,16 +27,143 @@
 // C++
 #include <algorithm>
 
+// Shove the wrap_Mesh.lua code directly into a raw string literal.
+static const char mesh_lua[] =
+#include "wrap_Mesh.lua"
+;
+
 namespace love
 {
 namespace graphics
 {
 
+/**
+ * NOTE: Additional wrapper code is in wrap_Mesh.lua. Be sure to keep it in
+ * sync with any changes made to this file!
+ **/
+
 Mesh *luax_checkmesh(lua_State *L, int idx)
 {
 	return luax_checktype<Mesh>(L, idx);
 }
 
+typedef void (*VertexWriter)(lua_State *L, int startidx, char *data);
+typedef int (*VertexReader)(lua_State *L, const char *data);
+
+struct VertexPacker
+{
+	VertexWriter write;
+	VertexReader read;
+};
+
+// Packing for the most common vertex formats: a float position, optional
+// float texture coordinates and an optional unorm8 color, tightly packed in
+// that order. Matches luax_writebufferdata and luax_readbufferdata, without
+// switching on every attribute's format for every vertex.
+template <int POSITION, int TEXCOORD, bool COLOR>
+static void writePackedVertex(lua_State *L, int startidx, char *data)
+{
+	float *components = (float *) data;
+	for (int i = 0; i < POSITION + TEXCOORD; i++)
+		components[i] = (float) luaL_optnumber(L, startidx + i, 0.0);
+
+	if (COLOR)
+	{
+		uint8 *color = (uint8 *) (components + POSITION + TEXCOORD);
+		startidx += POSITION + TEXCOORD;
+		for (int i = 0; i < 4; i++)
+			color[i] = (uint8) (luax_optnumberclamped01(L, startidx + i, 1.0) * 255);
+	}
+}
+
+template <int POSITION, int TEXCOORD, bool COLOR>
+static int readPackedVertex(lua_State *L, const char *data)
+{
+	const float *components = (const float *) data;
+	for (int i = 0; i < POSITION + TEXCOORD; i++)
+		lua_pushnumber(L, (lua_Number) components[i]);
+
+	if (COLOR)
+	{
+		const uint8 *color = (const uint8 *) (components + POSITION + TEXCOORD);
+		for (int i = 0; i < 4; i++)
+			lua_pushnumber(L, (lua_Number) color[i] / 255.0);
+	}
+
+	return POSITION + TEXCOORD + (COLOR ? 4 : 0);
+}
+
+static int getFloatVectorComponents(const Buffer::DataMember &member)
+{
+	if (member.decl.arrayLength > 0)
+		return 0;
+	else if (member.decl.format == DATAFORMAT_FLOAT_VEC2)
+		return 2;
+	else if (member.decl.format == DATAFORMAT_FLOAT_VEC3)
+		return 3;
+	else
+		return 0;
+}
+
+static bool getVertexPacker(const std::vector<Buffer::DataMember> &format, VertexPacker &packer)
+{
+	static const VertexPacker packers[2][2][2] =
+	{
+		{
+			{
+				{ writePackedVertex<2, 0, false>, readPackedVertex<2, 0, false> },
+				{ writePackedVertex<2, 0, true>, readPackedVertex<2, 0, true> },
+			},
+			{
+				{ writePackedVertex<2, 2, false>, readPackedVertex<2, 2, false> },
+				{ writePackedVertex<2, 2, true>, readPackedVertex<2, 2, true> },
+			},
+		},
+		{
+			{
+				{ writePackedVertex<3, 0, false>, readPackedVertex<3, 0, false> },
+				{ writePackedVertex<3, 0, true>, readPackedVertex<3, 0, true> },
+			},
+			{
+				{ writePackedVertex<3, 2, false>, readPackedVertex<3, 2, false> },
+				{ writePackedVertex<3, 2, true>, readPackedVertex<3, 2, true> },
+			},
+		},
+	};
+
+	if (format.empty() || format.size() > 3)
+		return false;
+
+	int position = getFloatVectorComponents(format[0]);
+	if (position == 0 || format[0].offset != 0)
+		return false;
+
+	size_t next = 1;
+	int texcoord = 0;
+	bool color = false;
+
+	if (next < format.size() && getFloatVectorComponents(format[next]) == 2
+		&& format[next].offset == position * sizeof(float))
+	{
+		texcoord = 2;
+		next++;
+	}
+
+	if (next < format.size() && format[next].decl.format == DATAFORMAT_UNORM8_VEC4
+		&& format[next].decl.arrayLength == 0
+		&& format[next].offset == (position + texcoord) * sizeof(float))
+	{
+		color = true;
+		next++;
+	}
+
+	if (next != format.size())
+		return false;
+
+	packer = packers[position - 2][texcoord / 2][color ? 1 : 0];
+	return true;
+}
+
 int w_Mesh_setVertices(lua_State *L)
 {
 	Mesh *t = luax_checkmesh(L, 1);
@@ -92,6 +219,9 @@ int w_Mesh_setVertices(lua_State *L)
 
 	char *data = (char *) t->getVertexData() + byteoffset;
 
+	VertexPacker packer;
+	bool packed = getVertexPacker(vertexformat, packer);
+
 	for (int i = 0; i < vertcount; i++)
 	{
 		// get vertices[vertindex]
@@ -104,11 +234,16 @@ int w_Mesh_setVertices(lua_State *L)
 
 		int idx = -ncomponents;
 
-		for (const Buffer::DataMember &member : vertexformat)
+		if (packed)
+			packer.write(L, idx, data);
+		else
 		{
-			// Fetch the values from Lua and store them in data buffer.
-			luax_writebufferdata(L, idx, member.decl.format, data + member.offset);
-			idx += member.info.components;
+			for (const Buffer::DataMember &member : vertexformat)
+			{
+				// Fetch the values from Lua and store them in data buffer.
+				luax_writebufferdata(L, idx, member.decl.format, data + member.offset);
+				idx += member.info.components;
+			}
 		}
 
 		lua_pop(L, ncomponents + 1);
@@ -137,7 +272,25 @@ int w_Mesh_setVertex(lua_State *L)
 
 	int idx = istable ? 1 : 3;
 
-	if (istable)
+	VertexPacker packer;
+	if (getVertexPacker(vertexformat, packer))
+	{
+		if (istable)
+		{
+			int ncomponents = 0;
+			for (const Buffer::DataMember &member : vertexformat)
+				ncomponents += member.info.components;
+
+			for (int i = 1; i <= ncomponents; i++)
+				lua_rawgeti(L, 3, i);
+
+			packer.write(L, -ncomponents, data);
+			lua_pop(L, ncomponents);
+		}
+		else
+			packer.write(L, idx, data);
+	}
+	else if (istable)
 	{
 		for (const Buffer::DataMember &member : vertexformat)
 		{
@@ -177,6 +330,10 @@ int w_Mesh_getVertex(lua_State *L)
 	const char *data = nullptr;
 	luax_catchexcept(L, [&](){ data = (const char *) t->checkVertexDataOffset(index, nullptr); });
 
+	VertexPacker packer;
+	if (getVertexPacker(vertexformat, packer))
+		return packer.read(L, data);
+
 	int n = 0;
 
 	for (const Buffer::DataMember &member : vertexformat)
@@ -389,6 +546,14 @@ int w_Mesh_flush(lua_State *L)
 	return 0;
 }
 
+// Placeholder, overridden by the FFI code when the FFI is available.
+int w_Mesh_getVertexFFIPointer(lua_State *L)
+{
+	luax_checkmesh(L, 1);
+	lua_pushnil(L);
+	return 1;
+}
+
 int w_Mesh_setVertexMap(lua_State *L)
 {
 	Mesh *t = luax_checkmesh(L, 1);
@@ -489,6 +654,24 @@ int w_Mesh_getIndexBuffer(lua_State *L)
 	return 1;
 }
 
+int w_Mesh_optimize(lua_State *L)
+{
+	Mesh *t = luax_checkmesh(L, 1);
+	Mesh::OptimizeSettings settings;
+
+	if (!lua_isnoneornil(L, 2))
+	{
+		luaL_checktype(L, 2, LUA_TTABLE);
+		settings.deduplicate = luax_boolflag(L, 2, "deduplicate", settings.deduplicate);
+		settings.vertexCache = luax_boolflag(L, 2, "vertexcache", settings.vertexCache);
+		settings.overdraw = luax_boolflag(L, 2, "overdraw", settings.overdraw);
+		settings.quantize = luax_boolflag(L, 2, "quantize", settings.quantize);
+	}
+
+	luax_catchexcept(L, [&](){ t->optimize(settings); });
+	return 0;
+}
+
 int w_Mesh_setTexture(lua_State *L)
 {
 	Mesh *t = luax_checkmesh(L, 1);
@@ -516,6 +699,33 @@ int w_Mesh_getTexture(lua_State *L)
 	return 1;
 }
 
+int w_Mesh_setBoneBuffer(lua_State *L)
+{
+	Mesh *t = luax_checkmesh(L, 1);
+
+	if (lua_isnoneornil(L, 2))
+		t->setBoneBuffer();
+	else
+	{
+		Buffer *buffer = luax_checkbuffer(L, 2);
+		luax_catchexcept(L, [&](){ t->setBoneBuffer(buffer); });
+	}
+
+	return 0;
+}
+
+int w_Mesh_getBoneBuffer(lua_State *L)
+{
+	Mesh *t = luax_checkmesh(L, 1);
+	Buffer *buffer = t->getBoneBuffer();
+
+	if (buffer == nullptr)
+		return 0;
+
+	luax_pushtype(L, buffer);
+	return 1;
+}
+
 int w_Mesh_setDrawMode(lua_State *L)
 {
 	Mesh *t = luax_checkmesh(L, 1);
@@ -572,6 +782,73 @@ int w_Mesh_getDrawRange(lua_State *L)
 	return 2;
 }
 
+int w_Mesh_setCullRect(lua_State *L)
+{
+	Mesh *t = luax_checkmesh(L, 1);
+
+	if (lua_isnoneornil(L, 2))
+		t->setCullRect();
+	else
+	{
+		float x = (float) luaL_checknumber(L, 2);
+		float y = (float) luaL_checknumber(L, 3);
+		float w = (float) luaL_checknumber(L, 4);
+		float h = (float) luaL_checknumber(L, 5);
+		luax_catchexcept(L, [&](){ t->setCullRect(x, y, w, h); });
+	}
+
+	return 0;
+}
+
+int w_Mesh_getCullRect(lua_State *L)
+{
+	Mesh *t = luax_checkmesh(L, 1);
+
+	float x = 0.0f, y = 0.0f, w = 0.0f, h = 0.0f;
+	if (!t->getCullRect(x, y, w, h))
+		return 0;
+
+	lua_pushnumber(L, x);
+	lua_pushnumber(L, y);
+	lua_pushnumber(L, w);
+	lua_pushnumber(L, h);
+	return 4;
+}
+
+// C functions in a struct, necessary for the FFI versions of Mesh methods.
+struct FFI_Mesh
+{
+	void *(*getVertexData)(Proxy *p);
+	size_t (*getVertexStride)(Proxy *p);
+	size_t (*getVertexCount)(Proxy *p);
+	void (*setVertexDataModified)(Proxy *p, size_t offset, size_t size);
+};
+
+static FFI_Mesh ffifuncs =
+{
+	[](Proxy *p) -> void * // getVertexData
+	{
+		auto mesh = luax_ffi_checktype<Mesh>(p);
+		return mesh != nullptr ? mesh->getVertexData() : nullptr;
+	},
+	[](Proxy *p) -> size_t // getVertexStride
+	{
+		auto mesh = luax_ffi_checktype<Mesh>(p);
+		return mesh != nullptr ? mesh->getVertexStride() : 0;
+	},
+	[](Proxy *p) -> size_t // getVertexCount
+	{
+		auto mesh = luax_ffi_checktype<Mesh>(p);
+		return mesh != nullptr ? mesh->getVertexCount() : 0;
+	},
+	[](Proxy *p, size_t offset, size_t size) // setVertexDataModified
+	{
+		auto mesh = luax_ffi_checktype<Mesh>(p);
+		if (mesh != nullptr)
+			mesh->setVertexDataModified(offset, size);
+	},
+};
+
 static const luaL_Reg w_Mesh_functions[] =
 {
 	{ "setVertices", w_Mesh_setVertices },
@@ -588,22 +865,30 @@ static const luaL_Reg w_Mesh_functions[] =
 	{ "getAttachedAttributes", w_Mesh_getAttachedAttributes },
 	{ "getVertexBuffer", w_Mesh_getVertexBuffer },
 	{ "flush", w_Mesh_flush },
+	{ "getVertexFFIPointer", w_Mesh_getVertexFFIPointer },
 	{ "setVertexMap", w_Mesh_setVertexMap },
 	{ "getVertexMap", w_Mesh_getVertexMap },
 	{ "setIndexBuffer", w_Mesh_setIndexBuffer },
 	{ "getIndexBuffer", w_Mesh_getIndexBuffer },
+	{ "optimize", w_Mesh_optimize },
 	{ "setTexture", w_Mesh_setTexture },
 	{ "getTexture", w_Mesh_getTexture },
+	{ "setBoneBuffer", w_Mesh_setBoneBuffer },
+	{ "getBoneBuffer", w_Mesh_getBoneBuffer },
 	{ "setDrawMode", w_Mesh_setDrawMode },
 	{ "getDrawMode", w_Mesh_getDrawMode },
 	{ "setDrawRange", w_Mesh_setDrawRange },
 	{ "getDrawRange", w_Mesh_getDrawRange },
+	{ "setCullRect", w_Mesh_setCullRect },
+	{ "getCullRect", w_Mesh_getCullRect },
 	{ 0, 0 }
 };
 
 extern "C" int luaopen_mesh(lua_State *L)
 {
-	return luax_register_type(L, &Mesh::type, w_Mesh_functions, nullptr);
+	int ret = luax_register_type(L, &Mesh::type, w_Mesh_functions, nullptr);
+	luax_runwrapper(L, mesh_lua, sizeof(mesh_lua), "Mesh.lua", Mesh::type, &ffifuncs);
+	return ret;
 }
 
 } // graphics
@@ -0,0 +1,233 @@
+R"luastring"--(
+-- DO NOT REMOVE THE ABOVE LINE. It is used to load this file as a C++ string.
+-- There is a matching delimiter at the bottom of the file.
+
+--[[
+Copyright (c) 2006-2024 LOVE Development Team
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+claim that you wrote the original software. If you use this software
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+--]]
+
+
+local Mesh_mt, ffifuncspointer_str, ffiwrapper = ...
+local Mesh = Mesh_mt.__index
+
+local tonumber, error = tonumber, error
+local type, pcall = type, pcall
+local min, max = math.min, math.max
+
+local function clamp01(x)
+	return min(max(x, 0), 1)
+end
+
+local function optnumber(v, default, argidx)
+	if v == nil then
+		return default
+	end
+	local n = tonumber(v)
+	if n == nil then
+		error("bad argument #"..argidx.." to 'setVertex' (number expected, got "..type(v)..")", 3)
+	end
+	return n
+end
+
+-- Everything below this point is efficient FFI replacements for existing
+-- Mesh functionality.
+
+if ffiwrapper == nil or not ffiwrapper.isjitenabled() then return end
+
+local ffi = ffiwrapper.ffi
+
+local ffifuncs = ffiwrapper.getfuncs("FFI_Mesh", [[
+typedef struct FFI_Mesh
+{
+	void *(*getVertexData)(Proxy *p);
+	size_t (*getVertexStride)(Proxy *p);
+	size_t (*getVertexCount)(Proxy *p);
+	void (*setVertexDataModified)(Proxy *p, size_t offset, size_t size);
+} FFI_Mesh;
+]], ffifuncspointer_str)
+
+local floatptr = ffi.typeof("float *")
+local uint8ptr = ffi.typeof("uint8_t *")
+
+local _setVertex = Mesh.setVertex
+local _getVertex = Mesh.getVertex
+local _release = Mesh.release
+local _optimize = Mesh.optimize
+
+local floatcomponents = {
+	floatvec2 = 2,
+	floatvec3 = 3,
+}
+
+-- Matches getVertexPacker in wrap_Mesh.cpp: a float position, optional float
+-- texture coordinates and an optional unorm8 color, tightly packed.
+local function getpackedformat(mesh)
+	local format = mesh:getVertexFormat()
+	if #format == 0 or #format > 3 then return nil end
+
+	for i = 1, #format do
+		if format[i].arraylength ~= 0 then return nil end
+	end
+
+	local position = floatcomponents[format[1].format]
+	if position == nil or format[1].offset ~= 0 then return nil end
+
+	local next, texcoord, color = 2, 0, false
+
+	local member = format[next]
+	if member ~= nil and member.format == "floatvec2" and member.offset == position * 4 then
+		texcoord = 2
+		next = next + 1
+	end
+
+	member = format[next]
+	if member ~= nil and member.format == "unorm8vec4" and member.offset == (position + texcoord) * 4 then
+		color = true
+		next = next + 1
+	end
+
+	if next <= #format then return nil end
+
+	return position + texcoord, color
+end
+
+-- Table which holds Mesh objects as keys, and information about the objects
+-- as values. Uses weak keys so the Mesh objects can still be GC'd properly.
+local objectcache = setmetatable({}, {
+	__mode = "k",
+	__index = function(self, mesh)
+		local data = ffifuncs.getVertexData(mesh)
+		local nfloats, color = getpackedformat(mesh)
+
+		local p = {
+			data = data ~= nil and data or nil,
+			stride = tonumber(ffifuncs.getVertexStride(mesh)),
+			count = tonumber(ffifuncs.getVertexCount(mesh)),
+			nfloats = nfloats,
+			color = color,
+		}
+
+		self[mesh] = p
+		return p
+	end,
+})
+
+function Mesh:setVertex(index, ...)
+	local p = objectcache[self]
+
+	if p.data == nil or p.nfloats == nil then
+		return _setVertex(self, index, ...)
+	end
+
+	index = tonumber(index)
+	if index == nil or index < 1 or index > p.count or index % 1 ~= 0 then
+		return _setVertex(self, index, ...)
+	end
+
+	local offset = (index - 1) * p.stride
+	local floats = ffi.cast(floatptr, ffi.cast(uint8ptr, p.data) + offset)
+	local nfloats = p.nfloats
+
+	local first = ...
+	if type(first) == "table" then
+		for i = 1, nfloats do
+			floats[i - 1] = optnumber(first[i], 0, 3)
+		end
+		if p.color then
+			local c = ffi.cast(uint8ptr, floats + nfloats)
+			for i = 1, 4 do
+				c[i - 1] = clamp01(optnumber(first[nfloats + i], 1, 3)) * 255
+			end
+		end
+	else
+		for i = 1, nfloats do
+			floats[i - 1] = optnumber((select(i, ...)), 0, i + 2)
+		end
+		if p.color then
+			local c = ffi.cast(uint8ptr, floats + nfloats)
+			for i = 1, 4 do
+				c[i - 1] = clamp01(optnumber((select(nfloats + i, ...)), 1, nfloats + i + 2)) * 255
+			end
+		end
+	end
+
+	ffifuncs.setVertexDataModified(self, offset, p.stride)
+end
+
+function Mesh:getVertex(index)
+	local p = objectcache[self]
+
+	if p.data == nil or p.nfloats == nil then
+		return _getVertex(self, index)
+	end
+
+	index = tonumber(index)
+	if index == nil or index < 1 or index > p.count or index % 1 ~= 0 then
+		return _getVertex(self, index)
+	end
+
+	local floats = ffi.cast(floatptr, ffi.cast(uint8ptr, p.data) + (index - 1) * p.stride)
+	local nfloats = p.nfloats
+
+	local a, b = tonumber(floats[0]), tonumber(floats[1])
+
+	if not p.color then
+		if nfloats == 2 then
+			return a, b
+		elseif nfloats == 3 then
+			return a, b, tonumber(floats[2])
+		end
+		return a, b, tonumber(floats[2]), tonumber(floats[3]), tonumber(floats[4])
+	end
+
+	local col = ffi.cast(uint8ptr, floats + nfloats)
+	local r, g, bl, al = col[0] / 255, col[1] / 255, col[2] / 255, col[3] / 255
+
+	if nfloats == 2 then
+		return a, b, r, g, bl, al
+	elseif nfloats == 3 then
+		return a, b, tonumber(floats[2]), r, g, bl, al
+	elseif nfloats == 4 then
+		return a, b, tonumber(floats[2]), tonumber(floats[3]), r, g, bl, al
+	end
+	return a, b, tonumber(floats[2]), tonumber(floats[3]), tonumber(floats[4]), r, g, bl, al
+end
+
+function Mesh:getVertexFFIPointer()
+	local p = objectcache[self]
+	if p.data == nil then return nil end
+
+	-- The caller can write anywhere in the vertex data through the pointer.
+	ffifuncs.setVertexDataModified(self, 0, p.stride * p.count)
+	return p.data
+end
+
+function Mesh:optimize(...)
+	-- The vertex data is reallocated, and its format and count can change.
+	objectcache[self] = nil
+	return _optimize(self, ...)
+end
+
+function Mesh:release()
+	objectcache[self] = nil
+	return _release(self)
+end
+
+-- DO NOT REMOVE THE NEXT LINE. It is used to load this file as a C++ string.
+--)luastring"--"
@@ -0,0 +1,87 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "wrap_OcclusionQuery.h"
+#include "Graphics.h"
+
+namespace love
+{
+namespace graphics
+{
+
+OcclusionQuery *luax_checkocclusionquery(lua_State *L, int idx)
+{
+	return luax_checktype<OcclusionQuery>(L, idx);
+}
+
+static void updateOcclusionQueries(lua_State *L)
+{
+	auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+	if (gfx != nullptr)
+		luax_catchexcept(L, [&]() { gfx->updateOcclusionQueries(); });
+}
+
+int w_OcclusionQuery_isResultAvailable(lua_State *L)
+{
+	OcclusionQuery *q = luax_checkocclusionquery(L, 1);
+	updateOcclusionQueries(L);
+	luax_pushboolean(L, q->isResultAvailable());
+	return 1;
+}
+
+int w_OcclusionQuery_getResult(lua_State *L)
+{
+	OcclusionQuery *q = luax_checkocclusionquery(L, 1);
+	updateOcclusionQueries(L);
+
+	if (!q->isResultAvailable())
+	{
+		lua_pushnil(L);
+		return 1;
+	}
+
+	luax_pushboolean(L, q->getSamples() > 0);
+	lua_pushnumber(L, (lua_Number) q->getSamples());
+	return 2;
+}
+
+int w_OcclusionQuery_isActive(lua_State *L)
+{
+	OcclusionQuery *q = luax_checkocclusionquery(L, 1);
+	luax_pushboolean(L, q->isActive());
+	return 1;
+}
+
+static const luaL_Reg w_OcclusionQuery_functions[] =
+{
+	{ "isResultAvailable", w_OcclusionQuery_isResultAvailable },
+	{ "getResult", w_OcclusionQuery_getResult },
+	{ "isActive", w_OcclusionQuery_isActive },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_occlusionquery(lua_State *L)
+{
+	return luax_register_type(L, &OcclusionQuery::type, w_OcclusionQuery_functions, nullptr);
+}
+
+} // graphics
+} // love
@@ -631,6 +631,21 @@ int w_ParticleSystem_hasRelativeRotation(lua_State *L)
 	return 1;
 }
 
+int w_ParticleSystem_setGPUSimulation(lua_State *L)
+{
+	ParticleSystem *t = luax_checkparticlesystem(L, 1);
+	bool enable = luax_checkboolean(L, 2);
+	luax_catchexcept(L, [&](){ t->setGPUSimulation(enable); });
+	return 0;
+}
+
+int w_ParticleSystem_isGPUSimulation(lua_State *L)
+{
+	ParticleSystem *t = luax_checkparticlesystem(L, 1);
+	luax_pushboolean(L, t->isGPUSimulation());
+	return 1;
+}
+
 int w_ParticleSystem_getCount(lua_State *L)
 {
 	ParticleSystem *t = luax_checkparticlesystem(L, 1);
@@ -755,6 +770,8 @@ static const luaL_Reg w_ParticleSystem_functions[] =
 	{ "getOffset", w_ParticleSystem_getOffset },
 	{ "setRelativeRotation", w_ParticleSystem_setRelativeRotation },
 	{ "hasRelativeRotation", w_ParticleSystem_hasRelativeRotation },
+	{ "setGPUSimulation", w_ParticleSystem_setGPUSimulation },
+	{ "isGPUSimulation", w_ParticleSystem_isGPUSimulation },
 	{ "getCount", w_ParticleSystem_getCount },
 	{ "start", w_ParticleSystem_start },
 	{ "stop", w_ParticleSystem_stop },
@@ -42,11 +42,23 @@ Shader *luax_checkshader(lua_State *L, int idx)
 int w_Shader_getWarnings(lua_State *L)
 {
 	Shader *shader = luax_checkshader(L, 1);
+	luax_catchexcept(L, [&]() { shader->waitUntilReady(); });
 	std::string warnings = shader->getWarnings();
 	lua_pushstring(L, warnings.c_str());
 	return 1;
 }
 
+// Shader:sendMany collects value uniforms here, so they can be updated at once.
+typedef std::vector<Shader::UniformUpdate> UniformUpdates;
+
+static void _updateUniform(lua_State *L, Shader *shader, const Shader::UniformInfo *info, int count, UniformUpdates *updates)
+{
+	if (updates != nullptr)
+		updates->push_back(std::make_pair(info, count));
+	else
+		luax_catchexcept(L, [&]() { shader->updateUniform(info, count); });
+}
+
 static int _getCount(lua_State *L, int startidx, const Shader::UniformInfo *info)
 {
 	return std::min(std::max(lua_gettop(L) - startidx + 1, 1), info->count);
@@ -77,7 +89,7 @@ static void _updateNumbers(lua_State *L, int startidx, T *values, int components
 	}
 }
 
-int w_Shader_sendFloats(lua_State *L, int startidx, Shader *shader, const Shader::UniformInfo *info, bool colors)
+int w_Shader_sendFloats(lua_State *L, int startidx, Shader *shader, const Shader::UniformInfo *info, bool colors, UniformUpdates *updates = nullptr)
 {
 	int count = _getCount(L, startidx, info);
 	int components = info->components;
@@ -92,35 +104,30 @@ int w_Shader_sendFloats(lua_State *L, int startidx, Shader *shader, const Shader
 	{
 		// alpha is always linear (when present).
 		int gammacomponents = std::min(components, 3);
-
-		for (int i = 0; i < count; i++)
-		{
-			for (int j = 0; j < gammacomponents; j++)
-				values[i * components + j] = math::gammaToLinear(values[i * components + j]);
-		}
+		math::gammaToLinear(values, count, components, gammacomponents);
 	}
 
-	luax_catchexcept(L, [&]() { shader->updateUniform(info, count); });
+	_updateUniform(L, shader, info, count, updates);
 	return 0;
 }
 
-int w_Shader_sendInts(lua_State *L, int startidx, Shader *shader, const Shader::UniformInfo *info)
+int w_Shader_sendInts(lua_State *L, int startidx, Shader *shader, const Shader::UniformInfo *info, UniformUpdates *updates)
 {
 	int count = _getCount(L, startidx, info);
 	_updateNumbers<int, lua_Integer, luaL_checkinteger>(L, startidx, info->ints, info->components, count);
-	luax_catchexcept(L, [&]() { shader->updateUniform(info, count); });
+	_updateUniform(L, shader, info, count, updates);
 	return 0;
 }
 
-int w_Shader_sendUnsignedInts(lua_State *L, int startidx, Shader *shader, const Shader::UniformInfo *info)
+int w_Shader_sendUnsignedInts(lua_State *L, int startidx, Shader *shader, const Shader::UniformInfo *info, UniformUpdates *updates)
 {
 	int count = _getCount(L, startidx, info);
 	_updateNumbers<unsigned int, lua_Integer, luaL_checkinteger>(L, startidx, info->uints, info->components, count);
-	luax_catchexcept(L, [&]() { shader->updateUniform(info, count); });
+	_updateUniform(L, shader, info, count, updates);
 	return 0;
 }
 
-int w_Shader_sendBooleans(lua_State *L, int startidx, Shader *shader, const Shader::UniformInfo *info)
+int w_Shader_sendBooleans(lua_State *L, int startidx, Shader *shader, const Shader::UniformInfo *info, UniformUpdates *updates)
 {
 	int count = _getCount(L, startidx, info);
 	int components = info->components;
@@ -153,11 +160,11 @@ int w_Shader_sendBooleans(lua_State *L, int startidx, Shader *shader, const Shad
 		}
 	}
 
-	luax_catchexcept(L, [&]() { shader->updateUniform(info, count); });
+	_updateUniform(L, shader, info, count, updates);
 	return 0;
 }
 
-int w_Shader_sendMatrices(lua_State *L, int startidx, Shader *shader, const Shader::UniformInfo *info)
+int w_Shader_sendMatrices(lua_State *L, int startidx, Shader *shader, const Shader::UniformInfo *info, UniformUpdates *updates)
 {
 	bool columnmajor = false;
 
@@ -264,7 +271,7 @@ int w_Shader_sendMatrices(lua_State *L, int startidx, Shader *shader, const Shad
 		}
 	}
 
-	shader->updateUniform(info, count);
+	_updateUniform(L, shader, info, count, updates);
 	return 0;
 }
 
@@ -302,20 +309,20 @@ int w_Shader_sendBuffers(lua_State *L, int startidx, Shader *shader, const Shade
 	return 0;
 }
 
-static int w_Shader_sendLuaValues(lua_State *L, int startidx, Shader *shader, const Shader::UniformInfo *info, const char *name)
+static int w_Shader_sendLuaValues(lua_State *L, int startidx, Shader *shader, const Shader::UniformInfo *info, const char *name, UniformUpdates *updates = nullptr)
 {
 	switch (info->baseType)
 	{
 	case Shader::UNIFORM_FLOAT:
-		return w_Shader_sendFloats(L, startidx, shader, info, false);
+		return w_Shader_sendFloats(L, startidx, shader, info, false, updates);
 	case Shader::UNIFORM_MATRIX:
-		return w_Shader_sendMatrices(L, startidx, shader, info);
+		return w_Shader_sendMatrices(L, startidx, shader, info, updates);
 	case Shader::UNIFORM_INT:
-		return w_Shader_sendInts(L, startidx, shader, info);
+		return w_Shader_sendInts(L, startidx, shader, info, updates);
 	case Shader::UNIFORM_UINT:
-		return w_Shader_sendUnsignedInts(L, startidx, shader, info);
+		return w_Shader_sendUnsignedInts(L, startidx, shader, info, updates);
 	case Shader::UNIFORM_BOOL:
-		return w_Shader_sendBooleans(L, startidx, shader, info);
+		return w_Shader_sendBooleans(L, startidx, shader, info, updates);
 	case Shader::UNIFORM_SAMPLER:
 	case Shader::UNIFORM_STORAGETEXTURE:
 		return w_Shader_sendTextures(L, startidx, shader, info);
@@ -327,7 +334,7 @@ static int w_Shader_sendLuaValues(lua_State *L, int startidx, Shader *shader, co
 	}
 }
 
-static int w_Shader_sendData(lua_State *L, int startidx, Shader *shader, const Shader::UniformInfo *info, bool colors)
+static int w_Shader_sendData(lua_State *L, int startidx, Shader *shader, const Shader::UniformInfo *info, bool colors, UniformUpdates *updates = nullptr)
 {
 	if (info->baseType == Shader::UNIFORM_SAMPLER || info->baseType == Shader::UNIFORM_STORAGETEXTURE
 		|| info->baseType == Shader::UNIFORM_TEXELBUFFER || info->baseType == Shader::UNIFORM_STORAGEBUFFER)
@@ -427,16 +434,10 @@ static int w_Shader_sendData(lua_State *L, int startidx, Shader *shader, const S
 		// alpha is always linear (when present).
 		int components = info->components;
 		int gammacomponents = std::min(components, 3);
-		float *values = info->floats;
-
-		for (int i = 0; i < count; i++)
-		{
-			for (int j = 0; j < gammacomponents; j++)
-				values[i * components + j] = math::gammaToLinear(values[i * components + j]);
-		}
+		math::gammaToLinear(info->floats, count, components, gammacomponents);
 	}
 
-	shader->updateUniform(info, count);
+	_updateUniform(L, shader, info, count, updates);
 	return 0;
 }
 
@@ -445,6 +446,8 @@ int w_Shader_send(lua_State *L)
 	Shader *shader = luax_checkshader(L, 1);
 	const char *name = luaL_checkstring(L, 2);
 
+	luax_catchexcept(L, [&]() { shader->waitUntilReady(); });
+
 	const Shader::UniformInfo *info = shader->getUniformInfo(name);
 	if (info == nullptr || !info->active)
 		return luaL_error(L, "Shader uniform '%s' does not exist.\nA common error is to define but not use the variable.", name);
@@ -455,11 +458,68 @@ int w_Shader_send(lua_State *L)
 		return w_Shader_sendLuaValues(L, 3, shader, info, name);
 }
 
+int w_Shader_sendMany(lua_State *L)
+{
+	Shader *shader = luax_checkshader(L, 1);
+	luaL_checktype(L, 2, LUA_TTABLE);
+
+	luax_catchexcept(L, [&]() { shader->waitUntilReady(); });
+
+	// Reused between calls to avoid allocating every time.
+	static UniformUpdates updates;
+	updates.clear();
+
+	lua_pushnil(L);
+	while (lua_next(L, 2))
+	{
+		if (lua_type(L, -2) != LUA_TSTRING)
+			return luaL_error(L, "Shader:sendMany expects a table with uniform names as keys.");
+
+		const char *name = lua_tostring(L, -2);
+		const Shader::UniformInfo *info = shader->getUniformInfo(name);
+		if (info == nullptr || !info->active)
+			return luaL_error(L, "Shader uniform '%s' does not exist.\nA common error is to define but not use the variable.", name);
+
+		int valueidx = lua_gettop(L);
+		int startidx = valueidx + 1;
+
+		// Array uniforms take a table with one value per element, other
+		// uniforms take the same value Shader:send would.
+		if (info->count > 1 && lua_istable(L, valueidx))
+		{
+			int count = std::min((int) luax_objlen(L, valueidx), info->count);
+			if (count == 0)
+				return luaL_error(L, "No values given for the Shader uniform array '%s'.", name);
+
+			luaL_checkstack(L, count, nullptr);
+			for (int i = 1; i <= count; i++)
+				lua_rawgeti(L, valueidx, i);
+		}
+		else
+			lua_pushvalue(L, valueidx);
+
+		if (luax_istype(L, startidx, Data::type))
+			w_Shader_sendData(L, startidx, shader, info, false, &updates);
+		else
+			w_Shader_sendLuaValues(L, startidx, shader, info, name, &updates);
+
+		// Keep the key for lua_next.
+		lua_settop(L, valueidx - 1);
+	}
+
+	if (!updates.empty())
+		luax_catchexcept(L, [&]() { shader->updateUniforms(updates.data(), (int) updates.size()); });
+
+	return 0;
+}
+
 int w_Shader_sendColors(lua_State *L)
 {
 	Shader *shader = luax_checkshader(L, 1);
 	const char *name = luaL_checkstring(L, 2);
 
+	luax_catchexcept(L, [&]() { shader->waitUntilReady(); });
+
 	const Shader::UniformInfo *info = shader->getUniformInfo(name);
 	if (info == nullptr || !info->active)
 		return luaL_error(L, "Shader uniform '%s' does not exist.\nA common error is to define but not use the variable.", name);
@@ -480,10 +540,20 @@ int w_Shader_hasUniform(lua_State *L)
 {
 	Shader *shader = luax_checkshader(L, 1);
 	const char *name = luaL_checkstring(L, 2);
+	luax_catchexcept(L, [&]() { shader->waitUntilReady(); });
 	luax_pushboolean(L, shader->hasUniform(name));
 	return 1;
 }
 
+int w_Shader_isReady(lua_State *L)
+{
+	Shader *shader = luax_checkshader(L, 1);
+	bool ready = false;
+	luax_catchexcept(L, [&]() { ready = shader->isReady(); });
+	luax_pushboolean(L, ready);
+	return 1;
+}
+
 int w_Shader_hasStage(lua_State* L)
 {
 	Shader *shader = luax_checkshader(L, 1);
@@ -549,6 +619,47 @@ int w_Shader_getBufferFormat(lua_State *L)
 	return luaL_error(L, "Buffer '%s' does not exist in the Shader.", name);
 }
 
+int w_Shader_setSpecializationConstant(lua_State *L)
+{
+	Shader *shader = luax_checkshader(L, 1);
+	const char *name = luaL_checkstring(L, 2);
+
+	double value = 0.0;
+	if (lua_isboolean(L, 3))
+		value = luax_toboolean(L, 3) ? 1.0 : 0.0;
+	else
+		value = luaL_checknumber(L, 3);
+
+	luax_catchexcept(L, [&]() {
+		shader->waitUntilReady();
+		shader->setSpecializationConstant(name, value);
+	});
+
+	return 0;
+}
+
+int w_Shader_getSpecializationConstant(lua_State *L)
+{
+	Shader *shader = luax_checkshader(L, 1);
+	const char *name = luaL_checkstring(L, 2);
+
+	luax_catchexcept(L, [&]() { shader->waitUntilReady(); });
+
+	double value = 0.0;
+	if (!shader->getSpecializationConstant(name, value))
+	{
+		lua_pushnil(L);
+		return 1;
+	}
+
+	if (shader->getSpecializationConstants().at(name).baseType == DATA_BASETYPE_BOOL)
+		luax_pushboolean(L, value != 0.0);
+	else
+		lua_pushnumber(L, value);
+
+	return 1;
+}
+
 int w_Shader_getDebugName(lua_State *L)
 {
 	Shader *shader = luax_checkshader(L, 1);
@@ -564,12 +675,16 @@ static const luaL_Reg w_Shader_functions[] =
 {
 	{ "getWarnings",             w_Shader_getWarnings },
 	{ "send",                    w_Shader_send },
+	{ "sendMany",                w_Shader_sendMany },
 	{ "sendColor",               w_Shader_sendColors },
 	{ "hasUniform",              w_Shader_hasUniform },
 	{ "hasStage",                w_Shader_hasStage },
+	{ "isReady",                 w_Shader_isReady },
 	{ "getLocalThreadgroupSize", w_Shader_getLocalThreadgroupSize },
 	{ "getBufferFormat",         w_Shader_getBufferFormat },
 	{ "getDebugName",            w_Shader_getDebugName },
+	{ "setSpecializationConstant", w_Shader_setSpecializationConstant },
+	{ "getSpecializationConstant", w_Shader_getSpecializationConstant },
 	{ 0, 0 }
 };
 
@@ -578,6 +693,132 @@ extern "C" int luaopen_shader(lua_State *L)
 	return luax_register_type(L, &Shader::type, w_Shader_functions, nullptr);
 }
 
+ShaderVariants *luax_checkshadervariants(lua_State *L, int idx)
+{
+	return luax_checktype<ShaderVariants>(L, idx);
+}
+
+uint32 luax_checkshadervariantmask(lua_State *L, int startidx, ShaderVariants *variants)
+{
+	if (lua_type(L, startidx) == LUA_TNUMBER)
+		return (uint32) lua_tonumber(L, startidx);
+
+	uint32 mask = 0;
+
+	if (lua_istable(L, startidx))
+	{
+		int count = (int) luax_objlen(L, startidx);
+		for (int i = 1; i <= count; i++)
+		{
+			lua_rawgeti(L, startidx, i);
+			const char *name = luaL_checkstring(L, -1);
+			luax_catchexcept(L, [&]() { mask |= variants->getFeatureBit(name); });
+			lua_pop(L, 1);
+		}
+		return mask;
+	}
+
+	int top = lua_gettop(L);
+	for (int i = startidx; i <= top; i++)
+	{
+		const char *name = luaL_checkstring(L, i);
+		luax_catchexcept(L, [&]() { mask |= variants->getFeatureBit(name); });
+	}
+
+	return mask;
+}
+
+int w_ShaderVariants_getShader(lua_State *L)
+{
+	ShaderVariants *variants = luax_checkshadervariants(L, 1);
+	uint32 mask = luax_checkshadervariantmask(L, 2, variants);
+	Shader *shader = nullptr;
+	luax_catchexcept(L, [&]() { shader = variants->getShader(mask); });
+	luax_pushtype(L, shader);
+	return 1;
+}
+
+int w_ShaderVariants_hasVariant(lua_State *L)
+{
+	ShaderVariants *variants = luax_checkshadervariants(L, 1);
+	uint32 mask = luax_checkshadervariantmask(L, 2, variants);
+	luax_pushboolean(L, variants->hasVariant(mask));
+	return 1;
+}
+
+int w_ShaderVariants_getFeatureMask(lua_State *L)
+{
+	ShaderVariants *variants = luax_checkshadervariants(L, 1);
+	uint32 mask = luax_checkshadervariantmask(L, 2, variants);
+	lua_pushnumber(L, (lua_Number) mask);
+	return 1;
+}
+
+int w_ShaderVariants_getFeatures(lua_State *L)
+{
+	ShaderVariants *variants = luax_checkshadervariants(L, 1);
+	const std::vector<std::string> &features = variants->getFeatures();
+
+	lua_createtable(L, (int) features.size(), 0);
+	for (int i = 0; i < (int) features.size(); i++)
+	{
+		luax_pushstring(L, features[i]);
+		lua_rawseti(L, -2, i + 1);
+	}
+
+	return 1;
+}
+
+int w_ShaderVariants_getVariantMasks(lua_State *L)
+{
+	ShaderVariants *variants = luax_checkshadervariants(L, 1);
+
+	std::vector<uint32> masks;
+	variants->getVariantMasks(masks);
+
+	lua_createtable(L, (int) masks.size(), 0);
+	for (int i = 0; i < (int) masks.size(); i++)
+	{
+		lua_pushnumber(L, (lua_Number) masks[i]);
+		lua_rawseti(L, -2, i + 1);
+	}
+
+	return 1;
+}
+
+int w_ShaderVariants_getVariantCount(lua_State *L)
+{
+	ShaderVariants *variants = luax_checkshadervariants(L, 1);
+	lua_pushinteger(L, variants->getVariantCount());
+	return 1;
+}
+
+int w_ShaderVariants_isReady(lua_State *L)
+{
+	ShaderVariants *variants = luax_checkshadervariants(L, 1);
+	bool ready = false;
+	luax_catchexcept(L, [&]() { ready = variants->isReady(); });
+	luax_pushboolean(L, ready);
+	return 1;
+}
+
+static const luaL_Reg w_ShaderVariants_functions[] =
+{
+	{ "getShader",       w_ShaderVariants_getShader },
+	{ "hasVariant",      w_ShaderVariants_hasVariant },
+	{ "getFeatureMask",  w_ShaderVariants_getFeatureMask },
+	{ "getFeatures",     w_ShaderVariants_getFeatures },
+	{ "getVariantMasks", w_ShaderVariants_getVariantMasks },
+	{ "getVariantCount", w_ShaderVariants_getVariantCount },
+	{ "isReady",         w_ShaderVariants_isReady },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_shadervariants(lua_State *L)
+{
+	return luax_register_type(L, &ShaderVariants::type, w_ShaderVariants_functions, nullptr);
+}
+
 } // graphics
 } // love
 
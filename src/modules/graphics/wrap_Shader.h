@@ -32,5 +32,13 @@ namespace graphics
 Shader *luax_checkshader(lua_State *L, int idx);
 extern "C" int luaopen_shader(lua_State *L);
 
+ShaderVariants *luax_checkshadervariants(lua_State *L, int idx);
+
+// Gets a feature mask from a number, or from feature names given either as
+// arguments starting at the index or as a table.
+uint32 luax_checkshadervariantmask(lua_State *L, int startidx, ShaderVariants *variants);
+
+extern "C" int luaopen_shadervariants(lua_State *L);
+
 } // graphics
 } // love
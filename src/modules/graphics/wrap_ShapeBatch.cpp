@@ -0,0 +1,330 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "wrap_ShapeBatch.h"
+
+namespace love
+{
+namespace graphics
+{
+
+ShapeBatch *luax_checkshapebatch(lua_State *L, int idx)
+{
+	return luax_checktype<ShapeBatch>(L, idx);
+}
+
+static Graphics::DrawMode checkDrawMode(lua_State *L, int idx)
+{
+	Graphics::DrawMode mode = Graphics::DRAW_FILL;
+	const char *str = luaL_checkstring(L, idx);
+	if (!Graphics::getConstant(str, mode))
+		luax_enumerror(L, "draw mode", Graphics::getConstants(mode), str);
+	return mode;
+}
+
+// Reads either a flat table of coordinates or a list of numbers starting at
+// the given index. Returns the number of vertices read.
+static int checkCoords(lua_State *L, int startidx, int minvertices, std::vector<Vector2> &coords)
+{
+	int args = lua_gettop(L) - startidx + 1;
+	bool is_table = false;
+
+	if (args == 1 && lua_istable(L, startidx))
+	{
+		args = (int) luax_objlen(L, startidx);
+		is_table = true;
+	}
+
+	if (args % 2 != 0)
+		return luaL_error(L, "Number of vertex components must be a multiple of two.");
+	else if (args < minvertices * 2)
+		return luaL_error(L, "Need at least %d vertices.", minvertices);
+
+	int numvertices = args / 2;
+	coords.resize(numvertices);
+
+	if (is_table)
+	{
+		for (int i = 0; i < numvertices; ++i)
+		{
+			lua_rawgeti(L, startidx, (i * 2) + 1);
+			lua_rawgeti(L, startidx, (i * 2) + 2);
+			coords[i].x = luax_checkfloat(L, -2);
+			coords[i].y = luax_checkfloat(L, -1);
+			lua_pop(L, 2);
+		}
+	}
+	else
+	{
+		for (int i = 0; i < numvertices; ++i)
+		{
+			coords[i].x = luax_checkfloat(L, startidx + (i * 2) + 0);
+			coords[i].y = luax_checkfloat(L, startidx + (i * 2) + 1);
+		}
+	}
+
+	return numvertices;
+}
+
+int w_ShapeBatch_rectangle(lua_State *L)
+{
+	ShapeBatch *s = luax_checkshapebatch(L, 1);
+	Graphics::DrawMode mode = checkDrawMode(L, 2);
+
+	float x = (float) luaL_checknumber(L, 3);
+	float y = (float) luaL_checknumber(L, 4);
+	float w = (float) luaL_checknumber(L, 5);
+	float h = (float) luaL_checknumber(L, 6);
+	float rx = (float) luaL_optnumber(L, 7, 0.0);
+	float ry = (float) luaL_optnumber(L, 8, rx);
+	int points = (int) luaL_optinteger(L, 9, 0);
+
+	s->rectangle(mode, x, y, w, h, rx, ry, points);
+	return 0;
+}
+
+int w_ShapeBatch_circle(lua_State *L)
+{
+	ShapeBatch *s = luax_checkshapebatch(L, 1);
+	Graphics::DrawMode mode = checkDrawMode(L, 2);
+
+	float x = (float) luaL_checknumber(L, 3);
+	float y = (float) luaL_checknumber(L, 4);
+	float radius = (float) luaL_checknumber(L, 5);
+	int points = (int) luaL_optinteger(L, 6, 0);
+
+	s->circle(mode, x, y, radius, points);
+	return 0;
+}
+
+int w_ShapeBatch_ellipse(lua_State *L)
+{
+	ShapeBatch *s = luax_checkshapebatch(L, 1);
+	Graphics::DrawMode mode = checkDrawMode(L, 2);
+
+	float x = (float) luaL_checknumber(L, 3);
+	float y = (float) luaL_checknumber(L, 4);
+	float a = (float) luaL_checknumber(L, 5);
+	float b = (float) luaL_optnumber(L, 6, a);
+	int points = (int) luaL_optinteger(L, 7, 0);
+
+	s->ellipse(mode, x, y, a, b, points);
+	return 0;
+}
+
+int w_ShapeBatch_arc(lua_State *L)
+{
+	ShapeBatch *s = luax_checkshapebatch(L, 1);
+	Graphics::DrawMode drawmode = checkDrawMode(L, 2);
+
+	int startidx = 3;
+
+	Graphics::ArcMode arcmode = Graphics::ARC_PIE;
+
+	if (lua_type(L, 3) == LUA_TSTRING)
+	{
+		const char *arcstr = luaL_checkstring(L, 3);
+		if (!Graphics::getConstant(arcstr, arcmode))
+			return luax_enumerror(L, "arc mode", Graphics::getConstants(arcmode), arcstr);
+
+		startidx = 4;
+	}
+
+	float x = (float) luaL_checknumber(L, startidx + 0);
+	float y = (float) luaL_checknumber(L, startidx + 1);
+	float radius = (float) luaL_checknumber(L, startidx + 2);
+	float angle1 = (float) luaL_checknumber(L, startidx + 3);
+	float angle2 = (float) luaL_checknumber(L, startidx + 4);
+	int points = (int) luaL_optinteger(L, startidx + 5, 0);
+
+	s->arc(drawmode, arcmode, x, y, radius, angle1, angle2, points);
+	return 0;
+}
+
+int w_ShapeBatch_polygon(lua_State *L)
+{
+	ShapeBatch *s = luax_checkshapebatch(L, 1);
+	Graphics::DrawMode mode = checkDrawMode(L, 2);
+
+	std::vector<Vector2> coords;
+	checkCoords(L, 3, 3, coords);
+
+	// make a closed loop
+	coords.push_back(coords[0]);
+
+	s->polygon(mode, coords.data(), coords.size());
+	return 0;
+}
+
+int w_ShapeBatch_line(lua_State *L)
+{
+	ShapeBatch *s = luax_checkshapebatch(L, 1);
+
+	std::vector<Vector2> coords;
+	checkCoords(L, 2, 2, coords);
+
+	s->line(coords.data(), coords.size());
+	return 0;
+}
+
+int w_ShapeBatch_clear(lua_State *L)
+{
+	ShapeBatch *s = luax_checkshapebatch(L, 1);
+	s->clear();
+	return 0;
+}
+
+int w_ShapeBatch_setColor(lua_State *L)
+{
+	ShapeBatch *s = luax_checkshapebatch(L, 1);
+
+	Colorf c;
+	if (lua_istable(L, 2))
+	{
+		for (int i = 1; i <= 4; i++)
+			lua_rawgeti(L, 2, i);
+
+		c.r = (float) luaL_checknumber(L, -4);
+		c.g = (float) luaL_checknumber(L, -3);
+		c.b = (float) luaL_checknumber(L, -2);
+		c.a = (float) luaL_optnumber(L, -1, 1.0);
+
+		lua_pop(L, 4);
+	}
+	else
+	{
+		c.r = (float) luaL_checknumber(L, 2);
+		c.g = (float) luaL_checknumber(L, 3);
+		c.b = (float) luaL_checknumber(L, 4);
+		c.a = (float) luaL_optnumber(L, 5, 1.0);
+	}
+
+	s->setColor(c);
+	return 0;
+}
+
+int w_ShapeBatch_getColor(lua_State *L)
+{
+	ShapeBatch *s = luax_checkshapebatch(L, 1);
+	const Colorf &c = s->getColor();
+	lua_pushnumber(L, c.r);
+	lua_pushnumber(L, c.g);
+	lua_pushnumber(L, c.b);
+	lua_pushnumber(L, c.a);
+	return 4;
+}
+
+int w_ShapeBatch_setLineWidth(lua_State *L)
+{
+	ShapeBatch *s = luax_checkshapebatch(L, 1);
+	s->setLineWidth((float) luaL_checknumber(L, 2));
+	return 0;
+}
+
+int w_ShapeBatch_getLineWidth(lua_State *L)
+{
+	ShapeBatch *s = luax_checkshapebatch(L, 1);
+	lua_pushnumber(L, s->getLineWidth());
+	return 1;
+}
+
+int w_ShapeBatch_setLineJoin(lua_State *L)
+{
+	ShapeBatch *s = luax_checkshapebatch(L, 1);
+
+	Graphics::LineJoin join;
+	const char *str = luaL_checkstring(L, 2);
+	if (!Graphics::getConstant(str, join))
+		return luax_enumerror(L, "line join", Graphics::getConstants(join), str);
+
+	s->setLineJoin(join);
+	return 0;
+}
+
+int w_ShapeBatch_getLineJoin(lua_State *L)
+{
+	ShapeBatch *s = luax_checkshapebatch(L, 1);
+	const char *str;
+	if (!Graphics::getConstant(s->getLineJoin(), str))
+		return luaL_error(L, "Unknown line join");
+	lua_pushstring(L, str);
+	return 1;
+}
+
+int w_ShapeBatch_setLineStyle(lua_State *L)
+{
+	ShapeBatch *s = luax_checkshapebatch(L, 1);
+
+	Graphics::LineStyle style;
+	const char *str = luaL_checkstring(L, 2);
+	if (!Graphics::getConstant(str, style))
+		return luax_enumerror(L, "line style", Graphics::getConstants(style), str);
+
+	s->setLineStyle(style);
+	return 0;
+}
+
+int w_ShapeBatch_getLineStyle(lua_State *L)
+{
+	ShapeBatch *s = luax_checkshapebatch(L, 1);
+	const char *str;
+	if (!Graphics::getConstant(s->getLineStyle(), str))
+		return luaL_error(L, "Unknown line style");
+	lua_pushstring(L, str);
+	return 1;
+}
+
+int w_ShapeBatch_getVertexCount(lua_State *L)
+{
+	ShapeBatch *s = luax_checkshapebatch(L, 1);
+	int count = 0;
+	luax_catchexcept(L, [&](){ count = s->getVertexCount(); });
+	lua_pushinteger(L, count);
+	return 1;
+}
+
+static const luaL_Reg w_ShapeBatch_functions[] =
+{
+	{ "rectangle", w_ShapeBatch_rectangle },
+	{ "circle", w_ShapeBatch_circle },
+	{ "ellipse", w_ShapeBatch_ellipse },
+	{ "arc", w_ShapeBatch_arc },
+	{ "polygon", w_ShapeBatch_polygon },
+	{ "line", w_ShapeBatch_line },
+	{ "clear", w_ShapeBatch_clear },
+	{ "setColor", w_ShapeBatch_setColor },
+	{ "getColor", w_ShapeBatch_getColor },
+	{ "setLineWidth", w_ShapeBatch_setLineWidth },
+	{ "getLineWidth", w_ShapeBatch_getLineWidth },
+	{ "setLineJoin", w_ShapeBatch_setLineJoin },
+	{ "getLineJoin", w_ShapeBatch_getLineJoin },
+	{ "setLineStyle", w_ShapeBatch_setLineStyle },
+	{ "getLineStyle", w_ShapeBatch_getLineStyle },
+	{ "getVertexCount", w_ShapeBatch_getVertexCount },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_shapebatch(lua_State *L)
+{
+	return luax_register_type(L, &ShapeBatch::type, w_ShapeBatch_functions, nullptr);
+}
+
+} // graphics
+} // love
@@ -23,11 +23,21 @@
 #include "Texture.h"
 #include "wrap_Texture.h"
 
+// Shove the wrap_SpriteBatch.lua code directly into a raw string literal.
+static const char spritebatch_lua[] =
+#include "wrap_SpriteBatch.lua"
+;
+
 namespace love
 {
 namespace graphics
 {
 
+/**
+ * NOTE: Additional wrapper code is in wrap_SpriteBatch.lua. Be sure to keep it
+ * in sync with any changes made to this file!
+ **/
+
 SpriteBatch *luax_checkspritebatch(lua_State *L, int idx)
 {
 	return luax_checktype<SpriteBatch>(L, idx);
@@ -260,6 +270,88 @@ int w_SpriteBatch_getDrawRange(lua_State *L)
 	return 2;
 }
 
+int w_SpriteBatch_setCullRect(lua_State *L)
+{
+	SpriteBatch *t = luax_checkspritebatch(L, 1);
+
+	if (lua_isnoneornil(L, 2))
+		t->setCullRect();
+	else
+	{
+		float x = (float) luaL_checknumber(L, 2);
+		float y = (float) luaL_checknumber(L, 3);
+		float w = (float) luaL_checknumber(L, 4);
+		float h = (float) luaL_checknumber(L, 5);
+		luax_catchexcept(L, [&](){ t->setCullRect(x, y, w, h); });
+	}
+
+	return 0;
+}
+
+int w_SpriteBatch_getCullRect(lua_State *L)
+{
+	SpriteBatch *t = luax_checkspritebatch(L, 1);
+
+	float x = 0.0f, y = 0.0f, w = 0.0f, h = 0.0f;
+	if (!t->getCullRect(x, y, w, h))
+		return 0;
+
+	lua_pushnumber(L, x);
+	lua_pushnumber(L, y);
+	lua_pushnumber(L, w);
+	lua_pushnumber(L, h);
+	return 4;
+}
+
+int w_SpriteBatch_setStatic(lua_State *L)
+{
+	SpriteBatch *t = luax_checkspritebatch(L, 1);
+	bool enable = luax_checkboolean(L, 2);
+	luax_catchexcept(L, [&](){ t->setStatic(enable); });
+	return 0;
+}
+
+int w_SpriteBatch_isStatic(lua_State *L)
+{
+	SpriteBatch *t = luax_checkspritebatch(L, 1);
+	luax_pushboolean(L, t->isStatic());
+	return 1;
+}
+
+int w_SpriteBatch_isInstanced(lua_State *L)
+{
+	SpriteBatch *t = luax_checkspritebatch(L, 1);
+	luax_pushboolean(L, t->isInstanced());
+	return 1;
+}
+
+// C functions in a struct, necessary for the FFI versions of SpriteBatch methods.
+struct FFI_SpriteBatch
+{
+	int (*add)(Proxy *p, const float *transform, int index);
+};
+
+static FFI_SpriteBatch ffifuncs =
+{
+	[](Proxy *p, const float *t, int index) -> int // add
+	{
+		auto batch = luax_ffi_checktype<SpriteBatch>(p);
+		if (batch == nullptr)
+			return -1;
+
+		// Exceptions can't cross the FFI boundary. The Lua code calls the
+		// regular method when this fails, which raises the error instead.
+		try
+		{
+			return batch->add(Matrix4(t[0], t[1], t[2], t[3], t[4], t[5], t[6], t[7], t[8]), index);
+		}
+		catch (std::exception &)
+		{
+			return -1;
+		}
+	},
+};
+
 static const luaL_Reg w_SpriteBatch_functions[] =
 {
 	{ "add", w_SpriteBatch_add },
@@ -277,12 +369,19 @@ static const luaL_Reg w_SpriteBatch_functions[] =
 	{ "attachAttribute", w_SpriteBatch_attachAttribute },
 	{ "setDrawRange", w_SpriteBatch_setDrawRange },
 	{ "getDrawRange", w_SpriteBatch_getDrawRange },
+	{ "setCullRect", w_SpriteBatch_setCullRect },
+	{ "getCullRect", w_SpriteBatch_getCullRect },
+	{ "setStatic", w_SpriteBatch_setStatic },
+	{ "isStatic", w_SpriteBatch_isStatic },
+	{ "isInstanced", w_SpriteBatch_isInstanced },
 	{ 0, 0 }
 };
 
 extern "C" int luaopen_spritebatch(lua_State *L)
 {
-	return luax_register_type(L, &SpriteBatch::type, w_SpriteBatch_functions, nullptr);
+	int ret = luax_register_type(L, &SpriteBatch::type, w_SpriteBatch_functions, nullptr);
+	luax_runwrapper(L, spritebatch_lua, sizeof(spritebatch_lua), "SpriteBatch.lua", SpriteBatch::type, &ffifuncs);
+	return ret;
 }
 
 } // graphics
@@ -0,0 +1,75 @@
+R"luastring"--(
+-- DO NOT REMOVE THE ABOVE LINE. It is used to load this file as a C++ string.
+-- There is a matching delimiter at the bottom of the file.
+
+--[[
+Copyright (c) 2006-2024 LOVE Development Team
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+claim that you wrote the original software. If you use this software
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+--]]
+
+
+local SpriteBatch_mt, ffifuncspointer_str, ffiwrapper = ...
+local SpriteBatch = SpriteBatch_mt.__index
+
+-- Everything below this point is efficient FFI replacements for existing
+-- SpriteBatch functionality.
+
+if ffiwrapper == nil or not ffiwrapper.isjitenabled() then return end
+
+local ffi = ffiwrapper.ffi
+local type = type
+local packstandardtransform = ffiwrapper.packstandardtransform
+
+-- Matches the struct declaration in wrap_SpriteBatch.cpp.
+local ffifuncs = ffiwrapper.getfuncs("FFI_SpriteBatch", [[
+typedef struct FFI_SpriteBatch
+{
+	int (*add)(Proxy *p, const float *transform, int index);
+} FFI_SpriteBatch;
+]], ffifuncspointer_str)
+
+local transform = ffi.new("float[9]")
+
+local _add = SpriteBatch.add
+local _set = SpriteBatch.set
+
+-- ffifuncs.add returns -1 for an invalid object or when SpriteBatch::add
+-- throws. The regular methods are used in that case, and for Quads and
+-- Transforms, so errors are reported the same way as before.
+
+function SpriteBatch:add(x, y, a, sx, sy, ox, oy, kx, ky)
+	if packstandardtransform(transform, x, y, a, sx, sy, ox, oy, kx, ky) then
+		local index = ffifuncs.add(self, transform, -1)
+		if index >= 0 then
+			return index + 1
+		end
+	end
+	return _add(self, x, y, a, sx, sy, ox, oy, kx, ky)
+end
+
+function SpriteBatch:set(index, x, y, a, sx, sy, ox, oy, kx, ky)
+	if type(index) == "number" and index >= 1
+		and packstandardtransform(transform, x, y, a, sx, sy, ox, oy, kx, ky)
+		and ffifuncs.add(self, transform, index - 1) >= 0 then
+		return
+	end
+	return _set(self, index, x, y, a, sx, sy, ox, oy, kx, ky)
+end
+
+-- DO NOT REMOVE THE NEXT LINE. It is used to load this file as a C++ string.
+--)luastring"--"
@@ -138,6 +138,73 @@ int w_TextBatch_addf(lua_State *L)
 	return 1;
 }
 
+static Matrix4 luax_checktextmatrix(lua_State *L, int idx)
+{
+	if (luax_istype(L, idx, math::Transform::type))
+		return luax_totype<math::Transform>(L, idx)->getMatrix();
+
+	float x  = (float) luaL_optnumber(L, idx + 0, 0.0);
+	float y  = (float) luaL_optnumber(L, idx + 1, 0.0);
+	float a  = (float) luaL_optnumber(L, idx + 2, 0.0);
+	float sx = (float) luaL_optnumber(L, idx + 3, 1.0);
+	float sy = (float) luaL_optnumber(L, idx + 4, sx);
+	float ox = (float) luaL_optnumber(L, idx + 5, 0.0);
+	float oy = (float) luaL_optnumber(L, idx + 6, 0.0);
+	float kx = (float) luaL_optnumber(L, idx + 7, 0.0);
+	float ky = (float) luaL_optnumber(L, idx + 8, 0.0);
+
+	return Matrix4(x, y, a, sx, sy, ox, oy, kx, ky);
+}
+
+int w_TextBatch_replace(lua_State *L)
+{
+	TextBatch *t = luax_checktextbatch(L, 1);
+	int index = (int) luaL_checkinteger(L, 2) - 1;
+
+	std::vector<love::font::ColoredString> text;
+	luax_checkcoloredstring(L, 3, text);
+
+	Matrix4 m = luax_checktextmatrix(L, 4);
+	luax_catchexcept(L, [&](){ t->replace(index, text, m); });
+	return 0;
+}
+
+int w_TextBatch_replacef(lua_State *L)
+{
+	TextBatch *t = luax_checktextbatch(L, 1);
+	int index = (int) luaL_checkinteger(L, 2) - 1;
+
+	std::vector<love::font::ColoredString> text;
+	luax_checkcoloredstring(L, 3, text);
+
+	float wrap = (float) luaL_checknumber(L, 4);
+
+	Font::AlignMode align = Font::ALIGN_MAX_ENUM;
+	const char *alignstr = luaL_checkstring(L, 5);
+
+	if (!Font::getConstant(alignstr, align))
+		return luax_enumerror(L, "align mode", Font::getConstants(align), alignstr);
+
+	Matrix4 m = luax_checktextmatrix(L, 6);
+	luax_catchexcept(L, [&](){ t->replacef(index, text, wrap, align, m); });
+	return 0;
+}
+
+int w_TextBatch_remove(lua_State *L)
+{
+	TextBatch *t = luax_checktextbatch(L, 1);
+	int index = (int) luaL_checkinteger(L, 2) - 1;
+	luax_catchexcept(L, [&](){ t->remove(index); });
+	return 0;
+}
+
+int w_TextBatch_getCount(lua_State *L)
+{
+	TextBatch *t = luax_checktextbatch(L, 1);
+	lua_pushinteger(L, t->getCount());
+	return 1;
+}
+
 int w_TextBatch_clear(lua_State *L)
 {
 	TextBatch *t = luax_checktextbatch(L, 1);
@@ -192,6 +259,10 @@ static const luaL_Reg w_TextBatch_functions[] =
 	{ "setf", w_TextBatch_setf },
 	{ "add", w_TextBatch_add },
 	{ "addf", w_TextBatch_addf },
+	{ "replace", w_TextBatch_replace },
+	{ "replacef", w_TextBatch_replacef },
+	{ "remove", w_TextBatch_remove },
+	{ "getCount", w_TextBatch_getCount },
 	{ "clear", w_TextBatch_clear },
 	{ "setFont", w_TextBatch_setFont },
 	{ "getFont", w_TextBatch_getFont },
@@ -300,6 +300,13 @@ int w_Texture_isReadable(lua_State *L)
 	return 1;
 }
 
+int w_Texture_isMemoryless(lua_State *L)
+{
+	Texture *t = luax_checktexture(L, 1);
+	luax_pushboolean(L, t->isMemoryless());
+	return 1;
+}
+
 int w_Texture_getViewFormats(lua_State *L)
 {
 	Texture *t = luax_checktexture(L, 1);
@@ -401,6 +408,43 @@ int w_Texture_replacePixels(lua_State *L)
 	return 0;
 }
 
+int w_Texture_replacePixelsAsync(lua_State *L)
+{
+	Texture *t = luax_checktexture(L, 1);
+	love::image::ImageData *id = luax_checktype<love::image::ImageData>(L, 2);
+
+	int slice = 0;
+	int mipmap = 0;
+	int x = 0;
+	int y = 0;
+	bool reloadmipmaps = t->getMipmapsMode() == Texture::MIPMAPS_AUTO;
+
+	if (t->getTextureType() != TEXTURE_2D)
+		slice = (int) luaL_checkinteger(L, 3) - 1;
+
+	mipmap = (int) luaL_optinteger(L, 4, 1) - 1;
+
+	if (!lua_isnoneornil(L, 5))
+	{
+		x = (int) luaL_checkinteger(L, 5);
+		y = (int) luaL_checkinteger(L, 6);
+
+		if (reloadmipmaps)
+			reloadmipmaps = luax_optboolean(L, 7, reloadmipmaps);
+	}
+
+	auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+	if (gfx == nullptr)
+		return luaL_error(L, "love.graphics must be initialized to use replacePixelsAsync.");
+
+	TextureUpload *upload = nullptr;
+	luax_catchexcept(L, [&](){ upload = gfx->replacePixelsAsync(t, id, slice, mipmap, x, y, reloadmipmaps); });
+
+	luax_pushtype(L, upload);
+	upload->release();
+	return 1;
+}
+
 int w_Texture_newImageData(lua_State *L)
 {
 	luax_markdeprecated(L, 1, "Texture:newImageData", API_METHOD, DEPRECATED_RENAMED, "love.graphics.readbackTexture");
@@ -529,12 +573,14 @@ const luaL_Reg w_Texture_functions[] =
 	{ "isCanvas", w_Texture_isCanvas },
 	{ "isComputeWritable", w_Texture_isComputeWritable },
 	{ "isReadable", w_Texture_isReadable },
+	{ "isMemoryless", w_Texture_isMemoryless },
 	{ "getViewFormats", w_Texture_getViewFormats },
 	{ "getMipmapMode", w_Texture_getMipmapMode },
 	{ "getDepthSampleMode", w_Texture_getDepthSampleMode },
 	{ "setDepthSampleMode", w_Texture_setDepthSampleMode },
 	{ "generateMipmaps", w_Texture_generateMipmaps },
 	{ "replacePixels", w_Texture_replacePixels },
+	{ "replacePixelsAsync", w_Texture_replacePixelsAsync },
 	{ "renderTo", w_Texture_renderTo },
 	{ "getDebugName", w_Texture_getDebugName },
 
@@ -549,5 +595,94 @@ extern "C" int luaopen_texture(lua_State *L)
 	return luax_register_type(L, &Texture::type, w_Texture_functions, nullptr);
 }
 
+static TextureUpload *luax_checktextureupload(lua_State *L, int idx)
+{
+	return luax_checktype<TextureUpload>(L, idx);
+}
+
+int w_TextureUpload_isComplete(lua_State *L)
+{
+	TextureUpload *upload = luax_checktextureupload(L, 1);
+	bool complete = false;
+	luax_catchexcept(L, [&]() { complete = upload->isComplete(); });
+	luax_pushboolean(L, complete);
+	return 1;
+}
+
+int w_TextureUpload_getTexture(lua_State *L)
+{
+	TextureUpload *upload = luax_checktextureupload(L, 1);
+	luax_pushtype(L, upload->getTexture());
+	return 1;
+}
+
+static const luaL_Reg w_TextureUpload_functions[] =
+{
+	{ "isComplete", w_TextureUpload_isComplete },
+	{ "getTexture", w_TextureUpload_getTexture },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_textureupload(lua_State *L)
+{
+	return luax_register_type(L, &TextureUpload::type, w_TextureUpload_functions, nullptr);
+}
+
+static StreamingTexture *luax_checkstreamingtexture(lua_State *L, int idx)
+{
+	return luax_checktype<StreamingTexture>(L, idx);
+}
+
+int w_StreamingTexture_getTexture(lua_State *L)
+{
+	StreamingTexture *t = luax_checkstreamingtexture(L, 1);
+	luax_pushtype(L, t->getTexture());
+	return 1;
+}
+
+int w_StreamingTexture_getMipmapCount(lua_State *L)
+{
+	StreamingTexture *t = luax_checkstreamingtexture(L, 1);
+	lua_pushinteger(L, t->getMipmapCount());
+	return 1;
+}
+
+int w_StreamingTexture_getResidentMipmap(lua_State *L)
+{
+	StreamingTexture *t = luax_checkstreamingtexture(L, 1);
+	lua_pushinteger(L, t->getResidentMipmap() + 1);
+	return 1;
+}
+
+int w_StreamingTexture_setResidentMipmap(lua_State *L)
+{
+	StreamingTexture *t = luax_checkstreamingtexture(L, 1);
+	int mipmap = (int) luaL_checkinteger(L, 2) - 1;
+	luax_catchexcept(L, [&]() { t->setResidentMipmap(mipmap); });
+	return 0;
+}
+
+int w_StreamingTexture_getResidentMemorySize(lua_State *L)
+{
+	StreamingTexture *t = luax_checkstreamingtexture(L, 1);
+	lua_pushnumber(L, (lua_Number) t->getResidentMemorySize(t->getResidentMipmap()));
+	return 1;
+}
+
+static const luaL_Reg w_StreamingTexture_functions[] =
+{
+	{ "getTexture", w_StreamingTexture_getTexture },
+	{ "getMipmapCount", w_StreamingTexture_getMipmapCount },
+	{ "getResidentMipmap", w_StreamingTexture_getResidentMipmap },
+	{ "setResidentMipmap", w_StreamingTexture_setResidentMipmap },
+	{ "getResidentMemorySize", w_StreamingTexture_getResidentMemorySize },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_streamingtexture(lua_State *L)
+{
+	return luax_register_type(L, &StreamingTexture::type, w_StreamingTexture_functions, nullptr);
+}
+
 } // graphics
 } // love
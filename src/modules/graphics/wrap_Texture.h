@@ -31,6 +31,8 @@ namespace graphics
 
 Texture *luax_checktexture(lua_State *L, int idx);
 extern "C" int luaopen_texture(lua_State *L);
+extern "C" int luaopen_textureupload(lua_State *L);
+extern "C" int luaopen_streamingtexture(lua_State *L);
 
 extern const luaL_Reg w_Texture_functions[];
 
@@ -0,0 +1,177 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+
+#include "wrap_VirtualTexture.h"
+#include "image/wrap_ImageData.h"
+
+namespace love
+{
+namespace graphics
+{
+
+VirtualTexture *luax_checkvirtualtexture(lua_State *L, int idx)
+{
+	return luax_checktype<VirtualTexture>(L, idx);
+}
+
+int w_VirtualTexture_getWidth(lua_State *L)
+{
+	VirtualTexture *t = luax_checkvirtualtexture(L, 1);
+	lua_pushinteger(L, t->getWidth());
+	return 1;
+}
+
+int w_VirtualTexture_getHeight(lua_State *L)
+{
+	VirtualTexture *t = luax_checkvirtualtexture(L, 1);
+	lua_pushinteger(L, t->getHeight());
+	return 1;
+}
+
+int w_VirtualTexture_getDimensions(lua_State *L)
+{
+	VirtualTexture *t = luax_checkvirtualtexture(L, 1);
+	lua_pushinteger(L, t->getWidth());
+	lua_pushinteger(L, t->getHeight());
+	return 2;
+}
+
+int w_VirtualTexture_getTileSize(lua_State *L)
+{
+	VirtualTexture *t = luax_checkvirtualtexture(L, 1);
+	lua_pushinteger(L, t->getTileSize());
+	return 1;
+}
+
+int w_VirtualTexture_getTileCount(lua_State *L)
+{
+	VirtualTexture *t = luax_checkvirtualtexture(L, 1);
+	lua_pushinteger(L, t->getTileCountX());
+	lua_pushinteger(L, t->getTileCountY());
+	return 2;
+}
+
+int w_VirtualTexture_getCacheSize(lua_State *L)
+{
+	VirtualTexture *t = luax_checkvirtualtexture(L, 1);
+	lua_pushinteger(L, t->getCacheSize());
+	return 1;
+}
+
+int w_VirtualTexture_getResidentTileCount(lua_State *L)
+{
+	VirtualTexture *t = luax_checkvirtualtexture(L, 1);
+	lua_pushinteger(L, t->getResidentTileCount());
+	return 1;
+}
+
+int w_VirtualTexture_getCacheTexture(lua_State *L)
+{
+	VirtualTexture *t = luax_checkvirtualtexture(L, 1);
+	luax_pushtype(L, t->getCacheTexture());
+	return 1;
+}
+
+int w_VirtualTexture_getIndirectionTexture(lua_State *L)
+{
+	VirtualTexture *t = luax_checkvirtualtexture(L, 1);
+	luax_pushtype(L, t->getIndirectionTexture());
+	return 1;
+}
+
+int w_VirtualTexture_requestRegion(lua_State *L)
+{
+	VirtualTexture *t = luax_checkvirtualtexture(L, 1);
+	int x = (int) luaL_checkinteger(L, 2);
+	int y = (int) luaL_checkinteger(L, 3);
+	int w = (int) luaL_checkinteger(L, 4);
+	int h = (int) luaL_checkinteger(L, 5);
+	t->requestRegion(x, y, w, h);
+	return 0;
+}
+
+int w_VirtualTexture_setTile(lua_State *L)
+{
+	VirtualTexture *t = luax_checkvirtualtexture(L, 1);
+	int tx = (int) luaL_checkinteger(L, 2);
+	int ty = (int) luaL_checkinteger(L, 3);
+	love::image::ImageData *data = love::image::luax_checkimagedata(L, 4);
+	luax_catchexcept(L, [&]() { t->setTile(tx, ty, data); });
+	return 0;
+}
+
+int w_VirtualTexture_isTileResident(lua_State *L)
+{
+	VirtualTexture *t = luax_checkvirtualtexture(L, 1);
+	int tx = (int) luaL_checkinteger(L, 2);
+	int ty = (int) luaL_checkinteger(L, 3);
+	luax_pushboolean(L, t->isTileResident(tx, ty));
+	return 1;
+}
+
+int w_VirtualTexture_getPendingTiles(lua_State *L)
+{
+	VirtualTexture *t = luax_checkvirtualtexture(L, 1);
+
+	std::vector<int> pending;
+	t->getPendingTiles(pending);
+
+	int count = (int) pending.size() / 2;
+	lua_createtable(L, count, 0);
+
+	for (int i = 0; i < count; i++)
+	{
+		lua_createtable(L, 2, 0);
+		lua_pushinteger(L, pending[i * 2 + 0]);
+		lua_rawseti(L, -2, 1);
+		lua_pushinteger(L, pending[i * 2 + 1]);
+		lua_rawseti(L, -2, 2);
+		lua_rawseti(L, -2, i + 1);
+	}
+
+	return 1;
+}
+
+static const luaL_Reg w_VirtualTexture_functions[] =
+{
+	{ "getWidth", w_VirtualTexture_getWidth },
+	{ "getHeight", w_VirtualTexture_getHeight },
+	{ "getDimensions", w_VirtualTexture_getDimensions },
+	{ "getTileSize", w_VirtualTexture_getTileSize },
+	{ "getTileCount", w_VirtualTexture_getTileCount },
+	{ "getCacheSize", w_VirtualTexture_getCacheSize },
+	{ "getResidentTileCount", w_VirtualTexture_getResidentTileCount },
+	{ "getCacheTexture", w_VirtualTexture_getCacheTexture },
+	{ "getIndirectionTexture", w_VirtualTexture_getIndirectionTexture },
+	{ "requestRegion", w_VirtualTexture_requestRegion },
+	{ "setTile", w_VirtualTexture_setTile },
+	{ "isTileResident", w_VirtualTexture_isTileResident },
+	{ "getPendingTiles", w_VirtualTexture_getPendingTiles },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_virtualtexture(lua_State *L)
+{
+	return luax_register_type(L, &VirtualTexture::type, w_VirtualTexture_functions, nullptr);
+}
+
+} // graphics
+} // love
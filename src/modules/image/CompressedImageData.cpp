@@ -21,6 +21,9 @@
 #include "CompressedImageData.h"
 #include "common/Exception.h"
 
+// C++
+#include <algorithm>
+
 namespace love
 {
 namespace image
@@ -30,6 +33,8 @@ love::Type CompressedImageData::type("CompressedImageData", &Data::type);
 
 CompressedImageData::CompressedImageData(const std::list<FormatHandler *> &formats, Data *filedata)
 	: format(PIXELFORMAT_UNKNOWN)
+	, dataOffset(0)
+	, dataSize(0)
 {
 	FormatHandler *parser = nullptr;
 
@@ -56,6 +61,21 @@ CompressedImageData::CompressedImageData(const std::list<FormatHandler *> &forma
 	if (dataImages.size() == 0 || memory->getSize() == 0)
 		throw love::Exception("Could not parse compressed data: No valid data?");
 
+	size_t begin = memory->getSize();
+	size_t end = 0;
+
+	for (const auto &slice : dataImages)
+	{
+		if (slice->getOffset() > memory->getSize() || slice->getSize() > memory->getSize() - slice->getOffset())
+			throw love::Exception("Could not parse compressed data: unexpected EOF.");
+
+		begin = std::min(begin, slice->getOffset());
+		end = std::max(end, slice->getOffset() + slice->getSize());
+	}
+
+	dataOffset = begin;
+	dataSize = end > begin ? end - begin : 0;
+
 	// This throws away some information the decoder could give us, but we
 	// can't really rely on it I think...
 	format = getLinearPixelFormat(format);
@@ -63,12 +83,17 @@ CompressedImageData::CompressedImageData(const std::list<FormatHandler *> &forma
 
 CompressedImageData::CompressedImageData(const CompressedImageData &c)
 	: format(c.format)
+	, dataOffset(0)
+	, dataSize(c.dataSize)
 {
-	memory.set(c.memory->clone(), Acquire::NORETAIN);
+	// Only the sub-images are copied, not the rest of the file they may be
+	// stored in.
+	memory.set(new ByteData(c.getData(), c.dataSize), Acquire::NORETAIN);
 
 	for (const auto &i : c.dataImages)
 	{
-		auto slice = new CompressedSlice(i->getFormat(), i->getWidth(), i->getHeight(), memory, i->getOffset(), i->getSize());
+		size_t offset = i->getOffset() - c.dataOffset;
+		auto slice = new CompressedSlice(i->getFormat(), i->getWidth(), i->getHeight(), memory, offset, i->getSize());
 		dataImages.push_back(slice);
 		slice->release();
 	}
@@ -85,12 +110,12 @@ CompressedImageData::~CompressedImageData()
 
 size_t CompressedImageData::getSize() const
 {
-	return memory->getSize();
+	return dataSize;
 }
 
 void *CompressedImageData::getData() const
 {
-	return memory->getData();
+	return (uint8 *) memory->getData() + dataOffset;
 }
 
 int CompressedImageData::getMipmapCount() const
@@ -41,6 +41,8 @@ namespace image
  * CompressedImageData represents image data which is designed to be uploaded to
  * the GPU and rendered in its compressed form, without being decompressed.
  * http://renderingpipeline.com/2012/07/texture-compression/
+ * When possible the sub-images reference the source Data in place (which may
+ * be a memory-mapped file), rather than a copy of it.
  **/
 class CompressedImageData : public Data
 {
@@ -102,8 +104,13 @@ protected:
 
 	PixelFormat format;
 
-	// Single block of memory containing all of the sub-images.
-	StrongRef<ByteData> memory;
+	// Single block of memory containing all of the sub-images. Can be the
+	// Data the image was parsed from.
+	StrongRef<Data> memory;
+
+	// Range of the memory used by the sub-images.
+	size_t dataOffset;
+	size_t dataSize;
 
 	// Texture info for each mipmap level.
 	std::vector<StrongRef<CompressedSlice>> dataImages;
@@ -23,6 +23,7 @@
 // LOVE
 #include "common/int.h"
 #include "common/pixelformat.h"
+#include "common/Data.h"
 #include "data/ByteData.h"
 #include "ImageDataBase.h"
 
@@ -34,12 +35,13 @@ namespace image
 using ByteData = love::data::ByteData;
 
 // Compressed image data can have multiple mipmap levels, each represented by a
-// sub-image.
+// sub-image. The memory can be the file the image was parsed from, in which
+// case the sub-image is referenced in place rather than copied.
 class CompressedSlice : public ImageDataBase
 {
 public:
 
-	CompressedSlice(PixelFormat format, int width, int height, ByteData *memory, size_t offset, size_t size);
+	CompressedSlice(PixelFormat format, int width, int height, Data *memory, size_t offset, size_t size);
 	CompressedSlice(const CompressedSlice &slice);
 	virtual ~CompressedSlice();
 
@@ -50,7 +52,7 @@ public:
 
 private:
 
-	StrongRef<ByteData> memory;
+	StrongRef<Data> memory;
 	size_t offset;
 	size_t dataSize;
 
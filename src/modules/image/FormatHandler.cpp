@@ -35,6 +35,11 @@ FormatHandler::~FormatHandler()
 {
 }
 
+bool FormatHandler::isThreadSafe() const
+{
+	return false;
+}
+
 bool FormatHandler::canDecode(Data* /*data*/)
 {
 	return false;
@@ -50,17 +55,42 @@ FormatHandler::DecodedImage FormatHandler::decode(Data* /*data*/)
 	throw love::Exception("Image decoding is not implemented for this format backend.");
 }
 
-FormatHandler::EncodedImage FormatHandler::encode(const DecodedImage& /*img*/, EncodedFormat /*format*/)
+bool FormatHandler::getDimensions(Data* /*data*/, int& /*width*/, int& /*height*/)
+{
+	return false;
+}
+
+bool FormatHandler::canDecodeRegion(Data* /*data*/)
+{
+	return false;
+}
+
+FormatHandler::DecodedImage FormatHandler::decodeRegion(Data* /*data*/, const DecodeRegion& /*region*/)
+{
+	throw love::Exception("Partial image decoding is not implemented for this format backend.");
+}
+
+FormatHandler::EncodedImage FormatHandler::encode(const DecodedImage& /*img*/, EncodedFormat /*format*/, int /*compressionLevel*/)
 {
 	throw love::Exception("Image encoding is not implemented for this format backend.");
 }
 
+bool FormatHandler::canEncodeCompressed(PixelFormat /*rawFormat*/, PixelFormat /*compressedFormat*/)
+{
+	return false;
+}
+
+FormatHandler::EncodedImage FormatHandler::encodeCompressed(const std::vector<DecodedImage>& /*mipmaps*/, PixelFormat /*compressedFormat*/)
+{
+	throw love::Exception("Compressed image encoding is not implemented for this format backend.");
+}
+
 bool FormatHandler::canParseCompressed(Data* /*data*/)
 {
 	return false;
 }
 
-StrongRef<ByteData> FormatHandler::parseCompressed(Data* /*filedata*/, std::vector<StrongRef<CompressedSlice>>& /*images*/, PixelFormat& /*format*/)
+StrongRef<Data> FormatHandler::parseCompressed(Data* /*filedata*/, std::vector<StrongRef<CompressedSlice>>& /*images*/, PixelFormat& /*format*/)
 {
 	throw love::Exception("Compressed image parsing is not implemented for this format backend.");
 }
@@ -46,6 +46,7 @@ public:
 		ENCODED_TGA,
 		ENCODED_PNG,
 		ENCODED_EXR,
+		ENCODED_QOI,
 		ENCODED_MAX_ENUM
 	};
 
@@ -59,6 +60,17 @@ public:
 		unsigned char *data = nullptr;
 	};
 
+	// A rectangle of an image to decode, which is then halved in size
+	// mipmapLevel times by averaging blocks of pixels.
+	struct DecodeRegion
+	{
+		int x = 0;
+		int y = 0;
+		int width = 0;
+		int height = 0;
+		int mipmapLevel = 0;
+	};
+
 	// Pixel data encoded in a particular format.
 	struct EncodedImage
 	{
@@ -72,6 +84,12 @@ public:
 	FormatHandler();
 	virtual ~FormatHandler();
 
+	/**
+	 * Whether decode and encode may be called from several threads at once.
+	 * ImageData only uses one thread at a time with handlers which aren't.
+	 **/
+	virtual bool isThreadSafe() const;
+
 	/**
 	 * Whether this format handler can decode the given Data into raw pixels.
 	 **/
@@ -87,10 +105,41 @@ public:
 	 **/
 	virtual DecodedImage decode(Data *data);
 
+	/**
+	 * Gets the size of an image without decoding it, if the format allows.
+	 **/
+	virtual bool getDimensions(Data *data, int &width, int &height);
+
+	/**
+	 * Whether this format handler can decode part of an image without holding
+	 * all of it in memory.
+	 **/
+	virtual bool canDecodeRegion(Data *data);
+
+	/**
+	 * Decodes part of an image, optionally at a reduced size. The region
+	 * must be inside the image.
+	 **/
+	virtual DecodedImage decodeRegion(Data *data, const DecodeRegion &region);
+
 	/**
 	 * Encodes an image from raw pixel data into a particular format.
+	 * @param compressionLevel From 0 (fastest) to 9 (smallest), or -1 for the
+	 *        format's default. Formats without settings ignore it.
+	 **/
+	virtual EncodedImage encode(const DecodedImage &img, EncodedFormat format, int compressionLevel);
+
+	/**
+	 * Whether this format handler can compress raw pixels into a file
+	 * containing the given compressed pixel format.
+	 **/
+	virtual bool canEncodeCompressed(PixelFormat rawFormat, PixelFormat compressedFormat);
+
+	/**
+	 * Compresses a chain of mipmap levels of raw pixel data, starting with the
+	 * base level, into a file containing the given compressed pixel format.
 	 **/
-	virtual EncodedImage encode(const DecodedImage &img, EncodedFormat format);
+	virtual EncodedImage encodeCompressed(const std::vector<DecodedImage> &mipmaps, PixelFormat compressedFormat);
 
 	/**
 	 * Whether this format handler can parse the given Data into a
@@ -107,9 +156,10 @@ public:
 	 *             pointer to the returned data.
 	 * @param[out] format The format of the Compressed Data.
 	 *
-	 * @return The single block of memory containing the parsed images.
+	 * @return The single block of memory containing the parsed images. This
+	 *         is filedata itself when the sub-images can be used in place.
 	 **/
-	virtual StrongRef<ByteData> parseCompressed(Data *filedata,
+	virtual StrongRef<Data> parseCompressed(Data *filedata,
 	        std::vector<StrongRef<CompressedSlice>> &images,
 	        PixelFormat &format);
 
@@ -20,11 +20,13 @@
 
 // LOVE
 #include "Image.h"
+#include "ImageDataEncode.h"
 #include "common/config.h"
 
 #include "magpie/PNGHandler.h"
 #include "magpie/STBHandler.h"
 #include "magpie/EXRHandler.h"
+#include "magpie/QOIHandler.h"
 
 #include "magpie/ddsHandler.h"
 #include "magpie/PVRHandler.h"
@@ -50,6 +52,7 @@ Image::Image()
 		new PNGHandler,
 		new STBHandler,
 		new EXRHandler,
+		new QOIHandler,
 		new DDSHandler,
 		new PVRHandler,
 		new KTXHandler,
@@ -60,6 +63,12 @@ Image::Image()
 
 Image::~Image()
 {
+	// Decodes and encodes still in progress need the format handlers and row
+	// workers.
+	ImageDataLoad::stopDecodeThreads();
+	ImageDataEncode::stopEncodeThreads();
+	ImageData::stopWorkerThreads();
+
 	// ImageData objects reference the FormatHandlers in our list, so we should
 	// release them instead of deleting them completely here.
 	for (FormatHandler *handler : formatHandlers)
@@ -71,6 +80,21 @@ love::image::ImageData *Image::newImageData(Data *data)
 	return new ImageData(data);
 }
 
+love::image::ImageData *Image::newImageData(Data *data, const FormatHandler::DecodeRegion &region)
+{
+	return new ImageData(data, region);
+}
+
+love::image::ImageDataLoad *Image::newImageDataAsync(Data *data)
+{
+	return new ImageDataLoad(data);
+}
+
+love::image::ImageDataLoad *Image::newImageDataAsync(Data *data, const FormatHandler::DecodeRegion &region)
+{
+	return new ImageDataLoad(data, region);
+}
+
 love::image::ImageData *Image::newImageData(int width, int height, PixelFormat format)
 {
 	return new ImageData(width, height, format);
@@ -86,6 +110,14 @@ love::image::CompressedImageData *Image::newCompressedData(Data *data)
 	return new CompressedImageData(formatHandlers, data);
 }
 
+love::image::CompressedImageData *Image::newCompressedData(ImageData *data, PixelFormat format, bool mipmaps)
+{
+	StrongRef<filesystem::FileData> filedata(data->encodeCompressed(format, mipmaps, "Image.dds"), Acquire::NORETAIN);
+	CompressedImageData *cdata = new CompressedImageData(formatHandlers, filedata);
+	cdata->setLinear(data->isLinear());
+	return cdata;
+}
+
 bool Image::isCompressed(Data *data)
 {
 	for (FormatHandler *handler : formatHandlers)
@@ -26,6 +26,7 @@
 #include "common/Module.h"
 #include "filesystem/File.h"
 #include "ImageData.h"
+#include "ImageDataLoad.h"
 #include "CompressedImageData.h"
 
 // C++
@@ -59,6 +60,22 @@ public:
 	 **/
 	ImageData *newImageData(Data *data);
 
+	/**
+	 * Decodes part of an image from FileData, optionally at a reduced size.
+	 * @param data The FileData containing the encoded image data.
+	 * @param region The part of the image to decode.
+	 * @return The new ImageData.
+	 **/
+	ImageData *newImageData(Data *data, const FormatHandler::DecodeRegion &region);
+
+	/**
+	 * Starts decoding FileData on a worker thread.
+	 * @param data The FileData containing the encoded image data.
+	 * @return An object which holds the new ImageData once it's decoded.
+	 **/
+	ImageDataLoad *newImageDataAsync(Data *data);
+	ImageDataLoad *newImageDataAsync(Data *data, const FormatHandler::DecodeRegion &region);
+
 	/**
 	 * Creates empty ImageData with the given size.
 	 * @param width The width of the ImageData.
@@ -85,6 +102,15 @@ public:
 	 **/
 	CompressedImageData *newCompressedData(Data *data);
 
+	/**
+	 * Creates new CompressedImageData by compressing ImageData.
+	 * @param data The RGBA8 ImageData to compress.
+	 * @param format The compressed pixel format to use (DXT1 or DXT5).
+	 * @param mipmaps Whether to generate and compress a full mipmap chain.
+	 * @return The new CompressedImageData.
+	 **/
+	CompressedImageData *newCompressedData(ImageData *data, PixelFormat format, bool mipmaps);
+
 	/**
 	 * Determines whether a FileData is Compressed image data or not.
 	 * @param data The FileData to test.
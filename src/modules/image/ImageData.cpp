@@ -21,8 +21,22 @@
 #include "ImageData.h"
 #include "Image.h"
 #include "filesystem/Filesystem.h"
+#include "math/MathModule.h"
+#include "common/memory.h"
 
 #include <algorithm> // min/max
+#include <cmath>
+#include <atomic>
+#include <thread>
+
+#if defined(LOVE_SIMD_SSE) && (defined(__SSE2__) || defined(_M_AMD64) || defined(_M_X64))
+#define LOVE_IMAGEDATA_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(LOVE_SIMD_NEON)
+#include <arm_neon.h>
+#endif
 
 using love::thread::Lock;
 
@@ -39,6 +53,12 @@ ImageData::ImageData(Data *data)
 	decode(data);
 }
 
+ImageData::ImageData(Data *data, const FormatHandler::DecodeRegion &region)
+	: ImageDataBase(PIXELFORMAT_UNKNOWN, 0, 0)
+{
+	decodeRegion(data, region);
+}
+
 ImageData::ImageData(int width, int height, PixelFormat format)
 	: ImageDataBase(format, width, height)
 {
@@ -58,25 +78,99 @@ ImageData::ImageData(int width, int height, PixelFormat format, void *data, bool
 		throw love::Exception("ImageData does not support the %s pixel format.", getPixelFormatName(format));
 
 	if (own)
+	{
 		this->data = (unsigned char *) data;
+		trackMemory(MEMORYTAG_IMAGEDATA, (int64) getSize());
+	}
 	else
 		create(width, height, format, data);
 }
 
+ImageData::SharedPixels::SharedPixels(unsigned char *data, size_t size, FormatHandler *handler)
+	: data(data)
+	, size(size)
+	, handler(handler)
+{
+}
+
+ImageData::SharedPixels::~SharedPixels()
+{
+	trackMemory(MEMORYTAG_IMAGEDATA, -(int64) size);
+
+	if (handler.get())
+		handler->freeRawPixels(data);
+	else
+		delete[] data;
+}
+
 ImageData::ImageData(const ImageData &c)
 	: ImageDataBase(c.format, c.width, c.height)
+	, pixelSetFunction(c.pixelSetFunction)
+	, pixelGetFunction(c.pixelGetFunction)
 {
-	create(width, height, format, c.getData());
+	// The original's sharing state is changed, so another thread mustn't
+	// clone or modify it at the same time.
+	Lock lock(const_cast<ImageData &>(c).getMutex());
+
+	if (c.dataExposed)
+	{
+		create(width, height, format, c.data);
+		return;
+	}
+
+	// Hand the original's pixels over to a SharedPixels the first time it's
+	// cloned, then share them.
+	if (c.sharedPixels.get() == nullptr)
+	{
+		c.sharedPixels.set(new SharedPixels(c.data, c.getSize(), c.decodeHandler), Acquire::NORETAIN);
+		c.decodeHandler.set(nullptr);
+	}
+
+	sharedPixels = c.sharedPixels;
+	data = c.data;
 }
 
 ImageData::~ImageData()
 {
+	if (sharedPixels.get())
+		return;
+
+	if (data != nullptr)
+		trackMemory(MEMORYTAG_IMAGEDATA, -(int64) getSize());
+
 	if (decodeHandler.get())
 		decodeHandler->freeRawPixels(data);
 	else
 		delete[] data;
 }
 
+void ImageData::makeUnique() const
+{
+	Lock lock(const_cast<ImageData *>(this)->getMutex());
+
+	// Once the clones are gone the pixels can be used in place.
+	if (sharedPixels.get() == nullptr || sharedPixels->getReferenceCount() == 1)
+		return;
+
+	size_t size = getSize();
+	unsigned char *copy = nullptr;
+
+	try
+	{
+		copy = new unsigned char[size];
+	}
+	catch (std::bad_alloc &)
+	{
+		throw love::Exception("Out of memory");
+	}
+
+	memcpy(copy, data, size);
+	trackMemory(MEMORYTAG_IMAGEDATA, (int64) size);
+
+	data = copy;
+	sharedPixels.set(nullptr);
+}
+
 love::image::ImageData *ImageData::clone() const
 {
 	return new ImageData(*this);
@@ -95,6 +189,8 @@ void ImageData::create(int width, int height, PixelFormat format, void *data)
 		throw love::Exception("Out of memory");
 	}
 
+	trackMemory(MEMORYTAG_IMAGEDATA, (int64) datasize);
+
 	if (data)
 		memcpy(this->data, data, datasize);
 
@@ -105,6 +201,16 @@ void ImageData::create(int width, int height, PixelFormat format, void *data)
 	pixelGetFunction = getPixelGetFunction(format);
 }
 
+// Format handlers which aren't thread-safe are only used by one thread at a
+// time.
+static void lockFormatHandler(love::thread::EmptyLock &lock, FormatHandler *handler)
+{
+	static love::thread::MutexRef mutex;
+
+	if (!handler->isThreadSafe())
+		lock.setLock(mutex);
+}
+
 void ImageData::decode(Data *data)
 {
 	FormatHandler *decoder = nullptr;
@@ -125,7 +231,11 @@ void ImageData::decode(Data *data)
 	}
 
 	if (decoder)
+	{
+		love::thread::EmptyLock lock;
+		lockFormatHandler(lock, decoder);
 		decodedimage = decoder->decode(data);
+	}
 
 	if (decodedimage.data == nullptr)
 	{
@@ -147,10 +257,18 @@ void ImageData::decode(Data *data)
 	}
 
 	// Clean up any old data.
-	if (decodeHandler)
-		decodeHandler->freeRawPixels(this->data);
+	if (sharedPixels.get())
+		sharedPixels.set(nullptr);
 	else
-		delete[] this->data;
+	{
+		if (this->data != nullptr)
+			trackMemory(MEMORYTAG_IMAGEDATA, -(int64) getSize());
+
+		if (decodeHandler)
+			decodeHandler->freeRawPixels(this->data);
+		else
+			delete[] this->data;
+	}
 
 	// This throws away some information the decoder could give us, but we
 	// can't really rely on it I think...
@@ -161,13 +279,244 @@ void ImageData::decode(Data *data)
 	this->data   = decodedimage.data;
 	this->format = decodedimage.format;
 
+	trackMemory(MEMORYTAG_IMAGEDATA, (int64) getSize());
+
 	decodeHandler = decoder;
 
 	pixelSetFunction = getPixelSetFunction(format);
 	pixelGetFunction = getPixelGetFunction(format);
 }
 
-love::filesystem::FileData *ImageData::encode(FormatHandler::EncodedFormat encodedFormat, const char *filename, bool writefile) const
+static FormatHandler *getDecoder(Data *data)
+{
+	auto module = Module::getInstance<Image>(Module::M_IMAGE);
+
+	if (module == nullptr)
+		throw love::Exception("love.image must be loaded in order to decode an ImageData.");
+
+	for (FormatHandler *handler : module->getFormatHandlers())
+	{
+		if (handler->canDecode(data))
+			return handler;
+	}
+
+	return nullptr;
+}
+
+void ImageData::getEncodedDimensions(Data *data, int &width, int &height)
+{
+	FormatHandler *decoder = getDecoder(data);
+
+	if (decoder != nullptr && decoder->getDimensions(data, width, height))
+		return;
+
+	StrongRef<ImageData> full(new ImageData(data), Acquire::NORETAIN);
+	width = full->getWidth();
+	height = full->getHeight();
+}
+
+void ImageData::decodeRegion(Data *data, FormatHandler::DecodeRegion region)
+{
+	FormatHandler *decoder = getDecoder(data);
+
+	int w = 0;
+	int h = 0;
+
+	bool partial = decoder != nullptr && decoder->canDecodeRegion(data)
+		&& decoder->getDimensions(data, w, h);
+
+	// Formats which can't decode part of an image are decoded in full, and
+	// the region is copied out of that.
+	StrongRef<ImageData> full;
+
+	if (!partial)
+	{
+		full.set(new ImageData(data), Acquire::NORETAIN);
+		w = full->getWidth();
+		h = full->getHeight();
+	}
+
+	if (region.width <= 0)
+		region.width = w - region.x;
+	if (region.height <= 0)
+		region.height = h - region.y;
+
+	if (region.x < 0 || region.y < 0 || region.width <= 0 || region.height <= 0
+		|| region.x + region.width > w || region.y + region.height > h)
+		throw love::Exception("Invalid image region (the image is %dx%d).", w, h);
+
+	if (region.mipmapLevel < 0 || region.mipmapLevel > 16)
+		throw love::Exception("Invalid mipmap level: %d", region.mipmapLevel);
+
+	if (partial)
+	{
+		FormatHandler::DecodedImage decodedimage;
+
+		{
+			love::thread::EmptyLock lock;
+			lockFormatHandler(lock, decoder);
+			decodedimage = decoder->decodeRegion(data, region);
+		}
+
+		if (decodedimage.size != getPixelFormatSliceSize(decodedimage.format, decodedimage.width, decodedimage.height))
+		{
+			decoder->freeRawPixels(decodedimage.data);
+			throw love::Exception("Could not convert image!");
+		}
+
+		this->width  = decodedimage.width;
+		this->height = decodedimage.height;
+		this->data   = decodedimage.data;
+		this->format = getLinearPixelFormat(decodedimage.format);
+
+		trackMemory(MEMORYTAG_IMAGEDATA, (int64) getSize());
+
+		decodeHandler = decoder;
+
+		pixelSetFunction = getPixelSetFunction(format);
+		pixelGetFunction = getPixelGetFunction(format);
+		return;
+	}
+
+	int level = region.mipmapLevel;
+	int blocksize = 1 << level;
+	int outw = (region.width + blocksize - 1) >> level;
+	int outh = (region.height + blocksize - 1) >> level;
+
+	this->width = outw;
+	this->height = outh;
+	create(outw, outh, full->getFormat());
+
+	PixelGetFunction getfunction = full->getPixelGetFunction();
+
+	if (level == 0 || getfunction == nullptr || pixelSetFunction == nullptr)
+	{
+		if (level > 0)
+			throw love::Exception("Reduced size decoding is not supported for the %s pixel format.", getPixelFormatName(format));
+
+		paste(full, 0, 0, region.x, region.y, region.width, region.height);
+		return;
+	}
+
+	// Average each block of source pixels.
+	for (int y = 0; y < outh; y++)
+	{
+		for (int x = 0; x < outw; x++)
+		{
+			int sx0 = region.x + x * blocksize;
+			int sy0 = region.y + y * blocksize;
+			int sx1 = std::min(sx0 + blocksize, region.x + region.width);
+			int sy1 = std::min(sy0 + blocksize, region.y + region.height);
+
+			Colorf sum(0.0f, 0.0f, 0.0f, 0.0f);
+			for (int sy = sy0; sy < sy1; sy++)
+			{
+				for (int sx = sx0; sx < sx1; sx++)
+					sum += full->getPixel(sx, sy);
+			}
+
+			sum /= (float) ((sx1 - sx0) * (sy1 - sy0));
+			setPixel(x, y, sum);
+		}
+	}
+}
+
+love::filesystem::FileData *ImageData::encodeCompressed(PixelFormat compressedFormat, bool mipmaps, const char *filename) const
+{
+	auto module = Module::getInstance<Image>(Module::M_IMAGE);
+
+	if (module == nullptr)
+		throw love::Exception("love.image must be loaded in order to encode an ImageData.");
+
+	FormatHandler *encoder = nullptr;
+	for (FormatHandler *handler : module->getFormatHandlers())
+	{
+		if (handler->canEncodeCompressed(format, compressedFormat))
+		{
+			encoder = handler;
+			break;
+		}
+	}
+
+	if (encoder == nullptr)
+		throw love::Exception("No suitable compressed image encoder for the %s pixel format.", getPixelFormatName(format));
+
+	// Box-filtered mipmap levels, each built from the previous one.
+	std::vector<std::vector<uint8>> levels;
+
+	std::vector<FormatHandler::DecodedImage> images(1);
+	images[0].format = format;
+	images[0].width = width;
+	images[0].height = height;
+	images[0].size = getSize();
+	images[0].data = data;
+
+	while (mipmaps && (images.back().width > 1 || images.back().height > 1))
+	{
+		const FormatHandler::DecodedImage &prev = images.back();
+		const uint8 *src = (const uint8 *) prev.data;
+
+		int w = std::max(prev.width / 2, 1);
+		int h = std::max(prev.height / 2, 1);
+
+		levels.emplace_back((size_t) w * h * 4);
+		uint8 *dst = levels.back().data();
+
+		for (int y = 0; y < h; y++)
+		{
+			int y0 = std::min(y * 2, prev.height - 1);
+			int y1 = std::min(y * 2 + 1, prev.height - 1);
+
+			for (int x = 0; x < w; x++)
+			{
+				int x0 = std::min(x * 2, prev.width - 1);
+				int x1 = std::min(x * 2 + 1, prev.width - 1);
+
+				for (int c = 0; c < 4; c++)
+				{
+					int sum = src[((size_t) y0 * prev.width + x0) * 4 + c] + src[((size_t) y0 * prev.width + x1) * 4 + c]
+						+ src[((size_t) y1 * prev.width + x0) * 4 + c] + src[((size_t) y1 * prev.width + x1) * 4 + c];
+					dst[((size_t) y * w + x) * 4 + c] = (uint8) ((sum + 2) / 4);
+				}
+			}
+		}
+
+		FormatHandler::DecodedImage img;
+		img.format = format;
+		img.width = w;
+		img.height = h;
+		img.size = levels.back().size();
+		img.data = dst;
+		images.push_back(img);
+	}
+
+	FormatHandler::EncodedImage encodedimage;
+
+	{
+		love::thread::EmptyLock lock;
+		lockFormatHandler(lock, encoder);
+		encodedimage = encoder->encodeCompressed(images, compressedFormat);
+	}
+
+	love::filesystem::FileData *filedata = nullptr;
+
+	try
+	{
+		filedata = new love::filesystem::FileData(encodedimage.size, filename);
+	}
+	catch (love::Exception &)
+	{
+		encoder->freeEncodedImage(encodedimage.data);
+		throw;
+	}
+
+	memcpy(filedata->getData(), encodedimage.data, encodedimage.size);
+	encoder->freeEncodedImage(encodedimage.data);
+
+	return filedata;
+}
+
+love::filesystem::FileData *ImageData::encode(FormatHandler::EncodedFormat encodedFormat, const char *filename, bool writefile, int compressionLevel) const
 {
 	FormatHandler *encoder = nullptr;
 	FormatHandler::EncodedImage encodedimage;
@@ -194,7 +543,11 @@ love::filesystem::FileData *ImageData::encode(FormatHandler::EncodedFormat encod
 	}
 
 	if (encoder != nullptr)
-		encodedimage = encoder->encode(rawimage, encodedFormat);
+	{
+		love::thread::EmptyLock lock;
+		lockFormatHandler(lock, encoder);
+		encodedimage = encoder->encode(rawimage, encodedFormat, compressionLevel);
+	}
 
 	if (encoder == nullptr || encodedimage.data == nullptr)
 		throw love::Exception("No suitable image encoder for the %s pixel format.", getPixelFormatName(format));
@@ -244,6 +597,14 @@ size_t ImageData::getSize() const
 }
 
 void *ImageData::getData() const
+{
+	Lock lock(const_cast<ImageData *>(this)->getMutex());
+	makeUnique();
+	dataExposed = true;
+	return data;
+}
+
+const void *ImageData::getReadOnlyData() const
 {
 	return data;
 }
@@ -528,12 +889,14 @@ void ImageData::setPixel(int x, int y, const Colorf &c)
 	if (!inside(x, y))
 		throw love::Exception("Attempt to set out-of-range pixel!");
 
-	size_t pixelsize = getPixelSize();
-	Pixel *p = (Pixel *) (data + ((y * width + x) * pixelsize));
-
 	if (pixelSetFunction == nullptr)
 		throw love::Exception("ImageData:setPixel does not currently support the %s pixel format.", getPixelFormatName(format));
 
+	makeUnique();
+
+	size_t pixelsize = getPixelSize();
+	Pixel *p = (Pixel *) (data + ((y * width + x) * pixelsize));
+
 	pixelSetFunction(c, p);
 }
 
@@ -572,15 +935,104 @@ static void pasteRGBA8toRGBA16(Row src, Row dst, int w)
 		dst.u16[i] = (uint16) src.u8[i] << 8u;
 }
 
+// Lookup tables for conversions with few enough possible inputs. They're
+// built on first use.
+
+static const float16 *getUnorm8ToFloat16Table()
+{
+	static float16 table[256];
+	static bool initialized = [](){
+		for (int i = 0; i < 256; i++)
+			table[i] = float32to16(i / 255.0f);
+		return true;
+	}();
+	(void) initialized;
+	return table;
+}
+
+static const uint8 *getFloat16ToUnorm8Table()
+{
+	static uint8 table[65536];
+	static bool initialized = [](){
+		for (int i = 0; i < 65536; i++)
+		{
+			float f = float16to32((float16) i);
+			// NaN becomes 0.
+			table[i] = f > 0.0f ? (uint8) (std::min(f, 1.0f) * 255.0f + 0.5f) : 0;
+		}
+		return true;
+	}();
+	(void) initialized;
+	return table;
+}
+
+static const uint8 *getGammaToLinearTable()
+{
+	static uint8 table[256];
+	static bool initialized = [](){
+		for (int i = 0; i < 256; i++)
+			table[i] = (uint8) (love::math::gammaToLinear(i / 255.0f) * 255.0f + 0.5f);
+		return true;
+	}();
+	(void) initialized;
+	return table;
+}
+
+static const uint8 *getLinearToGammaTable()
+{
+	static uint8 table[256];
+	static bool initialized = [](){
+		for (int i = 0; i < 256; i++)
+			table[i] = (uint8) (love::math::linearToGamma(i / 255.0f) * 255.0f + 0.5f);
+		return true;
+	}();
+	(void) initialized;
+	return table;
+}
+
 static void pasteRGBA8toRGBA16F(Row src, Row dst, int w)
 {
+	const float16 *table = getUnorm8ToFloat16Table();
 	for (int i = 0; i < w * 4; i++)
-		dst.f16[i] = float32to16(src.u8[i] / 255.0f);
+		dst.f16[i] = table[src.u8[i]];
 }
 
 static void pasteRGBA8toRGBA32F(Row src, Row dst, int w)
 {
-	for (int i = 0; i < w * 4; i++)
+	int i = 0;
+
+#if defined(LOVE_IMAGEDATA_SSE2)
+	const __m128i zero = _mm_setzero_si128();
+	const __m128 scale = _mm_set1_ps(1.0f / 255.0f);
+
+	for (; i + 16 <= w * 4; i += 16)
+	{
+		__m128i v = _mm_loadu_si128((const __m128i *) (src.u8 + i));
+		__m128i lo = _mm_unpacklo_epi8(v, zero);
+		__m128i hi = _mm_unpackhi_epi8(v, zero);
+
+		_mm_storeu_ps(dst.f32 + i + 0, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), scale));
+		_mm_storeu_ps(dst.f32 + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), scale));
+		_mm_storeu_ps(dst.f32 + i + 8, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), scale));
+		_mm_storeu_ps(dst.f32 + i + 12, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), scale));
+	}
+#elif defined(LOVE_SIMD_NEON)
+	const float32x4_t scale = vdupq_n_f32(1.0f / 255.0f);
+
+	for (; i + 16 <= w * 4; i += 16)
+	{
+		uint8x16_t v = vld1q_u8(src.u8 + i);
+		uint16x8_t lo = vmovl_u8(vget_low_u8(v));
+		uint16x8_t hi = vmovl_u8(vget_high_u8(v));
+
+		vst1q_f32(dst.f32 + i + 0, vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(lo))), scale));
+		vst1q_f32(dst.f32 + i + 4, vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(lo))), scale));
+		vst1q_f32(dst.f32 + i + 8, vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(hi))), scale));
+		vst1q_f32(dst.f32 + i + 12, vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(hi))), scale));
+	}
+#endif
+
+	for (; i < w * 4; i++)
 		dst.f32[i] = src.u8[i] / 255.0f;
 }
 
@@ -604,8 +1056,9 @@ static void pasteRGBA16toRGBA32F(Row src, Row dst, int w)
 
 static void pasteRGBA16FtoRGBA8(Row src, Row dst, int w)
 {
+	const uint8 *table = getFloat16ToUnorm8Table();
 	for (int i = 0; i < w * 4; i++)
-		dst.u8[i] = (uint8) (clamp01(float16to32(src.f16[i])) * 255.0f + 0.5f);
+		dst.u8[i] = table[src.f16[i]];
 }
 
 static void pasteRGBA16FtoRGBA16(Row src, Row dst, int w)
@@ -622,7 +1075,50 @@ static void pasteRGBA16FtoRGBA32F(Row src, Row dst, int w)
 
 static void pasteRGBA32FtoRGBA8(Row src, Row dst, int w)
 {
-	for (int i = 0; i < w * 4; i++)
+	int i = 0;
+
+#if defined(LOVE_IMAGEDATA_SSE2)
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 scale = _mm_set1_ps(255.0f);
+	const __m128 half = _mm_set1_ps(0.5f);
+
+	for (; i + 16 <= w * 4; i += 16)
+	{
+		__m128i v[4];
+		for (int j = 0; j < 4; j++)
+		{
+			// max(x, 0) is written with x second so NaN becomes 0.
+			__m128 f = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src.f32 + i + j * 4), zero), one);
+			v[j] = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(f, scale), half));
+		}
+
+		__m128i lo = _mm_packs_epi32(v[0], v[1]);
+		__m128i hi = _mm_packs_epi32(v[2], v[3]);
+		_mm_storeu_si128((__m128i *) (dst.u8 + i), _mm_packus_epi16(lo, hi));
+	}
+#elif defined(LOVE_SIMD_NEON)
+	const float32x4_t zero = vdupq_n_f32(0.0f);
+	const float32x4_t one = vdupq_n_f32(1.0f);
+	const float32x4_t scale = vdupq_n_f32(255.0f);
+	const float32x4_t half = vdupq_n_f32(0.5f);
+
+	for (; i + 16 <= w * 4; i += 16)
+	{
+		uint16x4_t v[4];
+		for (int j = 0; j < 4; j++)
+		{
+			float32x4_t f = vminq_f32(vmaxq_f32(vld1q_f32(src.f32 + i + j * 4), zero), one);
+			v[j] = vmovn_u32(vcvtq_u32_f32(vaddq_f32(vmulq_f32(f, scale), half)));
+		}
+
+		uint8x8_t lo = vmovn_u16(vcombine_u16(v[0], v[1]));
+		uint8x8_t hi = vmovn_u16(vcombine_u16(v[2], v[3]));
+		vst1q_u8(dst.u8 + i, vcombine_u8(lo, hi));
+	}
+#endif
+
+	for (; i < w * 4; i++)
 		dst.u8[i] = (uint8) (clamp01(src.f32[i]) * 255.0f + 0.5f);
 }
 
@@ -638,6 +1134,68 @@ static void pasteRGBA32FtoRGBA16F(Row src, Row dst, int w)
 		dst.f16[i] = float32to16(src.f32[i]);
 }
 
+static void pasteR8toRGBA8(Row src, Row dst, int w)
+{
+	for (int i = 0; i < w; i++)
+	{
+		dst.u8[i * 4 + 0] = src.u8[i];
+		dst.u8[i * 4 + 1] = 0;
+		dst.u8[i * 4 + 2] = 0;
+		dst.u8[i * 4 + 3] = 255;
+	}
+}
+
+static void pasteRG8toRGBA8(Row src, Row dst, int w)
+{
+	for (int i = 0; i < w; i++)
+	{
+		dst.u8[i * 4 + 0] = src.u8[i * 2 + 0];
+		dst.u8[i * 4 + 1] = src.u8[i * 2 + 1];
+		dst.u8[i * 4 + 2] = 0;
+		dst.u8[i * 4 + 3] = 255;
+	}
+}
+
+typedef void (*PasteFunction)(Row src, Row dst, int w);
+
+static PasteFunction getPasteFunction(PixelFormat srcformat, PixelFormat dstformat)
+{
+	if (srcformat == PIXELFORMAT_RGBA8_UNORM && dstformat == PIXELFORMAT_RGBA16_UNORM)
+		return pasteRGBA8toRGBA16;
+	else if (srcformat == PIXELFORMAT_RGBA8_UNORM && dstformat == PIXELFORMAT_RGBA16_FLOAT)
+		return pasteRGBA8toRGBA16F;
+	else if (srcformat == PIXELFORMAT_RGBA8_UNORM && dstformat == PIXELFORMAT_RGBA32_FLOAT)
+		return pasteRGBA8toRGBA32F;
+
+	else if (srcformat == PIXELFORMAT_RGBA16_UNORM && dstformat == PIXELFORMAT_RGBA8_UNORM)
+		return pasteRGBA16toRGBA8;
+	else if (srcformat == PIXELFORMAT_RGBA16_UNORM && dstformat == PIXELFORMAT_RGBA16_FLOAT)
+		return pasteRGBA16toRGBA16F;
+	else if (srcformat == PIXELFORMAT_RGBA16_UNORM && dstformat == PIXELFORMAT_RGBA32_FLOAT)
+		return pasteRGBA16toRGBA32F;
+
+	else if (srcformat == PIXELFORMAT_RGBA16_FLOAT && dstformat == PIXELFORMAT_RGBA8_UNORM)
+		return pasteRGBA16FtoRGBA8;
+	else if (srcformat == PIXELFORMAT_RGBA16_FLOAT && dstformat == PIXELFORMAT_RGBA16_UNORM)
+		return pasteRGBA16FtoRGBA16;
+	else if (srcformat == PIXELFORMAT_RGBA16_FLOAT && dstformat == PIXELFORMAT_RGBA32_FLOAT)
+		return pasteRGBA16FtoRGBA32F;
+
+	else if (srcformat == PIXELFORMAT_RGBA32_FLOAT && dstformat == PIXELFORMAT_RGBA8_UNORM)
+		return pasteRGBA32FtoRGBA8;
+	else if (srcformat == PIXELFORMAT_RGBA32_FLOAT && dstformat == PIXELFORMAT_RGBA16_UNORM)
+		return pasteRGBA32FtoRGBA16;
+	else if (srcformat == PIXELFORMAT_RGBA32_FLOAT && dstformat == PIXELFORMAT_RGBA16_FLOAT)
+		return pasteRGBA32FtoRGBA16F;
+
+	else if (srcformat == PIXELFORMAT_R8_UNORM && dstformat == PIXELFORMAT_RGBA8_UNORM)
+		return pasteR8toRGBA8;
+	else if (srcformat == PIXELFORMAT_RG8_UNORM && dstformat == PIXELFORMAT_RGBA8_UNORM)
+		return pasteRG8toRGBA8;
+
+	return nullptr;
+}
+
 void ImageData::paste(ImageData *src, int dx, int dy, int sx, int sy, int sw, int sh)
 {
 	PixelFormat dstformat = getFormat();
@@ -694,8 +1252,10 @@ void ImageData::paste(ImageData *src, int dx, int dy, int sx, int sy, int sw, in
 	if (sy + sh > srcH)
 		sh = srcH - sy;
 
-	uint8 *s = (uint8 *) src->getData();
-	uint8 *d = (uint8 *) getData();
+	makeUnique();
+
+	uint8 *s = src->data;
+	uint8 *d = data;
 
 	auto getfunction = src->pixelGetFunction;
 	auto setfunction = pixelSetFunction;
@@ -708,65 +1268,677 @@ void ImageData::paste(ImageData *src, int dx, int dy, int sx, int sy, int sw, in
 	else if (sw > 0)
 	{
 		// Otherwise, copy each row individually.
-		for (int i = 0; i < sh; i++)
+		PasteFunction pastefunction = srcformat != dstformat ? getPasteFunction(srcformat, dstformat) : nullptr;
+
+		if (srcformat != dstformat && pastefunction == nullptr)
 		{
-			Row rowsrc = {s + (sx + (i + sy) * srcW) * srcpixelsize};
-			Row rowdst = {d + (dx + (i + dy) * dstW) * dstpixelsize};
-
-			if (srcformat == dstformat)
-				memcpy(rowdst.u8, rowsrc.u8, srcpixelsize * sw);
-
-			else if (srcformat == PIXELFORMAT_RGBA8_UNORM && dstformat == PIXELFORMAT_RGBA16_UNORM)
-				pasteRGBA8toRGBA16(rowsrc, rowdst, sw);
-			else if (srcformat == PIXELFORMAT_RGBA8_UNORM && dstformat == PIXELFORMAT_RGBA16_FLOAT)
-				pasteRGBA8toRGBA16F(rowsrc, rowdst, sw);
-			else if (srcformat == PIXELFORMAT_RGBA8_UNORM && dstformat == PIXELFORMAT_RGBA32_FLOAT)
-				pasteRGBA8toRGBA32F(rowsrc, rowdst, sw);
-
-			else if (srcformat == PIXELFORMAT_RGBA16_UNORM && dstformat == PIXELFORMAT_RGBA8_UNORM)
-				pasteRGBA16toRGBA8(rowsrc, rowdst, sw);
-			else if (srcformat == PIXELFORMAT_RGBA16_UNORM && dstformat == PIXELFORMAT_RGBA16_FLOAT)
-				pasteRGBA16toRGBA16F(rowsrc, rowdst, sw);
-			else if (srcformat == PIXELFORMAT_RGBA16_UNORM && dstformat == PIXELFORMAT_RGBA32_FLOAT)
-				pasteRGBA16toRGBA32F(rowsrc, rowdst, sw);
-
-			else if (srcformat == PIXELFORMAT_RGBA16_FLOAT && dstformat == PIXELFORMAT_RGBA8_UNORM)
-				pasteRGBA16FtoRGBA8(rowsrc, rowdst, sw);
-			else if (srcformat == PIXELFORMAT_RGBA16_FLOAT && dstformat == PIXELFORMAT_RGBA16_UNORM)
-				pasteRGBA16FtoRGBA16(rowsrc, rowdst, sw);
-			else if (srcformat == PIXELFORMAT_RGBA16_FLOAT && dstformat == PIXELFORMAT_RGBA32_FLOAT)
-				pasteRGBA16FtoRGBA32F(rowsrc, rowdst, sw);
-
-			else if (srcformat == PIXELFORMAT_RGBA32_FLOAT && dstformat == PIXELFORMAT_RGBA8_UNORM)
-				pasteRGBA32FtoRGBA8(rowsrc, rowdst, sw);
-			else if (srcformat == PIXELFORMAT_RGBA32_FLOAT && dstformat == PIXELFORMAT_RGBA16_UNORM)
-				pasteRGBA32FtoRGBA16(rowsrc, rowdst, sw);
-			else if (srcformat == PIXELFORMAT_RGBA32_FLOAT && dstformat == PIXELFORMAT_RGBA16_FLOAT)
-				pasteRGBA32FtoRGBA16F(rowsrc, rowdst, sw);
-
-			else if (getfunction != nullptr && setfunction != nullptr)
-			{
-				// Slow path: convert src -> Colorf -> dst.
-				Colorf c;
-				for (int x = 0; x < sw; x++)
-				{
-					auto srcp = (const Pixel *) (rowsrc.u8 + x * srcpixelsize);
-					auto dstp = (Pixel *) (rowdst.u8 + x * dstpixelsize);
-					getfunction(srcp, c);
-					setfunction(c, dstp);
-				}
-			}
-			else if (getfunction == nullptr)
+			if (getfunction == nullptr)
 				throw love::Exception("ImageData:paste does not currently support converting from the %s pixel format.", getPixelFormatName(srcformat));
-			else
+			else if (setfunction == nullptr)
 				throw love::Exception("ImageData:paste does not currently support converting to the %s pixel format.", getPixelFormatName(dstformat));
 		}
-	}
-}
 
-size_t ImageData::getPixelSize() const
-{
-	return getPixelFormatBlockSize(format);
+		auto pasterows = [&](int rowy, int rowh)
+		{
+			for (int i = rowy; i < rowy + rowh; i++)
+			{
+				Row rowsrc = {s + (sx + (i + sy) * srcW) * srcpixelsize};
+				Row rowdst = {d + (dx + (i + dy) * dstW) * dstpixelsize};
+
+				if (srcformat == dstformat)
+					memcpy(rowdst.u8, rowsrc.u8, srcpixelsize * sw);
+				else if (pastefunction != nullptr)
+					pastefunction(rowsrc, rowdst, sw);
+				else
+				{
+					// Slow path: convert src -> Colorf -> dst.
+					Colorf c;
+					for (int x = 0; x < sw; x++)
+					{
+						auto srcp = (const Pixel *) (rowsrc.u8 + x * srcpixelsize);
+						auto dstp = (Pixel *) (rowdst.u8 + x * dstpixelsize);
+						getfunction(srcp, c);
+						setfunction(c, dstp);
+					}
+				}
+			}
+		};
+
+		// Plain copies are limited by memory bandwidth, conversions aren't.
+		if (srcformat == dstformat)
+			pasterows(0, sh);
+		else
+			parallelRows(0, sh, (size_t) sw * std::max(srcpixelsize, dstpixelsize), pasterows);
+	}
+}
+
+namespace
+{
+
+// Maximum number of worker threads used by ImageData::parallelRows.
+const unsigned int MAX_WORKER_THREADS = 16;
+
+// Below this many bytes the work is done entirely on the calling thread.
+const size_t MIN_PARALLEL_BYTES = 256 * 1024;
+
+class RowWorker;
+
+// State shared between ImageData::parallelRows and its worker threads.
+struct RowPool
+{
+	love::thread::MutexRef mutex;
+	love::thread::ConditionalRef workAvailable;
+	love::thread::ConditionalRef workFinished;
+
+	std::vector<RowWorker *> workers;
+
+	const std::function<void(int, int)> *func = nullptr;
+	int startRow = 0;
+	int endRow = 0;
+	int chunkRows = 1;
+	std::atomic<int> nextChunk {0};
+
+	// The first error thrown by func, if any.
+	std::string error;
+	std::atomic<bool> failed {false};
+
+	uint64 generation = 0;
+	size_t busyWorkers = 0;
+	bool stopping = false;
+
+	void processChunks()
+	{
+		while (!failed)
+		{
+			int y = startRow + (nextChunk++) * chunkRows;
+			if (y >= endRow)
+				break;
+
+			try
+			{
+				(*func)(y, std::min(chunkRows, endRow - y));
+			}
+			catch (std::exception &e)
+			{
+				love::thread::Lock lock(mutex);
+				if (!failed)
+					error = e.what();
+				failed = true;
+			}
+		}
+	}
+};
+
+class RowWorker : public love::thread::Threadable
+{
+public:
+
+	RowWorker(RowPool *pool)
+		: pool(pool)
+	{
+		threadName = "ImageDataWorker";
+	}
+
+	void threadFunction() override
+	{
+		uint64 generation = 0;
+
+		while (true)
+		{
+			{
+				love::thread::Lock lock(pool->mutex);
+
+				while (!pool->stopping && pool->generation == generation)
+					pool->workAvailable->wait(pool->mutex);
+
+				if (pool->stopping)
+					return;
+
+				generation = pool->generation;
+			}
+
+			pool->processChunks();
+
+			love::thread::Lock lock(pool->mutex);
+			if (--pool->busyWorkers == 0)
+				pool->workFinished->signal();
+		}
+	}
+
+private:
+
+	RowPool *pool;
+};
+
+RowPool *rowPool = nullptr;
+
+// parallelRows can be called from any thread, but the pool only runs one job
+// at a time.
+love::thread::MutexRef &getRowPoolMutex()
+{
+	static love::thread::MutexRef mutex;
+	return mutex;
+}
+
+inline uint8 clampUnorm8(int v)
+{
+	return (uint8) std::min(std::max(v, 0), 255);
+}
+
+void fillRGBA8(uint8 *row, int w, const uint8 c[4])
+{
+	uint32 packed;
+	memcpy(&packed, c, sizeof(uint32));
+
+	uint32 *p = (uint32 *) row;
+	for (int x = 0; x < w; x++)
+		p[x] = packed;
+}
+
+void multiplyRGBA8(uint8 *row, int w, const int factor[4])
+{
+	// factor is 8.8 fixed point so colors above 1 still brighten.
+	for (int i = 0; i < w * 4; i += 4)
+	{
+		for (int c = 0; c < 4; c++)
+			row[i + c] = clampUnorm8((row[i + c] * factor[c] + 128) >> 8);
+	}
+}
+
+void blendRGBA8(uint8 *row, int w, const uint8 color[4])
+{
+	int ca = color[3];
+	int ica = 255 - ca;
+
+	for (int i = 0; i < w * 4; i += 4)
+	{
+		for (int c = 0; c < 3; c++)
+			row[i + c] = (uint8) ((color[c] * ca + row[i + c] * ica + 127) / 255);
+		row[i + 3] = (uint8) (ca + (row[i + 3] * ica + 127) / 255);
+	}
+}
+
+void thresholdRGBA8(uint8 *row, int w, int threshold)
+{
+	for (int i = 0; i < w * 4; i += 4)
+	{
+		for (int c = 0; c < 3; c++)
+			row[i + c] = row[i + c] >= threshold ? 255 : 0;
+	}
+}
+
+void swizzleRGBA8(uint8 *row, int w, const ImageData::SwizzleComponent swizzle[4])
+{
+	uint8 src[6] = {0, 0, 0, 0, 0, 255};
+
+	for (int i = 0; i < w * 4; i += 4)
+	{
+		memcpy(src, row + i, 4);
+		for (int c = 0; c < 4; c++)
+			row[i + c] = src[swizzle[c]];
+	}
+}
+
+void premultiplyRGBA8(uint8 *row, int w)
+{
+	for (int i = 0; i < w * 4; i += 4)
+	{
+		int a = row[i + 3];
+		for (int c = 0; c < 3; c++)
+			row[i + c] = (uint8) ((row[i + c] * a + 127) / 255);
+	}
+}
+
+void unpremultiplyRGBA8(uint8 *row, int w)
+{
+	for (int i = 0; i < w * 4; i += 4)
+	{
+		int a = row[i + 3];
+		for (int c = 0; c < 3; c++)
+			row[i + c] = a == 0 ? 0 : clampUnorm8((row[i + c] * 255 + a / 2) / a);
+	}
+}
+
+void lookupRGBA8(uint8 *row, int w, const uint8 *table)
+{
+	for (int i = 0; i < w * 4; i += 4)
+	{
+		for (int c = 0; c < 3; c++)
+			row[i + c] = table[row[i + c]];
+	}
+}
+
+void applyOperationColorf(ImageData::PixelOperation op, const ImageData::PixelOperationParams &params, Colorf &p)
+{
+	const Colorf &c = params.color;
+
+	switch (op)
+	{
+	case ImageData::PIXELOP_FILL:
+		p = c;
+		break;
+	case ImageData::PIXELOP_MULTIPLY:
+		p *= c;
+		break;
+	case ImageData::PIXELOP_BLEND:
+		p.r = c.r * c.a + p.r * (1.0f - c.a);
+		p.g = c.g * c.a + p.g * (1.0f - c.a);
+		p.b = c.b * c.a + p.b * (1.0f - c.a);
+		p.a = c.a + p.a * (1.0f - c.a);
+		break;
+	case ImageData::PIXELOP_THRESHOLD:
+		p.r = p.r >= params.threshold ? 1.0f : 0.0f;
+		p.g = p.g >= params.threshold ? 1.0f : 0.0f;
+		p.b = p.b >= params.threshold ? 1.0f : 0.0f;
+		break;
+	case ImageData::PIXELOP_SWIZZLE:
+	{
+		float src[6] = {p.r, p.g, p.b, p.a, 0.0f, 1.0f};
+		p.r = src[params.swizzle[0]];
+		p.g = src[params.swizzle[1]];
+		p.b = src[params.swizzle[2]];
+		p.a = src[params.swizzle[3]];
+		break;
+	}
+	case ImageData::PIXELOP_PREMULTIPLY:
+		p.r *= p.a;
+		p.g *= p.a;
+		p.b *= p.a;
+		break;
+	case ImageData::PIXELOP_UNPREMULTIPLY:
+		if (p.a != 0.0f)
+		{
+			p.r /= p.a;
+			p.g /= p.a;
+			p.b /= p.a;
+		}
+		else
+			p.r = p.g = p.b = 0.0f;
+		break;
+	case ImageData::PIXELOP_GAMMATOLINEAR:
+		p.r = love::math::gammaToLinear(p.r);
+		p.g = love::math::gammaToLinear(p.g);
+		p.b = love::math::gammaToLinear(p.b);
+		break;
+	case ImageData::PIXELOP_LINEARTOGAMMA:
+		p.r = love::math::linearToGamma(p.r);
+		p.g = love::math::linearToGamma(p.g);
+		p.b = love::math::linearToGamma(p.b);
+		break;
+	default:
+		break;
+	}
+}
+
+} // anonymous namespace
+
+void ImageData::applyOperation(PixelOperation op, const PixelOperationParams &params, int x, int y, int w, int h)
+{
+	if (w <= 0 || h <= 0)
+		return;
+
+	if (!(inside(x, y) && inside(x + w - 1, y + h - 1)))
+		throw love::Exception("Invalid rectangle dimensions.");
+
+	for (int i = 0; i < 4; i++)
+	{
+		if (params.swizzle[i] < 0 || params.swizzle[i] >= SWIZZLE_MAX_ENUM)
+			throw love::Exception("Invalid swizzle component.");
+	}
+
+	if (pixelGetFunction == nullptr || pixelSetFunction == nullptr)
+		throw love::Exception("ImageData:applyOperation does not currently support the %s pixel format.", getPixelFormatName(format));
+
+	makeUnique();
+
+	size_t pixelsize = getPixelSize();
+	size_t stride = (size_t) width * pixelsize;
+	uint8 *base = data + (size_t) x * pixelsize;
+
+	std::function<void(int, int)> func;
+
+	if (format == PIXELFORMAT_RGBA8_UNORM)
+	{
+		const Colorf &c = params.color;
+
+		uint8 color[4];
+		int factor[4];
+		float comps[4] = {c.r, c.g, c.b, c.a};
+
+		for (int i = 0; i < 4; i++)
+		{
+			color[i] = (uint8) (std::min(std::max(comps[i], 0.0f), 1.0f) * 255.0f + 0.5f);
+			factor[i] = (int) (std::min(std::max(comps[i], 0.0f), 255.0f) * 256.0f + 0.5f);
+		}
+
+		int threshold = (int) std::ceil(params.threshold * 255.0f);
+		SwizzleComponent swizzle[4];
+		memcpy(swizzle, params.swizzle, sizeof(swizzle));
+
+		const uint8 *table = nullptr;
+		if (op == PIXELOP_GAMMATOLINEAR)
+			table = getGammaToLinearTable();
+		else if (op == PIXELOP_LINEARTOGAMMA)
+			table = getLinearToGammaTable();
+
+		func = [=](int rowy, int rowh)
+		{
+			for (int row = rowy; row < rowy + rowh; row++)
+			{
+				uint8 *p = base + row * stride;
+				switch (op)
+				{
+				case PIXELOP_FILL: fillRGBA8(p, w, color); break;
+				case PIXELOP_MULTIPLY: multiplyRGBA8(p, w, factor); break;
+				case PIXELOP_BLEND: blendRGBA8(p, w, color); break;
+				case PIXELOP_THRESHOLD: thresholdRGBA8(p, w, threshold); break;
+				case PIXELOP_SWIZZLE: swizzleRGBA8(p, w, swizzle); break;
+				case PIXELOP_PREMULTIPLY: premultiplyRGBA8(p, w); break;
+				case PIXELOP_UNPREMULTIPLY: unpremultiplyRGBA8(p, w); break;
+				case PIXELOP_GAMMATOLINEAR:
+				case PIXELOP_LINEARTOGAMMA: lookupRGBA8(p, w, table); break;
+				default: break;
+				}
+			}
+		};
+	}
+	else if (op == PIXELOP_FILL)
+	{
+		// Encode the color once and copy its bytes.
+		Pixel pixel;
+		pixelSetFunction(params.color, &pixel);
+
+		func = [=](int rowy, int rowh)
+		{
+			for (int row = rowy; row < rowy + rowh; row++)
+			{
+				uint8 *p = base + row * stride;
+				for (int i = 0; i < w; i++)
+					memcpy(p + i * pixelsize, &pixel, pixelsize);
+			}
+		};
+	}
+	else if (op == PIXELOP_GAMMATOLINEAR || op == PIXELOP_LINEARTOGAMMA)
+	{
+		PixelGetFunction getfunction = pixelGetFunction;
+		PixelSetFunction setfunction = pixelSetFunction;
+
+		// Convert whole rows at a time, with lookup tables instead of pow.
+		func = [=](int rowy, int rowh)
+		{
+			std::vector<Colorf> colors(w);
+			for (int row = rowy; row < rowy + rowh; row++)
+			{
+				uint8 *rowdata = base + row * stride;
+				for (int i = 0; i < w; i++)
+					getfunction((Pixel *) (rowdata + i * pixelsize), colors[i]);
+
+				if (op == PIXELOP_GAMMATOLINEAR)
+					love::math::gammaToLinear(&colors[0].r, w, 4, 3);
+				else
+					love::math::linearToGamma(&colors[0].r, w, 4, 3);
+
+				for (int i = 0; i < w; i++)
+					setfunction(colors[i], (Pixel *) (rowdata + i * pixelsize));
+			}
+		};
+	}
+	else
+	{
+		PixelGetFunction getfunction = pixelGetFunction;
+		PixelSetFunction setfunction = pixelSetFunction;
+		PixelOperationParams p = params;
+
+		func = [=](int rowy, int rowh)
+		{
+			Colorf c;
+			for (int row = rowy; row < rowy + rowh; row++)
+			{
+				uint8 *rowdata = base + row * stride;
+				for (int i = 0; i < w; i++)
+				{
+					auto pixel = (Pixel *) (rowdata + i * pixelsize);
+					getfunction(pixel, c);
+					applyOperationColorf(op, p, c);
+					setfunction(c, pixel);
+				}
+			}
+		};
+	}
+
+	parallelRows(y, h, (size_t) w * pixelsize, func);
+}
+
+void ImageData::blit(ImageData *src, int dx, int dy, int dw, int dh, int sx, int sy, int sw, int sh, BlitFilter filter)
+{
+	if (dw <= 0 || dh <= 0 || sw <= 0 || sh <= 0)
+		return;
+
+	if (!(src->inside(sx, sy) && src->inside(sx + sw - 1, sy + sh - 1)))
+		throw love::Exception("Invalid source rectangle dimensions.");
+
+	PixelGetFunction getfunction = src->pixelGetFunction;
+	PixelSetFunction setfunction = pixelSetFunction;
+
+	if (getfunction == nullptr)
+		throw love::Exception("ImageData:blit does not currently support converting from the %s pixel format.", getPixelFormatName(src->format));
+	if (setfunction == nullptr)
+		throw love::Exception("ImageData:blit does not currently support converting to the %s pixel format.", getPixelFormatName(format));
+
+	// Clip the destination rectangle, the scale stays the same.
+	int x0 = std::max(dx, 0);
+	int y0 = std::max(dy, 0);
+	int x1 = std::min(dx + dw, width);
+	int y1 = std::min(dy + dh, height);
+
+	if (x0 >= x1 || y0 >= y1)
+		return;
+
+	// Maps a destination pixel to its source texels and an 8 bit weight
+	// between them, sampling at pixel centers.
+	struct Sample
+	{
+		int i0;
+		int i1;
+		int weight;
+	};
+
+	auto makesamples = [&](int dstart, int dsize, int sstart, int ssize, int from, int to)
+	{
+		std::vector<Sample> samples(to - from);
+		float scale = (float) ssize / (float) dsize;
+
+		for (int i = from; i < to; i++)
+		{
+			float s = ((i - dstart) + 0.5f) * scale;
+			Sample &sample = samples[i - from];
+
+			if (filter == BLIT_NEAREST)
+			{
+				sample.i0 = sample.i1 = sstart + std::min((int) s, ssize - 1);
+				sample.weight = 0;
+			}
+			else
+			{
+				s = std::max(s - 0.5f, 0.0f);
+				int i0 = std::min((int) s, ssize - 1);
+				sample.i0 = sstart + i0;
+				sample.i1 = sstart + std::min(i0 + 1, ssize - 1);
+				sample.weight = (int) ((s - (float) i0) * 256.0f + 0.5f);
+			}
+		}
+
+		return samples;
+	};
+
+	std::vector<Sample> xsamples = makesamples(dx, dw, sx, sw, x0, x1);
+	std::vector<Sample> ysamples = makesamples(dy, dh, sy, sh, y0, y1);
+
+	makeUnique();
+
+	const uint8 *s = src->data;
+	uint8 *d = data;
+	int srcW = src->width;
+	size_t srcpixelsize = src->getPixelSize();
+	size_t dstpixelsize = getPixelSize();
+	bool rgba8 = src->format == PIXELFORMAT_RGBA8_UNORM && format == PIXELFORMAT_RGBA8_UNORM;
+
+	// The source can't also be the destination when rows are processed out of
+	// order.
+	std::vector<uint8> srccopy;
+	if (src == this)
+	{
+		srccopy.assign(s, s + getSize());
+		s = srccopy.data();
+	}
+
+	auto blitrows = [&](int rowy, int rowh)
+	{
+		for (int y = rowy; y < rowy + rowh; y++)
+		{
+			const Sample &ys = ysamples[y - y0];
+			const uint8 *row0 = s + (size_t) ys.i0 * srcW * srcpixelsize;
+			const uint8 *row1 = s + (size_t) ys.i1 * srcW * srcpixelsize;
+			uint8 *dstrow = d + ((size_t) y * width + x0) * dstpixelsize;
+
+			if (rgba8)
+			{
+				int wy = ys.weight;
+				for (int x = 0; x < x1 - x0; x++)
+				{
+					const Sample &xs = xsamples[x];
+					const uint8 *p00 = row0 + xs.i0 * 4;
+					const uint8 *p01 = row0 + xs.i1 * 4;
+					const uint8 *p10 = row1 + xs.i0 * 4;
+					const uint8 *p11 = row1 + xs.i1 * 4;
+					int wx = xs.weight;
+
+					for (int c = 0; c < 4; c++)
+					{
+						int top = p00[c] * (256 - wx) + p01[c] * wx;
+						int bottom = p10[c] * (256 - wx) + p11[c] * wx;
+						dstrow[x * 4 + c] = (uint8) ((top * (256 - wy) + bottom * wy + 32768) >> 16);
+					}
+				}
+			}
+			else
+			{
+				float wy = ys.weight / 256.0f;
+				Colorf c00, c01, c10, c11;
+
+				for (int x = 0; x < x1 - x0; x++)
+				{
+					const Sample &xs = xsamples[x];
+					float wx = xs.weight / 256.0f;
+
+					getfunction((const Pixel *) (row0 + xs.i0 * srcpixelsize), c00);
+					getfunction((const Pixel *) (row0 + xs.i1 * srcpixelsize), c01);
+					getfunction((const Pixel *) (row1 + xs.i0 * srcpixelsize), c10);
+					getfunction((const Pixel *) (row1 + xs.i1 * srcpixelsize), c11);
+
+					Colorf c;
+					c.r = (c00.r * (1.0f - wx) + c01.r * wx) * (1.0f - wy) + (c10.r * (1.0f - wx) + c11.r * wx) * wy;
+					c.g = (c00.g * (1.0f - wx) + c01.g * wx) * (1.0f - wy) + (c10.g * (1.0f - wx) + c11.g * wx) * wy;
+					c.b = (c00.b * (1.0f - wx) + c01.b * wx) * (1.0f - wy) + (c10.b * (1.0f - wx) + c11.b * wx) * wy;
+					c.a = (c00.a * (1.0f - wx) + c01.a * wx) * (1.0f - wy) + (c10.a * (1.0f - wx) + c11.a * wx) * wy;
+
+					setfunction(c, (Pixel *) (dstrow + x * dstpixelsize));
+				}
+			}
+		}
+	};
+
+	parallelRows(y0, y1 - y0, (size_t) (x1 - x0) * 4 * std::max(srcpixelsize, dstpixelsize), blitrows);
+}
+
+void ImageData::parallelRows(int y, int h, size_t rowsize, const std::function<void(int, int)> &func)
+{
+	if (h <= 0)
+		return;
+
+	unsigned int threads = std::thread::hardware_concurrency();
+
+	if (threads < 2 || h < 2 || (size_t) h * rowsize < MIN_PARALLEL_BYTES)
+	{
+		func(y, h);
+		return;
+	}
+
+	love::thread::Lock submitlock(getRowPoolMutex());
+
+	if (rowPool == nullptr)
+	{
+		rowPool = new RowPool();
+
+		unsigned int count = std::min(threads - 1, MAX_WORKER_THREADS);
+		for (unsigned int i = 0; i < count; i++)
+		{
+			RowWorker *worker = new RowWorker(rowPool);
+			if (worker->start())
+				rowPool->workers.push_back(worker);
+			else
+				worker->release();
+		}
+	}
+
+	RowPool *pool = rowPool;
+
+	// A few chunks per thread keeps the threads busy when rows take uneven
+	// amounts of time.
+	int chunks = (int) (pool->workers.size() + 1) * 4;
+
+	{
+		love::thread::Lock lock(pool->mutex);
+		pool->func = &func;
+		pool->startRow = y;
+		pool->endRow = y + h;
+		pool->chunkRows = std::max((h + chunks - 1) / chunks, 1);
+		pool->nextChunk = 0;
+		pool->error.clear();
+		pool->failed = false;
+		pool->busyWorkers = pool->workers.size();
+		pool->generation++;
+		pool->workAvailable->broadcast();
+	}
+
+	pool->processChunks();
+
+	love::thread::Lock lock(pool->mutex);
+	while (pool->busyWorkers > 0)
+		pool->workFinished->wait(pool->mutex);
+
+	pool->func = nullptr;
+
+	if (pool->failed)
+		throw love::Exception("%s", pool->error.c_str());
+}
+
+void ImageData::stopWorkerThreads()
+{
+	love::thread::Lock submitlock(getRowPoolMutex());
+
+	if (rowPool == nullptr)
+		return;
+
+	{
+		love::thread::Lock lock(rowPool->mutex);
+		rowPool->stopping = true;
+		rowPool->workAvailable->broadcast();
+	}
+
+	for (RowWorker *worker : rowPool->workers)
+	{
+		worker->wait();
+		worker->release();
+	}
+
+	delete rowPool;
+	rowPool = nullptr;
+}
+
+size_t ImageData::getPixelSize() const
+{
+	return getPixelFormatBlockSize(format);
 }
 
 bool ImageData::validPixelFormat(PixelFormat format)
@@ -839,14 +2011,68 @@ std::vector<std::string> ImageData::getConstants(FormatHandler::EncodedFormat)
 	return encodedFormats.getNames();
 }
 
+bool ImageData::getConstant(const char *in, PixelOperation &out)
+{
+	return pixelOperations.find(in, out);
+}
+
+bool ImageData::getConstant(PixelOperation in, const char *&out)
+{
+	return pixelOperations.find(in, out);
+}
+
+std::vector<std::string> ImageData::getConstants(PixelOperation)
+{
+	return pixelOperations.getNames();
+}
+
+bool ImageData::getConstant(const char *in, BlitFilter &out)
+{
+	return blitFilters.find(in, out);
+}
+
+bool ImageData::getConstant(BlitFilter in, const char *&out)
+{
+	return blitFilters.find(in, out);
+}
+
+std::vector<std::string> ImageData::getConstants(BlitFilter)
+{
+	return blitFilters.getNames();
+}
+
 StringMap<FormatHandler::EncodedFormat, FormatHandler::ENCODED_MAX_ENUM>::Entry ImageData::encodedFormatEntries[] =
 {
 	{"tga", FormatHandler::ENCODED_TGA},
 	{"png", FormatHandler::ENCODED_PNG},
 	{"exr", FormatHandler::ENCODED_EXR},
+	{"qoi", FormatHandler::ENCODED_QOI},
 };
 
 StringMap<FormatHandler::EncodedFormat, FormatHandler::ENCODED_MAX_ENUM> ImageData::encodedFormats(ImageData::encodedFormatEntries, sizeof(ImageData::encodedFormatEntries));
 
+StringMap<ImageData::PixelOperation, ImageData::PIXELOP_MAX_ENUM>::Entry ImageData::pixelOperationEntries[] =
+{
+	{"fill", PIXELOP_FILL},
+	{"multiply", PIXELOP_MULTIPLY},
+	{"blend", PIXELOP_BLEND},
+	{"threshold", PIXELOP_THRESHOLD},
+	{"swizzle", PIXELOP_SWIZZLE},
+	{"premultiply", PIXELOP_PREMULTIPLY},
+	{"unpremultiply", PIXELOP_UNPREMULTIPLY},
+	{"gammatolinear", PIXELOP_GAMMATOLINEAR},
+	{"lineartogamma", PIXELOP_LINEARTOGAMMA},
+};
+
+StringMap<ImageData::PixelOperation, ImageData::PIXELOP_MAX_ENUM> ImageData::pixelOperations(ImageData::pixelOperationEntries, sizeof(ImageData::pixelOperationEntries));
+
+StringMap<ImageData::BlitFilter, ImageData::BLIT_MAX_ENUM>::Entry ImageData::blitFilterEntries[] =
+{
+	{"nearest", BLIT_NEAREST},
+	{"linear", BLIT_LINEAR},
+};
+
+StringMap<ImageData::BlitFilter, ImageData::BLIT_MAX_ENUM> ImageData::blitFilters(ImageData::blitFilterEntries, sizeof(ImageData::blitFilterEntries));
+
 } // image
 } // love
@@ -32,6 +32,9 @@
 #include "ImageDataBase.h"
 #include "FormatHandler.h"
 
+// C++
+#include <functional>
+
 using love::thread::Mutex;
 
 namespace love
@@ -59,9 +62,57 @@ public:
 	typedef void (*PixelSetFunction)(const Colorf &c, Pixel *p);
 	typedef void (*PixelGetFunction)(const Pixel *p, Colorf &c);
 
+	// Built-in per-pixel operations, see applyOperation.
+	enum PixelOperation
+	{
+		PIXELOP_FILL,
+		PIXELOP_MULTIPLY,
+		PIXELOP_BLEND,
+		PIXELOP_THRESHOLD,
+		PIXELOP_SWIZZLE,
+		PIXELOP_PREMULTIPLY,
+		PIXELOP_UNPREMULTIPLY,
+		PIXELOP_GAMMATOLINEAR,
+		PIXELOP_LINEARTOGAMMA,
+		PIXELOP_MAX_ENUM
+	};
+
+	// Swizzle sources: the four color components, or a constant 0 or 1.
+	enum SwizzleComponent
+	{
+		SWIZZLE_R,
+		SWIZZLE_G,
+		SWIZZLE_B,
+		SWIZZLE_A,
+		SWIZZLE_ZERO,
+		SWIZZLE_ONE,
+		SWIZZLE_MAX_ENUM
+	};
+
+	enum BlitFilter
+	{
+		BLIT_NEAREST,
+		BLIT_LINEAR,
+		BLIT_MAX_ENUM
+	};
+
+	struct PixelOperationParams
+	{
+		Colorf color = Colorf(1.0f, 1.0f, 1.0f, 1.0f);
+		float threshold = 0.5f;
+		SwizzleComponent swizzle[4] = {SWIZZLE_R, SWIZZLE_G, SWIZZLE_B, SWIZZLE_A};
+	};
+
 	static love::Type type;
 
 	ImageData(Data *data);
+
+	/**
+	 * Decodes part of an encoded image, optionally at a reduced size. Width
+	 * and height in the region can be 0 to use the rest of the image. Formats
+	 * which support it are decoded without holding the whole image in memory.
+	 **/
+	ImageData(Data *data, const FormatHandler::DecodeRegion &region);
 	ImageData(int width, int height, PixelFormat format);
 	ImageData(int width, int height, PixelFormat format, void *data, bool own);
 	ImageData(const ImageData &c);
@@ -79,6 +130,26 @@ public:
 	 **/
 	void paste(ImageData *src, int dx, int dy, int sx, int sy, int sw, int sh);
 
+	/**
+	 * Applies a built-in operation to every pixel in the given rectangle. Large
+	 * rectangles are split into row chunks which are processed in parallel.
+	 * fill: Sets each pixel to params.color.
+	 * multiply: Multiplies each pixel by params.color, componentwise.
+	 * blend: Mixes params.color over each pixel using params.color.a.
+	 * threshold: Sets r, g and b to 1 if they're >= params.threshold, else 0.
+	 * swizzle: Rearranges the components of each pixel using params.swizzle.
+	 * premultiply, unpremultiply: Multiplies or divides r, g and b by alpha.
+	 * gammatolinear, lineartogamma: Converts r, g and b between sRGB and linear.
+	 **/
+	void applyOperation(PixelOperation op, const PixelOperationParams &params, int x, int y, int w, int h);
+
+	/**
+	 * Scales the (sx, sy, sw, sh) rectangle of src into the (dx, dy, dw, dh)
+	 * rectangle of this ImageData, converting between pixel formats if needed.
+	 * The destination rectangle is clipped to this ImageData's bounds.
+	 **/
+	void blit(ImageData *src, int dx, int dy, int dw, int dh, int sx, int sy, int sw, int sh, BlitFilter filter);
+
 	/**
 	 * Checks whether a position is inside this ImageData. Useful for checking bounds.
 	 * @param x The position along the x-axis.
@@ -107,12 +178,30 @@ public:
 	 * Encodes raw pixel data into a given format.
 	 * @param f The file to save the encoded image data to.
 	 * @param format The format of the encoded data.
+	 * @param compressionLevel 0-9, or -1 for the encoder's default.
+	 **/
+	love::filesystem::FileData *encode(FormatHandler::EncodedFormat format, const char *filename, bool writefile, int compressionLevel) const;
+
+	/**
+	 * Compresses the image into a GPU-compressed format (DXT1 or DXT5), with
+	 * an optional box-filtered mipmap chain. The returned file data can be
+	 * loaded with love.image.newCompressedData. Only RGBA8 is supported.
 	 **/
-	love::filesystem::FileData *encode(FormatHandler::EncodedFormat format, const char *filename, bool writefile) const;
+	love::filesystem::FileData *encodeCompressed(PixelFormat compressedFormat, bool mipmaps, const char *filename) const;
 
-	// Implements ImageDataBase.
+	/**
+	 * Clones share their pixels with the original until either is modified,
+	 * so cloning is cheap.
+	 **/
 	ImageData *clone() const override;
+
+	/**
+	 * Gets the pixels for writing. If they're shared with clones, this
+	 * ImageData gets its own copy first.
+	 **/
 	void *getData() const override;
+
+	const void *getReadOnlyData() const override;
 	size_t getSize() const override;
 
 	size_t getPixelSize() const;
@@ -122,13 +211,35 @@ public:
 
 	static bool validPixelFormat(PixelFormat format);
 
+	/**
+	 * Gets the size of an encoded image, decoding it only if its format
+	 * doesn't have a cheaper way.
+	 **/
+	static void getEncodedDimensions(Data *data, int &width, int &height);
+
 	static PixelSetFunction getPixelSetFunction(PixelFormat format);
 	static PixelGetFunction getPixelGetFunction(PixelFormat format);
 
+	/**
+	 * Calls func(y, h) for consecutive chunks of the rows [y, y+h), using worker
+	 * threads when there's enough data (h * rowsize bytes) to be worth it. The
+	 * calling thread processes chunks as well, and waits until all are done.
+	 **/
+	static void parallelRows(int y, int h, size_t rowsize, const std::function<void(int, int)> &func);
+	static void stopWorkerThreads();
+
 	static bool getConstant(const char *in, FormatHandler::EncodedFormat &out);
 	static bool getConstant(FormatHandler::EncodedFormat in, const char *&out);
 	static std::vector<std::string> getConstants(FormatHandler::EncodedFormat);
 
+	static bool getConstant(const char *in, PixelOperation &out);
+	static bool getConstant(PixelOperation in, const char *&out);
+	static std::vector<std::string> getConstants(PixelOperation);
+
+	static bool getConstant(const char *in, BlitFilter &out);
+	static bool getConstant(BlitFilter in, const char *&out);
+	static std::vector<std::string> getConstants(BlitFilter);
+
 private:
 
 	// Create imagedata. Initialize with data if not null.
@@ -136,13 +247,38 @@ private:
 
 	// Decode and load an encoded format.
 	void decode(Data *data);
+	void decodeRegion(Data *data, FormatHandler::DecodeRegion region);
+
+	// Pixels shared by an ImageData and its clones. Owns the memory, and
+	// frees it once none of them use it anymore.
+	class SharedPixels : public Object
+	{
+	public:
+
+		SharedPixels(unsigned char *data, size_t size, FormatHandler *handler);
+		virtual ~SharedPixels();
+
+		unsigned char *data;
+		size_t size;
+		StrongRef<FormatHandler> handler;
+	};
+
+	// Gives this ImageData its own copy of its pixels if they're shared with
+	// a clone, before they're modified.
+	void makeUnique() const;
+
+	// The actual data. Owned by sharedPixels when that's set.
+	mutable unsigned char *data = nullptr;
 
-	// The actual data.
-	unsigned char *data = nullptr;
+	mutable StrongRef<SharedPixels> sharedPixels;
+
+	// Set once getData has handed out a writable pointer, which can be
+	// written through at any time (e.g. by the FFI), so clones can't share it.
+	mutable bool dataExposed = false;
 
 	// The format handler that was used to decode the ImageData. We need to know
 	// this so we can properly delete memory allocated by the decoder.
-	StrongRef<FormatHandler> decodeHandler;
+	mutable StrongRef<FormatHandler> decodeHandler;
 
 	PixelSetFunction pixelSetFunction;
 	PixelGetFunction pixelGetFunction;
@@ -150,6 +286,12 @@ private:
 	static StringMap<FormatHandler::EncodedFormat, FormatHandler::ENCODED_MAX_ENUM>::Entry encodedFormatEntries[];
 	static StringMap<FormatHandler::EncodedFormat, FormatHandler::ENCODED_MAX_ENUM> encodedFormats;
 
+	static StringMap<PixelOperation, PIXELOP_MAX_ENUM>::Entry pixelOperationEntries[];
+	static StringMap<PixelOperation, PIXELOP_MAX_ENUM> pixelOperations;
+
+	static StringMap<BlitFilter, BLIT_MAX_ENUM>::Entry blitFilterEntries[];
+	static StringMap<BlitFilter, BLIT_MAX_ENUM> blitFilters;
+
 }; // ImageData
 
 } // image
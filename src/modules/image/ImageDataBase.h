@@ -37,6 +37,12 @@ public:
 
 	PixelFormat getFormat() const;
 
+	/**
+	 * Gets the pixels for reading only. Unlike getData, this never makes an
+	 * ImageData stop sharing its pixels with its clones.
+	 **/
+	virtual const void *getReadOnlyData() const { return getData(); }
+
 	int getWidth() const;
 	int getHeight() const;
 
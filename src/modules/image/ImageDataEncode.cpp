@@ -0,0 +1,246 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "ImageDataEncode.h"
+#include "common/Exception.h"
+
+// STL
+#include <algorithm>
+#include <deque>
+#include <thread>
+#include <cstdio>
+
+namespace love
+{
+namespace image
+{
+
+love::Type ImageDataEncode::type("ImageDataEncode", &Object::type);
+
+class EncodeWorker;
+
+namespace
+{
+
+// Encoders split large images across ImageData::parallelRows themselves, so
+// a second thread mostly keeps small encodes from waiting behind large ones.
+const unsigned int MAX_ENCODE_THREADS = 2;
+
+struct EncodePool
+{
+	love::thread::MutexRef mutex;
+	love::thread::ConditionalRef workAvailable;
+
+	std::vector<EncodeWorker *> workers;
+	std::deque<ImageDataEncode *> jobs;
+
+	bool stopping = false;
+};
+
+EncodePool *encodePool = nullptr;
+
+love::thread::Mutex *getEncodePoolMutex()
+{
+	static love::thread::MutexRef mutex;
+	return mutex;
+}
+
+} // anonymous namespace
+
+class EncodeWorker : public love::thread::Threadable
+{
+public:
+
+	EncodeWorker(EncodePool *pool)
+		: pool(pool)
+	{
+		threadName = "ImageEncoder";
+	}
+
+	void threadFunction() override
+	{
+		while (true)
+		{
+			ImageDataEncode *job = nullptr;
+
+			{
+				love::thread::Lock lock(pool->mutex);
+
+				while (!pool->stopping && pool->jobs.empty())
+					pool->workAvailable->wait(pool->mutex);
+
+				if (pool->stopping)
+					return;
+
+				job = pool->jobs.front();
+				pool->jobs.pop_front();
+			}
+
+			std::string error;
+
+			try
+			{
+				job->run();
+			}
+			catch (love::Exception &e)
+			{
+				error = e.what();
+			}
+
+			// Nothing else will see the error if the job was abandoned, for
+			// example by love.graphics.captureScreenshot.
+			if (!error.empty() && job->getReferenceCount() == 1)
+				printf("Image encoding or saving failed: %s\n", error.c_str());
+
+			job->finish(error);
+			job->release();
+		}
+	}
+
+private:
+
+	EncodePool *pool;
+};
+
+static EncodePool *getEncodePool()
+{
+	love::thread::Lock lock(getEncodePoolMutex());
+
+	if (encodePool == nullptr)
+	{
+		encodePool = new EncodePool();
+
+		unsigned int threads = std::max(std::thread::hardware_concurrency(), 1u);
+		unsigned int count = std::min(threads, MAX_ENCODE_THREADS);
+
+		for (unsigned int i = 0; i < count; i++)
+		{
+			EncodeWorker *worker = new EncodeWorker(encodePool);
+			if (worker->start())
+				encodePool->workers.push_back(worker);
+			else
+				worker->release();
+		}
+
+		if (encodePool->workers.empty())
+		{
+			delete encodePool;
+			encodePool = nullptr;
+			throw love::Exception("Could not start image encoding threads.");
+		}
+	}
+
+	return encodePool;
+}
+
+ImageDataEncode::ImageDataEncode(ImageData *imageData, FormatHandler::EncodedFormat format, const std::string &filename, bool writefile, int compressionLevel)
+	: imageData(imageData)
+	, format(format)
+	, filename(filename)
+	, writeFile(writefile)
+	, compressionLevel(compressionLevel)
+	, complete(false)
+{
+	EncodePool *pool = getEncodePool();
+	love::thread::Lock lock(pool->mutex);
+
+	retain();
+	pool->jobs.push_back(this);
+	pool->workAvailable->signal();
+}
+
+ImageDataEncode::~ImageDataEncode()
+{
+}
+
+void ImageDataEncode::run()
+{
+	StrongRef<love::filesystem::FileData> data(imageData->encode(format, filename.c_str(), writeFile, compressionLevel), Acquire::NORETAIN);
+
+	love::thread::Lock lock(mutex);
+	fileData = data;
+}
+
+void ImageDataEncode::finish(const std::string &encodeError)
+{
+	love::thread::Lock lock(mutex);
+
+	error = encodeError;
+	complete = true;
+
+	// The pixels aren't needed anymore.
+	imageData.set(nullptr);
+
+	finished->broadcast();
+}
+
+bool ImageDataEncode::isComplete() const
+{
+	love::thread::Lock lock(mutex);
+	return complete;
+}
+
+love::filesystem::FileData *ImageDataEncode::getFileData()
+{
+	love::thread::Lock lock(mutex);
+
+	while (!complete)
+		finished->wait(mutex);
+
+	if (!error.empty())
+		throw love::Exception("%s", error.c_str());
+
+	return fileData;
+}
+
+void ImageDataEncode::stopEncodeThreads()
+{
+	love::thread::Lock poolLock(getEncodePoolMutex());
+
+	if (encodePool == nullptr)
+		return;
+
+	std::deque<ImageDataEncode *> cancelled;
+
+	{
+		love::thread::Lock lock(encodePool->mutex);
+		encodePool->stopping = true;
+		encodePool->workAvailable->broadcast();
+		std::swap(cancelled, encodePool->jobs);
+	}
+
+	for (EncodeWorker *worker : encodePool->workers)
+	{
+		worker->wait();
+		worker->release();
+	}
+
+	for (ImageDataEncode *job : cancelled)
+	{
+		job->finish("The image module was destroyed before encoding finished.");
+		job->release();
+	}
+
+	delete encodePool;
+	encodePool = nullptr;
+}
+
+} // image
+} // love
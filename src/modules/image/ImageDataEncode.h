@@ -0,0 +1,91 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/Object.h"
+#include "thread/threads.h"
+#include "filesystem/FileData.h"
+#include "ImageData.h"
+
+// C++
+#include <string>
+
+namespace love
+{
+namespace image
+{
+
+/**
+ * Tracks an ImageData which is being encoded on the Image module's worker
+ * threads. The ImageData must not be modified until the encode is complete.
+ **/
+class ImageDataEncode : public love::Object
+{
+public:
+
+	static love::Type type;
+
+	/**
+	 * @param writefile Whether to also write the encoded file to filename,
+	 * using love.filesystem.
+	 **/
+	ImageDataEncode(ImageData *imageData, FormatHandler::EncodedFormat format, const std::string &filename, bool writefile, int compressionLevel);
+	virtual ~ImageDataEncode();
+
+	bool isComplete() const;
+
+	/**
+	 * Waits for encoding to finish, and throws if it failed.
+	 * @return The encoded file data.
+	 **/
+	love::filesystem::FileData *getFileData();
+
+	/**
+	 * Stops the worker threads, if they were started. Encodes which haven't
+	 * started yet fail.
+	 **/
+	static void stopEncodeThreads();
+
+private:
+
+	friend class EncodeWorker;
+
+	void run();
+	void finish(const std::string &encodeError);
+
+	StrongRef<ImageData> imageData;
+	FormatHandler::EncodedFormat format;
+	std::string filename;
+	bool writeFile;
+	int compressionLevel;
+
+	StrongRef<love::filesystem::FileData> fileData;
+	std::string error;
+	bool complete;
+
+	love::thread::MutexRef mutex;
+	love::thread::ConditionalRef finished;
+
+}; // ImageDataEncode
+
+} // image
+} // love
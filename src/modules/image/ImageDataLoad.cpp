@@ -0,0 +1,253 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "ImageDataLoad.h"
+#include "common/Exception.h"
+
+// STL
+#include <algorithm>
+#include <deque>
+#include <thread>
+
+namespace love
+{
+namespace image
+{
+
+love::Type ImageDataLoad::type("ImageDataLoad", &Object::type);
+
+class DecodeWorker;
+
+namespace
+{
+
+// Decodes are mostly independent of each other, but a few threads are left
+// free for ImageData::parallelRows and the rest of the game.
+const unsigned int MAX_DECODE_THREADS = 4;
+
+struct DecodePool
+{
+	love::thread::MutexRef mutex;
+	love::thread::ConditionalRef workAvailable;
+
+	std::vector<DecodeWorker *> workers;
+	std::deque<ImageDataLoad *> jobs;
+
+	bool stopping = false;
+};
+
+DecodePool *decodePool = nullptr;
+
+love::thread::Mutex *getDecodePoolMutex()
+{
+	static love::thread::MutexRef mutex;
+	return mutex;
+}
+
+} // anonymous namespace
+
+class DecodeWorker : public love::thread::Threadable
+{
+public:
+
+	DecodeWorker(DecodePool *pool)
+		: pool(pool)
+	{
+		threadName = "ImageDecoder";
+	}
+
+	void threadFunction() override
+	{
+		while (true)
+		{
+			ImageDataLoad *job = nullptr;
+
+			{
+				love::thread::Lock lock(pool->mutex);
+
+				while (!pool->stopping && pool->jobs.empty())
+					pool->workAvailable->wait(pool->mutex);
+
+				if (pool->stopping)
+					return;
+
+				job = pool->jobs.front();
+				pool->jobs.pop_front();
+			}
+
+			std::string error;
+
+			try
+			{
+				job->run();
+			}
+			catch (love::Exception &e)
+			{
+				error = e.what();
+			}
+
+			job->finish(error);
+			job->release();
+		}
+	}
+
+private:
+
+	DecodePool *pool;
+};
+
+static DecodePool *getDecodePool()
+{
+	love::thread::Lock lock(getDecodePoolMutex());
+
+	if (decodePool == nullptr)
+	{
+		decodePool = new DecodePool();
+
+		unsigned int threads = std::max(std::thread::hardware_concurrency(), 2u);
+		unsigned int count = std::min(threads - 1, MAX_DECODE_THREADS);
+
+		for (unsigned int i = 0; i < count; i++)
+		{
+			DecodeWorker *worker = new DecodeWorker(decodePool);
+			if (worker->start())
+				decodePool->workers.push_back(worker);
+			else
+				worker->release();
+		}
+
+		if (decodePool->workers.empty())
+		{
+			delete decodePool;
+			decodePool = nullptr;
+			throw love::Exception("Could not start image decoding threads.");
+		}
+	}
+
+	return decodePool;
+}
+
+ImageDataLoad::ImageDataLoad(Data *data)
+	: data(data)
+	, hasRegion(false)
+	, complete(false)
+{
+	start();
+}
+
+ImageDataLoad::ImageDataLoad(Data *data, const FormatHandler::DecodeRegion &region)
+	: data(data)
+	, region(region)
+	, hasRegion(true)
+	, complete(false)
+{
+	start();
+}
+
+ImageDataLoad::~ImageDataLoad()
+{
+}
+
+void ImageDataLoad::start()
+{
+	DecodePool *pool = getDecodePool();
+	love::thread::Lock lock(pool->mutex);
+
+	retain();
+	pool->jobs.push_back(this);
+	pool->workAvailable->signal();
+}
+
+void ImageDataLoad::run()
+{
+	ImageData *decoded = hasRegion ? new ImageData(data, region) : new ImageData(data);
+	StrongRef<ImageData> result(decoded, Acquire::NORETAIN);
+
+	love::thread::Lock lock(mutex);
+	imageData = result;
+}
+
+void ImageDataLoad::finish(const std::string &decodeError)
+{
+	love::thread::Lock lock(mutex);
+
+	error = decodeError;
+	complete = true;
+
+	// The encoded data isn't needed anymore.
+	data.set(nullptr);
+
+	finished->broadcast();
+}
+
+bool ImageDataLoad::isComplete() const
+{
+	love::thread::Lock lock(mutex);
+	return complete;
+}
+
+ImageData *ImageDataLoad::getImageData()
+{
+	love::thread::Lock lock(mutex);
+
+	while (!complete)
+		finished->wait(mutex);
+
+	if (!error.empty())
+		throw love::Exception("%s", error.c_str());
+
+	return imageData;
+}
+
+void ImageDataLoad::stopDecodeThreads()
+{
+	love::thread::Lock poolLock(getDecodePoolMutex());
+
+	if (decodePool == nullptr)
+		return;
+
+	std::deque<ImageDataLoad *> cancelled;
+
+	{
+		love::thread::Lock lock(decodePool->mutex);
+		decodePool->stopping = true;
+		decodePool->workAvailable->broadcast();
+		std::swap(cancelled, decodePool->jobs);
+	}
+
+	for (DecodeWorker *worker : decodePool->workers)
+	{
+		worker->wait();
+		worker->release();
+	}
+
+	for (ImageDataLoad *job : cancelled)
+	{
+		job->finish("The image module was destroyed before decoding finished.");
+		job->release();
+	}
+
+	delete decodePool;
+	decodePool = nullptr;
+}
+
+} // image
+} // love
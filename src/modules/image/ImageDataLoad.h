@@ -0,0 +1,87 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/Object.h"
+#include "common/Data.h"
+#include "thread/threads.h"
+#include "ImageData.h"
+
+// C++
+#include <string>
+
+namespace love
+{
+namespace image
+{
+
+/**
+ * Tracks encoded image data which is being decoded to an ImageData on the
+ * Image module's worker threads.
+ **/
+class ImageDataLoad : public love::Object
+{
+public:
+
+	static love::Type type;
+
+	ImageDataLoad(Data *data);
+	ImageDataLoad(Data *data, const FormatHandler::DecodeRegion &region);
+	virtual ~ImageDataLoad();
+
+	bool isComplete() const;
+
+	/**
+	 * Waits for decoding to finish, and throws if it failed.
+	 * @return The decoded ImageData.
+	 **/
+	ImageData *getImageData();
+
+	/**
+	 * Stops the worker threads, if they were started. Loads which haven't
+	 * started yet fail.
+	 **/
+	static void stopDecodeThreads();
+
+private:
+
+	friend class DecodeWorker;
+
+	void start();
+	void run();
+	void finish(const std::string &decodeError);
+
+	StrongRef<Data> data;
+	FormatHandler::DecodeRegion region;
+	bool hasRegion;
+
+	StrongRef<ImageData> imageData;
+	std::string error;
+	bool complete;
+
+	love::thread::MutexRef mutex;
+	love::thread::ConditionalRef finished;
+
+}; // ImageDataLoad
+
+} // image
+} // love
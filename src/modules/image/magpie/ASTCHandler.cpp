@@ -105,7 +105,7 @@ bool ASTCHandler::canParseCompressed(Data *data)
 	return true;
 }
 
-StrongRef<ByteData> ASTCHandler::parseCompressed(Data *filedata, std::vector<StrongRef<CompressedSlice>> &images, PixelFormat &format)
+StrongRef<Data> ASTCHandler::parseCompressed(Data *filedata, std::vector<StrongRef<CompressedSlice>> &images, PixelFormat &format)
 {
 	if (!canParseCompressed(filedata))
 		throw love::Exception("Could not decode compressed data (not an .astc file?)");
@@ -130,15 +130,11 @@ StrongRef<ByteData> ASTCHandler::parseCompressed(Data *filedata, std::vector<Str
 	if (totalsize + sizeof(header) > filedata->getSize())
 		throw love::Exception("Could not parse .astc file: file is too small.");
 
-	StrongRef<ByteData> memory(new ByteData(totalsize, false), Acquire::NORETAIN);
-
-	// .astc files only store a single mipmap level.
-	memcpy(memory->getData(), (uint8 *) filedata->getData() + sizeof(ASTCHeader), totalsize);
-
-	images.emplace_back(new CompressedSlice(cformat, sizeX, sizeY, memory, 0, totalsize), Acquire::NORETAIN);
+	// .astc files only store a single mipmap level, which is used in place.
+	images.emplace_back(new CompressedSlice(cformat, sizeX, sizeY, filedata, sizeof(ASTCHeader), totalsize), Acquire::NORETAIN);
 
 	format = cformat;
-	return memory;
+	return filedata;
 }
 
 } // magpie
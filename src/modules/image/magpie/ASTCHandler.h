@@ -41,9 +41,11 @@ public:
 	virtual ~ASTCHandler() {}
 
 	// Implements FormatHandler.
+	bool isThreadSafe() const override { return true; }
+
 	bool canParseCompressed(Data *data) override;
 
-	StrongRef<ByteData> parseCompressed(Data *filedata,
+	StrongRef<Data> parseCompressed(Data *filedata,
 	        std::vector<StrongRef<CompressedSlice>> &images,
 	        PixelFormat &format) override;
 
@@ -22,13 +22,40 @@
 #include "EXRHandler.h"
 #include "common/floattypes.h"
 #include "common/Exception.h"
+#include "image/ImageData.h"
 
 // zlib (for tinyexr)
 #include <zlib.h>
 
+// C++
+#include <functional>
+
+namespace love
+{
+namespace image
+{
+namespace magpie
+{
+
+// Scanline blocks are independent, so they're decoded on ImageData's row
+// worker threads.
+static void parallelEXRBlocks(int count, size_t blocksize, const std::function<void(int)> &func)
+{
+	ImageData::parallelRows(0, count, blocksize, [&](int y, int h)
+	{
+		for (int i = y; i < y + h; i++)
+			func(i);
+	});
+}
+
+} // magpie
+} // image
+} // love
+
 // tinyexr
 #define TINYEXR_IMPLEMENTATION
 #define TINYEXR_USE_MINIZ 0
+#define TINYEXR_PARALLEL_FOR(count, blocksize, func) love::image::magpie::parallelEXRBlocks(count, blocksize, func)
 #include "libraries/tinyexr/tinyexr.h"
 
 // C
@@ -108,18 +135,29 @@ static T *readEXRChannels(int width, int height, T *rgba[4], T one)
 		throw love::Exception("Out of memory.");
 	}
 
-	for (int y = 0; y < height; y++)
+	const T defaults[4] = {0, 0, 0, one};
+
+	ImageData::parallelRows(0, height, sizeof(T) * 4 * width, [&](int y, int h)
 	{
-		for (int x = 0; x < width; x++)
-		{
-			size_t offset = y * width + x;
+		size_t start = (size_t) y * width;
+		size_t end = (size_t) (y + h) * width;
 
-			data[offset * 4 + 0] = rgba[0] != nullptr ? rgba[0][offset] : 0;
-			data[offset * 4 + 1] = rgba[1] != nullptr ? rgba[1][offset] : 0;
-			data[offset * 4 + 2] = rgba[2] != nullptr ? rgba[2][offset] : 0;
-			data[offset * 4 + 3] = rgba[3] != nullptr ? rgba[3][offset] : one;
+		// One channel at a time keeps the inner loops free of branches.
+		for (int c = 0; c < 4; c++)
+		{
+			const T *src = rgba[c];
+			if (src != nullptr)
+			{
+				for (size_t i = start; i < end; i++)
+					data[i * 4 + c] = src[i];
+			}
+			else
+			{
+				for (size_t i = start; i < end; i++)
+					data[i * 4 + c] = defaults[c];
+			}
 		}
-	}
+	});
 
 	return data;
 }
@@ -259,7 +297,7 @@ FormatHandler::DecodedImage EXRHandler::decode(Data *data)
 	return img;
 }
 
-FormatHandler::EncodedImage EXRHandler::encode(const DecodedImage &img, EncodedFormat encodedFormat)
+FormatHandler::EncodedImage EXRHandler::encode(const DecodedImage &img, EncodedFormat encodedFormat, int /*compressionLevel*/)
 {
 	if (!canEncode(img.format, encodedFormat))
 	{
@@ -39,12 +39,13 @@ public:
 	virtual ~EXRHandler() {}
 
 	// Implements FormatHandler.
+	bool isThreadSafe() const override { return true; }
 
 	bool canDecode(Data *data) override;
 	bool canEncode(PixelFormat rawFormat, EncodedFormat encodedFormat) override;
 
 	DecodedImage decode(Data *data) override;
-	EncodedImage encode(const DecodedImage &img, EncodedFormat format) override;
+	EncodedImage encode(const DecodedImage &img, EncodedFormat format, int compressionLevel) override;
 
 	void freeRawPixels(unsigned char *mem) override;
 	void freeEncodedImage(unsigned char *mem) override;
@@ -26,6 +26,13 @@
 // C
 #include <string.h>
 
+// zlib
+#include <zlib.h>
+
+#ifdef LOVE_SUPPORT_ZSTD
+#include <zstd.h>
+#endif
+
 // C++
 #include <algorithm>
 
@@ -274,10 +281,313 @@ PixelFormat convertFormat(uint32 glformat)
 	}
 }
 
+#define KTX2_IDENTIFIER_REF {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A}
+#define KTX2_HEADER_SIZE    (80)
+
+// KTX2 files are always little-endian.
+struct KTX2Header
+{
+	uint8  identifier[12];
+	uint32 vkFormat;
+	uint32 typeSize;
+	uint32 pixelWidth;
+	uint32 pixelHeight;
+	uint32 pixelDepth;
+	uint32 layerCount;
+	uint32 faceCount;
+	uint32 levelCount;
+	uint32 supercompressionScheme;
+
+	uint32 dfdByteOffset;
+	uint32 dfdByteLength;
+	uint32 kvdByteOffset;
+	uint32 kvdByteLength;
+	uint64 sgdByteOffset;
+	uint64 sgdByteLength;
+};
+
+static_assert(sizeof(KTX2Header) == KTX2_HEADER_SIZE, "Real size of KTX2 header doesn't match struct size!");
+
+struct KTX2LevelIndex
+{
+	uint64 byteOffset;
+	uint64 byteLength;
+	uint64 uncompressedByteLength;
+};
+
+enum KTX2SupercompressionScheme
+{
+	KTX2_SUPERCOMPRESSION_NONE = 0,
+	KTX2_SUPERCOMPRESSION_BASISLZ = 1,
+	KTX2_SUPERCOMPRESSION_ZSTD = 2,
+	KTX2_SUPERCOMPRESSION_ZLIB = 3,
+};
+
+enum KTX2VkFormat
+{
+	// Used by Basis Universal (ETC1S and UASTC) data.
+	KTX2_VK_FORMAT_UNDEFINED = 0,
+
+	KTX2_VK_FORMAT_BC1_RGB_UNORM_BLOCK       = 131,
+	KTX2_VK_FORMAT_BC1_RGB_SRGB_BLOCK        = 132,
+	KTX2_VK_FORMAT_BC1_RGBA_UNORM_BLOCK      = 133,
+	KTX2_VK_FORMAT_BC1_RGBA_SRGB_BLOCK       = 134,
+	KTX2_VK_FORMAT_BC2_UNORM_BLOCK           = 135,
+	KTX2_VK_FORMAT_BC2_SRGB_BLOCK            = 136,
+	KTX2_VK_FORMAT_BC3_UNORM_BLOCK           = 137,
+	KTX2_VK_FORMAT_BC3_SRGB_BLOCK            = 138,
+	KTX2_VK_FORMAT_BC4_UNORM_BLOCK           = 139,
+	KTX2_VK_FORMAT_BC4_SNORM_BLOCK           = 140,
+	KTX2_VK_FORMAT_BC5_UNORM_BLOCK           = 141,
+	KTX2_VK_FORMAT_BC5_SNORM_BLOCK           = 142,
+	KTX2_VK_FORMAT_BC6H_UFLOAT_BLOCK         = 143,
+	KTX2_VK_FORMAT_BC6H_SFLOAT_BLOCK         = 144,
+	KTX2_VK_FORMAT_BC7_UNORM_BLOCK           = 145,
+	KTX2_VK_FORMAT_BC7_SRGB_BLOCK            = 146,
+	KTX2_VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK   = 147,
+	KTX2_VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK    = 148,
+	KTX2_VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK = 149,
+	KTX2_VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK  = 150,
+	KTX2_VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK = 151,
+	KTX2_VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK  = 152,
+	KTX2_VK_FORMAT_EAC_R11_UNORM_BLOCK       = 153,
+	KTX2_VK_FORMAT_EAC_R11_SNORM_BLOCK       = 154,
+	KTX2_VK_FORMAT_EAC_R11G11_UNORM_BLOCK    = 155,
+	KTX2_VK_FORMAT_EAC_R11G11_SNORM_BLOCK    = 156,
+
+	// The ASTC formats are contiguous, alternating UNORM and sRGB.
+	KTX2_VK_FORMAT_ASTC_4x4_UNORM_BLOCK      = 157,
+	KTX2_VK_FORMAT_ASTC_12x12_SRGB_BLOCK     = 184,
+};
+
+PixelFormat convertVkFormat(uint32 vkformat)
+{
+	switch (vkformat)
+	{
+	// BC1 to BC3 (DXT).
+	case KTX2_VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+	case KTX2_VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+		return PIXELFORMAT_DXT1_UNORM;
+	case KTX2_VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+	case KTX2_VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+		return PIXELFORMAT_DXT1_sRGB;
+	case KTX2_VK_FORMAT_BC2_UNORM_BLOCK:
+		return PIXELFORMAT_DXT3_UNORM;
+	case KTX2_VK_FORMAT_BC2_SRGB_BLOCK:
+		return PIXELFORMAT_DXT3_sRGB;
+	case KTX2_VK_FORMAT_BC3_UNORM_BLOCK:
+		return PIXELFORMAT_DXT5_UNORM;
+	case KTX2_VK_FORMAT_BC3_SRGB_BLOCK:
+		return PIXELFORMAT_DXT5_sRGB;
+
+	// BC4 to BC7.
+	case KTX2_VK_FORMAT_BC4_UNORM_BLOCK:
+		return PIXELFORMAT_BC4_UNORM;
+	case KTX2_VK_FORMAT_BC4_SNORM_BLOCK:
+		return PIXELFORMAT_BC4_SNORM;
+	case KTX2_VK_FORMAT_BC5_UNORM_BLOCK:
+		return PIXELFORMAT_BC5_UNORM;
+	case KTX2_VK_FORMAT_BC5_SNORM_BLOCK:
+		return PIXELFORMAT_BC5_SNORM;
+	case KTX2_VK_FORMAT_BC6H_UFLOAT_BLOCK:
+		return PIXELFORMAT_BC6H_UFLOAT;
+	case KTX2_VK_FORMAT_BC6H_SFLOAT_BLOCK:
+		return PIXELFORMAT_BC6H_FLOAT;
+	case KTX2_VK_FORMAT_BC7_UNORM_BLOCK:
+		return PIXELFORMAT_BC7_UNORM;
+	case KTX2_VK_FORMAT_BC7_SRGB_BLOCK:
+		return PIXELFORMAT_BC7_sRGB;
+
+	// ETC2 and EAC.
+	case KTX2_VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK:
+		return PIXELFORMAT_ETC2_RGB_UNORM;
+	case KTX2_VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK:
+		return PIXELFORMAT_ETC2_RGB_sRGB;
+	case KTX2_VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK:
+		return PIXELFORMAT_ETC2_RGBA1_UNORM;
+	case KTX2_VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK:
+		return PIXELFORMAT_ETC2_RGBA1_sRGB;
+	case KTX2_VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK:
+		return PIXELFORMAT_ETC2_RGBA_UNORM;
+	case KTX2_VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK:
+		return PIXELFORMAT_ETC2_RGBA_sRGB;
+	case KTX2_VK_FORMAT_EAC_R11_UNORM_BLOCK:
+		return PIXELFORMAT_EAC_R_UNORM;
+	case KTX2_VK_FORMAT_EAC_R11_SNORM_BLOCK:
+		return PIXELFORMAT_EAC_R_SNORM;
+	case KTX2_VK_FORMAT_EAC_R11G11_UNORM_BLOCK:
+		return PIXELFORMAT_EAC_RG_UNORM;
+	case KTX2_VK_FORMAT_EAC_R11G11_SNORM_BLOCK:
+		return PIXELFORMAT_EAC_RG_SNORM;
+	default:
+		break;
+	}
+
+	if (vkformat >= KTX2_VK_FORMAT_ASTC_4x4_UNORM_BLOCK && vkformat <= KTX2_VK_FORMAT_ASTC_12x12_SRGB_BLOCK)
+	{
+		static const PixelFormat astcformats[] =
+		{
+			PIXELFORMAT_ASTC_4x4_UNORM,   PIXELFORMAT_ASTC_4x4_sRGB,
+			PIXELFORMAT_ASTC_5x4_UNORM,   PIXELFORMAT_ASTC_5x4_sRGB,
+			PIXELFORMAT_ASTC_5x5_UNORM,   PIXELFORMAT_ASTC_5x5_sRGB,
+			PIXELFORMAT_ASTC_6x5_UNORM,   PIXELFORMAT_ASTC_6x5_sRGB,
+			PIXELFORMAT_ASTC_6x6_UNORM,   PIXELFORMAT_ASTC_6x6_sRGB,
+			PIXELFORMAT_ASTC_8x5_UNORM,   PIXELFORMAT_ASTC_8x5_sRGB,
+			PIXELFORMAT_ASTC_8x6_UNORM,   PIXELFORMAT_ASTC_8x6_sRGB,
+			PIXELFORMAT_ASTC_8x8_UNORM,   PIXELFORMAT_ASTC_8x8_sRGB,
+			PIXELFORMAT_ASTC_10x5_UNORM,  PIXELFORMAT_ASTC_10x5_sRGB,
+			PIXELFORMAT_ASTC_10x6_UNORM,  PIXELFORMAT_ASTC_10x6_sRGB,
+			PIXELFORMAT_ASTC_10x8_UNORM,  PIXELFORMAT_ASTC_10x8_sRGB,
+			PIXELFORMAT_ASTC_10x10_UNORM, PIXELFORMAT_ASTC_10x10_sRGB,
+			PIXELFORMAT_ASTC_12x10_UNORM, PIXELFORMAT_ASTC_12x10_sRGB,
+			PIXELFORMAT_ASTC_12x12_UNORM, PIXELFORMAT_ASTC_12x12_sRGB,
+		};
+
+		static_assert(sizeof(astcformats) / sizeof(astcformats[0]) == KTX2_VK_FORMAT_ASTC_12x12_SRGB_BLOCK - KTX2_VK_FORMAT_ASTC_4x4_UNORM_BLOCK + 1, "ASTC format table size mismatch");
+
+		return astcformats[vkformat - KTX2_VK_FORMAT_ASTC_4x4_UNORM_BLOCK];
+	}
+
+	return PIXELFORMAT_UNKNOWN;
+}
+
+bool isKTX2(Data *data)
+{
+	if (data->getSize() < sizeof(KTX2Header))
+		return false;
+
+	uint8 ktx2identifier[12] = KTX2_IDENTIFIER_REF;
+	return memcmp(data->getData(), ktx2identifier, 12) == 0;
+}
+
+void decompressLevel(uint32 scheme, const uint8 *src, size_t srcsize, uint8 *dst, size_t dstsize)
+{
+	if (scheme == KTX2_SUPERCOMPRESSION_ZLIB)
+	{
+		uLongf destlen = (uLongf) dstsize;
+		int zerr = uncompress(dst, &destlen, src, (uLong) srcsize);
+		if (zerr != Z_OK || destlen != dstsize)
+			throw love::Exception("Could not decompress zlib-supercompressed KTX2 mipmap level.");
+	}
+	else if (scheme == KTX2_SUPERCOMPRESSION_ZSTD)
+	{
+#ifdef LOVE_SUPPORT_ZSTD
+		size_t result = ZSTD_decompress(dst, dstsize, src, srcsize);
+		if (ZSTD_isError(result))
+			throw love::Exception("Could not decompress Zstandard-supercompressed KTX2 mipmap level: %s", ZSTD_getErrorName(result));
+		if (result != dstsize)
+			throw love::Exception("Could not decompress Zstandard-supercompressed KTX2 mipmap level: unexpected size.");
+#else
+		throw love::Exception("Zstandard-supercompressed KTX2 files are not supported (LOVE was built without Zstandard support).");
+#endif
+	}
+	else
+		throw love::Exception("Unknown supercompression scheme in KTX2 file.");
+}
+
+StrongRef<Data> parseKTX2(Data *filedata, std::vector<StrongRef<CompressedSlice>> &images, PixelFormat &format)
+{
+	KTX2Header header;
+	memcpy(&header, filedata->getData(), sizeof(KTX2Header));
+
+	const uint8 *filebytes = (const uint8 *) filedata->getData();
+	size_t filesize = filedata->getSize();
+
+	if (header.vkFormat == KTX2_VK_FORMAT_UNDEFINED || header.supercompressionScheme == KTX2_SUPERCOMPRESSION_BASISLZ)
+		throw love::Exception("KTX2 files containing Basis Universal data are not supported. Convert to a GPU block format (BC, ETC2, or ASTC) when creating the file.");
+
+	PixelFormat cformat = convertVkFormat(header.vkFormat);
+
+	if (cformat == PIXELFORMAT_UNKNOWN)
+		throw love::Exception("Unsupported image format in KTX2 file.");
+
+	if (header.layerCount > 1)
+		throw love::Exception("Texture arrays in KTX2 files are not supported.");
+
+	if (header.pixelDepth > 1)
+		throw love::Exception("3D textures in KTX2 files are not supported.");
+
+	if (header.faceCount > 1)
+		throw love::Exception("Cubemap textures in KTX2 files are not supported.");
+
+	if (header.supercompressionScheme > KTX2_SUPERCOMPRESSION_ZLIB)
+		throw love::Exception("Unknown supercompression scheme in KTX2 file.");
+
+	int levels = (int) std::max(header.levelCount, 1u);
+
+	if (sizeof(KTX2Header) + sizeof(KTX2LevelIndex) * levels > filesize)
+		throw love::Exception("Could not parse KTX2 file: unexpected EOF.");
+
+	std::vector<KTX2LevelIndex> levelindex(levels);
+	memcpy(levelindex.data(), filebytes + sizeof(KTX2Header), sizeof(KTX2LevelIndex) * levels);
+
+	size_t totalsize = 0;
+
+	// Level 0 is the base level in the index, even though the smallest level
+	// comes first in the file.
+	for (const KTX2LevelIndex &level : levelindex)
+	{
+		if (level.byteOffset > filesize || level.byteLength > filesize - level.byteOffset)
+			throw love::Exception("Could not parse KTX2 file: unexpected EOF.");
+
+		uint64 size = header.supercompressionScheme == KTX2_SUPERCOMPRESSION_NONE ? level.byteLength : level.uncompressedByteLength;
+		totalsize += (size_t) ((size + 3) & ~uint64(3));
+	}
+
+	// Levels without supercompression are used in place, without being
+	// copied out of the file.
+	if (header.supercompressionScheme == KTX2_SUPERCOMPRESSION_NONE)
+	{
+		for (int i = 0; i < levels; i++)
+		{
+			const KTX2LevelIndex &level = levelindex[i];
+
+			int width = (int) std::max(header.pixelWidth >> i, 1u);
+			int height = (int) std::max(header.pixelHeight >> i, 1u);
+
+			auto slice = new CompressedSlice(cformat, width, height, filedata, (size_t) level.byteOffset, (size_t) level.byteLength);
+			images.push_back(slice);
+			slice->release();
+		}
+
+		format = cformat;
+		return filedata;
+	}
+
+	StrongRef<Data> memory(new ByteData(totalsize, false), Acquire::NORETAIN);
+	size_t dataoffset = 0;
+
+	for (int i = 0; i < levels; i++)
+	{
+		const KTX2LevelIndex &level = levelindex[i];
+
+		const uint8 *src = filebytes + level.byteOffset;
+		uint8 *dst = (uint8 *) memory->getData() + dataoffset;
+		size_t mipsize = (size_t) level.uncompressedByteLength;
+
+		decompressLevel(header.supercompressionScheme, src, (size_t) level.byteLength, dst, mipsize);
+
+		int width = (int) std::max(header.pixelWidth >> i, 1u);
+		int height = (int) std::max(header.pixelHeight >> i, 1u);
+
+		auto slice = new CompressedSlice(cformat, width, height, memory, dataoffset, mipsize);
+		images.push_back(slice);
+		slice->release();
+
+		dataoffset += (mipsize + 3) & ~size_t(3);
+	}
+
+	format = cformat;
+	return memory;
+}
+
 } // Anonymous namespace.
 
 bool KTXHandler::canParseCompressed(Data *data)
 {
+	if (isKTX2(data))
+		return true;
+
 	if (data->getSize() < sizeof(KTXHeader))
 		return false;
 
@@ -293,11 +603,14 @@ bool KTXHandler::canParseCompressed(Data *data)
 	return true;
 }
 
-StrongRef<ByteData> KTXHandler::parseCompressed(Data *filedata, std::vector<StrongRef<CompressedSlice>> &images, PixelFormat &format)
+StrongRef<Data> KTXHandler::parseCompressed(Data *filedata, std::vector<StrongRef<CompressedSlice>> &images, PixelFormat &format)
 {
 	if (!canParseCompressed(filedata))
 		throw love::Exception("Could not decode compressed data (not a KTX file?)");
 
+	if (isKTX2(filedata))
+		return parseKTX2(filedata, images, format);
+
 	KTXHeader header = *(KTXHeader *) filedata->getData();
 
 	if (header.endianness == KTX_ENDIAN_REF_REV)
@@ -325,12 +638,13 @@ StrongRef<ByteData> KTXHandler::parseCompressed(Data *filedata, std::vector<Stro
 
 	size_t fileoffset = sizeof(KTXHeader) + header.bytesOfKeyValueData;
 	const uint8 *filebytes = (uint8 *) filedata->getData();
-	size_t totalsize = 0;
+	size_t filesize = filedata->getSize();
 
-	// Calculate the total size needed to hold the data in memory.
+	// Each mipmap level of the image is used in place, without being copied
+	// out of the file.
 	for (int i = 0; i < (int) header.numberOfMipmapLevels; i++)
 	{
-		if (fileoffset + sizeof(uint32) > filedata->getSize())
+		if (fileoffset + sizeof(uint32) > filesize)
 			throw love::Exception("Could not parse KTX file: unexpected EOF.");
 
 		uint32 mipsize = *(uint32 *) (filebytes + fileoffset);
@@ -340,47 +654,25 @@ StrongRef<ByteData> KTXHandler::parseCompressed(Data *filedata, std::vector<Stro
 
 		fileoffset += sizeof(uint32);
 
+		if (mipsize > filesize - fileoffset)
+			throw love::Exception("Could not parse KTX file: unexpected EOF.");
+
 		// All mipsize fields are at a file offset that's a multiple of 4, so
 		// there might be some padding after the actual data in this mip level.
 		uint32 mipsizepadded = (mipsize + 3) & ~uint32(3);
 
-		totalsize += mipsizepadded;
-		fileoffset += mipsizepadded;
-	}
-
-	StrongRef<ByteData> memory(new ByteData(totalsize, false), Acquire::NORETAIN);
-
-	// Reset the file offset to the start of the file's image data.
-	fileoffset = sizeof(KTXHeader) + header.bytesOfKeyValueData;
-	size_t dataoffset = 0;
-
-	// Copy each mipmap level of the image from the file to our block of memory.
-	for (int i = 0; i < (int) header.numberOfMipmapLevels; i++)
-	{
-		uint32 mipsize = *(uint32 *) (filebytes + fileoffset);
-
-		if (header.endianness == KTX_ENDIAN_REF_REV)
-			mipsize = swapuint32(mipsize);
-
-		fileoffset += sizeof(uint32);
-
-		uint32 mipsizepadded = (mipsize + 3) & ~uint32(3);
-
 		int width = (int) std::max(header.pixelWidth >> i, 1u);
 		int height = (int) std::max(header.pixelHeight >> i, 1u);
 
-		memcpy((uint8 *) memory->getData() + dataoffset, filebytes + fileoffset, mipsize);
-
-		auto slice = new CompressedSlice(cformat, width, height, memory, dataoffset, mipsize);
+		auto slice = new CompressedSlice(cformat, width, height, filedata, fileoffset, mipsize);
 		images.push_back(slice);
 		slice->release();
 
 		fileoffset += mipsizepadded;
-		dataoffset += mipsizepadded;
 	}
 
 	format = cformat;
-	return memory;
+	return filedata;
 }
 
 } // magpie
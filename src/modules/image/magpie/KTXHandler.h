@@ -31,7 +31,8 @@ namespace magpie
 {
 
 /**
- * Handles KTX files with compressed image data inside.
+ * Handles KTX and KTX2 files with compressed image data inside. KTX2 files
+ * may use zlib or Zstandard supercompression.
  **/
 class KTXHandler : public FormatHandler
 {
@@ -40,9 +41,11 @@ public:
 	virtual ~KTXHandler() {}
 
 	// Implements FormatHandler.
+	bool isThreadSafe() const override { return true; }
+
 	bool canParseCompressed(Data *data) override;
 
-	StrongRef<ByteData> parseCompressed(Data *filedata,
+	StrongRef<Data> parseCompressed(Data *filedata,
 	        std::vector<StrongRef<CompressedSlice>> &images,
 	        PixelFormat &format) override;
 
@@ -40,9 +40,11 @@ public:
 	virtual ~PKMHandler() {}
 
 	// Implements FormatHandler.
+	bool isThreadSafe() const override { return true; }
+
 	bool canParseCompressed(Data *data) override;
 
-	StrongRef<ByteData> parseCompressed(Data *filedata,
+	StrongRef<Data> parseCompressed(Data *filedata,
 	        std::vector<StrongRef<CompressedSlice>> &images,
 	        PixelFormat &format) override;
 
@@ -23,6 +23,7 @@
 // LOVE
 #include "common/Exception.h"
 #include "common/math.h"
+#include "image/ImageData.h"
 
 // LodePNG
 #include "lodepng/lodepng.h"
@@ -32,9 +33,12 @@
 
 // C++
 #include <algorithm>
+#include <limits>
+#include <vector>
 
 // C
 #include <cstdlib>
+#include <cstring>
 
 namespace love
 {
@@ -97,35 +101,270 @@ static unsigned zlibDecompress(unsigned char **out, size_t *outsize, const unsig
 	return 0; // Success.
 }
 
-// Custom PNG compression function for LodePNG, using zlib.
-static unsigned zlibCompress(unsigned char **out, size_t *outsize, const unsigned char *in,
-                             size_t insize, const LodePNGCompressSettings* /*settings*/)
+// PNG filter types.
+enum PNGFilter
 {
-	// Get the maximum compressed size of the data.
-	uLongf outdatasize = compressBound(insize);
+	PNG_FILTER_NONE,
+	PNG_FILTER_SUB,
+	PNG_FILTER_UP,
+	PNG_FILTER_AVERAGE,
+	PNG_FILTER_PAETH,
+	PNG_FILTER_MAX_ENUM
+};
+
+static inline uint8 paethPredictor(int a, int b, int c)
+{
+	int p = a + b - c;
+	int pa = abs(p - a);
+	int pb = abs(p - b);
+	int pc = abs(p - c);
+
+	if (pa <= pb && pa <= pc)
+		return (uint8) a;
+	else if (pb <= pc)
+		return (uint8) b;
+	else
+		return (uint8) c;
+}
 
-	// LodePNG uses malloc, realloc, and free.
-	unsigned char *outdata = (unsigned char *) malloc(outdatasize);
+// Writes the filtered row to out, and returns the sum of its bytes as signed
+// values (the usual heuristic for picking a filter).
+static uint64 filterRow(PNGFilter filter, const uint8 *cur, const uint8 *prev, size_t size, size_t bpp, uint8 *out)
+{
+	switch (filter)
+	{
+	case PNG_FILTER_NONE:
+		memcpy(out, cur, size);
+		break;
+	case PNG_FILTER_SUB:
+		for (size_t i = 0; i < size; i++)
+			out[i] = cur[i] - (i >= bpp ? cur[i - bpp] : 0);
+		break;
+	case PNG_FILTER_UP:
+		for (size_t i = 0; i < size; i++)
+			out[i] = cur[i] - prev[i];
+		break;
+	case PNG_FILTER_AVERAGE:
+		for (size_t i = 0; i < size; i++)
+			out[i] = cur[i] - (uint8) (((i >= bpp ? cur[i - bpp] : 0) + prev[i]) / 2);
+		break;
+	case PNG_FILTER_PAETH:
+		for (size_t i = 0; i < size; i++)
+		{
+			int a = i >= bpp ? cur[i - bpp] : 0;
+			int c = i >= bpp ? prev[i - bpp] : 0;
+			out[i] = cur[i] - paethPredictor(a, prev[i], c);
+		}
+		break;
+	default:
+		break;
+	}
 
-	if (!outdata)
-		return 83; // "Memory allocation failed" error code for LodePNG.
+	uint64 sum = 0;
+	for (size_t i = 0; i < size; i++)
+		sum += out[i] < 128 ? out[i] : 256 - out[i];
 
-	// Use zlib to compress the PNG data.
-	int status = compress(outdata, &outdatasize, in, insize);
+	return sum;
+}
 
-	if (status != Z_OK)
+// Filtered and deflated rows, which are encoded independently so they can
+// be compressed in parallel.
+struct RowGroup
+{
+	std::vector<uint8> compressed;
+	uLong adler = 1;
+	uLong filteredSize = 0;
+};
+
+static void encodeRowGroup(const FormatHandler::DecodedImage &img, int y0, int y1, int level, bool last, RowGroup &group)
+{
+	size_t bpp = img.format == PIXELFORMAT_RGBA16_UNORM ? 8 : 4;
+	size_t rowsize = (size_t) img.width * bpp;
+
+	std::vector<uint8> filtered((rowsize + 1) * (y1 - y0));
+
+	// Rows are converted to big-endian first for 16 bit images, and the
+	// previous row of the first row in the group is needed as well.
+	std::vector<uint8> rows[2] = {std::vector<uint8>(rowsize, 0), std::vector<uint8>(rowsize, 0)};
+	std::vector<uint8> candidate(level >= 4 ? rowsize : 0);
+
+	auto loadrow = [&](int y, std::vector<uint8> &row)
 	{
-		free(outdata);
-		return 10000; // "Unknown error code" for LodePNG.
+		const uint8 *src = img.data + (size_t) y * rowsize;
+#ifndef LOVE_BIG_ENDIAN
+		if (bpp == 8)
+		{
+			const uint16 *src16 = (const uint16 *) src;
+			uint16 *dst16 = (uint16 *) row.data();
+			for (size_t i = 0; i < rowsize / 2; i++)
+				dst16[i] = swapuint16(src16[i]);
+			return;
+		}
+#endif
+		memcpy(row.data(), src, rowsize);
+	};
+
+	if (y0 > 0)
+		loadrow(y0 - 1, rows[0]);
+
+	for (int y = y0; y < y1; y++)
+	{
+		std::vector<uint8> &prev = rows[(y - y0) % 2];
+		std::vector<uint8> &cur = rows[(y - y0 + 1) % 2];
+		loadrow(y, cur);
+
+		uint8 *out = &filtered[(rowsize + 1) * (y - y0)];
+
+		if (level == 0)
+		{
+			out[0] = PNG_FILTER_NONE;
+			filterRow(PNG_FILTER_NONE, cur.data(), prev.data(), rowsize, bpp, out + 1);
+		}
+		else if (level < 4)
+		{
+			// Fast levels use a fixed filter.
+			PNGFilter filter = y == 0 ? PNG_FILTER_SUB : PNG_FILTER_UP;
+			out[0] = (uint8) filter;
+			filterRow(filter, cur.data(), prev.data(), rowsize, bpp, out + 1);
+		}
+		else
+		{
+			uint64 best = std::numeric_limits<uint64>::max();
+			for (int f = 0; f < PNG_FILTER_MAX_ENUM; f++)
+			{
+				uint64 sum = filterRow((PNGFilter) f, cur.data(), prev.data(), rowsize, bpp, candidate.data());
+				if (sum < best)
+				{
+					best = sum;
+					out[0] = (uint8) f;
+					memcpy(out + 1, candidate.data(), rowsize);
+				}
+			}
+		}
 	}
 
-	if (out != nullptr)
-		*out = outdata;
+	group.filteredSize = (uLong) filtered.size();
+	group.adler = adler32(1, filtered.data(), (uInt) filtered.size());
 
-	if (outsize != nullptr)
-		*outsize = (size_t) outdatasize;
+	z_stream stream = {};
+	int strategy = level > 0 ? Z_FILTERED : Z_DEFAULT_STRATEGY;
 
-	return 0; // Success.
+	// Raw deflate, the zlib header and checksum are written separately.
+	if (deflateInit2(&stream, level, Z_DEFLATED, -15, 8, strategy) != Z_OK)
+		throw love::Exception("Could not initialize PNG compression.");
+
+	// Room for the empty block a sync flush ends with.
+	group.compressed.resize(deflateBound(&stream, (uLong) filtered.size()) + 16);
+
+	stream.next_in = filtered.data();
+	stream.avail_in = (uInt) filtered.size();
+	stream.next_out = group.compressed.data();
+	stream.avail_out = (uInt) group.compressed.size();
+
+	// Groups other than the last end on a byte boundary without marking the
+	// end of the stream, so they can be concatenated.
+	int status = deflate(&stream, last ? Z_FINISH : Z_SYNC_FLUSH);
+	group.compressed.resize(stream.total_out);
+	deflateEnd(&stream);
+
+	if (status != (last ? Z_STREAM_END : Z_OK))
+		throw love::Exception("Could not compress PNG image data.");
+}
+
+static inline uint32 readUint32BE(const uint8 *in)
+{
+	return ((uint32) in[0] << 24) | ((uint32) in[1] << 16) | ((uint32) in[2] << 8) | (uint32) in[3];
+}
+
+struct PNGHeader
+{
+	uint32 width = 0;
+	uint32 height = 0;
+	int bitDepth = 0;
+	int colorType = 0;
+	int interlace = 0;
+};
+
+static bool readPNGHeader(const uint8 *in, size_t size, PNGHeader &header)
+{
+	const uint8 signature[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+
+	if (size < 33 || memcmp(in, signature, 8) != 0 || memcmp(in + 12, "IHDR", 4) != 0)
+		return false;
+
+	header.width = readUint32BE(in + 16);
+	header.height = readUint32BE(in + 20);
+	header.bitDepth = in[24];
+	header.colorType = in[25];
+	header.interlace = in[28];
+
+	return header.width > 0 && header.height > 0;
+}
+
+static int getPNGChannelCount(int colorType)
+{
+	switch (colorType)
+	{
+	case 0: return 1; // Grayscale.
+	case 2: return 3; // RGB.
+	case 3: return 1; // Palette.
+	case 4: return 2; // Grayscale and alpha.
+	case 6: return 4; // RGBA.
+	default: return 0;
+	}
+}
+
+static void unfilterRow(uint8 *cur, const uint8 *prev, size_t size, size_t bpp)
+{
+	uint8 filter = cur[0];
+	cur++;
+
+	switch (filter)
+	{
+	case PNG_FILTER_NONE:
+		break;
+	case PNG_FILTER_SUB:
+		for (size_t i = bpp; i < size; i++)
+			cur[i] += cur[i - bpp];
+		break;
+	case PNG_FILTER_UP:
+		for (size_t i = 0; i < size; i++)
+			cur[i] += prev[i];
+		break;
+	case PNG_FILTER_AVERAGE:
+		for (size_t i = 0; i < size; i++)
+			cur[i] += (uint8) (((i >= bpp ? cur[i - bpp] : 0) + prev[i]) / 2);
+		break;
+	case PNG_FILTER_PAETH:
+		for (size_t i = 0; i < size; i++)
+		{
+			int a = i >= bpp ? cur[i - bpp] : 0;
+			int c = i >= bpp ? prev[i - bpp] : 0;
+			cur[i] += paethPredictor(a, prev[i], c);
+		}
+		break;
+	default:
+		throw love::Exception("Could not decode PNG image (invalid filter type).");
+	}
+}
+
+static void writeUint32BE(std::vector<uint8> &out, uint32 v)
+{
+	uint8 bytes[4] = {(uint8) (v >> 24), (uint8) (v >> 16), (uint8) (v >> 8), (uint8) v};
+	out.insert(out.end(), bytes, bytes + 4);
+}
+
+static void writeChunk(std::vector<uint8> &out, const char *type, const uint8 *data, size_t size)
+{
+	writeUint32BE(out, (uint32) size);
+
+	size_t start = out.size();
+	out.insert(out.end(), type, type + 4);
+	if (size > 0)
+		out.insert(out.end(), data, data + size);
+
+	uLong crc = crc32(0, out.data() + start, (uInt) (out.size() - start));
+	writeUint32BE(out, (uint32) crc);
 }
 
 bool PNGHandler::canDecode(Data *data)
@@ -199,61 +438,361 @@ PNGHandler::DecodedImage PNGHandler::decode(Data *fdata)
 	return img;
 }
 
-FormatHandler::EncodedImage PNGHandler::encode(const DecodedImage &img, EncodedFormat encodedFormat)
+bool PNGHandler::getDimensions(Data *data, int &width, int &height)
 {
-	if (!canEncode(img.format, encodedFormat))
-		throw love::Exception("PNG encoder cannot encode to non-PNG format.");
+	PNGHeader header;
+	if (!readPNGHeader((const uint8 *) data->getData(), data->getSize(), header))
+		return false;
 
-	EncodedImage encimg;
+	width = (int) header.width;
+	height = (int) header.height;
+	return true;
+}
 
-	lodepng::State state;
+bool PNGHandler::canDecodeRegion(Data *data)
+{
+	// Interlaced images store each row in up to 7 passes.
+	PNGHeader header;
+	return readPNGHeader((const uint8 *) data->getData(), data->getSize(), header)
+		&& header.interlace == 0;
+}
 
-	state.info_raw.colortype = LCT_RGBA;
-	state.info_raw.bitdepth = img.format == PIXELFORMAT_RGBA16_UNORM ? 16 : 8;
+PNGHandler::DecodedImage PNGHandler::decodeRegion(Data *fdata, const DecodeRegion &region)
+{
+	const uint8 *in = (const uint8 *) fdata->getData();
+	size_t insize = fdata->getSize();
 
-	state.info_png.color.colortype = LCT_RGBA;
-	state.info_png.color.bitdepth = state.info_raw.bitdepth;
+	PNGHeader header;
+	if (!readPNGHeader(in, insize, header) || header.interlace != 0)
+		throw love::Exception("Could not decode PNG image (unsupported header).");
 
-	state.encoder.zlibsettings.custom_zlib = zlibCompress;
+	int channels = getPNGChannelCount(header.colorType);
+	int bitdepth = header.bitDepth;
 
-	const uint8 *data = img.data;
-	uint16 *swappeddata = nullptr;
+	if (channels == 0 || (bitdepth != 1 && bitdepth != 2 && bitdepth != 4 && bitdepth != 8 && bitdepth != 16)
+		|| (bitdepth < 8 && channels > 1) || (header.colorType == 3 && bitdepth > 8))
+		throw love::Exception("Could not decode PNG image (invalid color type or bit depth).");
 
-	// LodePNG expects big-endian raw pixel data when encoding a 16 bit image.
-#ifndef LOVE_BIG_ENDIAN
-	if (state.info_raw.bitdepth == 16)
+	size_t bitsperpixel = (size_t) channels * bitdepth;
+	size_t stride = ((size_t) header.width * bitsperpixel + 7) / 8;
+	size_t filterbpp = std::max(bitsperpixel / 8, (size_t) 1);
+
+	// Find the palette, transparency and image data chunks. The image data is
+	// only read as far as the region's last row.
+	uint8 palette[256][4] = {};
+	size_t palettesize = 0;
+	int transparentkey[3] = {-1, -1, -1};
+	std::vector<std::pair<const uint8 *, uint32>> idat;
+
+	size_t pos = 8;
+	while (pos + 12 <= insize)
 	{
-		try
+		uint32 length = readUint32BE(in + pos);
+		const uint8 *type = in + pos + 4;
+		const uint8 *chunk = in + pos + 8;
+
+		if (length > insize - pos - 12)
+			break;
+
+		if (memcmp(type, "PLTE", 4) == 0)
 		{
-			swappeddata = new uint16[img.size / sizeof(uint16)];
+			palettesize = std::min(length / 3, 256u);
+			for (size_t i = 0; i < palettesize; i++)
+			{
+				memcpy(palette[i], chunk + i * 3, 3);
+				palette[i][3] = 255;
+			}
 		}
-		catch (std::exception &)
+		else if (memcmp(type, "tRNS", 4) == 0)
 		{
-			throw love::Exception("Out of memory.");
+			if (header.colorType == 3)
+			{
+				for (size_t i = 0; i < std::min(length, 256u); i++)
+					palette[i][3] = chunk[i];
+			}
+			else if (header.colorType == 0 && length >= 2)
+				transparentkey[0] = (chunk[0] << 8) | chunk[1];
+			else if (header.colorType == 2 && length >= 6)
+			{
+				for (int i = 0; i < 3; i++)
+					transparentkey[i] = (chunk[i * 2] << 8) | chunk[i * 2 + 1];
+			}
 		}
+		else if (memcmp(type, "IDAT", 4) == 0)
+			idat.emplace_back(chunk, length);
+		else if (memcmp(type, "IEND", 4) == 0)
+			break;
 
-		const uint16 *rawdata = (const uint16 *) img.data;
-		size_t numpixelcomponents = img.size / sizeof(uint16);
+		pos += 12 + length;
+	}
 
-		for (size_t i = 0; i < numpixelcomponents; i++)
-			swappeddata[i] = swapuint16(rawdata[i]);
+	if (idat.empty())
+		throw love::Exception("Could not decode PNG image (no image data).");
+
+	if (header.colorType == 3 && palettesize == 0)
+		throw love::Exception("Could not decode PNG image (missing palette).");
+
+	bool out16 = bitdepth == 16;
+	uint32 maxvalue = out16 ? 65535 : 255;
+	uint32 samplemax = (1u << bitdepth) - 1;
+
+	auto getsample = [&](const uint8 *row, size_t x, int c) -> uint32
+	{
+		if (bitdepth == 16)
+		{
+			const uint8 *p = row + (x * channels + c) * 2;
+			return ((uint32) p[0] << 8) | p[1];
+		}
+		else if (bitdepth == 8)
+			return row[x * channels + c];
 
-		data = (const uint8 *) swappeddata;
+		size_t bit = x * bitdepth;
+		return (row[bit / 8] >> (8 - bitdepth - (bit % 8))) & samplemax;
+	};
+
+	// Scales a sample to the output range, for bit depths below 8.
+	auto scale = [&](uint32 v) -> uint32
+	{
+		return bitdepth < 8 ? v * 255 / samplemax : v;
+	};
+
+	int level = region.mipmapLevel;
+	int blocksize = 1 << level;
+	int outw = (region.width + blocksize - 1) >> level;
+	int outh = (region.height + blocksize - 1) >> level;
+
+	DecodedImage img;
+	img.width = outw;
+	img.height = outh;
+	img.format = out16 ? PIXELFORMAT_RGBA16_UNORM : PIXELFORMAT_RGBA8_UNORM;
+	img.size = (size_t) outw * outh * (out16 ? 8 : 4);
+
+	// LodePNG's decoder uses malloc too, and freeRawPixels uses free.
+	img.data = (unsigned char *) malloc(img.size);
+	if (img.data == nullptr)
+		throw love::Exception("Out of memory.");
+
+	std::vector<uint8> rows[2] = {std::vector<uint8>(stride + 1, 0), std::vector<uint8>(stride + 1, 0)};
+	std::vector<uint64> sums((size_t) outw * 4, 0);
+	int blockrows = 0;
+
+	z_stream stream = {};
+	if (inflateInit(&stream) != Z_OK)
+	{
+		free(img.data);
+		throw love::Exception("Could not initialize PNG decompression.");
 	}
-#endif
 
-	unsigned status = lodepng_encode(&encimg.data, &encimg.size,
-	                                 data, img.width, img.height, &state);
+	size_t nextidat = 0;
 
-	if (swappeddata != nullptr)
-		delete[] swappeddata;
+	try
+	{
+		int lastrow = region.y + region.height;
 
-	if (status != 0)
+		for (int y = 0; y < lastrow; y++)
+		{
+			uint8 *prev = rows[y % 2].data() + 1;
+			uint8 *cur = rows[(y + 1) % 2].data();
+
+			stream.next_out = cur;
+			stream.avail_out = (uInt) (stride + 1);
+
+			while (stream.avail_out > 0)
+			{
+				if (stream.avail_in == 0)
+				{
+					if (nextidat >= idat.size())
+						throw love::Exception("Could not decode PNG image (image data is truncated).");
+
+					stream.next_in = (Bytef *) idat[nextidat].first;
+					stream.avail_in = idat[nextidat].second;
+					nextidat++;
+					continue;
+				}
+
+				int status = inflate(&stream, Z_NO_FLUSH);
+
+				if (status == Z_STREAM_END && stream.avail_out > 0)
+					throw love::Exception("Could not decode PNG image (image data is truncated).");
+				else if (status != Z_OK && status != Z_STREAM_END && status != Z_BUF_ERROR)
+					throw love::Exception("Could not decode PNG image (corrupt image data).");
+			}
+
+			unfilterRow(cur, prev, stride, filterbpp);
+
+			if (y < region.y)
+				continue;
+
+			const uint8 *row = cur + 1;
+
+			for (int x = 0; x < region.width; x++)
+			{
+				size_t sx = (size_t) (region.x + x);
+				uint32 rgba[4];
+
+				switch (header.colorType)
+				{
+				case 0:
+				{
+					uint32 v = getsample(row, sx, 0);
+					rgba[0] = rgba[1] = rgba[2] = scale(v);
+					rgba[3] = (int) v == transparentkey[0] ? 0 : maxvalue;
+					break;
+				}
+				case 2:
+				{
+					uint32 r = getsample(row, sx, 0);
+					uint32 g = getsample(row, sx, 1);
+					uint32 b = getsample(row, sx, 2);
+					rgba[0] = r;
+					rgba[1] = g;
+					rgba[2] = b;
+					rgba[3] = ((int) r == transparentkey[0] && (int) g == transparentkey[1] && (int) b == transparentkey[2]) ? 0 : maxvalue;
+					break;
+				}
+				case 3:
+				{
+					uint32 index = getsample(row, sx, 0);
+					if (index >= palettesize)
+						throw love::Exception("Could not decode PNG image (invalid palette index).");
+					for (int c = 0; c < 4; c++)
+						rgba[c] = palette[index][c];
+					break;
+				}
+				case 4:
+					rgba[0] = rgba[1] = rgba[2] = getsample(row, sx, 0);
+					rgba[3] = getsample(row, sx, 1);
+					break;
+				default:
+					for (int c = 0; c < 4; c++)
+						rgba[c] = getsample(row, sx, c);
+					break;
+				}
+
+				uint64 *sum = &sums[(size_t) (x >> level) * 4];
+				for (int c = 0; c < 4; c++)
+					sum[c] += rgba[c];
+			}
+
+			blockrows++;
+
+			// Average each block of pixels once all of its rows are in. Blocks
+			// at the right and bottom edges can be smaller.
+			if (blockrows == blocksize || y == lastrow - 1)
+			{
+				int outy = (y - region.y) >> level;
+
+				for (int outx = 0; outx < outw; outx++)
+				{
+					uint64 count = (uint64) std::min(blocksize, region.width - outx * blocksize) * blockrows;
+					uint64 *sum = &sums[(size_t) outx * 4];
+					size_t i = ((size_t) outy * outw + outx) * 4;
+
+					for (int c = 0; c < 4; c++)
+					{
+						uint64 v = (sum[c] + count / 2) / count;
+						if (out16)
+							((uint16 *) img.data)[i + c] = (uint16) v;
+						else
+							img.data[i + c] = (uint8) v;
+						sum[c] = 0;
+					}
+				}
+
+				blockrows = 0;
+			}
+		}
+	}
+	catch (love::Exception &)
 	{
-		const char *err = lodepng_error_text(status);
-		throw love::Exception("Could not encode PNG image (%s)", err);
+		inflateEnd(&stream);
+		free(img.data);
+		throw;
 	}
 
+	inflateEnd(&stream);
+	return img;
+}
+
+FormatHandler::EncodedImage PNGHandler::encode(const DecodedImage &img, EncodedFormat encodedFormat, int compressionLevel)
+{
+	if (!canEncode(img.format, encodedFormat))
+		throw love::Exception("PNG encoder cannot encode to non-PNG format.");
+
+	int level = compressionLevel < 0 ? 6 : std::min(compressionLevel, 9);
+	size_t rowsize = (size_t) img.width * (img.format == PIXELFORMAT_RGBA16_UNORM ? 8 : 4);
+
+	int rowspergroup = (int) std::max(ROW_GROUP_SIZE / std::max(rowsize, (size_t) 1), (size_t) 1);
+	int groupcount = std::max((img.height + rowspergroup - 1) / rowspergroup, 1);
+
+	std::vector<RowGroup> groups(groupcount);
+
+	ImageData::parallelRows(0, groupcount, (size_t) rowspergroup * rowsize, [&](int g0, int gn)
+	{
+		for (int g = g0; g < g0 + gn; g++)
+		{
+			int y0 = g * rowspergroup;
+			int y1 = std::min(y0 + rowspergroup, img.height);
+			encodeRowGroup(img, y0, y1, level, g == groupcount - 1, groups[g]);
+		}
+	});
+
+	std::vector<uint8> png;
+
+	size_t datasize = 0;
+	for (const RowGroup &group : groups)
+		datasize += group.compressed.size() + 12;
+	png.reserve(datasize + 64);
+
+	const uint8 signature[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+	png.insert(png.end(), signature, signature + sizeof(signature));
+
+	std::vector<uint8> header;
+	writeUint32BE(header, (uint32) img.width);
+	writeUint32BE(header, (uint32) img.height);
+	header.push_back(img.format == PIXELFORMAT_RGBA16_UNORM ? 16 : 8);
+	header.push_back(6); // RGBA
+	header.push_back(0); // Deflate compression.
+	header.push_back(0); // Adaptive filtering.
+	header.push_back(0); // No interlacing.
+	writeChunk(png, "IHDR", header.data(), header.size());
+
+	// Two byte zlib header: 32K window, with the level as a hint.
+	uint8 flevel = level < 2 ? 0 : (level < 6 ? 1 : (level == 6 ? 2 : 3));
+	uint8 zheader[2] = {0x78, (uint8) (flevel << 6)};
+	zheader[1] += 31 - ((zheader[0] << 8) + zheader[1]) % 31;
+
+	uLong adler = 1;
+	std::vector<uint8> idat;
+
+	for (int g = 0; g < groupcount; g++)
+	{
+		RowGroup &group = groups[g];
+		adler = adler32_combine(adler, group.adler, (z_off_t) group.filteredSize);
+
+		idat.clear();
+		if (g == 0)
+			idat.insert(idat.end(), zheader, zheader + 2);
+		idat.insert(idat.end(), group.compressed.begin(), group.compressed.end());
+		if (g == groupcount - 1)
+			writeUint32BE(idat, (uint32) adler);
+
+		std::vector<uint8>().swap(group.compressed);
+		writeChunk(png, "IDAT", idat.data(), idat.size());
+	}
+
+	writeChunk(png, "IEND", nullptr, 0);
+
+	EncodedImage encimg;
+
+	// Freed with free() in freeEncodedImage.
+	encimg.data = (unsigned char *) malloc(png.size());
+	if (encimg.data == nullptr)
+		throw love::Exception("Out of memory.");
+
+	memcpy(encimg.data, png.data(), png.size());
+	encimg.size = png.size();
+
 	return encimg;
 }
 
@@ -31,7 +31,8 @@ namespace magpie
 {
 
 /**
- * Interface between ImageData and LodePNG.
+ * Interface between ImageData and LodePNG. Encoding doesn't use LodePNG, so
+ * rows can be filtered and compressed in parallel.
  **/
 class PNGHandler : public FormatHandler
 {
@@ -40,16 +41,25 @@ public:
 	virtual ~PNGHandler() {}
 
 	// Implements FormatHandler.
+	bool isThreadSafe() const override { return true; }
 
 	bool canDecode(Data *data) override;
 	bool canEncode(PixelFormat rawFormat, EncodedFormat encodedFormat) override;
 
 	DecodedImage decode(Data *data) override;
-	EncodedImage encode(const DecodedImage &img, EncodedFormat format) override;
+
+	bool getDimensions(Data *data, int &width, int &height) override;
+	bool canDecodeRegion(Data *data) override;
+	DecodedImage decodeRegion(Data *data, const DecodeRegion &region) override;
+	EncodedImage encode(const DecodedImage &img, EncodedFormat format, int compressionLevel) override;
 
 	void freeRawPixels(unsigned char *mem) override;
 	void freeEncodedImage(unsigned char *mem) override;
 
+	// Rows are split into groups of about this many bytes, which are
+	// compressed independently.
+	static const size_t ROW_GROUP_SIZE = 512 * 1024;
+
 }; // PNGHandler
 
 } // magpie
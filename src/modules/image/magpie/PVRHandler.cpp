@@ -475,7 +475,7 @@ bool PVRHandler::canParseCompressed(Data *data)
 	return false;
 }
 
-StrongRef<ByteData> PVRHandler::parseCompressed(Data *filedata, std::vector<StrongRef<CompressedSlice>> &images, PixelFormat &format)
+StrongRef<Data> PVRHandler::parseCompressed(Data *filedata, std::vector<StrongRef<CompressedSlice>> &images, PixelFormat &format)
 {
 	if (!canParseCompressed(filedata))
 		throw love::Exception("Could not decode compressed data (not a PVR file?)");
@@ -528,12 +528,9 @@ StrongRef<ByteData> PVRHandler::parseCompressed(Data *filedata, std::vector<Stro
 	if (filedata->getSize() < fileoffset + totalsize)
 		throw love::Exception("Could not parse PVR file: invalid size calculation.");
 
-	;
-	StrongRef<ByteData> memory(new ByteData(totalsize, false), Acquire::NORETAIN);
-
 	size_t curoffset = 0;
-	const uint8 *filebytes = (uint8 *) filedata->getData() + fileoffset;
 
+	// Mipmap levels are used in place, without being copied out of the file.
 	for (int i = 0; i < (int) header3.numMipmaps; i++)
 	{
 		size_t mipsize = getMipLevelSize(header3, i);
@@ -544,9 +541,7 @@ StrongRef<ByteData> PVRHandler::parseCompressed(Data *filedata, std::vector<Stro
 		int width = std::max((int) header3.width >> i, 1);
 		int height = std::max((int) header3.height >> i, 1);
 
-		memcpy((uint8 *) memory->getData() + curoffset, filebytes + curoffset, mipsize);
-
-		auto slice = new CompressedSlice(cformat, width, height, memory, curoffset, mipsize);
+		auto slice = new CompressedSlice(cformat, width, height, filedata, fileoffset + curoffset, mipsize);
 		images.push_back(slice);
 		slice->release();
 
@@ -554,7 +549,7 @@ StrongRef<ByteData> PVRHandler::parseCompressed(Data *filedata, std::vector<Stro
 	}
 
 	format = cformat;
-	return memory;
+	return filedata;
 }
 
 } // magpie
@@ -0,0 +1,307 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "QOIHandler.h"
+
+// LOVE
+#include "common/Exception.h"
+
+// C
+#include <cstring>
+
+namespace love
+{
+namespace image
+{
+namespace magpie
+{
+
+static const uint8 QOI_OP_INDEX = 0x00;
+static const uint8 QOI_OP_DIFF  = 0x40;
+static const uint8 QOI_OP_LUMA  = 0x80;
+static const uint8 QOI_OP_RUN   = 0xC0;
+static const uint8 QOI_OP_RGB   = 0xFE;
+static const uint8 QOI_OP_RGBA  = 0xFF;
+static const uint8 QOI_MASK_2   = 0xC0;
+
+static const size_t QOI_HEADER_SIZE = 14;
+static const uint8 QOI_PADDING[8] = {0, 0, 0, 0, 0, 0, 0, 1};
+
+// Images larger than this are rejected, as in the reference implementation.
+static const uint64 QOI_PIXELS_MAX = 400000000;
+
+struct QOIPixel
+{
+	uint8 r, g, b, a;
+};
+
+static inline int qoiHash(const QOIPixel &p)
+{
+	return (p.r * 3 + p.g * 5 + p.b * 7 + p.a * 11) % 64;
+}
+
+static inline bool operator == (const QOIPixel &a, const QOIPixel &b)
+{
+	return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+}
+
+static inline void writeUint32BE(uint8 *out, uint32 v)
+{
+	out[0] = (uint8) (v >> 24);
+	out[1] = (uint8) (v >> 16);
+	out[2] = (uint8) (v >> 8);
+	out[3] = (uint8) v;
+}
+
+static inline uint32 readUint32BE(const uint8 *in)
+{
+	return ((uint32) in[0] << 24) | ((uint32) in[1] << 16) | ((uint32) in[2] << 8) | (uint32) in[3];
+}
+
+bool QOIHandler::canDecode(Data *data)
+{
+	if (data->getSize() < QOI_HEADER_SIZE + sizeof(QOI_PADDING))
+		return false;
+
+	const uint8 *bytes = (const uint8 *) data->getData();
+	return memcmp(bytes, "qoif", 4) == 0;
+}
+
+bool QOIHandler::canEncode(PixelFormat rawFormat, EncodedFormat encodedFormat)
+{
+	return encodedFormat == ENCODED_QOI && rawFormat == PIXELFORMAT_RGBA8_UNORM;
+}
+
+FormatHandler::DecodedImage QOIHandler::decode(Data *data)
+{
+	const uint8 *in = (const uint8 *) data->getData();
+	size_t size = data->getSize();
+
+	uint32 width = readUint32BE(in + 4);
+	uint32 height = readUint32BE(in + 8);
+	int channels = in[12];
+
+	if (width == 0 || height == 0 || (channels != 3 && channels != 4)
+		|| (uint64) width * height > QOI_PIXELS_MAX)
+		throw love::Exception("Could not decode QOI image (invalid header).");
+
+	DecodedImage img;
+	img.width = (int) width;
+	img.height = (int) height;
+	img.size = (size_t) width * height * 4;
+	img.format = PIXELFORMAT_RGBA8_UNORM;
+
+	try
+	{
+		img.data = new unsigned char[img.size];
+	}
+	catch (std::exception &)
+	{
+		throw love::Exception("Out of memory.");
+	}
+
+	QOIPixel index[64];
+	memset(index, 0, sizeof(index));
+
+	QOIPixel px = {0, 0, 0, 255};
+	int run = 0;
+
+	size_t p = QOI_HEADER_SIZE;
+	size_t end = size - sizeof(QOI_PADDING);
+
+	for (size_t i = 0; i < img.size; i += 4)
+	{
+		if (run > 0)
+			run--;
+		else if (p < end)
+		{
+			uint8 b1 = in[p++];
+
+			if (b1 == QOI_OP_RGB)
+			{
+				if (p + 3 > end)
+					break;
+				px.r = in[p++];
+				px.g = in[p++];
+				px.b = in[p++];
+			}
+			else if (b1 == QOI_OP_RGBA)
+			{
+				if (p + 4 > end)
+					break;
+				px.r = in[p++];
+				px.g = in[p++];
+				px.b = in[p++];
+				px.a = in[p++];
+			}
+			else if ((b1 & QOI_MASK_2) == QOI_OP_INDEX)
+				px = index[b1];
+			else if ((b1 & QOI_MASK_2) == QOI_OP_DIFF)
+			{
+				px.r += ((b1 >> 4) & 0x03) - 2;
+				px.g += ((b1 >> 2) & 0x03) - 2;
+				px.b += (b1 & 0x03) - 2;
+			}
+			else if ((b1 & QOI_MASK_2) == QOI_OP_LUMA)
+			{
+				if (p + 1 > end)
+					break;
+				uint8 b2 = in[p++];
+				int vg = (b1 & 0x3F) - 32;
+				px.r += vg - 8 + ((b2 >> 4) & 0x0F);
+				px.g += vg;
+				px.b += vg - 8 + (b2 & 0x0F);
+			}
+			else if ((b1 & QOI_MASK_2) == QOI_OP_RUN)
+				run = b1 & 0x3F;
+
+			index[qoiHash(px)] = px;
+		}
+
+		memcpy(img.data + i, &px, 4);
+	}
+
+	return img;
+}
+
+FormatHandler::EncodedImage QOIHandler::encode(const DecodedImage &img, EncodedFormat encodedFormat, int /*compressionLevel*/)
+{
+	if (!canEncode(img.format, encodedFormat))
+		throw love::Exception("QOI encoder cannot encode to non-QOI format.");
+
+	size_t pixelcount = (size_t) img.width * img.height;
+
+	// Worst case is an RGBA op for every pixel.
+	size_t maxsize = QOI_HEADER_SIZE + pixelcount * 5 + sizeof(QOI_PADDING);
+
+	uint8 *out = nullptr;
+	try
+	{
+		out = new uint8[maxsize];
+	}
+	catch (std::exception &)
+	{
+		throw love::Exception("Out of memory.");
+	}
+
+	memcpy(out, "qoif", 4);
+	writeUint32BE(out + 4, (uint32) img.width);
+	writeUint32BE(out + 8, (uint32) img.height);
+	out[12] = 4; // RGBA
+	out[13] = 0; // sRGB with linear alpha.
+
+	size_t p = QOI_HEADER_SIZE;
+
+	QOIPixel index[64];
+	memset(index, 0, sizeof(index));
+
+	QOIPixel prev = {0, 0, 0, 255};
+	int run = 0;
+
+	const QOIPixel *pixels = (const QOIPixel *) img.data;
+
+	for (size_t i = 0; i < pixelcount; i++)
+	{
+		QOIPixel px = pixels[i];
+
+		if (px == prev)
+		{
+			run++;
+			if (run == 62 || i == pixelcount - 1)
+			{
+				out[p++] = QOI_OP_RUN | (uint8) (run - 1);
+				run = 0;
+			}
+			continue;
+		}
+
+		if (run > 0)
+		{
+			out[p++] = QOI_OP_RUN | (uint8) (run - 1);
+			run = 0;
+		}
+
+		int hash = qoiHash(px);
+
+		if (index[hash] == px)
+			out[p++] = QOI_OP_INDEX | (uint8) hash;
+		else
+		{
+			index[hash] = px;
+
+			if (px.a == prev.a)
+			{
+				int8 vr = (int8) (px.r - prev.r);
+				int8 vg = (int8) (px.g - prev.g);
+				int8 vb = (int8) (px.b - prev.b);
+
+				int8 vgr = vr - vg;
+				int8 vgb = vb - vg;
+
+				if (vr > -3 && vr < 2 && vg > -3 && vg < 2 && vb > -3 && vb < 2)
+					out[p++] = QOI_OP_DIFF | (uint8) ((vr + 2) << 4 | (vg + 2) << 2 | (vb + 2));
+				else if (vgr > -9 && vgr < 8 && vg > -33 && vg < 32 && vgb > -9 && vgb < 8)
+				{
+					out[p++] = QOI_OP_LUMA | (uint8) (vg + 32);
+					out[p++] = (uint8) ((vgr + 8) << 4 | (vgb + 8));
+				}
+				else
+				{
+					out[p++] = QOI_OP_RGB;
+					out[p++] = px.r;
+					out[p++] = px.g;
+					out[p++] = px.b;
+				}
+			}
+			else
+			{
+				out[p++] = QOI_OP_RGBA;
+				out[p++] = px.r;
+				out[p++] = px.g;
+				out[p++] = px.b;
+				out[p++] = px.a;
+			}
+		}
+
+		prev = px;
+	}
+
+	memcpy(out + p, QOI_PADDING, sizeof(QOI_PADDING));
+	p += sizeof(QOI_PADDING);
+
+	EncodedImage encimg;
+	encimg.data = out;
+	encimg.size = p;
+	return encimg;
+}
+
+void QOIHandler::freeRawPixels(unsigned char *mem)
+{
+	delete[] mem;
+}
+
+void QOIHandler::freeEncodedImage(unsigned char *mem)
+{
+	delete[] mem;
+}
+
+} // magpie
+} // image
+} // love
@@ -59,6 +59,17 @@ namespace magpie
 
 static_assert(sizeof(Color32) == 4, "sizeof(Color32) must equal 4 bytes!");
 
+bool STBHandler::isThreadSafe() const
+{
+	// stb_image keeps its last error message in a global without thread
+	// locals.
+#ifdef STBI_NO_THREAD_LOCALS
+	return false;
+#else
+	return true;
+#endif
+}
+
 bool STBHandler::canDecode(Data *data)
 {
 	int w = 0;
@@ -108,7 +119,7 @@ FormatHandler::DecodedImage STBHandler::decode(Data *data)
 	return img;
 }
 
-FormatHandler::EncodedImage STBHandler::encode(const DecodedImage &img, EncodedFormat encodedFormat)
+FormatHandler::EncodedImage STBHandler::encode(const DecodedImage &img, EncodedFormat encodedFormat, int /*compressionLevel*/)
 {
 	if (!canEncode(img.format, encodedFormat))
 		throw love::Exception("Invalid format.");
@@ -25,6 +25,15 @@
 // dds parser
 #include "ddsparse/ddsparse.h"
 
+// C++
+#include <algorithm>
+#include <limits>
+
+// C
+#include <string.h>
+#include <math.h>
+#include <stdlib.h>
+
 namespace love
 {
 namespace image
@@ -234,20 +243,359 @@ FormatHandler::DecodedImage DDSHandler::decode(Data *data)
 	return img;
 }
 
+// Block compression of RGBA8 pixels. Endpoints are chosen along the principal
+// axis of each block's colors, which is cheap and gives good results for most
+// art without the exhaustive searches of offline compressors.
+
+static uint16 packRGB565(const float c[3])
+{
+	int r = std::min(std::max((int) (c[0] * (31.0f / 255.0f) + 0.5f), 0), 31);
+	int g = std::min(std::max((int) (c[1] * (63.0f / 255.0f) + 0.5f), 0), 63);
+	int b = std::min(std::max((int) (c[2] * (31.0f / 255.0f) + 0.5f), 0), 31);
+	return (uint16) ((r << 11) | (g << 5) | b);
+}
+
+static void unpackRGB565(uint16 c, int rgb[3])
+{
+	int r = (c >> 11) & 0x1F;
+	int g = (c >> 5) & 0x3F;
+	int b = c & 0x1F;
+	rgb[0] = (r << 3) | (r >> 2);
+	rgb[1] = (g << 2) | (g >> 4);
+	rgb[2] = (b << 3) | (b >> 2);
+}
+
+static void encodeColorBlock(const uint8 pixels[16][4], bool allowtransparent, uint8 *dest)
+{
+	bool transparent[16] = {};
+	bool hastransparent = false;
+
+	if (allowtransparent)
+	{
+		for (int i = 0; i < 16; i++)
+		{
+			transparent[i] = pixels[i][3] < 128;
+			hastransparent = hastransparent || transparent[i];
+		}
+	}
+
+	float mean[3] = {0.0f, 0.0f, 0.0f};
+	int count = 0;
+
+	for (int i = 0; i < 16; i++)
+	{
+		if (transparent[i])
+			continue;
+		for (int c = 0; c < 3; c++)
+			mean[c] += pixels[i][c];
+		count++;
+	}
+
+	uint16 c0 = 0;
+	uint16 c1 = 0;
+
+	if (count > 0)
+	{
+		for (int c = 0; c < 3; c++)
+			mean[c] /= (float) count;
+
+		float cov[6] = {};
+		for (int i = 0; i < 16; i++)
+		{
+			if (transparent[i])
+				continue;
+
+			float d[3] = {pixels[i][0] - mean[0], pixels[i][1] - mean[1], pixels[i][2] - mean[2]};
+			cov[0] += d[0] * d[0];
+			cov[1] += d[0] * d[1];
+			cov[2] += d[0] * d[2];
+			cov[3] += d[1] * d[1];
+			cov[4] += d[1] * d[2];
+			cov[5] += d[2] * d[2];
+		}
+
+		// Power iteration for the principal axis.
+		float axis[3] = {1.0f, 1.0f, 1.0f};
+		for (int iter = 0; iter < 4; iter++)
+		{
+			float x = cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2];
+			float y = cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2];
+			float z = cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2];
+			float len = std::max(std::max(fabsf(x), fabsf(y)), fabsf(z));
+			if (len <= 0.0f)
+				break;
+			axis[0] = x / len;
+			axis[1] = y / len;
+			axis[2] = z / len;
+		}
+
+		float mindot = std::numeric_limits<float>::max();
+		float maxdot = -std::numeric_limits<float>::max();
+		for (int i = 0; i < 16; i++)
+		{
+			if (transparent[i])
+				continue;
+
+			float dot = (pixels[i][0] - mean[0]) * axis[0] + (pixels[i][1] - mean[1]) * axis[1] + (pixels[i][2] - mean[2]) * axis[2];
+			mindot = std::min(mindot, dot);
+			maxdot = std::max(maxdot, dot);
+		}
+
+		float lensq = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+		if (lensq > 0.0f)
+		{
+			mindot /= lensq;
+			maxdot /= lensq;
+		}
+
+		// Inset the endpoints slightly, since the extremes are rarely hit exactly.
+		float inset = (maxdot - mindot) / 16.0f;
+		mindot += inset;
+		maxdot -= inset;
+
+		float minc[3];
+		float maxc[3];
+		for (int c = 0; c < 3; c++)
+		{
+			minc[c] = mean[c] + axis[c] * mindot;
+			maxc[c] = mean[c] + axis[c] * maxdot;
+		}
+
+		c0 = packRGB565(maxc);
+		c1 = packRGB565(minc);
+	}
+
+	// Four-color mode needs c0 > c1, three-color mode (with transparency)
+	// needs c0 <= c1.
+	if (hastransparent ? c0 > c1 : c0 < c1)
+		std::swap(c0, c1);
+
+	int palette[4][3];
+	unpackRGB565(c0, palette[0]);
+	unpackRGB565(c1, palette[1]);
+
+	int palettesize = 4;
+	if (hastransparent)
+	{
+		for (int c = 0; c < 3; c++)
+			palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+		palettesize = 3;
+	}
+	else
+	{
+		for (int c = 0; c < 3; c++)
+		{
+			palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+			palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+		}
+	}
+
+	uint32 indices = 0;
+	if (c0 != c1 || hastransparent)
+	{
+		for (int i = 0; i < 16; i++)
+		{
+			uint32 index = 3;
+			if (!transparent[i])
+			{
+				int besterror = std::numeric_limits<int>::max();
+				for (int p = 0; p < palettesize; p++)
+				{
+					int dr = pixels[i][0] - palette[p][0];
+					int dg = pixels[i][1] - palette[p][1];
+					int db = pixels[i][2] - palette[p][2];
+					int error = dr * dr + dg * dg + db * db;
+					if (error < besterror)
+					{
+						besterror = error;
+						index = (uint32) p;
+					}
+				}
+			}
+			indices |= index << (i * 2);
+		}
+	}
+
+	dest[0] = (uint8) (c0 & 0xFF);
+	dest[1] = (uint8) (c0 >> 8);
+	dest[2] = (uint8) (c1 & 0xFF);
+	dest[3] = (uint8) (c1 >> 8);
+	for (int i = 0; i < 4; i++)
+		dest[4 + i] = (uint8) ((indices >> (i * 8)) & 0xFF);
+}
+
+static void encodeAlphaBlock(const uint8 pixels[16][4], uint8 *dest)
+{
+	int a0 = 0;
+	int a1 = 255;
+	for (int i = 0; i < 16; i++)
+	{
+		a0 = std::max(a0, (int) pixels[i][3]);
+		a1 = std::min(a1, (int) pixels[i][3]);
+	}
+
+	uint64 indices = 0;
+	if (a0 != a1)
+	{
+		// Eight-value mode, where codes 2-7 interpolate from a0 to a1.
+		int palette[8] = {a0, a1};
+		for (int k = 2; k < 8; k++)
+			palette[k] = ((8 - k) * a0 + (k - 1) * a1) / 7;
+
+		for (int i = 0; i < 16; i++)
+		{
+			int besterror = std::numeric_limits<int>::max();
+			uint64 index = 0;
+			for (int k = 0; k < 8; k++)
+			{
+				int error = abs(pixels[i][3] - palette[k]);
+				if (error < besterror)
+				{
+					besterror = error;
+					index = (uint64) k;
+				}
+			}
+			indices |= index << (i * 3);
+		}
+	}
+
+	dest[0] = (uint8) a0;
+	dest[1] = (uint8) a1;
+	for (int i = 0; i < 6; i++)
+		dest[2 + i] = (uint8) ((indices >> (i * 8)) & 0xFF);
+}
+
+// Legacy DDS header, which is enough to describe BC1-3 data with mipmaps.
+struct DDSFileHeader
+{
+	uint32 magic;
+	uint32 size;
+	uint32 flags;
+	uint32 height;
+	uint32 width;
+	uint32 pitchOrLinearSize;
+	uint32 depth;
+	uint32 mipMapCount;
+	uint32 reserved1[11];
+	uint32 pfSize;
+	uint32 pfFlags;
+	uint32 pfFourCC;
+	uint32 pfRGBBitCount;
+	uint32 pfRBitMask;
+	uint32 pfGBitMask;
+	uint32 pfBBitMask;
+	uint32 pfABitMask;
+	uint32 caps;
+	uint32 caps2;
+	uint32 caps3;
+	uint32 caps4;
+	uint32 reserved2;
+};
+
+static uint32 makeFourCC(char a, char b, char c, char d)
+{
+	return (uint32) a | ((uint32) b << 8) | ((uint32) c << 16) | ((uint32) d << 24);
+}
+
+bool DDSHandler::canEncodeCompressed(PixelFormat rawFormat, PixelFormat compressedFormat)
+{
+	if (rawFormat != PIXELFORMAT_RGBA8_UNORM && rawFormat != PIXELFORMAT_RGBA8_sRGB)
+		return false;
+
+	return compressedFormat == PIXELFORMAT_DXT1_UNORM || compressedFormat == PIXELFORMAT_DXT5_UNORM;
+}
+
+FormatHandler::EncodedImage DDSHandler::encodeCompressed(const std::vector<DecodedImage> &mipmaps, PixelFormat compressedFormat)
+{
+	if (mipmaps.empty() || !canEncodeCompressed(mipmaps[0].format, compressedFormat))
+		throw love::Exception("Cannot compress to the requested pixel format.");
+
+	bool dxt5 = compressedFormat == PIXELFORMAT_DXT5_UNORM;
+	size_t blocksize = dxt5 ? 16 : 8;
+
+	size_t datasize = 0;
+	for (const DecodedImage &img : mipmaps)
+		datasize += (size_t) ((img.width + 3) / 4) * (size_t) ((img.height + 3) / 4) * blocksize;
+
+	EncodedImage encoded;
+	encoded.size = sizeof(DDSFileHeader) + datasize;
+
+	try
+	{
+		encoded.data = new unsigned char[encoded.size];
+	}
+	catch (std::exception &)
+	{
+		throw love::Exception("Out of memory.");
+	}
+
+	DDSFileHeader header = {};
+	header.magic = makeFourCC('D', 'D', 'S', ' ');
+	header.size = 124;
+	header.flags = 0x1 | 0x2 | 0x4 | 0x1000 | 0x80000; // caps, height, width, pixelformat, linearsize
+	header.height = (uint32) mipmaps[0].height;
+	header.width = (uint32) mipmaps[0].width;
+	header.pitchOrLinearSize = (uint32) (((mipmaps[0].width + 3) / 4) * ((mipmaps[0].height + 3) / 4) * blocksize);
+	header.mipMapCount = (uint32) mipmaps.size();
+	header.pfSize = 32;
+	header.pfFlags = 0x4; // fourcc
+	header.pfFourCC = dxt5 ? makeFourCC('D', 'X', 'T', '5') : makeFourCC('D', 'X', 'T', '1');
+	header.caps = 0x1000; // texture
+
+	if (mipmaps.size() > 1)
+	{
+		header.flags |= 0x20000; // mipmapcount
+		header.caps |= 0x8 | 0x400000; // complex, mipmap
+	}
+
+	memcpy(encoded.data, &header, sizeof(DDSFileHeader));
+	uint8 *dest = encoded.data + sizeof(DDSFileHeader);
+
+	for (const DecodedImage &img : mipmaps)
+	{
+		const uint8 *src = (const uint8 *) img.data;
+
+		for (int by = 0; by < img.height; by += 4)
+		{
+			for (int bx = 0; bx < img.width; bx += 4)
+			{
+				// Blocks past the edge of the image repeat the last pixel.
+				uint8 pixels[16][4];
+				for (int i = 0; i < 16; i++)
+				{
+					int x = std::min(bx + (i % 4), img.width - 1);
+					int y = std::min(by + (i / 4), img.height - 1);
+					memcpy(pixels[i], src + ((size_t) y * img.width + x) * 4, 4);
+				}
+
+				if (dxt5)
+				{
+					encodeAlphaBlock(pixels, dest);
+					encodeColorBlock(pixels, false, dest + 8);
+				}
+				else
+					encodeColorBlock(pixels, true, dest);
+
+				dest += blocksize;
+			}
+		}
+	}
+
+	return encoded;
+}
+
 bool DDSHandler::canParseCompressed(Data *data)
 {
 	return dds::isCompressedDDS(data->getData(), data->getSize());
 }
 
-StrongRef<ByteData> DDSHandler::parseCompressed(Data *filedata, std::vector<StrongRef<CompressedSlice>> &images, PixelFormat &format)
+StrongRef<Data> DDSHandler::parseCompressed(Data *filedata, std::vector<StrongRef<CompressedSlice>> &images, PixelFormat &format)
 {
 	if (!dds::isCompressedDDS(filedata->getData(), filedata->getSize()))
 		throw love::Exception("Could not decode compressed data (not a DDS file?)");
 
 	PixelFormat texformat = PIXELFORMAT_UNKNOWN;
 
-	size_t dataSize = 0;
-
 	images.clear();
 
 	// Attempt to parse the dds file.
@@ -261,34 +609,23 @@ StrongRef<ByteData> DDSHandler::parseCompressed(Data *filedata, std::vector<Stro
 	if (parser.getMipmapCount() == 0)
 		throw love::Exception("Could not parse compressed data: No readable texture data.");
 
-	// Calculate the size of the block of memory we're returning.
-	for (size_t i = 0; i < parser.getMipmapCount(); i++)
-	{
-		const dds::Image *img = parser.getImageData(i);
-		dataSize += img->dataSize;
-	}
+	const uint8 *filebytes = (const uint8 *) filedata->getData();
 
-	StrongRef<ByteData> memory(new ByteData(dataSize, false), Acquire::NORETAIN);
-
-	size_t dataOffset = 0;
-
-	// Copy the parsed mipmap levels from the FileData to our CompressedImageData.
+	// The parsed mipmap levels point into the FileData, so they're used in
+	// place instead of being copied.
 	for (size_t i = 0; i < parser.getMipmapCount(); i++)
 	{
 		// Fetch the data for this mipmap level.
 		const dds::Image *img = parser.getImageData(i);
 
-		// Copy the mipmap image from the FileData to our block of memory.
-		memcpy((uint8 *) memory->getData() + dataOffset, img->data, img->dataSize);
+		size_t dataOffset = (size_t) (img->data - filebytes);
 
-		auto slice = new CompressedSlice(texformat, img->width, img->height, memory, dataOffset, img->dataSize);
+		auto slice = new CompressedSlice(texformat, img->width, img->height, filedata, dataOffset, img->dataSize);
 		images.emplace_back(slice, Acquire::NORETAIN);
-
-		dataOffset += img->dataSize;
 	}
 
 	format = texformat;
-	return memory;
+	return filedata;
 }
 
 } // magpie
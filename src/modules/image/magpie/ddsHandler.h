@@ -43,10 +43,14 @@ public:
 	virtual ~DDSHandler() {}
 
 	// Implements FormatHandler.
+	bool isThreadSafe() const override { return true; }
+
 	bool canDecode(Data *data) override;
 	DecodedImage decode(Data *data) override;
+	bool canEncodeCompressed(PixelFormat rawFormat, PixelFormat compressedFormat) override;
+	EncodedImage encodeCompressed(const std::vector<DecodedImage> &mipmaps, PixelFormat compressedFormat) override;
 	bool canParseCompressed(Data *data) override;
-	StrongRef<ByteData> parseCompressed(Data *filedata,
+	StrongRef<Data> parseCompressed(Data *filedata,
 	        std::vector<StrongRef<CompressedSlice>> &images,
 	        PixelFormat &format) override;
 
@@ -34,6 +34,19 @@ namespace image
 
 #define instance() (Module::getInstance<Image>(Module::M_IMAGE))
 
+static bool luax_checkdecoderegion(lua_State *L, int idx, FormatHandler::DecodeRegion &region)
+{
+	if (!lua_istable(L, idx))
+		return false;
+
+	region.x = luax_intflag(L, idx, "x", 0);
+	region.y = luax_intflag(L, idx, "y", 0);
+	region.width = luax_intflag(L, idx, "width", 0);
+	region.height = luax_intflag(L, idx, "height", 0);
+	region.mipmapLevel = luax_intflag(L, idx, "mipmaplevel", 0);
+	return true;
+}
+
 int w_newImageData(lua_State *L)
 {
 	// Case 1: width & height.
@@ -85,11 +98,14 @@ int w_newImageData(lua_State *L)
 	}
 	else if (filesystem::luax_cangetdata(L, 1)) // Case 2: File(Data).
 	{
+		FormatHandler::DecodeRegion region;
+		bool hasregion = luax_checkdecoderegion(L, 2, region);
+
 		Data *data = love::filesystem::luax_getdata(L, 1);
 
 		ImageData *t = nullptr;
 		luax_catchexcept(L,
-			[&]() { t = instance()->newImageData(data); },
+			[&]() { t = hasregion ? instance()->newImageData(data, region) : instance()->newImageData(data); },
 			[&](bool) { data->release(); }
 		);
 
@@ -103,8 +119,45 @@ int w_newImageData(lua_State *L)
 	}
 }
 
+int w_newImageDataAsync(lua_State *L)
+{
+	FormatHandler::DecodeRegion region;
+	bool hasregion = luax_checkdecoderegion(L, 2, region);
+
+	Data *data = love::filesystem::luax_getdata(L, 1);
+
+	ImageDataLoad *t = nullptr;
+	luax_catchexcept(L,
+		[&]() { t = hasregion ? instance()->newImageDataAsync(data, region) : instance()->newImageDataAsync(data); },
+		[&](bool) { data->release(); }
+	);
+
+	luax_pushtype(L, t);
+	t->release();
+	return 1;
+}
+
 int w_newCompressedData(lua_State *L)
 {
+	if (luax_istype(L, 1, ImageData::type))
+	{
+		ImageData *id = luax_checkimagedata(L, 1);
+
+		PixelFormat format = PIXELFORMAT_UNKNOWN;
+		const char *fmt = luaL_checkstring(L, 2);
+		if (!getConstant(fmt, format))
+			return luax_enumerror(L, "pixel format", fmt);
+
+		bool mipmaps = luax_optboolean(L, 3, true);
+
+		CompressedImageData *t = nullptr;
+		luax_catchexcept(L, [&]() { t = instance()->newCompressedData(id, format, mipmaps); });
+
+		luax_pushtype(L, CompressedImageData::type, t);
+		t->release();
+		return 1;
+	}
+
 	Data *data = love::filesystem::luax_getdata(L, 1);
 
 	CompressedImageData *t = nullptr;
@@ -128,6 +181,22 @@ int w_isCompressed(lua_State *L)
 	return 1;
 }
 
+int w_getImageDimensions(lua_State *L)
+{
+	Data *data = love::filesystem::luax_getdata(L, 1);
+
+	int w = 0;
+	int h = 0;
+	luax_catchexcept(L,
+		[&]() { ImageData::getEncodedDimensions(data, w, h); },
+		[&](bool) { data->release(); }
+	);
+
+	lua_pushinteger(L, w);
+	lua_pushinteger(L, h);
+	return 2;
+}
+
 int w_newCubeFaces(lua_State *L)
 {
 	ImageData *id = luax_checkimagedata(L, 1);
@@ -142,8 +211,10 @@ int w_newCubeFaces(lua_State *L)
 static const luaL_Reg functions[] =
 {
 	{ "newImageData",  w_newImageData },
+	{ "newImageDataAsync", w_newImageDataAsync },
 	{ "newCompressedData", w_newCompressedData },
 	{ "isCompressed", w_isCompressed },
+	{ "getImageDimensions", w_getImageDimensions },
 	{ "newCubeFaces", w_newCubeFaces },
 	{ 0, 0 }
 };
@@ -151,6 +222,8 @@ static const luaL_Reg functions[] =
 static const lua_CFunction types[] =
 {
 	luaopen_imagedata,
+	luaopen_imagedataencode,
+	luaopen_imagedataload,
 	luaopen_compressedimagedata,
 	0
 };
@@ -234,6 +234,96 @@ int w_ImageData_paste(lua_State *L)
 	return 0;
 }
 
+int w_ImageData_applyOperation(lua_State *L)
+{
+	ImageData *t = luax_checkimagedata(L, 1);
+
+	ImageData::PixelOperation op;
+	const char *opstr = luaL_checkstring(L, 2);
+	if (!ImageData::getConstant(opstr, op))
+		return luax_enumerror(L, "pixel operation", ImageData::getConstants(op), opstr);
+
+	ImageData::PixelOperationParams params;
+	int startidx = 4;
+
+	if (op == ImageData::PIXELOP_PREMULTIPLY || op == ImageData::PIXELOP_UNPREMULTIPLY
+		|| op == ImageData::PIXELOP_GAMMATOLINEAR || op == ImageData::PIXELOP_LINEARTOGAMMA)
+	{
+		// These don't take a value.
+		startidx = 3;
+	}
+	else if (op == ImageData::PIXELOP_THRESHOLD)
+		params.threshold = (float) luaL_checknumber(L, 3);
+	else if (op == ImageData::PIXELOP_SWIZZLE)
+	{
+		size_t len = 0;
+		const char *str = luaL_checklstring(L, 3, &len);
+		if (len != 4)
+			return luaL_argerror(L, 3, "swizzle must have exactly 4 components");
+
+		for (int i = 0; i < 4; i++)
+		{
+			switch (str[i])
+			{
+			case 'r': params.swizzle[i] = ImageData::SWIZZLE_R; break;
+			case 'g': params.swizzle[i] = ImageData::SWIZZLE_G; break;
+			case 'b': params.swizzle[i] = ImageData::SWIZZLE_B; break;
+			case 'a': params.swizzle[i] = ImageData::SWIZZLE_A; break;
+			case '0': params.swizzle[i] = ImageData::SWIZZLE_ZERO; break;
+			case '1': params.swizzle[i] = ImageData::SWIZZLE_ONE; break;
+			default:
+				return luaL_error(L, "Invalid swizzle component '%c' (expected r, g, b, a, 0 or 1.)", str[i]);
+			}
+		}
+	}
+	else
+	{
+		luaL_checktype(L, 3, LUA_TTABLE);
+		for (int i = 1; i <= 4; i++)
+			lua_rawgeti(L, 3, i);
+
+		params.color.r = (float) luaL_checknumber(L, -4);
+		params.color.g = (float) luaL_checknumber(L, -3);
+		params.color.b = (float) luaL_checknumber(L, -2);
+		params.color.a = (float) luaL_optnumber(L, -1, 1.0);
+		lua_pop(L, 4);
+	}
+
+	int x = (int) luaL_optinteger(L, startidx + 0, 0);
+	int y = (int) luaL_optinteger(L, startidx + 1, 0);
+	int w = (int) luaL_optinteger(L, startidx + 2, t->getWidth());
+	int h = (int) luaL_optinteger(L, startidx + 3, t->getHeight());
+
+	luax_catchexcept(L, [&](){ t->applyOperation(op, params, x, y, w, h); });
+	return 0;
+}
+
+int w_ImageData_blit(lua_State *L)
+{
+	ImageData *t = luax_checkimagedata(L, 1);
+	ImageData *src = luax_checkimagedata(L, 2);
+	int dx = (int) luaL_checkinteger(L, 3);
+	int dy = (int) luaL_checkinteger(L, 4);
+	int dw = (int) luaL_checkinteger(L, 5);
+	int dh = (int) luaL_checkinteger(L, 6);
+
+	ImageData::BlitFilter filter = ImageData::BLIT_LINEAR;
+	if (!lua_isnoneornil(L, 7))
+	{
+		const char *filterstr = luaL_checkstring(L, 7);
+		if (!ImageData::getConstant(filterstr, filter))
+			return luax_enumerror(L, "blit filter", ImageData::getConstants(filter), filterstr);
+	}
+
+	int sx = (int) luaL_optinteger(L, 8, 0);
+	int sy = (int) luaL_optinteger(L, 9, 0);
+	int sw = (int) luaL_optinteger(L, 10, src->getWidth());
+	int sh = (int) luaL_optinteger(L, 11, src->getHeight());
+
+	luax_catchexcept(L, [&](){ t->blit(src, dx, dy, dw, dh, sx, sy, sw, sh, filter); });
+	return 0;
+}
+
 int w_ImageData_encode(lua_State *L)
 {
 	ImageData *t = luax_checkimagedata(L, 1);
@@ -252,8 +342,59 @@ int w_ImageData_encode(lua_State *L)
 		filename = luax_checkstring(L, 3);
 	}
 
+	int level = (int) luaL_optinteger(L, 4, -1);
+
 	love::filesystem::FileData *filedata = nullptr;
-	luax_catchexcept(L, [&](){ filedata = t->encode(format, filename.c_str(), hasfilename); });
+	luax_catchexcept(L, [&](){ filedata = t->encode(format, filename.c_str(), hasfilename, level); });
+
+	luax_pushtype(L, filedata);
+	filedata->release();
+
+	return 1;
+}
+
+int w_ImageData_encodeAsync(lua_State *L)
+{
+	ImageData *t = luax_checkimagedata(L, 1);
+
+	FormatHandler::EncodedFormat format;
+	const char *fmt = luaL_checkstring(L, 2);
+	if (!ImageData::getConstant(fmt, format))
+		return luax_enumerror(L, "encoded image format", ImageData::getConstants(format), fmt);
+
+	bool hasfilename = false;
+
+	std::string filename = "Image." + std::string(fmt);
+	if (!lua_isnoneornil(L, 3))
+	{
+		hasfilename = true;
+		filename = luax_checkstring(L, 3);
+	}
+
+	int level = (int) luaL_optinteger(L, 4, -1);
+
+	ImageDataEncode *encode = nullptr;
+	luax_catchexcept(L, [&](){ encode = new ImageDataEncode(t, format, filename, hasfilename, level); });
+
+	luax_pushtype(L, encode);
+	encode->release();
+
+	return 1;
+}
+
+int w_ImageData_encodeCompressed(lua_State *L)
+{
+	ImageData *t = luax_checkimagedata(L, 1);
+
+	PixelFormat format = PIXELFORMAT_UNKNOWN;
+	const char *fmt = luaL_checkstring(L, 2);
+	if (!getConstant(fmt, format))
+		return luax_enumerror(L, "pixel format", fmt);
+
+	bool mipmaps = luax_optboolean(L, 3, true);
+
+	love::filesystem::FileData *filedata = nullptr;
+	luax_catchexcept(L, [&](){ filedata = t->encodeCompressed(format, mipmaps, "Image.dds"); });
 
 	luax_pushtype(L, filedata);
 	filedata->release();
@@ -297,7 +438,11 @@ static const luaL_Reg w_ImageData_functions[] =
 	{ "setPixel", w_ImageData_setPixel },
 	{ "paste", w_ImageData_paste },
 	{ "mapPixel", w_ImageData_mapPixel },
+	{ "applyOperation", w_ImageData_applyOperation },
+	{ "blit", w_ImageData_blit },
 	{ "encode", w_ImageData_encode },
+	{ "encodeAsync", w_ImageData_encodeAsync },
+	{ "encodeCompressed", w_ImageData_encodeCompressed },
 	{ 0, 0 }
 };
 
@@ -311,5 +456,71 @@ extern "C" int luaopen_imagedata(lua_State *L)
 	return ret;
 }
 
+static ImageDataEncode *luax_checkimagedataencode(lua_State *L, int idx)
+{
+	return luax_checktype<ImageDataEncode>(L, idx);
+}
+
+int w_ImageDataEncode_isComplete(lua_State *L)
+{
+	ImageDataEncode *encode = luax_checkimagedataencode(L, 1);
+	luax_pushboolean(L, encode->isComplete());
+	return 1;
+}
+
+int w_ImageDataEncode_getFileData(lua_State *L)
+{
+	ImageDataEncode *encode = luax_checkimagedataencode(L, 1);
+	love::filesystem::FileData *filedata = nullptr;
+	luax_catchexcept(L, [&](){ filedata = encode->getFileData(); });
+	luax_pushtype(L, filedata);
+	return 1;
+}
+
+static const luaL_Reg w_ImageDataEncode_functions[] =
+{
+	{ "isComplete", w_ImageDataEncode_isComplete },
+	{ "getFileData", w_ImageDataEncode_getFileData },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_imagedataencode(lua_State *L)
+{
+	return luax_register_type(L, &ImageDataEncode::type, w_ImageDataEncode_functions, nullptr);
+}
+
+static ImageDataLoad *luax_checkimagedataload(lua_State *L, int idx)
+{
+	return luax_checktype<ImageDataLoad>(L, idx);
+}
+
+int w_ImageDataLoad_isComplete(lua_State *L)
+{
+	ImageDataLoad *load = luax_checkimagedataload(L, 1);
+	luax_pushboolean(L, load->isComplete());
+	return 1;
+}
+
+int w_ImageDataLoad_getImageData(lua_State *L)
+{
+	ImageDataLoad *load = luax_checkimagedataload(L, 1);
+	ImageData *imagedata = nullptr;
+	luax_catchexcept(L, [&](){ imagedata = load->getImageData(); });
+	luax_pushtype(L, imagedata);
+	return 1;
+}
+
+static const luaL_Reg w_ImageDataLoad_functions[] =
+{
+	{ "isComplete", w_ImageDataLoad_isComplete },
+	{ "getImageData", w_ImageDataLoad_getImageData },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_imagedataload(lua_State *L)
+{
+	return luax_register_type(L, &ImageDataLoad::type, w_ImageDataLoad_functions, nullptr);
+}
+
 } // image
 } // love
@@ -24,6 +24,8 @@
 // LOVE
 #include "common/runtime.h"
 #include "ImageData.h"
+#include "ImageDataEncode.h"
+#include "ImageDataLoad.h"
 
 namespace love
 {
@@ -32,6 +34,8 @@ namespace image
 
 ImageData *luax_checkimagedata(lua_State *L, int idx);
 extern "C" int luaopen_imagedata(lua_State *L);
+extern "C" int luaopen_imagedataencode(lua_State *L);
+extern "C" int luaopen_imagedataload(lua_State *L);
 
 } // image
 } // love
@@ -22,7 +22,7 @@ misrepresented as being the original software.
 3. This notice may not be removed or altered from any source distribution.
 --]]
 
-local ImageData_mt, ffifuncspointer_str = ...
+local ImageData_mt, ffifuncspointer_str, ffiwrapper = ...
 local ImageData = ImageData_mt.__index
 
 local tonumber, assert, error = tonumber, assert, error
@@ -41,20 +41,14 @@ end
 -- Everything below this point is efficient FFI replacements for existing
 -- ImageData functionality.
 
-if type(jit) ~= "table" or not jit.status() then
-	-- LuaJIT's FFI is *much* slower than LOVE's regular methods when the JIT
-	-- compiler is disabled.
-	return
-end
+if ffiwrapper == nil or not ffiwrapper.isjitenabled() then return end
 
-local status, ffi = pcall(require, "ffi")
-if not status then return end
+local ffi = ffiwrapper.ffi
 
 local bitstatus, bit = pcall(require, "bit")
 if not bitstatus then return end
 
-pcall(ffi.cdef, [[
-typedef struct Proxy Proxy;
+local ffifuncs = ffiwrapper.getfuncs("FFI_ImageData", [[
 typedef uint16_t float16;
 typedef uint16_t float11;
 typedef uint16_t float10;
@@ -92,9 +86,7 @@ struct ImageData_Pixel_RGB5A1 { uint16_t rgba; };
 struct ImageData_Pixel_RGB565 { uint16_t rgb; };
 struct ImageData_Pixel_RGB10A2 { uint32_t rgba; };
 struct ImageData_Pixel_RG11B10F { uint32_t rgb; };
-]])
-
-local ffifuncs = ffi.cast("FFI_ImageData **", ffifuncspointer_str)[0]
+]], ffifuncspointer_str)
 
 local conversions = {
 	r8 = {
@@ -171,6 +171,19 @@ public:
 		};
 	};
 
+	// The values of all inputs at one point in time. The vectors are resized
+	// in place, so a State can be reused without allocating every frame.
+	struct State
+	{
+		std::vector<float> axes;
+		std::vector<bool> buttons;
+		std::vector<Hat> hats;
+
+		bool gamepad = false;
+		float gamepadAxes[GAMEPAD_AXIS_MAX_ENUM];
+		bool gamepadButtons[GAMEPAD_BUTTON_MAX_ENUM];
+	};
+
 	virtual ~Joystick() {}
 
 	virtual bool open(int64 deviceid) = 0;
@@ -192,6 +205,8 @@ public:
 
 	virtual bool isDown(const std::vector<int> &buttonlist) const = 0;
 
+	virtual void getState(State &state) const = 0;
+
 	virtual void setPlayerIndex(int index) = 0;
 	virtual int getPlayerIndex() const = 0;
 
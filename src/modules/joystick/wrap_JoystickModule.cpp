@@ -48,6 +48,134 @@ int w_getJoysticks(lua_State *L)
 	return 1;
 }
 
+// Pushes t[key] if it's a table, otherwise puts a new table there and pushes it.
+static void pushSubtable(lua_State *L, int tidx, const char *key, int narr, int nrec)
+{
+	lua_getfield(L, tidx, key);
+	if (!lua_istable(L, -1))
+	{
+		lua_pop(L, 1);
+		lua_createtable(L, narr, nrec);
+		lua_pushvalue(L, -1);
+		lua_setfield(L, tidx, key);
+	}
+}
+
+// Removes array entries past count, left over from a previous call.
+static void truncateArray(lua_State *L, int idx, int count)
+{
+	for (int i = (int) luax_objlen(L, idx); i > count; i--)
+	{
+		lua_pushnil(L);
+		lua_rawseti(L, idx, i);
+	}
+}
+
+int w_getStates(lua_State *L)
+{
+	// Reused between calls, so reading the states doesn't allocate once the
+	// vectors have grown to fit.
+	static Joystick::State state;
+
+	int stickcount = instance()->getJoystickCount();
+
+	if (lua_istable(L, 1))
+		lua_pushvalue(L, 1);
+	else
+		lua_createtable(L, stickcount, 0);
+
+	int tidx = lua_gettop(L);
+
+	for (int i = 0; i < stickcount; i++)
+	{
+		Joystick *stick = instance()->getJoystick(i);
+		stick->getState(state);
+
+		lua_rawgeti(L, tidx, i + 1);
+		if (!lua_istable(L, -1))
+		{
+			lua_pop(L, 1);
+			lua_createtable(L, 0, 6);
+			lua_pushvalue(L, -1);
+			lua_rawseti(L, tidx, i + 1);
+		}
+
+		int sidx = lua_gettop(L);
+
+		luax_pushtype(L, stick);
+		lua_setfield(L, sidx, "joystick");
+
+		int count = (int) state.axes.size();
+		pushSubtable(L, sidx, "axes", count, 0);
+		for (int j = 0; j < count; j++)
+		{
+			lua_pushnumber(L, state.axes[j]);
+			lua_rawseti(L, -2, j + 1);
+		}
+		truncateArray(L, lua_gettop(L), count);
+		lua_pop(L, 1);
+
+		count = (int) state.buttons.size();
+		pushSubtable(L, sidx, "buttons", count, 0);
+		for (int j = 0; j < count; j++)
+		{
+			luax_pushboolean(L, state.buttons[j]);
+			lua_rawseti(L, -2, j + 1);
+		}
+		truncateArray(L, lua_gettop(L), count);
+		lua_pop(L, 1);
+
+		count = (int) state.hats.size();
+		pushSubtable(L, sidx, "hats", count, 0);
+		for (int j = 0; j < count; j++)
+		{
+			const char *str = "c";
+			Joystick::getConstant(state.hats[j], str);
+			lua_pushstring(L, str);
+			lua_rawseti(L, -2, j + 1);
+		}
+		truncateArray(L, lua_gettop(L), count);
+		lua_pop(L, 1);
+
+		if (state.gamepad)
+		{
+			pushSubtable(L, sidx, "gamepadaxes", 0, Joystick::GAMEPAD_AXIS_MAX_ENUM);
+			for (int j = 0; j < Joystick::GAMEPAD_AXIS_MAX_ENUM; j++)
+			{
+				const char *name = nullptr;
+				if (!Joystick::getConstant((Joystick::GamepadAxis) j, name))
+					continue;
+				lua_pushnumber(L, state.gamepadAxes[j]);
+				lua_setfield(L, -2, name);
+			}
+			lua_pop(L, 1);
+
+			pushSubtable(L, sidx, "gamepadbuttons", 0, Joystick::GAMEPAD_BUTTON_MAX_ENUM);
+			for (int j = 0; j < Joystick::GAMEPAD_BUTTON_MAX_ENUM; j++)
+			{
+				const char *name = nullptr;
+				if (!Joystick::getConstant((Joystick::GamepadButton) j, name))
+					continue;
+				luax_pushboolean(L, state.gamepadButtons[j]);
+				lua_setfield(L, -2, name);
+			}
+			lua_pop(L, 1);
+		}
+		else
+		{
+			lua_pushnil(L);
+			lua_setfield(L, sidx, "gamepadaxes");
+			lua_pushnil(L);
+			lua_setfield(L, sidx, "gamepadbuttons");
+		}
+
+		lua_pop(L, 1);
+	}
+
+	truncateArray(L, tidx, stickcount);
+	return 1;
+}
+
 int w_getIndex(lua_State *L)
 {
 	Joystick *j = luax_checkjoystick(L, 1);
@@ -176,6 +304,7 @@ static const luaL_Reg functions[] =
 {
 	{ "getJoysticks", w_getJoysticks },
 	{ "getJoystickCount", w_getJoystickCount },
+	{ "getStates", w_getStates },
 	{ "setGamepadMapping", w_setGamepadMapping },
 	{ "loadGamepadMappings", w_loadGamepadMappings },
 	{ "saveGamepadMappings", w_saveGamepadMappings },
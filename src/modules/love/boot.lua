@@ -39,8 +39,112 @@ local no_game_code = false
 local invalid_game_path = nil
 local main_file = "main.lua"
 
+-----------------------------------------------------------
+-- Startup timing.
+-----------------------------------------------------------
+
+local startuptimings = {}
+local phasestart = 0
+local phaseluamemory = 0
+local phasememory = nil
+
+local function beginphase()
+	phasestart = love._getTime()
+	phaseluamemory = collectgarbage("count") * 1024
+	phasememory = love._getMemoryUsage()
+end
+
+local function endphase(name)
+	local t = love._getTime()
+	local luamemory = collectgarbage("count") * 1024
+	local memory = love._getMemoryUsage()
+	table.insert(startuptimings, {
+		name = name,
+		time = t - phasestart,
+		luamemory = luamemory - phaseluamemory,
+		memory = (memory and phasememory) and (memory - phasememory) or nil,
+	})
+	phasestart = t
+	phaseluamemory = luamemory
+	phasememory = memory
+end
+
+-- Returns a list of {name=phase, time=seconds, luamemory=bytes, memory=bytes}
+-- tables, in the order the phases happened. The memory fields are the change
+-- in Lua heap size and process resident memory during the phase (memory is nil
+-- if the OS can't report it). Modules loaded lazily are added when they're
+-- loaded.
+function love.getStartupTimings()
+	local timings = {}
+	for i, v in ipairs(startuptimings) do
+		timings[i] = {name = v.name, time = v.time, luamemory = v.luamemory, memory = v.memory}
+	end
+	return timings
+end
+
+local function formatbytes(bytes)
+	if bytes == nil then
+		return "n/a"
+	end
+	return string.format("%+.2f MB", bytes / (1024 * 1024))
+end
+
+-- Returns the startup timings formatted as a human-readable table.
+function love.getStartupReport()
+	local lines = {
+		string.format("%-24s %10s %12s %12s", "phase", "time", "lua memory", "memory"),
+	}
+	local totaltime, totalluamemory, totalmemory = 0, 0, 0
+	for i, v in ipairs(startuptimings) do
+		table.insert(lines, string.format("%-24s %8.2fms %12s %12s", v.name, v.time * 1000,
+			formatbytes(v.luamemory), formatbytes(v.memory)))
+		totaltime = totaltime + v.time
+		totalluamemory = totalluamemory + v.luamemory
+		totalmemory = v.memory and totalmemory and (totalmemory + v.memory) or nil
+	end
+	table.insert(lines, string.format("%-24s %8.2fms %12s %12s", "total", totaltime * 1000,
+		formatbytes(totalluamemory), formatbytes(totalmemory)))
+	return table.concat(lines, "\n")
+end
+
+-----------------------------------------------------------
+-- Lazy module loading.
+-----------------------------------------------------------
+
+local lazymodules = {}
+
+-- Modules which must be loaded along with others, because the other module
+-- uses them from C++ where a lazy load can't be triggered.
+local lazydependencies = {
+	graphics = {"font"},
+}
+
+local function loadmodule(name)
+	beginphase()
+	require("love." .. name)
+	endphase("love." .. name)
+end
+
+local function loadlazymodule(name)
+	lazymodules[name] = nil
+	if next(lazymodules) == nil then
+		setmetatable(love, nil)
+	end
+	loadmodule(name)
+end
+
+local lazymt = {
+	__index = function(t, k)
+		if lazymodules[k] then
+			loadlazymodule(k)
+			return rawget(t, k)
+		end
+	end,
+}
+
 -- This can't be overridden.
 function love.boot()
+	beginphase()
 
 	-- This is absolutely needed.
 	require("love.filesystem")
@@ -50,6 +154,8 @@ function love.boot()
 	local arg0 = love.arg.getLow(love.rawGameArguments)
 	love.filesystem.init(arg0)
 
+	endphase("love.filesystem")
+
 	local exepath = love.filesystem.getExecutablePath()
 	if #exepath == 0 then
 		-- This shouldn't happen, but just in case we'll fall back to arg0.
@@ -134,6 +240,8 @@ function love.boot()
 		no_game_code = true
 	end
 
+	endphase("filesystem mount")
+
 	if not can_has_game then
         -- when editing this message, change it at love.cpp too
         print([[LOVE is an *awesome* framework you can use to make 2D games in Lua
@@ -170,6 +278,7 @@ function love.init()
 			fullscreentype = "desktop",
 			displayindex = 1,
 			vsync = 1,
+			presentmode = nil, -- overrides vsync if supported, e.g. "mailbox"
 			msaa = 0,
 			borderless = false,
 			resizable = false,
@@ -200,18 +309,28 @@ function love.init()
 		audio = {
 			mixwithsystem = true, -- Only relevant for Android / iOS.
 			mic = false, -- Only relevant for Android.
+			lowlatency = false,
+			periodsize = nil, -- Sample frames per mixing period when lowlatency is enabled.
 		},
+		threadaffinity = nil, -- Cores (starting at 1) that threads created by LOVE and love.thread run on.
+		headless = false, -- Run without a window, graphics or audio, e.g. for dedicated servers.
+		tickrate = 60, -- Updates per second of love.run's fixed tick loop in headless mode.
 		console = false, -- Only relevant for windows.
 		identity = false,
 		appendidentity = false,
 		externalstorage = false, -- Only relevant for Android.
+		profilestartup = false, -- Print and save a report of startup time and memory use.
+		bytecodecache = false, -- Cache compiled Lua files in the save directory.
 		accelerometerjoystick = nil, -- Only relevant for Android / iOS, deprecated.
 		gammacorrect = false,
 		highdpi = false,
 		renderers = nil,
 		excluderenderers = nil,
+		framesinflight = 2, -- Frames the CPU can record ahead of the GPU: 2 for lower latency, 3 for throughput. Only used by Vulkan.
 	}
 
+	beginphase()
+
 	-- Console hack, part 1.
 	local openedconsole = false
 	if love.arg.options.console.set and love._openConsole then
@@ -233,6 +352,29 @@ function love.init()
 		-- the error message can be displayed in the window.
 	end
 
+	-- Headless mode doesn't initialize anything which needs a display or an
+	-- audio device. It can also be forced from the command line.
+	if love.arg.options.headless.set then
+		c.headless = true
+	end
+
+	if love.arg.options["profile-startup"].set then
+		c.profilestartup = true
+	end
+
+	if c.headless then
+		c.window = false
+		for i,v in ipairs{
+			"window", "graphics", "font", "video", "audio",
+			"joystick", "keyboard", "mouse", "touch", "sensor",
+		} do
+			c.modules[v] = false
+		end
+		love.headless = true
+	end
+
+	endphase("conf")
+
 	-- Console hack, part 2.
 	if c.console and love._openConsole and not openedconsole then
 		love._openConsole()
@@ -286,6 +428,10 @@ function love.init()
 		love._setRenderers(renderers)
 	end
 
+	if love._setFramesInFlight and type(c.framesinflight) == "number" then
+		love._setFramesInFlight(c.framesinflight)
+	end
+
 	if love._setHighDPIAllowed then
 		love._setHighDPIAllowed(c.highdpi)
 	end
@@ -300,7 +446,34 @@ function love.init()
 		love._requestRecordingPermission(c.audio and c.audio.mic)
 	end
 
-	-- Gets desired modules.
+	if love._setAudioLowLatency and c.audio then
+		love._setAudioLowLatency(c.audio.lowlatency, c.audio.periodsize)
+	end
+
+	-- Must be set before any module starts its own threads.
+	if c.threadaffinity and c.modules.thread then
+		require("love.thread").setDefaultAffinity(c.threadaffinity)
+	end
+
+	-- Gets desired modules. Modules set to "lazy" are loaded the first time
+	-- love.<module> is accessed instead. Note that joystick, sensor and touch
+	-- events aren't received until their module is loaded, and audio devices
+	-- aren't opened until love.audio is used.
+	local lazy = {}
+	for k,v in pairs(c.modules) do
+		if v == "lazy" then
+			lazy[k] = true
+		end
+	end
+
+	for k,v in pairs(lazydependencies) do
+		if c.modules[k] and not lazy[k] then
+			for i,dep in ipairs(v) do
+				lazy[dep] = nil
+			end
+		end
+	end
+
 	for k,v in ipairs{
 		"data",
 		"thread",
@@ -322,11 +495,20 @@ function love.init()
 		"math",
 		"physics",
 	} do
-		if c.modules[v] then
-			require("love." .. v)
+		if lazy[v] then
+			-- It might have been required already, e.g. for threadaffinity.
+			if rawget(love, v) == nil then
+				lazymodules[v] = true
+			end
+		elseif c.modules[v] then
+			loadmodule(v)
 		end
 	end
 
+	if next(lazymodules) ~= nil then
+		setmetatable(love, lazymt)
+	end
+
 	if love.event then
 		love.createhandlers()
 	end
@@ -352,6 +534,7 @@ function love.init()
 	end
 
 	-- Setup window here.
+	beginphase()
 	if c.window and c.modules.window then
 		love.window.setTitle(c.window.title or c.title)
 		assert(love.window.setMode(c.window.width, c.window.height,
@@ -374,12 +557,29 @@ function love.init()
 			x = c.window.x,
 			y = c.window.y,
 		}), "Could not set window mode")
+		if c.window.presentmode then
+			-- Unsupported modes keep the mode picked from vsync.
+			love.window.setPresentMode(c.window.presentmode)
+		end
 		if c.window.icon then
 			assert(love.image, "If an icon is set in love.conf, love.image must be loaded!")
 			love.window.setIcon(love.image.newImageData(c.window.icon))
 		end
 	end
 
+	endphase("window")
+
+	-- Compiling the standard shaders happens during window creation, but it's
+	-- reported separately since it's often the biggest part of it.
+	if love.graphics and love.graphics._getDefaultShaderCompileTime then
+		local shadertime = love.graphics._getDefaultShaderCompileTime()
+		local window = startuptimings[#startuptimings]
+		if shadertime > 0 and shadertime <= window.time then
+			window.time = window.time - shadertime
+			table.insert(startuptimings, {name = "default shaders", time = shadertime, luamemory = 0, memory = 0})
+		end
+	end
+
 	-- The first couple event pumps on some systems (e.g. macOS) can take a
 	-- while. We'd rather hit that slowdown here than in event processing
 	-- within the first frames.
@@ -387,6 +587,14 @@ function love.init()
 		for i = 1, 2 do love.event.pump() end
 	end
 
+	if c.headless and love.timer then
+		local tickrate = tonumber(c.tickrate) or 60
+		if tickrate <= 0 then
+			error("love.conf's tickrate must be a positive number.")
+		end
+		love.timer.setFrameRateLimit(tickrate)
+	end
+
 	-- Our first timestep, because window creation can take some time
 	if love.timer then
 		love.timer.step()
@@ -395,8 +603,19 @@ function love.init()
 	if love.filesystem then
 		love.filesystem._setAndroidSaveExternal(c.externalstorage)
 		love.filesystem.setIdentity(c.identity or love.filesystem.getIdentity(), c.appendidentity)
+		love.filesystem.setBytecodeCacheEnabled(c.bytecodecache == true)
 		if love.filesystem.getInfo(main_file) then
+			beginphase()
 			require(main_file:gsub("%.lua$", ""))
+			endphase(main_file)
+		end
+	end
+
+	if c.profilestartup then
+		local report = love.getStartupReport()
+		print(report)
+		if love.filesystem then
+			pcall(love.filesystem.write, "startupreport.txt", report .. "\n")
 		end
 	end
 
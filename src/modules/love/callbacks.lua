@@ -115,6 +115,9 @@ function love.createhandlers()
 		directorydropped = function (dir)
 			if love.directorydropped then return love.directorydropped(dir) end
 		end,
+		filechanged = function (path, action)
+			if love.filechanged then return love.filechanged(path, action) end
+		end,
 		lowmemory = function ()
 			if love.lowmemory then love.lowmemory() end
 			collectgarbage()
@@ -146,43 +149,114 @@ end
 -- Default callbacks.
 -----------------------------------------------------------
 
+-- Headless mode (t.headless in love.conf) calls love.update at a fixed rate
+-- with a constant dt, and never draws.
+local function runheadless()
+	if love.load then love.load(love.parsedGameArguments, love.rawGameArguments) end
+
+	if love.timer then love.timer.step() end
+
+	local tickrate = love.timer and love.timer.getFrameRateLimit() or 0
+	local tick = tickrate > 0 and 1 / tickrate or 0
+
+	-- How far the ticks are behind real time, in seconds.
+	local lag = 0
+
+	-- After a long stall, drop the backlog instead of spending many ticks
+	-- catching up.
+	local maxticks = 5
+
+	return function()
+		if love.event then
+			love.event.pump()
+			for name, a,b,c,d,e,f in love.event.poll() do
+				if name == "quit" then
+					if not love.quit or not love.quit() then
+						return a or 0, b
+					end
+				end
+				love.handlers[name](a,b,c,d,e,f)
+			end
+		end
+
+		local dt = love.timer and love.timer.step() or 0
+
+		if tick > 0 then
+			lag = lag + dt
+			local ticks = 0
+			-- The small tolerance avoids alternating between 0 and 2 ticks
+			-- when frames are paced at almost exactly the tick rate.
+			while lag >= tick * 0.95 and ticks < maxticks do
+				if love.update then love.update(tick) end
+				lag = lag - tick
+				ticks = ticks + 1
+			end
+			if ticks == maxticks then
+				lag = 0
+			end
+		elseif love.update then
+			love.update(dt)
+		end
+
+		if love.timer then love.timer.waitForNextFrame() end
+	end
+end
+
 function love.run()
+	if love.headless then
+		return runheadless()
+	end
+
 	if love.load then love.load(love.parsedGameArguments, love.rawGameArguments) end
 
 	-- We don't want the first frame's dt to include time taken by love.load.
 	if love.timer then love.timer.step() end
 
+	-- Profiler zones are no-ops unless love.timer.setProfilingEnabled is used.
+	local beginzone = love.timer and love.timer.beginZone or function() end
+	local endzone = love.timer and love.timer.endZone or function() end
+
 	-- Main loop time.
 	return function()
 		-- Process events.
 		if love.event then
+			beginzone("love.event")
 			love.event.pump()
 			for name, a,b,c,d,e,f in love.event.poll() do
 				if name == "quit" then
 					if not love.quit or not love.quit() then
+						endzone()
 						return a or 0, b
 					end
 				end
 				love.handlers[name](a,b,c,d,e,f)
 			end
+			endzone()
 		end
 
 		-- Update dt, as we'll be passing it to update
 		local dt = love.timer and love.timer.step() or 0
 
 		-- Call update and draw
-		if love.update then love.update(dt) end -- will pass 0 if love.timer is disabled
+		if love.update then
+			beginzone("love.update")
+			love.update(dt) -- will pass 0 if love.timer is disabled
+			endzone()
+		end
 
 		if love.graphics and love.graphics.isActive() then
+			beginzone("love.draw")
 			love.graphics.origin()
 			love.graphics.clear(love.graphics.getBackgroundColor())
 
 			if love.draw then love.draw() end
+			endzone()
 
 			love.graphics.present()
 		end
 
-		if love.timer then love.timer.sleep(0.001) end
+		-- Sleeps for 1ms, or until the next frame if a frame rate limit is set.
+		if love.timer then love.timer.waitForNextFrame() end
 	end
 end
 
@@ -214,8 +288,8 @@ function love.errhand(msg)
 		end
 	end
 
-	-- Reset state.
-	if love.mouse then
+	-- Reset state. rawget avoids loading lazy modules just to reset them.
+	if rawget(love, "mouse") then
 		love.mouse.setVisible(true)
 		love.mouse.setGrabbed(false)
 		love.mouse.setRelativeMode(false)
@@ -223,13 +297,13 @@ function love.errhand(msg)
 			love.mouse.setCursor()
 		end
 	end
-	if love.joystick then
+	if rawget(love, "joystick") then
 		-- Stop all joystick vibrations.
 		for i,v in ipairs(love.joystick.getJoysticks()) do
 			v:setVibration()
 		end
 	end
-	if love.audio then love.audio.stop() end
+	if rawget(love, "audio") then love.audio.stop() end
 
 	love.graphics.reset()
 	love.graphics.setFont(love.graphics.newFont(15))
@@ -30,10 +30,17 @@
 // C++
 #include <string>
 #include <sstream>
+#include <chrono>
 
 #ifdef LOVE_WINDOWS
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
+#include <psapi.h>
+#elif defined(LOVE_MACOS) || defined(LOVE_IOS)
+#include <mach/mach.h>
+#elif defined(LOVE_LINUX) || defined(LOVE_ANDROID)
+#include <cstdio>
+#include <unistd.h>
 #endif // LOVE_WINDOWS
 
 #ifdef LOVE_ANDROID
@@ -300,6 +307,51 @@ const char *love_codename()
 	return love::VERSION_CODENAME;
 }
 
+// Seconds since the first call. Used by boot.lua to time startup phases
+// before love.timer is loaded (or when it's disabled.)
+static int w__getTime(lua_State *L)
+{
+	using clock = std::chrono::steady_clock;
+	static const clock::time_point start = clock::now();
+	std::chrono::duration<double> elapsed = clock::now() - start;
+	lua_pushnumber(L, elapsed.count());
+	return 1;
+}
+
+// Resident memory of the process in bytes, or nil if it can't be determined.
+// Used by boot.lua's startup profiler.
+static int w__getMemoryUsage(lua_State *L)
+{
+	double bytes = -1.0;
+
+#if defined(LOVE_WINDOWS)
+	PROCESS_MEMORY_COUNTERS counters = {};
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		bytes = (double) counters.WorkingSetSize;
+#elif defined(LOVE_MACOS) || defined(LOVE_IOS)
+	mach_task_basic_info_data_t info = {};
+	mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+	if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t) &info, &count) == KERN_SUCCESS)
+		bytes = (double) info.resident_size;
+#elif defined(LOVE_LINUX) || defined(LOVE_ANDROID)
+	FILE *file = fopen("/proc/self/statm", "r");
+	if (file != nullptr)
+	{
+		long pages = 0;
+		long resident = 0;
+		if (fscanf(file, "%ld %ld", &pages, &resident) == 2)
+			bytes = (double) resident * (double) sysconf(_SC_PAGESIZE);
+		fclose(file);
+	}
+#endif
+
+	if (bytes < 0.0)
+		lua_pushnil(L);
+	else
+		lua_pushnumber(L, bytes);
+	return 1;
+}
+
 static int w_love_getVersion(lua_State *L)
 {
 	lua_pushinteger(L, love::VERSION_MAJOR);
@@ -431,6 +483,14 @@ static int w__setRenderers(lua_State *L)
 	return 0;
 }
 
+static int w__setFramesInFlight(lua_State *L)
+{
+#ifdef LOVE_ENABLE_GRAPHICS
+	love::graphics::setFramesInFlight((int) luaL_checkinteger(L, 1));
+#endif
+	return 0;
+}
+
 static int w__setHighDPIAllowed(lua_State *L)
 {
 #ifdef LOVE_ENABLE_WINDOW
@@ -460,6 +520,15 @@ static int w__requestRecordingPermission(lua_State *L)
 	return 0;
 }
 
+static int w__setAudioLowLatency(lua_State *L)
+{
+#ifdef LOVE_ENABLE_AUDIO
+	int periodsize = (int) luaL_optinteger(L, 2, 0);
+	love::audio::setRequestLowLatency((bool) lua_toboolean(L, 1), periodsize);
+#endif
+	return 0;
+}
+
 static int w_love_markDeprecated(lua_State *L)
 {
 	int level = (int)luaL_checkinteger(L, 1);
@@ -560,6 +629,12 @@ int luaopen_love(lua_State *L)
 	lua_pushcfunction(L, w__setGammaCorrect);
 	lua_setfield(L, -2, "_setGammaCorrect");
 
+	lua_pushcfunction(L, w__getTime);
+	lua_setfield(L, -2, "_getTime");
+
+	lua_pushcfunction(L, w__getMemoryUsage);
+	lua_setfield(L, -2, "_getMemoryUsage");
+
 	lua_pushcfunction(L, w__getDefaultRenderers);
 	lua_setfield(L, -2, "_getDefaultRenderers");
 
@@ -569,6 +644,9 @@ int luaopen_love(lua_State *L)
 	lua_pushcfunction(L, w__setRenderers);
 	lua_setfield(L, -2, "_setRenderers");
 
+	lua_pushcfunction(L, w__setFramesInFlight);
+	lua_setfield(L, -2, "_setFramesInFlight");
+
 	lua_pushcfunction(L, w__setHighDPIAllowed);
 	lua_setfield(L, -2, "_setHighDPIAllowed");
 
@@ -578,6 +656,8 @@ int luaopen_love(lua_State *L)
 	lua_setfield(L, -2, "_setAudioMixWithSystem");
 	lua_pushcfunction(L, w__requestRecordingPermission);
 	lua_setfield(L, -2, "_requestRecordingPermission");
+	lua_pushcfunction(L, w__setAudioLowLatency);
+	lua_setfield(L, -2, "_setAudioLowLatency");
 
 	lua_newtable(L);
 
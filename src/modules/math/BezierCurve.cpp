@@ -31,15 +31,19 @@ namespace
 {
 
 /**
- * Subdivide Bezier polygon.
+ * Subdivide Bezier polygon k times, writing the resulting polygon chain to
+ * points. The scratch vector is reused between levels to avoid allocations.
  **/
-void subdivide(vector<love::Vector2> &points, int k)
+void subdivide(const vector<love::Vector2> &controlPoints, int k, vector<love::Vector2> &points, vector<love::Vector2> &scratch)
 {
+	points.assign(controlPoints.begin(), controlPoints.end());
 	if (k <= 0)
 		return;
 
-	// subdivision using de casteljau - subdivided control polygons are
-	// on the 'edges' of the computation scheme, e.g:
+	// Each level splits every sub-curve in two using de casteljau. The
+	// sub-curves' control polygons are stored back to back, sharing their
+	// end points. The subdivided control polygons are on the 'edges' of the
+	// computation scheme, e.g:
 	//
 	// ------LEFT------->
 	// b00  b10  b20  b30
@@ -50,33 +54,54 @@ void subdivide(vector<love::Vector2> &points, int k)
 	//
 	// the subdivided control polygon is:
 	// b00, b10, b20, b30, b21, b12, b03
-	vector<love::Vector2> left, right;
-	left.reserve(points.size());
-	right.reserve(points.size());
+	size_t n = controlPoints.size() - 1;
 
-	for (size_t step = 1; step < points.size(); ++step)
+	for (int level = 0; level < k; level++)
 	{
-		left.push_back(points[0]);
-		right.push_back(points[points.size() - step]);
-		for (size_t i = 0; i < points.size() - step; ++i)
-			points[i] = (points[i] + points[i+1]) * .5;
+		size_t curves = (points.size() - 1) / n;
+		scratch.resize(curves * 2 * n + 1);
+
+		for (size_t c = 0; c < curves; c++)
+		{
+			// The right polygon is computed in place: after each step, the
+			// last point that's still being reduced is part of it.
+			love::Vector2 *left = &scratch[c * 2 * n];
+			love::Vector2 *right = left + n;
+			std::copy(points.begin() + c * n, points.begin() + c * n + n + 1, right);
+
+			for (size_t step = 1; step <= n; ++step)
+			{
+				left[step - 1] = right[0];
+				for (size_t i = 0; i <= n - step; ++i)
+					right[i] = (right[i] + right[i+1]) * .5;
+			}
+		}
+
+		std::swap(points, scratch);
 	}
-	left.push_back(points[0]);
-	right.push_back(points[0]);
-
-	// recurse
-	subdivide(left, k-1);
-	subdivide(right, k-1);
-
-	// merge (right is in reversed order)
-	// By this point the 'left' array has a point at the end that's collinear
-	// with other points. It's still needed for the subdivide calls above but we
-	// can get rid of it here.
-	points.resize(left.size() + right.size() - 2);
-	for (size_t i = 0; i < left.size() - 1; ++i)
-		points[i] = left[i];
-	for (size_t i = 1; i < right.size(); ++i)
-		points[i-1 + left.size() - 1] = right[right.size() - i - 1];
+
+	// The points shared by neighbouring sub-curves lie on the curve, but
+	// they're dropped since they're collinear with their neighbours.
+	size_t curves = (points.size() - 1) / n;
+	size_t dst = n;
+	for (size_t c = 1; c < curves; c++)
+	{
+		for (size_t i = 1; i < n; i++)
+			points[dst++] = points[c * n + i];
+	}
+	points[dst++] = points[curves * n];
+	points.resize(dst);
+}
+
+// Evaluates a curve at t with de casteljau, using work as temporary storage.
+love::Vector2 evaluatePoint(const vector<love::Vector2> &controlPoints, double t, love::Vector2 *work)
+{
+	size_t count = controlPoints.size();
+	std::copy(controlPoints.begin(), controlPoints.end(), work);
+	for (size_t step = 1; step < count; ++step)
+		for (size_t i = 0; i < count - step; ++i)
+			work[i] = work[i] * (1-t) + work[i+1] * t;
+	return work[0];
 }
 
 }
@@ -241,38 +266,120 @@ BezierCurve* BezierCurve::getSegment(double t1, double t2) const
 	return new BezierCurve(right);
 }
 
-vector<Vector2> BezierCurve::render(int accuracy) const
+void BezierCurve::render(vector<Vector2> &points, int accuracy) const
 {
 	if (controlPoints.size() < 2)
 		throw Exception("Invalid Bezier curve: Not enough control points.");
-	vector<Vector2> vertices(controlPoints);
-	subdivide(vertices, accuracy);
-	return vertices;
+	subdivide(controlPoints, accuracy, points, scratch);
 }
 
-vector<Vector2> BezierCurve::renderSegment(double start, double end, int accuracy) const
+void BezierCurve::renderSegment(vector<Vector2> &points, double start, double end, int accuracy) const
 {
-	if (controlPoints.size() < 2)
-		throw Exception("Invalid Bezier curve: Not enough control points.");
-	vector<Vector2> vertices(controlPoints);
-	subdivide(vertices, accuracy);
+	render(points, accuracy);
 	if (start == end)
 	{
-		vertices.clear();
+		points.clear();
 	}
 	else if (start < end)
 	{
-		size_t start_idx = size_t(start * vertices.size());
-		size_t end_idx = size_t(end * vertices.size() + 0.5);
-		return std::vector<Vector2>(vertices.begin() + start_idx, vertices.begin() + end_idx);
+		size_t start_idx = size_t(start * points.size());
+		size_t end_idx = size_t(end * points.size() + 0.5);
+		points.erase(points.begin() + end_idx, points.end());
+		points.erase(points.begin(), points.begin() + start_idx);
 	}
-	else if (end > start)
+}
+
+void BezierCurve::renderAdaptive(vector<Vector2> &points, double tolerance, double start, double end) const
+{
+	if (controlPoints.size() < 2)
+		throw Exception("Invalid Bezier curve: Not enough control points.");
+	if (!(tolerance > 0.0))
+		throw Exception("Invalid tolerance: must be greater than 0.");
+	if (start < 0 || start > 1 || end < 0 || end > 1)
+		throw Exception("Invalid segment parameters: must be between 0 and 1");
+
+	size_t degree = getDegree();
+
+	// Wang's formula: the distance between the curve and a polyline with
+	// segments of equal parameter length h is at most
+	// h^2 * n(n-1)/8 * max|P[i+2] - 2P[i+1] + P[i]|.
+	double maxdiff = 0.0;
+	for (size_t i = 0; i + 2 < controlPoints.size(); i++)
 	{
-		size_t start_idx = size_t(end * vertices.size() + 0.5);
-		size_t end_idx = size_t(start * vertices.size());
-		return std::vector<Vector2>(vertices.begin() + start_idx, vertices.begin() + end_idx);
+		Vector2 d = controlPoints[i+2] - controlPoints[i+1] * 2.0f + controlPoints[i];
+		maxdiff = std::max(maxdiff, (double) d.getLength());
 	}
-	return vertices;
+
+	double length = std::abs(end - start);
+	double segments = std::ceil(std::sqrt(degree * (degree - 1) * maxdiff / (8.0 * tolerance)) * length);
+	int count = (int) std::min(std::max(segments, 1.0), 65536.0);
+
+	// The space after the output points is used as temporary storage by
+	// evaluatePoint, so nothing is allocated once the buffer is large enough.
+	points.resize(count + 1 + controlPoints.size());
+	Vector2 *work = &points[count + 1];
+
+	double h = (end - start) / count;
+
+	if (degree <= MAX_FORWARD_DIFFERENCE_DEGREE)
+	{
+		// Forward differencing: the first degree+1 points give a table of
+		// differences, and each following point then needs 'degree' additions.
+		double dx[MAX_FORWARD_DIFFERENCE_DEGREE + 1];
+		double dy[MAX_FORWARD_DIFFERENCE_DEGREE + 1];
+
+		// The differences amplify rounding errors in the first points, so
+		// they're evaluated in double precision.
+		for (size_t i = 0; i <= degree; i++)
+		{
+			double t = start + h * i;
+			double wx[MAX_FORWARD_DIFFERENCE_DEGREE + 1];
+			double wy[MAX_FORWARD_DIFFERENCE_DEGREE + 1];
+			for (size_t j = 0; j <= degree; j++)
+			{
+				wx[j] = controlPoints[j].x;
+				wy[j] = controlPoints[j].y;
+			}
+			for (size_t step = 1; step <= degree; step++)
+			{
+				for (size_t j = 0; j <= degree - step; j++)
+				{
+					wx[j] = wx[j] * (1-t) + wx[j+1] * t;
+					wy[j] = wy[j] * (1-t) + wy[j+1] * t;
+				}
+			}
+			dx[i] = wx[0];
+			dy[i] = wy[0];
+		}
+
+		for (size_t k = 1; k <= degree; k++)
+		{
+			for (size_t i = degree; i >= k; i--)
+			{
+				dx[i] -= dx[i-1];
+				dy[i] -= dy[i-1];
+			}
+		}
+
+		for (int i = 0; i < count; i++)
+		{
+			points[i] = Vector2((float) dx[0], (float) dy[0]);
+			for (size_t k = 0; k < degree; k++)
+			{
+				dx[k] += dx[k+1];
+				dy[k] += dy[k+1];
+			}
+		}
+	}
+	else
+	{
+		for (int i = 0; i < count; i++)
+			points[i] = evaluatePoint(controlPoints, start + h * i, work);
+	}
+
+	// Avoid accumulated error at the end point.
+	points[count] = evaluatePoint(controlPoints, end, work);
+	points.resize(count + 1);
 }
 
 } // namespace math
@@ -126,22 +126,39 @@ public:
 
 	/**
 	 * Renders the curve by subdivision.
+	 * @param points Filled with a polygon chain that approximates the curve.
 	 * @param accuracy The 'fineness' of the curve.
-	 * @returns A polygon chain that approximates the bezier curve.
 	 **/
-	std::vector<Vector2> render(int accuracy = 4) const;
+	void render(std::vector<Vector2> &points, int accuracy = 4) const;
 
 	/**
 	 * Renders a segment of the curve by subdivision.
+	 * @param points Filled with a polygon chain that approximates the segment.
 	 * @param start The starting point (between 0 and 1) on the curve.
 	 * @param end The ending point on the curve.
 	 * @param accuracy The 'fineness' of the curve.
-	 * @returns A polygon chain that approximates the segment along the curve
 	 **/
-	std::vector<Vector2> renderSegment(double start, double end, int accuracy = 4) const;
+	void renderSegment(std::vector<Vector2> &points, double start, double end, int accuracy = 4) const;
+
+	/**
+	 * Renders (a segment of) the curve with just enough points to stay
+	 * within a distance of the real curve, using forward differencing.
+	 * @param points Filled with a polygon chain that approximates the curve.
+	 * @param tolerance The maximum distance between the chain and the curve.
+	 * @param start The starting point (between 0 and 1) on the curve.
+	 * @param end The ending point on the curve.
+	 **/
+	void renderAdaptive(std::vector<Vector2> &points, double tolerance, double start = 0.0, double end = 1.0) const;
 
 private:
+
+	// Forward differencing loses precision quickly for higher degrees.
+	static const size_t MAX_FORWARD_DIFFERENCE_DEGREE = 8;
+
 	std::vector<Vector2> controlPoints;
+
+	// Reused by render, to avoid allocating temporary storage every time.
+	mutable std::vector<Vector2> scratch;
 };
 
 }
@@ -0,0 +1,805 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// Polygon triangulation by ear clipping, following the approach of Mapbox's
+// earcut: holes are joined to the outer polygon with bridges, and for larger
+// polygons the vertices are also kept in z-order so ear tests only need to
+// look at nearby vertices.
+
+#include "MathModule.h"
+#include "common/Exception.h"
+
+// STL
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <limits>
+
+namespace love
+{
+namespace math
+{
+
+namespace
+{
+
+struct Node
+{
+	Node(int i, double x, double y)
+		: i(i), x(x), y(y)
+	{}
+
+	// Index of the vertex in the input.
+	int i;
+	double x;
+	double y;
+
+	// The polygon ring.
+	Node *prev = nullptr;
+	Node *next = nullptr;
+
+	// Nodes sorted by z-order.
+	int32 z = 0;
+	Node *prevZ = nullptr;
+	Node *nextZ = nullptr;
+
+	// A single-vertex hole.
+	bool steiner = false;
+};
+
+class Earcut
+{
+public:
+
+	Earcut(const std::vector<Vector2> &vertices, std::vector<uint32> &indices)
+		: vertices(vertices)
+		, indices(indices)
+	{}
+
+	void run(const std::vector<int> &holeStarts);
+
+private:
+
+	Node *linkedList(int start, int end, bool clockwise);
+	Node *filterPoints(Node *start, Node *end = nullptr);
+	void earcutLinked(Node *ear, int pass);
+	bool isEar(Node *ear) const;
+	bool isEarHashed(Node *ear) const;
+	Node *cureLocalIntersections(Node *start);
+	void splitEarcut(Node *start);
+	Node *eliminateHoles(const std::vector<int> &holeStarts, Node *outerNode);
+	Node *eliminateHole(Node *hole, Node *outerNode);
+	Node *findHoleBridge(Node *hole, Node *outerNode) const;
+	void indexCurve(Node *start);
+	int32 zOrder(double x, double y) const;
+	Node *splitPolygon(Node *a, Node *b);
+	Node *insertNode(int i, const Vector2 &p, Node *last);
+	void addTriangle(const Node *a, const Node *b, const Node *c);
+
+	const std::vector<Vector2> &vertices;
+	std::vector<uint32> &indices;
+
+	// Nodes are never freed individually, and need stable addresses.
+	std::deque<Node> nodes;
+
+	bool hashed = false;
+	double minX = 0.0;
+	double minY = 0.0;
+	double invSize = 0.0;
+};
+
+inline double area(const Node *p, const Node *q, const Node *r)
+{
+	return (q->y - p->y) * (r->x - q->x) - (q->x - p->x) * (r->y - q->y);
+}
+
+inline bool equals(const Node *a, const Node *b)
+{
+	return a->x == b->x && a->y == b->y;
+}
+
+inline int sign(double v)
+{
+	return (v > 0.0) - (v < 0.0);
+}
+
+inline bool pointInTriangle(double ax, double ay, double bx, double by, double cx, double cy, double px, double py)
+{
+	return (cx - px) * (ay - py) >= (ax - px) * (cy - py)
+		&& (ax - px) * (by - py) >= (bx - px) * (ay - py)
+		&& (bx - px) * (cy - py) >= (cx - px) * (by - py);
+}
+
+// Whether q lies within the bounding box of segment pr.
+inline bool onSegment(const Node *p, const Node *q, const Node *r)
+{
+	return q->x <= std::max(p->x, r->x) && q->x >= std::min(p->x, r->x)
+		&& q->y <= std::max(p->y, r->y) && q->y >= std::min(p->y, r->y);
+}
+
+bool intersects(const Node *p1, const Node *q1, const Node *p2, const Node *q2)
+{
+	int o1 = sign(area(p1, q1, p2));
+	int o2 = sign(area(p1, q1, q2));
+	int o3 = sign(area(p2, q2, p1));
+	int o4 = sign(area(p2, q2, q1));
+
+	if (o1 != o2 && o3 != o4)
+		return true;
+
+	// Collinear cases.
+	return (o1 == 0 && onSegment(p1, p2, q1))
+		|| (o2 == 0 && onSegment(p1, q2, q1))
+		|| (o3 == 0 && onSegment(p2, p1, q2))
+		|| (o4 == 0 && onSegment(p2, q1, q2));
+}
+
+bool intersectsPolygon(const Node *a, const Node *b)
+{
+	const Node *p = a;
+	do
+	{
+		if (p->i != a->i && p->next->i != a->i && p->i != b->i && p->next->i != b->i && intersects(p, p->next, a, b))
+			return true;
+		p = p->next;
+	}
+	while (p != a);
+
+	return false;
+}
+
+// Whether the diagonal ab is inside the polygon near a.
+bool locallyInside(const Node *a, const Node *b)
+{
+	if (area(a->prev, a, a->next) < 0.0)
+		return area(a, b, a->next) >= 0.0 && area(a, a->prev, b) >= 0.0;
+	else
+		return area(a, b, a->prev) < 0.0 || area(a, a->next, b) < 0.0;
+}
+
+// Whether the middle of the diagonal ab is inside the polygon.
+bool middleInside(const Node *a, const Node *b)
+{
+	const Node *p = a;
+	bool inside = false;
+	double px = (a->x + b->x) / 2.0;
+	double py = (a->y + b->y) / 2.0;
+
+	do
+	{
+		if (((p->y > py) != (p->next->y > py)) && p->next->y != p->y
+			&& (px < (p->next->x - p->x) * (py - p->y) / (p->next->y - p->y) + p->x))
+			inside = !inside;
+		p = p->next;
+	}
+	while (p != a);
+
+	return inside;
+}
+
+bool sectorContainsSector(const Node *m, const Node *p)
+{
+	return area(m->prev, m, p->prev) < 0.0 && area(p->next, m, m->next) < 0.0;
+}
+
+bool isValidDiagonal(const Node *a, const Node *b)
+{
+	if (a->next->i == b->i || a->prev->i == b->i || intersectsPolygon(a, b))
+		return false;
+
+	if (locallyInside(a, b) && locallyInside(b, a) && middleInside(a, b)
+		&& (area(a->prev, a, b->prev) != 0.0 || area(a, b->prev, b) != 0.0))
+		return true;
+
+	// Special zero-length case.
+	return equals(a, b) && area(a->prev, a, a->next) > 0.0 && area(b->prev, b, b->next) > 0.0;
+}
+
+void removeNode(Node *p)
+{
+	p->next->prev = p->prev;
+	p->prev->next = p->next;
+
+	if (p->prevZ)
+		p->prevZ->nextZ = p->nextZ;
+	if (p->nextZ)
+		p->nextZ->prevZ = p->prevZ;
+}
+
+Node *getLeftmost(Node *start)
+{
+	Node *p = start;
+	Node *leftmost = start;
+	do
+	{
+		if (p->x < leftmost->x || (p->x == leftmost->x && p->y < leftmost->y))
+			leftmost = p;
+		p = p->next;
+	}
+	while (p != start);
+
+	return leftmost;
+}
+
+// Sorts the z-order list with a bottom-up merge sort.
+void sortLinked(Node *list)
+{
+	int inSize = 1;
+	int numMerges;
+
+	do
+	{
+		Node *p = list;
+		Node *tail = nullptr;
+		list = nullptr;
+		numMerges = 0;
+
+		while (p)
+		{
+			numMerges++;
+			Node *q = p;
+			int pSize = 0;
+			for (int i = 0; i < inSize; i++)
+			{
+				pSize++;
+				q = q->nextZ;
+				if (!q)
+					break;
+			}
+
+			int qSize = inSize;
+
+			while (pSize > 0 || (qSize > 0 && q))
+			{
+				Node *e;
+				if (pSize != 0 && (qSize == 0 || !q || p->z <= q->z))
+				{
+					e = p;
+					p = p->nextZ;
+					pSize--;
+				}
+				else
+				{
+					e = q;
+					q = q->nextZ;
+					qSize--;
+				}
+
+				if (tail)
+					tail->nextZ = e;
+				else
+					list = e;
+
+				e->prevZ = tail;
+				tail = e;
+			}
+
+			p = q;
+		}
+
+		tail->nextZ = nullptr;
+		inSize *= 2;
+	}
+	while (numMerges > 1);
+}
+
+void Earcut::run(const std::vector<int> &holeStarts)
+{
+	int count = (int) vertices.size();
+	int outerEnd = holeStarts.empty() ? count : holeStarts[0];
+
+	Node *outerNode = linkedList(0, outerEnd, true);
+	if (!outerNode || outerNode->next == outerNode->prev)
+		return;
+
+	if (!holeStarts.empty())
+		outerNode = eliminateHoles(holeStarts, outerNode);
+
+	// Simple shapes are faster without the z-order hash.
+	if (count > 80)
+	{
+		double maxX = vertices[0].x;
+		double maxY = vertices[0].y;
+		minX = maxX;
+		minY = maxY;
+
+		for (int i = 1; i < outerEnd; i++)
+		{
+			minX = std::min(minX, (double) vertices[i].x);
+			minY = std::min(minY, (double) vertices[i].y);
+			maxX = std::max(maxX, (double) vertices[i].x);
+			maxY = std::max(maxY, (double) vertices[i].y);
+		}
+
+		// z-order coordinates are in [0, 32767].
+		double size = std::max(maxX - minX, maxY - minY);
+		invSize = size != 0.0 ? 32767.0 / size : 0.0;
+		hashed = invSize != 0.0;
+	}
+
+	earcutLinked(outerNode, 0);
+}
+
+// Creates a circular list from vertices in [start, end), in the given winding.
+Node *Earcut::linkedList(int start, int end, bool clockwise)
+{
+	double sum = 0.0;
+	for (int i = start, j = end - 1; i < end; j = i++)
+		sum += ((double) vertices[j].x - vertices[i].x) * ((double) vertices[i].y + vertices[j].y);
+
+	Node *last = nullptr;
+	if (clockwise == (sum > 0.0))
+	{
+		for (int i = start; i < end; i++)
+			last = insertNode(i, vertices[i], last);
+	}
+	else
+	{
+		for (int i = end - 1; i >= start; i--)
+			last = insertNode(i, vertices[i], last);
+	}
+
+	if (last && equals(last, last->next))
+	{
+		removeNode(last);
+		last = last->next;
+	}
+
+	return last;
+}
+
+// Removes duplicate and collinear points.
+Node *Earcut::filterPoints(Node *start, Node *end)
+{
+	if (!start)
+		return start;
+	if (!end)
+		end = start;
+
+	Node *p = start;
+	bool again;
+	do
+	{
+		again = false;
+
+		if (!p->steiner && (equals(p, p->next) || area(p->prev, p, p->next) == 0.0))
+		{
+			removeNode(p);
+			p = end = p->prev;
+			if (p == p->next)
+				break;
+			again = true;
+		}
+		else
+			p = p->next;
+	}
+	while (again || p != end);
+
+	return end;
+}
+
+void Earcut::earcutLinked(Node *ear, int pass)
+{
+	if (!ear)
+		return;
+
+	if (pass == 0 && hashed)
+		indexCurve(ear);
+
+	Node *stop = ear;
+
+	while (ear->prev != ear->next)
+	{
+		Node *prev = ear->prev;
+		Node *next = ear->next;
+
+		if (hashed ? isEarHashed(ear) : isEar(ear))
+		{
+			addTriangle(prev, ear, next);
+			removeNode(ear);
+
+			// Skipping the next vertex leads to less sliver triangles.
+			ear = next->next;
+			stop = next->next;
+			continue;
+		}
+
+		ear = next;
+
+		// No more ears: try to clean up the polygon and continue.
+		if (ear == stop)
+		{
+			if (pass == 0)
+				earcutLinked(filterPoints(ear), 1);
+			else if (pass == 1)
+			{
+				ear = cureLocalIntersections(filterPoints(ear));
+				earcutLinked(ear, 2);
+			}
+			else if (pass == 2)
+				splitEarcut(ear);
+
+			break;
+		}
+	}
+}
+
+bool Earcut::isEar(Node *ear) const
+{
+	const Node *a = ear->prev;
+	const Node *b = ear;
+	const Node *c = ear->next;
+
+	// Reflex, can't be an ear.
+	if (area(a, b, c) >= 0.0)
+		return false;
+
+	double x0 = std::min(a->x, std::min(b->x, c->x));
+	double y0 = std::min(a->y, std::min(b->y, c->y));
+	double x1 = std::max(a->x, std::max(b->x, c->x));
+	double y1 = std::max(a->y, std::max(b->y, c->y));
+
+	// Make sure no other point is inside the potential ear.
+	const Node *p = c->next;
+	while (p != a)
+	{
+		if (p->x >= x0 && p->x <= x1 && p->y >= y0 && p->y <= y1
+			&& pointInTriangle(a->x, a->y, b->x, b->y, c->x, c->y, p->x, p->y)
+			&& area(p->prev, p, p->next) >= 0.0)
+			return false;
+		p = p->next;
+	}
+
+	return true;
+}
+
+bool Earcut::isEarHashed(Node *ear) const
+{
+	const Node *a = ear->prev;
+	const Node *b = ear;
+	const Node *c = ear->next;
+
+	if (area(a, b, c) >= 0.0)
+		return false;
+
+	double x0 = std::min(a->x, std::min(b->x, c->x));
+	double y0 = std::min(a->y, std::min(b->y, c->y));
+	double x1 = std::max(a->x, std::max(b->x, c->x));
+	double y1 = std::max(a->y, std::max(b->y, c->y));
+
+	// Only points within the triangle's z-order range can be inside it.
+	int32 minZ = zOrder(x0, y0);
+	int32 maxZ = zOrder(x1, y1);
+
+	auto blocks = [&](const Node *p)
+	{
+		return p->x >= x0 && p->x <= x1 && p->y >= y0 && p->y <= y1 && p != a && p != c
+			&& pointInTriangle(a->x, a->y, b->x, b->y, c->x, c->y, p->x, p->y)
+			&& area(p->prev, p, p->next) >= 0.0;
+	};
+
+	// Look in both directions from the ear at the same time.
+	const Node *p = ear->prevZ;
+	const Node *n = ear->nextZ;
+
+	while (p && p->z >= minZ && n && n->z <= maxZ)
+	{
+		if (blocks(p))
+			return false;
+		p = p->prevZ;
+
+		if (blocks(n))
+			return false;
+		n = n->nextZ;
+	}
+
+	while (p && p->z >= minZ)
+	{
+		if (blocks(p))
+			return false;
+		p = p->prevZ;
+	}
+
+	while (n && n->z <= maxZ)
+	{
+		if (blocks(n))
+			return false;
+		n = n->nextZ;
+	}
+
+	return true;
+}
+
+// Cuts off small self-intersections as triangles.
+Node *Earcut::cureLocalIntersections(Node *start)
+{
+	Node *p = start;
+	do
+	{
+		Node *a = p->prev;
+		Node *b = p->next->next;
+
+		if (!equals(a, b) && intersects(a, p, p->next, b) && locallyInside(a, b) && locallyInside(b, a))
+		{
+			addTriangle(a, p, b);
+
+			removeNode(p);
+			removeNode(p->next);
+
+			p = start = b;
+		}
+
+		p = p->next;
+	}
+	while (p != start);
+
+	return filterPoints(p);
+}
+
+// Splits the polygon in two along a valid diagonal, and triangulates both.
+void Earcut::splitEarcut(Node *start)
+{
+	Node *a = start;
+	do
+	{
+		Node *b = a->next->next;
+		while (b != a->prev)
+		{
+			if (a->i != b->i && isValidDiagonal(a, b))
+			{
+				Node *c = splitPolygon(a, b);
+
+				a = filterPoints(a, a->next);
+				c = filterPoints(c, c->next);
+
+				earcutLinked(a, 0);
+				earcutLinked(c, 0);
+				return;
+			}
+
+			b = b->next;
+		}
+
+		a = a->next;
+	}
+	while (a != start);
+}
+
+Node *Earcut::eliminateHoles(const std::vector<int> &holeStarts, Node *outerNode)
+{
+	std::vector<Node *> queue;
+	queue.reserve(holeStarts.size());
+
+	for (size_t i = 0; i < holeStarts.size(); i++)
+	{
+		int start = holeStarts[i];
+		int end = i + 1 < holeStarts.size() ? holeStarts[i + 1] : (int) vertices.size();
+
+		Node *list = linkedList(start, end, false);
+		if (!list)
+			continue;
+
+		if (list == list->next)
+			list->steiner = true;
+
+		queue.push_back(getLeftmost(list));
+	}
+
+	// Join holes from left to right.
+	std::sort(queue.begin(), queue.end(), [](const Node *a, const Node *b) { return a->x < b->x; });
+
+	for (Node *hole : queue)
+		outerNode = eliminateHole(hole, outerNode);
+
+	return outerNode;
+}
+
+Node *Earcut::eliminateHole(Node *hole, Node *outerNode)
+{
+	Node *bridge = findHoleBridge(hole, outerNode);
+	if (!bridge)
+		return outerNode;
+
+	Node *bridgeReverse = splitPolygon(bridge, hole);
+
+	filterPoints(bridgeReverse, bridgeReverse->next);
+	return filterPoints(bridge, bridge->next);
+}
+
+// Finds a vertex of the outer polygon which can be connected to the hole.
+Node *Earcut::findHoleBridge(Node *hole, Node *outerNode) const
+{
+	Node *p = outerNode;
+	double hx = hole->x;
+	double hy = hole->y;
+	double qx = -std::numeric_limits<double>::infinity();
+	Node *m = nullptr;
+
+	// Find the closest segment intersected by a ray going left from the hole.
+	do
+	{
+		if (hy <= p->y && hy >= p->next->y && p->next->y != p->y)
+		{
+			double x = p->x + (hy - p->y) * (p->next->x - p->x) / (p->next->y - p->y);
+			if (x <= hx && x > qx)
+			{
+				qx = x;
+				m = p->x < p->next->x ? p : p->next;
+				if (x == hx)
+					return m;
+			}
+		}
+
+		p = p->next;
+	}
+	while (p != outerNode);
+
+	if (!m)
+		return nullptr;
+
+	// Look for points inside the triangle formed by the hole point, the
+	// intersection and the segment's endpoint. The one with the smallest
+	// angle to the ray is the bridge, if there are any.
+	const Node *stop = m;
+	double mx = m->x;
+	double my = m->y;
+	double tanMin = std::numeric_limits<double>::infinity();
+
+	p = m;
+	do
+	{
+		if (hx >= p->x && p->x >= mx && hx != p->x
+			&& pointInTriangle(hy < my ? hx : qx, hy, mx, my, hy < my ? qx : hx, hy, p->x, p->y))
+		{
+			double tan = std::abs(hy - p->y) / (hx - p->x);
+
+			if (locallyInside(p, hole)
+				&& (tan < tanMin || (tan == tanMin && (p->x > m->x || (p->x == m->x && sectorContainsSector(m, p))))))
+			{
+				m = p;
+				tanMin = tan;
+			}
+		}
+
+		p = p->next;
+	}
+	while (p != stop);
+
+	return m;
+}
+
+void Earcut::indexCurve(Node *start)
+{
+	Node *p = start;
+	do
+	{
+		if (p->z == 0)
+			p->z = zOrder(p->x, p->y);
+		p->prevZ = p->prev;
+		p->nextZ = p->next;
+		p = p->next;
+	}
+	while (p != start);
+
+	p->prevZ->nextZ = nullptr;
+	p->prevZ = nullptr;
+
+	sortLinked(p);
+}
+
+// Interleaves the bits of the scaled coordinates.
+int32 Earcut::zOrder(double px, double py) const
+{
+	int32 x = (int32) ((px - minX) * invSize);
+	int32 y = (int32) ((py - minY) * invSize);
+
+	x = (x | (x << 8)) & 0x00FF00FF;
+	x = (x | (x << 4)) & 0x0F0F0F0F;
+	x = (x | (x << 2)) & 0x33333333;
+	x = (x | (x << 1)) & 0x55555555;
+
+	y = (y | (y << 8)) & 0x00FF00FF;
+	y = (y | (y << 4)) & 0x0F0F0F0F;
+	y = (y | (y << 2)) & 0x33333333;
+	y = (y | (y << 1)) & 0x55555555;
+
+	return x | (y << 1);
+}
+
+// Links a and b with a bridge. The polygon is split in two if they're in the
+// same ring, or two rings are joined into one otherwise.
+Node *Earcut::splitPolygon(Node *a, Node *b)
+{
+	nodes.emplace_back(a->i, a->x, a->y);
+	Node *a2 = &nodes.back();
+	nodes.emplace_back(b->i, b->x, b->y);
+	Node *b2 = &nodes.back();
+
+	Node *an = a->next;
+	Node *bp = b->prev;
+
+	a->next = b;
+	b->prev = a;
+
+	a2->next = an;
+	an->prev = a2;
+
+	b2->next = a2;
+	a2->prev = b2;
+
+	bp->next = b2;
+	b2->prev = bp;
+
+	return b2;
+}
+
+Node *Earcut::insertNode(int i, const Vector2 &v, Node *last)
+{
+	nodes.emplace_back(i, v.x, v.y);
+	Node *p = &nodes.back();
+
+	if (!last)
+	{
+		p->prev = p;
+		p->next = p;
+	}
+	else
+	{
+		p->next = last->next;
+		p->prev = last;
+		last->next->prev = p;
+		last->next = p;
+	}
+
+	return p;
+}
+
+void Earcut::addTriangle(const Node *a, const Node *b, const Node *c)
+{
+	indices.push_back((uint32) a->i);
+	indices.push_back((uint32) b->i);
+	indices.push_back((uint32) c->i);
+}
+
+} // anonymous namespace
+
+void triangulateIndices(const std::vector<Vector2> &vertices, const std::vector<int> &holeStarts, std::vector<uint32> &indices)
+{
+	int previous = 0;
+	for (int start : holeStarts)
+	{
+		if (start <= previous || start >= (int) vertices.size())
+			throw love::Exception("Invalid hole start index %d.", start + 1);
+		previous = start;
+	}
+
+	indices.clear();
+
+	if (vertices.size() < 3)
+		return;
+
+	indices.reserve((vertices.size() + holeStarts.size() * 2) * 3);
+
+	Earcut earcut(vertices, indices);
+	earcut.run(holeStarts);
+}
+
+} // math
+} // love
@@ -199,6 +199,163 @@ float linearToGamma(float c)
 		return 1.055f * powf(c, 1.0f / 2.4f) - 0.055f;
 }
 
+namespace
+{
+
+// Intervals in the gamma lookup tables. The largest error compared to
+// gammaToLinear and linearToGamma is below 1e-6.
+const int GAMMA_TABLE_SIZE = 4096;
+
+struct GammaTables
+{
+	// Indexed by the sRGB value.
+	float toLinear[GAMMA_TABLE_SIZE + 2];
+
+	// Indexed by the square root of the linear value, since linearToGamma is
+	// very steep near 0.
+	float toGamma[GAMMA_TABLE_SIZE + 2];
+
+	GammaTables()
+	{
+		// The extra entry lets 1.0 be interpolated without a special case.
+		for (int i = 0; i < GAMMA_TABLE_SIZE + 2; i++)
+		{
+			double c = (double) i / GAMMA_TABLE_SIZE;
+			toLinear[i] = (float) (c <= 0.04045 ? c / 12.92 : pow((c + 0.055) / 1.055, 2.4));
+
+			double l = c * c;
+			toGamma[i] = (float) (l <= 0.0031308 ? l * 12.92 : 1.055 * pow(l, 1.0 / 2.4) - 0.055);
+		}
+	}
+};
+
+const GammaTables &getGammaTables()
+{
+	static const GammaTables tables;
+	return tables;
+}
+
+inline float lookupGamma(const float *table, float x)
+{
+	float p = x * GAMMA_TABLE_SIZE;
+	int i = (int) p;
+	return table[i] + (table[i + 1] - table[i]) * (p - (float) i);
+}
+
+} // anonymous namespace
+
+void gammaToLinear(float *values, size_t count, int stride, int components)
+{
+	const float *table = getGammaTables().toLinear;
+
+	for (size_t i = 0; i < count; i++)
+	{
+		float *color = values + i * stride;
+		for (int j = 0; j < components; j++)
+		{
+			float c = color[j];
+			if (c >= 0.0f && c <= 1.0f)
+				color[j] = lookupGamma(table, c);
+			else
+				color[j] = gammaToLinear(c);
+		}
+	}
+}
+
+void linearToGamma(float *values, size_t count, int stride, int components)
+{
+	const float *table = getGammaTables().toGamma;
+
+	for (size_t i = 0; i < count; i++)
+	{
+		float *color = values + i * stride;
+		for (int j = 0; j < components; j++)
+		{
+			float c = color[j];
+			// The linear part is cheaper than a lookup, and the table is least
+			// accurate around it.
+			if (c >= 0.0f && c <= 0.0031308f)
+				color[j] = c * 12.92f;
+			else if (c > 0.0f && c <= 1.0f)
+				color[j] = lookupGamma(table, sqrtf(c));
+			else
+				color[j] = linearToGamma(c);
+		}
+	}
+}
+
+template <double (*noise2)(double, double), double (*noise3)(double, double, double)>
+static void fractalNoiseRows(const NoiseSettings &s, int width, int y, int h, float *dst)
+{
+	double amplitude = 1.0;
+	double total = 0.0;
+	for (int o = 0; o < s.octaves; o++)
+	{
+		total += amplitude;
+		amplitude *= s.gain;
+	}
+
+	double scale = total > 0.0 ? 1.0 / total : 0.0;
+
+	for (int row = 0; row < h; row++)
+	{
+		float *values = dst + (size_t) row * width;
+		double ny = s.y + (y + row) * s.frequency;
+
+		for (int col = 0; col < width; col++)
+		{
+			double nx = s.x + col * s.frequency;
+			double sum = 0.0;
+			double frequency = 1.0;
+			amplitude = 1.0;
+
+			for (int o = 0; o < s.octaves; o++)
+			{
+				if (s.useZ)
+					sum += noise3(nx * frequency, ny * frequency, s.z * frequency) * amplitude;
+				else
+					sum += noise2(nx * frequency, ny * frequency) * amplitude;
+
+				frequency *= s.lacunarity;
+				amplitude *= s.gain;
+			}
+
+			values[col] = (float) (sum * scale);
+		}
+	}
+}
+
+void fractalNoise(const NoiseSettings &settings, int width, int y, int h, float *dst)
+{
+	if (settings.type == NOISE_PERLIN)
+		fractalNoiseRows<perlinNoise2, perlinNoise3>(settings, width, y, h, dst);
+	else
+		fractalNoiseRows<simplexNoise2, simplexNoise3>(settings, width, y, h, dst);
+}
+
+static StringMap<NoiseType, NOISE_MAX_ENUM>::Entry noiseTypeEntries[] =
+{
+	{ "simplex", NOISE_SIMPLEX },
+	{ "perlin",  NOISE_PERLIN  },
+};
+
+static StringMap<NoiseType, NOISE_MAX_ENUM> noiseTypes(noiseTypeEntries, sizeof(noiseTypeEntries));
+
+bool getConstant(const char *in, NoiseType &out)
+{
+	return noiseTypes.find(in, out);
+}
+
+bool getConstant(NoiseType in, const char *&out)
+{
+	return noiseTypes.find(in, out);
+}
+
+std::vector<std::string> getConstants(NoiseType)
+{
+	return noiseTypes.getNames();
+}
+
 Math::Math()
 	: Module(M_MATH, "love.math")
 {
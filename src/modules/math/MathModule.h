@@ -68,6 +68,15 @@ std::vector<Triangle> triangulate(const std::vector<love::Vector2> &polygon);
  **/
 bool isConvex(const std::vector<love::Vector2> &polygon);
 
+/**
+ * Triangulate a polygon with optional holes, in close to O(n log n) time.
+ *
+ * @param vertices The outer polygon's vertices, followed by each hole's.
+ * @param holeStarts The index of the first vertex of each hole, in order.
+ * @param indices Filled with three vertex indices per triangle.
+ **/
+void triangulateIndices(const std::vector<love::Vector2> &vertices, const std::vector<int> &holeStarts, std::vector<uint32> &indices);
+
 /**
  * Converts a value from the sRGB (gamma) colorspace to linear RGB.
  **/
@@ -78,6 +87,18 @@ float gammaToLinear(float c);
  **/
 float linearToGamma(float c);
 
+/**
+ * Converts colors in place between sRGB and linear RGB, using lookup tables.
+ * Values outside of [0, 1] are converted with the functions above.
+ *
+ * @param values The colors' components.
+ * @param count The number of colors.
+ * @param stride The number of components in each color.
+ * @param components How many of each color's components to convert.
+ **/
+void gammaToLinear(float *values, size_t count, int stride, int components);
+void linearToGamma(float *values, size_t count, int stride, int components);
+
 /**
  * Calculate noise for the specified coordinate(s).
  *
@@ -92,6 +113,42 @@ static double perlinNoise2(double x, double y);
 static double perlinNoise3(double x, double y, double z);
 static double perlinNoise4(double x, double y, double z, double w);
 
+enum NoiseType
+{
+	NOISE_SIMPLEX,
+	NOISE_PERLIN,
+	NOISE_MAX_ENUM
+};
+
+struct NoiseSettings
+{
+	NoiseType type = NOISE_SIMPLEX;
+
+	// Noise coordinates of the first value, and the distance between values.
+	double x = 0.0;
+	double y = 0.0;
+	double z = 0.0;
+	double frequency = 1.0;
+
+	// 3D noise is used when z is set.
+	bool useZ = false;
+
+	int octaves = 1;
+	double lacunarity = 2.0;
+	double gain = 0.5;
+};
+
+/**
+ * Fills h rows of a grid, starting at row y, with fractal noise. Each octave
+ * multiplies the frequency by lacunarity and the amplitude by gain, and the
+ * sum is scaled back to [0, 1]. dst holds width values per row.
+ **/
+void fractalNoise(const NoiseSettings &settings, int width, int y, int h, float *dst);
+
+bool getConstant(const char *in, NoiseType &out);
+bool getConstant(NoiseType in, const char *&out);
+std::vector<std::string> getConstants(NoiseType);
+
 
 class Math : public Module
 {
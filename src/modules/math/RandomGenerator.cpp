@@ -23,6 +23,8 @@
 // C++
 #include <sstream>
 #include <iomanip>
+#include <algorithm>
+#include <vector>
 
 // C
 #include <cmath>
@@ -47,6 +49,77 @@ static uint64 wangHash64(uint64 key)
 	return key;
 }
 
+static inline uint64 xorshift64(uint64 state)
+{
+	state ^= (state >> 12);
+	state ^= (state << 25);
+	state ^= (state >> 27);
+	return state;
+}
+
+static inline double toDouble(uint64 r)
+{
+	// From http://xoroshiro.di.unimi.it
+	union { uint64 i; double d; } u;
+	u.i = ((0x3FFULL) << 52) | (r >> 12);
+	return u.d - 1.0;
+}
+
+// The xorshift step is linear over GF(2), so advancing the state N steps is a
+// multiplication with a 64x64 bit matrix. Each column is the result of
+// advancing a state with only that bit set.
+struct JumpMatrix
+{
+	uint64 columns[64];
+
+	uint64 apply(uint64 state) const
+	{
+		uint64 result = 0;
+		for (int i = 0; i < 64; i++)
+		{
+			if (state & (1ULL << i))
+				result ^= columns[i];
+		}
+		return result;
+	}
+
+	JumpMatrix squared() const
+	{
+		JumpMatrix m;
+		for (int i = 0; i < 64; i++)
+			m.columns[i] = apply(columns[i]);
+		return m;
+	}
+};
+
+struct JumpMatrices
+{
+	JumpMatrix block; // FILL_BLOCK_SIZE steps.
+	JumpMatrix stream; // 2^48 steps.
+
+	JumpMatrices()
+	{
+		JumpMatrix m;
+		for (int i = 0; i < 64; i++)
+			m.columns[i] = xorshift64(1ULL << i);
+
+		for (int i = 1; i <= 48; i++)
+		{
+			m = m.squared();
+			if ((1ULL << i) == RandomGenerator::FILL_BLOCK_SIZE)
+				block = m;
+		}
+
+		stream = m;
+	}
+};
+
+static const JumpMatrices &getJumpMatrices()
+{
+	static const JumpMatrices matrices;
+	return matrices;
+}
+
 love::Type RandomGenerator::type("RandomGenerator", &Object::type);
 
 // 64 bit Xorshift implementation taken from the end of Sec. 3 (page 4) in
@@ -66,12 +139,141 @@ RandomGenerator::RandomGenerator()
 
 uint64 RandomGenerator::rand()
 {
-	rng_state.b64 ^= (rng_state.b64 >> 12);
-	rng_state.b64 ^= (rng_state.b64 << 25);
-	rng_state.b64 ^= (rng_state.b64 >> 27);
+	rng_state.b64 = xorshift64(rng_state.b64);
 	return rng_state.b64 * 2685821657736338717ULL;
 }
 
+template <typename Transform>
+void RandomGenerator::fillBlocks(double *dst, size_t count, const ParallelFunc &parallel, const Transform &transform)
+{
+	if (count == 0)
+		return;
+
+	const JumpMatrix &jump = getJumpMatrices().block;
+
+	int blockcount = (int) ((count + FILL_BLOCK_SIZE - 1) / FILL_BLOCK_SIZE);
+	std::vector<uint64> states(blockcount + 1);
+
+	states[0] = rng_state.b64;
+	for (int i = 1; i < blockcount; i++)
+		states[i] = jump.apply(states[i - 1]);
+
+	auto fill = [&](int first, int n)
+	{
+		const uint64 multiplier = 2685821657736338717ULL;
+
+		// Four blocks are generated together: their states are independent,
+		// so the CPU can overlap their instructions.
+		int i = first;
+		for (; i + 4 <= first + n && (size_t) (i + 4) * FILL_BLOCK_SIZE <= count; i += 4)
+		{
+			uint64 s0 = states[i + 0], s1 = states[i + 1], s2 = states[i + 2], s3 = states[i + 3];
+			double *d0 = dst + (size_t) i * FILL_BLOCK_SIZE;
+			double *d1 = d0 + FILL_BLOCK_SIZE;
+			double *d2 = d1 + FILL_BLOCK_SIZE;
+			double *d3 = d2 + FILL_BLOCK_SIZE;
+
+			for (size_t j = 0; j < FILL_BLOCK_SIZE; j++)
+			{
+				s0 = xorshift64(s0);
+				s1 = xorshift64(s1);
+				s2 = xorshift64(s2);
+				s3 = xorshift64(s3);
+				d0[j] = toDouble(s0 * multiplier);
+				d1[j] = toDouble(s1 * multiplier);
+				d2[j] = toDouble(s2 * multiplier);
+				d3[j] = toDouble(s3 * multiplier);
+			}
+
+			for (int k = 0; k < 4; k++)
+				transform(dst + (size_t) (i + k) * FILL_BLOCK_SIZE, FILL_BLOCK_SIZE);
+
+			if (i + 4 == blockcount)
+				states[blockcount] = s3;
+		}
+
+		for (; i < first + n; i++)
+		{
+			uint64 s = states[i];
+			size_t start = (size_t) i * FILL_BLOCK_SIZE;
+			size_t size = std::min(count - start, (size_t) FILL_BLOCK_SIZE);
+
+			for (size_t j = 0; j < size; j++)
+			{
+				s = xorshift64(s);
+				dst[start + j] = toDouble(s * multiplier);
+			}
+
+			transform(dst + start, size);
+
+			if (i + 1 == blockcount)
+				states[blockcount] = s;
+		}
+	};
+
+	if (parallel && blockcount > 1)
+		parallel(blockcount, fill);
+	else
+		fill(0, blockcount);
+
+	// Continue after the last generated number, as if rand() was called.
+	rng_state.b64 = states[blockcount];
+}
+
+void RandomGenerator::randomFill(double *dst, size_t count, const ParallelFunc &parallel)
+{
+	fillBlocks(dst, count, parallel, [](double *, size_t) {});
+}
+
+void RandomGenerator::randomFill(double *dst, size_t count, double min, double max, const ParallelFunc &parallel)
+{
+	double range = max - min + 1;
+	fillBlocks(dst, count, parallel, [&](double *values, size_t n)
+	{
+		for (size_t i = 0; i < n; i++)
+			values[i] = floor(values[i] * range) + min;
+	});
+}
+
+void RandomGenerator::randomNormalFill(double *dst, size_t count, double stddev, double mean, const ParallelFunc &parallel)
+{
+	if (count == 0)
+		return;
+
+	// A number left over from a previous call to randomNormal comes first.
+	if (last_randomnormal != std::numeric_limits<double>::infinity())
+	{
+		*dst++ = randomNormal(stddev) + mean;
+		count--;
+	}
+
+	// Each pair of numbers comes from a pair of uniform numbers, which never
+	// straddle a block since FILL_BLOCK_SIZE is even.
+	size_t paircount = count & ~(size_t) 1;
+
+	fillBlocks(dst, paircount, parallel, [&](double *values, size_t n)
+	{
+		for (size_t i = 0; i < n; i += 2)
+		{
+			double r   = sqrt(-2.0 * log(1. - values[i]));
+			double phi = 2.0 * LOVE_M_PI * (1. - values[i + 1]);
+
+			values[i] = r * sin(phi) * stddev + mean;
+			values[i + 1] = r * cos(phi) * stddev + mean;
+		}
+	});
+
+	// An odd count leaves a number for the next call, like randomNormal.
+	if (paircount < count)
+		dst[paircount] = randomNormal(stddev) + mean;
+}
+
+void RandomGenerator::jump()
+{
+	rng_state.b64 = getJumpMatrices().stream.apply(rng_state.b64);
+	last_randomnormal = std::numeric_limits<double>::infinity();
+}
+
 // Box–Muller transform
 double RandomGenerator::randomNormal(double stddev)
 {
@@ -29,6 +29,7 @@
 #include "common/Object.h"
 
 // C++
+#include <functional>
 #include <limits>
 #include <string>
 
@@ -112,6 +113,39 @@ public:
 	 **/
 	double randomNormal(double stddev);
 
+	/**
+	 * Runs func on ranges of [0, count), possibly on several threads at once.
+	 **/
+	typedef std::function<void(int count, const std::function<void(int first, int n)> &func)> ParallelFunc;
+
+	/**
+	 * Fills dst with the next count numbers random() would return.
+	 *
+	 * The numbers are generated in blocks of FILL_BLOCK_SIZE which each start
+	 * from their own jumped-ahead copy of the state. Several blocks are worked
+	 * on at once, and parallel can spread them over multiple threads.
+	 **/
+	void randomFill(double *dst, size_t count, const ParallelFunc &parallel = nullptr);
+
+	/**
+	 * Fills dst with the next count numbers random(min, max) in the Lua API
+	 * would return: uniformly distributed integers in [min, max].
+	 **/
+	void randomFill(double *dst, size_t count, double min, double max, const ParallelFunc &parallel = nullptr);
+
+	/**
+	 * Fills dst with the next count numbers randomNormal(stddev) + mean would
+	 * return.
+	 **/
+	void randomNormalFill(double *dst, size_t count, double stddev, double mean, const ParallelFunc &parallel = nullptr);
+
+	/**
+	 * Advances the state as if rand() was called 2^48 times. Generators with
+	 * the same state which are jumped a different number of times give
+	 * non-overlapping streams, e.g. for use on different threads.
+	 **/
+	void jump();
+
 	/**
 	 * Set pseudo-random seed.
 	 * It's up to the implementation how to use this.
@@ -134,8 +168,14 @@ public:
 	 **/
 	std::string getState() const;
 
+	// Number of values generated from each jumped-ahead state in randomFill.
+	static const size_t FILL_BLOCK_SIZE = 16384;
+
 private:
 
+	template <typename Transform>
+	void fillBlocks(double *dst, size_t count, const ParallelFunc &parallel, const Transform &transform);
+
 	Seed seed;
 	Seed rng_state;
 	double last_randomnormal;
@@ -118,6 +118,16 @@ love::Vector2 Transform::inverseTransformPoint(love::Vector2 p)
 	return result;
 }
 
+void Transform::transformPoints(float *dst, const float *src, int count) const
+{
+	matrix.transformXYArray(dst, src, count);
+}
+
+void Transform::inverseTransformPoints(float *dst, const float *src, int count)
+{
+	getInverseMatrix().transformXYArray(dst, src, count);
+}
+
 const Matrix4 &Transform::getMatrix() const
 {
 	return matrix;
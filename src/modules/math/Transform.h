@@ -22,6 +22,7 @@
 
 // LOVE
 #include "common/Object.h"
+#include "common/memory.h"
 #include "common/Matrix.h"
 #include "common/Vector.h"
 #include "common/StringMap.h"
@@ -31,7 +32,7 @@ namespace love
 namespace math
 {
 
-class Transform : public Object
+class Transform : public Object, public Pooled<Transform>
 {
 public:
 
@@ -66,6 +67,9 @@ public:
 	love::Vector2 transformPoint(love::Vector2 p) const;
 	love::Vector2 inverseTransformPoint(love::Vector2 p);
 
+	void transformPoints(float *dst, const float *src, int count) const;
+	void inverseTransformPoints(float *dst, const float *src, int count);
+
 	const Matrix4 &getMatrix() const;
 	void setMatrix(const Matrix4 &m);
 
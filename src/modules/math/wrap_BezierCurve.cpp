@@ -171,16 +171,22 @@ int w_BezierCurve_getSegment(lua_State *L)
 	return 1;
 }
 
-int w_BezierCurve_render(lua_State *L)
+// Pushes a flat table of coordinates, reusing the table at idx if it's given.
+static void pushRenderedPoints(lua_State *L, const std::vector<Vector2> &points, int idx)
 {
-	BezierCurve *curve = luax_checkbeziercurve(L, 1);
-	int accuracy = (int) luaL_optinteger(L, 2, 5);
+	int count = (int) points.size();
+	int oldlen = 0;
 
-	std::vector<Vector2> points;
-	luax_catchexcept(L, [&](){ points = curve->render(accuracy); });
+	if (!lua_isnoneornil(L, idx))
+	{
+		luaL_checktype(L, idx, LUA_TTABLE);
+		oldlen = (int) luax_objlen(L, idx);
+		lua_pushvalue(L, idx);
+	}
+	else
+		lua_createtable(L, count * 2, 0);
 
-	lua_createtable(L, (int) points.size() * 2, 0);
-	for (int i = 0; i < (int) points.size(); ++i)
+	for (int i = 0; i < count; ++i)
 	{
 		lua_pushnumber(L, points[i].x);
 		lua_rawseti(L, -2, 2*i+1);
@@ -188,6 +194,31 @@ int w_BezierCurve_render(lua_State *L)
 		lua_rawseti(L, -2, 2*i+2);
 	}
 
+	// Clear values left over from a previous, longer curve.
+	for (int i = count * 2 + 1; i <= oldlen; i++)
+	{
+		lua_pushnil(L);
+		lua_rawseti(L, -2, i);
+	}
+}
+
+// Rendered points are only needed until they're pushed to Lua, so the same
+// vector can be used by every call.
+static std::vector<Vector2> &getRenderBuffer()
+{
+	static thread_local std::vector<Vector2> points;
+	return points;
+}
+
+int w_BezierCurve_render(lua_State *L)
+{
+	BezierCurve *curve = luax_checkbeziercurve(L, 1);
+	int accuracy = (int) luaL_optinteger(L, 2, 5);
+
+	std::vector<Vector2> &points = getRenderBuffer();
+	luax_catchexcept(L, [&](){ curve->render(points, accuracy); });
+
+	pushRenderedPoints(L, points, 3);
 	return 1;
 }
 
@@ -198,21 +229,28 @@ int w_BezierCurve_renderSegment(lua_State *L)
 	double end = luaL_checknumber(L, 3);
 	int accuracy = (int) luaL_optinteger(L, 4, 5);
 
-	std::vector<Vector2> points;
-	luax_catchexcept(L, [&](){ points = curve->renderSegment(start, end, accuracy); });
-
-	lua_createtable(L, (int) points.size() * 2, 0);
-	for (int i = 0; i < (int) points.size(); ++i)
-	{
-		lua_pushnumber(L, points[i].x);
-		lua_rawseti(L, -2, 2*i+1);
-		lua_pushnumber(L, points[i].y);
-		lua_rawseti(L, -2, 2*i+2);
-	}
+	std::vector<Vector2> &points = getRenderBuffer();
+	luax_catchexcept(L, [&](){ curve->renderSegment(points, start, end, accuracy); });
 
+	pushRenderedPoints(L, points, 5);
 	return 1;
 }
 
+int w_BezierCurve_renderAdaptive(lua_State *L)
+{
+	BezierCurve *curve = luax_checkbeziercurve(L, 1);
+	double tolerance = luaL_checknumber(L, 2);
+	double start = luaL_optnumber(L, 3, 0.0);
+	double end = luaL_optnumber(L, 4, 1.0);
+
+	std::vector<Vector2> &points = getRenderBuffer();
+	luax_catchexcept(L, [&](){ curve->renderAdaptive(points, tolerance, start, end); });
+
+	pushRenderedPoints(L, points, 5);
+	lua_pushinteger(L, (lua_Integer) points.size());
+	return 2;
+}
+
 static const luaL_Reg w_BezierCurve_functions[] =
 {
 	{"getDegree", w_BezierCurve_getDegree},
@@ -229,6 +267,7 @@ static const luaL_Reg w_BezierCurve_functions[] =
 	{"getSegment", w_BezierCurve_getSegment},
 	{"render", w_BezierCurve_render},
 	{"renderSegment", w_BezierCurve_renderSegment},
+	{"renderAdaptive", w_BezierCurve_renderAdaptive},
 	{ 0, 0 }
 };
 
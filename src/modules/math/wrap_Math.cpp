@@ -25,6 +25,8 @@
 #include "MathModule.h"
 #include "BezierCurve.h"
 #include "Transform.h"
+#include "common/Data.h"
+#include "image/ImageData.h"
 
 #include <cmath>
 #include <iostream>
@@ -145,6 +147,42 @@ int w_newTransform(lua_State *L)
 	return 1;
 }
 
+int w_multiplyTransformHierarchy(lua_State *L)
+{
+	static_assert(sizeof(Matrix4) == sizeof(float) * 16, "Matrix4 must be tightly packed.");
+
+	// Column-major 4x4 float matrices, one per node.
+	love::Data *locals = luax_checktype<love::Data>(L, 1);
+	luaL_checktype(L, 2, LUA_TTABLE);
+	love::Data *result = lua_isnoneornil(L, 3) ? locals : luax_checktype<love::Data>(L, 3);
+
+	int count = (int) (locals->getSize() / sizeof(Matrix4));
+	if ((int) luax_objlen(L, 2) < count)
+		return luaL_error(L, "Expected a parent index for each of the %d matrices.", count);
+
+	if (result->getSize() < (size_t) count * sizeof(Matrix4))
+		return luaL_error(L, "The destination Data is too small to hold %d matrices.", count);
+
+	// Parent indices are 1-based, with 0 for nodes without a parent.
+	std::vector<int> parents(count);
+	for (int i = 0; i < count; i++)
+	{
+		lua_rawgeti(L, 2, i + 1);
+		int parent = (int) luaL_checkinteger(L, -1);
+		lua_pop(L, 1);
+
+		if (parent < 0 || parent > i)
+			return luaL_error(L, "Invalid parent index %d for matrix %d. Parents must come before their children.", parent, i + 1);
+
+		parents[i] = parent - 1;
+	}
+
+	Matrix4::multiplyHierarchy((const Matrix4 *) locals->getData(), parents.data(), (Matrix4 *) result->getData(), count);
+
+	lua_pushvalue(L, lua_isnoneornil(L, 3) ? 1 : 3);
+	return 1;
+}
+
 int w_triangulate(lua_State *L)
 {
 	std::vector<love::Vector2> vertices;
@@ -215,6 +253,59 @@ int w_triangulate(lua_State *L)
 	return 1;
 }
 
+int w_triangulateIndices(lua_State *L)
+{
+	luaL_checktype(L, 1, LUA_TTABLE);
+
+	std::vector<love::Vector2> vertices;
+	int len = (int) luax_objlen(L, 1);
+	vertices.reserve(len / 2);
+	for (int i = 1; i <= len; i += 2)
+	{
+		lua_rawgeti(L, 1, i);
+		lua_rawgeti(L, 1, i+1);
+
+		Vector2 v;
+		v.x = (float) luaL_checknumber(L, -2);
+		v.y = (float) luaL_checknumber(L, -1);
+		vertices.push_back(v);
+
+		lua_pop(L, 2);
+	}
+
+	// Holes are given as the (1-based) index of their first vertex.
+	std::vector<int> holestarts;
+	if (!lua_isnoneornil(L, 2))
+	{
+		luaL_checktype(L, 2, LUA_TTABLE);
+		int count = (int) luax_objlen(L, 2);
+		holestarts.reserve(count);
+		for (int i = 1; i <= count; i++)
+		{
+			lua_rawgeti(L, 2, i);
+			holestarts.push_back((int) luaL_checkinteger(L, -1) - 1);
+			lua_pop(L, 1);
+		}
+	}
+
+	if (vertices.size() < 3)
+		return luaL_error(L, "Need at least 3 vertices to triangulate");
+
+	std::vector<uint32> indices;
+	luax_catchexcept(L, [&]() { triangulateIndices(vertices, holestarts, indices); });
+
+	// 1-based, so the result can be passed to Mesh:setVertexMap directly.
+	lua_createtable(L, (int) indices.size(), 0);
+	for (int i = 0; i < (int) indices.size(); i++)
+	{
+		lua_pushinteger(L, indices[i] + 1);
+		lua_rawseti(L, -2, i + 1);
+	}
+
+	lua_pushinteger(L, (lua_Integer) (indices.size() / 3));
+	return 2;
+}
+
 int w_isConvex(lua_State *L)
 {
 	std::vector<love::Vector2> vertices;
@@ -316,6 +407,61 @@ int w_linearToGamma(lua_State *L)
 	return numcomponents;
 }
 
+// Converts a flat table of numbers or a Data of floats with one of the bulk
+// gamma functions. Colors have 4 components by default, and alpha is left
+// alone.
+static int convertGammaColors(lua_State *L, void (*convert)(float *, size_t, int, int))
+{
+	int components = (int) luaL_optinteger(L, 2, 4);
+	if (components < 1 || components > 4)
+		return luaL_argerror(L, 2, "number of components must be between 1 and 4");
+
+	int gammacomponents = std::min(components, 3);
+
+	if (lua_istable(L, 1))
+	{
+		int len = (int) luax_objlen(L, 1);
+		int count = len / components;
+
+		static thread_local std::vector<float> values;
+		values.resize((size_t) count * components);
+
+		for (int i = 0; i < count * components; i++)
+		{
+			lua_rawgeti(L, 1, i + 1);
+			values[i] = (float) luaL_checknumber(L, -1);
+			lua_pop(L, 1);
+		}
+
+		convert(values.data(), count, components, gammacomponents);
+
+		for (int i = 0; i < count * components; i++)
+		{
+			lua_pushnumber(L, values[i]);
+			lua_rawseti(L, 1, i + 1);
+		}
+	}
+	else
+	{
+		love::Data *data = luax_checktype<love::Data>(L, 1);
+		size_t count = data->getSize() / (sizeof(float) * components);
+		convert((float *) data->getData(), count, components, gammacomponents);
+	}
+
+	lua_pushvalue(L, 1);
+	return 1;
+}
+
+int w_gammaToLinearColors(lua_State *L)
+{
+	return convertGammaColors(L, gammaToLinear);
+}
+
+int w_linearToGammaColors(lua_State *L)
+{
+	return convertGammaColors(L, linearToGamma);
+}
+
 int w_noise(lua_State *L)
 {
 	luax_markdeprecated(L, 1, "love.math.noise", API_FUNCTION, DEPRECATED_REPLACED, "love.math.perlinNoise or love.math.simplexNoise");
@@ -408,6 +554,107 @@ int w_simplexNoise(lua_State* L)
 	return 1;
 }
 
+int w_fillNoise(lua_State *L)
+{
+	love::image::ImageData *imagedata = nullptr;
+	love::Data *data = nullptr;
+	int width = 0;
+	int height = 0;
+	int settingsidx = 2;
+
+	if (luax_istype(L, 1, love::image::ImageData::type))
+	{
+		imagedata = luax_checktype<love::image::ImageData>(L, 1);
+		width = imagedata->getWidth();
+		height = imagedata->getHeight();
+	}
+	else
+	{
+		// A grid of floats.
+		data = luax_checktype<love::Data>(L, 1);
+		width = (int) luaL_checkinteger(L, 2);
+		height = (int) luaL_checkinteger(L, 3);
+		settingsidx = 4;
+
+		if (width < 0 || height < 0 || data->getSize() < (size_t) width * height * sizeof(float))
+			return luaL_error(L, "The Data is too small to hold %dx%d noise values.", width, height);
+	}
+
+	NoiseSettings settings;
+
+	if (!lua_isnoneornil(L, settingsidx))
+	{
+		luaL_checktype(L, settingsidx, LUA_TTABLE);
+
+		lua_getfield(L, settingsidx, "type");
+		if (!lua_isnoneornil(L, -1))
+		{
+			const char *str = luaL_checkstring(L, -1);
+			if (!getConstant(str, settings.type))
+				return luax_enumerror(L, "noise type", getConstants(settings.type), str);
+		}
+		lua_pop(L, 1);
+
+		lua_getfield(L, settingsidx, "z");
+		settings.useZ = lua_isnumber(L, -1) != 0;
+		lua_pop(L, 1);
+
+		settings.x = luax_numberflag(L, settingsidx, "x", 0.0);
+		settings.y = luax_numberflag(L, settingsidx, "y", 0.0);
+		settings.z = luax_numberflag(L, settingsidx, "z", 0.0);
+		settings.frequency = luax_numberflag(L, settingsidx, "frequency", 1.0);
+		settings.octaves = luax_intflag(L, settingsidx, "octaves", 1);
+		settings.lacunarity = luax_numberflag(L, settingsidx, "lacunarity", 2.0);
+		settings.gain = luax_numberflag(L, settingsidx, "gain", 0.5);
+
+		if (settings.octaves < 1)
+			return luaL_error(L, "The number of octaves must be at least 1.");
+	}
+
+	// Noise is far slower to compute than copying pixels, so the row size
+	// given to parallelRows is weighted by the work done per value.
+	size_t rowcost = (size_t) width * settings.octaves * 64;
+
+	luax_catchexcept(L, [&]() {
+		if (imagedata != nullptr)
+		{
+			auto setpixel = imagedata->getPixelSetFunction();
+			if (setpixel == nullptr)
+				throw love::Exception("love.math.fillNoise does not support the %s pixel format.", getPixelFormatName(imagedata->getFormat()));
+
+			uint8 *pixels = (uint8 *) imagedata->getData();
+			size_t pixelsize = imagedata->getPixelSize();
+
+			love::image::ImageData::parallelRows(0, height, rowcost, [&](int y, int h)
+			{
+				std::vector<float> values((size_t) width);
+				for (int row = y; row < y + h; row++)
+				{
+					fractalNoise(settings, width, row, 1, values.data());
+
+					uint8 *rowdata = pixels + (size_t) row * width * pixelsize;
+					for (int x = 0; x < width; x++)
+					{
+						Colorf c(values[x], values[x], values[x], 1.0f);
+						setpixel(c, (love::image::ImageData::Pixel *) (rowdata + x * pixelsize));
+					}
+				}
+			});
+		}
+		else
+		{
+			float *values = (float *) data->getData();
+			love::image::ImageData::parallelRows(0, height, rowcost, [&](int y, int h)
+			{
+				fractalNoise(settings, width, y, h, values + (size_t) y * width);
+			});
+		}
+	});
+
+	lua_pushvalue(L, 1);
+	return 1;
+}
+
 // C functions in a struct, necessary for the FFI versions of math functions.
 struct FFI_Math
 {
@@ -449,13 +696,18 @@ static const luaL_Reg functions[] =
 	{ "newRandomGenerator", w_newRandomGenerator },
 	{ "newBezierCurve", w_newBezierCurve },
 	{ "newTransform", w_newTransform },
+	{ "multiplyTransformHierarchy", w_multiplyTransformHierarchy },
 	{ "triangulate", w_triangulate },
+	{ "triangulateIndices", w_triangulateIndices },
 	{ "isConvex", w_isConvex },
 	{ "gammaToLinear", w_gammaToLinear },
 	{ "linearToGamma", w_linearToGamma },
+	{ "gammaToLinearColors", w_gammaToLinearColors },
+	{ "linearToGammaColors", w_linearToGammaColors },
 	{ "noise", w_noise },
 	{ "perlinNoise", w_perlinNoise },
 	{ "simplexNoise", w_simplexNoise },
+	{ "fillNoise", w_fillNoise },
 
 	{ 0, 0 }
 };
@@ -487,11 +739,13 @@ extern "C" int luaopen_love_math(lua_State *L)
 
 	int n = luax_register_module(L, w);
 
-	// Execute wrap_Math.lua, sending the math table and ffifuncs pointer as args.
+	// Execute wrap_Math.lua, sending the math table, ffifuncs pointer and the
+	// shared ffi helpers as args.
 	luaL_loadbuffer(L, math_lua, sizeof(math_lua), "=[love \"wrap_Math.lua\"]");
 	lua_pushvalue(L, -2);
 	luax_pushpointerasstring(L, &ffifuncs);
-	lua_call(L, 2, 0);
+	luax_pushffiwrapper(L);
+	lua_call(L, 3, 0);
 
 	return n;
 }
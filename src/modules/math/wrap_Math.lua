@@ -22,7 +22,7 @@ misrepresented as being the original software.
 3. This notice may not be removed or altered from any source distribution.
 --]]
 
-local love_math, ffifuncspointer_str = ...
+local love_math, ffifuncspointer_str, ffiwrapper = ...
 
 local type, tonumber, error = type, tonumber, error
 local floor = math.floor
@@ -42,6 +42,14 @@ function love_math.randomNormal(stddev, mean)
 	return rng:randomNormal(stddev, mean)
 end
 
+function love_math.randomFill(dest, count, l, u)
+	return rng:randomFill(dest, count, l, u)
+end
+
+function love_math.randomNormalFill(dest, count, stddev, mean)
+	return rng:randomNormalFill(dest, count, stddev, mean)
+end
+
 function love_math.setRandomSeed(low, high)
 	return rng:setSeed(low, high)
 end
@@ -80,17 +88,10 @@ function love_math.colorFromBytes(r, g, b, a)
 	return r, g, b, a
 end
 
-if type(jit) ~= "table" or not jit.status() then
-	-- LuaJIT's FFI is *much* slower than LOVE's regular methods when the JIT
-	-- compiler is disabled.
-	return
-end
-
-local status, ffi = pcall(require, "ffi")
-if not status then return end
+if ffiwrapper == nil or not ffiwrapper.isjitenabled() then return end
 
 -- Matches the struct declaration in wrap_Math.cpp.
-pcall(ffi.cdef, [[
+local ffifuncs = ffiwrapper.getfuncs("FFI_Math", [[
 typedef struct FFI_Math
 {
 	double (*snoise1)(double x);
@@ -105,9 +106,7 @@ typedef struct FFI_Math
 	float (*gammaToLinear)(float c);
 	float (*linearToGamma)(float c);
 } FFI_Math;
-]])
-
-local ffifuncs = ffi.cast("FFI_Math **", ffifuncspointer_str)[0]
+]], ffifuncspointer_str)
 local love = require("love")
 
 -- Overwrite some regular love.math functions with FFI implementations.
@@ -19,9 +19,12 @@
  **/
 
 #include "wrap_RandomGenerator.h"
+#include "common/Data.h"
+#include "image/ImageData.h"
 
 #include <cmath>
 #include <algorithm>
+#include <vector>
 
 // Put the Lua code directly into a raw string literal.
 static const char randomgenerator_lua[] =
@@ -85,6 +88,95 @@ int w_RandomGenerator_randomNormal(lua_State *L)
 	return 1;
 }
 
+// Spreads blocks of random numbers over the same worker threads ImageData
+// uses for its rows.
+static void parallelRandomBlocks(int count, const std::function<void(int, int)> &func)
+{
+	size_t blocksize = RandomGenerator::FILL_BLOCK_SIZE * sizeof(double);
+	love::image::ImageData::parallelRows(0, count, blocksize, func);
+}
+
+// Calls fill with a destination for count doubles: either the Data at idx, or
+// a buffer which is then copied into the table at idx.
+template <typename Fill>
+static int fillRandom(lua_State *L, int idx, lua_Integer count, const Fill &fill)
+{
+	if (count < 0)
+		return luaL_argerror(L, idx + 1, "count must not be negative");
+
+	if (lua_istable(L, idx))
+	{
+		static thread_local std::vector<double> values;
+		values.resize((size_t) count);
+
+		luax_catchexcept(L, [&]() { fill(values.data(), values.size()); });
+
+		for (lua_Integer i = 0; i < count; i++)
+		{
+			lua_pushnumber(L, values[(size_t) i]);
+			lua_rawseti(L, idx, (int) i + 1);
+		}
+	}
+	else
+	{
+		love::Data *data = luax_checktype<love::Data>(L, idx);
+		if (data->getSize() / sizeof(double) < (size_t) count)
+			return luaL_error(L, "The Data is too small to hold %d numbers.", (int) count);
+
+		luax_catchexcept(L, [&]() { fill((double *) data->getData(), (size_t) count); });
+	}
+
+	lua_pushvalue(L, idx);
+	return 1;
+}
+
+int w_RandomGenerator_randomFill(lua_State *L)
+{
+	RandomGenerator *rng = luax_checkrandomgenerator(L, 1);
+	lua_Integer count = luaL_checkinteger(L, 3);
+
+	if (lua_isnoneornil(L, 4))
+	{
+		return fillRandom(L, 2, count, [&](double *dst, size_t n)
+		{
+			rng->randomFill(dst, n, parallelRandomBlocks);
+		});
+	}
+
+	// Integers in [min, max], or [1, max] if only one bound is given.
+	double min = luaL_checknumber(L, 4);
+	double max = min;
+	if (lua_isnoneornil(L, 5))
+		min = 1.0;
+	else
+		max = luaL_checknumber(L, 5);
+
+	return fillRandom(L, 2, count, [&](double *dst, size_t n)
+	{
+		rng->randomFill(dst, n, min, max, parallelRandomBlocks);
+	});
+}
+
+int w_RandomGenerator_randomNormalFill(lua_State *L)
+{
+	RandomGenerator *rng = luax_checkrandomgenerator(L, 1);
+	lua_Integer count = luaL_checkinteger(L, 3);
+	double stddev = luaL_optnumber(L, 4, 1.0);
+	double mean = luaL_optnumber(L, 5, 0.0);
+
+	return fillRandom(L, 2, count, [&](double *dst, size_t n)
+	{
+		rng->randomNormalFill(dst, n, stddev, mean, parallelRandomBlocks);
+	});
+}
+
+int w_RandomGenerator_jump(lua_State *L)
+{
+	RandomGenerator *rng = luax_checkrandomgenerator(L, 1);
+	rng->jump();
+	return 0;
+}
+
 int w_RandomGenerator_setSeed(lua_State *L)
 {
 	RandomGenerator *rng = luax_checkrandomgenerator(L, 1);
@@ -141,6 +233,9 @@ static const luaL_Reg w_RandomGenerator_functions[] =
 {
 	{ "_random", w_RandomGenerator__random }, // random() is defined in wrap_RandomGenerator.lua.
 	{ "randomNormal", w_RandomGenerator_randomNormal },
+	{ "randomFill", w_RandomGenerator_randomFill },
+	{ "randomNormalFill", w_RandomGenerator_randomNormalFill },
+	{ "jump", w_RandomGenerator_jump },
 	{ "setSeed", w_RandomGenerator_setSeed },
 	{ "getSeed", w_RandomGenerator_getSeed },
 	{ "setState", w_RandomGenerator_setState },
@@ -22,7 +22,7 @@ misrepresented as being the original software.
 3. This notice may not be removed or altered from any source distribution.
 --]]
 
-local RandomGenerator_mt, ffifuncspointer_str = ...
+local RandomGenerator_mt, ffifuncspointer_str, ffiwrapper = ...
 local RandomGenerator = RandomGenerator_mt.__index
 
 local type, tonumber, error = type, tonumber, error
@@ -48,26 +48,15 @@ function RandomGenerator:random(l, u)
 	return getrandom(r, l, u)
 end
 
-if type(jit) ~= "table" or not jit.status() then
-	-- LuaJIT's FFI is *much* slower than LOVE's regular methods when the JIT
-	-- compiler is disabled.
-	return
-end
-
-local status, ffi = pcall(require, "ffi")
-if not status then return end
-
-pcall(ffi.cdef, [[
-typedef struct Proxy Proxy;
+if ffiwrapper == nil or not ffiwrapper.isjitenabled() then return end
 
+local ffifuncs = ffiwrapper.getfuncs("FFI_RandomGenerator", [[
 typedef struct FFI_RandomGenerator
 {
 	double (*random)(Proxy *p);
 	double (*randomNormal)(Proxy *p, double stddev, double mean);
 } FFI_RandomGenerator;
-]])
-
-local ffifuncs = ffi.cast("FFI_RandomGenerator **", ffifuncspointer_str)[0]
+]], ffifuncspointer_str)
 
 
 -- Overwrite some regular love.math functions with FFI implementations.
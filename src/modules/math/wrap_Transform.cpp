@@ -19,12 +19,26 @@
  **/
 
 #include "wrap_Transform.h"
+#include "common/Data.h"
+
+// C++
+#include <vector>
+
+// Shove the wrap_Transform.lua code directly into a raw string literal.
+static const char transform_lua[] =
+#include "wrap_Transform.lua"
+;
 
 namespace love
 {
 namespace math
 {
 
+/**
+ * NOTE: Additional wrapper code is in wrap_Transform.lua. Be sure to keep it
+ * in sync with any changes made to this file!
+ **/
+
 Transform *luax_checktransform(lua_State *L, int idx)
 {
 	return luax_checktype<Transform>(L, idx, Transform::type);
@@ -284,6 +298,81 @@ int w_Transform_inverseTransformPoint(lua_State *L)
 	return 2;
 }
 
+// Transforms a flat table of x,y coordinates, or a Data of float x,y pairs.
+static int transformPoints(lua_State *L, bool inverse)
+{
+	Transform *t = luax_checktransform(L, 1);
+
+	if (lua_istable(L, 2))
+	{
+		int len = (int) luax_objlen(L, 2);
+		int count = len / 2;
+
+		std::vector<float> points((size_t) count * 2);
+		for (int i = 0; i < count * 2; i++)
+		{
+			lua_rawgeti(L, 2, i + 1);
+			points[i] = (float) luaL_checknumber(L, -1);
+			lua_pop(L, 1);
+		}
+
+		if (inverse)
+			t->inverseTransformPoints(points.data(), points.data(), count);
+		else
+			t->transformPoints(points.data(), points.data(), count);
+
+		// An existing table can be passed in, to avoid creating one every call.
+		int oldlen = 0;
+		if (!lua_isnoneornil(L, 3))
+		{
+			luaL_checktype(L, 3, LUA_TTABLE);
+			oldlen = (int) luax_objlen(L, 3);
+			lua_pushvalue(L, 3);
+		}
+		else
+			lua_createtable(L, count * 2, 0);
+
+		for (int i = 0; i < count * 2; i++)
+		{
+			lua_pushnumber(L, points[i]);
+			lua_rawseti(L, -2, i + 1);
+		}
+
+		for (int i = count * 2 + 1; i <= oldlen; i++)
+		{
+			lua_pushnil(L);
+			lua_rawseti(L, -2, i);
+		}
+
+		return 1;
+	}
+
+	love::Data *src = luax_checktype<love::Data>(L, 2);
+	love::Data *dst = lua_isnoneornil(L, 3) ? src : luax_checktype<love::Data>(L, 3);
+
+	int count = (int) (src->getSize() / (sizeof(float) * 2));
+	if (dst->getSize() < (size_t) count * sizeof(float) * 2)
+		return luaL_error(L, "The destination Data is too small to hold %d points.", count);
+
+	if (inverse)
+		t->inverseTransformPoints((float *) dst->getData(), (const float *) src->getData(), count);
+	else
+		t->transformPoints((float *) dst->getData(), (const float *) src->getData(), count);
+
+	lua_pushvalue(L, lua_isnoneornil(L, 3) ? 2 : 3);
+	return 1;
+}
+
+int w_Transform_transformPoints(lua_State *L)
+{
+	return transformPoints(L, false);
+}
+
+int w_Transform_inverseTransformPoints(lua_State *L)
+{
+	return transformPoints(L, true);
+}
+
 int w_Transform__mul(lua_State *L)
 {
 	Transform *t1 = luax_checktransform(L, 1);
@@ -294,6 +383,73 @@ int w_Transform__mul(lua_State *L)
 	return 1;
 }
 
+// C functions in a struct, necessary for the FFI versions of Transform methods.
+struct FFI_Transform
+{
+	bool (*translate)(Proxy *p, float x, float y);
+	bool (*rotate)(Proxy *p, float angle);
+	bool (*scale)(Proxy *p, float sx, float sy);
+	bool (*shear)(Proxy *p, float kx, float ky);
+	bool (*transformPoint)(Proxy *p, float *xy);
+	bool (*inverseTransformPoint)(Proxy *p, float *xy);
+};
+
+static FFI_Transform ffifuncs =
+{
+	[](Proxy *p, float x, float y) -> bool // translate
+	{
+		auto t = luax_ffi_checktype<Transform>(p);
+		if (t == nullptr)
+			return false;
+		t->translate(x, y);
+		return true;
+	},
+	[](Proxy *p, float angle) -> bool // rotate
+	{
+		auto t = luax_ffi_checktype<Transform>(p);
+		if (t == nullptr)
+			return false;
+		t->rotate(angle);
+		return true;
+	},
+	[](Proxy *p, float sx, float sy) -> bool // scale
+	{
+		auto t = luax_ffi_checktype<Transform>(p);
+		if (t == nullptr)
+			return false;
+		t->scale(sx, sy);
+		return true;
+	},
+	[](Proxy *p, float kx, float ky) -> bool // shear
+	{
+		auto t = luax_ffi_checktype<Transform>(p);
+		if (t == nullptr)
+			return false;
+		t->shear(kx, ky);
+		return true;
+	},
+	[](Proxy *p, float *xy) -> bool // transformPoint
+	{
+		auto t = luax_ffi_checktype<Transform>(p);
+		if (t == nullptr)
+			return false;
+		love::Vector2 v = t->transformPoint(love::Vector2(xy[0], xy[1]));
+		xy[0] = v.x;
+		xy[1] = v.y;
+		return true;
+	},
+	[](Proxy *p, float *xy) -> bool // inverseTransformPoint
+	{
+		auto t = luax_ffi_checktype<Transform>(p);
+		if (t == nullptr)
+			return false;
+		love::Vector2 v = t->inverseTransformPoint(love::Vector2(xy[0], xy[1]));
+		xy[0] = v.x;
+		xy[1] = v.y;
+		return true;
+	},
+};
+
 static const luaL_Reg functions[] =
 {
 	{ "clone", w_Transform_clone },
@@ -310,13 +466,17 @@ static const luaL_Reg functions[] =
 	{ "getMatrix", w_Transform_getMatrix },
 	{ "transformPoint", w_Transform_transformPoint },
 	{ "inverseTransformPoint", w_Transform_inverseTransformPoint },
+	{ "transformPoints", w_Transform_transformPoints },
+	{ "inverseTransformPoints", w_Transform_inverseTransformPoints },
 	{ "__mul", w_Transform__mul },
 	{ 0, 0 }
 };
 
 extern "C" int luaopen_transform(lua_State *L)
 {
-	return luax_register_type(L, &Transform::type, functions, nullptr);
+	int ret = luax_register_type(L, &Transform::type, functions, nullptr);
+	luax_runwrapper(L, transform_lua, sizeof(transform_lua), "Transform.lua", Transform::type, &ffifuncs);
+	return ret;
 }
 
 } // math
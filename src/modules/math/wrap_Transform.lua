@@ -0,0 +1,114 @@
+R"luastring"--(
+-- DO NOT REMOVE THE ABOVE LINE. It is used to load this file as a C++ string.
+-- There is a matching delimiter at the bottom of the file.
+
+--[[
+Copyright (c) 2006-2024 LOVE Development Team
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+claim that you wrote the original software. If you use this software
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+--]]
+
+
+local Transform_mt, ffifuncspointer_str, ffiwrapper = ...
+local Transform = Transform_mt.__index
+
+-- Everything below this point is efficient FFI replacements for existing
+-- Transform functionality.
+
+if ffiwrapper == nil or not ffiwrapper.isjitenabled() then return end
+
+local ffi = ffiwrapper.ffi
+local type, tonumber = type, tonumber
+
+-- Matches the struct declaration in wrap_Transform.cpp.
+local ffifuncs = ffiwrapper.getfuncs("FFI_Transform", [[
+typedef struct FFI_Transform
+{
+	bool (*translate)(Proxy *p, float x, float y);
+	bool (*rotate)(Proxy *p, float angle);
+	bool (*scale)(Proxy *p, float sx, float sy);
+	bool (*shear)(Proxy *p, float kx, float ky);
+	bool (*transformPoint)(Proxy *p, float *xy);
+	bool (*inverseTransformPoint)(Proxy *p, float *xy);
+} FFI_Transform;
+]], ffifuncspointer_str)
+
+local point = ffi.new("float[2]")
+
+local _translate = Transform.translate
+local _rotate = Transform.rotate
+local _scale = Transform.scale
+local _shear = Transform.shear
+local _transformPoint = Transform.transformPoint
+local _inverseTransformPoint = Transform.inverseTransformPoint
+
+-- The FFI functions return false for an invalid or released object. In that
+-- case, or when the arguments aren't plain numbers, the regular methods are
+-- used so errors and argument coercion behave the same as before.
+
+function Transform:translate(x, y)
+	if type(x) == "number" and type(y) == "number" and ffifuncs.translate(self, x, y) then
+		return self
+	end
+	return _translate(self, x, y)
+end
+
+function Transform:rotate(angle)
+	if type(angle) == "number" and ffifuncs.rotate(self, angle) then
+		return self
+	end
+	return _rotate(self, angle)
+end
+
+function Transform:scale(sx, sy)
+	if type(sx) == "number" and (sy == nil or type(sy) == "number") then
+		if ffifuncs.scale(self, sx, sy == nil and sx or sy) then
+			return self
+		end
+	end
+	return _scale(self, sx, sy)
+end
+
+function Transform:shear(kx, ky)
+	if type(kx) == "number" and type(ky) == "number" and ffifuncs.shear(self, kx, ky) then
+		return self
+	end
+	return _shear(self, kx, ky)
+end
+
+function Transform:transformPoint(x, y)
+	if type(x) == "number" and type(y) == "number" then
+		point[0], point[1] = x, y
+		if ffifuncs.transformPoint(self, point) then
+			return tonumber(point[0]), tonumber(point[1])
+		end
+	end
+	return _transformPoint(self, x, y)
+end
+
+function Transform:inverseTransformPoint(x, y)
+	if type(x) == "number" and type(y) == "number" then
+		point[0], point[1] = x, y
+		if ffifuncs.inverseTransformPoint(self, point) then
+			return tonumber(point[0]), tonumber(point[1])
+		end
+	end
+	return _inverseTransformPoint(self, x, y)
+end
+
+-- DO NOT REMOVE THE NEXT LINE. It is used to load this file as a C++ string.
+--)luastring"--"
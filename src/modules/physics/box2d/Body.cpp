@@ -48,6 +48,7 @@ Body::Body(World *world, b2Vec2 p, Body::Type type)
 	// Box2D body holds a reference to the love Body.
 	this->retain();
 	this->setType(type);
+	savePreviousTransform();
 }
 
 Body::~Body()
@@ -85,6 +86,25 @@ float Body::getAngle()
 	return body->GetAngle();
 }
 
+void Body::getInterpolatedPosition(float alpha, float &x_o, float &y_o)
+{
+	const b2Vec2 &p = body->GetPosition();
+	b2Vec2 v = Physics::scaleUp(previousPosition + alpha * (p - previousPosition));
+	x_o = v.x;
+	y_o = v.y;
+}
+
+float Body::getInterpolatedAngle(float alpha)
+{
+	return previousAngle + alpha * (body->GetAngle() - previousAngle);
+}
+
+void Body::savePreviousTransform()
+{
+	previousPosition = body->GetPosition();
+	previousAngle = body->GetAngle();
+}
+
 void Body::getWorldCenter(float &x_o, float &y_o)
 {
 	b2Vec2 v = Physics::scaleUp(body->GetWorldCenter());
@@ -203,11 +223,13 @@ void Body::applyForce(float fx, float fy, bool wake)
 void Body::setX(float x)
 {
 	body->SetTransform(Physics::scaleDown(b2Vec2(x, getY())), getAngle());
+	savePreviousTransform();
 }
 
 void Body::setY(float y)
 {
 	body->SetTransform(Physics::scaleDown(b2Vec2(getX(), y)), getAngle());
+	savePreviousTransform();
 }
 
 void Body::setLinearVelocity(float x, float y)
@@ -218,6 +240,7 @@ void Body::setLinearVelocity(float x, float y)
 void Body::setAngle(float d)
 {
 	body->SetTransform(body->GetPosition(), d);
+	savePreviousTransform();
 }
 
 void Body::setAngularVelocity(float r)
@@ -235,6 +258,7 @@ void Body::setKinematicState(b2Vec2 pos, float a, b2Vec2 vel, float da)
 void Body::setPosition(float x, float y)
 {
 	body->SetTransform(Physics::scaleDown(b2Vec2(x, y)), body->GetAngle());
+	savePreviousTransform();
 }
 
 void Body::setAngularDamping(float d)
@@ -481,7 +505,10 @@ Shape *Body::getShape() const
 
 int Body::getShapes(lua_State *L) const
 {
-	lua_newtable(L);
+	int oldlen = Physics::pushOutputTable(L, 1);
+	int tableidx = lua_gettop(L);
+	int objectsidx = luax_getobjectregistry(L);
+
 	b2Fixture *f = body->GetFixtureList();
 	int i = 1;
 	do
@@ -491,17 +518,26 @@ int Body::getShapes(lua_State *L) const
 		Shape *shape = (Shape *)(f->GetUserData().pointer);
 		if (!shape)
 			throw love::Exception("A Shape has escaped Memoizer!");
-		luax_pushshape(L, shape);
-		lua_rawseti(L, -2, i);
+		luax_pushshape(L, objectsidx, shape);
+		lua_rawseti(L, tableidx, i);
 		i++;
 	}
 	while ((f = f->GetNext()));
+
+	// Remove the objects registry.
+	lua_pop(L, 1);
+
+	Physics::trimOutputTable(L, tableidx, i - 1, oldlen);
+
 	return 1;
 }
 
 int Body::getJoints(lua_State *L) const
 {
-	lua_newtable(L);
+	int oldlen = Physics::pushOutputTable(L, 1);
+	int tableidx = lua_gettop(L);
+	int objectsidx = luax_getobjectregistry(L);
+
 	const b2JointEdge *je = body->GetJointList();
 	int i = 1;
 
@@ -514,18 +550,26 @@ int Body::getJoints(lua_State *L) const
 		if (!joint)
 			throw love::Exception("A joint has escaped Memoizer!");
 
-		luax_pushjoint(L, joint);
-		lua_rawseti(L, -2, i);
+		luax_pushjoint(L, objectsidx, joint);
+		lua_rawseti(L, tableidx, i);
 		i++;
 	}
 	while ((je = je->next));
 
+	// Remove the objects registry.
+	lua_pop(L, 1);
+
+	Physics::trimOutputTable(L, tableidx, i - 1, oldlen);
+
 	return 1;
 }
 
 int Body::getContacts(lua_State *L) const
 {
-	lua_newtable(L);
+	int oldlen = Physics::pushOutputTable(L, 1);
+	int tableidx = lua_gettop(L);
+	int objectsidx = luax_getobjectregistry(L);
+
 	const b2ContactEdge *ce = body->GetContactList();
 	int i = 1;
 	do
@@ -533,18 +577,24 @@ int Body::getContacts(lua_State *L) const
 		if (!ce)
 			break;
 
-		Contact *contact = (Contact *) world->findObject(ce->contact);
+		Contact *contact = (Contact *)(ce->contact->GetUserData().pointer);
 		if (!contact)
 			contact = new Contact(world, ce->contact);
 		else
 			contact->retain();
 
-		luax_pushtype(L, contact);
+		luax_pushtype(L, objectsidx, contact);
 		contact->release();
-		lua_rawseti(L, -2, i);
+		lua_rawseti(L, tableidx, i);
 		i++;
 	}
 	while ((ce = ce->next));
+
+	// Remove the objects registry.
+	lua_pop(L, 1);
+
+	Physics::trimOutputTable(L, tableidx, i - 1, oldlen);
+
 	return 1;
 }
 
@@ -561,6 +611,8 @@ void Body::destroy()
 	world->world->DestroyBody(body);
 	body = nullptr;
 
+	world->removeMovedBody(this);
+
 	// Remove userdata reference to avoid it sticking around after GC
 	if (ref)
 		ref->unref();
@@ -56,6 +56,7 @@ public:
 	friend class CircleShape;
 	friend class PolygonShape;
 	friend class Shape;
+	friend class World;
 
 	// Public because joints et al ask for b2body
 	b2Body *body;
@@ -89,6 +90,24 @@ public:
 	 **/
 	void getPosition(float &x_o, float &y_o);
 
+	/**
+	 * Gets the position of the Body blended between its position before the
+	 * last step taken by World::updateFixed and its current position.
+	 * @param alpha 0 for the previous position, 1 for the current one.
+	 **/
+	void getInterpolatedPosition(float alpha, float &x_o, float &y_o);
+
+	/**
+	 * Gets the angle of the Body blended like getInterpolatedPosition.
+	 **/
+	float getInterpolatedAngle(float alpha);
+
+	/**
+	 * Remembers the current position and angle for interpolation. Moving the
+	 * Body directly does this too, so it doesn't appear to slide there.
+	 **/
+	void savePreviousTransform();
+
 	/**
 	 * Gets the velocity in the current center of mass.
 	 * @param[out] x_o The x-component of the velocity.
@@ -437,6 +456,13 @@ private:
 
 	bool hasCustomMass;
 
+	// The transform before the last fixed step, for interpolation.
+	b2Vec2 previousPosition;
+	float previousAngle;
+
+	// See World::getMovedBodies.
+	uint32 movedStamp = 0;
+
 	// Reference to arbitrary data.
 	Reference* ref = nullptr;
 
@@ -35,7 +35,7 @@ Contact::Contact(World *world, b2Contact *contact)
 	: contact(contact)
 	, world(world)
 {
-	world->registerObject(contact, this);
+	contact->GetUserData().pointer = (uintptr_t) this;
 }
 
 Contact::~Contact()
@@ -47,7 +47,7 @@ void Contact::invalidate()
 {
 	if (contact != nullptr)
 	{
-		world->unregisterObject(contact);
+		contact->GetUserData().pointer = 0;
 		contact = nullptr;
 	}
 }
@@ -23,6 +23,7 @@
 
 // LOVE
 #include "common/Object.h"
+#include "common/memory.h"
 #include "common/runtime.h"
 #include "World.h"
 
@@ -42,7 +43,7 @@ class World;
  * A Contact represents a collision point between
  * two shapes.
  **/
-class Contact : public Object
+class Contact : public Object, public Pooled<Contact>
 {
 public:
 	// Friends.
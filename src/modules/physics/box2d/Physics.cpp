@@ -402,6 +402,31 @@ b2AABB Physics::scaleUp(const b2AABB &aabb)
 	return t;
 }
 
+int Physics::pushOutputTable(lua_State *L, int idx, int narr)
+{
+	if (lua_isnoneornil(L, idx))
+	{
+		lua_createtable(L, narr, 0);
+		return 0;
+	}
+
+	luaL_checktype(L, idx, LUA_TTABLE);
+	lua_pushvalue(L, idx);
+	return (int) luax_objlen(L, idx);
+}
+
+void Physics::trimOutputTable(lua_State *L, int tableidx, int count, int oldlen)
+{
+	if (tableidx < 0)
+		tableidx = lua_gettop(L) + tableidx + 1;
+
+	for (int i = count + 1; i <= oldlen; i++)
+	{
+		lua_pushnil(L);
+		lua_rawseti(L, tableidx, i);
+	}
+}
+
 void Physics::computeLinearStiffness(float &stiffness, float &damping, float frequency, float dampingRatio, b2Body *bodyA, b2Body *bodyB)
 {
 	b2LinearStiffness(stiffness, damping, frequency, dampingRatio, bodyA, bodyB);
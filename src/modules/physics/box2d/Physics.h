@@ -383,6 +383,21 @@ public:
 	 **/
 	static void computeAngularFrequency(float &frequency, float &ratio, float stiffness, float damping, b2Body *bodyA, b2Body *bodyB);
 
+	/**
+	 * Pushes the table at the given stack index, or a new table if that
+	 * argument is nil. Functions which return lists accept an existing table
+	 * to fill, to avoid creating one every call.
+	 * @param narr Array size hint for a new table.
+	 * @return The length of the existing table, or 0.
+	 **/
+	static int pushOutputTable(lua_State *L, int idx, int narr = 0);
+
+	/**
+	 * Removes values left over after the first count elements of a reused
+	 * output table, from when it held a longer list.
+	 **/
+	static void trimOutputTable(lua_State *L, int tableidx, int count, int oldlen);
+
 	b2BlockAllocator *getBlockAllocator() { return &blockAllocator; }
 
 private:
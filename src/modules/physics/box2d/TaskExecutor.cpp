@@ -0,0 +1,151 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "TaskExecutor.h"
+#include "common/Exception.h"
+
+namespace love
+{
+namespace physics
+{
+namespace box2d
+{
+
+TaskExecutor::Worker::Worker(TaskExecutor *executor)
+	: executor(executor)
+{
+	threadName = "PhysicsWorker";
+}
+
+void TaskExecutor::Worker::threadFunction()
+{
+	uint64 lastbatch = 0;
+
+	while (true)
+	{
+		{
+			thread::Lock lock(executor->mutex);
+			while (!executor->stopping && executor->batch == lastbatch)
+				executor->startCond->wait(executor->mutex);
+
+			if (executor->stopping)
+				return;
+
+			lastbatch = executor->batch;
+		}
+
+		executor->runTasks();
+
+		thread::Lock lock(executor->mutex);
+		if (--executor->busyWorkers == 0)
+			executor->doneCond->signal();
+	}
+}
+
+TaskExecutor::TaskExecutor(int threadcount)
+	: task(nullptr)
+	, context(nullptr)
+	, count(0)
+	, nextIndex(0)
+	, batch(0)
+	, busyWorkers(0)
+	, stopping(false)
+{
+	for (int i = 0; i < threadcount - 1; i++)
+	{
+		Worker *worker = new Worker(this);
+		worker->start();
+		workers.push_back(worker);
+	}
+}
+
+TaskExecutor::~TaskExecutor()
+{
+	{
+		thread::Lock lock(mutex);
+		stopping = true;
+		startCond->broadcast();
+	}
+
+	for (Worker *worker : workers)
+	{
+		worker->wait();
+		delete worker;
+	}
+}
+
+int TaskExecutor::getThreadCount() const
+{
+	return (int) workers.size() + 1;
+}
+
+void TaskExecutor::Run(b2TaskFcn *task, void *context, int32 count)
+{
+	// Waking the workers isn't worth it for a single task.
+	if (workers.empty() || count <= 1)
+	{
+		for (int32 i = 0; i < count; i++)
+			task(i, context);
+		return;
+	}
+
+	{
+		thread::Lock lock(mutex);
+		this->task = task;
+		this->context = context;
+		this->count = count;
+		nextIndex = 0;
+		busyWorkers = (int) workers.size();
+		error.clear();
+		batch++;
+		startCond->broadcast();
+	}
+
+	runTasks();
+
+	thread::Lock lock(mutex);
+	while (busyWorkers > 0)
+		doneCond->wait(mutex);
+
+	if (!error.empty())
+		throw love::Exception("%s", error.c_str());
+}
+
+void TaskExecutor::runTasks()
+{
+	try
+	{
+		for (int32 i = nextIndex++; i < count; i = nextIndex++)
+			task(i, context);
+	}
+	catch (love::Exception &e)
+	{
+		thread::Lock lock(mutex);
+		if (error.empty())
+			error = e.what();
+
+		// Skip the remaining tasks.
+		nextIndex = count;
+	}
+}
+
+} // box2d
+} // physics
+} // love
@@ -0,0 +1,106 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_PHYSICS_BOX2D_TASK_EXECUTOR_H
+#define LOVE_PHYSICS_BOX2D_TASK_EXECUTOR_H
+
+// LOVE
+#include "common/config.h"
+#include "thread/threads.h"
+
+// STD
+#include <atomic>
+#include <string>
+#include <vector>
+
+// Box2D
+#include <box2d/Box2D.h>
+
+namespace love
+{
+namespace physics
+{
+namespace box2d
+{
+
+/**
+ * Runs Box2D tasks (such as solving islands) on a set of worker threads plus
+ * the thread which calls Run, which blocks until every task is done.
+ **/
+class TaskExecutor : public b2TaskExecutor
+{
+public:
+
+	/**
+	 * @param threadcount The total number of threads tasks run on, including
+	 * the calling thread.
+	 **/
+	TaskExecutor(int threadcount);
+	virtual ~TaskExecutor();
+
+	int getThreadCount() const;
+
+	void Run(b2TaskFcn *task, void *context, int32 count) override;
+
+private:
+
+	class Worker : public love::thread::Threadable
+	{
+	public:
+
+		Worker(TaskExecutor *executor);
+		virtual ~Worker() {}
+
+		void threadFunction() override;
+
+	private:
+
+		TaskExecutor *executor;
+
+	}; // Worker
+
+	void runTasks();
+
+	std::vector<Worker *> workers;
+
+	love::thread::MutexRef mutex;
+	love::thread::ConditionalRef startCond;
+	love::thread::ConditionalRef doneCond;
+
+	b2TaskFcn *task;
+	void *context;
+	int32 count;
+	std::atomic<int32> nextIndex;
+
+	// Incremented for each call to Run, so workers know when to start.
+	uint64 batch;
+	int busyWorkers;
+	bool stopping;
+
+	// Box2D assertions throw, so errors in workers are passed back to Run.
+	std::string error;
+
+}; // TaskExecutor
+
+} // box2d
+} // physics
+} // love
+
+#endif // LOVE_PHYSICS_BOX2D_TASK_EXECUTOR_H
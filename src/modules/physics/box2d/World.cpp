@@ -20,15 +20,24 @@
 
 #include "World.h"
 
+#include "Body.h"
 #include "Shape.h"
 #include "Contact.h"
 #include "Physics.h"
+#include "TaskExecutor.h"
 #include "common/Reference.h"
+#include "common/Data.h"
+#include "common/math.h"
 
 // Needed for World::getJoints. It should be moved to wrapper code...
 #include "wrap_Joint.h"
 #include "wrap_Shape.h"
 
+// STD
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
 namespace love
 {
 namespace physics
@@ -76,7 +85,7 @@ void World::ContactCallback::process(b2Contact *contact, const b2ContactImpulse
 				throw love::Exception("A Shape has escaped Memoizer!");
 		}
 
-		Contact *cobj = (Contact *)world->findObject(contact);
+		Contact *cobj = (Contact *)(contact->GetUserData().pointer);
 		if (!cobj)
 			cobj = new Contact(world, contact);
 		else
@@ -164,7 +173,6 @@ World::CollectCallback::CollectCallback(World *world, uint16 categoryMask, lua_S
 	, categoryMask(categoryMask)
 	, L(L)
 {
-	lua_newtable(L);
 }
 
 World::CollectCallback::~CollectCallback()
@@ -264,13 +272,25 @@ void World::SayGoodbye(b2Joint *joint)
 	if (j) j->destroyJoint(true);
 }
 
+void World::SayGoodbye(b2Contact *contact)
+{
+	Contact *c = (Contact *)(contact->GetUserData().pointer);
+	if (c) c->invalidate();
+}
+
 World::World()
 	: world(nullptr)
+	, taskExecutor(nullptr)
+	, fixedTimeAccumulator(0.0f)
+	, interpolationAlpha(0.0f)
+	, movedBodiesStamp(1)
 	, destructWorld(false)
 	, begin(this)
 	, end(this)
 	, presolve(this)
 	, postsolve(this)
+	, deferContactEvents(false)
+	, deferPostSolve(false)
 {
 	world = new b2World(b2Vec2(0,0));
 	world->SetAllowSleeping(true);
@@ -279,16 +299,21 @@ World::World()
 	world->SetDestructionListener(this);
 	b2BodyDef def;
 	groundBody = world->CreateBody(&def);
-	registerObject(world, this);
 }
 
 World::World(b2Vec2 gravity, bool sleep)
 	: world(nullptr)
+	, taskExecutor(nullptr)
+	, fixedTimeAccumulator(0.0f)
+	, interpolationAlpha(0.0f)
+	, movedBodiesStamp(1)
 	, destructWorld(false)
 	, begin(this)
 	, end(this)
 	, presolve(this)
 	, postsolve(this)
+	, deferContactEvents(false)
+	, deferPostSolve(false)
 {
 	world = new b2World(Physics::scaleDown(gravity));
 	world->SetAllowSleeping(sleep);
@@ -297,12 +322,12 @@ World::World(b2Vec2 gravity, bool sleep)
 	world->SetDestructionListener(this);
 	b2BodyDef def;
 	groundBody = world->CreateBody(&def);
-	registerObject(world, this);
 }
 
 World::~World()
 {
 	destroy();
+	clearContactEvents();
 }
 
 void World::update(float dt)
@@ -312,7 +337,17 @@ void World::update(float dt)
 
 void World::update(float dt, int velocityIterations, int positionIterations)
 {
+	clearMovedBodies();
+	step(dt, velocityIterations, positionIterations);
+}
+
+void World::step(float dt, int velocityIterations, int positionIterations)
+{
+	// Bodies awake before the step may fall asleep during it, and sleeping
+	// ones may be woken up, so both count as moved.
+	addMovedBodies();
 	world->Step(dt, velocityIterations, positionIterations);
+	addMovedBodies();
 
 	// Destroy all objects marked during the time step.
 	for (Body *b : destructBodies)
@@ -341,17 +376,170 @@ void World::update(float dt, int velocityIterations, int positionIterations)
 		destroy();
 }
 
+int World::updateFixed(float dt, float fixedDt, int maxSteps, int velocityIterations, int positionIterations)
+{
+	if (fixedDt <= 0.0f)
+		throw love::Exception("The fixed time step must be greater than 0.");
+
+	fixedTimeAccumulator += std::max(dt, 0.0f);
+
+	int steps = std::min((int) (fixedTimeAccumulator / fixedDt), std::max(maxSteps, 0));
+	fixedTimeAccumulator -= steps * fixedDt;
+
+	// Drop whatever couldn't be simulated within maxSteps.
+	if (fixedTimeAccumulator >= fixedDt)
+		fixedTimeAccumulator = std::fmod(fixedTimeAccumulator, fixedDt);
+
+	interpolationAlpha = fixedTimeAccumulator / fixedDt;
+
+	clearMovedBodies();
+
+	for (int i = 0; i < steps && world != nullptr; i++)
+	{
+		// Only the transforms from before the last step are needed.
+		if (i == steps - 1)
+		{
+			for (b2Body *b = world->GetBodyList(); b; b = b->GetNext())
+			{
+				Body *body = (Body *)(b->GetUserData().pointer);
+				if (body != nullptr && b->GetType() != b2_staticBody)
+					body->savePreviousTransform();
+			}
+		}
+
+		step(fixedDt, velocityIterations, positionIterations);
+	}
+
+	return steps;
+}
+
+float World::getInterpolationAlpha() const
+{
+	return interpolationAlpha;
+}
+
+void World::clearMovedBodies()
+{
+	movedBodies.clear();
+	movedBodiesStamp++;
+}
+
+void World::addMovedBodies()
+{
+	for (b2Body *b = world->GetBodyList(); b; b = b->GetNext())
+	{
+		if (!b->IsAwake() || b->GetType() == b2_staticBody)
+			continue;
+
+		Body *body = (Body *)(b->GetUserData().pointer);
+		if (body != nullptr && body->movedStamp != movedBodiesStamp)
+		{
+			body->movedStamp = movedBodiesStamp;
+			movedBodies.push_back(body);
+		}
+	}
+}
+
+void World::removeMovedBody(Body *body)
+{
+	if (body->movedStamp != movedBodiesStamp)
+		return;
+
+	body->movedStamp = 0;
+	movedBodies.erase(std::remove(movedBodies.begin(), movedBodies.end(), body), movedBodies.end());
+}
+
+int World::getMovedBodies(lua_State *L) const
+{
+	int count = (int) movedBodies.size();
+	int oldlen = Physics::pushOutputTable(L, 1, count);
+
+	for (int i = 0; i < count; i++)
+	{
+		luax_pushtype(L, movedBodies[i]);
+		lua_rawseti(L, -2, i + 1);
+	}
+
+	Physics::trimOutputTable(L, -1, count, oldlen);
+
+	lua_pushinteger(L, count);
+	return 2;
+}
+
+// Stored in front of the Box2D state by saveState.
+struct WorldStateHeader
+{
+	uint32 magic;
+	uint32 size;
+	float fixedTimeAccumulator;
+	float interpolationAlpha;
+};
+
+static const uint32 WORLD_STATE_MAGIC = 0x5753504C;
+
+size_t World::getStateSize() const
+{
+	return sizeof(WorldStateHeader) + (size_t) world->GetStateSize();
+}
+
+void World::saveState(void *dst, size_t size) const
+{
+	size_t statesize = getStateSize();
+	if (size < statesize)
+		throw love::Exception("Not enough space to save the World's state (%d bytes are needed.)", (int) statesize);
+
+	if (world->IsLocked())
+		throw love::Exception("The World's state can't be saved during a World callback.");
+
+	WorldStateHeader header;
+	header.magic = WORLD_STATE_MAGIC;
+	header.size = (uint32) statesize;
+	header.fixedTimeAccumulator = fixedTimeAccumulator;
+	header.interpolationAlpha = interpolationAlpha;
+	memcpy(dst, &header, sizeof(WorldStateHeader));
+
+	uint8 *b2data = (uint8 *) dst + sizeof(WorldStateHeader);
+	world->SaveState(b2data, (int32) (statesize - sizeof(WorldStateHeader)));
+}
+
+void World::loadState(const void *src, size_t size)
+{
+	if (world->IsLocked())
+		throw love::Exception("The World's state can't be loaded during a World callback.");
+
+	WorldStateHeader header;
+	if (size < sizeof(WorldStateHeader))
+		throw love::Exception("Invalid World state.");
+
+	memcpy(&header, src, sizeof(WorldStateHeader));
+	if (header.magic != WORLD_STATE_MAGIC || header.size < sizeof(WorldStateHeader) || header.size > size)
+		throw love::Exception("Invalid World state.");
+
+	const uint8 *b2data = (const uint8 *) src + sizeof(WorldStateHeader);
+	if (!world->LoadState(b2data, (int32) (header.size - sizeof(WorldStateHeader))))
+		throw love::Exception("The World's state doesn't match its current Bodies, Shapes and Joints.");
+
+	fixedTimeAccumulator = header.fixedTimeAccumulator;
+	interpolationAlpha = header.interpolationAlpha;
+}
+
 void World::BeginContact(b2Contact *contact)
 {
-	begin.process(contact);
+	if (deferContactEvents)
+		recordContactEvent(CONTACT_EVENT_BEGIN, contact, nullptr);
+	else
+		begin.process(contact);
 }
 
 void World::EndContact(b2Contact *contact)
 {
-	end.process(contact);
+	if (deferContactEvents)
+		recordContactEvent(CONTACT_EVENT_END, contact, nullptr);
+	else
+		end.process(contact);
 
 	// Letting the Contact know that the b2Contact will be destroyed any second.
-	Contact *c = (Contact *)findObject(contact);
+	Contact *c = (Contact *)(contact->GetUserData().pointer);
 	if (c != nullptr)
 		c->invalidate();
 }
@@ -364,7 +552,58 @@ void World::PreSolve(b2Contact *contact, const b2Manifold *oldManifold)
 
 void World::PostSolve(b2Contact *contact, const b2ContactImpulse *impulse)
 {
-	postsolve.process(contact, impulse);
+	if (!deferContactEvents)
+		postsolve.process(contact, impulse);
+	else if (deferPostSolve)
+		recordContactEvent(CONTACT_EVENT_POSTSOLVE, contact, impulse);
+}
+
+void World::recordContactEvent(ContactEventType type, b2Contact *contact, const b2ContactImpulse *impulse)
+{
+	Shape *a = (Shape *)(contact->GetFixtureA()->GetUserData().pointer);
+	Shape *b = (Shape *)(contact->GetFixtureB()->GetUserData().pointer);
+	if (a == nullptr || b == nullptr)
+		throw love::Exception("A Shape has escaped Memoizer!");
+
+	contactEvents.emplace_back();
+	ContactEvent &e = contactEvents.back();
+
+	e.type = type;
+	e.a = a;
+	e.b = b;
+	e.normal = b2Vec2(0.0f, 0.0f);
+	e.pointCount = 0;
+
+	a->retain();
+	b->retain();
+
+	// The b2Contact is about to be destroyed after an end event.
+	if (type == CONTACT_EVENT_END)
+		return;
+
+	b2WorldManifold manifold;
+	contact->GetWorldManifold(&manifold);
+
+	e.normal = manifold.normal;
+	e.pointCount = contact->GetManifold()->pointCount;
+
+	for (int i = 0; i < e.pointCount; i++)
+	{
+		e.points[i] = Physics::scaleUp(manifold.points[i]);
+		e.normalImpulses[i] = impulse ? Physics::scaleUp(impulse->normalImpulses[i]) : 0.0f;
+		e.tangentImpulses[i] = impulse ? Physics::scaleUp(impulse->tangentImpulses[i]) : 0.0f;
+	}
+}
+
+void World::clearContactEvents()
+{
+	for (ContactEvent &e : contactEvents)
+	{
+		e.a->release();
+		e.b->release();
+	}
+
+	contactEvents.clear();
 }
 
 bool World::ShouldCollide(b2Fixture *fixtureA, b2Fixture *fixtureB)
@@ -462,6 +701,93 @@ void World::setCallbacksL(lua_State *L)
 	begin.L = end.L = presolve.L = postsolve.L = filter.L = L;
 }
 
+void World::setContactEventsDeferred(bool deferred, bool postsolve)
+{
+	deferContactEvents = deferred;
+	deferPostSolve = deferred && postsolve;
+
+	if (!deferred)
+		clearContactEvents();
+}
+
+bool World::isContactEventsDeferred() const
+{
+	return deferContactEvents;
+}
+
+int World::getContactEvents(lua_State *L)
+{
+	// The event tables in a reused list are reused too.
+	int count = (int) contactEvents.size();
+	int oldlen = Physics::pushOutputTable(L, 1, count);
+
+	for (int i = 0; i < count; i++)
+	{
+		const ContactEvent &e = contactEvents[i];
+
+		lua_rawgeti(L, -1, i + 1);
+		if (!lua_istable(L, -1))
+		{
+			lua_pop(L, 1);
+			lua_createtable(L, 0, 13);
+			lua_pushvalue(L, -1);
+			lua_rawseti(L, -3, i + 1);
+		}
+
+		const char *type = "begin";
+		if (e.type == CONTACT_EVENT_END)
+			type = "end";
+		else if (e.type == CONTACT_EVENT_POSTSOLVE)
+			type = "postsolve";
+
+		lua_pushstring(L, type);
+		lua_setfield(L, -2, "type");
+
+		luax_pushshape(L, e.a);
+		lua_setfield(L, -2, "shapeA");
+		luax_pushshape(L, e.b);
+		lua_setfield(L, -2, "shapeB");
+
+		bool hasnormal = e.type != CONTACT_EVENT_END;
+		bool hasimpulse = e.type == CONTACT_EVENT_POSTSOLVE;
+
+		hasnormal ? lua_pushnumber(L, e.normal.x) : lua_pushnil(L);
+		lua_setfield(L, -2, "normalX");
+		hasnormal ? lua_pushnumber(L, e.normal.y) : lua_pushnil(L);
+		lua_setfield(L, -2, "normalY");
+
+		static const char *pointfields[b2_maxManifoldPoints][4] =
+		{
+			{ "x1", "y1", "normalImpulse1", "tangentImpulse1" },
+			{ "x2", "y2", "normalImpulse2", "tangentImpulse2" },
+		};
+
+		for (int p = 0; p < b2_maxManifoldPoints; p++)
+		{
+			bool haspoint = p < e.pointCount;
+
+			haspoint ? lua_pushnumber(L, e.points[p].x) : lua_pushnil(L);
+			lua_setfield(L, -2, pointfields[p][0]);
+			haspoint ? lua_pushnumber(L, e.points[p].y) : lua_pushnil(L);
+			lua_setfield(L, -2, pointfields[p][1]);
+
+			haspoint && hasimpulse ? lua_pushnumber(L, e.normalImpulses[p]) : lua_pushnil(L);
+			lua_setfield(L, -2, pointfields[p][2]);
+			haspoint && hasimpulse ? lua_pushnumber(L, e.tangentImpulses[p]) : lua_pushnil(L);
+			lua_setfield(L, -2, pointfields[p][3]);
+		}
+
+		lua_pop(L, 1);
+	}
+
+	Physics::trimOutputTable(L, -1, count, oldlen);
+
+	clearContactEvents();
+
+	lua_pushinteger(L, count);
+	return 2;
+}
+
 int World::setContactFilter(lua_State *L)
 {
 	if (!lua_isnoneornil(L, 1))
@@ -508,11 +834,150 @@ bool World::isSleepingAllowed() const
 	return world->GetAllowSleeping();
 }
 
+void World::setThreadCount(int count)
+{
+	if (count < 1)
+		throw love::Exception("Thread count must be at least 1.");
+
+	if (world->IsLocked())
+		throw love::Exception("The thread count can't be changed during a World callback.");
+
+	if (count == getThreadCount())
+		return;
+
+	world->SetTaskExecutor(nullptr);
+	delete taskExecutor;
+	taskExecutor = nullptr;
+
+	if (count > 1)
+	{
+		taskExecutor = new TaskExecutor(count);
+		world->SetTaskExecutor(taskExecutor);
+	}
+}
+
+int World::getThreadCount() const
+{
+	return taskExecutor != nullptr ? taskExecutor->getThreadCount() : 1;
+}
+
 bool World::isLocked() const
 {
 	return world->IsLocked();
 }
 
+// Removes vertices which are on the line between their neighbours, and ones
+// which are too close to the previous vertex for Box2D to make an edge.
+static void mergeCollinearVertices(std::vector<Vector2> &verts, bool loop, float tolerance)
+{
+	float minlength = Physics::scaleUp(b2_linearSlop);
+	size_t mincount = loop ? 3 : 2;
+
+	std::vector<Vector2> merged;
+	merged.reserve(verts.size());
+
+	for (const Vector2 &v : verts)
+	{
+		if (merged.empty() || (v - merged.back()).getLength() > minlength)
+			merged.push_back(v);
+	}
+
+	if (loop)
+	{
+		while (merged.size() > mincount && (merged.front() - merged.back()).getLength() <= minlength)
+			merged.pop_back();
+	}
+
+	bool removed = true;
+	while (removed && merged.size() > mincount)
+	{
+		removed = false;
+		size_t count = merged.size();
+		size_t start = loop ? 0 : 1;
+		size_t end = loop ? count : count - 1;
+
+		std::vector<Vector2> kept;
+		kept.reserve(count);
+
+		for (size_t i = 0; i < count; i++)
+		{
+			if (i < start || i >= end || kept.size() + (count - i - 1) < mincount)
+			{
+				kept.push_back(merged[i]);
+				continue;
+			}
+
+			const Vector2 &prev = kept.empty() ? merged[(i + count - 1) % count] : kept.back();
+			const Vector2 &cur = merged[i];
+			const Vector2 &next = i + 1 < count ? merged[i + 1] : kept.front();
+
+			Vector2 dir = next - prev;
+			float length = dir.getLength();
+
+			// Distance from the vertex to the line through its neighbours,
+			// and whether it's between them rather than a reversal.
+			float dist = length > 0.0f ? std::abs(Vector2::cross(dir, cur - prev)) / length : (cur - prev).getLength();
+			bool between = Vector2::dot(cur - prev, next - cur) > 0.0f;
+
+			if (dist <= tolerance && between)
+				removed = true;
+			else
+				kept.push_back(cur);
+		}
+
+		merged.swap(kept);
+	}
+
+	verts.swap(merged);
+}
+
+Body *World::addStaticGeometry(const Vector2 *coords, int coordcount, const int *chainsizes, int chaincount, bool loop, bool mergeCollinear, float tolerance)
+{
+	int total = 0;
+	for (int i = 0; i < chaincount; i++)
+	{
+		int mincount = loop ? 3 : 2;
+		if (chainsizes[i] < mincount)
+			throw love::Exception("Chain %d must have at least %d vertices, got %d.", i + 1, mincount, chainsizes[i]);
+		total += chainsizes[i];
+	}
+
+	if (total != coordcount)
+		throw love::Exception("The chain sizes add up to %d vertices, but %d were given.", total, coordcount);
+
+	StrongRef<Body> body(new Body(this, b2Vec2(0, 0), Body::BODY_STATIC), Acquire::NORETAIN);
+
+	std::vector<Vector2> verts;
+	std::vector<b2Vec2> vecs;
+	for (int i = 0; i < chaincount; i++)
+	{
+		verts.assign(coords, coords + chainsizes[i]);
+		coords += chainsizes[i];
+
+		if (mergeCollinear)
+		{
+			mergeCollinearVertices(verts, loop, tolerance);
+			if (verts.size() < (loop ? 3u : 2u))
+				throw love::Exception("Chain %d has too few distinct vertices.", i + 1);
+		}
+
+		vecs.clear();
+		for (const Vector2 &v : verts)
+			vecs.push_back(Physics::scaleDown(b2Vec2(v.x, v.y)));
+
+		b2ChainShape s;
+		if (loop)
+			s.CreateLoop(vecs.data(), (int32) vecs.size());
+		else
+			s.CreateChain(vecs.data(), (int32) vecs.size(), vecs.front(), vecs.back());
+
+		StrongRef<ChainShape> shape(new ChainShape(body, s), Acquire::NORETAIN);
+	}
+
+	body->retain();
+	return body.get();
+}
+
 int World::getBodyCount() const
 {
 	return world->GetBodyCount()-1; // ignore the ground body
@@ -530,7 +995,10 @@ int World::getContactCount() const
 
 int World::getBodies(lua_State *L) const
 {
-	lua_newtable(L);
+	int oldlen = Physics::pushOutputTable(L, 1);
+	int tableidx = lua_gettop(L);
+	int objectsidx = luax_getobjectregistry(L);
+
 	b2Body *b = world->GetBodyList();
 	int i = 1;
 	do
@@ -542,17 +1010,26 @@ int World::getBodies(lua_State *L) const
 		Body *body = (Body *)(b->GetUserData().pointer);
 		if (!body)
 			throw love::Exception("A body has escaped Memoizer!");
-		luax_pushtype(L, body);
-		lua_rawseti(L, -2, i);
+		luax_pushtype(L, objectsidx, body);
+		lua_rawseti(L, tableidx, i);
 		i++;
 	}
 	while ((b = b->GetNext()));
+
+	// Remove the objects registry.
+	lua_pop(L, 1);
+
+	Physics::trimOutputTable(L, tableidx, i - 1, oldlen);
+
 	return 1;
 }
 
 int World::getJoints(lua_State *L) const
 {
-	lua_newtable(L);
+	int oldlen = Physics::pushOutputTable(L, 1);
+	int tableidx = lua_gettop(L);
+	int objectsidx = luax_getobjectregistry(L);
+
 	b2Joint *j = world->GetJointList();
 	int i = 1;
 	do
@@ -560,33 +1037,48 @@ int World::getJoints(lua_State *L) const
 		if (!j) break;
 		Joint *joint = (Joint *)(j->GetUserData().pointer);
 		if (!joint) throw love::Exception("A joint has escaped Memoizer!");
-		luax_pushjoint(L, joint);
-		lua_rawseti(L, -2, i);
+		luax_pushjoint(L, objectsidx, joint);
+		lua_rawseti(L, tableidx, i);
 		i++;
 	}
 	while ((j = j->GetNext()));
+
+	// Remove the objects registry.
+	lua_pop(L, 1);
+
+	Physics::trimOutputTable(L, tableidx, i - 1, oldlen);
+
 	return 1;
 }
 
 int World::getContacts(lua_State *L)
 {
-	lua_newtable(L);
+	int oldlen = Physics::pushOutputTable(L, 1);
+	int tableidx = lua_gettop(L);
+	int objectsidx = luax_getobjectregistry(L);
+
 	b2Contact *c = world->GetContactList();
 	int i = 1;
 	do
 	{
 		if (!c) break;
-		Contact *contact = (Contact *)findObject(c);
+		Contact *contact = (Contact *)(c->GetUserData().pointer);
 		if (!contact)
 			contact = new Contact(this, c);
 		else
 			contact->retain();
-		luax_pushtype(L, contact);
+		luax_pushtype(L, objectsidx, contact);
 		contact->release();
-		lua_rawseti(L, -2, i);
+		lua_rawseti(L, tableidx, i);
 		i++;
 	}
 	while ((c = c->GetNext()));
+
+	// Remove the objects registry.
+	lua_pop(L, 1);
+
+	Physics::trimOutputTable(L, tableidx, i - 1, oldlen);
+
 	return 1;
 }
 
@@ -620,9 +1112,17 @@ int World::getShapesInArea(lua_State *L)
 	b2AABB box;
 	box.lowerBound = Physics::scaleDown(b2Vec2(lx, ly));
 	box.upperBound = Physics::scaleDown(b2Vec2(ux, uy));
+
+	int oldlen = Physics::pushOutputTable(L, 6);
+
 	CollectCallback query(this, categoryMaskBits, L);
 	world->QueryAABB(&query, box);
-	return 1;
+
+	int count = query.getCount();
+	Physics::trimOutputTable(L, -1, count, oldlen);
+
+	lua_pushinteger(L, count);
+	return 2;
 }
 
 int World::rayCast(lua_State *L)
@@ -668,6 +1168,81 @@ int World::rayCastAny(lua_State *L)
 	return 0;
 }
 
+int World::rayCastMany(lua_State *L)
+{
+	// Each ray is 4 numbers (x1, y1, x2, y2), in a table or a Data of floats.
+	const float *raydata = nullptr;
+	int raycount = 0;
+	bool raytable = lua_istable(L, 1);
+	if (raytable)
+		raycount = (int) luax_objlen(L, 1) / 4;
+	else
+	{
+		love::Data *data = luax_checktype<love::Data>(L, 1);
+		raydata = (const float *) data->getData();
+		raycount = (int) (data->getSize() / (sizeof(float) * 4));
+	}
+
+	luaL_checktype(L, 2, LUA_TTABLE);
+	bool fractions = !lua_isnoneornil(L, 3);
+	if (fractions)
+		luaL_checktype(L, 3, LUA_TTABLE);
+	bool closest = luax_optboolean(L, 4, true);
+	uint16 categoryMaskBits = (uint16)luaL_optinteger(L, 5, 0xFFFF);
+
+	int oldlen = (int) luax_objlen(L, 2);
+	int oldfractionlen = fractions ? (int) luax_objlen(L, 3) : 0;
+	int hits = 0;
+
+	for (int i = 0; i < raycount; i++)
+	{
+		float ray[4];
+		if (raytable)
+		{
+			for (int j = 0; j < 4; j++)
+			{
+				lua_rawgeti(L, 1, i * 4 + j + 1);
+				ray[j] = (float) lua_tonumber(L, -1);
+				lua_pop(L, 1);
+			}
+		}
+		else
+			memcpy(ray, raydata + i * 4, sizeof(ray));
+
+		b2Vec2 v1 = Physics::scaleDown(b2Vec2(ray[0], ray[1]));
+		b2Vec2 v2 = Physics::scaleDown(b2Vec2(ray[2], ray[3]));
+		RayCastOneCallback raycast(categoryMaskBits, !closest);
+
+		// Box2D asserts on zero-length rays, which can't hit anything anyway.
+		if ((v2 - v1).LengthSquared() > 0.0f)
+			world->RayCast(&raycast, v1, v2);
+
+		if (raycast.hitFixture)
+		{
+			Shape *f = (Shape *)(raycast.hitFixture->GetUserData().pointer);
+			if (f == nullptr)
+				throw love::Exception("A Shape has escaped Memoizer!");
+			luax_pushshape(L, f);
+			hits++;
+		}
+		else
+			lua_pushboolean(L, 0);
+		lua_rawseti(L, 2, i + 1);
+
+		if (fractions)
+		{
+			lua_pushnumber(L, raycast.hitFraction);
+			lua_rawseti(L, 3, i + 1);
+		}
+	}
+
+	Physics::trimOutputTable(L, 2, raycount, oldlen);
+	Physics::trimOutputTable(L, 3, raycount, oldfractionlen);
+
+	lua_pushinteger(L, hits);
+	return 1;
+}
+
 int World::rayCastClosest(lua_State *L)
 {
 	float x1 = (float)luaL_checknumber(L, 1);
@@ -697,6 +1272,179 @@ int World::rayCastClosest(lua_State *L)
 	return 0;
 }
 
+// Turns Box2D's debug draw calls into triangles, scaled to world units.
+class DebugDrawer : public b2Draw
+{
+public:
+
+	DebugDrawer(std::vector<graphics::Vertex> &vertices, float lineWidth)
+		: vertices(vertices)
+		, halfWidth(lineWidth * 0.5f)
+	{
+	}
+
+	void DrawPolygon(const b2Vec2 *verts, int32 count, const b2Color &color) override
+	{
+		Color32 c = toColor32(Colorf(color.r, color.g, color.b, color.a));
+		for (int32 i = 0; i < count; i++)
+			addLine(verts[i], verts[(i + 1) % count], c);
+	}
+
+	void DrawSolidPolygon(const b2Vec2 *verts, int32 count, const b2Color &color) override
+	{
+		Color32 fill = toColor32(Colorf(color.r * 0.5f, color.g * 0.5f, color.b * 0.5f, 0.5f));
+		for (int32 i = 1; i < count - 1; i++)
+		{
+			addVertex(verts[0], fill);
+			addVertex(verts[i], fill);
+			addVertex(verts[i + 1], fill);
+		}
+
+		DrawPolygon(verts, count, color);
+	}
+
+	void DrawCircle(const b2Vec2 &center, float radius, const b2Color &color) override
+	{
+		b2Vec2 verts[CIRCLE_SEGMENTS];
+		getCirclePoints(center, radius, verts);
+		DrawPolygon(verts, CIRCLE_SEGMENTS, color);
+	}
+
+	void DrawSolidCircle(const b2Vec2 &center, float radius, const b2Vec2 &axis, const b2Color &color) override
+	{
+		b2Vec2 verts[CIRCLE_SEGMENTS];
+		getCirclePoints(center, radius, verts);
+		DrawSolidPolygon(verts, CIRCLE_SEGMENTS, color);
+		DrawSegment(center, center + radius * axis, color);
+	}
+
+	void DrawSegment(const b2Vec2 &p1, const b2Vec2 &p2, const b2Color &color) override
+	{
+		addLine(p1, p2, toColor32(Colorf(color.r, color.g, color.b, color.a)));
+	}
+
+	void DrawTransform(const b2Transform &xf) override
+	{
+		const float axisscale = 0.4f;
+		DrawSegment(xf.p, xf.p + axisscale * xf.q.GetXAxis(), b2Color(1.0f, 0.0f, 0.0f));
+		DrawSegment(xf.p, xf.p + axisscale * xf.q.GetYAxis(), b2Color(0.0f, 1.0f, 0.0f));
+	}
+
+	void DrawPoint(const b2Vec2 &p, float size, const b2Color &color) override
+	{
+		// The size is in world units already.
+		Color32 c = toColor32(Colorf(color.r, color.g, color.b, color.a));
+		Vector2 center = toVector(p);
+		float h = size * 0.5f;
+		Vector2 corners[4] = {
+			Vector2(center.x - h, center.y - h),
+			Vector2(center.x + h, center.y - h),
+			Vector2(center.x + h, center.y + h),
+			Vector2(center.x - h, center.y + h),
+		};
+		addQuad(corners, c);
+	}
+
+private:
+
+	static const int CIRCLE_SEGMENTS = 16;
+
+	static Vector2 toVector(const b2Vec2 &v)
+	{
+		b2Vec2 scaled = Physics::scaleUp(v);
+		return Vector2(scaled.x, scaled.y);
+	}
+
+	void getCirclePoints(const b2Vec2 &center, float radius, b2Vec2 *verts) const
+	{
+		for (int i = 0; i < CIRCLE_SEGMENTS; i++)
+		{
+			float angle = (float) i * (2.0f * (float) LOVE_M_PI / CIRCLE_SEGMENTS);
+			verts[i] = center + radius * b2Vec2(cosf(angle), sinf(angle));
+		}
+	}
+
+	void addVertex(const Vector2 &v, Color32 color)
+	{
+		graphics::Vertex vert = {v.x, v.y, 0.0f, 0.0f, color};
+		vertices.push_back(vert);
+	}
+
+	void addVertex(const b2Vec2 &v, Color32 color)
+	{
+		addVertex(toVector(v), color);
+	}
+
+	void addQuad(const Vector2 *corners, Color32 color)
+	{
+		addVertex(corners[0], color);
+		addVertex(corners[1], color);
+		addVertex(corners[2], color);
+		addVertex(corners[0], color);
+		addVertex(corners[2], color);
+		addVertex(corners[3], color);
+	}
+
+	void addLine(const b2Vec2 &p1, const b2Vec2 &p2, Color32 color)
+	{
+		Vector2 a = toVector(p1);
+		Vector2 b = toVector(p2);
+		Vector2 dir = b - a;
+		float length = dir.getLength();
+		if (length <= 0.0f)
+			return;
+
+		Vector2 n = dir.getNormal(halfWidth / length);
+		Vector2 corners[4] = {a + n, b + n, b - n, a - n};
+		addQuad(corners, color);
+	}
+
+	std::vector<graphics::Vertex> &vertices;
+	float halfWidth;
+
+}; // DebugDrawer
+
+void World::debugDraw(const DebugDrawSettings &settings, std::vector<graphics::Vertex> &vertices)
+{
+	vertices.clear();
+
+	DebugDrawer drawer(vertices, settings.lineWidth);
+
+	uint32 flags = 0;
+	if (settings.shapes)
+		flags |= b2Draw::e_shapeBit;
+	if (settings.joints)
+		flags |= b2Draw::e_jointBit;
+	if (settings.boundingBoxes)
+		flags |= b2Draw::e_aabbBit;
+	if (settings.centersOfMass)
+		flags |= b2Draw::e_centerOfMassBit;
+
+	drawer.SetFlags(flags);
+
+	world->SetDebugDraw(&drawer);
+	world->DebugDraw();
+	world->SetDebugDraw(nullptr);
+
+	if (settings.contacts)
+	{
+		b2Color color(1.0f, 0.3f, 0.3f);
+		float size = std::max(settings.lineWidth * 4.0f, 2.0f);
+
+		for (b2Contact *c = world->GetContactList(); c != nullptr; c = c->GetNext())
+		{
+			if (!c->IsTouching())
+				continue;
+
+			b2WorldManifold manifold;
+			c->GetWorldManifold(&manifold);
+
+			for (int i = 0; i < c->GetManifold()->pointCount; i++)
+				drawer.DrawPoint(manifold.points[i], size, color);
+		}
+	}
+}
+
 void World::destroy()
 {
 	if (world == nullptr)
@@ -718,6 +1466,8 @@ void World::destroy()
 	//disable callbacks
 	begin.ref = end.ref = presolve.ref = postsolve.ref = filter.ref = nullptr;
 
+	clearMovedBodies();
+
 	// Cleaning up the world.
 	b2Body *b = world->GetBodyList();
 	while (b)
@@ -733,29 +1483,14 @@ void World::destroy()
 	}
 
 	world->DestroyBody(groundBody);
-	unregisterObject(world);
+
+	clearContactEvents();
 
 	delete world;
 	world = nullptr;
-}
 
-void World::registerObject(void *b2object, love::Object *object)
-{
-	box2dObjectMap[b2object] = object;
-}
-
-void World::unregisterObject(void *b2object)
-{
-	box2dObjectMap.erase(b2object);
-}
-
-love::Object *World::findObject(void *b2object) const
-{
-	auto it = box2dObjectMap.find(b2object);
-	if (it != box2dObjectMap.end())
-		return it->second;
-	else
-		return nullptr;
+	delete taskExecutor;
+	taskExecutor = nullptr;
 }
 
 } // box2d
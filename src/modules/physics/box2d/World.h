@@ -25,10 +25,11 @@
 #include "common/Object.h"
 #include "common/runtime.h"
 #include "common/Reference.h"
+#include "common/Vector.h"
+#include "graphics/vertex.h"
 
 // STD
 #include <vector>
-#include <unordered_map>
 
 // Box2D
 #include <box2d/Box2D.h>
@@ -44,6 +45,7 @@ class Contact;
 class Body;
 class Shape;
 class Joint;
+class TaskExecutor;
 
 /**
  * The World is the "God" container class,
@@ -69,6 +71,43 @@ public:
 
 	static love::Type type;
 
+	enum ContactEventType
+	{
+		CONTACT_EVENT_BEGIN,
+		CONTACT_EVENT_END,
+		CONTACT_EVENT_POSTSOLVE,
+	};
+
+	/**
+	 * A contact event recorded during update() when contact events are
+	 * deferred. The Shapes are retained until the event is delivered.
+	 **/
+	struct ContactEvent
+	{
+		ContactEventType type;
+		Shape *a;
+		Shape *b;
+		b2Vec2 normal;
+		b2Vec2 points[b2_maxManifoldPoints];
+		float normalImpulses[b2_maxManifoldPoints];
+		float tangentImpulses[b2_maxManifoldPoints];
+		int pointCount;
+	};
+
+	/**
+	 * What debugDraw generates geometry for. The line width is in world
+	 * (pixel) units.
+	 **/
+	struct DebugDrawSettings
+	{
+		bool shapes = true;
+		bool joints = true;
+		bool contacts = true;
+		bool boundingBoxes = false;
+		bool centersOfMass = false;
+		float lineWidth = 1.0f;
+	};
+
 	class ContactCallback
 	{
 	public:
@@ -109,6 +148,7 @@ public:
 		CollectCallback(World *world, uint16 categoryMask, lua_State *L);
 		virtual ~CollectCallback();
 		bool ReportFixture(b2Fixture *fixture) override;
+		int getCount() const { return i - 1; }
 	private:
 		World *world;
 		uint16 categoryMask;
@@ -171,11 +211,51 @@ public:
 	void update(float dt);
 	void update(float dt, int velocityIterations, int positionIterations);
 
+	/**
+	 * Advances the world in whole steps of fixedDt, carrying the rest of dt
+	 * over to the next call. At most maxSteps steps are taken and any time
+	 * beyond that is dropped, so one slow frame can't snowball. Each Body's
+	 * transform from before the last step is kept for interpolation.
+	 * @return The number of steps taken.
+	 **/
+	int updateFixed(float dt, float fixedDt, int maxSteps, int velocityIterations, int positionIterations);
+
+	/**
+	 * Gets how far the time carried over by updateFixed is into the next
+	 * step, from 0 to 1.
+	 **/
+	float getInterpolationAlpha() const;
+
+	/**
+	 * Gets the Bodies which were awake during the last update or updateFixed
+	 * call, so only those need to be read back. Static Bodies are never
+	 * included. An existing table can be passed in to be reused.
+	 **/
+	int getMovedBodies(lua_State *L) const;
+
+	/**
+	 * Gets the number of bytes needed by saveState.
+	 **/
+	size_t getStateSize() const;
+
+	/**
+	 * Copies the simulation state of every Body, Joint and contact, and the
+	 * time carried over by updateFixed, so the World can be rolled back to it.
+	 **/
+	void saveState(void *dst, size_t size) const;
+
+	/**
+	 * Restores a state from saveState. The World must still have exactly the
+	 * same Bodies, Shapes and Joints. Existing Contacts become invalid.
+	 **/
+	void loadState(const void *src, size_t size);
+
 	// From b2ContactListener
 	void BeginContact(b2Contact *contact);
 	void EndContact(b2Contact *contact);
 	void PreSolve(b2Contact *contact, const b2Manifold *oldManifold);
 	void PostSolve(b2Contact *contact, const b2ContactImpulse *impulse);
+	void SayGoodbye(b2Contact *contact);
 
 	// From b2ContactFilter
 	bool ShouldCollide(b2Fixture *fixtureA, b2Fixture *fixtureB);
@@ -209,6 +289,22 @@ public:
 	 **/
 	void setCallbacksL(lua_State *L);
 
+	/**
+	 * When deferred, begin, end and (optionally) postsolve contact events are
+	 * recorded during update() instead of calling their Lua callbacks, and are
+	 * collected afterwards with getContactEvents. The presolve callback is
+	 * still called during update(), since it can change how contacts resolve.
+	 **/
+	void setContactEventsDeferred(bool deferred, bool postsolve);
+	bool isContactEventsDeferred() const;
+
+	/**
+	 * Pushes a table of the recorded contact events and their count, reusing
+	 * the table (and tables in it) at index 1 if there is one. The recorded
+	 * events are cleared.
+	 **/
+	int getContactEvents(lua_State *L);
+
 	/**
 	 * Sets the ContactFilter callback.
 	 **/
@@ -252,6 +348,19 @@ public:
 	 **/
 	bool isSleepingAllowed() const;
 
+	/**
+	 * Sets the number of threads used to solve independent islands (groups of
+	 * touching or jointed bodies) during update(). The results are the same
+	 * for any thread count.
+	 * @param count The number of threads, including the calling thread.
+	 **/
+	void setThreadCount(int count);
+
+	/**
+	 * Gets the number of threads used to solve islands during update().
+	 **/
+	int getThreadCount() const;
+
 	/**
 	 * Returns whether this World is currently locked.
 	 * If it's locked, it's in the middle of a timestep.
@@ -259,6 +368,15 @@ public:
 	 **/
 	bool isLocked() const;
 
+	/**
+	 * Creates a static Body at the origin with one ChainShape per chain, in a
+	 * single call. The chains' vertices are stored one after the other in
+	 * coords. When mergeCollinear is true, vertices which lie on a straight
+	 * line between their neighbours (within the given tolerance) are removed,
+	 * so the chains have fewer edges and broadphase proxies.
+	 **/
+	Body *addStaticGeometry(const Vector2 *coords, int coordcount, const int *chainsizes, int chaincount, bool loop, bool mergeCollinear, float tolerance);
+
 	/**
 	 * Get the current body count.
 	 * @return The number of bodies.
@@ -307,7 +425,8 @@ public:
 	int queryShapesInArea(lua_State *L);
 
 	/**
-	 * Gets all Shapes that overlap a given bounding box.
+	 * Gets all Shapes that overlap a given bounding box, and their count. The
+	 * Shapes are put in an existing table instead of a new one if it's given.
 	 **/
 	int getShapesInArea(lua_State *L);
 
@@ -319,14 +438,25 @@ public:
 	int rayCastAny(lua_State *L);
 	int rayCastClosest(lua_State *L);
 
+	/**
+	 * Raycasts many rays at once, putting the Shape hit by each ray (or false)
+	 * and optionally the hit fractions into existing tables. Returns the
+	 * number of rays which hit something.
+	 **/
+	int rayCastMany(lua_State *L);
+
+	/**
+	 * Generates triangles for the outlines of every Shape, Joint, Contact
+	 * point and (optionally) bounding box in the World, in world coordinates,
+	 * so they can all be drawn with a single Mesh.
+	 **/
+	void debugDraw(const DebugDrawSettings &settings, std::vector<graphics::Vertex> &vertices);
+
 	/**
 	 * Destroy this world.
 	 **/
 	void destroy();
 
-	void registerObject(void *b2object, love::Object *object);
-	void unregisterObject(void *b2object);
-	love::Object *findObject(void *b2object) const;
 
 private:
 
@@ -336,6 +466,24 @@ private:
 	// Ground body
 	b2Body *groundBody;
 
+	// Solves islands on other threads, if there's more than one.
+	TaskExecutor *taskExecutor;
+
+	// Time carried over between calls to updateFixed.
+	float fixedTimeAccumulator;
+	float interpolationAlpha;
+
+	void step(float dt, int velocityIterations, int positionIterations);
+
+	void clearMovedBodies();
+	void addMovedBodies();
+	void removeMovedBody(Body *body);
+
+	// Bodies awake during the last update. A Body's movedStamp matches
+	// movedBodiesStamp while it's in the list.
+	std::vector<Body *> movedBodies;
+	uint32 movedBodiesStamp;
+
 	// The list of to be destructed bodies.
 	std::vector<Body *> destructBodies;
 	std::vector<Shape *> destructShapes;
@@ -346,7 +494,13 @@ private:
 	ContactCallback begin, end, presolve, postsolve;
 	ContactFilter filter;
 
-	std::unordered_map<void *, love::Object *> box2dObjectMap;
+	void recordContactEvent(ContactEventType type, b2Contact *contact, const b2ContactImpulse *impulse);
+	void clearContactEvents();
+
+	// Deferred contact events.
+	bool deferContactEvents;
+	bool deferPostSolve;
+	std::vector<ContactEvent> contactEvents;
 
 }; // World
 
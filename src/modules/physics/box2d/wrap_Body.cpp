@@ -22,6 +22,11 @@
 #include "wrap_Physics.h"
 #include "wrap_Shape.h"
 
+// Shove the wrap_Body.lua code directly into a raw string literal.
+static const char body_lua[] =
+#include "wrap_Body.lua"
+;
+
 namespace love
 {
 namespace physics
@@ -29,6 +34,11 @@ namespace physics
 namespace box2d
 {
 
+/**
+ * NOTE: Additional wrapper code is in wrap_Body.lua. Be sure to keep it in
+ * sync with any changes made to this file!
+ **/
+
 Body *luax_checkbody(lua_State *L, int idx)
 {
 	Body *b = luax_checktype<Body>(L, idx);
@@ -70,6 +80,27 @@ int w_Body_getPosition(lua_State *L)
 	return 2;
 }
 
+int w_Body_getInterpolatedPosition(lua_State *L)
+{
+	Body *t = luax_checkbody(L, 1);
+	float alpha = (float) luaL_optnumber(L, 2, t->getWorld()->getInterpolationAlpha());
+
+	float x_o, y_o;
+	t->getInterpolatedPosition(alpha, x_o, y_o);
+	lua_pushnumber(L, x_o);
+	lua_pushnumber(L, y_o);
+
+	return 2;
+}
+
+int w_Body_getInterpolatedAngle(lua_State *L)
+{
+	Body *t = luax_checkbody(L, 1);
+	float alpha = (float) luaL_optnumber(L, 2, t->getWorld()->getInterpolationAlpha());
+	lua_pushnumber(L, t->getInterpolatedAngle(alpha));
+	return 1;
+}
+
 int w_Body_getTransform(lua_State *L)
 {
 	Body *t = luax_checkbody(L, 1);
@@ -679,12 +710,43 @@ int w_Body_getUserData(lua_State *L)
 	return t->getUserData(L);
 }
 
+// C functions in a struct, necessary for the FFI versions of Body methods.
+struct FFI_Body
+{
+	bool (*getTransform)(Proxy *p, float *out);
+	bool (*getVelocity)(Proxy *p, float *out);
+};
+
+static FFI_Body ffifuncs =
+{
+	[](Proxy *p, float *out) -> bool // getTransform
+	{
+		auto b = luax_ffi_checktype<Body>(p);
+		if (b == nullptr || b->body == nullptr)
+			return false;
+		b->getPosition(out[0], out[1]);
+		out[2] = b->getAngle();
+		return true;
+	},
+	[](Proxy *p, float *out) -> bool // getVelocity
+	{
+		auto b = luax_ffi_checktype<Body>(p);
+		if (b == nullptr || b->body == nullptr)
+			return false;
+		b->getLinearVelocity(out[0], out[1]);
+		out[2] = b->getAngularVelocity();
+		return true;
+	},
+};
+
 static const luaL_Reg w_Body_functions[] =
 {
 	{ "getX", w_Body_getX },
 	{ "getY", w_Body_getY },
 	{ "getAngle", w_Body_getAngle },
 	{ "getPosition", w_Body_getPosition },
+	{ "getInterpolatedPosition", w_Body_getInterpolatedPosition },
+	{ "getInterpolatedAngle", w_Body_getInterpolatedAngle },
 	{ "getTransform", w_Body_getTransform },
 	{ "setTransform", w_Body_setTransform },
 	{ "getLinearVelocity", w_Body_getLinearVelocity },
@@ -756,7 +818,9 @@ static const luaL_Reg w_Body_functions[] =
 
 extern "C" int luaopen_body(lua_State *L)
 {
-	return luax_register_type(L, &Body::type, w_Body_functions, nullptr);
+	int ret = luax_register_type(L, &Body::type, w_Body_functions, nullptr);
+	luax_runwrapper(L, body_lua, sizeof(body_lua), "Body.lua", Body::type, &ffifuncs);
+	return ret;
 }
 
 } // box2d
@@ -0,0 +1,109 @@
+R"luastring"--(
+-- DO NOT REMOVE THE ABOVE LINE. It is used to load this file as a C++ string.
+-- There is a matching delimiter at the bottom of the file.
+
+--[[
+Copyright (c) 2006-2024 LOVE Development Team
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+claim that you wrote the original software. If you use this software
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+--]]
+
+
+local Body_mt, ffifuncspointer_str, ffiwrapper = ...
+local Body = Body_mt.__index
+
+-- Everything below this point is efficient FFI replacements for existing
+-- Body functionality.
+
+if ffiwrapper == nil or not ffiwrapper.isjitenabled() then return end
+
+local ffi = ffiwrapper.ffi
+local tonumber = tonumber
+
+-- Matches the struct declaration in wrap_Body.cpp.
+local ffifuncs = ffiwrapper.getfuncs("FFI_Body", [[
+typedef struct FFI_Body
+{
+	bool (*getTransform)(Proxy *p, float *out);
+	bool (*getVelocity)(Proxy *p, float *out);
+} FFI_Body;
+]], ffifuncspointer_str)
+
+local values = ffi.new("float[3]")
+
+local _getX = Body.getX
+local _getY = Body.getY
+local _getAngle = Body.getAngle
+local _getPosition = Body.getPosition
+local _getTransform = Body.getTransform
+local _getLinearVelocity = Body.getLinearVelocity
+local _getAngularVelocity = Body.getAngularVelocity
+
+-- The FFI functions return false for an invalid, released or destroyed Body,
+-- in which case the regular methods are called to raise the usual error.
+
+function Body:getX()
+	if ffifuncs.getTransform(self, values) then
+		return tonumber(values[0])
+	end
+	return _getX(self)
+end
+
+function Body:getY()
+	if ffifuncs.getTransform(self, values) then
+		return tonumber(values[1])
+	end
+	return _getY(self)
+end
+
+function Body:getAngle()
+	if ffifuncs.getTransform(self, values) then
+		return tonumber(values[2])
+	end
+	return _getAngle(self)
+end
+
+function Body:getPosition()
+	if ffifuncs.getTransform(self, values) then
+		return tonumber(values[0]), tonumber(values[1])
+	end
+	return _getPosition(self)
+end
+
+function Body:getTransform()
+	if ffifuncs.getTransform(self, values) then
+		return tonumber(values[0]), tonumber(values[1]), tonumber(values[2])
+	end
+	return _getTransform(self)
+end
+
+function Body:getLinearVelocity()
+	if ffifuncs.getVelocity(self, values) then
+		return tonumber(values[0]), tonumber(values[1])
+	end
+	return _getLinearVelocity(self)
+end
+
+function Body:getAngularVelocity()
+	if ffifuncs.getVelocity(self, values) then
+		return tonumber(values[2])
+	end
+	return _getAngularVelocity(self)
+end
+
+-- DO NOT REMOVE THE NEXT LINE. It is used to load this file as a C++ string.
+--)luastring"--"
@@ -41,7 +41,7 @@ namespace physics
 namespace box2d
 {
 
-void luax_pushjoint(lua_State *L, Joint *j)
+void luax_pushjoint(lua_State *L, int objectsidx, Joint *j)
 {
 	if (j == nullptr)
 		return lua_pushnil(L);
@@ -49,32 +49,42 @@ void luax_pushjoint(lua_State *L, Joint *j)
 	switch (j->getType())
 	{
 	case Joint::JOINT_DISTANCE:
-		return luax_pushtype(L, DistanceJoint::type, j);
+		return luax_pushtype(L, objectsidx, DistanceJoint::type, j);
 	case Joint::JOINT_REVOLUTE:
-		return luax_pushtype(L, RevoluteJoint::type, j);
+		return luax_pushtype(L, objectsidx, RevoluteJoint::type, j);
 	case Joint::JOINT_PRISMATIC:
-		return luax_pushtype(L, PrismaticJoint::type, j);
+		return luax_pushtype(L, objectsidx, PrismaticJoint::type, j);
 	case Joint::JOINT_MOUSE:
-		return luax_pushtype(L, MouseJoint::type, j);
+		return luax_pushtype(L, objectsidx, MouseJoint::type, j);
 	case Joint::JOINT_PULLEY:
-		return luax_pushtype(L, PulleyJoint::type, j);
+		return luax_pushtype(L, objectsidx, PulleyJoint::type, j);
 	case Joint::JOINT_GEAR:
-		return luax_pushtype(L, GearJoint::type, j);
+		return luax_pushtype(L, objectsidx, GearJoint::type, j);
 	case Joint::JOINT_FRICTION:
-		return luax_pushtype(L, FrictionJoint::type, j);
+		return luax_pushtype(L, objectsidx, FrictionJoint::type, j);
 	case Joint::JOINT_WELD:
-		return luax_pushtype(L, WeldJoint::type, j);
+		return luax_pushtype(L, objectsidx, WeldJoint::type, j);
 	case Joint::JOINT_WHEEL:
-		return luax_pushtype(L, WheelJoint::type, j);
+		return luax_pushtype(L, objectsidx, WheelJoint::type, j);
 	case Joint::JOINT_ROPE:
-		return luax_pushtype(L, RopeJoint::type, j);
+		return luax_pushtype(L, objectsidx, RopeJoint::type, j);
 	case Joint::JOINT_MOTOR:
-		return luax_pushtype(L, MotorJoint::type, j);
+		return luax_pushtype(L, objectsidx, MotorJoint::type, j);
 	default:
 		return lua_pushnil(L);
 	}
 }
 
+void luax_pushjoint(lua_State *L, Joint *j)
+{
+	if (j == nullptr)
+		return lua_pushnil(L);
+
+	int objectsidx = luax_getobjectregistry(L);
+	luax_pushjoint(L, objectsidx, j);
+	lua_remove(L, -2);
+}
+
 Joint *luax_checkjoint(lua_State *L, int idx)
 {
 	Joint *t = luax_checktype<Joint>(L, idx);
@@ -33,6 +33,9 @@ namespace box2d
 {
 
 void luax_pushjoint(lua_State *L, Joint *j);
+
+// Uses the objects registry at objectsidx, see luax_getobjectregistry.
+void luax_pushjoint(lua_State *L, int objectsidx, Joint *j);
 Joint *luax_checkjoint(lua_State *L, int idx);
 extern "C" int luaopen_joint(lua_State *L);
 
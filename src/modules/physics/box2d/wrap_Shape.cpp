@@ -33,26 +33,26 @@ Shape *luax_checkshape(lua_State *L, int idx)
 	return luax_checktype<Shape>(L, idx);
 }
 
-void luax_pushshape(lua_State *L, Shape *shape)
+void luax_pushshape(lua_State *L, int objectsidx, Shape *shape)
 {
 	if (shape != nullptr)
 	{
 		switch (shape->getType())
 		{
 		case Shape::SHAPE_CIRCLE:
-			luax_pushtype(L, (CircleShape *) shape);
+			luax_pushtype(L, objectsidx, CircleShape::type, shape);
 			break;
 		case Shape::SHAPE_POLYGON:
-			luax_pushtype(L, (PolygonShape *) shape);
+			luax_pushtype(L, objectsidx, PolygonShape::type, shape);
 			break;
 		case Shape::SHAPE_EDGE:
-			luax_pushtype(L, (EdgeShape *) shape);
+			luax_pushtype(L, objectsidx, EdgeShape::type, shape);
 			break;
 		case Shape::SHAPE_CHAIN:
-			luax_pushtype(L, (ChainShape *) shape);
+			luax_pushtype(L, objectsidx, ChainShape::type, shape);
 			break;
 		default:
-			luax_pushtype(L, shape);
+			luax_pushtype(L, objectsidx, Shape::type, shape);
 			break;
 		}
 	}
@@ -62,6 +62,16 @@ void luax_pushshape(lua_State *L, Shape *shape)
 	}
 }
 
+void luax_pushshape(lua_State *L, Shape *shape)
+{
+	if (shape == nullptr)
+		return lua_pushnil(L);
+
+	int objectsidx = luax_getobjectregistry(L);
+	luax_pushshape(L, objectsidx, shape);
+	lua_remove(L, -2);
+}
+
 int w_Shape_getType(lua_State *L)
 {
 	Shape *t = luax_checkshape(L, 1);
@@ -35,6 +35,9 @@ namespace box2d
 
 Shape *luax_checkshape(lua_State *L, int idx);
 void luax_pushshape(lua_State *L, Shape *shape);
+
+// Uses the objects registry at objectsidx, see luax_getobjectregistry.
+void luax_pushshape(lua_State *L, int objectsidx, Shape *shape);
 extern "C" int luaopen_shape(lua_State *L);
 
 extern const luaL_Reg w_Shape_functions[];
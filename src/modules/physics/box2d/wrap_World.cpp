@@ -19,6 +19,13 @@
  **/
 
 #include "wrap_World.h"
+#include "wrap_Body.h"
+#include "common/Data.h"
+#include "data/ByteData.h"
+#include "graphics/Graphics.h"
+
+// C
+#include <cstring>
 
 namespace love
 {
@@ -55,6 +62,81 @@ int w_World_update(lua_State *L)
 	return 0;
 }
 
+int w_World_updateFixed(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	float dt = (float)luaL_checknumber(L, 2);
+	float fixeddt = (float)luaL_checknumber(L, 3);
+	int maxsteps = (int) luaL_optinteger(L, 4, 8);
+	int velocityiterations = (int) luaL_optinteger(L, 5, 8);
+	int positioniterations = (int) luaL_optinteger(L, 6, 3);
+
+	// Make sure the world callbacks are using the calling Lua thread.
+	t->setCallbacksL(L);
+
+	int steps = 0;
+	luax_catchexcept(L, [&](){ steps = t->updateFixed(dt, fixeddt, maxsteps, velocityiterations, positioniterations); });
+
+	lua_pushinteger(L, steps);
+	lua_pushnumber(L, t->getInterpolationAlpha());
+	return 2;
+}
+
+int w_World_getInterpolationAlpha(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	lua_pushnumber(L, t->getInterpolationAlpha());
+	return 1;
+}
+
+int w_World_getMovedBodies(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	lua_remove(L, 1);
+	return t->getMovedBodies(L);
+}
+
+int w_World_saveState(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	size_t size = t->getStateSize();
+
+	// An existing Data can be reused if it's big enough.
+	love::Data *data = nullptr;
+	if (!lua_isnoneornil(L, 2))
+	{
+		data = luax_checktype<love::Data>(L, 2);
+		if (data->getSize() < size)
+			data = nullptr;
+	}
+
+	if (data != nullptr)
+	{
+		luax_catchexcept(L, [&](){ t->saveState(data->getData(), data->getSize()); });
+		lua_pushvalue(L, 2);
+	}
+	else
+	{
+		love::data::ByteData *bytedata = nullptr;
+		luax_catchexcept(L, [&]() {
+			bytedata = new love::data::ByteData(size, false);
+			t->saveState(bytedata->getData(), bytedata->getSize());
+		});
+		luax_pushtype(L, bytedata);
+		bytedata->release();
+	}
+
+	return 1;
+}
+
+int w_World_loadState(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	love::Data *data = luax_checktype<love::Data>(L, 2);
+	luax_catchexcept(L, [&](){ t->loadState(data->getData(), data->getSize()); });
+	return 0;
+}
+
 int w_World_setCallbacks(lua_State *L)
 {
 	World *t = luax_checkworld(L, 1);
@@ -69,6 +151,31 @@ int w_World_getCallbacks(lua_State *L)
 	return t->getCallbacks(L);
 }
 
+int w_World_setContactEventsDeferred(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	bool deferred = luax_checkboolean(L, 2);
+	bool postsolve = luax_optboolean(L, 3, false);
+	t->setContactEventsDeferred(deferred, postsolve);
+	return 0;
+}
+
+int w_World_isContactEventsDeferred(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	luax_pushboolean(L, t->isContactEventsDeferred());
+	return 1;
+}
+
+int w_World_getContactEvents(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	lua_remove(L, 1);
+	int ret = 0;
+	luax_catchexcept(L, [&](){ ret = t->getContactEvents(L); });
+	return ret;
+}
+
 int w_World_setContactFilter(lua_State *L)
 {
 	World *t = luax_checkworld(L, 1);
@@ -123,6 +230,21 @@ int w_World_isSleepingAllowed(lua_State *L)
 	return 1;
 }
 
+int w_World_setThreadCount(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	int count = (int) luaL_checkinteger(L, 2);
+	luax_catchexcept(L, [&](){ t->setThreadCount(count); });
+	return 0;
+}
+
+int w_World_getThreadCount(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	lua_pushinteger(L, t->getThreadCount());
+	return 1;
+}
+
 int w_World_isLocked(lua_State *L)
 {
 	World *t = luax_checkworld(L, 1);
@@ -130,6 +252,68 @@ int w_World_isLocked(lua_State *L)
 	return 1;
 }
 
+int w_World_addStaticGeometry(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	std::vector<Vector2> coords;
+
+	if (lua_istable(L, 2))
+	{
+		int argc = (int) luax_objlen(L, 2);
+		if (argc % 2 != 0)
+			return luaL_error(L, "Number of vertex components must be a multiple of two.");
+
+		coords.reserve(argc / 2);
+		for (int i = 0; i < argc / 2; i++)
+		{
+			lua_rawgeti(L, 2, 1 + i * 2);
+			lua_rawgeti(L, 2, 2 + i * 2);
+			float x = (float) luaL_checknumber(L, -2);
+			float y = (float) luaL_checknumber(L, -1);
+			coords.emplace_back(x, y);
+			lua_pop(L, 2);
+		}
+	}
+	else
+	{
+		// Data containing pairs of 32-bit floats.
+		love::Data *data = luax_checktype<love::Data>(L, 2);
+		size_t count = data->getSize() / (sizeof(float) * 2);
+		const float *src = (const float *) data->getData();
+
+		coords.reserve(count);
+		for (size_t i = 0; i < count; i++)
+			coords.emplace_back(src[i * 2 + 0], src[i * 2 + 1]);
+	}
+
+	std::vector<int> chainsizes;
+	if (lua_istable(L, 3))
+	{
+		int count = (int) luax_objlen(L, 3);
+		chainsizes.reserve(count);
+		for (int i = 1; i <= count; i++)
+		{
+			lua_rawgeti(L, 3, i);
+			chainsizes.push_back((int) luaL_checkinteger(L, -1));
+			lua_pop(L, 1);
+		}
+	}
+	else if (lua_isnoneornil(L, 3))
+		chainsizes.push_back((int) coords.size());
+	else
+		return luax_typerror(L, 3, "table or nil");
+
+	bool loop = luax_optboolean(L, 4, false);
+	bool merge = luax_optboolean(L, 5, false);
+	float tolerance = (float) luaL_optnumber(L, 6, 0.01);
+
+	Body *body = nullptr;
+	luax_catchexcept(L, [&](){ body = t->addStaticGeometry(coords.data(), (int) coords.size(), chainsizes.data(), (int) chainsizes.size(), loop, merge, tolerance); });
+	luax_pushtype(L, body);
+	body->release();
+	return 1;
+}
+
 int w_World_getBodyCount(lua_State *L)
 {
 	World *t = luax_checkworld(L, 1);
@@ -178,6 +362,56 @@ int w_World_getContacts(lua_State *L)
 	return ret;
 }
 
+int w_World_getBodyTransforms(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	luaL_checktype(L, 2, LUA_TTABLE);
+	Data *data = luax_checktype<Data>(L, 3);
+	int64 offset = (int64) luaL_optnumber(L, 4, 0);
+	bool velocities = luax_optboolean(L, 5, false);
+
+	// x, y, angle, and optionally linear and angular velocity, as floats.
+	int components = velocities ? 6 : 3;
+	int64 size = (int64) sizeof(float) * components;
+	int64 stride = (int64) luaL_optnumber(L, 6, (lua_Number) size);
+
+	if (stride < size)
+		return luaL_argerror(L, 6, "stride must be at least the size of the written values");
+
+	int count = (int) luax_objlen(L, 2);
+
+	if (offset < 0 || (count > 0 && offset + stride * (count - 1) + size > (int64) data->getSize()))
+		return luaL_error(L, "The given offset and number of bodies don't fit within the Data's size.");
+
+	uint8 *dst = (uint8 *) data->getData() + offset;
+
+	for (int i = 0; i < count; i++)
+	{
+		lua_rawgeti(L, 2, i + 1);
+		Body *b = luax_checkbody(L, -1);
+		lua_pop(L, 1);
+
+		if (b->getWorld() != t)
+			return luaL_error(L, "Body %d in the table belongs to a different World.", i + 1);
+
+		float values[6];
+		b->getPosition(values[0], values[1]);
+		values[2] = b->getAngle();
+
+		if (velocities)
+		{
+			b->getLinearVelocity(values[3], values[4]);
+			values[5] = b->getAngularVelocity();
+		}
+
+		// The destination doesn't have to be aligned.
+		memcpy(dst + stride * i, values, (size_t) size);
+	}
+
+	lua_pushinteger(L, count);
+	return 1;
+}
+
 int w_World_queryShapesInArea(lua_State *L)
 {
 	World *t = luax_checkworld(L, 1);
@@ -227,6 +461,75 @@ int w_World_rayCastClosest(lua_State *L)
 	return ret;
 }
 
+int w_World_rayCastMany(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	lua_remove(L, 1);
+	int ret = 0;
+	luax_catchexcept(L, [&]() { ret = t->rayCastMany(L); });
+	return ret;
+}
+
+int w_World_debugDraw(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+
+	World::DebugDrawSettings settings;
+	graphics::Mesh *mesh = nullptr;
+
+	if (!lua_isnoneornil(L, 2))
+	{
+		luaL_checktype(L, 2, LUA_TTABLE);
+		settings.shapes = luax_boolflag(L, 2, "shapes", settings.shapes);
+		settings.joints = luax_boolflag(L, 2, "joints", settings.joints);
+		settings.contacts = luax_boolflag(L, 2, "contacts", settings.contacts);
+		settings.boundingBoxes = luax_boolflag(L, 2, "boundingboxes", settings.boundingBoxes);
+		settings.centersOfMass = luax_boolflag(L, 2, "centersofmass", settings.centersOfMass);
+		settings.lineWidth = (float) luax_numberflag(L, 2, "linewidth", settings.lineWidth);
+
+		lua_getfield(L, 2, "mesh");
+		if (!lua_isnoneornil(L, -1))
+			mesh = luax_checktype<graphics::Mesh>(L, -1);
+		lua_pop(L, 1);
+	}
+
+	std::vector<graphics::Vertex> vertices;
+	luax_catchexcept(L, [&](){ t->debugDraw(settings, vertices); });
+
+	if (vertices.empty())
+	{
+		lua_pushnil(L);
+		return 1;
+	}
+
+	size_t datasize = vertices.size() * sizeof(graphics::Vertex);
+
+	// Reuse the given Mesh if it's one from an earlier debugDraw with room
+	// for all the vertices, otherwise make a new one.
+	if (mesh != nullptr && mesh->getVertexData() != nullptr
+		&& mesh->getVertexStride() == sizeof(graphics::Vertex)
+		&& mesh->getVertexCount() >= vertices.size())
+	{
+		memcpy(mesh->getVertexData(), vertices.data(), datasize);
+		mesh->setVertexDataModified(0, datasize);
+		mesh->setDrawRange(0, (int) vertices.size());
+		luax_pushtype(L, mesh);
+		return 1;
+	}
+
+	auto gfx = Module::getInstance<graphics::Graphics>(Module::M_GRAPHICS);
+	if (gfx == nullptr)
+		return luaL_error(L, "love.graphics must be loaded to use World:debugDraw.");
+
+	luax_catchexcept(L, [&]() {
+		mesh = gfx->newMesh(graphics::Mesh::getDefaultVertexFormat(), vertices.data(), datasize, graphics::PRIMITIVE_TRIANGLES, graphics::BUFFERDATAUSAGE_STREAM);
+	});
+
+	luax_pushtype(L, mesh);
+	mesh->release();
+	return 1;
+}
+
 int w_World_destroy(lua_State *L)
 {
 	World *t = luax_checkworld(L, 1);
@@ -244,8 +547,16 @@ int w_World_isDestroyed(lua_State *L)
 static const luaL_Reg w_World_functions[] =
 {
 	{ "update", w_World_update },
+	{ "updateFixed", w_World_updateFixed },
+	{ "getInterpolationAlpha", w_World_getInterpolationAlpha },
+	{ "getMovedBodies", w_World_getMovedBodies },
+	{ "saveState", w_World_saveState },
+	{ "loadState", w_World_loadState },
 	{ "setCallbacks", w_World_setCallbacks },
 	{ "getCallbacks", w_World_getCallbacks },
+	{ "setContactEventsDeferred", w_World_setContactEventsDeferred },
+	{ "isContactEventsDeferred", w_World_isContactEventsDeferred },
+	{ "getContactEvents", w_World_getContactEvents },
 	{ "setContactFilter", w_World_setContactFilter },
 	{ "getContactFilter", w_World_getContactFilter },
 	{ "setGravity", w_World_setGravity },
@@ -253,18 +564,24 @@ static const luaL_Reg w_World_functions[] =
 	{ "translateOrigin", w_World_translateOrigin },
 	{ "setSleepingAllowed", w_World_setSleepingAllowed },
 	{ "isSleepingAllowed", w_World_isSleepingAllowed },
+	{ "setThreadCount", w_World_setThreadCount },
+	{ "getThreadCount", w_World_getThreadCount },
 	{ "isLocked", w_World_isLocked },
+	{ "addStaticGeometry", w_World_addStaticGeometry },
 	{ "getBodyCount", w_World_getBodyCount },
 	{ "getJointCount", w_World_getJointCount },
 	{ "getContactCount", w_World_getContactCount },
 	{ "getBodies", w_World_getBodies },
 	{ "getJoints", w_World_getJoints },
 	{ "getContacts", w_World_getContacts },
+	{ "getBodyTransforms", w_World_getBodyTransforms },
 	{ "queryShapesInArea", w_World_queryShapesInArea },
 	{ "getShapesInArea", w_World_getShapesInArea },
 	{ "rayCast", w_World_rayCast },
 	{ "rayCastAny", w_World_rayCastAny },
 	{ "rayCastClosest", w_World_rayCastClosest },
+	{ "rayCastMany", w_World_rayCastMany },
+	{ "debugDraw", w_World_debugDraw },
 	{ "destroy", w_World_destroy },
 	{ "isDestroyed", w_World_isDestroyed },
 
@@ -21,6 +21,9 @@
 // LOVE
 #include "Sensor.h"
 
+// C++
+#include <utility>
+
 namespace love
 {
 namespace sensor
@@ -29,6 +32,41 @@ namespace sensor
 Sensor::Sensor(const char *name)
 	: Module(M_SENSOR, name)
 {
+	for (int i = 0; i < SENSOR_MAX_ENUM; i++)
+		batched[i] = false;
+}
+
+void Sensor::setBatched(SensorType type, bool batched)
+{
+	this->batched[type] = batched;
+	if (!batched)
+		samples[type].clear();
+}
+
+bool Sensor::isBatched(SensorType type) const
+{
+	return batched[type];
+}
+
+void Sensor::addSample(SensorType type, const float *data, double timestamp)
+{
+	std::vector<Sample> &buffer = samples[type];
+
+	if (buffer.size() >= MAX_BATCHED_SAMPLES)
+		buffer.erase(buffer.begin(), buffer.begin() + MAX_BATCHED_SAMPLES / 2);
+
+	Sample sample;
+	for (int i = 0; i < 3; i++)
+		sample.data[i] = data[i];
+	sample.timestamp = timestamp;
+
+	buffer.push_back(sample);
+}
+
+void Sensor::takeSamples(SensorType type, std::vector<Sample> &out)
+{
+	out.clear();
+	std::swap(out, samples[type]);
 }
 
 STRINGMAP_CLASS_BEGIN(Sensor, Sensor::SensorType, Sensor::SENSOR_MAX_ENUM, sensorType)
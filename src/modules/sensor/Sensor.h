@@ -25,6 +25,9 @@
 #include "common/Module.h"
 #include "common/StringMap.h"
 
+// C++
+#include <vector>
+
 namespace love
 {
 namespace sensor
@@ -41,6 +44,15 @@ public:
 		SENSOR_MAX_ENUM
 	};
 
+	struct Sample
+	{
+		float data[3];
+		double timestamp;
+	};
+
+	// Batched samples past this are dropped, oldest first.
+	static const size_t MAX_BATCHED_SAMPLES = 4096;
+
 	virtual ~Sensor() {}
 
 	/**
@@ -70,12 +82,30 @@ public:
 
 	virtual const char *getSensorName(SensorType type) = 0;
 
+	/**
+	 * While a sensor is batched its updates are stored here, instead of being
+	 * sent as individual sensorupdated events.
+	 **/
+	void setBatched(SensorType type, bool batched);
+	bool isBatched(SensorType type) const;
+
+	void addSample(SensorType type, const float *data, double timestamp);
+
+	/**
+	 * Replaces the contents of out with the stored samples and empties the
+	 * buffer. The vectors are swapped, so reusing out avoids allocations.
+	 **/
+	void takeSamples(SensorType type, std::vector<Sample> &out);
+
 	STRINGMAP_CLASS_DECLARE(SensorType);
 
 protected:
 
 	Sensor(const char *name);
 
+	bool batched[SENSOR_MAX_ENUM];
+	std::vector<Sample> samples[SENSOR_MAX_ENUM];
+
 }; // Sensor
 
 } // sensor
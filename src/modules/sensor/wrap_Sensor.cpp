@@ -88,6 +88,61 @@ static int w_getName(lua_State *L)
 	return 1;
 }
 
+static int w_setBatched(lua_State *L)
+{
+	Sensor::SensorType type = luax_checksensortype(L, 1);
+	bool batched = luax_checkboolean(L, 2);
+
+	instance()->setBatched(type, batched);
+	return 0;
+}
+
+static int w_isBatched(lua_State *L)
+{
+	Sensor::SensorType type = luax_checksensortype(L, 1);
+
+	lua_pushboolean(L, instance()->isBatched(type));
+	return 1;
+}
+
+static int w_getSamples(lua_State *L)
+{
+	// Swapped with the sensor's buffer each call, so neither reallocates.
+	static std::vector<Sensor::Sample> samples;
+
+	Sensor::SensorType type = luax_checksensortype(L, 1);
+	instance()->takeSamples(type, samples);
+
+	int count = (int) samples.size();
+
+	if (lua_istable(L, 2))
+		lua_pushvalue(L, 2);
+	else
+		lua_createtable(L, count * 4, 0);
+
+	// x, y, z, timestamp for each sample.
+	for (int i = 0; i < count; i++)
+	{
+		const Sensor::Sample &s = samples[i];
+		for (int j = 0; j < 3; j++)
+		{
+			lua_pushnumber(L, s.data[j]);
+			lua_rawseti(L, -2, i * 4 + j + 1);
+		}
+		lua_pushnumber(L, s.timestamp);
+		lua_rawseti(L, -2, i * 4 + 4);
+	}
+
+	for (int i = (int) luax_objlen(L, -1); i > count * 4; i--)
+	{
+		lua_pushnil(L);
+		lua_rawseti(L, -2, i);
+	}
+
+	lua_pushinteger(L, count);
+	return 2;
+}
+
 static const luaL_Reg functions[] =
 {
 	{ "hasSensor", w_hasSensor },
@@ -95,6 +150,9 @@ static const luaL_Reg functions[] =
 	{ "setEnabled", w_setEnabled },
 	{ "getData", w_getData },
 	{ "getName", w_getName },
+	{ "setBatched", w_setBatched },
+	{ "isBatched", w_isBatched },
+	{ "getSamples", w_getSamples },
 	{ nullptr, nullptr }
 };
 
@@ -55,6 +55,31 @@ Decoder::~Decoder()
 		delete [](char *) buffer;
 }
 
+int Decoder::decodeInto(void *dst, int dstSize)
+{
+	if (dstSize < bufferSize)
+		throw love::Exception("Decoder destination is too small (%d bytes, needs %d).", dstSize, bufferSize);
+
+	// Every decoder writes into the buffer pointer during decode(), so it can
+	// be pointed at the destination for the duration of the call.
+	void *ownBuffer = buffer;
+	buffer = dst;
+
+	int decoded = 0;
+	try
+	{
+		decoded = decode();
+	}
+	catch (love::Exception &)
+	{
+		buffer = ownBuffer;
+		throw;
+	}
+
+	buffer = ownBuffer;
+	return decoded;
+}
+
 void *Decoder::getBuffer() const
 {
 	return buffer;
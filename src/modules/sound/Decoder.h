@@ -88,6 +88,14 @@ public:
 	 **/
 	virtual int decode() = 0;
 
+	/**
+	 * Decodes the next chunk directly into the given memory instead of the
+	 * Decoder's own buffer, saving a copy when the data is kept. The memory
+	 * must be at least getSize() bytes.
+	 * @return The number of bytes actually decoded.
+	 **/
+	int decodeInto(void *dst, int dstSize);
+
 	/**
 	 * Gets the size of the buffer (NOT the size of the entire stream).
 	 * @return The size of the buffer.
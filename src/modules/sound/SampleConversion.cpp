@@ -0,0 +1,204 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "SampleConversion.h"
+#include "common/config.h"
+
+// C
+#include <cstring>
+
+// C++
+#include <algorithm>
+
+#if defined(LOVE_SIMD_SSE) && (defined(__SSE2__) || defined(_M_AMD64) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define LOVE_SOUND_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(LOVE_SIMD_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace love
+{
+namespace sound
+{
+
+// Conversions between two integer formats and mixing go through a float
+// buffer on the stack, one block at a time.
+static const size_t BLOCK_SAMPLES = 256;
+
+static const float INT16_SCALE = (float) LOVE_INT16_MAX;
+static const float INV_INT16_SCALE = 1.0f / (float) LOVE_INT16_MAX;
+
+static void int16ToFloat(const int16 *src, float *dst, size_t count)
+{
+	size_t i = 0;
+
+#if defined(LOVE_SOUND_SSE2)
+	const __m128 scale = _mm_set1_ps(INV_INT16_SCALE);
+	for (; i + 8 <= count; i += 8)
+	{
+		__m128i s = _mm_loadu_si128((const __m128i *) (src + i));
+		// Sign-extend by unpacking into the high halves and shifting down.
+		__m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16);
+		__m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(s, s), 16);
+		_mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+		_mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+	}
+#elif defined(LOVE_SIMD_NEON)
+	for (; i + 8 <= count; i += 8)
+	{
+		int16x8_t s = vld1q_s16(src + i);
+		float32x4_t lo = vcvtq_f32_s32(vmovl_s16(vget_low_s16(s)));
+		float32x4_t hi = vcvtq_f32_s32(vmovl_s16(vget_high_s16(s)));
+		vst1q_f32(dst + i, vmulq_n_f32(lo, INV_INT16_SCALE));
+		vst1q_f32(dst + i + 4, vmulq_n_f32(hi, INV_INT16_SCALE));
+	}
+#endif
+
+	for (; i < count; i++)
+		dst[i] = (float) src[i] * INV_INT16_SCALE;
+}
+
+static void floatToInt16(const float *src, int16 *dst, size_t count)
+{
+	size_t i = 0;
+
+#if defined(LOVE_SOUND_SSE2)
+	const __m128 scale = _mm_set1_ps(INT16_SCALE);
+	const __m128 minval = _mm_set1_ps(-1.0f);
+	const __m128 maxval = _mm_set1_ps(1.0f);
+	for (; i + 8 <= count; i += 8)
+	{
+		__m128 lo = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i), minval), maxval);
+		__m128 hi = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i + 4), minval), maxval);
+		// Truncate like the scalar cast does.
+		__m128i ilo = _mm_cvttps_epi32(_mm_mul_ps(lo, scale));
+		__m128i ihi = _mm_cvttps_epi32(_mm_mul_ps(hi, scale));
+		_mm_storeu_si128((__m128i *) (dst + i), _mm_packs_epi32(ilo, ihi));
+	}
+#elif defined(LOVE_SIMD_NEON)
+	const float32x4_t minval = vdupq_n_f32(-1.0f);
+	const float32x4_t maxval = vdupq_n_f32(1.0f);
+	for (; i + 8 <= count; i += 8)
+	{
+		float32x4_t lo = vminq_f32(vmaxq_f32(vld1q_f32(src + i), minval), maxval);
+		float32x4_t hi = vminq_f32(vmaxq_f32(vld1q_f32(src + i + 4), minval), maxval);
+		int32x4_t ilo = vcvtq_s32_f32(vmulq_n_f32(lo, INT16_SCALE));
+		int32x4_t ihi = vcvtq_s32_f32(vmulq_n_f32(hi, INT16_SCALE));
+		vst1q_s16(dst + i, vcombine_s16(vqmovn_s32(ilo), vqmovn_s32(ihi)));
+	}
+#endif
+
+	for (; i < count; i++)
+		dst[i] = (int16) (std::min(std::max(src[i], -1.0f), 1.0f) * INT16_SCALE);
+}
+
+static void int8ToFloat(const uint8 *src, float *dst, size_t count)
+{
+	// 8-bit sample values are unsigned internally.
+	for (size_t i = 0; i < count; i++)
+		dst[i] = ((float) src[i] - 128.0f) * (1.0f / 127.0f);
+}
+
+static void floatToInt8(const float *src, uint8 *dst, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+		dst[i] = (uint8) ((std::min(std::max(src[i], -1.0f), 1.0f) * 127.0f) + 128.0f);
+}
+
+static void addScaled(const float *src, float *dst, size_t count, float gain)
+{
+	size_t i = 0;
+
+#if defined(LOVE_SOUND_SSE2)
+	const __m128 g = _mm_set1_ps(gain);
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 s = _mm_mul_ps(_mm_loadu_ps(src + i), g);
+		_mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), s));
+	}
+#elif defined(LOVE_SIMD_NEON)
+	for (; i + 4 <= count; i += 4)
+		vst1q_f32(dst + i, vmlaq_n_f32(vld1q_f32(dst + i), vld1q_f32(src + i), gain));
+#endif
+
+	for (; i < count; i++)
+		dst[i] += src[i] * gain;
+}
+
+void convertSamplesToFloat(const void *src, int bitDepth, float *dst, size_t count)
+{
+	if (bitDepth == 16)
+		int16ToFloat((const int16 *) src, dst, count);
+	else
+		int8ToFloat((const uint8 *) src, dst, count);
+}
+
+void convertSamplesFromFloat(const float *src, void *dst, int bitDepth, size_t count)
+{
+	if (bitDepth == 16)
+		floatToInt16(src, (int16 *) dst, count);
+	else
+		floatToInt8(src, (uint8 *) dst, count);
+}
+
+void convertSamples(const void *src, int srcBitDepth, void *dst, int dstBitDepth, size_t count)
+{
+	if (srcBitDepth == dstBitDepth)
+	{
+		memmove(dst, src, count * (srcBitDepth / 8));
+		return;
+	}
+
+	float block[BLOCK_SAMPLES];
+	const uint8 *s = (const uint8 *) src;
+	uint8 *d = (uint8 *) dst;
+
+	for (size_t i = 0; i < count; i += BLOCK_SAMPLES)
+	{
+		size_t n = std::min(BLOCK_SAMPLES, count - i);
+		convertSamplesToFloat(s + i * (srcBitDepth / 8), srcBitDepth, block, n);
+		convertSamplesFromFloat(block, d + i * (dstBitDepth / 8), dstBitDepth, n);
+	}
+}
+
+void mixSamples(const void *src, int srcBitDepth, void *dst, int dstBitDepth, size_t count, float gain)
+{
+	float srcblock[BLOCK_SAMPLES];
+	float dstblock[BLOCK_SAMPLES];
+	const uint8 *s = (const uint8 *) src;
+	uint8 *d = (uint8 *) dst;
+
+	for (size_t i = 0; i < count; i += BLOCK_SAMPLES)
+	{
+		size_t n = std::min(BLOCK_SAMPLES, count - i);
+		uint8 *dstsamples = d + i * (dstBitDepth / 8);
+
+		convertSamplesToFloat(s + i * (srcBitDepth / 8), srcBitDepth, srcblock, n);
+		convertSamplesToFloat(dstsamples, dstBitDepth, dstblock, n);
+		addScaled(srcblock, dstblock, n, gain);
+		convertSamplesFromFloat(dstblock, dstsamples, dstBitDepth, n);
+	}
+}
+
+} // sound
+} // love
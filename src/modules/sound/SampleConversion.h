@@ -0,0 +1,59 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_SOUND_SAMPLE_CONVERSION_H
+#define LOVE_SOUND_SAMPLE_CONVERSION_H
+
+// LOVE
+#include "common/int.h"
+
+// C
+#include <stddef.h>
+
+namespace love
+{
+namespace sound
+{
+
+/**
+ * Bulk conversions between the sample formats SoundData uses and normalized
+ * floats, vectorized where SSE2 or NEON is available. Values match
+ * SoundData::getSample and setSample up to float rounding, except that floats
+ * outside [-1, 1] are clamped instead of wrapping around.
+ **/
+
+void convertSamplesToFloat(const void *src, int bitDepth, float *dst, size_t count);
+void convertSamplesFromFloat(const float *src, void *dst, int bitDepth, size_t count);
+
+/**
+ * Converts samples between 8 and 16 bit depths. src and dst may not overlap
+ * unless the bit depths are equal.
+ **/
+void convertSamples(const void *src, int srcBitDepth, void *dst, int dstBitDepth, size_t count);
+
+/**
+ * Adds src * gain to dst, clamping the result. The bit depths may differ.
+ **/
+void mixSamples(const void *src, int srcBitDepth, void *dst, int dstBitDepth, size_t count, float gain);
+
+} // sound
+} // love
+
+#endif // LOVE_SOUND_SAMPLE_CONVERSION_H
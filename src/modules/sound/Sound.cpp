@@ -34,6 +34,7 @@ Sound::Sound(const char *name)
 
 Sound::~Sound()
 {
+	SoundDataLoad::stopDecodeThreads();
 }
 
 SoundData *Sound::newSoundData(Decoder *decoder)
@@ -51,5 +52,10 @@ SoundData *Sound::newSoundData(void *data, int samples, int sampleRate, int bitD
 	return new SoundData(data, samples, sampleRate, bitDepth, channels);
 }
 
+SoundDataLoad *Sound::newSoundDataAsync(Decoder *decoder, int segments)
+{
+	return new SoundDataLoad(decoder, segments);
+}
+
 } // sound
 } // love
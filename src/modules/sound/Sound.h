@@ -26,6 +26,7 @@
 #include "common/Stream.h"
 
 #include "SoundData.h"
+#include "SoundDataLoad.h"
 #include "Decoder.h"
 
 namespace love
@@ -77,6 +78,15 @@ public:
 	 **/
 	SoundData *newSoundData(void *data, int samples, int sampleRate, int bitDepth, int channels);
 
+	/**
+	 * Starts decoding a decoder into new SoundData on worker threads.
+	 * @param decoder The file to decode the data from.
+	 * @param segments The maximum number of parts of the file to decode in
+	 * parallel, if the decoder can seek.
+	 * @return An object which gives the SoundData once it's decoded.
+	 **/
+	SoundDataLoad *newSoundDataAsync(Decoder *decoder, int segments);
+
 	/**
 	 * Attempts to find a decoder for the encoded sound data in the
 	 * specified file.
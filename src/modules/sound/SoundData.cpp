@@ -19,12 +19,16 @@
  **/
 
 #include "SoundData.h"
+#include "SampleConversion.h"
+#include "common/memory.h"
+#include "thread/threads.h"
 
 // C
 #include <cstdlib>
 #include <cstring>
 
 // C++
+#include <algorithm>
 #include <limits>
 #include <iostream>
 #include <vector>
@@ -47,42 +51,62 @@ SoundData::SoundData(Decoder *decoder)
 		throw love::Exception("Invalid bit depth: %d", decoder->getBitDepth());
 
 	size_t bufferSize = 524288; // 0x80000
-	int decoded = decoder->decode();
+	size_t chunkSize = (size_t) decoder->getSize();
 
-	while (decoded > 0)
+	while (true)
 	{
-		// Expand or allocate buffer. Note that realloc may move
-		// memory to other locations.
-		if (!data || bufferSize < size + decoded)
+		// Expand or allocate buffer, so the decoder can write its next chunk
+		// straight into it. Note that realloc may move memory to other
+		// locations.
+		if (size > std::numeric_limits<size_t>::max() - chunkSize)
 		{
-			while (bufferSize < size + decoded)
-				bufferSize <<= 1;
-			data = (uint8 *) realloc(data, bufferSize);
+			free(data);
+			throw love::Exception("Not enough memory.");
 		}
 
-		if (!data)
-			throw love::Exception("Not enough memory.");
+		if (!data || bufferSize < size + chunkSize)
+		{
+			while (bufferSize < size + chunkSize)
+				bufferSize <<= 1;
 
-		// Copy memory into new part of memory.
-		memcpy(data + size, decoder->getBuffer(), decoded);
+			uint8 *newdata = (uint8 *) realloc(data, bufferSize);
+			if (!newdata)
+			{
+				free(data);
+				throw love::Exception("Not enough memory.");
+			}
+			data = newdata;
+		}
 
-		// Overflow check.
-		if (size > std::numeric_limits<size_t>::max() - decoded)
+		int decoded = 0;
+		try
+		{
+			decoded = decoder->decodeInto(data + size, (int) chunkSize);
+		}
+		catch (love::Exception &)
 		{
 			free(data);
-			throw love::Exception("Not enough memory.");
+			throw;
 		}
 
+		if (decoded <= 0)
+			break;
+
 		// Keep this up to date.
 		size += decoded;
-
-		decoded = decoder->decode();
 	}
 
 	// Shrink buffer if necessary.
-	if (data && bufferSize > size)
+	if (size == 0)
+	{
+		free(data);
+		data = nullptr;
+	}
+	else if (bufferSize > size)
 		data = (uint8 *) realloc(data, size);
 
+	trackMemory(MEMORYTAG_SOUNDDATA, (int64) size);
+
 	channels = decoder->getChannelCount();
 	bitDepth = decoder->getBitDepth();
 	sampleRate = decoder->getSampleRate();
@@ -108,20 +132,54 @@ SoundData::SoundData(const void *d, int samples, int sampleRate, int bitDepth, i
 	load(samples, sampleRate, bitDepth, channels, d);
 }
 
+SoundData::SharedSamples::SharedSamples(uint8 *data, size_t size)
+	: data(data)
+	, size(size)
+{
+}
+
+SoundData::SharedSamples::~SharedSamples()
+{
+	free(data);
+	trackMemory(MEMORYTAG_SOUNDDATA, -(int64) size);
+}
+
 SoundData::SoundData(const SoundData &c)
-	: data(0)
-	, size(0)
-	, sampleRate(0)
-	, bitDepth(0)
-	, channels(0)
+	: data(c.data)
+	, size(c.size)
+	, sampleRate(c.sampleRate)
+	, bitDepth(c.bitDepth)
+	, channels(c.channels)
 {
-	load(c.getSampleCount(), c.getSampleRate(), c.getBitDepth(), c.getChannelCount(), c.getData());
+	// The original's sharing state is changed, so another thread mustn't
+	// clone or modify it at the same time.
+	love::thread::Lock lock(const_cast<SoundData &>(c).getMutex());
+
+	if (c.dataExposed)
+	{
+		data = nullptr;
+		load((int) (size / ((bitDepth / 8) * channels)), sampleRate, bitDepth, channels, c.data);
+		return;
+	}
+
+	// Hand the original's samples over to a SharedSamples the first time it's
+	// cloned, then share them.
+	if (c.data != 0 && c.sharedSamples.get() == nullptr)
+		c.sharedSamples.set(new SharedSamples(c.data, c.size), Acquire::NORETAIN);
+
+	sharedSamples = c.sharedSamples;
 }
 
 SoundData::~SoundData()
 {
+	if (sharedSamples.get())
+		return;
+
 	if (data != 0)
+	{
 		free(data);
+		trackMemory(MEMORYTAG_SOUNDDATA, -(int64) size);
+	}
 }
 
 SoundData *SoundData::clone() const
@@ -129,6 +187,25 @@ SoundData *SoundData::clone() const
 	return new SoundData(*this);
 }
 
+void SoundData::makeUnique() const
+{
+	love::thread::Lock lock(const_cast<SoundData *>(this)->getMutex());
+
+	// Once the clones are gone the samples can be used in place.
+	if (sharedSamples.get() == nullptr || sharedSamples->getReferenceCount() == 1)
+		return;
+
+	uint8 *copy = (uint8 *) malloc(size);
+	if (!copy)
+		throw love::Exception("Not enough memory.");
+
+	memcpy(copy, data, size);
+	trackMemory(MEMORYTAG_SOUNDDATA, (int64) size);
+
+	data = copy;
+	sharedSamples.set(nullptr);
+}
+
 void SoundData::load(int samples, int sampleRate, int bitDepth, int channels, const void *newData)
 {
 	if (samples <= 0)
@@ -146,6 +223,7 @@ void SoundData::load(int samples, int sampleRate, int bitDepth, int channels, co
 	if (data != 0)
 	{
 		free(data);
+		trackMemory(MEMORYTAG_SOUNDDATA, -(int64) size);
 		data = 0;
 	}
 
@@ -163,6 +241,8 @@ void SoundData::load(int samples, int sampleRate, int bitDepth, int channels, co
 	if (!data)
 		throw love::Exception("Not enough memory.");
 
+	trackMemory(MEMORYTAG_SOUNDDATA, (int64) size);
+
 	if (newData)
 		memcpy(data, newData, size);
 	else
@@ -171,9 +251,17 @@ void SoundData::load(int samples, int sampleRate, int bitDepth, int channels, co
 
 void *SoundData::getData() const
 {
+	love::thread::Lock lock(const_cast<SoundData *>(this)->getMutex());
+	makeUnique();
+	dataExposed = true;
 	return (void *)data;
 }
 
+const void *SoundData::getReadOnlyData() const
+{
+	return data;
+}
+
 size_t SoundData::getSize() const
 {
 	return size;
@@ -210,6 +298,8 @@ void SoundData::setSample(int i, float sample)
 	if (i < 0 || (size_t) i >= size/(bitDepth/8))
 		throw love::Exception("Attempt to set out-of-range sample!");
 
+	makeUnique();
+
 	if (bitDepth == 16)
 	{
 		// 16-bit sample values are signed.
@@ -272,11 +362,13 @@ void SoundData::copyFrom(const SoundData *src, int srcStart, int count, int dstS
 	if (srcStart < 0 || (srcStart+count) * srcBytesPerSample > src->size)
 		throw love::Exception("Source out-of-range!");
 
+	makeUnique();
+
 	if (bitDepth != src->bitDepth)
 	{
-		// Bit depth mismatch, use get/setSample at loop
-		for (int i = 0; i < count * channels; i++)
-			setSample(dstStart * channels + i, src->getSample(srcStart * channels + i));
+		// Bit depth mismatch, convert. The allocations can't overlap here.
+		convertSamples(src->data + srcStart * srcBytesPerSample, src->bitDepth,
+		               data + dstStart * bytesPerSample, bitDepth, (size_t) count * channels);
 	}
 	else if (this->data == src->data)
 		// May overlap, use memmove
@@ -285,6 +377,42 @@ void SoundData::copyFrom(const SoundData *src, int srcStart, int count, int dstS
 		memcpy(data + dstStart * bytesPerSample, src->data + srcStart * bytesPerSample, count * bytesPerSample);
 }
 
+void SoundData::mix(const SoundData *src, float gain, int srcStart, int count, int dstStart)
+{
+	if (channels != src->channels)
+		throw love::Exception("Channel count mismatch!");
+
+	if (count < 0)
+		count = std::min(src->getSampleCount() - srcStart, getSampleCount() - dstStart);
+
+	size_t bytesPerSample = (size_t) channels * bitDepth/8;
+	size_t srcBytesPerSample = (size_t) src->channels * src->bitDepth/8;
+
+	// Check range
+	if (dstStart < 0 || (dstStart+count) * bytesPerSample > size)
+		throw love::Exception("Destination out-of-range!");
+	if (srcStart < 0 || (srcStart+count) * srcBytesPerSample > src->size)
+		throw love::Exception("Source out-of-range!");
+
+	if (count == 0)
+		return;
+
+	makeUnique();
+
+	const uint8 *srcdata = src->data + srcStart * srcBytesPerSample;
+	std::vector<uint8> srccopy;
+
+	// Mixing is done in blocks, so overlapping ranges need a copy of the
+	// source samples first.
+	if (this->data == src->data)
+	{
+		srccopy.assign(srcdata, srcdata + count * srcBytesPerSample);
+		srcdata = srccopy.data();
+	}
+
+	mixSamples(srcdata, src->bitDepth, data + dstStart * bytesPerSample, bitDepth, (size_t) count * channels, gain);
+}
+
 SoundData *SoundData::slice(int start, int length) const
 {
 	int totalSamples = getSampleCount();
@@ -44,9 +44,24 @@ public:
 
 	virtual ~SoundData();
 
-	// Implements Data.
+	/**
+	 * Clones share their samples with the original until either is modified,
+	 * so cloning is cheap.
+	 **/
 	SoundData *clone() const;
+
+	/**
+	 * Gets the samples for writing. If they're shared with clones, this
+	 * SoundData gets its own copy first.
+	 **/
 	void *getData() const;
+
+	/**
+	 * Gets the samples for reading only, without making this SoundData stop
+	 * sharing them with its clones.
+	 **/
+	const void *getReadOnlyData() const;
+
 	size_t getSize() const;
 
 	virtual int getChannelCount() const;
@@ -62,13 +77,44 @@ public:
 	float getSample(int i, int channel) const;
 
 	void copyFrom(const SoundData *src, int srcStart, int count, int dstStart);
+
+	/**
+	 * Adds the samples of another SoundData, scaled by gain, to this one. The
+	 * result is clamped to the valid sample range.
+	 * @param count The number of sample frames to mix, or -1 for as many as
+	 * both SoundData can hold.
+	 **/
+	void mix(const SoundData *src, float gain, int srcStart = 0, int count = -1, int dstStart = 0);
 	SoundData *slice(int start, int length = -1) const;
 
 private:
 
+	// Samples shared by a SoundData and its clones. Frees them once none of
+	// them use it anymore.
+	class SharedSamples : public Object
+	{
+	public:
+
+		SharedSamples(uint8 *data, size_t size);
+		virtual ~SharedSamples();
+
+		uint8 *data;
+		size_t size;
+	};
+
 	void load(int samples, int sampleRate, int bitDepth, int channels, const void *newData = 0);
 
-	uint8 *data;
+	// Gives this SoundData its own copy of its samples if they're shared with
+	// a clone, before they're modified.
+	void makeUnique() const;
+
+	// Owned by sharedSamples when that's set.
+	mutable uint8 *data;
+	mutable StrongRef<SharedSamples> sharedSamples;
+
+	// Set once getData has handed out a writable pointer, which clones then
+	// can't share.
+	mutable bool dataExposed = false;
 	size_t size;
 
 	int sampleRate;
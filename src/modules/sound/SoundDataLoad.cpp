@@ -0,0 +1,348 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "SoundDataLoad.h"
+#include "common/Exception.h"
+
+// STL
+#include <algorithm>
+#include <deque>
+#include <thread>
+#include <cstring>
+#include <limits>
+
+namespace love
+{
+namespace sound
+{
+
+love::Type SoundDataLoad::type("SoundDataLoad", &Object::type);
+
+class DecodeWorker;
+
+namespace
+{
+
+const unsigned int MAX_DECODE_THREADS = 8;
+
+struct DecodeJob
+{
+	SoundDataLoad *load;
+	size_t segment;
+};
+
+struct DecodePool
+{
+	love::thread::MutexRef mutex;
+	love::thread::ConditionalRef workAvailable;
+
+	std::vector<DecodeWorker *> workers;
+	std::deque<DecodeJob> jobs;
+
+	bool stopping = false;
+};
+
+DecodePool *decodePool = nullptr;
+
+love::thread::Mutex *getDecodePoolMutex()
+{
+	static love::thread::MutexRef mutex;
+	return mutex;
+}
+
+} // anonymous namespace
+
+class DecodeWorker : public love::thread::Threadable
+{
+public:
+
+	DecodeWorker(DecodePool *pool)
+		: pool(pool)
+	{
+		threadName = "SoundDecoder";
+	}
+
+	void threadFunction() override
+	{
+		while (true)
+		{
+			DecodeJob job;
+
+			{
+				love::thread::Lock lock(pool->mutex);
+
+				while (!pool->stopping && pool->jobs.empty())
+					pool->workAvailable->wait(pool->mutex);
+
+				if (pool->stopping)
+					return;
+
+				job = pool->jobs.front();
+				pool->jobs.pop_front();
+			}
+
+			std::string error;
+
+			try
+			{
+				job.load->decodeSegment(job.segment);
+			}
+			catch (love::Exception &e)
+			{
+				error = e.what();
+			}
+
+			job.load->finishSegment(error);
+			job.load->release();
+		}
+	}
+
+private:
+
+	DecodePool *pool;
+};
+
+static DecodePool *getDecodePool()
+{
+	love::thread::Lock lock(getDecodePoolMutex());
+
+	if (decodePool == nullptr)
+	{
+		decodePool = new DecodePool();
+
+		unsigned int threads = std::max(std::thread::hardware_concurrency(), 2u);
+		unsigned int count = std::min(threads - 1, MAX_DECODE_THREADS);
+
+		for (unsigned int i = 0; i < count; i++)
+		{
+			DecodeWorker *worker = new DecodeWorker(decodePool);
+			if (worker->start())
+				decodePool->workers.push_back(worker);
+			else
+				worker->release();
+		}
+
+		if (decodePool->workers.empty())
+		{
+			delete decodePool;
+			decodePool = nullptr;
+			throw love::Exception("Could not start sound decoding threads.");
+		}
+	}
+
+	return decodePool;
+}
+
+SoundDataLoad::SoundDataLoad(Decoder *decoder, int segmentCount)
+	: sampleRate(decoder->getSampleRate())
+	, bitDepth(decoder->getBitDepth())
+	, channels(decoder->getChannelCount())
+	, remainingSegments(0)
+{
+	if (bitDepth != 8 && bitDepth != 16)
+		throw love::Exception("Invalid bit depth: %d", bitDepth);
+
+	segmentCount = std::max(segmentCount, 1);
+
+	// Only split into as many segments as the file can be cut into reliably.
+	// The last segment always decodes to the end of the stream, in case the
+	// duration is an estimate.
+	double duration = segmentCount > 1 && decoder->isSeekable() ? decoder->getDuration() : -1.0;
+	if (duration > 0.0)
+		segmentCount = std::min(segmentCount, std::max((int) (duration / MIN_SEGMENT_SECONDS), 1));
+	else
+		segmentCount = 1;
+
+	int64 totalSamples = (int64) (duration * sampleRate);
+
+	segments.resize(segmentCount);
+	for (int i = 0; i < segmentCount; i++)
+	{
+		Segment &segment = segments[i];
+
+		// Clones are made here rather than on the worker threads, so any
+		// errors are reported right away.
+		if (i == 0)
+			segment.decoder.set(decoder);
+		else
+			segment.decoder.set(decoder->clone(), Acquire::NORETAIN);
+
+		segment.startSample = totalSamples * i / segmentCount;
+		if (i < segmentCount - 1)
+			segment.sampleCount = totalSamples * (i + 1) / segmentCount - segment.startSample;
+	}
+
+	remainingSegments = segments.size();
+
+	DecodePool *pool = getDecodePool();
+	love::thread::Lock lock(pool->mutex);
+
+	for (size_t i = 0; i < segments.size(); i++)
+	{
+		retain();
+		pool->jobs.push_back({this, i});
+	}
+
+	pool->workAvailable->broadcast();
+}
+
+SoundDataLoad::~SoundDataLoad()
+{
+}
+
+void SoundDataLoad::decodeSegment(size_t index)
+{
+	Segment &segment = segments[index];
+	Decoder *decoder = segment.decoder;
+
+	// Aim a quarter sample past the start so rounding in the decoder can't
+	// land on the sample before it.
+	if (segment.startSample > 0 && !decoder->seek((segment.startSample + 0.25) / sampleRate))
+		throw love::Exception("Could not seek to the start of a sound segment.");
+
+	size_t frameSize = (size_t) (bitDepth / 8 * channels);
+	size_t limit = segment.sampleCount >= 0 ? (size_t) segment.sampleCount * frameSize : std::numeric_limits<size_t>::max();
+
+	if (segment.sampleCount >= 0)
+		segment.data.reserve(limit);
+
+	while (segment.data.size() < limit)
+	{
+		int decoded = decoder->decode();
+		if (decoded <= 0)
+			break;
+
+		size_t bytes = std::min((size_t) decoded, limit - segment.data.size());
+		const uint8 *buffer = (const uint8 *) decoder->getBuffer();
+		segment.data.insert(segment.data.end(), buffer, buffer + bytes);
+	}
+
+	// The Decoders aren't needed anymore, and clones may hold open files.
+	segment.decoder.set(nullptr);
+}
+
+void SoundDataLoad::finishSegment(const std::string &segmentError)
+{
+	love::thread::Lock lock(mutex);
+
+	if (!segmentError.empty() && error.empty())
+		error = segmentError;
+
+	if (--remainingSegments > 0)
+		return;
+
+	if (error.empty())
+	{
+		try
+		{
+			assemble();
+		}
+		catch (love::Exception &e)
+		{
+			error = e.what();
+		}
+	}
+
+	for (Segment &segment : segments)
+		std::vector<uint8>().swap(segment.data);
+
+	finished->broadcast();
+}
+
+void SoundDataLoad::assemble()
+{
+	size_t frameSize = (size_t) (bitDepth / 8 * channels);
+
+	size_t size = 0;
+	for (const Segment &segment : segments)
+		size += segment.data.size();
+
+	int samples = (int) (size / frameSize);
+	soundData.set(new SoundData(samples, sampleRate, bitDepth, channels), Acquire::NORETAIN);
+
+	uint8 *dst = (uint8 *) soundData->getData();
+	size_t remaining = soundData->getSize();
+	for (const Segment &segment : segments)
+	{
+		size_t bytes = std::min(segment.data.size(), remaining);
+		memcpy(dst, segment.data.data(), bytes);
+		dst += bytes;
+		remaining -= bytes;
+	}
+}
+
+bool SoundDataLoad::isComplete() const
+{
+	love::thread::Lock lock(mutex);
+	return remainingSegments == 0;
+}
+
+SoundData *SoundDataLoad::getSoundData()
+{
+	love::thread::Lock lock(mutex);
+
+	while (remainingSegments > 0)
+		finished->wait(mutex);
+
+	if (!error.empty())
+		throw love::Exception("%s", error.c_str());
+
+	return soundData;
+}
+
+int SoundDataLoad::getSegmentCount() const
+{
+	return (int) segments.size();
+}
+
+void SoundDataLoad::stopDecodeThreads()
+{
+	love::thread::Lock poolLock(getDecodePoolMutex());
+
+	if (decodePool == nullptr)
+		return;
+
+	std::deque<DecodeJob> cancelled;
+
+	{
+		love::thread::Lock lock(decodePool->mutex);
+		decodePool->stopping = true;
+		decodePool->workAvailable->broadcast();
+		std::swap(cancelled, decodePool->jobs);
+	}
+
+	for (DecodeWorker *worker : decodePool->workers)
+	{
+		worker->wait();
+		worker->release();
+	}
+
+	for (const DecodeJob &job : cancelled)
+	{
+		job.load->finishSegment("The sound module was destroyed before decoding finished.");
+		job.load->release();
+	}
+
+	delete decodePool;
+	decodePool = nullptr;
+}
+
+} // sound
+} // love
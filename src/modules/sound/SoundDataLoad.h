@@ -0,0 +1,113 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_SOUND_SOUND_DATA_LOAD_H
+#define LOVE_SOUND_SOUND_DATA_LOAD_H
+
+// LOVE
+#include "common/Object.h"
+#include "common/int.h"
+#include "thread/threads.h"
+#include "SoundData.h"
+#include "Decoder.h"
+
+// STL
+#include <string>
+#include <vector>
+
+namespace love
+{
+namespace sound
+{
+
+/**
+ * Tracks a SoundData which is being decoded on the Sound module's worker
+ * threads. Seekable files can be split into segments which are decoded in
+ * parallel by clones of the Decoder.
+ **/
+class SoundDataLoad : public love::Object
+{
+public:
+
+	static love::Type type;
+
+	/**
+	 * @param decoder The Decoder to read from. It must not be used elsewhere
+	 * until the load is complete.
+	 * @param segments The maximum number of parts to decode in parallel.
+	 **/
+	SoundDataLoad(Decoder *decoder, int segments);
+	virtual ~SoundDataLoad();
+
+	bool isComplete() const;
+
+	/**
+	 * Waits for decoding to finish, and throws if it failed.
+	 * @return The decoded SoundData.
+	 **/
+	SoundData *getSoundData();
+
+	int getSegmentCount() const;
+
+	/**
+	 * Stops the worker threads, if they were started. Loads which haven't
+	 * finished yet fail.
+	 **/
+	static void stopDecodeThreads();
+
+	// Files shorter than this many seconds per segment aren't split further.
+	static const int MIN_SEGMENT_SECONDS = 5;
+
+private:
+
+	struct Segment
+	{
+		StrongRef<Decoder> decoder;
+		int64 startSample = 0;
+		// -1 decodes until the end of the stream.
+		int64 sampleCount = -1;
+		std::vector<uint8> data;
+	};
+
+	friend class DecodeWorker;
+
+	void decodeSegment(size_t index);
+	void finishSegment(const std::string &segmentError);
+	void assemble();
+
+	std::vector<Segment> segments;
+
+	int sampleRate;
+	int bitDepth;
+	int channels;
+
+	StrongRef<SoundData> soundData;
+	std::string error;
+	size_t remainingSegments;
+
+	love::thread::MutexRef mutex;
+	love::thread::ConditionalRef finished;
+
+}; // SoundDataLoad
+
+} // sound
+} // love
+
+#endif // LOVE_SOUND_SOUND_DATA_LOAD_H
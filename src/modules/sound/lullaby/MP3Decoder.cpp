@@ -135,6 +135,41 @@ drmp3_bool32 MP3Decoder::onSeek(void *pUserData, int offset, drmp3_seek_origin o
 
 MP3Decoder::MP3Decoder(Stream *stream, int bufferSize)
 : Decoder(stream, bufferSize)
+{
+	init();
+
+	try
+	{
+		seekIndex = createSeekIndex();
+	}
+	catch (love::Exception &)
+	{
+		drmp3_uninit(&mp3);
+		throw;
+	}
+
+	// bind seek table
+	if (!drmp3_bind_seek_table(&mp3, (drmp3_uint32) seekIndex->points.size(), (drmp3_seek_point *) seekIndex->points.data()))
+	{
+		drmp3_uninit(&mp3);
+		throw love::Exception("Could not bind mp3 seek table");
+	}
+}
+
+MP3Decoder::MP3Decoder(Stream *stream, int bufferSize, const std::shared_ptr<const SeekIndex> &index)
+: Decoder(stream, bufferSize)
+, seekIndex(index)
+{
+	init();
+
+	if (!drmp3_bind_seek_table(&mp3, (drmp3_uint32) seekIndex->points.size(), (drmp3_seek_point *) seekIndex->points.data()))
+	{
+		drmp3_uninit(&mp3);
+		throw love::Exception("Could not bind mp3 seek table");
+	}
+}
+
+void MP3Decoder::init()
 {
 	// Check for possible ID3 tag and skip it if necessary.
 	offset = findFirstValidHeader(stream);
@@ -146,31 +181,30 @@ MP3Decoder::MP3Decoder(Stream *stream, int bufferSize)
 		throw love::Exception("Could not read mp3 data.");
 
 	sampleRate = mp3.sampleRate;
+}
+
+std::shared_ptr<const MP3Decoder::SeekIndex> MP3Decoder::createSeekIndex()
+{
+	auto index = std::make_shared<SeekIndex>();
 
 	// calculate duration
 	drmp3_uint64 pcmCount, mp3FrameCount;
 	if (!drmp3_get_mp3_and_pcm_frame_count(&mp3, &mp3FrameCount, &pcmCount))
-	{
-		drmp3_uninit(&mp3);
 		throw love::Exception("Could not calculate mp3 duration.");
-	}
-	duration = ((double) pcmCount) / ((double) mp3.sampleRate);
+
+	index->duration = ((double) pcmCount) / ((double) mp3.sampleRate);
 
 	// create seek table
 	drmp3_uint32 mp3FrameInt = (drmp3_uint32) mp3FrameCount;
-	seekTable.resize((size_t) mp3FrameCount, {0ULL, 0ULL, 0, 0});
-	if (!drmp3_calculate_seek_points(&mp3, &mp3FrameInt, seekTable.data()))
-	{
-		drmp3_uninit(&mp3);
+	index->points.resize((size_t) mp3FrameCount, {0ULL, 0ULL, 0, 0});
+	if (!drmp3_calculate_seek_points(&mp3, &mp3FrameInt, index->points.data()))
 		throw love::Exception("Could not calculate mp3 seek table");
-	}
 
-	// bind seek table
-	if (!drmp3_bind_seek_table(&mp3, mp3FrameInt, seekTable.data()))
-	{
-		drmp3_uninit(&mp3);
-		throw love::Exception("Could not bind mp3 seek table");
-	}
+	// Fewer seek points than MP3 frames may be used.
+	index->points.resize(mp3FrameInt);
+	index->points.shrink_to_fit();
+
+	return index;
 }
 
 MP3Decoder::~MP3Decoder()
@@ -181,7 +215,7 @@ MP3Decoder::~MP3Decoder()
 love::sound::Decoder *MP3Decoder::clone()
 {
 	StrongRef<Stream> s(stream->clone(), Acquire::NORETAIN);
-	return new MP3Decoder(s, bufferSize);
+	return new MP3Decoder(s, bufferSize, seekIndex);
 }
 
 int MP3Decoder::decode()
@@ -229,7 +263,7 @@ int MP3Decoder::getBitDepth() const
 
 double MP3Decoder::getDuration()
 {
-	return duration;
+	return seekIndex->duration;
 }
 
 } // lullaby
@@ -29,6 +29,7 @@
 #include "dr/dr_mp3.h"
 
 #include <vector>
+#include <memory>
 
 namespace love
 {
@@ -54,17 +55,30 @@ public:
 	double getDuration() override;
 
 private:
+
+	// Finding the duration and seek points means scanning every MP3 frame in
+	// the stream, so clones share the result instead of scanning again.
+	struct SeekIndex
+	{
+		std::vector<drmp3_seek_point> points;
+		double duration;
+	};
+
+	MP3Decoder(Stream *stream, int bufsize, const std::shared_ptr<const SeekIndex> &index);
+
+	void init();
+	std::shared_ptr<const SeekIndex> createSeekIndex();
+
 	static size_t onRead(void *pUserData, void *pBufferOut, size_t bytesToRead);
 	static drmp3_bool32 onSeek(void *pUserData, int offset, drmp3_seek_origin origin);
 
 	// MP3 handle
 	drmp3 mp3;
-	// Used for fast seeking
-	std::vector<drmp3_seek_point> seekTable;
+	// Used for fast seeking. dr_mp3 references the seek points without
+	// copying them.
+	std::shared_ptr<const SeekIndex> seekIndex;
 	// Position of first MP3 frame found
 	int64 offset;
-
-	double duration;
 }; // MP3Decoder
 
 } // lullaby
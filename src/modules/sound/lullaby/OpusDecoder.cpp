@@ -0,0 +1,210 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "OpusDecoder.h"
+
+#ifdef LOVE_SUPPORT_OPUS
+
+#include <stdio.h>
+#include <algorithm>
+
+#include "common/Exception.h"
+
+namespace love
+{
+namespace sound
+{
+namespace lullaby
+{
+
+static int opusRead(void *datasource, unsigned char *ptr, int nbytes)
+{
+	auto stream = (Stream *) datasource;
+	return (int) stream->read(ptr, nbytes);
+}
+
+static int opusSeek(void *datasource, opus_int64 offset, int whence)
+{
+	auto stream = (Stream *) datasource;
+	auto origin = Stream::SEEKORIGIN_BEGIN;
+
+	switch (whence)
+	{
+	case SEEK_SET:
+		origin = Stream::SEEKORIGIN_BEGIN;
+		break;
+	case SEEK_CUR:
+		origin = Stream::SEEKORIGIN_CURRENT;
+		break;
+	case SEEK_END:
+		origin = Stream::SEEKORIGIN_END;
+		break;
+	default:
+		break;
+	};
+
+	return stream->seek(offset, origin) ? 0 : -1;
+}
+
+static opus_int64 opusTell(void *datasource)
+{
+	auto stream = (Stream *) datasource;
+	return (opus_int64) stream->tell();
+}
+
+static int opusClose(void *)
+{
+	// Does nothing (handled elsewhere)
+	return 0;
+}
+/**
+ * END CALLBACK FUNCTIONS
+ **/
+
+OpusDecoder::OpusDecoder(Stream *stream, int bufferSize)
+	: Decoder(stream, bufferSize)
+	, handle(nullptr)
+	, channels(0)
+	, duration(-2.0)
+{
+	OpusFileCallbacks callbacks = {};
+	callbacks.read  = opusRead;
+	callbacks.seek  = opusSeek;
+	callbacks.tell  = opusTell;
+	callbacks.close = opusClose;
+
+	handle = op_open_callbacks(stream, &callbacks, nullptr, 0, nullptr);
+	if (handle == nullptr)
+		throw love::Exception("Could not read Opus bitstream");
+
+	const OpusHead *head = op_head(handle, -1);
+	channels = head != nullptr ? head->channel_count : 0;
+
+	// op_read returns whatever channel layout the stream has, but Sources only
+	// handle mono and stereo.
+	if (channels != 1 && channels != 2)
+	{
+		op_free(handle);
+		throw love::Exception("Unsupported Opus channel count: %d", channels);
+	}
+}
+
+OpusDecoder::~OpusDecoder()
+{
+	op_free(handle);
+}
+
+love::sound::Decoder *OpusDecoder::clone()
+{
+	StrongRef<Stream> s(stream->clone(), Acquire::NORETAIN);
+	return new OpusDecoder(s, bufferSize);
+}
+
+int OpusDecoder::decode()
+{
+	int size = 0;
+	int frameSize = channels * (int) sizeof(opus_int16);
+
+	while (size + frameSize <= bufferSize)
+	{
+		opus_int16 *out = (opus_int16 *) ((char *) buffer + size);
+		int result = op_read(handle, out, (bufferSize - size) / (int) sizeof(opus_int16), nullptr);
+
+		if (result == OP_HOLE)
+			continue;
+		else if (result < 0)
+			return -1;
+		else if (result == 0)
+		{
+			eof = true;
+			break;
+		}
+		else
+			size += result * frameSize;
+	}
+
+	return size;
+}
+
+bool OpusDecoder::seek(double s)
+{
+	ogg_int64_t offset = (ogg_int64_t) (std::max(s, 0.0) * SAMPLE_RATE);
+
+	if (op_pcm_seek(handle, offset) == 0)
+	{
+		eof = false;
+		return true;
+	}
+
+	return false;
+}
+
+bool OpusDecoder::rewind()
+{
+	if (op_raw_seek(handle, 0) == 0)
+	{
+		eof = false;
+		return true;
+	}
+
+	return false;
+}
+
+bool OpusDecoder::isSeekable()
+{
+	return op_seekable(handle) != 0;
+}
+
+int OpusDecoder::getChannelCount() const
+{
+	return channels;
+}
+
+int OpusDecoder::getBitDepth() const
+{
+	return 16;
+}
+
+int OpusDecoder::getSampleRate() const
+{
+	return SAMPLE_RATE;
+}
+
+double OpusDecoder::getDuration()
+{
+	// Only calculate the duration if we haven't done so already.
+	if (duration == -2.0)
+	{
+		ogg_int64_t samples = op_pcm_total(handle, -1);
+
+		if (samples < 0)
+			duration = -1.0;
+		else
+			duration = (double) samples / (double) SAMPLE_RATE;
+	}
+
+	return duration;
+}
+
+} // lullaby
+} // sound
+} // love
+
+#endif // LOVE_SUPPORT_OPUS
@@ -31,6 +31,10 @@
 #include "FLACDecoder.h"
 #include "MP3Decoder.h"
 
+#ifdef LOVE_SUPPORT_OPUS
+#	include "OpusDecoder.h"
+#endif
+
 #ifdef LOVE_SUPPORT_COREAUDIO
 #	include "CoreAudioDecoder.h"
 #endif
@@ -73,6 +77,9 @@ sound::Decoder *Sound::newDecoder(Stream *stream, int bufferSize)
 		DecoderImplFor<WaveDecoder>(),
 		DecoderImplFor<FLACDecoder>(),
 		DecoderImplFor<VorbisDecoder>(),
+#ifdef LOVE_SUPPORT_OPUS
+		DecoderImplFor<OpusDecoder>(),
+#endif
 #ifdef LOVE_SUPPORT_COREAUDIO
 		DecoderImplFor<CoreAudioDecoder>(),
 #endif
@@ -50,6 +50,13 @@ int w_newDecoder(lua_State *L)
 		{
 			auto file = love::filesystem::luax_getfile(L, 1);
 			luax_catchexcept(L, [&]() { file->open(love::filesystem::File::MODE_READ); });
+
+			// Decoders read sequentially, so file reads can happen ahead of
+			// them in the background unless the file was set up differently.
+			int64 buffersize = 0;
+			if (file->getBuffer(buffersize) == love::filesystem::File::BUFFER_NONE)
+				file->setBuffer(love::filesystem::File::BUFFER_READAHEAD, 0);
+
 			stream = file;
 		}
 		else
@@ -115,17 +122,41 @@ int w_newSoundData(lua_State *L)
 	return 1;
 }
 
+int w_newSoundDataAsync(lua_State *L)
+{
+	int segments = (int) luaL_optinteger(L, 2, 1);
+	if (segments < 1)
+		return luaL_error(L, "Segment count must be at least 1.");
+
+	// Convert to Decoder, if necessary.
+	if (!luax_istype(L, 1, Decoder::type))
+	{
+		lua_settop(L, 1);
+		w_newDecoder(L);
+		lua_replace(L, 1);
+	}
+
+	SoundDataLoad *t = nullptr;
+	luax_catchexcept(L, [&](){ t = instance()->newSoundDataAsync(luax_checkdecoder(L, 1), segments); });
+
+	luax_pushtype(L, t);
+	t->release();
+	return 1;
+}
+
 // List of functions to wrap.
 static const luaL_Reg functions[] =
 {
 	{ "newDecoder",  w_newDecoder },
 	{ "newSoundData",  w_newSoundData },
+	{ "newSoundDataAsync",  w_newSoundDataAsync },
 	{ 0, 0 }
 };
 
 static const lua_CFunction types[] =
 {
 	luaopen_sounddata,
+	luaopen_sounddataload,
 	luaopen_decoder,
 	0
 };
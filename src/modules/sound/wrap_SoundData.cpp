@@ -134,6 +134,20 @@ int w_SoundData_copyFrom(lua_State *L)
 	return 0;
 }
 
+int w_SoundData_mix(lua_State *L)
+{
+	SoundData *dst = luax_checksounddata(L, 1);
+	const SoundData *src = luax_checksounddata(L, 2);
+
+	float gain = (float) luaL_optnumber(L, 3, 1.0);
+	int srcStart = (int) luaL_optinteger(L, 4, 0);
+	int count = (int) luaL_optinteger(L, 5, -1);
+	int dstStart = (int) luaL_optinteger(L, 6, 0);
+
+	luax_catchexcept(L, [&](){ dst->mix(src, gain, srcStart, count, dstStart); });
+	return 0;
+}
+
 int w_SoundData_slice(lua_State *L)
 {
 	SoundData *t = luax_checksounddata(L, 1), *c = nullptr;
@@ -157,6 +171,7 @@ static const luaL_Reg w_SoundData_functions[] =
 	{ "setSample", w_SoundData_setSample },
 	{ "getSample", w_SoundData_getSample },
 	{ "copyFrom", w_SoundData_copyFrom },
+	{ "mix", w_SoundData_mix },
 	{ "slice", w_SoundData_slice },
 
 	{ 0, 0 }
@@ -172,5 +187,46 @@ extern "C" int luaopen_sounddata(lua_State *L)
 	return ret;
 }
 
+static SoundDataLoad *luax_checksounddataload(lua_State *L, int idx)
+{
+	return luax_checktype<SoundDataLoad>(L, idx);
+}
+
+int w_SoundDataLoad_isComplete(lua_State *L)
+{
+	SoundDataLoad *load = luax_checksounddataload(L, 1);
+	luax_pushboolean(L, load->isComplete());
+	return 1;
+}
+
+int w_SoundDataLoad_getSoundData(lua_State *L)
+{
+	SoundDataLoad *load = luax_checksounddataload(L, 1);
+	SoundData *t = nullptr;
+	luax_catchexcept(L, [&](){ t = load->getSoundData(); });
+	luax_pushtype(L, t);
+	return 1;
+}
+
+int w_SoundDataLoad_getSegmentCount(lua_State *L)
+{
+	SoundDataLoad *load = luax_checksounddataload(L, 1);
+	lua_pushinteger(L, load->getSegmentCount());
+	return 1;
+}
+
+static const luaL_Reg w_SoundDataLoad_functions[] =
+{
+	{ "isComplete", w_SoundDataLoad_isComplete },
+	{ "getSoundData", w_SoundDataLoad_getSoundData },
+	{ "getSegmentCount", w_SoundDataLoad_getSegmentCount },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_sounddataload(lua_State *L)
+{
+	return luax_register_type(L, &SoundDataLoad::type, w_SoundDataLoad_functions, nullptr);
+}
+
 } // sound
 } // love
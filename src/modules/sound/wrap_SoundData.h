@@ -24,6 +24,7 @@
 // LOVE
 #include "common/runtime.h"
 #include "SoundData.h"
+#include "SoundDataLoad.h"
 
 namespace love
 {
@@ -32,6 +33,7 @@ namespace sound
 
 SoundData *luax_checksounddata(lua_State *L, int idx);
 extern "C" int luaopen_sounddata(lua_State *L);
+extern "C" int luaopen_sounddataload(lua_State *L);
 
 } // sound
 } // love
@@ -22,17 +22,12 @@ misrepresented as being the original software.
 3. This notice may not be removed or altered from any source distribution.
 --]]
 
-local SoundData_mt = ...
+local SoundData_mt, ffifuncspointer_str, ffiwrapper = ...
 local SoundData = SoundData_mt.__index
 
-if type(jit) ~= "table" or not jit.status() then
-	-- LuaJIT's FFI is *much* slower than LOVE's regular methods when the JIT
-	-- compiler is disabled.
-	return
-end
+if ffiwrapper == nil or not ffiwrapper.isjitenabled() then return end
 
-local status, ffi = pcall(require, "ffi")
-if not status then return end
+local ffi = ffiwrapper.ffi
 
 local tonumber, assert, error = tonumber, assert, error
 local floor = math.floor
@@ -21,6 +21,7 @@
 // LOVE
 #include "wrap_System.h"
 #include "sdl/System.h"
+#include "common/memory.h"
 
 namespace love
 {
@@ -117,6 +118,40 @@ int w_getPreferredLocales(lua_State* L)
 	return 1;
 }
 
+int w_getMemoryStats(lua_State *L)
+{
+	lua_createtable(L, 0, MEMORYTAG_MAX_ENUM + 2);
+	lua_createtable(L, 0, MEMORYTAG_MAX_ENUM);
+
+	for (int i = 0; i < MEMORYTAG_MAX_ENUM; i++)
+	{
+		MemoryTag tag = (MemoryTag) i;
+		const char *name = nullptr;
+		if (!getConstant(tag, name))
+			continue;
+
+		lua_pushnumber(L, (lua_Number) getTrackedMemory(tag));
+		lua_setfield(L, -3, name);
+
+		lua_pushnumber(L, (lua_Number) getTrackedMemoryPeak(tag));
+		lua_setfield(L, -2, name);
+	}
+
+	lua_setfield(L, -2, "peak");
+
+	lua_Number luabytes = lua_gc(L, LUA_GCCOUNT, 0) * 1024.0 + lua_gc(L, LUA_GCCOUNTB, 0);
+	lua_pushnumber(L, luabytes);
+	lua_setfield(L, -2, "lua");
+
+	return 1;
+}
+
+int w_resetMemoryPeaks(lua_State *)
+{
+	resetTrackedMemoryPeaks();
+	return 0;
+}
+
 static const luaL_Reg functions[] =
 {
 	{ "getOS", w_getOS },
@@ -128,6 +163,8 @@ static const luaL_Reg functions[] =
 	{ "vibrate", w_vibrate },
 	{ "hasBackgroundMusic", w_hasBackgroundMusic },
 	{ "getPreferredLocales", w_getPreferredLocales },
+	{ "getMemoryStats", w_getMemoryStats },
+	{ "resetMemoryPeaks", w_resetMemoryPeaks },
 	{ 0, 0 }
 };
 
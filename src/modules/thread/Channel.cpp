@@ -21,6 +21,7 @@
 #include "Channel.h"
 
 #include <timer/Timer.h>
+#include <event/Event.h>
 
 namespace love
 {
@@ -30,7 +31,8 @@ namespace thread
 love::Type Channel::type("Channel", &Object::type);
 
 Channel::Channel()
-	: sent(0)
+	: eventWatchers(0)
+	, sent(0)
 	, received(0)
 {
 }
@@ -46,6 +48,8 @@ uint64 Channel::push(const Variant &var)
 	queue.push(var);
 	cond->broadcast();
 
+	notifyEventWatchers();
+
 	return ++sent;
 }
 
@@ -164,6 +168,48 @@ void Channel::clear()
 	cond->broadcast();
 }
 
+int Channel::pushMany(const std::vector<Variant> &vars)
+{
+	Lock l(mutex);
+
+	for (const Variant &var : vars)
+		queue.push(var);
+
+	sent += vars.size();
+	cond->broadcast();
+
+	if (!vars.empty())
+		notifyEventWatchers();
+
+	return (int) vars.size();
+}
+
+int Channel::popMany(std::vector<Variant> &vars, int max)
+{
+	Lock l(mutex);
+
+	int count = 0;
+	while (count < max && !queue.empty())
+	{
+		vars.push_back(queue.front());
+		queue.pop();
+		count++;
+	}
+
+	if (count > 0)
+	{
+		received += count;
+		cond->broadcast();
+	}
+
+	return count;
+}
+
+bool Channel::isLockFree() const
+{
+	return false;
+}
+
 void Channel::lockMutex()
 {
 	mutex->lock();
@@ -174,5 +220,29 @@ void Channel::unlockMutex()
 	mutex->unlock();
 }
 
+void Channel::addEventWatcher()
+{
+	eventWatchers.fetch_add(1);
+}
+
+void Channel::removeEventWatcher()
+{
+	eventWatchers.fetch_sub(1);
+}
+
+void Channel::notifyEventWatchers()
+{
+	// Pairs with the seq_cst increment in addEventWatcher: either the watcher
+	// sees the pushed value when it checks getCount, or this sees the watcher.
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+
+	if (eventWatchers.load(std::memory_order_relaxed) > 0)
+	{
+		auto eventmodule = Module::getInstance<love::event::Event>(Module::M_EVENT);
+		if (eventmodule != nullptr)
+			eventmodule->wake();
+	}
+}
+
 } // thread
 } // love
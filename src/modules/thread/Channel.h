@@ -22,7 +22,9 @@
 #define LOVE_THREAD_CHANNEL_H
 
 // STL
+#include <atomic>
 #include <queue>
+#include <vector>
 
 // LOVE
 #include "common/Variant.h"
@@ -41,26 +43,44 @@ public:
 	static love::Type type;
 
 	Channel();
-	~Channel();
-
-	uint64 push(const Variant &var);
-	bool supply(const Variant &var); // blocking push
-	bool supply(const Variant &var, double timeout);
-	bool pop(Variant *var);
-	bool demand(Variant *var); // blocking pop
-	bool demand(Variant *var, double timeout); // blocking pop
-	bool peek(Variant *var);
-	int getCount() const;
-	bool hasRead(uint64 id) const;
-	void clear();
+	virtual ~Channel();
+
+	virtual uint64 push(const Variant &var);
+	virtual bool supply(const Variant &var); // blocking push
+	virtual bool supply(const Variant &var, double timeout);
+	virtual bool pop(Variant *var);
+	virtual bool demand(Variant *var); // blocking pop
+	virtual bool demand(Variant *var, double timeout); // blocking pop
+	virtual bool peek(Variant *var);
+	virtual int getCount() const;
+	virtual bool hasRead(uint64 id) const;
+	virtual void clear();
+
+	// Pushes or pops several values at once, returning how many were.
+	virtual int pushMany(const std::vector<Variant> &vars);
+	virtual int popMany(std::vector<Variant> &vars, int max);
+
+	virtual bool isLockFree() const;
 
 	void lockMutex();
 	void unlockMutex();
 
-private:
+	// love.event.wait can watch Channels. While it does, pushes wake it up.
+	void addEventWatcher();
+	void removeEventWatcher();
+
+protected:
+
+	// Wakes up love.event.wait if it's watching this Channel.
+	void notifyEventWatchers();
 
 	MutexRef mutex;
 	ConditionalRef cond;
+
+private:
+
+	std::atomic<int> eventWatchers;
+
 	std::queue<Variant> queue;
 
 	uint64 sent;
@@ -0,0 +1,219 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "Job.h"
+#include "JobPool.h"
+
+namespace love
+{
+namespace thread
+{
+
+love::Type Job::type("Job", &Object::type);
+
+Job::Job(JobPool *pool, const std::string &function, const std::vector<Variant> &args)
+	: pool(pool)
+	, function(function)
+	, args(args)
+	, ranged(false)
+	, first(0)
+	, last(0)
+	, grain(0)
+	, waitingDependencies(0)
+	, dependencyFailed(false)
+	, status(STATUS_PENDING)
+	, remainingTasks(0)
+{
+}
+
+Job::Job(JobPool *pool, const std::string &function, const std::vector<Variant> &args, int64 first, int64 last, int64 grain)
+	: pool(pool)
+	, function(function)
+	, args(args)
+	, ranged(true)
+	, first(first)
+	, last(last)
+	, grain(grain)
+	, waitingDependencies(0)
+	, dependencyFailed(false)
+	, status(STATUS_PENDING)
+	, remainingTasks(0)
+{
+}
+
+Job::~Job()
+{
+}
+
+JobPool *Job::getPool() const
+{
+	return pool;
+}
+
+const std::string &Job::getFunction() const
+{
+	return function;
+}
+
+const std::vector<Variant> &Job::getArgs() const
+{
+	return args;
+}
+
+bool Job::isRanged() const
+{
+	return ranged;
+}
+
+void Job::getRange(int64 &first, int64 &last, int64 &grain) const
+{
+	first = this->first;
+	last = this->last;
+	grain = this->grain;
+}
+
+Job::Status Job::getStatus()
+{
+	Lock l(mutex);
+	return status;
+}
+
+bool Job::isDone()
+{
+	Lock l(mutex);
+	return status == STATUS_COMPLETE || status == STATUS_FAILED;
+}
+
+std::string Job::getError()
+{
+	Lock l(mutex);
+	return error;
+}
+
+std::vector<Variant> Job::getResults()
+{
+	Lock l(mutex);
+	return results;
+}
+
+void Job::wait()
+{
+	Lock l(mutex);
+
+	while (status == STATUS_PENDING || status == STATUS_RUNNING)
+		cond->wait(mutex);
+}
+
+bool Job::addDependent(Job *job)
+{
+	Lock l(mutex);
+
+	if (status == STATUS_COMPLETE)
+		return false;
+
+	if (status == STATUS_FAILED)
+	{
+		job->dependencyFailed = true;
+		return false;
+	}
+
+	job->retain();
+	dependents.push_back(job);
+	return true;
+}
+
+void Job::setWaitingDependencies(int count)
+{
+	waitingDependencies = count;
+}
+
+bool Job::releaseDependency(bool failed)
+{
+	if (failed)
+		dependencyFailed = true;
+
+	return waitingDependencies.fetch_sub(1) == 1;
+}
+
+bool Job::hasFailedDependency() const
+{
+	return dependencyFailed;
+}
+
+void Job::start(int tasks)
+{
+	Lock l(mutex);
+	remainingTasks = tasks;
+}
+
+void Job::startTask()
+{
+	Lock l(mutex);
+	if (status == STATUS_PENDING)
+		status = STATUS_RUNNING;
+}
+
+void Job::finishTask(const std::string &taskerror, const std::vector<Variant> &taskresults)
+{
+	std::vector<Job *> released;
+	bool failed = false;
+
+	{
+		Lock l(mutex);
+
+		if (!taskerror.empty() && error.empty())
+			error = taskerror;
+
+		if (!ranged)
+			results = taskresults;
+
+		if (--remainingTasks > 0)
+			return;
+
+		if (dependencyFailed && error.empty())
+			error = "A job this job depends on failed.";
+
+		status = error.empty() ? STATUS_COMPLETE : STATUS_FAILED;
+		failed = status == STATUS_FAILED;
+
+		released.swap(dependents);
+		cond->broadcast();
+	}
+
+	for (Job *job : released)
+	{
+		if (job->releaseDependency(failed))
+			pool->schedule(job);
+
+		job->release();
+	}
+}
+
+STRINGMAP_CLASS_BEGIN(Job, Job::Status, Job::STATUS_MAX_ENUM, status)
+{
+	{ "pending",  Job::STATUS_PENDING  },
+	{ "running",  Job::STATUS_RUNNING  },
+	{ "complete", Job::STATUS_COMPLETE },
+	{ "failed",   Job::STATUS_FAILED   },
+}
+STRINGMAP_CLASS_END(Job, Job::Status, Job::STATUS_MAX_ENUM, status)
+
+} // thread
+} // love
@@ -0,0 +1,130 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_THREAD_JOB_H
+#define LOVE_THREAD_JOB_H
+
+// LOVE
+#include "common/Object.h"
+#include "common/StringMap.h"
+#include "common/Variant.h"
+#include "common/int.h"
+#include "threads.h"
+
+// STL
+#include <atomic>
+#include <string>
+#include <vector>
+
+namespace love
+{
+namespace thread
+{
+
+class JobPool;
+
+/**
+ * A call to a named function in a JobPool's code, or a parallel-for over a
+ * range of integers which is split into chunks run by different workers.
+ * Jobs can depend on other jobs in the same pool, and only start once all
+ * of those are complete. All methods can be called from any thread.
+ **/
+class Job : public love::Object
+{
+public:
+
+	static love::Type type;
+
+	enum Status
+	{
+		STATUS_PENDING,
+		STATUS_RUNNING,
+		STATUS_COMPLETE,
+		STATUS_FAILED,
+		STATUS_MAX_ENUM
+	};
+
+	Job(JobPool *pool, const std::string &function, const std::vector<Variant> &args);
+	Job(JobPool *pool, const std::string &function, const std::vector<Variant> &args, int64 first, int64 last, int64 grain);
+	virtual ~Job();
+
+	JobPool *getPool() const;
+	const std::string &getFunction() const;
+	const std::vector<Variant> &getArgs() const;
+
+	bool isRanged() const;
+	void getRange(int64 &first, int64 &last, int64 &grain) const;
+
+	Status getStatus();
+	bool isDone();
+	std::string getError();
+
+	/**
+	 * Gets the values returned by the job's function. Parallel-for jobs
+	 * have no results.
+	 **/
+	std::vector<Variant> getResults();
+
+	/**
+	 * Blocks until the job is complete or has failed.
+	 **/
+	void wait();
+
+	// Used by the JobPool.
+	bool addDependent(Job *job);
+	void setWaitingDependencies(int count);
+	bool releaseDependency(bool failed);
+	bool hasFailedDependency() const;
+	void start(int tasks);
+	void startTask();
+	void finishTask(const std::string &error, const std::vector<Variant> &results);
+
+	STRINGMAP_CLASS_DECLARE(Status);
+
+private:
+
+	JobPool *pool;
+	std::string function;
+	std::vector<Variant> args;
+
+	bool ranged;
+	int64 first;
+	int64 last;
+	int64 grain;
+
+	// Set before the job is scheduled, then only counted down.
+	std::atomic<int> waitingDependencies;
+	std::atomic<bool> dependencyFailed;
+
+	Status status;
+	int remainingTasks;
+	std::string error;
+	std::vector<Variant> results;
+	std::vector<Job *> dependents;
+
+	MutexRef mutex;
+	ConditionalRef cond;
+
+}; // Job
+
+} // thread
+} // love
+
+#endif // LOVE_THREAD_JOB_H
@@ -0,0 +1,394 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "JobPool.h"
+#include "LuaThread.h"
+#include "common/Exception.h"
+#include "common/runtime.h"
+#include "common/profiler.h"
+
+// STL
+#include <algorithm>
+#include <thread>
+
+namespace love
+{
+namespace thread
+{
+
+love::Type JobPool::type("JobPool", &Object::type);
+
+// The worker running on the current thread, if any. Jobs released by a
+// worker's task are queued on that worker, since their inputs are likely
+// still in its cache.
+static thread_local int currentWorker = -1;
+static thread_local JobPool *currentPool = nullptr;
+
+struct TaskContext
+{
+	Job *job;
+	int64 first;
+	int64 last;
+	int functionsRef;
+	std::vector<Variant> results;
+};
+
+// Runs inside lua_pcall, so errors while calling the job function or while
+// converting its results are caught.
+static int runTask(lua_State *L)
+{
+	TaskContext *context = (TaskContext *) lua_touserdata(L, 1);
+	Job *job = context->job;
+
+	lua_rawgeti(L, LUA_REGISTRYINDEX, context->functionsRef);
+	lua_getfield(L, -1, job->getFunction().c_str());
+	lua_remove(L, -2);
+
+	if (!lua_isfunction(L, -1))
+		return luaL_error(L, "No job function named '%s'.", job->getFunction().c_str());
+
+	int base = lua_gettop(L);
+	const std::vector<Variant> &args = job->getArgs();
+
+	luaL_checkstack(L, (int) args.size() + 2, "too many job arguments");
+
+	if (job->isRanged())
+	{
+		lua_pushnumber(L, (lua_Number) context->first);
+		lua_pushnumber(L, (lua_Number) context->last);
+	}
+
+	for (const Variant &arg : args)
+		luax_pushvariant(L, arg);
+
+	lua_call(L, lua_gettop(L) - base, LUA_MULTRET);
+
+	if (job->isRanged())
+		return 0;
+
+	for (int i = base; i <= lua_gettop(L); i++)
+	{
+		luax_catchexcept(L, [&]() { context->results.push_back(luax_checkvariant(L, i)); });
+
+		if (context->results.back().getType() == Variant::UNKNOWN)
+			return luaL_error(L, "Job function '%s' returned a value which can't be sent between threads.", job->getFunction().c_str());
+	}
+
+	return 0;
+}
+
+JobPool::Worker::Worker(JobPool *pool, int index)
+	: pool(pool)
+	, index(index)
+{
+	threadName = pool->name;
+}
+
+void JobPool::Worker::threadFunction()
+{
+	setProfilerThreadName(threadName);
+
+	currentWorker = index;
+	currentPool = pool;
+
+	lua_State *L = LuaThread::newState();
+
+	lua_pushcfunction(L, luax_traceback);
+	int tracebackidx = lua_gettop(L);
+
+	std::string loaderror;
+	int functionsref = LUA_NOREF;
+
+	const love::Data *code = pool->code.get();
+
+	if (luaL_loadbuffer(L, (const char *) code->getData(), code->getSize(), pool->name.c_str()) != 0
+		|| lua_pcall(L, 0, 1, tracebackidx) != 0)
+		loaderror = luax_tostring(L, -1);
+	else if (!lua_istable(L, -1))
+		loaderror = "Job pool code must return a table of job functions.";
+	else
+	{
+		lua_pushvalue(L, -1);
+		functionsref = luaL_ref(L, LUA_REGISTRYINDEX);
+	}
+
+	lua_settop(L, tracebackidx);
+
+	Task task;
+	while (pool->takeTask(index, task))
+	{
+		Job *job = task.job;
+		job->startTask();
+
+		if (!loaderror.empty())
+			job->finishTask(loaderror, {});
+		else
+		{
+			TaskContext context = {job, task.first, task.last, functionsref, {}};
+			std::string error;
+
+			lua_pushcfunction(L, runTask);
+			lua_pushlightuserdata(L, &context);
+
+			if (lua_pcall(L, 1, 0, tracebackidx) != 0)
+			{
+				error = luax_tostring(L, -1);
+				context.results.clear();
+			}
+
+			lua_settop(L, tracebackidx);
+			job->finishTask(error, context.results);
+		}
+
+		job->release();
+	}
+
+	lua_close(L);
+
+	currentWorker = -1;
+	currentPool = nullptr;
+}
+
+JobPool::JobPool(const std::string &name, love::Data *code, int threadcount)
+	: name(name)
+	, code(code)
+	, queuedTasks(0)
+	, sleepingWorkers(0)
+	, nextWorker(0)
+	, stopping(false)
+{
+	if (threadcount <= 0)
+		threadcount = std::max((int) std::thread::hardware_concurrency() - 1, 1);
+
+	for (int i = 0; i < threadcount; i++)
+		workers.push_back(new Worker(this, i));
+
+	for (Worker *worker : workers)
+		worker->start();
+}
+
+JobPool::~JobPool()
+{
+	stopping = true;
+
+	{
+		Lock l(mutex);
+		cond->broadcast();
+	}
+
+	for (Worker *worker : workers)
+		worker->wait();
+
+	// Tasks which never ran fail their jobs, which fails anything depending
+	// on them in turn (see schedule).
+	for (Worker *worker : workers)
+	{
+		for (const Task &task : worker->tasks)
+		{
+			task.job->finishTask("The job pool was destroyed.", {});
+			task.job->release();
+		}
+
+		worker->tasks.clear();
+	}
+
+	for (Worker *worker : workers)
+		delete worker;
+}
+
+Job *JobPool::submit(const std::string &function, const std::vector<Variant> &args, const std::vector<Job *> &dependencies)
+{
+	return addJob(new Job(this, function, args), dependencies);
+}
+
+Job *JobPool::parallelFor(const std::string &function, int64 first, int64 last, int64 grain, const std::vector<Variant> &args, const std::vector<Job *> &dependencies)
+{
+	return addJob(new Job(this, function, args, first, last, grain), dependencies);
+}
+
+int JobPool::getThreadCount() const
+{
+	return (int) workers.size();
+}
+
+Job *JobPool::addJob(Job *job, const std::vector<Job *> &dependencies)
+{
+	for (Job *dependency : dependencies)
+	{
+		if (dependency->getPool() != this)
+		{
+			job->release();
+			throw love::Exception("Job dependencies must belong to the same JobPool.");
+		}
+	}
+
+	// One extra count, so the job can't be scheduled before every dependency
+	// has been registered.
+	job->setWaitingDependencies((int) dependencies.size() + 1);
+
+	for (Job *dependency : dependencies)
+	{
+		if (!dependency->addDependent(job))
+			job->releaseDependency(false);
+	}
+
+	if (job->releaseDependency(false))
+		schedule(job);
+
+	return job;
+}
+
+void JobPool::schedule(Job *job)
+{
+	if (stopping)
+	{
+		job->start(1);
+		job->finishTask("The job pool was destroyed.", {});
+		return;
+	}
+
+	int worker = currentPool == this ? currentWorker : (int) (nextWorker++ % workers.size());
+
+	if (job->hasFailedDependency())
+	{
+		job->start(1);
+		job->finishTask("", {});
+		return;
+	}
+
+	if (!job->isRanged())
+	{
+		job->start(1);
+		pushTask({job, 0, 0}, worker);
+		wake(1);
+		return;
+	}
+
+	int64 first = 0;
+	int64 last = 0;
+	int64 grain = 0;
+	job->getRange(first, last, grain);
+
+	int64 count = last - first + 1;
+	if (count <= 0)
+	{
+		job->start(1);
+		job->finishTask("", {});
+		return;
+	}
+
+	if (grain <= 0)
+	{
+		int64 chunks = (int64) workers.size() * 4;
+		grain = std::max<int64>((count + chunks - 1) / chunks, 1);
+	}
+
+	int tasks = (int) ((count + grain - 1) / grain);
+	job->start(tasks);
+
+	// Chunks are spread over every worker up front, so most of them don't
+	// need to be stolen.
+	for (int i = 0; i < tasks; i++)
+	{
+		int64 chunkfirst = first + (int64) i * grain;
+		int64 chunklast = std::min(chunkfirst + grain - 1, last);
+		pushTask({job, chunkfirst, chunklast}, (worker + i) % (int) workers.size());
+	}
+
+	wake(tasks);
+}
+
+void JobPool::pushTask(const Task &task, int worker)
+{
+	task.job->retain();
+
+	Worker *w = workers[worker];
+	Lock l(w->mutex);
+	w->tasks.push_back(task);
+}
+
+void JobPool::wake(int count)
+{
+	queuedTasks += count;
+
+	// Pairs with the fence in takeTask: either the worker sees the new tasks,
+	// or this sees the sleeping worker.
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+
+	if (sleepingWorkers.load(std::memory_order_relaxed) > 0)
+	{
+		Lock l(mutex);
+		if (count == 1)
+			cond->signal();
+		else
+			cond->broadcast();
+	}
+}
+
+bool JobPool::takeTask(int worker, Task &task)
+{
+	int workercount = (int) workers.size();
+
+	while (!stopping)
+	{
+		{
+			Worker *w = workers[worker];
+			Lock l(w->mutex);
+
+			if (!w->tasks.empty())
+			{
+				task = w->tasks.back();
+				w->tasks.pop_back();
+				queuedTasks--;
+				return true;
+			}
+		}
+
+		for (int i = 1; i < workercount; i++)
+		{
+			Worker *victim = workers[(worker + i) % workercount];
+			Lock l(victim->mutex);
+
+			if (!victim->tasks.empty())
+			{
+				task = victim->tasks.front();
+				victim->tasks.pop_front();
+				queuedTasks--;
+				return true;
+			}
+		}
+
+		sleepingWorkers++;
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		{
+			Lock l(mutex);
+			while (queuedTasks.load() <= 0 && !stopping)
+				cond->wait(mutex);
+		}
+
+		sleepingWorkers--;
+	}
+
+	return false;
+}
+
+} // thread
+} // love
@@ -0,0 +1,139 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_THREAD_JOB_POOL_H
+#define LOVE_THREAD_JOB_POOL_H
+
+// LOVE
+#include "common/Data.h"
+#include "common/Object.h"
+#include "common/Variant.h"
+#include "common/int.h"
+#include "threads.h"
+#include "Job.h"
+
+// STL
+#include <atomic>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace love
+{
+namespace thread
+{
+
+/**
+ * A fixed set of worker threads, each with its own Lua state, which run Jobs.
+ * The pool's code is run once in every worker and returns a table of job
+ * functions, which Jobs refer to by name.
+ *
+ * Each worker has its own queue of tasks. Workers take their newest task
+ * first, and when their queue is empty they steal the oldest task of another
+ * worker, so work spreads out without a single shared queue.
+ *
+ * Destroying the pool fails every job which hasn't run yet.
+ **/
+class JobPool : public love::Object
+{
+public:
+
+	static love::Type type;
+
+	/**
+	 * @param threadcount The number of workers, or 0 to use one less than the
+	 *        number of CPU cores.
+	 **/
+	JobPool(const std::string &name, love::Data *code, int threadcount);
+	virtual ~JobPool();
+
+	/**
+	 * Calls a job function with the given arguments, once all dependencies
+	 * are complete.
+	 **/
+	Job *submit(const std::string &function, const std::vector<Variant> &args, const std::vector<Job *> &dependencies);
+
+	/**
+	 * Calls a job function with (chunkfirst, chunklast, args...) for chunks of
+	 * grain values covering first to last, inclusive. A grain of 0 picks a
+	 * size which gives each worker several chunks.
+	 **/
+	Job *parallelFor(const std::string &function, int64 first, int64 last, int64 grain, const std::vector<Variant> &args, const std::vector<Job *> &dependencies);
+
+	int getThreadCount() const;
+
+	// Queues a job whose dependencies are all done. Called by Jobs.
+	void schedule(Job *job);
+
+private:
+
+	struct Task
+	{
+		Job *job;
+		int64 first;
+		int64 last;
+	};
+
+	class Worker : public Threadable
+	{
+	public:
+
+		Worker(JobPool *pool, int index);
+		virtual ~Worker() {}
+
+		void threadFunction() override;
+
+		// Guarded by mutex. The owner takes from the back, thieves from the
+		// front.
+		std::deque<Task> tasks;
+		MutexRef mutex;
+
+	private:
+
+		JobPool *pool;
+		int index;
+
+	}; // Worker
+
+	Job *addJob(Job *job, const std::vector<Job *> &dependencies);
+	void pushTask(const Task &task, int worker);
+	void wake(int count);
+	bool takeTask(int worker, Task &task);
+
+	std::string name;
+	StrongRef<love::Data> code;
+
+	std::vector<Worker *> workers;
+
+	std::atomic<int> queuedTasks;
+	std::atomic<int> sleepingWorkers;
+	std::atomic<uint32> nextWorker;
+	std::atomic<bool> stopping;
+
+	// Only used by workers with nothing to do.
+	MutexRef mutex;
+	ConditionalRef cond;
+
+}; // JobPool
+
+} // thread
+} // love
+
+#endif // LOVE_THREAD_JOB_POOL_H
@@ -0,0 +1,308 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "LockFreeChannel.h"
+#include "common/memory.h"
+
+#include <timer/Timer.h>
+
+namespace love
+{
+namespace thread
+{
+
+LockFreeChannel::LockFreeChannel(int capacity)
+	: cells(nullptr)
+	, mask(0)
+	, pushPosition(0)
+	, popPosition(0)
+	, waiters(0)
+{
+	if (capacity < 1 || capacity > MAX_CAPACITY)
+		throw love::Exception("Channel capacity must be between 1 and %d.", MAX_CAPACITY);
+
+	uint64 size = 1;
+	while (size < (uint64) capacity)
+		size <<= 1;
+
+	cells = new Cell[size];
+	trackMemory(MEMORYTAG_VARIANT, (int64) (size * sizeof(Cell)));
+	mask = size - 1;
+
+	for (uint64 i = 0; i < size; i++)
+		cells[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+LockFreeChannel::~LockFreeChannel()
+{
+	trackMemory(MEMORYTAG_VARIANT, -(int64) ((mask + 1) * sizeof(Cell)));
+	delete[] cells;
+}
+
+bool LockFreeChannel::tryPush(const Variant &var, uint64 *id)
+{
+	uint64 pos = pushPosition.load(std::memory_order_relaxed);
+	Cell *cell = nullptr;
+
+	while (true)
+	{
+		cell = &cells[pos & mask];
+		uint64 seq = cell->sequence.load(std::memory_order_acquire);
+		int64 diff = (int64) seq - (int64) pos;
+
+		if (diff == 0)
+		{
+			if (pushPosition.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				break;
+		}
+		else if (diff < 0)
+			return false; // Full.
+		else
+			pos = pushPosition.load(std::memory_order_relaxed);
+	}
+
+	cell->value = var;
+	cell->sequence.store(pos + 1, std::memory_order_release);
+
+	*id = pos + 1;
+	return true;
+}
+
+bool LockFreeChannel::tryPop(Variant *var)
+{
+	uint64 pos = popPosition.load(std::memory_order_relaxed);
+	Cell *cell = nullptr;
+
+	while (true)
+	{
+		cell = &cells[pos & mask];
+		uint64 seq = cell->sequence.load(std::memory_order_acquire);
+		int64 diff = (int64) seq - (int64) (pos + 1);
+
+		if (diff == 0)
+		{
+			if (popPosition.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				break;
+		}
+		else if (diff < 0)
+			return false; // Empty.
+		else
+			pos = popPosition.load(std::memory_order_relaxed);
+	}
+
+	*var = cell->value;
+	cell->value = Variant();
+	cell->sequence.store(pos + mask + 1, std::memory_order_release);
+
+	return true;
+}
+
+void LockFreeChannel::notify()
+{
+	// Pairs with the fence in waitUntil: either the waiter sees the change, or
+	// this sees the waiter.
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+
+	if (waiters.load(std::memory_order_relaxed) > 0)
+	{
+		Lock l(mutex);
+		cond->broadcast();
+	}
+}
+
+bool LockFreeChannel::waitUntil(const std::function<bool()> &done, bool forever, double timeout)
+{
+	if (done())
+		return true;
+
+	waiters.fetch_add(1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+
+	bool result = false;
+
+	{
+		Lock l(mutex);
+
+		while (forever || timeout >= 0)
+		{
+			if (done())
+			{
+				result = true;
+				break;
+			}
+
+			if (forever)
+				cond->wait(mutex);
+			else
+			{
+				double start = love::timer::Timer::getTime();
+				cond->wait(mutex, timeout*1000);
+				double stop = love::timer::Timer::getTime();
+
+				timeout -= (stop-start);
+			}
+		}
+	}
+
+	waiters.fetch_sub(1, std::memory_order_relaxed);
+	return result;
+}
+
+uint64 LockFreeChannel::push(const Variant &var)
+{
+	uint64 id = 0;
+	if (!tryPush(var, &id))
+		return 0;
+
+	notify();
+	notifyEventWatchers();
+	return id;
+}
+
+bool LockFreeChannel::supply(const Variant &var)
+{
+	uint64 id = 0;
+	waitUntil([&]() { return tryPush(var, &id); }, true, 0.0);
+	notify();
+	notifyEventWatchers();
+
+	return waitUntil([&]() { return hasRead(id); }, true, 0.0);
+}
+
+bool LockFreeChannel::supply(const Variant &var, double timeout)
+{
+	double start = love::timer::Timer::getTime();
+
+	uint64 id = 0;
+	if (!waitUntil([&]() { return tryPush(var, &id); }, false, timeout))
+		return false;
+
+	notify();
+	notifyEventWatchers();
+
+	timeout -= love::timer::Timer::getTime() - start;
+	return waitUntil([&]() { return hasRead(id); }, false, timeout);
+}
+
+bool LockFreeChannel::pop(Variant *var)
+{
+	if (!tryPop(var))
+		return false;
+
+	notify();
+	return true;
+}
+
+bool LockFreeChannel::demand(Variant *var)
+{
+	waitUntil([&]() { return tryPop(var); }, true, 0.0);
+	notify();
+	return true;
+}
+
+bool LockFreeChannel::demand(Variant *var, double timeout)
+{
+	if (!waitUntil([&]() { return tryPop(var); }, false, timeout))
+		return false;
+
+	notify();
+	return true;
+}
+
+bool LockFreeChannel::peek(Variant */*var*/)
+{
+	throw love::Exception("Lock-free Channels do not support peek.");
+}
+
+int LockFreeChannel::getCount() const
+{
+	uint64 popped = popPosition.load(std::memory_order_acquire);
+	uint64 pushed = pushPosition.load(std::memory_order_acquire);
+	return pushed > popped ? (int) (pushed - popped) : 0;
+}
+
+bool LockFreeChannel::hasRead(uint64 id) const
+{
+	return popPosition.load(std::memory_order_acquire) >= id;
+}
+
+void LockFreeChannel::clear()
+{
+	Variant var;
+	bool cleared = false;
+
+	while (tryPop(&var))
+		cleared = true;
+
+	if (cleared)
+		notify();
+}
+
+int LockFreeChannel::pushMany(const std::vector<Variant> &vars)
+{
+	int count = 0;
+	uint64 id = 0;
+
+	for (const Variant &var : vars)
+	{
+		if (!tryPush(var, &id))
+			break;
+		count++;
+	}
+
+	// One wake-up for the whole batch.
+	if (count > 0)
+	{
+		notify();
+		notifyEventWatchers();
+	}
+
+	return count;
+}
+
+int LockFreeChannel::popMany(std::vector<Variant> &vars, int max)
+{
+	int count = 0;
+	Variant var;
+
+	while (count < max && tryPop(&var))
+	{
+		vars.push_back(var);
+		count++;
+	}
+
+	if (count > 0)
+		notify();
+
+	return count;
+}
+
+bool LockFreeChannel::isLockFree() const
+{
+	return true;
+}
+
+int LockFreeChannel::getCapacity() const
+{
+	return (int) (mask + 1);
+}
+
+} // thread
+} // love
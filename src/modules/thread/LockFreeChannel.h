@@ -0,0 +1,105 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_THREAD_LOCK_FREE_CHANNEL_H
+#define LOVE_THREAD_LOCK_FREE_CHANNEL_H
+
+// LOVE
+#include "Channel.h"
+
+// STL
+#include <atomic>
+#include <functional>
+
+namespace love
+{
+namespace thread
+{
+
+/**
+ * A Channel with a fixed capacity, backed by a bounded multi-producer
+ * multi-consumer ring buffer. Pushing and popping never take a lock, so
+ * throughput doesn't collapse when many threads use the same channel. The
+ * mutex is only used by threads which block in supply or demand.
+ *
+ * push fails (returning 0) when the channel is full. peek and performAtomic
+ * aren't supported, since values can be popped by other threads at any time.
+ **/
+class LockFreeChannel : public Channel
+{
+public:
+
+	// Capacities are rounded up to a power of two.
+	static const int MAX_CAPACITY = 1 << 24;
+
+	LockFreeChannel(int capacity);
+	virtual ~LockFreeChannel();
+
+	uint64 push(const Variant &var) override;
+	bool supply(const Variant &var) override;
+	bool supply(const Variant &var, double timeout) override;
+	bool pop(Variant *var) override;
+	bool demand(Variant *var) override;
+	bool demand(Variant *var, double timeout) override;
+	bool peek(Variant *var) override;
+	int getCount() const override;
+	bool hasRead(uint64 id) const override;
+	void clear() override;
+
+	int pushMany(const std::vector<Variant> &vars) override;
+	int popMany(std::vector<Variant> &vars, int max) override;
+
+	bool isLockFree() const override;
+
+	int getCapacity() const;
+
+private:
+
+	struct Cell
+	{
+		// The position this cell is ready to be pushed to (equal to it) or
+		// popped from (one past it).
+		std::atomic<uint64> sequence;
+		Variant value;
+	};
+
+	bool tryPush(const Variant &var, uint64 *id);
+	bool tryPop(Variant *var);
+
+	// Wakes up threads blocked in supply or demand, if there are any.
+	void notify();
+
+	// Blocks until done returns true, or the timeout (in seconds) runs out.
+	bool waitUntil(const std::function<bool()> &done, bool forever, double timeout);
+
+	Cell *cells;
+	uint64 mask;
+
+	// Kept on separate cache lines so producers and consumers don't contend.
+	alignas(64) std::atomic<uint64> pushPosition;
+	alignas(64) std::atomic<uint64> popPosition;
+	alignas(64) std::atomic<int> waiters;
+
+}; // LockFreeChannel
+
+} // thread
+} // love
+
+#endif // LOVE_THREAD_LOCK_FREE_CHANNEL_H
@@ -0,0 +1,58 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_THREAD_LUAMUTEX_H
+#define LOVE_THREAD_LUAMUTEX_H
+
+// LOVE
+#include "common/Object.h"
+#include "threads.h"
+
+namespace love
+{
+namespace thread
+{
+
+/**
+ * A Mutex which can be shared between Lua threads, for example to guard a
+ * ByteData that several threads write to.
+ **/
+class LuaMutex : public love::Object
+{
+public:
+
+	static love::Type type;
+
+	LuaMutex();
+	virtual ~LuaMutex();
+
+	void lock();
+	void unlock();
+
+private:
+
+	MutexRef mutex;
+
+}; // LuaMutex
+
+} // thread
+} // love
+
+#endif // LOVE_THREAD_LUAMUTEX_H
@@ -0,0 +1,214 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "LuaStatePool.h"
+#include "LuaThread.h"
+#include "common/runtime.h"
+
+namespace love
+{
+namespace thread
+{
+
+LuaStatePool::LuaStatePool()
+	: size(0)
+	, generation(0)
+	, stopping(false)
+{
+	threadName = "LuaStatePool";
+}
+
+LuaStatePool::~LuaStatePool()
+{
+	stop();
+}
+
+void LuaStatePool::setSize(int size, const std::vector<std::string> &modules)
+{
+	bool startthread = false;
+
+	{
+		Lock l(mutex);
+
+		if (modules != this->modules)
+		{
+			this->modules = modules;
+			generation++;
+			closing.insert(closing.end(), states.begin(), states.end());
+			states.clear();
+		}
+
+		this->size = size;
+
+		while ((int) states.size() > size)
+		{
+			closing.push_back(states.back());
+			states.pop_back();
+		}
+
+		startthread = size > 0 && !stopping;
+		cond->broadcast();
+	}
+
+	if (startthread && !isRunning())
+		start();
+}
+
+int LuaStatePool::getSize() const
+{
+	Lock l(mutex);
+	return size;
+}
+
+std::vector<std::string> LuaStatePool::getModules() const
+{
+	Lock l(mutex);
+	return modules;
+}
+
+lua_State *LuaStatePool::takeState()
+{
+	std::vector<std::string> mods;
+
+	{
+		Lock l(mutex);
+
+		if (!states.empty())
+		{
+			lua_State *L = states.back();
+			states.pop_back();
+			cond->broadcast();
+			return L;
+		}
+
+		mods = modules;
+	}
+
+	return newState(mods);
+}
+
+void LuaStatePool::returnState(lua_State *L)
+{
+	if (isRunning())
+	{
+		Lock l(mutex);
+		if (!stopping)
+		{
+			closing.push_back(L);
+			cond->broadcast();
+			return;
+		}
+	}
+
+	lua_close(L);
+}
+
+void LuaStatePool::stop()
+{
+	{
+		Lock l(mutex);
+		stopping = true;
+		cond->broadcast();
+	}
+
+	owner->wait();
+
+	Lock l(mutex);
+
+	for (lua_State *L : states)
+		lua_close(L);
+	for (lua_State *L : closing)
+		lua_close(L);
+
+	states.clear();
+	closing.clear();
+}
+
+void LuaStatePool::threadFunction()
+{
+	while (true)
+	{
+		lua_State *toclose = nullptr;
+		std::vector<std::string> mods;
+		uint64 gen = 0;
+
+		{
+			Lock l(mutex);
+
+			while (!stopping && closing.empty() && (int) states.size() >= size)
+				cond->wait(mutex);
+
+			if (stopping)
+				return;
+
+			if (!closing.empty())
+			{
+				toclose = closing.back();
+				closing.pop_back();
+			}
+			else
+			{
+				mods = modules;
+				gen = generation;
+			}
+		}
+
+		// Closing has priority, since it frees memory and runs finalizers.
+		if (toclose != nullptr)
+		{
+			lua_close(toclose);
+			continue;
+		}
+
+		lua_State *L = newState(mods);
+
+		{
+			Lock l(mutex);
+			if (!stopping && gen == generation && (int) states.size() < size)
+			{
+				states.push_back(L);
+				L = nullptr;
+			}
+		}
+
+		if (L != nullptr)
+			lua_close(L);
+	}
+}
+
+lua_State *LuaStatePool::newState(const std::vector<std::string> &modules)
+{
+	lua_State *L = LuaThread::newState();
+
+	for (const std::string &module : modules)
+	{
+		// Modules which fail to load here are left for the thread's own code
+		// to require, so it gets the error.
+		lua_getglobal(L, "require");
+		lua_pushstring(L, ("love." + module).c_str());
+		if (lua_pcall(L, 1, 0, 0) != 0)
+			lua_pop(L, 1);
+	}
+
+	return L;
+}
+
+} // thread
+} // love
@@ -0,0 +1,95 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_THREAD_LUASTATEPOOL_H
+#define LOVE_THREAD_LUASTATEPOOL_H
+
+// STL
+#include <string>
+#include <vector>
+
+// LOVE
+#include "threads.h"
+
+struct lua_State;
+
+namespace love
+{
+namespace thread
+{
+
+/**
+ * Keeps Lua states with love and a chosen set of modules already loaded, so
+ * starting a LuaThread doesn't have to pay for creating one. A background
+ * thread refills the pool and closes states that threads are done with.
+ *
+ * States are never reused after running thread code, so threads can't see
+ * each other's globals.
+ **/
+class LuaStatePool : public Threadable
+{
+public:
+
+	LuaStatePool();
+	virtual ~LuaStatePool();
+
+	/**
+	 * Sets how many ready states to keep, and which love modules (e.g. "math")
+	 * to load in them in addition to love.thread and love.filesystem.
+	 * States which were already made with other modules are discarded.
+	 **/
+	void setSize(int size, const std::vector<std::string> &modules);
+	int getSize() const;
+	std::vector<std::string> getModules() const;
+
+	// Returns a ready state, or makes a new one if there are none.
+	lua_State *takeState();
+
+	// Closes a state which was returned by takeState().
+	void returnState(lua_State *L);
+
+	// Stops the background thread and closes all pooled states.
+	void stop();
+
+	void threadFunction() override;
+
+private:
+
+	static lua_State *newState(const std::vector<std::string> &modules);
+
+	MutexRef mutex;
+	ConditionalRef cond;
+
+	std::vector<lua_State *> states;
+	std::vector<lua_State *> closing;
+
+	std::vector<std::string> modules;
+	int size;
+
+	// Incremented when the modules change, to discard states being made.
+	uint64 generation;
+	bool stopping;
+
+}; // LuaStatePool
+
+} // thread
+} // love
+
+#endif // LOVE_THREAD_LUASTATEPOOL_H
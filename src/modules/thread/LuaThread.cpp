@@ -22,6 +22,7 @@
 #include "event/Event.h"
 #include "common/config.h"
 #include "common/runtime.h"
+#include "common/profiler.h"
 
 #ifdef LOVE_BUILD_STANDALONE
 extern "C" int luaopen_love(lua_State * L);
@@ -35,8 +36,9 @@ namespace thread
 
 love::Type LuaThread::type("Thread", &Threadable::type);
 
-LuaThread::LuaThread(const std::string &name, love::Data *code)
+LuaThread::LuaThread(const std::string &name, love::Data *code, LuaStatePool *statePool)
 	: code(code)
+	, statePool(statePool)
 	, name(name)
 	, haserror(false)
 {
@@ -52,30 +54,9 @@ void LuaThread::threadFunction()
 	error.clear();
 	haserror = false;
 
-	lua_State *L = luaL_newstate();
-	luaL_openlibs(L);
-
-#ifdef LOVE_BUILD_STANDALONE
-	// Call LuaJIT-specific setup again. While it's quite late to call it at
-	// this point, it still needed to turn off JIT compilation (if necessary)
-	// for this thread.
-	luax_preload(L, luaopen_love_jitsetup, "love.jitsetup");
-	luax_require(L, "love.jitsetup");
-	lua_pop(L, 1);
-
-	luax_preload(L, luaopen_love, "love");
-	luax_require(L, "love");
-	lua_pop(L, 1);
-#endif // LOVE_BUILD_STANDALONE
+	setProfilerThreadName(name);
 
-	luax_require(L, "love.thread");
-	lua_pop(L, 1);
-
-	// We load love.filesystem by default, since require still exists without it
-	// but won't load files from the proper paths. love.filesystem also must be
-	// loaded before using any love function that can take a filepath argument.
-	luax_require(L, "love.filesystem");
-	lua_pop(L, 1);
+	lua_State *L = statePool.get() ? statePool->takeState() : newState();
 
 	lua_pushcfunction(L, luax_traceback);
 	int tracebackidx = lua_gettop(L);
@@ -101,12 +82,45 @@ void LuaThread::threadFunction()
 		}
 	}
 
-	lua_close(L);
+	if (statePool.get())
+		statePool->returnState(L);
+	else
+		lua_close(L);
 
 	if (haserror)
 		onError();
 }
 
+lua_State *LuaThread::newState()
+{
+	lua_State *L = luaL_newstate();
+	luaL_openlibs(L);
+
+#ifdef LOVE_BUILD_STANDALONE
+	// Call LuaJIT-specific setup again. While it's quite late to call it at
+	// this point, it still needed to turn off JIT compilation (if necessary)
+	// for this thread.
+	luax_preload(L, luaopen_love_jitsetup, "love.jitsetup");
+	luax_require(L, "love.jitsetup");
+	lua_pop(L, 1);
+
+	luax_preload(L, luaopen_love, "love");
+	luax_require(L, "love");
+	lua_pop(L, 1);
+#endif // LOVE_BUILD_STANDALONE
+
+	luax_require(L, "love.thread");
+	lua_pop(L, 1);
+
+	// We load love.filesystem by default, since require still exists without it
+	// but won't load files from the proper paths. love.filesystem also must be
+	// loaded before using any love function that can take a filepath argument.
+	luax_require(L, "love.filesystem");
+	lua_pop(L, 1);
+
+	return L;
+}
+
 bool LuaThread::start(const std::vector<Variant> &args)
 {
 	if (isRunning())
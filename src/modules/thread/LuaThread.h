@@ -30,6 +30,9 @@
 #include "common/Object.h"
 #include "common/Variant.h"
 #include "threads.h"
+#include "LuaStatePool.h"
+
+struct lua_State;
 
 namespace love
 {
@@ -42,7 +45,7 @@ public:
 
 	static love::Type type;
 
-	LuaThread(const std::string &name, love::Data *code);
+	LuaThread(const std::string &name, love::Data *code, LuaStatePool *statePool = nullptr);
 	virtual ~LuaThread();
 	void threadFunction();
 	const std::string &getError() const;
@@ -50,11 +53,18 @@ public:
 
 	bool start(const std::vector<Variant> &args);
 
+	/**
+	 * Creates a Lua state with the standard libraries, love, love.thread and
+	 * love.filesystem loaded, for running Lua code on another thread.
+	 **/
+	static lua_State *newState();
+
 private:
 
 	void onError();
 
 	StrongRef<love::Data> code;
+	StrongRef<LuaStatePool> statePool;
 	std::string name;
 	std::string error;
 	bool haserror;
@@ -0,0 +1,101 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "Semaphore.h"
+
+#include <timer/Timer.h>
+
+namespace love
+{
+namespace thread
+{
+
+love::Type Semaphore::type("Semaphore", &Object::type);
+
+Semaphore::Semaphore(int count)
+	: count(count)
+{
+}
+
+Semaphore::~Semaphore()
+{
+}
+
+void Semaphore::acquire()
+{
+	Lock l(mutex);
+
+	while (count <= 0)
+		cond->wait(mutex);
+
+	count--;
+}
+
+bool Semaphore::acquire(double timeout)
+{
+	Lock l(mutex);
+
+	while (count <= 0)
+	{
+		if (timeout < 0)
+			return false;
+
+		double start = love::timer::Timer::getTime();
+		cond->wait(mutex, timeout*1000);
+		double stop = love::timer::Timer::getTime();
+
+		timeout -= (stop-start);
+	}
+
+	count--;
+	return true;
+}
+
+bool Semaphore::tryAcquire()
+{
+	Lock l(mutex);
+
+	if (count <= 0)
+		return false;
+
+	count--;
+	return true;
+}
+
+void Semaphore::release(int count)
+{
+	Lock l(mutex);
+
+	this->count += count;
+
+	if (count == 1)
+		cond->signal();
+	else
+		cond->broadcast();
+}
+
+int Semaphore::getCount() const
+{
+	Lock l(mutex);
+	return count;
+}
+
+} // thread
+} // love
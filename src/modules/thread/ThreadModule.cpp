@@ -28,11 +28,18 @@ namespace thread
 ThreadModule::ThreadModule()
 	: love::Module(M_THREAD, "love.thread.sdl")
 {
+	statePool.set(new LuaStatePool(), Acquire::NORETAIN);
+}
+
+ThreadModule::~ThreadModule()
+{
+	// The pool's own thread keeps it alive until it's stopped.
+	statePool->stop();
 }
 
 LuaThread *ThreadModule::newThread(const std::string &name, love::Data *data)
 {
-	return new LuaThread(name, data);
+	return new LuaThread(name, data, statePool);
 }
 
 Channel *ThreadModule::newChannel()
@@ -40,6 +47,11 @@ Channel *ThreadModule::newChannel()
 	return new Channel();
 }
 
+Channel *ThreadModule::newLockFreeChannel(int capacity)
+{
+	return new LockFreeChannel(capacity);
+}
+
 Channel *ThreadModule::getChannel(const std::string &name)
 {
 	Lock lock(namedChannelMutex);
@@ -53,5 +65,25 @@ Channel *ThreadModule::getChannel(const std::string &name)
 	return c;
 }
 
+JobPool *ThreadModule::newJobPool(const std::string &name, love::Data *code, int threadcount)
+{
+	return new JobPool(name, code, threadcount);
+}
+
+LuaMutex *ThreadModule::newMutex()
+{
+	return new LuaMutex();
+}
+
+Semaphore *ThreadModule::newSemaphore(int count)
+{
+	return new Semaphore(count);
+}
+
+LuaStatePool *ThreadModule::getStatePool() const
+{
+	return statePool;
+}
+
 } // thread
 } // love
@@ -32,7 +32,12 @@
 
 #include "Thread.h"
 #include "Channel.h"
+#include "LockFreeChannel.h"
 #include "LuaThread.h"
+#include "LuaStatePool.h"
+#include "JobPool.h"
+#include "LuaMutex.h"
+#include "Semaphore.h"
 #include "threads.h"
 
 namespace love
@@ -44,16 +49,25 @@ class ThreadModule : public love::Module
 public:
 
 	ThreadModule();
-	virtual ~ThreadModule() {}
+	virtual ~ThreadModule();
 	virtual LuaThread *newThread(const std::string &name, love::Data *data);
 	virtual Channel *newChannel();
+	virtual Channel *newLockFreeChannel(int capacity);
 	virtual Channel *getChannel(const std::string &name);
+	virtual JobPool *newJobPool(const std::string &name, love::Data *code, int threadcount);
+	virtual LuaMutex *newMutex();
+	virtual Semaphore *newSemaphore(int count);
+
+	// Pre-made Lua states which new LuaThreads start with.
+	LuaStatePool *getStatePool() const;
 
 private:
 
 	std::map<std::string, StrongRef<Channel>> namedChannels;
 	MutexRef namedChannelMutex;
 
+	StrongRef<LuaStatePool> statePool;
+
 }; // ThreadModule
 
 } // thread
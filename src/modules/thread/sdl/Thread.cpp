@@ -28,6 +28,8 @@ namespace sdl
 {
 Thread::Thread(Threadable *t)
 	: t(t)
+	, priority(THREAD_PRIORITY_NORMAL)
+	, affinity(0)
 	, running(false)
 	, thread(nullptr)
 {
@@ -60,7 +62,27 @@ bool Thread::start()
 	// between CreateThread and the start of the thread code's execution.
 	t->retain();
 
-	thread = SDL_CreateThread(thread_runner, t->getThreadName(), this);
+	// Priority and affinity can only be set from the new thread itself.
+	priority = t->getPriority();
+	affinity = t->getAffinity();
+	size_t stacksize = t->getStackSize();
+
+	if (stacksize > 0)
+	{
+#if SDL_VERSION_ATLEAST(3, 0, 0)
+		SDL_PropertiesID props = SDL_CreateProperties();
+		SDL_SetPointerProperty(props, SDL_PROP_THREAD_CREATE_ENTRY_FUNCTION_POINTER, (void *) thread_runner);
+		SDL_SetStringProperty(props, SDL_PROP_THREAD_CREATE_NAME_STRING, t->getThreadName());
+		SDL_SetPointerProperty(props, SDL_PROP_THREAD_CREATE_USERDATA_POINTER, this);
+		SDL_SetNumberProperty(props, SDL_PROP_THREAD_CREATE_STACKSIZE_NUMBER, (Sint64) stacksize);
+		thread = SDL_CreateThreadWithProperties(props);
+		SDL_DestroyProperties(props);
+#else
+		thread = SDL_CreateThreadWithStackSize(thread_runner, t->getThreadName(), stacksize, this);
+#endif
+	}
+	else
+		thread = SDL_CreateThread(thread_runner, t->getThreadName(), this);
 	running = (thread != nullptr);
 
 	if (!running)
@@ -92,6 +114,12 @@ int Thread::thread_runner(void *data)
 {
 	Thread *self = (Thread *) data; // some compilers don't like 'this'
 
+	if (self->priority != THREAD_PRIORITY_NORMAL)
+		setCurrentThreadPriority(self->priority);
+
+	if (self->affinity != 0)
+		setCurrentThreadAffinity(self->affinity);
+
 	self->t->threadFunction();
 
 	{
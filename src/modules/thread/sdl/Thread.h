@@ -48,6 +48,8 @@ public:
 private:
 
 	Threadable *t;
+	ThreadPriority priority;
+	uint64 affinity;
 	bool running;
 	SDL_Thread *thread;
 	Mutex mutex;
@@ -125,5 +125,33 @@ thread::Thread *newThread(Threadable *t)
 	return new sdl::Thread(t);
 }
 
+bool setCurrentThreadPriority(ThreadPriority priority)
+{
+	SDL_ThreadPriority sdlpriority = SDL_THREAD_PRIORITY_NORMAL;
+
+	switch (priority)
+	{
+	case THREAD_PRIORITY_LOW:
+		sdlpriority = SDL_THREAD_PRIORITY_LOW;
+		break;
+	case THREAD_PRIORITY_NORMAL:
+	default:
+		sdlpriority = SDL_THREAD_PRIORITY_NORMAL;
+		break;
+	case THREAD_PRIORITY_HIGH:
+		sdlpriority = SDL_THREAD_PRIORITY_HIGH;
+		break;
+	case THREAD_PRIORITY_TIME_CRITICAL:
+		sdlpriority = SDL_THREAD_PRIORITY_TIME_CRITICAL;
+		break;
+	}
+
+#if SDL_VERSION_ATLEAST(3, 0, 0)
+	return SDL_SetCurrentThreadPriority(sdlpriority);
+#else
+	return SDL_SetThreadPriority(sdlpriority) == 0;
+#endif
+}
+
 } // thread
 } // love
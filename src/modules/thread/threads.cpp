@@ -20,8 +20,14 @@
 
 #include "threads.h"
 
+// C++
+#include <atomic>
+
 #if defined(LOVE_LINUX)
 #include <signal.h>
+#include <sched.h>
+#elif defined(LOVE_WINDOWS)
+#include <windows.h>
 #endif
 
 namespace love
@@ -87,7 +93,12 @@ void EmptyLock::setLock(Mutex &m)
 
 love::Type Threadable::type("Threadable", &Object::type);
 
+static std::atomic<uint64> defaultAffinity(0);
+
 Threadable::Threadable()
+	: priority(THREAD_PRIORITY_NORMAL)
+	, affinity(defaultAffinity.load())
+	, stackSize(0)
 {
 	owner = newThread(this);
 }
@@ -117,6 +128,36 @@ const char *Threadable::getThreadName() const
 	return threadName.empty() ? nullptr : threadName.c_str();
 }
 
+void Threadable::setPriority(ThreadPriority priority)
+{
+	this->priority = priority;
+}
+
+ThreadPriority Threadable::getPriority() const
+{
+	return priority;
+}
+
+void Threadable::setAffinity(uint64 coremask)
+{
+	affinity = coremask;
+}
+
+uint64 Threadable::getAffinity() const
+{
+	return affinity;
+}
+
+void Threadable::setStackSize(size_t size)
+{
+	stackSize = size;
+}
+
+size_t Threadable::getStackSize() const
+{
+	return stackSize;
+}
+
 MutexRef::MutexRef()
 	: mutex(newMutex())
 {
@@ -157,6 +198,50 @@ Conditional *ConditionalRef::operator->() const
 	return conditional;
 }
 
+bool setCurrentThreadAffinity(uint64 coremask)
+{
+	if (coremask == 0)
+		return false;
+
+#if defined(LOVE_WINDOWS)
+	return SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR) coremask) != 0;
+#elif defined(LOVE_LINUX)
+	cpu_set_t set;
+	CPU_ZERO(&set);
+
+	for (int i = 0; i < 64 && i < CPU_SETSIZE; i++)
+	{
+		if (coremask & (1ull << i))
+			CPU_SET(i, &set);
+	}
+
+	// On Linux and Android, pid 0 refers to the calling thread.
+	return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+	// macOS and iOS don't allow pinning threads to specific cores.
+	return false;
+#endif
+}
+
+void setDefaultThreadAffinity(uint64 coremask)
+{
+	defaultAffinity = coremask;
+}
+
+uint64 getDefaultThreadAffinity()
+{
+	return defaultAffinity.load();
+}
+
+STRINGMAP_BEGIN(ThreadPriority, THREAD_PRIORITY_MAX_ENUM, threadPriority)
+{
+	{ "low",      THREAD_PRIORITY_LOW           },
+	{ "normal",   THREAD_PRIORITY_NORMAL        },
+	{ "high",     THREAD_PRIORITY_HIGH          },
+	{ "critical", THREAD_PRIORITY_TIME_CRITICAL },
+}
+STRINGMAP_END(ThreadPriority, THREAD_PRIORITY_MAX_ENUM, threadPriority)
+
 #if defined(LOVE_LINUX)
 static sigset_t oldset;
 
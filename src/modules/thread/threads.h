@@ -23,10 +23,13 @@
 
 // LOVE
 #include "common/config.h"
+#include "common/int.h"
+#include "common/StringMap.h"
 #include "Thread.h"
 
 // C++
 #include <string>
+#include <vector>
 
 namespace love
 {
@@ -77,6 +80,15 @@ private:
 	Mutex *mutex;
 };
 
+enum ThreadPriority
+{
+	THREAD_PRIORITY_LOW,
+	THREAD_PRIORITY_NORMAL,
+	THREAD_PRIORITY_HIGH,
+	THREAD_PRIORITY_TIME_CRITICAL,
+	THREAD_PRIORITY_MAX_ENUM
+};
+
 class Threadable : public love::Object
 {
 public:
@@ -92,11 +104,27 @@ public:
 	bool isRunning() const;
 	const char *getThreadName() const;
 
+	/**
+	 * Scheduling options, which take effect the next time the thread starts.
+	 * An affinity of 0 lets the thread run on any core, and a stack size of 0
+	 * uses the system default.
+	 **/
+	void setPriority(ThreadPriority priority);
+	ThreadPriority getPriority() const;
+	void setAffinity(uint64 coremask);
+	uint64 getAffinity() const;
+	void setStackSize(size_t size);
+	size_t getStackSize() const;
+
 protected:
 
 	Thread *owner;
 	std::string threadName;
 
+	ThreadPriority priority;
+	uint64 affinity;
+	size_t stackSize;
+
 };
 
 class MutexRef
@@ -129,6 +157,27 @@ Mutex *newMutex();
 Conditional *newConditional();
 Thread *newThread(Threadable *t);
 
+/**
+ * Sets the scheduling priority of the calling thread.
+ * @return False if the system refused.
+ **/
+bool setCurrentThreadPriority(ThreadPriority priority);
+
+/**
+ * Restricts the calling thread to the cores set in the given mask.
+ * @return False if the system refused, or doesn't support core affinity.
+ **/
+bool setCurrentThreadAffinity(uint64 coremask);
+
+/**
+ * The core affinity new Threadables start with, so that threads created by
+ * love itself (audio, video, I/O) can be kept off the main thread's core.
+ **/
+void setDefaultThreadAffinity(uint64 coremask);
+uint64 getDefaultThreadAffinity();
+
+STRINGMAP_DECLARE(ThreadPriority);
+
 #if defined(LOVE_LINUX)
 void disableSignals();
 void reenableSignals();
@@ -20,6 +20,9 @@
 
 #include "wrap_Channel.h"
 
+// STL
+#include <climits>
+
 namespace love
 {
 namespace thread
@@ -38,7 +41,12 @@ int w_Channel_push(lua_State *L)
 		if (var.getType() == Variant::UNKNOWN)
 			luaL_argerror(L, 2, "boolean, number, string, love type, or table expected");
 		uint64 id = c->push(var);
-		lua_pushnumber(L, (lua_Number) id);
+
+		// Lock-free Channels can be full.
+		if (id == 0)
+			lua_pushnil(L);
+		else
+			lua_pushnumber(L, (lua_Number) id);
 	});
 	return 1;
 }
@@ -94,7 +102,9 @@ int w_Channel_peek(lua_State *L)
 {
 	Channel *c = luax_checkchannel(L, 1);
 	Variant var;
-	if (c->peek(&var))
+	bool result = false;
+	luax_catchexcept(L, [&]() { result = c->peek(&var); });
+	if (result)
 		luax_pushvariant(L, var);
 	else
 		lua_pushnil(L);
@@ -123,11 +133,99 @@ int w_Channel_clear(lua_State *L)
 	return 0;
 }
 
+int w_Channel_pushMany(lua_State *L)
+{
+	Channel *c = luax_checkchannel(L, 1);
+	luaL_checktype(L, 2, LUA_TTABLE);
+
+	int len = (int) luax_objlen(L, 2);
+	int count = 0;
+	int invalid = 0;
+
+	luax_catchexcept(L, [&]() {
+		std::vector<Variant> vars;
+		vars.reserve(len);
+
+		for (int i = 1; i <= len; i++)
+		{
+			lua_rawgeti(L, 2, i);
+			vars.push_back(luax_checkvariant(L, -1));
+			lua_pop(L, 1);
+
+			if (vars.back().getType() == Variant::UNKNOWN)
+			{
+				invalid = i;
+				return;
+			}
+		}
+
+		count = c->pushMany(vars);
+	});
+
+	if (invalid > 0)
+		return luaL_error(L, "Value %d in the table can't be pushed to a Channel.", invalid);
+
+	lua_pushinteger(L, count);
+	return 1;
+}
+
+int w_Channel_popMany(lua_State *L)
+{
+	Channel *c = luax_checkchannel(L, 1);
+	int max = (int) luaL_optinteger(L, 2, INT_MAX);
+	if (max < 0)
+		return luaL_argerror(L, 2, "max must not be negative");
+
+	// An existing table can be passed in, to avoid creating one every call.
+	bool reuse = !lua_isnoneornil(L, 3);
+	int oldlen = 0;
+	if (reuse)
+	{
+		luaL_checktype(L, 3, LUA_TTABLE);
+		oldlen = (int) luax_objlen(L, 3);
+	}
+
+	std::vector<Variant> vars;
+	int count = c->popMany(vars, max);
+
+	if (reuse)
+		lua_pushvalue(L, 3);
+	else
+		lua_createtable(L, count, 0);
+
+	for (int i = 0; i < count; i++)
+	{
+		luax_pushvariant(L, vars[i]);
+		lua_rawseti(L, -2, i + 1);
+	}
+
+	// Clear values left over from a previous, longer batch.
+	for (int i = count + 1; i <= oldlen; i++)
+	{
+		lua_pushnil(L);
+		lua_rawseti(L, -2, i);
+	}
+
+	lua_pushinteger(L, count);
+	return 2;
+}
+
+int w_Channel_isLockFree(lua_State *L)
+{
+	Channel *c = luax_checkchannel(L, 1);
+	luax_pushboolean(L, c->isLockFree());
+	return 1;
+}
+
 int w_Channel_performAtomic(lua_State *L)
 {
 	Channel *c = luax_checkchannel(L, 1);
 	luaL_checktype(L, 2, LUA_TFUNCTION);
 
+	// Other threads don't take the mutex when using lock-free Channels.
+	if (c->isLockFree())
+		return luaL_error(L, "Lock-free Channels do not support performAtomic.");
+
 	// Pass this channel as an argument to the function.
 	lua_pushvalue(L, 1);
 	lua_insert(L, 3);
@@ -160,6 +258,9 @@ static const luaL_Reg w_Channel_functions[] =
 	{ "getCount", w_Channel_getCount },
 	{ "hasRead", w_Channel_hasRead },
 	{ "clear", w_Channel_clear },
+	{ "pushMany", w_Channel_pushMany },
+	{ "popMany", w_Channel_popMany },
+	{ "isLockFree", w_Channel_isLockFree },
 	{ "performAtomic", w_Channel_performAtomic },
 	{ 0, 0 }
 };
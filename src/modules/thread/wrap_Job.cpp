@@ -0,0 +1,113 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "wrap_Job.h"
+
+namespace love
+{
+namespace thread
+{
+
+Job *luax_checkjob(lua_State *L, int idx)
+{
+	return luax_checktype<Job>(L, idx);
+}
+
+static int pushResults(lua_State *L, Job *job)
+{
+	std::vector<Variant> results = job->getResults();
+
+	luaL_checkstack(L, (int) results.size(), "too many job results");
+
+	for (const Variant &v : results)
+		luax_pushvariant(L, v);
+
+	return (int) results.size();
+}
+
+int w_Job_getStatus(lua_State *L)
+{
+	Job *t = luax_checkjob(L, 1);
+	const char *str = nullptr;
+	if (!Job::getConstant(t->getStatus(), str))
+		return luaL_error(L, "Unknown job status.");
+	lua_pushstring(L, str);
+	return 1;
+}
+
+int w_Job_isDone(lua_State *L)
+{
+	Job *t = luax_checkjob(L, 1);
+	luax_pushboolean(L, t->isDone());
+	return 1;
+}
+
+int w_Job_getResults(lua_State *L)
+{
+	Job *t = luax_checkjob(L, 1);
+	if (t->getStatus() != Job::STATUS_COMPLETE)
+		return 0;
+	return pushResults(L, t);
+}
+
+int w_Job_getError(lua_State *L)
+{
+	Job *t = luax_checkjob(L, 1);
+
+	if (t->getStatus() != Job::STATUS_FAILED)
+		return 0;
+
+	luax_pushstring(L, t->getError());
+	return 1;
+}
+
+int w_Job_wait(lua_State *L)
+{
+	Job *t = luax_checkjob(L, 1);
+	t->wait();
+
+	if (t->getStatus() == Job::STATUS_FAILED)
+	{
+		luax_pushboolean(L, false);
+		luax_pushstring(L, t->getError());
+		return 2;
+	}
+
+	luax_pushboolean(L, true);
+	return 1 + pushResults(L, t);
+}
+
+static const luaL_Reg w_Job_functions[] =
+{
+	{ "getStatus", w_Job_getStatus },
+	{ "isDone", w_Job_isDone },
+	{ "getResults", w_Job_getResults },
+	{ "getError", w_Job_getError },
+	{ "wait", w_Job_wait },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_job(lua_State *L)
+{
+	return luax_register_type(L, &Job::type, w_Job_functions, nullptr);
+}
+
+} // thread
+} // love
@@ -0,0 +1,152 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "wrap_JobPool.h"
+#include "wrap_Job.h"
+
+namespace love
+{
+namespace thread
+{
+
+JobPool *luax_checkjobpool(lua_State *L, int idx)
+{
+	return luax_checktype<JobPool>(L, idx);
+}
+
+// The job is either a function name, or a table with the function name and
+// the jobs it depends on: {name = "fn", after = job or {jobs...}}.
+static std::string checkJobOptions(lua_State *L, int idx, std::vector<Job *> &dependencies, int64 *grain)
+{
+	if (lua_type(L, idx) == LUA_TSTRING)
+		return lua_tostring(L, idx);
+
+	luaL_checktype(L, idx, LUA_TTABLE);
+
+	lua_getfield(L, idx, "name");
+	if (lua_type(L, -1) != LUA_TSTRING)
+		luaL_error(L, "Job table must have a 'name' string field.");
+	std::string name = lua_tostring(L, -1);
+	lua_pop(L, 1);
+
+	lua_getfield(L, idx, "after");
+	if (luax_istype(L, -1, Job::type))
+		dependencies.push_back(luax_checkjob(L, -1));
+	else if (lua_istable(L, -1))
+	{
+		int count = (int) luax_objlen(L, -1);
+		for (int i = 1; i <= count; i++)
+		{
+			lua_rawgeti(L, -1, i);
+			dependencies.push_back(luax_checkjob(L, -1));
+			lua_pop(L, 1);
+		}
+	}
+	else if (!lua_isnil(L, -1))
+		luaL_error(L, "Job 'after' field must be a Job or a table of Jobs.");
+	lua_pop(L, 1);
+
+	if (grain != nullptr)
+	{
+		lua_getfield(L, idx, "grain");
+		if (!lua_isnoneornil(L, -1))
+			*grain = (int64) luaL_checknumber(L, -1);
+		lua_pop(L, 1);
+	}
+
+	return name;
+}
+
+static void checkJobArgs(lua_State *L, int start, std::vector<Variant> &args)
+{
+	for (int i = start; i <= lua_gettop(L); i++)
+	{
+		luax_catchexcept(L, [&]() { args.push_back(luax_checkvariant(L, i)); });
+
+		if (args.back().getType() == Variant::UNKNOWN)
+		{
+			args.clear();
+			luaL_argerror(L, i, "boolean, number, string, love type, or table expected");
+		}
+	}
+}
+
+int w_JobPool_submit(lua_State *L)
+{
+	JobPool *t = luax_checkjobpool(L, 1);
+
+	std::vector<Job *> dependencies;
+	std::string function = checkJobOptions(L, 2, dependencies, nullptr);
+
+	std::vector<Variant> args;
+	checkJobArgs(L, 3, args);
+
+	Job *job = nullptr;
+	luax_catchexcept(L, [&]() { job = t->submit(function, args, dependencies); });
+
+	luax_pushtype(L, job);
+	job->release();
+	return 1;
+}
+
+int w_JobPool_parallelFor(lua_State *L)
+{
+	JobPool *t = luax_checkjobpool(L, 1);
+
+	std::vector<Job *> dependencies;
+	int64 grain = 0;
+	std::string function = checkJobOptions(L, 2, dependencies, &grain);
+
+	int64 first = (int64) luaL_checknumber(L, 3);
+	int64 last = (int64) luaL_checknumber(L, 4);
+
+	std::vector<Variant> args;
+	checkJobArgs(L, 5, args);
+
+	Job *job = nullptr;
+	luax_catchexcept(L, [&]() { job = t->parallelFor(function, first, last, grain, args, dependencies); });
+
+	luax_pushtype(L, job);
+	job->release();
+	return 1;
+}
+
+int w_JobPool_getThreadCount(lua_State *L)
+{
+	JobPool *t = luax_checkjobpool(L, 1);
+	lua_pushinteger(L, t->getThreadCount());
+	return 1;
+}
+
+static const luaL_Reg w_JobPool_functions[] =
+{
+	{ "submit", w_JobPool_submit },
+	{ "parallelFor", w_JobPool_parallelFor },
+	{ "getThreadCount", w_JobPool_getThreadCount },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_jobpool(lua_State *L)
+{
+	return luax_register_type(L, &JobPool::type, w_JobPool_functions, nullptr);
+}
+
+} // thread
+} // love
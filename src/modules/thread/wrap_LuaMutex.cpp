@@ -0,0 +1,82 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "wrap_LuaMutex.h"
+
+namespace love
+{
+namespace thread
+{
+
+LuaMutex *luax_checkmutex(lua_State *L, int idx)
+{
+	return luax_checktype<LuaMutex>(L, idx);
+}
+
+int w_Mutex_lock(lua_State *L)
+{
+	LuaMutex *m = luax_checkmutex(L, 1);
+	m->lock();
+	return 0;
+}
+
+int w_Mutex_unlock(lua_State *L)
+{
+	LuaMutex *m = luax_checkmutex(L, 1);
+	m->unlock();
+	return 0;
+}
+
+int w_Mutex_performAtomic(lua_State *L)
+{
+	LuaMutex *m = luax_checkmutex(L, 1);
+	luaL_checktype(L, 2, LUA_TFUNCTION);
+
+	m->lock();
+
+	// Call the function with any user-specified arguments. Unlike lock/unlock,
+	// the Mutex is released even if the function errors.
+	int numargs = lua_gettop(L) - 2;
+	int err = lua_pcall(L, numargs, LUA_MULTRET, 0);
+
+	m->unlock();
+
+	if (err != 0)
+		return lua_error(L);
+
+	// Everything after the Mutex argument is a return value.
+	return lua_gettop(L) - 1;
+}
+
+static const luaL_Reg w_Mutex_functions[] =
+{
+	{ "lock", w_Mutex_lock },
+	{ "unlock", w_Mutex_unlock },
+	{ "performAtomic", w_Mutex_performAtomic },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_mutex(lua_State *L)
+{
+	return luax_register_type(L, &LuaMutex::type, w_Mutex_functions, nullptr);
+}
+
+} // thread
+} // love
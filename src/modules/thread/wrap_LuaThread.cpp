@@ -30,6 +30,52 @@ LuaThread *luax_checkthread(lua_State *L, int idx)
 	return luax_checktype<LuaThread>(L, idx);
 }
 
+uint64 luax_checkaffinity(lua_State *L, int idx)
+{
+	if (lua_isnoneornil(L, idx))
+		return 0;
+
+	luaL_checktype(L, idx, LUA_TTABLE);
+
+	uint64 coremask = 0;
+	int count = (int) luax_objlen(L, idx);
+
+	for (int i = 1; i <= count; i++)
+	{
+		lua_rawgeti(L, idx, i);
+		int core = (int) luaL_checkinteger(L, -1);
+		lua_pop(L, 1);
+
+		if (core < 1 || core > 64)
+			luaL_error(L, "Invalid core index %d (must be between 1 and 64.)", core);
+
+		coremask |= 1ull << (core - 1);
+	}
+
+	return coremask;
+}
+
+void luax_pushaffinity(lua_State *L, uint64 coremask)
+{
+	if (coremask == 0)
+	{
+		lua_pushnil(L);
+		return;
+	}
+
+	lua_newtable(L);
+	int n = 0;
+
+	for (int i = 0; i < 64; i++)
+	{
+		if (coremask & (1ull << i))
+		{
+			lua_pushinteger(L, i + 1);
+			lua_rawseti(L, -2, ++n);
+		}
+	}
+}
+
 int w_Thread_start(lua_State *L)
 {
 	LuaThread *t = luax_checkthread(L, 1);
@@ -77,12 +123,73 @@ int w_Thread_isRunning(lua_State *L)
 	return 1;
 }
 
+int w_Thread_setPriority(lua_State *L)
+{
+	LuaThread *t = luax_checkthread(L, 1);
+	const char *str = luaL_checkstring(L, 2);
+	ThreadPriority priority;
+	if (!getConstant(str, priority))
+		return luax_enumerror(L, "thread priority", getConstants(priority), str);
+
+	t->setPriority(priority);
+	return 0;
+}
+
+int w_Thread_getPriority(lua_State *L)
+{
+	LuaThread *t = luax_checkthread(L, 1);
+	const char *str = nullptr;
+	if (!getConstant(t->getPriority(), str))
+		return luaL_error(L, "Unknown thread priority.");
+
+	lua_pushstring(L, str);
+	return 1;
+}
+
+int w_Thread_setAffinity(lua_State *L)
+{
+	LuaThread *t = luax_checkthread(L, 1);
+	t->setAffinity(luax_checkaffinity(L, 2));
+	return 0;
+}
+
+int w_Thread_getAffinity(lua_State *L)
+{
+	LuaThread *t = luax_checkthread(L, 1);
+	luax_pushaffinity(L, t->getAffinity());
+	return 1;
+}
+
+int w_Thread_setStackSize(lua_State *L)
+{
+	LuaThread *t = luax_checkthread(L, 1);
+	lua_Number size = luaL_optnumber(L, 2, 0);
+	if (size < 0)
+		return luaL_argerror(L, 2, "stack size must not be negative");
+
+	t->setStackSize((size_t) size);
+	return 0;
+}
+
+int w_Thread_getStackSize(lua_State *L)
+{
+	LuaThread *t = luax_checkthread(L, 1);
+	lua_pushnumber(L, (lua_Number) t->getStackSize());
+	return 1;
+}
+
 static const luaL_Reg w_Thread_functions[] =
 {
 	{ "start", w_Thread_start },
 	{ "wait", w_Thread_wait },
 	{ "getError", w_Thread_getError },
 	{ "isRunning", w_Thread_isRunning },
+	{ "setPriority", w_Thread_setPriority },
+	{ "getPriority", w_Thread_getPriority },
+	{ "setAffinity", w_Thread_setAffinity },
+	{ "getAffinity", w_Thread_getAffinity },
+	{ "setStackSize", w_Thread_setStackSize },
+	{ "getStackSize", w_Thread_getStackSize },
 	{ 0, 0 }
 };
 
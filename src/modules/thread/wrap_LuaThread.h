@@ -31,6 +31,11 @@ namespace thread
 {
 
 LuaThread *luax_checkthread(lua_State *L, int idx);
+
+// Core affinities are tables of 1-based core indices in Lua, or nil for any core.
+uint64 luax_checkaffinity(lua_State *L, int idx);
+void luax_pushaffinity(lua_State *L, uint64 coremask);
+
 extern "C" int luaopen_thread(lua_State *L);
 
 } // thread
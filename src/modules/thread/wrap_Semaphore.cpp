@@ -0,0 +1,86 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "wrap_Semaphore.h"
+
+namespace love
+{
+namespace thread
+{
+
+Semaphore *luax_checksemaphore(lua_State *L, int idx)
+{
+	return luax_checktype<Semaphore>(L, idx);
+}
+
+int w_Semaphore_acquire(lua_State *L)
+{
+	Semaphore *s = luax_checksemaphore(L, 1);
+	bool result = true;
+
+	if (lua_isnumber(L, 2))
+		result = s->acquire(lua_tonumber(L, 2));
+	else
+		s->acquire();
+
+	luax_pushboolean(L, result);
+	return 1;
+}
+
+int w_Semaphore_tryAcquire(lua_State *L)
+{
+	Semaphore *s = luax_checksemaphore(L, 1);
+	luax_pushboolean(L, s->tryAcquire());
+	return 1;
+}
+
+int w_Semaphore_release(lua_State *L)
+{
+	Semaphore *s = luax_checksemaphore(L, 1);
+	int count = (int) luaL_optinteger(L, 2, 1);
+	if (count < 1)
+		return luaL_argerror(L, 2, "count must be positive");
+	s->release(count);
+	return 0;
+}
+
+int w_Semaphore_getCount(lua_State *L)
+{
+	Semaphore *s = luax_checksemaphore(L, 1);
+	lua_pushinteger(L, s->getCount());
+	return 1;
+}
+
+static const luaL_Reg w_Semaphore_functions[] =
+{
+	{ "acquire", w_Semaphore_acquire },
+	{ "tryAcquire", w_Semaphore_tryAcquire },
+	{ "release", w_Semaphore_release },
+	{ "getCount", w_Semaphore_getCount },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_semaphore(lua_State *L)
+{
+	return luax_register_type(L, &Semaphore::type, w_Semaphore_functions, nullptr);
+}
+
+} // thread
+} // love
@@ -22,6 +22,10 @@
 #include "wrap_ThreadModule.h"
 #include "wrap_LuaThread.h"
 #include "wrap_Channel.h"
+#include "wrap_JobPool.h"
+#include "wrap_Job.h"
+#include "wrap_LuaMutex.h"
+#include "wrap_Semaphore.h"
 #include "ThreadModule.h"
 
 #include "filesystem/File.h"
@@ -37,9 +41,9 @@ namespace thread
 
 #define instance() (Module::getInstance<ThreadModule>(Module::M_THREAD))
 
-int w_newThread(lua_State *L)
+// Gets Lua code from a string, filename, File or Data at index 1.
+static love::Data *checkThreadCode(lua_State *L, std::string &name)
 {
-	std::string name = "Thread code";
 	love::Data *data = nullptr;
 
 	if (lua_isstring(L, 1))
@@ -75,20 +79,130 @@ int w_newThread(lua_State *L)
 		data = luax_checktype<love::Data>(L, 1);
 	}
 
+	return data;
+}
+
+int w_newThread(lua_State *L)
+{
+	std::string name = "Thread code";
+	love::Data *data = checkThreadCode(L, name);
+
 	LuaThread *t = instance()->newThread(name, data);
 	luax_pushtype(L, t);
 	t->release();
 	return 1;
 }
 
+int w_newJobPool(lua_State *L)
+{
+	std::string name = "Job pool code";
+	int threadcount = (int) luaL_optinteger(L, 2, 0);
+	love::Data *data = checkThreadCode(L, name);
+
+	JobPool *pool = nullptr;
+	luax_catchexcept(L, [&]() { pool = instance()->newJobPool(name, data, threadcount); });
+
+	luax_pushtype(L, pool);
+	pool->release();
+	return 1;
+}
+
 int w_newChannel(lua_State *L)
 {
-	Channel *c = instance()->newChannel();
+	bool lockfree = false;
+	int capacity = 0;
+
+	if (!lua_isnoneornil(L, 1))
+	{
+		luaL_checktype(L, 1, LUA_TTABLE);
+		lockfree = luax_boolflag(L, 1, "lockfree", false);
+		capacity = luax_intflag(L, 1, "capacity", 0);
+
+		if (capacity != 0 && !lockfree)
+			return luaL_error(L, "Only lock-free Channels can have a capacity.");
+	}
+
+	Channel *c = nullptr;
+	if (lockfree)
+		luax_catchexcept(L, [&]() { c = instance()->newLockFreeChannel(capacity > 0 ? capacity : 1024); });
+	else
+		c = instance()->newChannel();
+
 	luax_pushtype(L, c);
 	c->release();
 	return 1;
 }
 
+int w_newMutex(lua_State *L)
+{
+	LuaMutex *m = instance()->newMutex();
+	luax_pushtype(L, m);
+	m->release();
+	return 1;
+}
+
+int w_newSemaphore(lua_State *L)
+{
+	int count = (int) luaL_optinteger(L, 1, 0);
+	if (count < 0)
+		return luaL_argerror(L, 1, "count must not be negative");
+
+	Semaphore *s = instance()->newSemaphore(count);
+	luax_pushtype(L, s);
+	s->release();
+	return 1;
+}
+
+int w_setDefaultAffinity(lua_State *L)
+{
+	setDefaultThreadAffinity(luax_checkaffinity(L, 1));
+	return 0;
+}
+
+int w_getDefaultAffinity(lua_State *L)
+{
+	luax_pushaffinity(L, getDefaultThreadAffinity());
+	return 1;
+}
+
+int w_setStatePoolSize(lua_State *L)
+{
+	int size = (int) luaL_checkinteger(L, 1);
+	if (size < 0)
+		return luaL_argerror(L, 1, "size must not be negative");
+
+	std::vector<std::string> modules;
+	if (!lua_isnoneornil(L, 2))
+	{
+		luaL_checktype(L, 2, LUA_TTABLE);
+		int count = (int) luax_objlen(L, 2);
+		for (int i = 1; i <= count; i++)
+		{
+			lua_rawgeti(L, 2, i);
+			modules.push_back(luax_checkstring(L, -1));
+			lua_pop(L, 1);
+		}
+	}
+
+	luax_catchexcept(L, [&]() { instance()->getStatePool()->setSize(size, modules); });
+	return 0;
+}
+
+int w_getStatePoolSize(lua_State *L)
+{
+	LuaStatePool *pool = instance()->getStatePool();
+	std::vector<std::string> modules = pool->getModules();
+
+	lua_pushinteger(L, pool->getSize());
+	lua_createtable(L, (int) modules.size(), 0);
+	for (int i = 0; i < (int) modules.size(); i++)
+	{
+		luax_pushstring(L, modules[i]);
+		lua_rawseti(L, -2, i + 1);
+	}
+	return 2;
+}
+
 int w_getChannel(lua_State *L)
 {
 	std::string name = luax_checkstring(L, 1);
@@ -103,12 +217,23 @@ static const luaL_Reg module_functions[] =
 	{ "newThread", w_newThread },
 	{ "newChannel", w_newChannel },
 	{ "getChannel", w_getChannel },
+	{ "newJobPool", w_newJobPool },
+	{ "newMutex", w_newMutex },
+	{ "newSemaphore", w_newSemaphore },
+	{ "setDefaultAffinity", w_setDefaultAffinity },
+	{ "getDefaultAffinity", w_getDefaultAffinity },
+	{ "setStatePoolSize", w_setStatePoolSize },
+	{ "getStatePoolSize", w_getStatePoolSize },
 	{ 0, 0 }
 };
 
 static const lua_CFunction types[] = {
 	luaopen_thread,
 	luaopen_channel,
+	luaopen_jobpool,
+	luaopen_job,
+	luaopen_mutex,
+	luaopen_semaphore,
 	0
 };
 
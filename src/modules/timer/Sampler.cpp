@@ -0,0 +1,316 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "Sampler.h"
+#include "common/delay.h"
+#include "common/Exception.h"
+
+// C++
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+namespace love
+{
+namespace timer
+{
+
+// Deep recursion is cut off so a sample can't take too long.
+static const int MAX_SAMPLE_DEPTH = 128;
+
+// The Sampler whose hook is installed. Only read by the hook, which runs on
+// the sampled Lua state's thread.
+static std::atomic<Sampler *> activeSampler(nullptr);
+
+// The most recently started Sampler, kept after it stops so its samples can
+// still be read.
+static StrongRef<Sampler> lastSampler;
+
+static thread::Mutex *getSamplerMutex()
+{
+	static thread::Mutex *mutex = thread::newMutex();
+	return mutex;
+}
+
+Sampler::Sampler(lua_State *L, const void *owner, double interval)
+	: L(L)
+	, owner(owner)
+	, interval(interval)
+	, threadRef(LUA_NOREF)
+	, profileThread(getCurrentProfileThread())
+	, finish(false)
+	, pendingSamples(0)
+	, pendingZone(nullptr)
+	, sampleCount(0)
+{
+	threadName = "Sampler";
+	setPriority(thread::THREAD_PRIORITY_HIGH);
+}
+
+Sampler::~Sampler()
+{
+}
+
+void Sampler::startSampling(lua_State *L, const void *owner, double interval)
+{
+	if (interval <= 0.0)
+		throw love::Exception("Sampling interval must be greater than 0.");
+
+	thread::Lock lock(getSamplerMutex());
+
+	if (activeSampler.load() != nullptr)
+		throw love::Exception("A Lua state is already being sampled.");
+
+#if defined(LUA_JITLIBNAME) && !defined(LOVE_SAMPLER_LUAJIT_PROFILE)
+	throw love::Exception("Sampling requires LuaJIT 2.1 or newer.");
+#endif
+
+	if (lua_gethook(L) != nullptr)
+		throw love::Exception("Cannot start sampling while a debug hook is set.");
+
+	StrongRef<Sampler> sampler(new Sampler(L, owner, interval), Acquire::NORETAIN);
+
+	setProfilerSampling(true);
+	activeSampler.store(sampler.get(), std::memory_order_release);
+
+	if (!sampler->start())
+	{
+		activeSampler.store(nullptr, std::memory_order_release);
+		setProfilerSampling(false);
+		throw love::Exception("Could not start the sampler thread.");
+	}
+
+#ifdef LOVE_SAMPLER_LUAJIT_PROFILE
+	std::string mode = "i" + std::to_string(std::max((int) (interval * 1000.0 + 0.5), 1));
+	luaJIT_profile_start(L, mode.c_str(), profileCallback, sampler.get());
+#endif
+
+	lua_pushthread(L);
+	sampler->threadRef = luaL_ref(L, LUA_REGISTRYINDEX);
+
+	lastSampler = sampler;
+}
+
+bool Sampler::stopSampling(lua_State *L, const void *owner)
+{
+	thread::Lock lock(getSamplerMutex());
+
+	Sampler *sampler = activeSampler.load();
+	if (sampler == nullptr || sampler->owner != owner)
+		return false;
+
+	sampler->finish.store(true);
+	sampler->wait();
+
+	// The hook or callback runs on this thread, so it can't be running now.
+#ifdef LOVE_SAMPLER_LUAJIT_PROFILE
+	luaJIT_profile_stop(sampler->L);
+#else
+	lua_sethook(sampler->L, nullptr, 0, 0);
+#endif
+	activeSampler.store(nullptr, std::memory_order_release);
+	setProfilerSampling(false);
+
+	luaL_unref(L, LUA_REGISTRYINDEX, sampler->threadRef);
+	sampler->threadRef = LUA_NOREF;
+
+	return true;
+}
+
+bool Sampler::isSampling(const void *owner)
+{
+	thread::Lock lock(getSamplerMutex());
+	Sampler *sampler = activeSampler.load();
+	return sampler != nullptr && sampler->owner == owner;
+}
+
+std::string Sampler::getFoldedStacks(int &samplecount)
+{
+	StrongRef<Sampler> sampler;
+	{
+		thread::Lock lock(getSamplerMutex());
+		sampler = lastSampler;
+	}
+
+	samplecount = 0;
+	if (sampler.get() == nullptr)
+		return "";
+
+	std::vector<std::pair<std::string, int>> sorted;
+	{
+		thread::Lock lock(sampler->mutex);
+		sorted.assign(sampler->stacks.begin(), sampler->stacks.end());
+		samplecount = sampler->sampleCount;
+	}
+
+	std::sort(sorted.begin(), sorted.end());
+
+	std::stringstream ss;
+	for (const auto &s : sorted)
+		ss << s.first << " " << s.second << "\n";
+
+	return ss.str();
+}
+
+void Sampler::threadFunction()
+{
+	double intervalms = interval * 1000.0;
+
+	while (!finish.load())
+	{
+		love::sleep(intervalms);
+
+		// Note the zone now rather than in the hook, since the hook can't run
+		// until the thread returns to Lua, after the zone has ended.
+		const char *zone = getProfileThreadZone(profileThread);
+
+#ifdef LOVE_SAMPLER_LUAJIT_PROFILE
+		// LuaJIT's profiler takes the samples, on its own timer.
+		if (zone != nullptr)
+			pendingZone.store(zone, std::memory_order_relaxed);
+#else
+		pendingZone.store(zone, std::memory_order_relaxed);
+		pendingSamples.fetch_add(1, std::memory_order_release);
+
+		// Lua allows hooks to be set asynchronously, e.g. from a signal
+		// handler. LuaJIT doesn't, see LOVE_SAMPLER_LUAJIT_PROFILE.
+		lua_sethook(L, hook, LUA_MASKCOUNT, 1);
+#endif
+	}
+}
+
+static void appendFrameName(std::string &str, const char *name)
+{
+	// Semicolons separate frames in folded stacks.
+	for (const char *c = name; *c != '\0'; c++)
+		str += *c == ';' ? ':' : *c;
+}
+
+#ifdef LOVE_SAMPLER_LUAJIT_PROFILE
+
+void Sampler::profileCallback(void *data, lua_State *L, int samples, int vmstate)
+{
+	((Sampler *) data)->takeProfileSample(L, samples, vmstate);
+}
+
+void Sampler::takeProfileSample(lua_State *L, int samples, int vmstate)
+{
+	const char *zone = pendingZone.exchange(nullptr, std::memory_order_relaxed);
+
+	if (zone == nullptr && vmstate == 'G')
+		zone = "Garbage collector";
+	else if (zone == nullptr && vmstate == 'J')
+		zone = "JIT compiler";
+
+	// Module:function names, outermost frame first.
+	size_t len = 0;
+	const char *dump = luaJIT_profile_dumpstack(L, "FZ;", -MAX_SAMPLE_DEPTH, &len);
+
+	stack.assign(dump, len);
+
+	addSample(samples, zone);
+}
+
+#else // LOVE_SAMPLER_LUAJIT_PROFILE
+
+void Sampler::hook(lua_State *L, lua_Debug */*ar*/)
+{
+	lua_sethook(L, nullptr, 0, 0);
+
+	Sampler *sampler = activeSampler.load(std::memory_order_acquire);
+	if (sampler != nullptr)
+		sampler->takeSample(L);
+}
+
+void Sampler::takeSample(lua_State *L)
+{
+	// Several samples may have been requested while the thread was busy in
+	// native code. They all count towards the stack it returns to.
+	int weight = pendingSamples.exchange(0, std::memory_order_acquire);
+	if (weight <= 0)
+		return;
+
+	const char *zone = pendingZone.load(std::memory_order_relaxed);
+
+	int depth = 0;
+	lua_Debug ar;
+
+	while (depth < MAX_SAMPLE_DEPTH && lua_getstack(L, depth, &ar))
+	{
+		if (frames.size() <= (size_t) depth)
+			frames.emplace_back();
+
+		std::string &frame = frames[depth];
+		frame.clear();
+
+		lua_getinfo(L, "Sn", &ar);
+
+		if (ar.name != nullptr)
+			appendFrameName(frame, ar.name);
+		else if (strcmp(ar.what, "main") == 0)
+			frame += "main chunk";
+		else
+			frame += "?";
+
+		if (strcmp(ar.what, "C") == 0)
+			frame += " [C]";
+		else
+		{
+			frame += " (";
+			appendFrameName(frame, ar.short_src);
+			frame += ":" + std::to_string(ar.linedefined) + ")";
+		}
+
+		depth++;
+	}
+
+	// Outermost frame first.
+	stack.clear();
+	for (int i = depth - 1; i >= 0; i--)
+	{
+		stack += frames[i];
+		if (i > 0)
+			stack += ';';
+	}
+
+	addSample(weight, zone);
+}
+
+#endif // LOVE_SAMPLER_LUAJIT_PROFILE
+
+void Sampler::addSample(int weight, const char *zone)
+{
+	if (zone != nullptr)
+	{
+		if (!stack.empty())
+			stack += ';';
+		stack += '[';
+		appendFrameName(stack, zone);
+		stack += ']';
+	}
+
+	thread::Lock lock(mutex);
+	stacks[stack] += weight;
+	sampleCount += weight;
+}
+
+} // timer
+} // love
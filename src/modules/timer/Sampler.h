@@ -0,0 +1,136 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_TIMER_SAMPLER_H
+#define LOVE_TIMER_SAMPLER_H
+
+// LOVE
+#include "common/runtime.h"
+#include "common/profiler.h"
+#include "thread/threads.h"
+
+// C++
+#include <atomic>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// LuaJIT's debug hooks can't be set from another thread, and don't run inside
+// compiled traces. LuaJIT 2.1 has its own sampling profiler, which is used
+// instead.
+#if defined(LUA_JITLIBNAME)
+#include <luajit.h>
+#if LUAJIT_VERSION_NUM >= 20100
+#define LOVE_SAMPLER_LUAJIT_PROFILE
+#endif
+#endif
+
+namespace love
+{
+namespace timer
+{
+
+/**
+ * Sampling profiler for a Lua state. A background thread wakes up at a fixed
+ * interval, notes which native profiler zone the Lua state's thread is in, and
+ * installs a count hook. The hook runs on the Lua state's own thread at its
+ * next instruction, records the Lua call stack, and removes itself again.
+ * Samples are aggregated as "folded stacks", which flame graph tools such as
+ * flamegraph.pl and speedscope can load.
+ *
+ * With LuaJIT, LuaJIT's profiler takes the samples instead, and the thread
+ * only notes the native zones. A zone is attached to the next Lua sample, so
+ * it can be off by up to one interval.
+ *
+ * Only one Lua state can be sampled at a time. Without LuaJIT, any debug
+ * hook set while sampling will be replaced.
+ **/
+class Sampler : public love::thread::Threadable
+{
+public:
+
+	/**
+	 * Starts sampling the given Lua thread (coroutine). The owner identifies
+	 * the Lua state, so sampling can only be stopped from the same state.
+	 **/
+	static void startSampling(lua_State *L, const void *owner, double interval);
+
+	/**
+	 * Stops sampling if the given owner started it. Returns false otherwise.
+	 **/
+	static bool stopSampling(lua_State *L, const void *owner);
+
+	static bool isSampling(const void *owner);
+
+	/**
+	 * Gets the samples taken by the most recently started Sampler, one folded
+	 * stack per line followed by its sample count.
+	 **/
+	static std::string getFoldedStacks(int &samplecount);
+
+	virtual ~Sampler();
+
+	// Implements Threadable.
+	void threadFunction() override;
+
+private:
+
+	Sampler(lua_State *L, const void *owner, double interval);
+
+#ifdef LOVE_SAMPLER_LUAJIT_PROFILE
+	static void profileCallback(void *data, lua_State *L, int samples, int vmstate);
+	void takeProfileSample(lua_State *L, int samples, int vmstate);
+#else
+	static void hook(lua_State *L, lua_Debug *ar);
+	void takeSample(lua_State *L);
+#endif
+
+	// Appends the zone to the stack and records it.
+	void addSample(int weight, const char *zone);
+
+	lua_State *L;
+	const void *owner;
+	double interval;
+
+	// Registry reference keeping the sampled coroutine alive.
+	int threadRef;
+
+	ProfileThread *profileThread;
+
+	std::atomic<bool> finish;
+
+	// Written by the sampler thread, consumed by the hook.
+	std::atomic<int> pendingSamples;
+	std::atomic<const char *> pendingZone;
+
+	// Only used by the hook.
+	std::vector<std::string> frames;
+	std::string stack;
+
+	thread::MutexRef mutex;
+	std::unordered_map<std::string, int> stacks;
+	int sampleCount;
+
+}; // Sampler
+
+} // timer
+} // love
+
+#endif // LOVE_TIMER_SAMPLER_H
@@ -24,7 +24,9 @@
 #include "common/delay.h"
 #include "Timer.h"
 
+#include <algorithm>
 #include <iostream>
+#include <thread>
 #if defined(LOVE_WINDOWS)
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
@@ -51,8 +53,12 @@ Timer::Timer()
 	, fpsUpdateFrequency(1)
 	, frames(0)
 	, dt(0)
+	, frameRateLimit(0)
+	, nextFrameTime(0)
+	, frameEndTime(0)
+	, frameWorkTime(0)
 {
-	prevFpsUpdate = currTime = getTime();
+	prevFpsUpdate = currTime = frameEndTime = getTime();
 }
 
 double Timer::step()
@@ -82,10 +88,87 @@ double Timer::step()
 	return dt;
 }
 
+// How late the OS tends to wake us up from a sleep, per thread. Starts out
+// pessimistic and adapts to the actual scheduler and timer resolution.
+static thread_local double sleepOvershoot = 0.001;
+
+// Sleep and yield for the rest is much more accurate than a plain sleep, but
+// waiting for more than a couple of ms would just burn a core, so past that
+// it's better to accept the lateness.
+static const double MIN_SPIN_TIME = 0.0002;
+static const double MAX_SPIN_TIME = 0.002;
+
+static void sleepUntil(double deadline)
+{
+	double now = Timer::getTime();
+	double spintime = std::min(std::max(sleepOvershoot * 2.0, MIN_SPIN_TIME), MAX_SPIN_TIME);
+
+	double sleeptime = deadline - now - spintime;
+	if (sleeptime > 0)
+	{
+		love::sleep(sleeptime * 1000.0);
+		now = Timer::getTime();
+
+		double overshoot = std::max(now - (deadline - spintime), 0.0);
+		sleepOvershoot = sleepOvershoot * 0.875 + overshoot * 0.125;
+	}
+
+	while (now < deadline)
+	{
+		std::this_thread::yield();
+		now = Timer::getTime();
+	}
+}
+
 void Timer::sleep(double seconds) const
 {
-	if (seconds >= 0)
-		love::sleep(seconds*1000);
+	if (seconds > 0)
+		sleepUntil(getTime() + seconds);
+	else if (seconds == 0)
+		love::sleep(0);
+}
+
+void Timer::setFrameRateLimit(double fps)
+{
+	frameRateLimit = fps > 0 ? fps : 0;
+	nextFrameTime = 0;
+}
+
+double Timer::getFrameRateLimit() const
+{
+	return frameRateLimit;
+}
+
+double Timer::waitForNextFrame()
+{
+	double start = getTime();
+	frameWorkTime = start - frameEndTime;
+
+	if (frameRateLimit <= 0)
+	{
+		love::sleep(1.0);
+		frameEndTime = getTime();
+		return frameEndTime - start;
+	}
+
+	double period = 1.0 / frameRateLimit;
+
+	// Start over from now instead of trying to catch up after a long hitch,
+	// or when the limit was just enabled or changed.
+	if (nextFrameTime <= 0 || start - nextFrameTime > period)
+		nextFrameTime = start;
+
+	nextFrameTime += period;
+
+	sleepUntil(nextFrameTime);
+
+	frameEndTime = getTime();
+	return frameEndTime - start;
+}
+
+double Timer::getFrameWorkTime() const
+{
+	return frameWorkTime;
 }
 
 double Timer::getDelta() const
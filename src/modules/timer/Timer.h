@@ -43,8 +43,9 @@ public:
 	double step();
 
 	/**
-	 * Tries to sleep for the specified amount of time. The precision is
-	 * usually 1ms.
+	 * Sleeps for the specified amount of time. The OS sleep is cut short and
+	 * the remaining fraction of a millisecond or so is spent yielding, so the
+	 * precision is much better than the OS scheduler's.
 	 * @param seconds The number of seconds to sleep for.
 	 **/
 	void sleep(double seconds) const;
@@ -67,6 +68,28 @@ public:
 	 **/
 	double getAverageDelta() const;
 
+	/**
+	 * Sets the frame rate which waitForNextFrame paces frames to. 0 disables
+	 * the limit.
+	 **/
+	void setFrameRateLimit(double fps);
+	double getFrameRateLimit() const;
+
+	/**
+	 * Sleeps until it's time to start the next frame according to the frame
+	 * rate limit, or for 1ms if there's no limit. Frames are scheduled at fixed
+	 * intervals, so time lost to an oversleep is made up on the next frame.
+	 * @return The number of seconds spent waiting.
+	 **/
+	double waitForNextFrame();
+
+	/**
+	 * Gets the time in seconds between the previous waitForNextFrame call
+	 * returning and this frame's call beginning, i.e. how long the game took
+	 * to produce the last frame, including presenting it.
+	 **/
+	double getFrameWorkTime() const;
+
 	/**
 	 * Gets the amount of time in seconds passed since its first invocation
 	 * (which happens as part of the Timer constructor,
@@ -97,6 +120,12 @@ private:
 	// The current timestep.
 	double dt;
 
+	// Frame pacing vars.
+	double frameRateLimit;
+	double nextFrameTime;
+	double frameEndTime;
+	double frameWorkTime;
+
 }; // Timer
 
 } // timer
@@ -22,6 +22,8 @@
 
 // LOVE
 #include "wrap_Timer.h"
+#include "Sampler.h"
+#include "common/profiler.h"
 
 namespace love
 {
@@ -60,12 +62,127 @@ int w_sleep(lua_State *L)
 	return 0;
 }
 
+int w_setFrameRateLimit(lua_State *L)
+{
+	double fps = luaL_checknumber(L, 1);
+	if (fps < 0)
+		return luaL_argerror(L, 1, "frame rate limit must not be negative");
+	instance()->setFrameRateLimit(fps);
+	return 0;
+}
+
+int w_getFrameRateLimit(lua_State *L)
+{
+	lua_pushnumber(L, instance()->getFrameRateLimit());
+	return 1;
+}
+
+int w_waitForNextFrame(lua_State *L)
+{
+	lua_pushnumber(L, instance()->waitForNextFrame());
+	return 1;
+}
+
+int w_getFrameWorkTime(lua_State *L)
+{
+	lua_pushnumber(L, instance()->getFrameWorkTime());
+	return 1;
+}
+
 int w_getTime(lua_State *L)
 {
 	lua_pushnumber(L, instance()->getTime());
 	return 1;
 }
 
+int w_setProfilingEnabled(lua_State *L)
+{
+	setProfilerEnabled(luax_checkboolean(L, 1));
+	return 0;
+}
+
+int w_isProfilingEnabled(lua_State *L)
+{
+	luax_pushboolean(L, isProfilerEnabled());
+	return 1;
+}
+
+int w_beginZone(lua_State *L)
+{
+	const char *name = luaL_checkstring(L, 1);
+	if (isProfilerEnabled())
+		beginProfileZone(std::string(name));
+	return 0;
+}
+
+int w_endZone(lua_State */*L*/)
+{
+	// Zones begun before profiling was disabled still need to be closed.
+	endProfileZone();
+	return 0;
+}
+
+int w_clearProfile(lua_State */*L*/)
+{
+	clearProfile();
+	return 0;
+}
+
+int w_getProfileTrace(lua_State *L)
+{
+	std::string trace;
+	luax_catchexcept(L, [&]() { trace = getProfileTraceJSON(); });
+	luax_pushstring(L, trace);
+	return 1;
+}
+
+// Identifies the Lua state to the Sampler. It's a userdata in the registry
+// whose __gc stops sampling before the Lua state is closed.
+static const char *SAMPLER_OWNER_KEY = "_love_timer_sampler";
+
+static const void *getSamplerOwner(lua_State *L)
+{
+	lua_getfield(L, LUA_REGISTRYINDEX, SAMPLER_OWNER_KEY);
+	const void *owner = lua_touserdata(L, -1);
+	lua_pop(L, 1);
+	return owner;
+}
+
+static int w_samplerOwner__gc(lua_State *L)
+{
+	Sampler::stopSampling(L, lua_touserdata(L, 1));
+	return 0;
+}
+
+int w_startSampling(lua_State *L)
+{
+	double interval = luaL_optnumber(L, 1, 0.001);
+	luax_catchexcept(L, [&]() { Sampler::startSampling(L, getSamplerOwner(L), interval); });
+	return 0;
+}
+
+int w_stopSampling(lua_State *L)
+{
+	luax_pushboolean(L, Sampler::stopSampling(L, getSamplerOwner(L)));
+	return 1;
+}
+
+int w_isSampling(lua_State *L)
+{
+	luax_pushboolean(L, Sampler::isSampling(getSamplerOwner(L)));
+	return 1;
+}
+
+int w_getSampleProfile(lua_State *L)
+{
+	std::string stacks;
+	int samplecount = 0;
+	luax_catchexcept(L, [&]() { stacks = Sampler::getFoldedStacks(samplecount); });
+	luax_pushstring(L, stacks);
+	lua_pushinteger(L, samplecount);
+	return 2;
+}
+
 // List of functions to wrap.
 static const luaL_Reg functions[] =
 {
@@ -75,6 +192,20 @@ static const luaL_Reg functions[] =
 	{ "getAverageDelta", w_getAverageDelta },
 	{ "sleep", w_sleep },
 	{ "getTime", w_getTime },
+	{ "setFrameRateLimit", w_setFrameRateLimit },
+	{ "getFrameRateLimit", w_getFrameRateLimit },
+	{ "waitForNextFrame", w_waitForNextFrame },
+	{ "getFrameWorkTime", w_getFrameWorkTime },
+	{ "setProfilingEnabled", w_setProfilingEnabled },
+	{ "isProfilingEnabled", w_isProfilingEnabled },
+	{ "beginZone", w_beginZone },
+	{ "endZone", w_endZone },
+	{ "clearProfile", w_clearProfile },
+	{ "getProfileTrace", w_getProfileTrace },
+	{ "startSampling", w_startSampling },
+	{ "stopSampling", w_stopSampling },
+	{ "isSampling", w_isSampling },
+	{ "getSampleProfile", w_getSampleProfile },
 	{ 0, 0 }
 };
 
@@ -89,6 +220,17 @@ extern "C" int luaopen_love_timer(lua_State *L)
 	else
 		instance->retain();
 
+	if (getSamplerOwner(L) == nullptr)
+	{
+		// Any old data that we can attach a metatable to, for __gc.
+		lua_newuserdata(L, sizeof(int));
+		luaL_newmetatable(L, "love_timer_sampler");
+		lua_pushcfunction(L, w_samplerOwner__gc);
+		lua_setfield(L, -2, "__gc");
+		lua_setmetatable(L, -2);
+		lua_setfield(L, LUA_REGISTRYINDEX, SAMPLER_OWNER_KEY);
+	}
+
 	WrappedModule w;
 	w.module = instance;
 	w.name = "timer";
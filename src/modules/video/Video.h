@@ -38,10 +38,17 @@ public:
 
 	virtual ~Video() {}
 
+	static const int DEFAULT_DECODE_AHEAD_FRAMES = 2;
+	static const int MAX_DECODE_AHEAD_FRAMES = 16;
+
 	/**
-	 * Create a VideoStream representing video frames
+	 * Create a VideoStream representing video frames. Implementations only
+	 * need to provide planar Y'CbCr frames through VideoStream's front buffer,
+	 * so other decoder backends can be added behind this interface.
+	 * @param decodeahead The number of frames which are decoded ahead of the
+	 * current playback position.
 	 **/
-	virtual VideoStream *newVideoStream(love::filesystem::File *file) = 0;
+	virtual VideoStream *newVideoStream(love::filesystem::File *file, int decodeahead = DEFAULT_DECODE_AHEAD_FRAMES) = 0;
 
 protected:
 
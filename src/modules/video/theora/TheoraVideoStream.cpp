@@ -20,6 +20,7 @@
 
 // STL
 #include <iostream>
+#include <algorithm>
 
 // LOVE
 #include "TheoraVideoStream.h"
@@ -33,12 +34,14 @@ namespace video
 namespace theora
 {
 
-TheoraVideoStream::TheoraVideoStream(love::filesystem::File *file)
+TheoraVideoStream::TheoraVideoStream(love::filesystem::File *file, int decodeahead)
 	: demuxer(file)
 	, headerParsed(false)
 	, decoder(nullptr)
-	, frameReady(false)
-	, lastFrame(0)
+	, frontBuffer(nullptr)
+	, decodeAhead((size_t) std::max(decodeahead, 1))
+	, syncPosition(0)
+	, lastPosition(0)
 	, nextFrame(0)
 {
 	if (demuxer.findStream() != OggDemuxer::TYPE_THEORA)
@@ -46,8 +49,9 @@ TheoraVideoStream::TheoraVideoStream(love::filesystem::File *file)
 
 	th_info_init(&videoInfo);
 
-	frontBuffer = new Frame();
-	backBuffer = new Frame();
+	// One frame for display, plus the decode-ahead queue.
+	for (size_t i = 0; i < decodeAhead + 1; i++)
+		frames.push_back(new Frame());
 
 	try
 	{
@@ -55,12 +59,15 @@ TheoraVideoStream::TheoraVideoStream(love::filesystem::File *file)
 	}
 	catch (love::Exception &ex)
 	{
-		delete backBuffer;
-		delete frontBuffer;
+		for (Frame *frame : frames)
+			delete frame;
 		th_info_clear(&videoInfo);
 		throw ex;
 	}
 
+	frontBuffer = frames[0];
+	freeFrames.assign(frames.begin() + 1, frames.end());
+
 	frameSync.set(new DeltaSync(), Acquire::NORETAIN);
 }
 
@@ -71,8 +78,8 @@ TheoraVideoStream::~TheoraVideoStream()
 
 	th_info_clear(&videoInfo);
 
-	delete frontBuffer;
-	delete backBuffer;
+	for (Frame *frame : frames)
+		delete frame;
 }
 
 int TheoraVideoStream::getWidth() const
@@ -162,27 +169,30 @@ void TheoraVideoStream::parseHeader()
 	decoder = th_decode_alloc(&videoInfo, setupInfo);
 	th_setup_free(setupInfo);
 
-	Frame *buffers[2] = {backBuffer, frontBuffer};
+	// Post-processing is mostly invisible at normal playback sizes and is by
+	// far the most expensive part of decoding, so keep it off.
+	int pplevel = 0;
+	th_decode_ctl(decoder, TH_DECCTL_SET_PPLEVEL, &pplevel, sizeof(pplevel));
 
 	yPlaneXOffset = cPlaneXOffset = videoInfo.pic_x;
 	yPlaneYOffset = cPlaneYOffset = videoInfo.pic_y;
 
 	scaleFormat(videoInfo.pixel_fmt, cPlaneXOffset, cPlaneYOffset);
 
-	for (int i = 0; i < 2; i++)
+	for (Frame *frame : frames)
 	{
-		buffers[i]->cw = buffers[i]->yw = videoInfo.pic_width;
-		buffers[i]->ch = buffers[i]->yh = videoInfo.pic_height;
+		frame->cw = frame->yw = videoInfo.pic_width;
+		frame->ch = frame->yh = videoInfo.pic_height;
 
-		scaleFormat(videoInfo.pixel_fmt, buffers[i]->cw, buffers[i]->ch);
+		scaleFormat(videoInfo.pixel_fmt, frame->cw, frame->ch);
 
-		buffers[i]->yplane = new unsigned char[buffers[i]->yw * buffers[i]->yh];
-		buffers[i]->cbplane = new unsigned char[buffers[i]->cw * buffers[i]->ch];
-		buffers[i]->crplane = new unsigned char[buffers[i]->cw * buffers[i]->ch];
+		frame->yplane = new unsigned char[frame->yw * frame->yh];
+		frame->cbplane = new unsigned char[frame->cw * frame->ch];
+		frame->crplane = new unsigned char[frame->cw * frame->ch];
 
-		memset(buffers[i]->yplane, 16, buffers[i]->yw * buffers[i]->yh);
-		memset(buffers[i]->cbplane, 128, buffers[i]->cw * buffers[i]->ch);
-		memset(buffers[i]->crplane, 128, buffers[i]->cw * buffers[i]->ch);
+		memset(frame->yplane, 16, frame->yw * frame->yh);
+		memset(frame->cbplane, 128, frame->cw * frame->ch);
+		memset(frame->crplane, 128, frame->cw * frame->ch);
 	}
 
 	headerParsed = true;
@@ -199,10 +209,63 @@ void TheoraVideoStream::seekDecoder(double target)
 		return;
 
 	// Now update theora and our decoder on this new position of ours
-	lastFrame = nextFrame = -1;
+	nextFrame = -1;
 	th_decode_ctl(decoder, TH_DECCTL_SET_GRANPOS, &packet.granulepos, sizeof(packet.granulepos));
 }
 
+bool TheoraVideoStream::decodeNextFrame()
+{
+	ogg_int64_t decoderPosition;
+	do
+	{
+		if (demuxer.readPacket(packet))
+			return false;
+
+		if (packet.granulepos > 0)
+			th_decode_ctl(decoder, TH_DECCTL_SET_GRANPOS, &packet.granulepos, sizeof(packet.granulepos));
+	} while (th_decode_packetin(decoder, &packet, &decoderPosition) != 0);
+
+	nextFrame = th_granule_time(decoder, decoderPosition);
+	return true;
+}
+
+void TheoraVideoStream::copyFrame(const th_ycbcr_buffer &bufferinfo, Frame *frame)
+{
+	for (int y = 0; y < frame->yh; ++y)
+	{
+		memcpy(frame->yplane+frame->yw*y,
+				bufferinfo[0].data+
+					bufferinfo[0].stride*(y+yPlaneYOffset)+yPlaneXOffset,
+				frame->yw);
+	}
+
+	for (int y = 0; y < frame->ch; ++y)
+	{
+		memcpy(frame->cbplane+frame->cw*y,
+				bufferinfo[1].data+
+					bufferinfo[1].stride*(y+cPlaneYOffset)+cPlaneXOffset,
+				frame->cw);
+	}
+
+	for (int y = 0; y < frame->ch; ++y)
+	{
+		memcpy(frame->crplane+frame->cw*y,
+				bufferinfo[2].data+
+					bufferinfo[2].stride*(y+cPlaneYOffset)+cPlaneXOffset,
+				frame->cw);
+	}
+}
+
+void TheoraVideoStream::flushQueuedFrames()
+{
+	love::thread::Lock l(bufferMutex);
+
+	for (const QueuedFrame &queued : queuedFrames)
+		freeFrames.push_back(queued.frame);
+
+	queuedFrames.clear();
+}
+
 void TheoraVideoStream::threadedFillBackBuffer(double dt)
 {
 	// Synchronize
@@ -210,13 +273,25 @@ void TheoraVideoStream::threadedFillBackBuffer(double dt)
 	double position = frameSync->getPosition();
 
 	// Seeking backwards
-	if (position < lastFrame)
+	if (position < lastPosition)
+	{
 		seekDecoder(position);
+		flushQueuedFrames();
+	}
+
+	lastPosition = position;
+
+	{
+		love::thread::Lock l(bufferMutex);
+		syncPosition = position;
+	}
 
 	th_ycbcr_buffer bufferinfo;
 	bool hasFrame = false;
+	double frameTime = 0.0;
 
-	// Until we are at the end of the stream, or we are displaying the right frame
+	// Until we are at the end of the stream, or we are displaying the right
+	// frame. Frames we fall behind on are skipped without being copied.
 	unsigned int framesBehind = 0;
 	bool failedSeek = false;
 	while (!demuxer.isEos() && position >= nextFrame)
@@ -231,59 +306,57 @@ void TheoraVideoStream::threadedFillBackBuffer(double dt)
 
 		th_decode_ycbcr_out(decoder, bufferinfo);
 		hasFrame = true;
+		frameTime = nextFrame;
 
-		ogg_int64_t decoderPosition;
-		do
-		{
-			if (demuxer.readPacket(packet))
-				return;
-
-			if (packet.granulepos > 0)
-				th_decode_ctl(decoder, TH_DECCTL_SET_GRANPOS, &packet.granulepos, sizeof(packet.granulepos));
-		} while (th_decode_packetin(decoder, &packet, &decoderPosition) != 0);
-
-		lastFrame = nextFrame;
-		nextFrame = th_granule_time(decoder, decoderPosition);
+		if (!decodeNextFrame())
+			return;
 	}
 
-	// Only swap once, even if we read many frames to get here
+	// Only copy once, even if we read many frames to get here. Anything
+	// already queued is older than this frame, so it's dropped.
 	if (hasFrame)
 	{
-		// Don't swap whilst we're writing to the backbuffer
+		flushQueuedFrames();
+
+		Frame *frame = nullptr;
 		{
 			love::thread::Lock l(bufferMutex);
-			frameReady = false;
+			frame = freeFrames.back();
+			freeFrames.pop_back();
 		}
 
-		for (int y = 0; y < backBuffer->yh; ++y)
-		{
-			memcpy(backBuffer->yplane+backBuffer->yw*y,
-					bufferinfo[0].data+
-						bufferinfo[0].stride*(y+yPlaneYOffset)+yPlaneXOffset,
-					backBuffer->yw);
-		}
+		copyFrame(bufferinfo, frame);
 
-		for (int y = 0; y < backBuffer->ch; ++y)
-		{
-			memcpy(backBuffer->cbplane+backBuffer->cw*y,
-					bufferinfo[1].data+
-						bufferinfo[1].stride*(y+cPlaneYOffset)+cPlaneXOffset,
-					backBuffer->cw);
-		}
+		love::thread::Lock l(bufferMutex);
+		queuedFrames.push_back({frame, frameTime});
+	}
 
-		for (int y = 0; y < backBuffer->ch; ++y)
+	// Decode ahead of the current position, so the main thread always has a
+	// frame ready when it becomes due.
+	while (!demuxer.isEos())
+	{
+		Frame *frame = nullptr;
 		{
-			memcpy(backBuffer->crplane+backBuffer->cw*y,
-					bufferinfo[2].data+
-						bufferinfo[2].stride*(y+cPlaneYOffset)+cPlaneXOffset,
-					backBuffer->cw);
+			love::thread::Lock l(bufferMutex);
+			if (queuedFrames.size() >= decodeAhead || freeFrames.empty())
+				break;
+
+			frame = freeFrames.back();
+			freeFrames.pop_back();
 		}
 
-		// Re-enable swapping
+		th_decode_ycbcr_out(decoder, bufferinfo);
+		double time = nextFrame;
+
+		copyFrame(bufferinfo, frame);
+
 		{
 			love::thread::Lock l(bufferMutex);
-			frameReady = true;
+			queuedFrames.push_back({frame, time});
 		}
+
+		if (!decodeNextFrame())
+			return;
 	}
 }
 
@@ -294,20 +367,25 @@ void TheoraVideoStream::fillBackBuffer()
 
 bool TheoraVideoStream::swapBuffers()
 {
-	if (demuxer.isEos())
-		return false;
-
 	if (!frameSync->isPlaying())
 		return false;
 
 	love::thread::Lock l(bufferMutex);
-	if (!frameReady)
+
+	// Display the newest frame which is due, and recycle the ones before it.
+	size_t due = 0;
+	while (due < queuedFrames.size() && queuedFrames[due].time <= syncPosition)
+		due++;
+
+	if (due == 0)
 		return false;
-	frameReady = false;
 
-	Frame *temp = frontBuffer;
-	frontBuffer = backBuffer;
-	backBuffer = temp;
+	freeFrames.push_back(frontBuffer);
+	for (size_t i = 0; i < due - 1; i++)
+		freeFrames.push_back(queuedFrames[i].frame);
+
+	frontBuffer = queuedFrames[due - 1].frame;
+	queuedFrames.erase(queuedFrames.begin(), queuedFrames.begin() + due);
 
 	return true;
 }
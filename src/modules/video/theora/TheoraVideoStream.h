@@ -29,6 +29,10 @@
 #include "thread/threads.h"
 #include "OggDemuxer.h"
 
+// STL
+#include <vector>
+#include <deque>
+
 // OGG/Theora
 #include <ogg/ogg.h>
 #include <theora/codec.h>
@@ -44,7 +48,7 @@ namespace theora
 class TheoraVideoStream : public love::video::VideoStream
 {
 public:
-	TheoraVideoStream(love::filesystem::File *file);
+	TheoraVideoStream(love::filesystem::File *file, int decodeahead);
 	~TheoraVideoStream();
 
 	const void *getFrontBuffer() const;
@@ -62,6 +66,12 @@ public:
 	void threadedFillBackBuffer(double dt);
 
 private:
+
+	struct QueuedFrame
+	{
+		Frame *frame;
+		double time;
+	};
 	OggDemuxer demuxer;
 
 	bool headerParsed;
@@ -71,21 +81,33 @@ private:
 	th_info videoInfo;
 	th_dec_ctx *decoder;
 
+	// All frames are owned by this list. The front buffer is displayed, queued
+	// frames have been decoded ahead of the playback position, and the rest
+	// are free for the worker thread to decode into.
+	std::vector<Frame *> frames;
 	Frame *frontBuffer;
-	Frame *backBuffer;
+	std::deque<QueuedFrame> queuedFrames;
+	std::vector<Frame *> freeFrames;
+	size_t decodeAhead;
+
 	unsigned int yPlaneXOffset;
 	unsigned int cPlaneXOffset;
 	unsigned int yPlaneYOffset;
 	unsigned int cPlaneYOffset;
 
 	love::thread::MutexRef bufferMutex;
-	bool frameReady;
 
-	double lastFrame;
+	// Last sync position seen by the worker thread, guarded by bufferMutex.
+	double syncPosition;
+
+	double lastPosition;
 	double nextFrame;
 
 	void parseHeader();
 	void seekDecoder(double target);
+	bool decodeNextFrame();
+	void copyFrame(const th_ycbcr_buffer &bufferinfo, Frame *frame);
+	void flushQueuedFrames();
 }; // TheoraVideoStream
 
 } // theora
@@ -20,6 +20,8 @@
 
 // STL
 #include <vector>
+#include <thread>
+#include <algorithm>
 
 // LOVE
 #include "Video.h"
@@ -36,22 +38,53 @@ namespace theora
 Video::Video()
 	: love::video::Video("love.video.theora")
 {
-	workerThread = new Worker();
-	workerThread->start();
+	// Leave one core for the main thread.
+	int cores = (int) std::thread::hardware_concurrency();
+	maxWorkerThreads = std::max(std::min(cores - 1, MAX_WORKER_THREADS), 1);
+
+	Worker *worker = new Worker();
+	worker->start();
+	workerThreads.push_back(worker);
 }
 
 Video::~Video()
 {
-	delete workerThread;
+	for (Worker *worker : workerThreads)
+		delete worker;
 }
 
-VideoStream *Video::newVideoStream(love::filesystem::File *file)
+VideoStream *Video::newVideoStream(love::filesystem::File *file, int decodeahead)
 {
-	TheoraVideoStream *stream = new TheoraVideoStream(file);
-	workerThread->addStream(stream);
+	TheoraVideoStream *stream = new TheoraVideoStream(file, decodeahead);
+	getWorker()->addStream(stream);
 	return stream;
 }
 
+Worker *Video::getWorker()
+{
+	Worker *best = nullptr;
+	size_t bestcount = 0;
+
+	for (Worker *worker : workerThreads)
+	{
+		size_t count = worker->getStreamCount();
+		if (best == nullptr || count < bestcount)
+		{
+			best = worker;
+			bestcount = count;
+		}
+	}
+
+	if (bestcount > 0 && (int) workerThreads.size() < maxWorkerThreads)
+	{
+		best = new Worker();
+		best->start();
+		workerThreads.push_back(best);
+	}
+
+	return best;
+}
+
 Worker::Worker()
 	: stopping(false)
 {
@@ -70,6 +103,12 @@ void Worker::addStream(TheoraVideoStream *stream)
 	cond->broadcast();
 }
 
+size_t Worker::getStreamCount()
+{
+	love::thread::Lock l(mutex);
+	return streams.size();
+}
+
 void Worker::stop()
 {
 	{
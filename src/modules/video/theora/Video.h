@@ -46,10 +46,18 @@ public:
 	Video();
 	virtual ~Video();
 
-	VideoStream *newVideoStream(love::filesystem::File* file);
+	VideoStream *newVideoStream(love::filesystem::File* file, int decodeahead) override;
 
 private:
-	Worker *workerThread;
+
+	// Each stream gets its own worker thread until this many exist, after
+	// which new streams share the least busy worker.
+	static const int MAX_WORKER_THREADS = 8;
+
+	Worker *getWorker();
+
+	std::vector<Worker *> workerThreads;
+	int maxWorkerThreads;
 }; // Video
 
 class Worker : public love::thread::Threadable
@@ -62,6 +70,7 @@ public:
 	void threadFunction();
 
 	void addStream(TheoraVideoStream *stream);
+	size_t getStreamCount();
 	// Frees itself!
 	void stop();
 
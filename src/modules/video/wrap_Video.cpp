@@ -36,13 +36,25 @@ int w_newVideoStream(lua_State *L)
 {
 	love::filesystem::File *file = love::filesystem::luax_getfile(L, 1);
 
+	int decodeahead = (int) luaL_optinteger(L, 2, Video::DEFAULT_DECODE_AHEAD_FRAMES);
+	if (decodeahead < 1 || decodeahead > Video::MAX_DECODE_AHEAD_FRAMES)
+	{
+		file->release();
+		return luaL_error(L, "Number of decode-ahead frames must be between 1 and %d.", Video::MAX_DECODE_AHEAD_FRAMES);
+	}
+
 	VideoStream *stream = nullptr;
 	luax_catchexcept(L, [&]() {
 		// Can't check if open for reading
 		if (!file->isOpen() && !file->open(love::filesystem::File::MODE_READ))
 			luaL_error(L, "File is not open and cannot be opened");
 
-		stream = instance()->newVideoStream(file);
+		// Video is read sequentially, so let reads happen ahead of decoding.
+		int64 buffersize = 0;
+		if (file->getBuffer(buffersize) == love::filesystem::File::BUFFER_NONE)
+			file->setBuffer(love::filesystem::File::BUFFER_READAHEAD, 0);
+
+		stream = instance()->newVideoStream(file, decodeahead);
 	});
 
 	luax_pushtype(L, stream);
@@ -96,6 +96,21 @@ std::vector<std::string> Window::getConstants(MessageBoxType)
 	return messageBoxTypes.getNames();
 }
 
+bool Window::getConstant(const char *in, PresentMode &out)
+{
+	return presentModes.find(in, out);
+}
+
+bool Window::getConstant(PresentMode in, const char *&out)
+{
+	return presentModes.find(in, out);
+}
+
+std::vector<std::string> Window::getConstants(PresentMode)
+{
+	return presentModes.getNames();
+}
+
 bool Window::getConstant(const char *in, DisplayOrientation &out)
 {
 	return orientations.find(in, out);
@@ -152,6 +167,16 @@ StringMap<Window::MessageBoxType, Window::MESSAGEBOX_MAX_ENUM>::Entry Window::me
 
 StringMap<Window::MessageBoxType, Window::MESSAGEBOX_MAX_ENUM> Window::messageBoxTypes(Window::messageBoxTypeEntries, sizeof(Window::messageBoxTypeEntries));
 
+StringMap<Window::PresentMode, Window::PRESENTMODE_MAX_ENUM>::Entry Window::presentModeEntries[] =
+{
+	{"immediate", PRESENTMODE_IMMEDIATE},
+	{"vsync", PRESENTMODE_VSYNC},
+	{"adaptive", PRESENTMODE_ADAPTIVE},
+	{"mailbox", PRESENTMODE_MAILBOX},
+};
+
+StringMap<Window::PresentMode, Window::PRESENTMODE_MAX_ENUM> Window::presentModes(Window::presentModeEntries, sizeof(Window::presentModeEntries));
+
 StringMap<Window::DisplayOrientation, Window::ORIENTATION_MAX_ENUM>::Entry Window::orientationEntries[] =
 {
 	{"unknown", ORIENTATION_UNKNOWN},
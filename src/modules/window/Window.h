@@ -94,6 +94,18 @@ public:
 		MESSAGEBOX_MAX_ENUM
 	};
 
+	// How finished frames are handed to the display. "vsync" and "adaptive"
+	// match a vsync value of 1 and -1, "immediate" matches 0. "mailbox"
+	// doesn't block or tear: the newest frame replaces a queued one.
+	enum PresentMode
+	{
+		PRESENTMODE_IMMEDIATE,
+		PRESENTMODE_VSYNC,
+		PRESENTMODE_ADAPTIVE,
+		PRESENTMODE_MAILBOX,
+		PRESENTMODE_MAX_ENUM
+	};
+
 	enum DisplayOrientation
 	{
 		ORIENTATION_UNKNOWN,
@@ -169,6 +181,12 @@ public:
 	virtual void setVSync(int vsync) = 0;
 	virtual int getVSync() const = 0;
 
+	// Returns false (and leaves the current mode alone) if the mode isn't
+	// supported by the active renderer.
+	virtual bool setPresentMode(PresentMode mode) = 0;
+	virtual PresentMode getPresentMode() const = 0;
+	virtual std::vector<PresentMode> getSupportedPresentModes() const = 0;
+
 	virtual void setDisplaySleepEnabled(bool enable) = 0;
 	virtual bool isDisplaySleepEnabled() const = 0;
 
@@ -216,6 +234,20 @@ public:
 
 	virtual void *getHandle() const = 0;
 
+	/**
+	 * Creates an OpenGL context which shares objects with the window's main
+	 * context, so it can be used on another thread. Returns null if the
+	 * window doesn't use OpenGL or the context couldn't be created.
+	 **/
+	virtual void *createSharedGLContext() = 0;
+
+	/**
+	 * Makes a context from createSharedGLContext current on the calling
+	 * thread, or releases the thread's current context when null.
+	 **/
+	virtual bool setSharedGLContextCurrent(void *context) = 0;
+	virtual void destroySharedGLContext(void *context) = 0;
+
 	virtual bool showMessageBox(const std::string &title, const std::string &message, MessageBoxType type, bool attachtowindow) = 0;
 	virtual int showMessageBox(const MessageBoxData &data) = 0;
 
@@ -232,6 +264,10 @@ public:
 	static bool getConstant(MessageBoxType in, const char *&out);
 	static std::vector<std::string> getConstants(MessageBoxType);
 
+	static bool getConstant(const char *in, PresentMode &out);
+	static bool getConstant(PresentMode in, const char *&out);
+	static std::vector<std::string> getConstants(PresentMode);
+
 	static bool getConstant(const char *in, DisplayOrientation &out);
 	static bool getConstant(DisplayOrientation in, const char *&out);
 	static std::vector<std::string> getConstants(DisplayOrientation);
@@ -251,6 +287,9 @@ private:
 	static StringMap<MessageBoxType, MESSAGEBOX_MAX_ENUM>::Entry messageBoxTypeEntries[];
 	static StringMap<MessageBoxType, MESSAGEBOX_MAX_ENUM> messageBoxTypes;
 
+	static StringMap<PresentMode, PRESENTMODE_MAX_ENUM>::Entry presentModeEntries[];
+	static StringMap<PresentMode, PRESENTMODE_MAX_ENUM> presentModes;
+
 	static StringMap<DisplayOrientation, ORIENTATION_MAX_ENUM>::Entry orientationEntries[];
 	static StringMap<DisplayOrientation, ORIENTATION_MAX_ENUM> orientations;
 
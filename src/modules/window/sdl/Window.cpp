@@ -1379,6 +1379,171 @@ int Window::getVSync() const
 	return 0;
 }
 
+#ifdef LOVE_GRAPHICS_VULKAN
+static bool getVulkanPresentMode(Window::PresentMode in, VkPresentModeKHR &out)
+{
+	switch (in)
+	{
+	case Window::PRESENTMODE_IMMEDIATE:
+		out = VK_PRESENT_MODE_IMMEDIATE_KHR;
+		return true;
+	case Window::PRESENTMODE_VSYNC:
+		out = VK_PRESENT_MODE_FIFO_KHR;
+		return true;
+	case Window::PRESENTMODE_ADAPTIVE:
+		out = VK_PRESENT_MODE_FIFO_RELAXED_KHR;
+		return true;
+	case Window::PRESENTMODE_MAILBOX:
+		out = VK_PRESENT_MODE_MAILBOX_KHR;
+		return true;
+	default:
+		return false;
+	}
+}
+
+static bool getVulkanPresentMode(VkPresentModeKHR in, Window::PresentMode &out)
+{
+	switch (in)
+	{
+	case VK_PRESENT_MODE_IMMEDIATE_KHR:
+		out = Window::PRESENTMODE_IMMEDIATE;
+		return true;
+	case VK_PRESENT_MODE_FIFO_KHR:
+		out = Window::PRESENTMODE_VSYNC;
+		return true;
+	case VK_PRESENT_MODE_FIFO_RELAXED_KHR:
+		out = Window::PRESENTMODE_ADAPTIVE;
+		return true;
+	case VK_PRESENT_MODE_MAILBOX_KHR:
+		out = Window::PRESENTMODE_MAILBOX;
+		return true;
+	default:
+		return false;
+	}
+}
+#endif
+
+bool Window::setPresentMode(PresentMode mode)
+{
+	if (glcontext != nullptr)
+	{
+		// OpenGL has no mailbox equivalent. Adaptive vsync depends on the
+		// driver, so check whether the swap interval actually changed.
+		if (mode == PRESENTMODE_MAILBOX)
+			return false;
+
+		int vsync = mode == PRESENTMODE_ADAPTIVE ? -1 : (mode == PRESENTMODE_VSYNC ? 1 : 0);
+		int oldvsync = getVSync();
+
+		SDL_GL_SetSwapInterval(vsync);
+
+		if (getVSync() != vsync)
+		{
+			SDL_GL_SetSwapInterval(oldvsync);
+			return false;
+		}
+
+		return true;
+	}
+
+#ifdef LOVE_GRAPHICS_VULKAN
+	if (windowRenderer == love::graphics::RENDERER_VULKAN)
+	{
+		VkPresentModeKHR vkmode;
+		if (!getVulkanPresentMode(mode, vkmode))
+			return false;
+		auto vgfx = dynamic_cast<love::graphics::vulkan::Graphics*>(graphics.get());
+		return vgfx->setPresentMode(vkmode);
+	}
+#endif
+
+#if defined(LOVE_GRAPHICS_METAL)
+	if (metalView != nullptr)
+	{
+		// CAMetalLayer is always triple buffered, and can only turn display
+		// sync on or off (on macOS).
+#ifdef LOVE_MACOS
+		if (mode != PRESENTMODE_VSYNC && mode != PRESENTMODE_IMMEDIATE)
+			return false;
+		void *metallayer = SDL_Metal_GetLayer(metalView);
+		love::macos::setMetalLayerVSync(metallayer, mode == PRESENTMODE_VSYNC);
+		return true;
+#else
+		return mode == PRESENTMODE_VSYNC;
+#endif
+	}
+#endif
+
+	return false;
+}
+
+Window::PresentMode Window::getPresentMode() const
+{
+#ifdef LOVE_GRAPHICS_VULKAN
+	if (windowRenderer == love::graphics::RENDERER_VULKAN)
+	{
+		auto vgfx = dynamic_cast<love::graphics::vulkan::Graphics*>(graphics.get());
+		PresentMode mode = PRESENTMODE_VSYNC;
+		getVulkanPresentMode(vgfx->getPresentMode(), mode);
+		return mode;
+	}
+#endif
+
+	int vsync = getVSync();
+	if (vsync == -1)
+		return PRESENTMODE_ADAPTIVE;
+	else if (vsync == 0)
+		return PRESENTMODE_IMMEDIATE;
+	else
+		return PRESENTMODE_VSYNC;
+}
+
+std::vector<Window::PresentMode> Window::getSupportedPresentModes() const
+{
+	std::vector<PresentMode> modes;
+
+	if (glcontext != nullptr)
+	{
+		modes.push_back(PRESENTMODE_IMMEDIATE);
+		modes.push_back(PRESENTMODE_VSYNC);
+
+		// The only way to know whether adaptive vsync works is to try it.
+		int oldvsync = getVSync();
+		SDL_GL_SetSwapInterval(-1);
+		if (getVSync() == -1)
+			modes.push_back(PRESENTMODE_ADAPTIVE);
+		SDL_GL_SetSwapInterval(oldvsync);
+
+		return modes;
+	}
+
+#ifdef LOVE_GRAPHICS_VULKAN
+	if (windowRenderer == love::graphics::RENDERER_VULKAN)
+	{
+		auto vgfx = dynamic_cast<love::graphics::vulkan::Graphics*>(graphics.get());
+		for (VkPresentModeKHR vkmode : vgfx->getSupportedPresentModes())
+		{
+			PresentMode mode;
+			if (getVulkanPresentMode(vkmode, mode))
+				modes.push_back(mode);
+		}
+		return modes;
+	}
+#endif
+
+#if defined(LOVE_GRAPHICS_METAL)
+	if (metalView != nullptr)
+	{
+#ifdef LOVE_MACOS
+		modes.push_back(PRESENTMODE_IMMEDIATE);
+#endif
+		modes.push_back(PRESENTMODE_VSYNC);
+	}
+#endif
+
+	return modes;
+}
+
 void Window::setDisplaySleepEnabled(bool enable)
 {
 	if (enable)
@@ -1673,6 +1838,39 @@ void *Window::getHandle() const
 	return window;
 }
 
+void *Window::createSharedGLContext()
+{
+	if (window == nullptr || glcontext == nullptr)
+		return nullptr;
+
+	// SDL shares objects with whichever context is current.
+	SDL_GL_MakeCurrent(window, glcontext);
+	SDL_GL_SetAttribute(SDL_GL_SHARE_WITH_CURRENT_CONTEXT, 1);
+
+	SDL_GLContext context = SDL_GL_CreateContext(window);
+
+	SDL_GL_SetAttribute(SDL_GL_SHARE_WITH_CURRENT_CONTEXT, 0);
+
+	// Creating a context makes it current.
+	SDL_GL_MakeCurrent(window, glcontext);
+
+	return (void *) context;
+}
+
+bool Window::setSharedGLContextCurrent(void *context)
+{
+	if (window == nullptr)
+		return false;
+
+	return SDL_GL_MakeCurrent(window, (SDL_GLContext) context) == 0;
+}
+
+void Window::destroySharedGLContext(void *context)
+{
+	if (context != nullptr)
+		SDL_GL_DeleteContext((SDL_GLContext) context);
+}
+
 SDL_MessageBoxFlags Window::convertMessageBoxType(MessageBoxType type) const
 {
 	switch (type)
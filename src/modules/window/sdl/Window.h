@@ -81,6 +81,10 @@ public:
 	void setVSync(int vsync) override;
 	int getVSync() const override;
 
+	bool setPresentMode(PresentMode mode) override;
+	PresentMode getPresentMode() const override;
+	std::vector<PresentMode> getSupportedPresentModes() const override;
+
 	void setDisplaySleepEnabled(bool enable) override;
 	bool isDisplaySleepEnabled() const override;
 
@@ -125,6 +129,10 @@ public:
 
 	void *getHandle() const override;
 
+	void *createSharedGLContext() override;
+	bool setSharedGLContextCurrent(void *context) override;
+	void destroySharedGLContext(void *context) override;
+
 	bool showMessageBox(const std::string &title, const std::string &message, MessageBoxType type, bool attachtowindow) override;
 	int showMessageBox(const MessageBoxData &data) override;
 
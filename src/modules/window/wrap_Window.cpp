@@ -443,6 +443,41 @@ int w_getVSync(lua_State *L)
 	return 1;
 }
 
+int w_setPresentMode(lua_State *L)
+{
+	Window::PresentMode mode;
+	const char *str = luaL_checkstring(L, 1);
+	if (!Window::getConstant(str, mode))
+		return luax_enumerror(L, "present mode", Window::getConstants(mode), str);
+	luax_pushboolean(L, instance()->setPresentMode(mode));
+	return 1;
+}
+
+int w_getPresentMode(lua_State *L)
+{
+	const char *str = nullptr;
+	if (!Window::getConstant(instance()->getPresentMode(), str))
+		return luaL_error(L, "Unknown present mode.");
+	lua_pushstring(L, str);
+	return 1;
+}
+
+int w_getSupportedPresentModes(lua_State *L)
+{
+	std::vector<Window::PresentMode> modes = instance()->getSupportedPresentModes();
+	lua_createtable(L, (int) modes.size(), 0);
+	int i = 1;
+	for (Window::PresentMode mode : modes)
+	{
+		const char *str = nullptr;
+		if (!Window::getConstant(mode, str))
+			continue;
+		lua_pushstring(L, str);
+		lua_rawseti(L, -2, i++);
+	}
+	return 1;
+}
+
 int w_setDisplaySleepEnabled(lua_State *L)
 {
 	instance()->setDisplaySleepEnabled(luax_checkboolean(L, 1));
@@ -676,6 +711,9 @@ static const luaL_Reg functions[] =
 	{ "getIcon", w_getIcon },
 	{ "setVSync", w_setVSync },
 	{ "getVSync", w_getVSync },
+	{ "setPresentMode", w_setPresentMode },
+	{ "getPresentMode", w_getPresentMode },
+	{ "getSupportedPresentModes", w_getSupportedPresentModes },
 	{ "setDisplaySleepEnabled", w_setDisplaySleepEnabled },
 	{ "isDisplaySleepEnabled", w_isDisplaySleepEnabled },
 	{ "setTitle", w_setTitle },
@@ -0,0 +1,32 @@
+-- love.data
+
+
+--------------------------------------------------------------------------------
+--------------------------------------------------------------------------------
+--------------------------------------------------------------------------------
+
+
+-- love.data.compress of 64KB of repetitive text
+love.benchmark.data.compress = function(bench)
+  local text = string.rep('helloworld love.data.compress ', 2200):sub(1, 65536)
+  for _, format in ipairs({'lz4', 'zlib', 'gzip', 'deflate'}) do
+    bench:measure(format, 10, function(n)
+      for i=1,n do
+        love.data.compress('data', format, text)
+      end
+    end)
+  end
+end
+
+
+-- love.data.hash of 64KB of text
+love.benchmark.data.hash = function(bench)
+  local text = string.rep('0123456789abcdef', 4096)
+  for _, func in ipairs({'md5', 'sha1', 'sha256', 'xxh64'}) do
+    bench:measure(func, 10, function(n)
+      for i=1,n do
+        love.data.hash('data', func, text)
+      end
+    end)
+  end
+end
@@ -0,0 +1,95 @@
+-- love.graphics
+-- all benchmarks draw into a canvas so they don't depend on the window size
+
+
+--------------------------------------------------------------------------------
+--------------------------------------------------------------------------------
+--------------------------------------------------------------------------------
+
+
+-- batched draws of the same texture, flushed once per sample
+love.benchmark.graphics.drawBatched = function(bench)
+  local canvas = love.graphics.newCanvas(64, 64)
+  local image = love.graphics.newImage('resources/love.png')
+  love.graphics.setCanvas(canvas)
+  bench:measure('image', 10000, function(n)
+    for i=1,n do
+      love.graphics.draw(image, i % 64, 0)
+    end
+    love.graphics.flushBatch()
+  end)
+  bench:measure('rectangle', 10000, function(n)
+    for i=1,n do
+      love.graphics.rectangle('fill', i % 64, 0, 4, 4)
+    end
+    love.graphics.flushBatch()
+  end)
+  love.graphics.setCanvas()
+end
+
+
+-- SpriteBatch:add and the upload + draw of the batch
+love.benchmark.graphics.SpriteBatch = function(bench)
+  local canvas = love.graphics.newCanvas(64, 64)
+  local image = love.graphics.newImage('resources/love.png')
+  local quad = love.graphics.newQuad(0, 0, 16, 16, image)
+  local sbatch = love.graphics.newSpriteBatch(image, 10000, 'stream')
+  bench:measure('add', 10000, function(n)
+    sbatch:clear()
+    for i=1,n do
+      sbatch:add(quad, i % 64, i % 32, 0, 1, 1)
+    end
+  end)
+  love.graphics.setCanvas(canvas)
+  bench:measure('flush', 10, function(n)
+    for i=1,n do
+      sbatch:flush()
+      love.graphics.draw(sbatch)
+    end
+    love.graphics.flushBatch()
+  end)
+  love.graphics.setCanvas()
+end
+
+
+-- Font text layout and drawing
+love.benchmark.graphics.print = function(bench)
+  local canvas = love.graphics.newCanvas(256, 256)
+  local font = love.graphics.newFont('resources/font.ttf', 12)
+  local text = 'The quick brown fox jumps over the lazy dog 0123456789'
+  love.graphics.setCanvas(canvas)
+  love.graphics.setFont(font)
+  bench:measure('print', 1000, function(n)
+    for i=1,n do
+      love.graphics.print(text, 0, i % 256)
+    end
+    love.graphics.flushBatch()
+  end)
+  bench:measure('printf', 1000, function(n)
+    for i=1,n do
+      love.graphics.printf(text, 0, i % 256, 100, 'center')
+    end
+    love.graphics.flushBatch()
+  end)
+  love.graphics.setCanvas()
+end
+
+
+-- ParticleSystem:update with a full buffer of live particles
+love.benchmark.graphics.ParticleSystem = function(bench)
+  local image = love.graphics.newImage('resources/pixel.png')
+  local psystem = love.graphics.newParticleSystem(image, 5000)
+  psystem:setParticleLifetime(1000, 1000)
+  psystem:setEmissionRate(0)
+  psystem:setSpeed(10, 20)
+  psystem:setSpread(math.pi * 2)
+  psystem:setLinearAcceleration(0, 10, 0, 20)
+  psystem:setSizes(1, 2, 1)
+  psystem:setColors(1, 1, 1, 1, 1, 1, 1, 0)
+  psystem:emit(5000)
+  bench:measure('update', 100, function(n)
+    for i=1,n do
+      psystem:update(1/60)
+    end
+  end)
+end
@@ -0,0 +1,34 @@
+-- love.image
+
+
+--------------------------------------------------------------------------------
+--------------------------------------------------------------------------------
+--------------------------------------------------------------------------------
+
+
+-- ImageData:mapPixel over a 256x256 image, counted per pixel
+love.benchmark.image.mapPixel = function(bench)
+  local imgdata = love.image.newImageData(256, 256)
+  local invert = function(x, y, r, g, b, a)
+    return 1 - r, 1 - g, 1 - b, a
+  end
+  bench:measure('rgba8', 256*256, function(n)
+    imgdata:mapPixel(invert)
+  end, 10)
+end
+
+
+-- ImageData:encode of a 256x256 image
+love.benchmark.image.encode = function(bench)
+  local imgdata = love.image.newImageData('resources/love.png')
+  bench:measure('png', 10, function(n)
+    for i=1,n do
+      imgdata:encode('png')
+    end
+  end, 10)
+  bench:measure('tga', 10, function(n)
+    for i=1,n do
+      imgdata:encode('tga')
+    end
+  end, 10)
+end
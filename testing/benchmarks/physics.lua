@@ -0,0 +1,26 @@
+-- love.physics
+
+
+--------------------------------------------------------------------------------
+--------------------------------------------------------------------------------
+--------------------------------------------------------------------------------
+
+
+-- World:update with a pile of boxes resting on the ground
+love.benchmark.physics.World = function(bench)
+  local world = love.physics.newWorld(0, 100, true)
+  local ground = love.physics.newBody(world, 0, 200, 'static')
+  love.physics.newRectangleShape(ground, 0, 0, 1000, 10)
+  for i=1,500 do
+    local body = love.physics.newBody(world, (i % 50) * 12 - 300, -math.floor(i / 50) * 12, 'dynamic')
+    love.physics.newRectangleShape(body, 0, 0, 10, 10)
+  end
+  -- let the boxes settle so the contacts are what's being measured
+  for i=1,120 do world:update(1/60) end
+  bench:measure('update', 10, function(n)
+    for i=1,n do
+      world:update(1/60)
+    end
+  end)
+  world:destroy()
+end
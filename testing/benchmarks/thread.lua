@@ -0,0 +1,38 @@
+-- love.thread
+
+
+--------------------------------------------------------------------------------
+--------------------------------------------------------------------------------
+--------------------------------------------------------------------------------
+
+
+-- Channel:push followed by Channel:pop on the same thread
+love.benchmark.thread.Channel = function(bench)
+  local channel = love.thread.newChannel()
+  bench:measure('number', 10000, function(n)
+    for i=1,n do
+      channel:push(i)
+    end
+    for i=1,n do
+      channel:pop()
+    end
+  end)
+  bench:measure('table', 1000, function(n)
+    local value = {x = 1, y = 2, name = 'test'}
+    for i=1,n do
+      channel:push(value)
+    end
+    for i=1,n do
+      channel:pop()
+    end
+  end)
+  local lockfree = love.thread.newChannel({lockfree = true, capacity = 16384})
+  bench:measure('lockfree', 10000, function(n)
+    for i=1,n do
+      lockfree:push(i)
+    end
+    for i=1,n do
+      lockfree:pop()
+    end
+  end)
+end
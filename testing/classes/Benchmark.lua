@@ -0,0 +1,96 @@
+-- @class - Benchmark
+-- @desc - passed to each benchmark method, times a function over a number of
+--         samples and keeps the per-op results for the BenchmarkSuite output
+Benchmark = {
+
+
+  -- @method - Benchmark:new()
+  -- @desc - create a new Benchmark object
+  -- @param {string} module - love module the benchmark is for
+  -- @param {string} method - name of the benchmark method
+  -- @return {table} - returns the new Benchmark object
+  new = function(self, module, method)
+    local benchmark = {
+      module = module,
+      method = method,
+      results = {},
+      skipped = false,
+      skipreason = '',
+      fatal = '',
+      samples = 30
+    }
+    setmetatable(benchmark, self)
+    self.__index = self
+    return benchmark
+  end,
+
+
+  -- @method - Benchmark:measure()
+  -- @desc - runs func(iterations) once to warm up, then once per sample while
+  --         timing it. Garbage collection is stopped while a sample runs so
+  --         the growth of the Lua heap gives the bytes allocated per op
+  -- @param {string} label - name of this measurement in the output
+  -- @param {number} iterations - ops performed by each call to func
+  -- @param {function} func - function doing the work, given the iterations
+  -- @param {number} samples - optional number of samples, defaults to 30
+  -- @return {table} - returns the result row
+  measure = function(self, label, iterations, func, samples)
+    samples = samples or self.samples
+    func(iterations)
+
+    local times = {}
+    local allocated = 0
+    for s=1,samples do
+      collectgarbage('collect')
+      collectgarbage('stop')
+      local memstart = collectgarbage('count')
+      local start = love.timer.getTime()
+      func(iterations)
+      local elapsed = love.timer.getTime() - start
+      allocated = allocated + math.max(0, collectgarbage('count') - memstart)
+      collectgarbage('restart')
+      table.insert(times, elapsed * 1e9 / iterations)
+    end
+
+    table.sort(times)
+    local total = 0
+    for t=1,#times do total = total + times[t] end
+
+    local result = {
+      label = label,
+      iterations = iterations,
+      samples = samples,
+      mean = total / #times,
+      min = times[1],
+      p50 = BenchmarkPercentile(times, 0.5),
+      p90 = BenchmarkPercentile(times, 0.9),
+      p99 = BenchmarkPercentile(times, 0.99),
+      bytes = allocated * 1024 / (iterations * samples)
+    }
+    table.insert(self.results, result)
+    return result
+  end,
+
+
+  -- @method - Benchmark:skipBenchmark()
+  -- @desc - used to skip a benchmark that can't run in this environment
+  -- @param {string} reason - reason why the benchmark was skipped
+  -- @return {nil}
+  skipBenchmark = function(self, reason)
+    self.skipped = true
+    self.skipreason = reason
+  end
+
+
+}
+
+
+-- @func - BenchmarkPercentile()
+-- @desc - nearest-rank percentile of a sorted list
+-- @param {table} sorted - sorted list of numbers
+-- @param {number} p - percentile between 0 and 1
+-- @return {number} - returns the value at that percentile
+function BenchmarkPercentile(sorted, p)
+  local index = math.max(1, math.ceil(p * #sorted))
+  return sorted[math.min(index, #sorted)]
+end
@@ -0,0 +1,230 @@
+-- @class - BenchmarkSuite
+-- @desc - used instead of the TestSuite when running with --benchmark, runs
+--         the benchmark methods in /benchmarks one per frame and writes the
+--         per-op timings in the same output formats as the tests
+BenchmarkSuite = {
+
+
+  -- @method - BenchmarkSuite:new()
+  -- @desc - creates a new BenchmarkSuite object
+  -- @return {table} - returns the new BenchmarkSuite object
+  new = function(self)
+    local suite = {
+
+      -- benchmark internals
+      modules = {},
+      queue = {},
+      current = 1,
+      output = '',
+      time = 0,
+      xml = '',
+      html = '',
+      mdrows = '',
+      colormap = {
+        grey = '\27[37m',
+        green = '\27[32m',
+        yellow = '\27[33m'
+      },
+
+      -- love modules to benchmark
+      data = {},
+      graphics = {},
+      image = {},
+      physics = {},
+      thread = {}
+
+    }
+    setmetatable(suite, self)
+    self.__index = self
+    return suite
+  end,
+
+
+  -- @method - BenchmarkSuite:start()
+  -- @desc - queues every benchmark method of the given modules
+  -- @param {table} modules - list of module names to benchmark
+  -- @param {string} method - specific method to run, if nil all are run
+  -- @return {nil}
+  start = function(self, modules, method)
+    self.modules = modules
+    for m=1,#modules do
+      local module = modules[m]
+      local methods = {}
+      if method ~= nil and method ~= '' then
+        table.insert(methods, method)
+      else
+        for name,_ in pairs(self[module] or {}) do
+          table.insert(methods, name)
+        end
+        table.sort(methods)
+      end
+      for i=1,#methods do
+        table.insert(self.queue, {module = module, method = methods[i]})
+      end
+    end
+    self:log('yellow', '\nlove.benchmark.start')
+  end,
+
+
+  -- @method - BenchmarkSuite:log()
+  -- @desc - log to console with specific colors
+  -- @param {string} color - color key to use for the log
+  -- @param {string} line - message to write
+  -- @return {nil}
+  log = function(self, color, line)
+    print(self.colormap[color] .. line)
+  end,
+
+
+  -- @method - BenchmarkSuite:runSuite()
+  -- @desc - called in love.update, runs the next queued benchmark method
+  -- @return {nil}
+  runSuite = function(self)
+    if self.current > #self.queue then
+      self:printResult()
+      love.event.quit(0)
+      return
+    end
+
+    local item = self.queue[self.current]
+    self.current = self.current + 1
+    TextRun = 'love.' .. item.module .. '.' .. item.method
+
+    local benchmark = Benchmark:new(item.module, item.method)
+    local func = self[item.module][item.method]
+    local start = love.timer.getTime()
+    if func == nil then
+      benchmark.fatal = 'no benchmark named ' .. item.method
+    else
+      local ok, err = pcall(func, benchmark)
+      if not ok then
+        benchmark.fatal = tostring(err)
+      end
+    end
+    self.time = self.time + love.timer.getTime() - start
+    collectgarbage('collect')
+
+    self:addResult(benchmark)
+  end,
+
+
+  -- @method - BenchmarkSuite:addResult()
+  -- @desc - prints the results of a benchmark method and appends them to the
+  --         XML, HTML + MD output
+  -- @param {table} benchmark - the finished Benchmark object
+  -- @return {nil}
+  addResult = function(self, benchmark)
+    local name = 'love.' .. benchmark.module .. '.' .. benchmark.method
+
+    if benchmark.fatal ~= '' or benchmark.skipped then
+      local message = benchmark.fatal ~= '' and benchmark.fatal or benchmark.skipreason
+      local tag = benchmark.fatal ~= '' and 'failure' or 'skipped'
+      self:log('grey', '  ' .. name .. ' ==> ' .. string.upper(tag) .. ' - ' .. message)
+      self.xml = self.xml .. '\t\t<testcase classname="' .. benchmark.module ..
+        '" name="' .. benchmark.method .. '">\n\t\t\t<' .. tag .. ' message="' ..
+        message .. '" />\n\t\t</testcase>\n'
+      self.html = self.html .. '<tr class="yellow"><td>' .. name ..
+        '</td><td colspan="7">' .. message .. '</td></tr>'
+      self.mdrows = self.mdrows .. '| ' .. name .. ' | ' .. message .. ' | | | | | | |\n'
+      return
+    end
+
+    for r=1,#benchmark.results do
+      local result = benchmark.results[r]
+      local label = name .. ' ' .. result.label
+      local cols = {
+        string.format('%.1f', result.mean),
+        string.format('%.1f', result.p50),
+        string.format('%.1f', result.p90),
+        string.format('%.1f', result.p99),
+        string.format('%.1f', result.min),
+        string.format('%.1f', result.bytes)
+      }
+      self:log('green', '  ' .. label .. ' ==> ' .. cols[1] .. ' ns/op, p50 ' ..
+        cols[2] .. ', p90 ' .. cols[3] .. ', p99 ' .. cols[4] .. ', ' ..
+        cols[6] .. ' B/op')
+      self.xml = self.xml .. '\t\t<testcase classname="' .. benchmark.module ..
+        '" name="' .. benchmark.method .. ' ' .. result.label ..
+        '" time="' .. string.format('%.9f', result.mean / 1e9) .. '">\n' ..
+        '\t\t\t<properties>\n' ..
+        '\t\t\t\t<property name="ns_per_op" value="' .. cols[1] .. '" />\n' ..
+        '\t\t\t\t<property name="p50" value="' .. cols[2] .. '" />\n' ..
+        '\t\t\t\t<property name="p90" value="' .. cols[3] .. '" />\n' ..
+        '\t\t\t\t<property name="p99" value="' .. cols[4] .. '" />\n' ..
+        '\t\t\t\t<property name="min" value="' .. cols[5] .. '" />\n' ..
+        '\t\t\t\t<property name="bytes_per_op" value="' .. cols[6] .. '" />\n' ..
+        '\t\t\t\t<property name="iterations" value="' .. tostring(result.iterations) .. '" />\n' ..
+        '\t\t\t\t<property name="samples" value="' .. tostring(result.samples) .. '" />\n' ..
+        '\t\t\t</properties>\n\t\t</testcase>\n'
+      self.html = self.html .. '<tr><td>' .. label .. '</td><td>' ..
+        table.concat(cols, '</td><td>') .. '</td><td>' ..
+        tostring(result.iterations) .. 'x' .. tostring(result.samples) .. '</td></tr>'
+      self.mdrows = self.mdrows .. '| ' .. label .. ' | ' ..
+        table.concat(cols, ' | ') .. ' | ' .. tostring(result.iterations) ..
+        'x' .. tostring(result.samples) .. ' |\n'
+    end
+  end,
+
+
+  -- @method - BenchmarkSuite:printResult()
+  -- @desc - writes the MD, XML + HTML of the benchmark output
+  -- @return {nil}
+  printResult = function(self)
+    local finaltime = UtilTimeFormat(self.time)
+
+    local name = 'NONE'
+    local version = 'NONE'
+    local vendor = 'NONE'
+    local device = 'NONE'
+    if love.graphics then
+      name, version, vendor, device = love.graphics.getRendererInfo()
+    end
+    local renderer = name .. ' | ' .. version .. ' | ' .. vendor .. ' | ' .. device
+    local lovever = love.getVersion and string.format('%d.%d.%d', love.getVersion()) or 'NONE'
+
+    local header = {'Benchmark', 'ns/op', 'p50', 'p90', 'p99', 'min', 'B/op', 'ops'}
+
+    local md = '<!-- BENCHMARKS ' .. tostring(#self.queue) ..
+      ' || TIME ' .. finaltime .. ' -->\n\n### Info\n' ..
+      '**' .. tostring(#self.queue) .. '** benchmarks were completed in **' ..
+      finaltime .. 's**\n\n' ..
+      'LOVE: ' .. lovever .. ' | Renderer: ' .. renderer .. '\n\n' ..
+      '### Report\n' ..
+      '| ' .. table.concat(header, ' | ') .. ' |\n' ..
+      '| --- | --- | --- | --- | --- | --- | --- | --- |\n' ..
+      self.mdrows
+
+    local xml = '<testsuites name="love.benchmark" tests="' .. tostring(#self.queue) ..
+      '" time="' .. finaltime .. '">\n\t<testsuite name="love.benchmark" time="' ..
+      finaltime .. '">\n' .. self.xml .. '\t</testsuite>\n</testsuites>'
+
+    local html = [[
+      <html>
+        <head>
+          <style>
+          * { font-family: monospace; margin: 0; font-size: 11px; padding: 0; }
+          body { margin: 40px 50px 50px 50px; overflow-y: scroll; background: #222; }
+          h1 { font-weight: normal; color: #eee; font-size: 12px; border-radius: 2px; padding: 5px 0; background: #333; }
+          table { color: #eee; background: #444; margin: 5px 0 0 10px; width: calc(100% - 20px); max-width: 800px; border-collapse: collapse }
+          table thead { background: #333; }
+          table th, table td { padding: 2px 4px; font-size: 11px; }
+          tr.yellow { background: slategrey; }
+          .wrap { max-width: 800px; padding-top: 30px; margin: auto; position: relative; }
+          .renderer { color: #eee; margin: 10px; }
+          </style>
+        </head>
+        <body>]]
+    html = html .. '<div class="wrap"><h1>&nbsp;love.benchmark report - ' .. finaltime .. 's</h1>' ..
+      '<p class="renderer">LOVE: ' .. lovever .. ' | Renderer: ' .. renderer .. '</p>' ..
+      '<table><thead><tr><td>' .. table.concat(header, '</td><td>') .. '</td></tr></thead><tbody>' ..
+      self.html .. '</tbody></table></div></body></html>'
+
+    love.filesystem.write('tempoutput/' .. self.output .. '.xml', xml)
+    love.filesystem.write('tempoutput/' .. self.output .. '.html', html)
+    love.filesystem.write('tempoutput/' .. self.output .. '.md', md)
+
+    self:log('grey', '\nFINISHED - ' .. finaltime .. 's\n')
+  end
+
+
+}
@@ -2,10 +2,15 @@
 require('classes.TestSuite')
 require('classes.TestModule')
 require('classes.TestMethod')
+require('classes.BenchmarkSuite')
+require('classes.Benchmark')
 
 -- create testsuite obj
 love.test = TestSuite:new()
 
+-- create benchmark suite obj, only used when running with --benchmark
+love.benchmark = BenchmarkSuite:new()
+
 -- load test scripts if module is active
 -- this is so in future if we have per-module disabling it'll still run
 if love ~= nil then require('tests.love') end
@@ -30,6 +35,13 @@ if love.touch ~= nil then require('tests.touch') end
 if love.video ~= nil then require('tests.video') end
 if love.window ~= nil then require('tests.window') end
 
+-- load benchmark scripts if module is active
+if love.data ~= nil then require('benchmarks.data') end
+if love.graphics ~= nil then require('benchmarks.graphics') end
+if love.image ~= nil then require('benchmarks.image') end
+if love.physics ~= nil then require('benchmarks.physics') end
+if love.thread ~= nil then require('benchmarks.thread') end
+
 -- love.load
 -- load given arguments and run the test suite
 love.load = function(args)
@@ -84,13 +96,18 @@ love.load = function(args)
     'sound', 'system', 'thread', 'timer', 'touch', 'video', 'window'
   }
   GITHUB_RUNNER = false
+  BENCHMARK = false
+  for a=1,#arglist do
+    if arglist[a] == '--benchmark' then BENCHMARK = true end
+  end
+  local methods = BENCHMARK and love.benchmark or love.test
   for a=1,#arglist do
     if testcmd == '--method' then
       if module == '' and (arglist[a] == 'love' or love[ arglist[a] ] ~= nil) then 
         module = arglist[a] 
         table.insert(modules, module)
       elseif module ~= '' and love[module] ~= nil and method == '' then
-        if love.test[module][arglist[a]] ~= nil then method = arglist[a] end
+        if methods[module] ~= nil and methods[module][arglist[a]] ~= nil then method = arglist[a] end
       end
     end
     if testcmd == '--modules' then
@@ -111,6 +128,27 @@ love.load = function(args)
     end
   end
 
+  -- benchmarks run instead of the tests, for any of the modules given that
+  -- have benchmarks
+  if BENCHMARK then
+    local benchmodules = {}
+    for m=1,#modules do
+      if love.benchmark[modules[m]] ~= nil and love[modules[m]] ~= nil then
+        table.insert(benchmodules, modules[m])
+      end
+    end
+    if #benchmodules == 0 or (testcmd == '--method' and method == '') then
+      print('No valid benchmark specified')
+      love.event.quit(0)
+      return
+    end
+    love.benchmark.output = 'lovebench_' .. table.concat(benchmodules, '_')
+    if testcmd == '--all' then love.benchmark.output = 'lovebench_all' end
+    TextCommand = '--benchmark'
+    love.benchmark:start(benchmodules, method)
+    return
+  end
+
   -- method uses the module + method given
   if testcmd == '--method' then
     local testmodule = TestModule:new(module, method)
@@ -172,7 +210,11 @@ end
 -- love.update
 -- run test suite logic 
 love.update = function(delta)
-  love.test:runSuite(delta)
+  if BENCHMARK then
+    love.benchmark:runSuite()
+  else
+    love.test:runSuite(delta)
+  end
 end
 
 
@@ -43,6 +43,14 @@ love.test.audio.RecordingDevice = function(test)
   test:assertEquals(4000, device:getSampleRate(), 'check sample rate set')
   test:assertEquals(16, device:getBitDepth(), 'check bit depth set')
   test:assertEquals(1, device:getChannelCount(), 'check channel count set')
+
+  -- check reading into an existing sounddata
+  local buffer = love.sound.newSoundData(8, 4000, 16, 1)
+  test:waitFrames(10)
+  test:assertRange(device:getData(buffer), 0, 8, 'check read into buffer')
+  test:assertEquals(0, device:getData(buffer, 8), 'check read into full buffer')
+  local wrongformat = love.sound.newSoundData(8, 4000, 8, 1)
+  test:assertFalse(pcall(device.getData, device, wrongformat), 'check format must match')
   local recording = device:stop()
   test:waitFrames(10)
 
@@ -156,8 +164,22 @@ love.test.audio.Source = function(test)
   test:assertObject(queue)
   local run = queue:queue(sdata)
   test:assertTrue(run, 'check queued sound')
+  -- check 8-bit data is converted when queued
+  local sdata8 = love.sound.newSoundData(1024, 44100, 8, 1)
+  test:assertTrue(queue:queue(sdata8), 'check queued converted sound')
   queue:stop()
 
+  -- check scheduled playback
+  local scheduled = love.audio.newSource('resources/click.ogg', 'static')
+  local now = love.audio.getDeviceTime()
+  test:assertTrue(scheduled:playAt(now + 10), 'check scheduled play')
+  scheduled:stop()
+  test:assertFalse(scheduled:isPlaying(), 'check stop cancels schedule')
+  scheduled:playAt(now - 1)
+  test:assertTrue(scheduled:isPlaying(), 'check past time plays now')
+  scheduled:stopAt(now - 1)
+  test:assertFalse(scheduled:isPlaying(), 'check past time stops now')
+
   -- check making a filer
   local setfilter = stereo:setFilter({
     type = 'lowpass',
@@ -192,6 +214,36 @@ love.test.audio.Source = function(test)
   love.audio.stop(mono)
   love.audio.stop(effsource)
 
+  -- priority
+  test:assertEquals(0, stereo:getPriority(), 'check def priority')
+  stereo:setPriority(5)
+  test:assertEquals(5, stereo:getPriority(), 'check priority set')
+  test:assertEquals(5, stereo:clone():getPriority(), 'check priority cloned')
+
+  -- sources past the voice limit keep playing virtually
+  local voices = {}
+  for i=1,80 do
+    voices[i] = love.audio.newSource('resources/click.ogg', 'static')
+    voices[i]:setLooping(true)
+    voices[i]:setVolume(0.5)
+    voices[i]:play()
+  end
+  local important = love.audio.newSource('resources/click.ogg', 'static')
+  important:setPriority(10)
+  important:play()
+  local virtualcount = 0
+  for i=1,#voices do
+    test:assertTrue(voices[i]:isPlaying(), 'check voice ' .. i .. ' playing')
+    if voices[i]:isVirtual() then virtualcount = virtualcount + 1 end
+  end
+  test:assertTrue(virtualcount > 0, 'check some voices virtual')
+  test:assertFalse(important:isVirtual(), 'check important voice not stolen')
+  voices[80]:seek(0.01)
+  test:assertRange(voices[80]:tell(), 0.01, 0.02, 'check virtual seek/tell')
+  love.audio.stop(voices)
+  love.audio.stop(important)
+  test:assertFalse(voices[80]:isPlaying(), 'check virtual voice stopped')
+
 end
 
 
@@ -231,6 +283,16 @@ love.test.audio.getActiveSourceCount = function(test)
 end
 
 
+-- love.audio.getDeviceTime
+love.test.audio.getDeviceTime = function(test)
+  -- check the device clock doesn't go backwards
+  local time1 = love.audio.getDeviceTime()
+  love.timer.sleep(0.01)
+  local time2 = love.audio.getDeviceTime()
+  test:assertGreaterEqual(time1, time2, 'check clock advances')
+end
+
+
 -- love.audio.getDistanceModel
 love.test.audio.getDistanceModel = function(test)
   -- check we get a value
@@ -270,6 +332,33 @@ love.test.audio.getEffect = function(test)
 end
 
 
+-- love.audio.getEffectStats
+love.test.audio.getEffectStats = function(test)
+  local stats = love.audio.getEffectStats()
+  test:assertNotNil(stats.sceneeffects)
+  test:assertNotNil(stats.effectobjects)
+  if love.audio.isEffectsSupported() then
+    -- check sources with the same filter share one filter object
+    local before = love.audio.getEffectStats()
+    local a = love.audio.newSource('resources/click.ogg', 'static')
+    local b = love.audio.newSource('resources/click.ogg', 'static')
+    a:setFilter({ type = 'lowpass', volume = 0.3, highgain = 0.4 })
+    b:setFilter({ type = 'lowpass', volume = 0.3, highgain = 0.4 })
+    local after = love.audio.getEffectStats()
+    test:assertEquals(before.filters + 1, after.filters, 'check filter shared')
+    test:assertEquals(before.filterusers + 2, after.filterusers, 'check filter users')
+    -- check released filter objects are kept for reuse
+    a:setFilter()
+    b:setFilter()
+    local released = love.audio.getEffectStats()
+    test:assertEquals(before.filters, released.filters, 'check filter released')
+    test:assertEquals(after.filterobjects, released.filterobjects, 'check filter object pooled')
+    a:release()
+    b:release()
+  end
+end
+
+
 -- love.audio.getMaxSceneEffects
 -- @NOTE feel like this is platform specific number so best we can do is a nil?
 love.test.audio.getMaxSceneEffects = function(test)
@@ -299,6 +388,26 @@ love.test.audio.getOrientation = function(test)
 end
 
 
+-- love.audio.getOutputLatency
+love.test.audio.getOutputLatency = function(test)
+  -- check latency is either unknown or a positive duration
+  local latency = love.audio.getOutputLatency()
+  if latency ~= nil then
+    test:assertGreaterEqual(0, latency, 'check latency')
+  end
+end
+
+
+-- love.audio.getOutputPeriodSize
+love.test.audio.getOutputPeriodSize = function(test)
+  -- check period size is either unknown or at least one sample frame
+  local period = love.audio.getOutputPeriodSize()
+  if period ~= nil then
+    test:assertGreaterEqual(1, period, 'check period size')
+  end
+end
+
+
 -- love.audio.getPlaybackDevice
 love.test.audio.getPlaybackDevice = function(test)
   test:assertNotNil(love.audio.getPlaybackDevice)
@@ -332,6 +441,33 @@ love.test.audio.getRecordingDevices = function(test)
 end
 
 
+-- love.audio.getSourceCacheLimit
+love.test.audio.getSourceCacheLimit = function(test)
+  -- check default value is a usable size
+  test:assertGreaterEqual(0, love.audio.getSourceCacheLimit(), 'check default')
+end
+
+
+-- love.audio.getStats
+love.test.audio.getStats = function(test)
+  local source = love.audio.newSource('resources/tone.ogg', 'stream')
+  source:play()
+  local stats = love.audio.getStats()
+  test:assertGreaterEqual(1, stats.activesources + stats.virtualsources, 'check playing source counted')
+  test:assertGreaterEqual(stats.activesources, stats.maxsources, 'check max sources')
+  test:assertGreaterEqual(0, stats.underruns, 'check underruns')
+  test:assertGreaterEqual(stats.updatetime, stats.maxupdatetime, 'check update time')
+  test:assertGreaterEqual(stats.wakeupjitter, stats.maxwakeupjitter, 'check wakeup jitter')
+  test:assertGreaterEqual(0, source:getUnderrunCount(), 'check source underruns')
+  -- check an existing table is filled in
+  local t = {}
+  test:assertEquals(t, love.audio.getStats(t), 'check table reused')
+  test:assertNotNil(t.decodedchunks)
+  source:stop()
+  source:release()
+end
+
+
 -- love.audio.getVelocity
 love.test.audio.getVelocity = function(test)
   -- check getting values matches what was set
@@ -369,6 +505,23 @@ end
 love.test.audio.newSource = function(test)
   test:assertObject(love.audio.newSource('resources/click.ogg', 'static'))
   test:assertObject(love.audio.newSource('resources/click.ogg', 'stream'))
+  -- check static sources from the same file share data but not state
+  local source1 = love.audio.newSource('resources/click.ogg', 'static')
+  local source2 = love.audio.newSource('resources/click.ogg', 'static')
+  test:assertNotEquals(source1, source2, 'check separate objects')
+  test:assertEquals(source1:getDuration('samples'), source2:getDuration('samples'), 'check same data')
+  source1:setVolume(0.5)
+  test:assertEquals(1, source2:getVolume(), 'check separate state')
+  -- check compressed sources decode the same data as static ones
+  local compressed = love.audio.newSource('resources/click.ogg', 'compressed')
+  test:assertObject(compressed)
+  test:assertEquals('compressed', compressed:getType(), 'check compressed type')
+  test:assertEquals(source1:getDuration('samples'), compressed:getDuration('samples'), 'check compressed duration')
+  local compressedclone = compressed:clone()
+  test:assertEquals('compressed', compressedclone:getType(), 'check cloned compressed type')
+  compressed:play()
+  test:assertTrue(compressed:isPlaying(), 'check compressed playing')
+  compressed:stop()
 end
 
 
@@ -505,6 +658,53 @@ love.test.audio.setPosition = function(test)
 end
 
 
+-- love.audio.setPositions
+love.test.audio.setPositions = function(test)
+  local a = love.audio.newSource('resources/clickmono.ogg', 'static')
+  local b = love.audio.newSource('resources/clickmono.ogg', 'static')
+  -- check flat tables set each source in order
+  love.audio.setPositions({a, b}, {1, 2, 3, 4, 5, 6}, {7, 8, 9, 10, 11, 12})
+  local x, y, z = b:getPosition()
+  test:assertEquals(4, x, 'check x position')
+  test:assertEquals(5, y, 'check y position')
+  test:assertEquals(6, z, 'check z position')
+  x, y, z = a:getVelocity()
+  test:assertEquals(7, x, 'check x velocity')
+  test:assertEquals(8, y, 'check y velocity')
+  test:assertEquals(9, z, 'check z velocity')
+  -- check float data works too, and velocities are left alone
+  local packed = love.data.pack('data', 'ffffff', -1, -2, -3, -4, -5, -6)
+  love.audio.setPositions({a, b}, packed)
+  x, y, z = a:getPosition()
+  test:assertEquals(-1, x, 'check x position from data')
+  test:assertEquals(-3, z, 'check z position from data')
+  x, y, z = b:getVelocity()
+  test:assertEquals(10, x, 'check velocity kept')
+  -- check short input and stereo sources are rejected
+  local ok = pcall(love.audio.setPositions, {a, b}, {1, 2, 3})
+  test:assertFalse(ok, 'check short table errors')
+  local stereo = love.audio.newSource('resources/click.ogg', 'static')
+  ok = pcall(love.audio.setPositions, {stereo}, {1, 2, 3})
+  test:assertFalse(ok, 'check stereo source errors')
+  a:release()
+  b:release()
+  stereo:release()
+end
+
+
+-- love.audio.setSourceCacheLimit
+love.test.audio.setSourceCacheLimit = function(test)
+  local limit = love.audio.getSourceCacheLimit()
+  -- check setting value is returned properly
+  love.audio.setSourceCacheLimit(0)
+  test:assertEquals(0, love.audio.getSourceCacheLimit(), 'check set to 0')
+  -- check cached sources still load with the cache disabled
+  test:assertObject(love.audio.newSource('resources/click.ogg', 'static'))
+  love.audio.setSourceCacheLimit(limit)
+  test:assertEquals(limit, love.audio.getSourceCacheLimit(), 'check restored')
+end
+
+
 -- love.audio.setVelocity
 love.test.audio.setVelocity = function(test)
   -- check setting velocity vals are returned
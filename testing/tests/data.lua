@@ -37,6 +37,44 @@ love.test.data.ByteData = function(test)
   data:setString('love!', 5)
   test:assertEquals('hellolove!', data:getString(), 'check change string')
 
+  -- check writing and reading typed arrays, including at unaligned offsets
+  local array = love.data.newByteData(64)
+  array:setArray('float', 1, {1.5, -2, 3.25})
+  local floats = array:getArray('float', 1, 3)
+  test:assertEquals(3, #floats, 'check float array length')
+  test:assertEquals(1.5, floats[1], 'check float array 1')
+  test:assertEquals(-2, floats[2], 'check float array 2')
+  test:assertEquals(3.25, floats[3], 'check float array 3')
+  test:assertEquals(-2, array:getFloat(5), 'check float array matches getFloat')
+  array:setArray('int16', 20, {10, 20, 30, 40}, 2, 2)
+  test:assertEquals(20, array:getInt16(20), 'check int16 array start index')
+  test:assertEquals(30, array:getInt16(22), 'check int16 array count')
+  local filled = {7, 8}
+  array:getArray('int16', 20, 2, filled, 3)
+  test:assertEquals(4, #filled, 'check array into existing table')
+  test:assertEquals(30, filled[4], 'check array into existing table value')
+  local ok = pcall(array.setArray, array, 'double', 60, {1})
+  test:assertFalse(ok, 'check array out of bounds')
+
+  -- check copying ranges between data
+  array:copyFrom(data, 40, 5, 5)
+  test:assertEquals('love!', array:getString(40, 5), 'check copy from data')
+  array:copyFrom(array, 42, 40, 5)
+  test:assertEquals('lolove!', array:getString(40, 7), 'check overlapping copy')
+
+  -- check atomic operations
+  array:atomicStore('int32', 0, 10)
+  test:assertEquals(10, array:atomicLoad('int32', 0), 'check atomic store')
+  test:assertEquals(10, array:atomicAdd('int32', 0, 5), 'check atomic add')
+  local swapped, old = array:atomicCompareExchange('int32', 0, 10, 20)
+  test:assertFalse(swapped, 'check failed exchange')
+  test:assertEquals(15, old, 'check failed exchange value')
+  swapped = array:atomicCompareExchange('int32', 0, 15, 20)
+  test:assertTrue(swapped, 'check exchange')
+  test:assertEquals(20, array:getInt32(0), 'check exchanged value')
+  test:assertFalse(pcall(array.atomicLoad, array, 'int32', 2), 'check misaligned offset')
+  test:assertFalse(pcall(array.atomicLoad, array, 'float', 0), 'check non-integer type')
+
 end
 
 
@@ -58,6 +96,94 @@ love.test.data.CompressedData = function(test)
   test:assertEquals('zlib', clonedcdata:getFormat())
   test:assertEquals(18, clonedcdata:getSize())
   test:assertEquals('helloworld', love.data.decompress('data', clonedcdata):getString())
+  test:assertEquals(10, clonedcdata:getDecompressedSize(), 'check decompressed size')
+
+end
+
+
+-- CompressionStream (love.data.newCompressionStream)
+love.test.data.CompressionStream = function(test)
+
+  -- compress in pieces, flushing part way through
+  local compressor = love.data.newCompressionStream('gzip', 6)
+  test:assertObject(compressor)
+  test:assertEquals('gzip', compressor:getFormat(), 'check format used')
+  test:assertTrue(compressor:isCompressing(), 'check compressing')
+  local input = string.rep('helloworld', 1000)
+  compressor:push(input:sub(1, 4000))
+  compressor:flush()
+  local compressed = compressor:pull()
+  test:assertGreaterEqual(1, #compressed, 'check flushed output')
+  compressor:push(love.data.newByteData(input:sub(4001)), true)
+  test:assertTrue(compressor:isFinished(), 'check compressor finished')
+  compressed = compressed .. compressor:pull('data'):getString()
+  test:assertEquals(0, compressor:getPendingSize(), 'check nothing pending')
+
+  -- the result is a normal gzip stream
+  test:assertEquals(input, love.data.decompress('string', 'gzip', compressed), 'check whole decompress')
+
+  -- decompress in pieces
+  local decompressor = love.data.newDecompressionStream('gzip')
+  test:assertObject(decompressor)
+  local output = ''
+  for i=1,#compressed,7 do
+    decompressor:push(compressed:sub(i, i + 6))
+    output = output .. decompressor:pull()
+  end
+  test:assertTrue(decompressor:isFinished(), 'check decompressor finished')
+  test:assertEquals(input, output, 'check stream decompress')
+  local totalin, totalout = decompressor:getTotals()
+  test:assertEquals(#compressed, totalin, 'check total in')
+  test:assertEquals(#input, totalout, 'check total out')
+
+  -- truncated streams are an error
+  local truncated = love.data.newDecompressionStream('gzip')
+  truncated:push(compressed:sub(1, 10))
+  local ok = pcall(truncated.finish, truncated)
+  test:assertEquals(false, ok, 'check truncated stream')
+
+end
+
+
+-- Hasher (love.data.newHasher)
+love.test.data.Hasher = function(test)
+
+  -- hashing in pieces matches hashing all at once
+  local hasher = love.data.newHasher('xxh64')
+  test:assertObject(hasher)
+  test:assertEquals('xxh64', hasher:getFunction(), 'check function used')
+  hasher:update('hello')
+  hasher:update(love.data.newByteData('world'))
+  test:assertEquals(10, hasher:getSize(), 'check size')
+  test:assertEquals(love.data.hash('string', 'xxh64', 'helloworld'), hasher:finalize(), 'check incremental hash')
+  test:assertEquals('80111601aa1c6a4f', love.data.encode('string', 'hex', hasher:finalize('data')), 'check data container')
+
+  -- reset starts over
+  hasher:reset()
+  hasher:update('helloworld')
+  test:assertEquals(love.data.hash('string', 'xxh64', 'helloworld'), hasher:finalize(), 'check reset')
+
+  -- seeds change the result
+  local seeded = love.data.newHasher('xxh64', 42)
+  seeded:update('helloworld')
+  test:assertEquals('2f4a76744deec887', love.data.encode('string', 'hex', seeded:finalize()), 'check seeded hash')
+
+  local xxh32 = love.data.newHasher('xxh32')
+  xxh32:update('helloworld')
+  test:assertEquals(love.data.hash('string', 'xxh32', 'helloworld'), xxh32:finalize(), 'check xxh32 hash')
+
+  -- cryptographic functions can be incremental too, across block boundaries
+  local input = string.rep('helloworld', 100)
+  for _, fn in ipairs({ 'md5', 'sha1', 'sha224', 'sha256', 'sha384', 'sha512' }) do
+    local crypto = love.data.newHasher(fn)
+    for i=1,#input,37 do
+      crypto:update(input:sub(i, i + 36))
+    end
+    test:assertEquals(love.data.hash('string', fn, input), crypto:finalize(), 'check incremental ' .. fn)
+  end
+
+  -- only the xxHash functions can be seeded
+  test:assertEquals(false, pcall(love.data.newHasher, 'sha256', 1), 'check unsupported seed')
 
 end
 
@@ -123,6 +249,23 @@ love.test.data.decode = function(test)
   test:assertEquals('helloworld', love.data.decode('string', 'hex', str2), 'check string hex decode')
   test:assertEquals(love.data.newByteData('helloworld'):getString(), love.data.decode('data', 'base64', str3):getString(), 'check data base64 decode')
   test:assertEquals(love.data.newByteData('helloworld'):getString(), love.data.decode('data', 'hex', str4):getString(), 'check data hex decode')
+  -- check decoding into an existing data at an offset
+  local dest = love.data.newByteData(16)
+  test:assertEquals(10, love.data.decode(dest, 'base64', str1, 4), 'check base64 decode into data size')
+  test:assertEquals('helloworld', dest:getString(4, 10), 'check base64 decode into data')
+  test:assertEquals(10, love.data.decode(dest, 'hex', str2), 'check hex decode into data size')
+  test:assertEquals('helloworld', dest:getString(0, 10), 'check hex decode into data')
+  local ok = pcall(love.data.decode, dest, 'hex', str2, 8)
+  test:assertFalse(ok, 'check decode into data too small')
+  -- check large round trips, which go through the vectorized paths
+  local bytes = {}
+  for i=1,4099 do
+    bytes[i] = string.char((i * 7) % 256)
+  end
+  local large = table.concat(bytes)
+  test:assertEquals(large, love.data.decode('string', 'base64', love.data.encode('string', 'base64', large, 76)), 'check large base64 round trip')
+  test:assertEquals(large, love.data.decode('string', 'hex', love.data.encode('string', 'hex', large)), 'check large hex round trip')
+  test:assertEquals(large, love.data.decode('string', 'hex', string.upper(love.data.encode('string', 'hex', large))), 'check large uppercase hex decode')
 end
 
 
@@ -166,6 +309,15 @@ love.test.data.decompress = function(test)
   test:assertEquals(love.data.newByteData('helloworld'):getString(), love.data.decompress('data', 'gzip', str16):getString(), 'check data glib decompress')
   test:assertEquals(love.data.newByteData('helloworld'):getString(), love.data.decompress('data', 'gzip', str17):getString(), 'check data glib decompress')
   test:assertEquals(love.data.newByteData('helloworld'):getString(), love.data.decompress('data', 'gzip', str18):getString(), 'check data glib decompress')
+  -- an optional size hint for the decompressed data
+  test:assertEquals('helloworld', love.data.decompress('string', 'zlib', str4, 10), 'check zlib decompress with size hint')
+  test:assertEquals('helloworld', love.data.decompress('string', 'zlib', str4, 2), 'check zlib decompress with small size hint')
+  -- large lz4 inputs are split into blocks, and levels above 9 use slower HC modes
+  local large = string.rep('helloworld', 500000) .. 'end'
+  local blocks = love.data.compress('data', 'lz4', large, -1)
+  test:assertEquals(#large, #love.data.decompress('string', blocks), 'check lz4 block decompress size')
+  test:assertEquals(large, love.data.decompress('string', 'lz4', blocks:getString()), 'check lz4 block decompress')
+  test:assertEquals(large, love.data.decompress('string', 'lz4', love.data.compress('string', 'lz4', large, 12)), 'check lz4 hc block decompress')
 end
 
 
@@ -189,7 +341,25 @@ love.test.data.encode = function(test)
       test:assertNotEquals(nil, encodes[e][1]:type(), 'check has :type()')
     end
   end
+  -- check encoding into an existing data at an offset
+  local dest = love.data.newByteData(32)
+  test:assertEquals(16, love.data.encode(dest, 'base64', 'helloworld', 0, 2), 'check base64 encode into data size')
+  test:assertEquals('aGVsbG93b3JsZA==', dest:getString(2, 16), 'check base64 encode into data')
+  test:assertEquals(20, love.data.encode(dest, 'hex', 'helloworld'), 'check hex encode into data size')
+  test:assertEquals('68656c6c6f776f726c64', dest:getString(0, 20), 'check hex encode into data')
+  local ok = pcall(love.data.encode, dest, 'hex', 'helloworld', 0, 16)
+  test:assertFalse(ok, 'check encode into data too small')
+
+end
+
 
+-- love.data.getEncodedSize
+love.test.data.getEncodedSize = function(test)
+  test:assertEquals(16, love.data.getEncodedSize('base64', 10), 'check base64 size')
+  test:assertEquals(20, love.data.getEncodedSize('base64', 10, 4), 'check base64 size with lines')
+  test:assertEquals(20, love.data.getEncodedSize('hex', 10), 'check hex size')
+  local str = love.data.encode('string', 'base64', string.rep('a', 100), 8)
+  test:assertEquals(#str, love.data.getEncodedSize('base64', 100, 8), 'check base64 size matches encode')
 end
 
 
@@ -234,6 +404,9 @@ love.test.data.hash = function(test)
   test:assertEquals('936a185caaa266bb9cbe981e9e05cb78cd732b0b3280eb944412bb6f8f8f07af', love.data.encode("string", "hex", data4), 'check data sha256 encode')
   test:assertEquals('97982a5b1414b9078103a1c008c4e3526c27b41cdbcf80790560a40f2a9bf2ed4427ab1428789915ed4b3dc07c454bd9', love.data.encode("string", "hex", data5), 'check data sha384 encode')
   test:assertEquals('1594244d52f2d8c12b142bb61f47bc2eaf503d6d9ca8480cae9fcf112f66e4967dc5e8fa98285e36db8af1b8ffa8b84cb15e0fbcf836c3deb803c13f37659a60', love.data.encode("string", "hex", data6), 'check data sha512 encode')
+    -- test non-cryptographic hashes
+  test:assertEquals('2362e202', love.data.encode("string", "hex", love.data.hash('string', 'xxh32', 'helloworld')), 'check string xxh32 encode')
+  test:assertEquals('80111601aa1c6a4f', love.data.encode("string", "hex", love.data.hash('data', 'xxh64', 'helloworld')), 'check data xxh64 encode')
 end
 
 
@@ -264,6 +437,29 @@ love.test.data.pack = function(test)
 end
 
 
+-- love.data.trainDictionary
+love.test.data.trainDictionary = function(test)
+  if not pcall(love.data.compress, 'string', 'zstd', 'helloworld') then
+    return test:skipTest('LOVE was built without Zstandard support')
+  end
+  local samples = {}
+  for i=1,200 do
+    samples[i] = '{"id":' .. i .. ',"name":"player' .. i .. '","score":' .. (i*37 % 1000) .. ',"alive":true}'
+  end
+  local dictionary = love.data.trainDictionary('string', 'zstd', samples, 1024)
+  test:assertGreaterEqual(1, #dictionary, 'check dictionary trained')
+  local message = '{"id":999,"name":"player999","score":123,"alive":true}'
+  local plain = love.data.compress('string', 'zstd', message)
+  local compressed = love.data.compress('string', 'zstd', message, -1, dictionary)
+  test:assertGreaterEqual(#compressed, #plain, 'check dictionary helps')
+  test:assertEquals(message, love.data.decompress('string', 'zstd', compressed, nil, dictionary), 'check dictionary round trip')
+  local cdata = love.data.compress('data', 'zstd', message, 9, dictionary)
+  test:assertEquals(message, love.data.decompress('string', cdata, dictionary), 'check compressed data round trip')
+  test:assertEquals(false, pcall(love.data.decompress, 'string', 'zstd', compressed), 'check dictionary required')
+  test:assertEquals(false, pcall(love.data.compress, 'string', 'zlib', message, -1, dictionary), 'check zlib rejects dictionary')
+end
+
+
 -- love.data.unpack
 love.test.data.unpack = function(test)
   local packed1 = love.data.pack('string', '>s5s4I3', 'hello', 'love', 100)
@@ -39,6 +39,30 @@ love.test.event.poll = function(test)
 end
 
 
+-- love.event.pollMany
+love.test.event.pollMany = function(test)
+  -- push some events first
+  love.event.push('test', 1, 2, 3)
+  love.event.push('test', 4)
+  love.event.push('test', 5, 6)
+  -- check events are returned as tables
+  local events, count = love.event.pollMany(2)
+  test:assertEquals(2, count, 'check max events')
+  test:assertEquals('test', events[1][1], 'check event name')
+  test:assertEquals(3, events[1][4], 'check event args')
+  test:assertEquals(nil, events[2][3], 'check event arg count')
+  -- check tables are reused and old values cleared
+  local first = events[1]
+  local same, count2 = love.event.pollMany(nil, events)
+  test:assertEquals(events, same, 'check table reused')
+  test:assertEquals(1, count2, 'check remaining events')
+  test:assertEquals(first, events[1], 'check event table reused')
+  test:assertEquals(6, events[1][3], 'check new args')
+  test:assertEquals(nil, events[1][4], 'check old args cleared')
+  test:assertEquals(nil, events[2], 'check old events cleared')
+end
+
+
 -- love.event.pump
 -- @NOTE dont think can really test as internally used
 love.test.event.pump = function(test)
@@ -60,6 +84,25 @@ love.test.event.push = function(test)
     end
   end
   test:assertEquals(12, count, 'check total events')
+
+  -- check events pushed from another thread arrive in order
+  local thread = love.thread.newThread([[
+    require('love.event')
+    for i=1,100 do love.event.push('threaded', i) end
+  ]])
+  thread:start()
+  thread:wait()
+  local last = 0
+  local ordered = true
+  love.event.pump()
+  for n, a in love.event.poll() do
+    if n == 'threaded' then
+      if a ~= last + 1 then ordered = false end
+      last = a
+    end
+  end
+  test:assertTrue(ordered, 'check threaded events order')
+  test:assertEquals(100, last, 'check threaded events count')
 end
 
 
@@ -73,8 +116,42 @@ love.test.event.quit = function(test)
 end
 
 
+-- love.event.setCoalesced
+love.test.event.setCoalesced = function(test)
+  for _, name in ipairs({'mousemoved', 'touchmoved'}) do
+    test:assertFalse(love.event.isCoalesced(name), 'check ' .. name .. ' off by default')
+    love.event.setCoalesced(name, true)
+    test:assertTrue(love.event.isCoalesced(name), 'check ' .. name .. ' enabled')
+    love.event.setCoalesced(name, false)
+    test:assertFalse(love.event.isCoalesced(name), 'check ' .. name .. ' disabled')
+  end
+  local ok = pcall(love.event.setCoalesced, 'keypressed', true)
+  test:assertFalse(ok, 'check other events can not be coalesced')
+end
+
+
 -- love.event.wait
--- @NOTE not sure best way to test this one
 love.test.event.wait = function(test)
-  test:skipTest('used internally')
+  love.event.clear()
+  -- times out when there's nothing to wait for
+  local starttime = love.timer.getTime()
+  local name = love.event.wait(0.05, {})
+  test:assertEquals(nil, name, 'check timeout returns nothing')
+  test:assertRange(love.timer.getTime() - starttime, 0.04, 1, 'check timeout waited')
+  -- returns straight away for a pushed event
+  love.event.push('test', 1)
+  local name, a = love.event.wait(1)
+  test:assertEquals('test', name, 'check pushed event returned')
+  test:assertEquals(1, a, 'check pushed event arg')
+  -- returns straight away when a watched channel has a value
+  local channel = love.thread.newChannel()
+  channel:push(1)
+  starttime = love.timer.getTime()
+  name = love.event.wait(1, {channel})
+  test:assertEquals(nil, name, 'check channel wake returns nothing')
+  test:assertRange(love.timer.getTime() - starttime, 0, 0.5, 'check channel wake is fast')
+  -- bad sources error
+  local ok = pcall(love.event.wait, 0, {'nope'})
+  test:assertFalse(ok, 'check invalid source errors')
+  love.event.clear()
 end
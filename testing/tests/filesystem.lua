@@ -75,6 +75,20 @@ love.test.filesystem.File = function(test)
   test:assertEquals(counter, 15)
   file1:close()
 
+  -- test read-ahead buffering
+  file1:open('w')
+  test:assertFalse(file1:setBuffer('readahead'), 'check no read-ahead in write mode')
+  file1:close()
+  file1:open('r')
+  test:assertTrue(file1:setBuffer('readahead', 4), 'check read-ahead in read mode')
+  test:assertEquals('readahead', file1:getBuffer())
+  test:assertEquals('repl', file1:read(4), 'check read-ahead read')
+  test:assertEquals(4, file1:tell(), 'check read-ahead tell')
+  file1:seek(8)
+  test:assertEquals('content', file1:read(), 'check read-ahead seek')
+  test:assertTrue(file1:isEOF(), 'check read-ahead eof')
+  file1:close()
+
 end
 
 
@@ -100,6 +114,49 @@ love.test.filesystem.FileData = function(test)
 end
 
 
+-- FileRequest (love.filesystem.readAsync)
+love.test.filesystem.FileRequest = function(test)
+
+  -- create a request and wait for it
+  local request = love.filesystem.readAsync('resources/test.txt', 2)
+  test:assertObject(request)
+  test:assertEquals('resources/test.txt', request:getFilename(), 'check filename')
+  test:assertEquals(2, request:getPriority(), 'check priority')
+  request:setPriority(5)
+  test:assertEquals(5, request:getPriority(), 'check set priority')
+
+  local data = request:wait()
+  test:assertTrue(request:isDone(), 'check done')
+  test:assertEquals('complete', request:getStatus(), 'check status')
+  test:assertEquals('helloworld', data:getString(), 'check data')
+  test:assertEquals('helloworld', request:getData():getString(), 'check get data')
+  test:assertEquals(nil, request:getError(), 'check no error')
+
+  -- canceling a finished request does nothing
+  request:cancel()
+  test:assertEquals('complete', request:getStatus(), 'check cancel after completion')
+
+  -- check a missing file fails with an error
+  local missing = love.filesystem.readAsync('resources/doesnotexist.txt')
+  local nodata, err = missing:wait()
+  test:assertEquals(nil, nodata, 'check missing data')
+  test:assertEquals('failed', missing:getStatus(), 'check missing status')
+  test:assertNotNil(err)
+  test:assertNotNil(missing:getError())
+
+  -- check writes complete with the data written
+  local write = love.filesystem.writeAsync('filerequest.txt', 'helloworld', true)
+  test:assertTrue(write:isWrite(), 'check write request')
+  test:assertFalse(request:isWrite(), 'check read request')
+  test:assertEquals(true, write:wait(), 'check write result')
+  test:assertEquals('complete', write:getStatus(), 'check write status')
+  test:assertEquals(nil, write:getData(), 'check write has no data')
+  test:assertEquals('helloworld', love.filesystem.read('filerequest.txt'), 'check written')
+  love.filesystem.remove('filerequest.txt')
+
+end
+
+
 --------------------------------------------------------------------------------
 --------------------------------------------------------------------------------
 ------------------------------------METHODS-------------------------------------
@@ -162,6 +219,35 @@ love.test.filesystem.getCRequirePath = function(test)
 end
 
 
+-- love.filesystem.getDirectoryInfo
+love.test.filesystem.getDirectoryInfo = function(test)
+  -- create a dir + subdir with 2 files
+  love.filesystem.createDirectory('foo/bar')
+  love.filesystem.write('foo/file1.txt', 'file1')
+  love.filesystem.write('foo/bar/file22.txt', 'file22')
+  -- check the direct children and their info match getInfo
+  local items = love.filesystem.getDirectoryInfo('foo')
+  test:assertEquals(2, #items, 'check item count')
+  test:assertEquals('bar', items[1].name, 'check sorted names')
+  test:assertEquals('directory', items[1].type, 'check dir type')
+  test:assertEquals('file1.txt', items[2].name, 'check file name')
+  test:assertEquals('file', items[2].type, 'check file type')
+  test:assertEquals(5, items[2].size, 'check file size')
+  test:assertEquals(love.filesystem.getInfo('foo/file1.txt').modtime, items[2].modtime, 'check modtime')
+  -- check recursive mode includes subdirectory contents
+  items = love.filesystem.getDirectoryInfo('foo', true)
+  test:assertEquals(3, #items, 'check recursive item count')
+  test:assertEquals('bar/file22.txt', items[3].name, 'check nested name')
+  test:assertEquals(6, items[3].size, 'check nested size')
+  test:assertEquals(0, #love.filesystem.getDirectoryInfo('foo/missing'), 'check missing dir')
+  -- cleanup
+  love.filesystem.remove('foo/file1.txt')
+  love.filesystem.remove('foo/bar/file22.txt')
+  love.filesystem.remove('foo/bar')
+  love.filesystem.remove('foo')
+end
+
+
 -- love.filesystem.getDirectoryItems
 love.test.filesystem.getDirectoryItems = function(test)
   -- create a dir + subdir with 2 files
@@ -286,6 +372,14 @@ love.test.filesystem.getInfo = function(test)
   test:assertEquals(love.filesystem.getInfo('foo/bar/file2.txt').size, 5, 'check info size match')
   test:assertFalse(love.filesystem.getInfo('foo/bar/file2.txt').readonly, 'check readonly')
   -- @TODO test modified timestamp from info.modtime?
+  -- check cached lookups are updated when files are written and removed
+  test:assertEquals(nil, love.filesystem.getInfo('foo/bar/file3.txt'), 'check missing file')
+  love.filesystem.write('foo/bar/file3.txt', 'file3')
+  test:assertNotEquals(nil, love.filesystem.getInfo('foo/bar/file3.txt'), 'check written file')
+  love.filesystem.append('foo/bar/file3.txt', 'more')
+  test:assertEquals(9, love.filesystem.getInfo('foo/bar/file3.txt').size, 'check appended size')
+  love.filesystem.remove('foo/bar/file3.txt')
+  test:assertEquals(nil, love.filesystem.getInfo('foo/bar/file3.txt'), 'check removed file')
   -- cleanup
   love.filesystem.remove('foo/bar/file2.txt')
   love.filesystem.remove('foo/bar')
@@ -486,6 +580,26 @@ love.test.filesystem.read = function(test)
 end
 
 
+-- love.filesystem.readAsync
+love.test.filesystem.readAsync = function(test)
+  -- queue a few reads, cancel one, and wait for the rest
+  local requests = {}
+  for i=1,4 do
+    requests[i] = love.filesystem.readAsync('resources/test.txt', i)
+  end
+  local canceled = love.filesystem.readAsync('resources/test.txt', -1)
+  canceled:cancel()
+  for i=1,4 do
+    local data = requests[i]:wait()
+    test:assertEquals('helloworld', data:getString(), 'check request ' .. tostring(i))
+  end
+  canceled:wait()
+  test:assertTrue(canceled:isDone(), 'check canceled is done')
+  test:assertEquals('canceled', canceled:getStatus(), 'check canceled status')
+  test:assertEquals(nil, canceled:getData(), 'check canceled data')
+end
+
+
 -- love.filesystem.remove
 love.test.filesystem.remove = function(test)
   -- create a dir + subdir with a file
@@ -501,6 +615,35 @@ love.test.filesystem.remove = function(test)
 end
 
 
+-- love.filesystem.setBytecodeCacheEnabled
+love.test.filesystem.setBytecodeCacheEnabled = function(test)
+  local enabled = love.filesystem.isBytecodeCacheEnabled()
+  love.filesystem.setBytecodeCacheEnabled(true)
+  test:assertTrue(love.filesystem.isBytecodeCacheEnabled(), 'check enabled')
+  love.filesystem.write('bytecodecache.lua', 'return 1 + 2')
+  -- first load compiles and writes the cache, second load reads it
+  local chunk1, errormsg1 = love.filesystem.load('bytecodecache.lua')
+  test:assertEquals(nil, errormsg1, 'check no error message')
+  test:assertEquals(3, chunk1(), 'check compiled chunk runs')
+  local items = love.filesystem.getDirectoryItems('.bytecodecache')
+  test:assertGreaterEqual(1, #items, 'check cache file written')
+  local chunk2, errormsg2 = love.filesystem.load('bytecodecache.lua')
+  test:assertEquals(nil, errormsg2, 'check no error message')
+  test:assertEquals(3, chunk2(), 'check cached chunk runs')
+  -- changing the source must not use the old bytecode
+  love.filesystem.write('bytecodecache.lua', 'return 4 + 5')
+  local chunk3 = love.filesystem.load('bytecodecache.lua')
+  test:assertEquals(9, chunk3(), 'check changed file is recompiled')
+  -- cleanup
+  love.filesystem.setBytecodeCacheEnabled(enabled)
+  for _, item in ipairs(love.filesystem.getDirectoryItems('.bytecodecache')) do
+    love.filesystem.remove('.bytecodecache/' .. item)
+  end
+  love.filesystem.remove('.bytecodecache')
+  love.filesystem.remove('bytecodecache.lua')
+end
+
+
 -- love.filesystem.setCRequirePath
 love.test.filesystem.setCRequirePath = function(test)
   -- check setting path val is returned
@@ -554,6 +697,34 @@ love.test.filesystem.unmount = function(test)
 end
 
 
+-- love.filesystem.unwatch
+love.test.filesystem.unwatch = function(test)
+  love.filesystem.createDirectory('foo')
+  love.filesystem.watch('foo')
+  -- check only watched paths can be unwatched
+  test:assertEquals(true, love.filesystem.unwatch('foo'), 'check unwatched')
+  test:assertEquals(false, love.filesystem.unwatch('foo'), 'check already unwatched')
+  -- cleanup
+  love.filesystem.remove('foo')
+end
+
+
+-- love.filesystem.watch
+love.test.filesystem.watch = function(test)
+  love.filesystem.createDirectory('foo')
+  love.filesystem.write('foo/file1.txt', 'file1')
+  -- check dirs and single files can be watched, but missing paths can't
+  test:assertEquals(true, love.filesystem.watch('foo'), 'check watch dir')
+  test:assertEquals(true, love.filesystem.watch('foo/file1.txt'), 'check watch file')
+  test:assertEquals(false, love.filesystem.watch('foo/missing'), 'check watch missing')
+  -- cleanup
+  love.filesystem.unwatch('foo')
+  love.filesystem.unwatch('foo/file1.txt')
+  love.filesystem.remove('foo/file1.txt')
+  love.filesystem.remove('foo')
+end
+
+
 -- love.filesystem.write
 love.test.filesystem.write = function(test)
   -- check writing a bunch of files matches whats read back
@@ -563,8 +734,44 @@ love.test.filesystem.write = function(test)
   test:assertEquals('helloworld', love.filesystem.read('test1.txt'), 'check read file')
   test:assertEquals('helloworld', love.filesystem.read('test2.txt'), 'check read all')
   test:assertEquals('hello', love.filesystem.read('test3.txt'), 'check read partial')
+  -- check atomic writes replace the file and leave no temp files behind
+  local items = #love.filesystem.getDirectoryItems('')
+  love.filesystem.write('test1.txt', 'atomic', nil, true)
+  test:assertEquals('atomic', love.filesystem.read('test1.txt'), 'check atomic write')
+  test:assertEquals(items, #love.filesystem.getDirectoryItems(''), 'check no temp files')
   -- cleanup
   love.filesystem.remove('test1.txt')
   love.filesystem.remove('test2.txt')
   love.filesystem.remove('test3.txt')
 end
+
+
+-- love.filesystem.writeArchive
+love.test.filesystem.writeArchive = function(test)
+  local repeated = string.rep('abcd', 1000)
+  for _, compression in ipairs({'none', 'lz4'}) do
+    local files = {
+      ['hello.txt'] = 'helloworld',
+      ['dir/repeated.txt'] = repeated,
+      ['dir/sub/data.bin'] = love.data.newByteData('bytes')
+    }
+    test:assertTrue(love.filesystem.writeArchive('test.lpak', files, compression), 'check written')
+    -- check the archive mounts like a zip
+    test:assertTrue(love.filesystem.mount('test.lpak', 'pack'), 'check mounted')
+    test:assertEquals('helloworld', love.filesystem.read('pack/hello.txt'), 'check read ' .. compression)
+    test:assertEquals(repeated, love.filesystem.read('pack/dir/repeated.txt'), 'check repeated ' .. compression)
+    test:assertEquals('bytes', love.filesystem.read('pack/dir/sub/data.bin'), 'check data ' .. compression)
+    test:assertEquals('directory', love.filesystem.getInfo('pack/dir').type, 'check directory')
+    test:assertEquals(#repeated, love.filesystem.getInfo('pack/dir/repeated.txt').size, 'check size')
+    local items = love.filesystem.getDirectoryItems('pack/dir')
+    table.sort(items)
+    test:assertEquals(2, #items, 'check item count')
+    test:assertEquals('repeated.txt', items[1], 'check item 1')
+    test:assertEquals('sub', items[2], 'check item 2')
+    test:assertTrue(love.filesystem.unmount('test.lpak'), 'check unmounted')
+  end
+  -- check bad input
+  test:assertEquals(nil, love.filesystem.writeArchive('test.lpak', {['../bad.txt'] = 'x'}), 'check bad path')
+  -- cleanup
+  love.filesystem.remove('test.lpak')
+end
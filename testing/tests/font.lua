@@ -80,6 +80,17 @@ love.test.font.Rasterizer = function(test)
   test:assertEquals(12, rasterizer:getHeight(), 'check height')
   test:assertEquals(15, rasterizer:getLineHeight(), 'check line height')
 
+  -- check shaping multiple strings at once
+  local shaped, infos = rasterizer:shapeTexts({'LOVE', '', 'LO VE'})
+  test:assertEquals(3, #infos, 'check shaped count')
+  test:assertEquals(1, infos[1].first, 'check shaped first')
+  test:assertEquals(4, infos[1].count, 'check shaped glyphs')
+  test:assertEquals(0, infos[2].count, 'check shaped empty')
+  test:assertEquals(5, infos[3].first, 'check shaped offset')
+  test:assertEquals(12 * (infos[1].count + infos[3].count), shaped:getSize(), 'check shaped size')
+  local wrapped, wrapinfos = rasterizer:shapeTexts('LO VE LO VE', 20)
+  test:assertTrue(wrapinfos[1].height > rasterizer:getHeight(), 'check wrapped lines')
+
 end
 
 
@@ -68,6 +68,23 @@ love.test.graphics.Buffer = function(test)
   local indexbuffer = love.graphics.newBuffer('uint16', 128, {index=true})
   test:assertTrue(indexbuffer:isBufferType('index'), 'check is index buffer')
 
+  -- small buffers may share an internal page, check they keep their own data
+  local smallbuffers = {}
+  for i=1,32 do
+    smallbuffers[i] = love.graphics.newBuffer('float', {i, i * 2, i * 3}, {vertex=true, usage='static'})
+  end
+  for i=1,32,2 do
+    smallbuffers[i]:release()
+    smallbuffers[i] = love.graphics.newBuffer('float', {-i, -i * 2, -i * 3}, {vertex=true, usage='static'})
+  end
+  smallbuffers[4]:setArrayData({40, 41, 42})
+  for i=1,32 do
+    local sign = i % 2 == 1 and -1 or 1
+    local data = love.graphics.readbackBuffer(smallbuffers[i])
+    local expected = i == 4 and 42 or sign * i * 3
+    test:assertEquals(expected, data:getFloat(8), string.format('check small buffer %d contents', i))
+  end
+
 end
 
 
@@ -293,6 +310,8 @@ love.test.graphics.Font = function(test)
   -- check width + kerning
   test:assertEquals(0, font:getKerning('a', 'b'), 'check kerning')
   test:assertEquals(24, font:getWidth('test'), 'check data size')
+  test:assertEquals(24 * 8, font:getWidth(string.rep('test', 8)), 'check long ascii width')
+  test:assertFalse(pcall(font.getWidth, font, string.rep('test', 8) .. '\255'), 'check invalid utf-8 after ascii')
 
   -- check specific glyphs
   test:assertTrue(font:hasGlyphs('test'), 'check data size')
@@ -312,6 +331,62 @@ love.test.graphics.Font = function(test)
   local imgdata = love.graphics.readbackTexture(canvas)
   test:compareImg(imgdata)
 
+  -- check cached text layouts are redrawn the same, and follow line height
+  love.graphics.setCanvas(canvas)
+    love.graphics.clear(0, 0, 0, 0)
+    love.graphics.print('Aa', 0, 5)
+  love.graphics.setCanvas()
+  test:assertTrue(love.graphics.readbackTexture(canvas):getString() == imgdata:getString(), 'check cached print')
+  local function drawLines()
+    love.graphics.setCanvas(canvas)
+      love.graphics.clear(0, 0, 0, 0)
+      love.graphics.printf('A A', 0, 0, 4)
+    love.graphics.setCanvas()
+    return love.graphics.readbackTexture(canvas):getString()
+  end
+  local lines1 = drawLines()
+  font:setLineHeight(0.5)
+  local lines2 = drawLines()
+  font:setLineHeight(1)
+  test:assertFalse(lines1 == lines2, 'check cached printf line height')
+  test:assertTrue(lines1 == drawLines(), 'check cached printf')
+
+  -- check preloaded and async glyphs draw the same as regular ones
+  local function drawWhenLoaded(f)
+    for i=1,100 do
+      love.graphics.setFont(f)
+      love.graphics.print('Aa', 0, 5)
+      if not f:isPreloading() then break end
+      love.timer.sleep(0.01)
+    end
+    love.graphics.setCanvas(canvas)
+      love.graphics.clear(0, 0, 0, 0)
+      love.graphics.setFont(f)
+      love.graphics.print('Aa', 0, 5)
+    love.graphics.setCanvas()
+    return love.graphics.readbackTexture(canvas)
+  end
+  local preloadfont = love.graphics.newFont('resources/font.ttf', 8)
+  preloadfont:preload('Aa', {0x30, 0x39})
+  test:assertTrue(drawWhenLoaded(preloadfont):getString() == imgdata:getString(), 'check preload draw')
+  local asyncfont = love.graphics.newFont('resources/font.ttf', 8)
+  test:assertFalse(asyncfont:isAsyncGlyphLoading(), 'check def async')
+  asyncfont:setAsyncGlyphLoading(true)
+  test:assertTrue(asyncfont:isAsyncGlyphLoading(), 'check change async')
+  test:assertTrue(drawWhenLoaded(asyncfont):getString() == imgdata:getString(), 'check async draw')
+  love.graphics.setFont(font)
+
+  -- check sdf fonts
+  test:assertFalse(font:isSDF(), 'check def sdf')
+  local sdffont = love.graphics.newFont('resources/font.ttf', 32, {sdf = true})
+  test:assertTrue(sdffont:isSDF(), 'check sdf')
+  test:assertEquals('linear', sdffont:getFilter(), 'check sdf filter')
+  love.graphics.setCanvas(canvas)
+    love.graphics.setFont(sdffont)
+    love.graphics.print('Aa', 0, 0, 0, 0.25, 0.25)
+  love.graphics.setCanvas()
+  love.graphics.setFont(font)
+
   -- check font substitution
   local fontab = love.graphics.newImageFont('resources/font-letters-ab.png', 'AB')
   local fontcd = love.graphics.newImageFont('resources/font-letters-cd.png', 'CD')
@@ -457,6 +532,15 @@ love.test.graphics.Mesh = function(test)
   test:assertEquals(1, min2, 'check draw range set min')
   test:assertEquals(10, max2, 'check draw range set max')
 
+  -- check cull rect
+  test:assertEquals(nil, mesh1:getCullRect(), 'check cull rect not set')
+  mesh1:setCullRect(-10, -10, 5, 5)
+  local cx, cy, cw, ch = mesh1:getCullRect()
+  test:assertEquals(-10, cx, 'check cull rect set x')
+  test:assertEquals(5, ch, 'check cull rect set h')
+  mesh1:setCullRect()
+  test:assertEquals(nil, mesh1:getCullRect(), 'check cull rect reset')
+
   -- check texture pointer
   test:assertEquals(nil, mesh1:getTexture(), 'check no texture')
   mesh1:setTexture(image)
@@ -519,6 +603,17 @@ love.test.graphics.Mesh = function(test)
   test:assertEquals(1, g5, 'check reset vertex color 1')
   test:assertEquals(0, b5, 'check reset vertex color 2')
 
+  -- check setting a vertex from a table, with default values
+  mesh1:setVertex(3, {10, 20, 0.5, 0.25})
+  local x7, y7, u7, v7, r7, g7, b7, a7 = mesh1:getVertex(3)
+  test:assertEquals(10, x7, 'check table vertex props x')
+  test:assertEquals(20, y7, 'check table vertex props y')
+  test:assertEquals(0.5, u7, 'check table vertex props u')
+  test:assertEquals(0.25, v7, 'check table vertex props v')
+  test:assertEquals(1, r7, 'check table vertex default r')
+  test:assertEquals(1, a7, 'check table vertex default a')
+  mesh1:setVertices(vertices)
+
   -- check setting the vertex map 
   local vmap1 = mesh1:getVertexMap()
   test:assertEquals(nil, vmap1, 'check no map by def')
@@ -555,6 +650,58 @@ love.test.graphics.Mesh = function(test)
   mesh1:detachAttribute('VertexPosition')
   test:assertTrue(mesh1:isAttributeEnabled('VertexPosition'), 'check cant detach def attribute')
 
+  -- check skinning with a bone buffer, which moves the quad by bone 1
+  test:assertEquals(nil, mesh1:getBoneBuffer(), 'check no bone buffer by def')
+  if love.graphics.getSupported().texelbuffer then
+    local bones = love.graphics.newBuffer('floatvec4', {
+      {1, 0, 0, 0}, {0, 1, 0, 0},
+      {1, 0, 8, 0}, {0, 1, 0, 0},
+    }, {texel=true})
+    local mesh3 = love.graphics.newMesh({
+      { name = 'VertexPosition', format = 'floatvec2'},
+      { name = 'VertexBoneIndices', format = 'floatvec4'},
+      { name = 'VertexBoneWeights', format = 'floatvec4'},
+    }, {
+      { 0, 0, 1, 0, 0, 0, 1, 0, 0, 0 },
+      { 4, 0, 1, 0, 0, 0, 1, 0, 0, 0 },
+      { 4, 4, 1, 0, 0, 0, 1, 0, 0, 0 },
+      { 0, 4, 1, 0, 0, 0, 1, 0, 0, 0 },
+    }, 'fan')
+    if pcall(mesh3.setBoneBuffer, mesh3, bones) then
+      test:assertEquals(bones, mesh3:getBoneBuffer(), 'check bone buffer set')
+      local canvas = love.graphics.newCanvas(16, 16)
+      love.graphics.setCanvas(canvas)
+        love.graphics.clear(0, 0, 0, 1)
+        love.graphics.draw(mesh3)
+      love.graphics.setCanvas()
+      local imgdata = love.graphics.readbackTexture(canvas)
+      local r = imgdata:getPixel(2, 2)
+      test:assertEquals(0, r, 'check skinned bind position empty')
+      r = imgdata:getPixel(10, 2)
+      test:assertEquals(1, r, 'check skinned position')
+      mesh3:setBoneBuffer()
+      test:assertEquals(nil, mesh3:getBoneBuffer(), 'check bone buffer cleared')
+    end
+  end
+
+  -- check optimizing removes duplicate and unused vertices
+  local mesh4 = love.graphics.newMesh({
+    { 0, 0, 0, 0, 1, 1, 1, 1 },
+    { 4, 0, 1, 0, 1, 1, 1, 1 },
+    { 0, 4, 0, 1, 1, 1, 1, 1 },
+    { 4, 0, 1, 0, 1, 1, 1, 1 },
+    { 4, 4, 1, 1, 1, 1, 1, 1 },
+    { 0, 4, 0, 1, 1, 1, 1, 1 },
+    { 8, 8, 1, 1, 1, 1, 1, 1 },
+  }, 'triangles')
+  mesh4:setVertexMap(1, 2, 3, 4, 5, 6)
+  mesh4:optimize({ quantize = true })
+  test:assertEquals(4, mesh4:getVertexCount(), 'check optimized vertex count')
+  test:assertEquals(6, #mesh4:getVertexMap(), 'check optimized vertex map')
+  test:assertEquals('unorm16vec2', mesh4:getVertexFormat()[2].format, 'check quantized texcoords')
+  local x, y = mesh4:getVertex(1)
+  test:assertEquals(true, x ~= 8 and y ~= 8, 'check unused vertex removed')
+
 end
 
 
@@ -757,6 +904,16 @@ love.test.graphics.ParticleSystem = function(test)
   psystem:setTexture(love.graphics.newImage('resources/love.png'))
   test:assertObject(psystem:getTexture())
 
+  -- check gpu simulation
+  test:assertFalse(psystem:isGPUSimulation(), 'check def gpu simulation')
+  if love.graphics.getSupported().glsl4 then
+    psystem:setGPUSimulation(true)
+    test:assertTrue(psystem:isGPUSimulation(), 'check change gpu simulation')
+    psystem:emit(10)
+    test:assertEquals(10, psystem:getCount(), 'check gpu simulation count')
+    psystem:setGPUSimulation(false)
+  end
+
   -- try a graphics test!
   -- hard to get exactly because of the variation but we can use some pixel 
   -- tolerance and volume to try and cover the randomness
@@ -840,6 +997,13 @@ love.test.graphics.Shader = function(test)
   test:assertFalse(shader1:hasUniform('tex1'), 'check invalid uniform')
   test:assertTrue(shader1:hasUniform('tex2'), 'check valid uniform')
   test:assertEquals('testshader', shader1:getDebugName())
+  test:assertTrue(shader1:isReady(), 'check non-async shader is ready')
+
+  -- check async shader, which must be usable even before it's ready
+  local asyncshader = love.graphics.newShader(pixelcode1, vertexcode1, {async = true})
+  test:assertObject(asyncshader)
+  test:assertTrue(asyncshader:hasUniform('tex2'), 'check async uniform')
+  test:assertTrue(asyncshader:isReady(), 'check async shader is ready after use')
 
   -- check invalid shader
   local pixelcode2 = [[
@@ -852,6 +1016,14 @@ love.test.graphics.Shader = function(test)
   ]]
   local res, err = pcall(love.graphics.newShader, pixelcode2, vertexcode1)
   test:assertNotEquals(nil, err, 'check shader compile fails')
+  -- an async shader may only report the error when it's used, but then it
+  -- has to keep failing instead of drawing with no program
+  local asyncok, asyncbad = pcall(love.graphics.newShader, pixelcode2, vertexcode1, {async = true})
+  if asyncok then
+    test:assertFalse(pcall(love.graphics.setShader, asyncbad), 'check async compile error raised')
+    test:assertFalse(pcall(love.graphics.setShader, asyncbad), 'check async compile error kept')
+    love.graphics.setShader()
+  end
 
   -- check using a shader to draw + sending uniforms
   -- shader will return a given color if overwrite set to 1, otherwise def. draw
@@ -950,6 +1122,41 @@ love.test.graphics.Shader = function(test)
   local imgdata2 = love.graphics.readbackTexture(canvas3)
   test:compareImg(imgdata2)
 
+  -- sendMany should update several uniforms (and array elements) at once
+  shader7:sendMany({vec3s = {{0, 0, 1}, {1, 0, 0}, {0, 1, 0}}})
+  love.graphics.push("all")
+    love.graphics.setCanvas(canvas3)
+    love.graphics.setShader(shader7)
+    love.graphics.rectangle("fill", 0, 0, 16, 16)
+  love.graphics.pop()
+  local r, g, b = love.graphics.readbackTexture(canvas3):getPixel(8, 8)
+  test:assertEquals(1, r, 'check sendMany array value r')
+  test:assertEquals(0, g, 'check sendMany array value g')
+  test:assertEquals(0, b, 'check sendMany array value b')
+  local ok = pcall(shader7.sendMany, shader7, {missing = 1})
+  test:assertFalse(ok, 'check sendMany rejects unknown uniforms')
+
+  -- specialization constants can be changed without recompiling on backends
+  -- which support them, and act as regular constants elsewhere
+  local shader9 = love.graphics.newShader[[
+    SpecializationConstant(0) int QUALITY = 2;
+    SpecializationConstant(1) bool BRIGHT = false;
+
+    vec4 effect(vec4 vcolor, Image tex, vec2 tc, vec2 pc) {
+      return vec4(float(QUALITY) / 4.0, BRIGHT ? 1.0 : 0.0, 0.0, 1.0);
+    }
+  ]]
+  local renderer = love.graphics.getRendererInfo()
+  if renderer == 'Vulkan' or renderer == 'Metal' then
+    test:assertEquals(2, shader9:getSpecializationConstant('QUALITY'), 'check default constant')
+    shader9:setSpecializationConstant('QUALITY', 4)
+    shader9:setSpecializationConstant('BRIGHT', true)
+    test:assertEquals(4, shader9:getSpecializationConstant('QUALITY'), 'check set constant')
+    test:assertTrue(shader9:getSpecializationConstant('BRIGHT'), 'check set bool constant')
+  else
+    test:assertEquals(nil, shader9:getSpecializationConstant('QUALITY'), 'check no constants')
+  end
+
   if love.graphics.getSupported().glsl3 then
     local shader8 = love.graphics.newShader[[
       #pragma language glsl3
@@ -1077,6 +1284,27 @@ love.test.graphics.SpriteBatch = function(test)
   local imgdata1 = love.graphics.readbackTexture(canvas)
   test:compareImg(imgdata1)
 
+  -- instanced batches draw the same sprites as regular ones
+  local ibatch = love.graphics.newSpriteBatch(texture2, 5000, nil, true)
+  test:assertTrue(ibatch:isInstanced(), 'check instanced')
+  test:assertFalse(sbatch:isInstanced(), 'check def instanced')
+  for s=1,4096 do
+    local row = math.floor((s-1)/64)
+    if row % 2 == 0 then
+      ibatch:setColor(1, 1, 1, 1)
+    else
+      ibatch:setColor(1, 0, 0, 1)
+    end
+    ibatch:add(quad1, (s-1) % 64, row, 0, 1, 1)
+  end
+  test:assertEquals(4096, ibatch:getCount(), 'check instanced count')
+  love.graphics.setCanvas(canvas)
+    love.graphics.clear(0, 0, 0, 1)
+    love.graphics.draw(ibatch, 0, 0)
+  love.graphics.setCanvas()
+  local instanceddata = love.graphics.readbackTexture(canvas)
+  test:assertTrue(instanceddata:getString() == imgdata1:getString(), 'check instanced draw')
+
   -- use set to change some sprites
   for s=1,2048 do
     sbatch:set(sprites[s][1], quad2, sprites[s][2], sprites[s][3]+1, 0, 1, 1)
@@ -1097,6 +1325,20 @@ love.test.graphics.SpriteBatch = function(test)
   local imgdata3 = love.graphics.readbackTexture(canvas)
   test:compareImg(imgdata3)
 
+  -- static batches keep drawing the uploaded sprites but can't be changed
+  test:assertFalse(sbatch:isStatic(), 'check def static')
+  sbatch:setStatic(true)
+  test:assertTrue(sbatch:isStatic(), 'check change static')
+  test:assertFalse(pcall(sbatch.add, sbatch, quad1, 0, 0), 'check static add error')
+  love.graphics.setCanvas(canvas)
+    love.graphics.clear(0, 0, 0, 1)
+    love.graphics.draw(sbatch, 0, 0)
+  love.graphics.setCanvas()
+  local staticdata = love.graphics.readbackTexture(canvas)
+  test:assertTrue(staticdata:getString() == imgdata3:getString(), 'check static draw')
+  sbatch:setStatic(false)
+  test:assertFalse(sbatch:isStatic(), 'check disable static')
+
   -- clear and redraw
   sbatch:clear()
   love.graphics.setCanvas(canvas)
@@ -1106,6 +1348,38 @@ love.test.graphics.SpriteBatch = function(test)
   local imgdata4 = love.graphics.readbackTexture(canvas)
   test:compareImg(imgdata4)
 
+  -- sprites outside the cull rect aren't drawn
+  local whitedata = love.image.newImageData(1, 1)
+  whitedata:setPixel(0, 0, 1, 1, 1, 1)
+  local cbatch = love.graphics.newSpriteBatch(love.graphics.newImage(whitedata), 16)
+  for x=0,15 do
+    cbatch:add(x, 0, 0, 1, 16)
+  end
+  test:assertEquals(nil, cbatch:getCullRect(), 'check no cull rect by def')
+  cbatch:setCullRect(0, 0, 7.5, 16)
+  local cx, cy, cw, ch = cbatch:getCullRect()
+  test:assertEquals(7.5, cw, 'check cull rect set')
+  local cullcanvas = love.graphics.newCanvas(16, 16)
+  love.graphics.setCanvas(cullcanvas)
+    love.graphics.clear(0, 0, 0, 1)
+    love.graphics.draw(cbatch)
+  love.graphics.setCanvas()
+  local culldata = love.graphics.readbackTexture(cullcanvas)
+  test:assertEquals(1, culldata:getPixel(3, 3), 'check visible sprite drawn')
+  test:assertEquals(0, culldata:getPixel(12, 3), 'check culled sprite skipped')
+  -- moving a sprite into the rect updates the grid
+  cbatch:set(15, 6, 0, 0, 1, 16)
+  cbatch:setCullRect(10, 0, 6, 16)
+  love.graphics.setCanvas(cullcanvas)
+    love.graphics.clear(0, 0, 0, 1)
+    love.graphics.draw(cbatch)
+  love.graphics.setCanvas()
+  culldata = love.graphics.readbackTexture(cullcanvas)
+  test:assertEquals(0, culldata:getPixel(6, 3), 'check moved sprite culled')
+  test:assertEquals(1, culldata:getPixel(12, 3), 'check sprite in new rect drawn')
+  cbatch:setCullRect()
+  test:assertEquals(nil, cbatch:getCullRect(), 'check cull rect reset')
+
   -- array texture sbatch
   local texture3 = love.graphics.newArrayImage({
     'resources/love.png',
@@ -1170,6 +1444,34 @@ love.test.graphics.Text = function(test)
   local imgdata = love.graphics.readbackTexture(canvas)
   test:compareImg(imgdata)
 
+  -- check replacing and removing text matches building it from scratch
+  local function drawBatch(batch)
+    love.graphics.setCanvas(canvas)
+      love.graphics.clear(0, 0, 0, 0)
+      love.graphics.draw(batch, 0, 0)
+    love.graphics.setCanvas()
+    return love.graphics.readbackTexture(canvas):getString()
+  end
+  local function newBatch(lines)
+    local batch = love.graphics.newTextBatch(font)
+    for i=1,#lines do
+      batch:add(lines[i], 0, (i-1)*9)
+    end
+    return batch
+  end
+  local edittext = newBatch({'one', 'two', 'three'})
+  edittext:replace(2, 'TWO!!', 0, 9)
+  test:assertEquals(3, edittext:getCount(), 'check replace count')
+  test:assertEquals(font:getWidth('TWO!!'), edittext:getWidth(2), 'check replace width')
+  test:assertTrue(drawBatch(edittext) == drawBatch(newBatch({'one', 'TWO!!', 'three'})), 'check replace draw')
+  edittext:replacef(3, 'a', 20, 'right', 0, 18)
+  edittext:remove(1)
+  test:assertEquals(2, edittext:getCount(), 'check remove count')
+  local expected = love.graphics.newTextBatch(font)
+  expected:add('TWO!!', 0, 9)
+  expected:addf('a', 20, 'right', 0, 18)
+  test:assertTrue(drawBatch(edittext) == drawBatch(expected), 'check remove draw')
+
 end
 
 
@@ -1329,6 +1631,102 @@ love.test.graphics.clear = function(test)
 end
 
 
+-- love.graphics.computeBlur
+love.test.graphics.computeBlur = function(test)
+  if not love.graphics.getSupported().glsl4 then
+    test:skipTest('compute shaders are not supported on this system')
+    return
+  end
+  -- single white pixel spread over 3x3 by a radius 1 box blur
+  local source = love.graphics.newCanvas(16, 16, {format = 'rgba16f'})
+  love.graphics.setCanvas(source)
+    love.graphics.clear(0, 0, 0, 1)
+    love.graphics.setColor(1, 1, 1, 1)
+    love.graphics.points(8.5, 8.5)
+  love.graphics.setCanvas()
+  local dest = love.graphics.newTexture(16, 16, {format = 'rgba16f', computewrite = true})
+  love.graphics.computeBlur(source, dest, 1, 'box')
+  local imgdata = love.graphics.readbackTexture(dest)
+  test:assertRange(imgdata:getPixel(8, 8), 0.1, 0.12, 'check blurred center')
+  test:assertRange(imgdata:getPixel(7, 9), 0.1, 0.12, 'check blurred corner')
+  test:assertEquals(0, imgdata:getPixel(6, 8), 'check outside radius')
+  test:assertEquals(1, select(4, imgdata:getPixel(0, 0)), 'check alpha kept')
+  -- gaussian weights sum to one, so a solid image stays the same
+  love.graphics.setCanvas(source)
+    love.graphics.clear(0.5, 0.5, 0.5, 1)
+  love.graphics.setCanvas()
+  love.graphics.computeBlur(source, dest, 8, 'gaussian')
+  imgdata = love.graphics.readbackTexture(dest)
+  test:assertRange(imgdata:getPixel(0, 0), 0.49, 0.51, 'check gaussian edge')
+  test:assertRange(imgdata:getPixel(8, 8), 0.49, 0.51, 'check gaussian center')
+  -- destination must be compute writable
+  local ok = pcall(love.graphics.computeBlur, source, source, 1)
+  test:assertFalse(ok, 'check computewrite error')
+end
+
+
+-- love.graphics.computeDownsample
+love.test.graphics.computeDownsample = function(test)
+  if not love.graphics.getSupported().glsl4 then
+    test:skipTest('compute shaders are not supported on this system')
+    return
+  end
+  -- left half white, right half black
+  local source = love.graphics.newCanvas(16, 16)
+  love.graphics.setCanvas(source)
+    love.graphics.clear(0, 0, 0, 1)
+    love.graphics.rectangle('fill', 0, 0, 8, 16)
+  love.graphics.setCanvas()
+  local dests = {}
+  for i=1,3 do
+    local size = 16 / 2^i
+    dests[i] = love.graphics.newTexture(size, size, {format = 'rgba8', computewrite = true})
+  end
+  love.graphics.computeDownsample(source, dests)
+  local level1 = love.graphics.readbackTexture(dests[1])
+  test:assertEquals(1, level1:getPixel(3, 3), 'check level 1 left')
+  test:assertEquals(0, level1:getPixel(4, 3), 'check level 1 right')
+  local level2 = love.graphics.readbackTexture(dests[2])
+  test:assertEquals(1, level2:getPixel(1, 0), 'check level 2 left')
+  test:assertEquals(0, level2:getPixel(2, 0), 'check level 2 right')
+  local level3 = love.graphics.readbackTexture(dests[3])
+  test:assertEquals(1, level3:getPixel(0, 1), 'check level 3 left')
+  test:assertEquals(0, level3:getPixel(1, 1), 'check level 3 right')
+end
+
+
+-- love.graphics.computeLuminance
+-- @NOTE also tests love.graphics.computeHistogram
+love.test.graphics.computeLuminance = function(test)
+  if not love.graphics.getSupported().glsl4 then
+    test:skipTest('compute shaders are not supported on this system')
+    return
+  end
+  local source = love.graphics.newCanvas(32, 32, {format = 'rgba16f'})
+  love.graphics.setCanvas(source)
+    love.graphics.clear(0, 0, 0, 1)
+    love.graphics.setColor(0.5, 0.5, 0.5, 1)
+    love.graphics.rectangle('fill', 0, 0, 32, 16)
+    love.graphics.setColor(1, 1, 1, 1)
+  love.graphics.setCanvas()
+  -- half the pixels are black and go in the first bin
+  local buffer = love.graphics.newBuffer('uint32', 256, {shaderstorage = true})
+  love.graphics.computeHistogram(source, buffer)
+  local data = love.graphics.readbackBuffer(buffer)
+  test:assertEquals(512, data:getUInt32(0), 'check black bin')
+  local total = 0
+  for i=0,255 do
+    total = total + data:getUInt32(i * 4)
+  end
+  test:assertEquals(1024, total, 'check every pixel counted')
+  -- the average ignores black pixels
+  local dest = love.graphics.newTexture(1, 1, {format = 'r32f', computewrite = true})
+  love.graphics.computeLuminance(source, dest)
+  local imgdata = love.graphics.readbackTexture(dest)
+  test:assertRange(imgdata:getPixel(0, 0), 0.48, 0.52, 'check average luminance')
+end
+
+
 -- love.graphics.discard
 love.test.graphics.discard = function(test)
   -- from the docs: "on some desktops this may do nothing"
@@ -1402,6 +1800,30 @@ love.test.graphics.drawLayer = function(test)
 end
 
 
+-- love.graphics.drawLines
+love.test.graphics.drawLines = function(test)
+  local format = {{name='VertexPosition', format='floatvec2'}}
+  local points = love.graphics.newBuffer(format, {{2, 8}, {14, 8}, {14, 14}}, {vertex=true})
+  local canvas = love.graphics.newCanvas(16, 16)
+  love.graphics.setCanvas(canvas)
+    love.graphics.clear(0, 0, 0, 1)
+    love.graphics.setLineStyle('rough')
+    love.graphics.setLineWidth(2)
+    love.graphics.drawLines(points)
+    love.graphics.setLineWidth(1)
+    love.graphics.setLineStyle('smooth')
+  love.graphics.setCanvas()
+  local imgdata = love.graphics.readbackTexture(canvas)
+  local r = imgdata:getPixel(6, 7)
+  test:assertEquals(1, r, 'check first segment')
+  r = imgdata:getPixel(13, 11)
+  test:assertEquals(1, r, 'check second segment')
+  r = imgdata:getPixel(6, 3)
+  test:assertEquals(0, r, 'check outside line')
+  test:assertEquals(false, pcall(love.graphics.drawLines, points, 3, 1), 'check invalid range')
+end
+
+
 -- love.graphics.ellipse
 love.test.graphics.ellipse = function(test)
   local canvas = love.graphics.newCanvas(32, 32)
@@ -1553,6 +1975,28 @@ love.test.graphics.rectangle = function(test)
 end
 
 
+-- love.graphics.updateParticleSystems
+love.test.graphics.updateParticleSystems = function(test)
+  local image = love.graphics.newImage('resources/pixel.png')
+  local systems = {}
+  for i=1,4 do
+    systems[i] = love.graphics.newParticleSystem(image, 100)
+    systems[i]:setParticleLifetime(1, 1)
+    systems[i]:emit(10 * i)
+  end
+  love.graphics.updateParticleSystems(systems, 0.5)
+  for i=1,4 do
+    test:assertEquals(10 * i, systems[i]:getCount(), 'check particles alive')
+  end
+  love.graphics.updateParticleSystems(systems, 1)
+  for i=1,4 do
+    test:assertEquals(0, systems[i]:getCount(), 'check particles dead')
+  end
+  local ok = pcall(love.graphics.updateParticleSystems, {systems[1], systems[1]}, 1)
+  test:assertFalse(ok, 'check duplicate systems error')
+end
+
+
 --------------------------------------------------------------------------------
 --------------------------------------------------------------------------------
 --------------------------------OBJECT CREATION---------------------------------
@@ -1560,6 +2004,25 @@ end
 --------------------------------------------------------------------------------
 
 
+-- love.graphics.captureFrames
+love.test.graphics.captureFrames = function(test)
+  test:assertFalse(love.graphics.isCapturing(), 'check not capturing')
+  love.graphics.captureFrames(2, 'example-capture.lua')
+  test:assertTrue(love.graphics.isCapturing(), 'check capturing')
+  -- the capture ends after 2 presents, which happen at the end of the frames
+  test:waitFrames(3)
+  test:assertFalse(love.graphics.isCapturing(), 'check capture finished')
+  test:assertNotEquals(nil, love.filesystem.getInfo('example-capture.lua'), 'check capture written')
+  -- replaying draws the recorded frames, with timings for each
+  local stats = love.graphics.replayCapture('example-capture.lua', 2)
+  test:assertEquals(4, stats.frames, 'check replayed frames')
+  test:assertGreaterEqual(0, stats.min, 'check min frame time')
+  test:assertGreaterEqual(stats.p50, stats.max, 'check max frame time')
+  test:assertEquals(0, stats.failed, 'check no failed commands')
+  love.filesystem.remove('example-capture.lua')
+end
+
+
 -- love.graphics.captureScreenshot
 love.test.graphics.captureScreenshot = function(test)
   love.graphics.captureScreenshot('example-screenshot.png')
@@ -1589,6 +2052,37 @@ love.test.graphics.captureScreenshot = function(test)
 end
 
 
+-- love.graphics.multiDrawIndirect
+love.test.graphics.multiDrawIndirect = function(test)
+  if not love.graphics.getSupported().indirectdraw then
+    return test:skipTest('indirect draws are not supported on this system')
+  end
+  -- two triangles making up a 16x16 square, each drawn by its own args entry
+  local mesh = love.graphics.newMesh({
+    { 0, 0 }, { 16, 0 }, { 16, 16 },
+    { 0, 0 }, { 16, 16 }, { 0, 16 },
+  }, 'triangles', 'static')
+  local argsbuffer = love.graphics.newBuffer('uint32', 8, {indirectarguments=true})
+  argsbuffer:setArrayData({
+    3, 1, 0, 0,
+    3, 1, 3, 0,
+  })
+  local canvas = love.graphics.newCanvas(16, 16)
+  love.graphics.setCanvas(canvas)
+    love.graphics.clear(0, 0, 0, 1)
+    love.graphics.multiDrawIndirect(mesh, argsbuffer, 1, 2)
+  love.graphics.setCanvas()
+  local imgdata = love.graphics.readbackTexture(canvas)
+  local coords = {{1,1},{14,14},{14,1},{1,14}}
+  for c=1,#coords do
+    local r = imgdata:getPixel(coords[c][1], coords[c][2])
+    test:assertEquals(1, r, 'check pixel drawn at ' .. coords[c][1] .. ',' .. coords[c][2])
+  end
+  local ok = pcall(love.graphics.multiDrawIndirect, mesh, argsbuffer, 1, 3)
+  test:assertFalse(ok, 'check draw count past the end of the buffer errors')
+end
+
+
 -- love.graphics.newArrayImage
 -- @NOTE this is just basic nil checking, objs have their own test method
 love.test.graphics.newArrayImage = function(test)
@@ -1597,6 +2091,52 @@ love.test.graphics.newArrayImage = function(test)
   }))
 end
 
+-- love.graphics.newAtlas
+love.test.graphics.newAtlas = function(test)
+  local red = love.image.newImageData(16, 8)
+  red:mapPixel(function() return 1, 0, 0, 1 end)
+  local blue = love.image.newImageData(8, 24)
+  blue:mapPixel(function() return 0, 0, 1, 1 end)
+  local green = love.graphics.newCanvas(12, 12)
+  love.graphics.setCanvas(green)
+    love.graphics.clear(0, 1, 0, 1)
+  love.graphics.setCanvas()
+  local atlas, quads = love.graphics.newAtlas({red, blue, green}, {
+    padding = 2,
+    debugname = 'atlas'
+  })
+  test:assertObject(atlas)
+  test:assertEquals(3, #quads, 'check one quad per image')
+  test:assertEquals('atlas', atlas:getDebugName(), 'check debugname')
+  -- quads keep the size of their image and don't overlap
+  local sizes = {{16, 8}, {8, 24}, {12, 12}}
+  for i=1,#quads do
+    local x, y, w, h = quads[i]:getViewport()
+    test:assertEquals(sizes[i][1], w, 'check quad ' .. i .. ' width')
+    test:assertEquals(sizes[i][2], h, 'check quad ' .. i .. ' height')
+    test:assertTrue(x + w <= atlas:getWidth() and y + h <= atlas:getHeight(), 'check quad ' .. i .. ' inside')
+    for j=i+1,#quads do
+      local x2, y2, w2, h2 = quads[j]:getViewport()
+      local overlap = x < x2 + w2 and x2 < x + w and y < y2 + h2 and y2 < y + h
+      test:assertFalse(overlap, 'check quads ' .. i .. ' and ' .. j .. ' overlap')
+    end
+  end
+  -- the contents are copied into the atlas
+  local imgdata = love.graphics.readbackTexture(atlas)
+  local colors = {{1, 0, 0}, {0, 0, 1}, {0, 1, 0}}
+  for i=1,#quads do
+    local x, y = quads[i]:getViewport()
+    local r, g, b = imgdata:getPixel(x + 1, y + 1)
+    test:assertEquals(colors[i][1], r, 'check quad ' .. i .. ' r')
+    test:assertEquals(colors[i][2], g, 'check quad ' .. i .. ' g')
+    test:assertEquals(colors[i][3], b, 'check quad ' .. i .. ' b')
+  end
+  -- too small a maximum size is an error
+  local ok = pcall(love.graphics.newAtlas, {red, blue}, {maxsize = 16})
+  test:assertFalse(ok, 'check maxsize error')
+end
+
+
 -- love.graphics.newCanvas
 -- @NOTE this is just basic nil checking, objs have their own test method
 love.test.graphics.newCanvas = function(test)
@@ -1622,6 +2162,49 @@ love.test.graphics.newCubeImage = function(test)
 end
 
 
+-- love.graphics.newDrawList
+love.test.graphics.newDrawList = function(test)
+  local list = love.graphics.newDrawList()
+  test:assertObject(list)
+  test:assertEquals(0, list:getDrawCount(), 'check empty')
+  local shapes = love.graphics.newShapeBatch()
+  shapes:rectangle('fill', 0, 8, 8, 8)
+  love.graphics.beginDrawList(list)
+    test:assertEquals(list, love.graphics.getRecordingDrawList(), 'check recording')
+    test:assertFalse(pcall(love.graphics.beginDrawList, list), 'check nested begin')
+    love.graphics.setColor(1, 0, 0, 1)
+    love.graphics.rectangle('fill', 0, 0, 8, 8)
+    love.graphics.translate(8, 0)
+    love.graphics.rectangle('fill', 0, 0, 8, 8)
+    love.graphics.setColor(0, 1, 0, 1)
+    love.graphics.draw(shapes)
+    love.graphics.setColor(1, 1, 1, 1)
+  love.graphics.endDrawList()
+  test:assertEquals(nil, love.graphics.getRecordingDrawList(), 'check not recording')
+  test:assertFalse(pcall(love.graphics.endDrawList), 'check end without begin')
+  -- the two rectangles share their state, so they're merged into one draw
+  test:assertEquals(2, list:getDrawCount(), 'check draw count')
+  test:assertGreaterEqual(8, list:getVertexCount(), 'check vertex count')
+  -- nothing was drawn while recording, and replaying applies the transform
+  local canvas = love.graphics.newCanvas(32, 32)
+  love.graphics.setCanvas(canvas)
+    love.graphics.clear(0, 0, 0, 1)
+    love.graphics.draw(list, 8, 8)
+  love.graphics.setCanvas()
+  local imgdata = love.graphics.readbackTexture(canvas)
+  local r, g, b = imgdata:getPixel(2, 2)
+  test:assertEquals(0, r, 'check offset')
+  r, g, b = imgdata:getPixel(12, 12)
+  test:assertEquals(1, r, 'check first rectangle')
+  r, g, b = imgdata:getPixel(20, 12)
+  test:assertEquals(1, r, 'check translated rectangle')
+  r, g, b = imgdata:getPixel(12, 20)
+  test:assertEquals(1, g, 'check recorded drawable color')
+  list:clear()
+  test:assertEquals(0, list:getDrawCount(), 'check cleared')
+end
+
+
 -- love.graphics.newFont
 -- @NOTE this is just basic nil checking, objs have their own test method
 love.test.graphics.newFont = function(test)
@@ -1645,6 +2228,19 @@ end
 -- @NOTE this is just basic nil checking, objs have their own test method
 love.test.graphics.newImageFont = function(test)
   test:assertObject(love.graphics.newImageFont('resources/love.png', 'ABCD', 1))
+  -- glyphs are drawn from a copy of the image, the source keeps its spacer color
+  local imgdata = love.image.newImageData('resources/font-letters-ab.png')
+  local spacer = {imgdata:getPixel(0, 0)}
+  local font = love.graphics.newImageFont(imgdata, 'AB')
+  local canvas = love.graphics.newCanvas(32, 16)
+  love.graphics.setCanvas(canvas)
+    love.graphics.clear(0, 0, 0, 0)
+    love.graphics.print('AB', font, 0, 0)
+  love.graphics.setCanvas()
+  local r, g, b, a = imgdata:getPixel(0, 0)
+  test:assertEquals(spacer[1], r, 'check source spacer r')
+  test:assertEquals(spacer[4], a, 'check source spacer a')
+  test:assertEquals(font:getWidth('A') + font:getWidth('B'), font:getWidth('AB'), 'check width')
 end
 
 
@@ -1655,6 +2251,38 @@ love.test.graphics.newMesh = function(test)
 end
 
 
+-- love.graphics.newOcclusionQuery
+love.test.graphics.newOcclusionQuery = function(test)
+  if love.graphics.getSupported().occlusionquery ~= true then
+    test:skipTest('occlusion queries are not supported on this system')
+    return
+  end
+  local query = love.graphics.newOcclusionQuery()
+  test:assertObject(query)
+  test:assertFalse(query:isActive(), 'check inactive')
+  test:assertFalse(pcall(love.graphics.endOcclusionQuery), 'check end without begin')
+  local canvas = love.graphics.newCanvas(16, 16)
+  love.graphics.setCanvas(canvas)
+    love.graphics.beginOcclusionQuery(query)
+    test:assertTrue(query:isActive(), 'check active')
+    test:assertEquals(query, love.graphics.getActiveOcclusionQuery(), 'check active query')
+    test:assertFalse(pcall(love.graphics.beginOcclusionQuery, query), 'check nested begin')
+    test:assertFalse(query:isResultAvailable(), 'check no result while active')
+    test:assertEquals(nil, query:getResult(), 'check nil result while active')
+    love.graphics.rectangle('fill', 0, 0, 16, 16)
+    love.graphics.endOcclusionQuery()
+  love.graphics.setCanvas()
+  test:assertFalse(query:isActive(), 'check ended')
+  test:assertEquals(nil, love.graphics.getActiveOcclusionQuery(), 'check no active query')
+  -- results arrive asynchronously, but once there they must count the draw
+  if query:isResultAvailable() then
+    local visible, samples = query:getResult()
+    test:assertTrue(visible, 'check visible')
+    test:assertGreaterEqual(1, samples, 'check samples')
+  end
+end
+
+
 -- love.graphics.newParticleSystem
 -- @NOTE this is just basic nil checking, objs have their own test method
 love.test.graphics.newParticleSystem = function(test)
@@ -1671,6 +2299,36 @@ love.test.graphics.newQuad = function(test)
 end
 
 
+-- love.graphics.newReadbackRing
+love.test.graphics.newReadbackRing = function(test)
+  local ring = love.graphics.newReadbackRing(2)
+  test:assertObject(ring)
+  test:assertEquals(2, ring:getSize(), 'check size')
+  local canvas = love.graphics.newCanvas(16, 16)
+  love.graphics.setCanvas(canvas)
+    love.graphics.clear(1, 0, 0, 1)
+  love.graphics.setCanvas()
+  local first = ring:readbackTexture(canvas)
+  local second = ring:readbackTexture(canvas)
+  test:assertObject(first)
+  test:assertObject(second)
+  test:assertEquals(nil, ring:readbackTexture(canvas), 'check full ring')
+  first:wait()
+  second:wait()
+  local completed = ring:poll()
+  test:assertEquals(2, #completed, 'check completed count')
+  test:assertEquals(first, completed[1], 'check completion order')
+  local r, g, b, a = completed[1]:getImageData():getPixel(0, 0)
+  test:assertEquals(1, r, 'check readback pixel')
+  -- slots are free again once polled, and reuse their destination data
+  local imgdata = completed[1]:getImageData()
+  local third = ring:readbackTexture(canvas)
+  test:assertObject(third)
+  third:wait()
+  test:assertEquals(imgdata, ring:poll()[1]:getImageData(), 'check recycled data')
+end
+
+
 -- love.graphics.newShader
 -- @NOTE this is just basic nil checking, objs have their own test method
 love.test.graphics.newShader = function(test)
@@ -1689,6 +2347,80 @@ love.test.graphics.newShader = function(test)
 end
 
 
+-- love.graphics.newShaderVariants
+love.test.graphics.newShaderVariants = function(test)
+  local pixelcode = [[
+    vec4 effect(vec4 color, Image tex, vec2 tc, vec2 pc) {
+      vec4 result = vec4(0.0, 0.0, 0.0, 1.0);
+    #ifdef RED
+      result.r = 1.0;
+    #endif
+    #ifdef GREEN
+      result.g = 1.0;
+    #endif
+      return result;
+    }
+  ]]
+  local variants = love.graphics.newShaderVariants(pixelcode, {
+    features = {'RED', 'GREEN'},
+    variants = {0, {'RED'}, {'RED', 'GREEN'}}
+  })
+  test:assertObject(variants)
+  test:assertEquals(3, variants:getVariantCount(), 'check variant count')
+  test:assertEquals(3, variants:getFeatureMask('RED', 'GREEN'), 'check feature mask')
+  test:assertTrue(variants:hasVariant('RED'), 'check declared variant')
+  test:assertFalse(variants:hasVariant('GREEN'), 'check undeclared variant')
+  test:assertObject(variants:getShader(1))
+  local ok = pcall(variants.getShader, variants, 2)
+  test:assertFalse(ok, 'check undeclared variant errors')
+  -- select a variant by its features when drawing
+  local canvas = love.graphics.newCanvas(4, 4)
+  love.graphics.push('all')
+    love.graphics.setCanvas(canvas)
+    love.graphics.setShader(variants, 'RED', 'GREEN')
+    love.graphics.rectangle('fill', 0, 0, 4, 4)
+  love.graphics.pop()
+  local r, g, b = love.graphics.readbackTexture(canvas):getPixel(1, 1)
+  test:assertEquals(1, r, 'check variant r')
+  test:assertEquals(1, g, 'check variant g')
+  test:assertEquals(0, b, 'check variant b')
+end
+
+
+-- love.graphics.newShapeBatch
+love.test.graphics.newShapeBatch = function(test)
+  local shapes = love.graphics.newShapeBatch()
+  test:assertObject(shapes)
+  test:assertEquals(0, shapes:getVertexCount(), 'check empty')
+  shapes:setColor(1, 0, 0, 1)
+  shapes:rectangle('fill', 0, 0, 8, 8)
+  shapes:setColor(0, 0, 1, 1)
+  shapes:circle('fill', 12, 12, 4, 16)
+  shapes:setLineWidth(2)
+  shapes:line(0, 15, 15, 15)
+  local count = shapes:getVertexCount()
+  test:assertGreaterEqual(4 + 16, count, 'check tessellated')
+  test:assertEquals(count, shapes:getVertexCount(), 'check cached')
+  shapes:setLineWidth(4)
+  test:assertEquals(4, shapes:getLineWidth(), 'check line width')
+  test:assertEquals(count, shapes:getVertexCount(), 'check retessellated')
+  local canvas = love.graphics.newCanvas(16, 16)
+  love.graphics.setCanvas(canvas)
+    love.graphics.clear(0, 0, 0, 1)
+    love.graphics.draw(shapes)
+  love.graphics.setCanvas()
+  local imgdata = love.graphics.readbackTexture(canvas)
+  local r, g, b = imgdata:getPixel(2, 2)
+  test:assertEquals(1, r, 'check recorded color r')
+  test:assertEquals(0, b, 'check recorded color b')
+  r, g, b = imgdata:getPixel(12, 12)
+  test:assertEquals(0, r, 'check second color r')
+  test:assertEquals(1, b, 'check second color b')
+  shapes:clear()
+  test:assertEquals(0, shapes:getVertexCount(), 'check cleared')
+end
+
+
 -- love.graphics.newSpriteBatch
 -- @NOTE this is just basic nil checking, objs have their own test method
 love.test.graphics.newSpriteBatch = function(test)
@@ -1710,6 +2442,64 @@ end
 love.test.graphics.newTexture = function(test)
   local imgdata = love.image.newImageData('resources/love.png')
   test:assertObject(love.graphics.newTexture(imgdata))
+  local compressed = love.graphics.newTexture(imgdata, { compress = 'DXT5', mipmaps = true })
+  test:assertObject(compressed)
+  test:assertTrue(compressed:isCompressed(), 'check compressed on import')
+  test:assertEquals(imgdata:getWidth(), compressed:getWidth(), 'check compressed width')
+end
+
+
+-- love.graphics.newStreamingTexture
+love.test.graphics.newStreamingTexture = function(test)
+  local texture = love.graphics.newStreamingTexture('resources/love.dxt1')
+  test:assertObject(texture)
+  test:assertEquals(7, texture:getMipmapCount(), 'check mipmap count')
+  local width = texture:getTexture():getWidth()
+  local size = texture:getResidentMemorySize()
+  texture:setResidentMipmap(3)
+  test:assertEquals(3, texture:getResidentMipmap(), 'check resident mipmap')
+  test:assertEquals(width, texture:getTexture():getWidth(), 'check logical size kept')
+  test:assertGreaterEqual(texture:getResidentMemorySize(), size, 'check memory dropped')
+  test:assertFalse(texture:getResidentMemorySize() == size, 'check memory changed')
+  love.graphics.setTextureStreamingBudget(1024)
+  test:assertEquals(1024, love.graphics.getTextureStreamingBudget(), 'check budget')
+  love.graphics.setTextureStreamingBudget(0)
+end
+
+
+-- love.graphics.newTextureAsync
+love.test.graphics.newTextureAsync = function(test)
+  local imgdata = love.image.newImageData('resources/love.png')
+  local texture, upload = love.graphics.newTextureAsync(imgdata, { mipmaps = false })
+  test:assertObject(texture)
+  test:assertObject(upload)
+  test:assertEquals(texture, upload:getTexture(), 'check upload texture')
+  test:assertEquals(imgdata:getWidth(), texture:getPixelWidth(), 'check width')
+  -- copies are ordered before later reads, so the data is already visible
+  local readback = love.graphics.readbackTexture(texture)
+  test:assertEquals(imgdata:getString(), readback:getString(), 'check uploaded pixels')
+  local replacement = love.image.newImageData(4, 4, imgdata:getFormat())
+  local replaced = texture:replacePixelsAsync(replacement, nil, 1, 0, 0)
+  test:assertObject(replaced)
+  local r, g, b, a = love.graphics.readbackTexture(texture):getPixel(0, 0)
+  test:assertEquals(0, a, 'check replaced pixels')
+end
+
+
+-- love.graphics.newBufferAsync
+love.test.graphics.newBufferAsync = function(test)
+  local data = love.data.newByteData(4 * 4)
+  local values = love.data.pack('string', 'ffff', 1, 2, 3, 4)
+  data:setString(values)
+  local buffer, upload = love.graphics.newBufferAsync('float', data, {vertex = true})
+  test:assertObject(buffer)
+  test:assertObject(upload)
+  test:assertEquals(buffer, upload:getBuffer(), 'check upload buffer')
+  test:assertEquals(4, buffer:getElementCount(), 'check element count')
+  -- using the buffer waits for the upload to finish
+  local readback = love.graphics.readbackBuffer(buffer)
+  test:assertEquals(values, readback:getString(), 'check uploaded data')
+  test:assertTrue(upload:isComplete(), 'check upload complete')
 end
 
 
@@ -1723,6 +2513,40 @@ love.test.graphics.newVideo = function(test)
 end
 
 
+-- love.graphics.newVirtualTexture
+love.test.graphics.newVirtualTexture = function(test)
+  local vt = love.graphics.newVirtualTexture(40, 24, {tilesize = 16, cachesize = 3})
+  test:assertObject(vt)
+  local tw, th = vt:getTileCount()
+  test:assertEquals(3, tw, 'check tile columns')
+  test:assertEquals(2, th, 'check tile rows')
+  test:assertEquals(0, vt:getResidentTileCount(), 'check empty cache')
+  test:assertEquals(3, vt:getIndirectionTexture():getWidth(), 'check indirection width')
+  test:assertEquals(54, vt:getCacheTexture():getWidth(), 'check cache width')
+  -- edge tiles are cropped to the virtual texture's size
+  test:assertFalse(pcall(vt.setTile, vt, 2, 0, love.image.newImageData(16, 16)), 'check edge tile size')
+  test:assertFalse(pcall(vt.setTile, vt, 3, 0, love.image.newImageData(16, 16)), 'check invalid tile')
+  local tile = love.image.newImageData(16, 16)
+  tile:mapPixel(function() return 1, 0, 0, 1 end)
+  vt:setTile(1, 0, tile)
+  test:assertTrue(vt:isTileResident(1, 0), 'check resident')
+  test:assertFalse(vt:isTileResident(0, 0), 'check not resident')
+  test:assertEquals(1, vt:getResidentTileCount(), 'check resident count')
+  -- only resident tiles are drawn, and the visible ones are requested
+  local canvas = love.graphics.newCanvas(40, 24)
+  love.graphics.setCanvas(canvas)
+    love.graphics.clear(0, 0, 0, 1)
+    love.graphics.draw(vt)
+  love.graphics.setCanvas()
+  local imgdata = love.graphics.readbackTexture(canvas)
+  local r, g, b = imgdata:getPixel(20, 8)
+  test:assertEquals(1, r, 'check resident tile drawn')
+  r, g, b = imgdata:getPixel(4, 8)
+  test:assertEquals(0, r, 'check missing tile not drawn')
+  test:assertEquals(5, #vt:getPendingTiles(), 'check pending tiles')
+end
+
+
 -- love.graphics.newVolumeImage
 -- @NOTE this is just basic nil checking, objs have their own test method
 love.test.graphics.newVolumeImage = function(test)
@@ -1783,6 +2607,17 @@ love.test.graphics.getBackgroundColor = function(test)
 end
 
 
+-- love.graphics.getBatchSortMode
+love.test.graphics.getBatchSortMode = function(test)
+  -- check default sort mode
+  test:assertEquals('none', love.graphics.getBatchSortMode())
+  -- check set value returned correctly
+  love.graphics.setBatchSortMode('safe')
+  test:assertEquals('safe', love.graphics.getBatchSortMode())
+  love.graphics.setBatchSortMode('none') -- reset
+end
+
+
 -- love.graphics.getBlendMode
 love.test.graphics.getBlendMode = function(test)
   -- check default blend mode
@@ -2001,6 +2836,27 @@ love.test.graphics.getStencilState = function(test)
 end
 
 
+-- love.graphics.getTemporaryCanvas
+love.test.graphics.getTemporaryCanvas = function(test)
+  local canvas = love.graphics.getTemporaryCanvas(16, 16)
+  test:assertObject(canvas)
+  test:assertEquals(16, canvas:getPixelWidth(), 'check temporary canvas width')
+  test:assertEquals(false, canvas:isMemoryless(), 'check canvas not memoryless')
+  -- drawing to it works like any other canvas
+  love.graphics.setCanvas(canvas)
+    love.graphics.clear(1, 0, 0, 1)
+  love.graphics.setCanvas()
+  local imgdata = love.graphics.readbackTexture(canvas)
+  local r, g, b, a = imgdata:getPixel(0, 0)
+  test:assertEquals(1, r, 'check temporary canvas contents')
+  -- released canvases are reused for matching requests
+  love.graphics.releaseTemporaryCanvas(canvas)
+  local other = love.graphics.getTemporaryCanvas(16, 16)
+  test:assertEquals(canvas, other, 'check temporary canvas reused')
+  love.graphics.releaseTemporaryCanvas(other)
+end
+
+
 -- love.graphics.intersectScissor
 love.test.graphics.intersectScissor = function(test)
   -- make a scissor for the left half, then interset to make the top half
@@ -2027,6 +2883,15 @@ love.test.graphics.isActive = function(test)
 end
 
 
+-- love.graphics.isAsyncCompute
+love.test.graphics.isAsyncCompute = function(test)
+  test:assertFalse(love.graphics.isAsyncCompute(), 'check off by default')
+  love.graphics.setAsyncCompute(true)
+  test:assertTrue(love.graphics.isAsyncCompute(), 'check async compute is set')
+  love.graphics.setAsyncCompute(false) -- reset
+end
+
+
 -- love.graphics.isGammaCorrect
 love.test.graphics.isGammaCorrect = function(test)
   -- we know the config so know this is false
@@ -2034,6 +2899,24 @@ love.test.graphics.isGammaCorrect = function(test)
 end
 
 
+-- love.graphics.isShaderCacheEnabled
+love.test.graphics.isShaderCacheEnabled = function(test)
+  test:assertFalse(love.graphics.isShaderCacheEnabled(), 'check off by default')
+  love.graphics.setShaderCacheEnabled(true)
+  test:assertTrue(love.graphics.isShaderCacheEnabled(), 'check cache is set')
+  love.graphics.setShaderCacheEnabled(false) -- reset
+end
+
+
+-- love.graphics.isTextureArrayBatching
+love.test.graphics.isTextureArrayBatching = function(test)
+  test:assertFalse(love.graphics.isTextureArrayBatching(), 'check off by default')
+  love.graphics.setTextureArrayBatching(true)
+  test:assertTrue(love.graphics.isTextureArrayBatching(), 'check batching is set')
+  love.graphics.setTextureArrayBatching(false) -- reset
+end
+
+
 -- love.graphics.isWireframe
 love.test.graphics.isWireframe = function(test)
   local name, version, vendor, device = love.graphics.getRendererInfo()
@@ -2050,6 +2933,50 @@ love.test.graphics.isWireframe = function(test)
 end
 
 
+-- love.graphics.pushClip
+-- @NOTE also tests love.graphics.popClip and love.graphics.getClipDepth
+love.test.graphics.pushClip = function(test)
+  local canvas = love.graphics.newCanvas(16, 16)
+  love.graphics.setCanvas({canvas, stencil = true})
+    love.graphics.clear(0, 0, 0, 1)
+    love.graphics.origin()
+    -- axis-aligned clips only use the scissor, even when scaled
+    love.graphics.push()
+    love.graphics.scale(2, 2)
+    test:assertFalse(love.graphics.pushClip(0, 0, 4, 8), 'check scissor used')
+    love.graphics.pop()
+    test:assertEquals(1, love.graphics.getClipDepth(), 'check clip depth')
+    local x, y, w, h = love.graphics.getScissor()
+    test:assertEquals(8, w, 'check scissor width')
+    test:assertEquals(16, h, 'check scissor height')
+    -- rotated clips fall back to the stencil buffer and nest
+    love.graphics.push()
+    love.graphics.translate(8, 8)
+    love.graphics.rotate(math.pi / 4)
+    test:assertTrue(love.graphics.pushClip(-4, -4, 8, 8), 'check stencil used')
+    test:assertTrue(love.graphics.pushClip(-2, -2, 4, 4), 'check nested stencil used')
+    love.graphics.pop()
+    test:assertEquals(3, love.graphics.getClipDepth(), 'check nested clip depth')
+    love.graphics.setColor(1, 0, 0, 1)
+    love.graphics.rectangle('fill', 0, 0, 16, 16)
+    love.graphics.setColor(1, 1, 1, 1)
+    love.graphics.popClip()
+    love.graphics.popClip()
+    love.graphics.popClip()
+    test:assertEquals(0, love.graphics.getClipDepth(), 'check clips popped')
+    test:assertEquals(nil, love.graphics.getScissor(), 'check scissor restored')
+    test:assertEquals('off', love.graphics.getStencilMode(), 'check stencil restored')
+  love.graphics.setCanvas()
+  local imgdata = love.graphics.readbackTexture(canvas)
+  -- only the middle of the left half is filled
+  test:assertEquals(1, imgdata:getPixel(7, 7), 'check inside clip')
+  test:assertEquals(0, imgdata:getPixel(8, 8), 'check outside scissor')
+  test:assertEquals(0, imgdata:getPixel(3, 3), 'check outside nested stencil')
+  -- popping an empty stack is an error
+  test:assertFalse(pcall(love.graphics.popClip), 'check pop error')
+end
+
+
 -- love.graphics.reset
 love.test.graphics.reset = function(test)
   -- reset should reset current canvas and any colors/scissor
@@ -2083,6 +3010,48 @@ love.test.graphics.setBackgroundColor = function(test)
 end
 
 
+-- love.graphics.setBatchSortMode
+love.test.graphics.setBatchSortMode = function(test)
+  -- interleave draws from two textures, which normally breaks the batch
+  local red = love.graphics.newCanvas(1, 1)
+  local blue = love.graphics.newCanvas(1, 1)
+  love.graphics.setCanvas(red)
+    love.graphics.clear(1, 0, 0, 1)
+  love.graphics.setCanvas(blue)
+    love.graphics.clear(0, 0, 1, 1)
+  love.graphics.setCanvas()
+  local function drawinterleaved(mode)
+    local canvas = love.graphics.newCanvas(16, 16)
+    love.graphics.setCanvas(canvas)
+      love.graphics.clear(0, 0, 0, 1)
+      love.graphics.setBatchSortMode(mode)
+      love.graphics.flushBatch()
+      local before = love.graphics.getStats().drawcalls
+      for i=0,7 do
+        love.graphics.draw(i % 2 == 0 and red or blue, i*2, 0, 0, 2, 16)
+      end
+      love.graphics.flushBatch()
+      local after = love.graphics.getStats().drawcalls
+      love.graphics.setBatchSortMode('none')
+    love.graphics.setCanvas()
+    return after - before, love.graphics.readbackTexture(canvas)
+  end
+  local unsorted, unsortedimg = drawinterleaved('none')
+  local sorted, sortedimg = drawinterleaved('always')
+  test:assertEquals(8, unsorted, 'check unsorted draws are not batched')
+  test:assertEquals(2, sorted, 'check sorted draws are batched per texture')
+  -- non-overlapping draws should give the same result in either mode
+  for x=0,15 do
+    local r1, g1, b1 = unsortedimg:getPixel(x, 8)
+    local r2, g2, b2 = sortedimg:getPixel(x, 8)
+    test:assertEquals(r1+g1*2+b1*4, r2+g2*2+b2*4, 'check pixel ' .. x .. ' matches')
+  end
+  -- alpha blending isn't order independent, so 'safe' shouldn't reorder
+  local safe = drawinterleaved('safe')
+  test:assertEquals(8, safe, 'check safe mode keeps order with alpha blending')
+end
+
+
 -- love.graphics.setBlendMode
 love.test.graphics.setBlendMode = function(test)
   -- create fully white canvas, then draw diff. pixels through blendmodes
@@ -2129,6 +3098,14 @@ love.test.graphics.setCanvas = function(test)
   test:compareImg(imgdata)
   local imgdata2 = love.graphics.readbackTexture(canvas2, 1, 2) -- readback mipmap
   test:compareImg(imgdata2)
+  -- per-target load and store actions
+  love.graphics.setCanvas({{canvas1, load = 'clear'}})
+  love.graphics.setCanvas()
+  local r, g, b, a = love.graphics.readbackTexture(canvas1):getPixel(0, 0)
+  test:assertEquals(0, a, 'check load clear action')
+  love.graphics.setCanvas({{canvas1, store = 'discard'}})
+    test:assertEquals('discard', love.graphics.getCanvas()[1].store, 'check store action')
+  love.graphics.setCanvas()
 end
 
 
@@ -2211,6 +3188,24 @@ love.test.graphics.setDepthMode = function(test)
 end
 
 
+-- love.graphics.setDynamicResolution
+love.test.graphics.setDynamicResolution = function(test)
+  test:assertFalse(love.graphics.isDynamicResolutionEnabled(), 'check disabled by default')
+  test:assertEquals(1, love.graphics.getDynamicResolutionScale(), 'check default scale')
+  love.graphics.setDynamicResolution(true, {scale = 0.5, minscale = 0.5, maxscale = 1})
+  test:assertTrue(love.graphics.isDynamicResolutionEnabled(), 'check enabled')
+  test:assertRange(love.graphics.getDynamicResolutionScale(), 0.5, 1, 'check scale in range')
+  -- the internal canvas stands in for the screen
+  love.graphics.setCanvas()
+  test:assertEquals(nil, love.graphics.getCanvas(), 'check screen canvas hidden')
+  test:waitFrames(2)
+  test:assertRange(love.graphics.getDynamicResolutionScale(), 0.5, 1, 'check scale after present')
+  love.graphics.setDynamicResolution(false)
+  test:assertFalse(love.graphics.isDynamicResolutionEnabled(), 'check disabled')
+  test:assertEquals(1, love.graphics.getDynamicResolutionScale(), 'check scale reset')
+end
+
+
 -- love.graphics.setFont
 love.test.graphics.setFont = function(test)
   -- set font doesnt return anything so draw with the test font
@@ -2402,6 +3397,28 @@ love.test.graphics.setShader = function(test)
 end
 
 
+-- love.graphics.setShaderCacheEnabled
+love.test.graphics.setShaderCacheEnabled = function(test)
+  local pixelcode = 'vec4 effect(vec4 c, Image tex, vec2 tc, vec2 pc) { return vec4(0.0, 0.0, 1.0, 1.0); }'
+  love.graphics.setShaderCacheEnabled(true)
+  -- the second shader should be loaded from the cached program if supported
+  for i=1,2 do
+    local shader = love.graphics.newShader(pixelcode)
+    local canvas = love.graphics.newCanvas(4, 4)
+    love.graphics.setCanvas(canvas)
+      love.graphics.clear(0, 0, 0, 1)
+      love.graphics.setShader(shader)
+      love.graphics.rectangle('fill', 0, 0, 4, 4)
+      love.graphics.setShader()
+    love.graphics.setCanvas()
+    local imgdata = love.graphics.readbackTexture(canvas)
+    local r, g, b, a = imgdata:getPixel(2, 2)
+    test:assertEquals(1, b, 'check shader output ' .. i)
+  end
+  love.graphics.setShaderCacheEnabled(false)
+end
+
+
 -- love.graphics.setStencilState
 love.test.graphics.setStencilState = function(test)
   local canvas = love.graphics.newCanvas(16, 16)
@@ -2420,6 +3437,39 @@ love.test.graphics.setStencilState = function(test)
 end
 
 
+-- love.graphics.setTextureArrayBatching
+love.test.graphics.setTextureArrayBatching = function(test)
+  local red = love.image.newImageData(1, 1)
+  red:setPixel(0, 0, 1, 0, 0, 1)
+  local green = love.image.newImageData(1, 1)
+  green:setPixel(0, 0, 0, 1, 0, 1)
+  local images = {love.graphics.newImage(red), love.graphics.newImage(green)}
+  local canvas = love.graphics.newCanvas(16, 16)
+  love.graphics.setTextureArrayBatching(true)
+  love.graphics.setCanvas(canvas)
+    love.graphics.clear(0, 0, 0, 1)
+    -- draw enough times for both images to be moved into an array texture
+    for y=0,15 do
+      for x=0,15 do
+        love.graphics.draw(images[(x + y) % 2 + 1], x, y)
+      end
+    end
+  love.graphics.setCanvas()
+  love.graphics.setTextureArrayBatching(false)
+  local imgdata = love.graphics.readbackTexture(canvas)
+  for y=0,15 do
+    for x=0,15 do
+      local r, g, b, a = imgdata:getPixel(x, y)
+      if (x + y) % 2 == 0 then
+        test:assertEquals(1, r, 'check red pixel ' .. x .. ',' .. y)
+      else
+        test:assertEquals(1, g, 'check green pixel ' .. x .. ',' .. y)
+      end
+    end
+  end
+end
+
+
 -- love.graphics.setWireframe
 love.test.graphics.setWireframe = function(test)
   local name, version, vendor, device = love.graphics.getRendererInfo()
@@ -2637,6 +3687,29 @@ love.test.graphics.shear = function(test)
 end
 
 
+-- love.graphics.startRecording
+love.test.graphics.startRecording = function(test)
+  if not love.graphics.getSupported().backbuffercapture then
+    test:skipTest('backbuffer capture is not supported on this system')
+    return
+  end
+  test:assertFalse(love.graphics.isRecording(), 'check not recording')
+  love.graphics.startRecording('recording-test', {buffers = 2})
+  test:assertTrue(love.graphics.isRecording(), 'check recording')
+  test:waitFrames(3)
+  -- stopping waits for the frames still being read back and encoded
+  local recorded, dropped = love.graphics.stopRecording()
+  test:assertFalse(love.graphics.isRecording(), 'check recording stopped')
+  test:assertGreaterEqual(1, recorded, 'check frames recorded')
+  test:assertGreaterEqual(0, dropped, 'check dropped count')
+  test:assertNotEquals(nil, love.filesystem.getInfo('recording-test/000001.qoi'), 'check first frame written')
+  for _, file in ipairs(love.filesystem.getDirectoryItems('recording-test')) do
+    love.filesystem.remove('recording-test/' .. file)
+  end
+  love.filesystem.remove('recording-test')
+end
+
+
 -- love.graphics.transformPoint
 love.test.graphics.transformPoint = function(test)
   -- start with 0, 0
@@ -2790,12 +3863,54 @@ end
 love.test.graphics.getStats = function(test)
   local stattypes = {
     'drawcalls', 'canvasswitches', 'texturememory', 'shaderswitches',
-    'drawcallsbatched', 'textures', 'fonts'
+    'drawcallsbatched', 'textures', 'fonts', 'streambuffermemory',
+    'streambufferused', 'streambufferstalls', 'gputime', 'gpuscopes',
+    'framebuffers', 'framebuffercachehits', 'framebuffercachemisses',
+    'memoryheaps'
   }
   local stats = love.graphics.getStats()
   for s=1,#stattypes do
     test:assertNotEquals(nil, stats[stattypes[s] ], 'expected a key for stat: ' .. stattypes[s])
   end
+  for i=1,#stats.memoryheaps do
+    test:assertNotEquals(nil, stats.memoryheaps[i].usage, 'check heap usage')
+    test:assertNotEquals(nil, stats.memoryheaps[i].budget, 'check heap budget')
+  end
+end
+
+
+-- love.graphics.defragmentMemory
+love.test.graphics.defragmentMemory = function(test)
+  local buffer = love.graphics.newBuffer('float', {1, 2, 3, 4}, {vertex = true})
+  local complete, moved = love.graphics.defragmentMemory(1024 * 1024)
+  test:assertEquals('boolean', type(complete), 'check completion result')
+  test:assertEquals(true, moved >= 0, 'check bytes moved')
+  local data = love.graphics.readbackBuffer(buffer)
+  test:assertEquals(3, data:getFloat(8), 'check buffer contents are kept')
+end
+
+
+-- love.graphics.beginGPUScope
+-- love.graphics.endGPUScope
+love.test.graphics.beginGPUScope = function(test)
+  local canvas = love.graphics.newCanvas(16, 16)
+  love.graphics.setCanvas(canvas)
+    love.graphics.beginGPUScope('outer')
+      love.graphics.clear(1, 0, 0, 1)
+      love.graphics.beginGPUScope('inner')
+        love.graphics.rectangle('fill', 0, 0, 8, 8)
+      love.graphics.endGPUScope()
+    love.graphics.endGPUScope()
+  love.graphics.setCanvas()
+  local stats = love.graphics.getStats()
+  test:assertEquals('number', type(stats.gputime), 'check gputime type')
+  test:assertEquals('table', type(stats.gpuscopes), 'check gpuscopes type')
+  for i=1,#stats.gpuscopes do
+    local scope = stats.gpuscopes[i]
+    test:assertEquals('string', type(scope.name), 'check scope name')
+    test:assertGreaterEqual(0, scope.time, 'check scope time')
+    test:assertGreaterEqual(0, scope.depth, 'check scope depth')
+  end
 end
 
 
@@ -2807,7 +3922,7 @@ love.test.graphics.getSupported = function(test)
     'clampzero', 'lighten', 'glsl3', 'instancing', 'fullnpot', 
     'pixelshaderhighp', 'shaderderivatives', 'indirectdraw',
     'copytexturetobuffer', 'multirendertargetformats', 
-    'clampone', 'glsl4'
+    'clampone', 'glsl4', 'asynccompute', 'backbuffercapture'
   }
   local features = love.graphics.getSupported()
   for g=1,#gfs do
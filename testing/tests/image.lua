@@ -19,6 +19,11 @@ love.test.image.CompressedImageData = function(test)
   test:assertNotEquals(nil, idata:getString(), 'check data string')
   test:assertEquals(2744, idata:getSize(), 'check data size')
 
+  -- mipmaps are read in place from the file, clones copy only the mipmaps
+  local clone = idata:clone()
+  test:assertEquals(idata:getSize(), clone:getSize(), 'check clone size')
+  test:assertEquals(idata:getString(), clone:getString(), 'check clone data')
+
   -- check img dimensions
   local iw, ih = idata:getDimensions()
   test:assertEquals(64, iw, 'check image dimension w')
@@ -60,6 +65,30 @@ love.test.image.ImageData = function(test)
 
   -- check format
   test:assertEquals('rgba8', idata:getFormat(), 'check image format')
+
+  -- clones share pixels until one of them is modified
+  local clone = idata:clone()
+  local r1, g1, b1, a1 = idata:getPixel(0, 0)
+  clone:setPixel(0, 0, 1, 0, 1, 1)
+  local r2, g2, b2, a2 = idata:getPixel(0, 0)
+  test:assertEquals(r1, r2, 'check original r unchanged by clone')
+  test:assertEquals(g1, g2, 'check original g unchanged by clone')
+  test:assertEquals(b1, b2, 'check original b unchanged by clone')
+  test:assertEquals(a1, a2, 'check original a unchanged by clone')
+  local cr, cg = clone:getPixel(0, 0)
+  test:assertEquals(1, cr, 'check clone r set')
+  test:assertEquals(0, cg, 'check clone g set')
+
+  -- modifying the original after cloning leaves the clone alone
+  local clone2 = idata:clone()
+  local c1, c2, c3, c4 = clone2:getPixel(1, 1)
+  idata:setPixel(1, 1, 0, 1, 0, 1)
+  local n1, n2, n3, n4 = clone2:getPixel(1, 1)
+  test:assertEquals(c1, n1, 'check clone r unchanged by original')
+  test:assertEquals(c2, n2, 'check clone g unchanged by original')
+  test:assertEquals(c3, n3, 'check clone b unchanged by original')
+  test:assertEquals(c4, n4, 'check clone a unchanged by original')
+  idata:setPixel(1, 1, c1, c2, c3, c4)
   
   -- manipulate image data so white heart is black
   local mapdata = function(x, y, r, g, b, a)
@@ -96,6 +125,71 @@ love.test.image.ImageData = function(test)
   test:assertNotNil(read2)
   love.filesystem.remove('test-encode.exr')
 
+  -- check encoding to qoi, with compression levels, and in the background
+  local qoidata = love.image.newImageData(idata:encode('qoi'))
+  test:assertEquals(64, qoidata:getWidth(), 'check qoi width')
+  local qr, qg, qb = qoidata:getPixel(25, 25)
+  test:assertEquals(1, qr+qg+qb, 'check qoi pixel')
+  local fastdata = love.image.newImageData(idata:encode('png', nil, 1))
+  qr, qg, qb = fastdata:getPixel(25, 25)
+  test:assertEquals(1, qr+qg+qb, 'check fast png pixel')
+  local encodejob = idata:encodeAsync('png', nil, 9)
+  local asyncdata = love.image.newImageData(encodejob:getFileData())
+  test:assertTrue(encodejob:isComplete(), 'check async encode complete')
+  qr, qg, qb = asyncdata:getPixel(25, 25)
+  test:assertEquals(1, qr+qg+qb, 'check async png pixel')
+
+  -- check built-in pixel operations
+  local odata = love.image.newImageData(1024, 1024)
+  odata:applyOperation('fill', {1, 0.5, 0, 1})
+  local r3, g3, b3, a3 = odata:getPixel(1000, 1000)
+  test:assertEquals(1, r3, 'check fill r')
+  test:assertEquals(128, math.floor(g3*255+0.5), 'check fill g')
+  odata:applyOperation('swizzle', 'bgra', 0, 0, 512, 512)
+  r3, g3, b3, a3 = odata:getPixel(10, 10)
+  test:assertEquals(0, r3, 'check swizzle r')
+  test:assertEquals(1, b3, 'check swizzle b')
+  r3 = odata:getPixel(600, 600)
+  test:assertEquals(1, r3, 'check swizzle rect')
+  odata:applyOperation('threshold', 0.6)
+  r3, g3, b3, a3 = odata:getPixel(1000, 1000)
+  test:assertEquals(0, g3, 'check threshold')
+  odata:applyOperation('multiply', {0.5, 0.5, 0.5, 1})
+  r3, g3, b3, a3 = odata:getPixel(1000, 1000)
+  test:assertEquals(128, math.floor(r3*255+0.5), 'check multiply')
+  odata:applyOperation('blend', {0, 0, 1, 1})
+  r3, g3, b3, a3 = odata:getPixel(1000, 1000)
+  test:assertEquals(0, r3, 'check blend r')
+  test:assertEquals(1, b3, 'check blend b')
+  odata:applyOperation('fill', {1, 1, 1, 0.5})
+  odata:applyOperation('premultiply', 0, 0, 16, 16)
+  r3, g3, b3, a3 = odata:getPixel(0, 0)
+  test:assertEquals(128, math.floor(r3*255+0.5), 'check premultiply')
+  odata:applyOperation('unpremultiply', 0, 0, 16, 16)
+  r3, g3, b3, a3 = odata:getPixel(0, 0)
+  test:assertEquals(1, r3, 'check unpremultiply')
+
+  -- check format converting paste and scaled blit
+  local rdata = love.image.newImageData(4, 4, 'r8')
+  rdata:setPixel(1, 1, 1, 0, 0, 1)
+  odata:paste(rdata, 0, 0)
+  r3, g3, b3, a3 = odata:getPixel(1, 1)
+  test:assertEquals(1, r3, 'check r8 paste r')
+  test:assertEquals(1, a3, 'check r8 paste a')
+  local fdata = love.image.newImageData(64, 64, 'rgba32f')
+  fdata:paste(odata, 0, 0)
+  r3 = fdata:getPixel(1, 1)
+  test:assertEquals(1, r3, 'check rgba32f paste')
+  local bdata = love.image.newImageData(8, 8)
+  bdata:blit(rdata, 0, 0, 8, 8, 'nearest')
+  r3, g3, b3, a3 = bdata:getPixel(2, 2)
+  test:assertEquals(1, r3, 'check nearest blit')
+  r3 = bdata:getPixel(0, 0)
+  test:assertEquals(0, r3, 'check nearest blit corner')
+  bdata:blit(fdata, 0, 0, 8, 8, 'linear', 0, 0, 2, 2)
+  r3 = bdata:getPixel(4, 4)
+  test:assertGreaterEqual(0.2, r3, 'check linear blit')
+
   -- check linear
   test:assertFalse(idata:isLinear(), 'check not linear')
   idata:setLinear(true)
@@ -111,6 +205,14 @@ end
 --------------------------------------------------------------------------------
 
 
+-- love.image.getImageDimensions
+love.test.image.getImageDimensions = function(test)
+  local w, h = love.image.getImageDimensions('resources/love.png')
+  test:assertEquals(64, w, 'check png width')
+  test:assertEquals(64, h, 'check png height')
+end
+
+
 -- love.image.isCompressed
 -- @NOTE really we need to test each of the files listed here:
 -- https://love2d.org/wiki/CompressedImageFormat
@@ -125,6 +227,17 @@ end
 -- @NOTE this is just basic nil checking, objs have their own test method
 love.test.image.newCompressedData = function(test)
   test:assertObject(love.image.newCompressedData('resources/love.dxt1'))
+  -- compressing imagedata directly
+  local imgdata = love.image.newImageData('resources/love.png')
+  local cdata = love.image.newCompressedData(imgdata, 'DXT5')
+  test:assertObject(cdata)
+  test:assertEquals('DXT5', cdata:getFormat(), 'check compressed format')
+  test:assertEquals(imgdata:getWidth(), cdata:getWidth(), 'check compressed width')
+  test:assertEquals(7, cdata:getMipmapCount(), 'check generated mipmaps')
+  local single = love.image.newCompressedData(imgdata, 'DXT1', false)
+  test:assertEquals(1, single:getMipmapCount(), 'check no mipmaps')
+  local encoded = imgdata:encodeCompressed('DXT1', false)
+  test:assertTrue(love.image.isCompressed(encoded), 'check encoded dds')
 end
 
 
@@ -133,4 +246,40 @@ end
 love.test.image.newImageData = function(test)
   test:assertObject(love.image.newImageData('resources/love.png'))
   test:assertObject(love.image.newImageData(16, 16, 'rgba8', nil))
+  -- decoding part of an image, and at a reduced size
+  local full = love.image.newImageData('resources/love.png')
+  local part = love.image.newImageData('resources/love.png', {x = 16, y = 8, width = 20, height = 30})
+  test:assertEquals(20, part:getWidth(), 'check region width')
+  test:assertEquals(30, part:getHeight(), 'check region height')
+  local r1, g1, b1, a1 = full:getPixel(25, 25)
+  local r2, g2, b2, a2 = part:getPixel(9, 17)
+  test:assertEquals(r1, r2, 'check region pixel r')
+  test:assertEquals(a1, a2, 'check region pixel a')
+  local small = love.image.newImageData('resources/love.png', {mipmaplevel = 2})
+  test:assertEquals(16, small:getWidth(), 'check reduced width')
+  test:assertEquals(16, small:getHeight(), 'check reduced height')
+end
+
+
+-- love.image.newImageDataAsync
+love.test.image.newImageDataAsync = function(test)
+  local full = love.image.newImageData('resources/love.png')
+  local job = love.image.newImageDataAsync('resources/love.png')
+  test:assertObject(job)
+  local idata = job:getImageData()
+  test:assertTrue(job:isComplete(), 'check complete')
+  test:assertObject(idata)
+  test:assertEquals(full:getWidth(), idata:getWidth(), 'check width')
+  test:assertEquals(full:getHeight(), idata:getHeight(), 'check height')
+  local r1, g1, b1, a1 = full:getPixel(25, 25)
+  local r2, g2, b2, a2 = idata:getPixel(25, 25)
+  test:assertEquals(r1, r2, 'check pixel r')
+  test:assertEquals(a1, a2, 'check pixel a')
+  -- regions are supported too
+  local part = love.image.newImageDataAsync('resources/love.png', {mipmaplevel = 1}):getImageData()
+  test:assertEquals(32, part:getWidth(), 'check region width')
+  -- errors are raised when the result is requested
+  local bad = love.image.newImageDataAsync(love.filesystem.newFileData('not an image', 'bad.png'))
+  local ok = pcall(bad.getImageData, bad)
+  test:assertEquals(false, ok, 'check decode error')
 end
@@ -30,6 +30,24 @@ love.test.joystick.getJoysticks = function(test)
 end
 
 
+-- love.joystick.getStates
+love.test.joystick.getStates = function(test)
+  local states = love.joystick.getStates()
+  test:assertEquals(love.joystick.getJoystickCount(), #states, 'check count')
+  -- the same table should be filled in again
+  local stale = {{}, {}, {}, {}, {}, {}, {}, {}, {}}
+  local reused = love.joystick.getStates(stale)
+  test:assertEquals(stale, reused, 'check table reused')
+  test:assertEquals(#states, #reused, 'check old entries removed')
+  for i=1,#reused do
+    local joystick = reused[i].joystick
+    test:assertEquals(joystick:getAxisCount(), #reused[i].axes, 'check axes')
+    test:assertEquals(joystick:getButtonCount(), #reused[i].buttons, 'check buttons')
+    test:assertEquals(joystick:getHatCount(), #reused[i].hats, 'check hats')
+  end
+end
+
+
 -- love.joystick.loadGamepadMappings
 love.test.joystick.loadGamepadMappings = function(test)
   local ok, err = pcall(love.joystick.loadGamepadMappings, 'fakefile.txt')
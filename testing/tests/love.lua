@@ -8,6 +8,32 @@
 --------------------------------------------------------------------------------
 
 
+-- love.getStartupTimings
+love.test.love.getStartupTimings = function(test)
+  local timings = love.getStartupTimings()
+  test:assertGreaterEqual(1, #timings, 'check timings recorded')
+  local names = {}
+  for i, v in ipairs(timings) do
+    test:assertEquals('string', type(v.name), 'check phase name ' .. i)
+    test:assertGreaterEqual(0, v.time, 'check phase time ' .. i)
+    test:assertEquals('number', type(v.luamemory), 'check phase lua memory ' .. i)
+    names[v.name] = true
+  end
+  test:assertTrue(names['love.filesystem'], 'check filesystem phase')
+  test:assertTrue(names['filesystem mount'], 'check mount phase')
+  test:assertTrue(names['conf'], 'check conf phase')
+end
+
+
+-- love.getStartupReport
+love.test.love.getStartupReport = function(test)
+  local report = love.getStartupReport()
+  test:assertEquals('string', type(report), 'check report is a string')
+  test:assertNotEquals(nil, report:find('conf', 1, true), 'check conf phase listed')
+  test:assertNotEquals(nil, report:find('total', 1, true), 'check total listed')
+end
+
+
 -- love.getVersion
 love.test.love.getVersion = function(test)
   local major, minor, revision, codename = love.getVersion()
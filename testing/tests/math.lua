@@ -60,6 +60,23 @@ love.test.math.BezierCurve = function(test)
   test:assertEquals(196, #coords1, 'check coords')
   test:assertEquals(20, #coords2, 'check segment coords')
 
+  -- check render lists reuse a given table
+  local reused = curve:render(5, coords2)
+  test:assertEquals(coords2, reused, 'check reused table')
+  test:assertEquals(196, #reused, 'check reused coords')
+  curve:renderSegment(0, 0.1, 5, reused)
+  test:assertEquals(20, #reused, 'check reused segment coords')
+
+  -- check adaptive rendering
+  local coarse, coarsecount = curve:renderAdaptive(1)
+  local fine, finecount = curve:renderAdaptive(0.01)
+  test:assertEquals(coarsecount * 2, #coarse, 'check adaptive coords')
+  test:assertGreaterEqual(coarsecount + 1, finecount, 'check adaptive tolerance')
+  test:assertEquals(1, fine[1], 'check adaptive start x')
+  test:assertEquals(3, fine[#fine - 1], 'check adaptive end x')
+  local _, segmentcount = curve:renderAdaptive(0.01, 0, 0.5, fine)
+  test:assertEquals(segmentcount * 2, #fine, 'check adaptive segment coords')
+
   -- check translation values
   px, py = curve:getControlPoint(2)
   test:assertCoords({3, 2}, {px, py}, 'check pretransform x/y')
@@ -104,6 +121,32 @@ love.test.math.RandomGenerator = function(test)
   test:assertNotEquals(rng1:random(), rng2:random(), 'check not matching states')
   test:assertNotEquals(rng1:randomNormal(), rng2:randomNormal(), 'check not matching states')
 
+  -- check bulk fills give the same numbers as individual calls
+  rng2:setState(rng1:getState())
+  local values = rng1:randomFill({}, 40000)
+  local matching = true
+  for i=1,40000 do
+    if values[i] ~= rng2:random() then matching = false end
+  end
+  test:assertTrue(matching, 'check randomFill matches random')
+  rng1:randomFill(values, 100, 5, 10)
+  matching = true
+  for i=1,100 do
+    if values[i] ~= rng2:random(5, 10) then matching = false end
+  end
+  test:assertTrue(matching, 'check randomFill range matches random')
+  local data = love.data.newByteData(8 * 101)
+  rng1:randomNormalFill(data, 101, 2, 3)
+  local first = love.data.unpack('d', data:getString())
+  test:assertEquals(rng2:randomNormal(2, 3), first, 'check randomNormalFill matches randomNormal')
+  for i=2,101 do rng2:randomNormal(2, 3) end
+  test:assertEquals(rng1:getState(), rng2:getState(), 'check states match after fill')
+
+  -- check jumped generators give different numbers
+  rng2:setState(rng1:getState())
+  rng2:jump()
+  test:assertNotEquals(rng1:random(), rng2:random(), 'check jumped state')
+
 end
 
 
@@ -164,6 +207,31 @@ love.test.math.Transform = function(test)
   transform:setMatrix(1, 3, 4, 5.5, 1, 4.5, 2, 1, 3.4, 5.1, 4.1, 13, 1, 1, 2, 3)
   test:assertFalse(transform:isAffine2DTransform(), 'check not affine')
 
+  -- check batched point transforms
+  transform:setTransformation(10, 20, 0, 2, 2)
+  local points = transform:transformPoints({1, 1, 2, 3, 0, 0, -1, 4, 5, 5})
+  test:assertEquals(10, #points, 'check batch point count')
+  test:assertCoords({12, 22}, {points[1], points[2]}, 'check batch point 1')
+  test:assertCoords({20, 30}, {points[9], points[10]}, 'check batch point 5')
+  local back = transform:inverseTransformPoints(points, points)
+  test:assertCoords({-1, 4}, {back[7], back[8]}, 'check batch inverse point')
+  local pointdata = love.data.newByteData(love.data.pack('string', 'ffffffffff', 1, 1, 2, 3, 0, 0, -1, 4, 5, 5))
+  transform:transformPoints(pointdata)
+  local x5, y5 = love.data.unpack('ff', pointdata, 33)
+  test:assertCoords({20, 30}, {x5, y5}, 'check batch data points')
+
+  -- check argument handling matches the regular methods
+  transform:reset()
+  transform:scale(2)
+  transform:translate('3', 1)
+  px, py = transform:transformPoint(1, '1')
+  test:assertCoords({8, 4}, {px, py}, 'check number string arguments')
+  local ok = pcall(transform.translate, transform, {}, 1)
+  test:assertFalse(ok, 'check invalid argument errors')
+  transform3:release()
+  ok = pcall(transform3.rotate, transform3, 1)
+  test:assertFalse(ok, 'check released transform errors')
+
 end
 
 
@@ -220,6 +288,25 @@ love.test.math.colorToBytes = function(test)
 end
 
 
+-- love.math.fillNoise
+love.test.math.fillNoise = function(test)
+  -- check a float grid matches the single value functions
+  local grid = love.data.newByteData(4*4*4)
+  love.math.fillNoise(grid, 4, 4, {x = 0.5, y = 0.25, frequency = 0.1})
+  local value = love.data.unpack('f', grid, (4*2 + 3)*4 + 1)
+  test:assertRange(value - love.math.simplexNoise(0.8, 0.45), -0.0001, 0.0001, 'check simplex grid value')
+  love.math.fillNoise(grid, 4, 4, {type = 'perlin', frequency = 0.3, z = 2, octaves = 3})
+  value = love.data.unpack('f', grid, 4*5 + 1)
+  test:assertRange(value, 0, 1, 'check fractal value range')
+  -- check filling an imagedata
+  local imgdata = love.image.newImageData(16, 16, 'r32f')
+  test:assertEquals(imgdata, love.math.fillNoise(imgdata, {octaves = 4}), 'check imagedata returned')
+  local r = imgdata:getPixel(5, 9)
+  test:assertRange(r, 0, 1, 'check imagedata value range')
+  test:assertEquals(false, pcall(love.math.fillNoise, grid, 8, 8), 'check data too small')
+end
+
+
 -- love.math.gammaToLinear
 -- @NOTE I tried doing the same formula as the source from MathModule.cpp
 -- but get test failues due to slight differences
@@ -233,6 +320,31 @@ love.test.math.gammaToLinear = function(test)
 end
 
 
+-- love.math.gammaToLinearColors
+love.test.math.gammaToLinearColors = function(test)
+  local colors = {1, 0.8, 0.02, 0.5, 0.3, 0.001, 0.7, 0.25}
+  love.math.gammaToLinearColors(colors)
+  local er, eg, eb = love.math.gammaToLinear(1, 0.8, 0.02)
+  test:assertRange(colors[1], er - 0.000001, er + 0.000001, 'check color r')
+  test:assertRange(colors[2], eg - 0.000001, eg + 0.000001, 'check color g')
+  test:assertRange(colors[3], eb - 0.000001, eb + 0.000001, 'check color b')
+  test:assertEquals(0.5, colors[4], 'check alpha is unchanged')
+  -- converting back should give the original colors
+  love.math.linearToGammaColors(colors)
+  test:assertRange(colors[6], 0.00099, 0.00101, 'check round trip')
+  test:assertRange(colors[7], 0.69999, 0.70001, 'check round trip')
+  -- data of floats, with 3 components
+  local data = love.data.newByteData(4 * 3)
+  data:setString(love.data.pack('string', 'fff', 0.2, 0.4, 0.6))
+  love.math.gammaToLinearColors(data, 3)
+  local r, g, b = love.data.unpack('fff', data:getString())
+  local lr, lg, lb = love.math.gammaToLinear(0.2, 0.4, 0.6)
+  test:assertRange(r, lr - 0.000001, lr + 0.000001, 'check data r')
+  test:assertRange(g, lg - 0.000001, lg + 0.000001, 'check data g')
+  test:assertRange(b, lb - 0.000001, lb + 0.000001, 'check data b')
+end
+
+
 -- love.math.getRandomSeed
 -- @NOTE whenever i run this high is always 0, is that intended?
 love.test.math.getRandomSeed = function(test)
@@ -270,6 +382,19 @@ love.test.math.linearToGamma = function(test)
 end
 
 
+-- love.math.multiplyTransformHierarchy
+love.test.math.multiplyTransformHierarchy = function(test)
+  local function translation(x, y)
+    return love.data.pack('string', 'ffffffffffffffff', 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, x, y, 0, 1)
+  end
+  local locals = love.data.newByteData(translation(1, 2) .. translation(3, 4) .. translation(5, 6))
+  love.math.multiplyTransformHierarchy(locals, {0, 1, 2})
+  local x, y = love.data.unpack('ff', locals, 64*2 + 48 + 1)
+  test:assertCoords({9, 12}, {x, y}, 'check combined translation')
+  test:assertEquals(false, pcall(love.math.multiplyTransformHierarchy, locals, {0, 3, 1}), 'check invalid parent')
+end
+
+
 -- love.math.newBezierCurve
 -- @NOTE this is just basic nil checking, objs have their own test method
 love.test.math.newBezierCurve = function(test)
@@ -366,3 +491,32 @@ love.test.math.triangulate = function(test)
   test:assertEquals(3, #triangles1, 'check polygon triangles')
   test:assertEquals(3, #triangles2, 'check polygon triangles')
 end
+
+
+-- love.math.triangulateIndices
+love.test.math.triangulateIndices = function(test)
+  -- square with a square hole
+  local vertices = {0, 0, 10, 0, 10, 10, 0, 10, 2, 2, 2, 8, 8, 8, 8, 2}
+  local indices, count = love.math.triangulateIndices(vertices, {5})
+  test:assertEquals(8, count, 'check hole triangle count')
+  test:assertEquals(24, #indices, 'check index count')
+  local area = 0
+  for i=1,#indices,3 do
+    local ax, ay = vertices[indices[i]*2-1], vertices[indices[i]*2]
+    local bx, by = vertices[indices[i+1]*2-1], vertices[indices[i+1]*2]
+    local cx, cy = vertices[indices[i+2]*2-1], vertices[indices[i+2]*2]
+    area = area + math.abs((bx-ax)*(cy-ay) - (cx-ax)*(by-ay)) / 2
+  end
+  test:assertEquals(64, area, 'check triangulated area')
+  -- large polygons use the z-order hashed path
+  local circle = {}
+  for i=0,199 do
+    local a = i / 200 * math.pi * 2
+    table.insert(circle, math.cos(a) * 100)
+    table.insert(circle, math.sin(a) * 100)
+  end
+  local _, circlecount = love.math.triangulateIndices(circle)
+  test:assertEquals(198, circlecount, 'check polygon triangle count')
+  local ok = pcall(love.math.triangulateIndices, vertices, {9})
+  test:assertEquals(false, ok, 'check invalid hole errors')
+end
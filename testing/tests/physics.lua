@@ -24,6 +24,10 @@ love.test.physics.Body = function(test)
   test:assertEquals(1, #body2:getShapes(), 'check shapes total 2')
   test:assertNotEquals(nil, body1:getShape(), 'check shape 1')
   test:assertNotEquals(nil, body2:getShape(), 'check shape 2')
+  local shapes = {'a', 'b', 'c'}
+  test:assertEquals(shapes, body1:getShapes(shapes), 'check shapes reuse table')
+  test:assertEquals(1, #shapes, 'check shapes reused table cleared')
+  test:assertEquals(body1:getShape(), shapes[1], 'check shapes reused table value')
 
   -- check body active
   test:assertTrue(body1:isActive(), 'check active by def')
@@ -521,6 +525,9 @@ love.test.physics.World = function(test)
   test:assertRange(world:getBodies()[1]:getX(), 9, 11, 'check body prop change x')
   test:assertRange(world:getBodies()[1]:getY(), 9, 11, 'check body prop change y')
   test:assertEquals(1, world:getBodyCount(), 'check 1 body count')
+  local bodies = {}
+  world:getBodies(bodies)
+  test:assertEquals(body1, bodies[1], 'check bodies reuse table')
 
   -- check shapes in world
   test:assertEquals(1, #world:getShapesInArea(0, 0, 10, 10), 'check shapes in area #1')
@@ -585,6 +592,20 @@ love.test.physics.World = function(test)
   test:assertEquals(world:rayCastClosest(0, 0, 200, 200), rectangle1, 'check closest raycast')
   test:assertNotEquals(nil, world:rayCastAny(0, 0, 200, 200), 'check any raycast')
 
+  -- check batched raycasts and reused results
+  local hitshapes, fractions = {}, {}
+  local hits = world:rayCastMany({0, 0, 200, 200, 500, 500, 600, 600}, hitshapes, fractions)
+  test:assertEquals(1, hits, 'check batched raycast hits')
+  test:assertEquals(rectangle1, hitshapes[1], 'check batched closest raycast')
+  test:assertFalse(hitshapes[2], 'check batched raycast miss')
+  test:assertEquals(2, #fractions, 'check batched raycast fractions')
+  hits = world:rayCastMany({500, 500, 600, 600}, hitshapes, fractions)
+  test:assertEquals(0, hits, 'check batched raycast no hits')
+  test:assertEquals(1, #hitshapes, 'check batched raycast results cleared')
+  local area, count = world:getShapesInArea(0, 0, 200, 200, nil, hitshapes)
+  test:assertEquals(hitshapes, area, 'check area table reused')
+  test:assertEquals(#area, count, 'check area count')
+
   -- change collision logic
   test:assertEquals(nil, world:getContactFilter(), 'check def filter')
   world:update(1)
@@ -595,10 +616,173 @@ love.test.physics.World = function(test)
   world:update(1)
   test:assertEquals(1, collisions, 'check collision logic change')
 
+  -- check deferred contact events
+  local dworld = love.physics.newWorld(0, 0, false)
+  local dbody1 = love.physics.newBody(dworld, 0, 0, 'dynamic')
+  local dshape1 = love.physics.newRectangleShape(dbody1, 0, 0, 10, 10)
+  local dbody2 = love.physics.newBody(dworld, 5, 5, 'dynamic')
+  local dshape2 = love.physics.newRectangleShape(dbody2, 0, 0, 10, 10)
+  local deferredCallback = false
+  dworld:setCallbacks(function() deferredCallback = true end)
+  test:assertFalse(dworld:isContactEventsDeferred(), 'check not deferred by default')
+  dworld:setContactEventsDeferred(true, true)
+  test:assertTrue(dworld:isContactEventsDeferred(), 'check deferred')
+  dworld:update(1)
+  test:assertFalse(deferredCallback, 'check callback not called')
+  local events, count = dworld:getContactEvents()
+  test:assertGreaterEqual(2, count, 'check events recorded')
+  test:assertEquals('begin', events[1].type, 'check begin event')
+  test:assertNotEquals(nil, events[1].normalX, 'check begin normal')
+  test:assertEquals('postsolve', events[2].type, 'check postsolve event')
+  test:assertNotEquals(nil, events[2].normalImpulse1, 'check postsolve impulse')
+  local first = events[1]
+  local _, count2 = dworld:getContactEvents(events)
+  test:assertEquals(0, count2, 'check events cleared')
+  test:assertEquals(nil, events[1], 'check old events cleared')
+  dworld:setContactEventsDeferred(true, false)
+  dbody2:setPosition(100, 100)
+  dworld:update(1)
+  events, count = dworld:getContactEvents({first})
+  test:assertEquals(1, count, 'check end event only')
+  test:assertEquals(first, events[1], 'check event table reused')
+  test:assertEquals('end', events[1].type, 'check end event')
+  test:assertEquals(nil, events[1].normalX, 'check old fields cleared')
+  test:assertTrue(events[1].shapeA == dshape1 or events[1].shapeA == dshape2, 'check event shape')
+  dworld:destroy()
+
   -- check gravity
   world:setGravity(1, 1)
   test:assertEquals(1, world:getGravity(), 'check grav change')
 
+  -- check bulk transform readback
+  local transforms = love.data.newByteData(4 * 6 * 2)
+  local written = world:getBodyTransforms({body1, body2}, transforms, 0, true)
+  test:assertEquals(2, written, 'check transforms written')
+  local values = transforms:getArray('float', 0, 12)
+  test:assertEquals(body1:getX(), values[1], 'check body x')
+  test:assertEquals(body2:getY(), values[8], 'check body y')
+  test:assertEquals(body2:getAngle(), values[9], 'check body angle')
+  test:assertEquals(body2:getAngularVelocity(), values[12], 'check body angular velocity')
+  local ok = pcall(world.getBodyTransforms, world, {body1, body2}, transforms, 24, true)
+  test:assertFalse(ok, 'check transforms out of bounds')
+  ok = pcall(world.getBodyTransforms, world, {love.physics.newBody(love.physics.newWorld())}, transforms)
+  test:assertFalse(ok, 'check body from another world')
+
+  -- check threaded island solving gives the same results
+  local function simulate(threads)
+    local sim = love.physics.newWorld(0, 9.81*64, true)
+    sim:setThreadCount(threads)
+    love.physics.newRectangleShape(love.physics.newBody(sim, 200, 400, 'static'), 400, 10)
+    local boxes = {}
+    for i=1,8 do
+      for j=1,4 do
+        local box = love.physics.newBody(sim, i*40, 380 - j*12, 'dynamic')
+        love.physics.newRectangleShape(box, 10, 10)
+        table.insert(boxes, box)
+      end
+    end
+    for i=1,60 do sim:update(1/60) end
+    local positions = {}
+    for i=1,#boxes do
+      table.insert(positions, boxes[i]:getX())
+      table.insert(positions, boxes[i]:getY())
+    end
+    sim:destroy()
+    return positions
+  end
+  test:assertEquals(1, world:getThreadCount(), 'check default thread count')
+  world:setThreadCount(4)
+  test:assertEquals(4, world:getThreadCount(), 'check thread count set')
+  world:setThreadCount(1)
+  test:assertFalse(pcall(world.setThreadCount, world, 0), 'check invalid thread count')
+  local serial, threaded = simulate(1), simulate(4)
+  for i=1,#serial do
+    test:assertEquals(serial[i], threaded[i], 'check threaded result ' .. i)
+  end
+
+  -- check fixed updates and interpolation
+  local fixed = love.physics.newWorld(0, 0, true)
+  local mover = love.physics.newBody(fixed, 0, 0, 'dynamic')
+  love.physics.newCircleShape(mover, 4)
+  mover:setLinearVelocity(60, 0)
+  local steps, alpha = fixed:updateFixed(2.5/60, 1/60)
+  test:assertEquals(2, steps, 'check fixed steps taken')
+  test:assertRange(alpha, 0.49, 0.51, 'check interpolation alpha')
+  test:assertEquals(alpha, fixed:getInterpolationAlpha(), 'check alpha matches')
+  local ix = mover:getInterpolatedPosition()
+  test:assertRange(ix, 1.49, 1.51, 'check interpolated x')
+  test:assertRange(mover:getInterpolatedPosition(1), 1.99, 2.01, 'check current x')
+  steps = fixed:updateFixed(1, 1/60, 4)
+  test:assertEquals(4, steps, 'check max steps')
+  mover:setPosition(100, 0)
+  test:assertEquals(100, mover:getInterpolatedPosition(0), 'check teleport not interpolated')
+  test:assertFalse(pcall(fixed.updateFixed, fixed, 1, 0), 'check invalid fixed step')
+  fixed:destroy()
+
+  -- check state rollback
+  local rollback = love.physics.newWorld(0, 10, false)
+  local floor = love.physics.newBody(rollback, 0, 20, 'static')
+  love.physics.newRectangleShape(floor, 0, 0, 100, 2)
+  local box = love.physics.newBody(rollback, 0, 0, 'dynamic')
+  love.physics.newRectangleShape(box, 0, 0, 4, 4)
+  rollback:update(1/60)
+  local state = rollback:saveState()
+  for i=1,60 do rollback:update(1/60) end
+  local bx, by = box:getPosition()
+  rollback:loadState(state)
+  test:assertEquals(state, rollback:saveState(state), 'check state data reused')
+  for i=1,60 do rollback:update(1/60) end
+  local rx, ry = box:getPosition()
+  test:assertEquals(bx, rx, 'check rollback x')
+  test:assertEquals(by, ry, 'check rollback y')
+  love.physics.newBody(rollback, 0, 0, 'dynamic')
+  test:assertFalse(pcall(rollback.loadState, rollback, state), 'check mismatched state')
+  rollback:destroy()
+
+  -- check moved bodies
+  local moving = love.physics.newWorld(0, 10, true)
+  local still = love.physics.newBody(moving, 0, 0, 'static')
+  local faller = love.physics.newBody(moving, 0, 0, 'dynamic')
+  love.physics.newCircleShape(faller, 0, 0, 1)
+  moving:update(1/60)
+  local moved, movedcount = moving:getMovedBodies()
+  test:assertEquals(1, movedcount, 'check moved count')
+  test:assertEquals(faller, moved[1], 'check moved body')
+  faller:setAwake(false)
+  moving:update(1/60)
+  local reused, reusedcount = moving:getMovedBodies(moved)
+  test:assertEquals(moved, reused, 'check moved table reused')
+  test:assertEquals(0, reusedcount, 'check sleeping body not moved')
+  test:assertEquals(nil, reused[1], 'check moved table cleared')
+  moving:destroy()
+
+  -- check bulk static geometry
+  local level = love.physics.newWorld(0, 10, false)
+  local ground = level:addStaticGeometry({0, 0, 10, 0, 20, 0, 30, 0, 30, -10, 40, 0, 50, 0, 60, 0}, {4, 4})
+  test:assertEquals('static', ground:getType(), 'check static geometry body type')
+  test:assertEquals(2, #ground:getShapes(), 'check static geometry chains')
+  test:assertEquals(4, ground:getShapes()[1]:getVertexCount(), 'check unmerged chain')
+  local floordata = love.data.newByteData(love.data.pack('string', 'ffffffff', 0, 0, 10, 0, 20, 0, 20, 10))
+  local merged = level:addStaticGeometry(floordata, nil, false, true)
+  test:assertEquals(3, merged:getShapes()[1]:getVertexCount(), 'check collinear vertices merged')
+  local x1, y1, x2, y2 = merged:getShapes()[1]:getPoints()
+  test:assertEquals(20, x2, 'check merged edge end')
+  test:assertFalse(pcall(level.addStaticGeometry, level, {0, 0, 10, 0}, {3}), 'check mismatched chain sizes')
+  level:destroy()
+
+  -- check debug draw batching
+  local debugworld = love.physics.newWorld(0, 0, false)
+  test:assertEquals(nil, debugworld:debugDraw(), 'check empty debug draw')
+  local debugbody = love.physics.newBody(debugworld, 0, 0, 'dynamic')
+  love.physics.newRectangleShape(debugbody, 0, 0, 10, 10)
+  local debugmesh = debugworld:debugDraw({linewidth = 2})
+  test:assertObject(debugmesh)
+  -- 2 fill triangles and 4 outline quads
+  test:assertEquals(30, debugmesh:getVertexCount(), 'check debug draw vertices')
+  test:assertEquals(debugmesh, debugworld:debugDraw({mesh = debugmesh}), 'check debug mesh reused')
+  test:assertEquals(nil, debugworld:debugDraw({shapes = false}), 'check debug draw without shapes')
+  debugworld:destroy()
+
   -- check destruction
   test:assertFalse(world:isDestroyed(), 'check not destroyed')
   world:destroy()
@@ -100,3 +100,20 @@ love.test.sensor.getData = function(test)
     test:skipTest('neither accelerometer nor gyroscope are supported in this system')
   end
 end
+
+
+-- love.sensor.setBatched and love.sensor.getSamples
+love.test.sensor.getSamples = function(test)
+  for _, sensorType in ipairs({'accelerometer', 'gyroscope'}) do
+    test:assertFalse(love.sensor.isBatched(sensorType), 'check ' .. sensorType .. ' not batched')
+    love.sensor.setBatched(sensorType, true)
+    test:assertTrue(love.sensor.isBatched(sensorType), 'check ' .. sensorType .. ' batched')
+    -- samples are x, y, z, timestamp and old entries are cleared
+    local reused = {1, 2, 3, 4, 5, 6, 7, 8}
+    local samples, count = love.sensor.getSamples(sensorType, reused)
+    test:assertEquals(reused, samples, 'check table reused')
+    test:assertEquals(count * 4, #samples, 'check sample values')
+    love.sensor.setBatched(sensorType, false)
+    test:assertFalse(love.sensor.isBatched(sensorType), 'check ' .. sensorType .. ' unbatched')
+  end
+end
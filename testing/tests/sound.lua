@@ -74,6 +74,18 @@ love.test.sound.SoundData = function(test)
   test:assertEquals(44100, clone:getSampleRate(), 'check clone sample rate')
   test:assertEquals(2927, clone:getSampleCount(), 'check clone sample count')
 
+  -- clones share samples until one of them is modified
+  local original = sdata:getSample(0)
+  clone:setSample(0, 0.5)
+  test:assertEquals(original, sdata:getSample(0), 'check original unchanged by clone')
+  test:assertRange(clone:getSample(0), 0.49, 0.51, 'check clone sample set')
+
+  -- modifying the original after cloning leaves the clone alone
+  local clone2 = sdata:clone()
+  sdata:setSample(0, -0.5)
+  test:assertEquals(original, clone2:getSample(0), 'check clone unchanged by original')
+  sdata:setSample(0, original)
+
   -- check sample setting
   test:assertRange(sdata:getSample(0.001), -0.1, 0, 'check sample 1')
   test:assertRange(sdata:getSample(0.005), -0.1, 0, 'check sample 1')
@@ -92,6 +104,28 @@ love.test.sound.SoundData = function(test)
   local slice = copy1:slice(0, count)
   test:assertEquals(count, slice:getSampleCount(), 'check slice length')
 
+  -- check copying between bit depths converts samples
+  local copy8 = love.sound.newSoundData(16, 44100, 8, 1)
+  local copy16 = love.sound.newSoundData(16, 44100, 16, 1)
+  for i=0,15 do
+    copy16:setSample(i, (i - 8) / 8)
+  end
+  copy8:copyFrom(copy16, 0, 16, 0)
+  for i=0,15 do
+    test:assertRange(copy8:getSample(i), (i - 8) / 8 - 0.01, (i - 8) / 8 + 0.01, 'check converted sample ' .. i)
+  end
+
+  -- check mixing adds scaled samples and clamps
+  local mixed = love.sound.newSoundData(16, 44100, 16, 1)
+  for i=0,15 do
+    mixed:setSample(i, 0.5)
+  end
+  mixed:mix(copy8, 0.5)
+  test:assertRange(mixed:getSample(0), -0.01, 0.01, 'check mixed sample')
+  test:assertRange(mixed:getSample(12), 0.74, 0.76, 'check mixed sample')
+  mixed:mix(mixed, 2, 0, 4, 12)
+  test:assertEquals(1, mixed:getSample(15), 'check mixing clamps')
+
 end
 
 
@@ -116,3 +150,20 @@ love.test.sound.newSoundData = function(test)
   test:assertObject(love.sound.newSoundData('resources/click.ogg'))
   test:assertObject(love.sound.newSoundData(math.floor((1/32)*44100), 44100, 16, 1))
 end
+
+
+-- love.sound.newSoundDataAsync
+love.test.sound.newSoundDataAsync = function(test)
+  local sync = love.sound.newSoundData('resources/tone.ogg')
+  local load = love.sound.newSoundDataAsync('resources/tone.ogg', 4)
+  test:assertGreaterEqual(1, load:getSegmentCount(), 'check segment count')
+  -- check the async result matches decoding on this thread
+  local async = load:getSoundData()
+  test:assertTrue(load:isComplete(), 'check load complete')
+  test:assertEquals(sync:getSampleCount(), async:getSampleCount(), 'check sample count')
+  test:assertEquals(sync:getChannelCount(), async:getChannelCount(), 'check channels')
+  local last = sync:getSampleCount() - 1
+  test:assertEquals(sync:getSample(0), async:getSample(0), 'check first sample')
+  test:assertEquals(sync:getSample(math.floor(last/2)), async:getSample(math.floor(last/2)), 'check middle sample')
+  test:assertEquals(sync:getSample(last), async:getSample(last), 'check last sample')
+end
@@ -37,6 +37,28 @@ love.test.system.getPreferredLocales = function(test)
 end
 
 
+-- love.system.getMemoryStats
+love.test.system.getMemoryStats = function(test)
+  local before = love.system.getMemoryStats()
+  test:assertEquals('table', type(before), 'check returns table')
+  test:assertEquals('table', type(before.peak), 'check peak table')
+  test:assertGreaterEqual(0, before.lua, 'check lua memory')
+  local names = {'texture', 'buffer', 'font', 'sounddata', 'imagedata', 'physics', 'variant'}
+  for n=1,#names do
+    test:assertEquals('number', type(before[names[n]]), 'check ' .. names[n] .. ' value')
+    test:assertGreaterEqual(before[names[n]], before.peak[names[n]], 'check ' .. names[n] .. ' peak')
+  end
+  -- creating imagedata should be counted
+  local imgdata = love.image.newImageData(64, 64)
+  local after = love.system.getMemoryStats()
+  test:assertGreaterEqual(before.imagedata + 64*64*4, after.imagedata, 'check imagedata counted')
+  imgdata:release()
+  love.system.resetMemoryPeaks()
+  local reset = love.system.getMemoryStats()
+  test:assertEquals(reset.imagedata, reset.peak.imagedata, 'check peak reset')
+end
+
+
 -- love.system.getPowerInfo
 love.test.system.getPowerInfo = function(test)
   -- check battery state is one of the documented states
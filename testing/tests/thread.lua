@@ -76,6 +76,183 @@ love.test.thread.Channel = function(test)
   test:assertEquals('pong', msg4, 'check message recieved 2')
   test:assertEquals(0, channel:getCount())
 
+  -- check strings on both sides of the inline storage limit
+  for _, len in ipairs({0, 15, 16, 300}) do
+    local str = string.rep('s', len)
+    channel:push(str)
+    test:assertEquals(str, channel:pop(), 'check string of length ' .. len)
+  end
+
+  -- check tables keep their contents, including repeated strings and holes
+  local long = string.rep('abc', 10)
+  local sent = {1, 'two', nil, {x = long, y = {long, true}}, n = 4.5, [long] = false}
+  channel:push(sent)
+  local received = channel:pop()
+  test:assertEquals(1, received[1], 'check table array')
+  test:assertEquals('two', received[2], 'check table string')
+  test:assertEquals(nil, received[3], 'check table hole')
+  test:assertEquals(long, received[4].x, 'check nested table')
+  test:assertEquals(long, received[4].y[1], 'check repeated string')
+  test:assertEquals(true, received[4].y[2], 'check nested boolean')
+  test:assertEquals(4.5, received.n, 'check table hash')
+  test:assertEquals(false, received[long], 'check string key')
+  local cycle = {}
+  cycle.self = cycle
+  test:assertFalse(pcall(channel.push, channel, cycle), 'check cycle error')
+
+  -- check batches keep their order
+  test:assertEquals(3, channel:pushMany({1, 2, 3}), 'check batch pushed')
+  local batch = channel:popMany(2)
+  test:assertEquals(2, #batch, 'check batch max')
+  test:assertEquals(2, batch[2], 'check batch order')
+  test:assertEquals(3, channel:popMany()[1], 'check batch rest')
+  channel:pushMany({'x'})
+  local reused, count = channel:popMany(10, batch)
+  test:assertEquals(batch, reused, 'check table reused')
+  test:assertEquals(1, count, 'check reused count')
+  test:assertEquals(nil, batch[2], 'check old values cleared')
+  test:assertFalse(channel:isLockFree(), 'check not lock-free')
+
+  -- check lock-free channels are bounded and round capacity up
+  local ring = love.thread.newChannel({lockfree = true, capacity = 3})
+  test:assertTrue(ring:isLockFree(), 'check lock-free')
+  test:assertEquals(4, ring:pushMany({'a', 'b', 'c', 'd', 'e'}), 'check capacity')
+  test:assertEquals(nil, ring:push('f'), 'check push when full')
+  test:assertEquals('a', ring:pop(), 'check ring order')
+  test:assertNotEquals(nil, ring:push('f'), 'check push after pop')
+  test:assertEquals(4, ring:getCount(), 'check ring count')
+
+  -- check blocking calls work across threads
+  local threadcode3 = [[
+    local ring = ...
+    for i=1,100 do ring:supply(i) end
+  ]]
+  ring:clear()
+  local thread3 = love.thread.newThread(threadcode3)
+  thread3:start(ring)
+  local total = 0
+  for i=1,100 do total = total + ring:demand(1) end
+  thread3:wait()
+  test:assertEquals(5050, total, 'check ring demand')
+  test:assertEquals(0, ring:getCount(), 'check ring empty')
+
+end
+
+
+-- JobPool (love.thread.newJobPool)
+love.test.thread.JobPool = function(test)
+
+  local pool = love.thread.newJobPool([[
+    local jobs = {}
+    function jobs.add(a, b) return a + b, 'done' end
+    function jobs.fill(first, last, name)
+      local channel = love.thread.getChannel(name)
+      for i=first,last do channel:push(i) end
+    end
+    function jobs.fail() error('bad job') end
+    return jobs
+  ]], 2)
+  test:assertObject(pool)
+  test:assertEquals(2, pool:getThreadCount(), 'check thread count')
+
+  -- check a job returns its results
+  local add = pool:submit('add', 1, 2)
+  test:assertObject(add)
+  local ok, sum, msg = add:wait()
+  test:assertTrue(ok, 'check job succeeded')
+  test:assertEquals(3, sum, 'check job result')
+  test:assertEquals('done', msg, 'check 2nd job result')
+  test:assertEquals('complete', add:getStatus(), 'check job status')
+  test:assertTrue(add:isDone(), 'check job done')
+
+  -- check parallel for covers the whole range once, after its dependency
+  local channel = love.thread.getChannel('jobpool')
+  channel:clear()
+  local fill = pool:parallelFor({name = 'fill', after = add, grain = 7}, 1, 100, 'jobpool')
+  test:assertTrue(fill:wait(), 'check parallel for succeeded')
+  local total = 0
+  for _, v in ipairs(channel:popMany()) do total = total + v end
+  test:assertEquals(5050, total, 'check parallel for range')
+
+  -- check errors fail the job and anything depending on it
+  local fail = pool:submit('fail')
+  local after = pool:submit({name = 'add', after = {fail}}, 1, 1)
+  local failok, err = fail:wait()
+  test:assertFalse(failok, 'check job failed')
+  test:assertNotNil(err)
+  test:assertFalse(after:wait(), 'check dependent failed')
+  test:assertEquals('failed', after:getStatus(), 'check dependent status')
+  test:assertFalse(pool:submit('missing'):wait(), 'check missing function')
+
+end
+
+
+-- Mutex (love.thread.newMutex)
+love.test.thread.Mutex = function(test)
+
+  -- create object
+  local mutex = love.thread.newMutex()
+  test:assertObject(mutex)
+
+  -- check locking is recursive and errors still unlock
+  mutex:lock()
+  mutex:lock()
+  mutex:unlock()
+  mutex:unlock()
+  local a, b = mutex:performAtomic(function(x) return x, x + 1 end, 1)
+  test:assertEquals(1, a, 'check atomic return')
+  test:assertEquals(2, b, 'check atomic return')
+  test:assertFalse(pcall(mutex.performAtomic, mutex, error), 'check atomic error')
+
+  -- check threads sharing a buffer
+  local data = love.data.newByteData(8)
+  local threadcode = [[
+    local mutex, data = ...
+    for i=1,1000 do
+      data:atomicAdd('int32', 0, 1)
+      mutex:performAtomic(function()
+        data:setInt32(4, data:getInt32(4) + 1)
+      end)
+    end
+  ]]
+  local threads = {}
+  for i=1,4 do
+    threads[i] = love.thread.newThread(threadcode)
+    threads[i]:start(mutex, data)
+  end
+  for i=1,4 do
+    threads[i]:wait()
+    test:assertEquals(nil, threads[i]:getError(), 'check no errors')
+  end
+  test:assertEquals(4000, data:atomicLoad('int32', 0), 'check atomic count')
+  test:assertEquals(4000, data:getInt32(4), 'check locked count')
+
+end
+
+
+-- Semaphore (love.thread.newSemaphore)
+love.test.thread.Semaphore = function(test)
+
+  -- create object
+  local semaphore = love.thread.newSemaphore(1)
+  test:assertObject(semaphore)
+
+  -- check counting
+  test:assertEquals(1, semaphore:getCount(), 'check initial count')
+  test:assertTrue(semaphore:acquire(), 'check acquire')
+  test:assertFalse(semaphore:tryAcquire(), 'check try acquire')
+  test:assertFalse(semaphore:acquire(0.01), 'check acquire timeout')
+  semaphore:release(2)
+  test:assertEquals(2, semaphore:getCount(), 'check released count')
+  test:assertTrue(semaphore:tryAcquire(), 'check try acquire')
+
+  -- check waking up from another thread
+  local waiting = love.thread.newSemaphore(0)
+  local thread = love.thread.newThread('local s = ...\ns:release()\n')
+  thread:start(waiting)
+  test:assertTrue(waiting:acquire(5), 'check acquire from thread')
+  thread:wait()
+
 end
 
 
@@ -99,6 +276,20 @@ love.test.thread.Thread = function(test)
   test:assertFalse(thread:isRunning(), 'check finished')
   test:assertEquals(nil, thread:getError(), 'check no errors')
 
+  -- check scheduling options
+  test:assertEquals('normal', thread:getPriority(), 'check default priority')
+  thread:setPriority('low')
+  test:assertEquals('low', thread:getPriority(), 'check set priority')
+  test:assertEquals(nil, thread:getAffinity(), 'check default affinity')
+  thread:setAffinity({1})
+  test:assertEquals(1, thread:getAffinity()[1], 'check set affinity')
+  test:assertFalse(pcall(thread.setAffinity, thread, {0}), 'check invalid core')
+  thread:setStackSize(1024*1024)
+  test:assertEquals(1024*1024, thread:getStackSize(), 'check set stack size')
+  thread:start()
+  thread:wait()
+  test:assertEquals(nil, thread:getError(), 'check no errors with options')
+
   -- check an invalid thread
   local badthreadcode = 'local b = 0\nreturn b + "string" .. 10'
   local badthread = love.thread.newThread(badthreadcode)
@@ -123,6 +314,20 @@ love.test.thread.getChannel = function(test)
 end
 
 
+-- love.thread.getDefaultAffinity
+love.test.thread.getDefaultAffinity = function(test)
+  test:assertEquals(nil, love.thread.getDefaultAffinity(), 'check default')
+end
+
+
+-- love.thread.getStatePoolSize
+love.test.thread.getStatePoolSize = function(test)
+  local size, modules = love.thread.getStatePoolSize()
+  test:assertEquals(0, size, 'check default size')
+  test:assertEquals(0, #modules, 'check default modules')
+end
+
+
 -- love.thread.newChannel
 -- @NOTE this is just basic nil checking, objs have their own test method
 love.test.thread.newChannel = function(test)
@@ -130,8 +335,64 @@ love.test.thread.newChannel = function(test)
 end
 
 
+-- love.thread.newJobPool
+-- @NOTE this is just basic nil checking, objs have their own test method
+love.test.thread.newJobPool = function(test)
+  test:assertObject(love.thread.newJobPool('return {}\n', 1))
+end
+
+
+-- love.thread.newMutex
+-- @NOTE this is just basic nil checking, objs have their own test method
+love.test.thread.newMutex = function(test)
+  test:assertObject(love.thread.newMutex())
+end
+
+
+-- love.thread.newSemaphore
+-- @NOTE this is just basic nil checking, objs have their own test method
+love.test.thread.newSemaphore = function(test)
+  test:assertObject(love.thread.newSemaphore())
+end
+
+
 -- love.thread.newThread
 -- @NOTE this is just basic nil checking, objs have their own test method
 love.test.thread.newThread = function(test)
   test:assertObject(love.thread.newThread('classes/TestSuite.lua'))
 end
+
+
+-- love.thread.setStatePoolSize
+love.test.thread.setStatePoolSize = function(test)
+  love.thread.setStatePoolSize(2, {'math'})
+  local size, modules = love.thread.getStatePoolSize()
+  test:assertEquals(2, size, 'check size')
+  test:assertEquals('math', modules[1], 'check modules')
+
+  -- check threads start with the chosen modules, and don't share globals
+  local channel = love.thread.newChannel()
+  local threadcode = 'local c = ...\nc:push(love.math ~= nil and shared == nil)\nshared = true\n'
+  for i=1,4 do
+    local thread = love.thread.newThread(threadcode)
+    thread:start(channel)
+    thread:wait()
+    test:assertEquals(nil, thread:getError(), 'check no errors')
+    test:assertTrue(channel:pop(), 'check fresh state with modules')
+  end
+
+  love.thread.setStatePoolSize(0)
+  test:assertEquals(0, love.thread.getStatePoolSize(), 'check reset')
+end
+
+
+-- love.thread.setDefaultAffinity
+love.test.thread.setDefaultAffinity = function(test)
+  love.thread.setDefaultAffinity({1, 2})
+  local cores = love.thread.getDefaultAffinity()
+  test:assertEquals(2, #cores, 'check core count')
+  test:assertEquals(2, cores[2], 'check core index')
+  test:assertEquals(2, #love.thread.newThread('return\n'):getAffinity(), 'check new thread affinity')
+  love.thread.setDefaultAffinity(nil)
+  test:assertEquals(nil, love.thread.getDefaultAffinity(), 'check reset')
+end
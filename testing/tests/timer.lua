@@ -8,6 +8,30 @@
 --------------------------------------------------------------------------------
 
 
+-- love.timer.beginZone
+-- love.timer.endZone
+-- love.timer.getProfileTrace
+love.test.timer.beginZone = function(test)
+  local wasenabled = love.timer.isProfilingEnabled()
+  love.timer.setProfilingEnabled(true)
+  test:assertTrue(love.timer.isProfilingEnabled(), 'check profiling enabled')
+  love.timer.clearProfile()
+  love.timer.beginZone('outer zone')
+    love.timer.beginZone('inner "zone"')
+    love.timer.sleep(0.01)
+    love.timer.endZone()
+  love.timer.endZone()
+  local trace = love.timer.getProfileTrace()
+  love.timer.setProfilingEnabled(wasenabled)
+  test:assertEquals('string', type(trace), 'check trace type')
+  test:assertNotEquals(nil, trace:find('"traceEvents"', 1, true), 'check trace events key')
+  test:assertNotEquals(nil, trace:find('"name":"outer zone"', 1, true), 'check outer zone recorded')
+  test:assertNotEquals(nil, trace:find('"name":"inner \\"zone\\""', 1, true), 'check inner zone name escaped')
+  love.timer.clearProfile()
+  test:assertEquals(nil, love.timer.getProfileTrace():find('outer zone', 1, true), 'check profile cleared')
+end
+
+
 -- love.timer.getAverageDelta
 -- @NOTE not sure if you could reliably get a specific delta?
 love.test.timer.getAverageDelta = function(test)
@@ -37,6 +61,43 @@ love.test.timer.getTime = function(test)
 end
 
 
+-- love.timer.setFrameRateLimit
+-- love.timer.getFrameRateLimit
+love.test.timer.setFrameRateLimit = function(test)
+  local oldlimit = love.timer.getFrameRateLimit()
+  love.timer.setFrameRateLimit(20)
+  test:assertEquals(20, love.timer.getFrameRateLimit(), 'check limit set')
+  local ok = pcall(love.timer.setFrameRateLimit, -1)
+  test:assertFalse(ok, 'check negative limit errors')
+  love.timer.setFrameRateLimit(oldlimit)
+  test:assertEquals(oldlimit, love.timer.getFrameRateLimit(), 'check limit restored')
+end
+
+
+-- love.timer.startSampling
+-- love.timer.stopSampling
+-- love.timer.getSampleProfile
+love.test.timer.startSampling = function(test)
+  love.timer.startSampling(0.001)
+  test:assertTrue(love.timer.isSampling(), 'check sampling started')
+  local ok = pcall(love.timer.startSampling)
+  test:assertFalse(ok, 'check sampling can only be started once')
+  local function busyloop()
+    local x = 0
+    local starttime = love.timer.getTime()
+    while love.timer.getTime() - starttime < 0.1 do x = x + 1 end
+    return x
+  end
+  busyloop()
+  test:assertTrue(love.timer.stopSampling(), 'check sampling stopped')
+  test:assertFalse(love.timer.isSampling(), 'check not sampling')
+  test:assertFalse(love.timer.stopSampling(), 'check stopping twice')
+  local profile, count = love.timer.getSampleProfile()
+  test:assertGreaterEqual(1, count, 'check samples taken')
+  test:assertNotEquals(nil, profile:find('busyloop', 1, true), 'check Lua function sampled')
+end
+
+
 -- love.timer.sleep
 love.test.timer.sleep = function(test)
   local starttime = love.timer.getTime()
@@ -50,3 +111,20 @@ end
 love.test.timer.step = function(test)
   test:assertNotNil(love.timer.step())
 end
+
+
+-- love.timer.waitForNextFrame
+-- love.timer.getFrameWorkTime
+love.test.timer.waitForNextFrame = function(test)
+  local oldlimit = love.timer.getFrameRateLimit()
+  love.timer.setFrameRateLimit(20)
+  love.timer.waitForNextFrame()
+  local starttime = love.timer.getTime()
+  for i=1,4 do
+    love.timer.waitForNextFrame()
+  end
+  love.timer.setFrameRateLimit(oldlimit)
+  -- 4 frames at 20fps should take 0.2s
+  test:assertRange(love.timer.getTime() - starttime, 0.15, 1, 'check frames are paced')
+  test:assertGreaterEqual(0, love.timer.getFrameWorkTime(), 'check work time')
+end
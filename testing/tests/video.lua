@@ -43,4 +43,7 @@ end
 -- @NOTE this is just basic nil checking, objs have their own test method
 love.test.video.newVideoStream = function(test)
   test:assertObject(love.video.newVideoStream('resources/sample.ogv'))
+  test:assertObject(love.video.newVideoStream('resources/sample.ogv', 4))
+  local ok = pcall(love.video.newVideoStream, 'resources/sample.ogv', 0)
+  test:assertFalse(ok, 'check invalid decode-ahead count')
 end
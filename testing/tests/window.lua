@@ -110,6 +110,13 @@ love.test.window.getPosition = function(test)
 end
 
 
+-- love.window.getPresentMode
+love.test.window.getPresentMode = function(test)
+  local modes = {'immediate', 'vsync', 'adaptive', 'mailbox'}
+  test:assertMatch(modes, love.window.getPresentMode(), 'check value matches')
+end
+
+
 -- love.window.getSafeArea
 -- @NOTE dependent on hardware so best can do is not nil
 love.test.window.getSafeArea = function(test)
@@ -121,6 +128,17 @@ love.test.window.getSafeArea = function(test)
 end
 
 
+-- love.window.getSupportedPresentModes
+love.test.window.getSupportedPresentModes = function(test)
+  local modes = love.window.getSupportedPresentModes()
+  test:assertEquals('table', type(modes), 'check returns table')
+  local valid = {'immediate', 'vsync', 'adaptive', 'mailbox'}
+  for i=1,#modes do
+    test:assertMatch(valid, modes[i], 'check value matches')
+  end
+end
+
+
 -- love.window.getTitle
 love.test.window.getTitle = function(test)
   -- check title returned is what was set
@@ -290,10 +308,18 @@ love.test.window.setMode = function(test)
   test:assertEquals(512, height, 'check window h match')
   test:assertFalse(flags["fullscreen"], 'check window not fullscreen')
   test:assertFalse(flags["resizable"], 'check window not resizeable')
+  -- graphics resources are kept alive across mode changes
+  local canvas = love.graphics.newCanvas(4, 4)
+  love.graphics.setCanvas(canvas)
+    love.graphics.clear(1, 0, 0, 1)
+  love.graphics.setCanvas()
   love.window.setMode(360, 240, {
     fullscreen = false,
     resizable = true
   })
+  local r, g, b, a = love.graphics.readbackTexture(canvas):getPixel(0, 0)
+  test:assertEquals(1, r, 'check canvas contents kept')
+  test:assertEquals(1, a, 'check canvas alpha kept')
 end
 
 -- love.window.setPosition
@@ -307,6 +333,20 @@ love.test.window.setPosition = function(test)
 end
 
 
+-- love.window.setPresentMode
+love.test.window.setPresentMode = function(test)
+  local original = love.window.getPresentMode()
+  local supported = love.window.getSupportedPresentModes()
+  test:assertEquals('table', type(supported), 'check returns table')
+  for i=1,#supported do
+    test:assertTrue(love.window.setPresentMode(supported[i]), 'check ' .. supported[i] .. ' set')
+    test:assertEquals(supported[i], love.window.getPresentMode(), 'check ' .. supported[i] .. ' active')
+  end
+  love.window.setPresentMode(original)
+  love.window.setVSync(1)
+end
+
+
 -- love.window.setTitle
 love.test.window.setTitle = function(test)
   -- check setting title val is returned